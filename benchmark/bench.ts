@@ -7,6 +7,7 @@ import * as executeOverhead from './execute-overhead';
 import * as executeScalability from './execute-scalability';
 import * as transportOverhead from './transport-overhead';
 import * as storeOverhead from './store-overhead';
+import * as workerThreadsComparison from './worker-threads-comparison';
 
 export function bench(): Promise<void> {
     // Non-zone related benchmarks.
@@ -19,7 +20,8 @@ export function bench(): Promise<void> {
 
     return nodeNapaPerfComp.bench(singleWorkerZone)
         .then(() => { return executeOverhead.bench(singleWorkerZone); })
-        .then(() => { return executeScalability.bench(multiWorkerZone);});
+        .then(() => { return executeScalability.bench(multiWorkerZone); })
+        .then(() => { return workerThreadsComparison.bench(); });
 }
 
 bench();
\ No newline at end of file
@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as napa from '../lib/index';
+import * as fs from 'fs';
+import * as mdTable from 'markdown-table';
+import { generateString, timeDiffInMs, formatTimeDiff } from './bench-utils';
+
+/// <summary> Settings of a load run. </summary>
+export interface LoadSettings {
+    /// <summary> Target calls per second, sent on schedule whether or not earlier calls have returned. </summary>
+    rps: number;
+
+    /// <summary> Length in characters of the string argument of each call. </summary>
+    payloadSize: number;
+
+    /// <summary> Number of workers of the zone under load. </summary>
+    workers: number;
+
+    /// <summary> Duration of the measured run in milliseconds, after warm-up. </summary>
+    durationInMs: number;
+
+    /// <summary> Duration of the warm-up in milliseconds, whose calls are not measured. </summary>
+    warmupInMs: number;
+}
+
+/// <summary> Results of a load run, latencies are in milliseconds. </summary>
+export interface LoadResult {
+    settings: LoadSettings;
+    calls: number;
+    errors: number;
+    achievedRps: number;
+    latency: {
+        p50: number;
+        p90: number;
+        p99: number;
+        p999: number;
+        max: number;
+        mean: number;
+    };
+}
+
+export const DEFAULT_LOAD_SETTINGS: LoadSettings = {
+    rps: 1000,
+    payloadSize: 100,
+    workers: 4,
+    durationInMs: 10000,
+    warmupInMs: 2000
+};
+
+/// <summary> Interval of the send loop, calls due within an interval are sent together on their own schedule. </summary>
+const TICK_IN_MS = 1;
+
+function percentile(sorted: number[], p: number): number {
+    if (sorted.length === 0) {
+        return 0;
+    }
+    let index = Math.min(sorted.length - 1, Math.ceil(p * sorted.length) - 1);
+    return sorted[Math.max(0, index)];
+}
+
+function nowInMs(origin: [number, number]): number {
+    return timeDiffInMs(process.hrtime(origin));
+}
+
+/// <summary> Drives zone.execute at a fixed rate for a duration, and records the latency of each call. </summary>
+/// <remarks>
+///     The generator is open-loop: call i is due at i / rps, and its latency is measured from when it was due,
+///     not from when it was sent, so a stalled zone or caller shows up in the latency instead of lowering the rate.
+/// </remarks>
+function drive(zone: napa.zone.Zone, rps: number, durationInMs: number, args: any[], latencies: number[] | null): Promise<number> {
+    return new Promise<number>((resolve) => {
+        let origin = process.hrtime();
+        let total = Math.floor(rps * durationInMs / 1000);
+        let sent = 0;
+        let finished = 0;
+        let errors = 0;
+
+        let onFinished = (dueAt: number, succeeded: boolean) => {
+            if (latencies != null) {
+                latencies.push(nowInMs(origin) - dueAt);
+            }
+            if (!succeeded) {
+                ++errors;
+            }
+            if (++finished === total) {
+                resolve(errors);
+            }
+        };
+
+        let tick = () => {
+            let due = Math.min(total, Math.floor(nowInMs(origin) * rps / 1000) + 1);
+            for (; sent < due; ++sent) {
+                let dueAt = sent * 1000 / rps;
+                zone.execute("", "echo", args).then(
+                    () => { onFinished(dueAt, true); },
+                    () => { onFinished(dueAt, false); });
+            }
+            if (sent < total) {
+                setTimeout(tick, TICK_IN_MS);
+            }
+        };
+
+        if (total === 0) {
+            resolve(0);
+            return;
+        }
+        tick();
+    });
+}
+
+/// <summary> Runs the load against a new zone and reports latency percentiles and achieved throughput. </summary>
+export async function bench(settings: LoadSettings = DEFAULT_LOAD_SETTINGS): Promise<LoadResult> {
+    console.log(`Benchmarking latency under load (${settings.rps} calls/s, ${settings.payloadSize} bytes, ${settings.workers} workers)...`);
+
+    let zone = napa.zone.create(`load-latency-zone-${settings.workers}`, { workers: settings.workers });
+    await zone.broadcast("function echo(payload) { return payload; }");
+
+    const ARGS = [generateString(settings.payloadSize + 1)];
+
+    // Warm-up at the target rate, so the measured run starts with compiled code and steady queues.
+    await drive(zone, settings.rps, settings.warmupInMs, ARGS, null);
+
+    let latencies: number[] = [];
+    let start = process.hrtime();
+    let errors = await drive(zone, settings.rps, settings.durationInMs, ARGS, latencies);
+    let elapsed = timeDiffInMs(process.hrtime(start));
+
+    latencies.sort((a, b) => a - b);
+    let sum = latencies.reduce((total, latency) => total + latency, 0);
+    let result: LoadResult = {
+        settings: settings,
+        calls: latencies.length,
+        errors: errors,
+        achievedRps: elapsed > 0 ? latencies.length * 1000 / elapsed : 0,
+        latency: {
+            p50: percentile(latencies, 0.5),
+            p90: percentile(latencies, 0.9),
+            p99: percentile(latencies, 0.99),
+            p999: percentile(latencies, 0.999),
+            max: latencies.length > 0 ? latencies[latencies.length - 1] : 0,
+            mean: latencies.length > 0 ? sum / latencies.length : 0
+        }
+    };
+
+    console.log("## `zone.execute` latency under load\n");
+    console.log(mdTable([
+        ["target rps", "achieved rps", "calls", "errors", "p50 (ms)", "p90 (ms)", "p99 (ms)", "p999 (ms)", "max (ms)"],
+        [
+            settings.rps.toString(),
+            result.achievedRps.toFixed(1),
+            result.calls.toString(),
+            result.errors.toString(),
+            formatTimeDiff(result.latency.p50),
+            formatTimeDiff(result.latency.p90),
+            formatTimeDiff(result.latency.p99),
+            formatTimeDiff(result.latency.p999),
+            formatTimeDiff(result.latency.max)
+        ]
+    ]));
+    console.log();
+
+    return result;
+}
+
+/// <summary> Parses `--rps=`, `--payload=`, `--workers=`, `--duration=`, `--warmup=` and `--output=` arguments. </summary>
+function parseArguments(argv: string[]): { settings: LoadSettings, output: string } {
+    let settings: LoadSettings = {
+        rps: DEFAULT_LOAD_SETTINGS.rps,
+        payloadSize: DEFAULT_LOAD_SETTINGS.payloadSize,
+        workers: DEFAULT_LOAD_SETTINGS.workers,
+        durationInMs: DEFAULT_LOAD_SETTINGS.durationInMs,
+        warmupInMs: DEFAULT_LOAD_SETTINGS.warmupInMs
+    };
+    let output: string = null;
+
+    for (let arg of argv) {
+        let match = /^--([a-z]+)=(.*)$/.exec(arg);
+        if (match == null) {
+            throw new Error(`Unknown argument: ${arg}`);
+        }
+        let value = match[2];
+        switch (match[1]) {
+            case 'rps': settings.rps = Number(value); break;
+            case 'payload': settings.payloadSize = Number(value); break;
+            case 'workers': settings.workers = Number(value); break;
+            case 'duration': settings.durationInMs = Number(value); break;
+            case 'warmup': settings.warmupInMs = Number(value); break;
+            case 'output': output = value; break;
+            default: throw new Error(`Unknown argument: ${arg}`);
+        }
+    }
+    return { settings: settings, output: output };
+}
+
+if (require.main === module) {
+    let options = parseArguments(process.argv.slice(2));
+    bench(options.settings).then((result: LoadResult) => {
+        let json = JSON.stringify(result, null, 2);
+        if (options.output != null) {
+            fs.writeFileSync(options.output, json);
+        } else {
+            console.log(json);
+        }
+        process.exit(0);
+    }, (error: any) => {
+        console.error(error);
+        process.exit(1);
+    });
+}
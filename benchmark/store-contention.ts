@@ -0,0 +1,233 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as napa from '../lib/index';
+import * as fs from 'fs';
+import * as mdTable from 'markdown-table';
+import { generateString } from './bench-utils';
+
+/// <summary> Settings of a contention run. </summary>
+export interface ContentionSettings {
+    /// <summary> Numbers of workers to hammer the store from, one zone per number. </summary>
+    workers: number[];
+
+    /// <summary> Share of operations that are 'get', the rest are 'set'. </summary>
+    readRatio: number;
+
+    /// <summary> Number of keys the operations pick from uniformly. </summary>
+    keys: number;
+
+    /// <summary> Length in characters of the string values set. </summary>
+    valueSize: number;
+
+    /// <summary> Options of the store under test, i.e. number of shards. </summary>
+    store: napa.store.StoreOptions;
+
+    /// <summary> Duration of each measured run in milliseconds, after warm-up. </summary>
+    durationInMs: number;
+
+    /// <summary> Duration of the warm-up in milliseconds, whose operations are not measured. </summary>
+    warmupInMs: number;
+}
+
+/// <summary> Results for one number of workers, latencies are in microseconds. </summary>
+export interface ContentionResult {
+    workers: number;
+    operations: number;
+    throughput: number;
+    latency: {
+        p50: number;
+        p99: number;
+        max: number;
+    };
+}
+
+export const DEFAULT_CONTENTION_SETTINGS: ContentionSettings = {
+    workers: [1, 2, 4, 8, 16, 32, 64],
+    readRatio: 0.9,
+    keys: 1000,
+    valueSize: 100,
+    store: {},
+    durationInMs: 3000,
+    warmupInMs: 1000
+};
+
+/// <summary> Latencies are counted in buckets 10% apart, which merge exactly across workers. </summary>
+const BUCKET_BASE = 1.1;
+
+/// <summary> Delay before workers start together, so that all calls are dispatched by then. </summary>
+const START_DELAY_IN_MS = 200;
+
+/// <summary>
+///     Runs in a zone worker: waits until 'startAt', then gets or sets random keys until the duration is over.
+///     Returns the number of operations and a histogram of their latencies.
+/// </summary>
+function hammer(storeId: string, keys: number, valueSize: number, readRatio: number, startAt: number, durationInMs: number) {
+    const napa = require('../lib/index');
+    let store = napa.store.get(storeId);
+    let value = Array(valueSize + 1).join('x');
+    let buckets: number[] = [];
+
+    // The function runs in another isolate, so it repeats BUCKET_BASE instead of capturing it.
+    let logBase = Math.log(1.1);
+
+    // Spin instead of sleeping, so workers start within a millisecond of each other.
+    while (Date.now() < startAt) {
+    }
+
+    let end = startAt + durationInMs;
+    let operations = 0;
+    for (;;) {
+        if ((operations & 63) === 0 && Date.now() >= end) {
+            break;
+        }
+        let key = 'key' + Math.floor(Math.random() * keys);
+        let start = process.hrtime();
+        if (Math.random() < readRatio) {
+            store.get(key);
+        } else {
+            store.set(key, value);
+        }
+        let diff = process.hrtime(start);
+        let latency = diff[0] * 1e6 + diff[1] / 1e3;
+        let bucket = latency <= 1 ? 0 : Math.ceil(Math.log(latency) / logBase);
+        buckets[bucket] = (buckets[bucket] || 0) + 1;
+        ++operations;
+    }
+    return { operations: operations, buckets: buckets };
+}
+
+/// <summary> Returns the upper bound of the bucket the percentile falls in. </summary>
+function percentile(buckets: number[], count: number, p: number): number {
+    let rank = Math.max(1, Math.ceil(p * count));
+    let seen = 0;
+    for (let i = 0; i < buckets.length; ++i) {
+        seen += buckets[i] || 0;
+        if (seen >= rank) {
+            return Math.pow(BUCKET_BASE, i);
+        }
+    }
+    return 0;
+}
+
+/// <summary> Starts 'hammer' on every worker of a zone at once, and merges their results. </summary>
+async function run(zone: napa.zone.Zone, workers: number, storeId: string, settings: ContentionSettings, durationInMs: number): Promise<ContentionResult> {
+    let startAt = Date.now() + START_DELAY_IN_MS;
+    let calls: Promise<napa.zone.Result>[] = [];
+    for (let i = 0; i < workers; ++i) {
+        calls.push(zone.execute(hammer, [storeId, settings.keys, settings.valueSize, settings.readRatio, startAt, durationInMs]));
+    }
+    let results = await Promise.all(calls);
+
+    let operations = 0;
+    let buckets: number[] = [];
+    for (let result of results) {
+        let value = result.value;
+        operations += value.operations;
+        for (let i = 0; i < value.buckets.length; ++i) {
+            buckets[i] = (buckets[i] || 0) + (value.buckets[i] || 0);
+        }
+    }
+    return {
+        workers: workers,
+        operations: operations,
+        throughput: operations * 1000 / durationInMs,
+        latency: {
+            p50: percentile(buckets, operations, 0.5),
+            p99: percentile(buckets, operations, 0.99),
+            max: percentile(buckets, operations, 1)
+        }
+    };
+}
+
+/// <summary> Hammers one store from each number of workers, and reports throughput and latency percentiles. </summary>
+/// <remarks> Each call of a run is dispatched to its own idle worker, so a run has exactly 'workers' threads on the store. </remarks>
+export async function bench(settings: ContentionSettings = DEFAULT_CONTENTION_SETTINGS): Promise<ContentionResult[]> {
+    console.log(`Benchmarking store contention (${settings.readRatio * 100}% reads, ${settings.keys} keys, ${settings.valueSize} bytes, options ${JSON.stringify(settings.store)})...`);
+
+    let value = generateString(settings.valueSize + 1);
+    let results: ContentionResult[] = [];
+    for (let workers of settings.workers) {
+        let storeId = `store-contention-${workers}`;
+        let store = napa.store.create(storeId, settings.store);
+        for (let i = 0; i < settings.keys; ++i) {
+            store.set(`key${i}`, value);
+        }
+
+        let zone = napa.zone.create(`store-contention-zone-${workers}`, { workers: workers });
+        await run(zone, workers, storeId, settings, settings.warmupInMs);
+        results.push(await run(zone, workers, storeId, settings, settings.durationInMs));
+    }
+
+    let table = [];
+    table.push(["workers", "ops/s", "ops/s per worker", "p50 (us)", "p99 (us)", "max (us)"]);
+    for (let result of results) {
+        table.push([
+            result.workers.toString(),
+            result.throughput.toFixed(0),
+            (result.throughput / result.workers).toFixed(0),
+            result.latency.p50.toFixed(1),
+            result.latency.p99.toFixed(1),
+            result.latency.max.toFixed(1)
+        ]);
+    }
+    console.log("## `store.get` and `store.set` under contention\n");
+    console.log(mdTable(table));
+    console.log();
+
+    return results;
+}
+
+/// <summary>
+///     Parses `--workers=` (comma separated), `--reads=`, `--keys=`, `--value=`, `--shards=`, `--frozen=`,
+///     `--duration=`, `--warmup=` and `--output=` arguments.
+/// </summary>
+function parseArguments(argv: string[]): { settings: ContentionSettings, output: string } {
+    let settings: ContentionSettings = {
+        workers: DEFAULT_CONTENTION_SETTINGS.workers,
+        readRatio: DEFAULT_CONTENTION_SETTINGS.readRatio,
+        keys: DEFAULT_CONTENTION_SETTINGS.keys,
+        valueSize: DEFAULT_CONTENTION_SETTINGS.valueSize,
+        store: {},
+        durationInMs: DEFAULT_CONTENTION_SETTINGS.durationInMs,
+        warmupInMs: DEFAULT_CONTENTION_SETTINGS.warmupInMs
+    };
+    let output: string = null;
+
+    for (let arg of argv) {
+        let match = /^--([a-z]+)=(.*)$/.exec(arg);
+        if (match == null) {
+            throw new Error(`Unknown argument: ${arg}`);
+        }
+        let value = match[2];
+        switch (match[1]) {
+            case 'workers': settings.workers = value.split(',').map(Number); break;
+            case 'reads': settings.readRatio = Number(value); break;
+            case 'keys': settings.keys = Number(value); break;
+            case 'value': settings.valueSize = Number(value); break;
+            case 'shards': settings.store.shards = Number(value); break;
+            case 'frozen': settings.store.frozen = value === 'true'; break;
+            case 'duration': settings.durationInMs = Number(value); break;
+            case 'warmup': settings.warmupInMs = Number(value); break;
+            case 'output': output = value; break;
+            default: throw new Error(`Unknown argument: ${arg}`);
+        }
+    }
+    return { settings: settings, output: output };
+}
+
+if (require.main === module) {
+    let options = parseArguments(process.argv.slice(2));
+    bench(options.settings).then((results: ContentionResult[]) => {
+        let json = JSON.stringify({ settings: options.settings, results: results }, null, 2);
+        if (options.output != null) {
+            fs.writeFileSync(options.output, json);
+        } else {
+            console.log(json);
+        }
+        process.exit(0);
+    }, (error: any) => {
+        console.error(error);
+        process.exit(1);
+    });
+}
@@ -4,7 +4,7 @@
 import * as napa from '../lib/index';
 import * as assert from 'assert';
 import * as mdTable from 'markdown-table';
-import { generateObject, timeDiffInMs, formatTimeDiff, formatRatio } from './bench-utils';
+import { generateObject, generateString, timeDiffInMs, formatTimeDiff, formatRatio } from './bench-utils';
 
 type BenchmarkSettings = [
     string,     // label
@@ -15,6 +15,11 @@ type BenchmarkSettings = [
 ];
 
 export function bench() {
+    benchPayloadTypes();
+    benchMatrix();
+}
+
+function benchPayloadTypes() {
     console.log("Benchmarking transport overhead...");
     let settings: BenchmarkSettings[] = [
         // Number
@@ -89,4 +94,239 @@ export function bench() {
     console.log("## Transport overhead\n");
     console.log(mdTable(table));
     console.log('');
-}
\ No newline at end of file
+}
+const KB = 1024;
+const MB = 1024 * KB;
+
+/// <summary> A small transportable class, to measure the cost of marshalling class instances. </summary>
+@napa.transport.cid('napajs.benchmark.Point')
+class Point extends napa.transport.AutoTransportable {
+    x: number = 0;
+    y: number = 0;
+}
+
+/// <summary> A payload shape, which creates a value of about the given size when marshalled as JSON, or in memory. </summary>
+interface Shape {
+    name: string;
+    create(size: number): any;
+
+    /// <summary> Returns the ArrayBuffers of the value that can be transferred instead of copied, if any. </summary>
+    transferables?(value: any): ArrayBuffer[];
+
+    /// <summary> Whether the value survives JSON.stringify and JSON.parse. </summary>
+    json: boolean;
+}
+
+/// <summary> Builds a binary tree of objects with leaves of about 32 bytes. </summary>
+function createTree(size: number): any {
+    if (size <= 64) {
+        return { value: generateString(16) };
+    }
+    return { left: createTree(size / 2), right: createTree(size / 2) };
+}
+
+const SHAPES: Shape[] = [
+    {
+        // '"key123":"xxxxxxxxx",' is about 24 bytes.
+        name: "flat object",
+        create: (size) => {
+            let object: any = {};
+            for (let i = 0; i < Math.max(1, Math.floor(size / 24)); ++i) {
+                object[`key${i}`] = generateString(10);
+            }
+            return object;
+        },
+        json: true
+    },
+    {
+        name: "nested object",
+        create: createTree,
+        json: true
+    },
+    {
+        // '123456,' is about 7 bytes.
+        name: "array",
+        create: (size) => {
+            let array: number[] = new Array(Math.max(1, Math.floor(size / 7)));
+            for (let i = 0; i < array.length; ++i) {
+                array[i] = i % 1000000;
+            }
+            return array;
+        },
+        json: true
+    },
+    {
+        name: "Float64Array",
+        create: (size) => {
+            let array = new Float64Array(Math.max(1, Math.floor(size / 8)));
+            for (let i = 0; i < array.length; ++i) {
+                array[i] = i;
+            }
+            return array;
+        },
+        transferables: (value) => [value.buffer],
+        json: false
+    },
+    {
+        name: "SharedArrayBuffer",
+        create: (size) => new SharedArrayBuffer(size),
+        json: false
+    },
+    {
+        // '{"_cid":"napajs.benchmark.Point","x":1,"y":2},' is about 50 bytes.
+        name: "Transportable",
+        create: (size) => {
+            let points: Point[] = [];
+            for (let i = 0; i < Math.max(1, Math.floor(size / 50)); ++i) {
+                let point = new Point();
+                point.x = i;
+                point.y = -i;
+                points.push(point);
+            }
+            return points;
+        },
+        json: false
+    }
+];
+
+/// <summary> A way to move a value between isolates, which marshalls it to a payload and unmarshalls it back. </summary>
+interface Mode {
+    name: string;
+    supports(shape: Shape): boolean;
+
+    /// <summary> Marshalls the value, if not set the value is marshalled once upfront and its payload reused. </summary>
+    marshall?(value: any, context: napa.transport.TransportContext, transferList: ArrayBuffer[]): any;
+    unmarshall(payload: any, context: napa.transport.TransportContext): any;
+}
+
+const MODES: Mode[] = [
+    {
+        name: "JSON",
+        supports: (shape) => shape.json,
+        marshall: (value) => JSON.stringify(value),
+        unmarshall: (payload) => JSON.parse(payload)
+    },
+    {
+        name: "AUTO",
+        supports: () => true,
+        marshall: (value, context) => napa.transport.marshall(value, context),
+        unmarshall: (payload, context) => napa.transport.unmarshall(payload, context)
+    },
+    {
+        // With TransportOption.MANUAL, a value is marshalled once and its payload passed to many calls,
+        // so only unmarshalling is paid per call.
+        name: "MANUAL",
+        supports: () => true,
+        unmarshall: (payload, context) => napa.transport.unmarshall(payload, context)
+    },
+    {
+        name: "BINARY",
+        supports: () => true,
+        marshall: (value, context) => napa.transport.marshallBinary(value, context),
+        unmarshall: (payload, context) => napa.transport.unmarshallBinary(payload, context)
+    },
+    {
+        // ArrayBuffers in the transfer list are moved to the receiver without a copy.
+        name: "AUTO + transfer",
+        supports: (shape) => shape.transferables != null,
+        marshall: (value, context, transferList) => napa.transport.marshall(value, context, transferList),
+        unmarshall: (payload, context) => napa.transport.unmarshall(payload, context)
+    }
+];
+
+/// <summary> Returns the V8 heap and external memory in use, after a full GC if node runs with --expose-gc. </summary>
+function memoryInUse(): number {
+    if (typeof (<any>global).gc === 'function') {
+        (<any>global).gc();
+    }
+    let usage = process.memoryUsage();
+    return usage.heapUsed + usage.external;
+}
+
+function formatSize(size: number): string {
+    if (size >= MB) {
+        return (size / MB).toFixed(size % MB === 0 ? 0 : 1) + " MB";
+    }
+    if (size >= KB) {
+        return (size / KB).toFixed(size % KB === 0 ? 0 : 1) + " KB";
+    }
+    return size.toFixed(0) + " B";
+}
+
+function formatThroughput(size: number, repeat: number, timeInMs: number): string {
+    return (size * repeat / MB / (timeInMs / 1000)).toFixed(1);
+}
+
+function payloadSize(payload: any): number {
+    return typeof payload === 'string' ? payload.length : payload.byteLength;
+}
+
+/// <summary>
+///     Measures throughput and memory of marshalling and unmarshalling payloads of 100 B to 100 MB,
+///     for each payload shape and each transport mode that supports it.
+/// </summary>
+/// <param name="maxSize"> The largest payload to measure, in bytes. </param>
+export function benchMatrix(maxSize: number = 100 * MB) {
+    console.log("Benchmarking transport matrix...");
+    let sizes = [100, 10 * KB, MB, 100 * MB].filter((size) => size <= maxSize);
+
+    let table = [];
+    table.push(["size", "shape", "mode", "payload", "marshall (MB/s)", "marshall memory / op", "unmarshall (MB/s)", "unmarshall memory / op"]);
+    for (let size of sizes) {
+        // About 20 MB of payloads per measurement, at most 1000 repeats.
+        const REPEAT = Math.max(1, Math.min(1000, Math.floor(20 * MB / size)));
+        for (let shape of SHAPES) {
+            let value = shape.create(size);
+            for (let mode of MODES) {
+                if (!mode.supports(shape)) {
+                    continue;
+                }
+                let context = napa.transport.createTransportContext();
+                let transferList = shape.transferables != null ? shape.transferables(value) : undefined;
+                let payloads: any[] = new Array(REPEAT);
+
+                // Payloads are kept until unmarshalled, so the memory they take is counted.
+                let marshallThroughput = "-";
+                let marshallMemory = "-";
+                if (mode.marshall == null) {
+                    payloads.fill(napa.transport.marshall(value, context));
+                }
+                else {
+                    let memory = memoryInUse();
+                    let start = process.hrtime();
+                    for (let i = 0; i < REPEAT; ++i) {
+                        payloads[i] = mode.marshall(value, context, transferList);
+                    }
+                    let marshallTime = timeDiffInMs(process.hrtime(start));
+                    marshallThroughput = formatThroughput(size, REPEAT, marshallTime);
+                    marshallMemory = formatSize(Math.max(0, memoryInUse() - memory) / REPEAT);
+                }
+
+                let results: any[] = new Array(REPEAT);
+                let memory = memoryInUse();
+                let start = process.hrtime();
+                for (let i = 0; i < REPEAT; ++i) {
+                    results[i] = mode.unmarshall(payloads[i], context);
+                }
+                let unmarshallTime = timeDiffInMs(process.hrtime(start));
+                let unmarshallMemory = formatSize(Math.max(0, memoryInUse() - memory) / REPEAT);
+
+                table.push([
+                    formatSize(size),
+                    shape.name,
+                    mode.name,
+                    formatSize(payloadSize(payloads[0])),
+                    marshallThroughput,
+                    marshallMemory,
+                    formatThroughput(size, REPEAT, unmarshallTime),
+                    unmarshallMemory]);
+
+                payloads = null;
+                results = null;
+            }
+        }
+    }
+    console.log("## Transport matrix\n");
+    console.log(mdTable(table));
+    console.log('');
+}
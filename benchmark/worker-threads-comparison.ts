@@ -0,0 +1,160 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as napa from '../lib/index';
+import * as mdTable from 'markdown-table';
+import { generateObject, timeDiffInMs, formatTimeDiff, formatRatio } from './bench-utils';
+
+/// <summary> A workload sent to a worker per call, and the function computing it on the worker. </summary>
+interface Workload {
+    label: string;
+    args: () => any[];
+}
+
+/// <summary> Worker counts of the scaling curves. </summary>
+const WORKER_COUNTS = [1, 2, 4, 8, 16, 32, 64];
+
+/// <summary> Calls made per measurement, spread round-robin over the workers. </summary>
+const REPEAT = 10000;
+
+const SHARED_LENGTH = 1024 * 1024;
+
+/// <summary> Functions run by both napa workers and worker_threads, `run` dispatches on the workload kind. </summary>
+function run(kind: string, value: any, start: number, end: number): any {
+    if (kind === 'empty') {
+        return undefined;
+    }
+    if (kind === 'echo') {
+        return value;
+    }
+    // 'shared': sum a slice of an Int32Array on a SharedArrayBuffer, without copying the buffer.
+    let array = new Int32Array(value);
+    let sum = 0;
+    for (let i = start; i < end; ++i) {
+        sum += array[i];
+    }
+    return sum;
+}
+
+/// <summary> Source of a worker_threads worker, answering each message with the result of `run`. </summary>
+const WORKER_THREAD_SOURCE = `
+    const { parentPort } = require('worker_threads');
+    ${run.toString()}
+    parentPort.on('message', (message) => {
+        parentPort.postMessage({ id: message.id, result: run(message.kind, message.value, message.start, message.end) });
+    });
+`;
+
+function makeWorkloads(shared: SharedArrayBuffer): { [kind: string]: Workload } {
+    let object = generateObject(10, 2, 'string', 10);
+    let typedArray = new Float64Array(16 * 1024);
+    for (let i = 0; i < typedArray.length; ++i) {
+        typedArray[i] = i;
+    }
+
+    return {
+        'empty': { label: "dispatch (empty call)", args: () => ['empty', null, 0, 0] },
+        'object': { label: "plain object (2 levels of 10 keys)", args: () => ['echo', object, 0, 0] },
+        'typed': { label: "Float64Array (128 KB)", args: () => ['echo', typedArray, 0, 0] },
+        'shared': { label: "SharedArrayBuffer (sum 64K of 1M ints)", args: () => ['shared', shared, 0, 64 * 1024] }
+    };
+}
+
+/// <summary> A pool of worker_threads workers, called round-robin with promises. </summary>
+class WorkerThreadPool {
+    private _workers: any[] = [];
+    private _pending = new Map<number, () => void>();
+    private _nextId = 0;
+    private _next = 0;
+
+    constructor(workerThreads: any, size: number) {
+        for (let i = 0; i < size; ++i) {
+            let worker = new workerThreads.Worker(WORKER_THREAD_SOURCE, { eval: true });
+            worker.on('message', (message: any) => {
+                let resolve = this._pending.get(message.id);
+                this._pending.delete(message.id);
+                resolve();
+            });
+            this._workers.push(worker);
+        }
+    }
+
+    call(args: any[]): Promise<void> {
+        return new Promise<void>((resolve) => {
+            let id = this._nextId++;
+            this._pending.set(id, resolve);
+            let worker = this._workers[this._next];
+            this._next = (this._next + 1) % this._workers.length;
+            worker.postMessage({ id: id, kind: args[0], value: args[1], start: args[2], end: args[3] });
+        });
+    }
+
+    terminate(): Promise<any> {
+        return Promise.all(this._workers.map((worker) => worker.terminate()));
+    }
+}
+
+/// <summary> Makes REPEAT concurrent calls and returns the elapsed milliseconds. </summary>
+async function time(call: (args: any[]) => Promise<any>, workload: Workload): Promise<number> {
+    // Warm-up.
+    await Promise.all(Array.from({ length: 100 }, () => call(workload.args())));
+
+    let start = process.hrtime();
+    let calls: Promise<any>[] = [];
+    for (let i = 0; i < REPEAT; ++i) {
+        calls.push(call(workload.args()));
+    }
+    await Promise.all(calls);
+    return timeDiffInMs(process.hrtime(start));
+}
+
+export async function bench(): Promise<void> {
+    console.log("Benchmarking napa zone.execute against node worker_threads...");
+
+    let workerThreads: any = null;
+    try {
+        workerThreads = require('worker_threads');
+    } catch (error) {
+        console.log("worker_threads is not available in this version of node, skipping.\n");
+        return;
+    }
+
+    let shared = new SharedArrayBuffer(SHARED_LENGTH * 4);
+    let sharedArray = new Int32Array(shared);
+    for (let i = 0; i < sharedArray.length; ++i) {
+        sharedArray[i] = i % 100;
+    }
+    let workloads = makeWorkloads(shared);
+
+    let tables: { [kind: string]: any[] } = {};
+    for (let kind in workloads) {
+        tables[kind] = [["workers", "napa (ms)", "worker_threads (ms)", "napa calls/ms", "worker_threads calls/ms"]];
+    }
+
+    for (let workers of WORKER_COUNTS) {
+        let zone = napa.zone.create(`worker-threads-comparison-${workers}`, { workers: workers });
+        await zone.broadcast(run.toString());
+        let pool = new WorkerThreadPool(workerThreads, workers);
+
+        for (let kind in workloads) {
+            let workload = workloads[kind];
+            let napaTime = await time((args) => zone.execute("", "run", args), workload);
+            let workerThreadsTime = await time((args) => pool.call(args), workload);
+
+            tables[kind].push([
+                workers.toString(),
+                formatTimeDiff(napaTime),
+                formatTimeDiff(workerThreadsTime) + formatRatio(workerThreadsTime, napaTime),
+                (REPEAT / napaTime).toFixed(2),
+                (REPEAT / workerThreadsTime).toFixed(2)
+            ]);
+        }
+        await pool.terminate();
+    }
+
+    for (let kind in workloads) {
+        console.log(`## ${workloads[kind].label}, ${REPEAT} calls\n`);
+        console.log(mdTable(tables[kind]));
+        console.log();
+    }
+}
@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as childProcess from 'child_process';
+import * as fs from 'fs';
+import * as os from 'os';
+import * as path from 'path';
+import * as mdTable from 'markdown-table';
+import { timeDiffInMs, formatTimeDiff } from './bench-utils';
+
+/// <summary> A way to start workers, measured in a process of its own since platform settings and RSS are per process. </summary>
+interface StartupConfiguration {
+    name: string;
+
+    /// <summary> Platform settings of the process. </summary>
+    platform: any;
+
+    /// <summary> Settings of the zone, besides workers. </summary>
+    zone: any;
+
+    /// <summary> Whether a first process runs to create the files the measured one starts from, like a snapshot. </summary>
+    primed: boolean;
+}
+
+/// <summary> Measurement of one zone in one process, sizes are in bytes. </summary>
+export interface StartupResult {
+    configuration: string;
+    workers: number;
+
+    /// <summary> Milliseconds from napa.zone.create until every worker ran a broadcast. </summary>
+    timeToReady: number;
+
+    /// <summary> Growth of the resident set of the process, per worker. </summary>
+    rssPerWorker: number;
+
+    /// <summary> Average used V8 heap of a worker. </summary>
+    heapUsedPerWorker: number;
+
+    /// <summary> Average V8 heap reserved by a worker. </summary>
+    heapTotalPerWorker: number;
+}
+
+/// <summary> Number of functions of the generated module, about 1 MB of source. </summary>
+const MODULE_FUNCTIONS = 5000;
+
+/// <summary> Writes a module defining many functions, as a stand-in for an application loaded at startup. </summary>
+function writeModule(file: string) {
+    let lines: string[] = [];
+    for (let i = 0; i < MODULE_FUNCTIONS; ++i) {
+        lines.push(`function f${i}(a, b) { var s = 0; for (var i = 0; i < a; ++i) { s += (i * ${i}) % (b + 1); } return s + '${i}'; }`);
+    }
+    lines.push(`var functions = [${Array.from(Array(MODULE_FUNCTIONS).keys()).map((i) => `f${i}`).join(', ')}];`);
+    lines.push(`if (typeof module !== 'undefined') { module.exports = functions; }`);
+    fs.writeFileSync(file, lines.join('\n'));
+}
+
+function createConfigurations(directory: string): StartupConfiguration[] {
+    let moduleFile = path.join(directory, 'startup-module.js');
+    writeModule(moduleFile);
+
+    return [
+        {
+            name: "default",
+            platform: {},
+            zone: {},
+            primed: false
+        },
+        {
+            name: "preload",
+            platform: {},
+            zone: { preload: [moduleFile] },
+            primed: false
+        },
+        {
+            name: "preload + code cache",
+            platform: { codeCacheDirectory: path.join(directory, 'code-cache') },
+            zone: { preload: [moduleFile] },
+            primed: true
+        },
+        {
+            name: "startup snapshot",
+            platform: {},
+            zone: { startupScript: moduleFile, startupSnapshot: path.join(directory, 'startup.snapshot') },
+            primed: true
+        },
+        {
+            name: "prewarmed isolates",
+            platform: { prewarmIsolates: -1 },
+            zone: {},
+            primed: false
+        }
+    ];
+}
+
+/// <summary> Runs in a child process: creates one zone and measures it. </summary>
+async function measure(configuration: StartupConfiguration, workers: number): Promise<StartupResult> {
+    const napa = require('../lib/index');
+
+    let platform = Object.assign({}, configuration.platform);
+    if (platform.prewarmIsolates < 0) {
+        platform.prewarmIsolates = workers;
+    }
+    napa.runtime.setPlatformSettings(platform);
+
+    if (platform.prewarmIsolates > 0) {
+        // Give isolates time to be created in the background, as they are before a zone is needed.
+        await new Promise((resolve) => setTimeout(resolve, 1000 + 100 * workers));
+    }
+
+    let rss = process.memoryUsage().rss;
+    let start = process.hrtime();
+    let zone = napa.zone.create('startup-zone', Object.assign({ workers: workers }, configuration.zone));
+    await zone.broadcast('');
+    let timeToReady = timeDiffInMs(process.hrtime(start));
+    let rssGrowth = process.memoryUsage().rss - rss;
+
+    let statistics: any[] = await zone.getHeapStatistics();
+    let heapUsed = statistics.reduce((total, s) => total + s.usedHeapSize, 0);
+    let heapTotal = statistics.reduce((total, s) => total + s.totalHeapSize, 0);
+
+    return {
+        configuration: configuration.name,
+        workers: workers,
+        timeToReady: timeToReady,
+        rssPerWorker: rssGrowth / workers,
+        heapUsedPerWorker: heapUsed / statistics.length,
+        heapTotalPerWorker: heapTotal / statistics.length
+    };
+}
+
+/// <summary> Runs 'measure' in a new node process, which prints the result as JSON. </summary>
+function spawn(configuration: StartupConfiguration, workers: number): StartupResult {
+    let output = childProcess.execFileSync(
+        process.execPath,
+        [__filename, `--child=${JSON.stringify({ configuration: configuration, workers: workers })}`],
+        { encoding: 'utf8' });
+    let lines = output.trim().split('\n');
+    return JSON.parse(lines[lines.length - 1]);
+}
+
+function formatMB(bytes: number): string {
+    return (bytes / 1024 / 1024).toFixed(1);
+}
+
+/// <summary>
+///     Measures time-to-ready and memory of zones of each size for each startup configuration,
+///     each in a new process after a priming process where the configuration creates files to start from.
+/// </summary>
+export function bench(workerCounts: number[] = [1, 4, 16]): StartupResult[] {
+    console.log("Benchmarking zone startup...");
+
+    let directory = fs.mkdtempSync(path.join(os.tmpdir(), 'napa-zone-startup-'));
+    let results: StartupResult[] = [];
+    for (let configuration of createConfigurations(directory)) {
+        if (configuration.primed) {
+            spawn(configuration, 1);
+        }
+        for (let workers of workerCounts) {
+            results.push(spawn(configuration, workers));
+        }
+    }
+
+    let table = [];
+    table.push(["configuration", "workers", "time to ready (ms)", "RSS / worker (MB)", "heap used / worker (MB)", "heap total / worker (MB)"]);
+    for (let result of results) {
+        table.push([
+            result.configuration,
+            result.workers.toString(),
+            formatTimeDiff(result.timeToReady),
+            formatMB(result.rssPerWorker),
+            formatMB(result.heapUsedPerWorker),
+            formatMB(result.heapTotalPerWorker)
+        ]);
+    }
+    console.log("## Zone startup\n");
+    console.log(mdTable(table));
+    console.log();
+
+    return results;
+}
+
+if (require.main === module) {
+    let child = process.argv.slice(2).filter((arg) => arg.startsWith('--child='));
+    if (child.length !== 0) {
+        let options = JSON.parse(child[0].substr('--child='.length));
+        measure(options.configuration, options.workers).then((result: StartupResult) => {
+            console.log(JSON.stringify(result));
+            process.exit(0);
+        }, (error: any) => {
+            console.error(error);
+            process.exit(1);
+        });
+    } else {
+        let workers = process.argv.slice(2)
+            .filter((arg) => arg.startsWith('--workers='))
+            .map((arg) => arg.substr('--workers='.length).split(',').map(Number));
+        let results = workers.length !== 0 ? bench(workers[0]) : bench();
+        let output = process.argv.slice(2).filter((arg) => arg.startsWith('--output='));
+        if (output.length !== 0) {
+            fs.writeFileSync(output[0].substr('--output='.length), JSON.stringify(results, null, 2));
+        }
+    }
+}
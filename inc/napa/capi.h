@@ -35,6 +35,60 @@ EXTERN_C NAPA_API napa_zone_handle napa_zone_get_current();
 /// <param name="handle"> The zone handle. </param>
 EXTERN_C NAPA_API napa_result_code napa_zone_release(napa_zone_handle handle);
 
+/// <summary>
+///     Runs the calls queued on the zone, then disposes its workers and frees its id for a new zone, while handles
+///     to it may still be held. Calls made through any handle of the zone afterwards fail with NAPA_RESULT_ZONE_RECYCLED.
+///     Handles still have to be released.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <returns> NAPA_RESULT_ZONE_RECYCLE_ERROR for the node zone, or if called from a worker of the zone. </returns>
+EXTERN_C NAPA_API napa_result_code napa_zone_recycle(napa_zone_handle handle);
+
+/// <summary>
+///     Connects to a zone served by another process or host, see napa_zone_serve.
+///     Calls are sent as module and function names with marshalled arguments, they can't transport shared objects.
+/// </summary>
+/// <param name="address"> The address the zone is served on, like 'host:port'. </param>
+/// <param name="connections"> The number of TCP connections calls are spread on, at least 1. </param>
+/// <returns> A handle whose id is the id of the remote zone, or null if the address doesn't serve a zone. </returns>
+/// <remarks> This function returns a handle that must be released when it's no longer needed, which closes the connections. </remarks>
+EXTERN_C NAPA_API napa_zone_handle napa_zone_connect(napa_string_ref address, uint32_t connections);
+
+/// <summary> Serves a zone to napa_zone_connect of other processes or hosts, until napa_zone_stop_serving or shutdown. </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="address"> The address to listen on, like '0.0.0.0:port', port 0 for a port chosen by the system. </param>
+/// <param name="port"> Receives the port the zone is served on. </param>
+/// <returns> NAPA_RESULT_REMOTE_CONNECTION_ERROR if the address can't be listened on. </returns>
+/// <remarks> Clients are not authenticated, a zone should only be served on a trusted network. </remarks>
+EXTERN_C NAPA_API napa_result_code napa_zone_serve(napa_zone_handle handle, napa_string_ref address, uint16_t* port);
+
+/// <summary> Stops serving the zone served on a port and closes its connections, nothing if no zone is served on it. </summary>
+/// <param name="port"> The port returned by napa_zone_serve. </param>
+EXTERN_C NAPA_API napa_result_code napa_zone_stop_serving(uint16_t port);
+
+/// <summary>
+///     Connects to a zone served by another process of the host on shared memory, see napa_zone_serve_shared_memory.
+///     Calls are made like with napa_zone_connect, and are copied through rings of the shared memory rather than sockets.
+/// </summary>
+/// <param name="name"> The name the zone is served on. </param>
+/// <param name="connections"> The number of channels calls are spread on, at least 1. </param>
+/// <returns> A handle whose id is the id of the remote zone, or null if no running process serves the name. </returns>
+/// <remarks> This function returns a handle that must be released when it's no longer needed, which closes the channels. </remarks>
+EXTERN_C NAPA_API napa_zone_handle napa_zone_connect_shared_memory(napa_string_ref name, uint32_t connections);
+
+/// <summary>
+///     Serves a zone to napa_zone_connect_shared_memory of other processes of the host,
+///     until napa_zone_stop_serving_shared_memory or shutdown.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="name"> The name of the shared memory segment, without path separators. </param>
+/// <returns> NAPA_RESULT_REMOTE_CONNECTION_ERROR if the segment can't be created, or a running process serves the name. </returns>
+EXTERN_C NAPA_API napa_result_code napa_zone_serve_shared_memory(napa_zone_handle handle, napa_string_ref name);
+
+/// <summary> Stops serving the zone served on a shared memory name and closes its channels, nothing if none is served on it. </summary>
+/// <param name="name"> The name given to napa_zone_serve_shared_memory. </param>
+EXTERN_C NAPA_API napa_result_code napa_zone_stop_serving_shared_memory(napa_string_ref name);
+
 /// <summary>
 ///     Initializes the napa zone, providing specific settings.
 ///     The provided settings override any settings that were previously set.
@@ -50,6 +104,23 @@ EXTERN_C NAPA_API napa_result_code napa_zone_init(
 /// <param name="handle"> The zone handle. </param>
 EXTERN_C NAPA_API napa_string_ref napa_zone_get_id(napa_zone_handle handle);
 
+/// <summary> Retrieves the number of calls that are waiting for a zone worker. </summary>
+/// <param name="handle"> The zone handle. </param>
+EXTERN_C NAPA_API size_t napa_zone_get_queue_length(napa_zone_handle handle);
+
+/// <summary> Retrieves the number of running zone workers. </summary>
+/// <param name="handle"> The zone handle. </param>
+EXTERN_C NAPA_API uint32_t napa_zone_get_worker_count(napa_zone_handle handle);
+
+/// <summary>
+///     Cancels the calls that were made with the given cancellation token.
+///     Queued calls are dropped before they run, running calls are terminated.
+///     Both are completed with NAPA_RESULT_CANCELLED. Calls made with the token afterwards are not affected.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="token"> The cancellation token of the calls, see napa_zone_call_options. </param>
+EXTERN_C NAPA_API void napa_zone_cancel(napa_zone_handle handle, uint64_t token);
+
 /// <summary> Executes a pre-loaded function asynchronously on all zone workers. </summary>
 /// <param name="handle"> The zone handle. </param>
 /// <param name="spec"> The function spec to call. </param>
@@ -61,6 +132,24 @@ EXTERN_C NAPA_API void napa_zone_broadcast(
     napa_zone_broadcast_callback callback,
     void* context);
 
+/// <summary>
+///     Executes a pre-loaded function asynchronously on some zone workers, i.e. to roll out a config in stages.
+///     The workers run it again when they are restarted, like for napa_zone_broadcast.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="spec"> The function spec to call. </param>
+/// <param name="worker_ids"> The ids of the workers to run it. </param>
+/// <param name="worker_ids_count"> The number of worker ids, 0 to run it on all workers. </param>
+/// <param name="callback"> A callback that is triggered when the running workers among them are done. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+EXTERN_C NAPA_API void napa_zone_broadcast_to_workers(
+    napa_zone_handle handle,
+    napa_zone_function_spec spec,
+    const uint32_t* worker_ids,
+    size_t worker_ids_count,
+    napa_zone_broadcast_callback callback,
+    void* context);
+
 /// <summary> Executes a pre-loaded function asynchronously in a single zone worker. </summary>
 /// <param name="handle"> The zone handle. </param>
 /// <param name="spec"> The function spec to call. </param>
@@ -72,6 +161,177 @@ EXTERN_C NAPA_API void napa_zone_execute(
     napa_zone_execute_callback callback,
     void* context);
 
+/// <summary>
+///     Executes a pre-loaded function asynchronously on the given zone worker, after the calls already queued on it,
+///     i.e. for state sharded across workers. Calls on a worker that isn't running complete with
+///     NAPA_RESULT_WORKER_NOT_RUNNING. The calls queued on each worker are reported by napa_zone_get_stats.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="worker_id"> The id of the worker. </param>
+/// <param name="spec"> The function spec to call. </param>
+/// <param name="callback"> A callback that is triggered when execution is done. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+EXTERN_C NAPA_API void napa_zone_execute_on_worker(
+    napa_zone_handle handle,
+    uint32_t worker_id,
+    napa_zone_function_spec spec,
+    napa_zone_execute_callback callback,
+    void* context);
+
+/// <summary>
+///     Executes a pre-loaded function asynchronously in a single zone worker, and hands the result over without
+///     copying it. The marshalled return value is moved into a reference counted buffer, the result strings stay
+///     valid after the callback returns, until the last reference of the buffer is released.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="spec"> The function spec to call. </param>
+/// <param name="callback"> A callback that is triggered when execution is done, it owns one reference of the buffer. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+EXTERN_C NAPA_API void napa_zone_execute_retained(
+    napa_zone_handle handle,
+    napa_zone_function_spec spec,
+    napa_zone_execute_retained_callback callback,
+    void* context);
+
+/// <summary>
+///     Executes a pre-loaded function asynchronously in a single zone worker, and writes the return value into a
+///     buffer of the caller. If the return value doesn't fit, the result code is NAPA_RESULT_RESULT_BUFFER_TOO_SMALL
+///     and return_value has a null data with the size needed. The error message is only valid during the callback.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="spec"> The function spec to call. </param>
+/// <param name="buffer"> The buffer to write the return value into, which must stay valid until the callback. </param>
+/// <param name="buffer_size"> The size of the buffer in bytes. </param>
+/// <param name="callback"> A callback that is triggered when execution is done. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+EXTERN_C NAPA_API void napa_zone_execute_into(
+    napa_zone_handle handle,
+    napa_zone_function_spec spec,
+    char* buffer,
+    size_t buffer_size,
+    napa_zone_execute_callback callback,
+    void* context);
+
+/// <summary>
+///     Executes a pre-loaded function in a single zone worker and blocks the calling thread until it is done, for
+///     embedders calling from their own threads. The thread waits on a futex of a per thread slot, so the call
+///     doesn't allocate a promise. It must not be called from a worker of the zone, which could wait for itself.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="spec"> The function spec to call. </param>
+/// <param name="timeout"> The longest time in milliseconds to wait, the call keeps running if it's exceeded. </param>
+/// <param name="result">
+///     Set to the result of the call, or to a NAPA_RESULT_TIMEOUT result if the wait timed out. Its strings are valid
+///     until the next napa_zone_execute_sync on the same thread, and it owns the transport context if any.
+/// </param>
+/// <returns> The code of the result. </returns>
+EXTERN_C NAPA_API napa_result_code napa_zone_execute_sync(
+    napa_zone_handle handle,
+    napa_zone_function_spec spec,
+    uint32_t timeout,
+    napa_zone_result* result);
+
+/// <summary> Adds a reference to a result buffer, to keep its strings alive for another owner. </summary>
+/// <param name="buffer"> The result buffer. </param>
+EXTERN_C NAPA_API void napa_result_retain(napa_result_buffer_handle buffer);
+
+/// <summary> Releases a reference of a result buffer, the buffer is freed with its last reference. </summary>
+/// <param name="buffer"> The result buffer, or null to do nothing. </param>
+EXTERN_C NAPA_API void napa_result_release(napa_result_buffer_handle buffer);
+
+/// <summary>
+///     Executes a batch of pre-loaded functions asynchronously.
+///     The batch is split into per worker chunks, each running as a single task,
+///     and all results are delivered through one callback.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="specs"> The function specs to call. </param>
+/// <param name="specs_count"> The number of function specs. </param>
+/// <param name="callback"> A callback that is triggered when all executions are done. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+EXTERN_C NAPA_API void napa_zone_execute_batch(
+    napa_zone_handle handle,
+    const napa_zone_function_spec* specs,
+    size_t specs_count,
+    napa_zone_execute_batch_callback callback,
+    void* context);
+
+/// <summary>
+///     Runs a native function asynchronously on a zone worker, i.e. CPU bound work sharing the zone workers with
+///     its JS calls. The function is scheduled like a call, without a call context, marshalling or V8 handle scope,
+///     so it must not use V8. Node zones have no workers to run it on, the callback gets NAPA_RESULT_WORKER_NOT_RUNNING.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="function"> The native function. </param>
+/// <param name="context"> An opaque pointer that is passed to the function and the callback. </param>
+/// <param name="callback">
+///     A callback that is triggered once the function ran, or with the code it was dropped with,
+///     i.e. NAPA_RESULT_ZONE_OVERLOADED. It can be null.
+/// </param>
+EXTERN_C NAPA_API void napa_zone_execute_native(
+    napa_zone_handle handle,
+    napa_zone_native_function function,
+    void* context,
+    napa_zone_native_callback callback);
+
+/// <summary> Collects the V8 heap statistics of the running zone workers asynchronously. </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="callback"> A callback that is triggered with the statistics of each worker once all reported. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+EXTERN_C NAPA_API void napa_zone_get_heap_statistics(
+    napa_zone_handle handle,
+    napa_zone_heap_statistics_callback callback,
+    void* context);
+
+/// <summary> Reads the utilization counters of the zone and its running workers. </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="callback"> A callback that is called synchronously with the statistics. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+EXTERN_C NAPA_API void napa_zone_get_stats(
+    napa_zone_handle handle,
+    napa_zone_stats_callback callback,
+    void* context);
+
+/// <summary> Reads the statistics of the calls of each function that ran in the zone. </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="callback"> A callback that is called synchronously with the statistics, ordered by module and function. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+EXTERN_C NAPA_API void napa_zone_get_function_stats(
+    napa_zone_handle handle,
+    napa_zone_function_stats_callback callback,
+    void* context);
+
+/// <summary>
+///     Notifies the running zone workers of memory pressure, so their isolates collect garbage
+///     before the calls they have queued.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="level"> The memory pressure level. </param>
+EXTERN_C NAPA_API void napa_zone_notify_memory_pressure(napa_zone_handle handle, napa_memory_pressure_level level);
+
+/// <summary>
+///     Starts sampling the CPU profile of zone workers with the V8 CPU profiler, before the calls they have queued.
+///     Workers that are already profiling keep their profile.
+/// </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="worker_ids"> The ids of the workers to profile. </param>
+/// <param name="worker_ids_count"> The number of worker ids, 0 to profile all running workers. </param>
+/// <param name="sampling_interval"> The sampling interval in microseconds, 0 for the V8 default. </param>
+EXTERN_C NAPA_API void napa_zone_start_profiling(
+    napa_zone_handle handle,
+    const uint32_t* worker_ids,
+    size_t worker_ids_count,
+    uint32_t sampling_interval);
+
+/// <summary> Stops the CPU profiling of all zone workers asynchronously. </summary>
+/// <param name="handle"> The zone handle. </param>
+/// <param name="callback"> A callback that is triggered with the profiles of the workers that were profiling. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+EXTERN_C NAPA_API void napa_zone_stop_profiling(
+    napa_zone_handle handle,
+    napa_zone_cpu_profiles_callback callback,
+    void* context);
+
 /// <summary>
 ///     Global napa initialization. Invokes initialization steps that are cross zones.
 ///     The settings passed represent the defaults for all the zones
@@ -124,3 +384,51 @@ EXTERN_C NAPA_API void* napa_malloc(size_t size);
 /// <param name="pointer"> Pointer to memory to be freed. </param>
 /// <param name="size_hint"> Hint of size to deallocate. </param>
 EXTERN_C NAPA_API void napa_free(void* pointer, size_t size_hint);
+
+/// <summary> Allocate memory from the size class pools with thread caches of napa.dll. </summary>
+/// <param name="size"> Size of memory requested in byte. </param>
+/// <returns> Allocated memory. </returns>
+EXTERN_C NAPA_API void* napa_pool_allocate(size_t size);
+
+/// <summary> Free memory from napa_pool_allocate, on any thread. </summary>
+/// <param name="pointer"> Pointer to memory to be freed. </param>
+/// <param name="size_hint"> Hint of size to deallocate. </param>
+EXTERN_C NAPA_API void napa_pool_deallocate(void* pointer, size_t size_hint);
+
+/// <summary> Reads all metrics of the in-process metric provider. </summary>
+/// <param name="format"> The format of the snapshot. </param>
+/// <param name="callback"> A callback that is called synchronously with the snapshot. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+/// <returns> NAPA_RESULT_METRIC_SNAPSHOT_ERROR if the configured metric provider isn't 'in-process'. </returns>
+EXTERN_C NAPA_API napa_result_code napa_metric_snapshot(
+    napa_metric_snapshot_format format,
+    napa_metric_snapshot_callback callback,
+    void* context);
+
+/// <summary> Writes the modules loaded so far by the zones of this process to a bundle file. </summary>
+/// <param name="path"> The bundle file path, replaced if it exists. </param>
+/// <remarks> Zones created with the 'bundle' setting then load the modules from the bundle. </remarks>
+/// <returns> NAPA_RESULT_MODULE_BUNDLE_ERROR if the file can't be written. </returns>
+EXTERN_C NAPA_API napa_result_code napa_module_bundle_write(napa_string_ref path);
+
+/// <summary> Starts recording scheduler, worker, timer, async completion and GC events of all zones. </summary>
+/// <param name="events_per_thread"> The number of events each thread records at most, 0 for the default. </param>
+/// <returns> NAPA_RESULT_TRACE_STARTED if a trace is already recorded. </returns>
+EXTERN_C NAPA_API napa_result_code napa_trace_start(size_t events_per_thread);
+
+/// <summary> Stops recording and returns the trace in Chrome trace event JSON. </summary>
+/// <param name="callback"> A callback that is called synchronously with the trace. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+/// <returns> NAPA_RESULT_TRACE_NOT_STARTED if no trace is recorded. </returns>
+EXTERN_C NAPA_API napa_result_code napa_trace_stop(napa_trace_callback callback, void* context);
+
+/// <summary> Sets the share of new traces of zone calls whose spans are recorded, and how many spans are kept. </summary>
+/// <param name="sample_rate"> From 0, which records no spans and is the default, to 1, which records all of them. </param>
+/// <param name="capacity"> The number of spans kept until they are exported, 0 for the default. </param>
+/// <remarks> Calls continue the trace of the call they are made from, so each trace is sampled as a whole. </remarks>
+EXTERN_C NAPA_API void napa_spans_set_sampling(double sample_rate, size_t capacity);
+
+/// <summary> Takes the spans recorded since the last export, as a JSON array ordered from the oldest span. </summary>
+/// <param name="callback"> A callback that is called synchronously with the spans. </param>
+/// <param name="context"> An opaque pointer that is passed back in the callback. </param>
+EXTERN_C NAPA_API void napa_spans_export(napa_trace_callback callback, void* context);
@@ -11,6 +11,14 @@
 /// <summary> The maximum string length of a single log call. Anything over will be truncated. </summary>
 const size_t LOG_MAX_SIZE = 512;
 
+/// <summary>
+///     The most verbose level compiled in, from 0 (Error) to 3 (Debug), set by the NAPA_LOG_LEVEL cmake option.
+///     More verbose LOG_* calls compile to nothing.
+/// </summary>
+#ifndef NAPA_LOG_LEVEL_MAX
+#define NAPA_LOG_LEVEL_MAX 3
+#endif
+
 inline void LogFormattedMessage(
     napa::providers::LoggingProvider& logger,
     const char* section,
@@ -32,11 +40,13 @@ inline void LogFormattedMessage(
 
 #ifndef NAPA_LOG_DISABLED
 
-#define LOG(section, level, traceId, format, ...) do {                                                   \
-    auto& logger = napa::providers::GetLoggingProvider();                                                \
-    if (logger.IsLogEnabled(section, level)) {                                                           \
-        LogFormattedMessage(logger, section, level, traceId, __FILE__, __LINE__, format, ##__VA_ARGS__); \
-    }                                                                                                    \
+#define LOG(section, level, traceId, format, ...) do {                                                       \
+    if (static_cast<int>(level) <= NAPA_LOG_LEVEL_MAX && napa::providers::IsLogLevelEnabled(level)) {        \
+        auto& logger = napa::providers::GetLoggingProvider();                                                \
+        if (logger.IsLogEnabled(section, level)) {                                                           \
+            LogFormattedMessage(logger, section, level, traceId, __FILE__, __LINE__, format, ##__VA_ARGS__); \
+        }                                                                                                    \
+    }                                                                                                        \
 } while (false)
 
 #else
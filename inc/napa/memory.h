@@ -5,7 +5,9 @@
 
 #include <napa/capi.h>
 #include <napa/memory/allocator.h>
+#include <napa/memory/array-buffer-pool.h>
 #include <napa/memory/common.h>
+#include <napa/memory/malloc-library.h>
 
 #define NAPA_MALLOC(size) ::napa_malloc(size)
 #define NAPA_FREE(pointer, sizeHint) ::napa_free(pointer, sizeHint)
@@ -17,6 +19,9 @@
 
 #define NAPA_DEFAULT_ALLOCATOR napa::memory::GetDefaultAllocator()
 #define NAPA_CRT_ALLOCATOR napa::memory::GetCrtAllocator()
+#define NAPA_POOL_ALLOCATOR napa::memory::GetPoolAllocator()
+#define NAPA_ZONE_ALLOCATOR napa::memory::GetZoneAllocator()
+#define NAPA_TASK_ARENA napa::memory::GetTaskArena()
 
 #define NAPA_MAKE_UNIQUE napa::memory::MakeUnique
 #define NAPA_MAKE_SHARED napa::memory::MakeShared
@@ -38,5 +38,19 @@ namespace memory {
 
     /// <summary> Get a long living default allocator for convenience. User can create their own as well.</summary>
     NAPA_API Allocator& GetDefaultAllocator();
+
+    /// <summary> Get a long living allocator of size class pools with thread caches, for many small and short lived allocations. </summary>
+    NAPA_API Allocator& GetPoolAllocator();
+
+    /// <summary> Get the allocator of the zone the calling worker belongs to, the default allocator outside of napa zones. </summary>
+    NAPA_API Allocator& GetZoneAllocator();
+
+    /// <summary> Get the bump pointer arena of the calling worker for request scoped data. </summary>
+    /// <remarks>
+    ///     Its memory is released at once after each call task, so it must not be kept beyond the synchronous part of
+    ///     the call, e.g. by asynchronous work. Outside of napa zones it is the zone allocator, which is why callers
+    ///     still deallocate, which the arena ignores.
+    /// </remarks>
+    NAPA_API Allocator& GetTaskArena();
 }
 }
\ No newline at end of file
@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/exports.h>
+#include <cstdint>
+
+namespace napa {
+namespace memory {
+
+    /// <summary> Statistics of the pool that all isolates allocate ArrayBuffer memory from. </summary>
+    struct ArrayBufferPoolStats {
+
+        /// <summary> The number of buffers allocated so far. </summary>
+        uint64_t allocations;
+
+        /// <summary> The number of allocations served by a pooled block. </summary>
+        uint64_t poolHits;
+
+        /// <summary> The number of blocks mapped from the system. </summary>
+        uint64_t mappedBlocks;
+
+        /// <summary> The number of mapped blocks backed by huge pages. </summary>
+        uint64_t hugePageBlocks;
+
+        /// <summary> The number and total length of the buffers in use. </summary>
+        uint64_t liveBuffers;
+        uint64_t liveSize;
+
+        /// <summary> The number and total size of the released blocks kept for reuse. </summary>
+        uint64_t pooledBlocks;
+        uint64_t pooledSize;
+    };
+
+    /// <summary> Get the statistics of the ArrayBuffer pool. </summary>
+    NAPA_API ArrayBufferPoolStats GetArrayBufferPoolStats();
+}
+}
@@ -6,29 +6,36 @@
 #include <napa/capi.h>
 #include <napa/memory/allocator.h>
 #include <napa/stl/allocator.h>
+#include <napa/stl/static-allocator.h>
 #include <memory>
 #include <type_traits>
 
 namespace napa {
 namespace memory {
+    /// <summary> Deleter using an allocation policy of napa::stl::StaticAllocator. </summary>
+    template <typename T, typename Policy>
+    void PolicyDeleter(T* object) {
+        static_assert(std::is_destructible<T>::value, "Not destructible.");
+        object->~T();
+        Policy::Deallocate(object, sizeof(T));
+    }
+
     /// <summary> Deleter using Napa's default allocator. </summary>
     template <typename T>
     void DefaultDeleter(T* object) {
-        static_assert(std::is_destructible<T>::value, "Not destructible.");
-        object->~T();
-        ::napa_deallocate(object, sizeof(T));
+        PolicyDeleter<T, napa::stl::DefaultAllocationPolicy>(object);
     }
 
     /// <summary> std::unique_ptr using Napa default allocator. </summary>
     template <typename T>
     using UniquePtr = std::unique_ptr<T, void (*)(T*)>;
 
-    /// <summary> std::make_unique using Napa default allocator. </summary>
-    template <typename T, typename... Args>
+    /// <summary> std::make_unique using an allocation policy, Napa default allocator unless specified. </summary>
+    template <typename T, typename Policy = napa::stl::DefaultAllocationPolicy, typename... Args>
     UniquePtr<T> MakeUnique(Args&&... args) {
-        void* memory = ::napa_allocate(sizeof(T));
+        void* memory = Policy::Allocate(sizeof(T));
         T* t = new (memory) T(std::forward<Args>(args)...);
-        return UniquePtr<T>(t, DefaultDeleter<T>);
+        return UniquePtr<T>(t, PolicyDeleter<T, Policy>);
     }
 
     /// <summary> std::allocate_shared using napa::memory::Allocator. </summary>
@@ -39,11 +46,12 @@ namespace memory {
             std::forward<Args>(args)...);
     }
 
-    /// <summary> std::make_shared using Napa default allocator. </summary>
-    template <typename T, typename... Args>
+    /// <summary> std::make_shared using an allocation policy, Napa default allocator unless specified. </summary>
+    /// <remarks> The control block and object are allocated without going through napa::memory::Allocator. </remarks>
+    template <typename T, typename Policy = napa::stl::DefaultAllocationPolicy, typename... Args>
     std::shared_ptr<T> MakeShared(Args&&... args) {
-        return AllocateShared<T>(
-            GetDefaultAllocator(), 
+        return std::allocate_shared<T>(
+            napa::stl::StaticAllocator<T, Policy>(),
             std::forward<Args>(args)...);
     }
 }
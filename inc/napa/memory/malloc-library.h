@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/exports.h>
+#include <cstdint>
+
+namespace napa {
+namespace memory {
+
+    /// <summary> Statistics of the malloc library selected by the defaultAllocator platform setting. </summary>
+    /// <remarks> Sizes a library doesn't report are 0. </remarks>
+    struct MallocLibraryStats {
+
+        /// <summary> 'mimalloc' or 'jemalloc', or empty if no malloc library is in use. </summary>
+        const char* name;
+
+        /// <summary> Bytes allocated by the application. </summary>
+        uint64_t allocatedSize;
+
+        /// <summary> Bytes the library committed, including its free lists and metadata. </summary>
+        uint64_t committedSize;
+
+        /// <summary> Bytes of memory resident in physical pages. </summary>
+        uint64_t residentSize;
+
+        /// <summary> The most bytes that were resident in physical pages. </summary>
+        uint64_t peakResidentSize;
+    };
+
+    /// <summary> Get the statistics of the malloc library in use. </summary>
+    NAPA_API MallocLibraryStats GetMallocLibraryStats();
+}
+}
@@ -120,3 +120,4 @@
 
 // Depends on NAPA_GET_PERSISTENT_CONSTRUCTOR.
 #include "napa/module/common.h"
+#include "napa/module/function-binding.h"
@@ -53,6 +53,16 @@ namespace binding {
                 v8::Local<v8::Function>::Cast(require)->Call(isolate->GetCurrentContext(), bindingModule, 1, argv)));
     }
 
+    /// <summary> Find the wrap of a shared object created in the current isolate. </summary>
+    /// <param name="object"> Pointer of the shared object. </param>
+    /// <param name="wrapType"> Class name of the wrap, object may be wrapped by different wrap types. </param>
+    /// <returns> The wrap if it's still alive and holds the object, otherwise an empty handle. </returns>
+    NAPA_BINDING_API v8::Local<v8::Object> FindShareableWrap(const void* object, const char* wrapType);
+
+    /// <summary> Cache the wrap of a shared object in the current isolate, so transporting the object again reuses it. </summary>
+    /// <remarks> The wrap is held weakly, it's dropped from the cache once collected. </remarks>
+    NAPA_BINDING_API void CacheShareableWrap(const void* object, const char* wrapType, v8::Local<v8::Object> wrap);
+
     /// <summary> Create a new instance of a wrap type exported from napa binding. </summary>
     inline v8::MaybeLocal<v8::Object> NewInstance(const char* wrapType, int argc, v8::Local<v8::Value> argv[]) {
         auto isolate = v8::Isolate::GetCurrent();
@@ -14,12 +14,27 @@ namespace binding {
     /// <summary> It creates a new instance of wrapType with a shared_ptr<T>. </summary>
     /// <param name="object"> shared_ptr of object. </summary>
     /// <param name="wrapType"> wrap type from napa-binding, which extends napa::module::Sharable. </param>
+    /// <param name="externalSize"> Bytes of native memory held by the object, reported to V8 by the wrap. </param>
     /// <returns> V8 object of wrapType. </summary>
-    
+    /// <remarks> The wrap of an object is reused while it's alive in the current isolate. </remarks>
     template <typename T>
-    inline v8::Local<v8::Object> CreateShareableWrap(std::shared_ptr<T> object, const char* wrapType = "SharedPtrWrap") {
+    inline v8::Local<v8::Object> CreateShareableWrap(
+        std::shared_ptr<T> object,
+        const char* wrapType = "SharedPtrWrap",
+        size_t externalSize = 0) {
+        const void* pointer = object.get();
+        if (pointer != nullptr) {
+            auto cached = FindShareableWrap(pointer, wrapType);
+            if (!cached.IsEmpty()) {
+                return cached;
+            }
+        }
+
         auto instance = NewInstance(wrapType, 0, nullptr).ToLocalChecked();
-        ShareableWrap::Set(instance, std::move(object));
+        ShareableWrap::Set(instance, std::move(object), externalSize);
+        if (pointer != nullptr) {
+            CacheShareableWrap(pointer, wrapType, instance);
+        }
         return instance;
     }
 }
@@ -0,0 +1,236 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/v8-helpers.h>
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace napa {
+namespace module {
+
+namespace internal {
+
+    /// <summary> Conversion of a JavaScript argument to a parameter of a bound native function. </summary>
+    template <typename T, typename Enable = void>
+    struct ArgumentTraits;
+
+    template <>
+    struct ArgumentTraits<bool> {
+        static const char* TypeName() { return "boolean"; }
+        static bool Is(const v8::Local<v8::Value>& value) { return value->IsBoolean(); }
+        static bool To(const v8::Local<v8::Value>& value) { return value.As<v8::Boolean>()->Value(); }
+    };
+
+    template <typename T>
+    struct ArgumentTraits<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+        static const char* TypeName() { return "number"; }
+        static bool Is(const v8::Local<v8::Value>& value) { return value->IsNumber(); }
+        static T To(const v8::Local<v8::Value>& value) {
+            // Small integers are kept as Smi by V8, they don't need to go through a double.
+            if (value->IsInt32()) {
+                return static_cast<T>(value.As<v8::Int32>()->Value());
+            }
+            auto context = v8::Isolate::GetCurrent()->GetCurrentContext();
+            return static_cast<T>(value->IntegerValue(context).FromJust());
+        }
+    };
+
+    template <typename T>
+    struct ArgumentTraits<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+        static const char* TypeName() { return "number"; }
+        static bool Is(const v8::Local<v8::Value>& value) { return value->IsNumber(); }
+        static T To(const v8::Local<v8::Value>& value) { return static_cast<T>(value.As<v8::Number>()->Value()); }
+    };
+
+    template <>
+    struct ArgumentTraits<std::string> {
+        static const char* TypeName() { return "string"; }
+        static bool Is(const v8::Local<v8::Value>& value) { return value->IsString(); }
+        static std::string To(const v8::Local<v8::Value>& value) { return v8_helpers::V8ValueTo<std::string>(value); }
+    };
+
+    template <>
+    struct ArgumentTraits<std::u16string> {
+        static const char* TypeName() { return "string"; }
+        static bool Is(const v8::Local<v8::Value>& value) { return value->IsString(); }
+        static std::u16string To(const v8::Local<v8::Value>& value) { return v8_helpers::V8ValueTo<std::u16string>(value); }
+    };
+
+    template <>
+    struct ArgumentTraits<v8::Local<v8::Value>> {
+        static const char* TypeName() { return "any"; }
+        static bool Is(const v8::Local<v8::Value>&) { return true; }
+        static v8::Local<v8::Value> To(const v8::Local<v8::Value>& value) { return value; }
+    };
+
+    template <>
+    struct ArgumentTraits<v8::Local<v8::String>> {
+        static const char* TypeName() { return "string"; }
+        static bool Is(const v8::Local<v8::Value>& value) { return value->IsString(); }
+        static v8::Local<v8::String> To(const v8::Local<v8::Value>& value) { return value.As<v8::String>(); }
+    };
+
+    template <>
+    struct ArgumentTraits<v8::Local<v8::Object>> {
+        static const char* TypeName() { return "object"; }
+        static bool Is(const v8::Local<v8::Value>& value) { return value->IsObject(); }
+        static v8::Local<v8::Object> To(const v8::Local<v8::Value>& value) { return value.As<v8::Object>(); }
+    };
+
+    template <>
+    struct ArgumentTraits<v8::Local<v8::Function>> {
+        static const char* TypeName() { return "function"; }
+        static bool Is(const v8::Local<v8::Value>& value) { return value->IsFunction(); }
+        static v8::Local<v8::Function> To(const v8::Local<v8::Value>& value) { return value.As<v8::Function>(); }
+    };
+
+    /// <summary> Parameters are converted from their decayed type, so 'const std::string&' binds like 'std::string'. </summary>
+    template <typename T>
+    using ArgumentTraitsOf = ArgumentTraits<typename std::decay<T>::type>;
+
+    /// <summary> Conversion of the result of a bound native function to a JavaScript value. </summary>
+    template <typename T, typename Enable = void>
+    struct ResultTraits;
+
+    template <>
+    struct ResultTraits<bool> {
+        static void Set(v8::ReturnValue<v8::Value> returnValue, bool value) { returnValue.Set(value); }
+    };
+
+    template <typename T>
+    struct ResultTraits<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+        static void Set(v8::ReturnValue<v8::Value> returnValue, T value) {
+            // Integers that fit 32 bits are returned as Smi when they can, wider ones as doubles.
+            if (std::is_signed<T>::value && sizeof(T) <= sizeof(int32_t)) {
+                returnValue.Set(static_cast<int32_t>(value));
+            } else if (!std::is_signed<T>::value && sizeof(T) <= sizeof(uint32_t)) {
+                returnValue.Set(static_cast<uint32_t>(value));
+            } else {
+                returnValue.Set(static_cast<double>(value));
+            }
+        }
+    };
+
+    template <typename T>
+    struct ResultTraits<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+        static void Set(v8::ReturnValue<v8::Value> returnValue, T value) { returnValue.Set(static_cast<double>(value)); }
+    };
+
+    template <>
+    struct ResultTraits<std::string> {
+        static void Set(v8::ReturnValue<v8::Value> returnValue, std::string value) {
+            returnValue.Set(v8_helpers::MakeV8String(v8::Isolate::GetCurrent(), std::move(value)));
+        }
+    };
+
+    template <>
+    struct ResultTraits<std::u16string> {
+        static void Set(v8::ReturnValue<v8::Value> returnValue, std::u16string value) {
+            returnValue.Set(v8_helpers::MakeV8String(v8::Isolate::GetCurrent(), std::move(value)));
+        }
+    };
+
+    template <typename T>
+    struct ResultTraits<v8::Local<T>> {
+        static void Set(v8::ReturnValue<v8::Value> returnValue, v8::Local<T> value) { returnValue.Set(value); }
+    };
+
+    /// <summary> Tell if all arguments have the types of the parameters, without converting any. </summary>
+    template <typename... Args, size_t... Indices>
+    inline bool CheckArguments(const v8::FunctionCallbackInfo<v8::Value>& args, std::index_sequence<Indices...>) {
+        bool matches[] = { true, ArgumentTraitsOf<Args>::Is(args[static_cast<int>(Indices)])... };
+        for (auto match : matches) {
+            if (!match) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// <summary> Describe the parameters of a bound function, like '(number, string)'. </summary>
+    template <typename... Args>
+    inline std::string DescribeParameters() {
+        const char* names[] = { "", ArgumentTraitsOf<Args>::TypeName()... };
+        std::string signature = "(";
+        for (size_t i = 1; i < sizeof(names) / sizeof(names[0]); ++i) {
+            signature += (i > 1 ? ", " : "");
+            signature += names[i];
+        }
+        return signature + ")";
+    }
+
+    /// <summary> Call a bound function with converted arguments, and set its result as the return value. </summary>
+    template <typename Result, typename... Args>
+    struct Invoker {
+        template <Result(*function)(Args...), size_t... Indices>
+        static void Invoke(const v8::FunctionCallbackInfo<v8::Value>& args, std::index_sequence<Indices...>) {
+            ResultTraits<typename std::decay<Result>::type>::Set(
+                args.GetReturnValue(),
+                function(ArgumentTraitsOf<Args>::To(args[static_cast<int>(Indices)])...));
+        }
+    };
+
+    template <typename... Args>
+    struct Invoker<void, Args...> {
+        template <void(*function)(Args...), size_t... Indices>
+        static void Invoke(const v8::FunctionCallbackInfo<v8::Value>& args, std::index_sequence<Indices...>) {
+            function(ArgumentTraitsOf<Args>::To(args[static_cast<int>(Indices)])...);
+        }
+    };
+
+    template <typename Function, Function function>
+    struct FunctionBinding;
+
+    /// <summary> V8 callback of a native function, whose conversions are generated for its signature at compile time. </summary>
+    template <typename Result, typename... Args, Result(*function)(Args...)>
+    struct FunctionBinding<Result(*)(Args...), function> {
+        static void Callback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+            using Indices = std::index_sequence_for<Args...>;
+            if (args.Length() != static_cast<int>(sizeof...(Args)) || !CheckArguments<Args...>(args, Indices())) {
+                // The name is only read on errors, calls don't pay for it.
+                auto isolate = args.GetIsolate();
+                v8::String::Utf8Value name(args.Data());
+                JS_FAIL(isolate, "\"%s\" expects arguments %s.", *name, DescribeParameters<Args...>().c_str());
+            }
+            Invoker<Result, Args...>::template Invoke<function>(args, Indices());
+        }
+    };
+}
+
+    /// <summary> It binds the method name with a V8 function calling a native function. </summary>
+    /// <param name="exports"> V8 object to bind the function to. </param>
+    /// <param name="name"> Method name. </param>
+    /// <remarks>
+    ///     Arguments and the result are converted by code generated for the signature of the function,
+    ///     which is called directly instead of through a callback written by hand for it.
+    ///     Calls with a wrong number of arguments, or arguments of other types, throw a TypeError.
+    ///     Parameters can be bool, integers, floating points, std::string, std::u16string and v8::Local of Value, String, Object or Function.
+    ///     Results can be any of these types, any other v8::Local, or void.
+    /// </remarks>
+    template <typename Function, Function function, typename T>
+    void ExportFunction(const T& exports, const char* name) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope handleScope(isolate);
+
+        auto functionName = v8::String::NewFromUtf8(isolate, name);
+        auto functionTemplate = v8::FunctionTemplate::New(
+            isolate,
+            internal::FunctionBinding<Function, function>::Callback,
+            functionName);
+        auto boundFunction = functionTemplate->GetFunction();
+        boundFunction->SetName(functionName);
+
+        exports->Set(functionName, boundFunction);
+    }
+}
+}
+
+/// <summary> It exports a native function to addon exports object, converting its arguments and result by its signature. </summary>
+/// <example> double Add(double x, double y); NAPA_EXPORT_FUNCTION(exports, "add", Add); </example>
+#define NAPA_EXPORT_FUNCTION(exports, name, function) \
+    napa::module::ExportFunction<decltype(&function), &function>(exports, name)
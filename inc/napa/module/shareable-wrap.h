@@ -4,6 +4,7 @@
 #pragma once
 
 #include <napa/module.h>
+#include <napa/module/binding.h>
 #include <napa/module/transport-context-wrap.h>
 #include <napa/transport.h>
 
@@ -38,14 +39,26 @@ namespace module {
         /// <param name="cid"> Cid used for transporting the wrap. </param>
         /// <param name='constructor'> Constructor of wrap class. </param>
         static void InitConstructor(const char* cid, v8::Local<v8::Function> constructor) {
+            auto isolate = v8::Isolate::GetCurrent();
             napa::transport::TransportableObject::InitConstructor(cid, constructor);
+
+            // Static '_load' is used by unmarshall instead of 'new' and 'load', to reuse the wrap of a loaded object.
+            auto load = v8::Function::New(isolate->GetCurrentContext(), LoadInstanceCallback, constructor);
+            constructor->Set(v8_helpers::MakeV8String(isolate, "_load"), load.ToLocalChecked());
         }
 
         /// <summary> Set an instance of ShareableWrap child-class with shared_ptr of T. </summary>
+        /// <param name="externalSize"> Bytes of native memory held by the object, reported to V8 while the wrap holds it. </param>
         template <typename T>
-        static void Set(v8::Local<v8::Object> wrap, std::shared_ptr<T> object) {
+        static void Set(v8::Local<v8::Object> wrap, std::shared_ptr<T> object, size_t externalSize = 0) {
             auto shareable = NAPA_OBJECTWRAP::Unwrap<ShareableWrap>(wrap);
             shareable->_object = std::static_pointer_cast<void>(std::move(object));
+            shareable->SetExternalSize(externalSize);
+        }
+
+        /// <summary> Get bytes of native memory held by the contained object, which are reported to V8. </summary>
+        size_t GetExternalSize() const {
+            return _externalSize;
         }
 
         /// <summary> Get shared_ptr of T, which is the type of contained native object. </summary>
@@ -68,11 +81,12 @@ namespace module {
 
         /// <summary> It creates a new instance of WrapType of shared_ptr<T>, WrapType is a sub-class of ShareableWrap. </summary>
         /// <param name="object"> shared_ptr of object. </summary>
+        /// <param name="externalSize"> Bytes of native memory held by the object, see Set. </param>
         /// <returns> V8 object of type ShareableWrap. </summary>
         template <typename WrapType, typename T>
-        static v8::Local<v8::Object> NewInstance(std::shared_ptr<T> object) {
+        static v8::Local<v8::Object> NewInstance(std::shared_ptr<T> object, size_t externalSize = 0) {
             auto instance = napa::module::NewInstance<WrapType>().ToLocalChecked();
-            Set(instance, std::move(object));
+            Set(instance, std::move(object), externalSize);
             return instance;
         }
 
@@ -87,21 +101,39 @@ namespace module {
         /// <summary> Constructor. </summary>
         explicit ShareableWrap(std::shared_ptr<void> object) : _object(std::move(object)) {}
 
-        /// <summary> Allow inheritance. </summary>
-        virtual ~ShareableWrap() = default;
+        /// <summary> Allow inheritance. Gives the reported external memory back to V8. </summary>
+        virtual ~ShareableWrap() {
+            auto isolate = v8::Isolate::GetCurrent();
+            if (_externalSize > 0 && isolate != nullptr) {
+                isolate->AdjustAmountOfExternalAllocatedMemory(-static_cast<int64_t>(_externalSize));
+            }
+        }
+
+        /// <summary> Report the native memory held by the contained object to V8, replacing the size reported before. </summary>
+        /// <remarks> So GC runs as often as the memory wraps keep alive requires, not only by their own small size. </remarks>
+        void SetExternalSize(size_t externalSize) {
+            if (externalSize != _externalSize) {
+                v8::Isolate::GetCurrent()->AdjustAmountOfExternalAllocatedMemory(
+                    static_cast<int64_t>(externalSize) - static_cast<int64_t>(_externalSize));
+                _externalSize = externalSize;
+            }
+        }
 
         /// <summary> It implements readonly Shareable.handle : Handle </summary>
+        /// <remarks> The handle array is created once per contained object and returned by later reads. </remarks>
         static void GetHandleCallback(v8::Local<v8::String> /*propertyName*/, const v8::PropertyCallbackInfo<v8::Value>& args){
             auto isolate = v8::Isolate::GetCurrent();
-            v8::HandleScope scope(isolate);
             auto thisObject = NAPA_OBJECTWRAP::Unwrap<ShareableWrap>(args.Holder());
-            args.GetReturnValue().Set(v8_helpers::PtrToV8Uint32Array(isolate, thisObject->_object.get()));
+            if (thisObject->_handle.IsEmpty() || thisObject->_handleObject != thisObject->_object.get()) {
+                thisObject->_handleObject = thisObject->_object.get();
+                thisObject->_handle.Reset(isolate, v8_helpers::PtrToV8Uint32Array(isolate, thisObject->_handleObject));
+            }
+            args.GetReturnValue().Set(thisObject->_handle);
         }
 
         /// <summary> It implements Shareable.refCount(): boolean </summary>
+        /// <remarks> Read from the control block of the shared_ptr, no handle is created. </remarks>
         static void RefCountCallback(v8::Local<v8::String> /*propertyName*/, const v8::PropertyCallbackInfo<v8::Value>& args){
-            auto isolate = v8::Isolate::GetCurrent();
-            v8::HandleScope scope(isolate);
             auto thisObject = NAPA_OBJECTWRAP::Unwrap<ShareableWrap>(args.Holder());
             args.GetReturnValue().Set(static_cast<int32_t>(thisObject->_object.use_count()));
         }
@@ -136,6 +168,51 @@ namespace module {
             // Load object from transport context.
             auto thisObject = NAPA_OBJECTWRAP::Unwrap<ShareableWrap>(args.Holder());
             thisObject->_object = transportContextWrap->Get()->LoadShared<void>(result.first);
+            thisObject->SetExternalSize(transportContextWrap->Get()->GetExternalSize(result.first));
+        }
+
+        /// <summary> It implements static _load(payload: object, transportContext: TransportContext): ShareableWrap </summary>
+        /// <remarks> The wrap already holding the loaded object in this isolate is returned, otherwise a new wrap is created. </remarks>
+        static void LoadInstanceCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+            auto isolate = v8::Isolate::GetCurrent();
+            v8::HandleScope scope(isolate);
+            auto context = isolate->GetCurrentContext();
+
+            CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"_load\".");
+            CHECK_ARG(isolate, args[0]->IsObject(), "Argument \"payload\" shall be 'Object' type.");
+            CHECK_ARG(isolate, args[1]->IsObject(), "Argument \"transportContext\" shall be 'TransportContextWrap' type.");
+
+            auto payload = v8::Local<v8::Object>::Cast(args[0]);
+            auto result = v8_helpers::V8ValueToUintptr(isolate, payload->Get(v8_helpers::MakeV8String(isolate, "handle")));
+            JS_ENSURE(isolate, result.second, "Unable to cast \"handle\" to pointer. Please check if it's in valid handle format.");
+
+            auto transportContextWrap = NAPA_OBJECTWRAP::Unwrap<TransportContextWrap>(v8::Local<v8::Object>::Cast(args[1]));
+            JS_ENSURE(isolate, transportContextWrap != nullptr, "Argument \"transportContext\" should be 'TransportContextWrap' type.");
+
+            // Loading consumes the reference saved by the sender, even when the wrap is reused.
+            auto object = transportContextWrap->Get()->LoadShared<void>(result.first);
+            auto externalSize = transportContextWrap->Get()->GetExternalSize(result.first);
+
+            auto constructor = v8::Local<v8::Function>::Cast(args.Data());
+            v8::String::Utf8Value wrapType(constructor->GetName());
+            if (object != nullptr) {
+                auto cached = binding::FindShareableWrap(object.get(), *wrapType);
+                if (!cached.IsEmpty()) {
+                    args.GetReturnValue().Set(cached);
+                    return;
+                }
+            }
+
+            auto instance = constructor->NewInstance(context);
+            RETURN_ON_PENDING_EXCEPTION(instance);
+
+            auto wrap = instance.ToLocalChecked();
+            const void* pointer = object.get();
+            Set(wrap, std::move(object), externalSize);
+            if (pointer != nullptr) {
+                binding::CacheShareableWrap(pointer, *wrapType, wrap);
+            }
+            args.GetReturnValue().Set(wrap);
         }
 
         /// <summary> It implements TransportableObject.save(payload: object, transportContext: TransportContext): void </summary>
@@ -159,11 +236,18 @@ namespace module {
                 v8_helpers::PtrToV8Uint32Array(isolate, thisObject->_object.get()));
 
             // Save object to transport context.
-            transportContextWrap->Get()->SaveShared(thisObject->_object);
+            transportContextWrap->Get()->SaveShared(thisObject->_object, thisObject->_externalSize);
         }
 
         /// <summary> Shared object. </summary>
         std::shared_ptr<void> _object;
+
+        /// <summary> Handle array returned by 'handle', created for _handleObject. </summary>
+        v8::Global<v8::Value> _handle;
+        const void* _handleObject = nullptr;
+
+        /// <summary> Bytes of external memory reported to V8 for the contained object. </summary>
+        size_t _externalSize = 0;
     };
 }
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 
 #include <napa/exports.h>
 
+#include <atomic>
+
 namespace napa {
 namespace providers {
 
@@ -59,6 +61,14 @@ namespace providers {
     /// <summary> Exports a getter function for retrieves the configured logging provider. </summary>
     NAPA_API LoggingProvider& GetLoggingProvider();
 
+    /// <summary> The most verbose level that is logged, or -1 for none, set from the platform settings. </summary>
+    NAPA_API extern std::atomic<int> activeLogLevel;
+
+    /// <summary> Tells with one atomic load if messages of a level may be logged, before asking the provider. </summary>
+    inline bool IsLogLevelEnabled(LoggingProvider::Verboseness level) {
+        return static_cast<int>(level) <= activeLogLevel.load(std::memory_order_relaxed);
+    }
+
     /// <summary> Singnature  of the logging provider factory method. </summary>
     typedef LoggingProvider* (*CreateLoggingProvider)();
 }
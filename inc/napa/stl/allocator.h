@@ -5,6 +5,8 @@
 
 #include <napa/memory/allocator.h>
 #include <limits>
+#include <new>
+#include <utility>
 
 namespace napa {
 namespace stl {
@@ -60,6 +62,10 @@ namespace stl {
         void construct(pointer p, const_reference val);
         void destroy(pointer p);
 
+        /// <summary> C++11 construction, so containers can move and emplace elements. </summary>
+        template <typename U, typename... Args>
+        void construct(U* p, Args&&... args);
+
         bool operator==(const Allocator&) const;
         bool operator!=(const Allocator&) const;
 
@@ -116,6 +122,12 @@ namespace stl {
         new (ptr) T(val);
     }
 
+    template <typename T>
+    template <typename U, typename... Args>
+    void Allocator<T>::construct(U* ptr, Args&&... args) {
+        new (ptr) U(std::forward<Args>(args)...);
+    }
+
 #pragma warning(push)
 #pragma warning(disable:4100)
     // Warning C4100 says that 'ptr' is unreferenced as a formal parameter.
@@ -130,12 +142,13 @@ namespace stl {
 
     template <typename T>
     bool Allocator<T>::operator==(const Allocator& other) const {
-        return *_allocator == *(other._allocator);
+        // Copies of an allocator share it, which spares comparing allocator types.
+        return _allocator == other._allocator || *_allocator == *(other._allocator);
     }
 
     template <typename T>
     bool Allocator<T>::operator!=(const Allocator& other) const {
-        return !(*_allocator == *(other._allocator));
+        return !(*this == other);
     }
 }
 }
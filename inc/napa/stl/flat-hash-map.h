@@ -0,0 +1,356 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/stl/allocator.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace napa {
+    namespace stl {
+
+        /// <summary> An unordered map keeping its entries in one open addressing table. </summary>
+        /// <remarks>
+        ///     Entries are probed linearly from the slot of their hash, which is scrambled so that pointer and
+        ///     other low-entropy keys spread out, and erasures shift the following entries back instead of leaving
+        ///     tombstones. The table doubles once it's 3/4 full. Unlike std::unordered_map, entries are
+        ///     std::pair<Key, T>, whose keys must not be changed through iterators, and iterators and references
+        ///     are invalidated by insertions and erasures.
+        /// </remarks>
+        template <
+            typename Key,
+            typename T,
+            typename Hash = std::hash<Key>,
+            typename KeyEqual = std::equal_to<Key>,
+            typename Alloc = napa::stl::Allocator<std::pair<Key, T>>
+        >
+        class FlatHashMap {
+            struct Slot {
+                bool full;
+                typename std::aligned_storage<sizeof(std::pair<Key, T>), alignof(std::pair<Key, T>)>::type storage;
+
+                std::pair<Key, T>& Value() {
+                    return *reinterpret_cast<std::pair<Key, T>*>(&storage);
+                }
+            };
+
+            template <typename Value>
+            class Iterator {
+            public:
+                typedef std::forward_iterator_tag iterator_category;
+                typedef typename std::remove_const<Value>::type value_type;
+                typedef ptrdiff_t difference_type;
+                typedef Value* pointer;
+                typedef Value& reference;
+
+                Iterator() : _slot(nullptr), _end(nullptr) {}
+                Iterator(Slot* slot, Slot* end) : _slot(slot), _end(end) { SkipEmpty(); }
+
+                /// <summary> Iterators convert to const iterators. </summary>
+                template <typename Other, typename = typename std::enable_if<std::is_const<Value>::value && !std::is_const<Other>::value>::type>
+                Iterator(const Iterator<Other>& other) : _slot(other._slot), _end(other._end) {}
+
+                reference operator*() const { return _slot->Value(); }
+                pointer operator->() const { return &_slot->Value(); }
+
+                Iterator& operator++() {
+                    ++_slot;
+                    SkipEmpty();
+                    return *this;
+                }
+
+                Iterator operator++(int) {
+                    auto it = *this;
+                    ++*this;
+                    return it;
+                }
+
+                bool operator==(const Iterator& other) const { return _slot == other._slot; }
+                bool operator!=(const Iterator& other) const { return _slot != other._slot; }
+
+            private:
+                friend class FlatHashMap;
+                template <typename Other> friend class Iterator;
+
+                void SkipEmpty() {
+                    while (_slot != _end && !_slot->full) {
+                        ++_slot;
+                    }
+                }
+
+                Slot* _slot;
+                Slot* _end;
+            };
+
+        public:
+            typedef Key key_type;
+            typedef T mapped_type;
+            typedef std::pair<Key, T> value_type;
+            typedef Hash hasher;
+            typedef KeyEqual key_equal;
+            typedef Alloc allocator_type;
+            typedef size_t size_type;
+            typedef Iterator<value_type> iterator;
+            typedef Iterator<const value_type> const_iterator;
+
+            /// <summary> Constructor that uses a default constructed allocator. </summary>
+            FlatHashMap() : FlatHashMap(Alloc()) {}
+
+            /// <summary> Constructor with the allocator of the table. </summary>
+            explicit FlatHashMap(const Alloc& allocator, const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual()) :
+                _allocator(allocator), _hash(hash), _equal(equal), _slots(nullptr), _capacity(0), _size(0) {}
+
+            FlatHashMap(const FlatHashMap& other) : FlatHashMap(other._allocator, other._hash, other._equal) {
+                reserve(other._size);
+                for (const auto& entry : other) {
+                    try_emplace(entry.first, entry.second);
+                }
+            }
+
+            FlatHashMap(FlatHashMap&& other) : FlatHashMap(other._allocator, other._hash, other._equal) {
+                swap(other);
+            }
+
+            FlatHashMap& operator=(const FlatHashMap& other) {
+                if (this != &other) {
+                    FlatHashMap copy(other);
+                    swap(copy);
+                }
+                return *this;
+            }
+
+            FlatHashMap& operator=(FlatHashMap&& other) {
+                if (this != &other) {
+                    FlatHashMap moved(std::move(other));
+                    swap(moved);
+                }
+                return *this;
+            }
+
+            ~FlatHashMap() {
+                clear();
+                if (_slots != nullptr) {
+                    SlotTraits::deallocate(_allocator, _slots, _capacity);
+                }
+            }
+
+            void swap(FlatHashMap& other) {
+                std::swap(_allocator, other._allocator);
+                std::swap(_hash, other._hash);
+                std::swap(_equal, other._equal);
+                std::swap(_slots, other._slots);
+                std::swap(_capacity, other._capacity);
+                std::swap(_size, other._size);
+            }
+
+            allocator_type get_allocator() const { return allocator_type(_allocator); }
+
+            iterator begin() { return iterator(_slots, _slots + _capacity); }
+            const_iterator begin() const { return const_iterator(_slots, _slots + _capacity); }
+            iterator end() { return iterator(_slots + _capacity, _slots + _capacity); }
+            const_iterator end() const { return const_iterator(_slots + _capacity, _slots + _capacity); }
+
+            bool empty() const { return _size == 0; }
+            size_type size() const { return _size; }
+
+            /// <summary> The number of slots of the table. </summary>
+            size_type bucket_count() const { return _capacity; }
+
+            /// <summary> Makes room for count entries without growing the table again. </summary>
+            void reserve(size_type count) {
+                size_type capacity = _capacity;
+                if (capacity < MIN_CAPACITY) {
+                    capacity = MIN_CAPACITY;
+                }
+                while (capacity - capacity / 4 < count) {
+                    capacity *= 2;
+                }
+                if (capacity > _capacity) {
+                    Rehash(capacity);
+                }
+            }
+
+            void clear() {
+                for (size_type i = 0; i < _capacity && _size > 0; ++i) {
+                    if (_slots[i].full) {
+                        Destroy(_slots[i]);
+                    }
+                }
+            }
+
+            iterator find(const Key& key) {
+                auto index = FindIndex(key);
+                return index < _capacity ? iterator(_slots + index, _slots + _capacity) : end();
+            }
+
+            const_iterator find(const Key& key) const {
+                auto index = FindIndex(key);
+                return index < _capacity ? const_iterator(_slots + index, _slots + _capacity) : end();
+            }
+
+            size_type count(const Key& key) const {
+                return FindIndex(key) < _capacity ? 1 : 0;
+            }
+
+            T& at(const Key& key) {
+                auto index = FindIndex(key);
+                if (index >= _capacity) {
+                    throw std::out_of_range("FlatHashMap key not found");
+                }
+                return _slots[index].Value().second;
+            }
+
+            const T& at(const Key& key) const {
+                return const_cast<FlatHashMap*>(this)->at(key);
+            }
+
+            T& operator[](const Key& key) {
+                return try_emplace(key).first->second;
+            }
+
+            /// <summary> Inserts an entry unless there is one with the same key. </summary>
+            /// <returns> The entry of the key, and whether it was inserted. </returns>
+            std::pair<iterator, bool> insert(value_type value) {
+                return try_emplace(std::move(value.first), std::move(value.second));
+            }
+
+            /// <summary> Inserts an entry constructed from args unless there is one with the key. </summary>
+            template <typename K, typename... Args>
+            std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+                reserve(_size + 1);
+
+                auto index = GetHomeIndex(key);
+                while (_slots[index].full) {
+                    if (_equal(_slots[index].Value().first, key)) {
+                        return std::make_pair(iterator(_slots + index, _slots + _capacity), false);
+                    }
+                    index = (index + 1) & (_capacity - 1);
+                }
+
+                auto& slot = _slots[index];
+                new (&slot.storage) value_type(
+                    std::piecewise_construct,
+                    std::forward_as_tuple(std::forward<K>(key)),
+                    std::forward_as_tuple(std::forward<Args>(args)...));
+                slot.full = true;
+                ++_size;
+                return std::make_pair(iterator(_slots + index, _slots + _capacity), true);
+            }
+
+            size_type erase(const Key& key) {
+                auto index = FindIndex(key);
+                if (index >= _capacity) {
+                    return 0;
+                }
+                EraseIndex(index);
+                return 1;
+            }
+
+            /// <summary> Erases an entry, entries may move so all iterators are invalidated. </summary>
+            void erase(const_iterator position) {
+                EraseIndex(static_cast<size_type>(position._slot - _slots));
+            }
+
+        private:
+            typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Slot> SlotAlloc;
+            typedef std::allocator_traits<SlotAlloc> SlotTraits;
+
+            static constexpr size_type MIN_CAPACITY = 8;
+
+            /// <summary> Fibonacci hashing keeps the high bits of the scrambled hash as the slot index. </summary>
+            size_type GetHomeIndex(const Key& key) const {
+                auto hash = static_cast<uint64_t>(_hash(key)) * UINT64_C(0x9E3779B97F4A7C15);
+                return static_cast<size_type>(hash >> (64 - _shift)) & (_capacity - 1);
+            }
+
+            /// <summary> Returns the slot index of a key, or _capacity if absent. </summary>
+            size_type FindIndex(const Key& key) const {
+                if (_size == 0) {
+                    return _capacity;
+                }
+                auto index = GetHomeIndex(key);
+                while (_slots[index].full) {
+                    if (_equal(_slots[index].Value().first, key)) {
+                        return index;
+                    }
+                    index = (index + 1) & (_capacity - 1);
+                }
+                return _capacity;
+            }
+
+            void Destroy(Slot& slot) {
+                slot.Value().~value_type();
+                slot.full = false;
+                --_size;
+            }
+
+            /// <summary> Empties a slot, then shifts back the following entries that probed past it. </summary>
+            void EraseIndex(size_type index) {
+                Destroy(_slots[index]);
+
+                auto mask = _capacity - 1;
+                auto hole = index;
+                for (auto next = (hole + 1) & mask; _slots[next].full; next = (next + 1) & mask) {
+                    // An entry can fill the hole if its home slot is not cyclically in (hole, next].
+                    auto home = GetHomeIndex(_slots[next].Value().first);
+                    if (((next - home) & mask) >= ((next - hole) & mask)) {
+                        new (&_slots[hole].storage) value_type(std::move(_slots[next].Value()));
+                        _slots[hole].full = true;
+                        _slots[next].Value().~value_type();
+                        _slots[next].full = false;
+                        hole = next;
+                    }
+                }
+            }
+
+            void Rehash(size_type capacity) {
+                auto slots = _slots;
+                auto oldCapacity = _capacity;
+
+                _slots = SlotTraits::allocate(_allocator, capacity);
+                for (size_type i = 0; i < capacity; ++i) {
+                    _slots[i].full = false;
+                }
+                _capacity = capacity;
+                _shift = 0;
+                while ((size_type(1) << _shift) < capacity) {
+                    ++_shift;
+                }
+
+                for (size_type i = 0; i < oldCapacity; ++i) {
+                    if (slots[i].full) {
+                        auto& value = slots[i].Value();
+                        auto index = GetHomeIndex(value.first);
+                        while (_slots[index].full) {
+                            index = (index + 1) & (_capacity - 1);
+                        }
+                        new (&_slots[index].storage) value_type(std::move(value));
+                        _slots[index].full = true;
+                        value.~value_type();
+                    }
+                }
+                if (slots != nullptr) {
+                    SlotTraits::deallocate(_allocator, slots, oldCapacity);
+                }
+            }
+
+            SlotAlloc _allocator;
+            Hash _hash;
+            KeyEqual _equal;
+            Slot* _slots;
+            size_type _capacity;
+            size_type _size;
+            unsigned _shift = 0;
+        };
+    }
+}
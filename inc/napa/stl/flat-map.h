@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/stl/allocator.h>
+#include <napa/stl/vector.h>
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace napa {
+    namespace stl {
+
+        /// <summary> An ordered map keeping its entries sorted in one contiguous vector. </summary>
+        /// <remarks>
+        ///     Lookups are binary searches over adjacent entries, insertions and erasures move the entries after them.
+        ///     It suits small maps, and maps that are filled once then mostly read. Unlike std::map, entries are
+        ///     std::pair<Key, T>, whose keys must not be changed through iterators, and iterators are invalidated
+        ///     by insertions and erasures.
+        /// </remarks>
+        template <
+            typename Key,
+            typename T,
+            typename Compare = std::less<Key>,
+            typename Alloc = napa::stl::Allocator<std::pair<Key, T>>
+        >
+        class FlatMap {
+        public:
+            typedef Key key_type;
+            typedef T mapped_type;
+            typedef std::pair<Key, T> value_type;
+            typedef Compare key_compare;
+            typedef Alloc allocator_type;
+            typedef std::vector<value_type, Alloc> container_type;
+            typedef typename container_type::size_type size_type;
+            typedef typename container_type::iterator iterator;
+            typedef typename container_type::const_iterator const_iterator;
+
+            /// <summary> Constructor that uses a default constructed allocator. </summary>
+            FlatMap() : FlatMap(Alloc()) {}
+
+            /// <summary> Constructor with the allocator of the entries. </summary>
+            explicit FlatMap(const Alloc& allocator, const Compare& compare = Compare()) :
+                _entries(allocator), _compare(compare) {}
+
+            allocator_type get_allocator() const { return _entries.get_allocator(); }
+
+            iterator begin() { return _entries.begin(); }
+            const_iterator begin() const { return _entries.begin(); }
+            iterator end() { return _entries.end(); }
+            const_iterator end() const { return _entries.end(); }
+
+            bool empty() const { return _entries.empty(); }
+            size_type size() const { return _entries.size(); }
+            size_type capacity() const { return _entries.capacity(); }
+            void reserve(size_type capacity) { _entries.reserve(capacity); }
+            void clear() { _entries.clear(); }
+
+            iterator lower_bound(const Key& key) {
+                return std::lower_bound(_entries.begin(), _entries.end(), key, EntryCompare(_compare));
+            }
+
+            const_iterator lower_bound(const Key& key) const {
+                return std::lower_bound(_entries.begin(), _entries.end(), key, EntryCompare(_compare));
+            }
+
+            iterator find(const Key& key) {
+                auto it = lower_bound(key);
+                return it != _entries.end() && !_compare(key, it->first) ? it : _entries.end();
+            }
+
+            const_iterator find(const Key& key) const {
+                auto it = lower_bound(key);
+                return it != _entries.end() && !_compare(key, it->first) ? it : _entries.end();
+            }
+
+            size_type count(const Key& key) const {
+                return find(key) != end() ? 1 : 0;
+            }
+
+            T& at(const Key& key) {
+                auto it = find(key);
+                if (it == _entries.end()) {
+                    throw std::out_of_range("FlatMap key not found");
+                }
+                return it->second;
+            }
+
+            const T& at(const Key& key) const {
+                return const_cast<FlatMap*>(this)->at(key);
+            }
+
+            T& operator[](const Key& key) {
+                return try_emplace(key).first->second;
+            }
+
+            /// <summary> Inserts an entry unless there is one with the same key. </summary>
+            /// <returns> The entry of the key, and whether it was inserted. </returns>
+            std::pair<iterator, bool> insert(value_type value) {
+                auto it = lower_bound(value.first);
+                if (it != _entries.end() && !_compare(value.first, it->first)) {
+                    return std::make_pair(it, false);
+                }
+                return std::make_pair(_entries.insert(it, std::move(value)), true);
+            }
+
+            /// <summary> Inserts an entry constructed from args unless there is one with the key. </summary>
+            template <typename... Args>
+            std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+                auto it = lower_bound(key);
+                if (it != _entries.end() && !_compare(key, it->first)) {
+                    return std::make_pair(it, false);
+                }
+                it = _entries.emplace(it, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+                return std::make_pair(it, true);
+            }
+
+            iterator erase(const_iterator position) {
+                return _entries.erase(position);
+            }
+
+            size_type erase(const Key& key) {
+                auto it = find(key);
+                if (it == _entries.end()) {
+                    return 0;
+                }
+                _entries.erase(it);
+                return 1;
+            }
+
+        private:
+            /// <summary> Compares entries to keys for binary searches. </summary>
+            struct EntryCompare {
+                explicit EntryCompare(const Compare& compare) : compare(compare) {}
+
+                bool operator()(const value_type& entry, const Key& key) const {
+                    return compare(entry.first, key);
+                }
+
+                const Compare& compare;
+            };
+
+            container_type _entries;
+            Compare _compare;
+        };
+    }
+}
@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/stl/allocator.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace napa {
+    namespace stl {
+
+        /// <summary> A vector keeping up to N elements in place, and allocating from Alloc beyond. </summary>
+        /// <remarks>
+        ///     Moving a vector that uses its inline storage moves the elements one by one, so unlike std::vector,
+        ///     iterators and references to elements of a moved vector are not valid in the moved-to vector.
+        ///     Iterators are pointers, invalidated by insertions beyond the capacity and by erasures.
+        /// </remarks>
+        template <typename T, size_t N, typename Alloc = napa::stl::Allocator<T>>
+        class SmallVector {
+        public:
+            typedef T value_type;
+            typedef Alloc allocator_type;
+            typedef size_t size_type;
+            typedef ptrdiff_t difference_type;
+            typedef T& reference;
+            typedef const T& const_reference;
+            typedef T* pointer;
+            typedef const T* const_pointer;
+            typedef T* iterator;
+            typedef const T* const_iterator;
+
+            static_assert(N > 0, "SmallVector needs room for at least 1 inline element.");
+
+            /// <summary> Constructor that uses a default constructed allocator. </summary>
+            SmallVector() : SmallVector(Alloc()) {}
+
+            /// <summary> Constructor with the allocator to use beyond the inline storage. </summary>
+            explicit SmallVector(const Alloc& allocator) :
+                _allocator(allocator), _data(GetInlineData()), _size(0), _capacity(N) {}
+
+            SmallVector(std::initializer_list<T> values, const Alloc& allocator = Alloc()) : SmallVector(allocator) {
+                assign(values.begin(), values.end());
+            }
+
+            SmallVector(const SmallVector& other) : SmallVector(other._allocator) {
+                assign(other.begin(), other.end());
+            }
+
+            SmallVector(SmallVector&& other) : SmallVector(other._allocator) {
+                MoveFrom(other);
+            }
+
+            SmallVector& operator=(const SmallVector& other) {
+                if (this != &other) {
+                    assign(other.begin(), other.end());
+                }
+                return *this;
+            }
+
+            SmallVector& operator=(SmallVector&& other) {
+                if (this != &other) {
+                    clear();
+                    Release();
+                    _allocator = other._allocator;
+                    MoveFrom(other);
+                }
+                return *this;
+            }
+
+            ~SmallVector() {
+                clear();
+                Release();
+            }
+
+            template <typename InputIt>
+            void assign(InputIt first, InputIt last) {
+                clear();
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            }
+
+            allocator_type get_allocator() const { return _allocator; }
+
+            iterator begin() { return _data; }
+            const_iterator begin() const { return _data; }
+            iterator end() { return _data + _size; }
+            const_iterator end() const { return _data + _size; }
+
+            bool empty() const { return _size == 0; }
+            size_type size() const { return _size; }
+            size_type capacity() const { return _capacity; }
+
+            /// <summary> Tells if the elements are in the inline storage. </summary>
+            bool is_inline() const { return _data == GetInlineData(); }
+
+            reference operator[](size_type index) { return _data[index]; }
+            const_reference operator[](size_type index) const { return _data[index]; }
+
+            reference at(size_type index) {
+                if (index >= _size) {
+                    throw std::out_of_range("SmallVector index out of range");
+                }
+                return _data[index];
+            }
+
+            const_reference at(size_type index) const {
+                return const_cast<SmallVector*>(this)->at(index);
+            }
+
+            reference front() { return _data[0]; }
+            const_reference front() const { return _data[0]; }
+            reference back() { return _data[_size - 1]; }
+            const_reference back() const { return _data[_size - 1]; }
+            pointer data() { return _data; }
+            const_pointer data() const { return _data; }
+
+            void reserve(size_type capacity) {
+                if (capacity > _capacity) {
+                    Grow(capacity);
+                }
+            }
+
+            void resize(size_type size) {
+                reserve(size);
+                while (_size > size) {
+                    pop_back();
+                }
+                while (_size < size) {
+                    emplace_back();
+                }
+            }
+
+            void clear() {
+                while (_size > 0) {
+                    pop_back();
+                }
+            }
+
+            void push_back(const T& value) { emplace_back(value); }
+            void push_back(T&& value) { emplace_back(std::move(value)); }
+
+            template <typename... Args>
+            reference emplace_back(Args&&... args) {
+                if (_size == _capacity) {
+                    // The value is constructed first, since args may refer to an element.
+                    T value(std::forward<Args>(args)...);
+                    Grow(_capacity * 2);
+                    new (_data + _size) T(std::move(value));
+                } else {
+                    new (_data + _size) T(std::forward<Args>(args)...);
+                }
+                return _data[_size++];
+            }
+
+            void pop_back() {
+                _data[--_size].~T();
+            }
+
+            iterator insert(const_iterator position, T value) {
+                auto index = position - _data;
+                emplace_back(std::move(value));
+                std::rotate(_data + index, _data + _size - 1, _data + _size);
+                return _data + index;
+            }
+
+            iterator erase(const_iterator position) {
+                return erase(position, position + 1);
+            }
+
+            iterator erase(const_iterator first, const_iterator last) {
+                auto index = first - _data;
+                auto count = last - first;
+                std::move(_data + index + count, _data + _size, _data + index);
+                for (difference_type i = 0; i < count; ++i) {
+                    pop_back();
+                }
+                return _data + index;
+            }
+
+        private:
+            typedef std::allocator_traits<Alloc> Traits;
+
+            T* GetInlineData() const {
+                return reinterpret_cast<T*>(const_cast<typename std::aligned_storage<sizeof(T), alignof(T)>::type*>(_inline));
+            }
+
+            void Grow(size_type capacity) {
+                auto data = Traits::allocate(_allocator, capacity);
+                for (size_type i = 0; i < _size; ++i) {
+                    new (data + i) T(std::move_if_noexcept(_data[i]));
+                    _data[i].~T();
+                }
+                Release();
+                _data = data;
+                _capacity = capacity;
+            }
+
+            /// <summary> Deallocates the heap storage, elements must be destroyed or moved from. </summary>
+            void Release() {
+                if (!is_inline()) {
+                    Traits::deallocate(_allocator, _data, _capacity);
+                }
+                _data = GetInlineData();
+                _capacity = N;
+            }
+
+            /// <summary> Takes the elements of other, this must be empty and inline. </summary>
+            void MoveFrom(SmallVector& other) {
+                if (other.is_inline()) {
+                    reserve(other._size);
+                    for (auto& value : other) {
+                        new (_data + _size++) T(std::move(value));
+                    }
+                    other.clear();
+                    other.Release();
+                } else {
+                    _data = other._data;
+                    _size = other._size;
+                    _capacity = other._capacity;
+                    other._data = other.GetInlineData();
+                    other._size = 0;
+                    other._capacity = N;
+                }
+            }
+
+            Alloc _allocator;
+            T* _data;
+            size_type _size;
+            size_type _capacity;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type _inline[N];
+        };
+    }
+}
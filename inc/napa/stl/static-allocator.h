@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/capi.h>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace napa {
+namespace stl {
+
+    /// <summary> Allocation policy of napa_allocate and napa_deallocate, what the default allocator uses. </summary>
+    struct DefaultAllocationPolicy {
+        static void* Allocate(size_t size) {
+            return ::napa_allocate(size);
+        }
+
+        static void Deallocate(void* memory, size_t sizeHint) {
+            ::napa_deallocate(memory, sizeHint);
+        }
+    };
+
+    /// <summary> Allocation policy of the C runtime allocator from napa.dll, what the CRT allocator uses. </summary>
+    struct CrtAllocationPolicy {
+        static void* Allocate(size_t size) {
+            return ::napa_malloc(size);
+        }
+
+        static void Deallocate(void* memory, size_t sizeHint) {
+            ::napa_free(memory, sizeHint);
+        }
+    };
+
+    /// <summary> Allocation policy of the size class pools, what the pool allocator uses. </summary>
+    struct PoolAllocationPolicy {
+        static void* Allocate(size_t size) {
+            return ::napa_pool_allocate(size);
+        }
+
+        static void Deallocate(void* memory, size_t sizeHint) {
+            ::napa_pool_deallocate(memory, sizeHint);
+        }
+    };
+
+    /// <summary>
+    ///     STL allocator bound at compile time to an allocation policy, which has static Allocate and Deallocate
+    ///     functions with the signatures of napa::memory::Allocator's.
+    /// </summary>
+    /// <remarks>
+    ///     Unlike napa::stl::Allocator, it holds no napa::memory::Allocator, so it takes no space in containers,
+    ///     allocates without a virtual call and all its instances are equal. Use napa::stl::Allocator when the
+    ///     allocator is only known at run time, e.g. the zone allocator or a task arena.
+    /// </remarks>
+    template <typename T, typename Policy = DefaultAllocationPolicy>
+    class StaticAllocator {
+    public:
+        typedef size_t    size_type;
+        typedef ptrdiff_t difference_type;
+        typedef T*        pointer;
+        typedef const T*  const_pointer;
+        typedef T&        reference;
+        typedef const T&  const_reference;
+        typedef T         value_type;
+
+        template <typename U> struct rebind
+        {
+            typedef StaticAllocator<U, Policy> other;
+        };
+
+        StaticAllocator() = default;
+
+        template <typename U>
+        StaticAllocator(const StaticAllocator<U, Policy>&) throw() {}
+
+        pointer allocate(size_type count, const void* /*hint*/ = 0) {
+            return static_cast<pointer>(Policy::Allocate(sizeof(T) * count));
+        }
+
+        void deallocate(pointer p, size_type count) {
+            Policy::Deallocate(p, sizeof(T) * count);
+        }
+
+        size_type max_size() const throw() {
+            return std::numeric_limits<size_type>::max() / sizeof(T);
+        }
+
+        template <typename U, typename... Args>
+        void construct(U* p, Args&&... args) {
+            new (p) U(std::forward<Args>(args)...);
+        }
+
+        template <typename U>
+        void destroy(U* p) {
+            p->~U();
+        }
+
+        template <typename U>
+        bool operator==(const StaticAllocator<U, Policy>&) const {
+            return true;
+        }
+
+        template <typename U>
+        bool operator!=(const StaticAllocator<U, Policy>&) const {
+            return false;
+        }
+    };
+}
+}
@@ -3,7 +3,7 @@
 
 #pragma once
 
-#include <napa/stl/unordered_map.h>
+#include <napa/stl/flat-hash-map.h>
 #include <memory>
 
 namespace napa {
@@ -41,9 +41,14 @@ namespace transport {
 
         /// <summary> It saves a shared pointer that can be loaded later. </summary>
         /// <param name="pointer"> Shared pointer to transfer ownership to another isolate. </param>
+        /// <param name="externalSize"> 
+        ///     Bytes of native memory held by the object, which wraps of the receiver report to V8 as external memory.
+        /// </param>
         template <typename T>
-        void SaveShared(std::shared_ptr<T> pointer) {
-            _sharedDepot[reinterpret_cast<uintptr_t>(pointer.get())] = std::move(pointer);
+        void SaveShared(std::shared_ptr<T> pointer, size_t externalSize = 0) {
+            auto& entry = _sharedDepot[reinterpret_cast<uintptr_t>(pointer.get())];
+            entry.pointer = std::move(pointer);
+            entry.externalSize = externalSize;
         }
 
         /// <summary> It loads a previously saved shared pointer. </summary>
@@ -53,20 +58,59 @@ namespace transport {
         std::shared_ptr<T> LoadShared(uintptr_t handle) {
             auto it = _sharedDepot.find(handle);
             if (it != _sharedDepot.end()) {
-                return std::static_pointer_cast<T>(it->second);
+                return std::static_pointer_cast<T>(it->second.pointer);
             }
             return std::shared_ptr<T>();
         }
 
+        /// <summary> Get the external size saved with a shared pointer. </summary>
+        /// <param name="handle"> uintptr_t value. </summary>
+        /// <returns> The size passed to SaveShared, or 0 if the handle is not found. </returns>
+        size_t GetExternalSize(uintptr_t handle) const {
+            auto it = _sharedDepot.find(handle);
+            return it != _sharedDepot.end() ? it->second.externalSize : 0;
+        }
+
+        /// <summary> It creates a context that extends the ownership of all saved shared pointers, for another receiver. </summary>
+        std::unique_ptr<TransportContext> Share() const {
+            auto context = std::make_unique<TransportContext>();
+            for (const auto& entry : _sharedDepot) {
+                context->_sharedDepot[entry.first] = entry.second;
+            }
+            return context;
+        }
+
+        /// <summary> It extends the ownership of all shared pointers saved in another context, which this context loads from then. </summary>
+        void ShareFrom(const TransportContext& other) {
+            for (const auto& entry : other._sharedDepot) {
+                _sharedDepot[entry.first] = entry.second;
+            }
+        }
+
         /// <summary> Get count of saved shared_ptr. </summary> 
-        uint32_t GetSharedCount() {
+        uint32_t GetSharedCount() const {
             return static_cast<uint32_t>(_sharedDepot.size());
         }
 
+        /// <summary> Get the sum of the external sizes saved with all shared pointers. </summary>
+        size_t GetTotalExternalSize() const {
+            size_t total = 0;
+            for (const auto& entry : _sharedDepot) {
+                total += entry.second.externalSize;
+            }
+            return total;
+        }
+
     private:
 
+        /// <summary> A saved shared_ptr with the size of native memory it holds. </summary>
+        struct SharedEntry {
+            std::shared_ptr<void> pointer;
+            size_t externalSize = 0;
+        };
+
         /// <summary> shared_ptr depot. </summary>
-        napa::stl::UnorderedMap<uintptr_t, std::shared_ptr<void>> _sharedDepot;
+        napa::stl::FlatHashMap<uintptr_t, SharedEntry> _sharedDepot;
     };
 }
 }
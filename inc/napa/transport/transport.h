@@ -32,12 +32,40 @@ namespace transport {
             argv));
     }
 
+    /// <summary> Marshall an object with transport context, moving the ArrayBuffers in the transfer list instead of copying. </summary>
+    /// <param name="object"> Object to marshall, it can be built-in JavaScript types or object implements napajs.transport.Transportable. </param>
+    /// <param name="transportContextWrap"> TransportContextWrap to save shareable states if any. </param>
+    /// <param name="transferList"> Array of ArrayBuffers to transfer, they keep attached until 'Detach' is called on the list. </param>
+    /// <returns> Payload in V8 string of marshalled object. </summary>
+    inline v8::MaybeLocal<v8::String> Marshall(
+        v8::Local<v8::Value> object,
+        v8::Local<v8::Object> transportContextWrap,
+        v8::Local<v8::Value> transferList) {
+        v8::Local<v8::Value> argv[] = { object, transportContextWrap, transferList };
+        return v8_helpers::MaybeCast<v8::String>(napa::module::binding::Call(
+            "../lib/transport/transport", 
+            "marshall", 
+            sizeof(argv) / sizeof(v8::Local<v8::Value>), 
+            argv));
+    }
+
+    /// <summary> Detach the transferred ArrayBuffers from the sender, after all values referencing them are marshalled. </summary>
+    /// <param name="transferList"> Array of ArrayBuffers passed to 'Marshall'. </param>
+    inline void Detach(v8::Local<v8::Value> transferList) {
+        v8::Local<v8::Value> argv[] = { transferList };
+        (void)napa::module::binding::Call("../lib/transport/transport", "detach", sizeof(argv) / sizeof(v8::Local<v8::Value>), argv);
+    }
+
     /// <summary> Marshall an object with transport context. C++ modules can use this helper function to marshall its members. </summary>
     /// <param name="object"> Object to marshall, it can be built-in JavaScript types or object implements napajs.transport.Transportable. </param>
     /// <param name="transportContext"> TransportContext to save shareable states if any. </param>
+    /// <param name="transferList"> Optional array of ArrayBuffers to transfer instead of copying. </param>
     /// <returns> Payload in V8 string of marshalled object. </summary>
     /// <remarks> 'napajs/lib/transport/transport' is required instead of 'napajs/lib/transport' to avoid circular dependency on addon. </remarks>
-    inline v8::MaybeLocal<v8::String> Marshall(v8::Local<v8::Value> object, napa::transport::TransportContext* transportContext) {
+    inline v8::MaybeLocal<v8::String> Marshall(
+        v8::Local<v8::Value> object,
+        napa::transport::TransportContext* transportContext,
+        v8::Local<v8::Value> transferList = v8::Local<v8::Value>()) {
         auto isolate = v8::Isolate::GetCurrent();
         v8::Local<v8::Value> argv[] = { 
             v8::Boolean::New(isolate, false),                           // Not owning since wrap is temporary.
@@ -48,7 +76,10 @@ namespace transport {
             sizeof(argv) / sizeof(v8::Local<v8::Value>), 
             argv).ToLocalChecked();
 
-        return Marshall(object, transportContextWrap);
+        if (transferList.IsEmpty()) {
+            return Marshall(object, transportContextWrap);
+        }
+        return Marshall(object, transportContextWrap, transferList);
     }
 
     /// <summary> Unmarshall a payload with transport context. C++ modules can use this helper function to unmarshall its members. </summary>
@@ -59,6 +59,12 @@ typedef enum {
 
     /// <summary> transport.marshall/unmarshall will be done by user manually. </summary>
     MANUAL,
+
+    /// <summary>
+    ///     Arguments and the return value are serialized as a whole into bytes by V8's ValueSerializer,
+    ///     instead of being marshalled into JSON. Each spec carries a single argument of the bytes.
+    /// </summary>
+    BINARY,
 } napa_transport_option;
 
 #ifdef __cplusplus
@@ -77,6 +83,83 @@ typedef struct {
 
     /// <summary> Arguments transport option. Default is AUTO. </summary>
     napa_transport_option transport;
+
+    /// <summary> Scheduling priority - Calls with higher priority are dispatched first when all workers are busy. Default is 0. </summary>
+    uint32_t priority;
+
+    /// <summary>
+    ///     Absolute deadline in milliseconds since Unix epoch - Use 0 for none.
+    ///     A call that hasn't started by its deadline is rejected with NAPA_RESULT_TIMEOUT without running.
+    /// </summary>
+    int64_t deadline;
+
+    /// <summary>
+    ///     Routing key - Calls with the same key prefer the same worker, so per-worker caches stay warm.
+    ///     Use 0 for calls that can run on any worker.
+    /// </summary>
+    uint64_t routing_key;
+
+    /// <summary>
+    ///     Cancellation token - Calls made with the same token are withdrawn together by napa_zone_cancel.
+    ///     Use 0 for calls that can't be cancelled.
+    /// </summary>
+    uint64_t cancellation_token;
+
+    /// <summary> Whether the result carries the time spent in each phase of the call. Default is 0 for no timing. </summary>
+    uint32_t record_timing;
+
+    /// <summary> Whether the worker runs a full garbage collection after the call returns. Default is 0 to let V8 decide. </summary>
+    uint32_t collect_garbage;
+
+    /// <summary>
+    ///     Time in milliseconds a successful result is cached for, so identical calls return it without running.
+    ///     Use 0 for calls that are not cached.
+    /// </summary>
+    uint32_t cache_ttl;
+
+    /// <summary>
+    ///     Cache key - Calls with the same module, function and key share a cached result.
+    ///     Use 0 to key the cached result by the marshalled arguments.
+    /// </summary>
+    uint64_t cache_key;
+
+    /// <summary>
+    ///     Whether the call joins an identical call that is in flight, and receives its result instead of running.
+    ///     Default is 0 for calls that always run.
+    /// </summary>
+    uint32_t coalesce;
+
+    /// <summary>
+    ///     Whether the call ignores the deadline of the zone call it's made from.
+    ///     Default is 0, a call made by a running zone call is limited to what is left of its deadline and timeout.
+    /// </summary>
+    uint32_t detach_deadline;
+
+    /// <summary>
+    ///     Arguments and results of at least this many bytes are compressed in the LZ4 block format while queued.
+    ///     Use 0 for calls that don't compress.
+    /// </summary>
+    uint32_t compression_threshold;
+
+    /// <summary>
+    ///     Tenant key - Waiting calls of different tenants are dispatched in turns, as often as their weights in the
+    ///     zone's tenantWeights setting, so a tenant flooding the zone doesn't starve the others.
+    ///     Use 0 for calls of the default tenant.
+    /// </summary>
+    uint64_t tenant;
+
+    /// <summary>
+    ///     Trace id - The call continues this trace as a child of parent_span_id, i.e. of a request traced elsewhere.
+    ///     Use 0 to continue the trace of the zone call it's made from, or to begin a new trace sampled by the
+    ///     process's span sampling rate.
+    /// </summary>
+    uint64_t trace_id;
+
+    /// <summary> The span the call is made from, used with trace_id. </summary>
+    uint64_t parent_span_id;
+
+    /// <summary> Whether spans of the trace of trace_id are recorded. Default is 0, ignored without trace_id. </summary>
+    uint32_t trace_sampled;
 } napa_zone_call_options;
 
 #ifdef __cplusplus
@@ -117,6 +200,13 @@ typedef struct {
 #include <vector>
 
 namespace napa {
+    /// <summary> Returns the options of a call made without any, zero initialized so new fields default to 0. </summary>
+    inline CallOptions DefaultCallOptions() {
+        CallOptions options{};
+        options.transport = AUTO;
+        return options;
+    }
+
     /// <summary> Represents a function to call with its arguments. </summary>
     struct FunctionSpec {
 
@@ -129,8 +219,14 @@ namespace napa {
         /// <summary> The function arguments. </summary>
         std::vector<StringRef> arguments;
 
-        /// <summary> Execute options. </summary>
-        CallOptions options = { 0, AUTO };
+        /// <summary>
+        ///     The function arguments owned by the spec, which the call takes over instead of copying them.
+        ///     When not empty, they are used instead of 'arguments'.
+        /// </summary>
+        mutable std::vector<std::string> ownedArguments;
+
+        /// <summary> Execute options, all zero but for the transport, which is AUTO. </summary>
+        CallOptions options = DefaultCallOptions();
 
         /// <summary> Used for transporting shared_ptr and unique_ptr across zones/workers. </summary>
         mutable std::unique_ptr<napa::transport::TransportContext> transportContext;
@@ -139,6 +235,30 @@ namespace napa {
 
 #endif // __cplusplus
 
+/// <summary> Represents the time in nanoseconds a call spent in each phase, 0 for phases it didn't reach. </summary>
+typedef struct {
+
+    /// <summary> From the call being made until a worker dispatched it. </summary>
+    int64_t queue;
+
+    /// <summary> From the dispatch until the function started, which includes loading it and unmarshalling the arguments. </summary>
+    int64_t unmarshall;
+
+    /// <summary> From the function starting until it returned, or its returned promise settled. </summary>
+    int64_t execute;
+
+    /// <summary> From the function returning until the call finished, which includes marshalling the result. </summary>
+    int64_t marshall;
+} napa_zone_call_timing;
+
+#ifdef __cplusplus
+
+namespace napa {
+    typedef napa_zone_call_timing CallTiming;
+}
+
+#endif // __cplusplus
+
 /// <summary> Represents a result from executing in a zone. </summary>
 typedef struct {
 
@@ -153,6 +273,9 @@ typedef struct {
 
     /// <summary> A context used for transporting handles across zones/workers. </summary>
     void* transport_context;
+
+    /// <summary> Time spent in each phase of the call, all 0 unless the call options asked for timing. </summary>
+    napa_zone_call_timing timing;
 } napa_zone_result;
 
 #ifdef __cplusplus
@@ -172,6 +295,9 @@ namespace napa {
 
         /// <summary> Used for transporting shared_ptr and unique_ptr across zones/workers. </summary>
         mutable std::unique_ptr<napa::transport::TransportContext> transportContext;
+
+        /// <summary> Time spent in each phase of the call, all 0 unless the call options asked for timing. </summary>
+        CallTiming timing = { 0, 0, 0, 0 };
     };
 }
 
@@ -182,6 +308,24 @@ typedef void(*napa_zone_callback)(napa_zone_result result, void* context);
 typedef napa_zone_callback napa_zone_broadcast_callback;
 typedef napa_zone_callback napa_zone_execute_callback;
 
+/// <summary> Callback signature for batch execution, results are in the same order as the function specs. </summary>
+typedef void(*napa_zone_execute_batch_callback)(const napa_zone_result* results, size_t results_count, void* context);
+
+/// <summary> A reference counted buffer owning the return value and error message of a result. </summary>
+typedef struct napa_result_buffer *napa_result_buffer_handle;
+
+/// <summary>
+///     Callback signature for execution with a retained result. The strings of the result point into the buffer,
+///     which the callback owns a reference of and releases with napa_result_release once done with them.
+/// </summary>
+typedef void(*napa_zone_execute_retained_callback)(napa_zone_result result, napa_result_buffer_handle buffer, void* context);
+
+/// <summary> Signature of a native function run on a zone worker, with the context given to napa_zone_execute_native. </summary>
+typedef void(*napa_zone_native_function)(void* context);
+
+/// <summary> Callback signature for native execution, with NAPA_RESULT_SUCCESS once the function ran, or the code it was dropped with. </summary>
+typedef void(*napa_zone_native_callback)(napa_result_code code, void* context);
+
 #ifdef __cplusplus
 
 #include <functional>
@@ -190,6 +334,304 @@ namespace napa {
     typedef std::function<void(Result)> ZoneCallback;
     typedef ZoneCallback BroadcastCallback;
     typedef ZoneCallback ExecuteCallback;
+    typedef std::function<void(std::vector<Result>)> ExecuteBatchCallback;
+    typedef std::function<void()> NativeFunction;
+    typedef std::function<void(ResultCode)> NativeCallback;
+}
+
+#endif // __cplusplus
+
+/// <summary> Represents the V8 heap statistics of a zone worker. </summary>
+typedef struct {
+
+    /// <summary> The id of the worker. </summary>
+    uint32_t worker_id;
+
+    /// <summary> Bytes of heap reserved by V8. </summary>
+    size_t total_heap_size;
+
+    /// <summary> Bytes of heap reserved for executable code. </summary>
+    size_t total_heap_size_executable;
+
+    /// <summary> Bytes of heap backed by physical memory. </summary>
+    size_t total_physical_size;
+
+    /// <summary> Bytes V8 can still allocate before reaching the heap size limit. </summary>
+    size_t total_available_size;
+
+    /// <summary> Bytes of heap used by objects. </summary>
+    size_t used_heap_size;
+
+    /// <summary> The heap size limit of the isolate. </summary>
+    size_t heap_size_limit;
+
+    /// <summary> Bytes V8 allocated with malloc. </summary>
+    size_t malloced_memory;
+
+    /// <summary> The highest number of bytes V8 allocated with malloc. </summary>
+    size_t peak_malloced_memory;
+} napa_zone_heap_statistics;
+
+/// <summary> Represents how urgently zone workers should release memory. </summary>
+typedef enum {
+
+    /// <summary> Memory pressure is over, workers go back to their usual collections. </summary>
+    MEMORY_PRESSURE_NONE,
+
+    /// <summary> Workers collect garbage more eagerly. </summary>
+    MEMORY_PRESSURE_MODERATE,
+
+    /// <summary> Workers collect all the garbage they can, right away. </summary>
+    MEMORY_PRESSURE_CRITICAL,
+} napa_memory_pressure_level;
+
+/// <summary> Callback receiving the heap statistics of zone workers, which are only valid during the call. </summary>
+typedef void(*napa_zone_heap_statistics_callback)(const napa_zone_heap_statistics* statistics, size_t statistics_count, void* context);
+
+/// <summary> Represents the utilization of a zone worker since it started. </summary>
+typedef struct {
+
+    /// <summary> The id of the worker. </summary>
+    uint32_t worker_id;
+
+    /// <summary> Nanoseconds spent running tasks and timers. </summary>
+    uint64_t busy_time;
+
+    /// <summary> Nanoseconds spent waiting for tasks. </summary>
+    uint64_t idle_time;
+
+    /// <summary> The number of tasks the worker ran. </summary>
+    uint64_t executed_tasks;
+
+    /// <summary> The number of tasks queued on the worker. </summary>
+    size_t queued_tasks;
+
+    /// <summary> The number of immediate tasks queued on the worker, which run ahead of the other queued tasks. </summary>
+    size_t queued_immediate_tasks;
+} napa_zone_worker_stats;
+
+/// <summary> Represents the calls of a tenant that waited in a zone for an idle worker. </summary>
+typedef struct {
+
+    /// <summary> The tenant key. </summary>
+    uint64_t tenant;
+
+    /// <summary> The tenant name from the zone's tenantWeights setting, empty for tenants without a weight. </summary>
+    napa_string_ref name;
+
+    /// <summary> The number of calls of the tenant waiting for an idle worker. </summary>
+    size_t queued_tasks;
+
+    /// <summary> The number of calls of the tenant that waited and were dispatched. </summary>
+    uint64_t dispatched_tasks;
+
+    /// <summary> Nanoseconds the dispatched calls waited in total. </summary>
+    uint64_t wait_time;
+
+    /// <summary> Nanoseconds the longest dispatched call waited. </summary>
+    uint64_t max_wait_time;
+} napa_zone_tenant_stats;
+
+/// <summary> Represents the hardware counters of the calls of a function, summed over the workers of a zone. </summary>
+typedef struct {
+
+    /// <summary> The function, like 'module.function', or the function name alone for functions of the global scope. </summary>
+    napa_string_ref function;
+
+    /// <summary> The number of calls counted. </summary>
+    uint64_t calls;
+
+    /// <summary> CPU cycles the calls ran in user mode. </summary>
+    uint64_t cycles;
+
+    /// <summary> Instructions the calls retired in user mode. </summary>
+    uint64_t instructions;
+
+    /// <summary> Last level cache references of the calls. </summary>
+    uint64_t cache_references;
+
+    /// <summary> Last level cache misses of the calls. </summary>
+    uint64_t cache_misses;
+} napa_zone_function_counters;
+
+/// <summary> The number of buckets of the execution time histograms of napa_zone_function_stats. </summary>
+#define NAPA_FUNCTION_STATS_HISTOGRAM_BUCKETS 32
+
+/// <summary> Represents the calls of a function that ran in a zone, since the zone was created. </summary>
+typedef struct {
+
+    /// <summary> The module of the function, empty for functions of the global scope. </summary>
+    napa_string_ref module;
+
+    /// <summary> The function name. </summary>
+    napa_string_ref function;
+
+    /// <summary> The number of calls that finished after a worker dispatched them. </summary>
+    uint64_t calls;
+
+    /// <summary> The number of those calls that were rejected, i.e. threw, timed out or were cancelled. </summary>
+    uint64_t errors;
+
+    /// <summary> Nanoseconds from dispatch to result, summed over the calls. </summary>
+    uint64_t total_time;
+
+    /// <summary> Nanoseconds from dispatch to result of the longest call. </summary>
+    uint64_t max_time;
+
+    /// <summary>
+    ///     The number of calls by execution time. Bucket 0 counts calls under 1 microsecond, bucket i calls from
+    ///     2^(i-1) up to 2^i microseconds, and the last bucket all longer calls.
+    /// </summary>
+    uint64_t histogram[NAPA_FUNCTION_STATS_HISTOGRAM_BUCKETS];
+} napa_zone_function_stats;
+
+/// <summary> Callback receiving the statistics of the functions of a zone, which are only valid during the call. </summary>
+typedef void(*napa_zone_function_stats_callback)(const napa_zone_function_stats* stats, size_t stats_count, void* context);
+
+/// <summary> Represents the utilization of a zone and its running workers. </summary>
+typedef struct {
+
+    /// <summary> The number of calls waiting in the zone for an idle worker. </summary>
+    size_t pending_tasks;
+
+    /// <summary> The statistics of each running worker, ordered by worker id. </summary>
+    const napa_zone_worker_stats* workers;
+
+    /// <summary> The number of entries in workers. </summary>
+    size_t workers_count;
+
+    /// <summary> The statistics of each tenant whose calls waited in the zone, ordered by tenant key. </summary>
+    const napa_zone_tenant_stats* tenants;
+
+    /// <summary> The number of entries in tenants. </summary>
+    size_t tenants_count;
+
+    /// <summary> The hardware counters of each function called, ordered by function, with the hardwareCounters setting. </summary>
+    const napa_zone_function_counters* functions;
+
+    /// <summary> The number of entries in functions. </summary>
+    size_t functions_count;
+} napa_zone_stats;
+
+/// <summary> Callback receiving the statistics of a zone, which are only valid during the call. </summary>
+typedef void(*napa_zone_stats_callback)(const napa_zone_stats* stats, void* context);
+
+/// <summary> Represents the CPU profile a zone worker recorded. </summary>
+typedef struct {
+
+    /// <summary> The id of the worker. </summary>
+    uint32_t worker_id;
+
+    /// <summary> The profile in the .cpuprofile JSON format of Chrome DevTools. </summary>
+    napa_string_ref profile;
+} napa_zone_cpu_profile;
+
+/// <summary> Callback receiving the CPU profiles of zone workers, which are only valid during the call. </summary>
+typedef void(*napa_zone_cpu_profiles_callback)(const napa_zone_cpu_profile* profiles, size_t profiles_count, void* context);
+
+#ifdef __cplusplus
+
+namespace napa {
+    /// <summary> Represents the CPU profile a zone worker recorded. </summary>
+    struct CpuProfile {
+
+        /// <summary> The id of the worker. </summary>
+        uint32_t workerId = 0;
+
+        /// <summary> The profile in the .cpuprofile JSON format of Chrome DevTools. </summary>
+        std::string profile;
+    };
+
+    typedef std::function<void(std::vector<CpuProfile>)> CpuProfilesCallback;
+    typedef napa_zone_heap_statistics HeapStatistics;
+    typedef napa_memory_pressure_level MemoryPressureLevel;
+    typedef std::function<void(std::vector<HeapStatistics>)> HeapStatisticsCallback;
+    typedef napa_zone_worker_stats WorkerStats;
+
+    /// <summary> Represents the calls of a tenant that waited in a zone for an idle worker. </summary>
+    struct TenantStats {
+
+        /// <summary> The tenant key. </summary>
+        uint64_t tenant = 0;
+
+        /// <summary> The tenant name from the zone's tenantWeights setting, empty for tenants without a weight. </summary>
+        std::string name;
+
+        /// <summary> The number of calls of the tenant waiting for an idle worker. </summary>
+        size_t queuedTasks = 0;
+
+        /// <summary> The number of calls of the tenant that waited and were dispatched. </summary>
+        uint64_t dispatchedTasks = 0;
+
+        /// <summary> Nanoseconds the dispatched calls waited in total. </summary>
+        uint64_t waitTime = 0;
+
+        /// <summary> Nanoseconds the longest dispatched call waited. </summary>
+        uint64_t maxWaitTime = 0;
+    };
+
+    /// <summary> Represents the hardware counters of the calls of a function, summed over the workers of a zone. </summary>
+    struct FunctionCounters {
+
+        /// <summary> The function, like 'module.function', or the function name alone for functions of the global scope. </summary>
+        std::string function;
+
+        /// <summary> The number of calls counted. </summary>
+        uint64_t calls = 0;
+
+        /// <summary> CPU cycles the calls ran in user mode. </summary>
+        uint64_t cycles = 0;
+
+        /// <summary> Instructions the calls retired in user mode. </summary>
+        uint64_t instructions = 0;
+
+        /// <summary> Last level cache references of the calls. </summary>
+        uint64_t cacheReferences = 0;
+
+        /// <summary> Last level cache misses of the calls. </summary>
+        uint64_t cacheMisses = 0;
+    };
+
+    /// <summary> Represents the utilization of a zone and its running workers. </summary>
+    struct ZoneStats {
+
+        /// <summary> The number of calls waiting in the zone for an idle worker. </summary>
+        size_t pendingTasks = 0;
+
+        /// <summary> The statistics of each running worker, ordered by worker id. </summary>
+        std::vector<WorkerStats> workers;
+
+        /// <summary> The statistics of each tenant whose calls waited in the zone, ordered by tenant key. </summary>
+        std::vector<TenantStats> tenants;
+
+        /// <summary> The hardware counters of each function called, ordered by function, with the hardwareCounters setting. </summary>
+        std::vector<FunctionCounters> functions;
+    };
+
+    /// <summary> Represents the calls of a function that ran in a zone, since the zone was created. </summary>
+    struct FunctionStats {
+
+        /// <summary> The module of the function, empty for functions of the global scope. </summary>
+        std::string module;
+
+        /// <summary> The function name. </summary>
+        std::string function;
+
+        /// <summary> The number of calls that finished after a worker dispatched them. </summary>
+        uint64_t calls = 0;
+
+        /// <summary> The number of those calls that were rejected, i.e. threw, timed out or were cancelled. </summary>
+        uint64_t errors = 0;
+
+        /// <summary> Nanoseconds from dispatch to result, summed over the calls. </summary>
+        uint64_t totalTime = 0;
+
+        /// <summary> Nanoseconds from dispatch to result of the longest call. </summary>
+        uint64_t maxTime = 0;
+
+        /// <summary> The number of calls by execution time, see napa_zone_function_stats. </summary>
+        uint64_t histogram[NAPA_FUNCTION_STATS_HISTOGRAM_BUCKETS] = {};
+    };
 }
 
 #endif // __cplusplus
@@ -200,3 +642,19 @@ typedef struct napa_zone *napa_zone_handle;
 /// <summary> Callback for customized memory allocator. </summary>
 typedef void* (*napa_allocate_callback)(size_t);
 typedef void (*napa_deallocate_callback)(void*, size_t);
+
+/// <summary> Represents the format of a metric snapshot. </summary>
+typedef enum {
+
+    /// <summary> A JSON array of metrics, each with its series. </summary>
+    METRIC_SNAPSHOT_JSON,
+
+    /// <summary> The Prometheus text exposition format. </summary>
+    METRIC_SNAPSHOT_PROMETHEUS,
+} napa_metric_snapshot_format;
+
+/// <summary> Callback receiving a metric snapshot, which is only valid during the call. </summary>
+typedef void (*napa_metric_snapshot_callback)(napa_string_ref snapshot, void* context);
+
+/// <summary> Callback receiving a trace in Chrome trace event JSON, which is only valid during the call. </summary>
+typedef void (*napa_trace_callback)(napa_string_ref trace, void* context);
@@ -5,7 +5,9 @@
 
 #include <napa/assert.h>
 
+#include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <stdarg.h>
 
 namespace napa {
@@ -20,5 +22,56 @@ namespace utils {
 
         NAPA_ASSERT(size >= 0, "Format message error, probably wrong format encoding");
     }
+
+    /// <summary> Tell if chars are all ASCII, which are the same in Latin-1 and UTF-8. </summary>
+    /// <remarks>
+    ///     Chars are tested 8 bytes at a time, and blocks of 32 bytes are folded into one test,
+    ///     a loop compilers vectorize. Marshalled JSON is mostly ASCII, so it usually runs to the end.
+    /// </remarks>
+    inline bool IsAscii(const char* data, size_t length) {
+        constexpr uint64_t HIGH_BITS = 0x8080808080808080ULL;
+
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32) {
+            uint64_t words[4];
+            std::memcpy(words, data + i, sizeof(words));
+            if (((words[0] | words[1] | words[2] | words[3]) & HIGH_BITS) != 0) {
+                return false;
+            }
+        }
+        for (; i + 8 <= length; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            if ((word & HIGH_BITS) != 0) {
+                return false;
+            }
+        }
+        for (; i < length; ++i) {
+            if (static_cast<unsigned char>(data[i]) >= 0x80) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// <summary> Tell if UTF-16 chars are all ASCII, so they fit in one byte each. </summary>
+    inline bool IsAscii(const char16_t* data, size_t length) {
+        constexpr uint64_t HIGH_BITS = 0xFF80FF80FF80FF80ULL;
+
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            uint64_t words[4];
+            std::memcpy(words, data + i, sizeof(words));
+            if (((words[0] | words[1] | words[2] | words[3]) & HIGH_BITS) != 0) {
+                return false;
+            }
+        }
+        for (; i < length; ++i) {
+            if (data[i] >= 0x80) {
+                return false;
+            }
+        }
+        return true;
+    }
 }
 }
\ No newline at end of file
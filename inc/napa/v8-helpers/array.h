@@ -6,6 +6,9 @@
 #include "conversion.h"
 
 #include <v8.h>
+
+#include <cstdint>
+#include <cstring>
 #include <vector>
 
 namespace napa {
@@ -23,5 +26,130 @@ namespace v8_helpers {
         }
         return res;
     }
+
+    namespace internal {
+
+        /// <summary> The typed array holding elements of a numeric type. </summary>
+        template <typename T>
+        struct TypedArrayTraits;
+
+        #define NAPA_DEFINE_TYPED_ARRAY_TRAITS(type, arrayType) \
+            template <> \
+            struct TypedArrayTraits<type> { \
+                typedef v8::arrayType ArrayType; \
+                static bool Is(const v8::Local<v8::Value>& value) { return value->Is##arrayType(); } \
+            }
+
+        NAPA_DEFINE_TYPED_ARRAY_TRAITS(double, Float64Array);
+        NAPA_DEFINE_TYPED_ARRAY_TRAITS(float, Float32Array);
+        NAPA_DEFINE_TYPED_ARRAY_TRAITS(int32_t, Int32Array);
+        NAPA_DEFINE_TYPED_ARRAY_TRAITS(uint32_t, Uint32Array);
+        NAPA_DEFINE_TYPED_ARRAY_TRAITS(int16_t, Int16Array);
+        NAPA_DEFINE_TYPED_ARRAY_TRAITS(uint16_t, Uint16Array);
+        NAPA_DEFINE_TYPED_ARRAY_TRAITS(int8_t, Int8Array);
+        NAPA_DEFINE_TYPED_ARRAY_TRAITS(uint8_t, Uint8Array);
+
+        #undef NAPA_DEFINE_TYPED_ARRAY_TRAITS
+
+        /// <summary> Convert a number to a numeric type, without going through a double for small integers. </summary>
+        template <typename T>
+        inline bool ToNumber(const v8::Local<v8::Context>& context, const v8::Local<v8::Value>& value, T& number) {
+            if (value->IsInt32()) {
+                number = static_cast<T>(value.As<v8::Int32>()->Value());
+                return true;
+            }
+            if (!value->IsNumber()) {
+                return false;
+            }
+            number = static_cast<T>(value->NumberValue(context).FromJust());
+            return true;
+        }
+    }
+
+    /// <summary> Elements of a typed array, borrowed from its backing store. </summary>
+    template <typename T>
+    struct TypedArrayContents {
+        /// <summary> First element of the typed array. </summary>
+        T* data;
+
+        /// <summary> Number of elements. </summary>
+        size_t length;
+    };
+
+    /// <summary> Borrow the elements of a typed array of T, like Float64Array for double, without copying them. </summary>
+    /// <param name="value"> The typed array. </param>
+    /// <param name="contents"> Receives the elements, valid as long as the typed array is alive and its buffer isn't detached. </param>
+    /// <returns> False if the value is not a typed array of T. </returns>
+    /// <remarks> Elements of small typed arrays live in the V8 heap, they are moved to a backing store when borrowed. </remarks>
+    template <typename T>
+    inline bool GetTypedArrayContents(const v8::Local<v8::Value>& value, TypedArrayContents<T>& contents) {
+        if (!internal::TypedArrayTraits<T>::Is(value)) {
+            return false;
+        }
+
+        auto view = value.As<v8::ArrayBufferView>();
+        auto data = static_cast<uint8_t*>(view->Buffer()->GetContents().Data()) + view->ByteOffset();
+        contents.data = reinterpret_cast<T*>(data);
+        contents.length = view->ByteLength() / sizeof(T);
+        return true;
+    }
+
+    /// <summary> Convert a typed array or an array of numbers to std::vector of a numeric type. </summary>
+    /// <param name="isolate"> V8 isolate. </param>
+    /// <param name="value"> A typed array, or an array of numbers. </param>
+    /// <param name="result"> Receives the numbers. </param>
+    /// <returns> False if the value is neither a typed array nor an array, or holds an element that isn't a number. </returns>
+    /// <remarks>
+    ///     Typed arrays of T, like Float64Array for std::vector<double>, are copied in bulk.
+    ///     Other typed arrays and arrays are converted element by element, small integers without going through a double.
+    /// </remarks>
+    template <typename T>
+    inline bool V8NumbersToVector(v8::Isolate* isolate, const v8::Local<v8::Value>& value, std::vector<T>& result) {
+        if (internal::TypedArrayTraits<T>::Is(value)) {
+            auto view = value.As<v8::ArrayBufferView>();
+            result.resize(view->ByteLength() / sizeof(T));
+            if (!result.empty()) {
+                view->CopyContents(result.data(), result.size() * sizeof(T));
+            }
+            return true;
+        }
+
+        if (!value->IsArray() && !value->IsTypedArray()) {
+            return false;
+        }
+
+        auto context = isolate->GetCurrentContext();
+        auto array = value.As<v8::Object>();
+        auto length = value->IsArray() ? value.As<v8::Array>()->Length() : static_cast<uint32_t>(value.As<v8::TypedArray>()->Length());
+
+        result.resize(length);
+        for (uint32_t i = 0; i < length; ++i) {
+            v8::Local<v8::Value> element;
+            if (!array->Get(context, i).ToLocal(&element) || !internal::ToNumber(context, element, result[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// <summary> Create a typed array of T, like Float64Array for double, over native memory without copying it. </summary>
+    /// <param name="isolate"> V8 isolate. </param>
+    /// <param name="data"> First element. The memory is not owned by the typed array, it must outlive the typed array. </param>
+    /// <param name="length"> Number of elements. </param>
+    template <typename T>
+    inline v8::Local<typename internal::TypedArrayTraits<T>::ArrayType> MakeExternalTypedArray(v8::Isolate* isolate, T* data, size_t length) {
+        auto buffer = v8::ArrayBuffer::New(isolate, data, length * sizeof(T));
+        return internal::TypedArrayTraits<T>::ArrayType::New(buffer, 0, length);
+    }
+
+    /// <summary> Create a typed array of T, like Float64Array for std::vector<double>, with a copy of the elements. </summary>
+    template <typename T>
+    inline v8::Local<typename internal::TypedArrayTraits<T>::ArrayType> MakeTypedArray(v8::Isolate* isolate, const std::vector<T>& elements) {
+        auto buffer = v8::ArrayBuffer::New(isolate, elements.size() * sizeof(T));
+        if (!elements.empty()) {
+            std::memcpy(buffer->GetContents().Data(), elements.data(), elements.size() * sizeof(T));
+        }
+        return internal::TypedArrayTraits<T>::ArrayType::New(buffer, 0, elements.size());
+    }
 }
 }
@@ -9,6 +9,73 @@
 
 namespace napa {
 namespace v8_helpers {
+
+    namespace internal {
+
+        /// <summary> Convert a V8 value to a string, empty if it can't be converted. </summary>
+        inline bool ToV8String(const v8::Local<v8::Value>& value, v8::Local<v8::String>& str) {
+            if (value.IsEmpty()) {
+                return false;
+            }
+            if (value->IsString()) {
+                str = v8::Local<v8::String>::Cast(value);
+                return true;
+            }
+            return value->ToString(v8::Isolate::GetCurrent()->GetCurrentContext()).ToLocal(&str);
+        }
+
+        /// <summary> Write a V8 value as UTF-8 into a string of chars, straight from the V8 string. </summary>
+        /// <remarks> ASCII is the same in UTF-8, so one-byte strings of ASCII chars are copied without measuring and encoding them. </remarks>
+        template <typename String>
+        inline String ToUtf8(const v8::Local<v8::Value>& value) {
+            String result;
+            v8::Local<v8::String> str;
+            if (!ToV8String(value, str)) {
+                return result;
+            }
+
+            if (str->IsOneByte()) {
+                result.resize(static_cast<size_t>(str->Length()));
+                if (!result.empty()) {
+                    str->WriteOneByte(
+                        reinterpret_cast<uint8_t*>(&result[0]),
+                        0,
+                        static_cast<int>(result.size()),
+                        v8::String::NO_NULL_TERMINATION);
+                }
+                if (napa::utils::IsAscii(result.data(), result.size())) {
+                    return result;
+                }
+            }
+
+            result.resize(static_cast<size_t>(str->Utf8Length()));
+            if (!result.empty()) {
+                str->WriteUtf8(&result[0], static_cast<int>(result.size()), nullptr, v8::String::NO_NULL_TERMINATION);
+            }
+            return result;
+        }
+
+        /// <summary> Write a V8 value as UTF-16 into a string of char16_t, straight from the V8 string. </summary>
+        template <typename String>
+        inline String ToUtf16(const v8::Local<v8::Value>& value) {
+            String result;
+            v8::Local<v8::String> str;
+            if (!ToV8String(value, str)) {
+                return result;
+            }
+
+            result.resize(static_cast<size_t>(str->Length()));
+            if (!result.empty()) {
+                str->Write(
+                    reinterpret_cast<uint16_t*>(&result[0]),
+                    0,
+                    static_cast<int>(result.size()),
+                    v8::String::NO_NULL_TERMINATION);
+            }
+            return result;
+        }
+    }
+
     /// <summary> Unified method signature for convert V8 value to C++ types. </summary>
     template <typename T>
     inline T V8ValueTo(const v8::Local<v8::Value>& value) {
@@ -18,29 +85,25 @@ namespace v8_helpers {
     /// <summary> Convert a v8 value to std::string. </summary>
     template <>
     inline std::string V8ValueTo(const v8::Local<v8::Value>& value) {
-        v8::String::Utf8Value utf8Value(value);
-        return std::string(*utf8Value);
+        return internal::ToUtf8<std::string>(value);
     }
 
     /// <summary> Convert a v8 value to std::u16string. </summary>
     template <>
     inline std::u16string V8ValueTo(const v8::Local<v8::Value>& value) {
-        v8::String::Value utf16Value(value);
-        return std::u16string(reinterpret_cast<const char16_t *>(*utf16Value));
+        return internal::ToUtf16<std::u16string>(value);
     }
 
     /// <summary> Convert a v8 value to napa::stl::String. </summary>
     template <>
     inline napa::stl::String V8ValueTo(const v8::Local<v8::Value>& value) {
-        v8::String::Utf8Value utf8Value(value);
-        return napa::stl::String(*utf8Value);
+        return internal::ToUtf8<napa::stl::String>(value);
     }
 
     /// <summary> Convert a v8 value to napa::stl::U16String. </summary>
     template <>
     inline napa::stl::U16String V8ValueTo(const v8::Local<v8::Value>& value) {
-        v8::String::Value utf16Value(value);
-        return napa::stl::U16String(reinterpret_cast<const char16_t *>(*utf16Value));
+        return internal::ToUtf16<napa::stl::U16String>(value);
     }
 
     /// <summary> Convert a v8 value to a Utf8String. </summary>
@@ -5,14 +5,34 @@
 
 #include <v8.h>
 #include <napa/stl/string.h>
+#include <napa/utils.h>
 #include <cstring>
+#include <string>
+#include <utility>
 
 namespace napa {
 namespace v8_helpers {
 
+    /// <summary> Shorter strings are copied into V8 instead of made external, an external string costs more to track than to copy. </summary>
+    constexpr size_t EXTERNAL_STRING_MIN_LENGTH = 1024;
+
+    /// <summary> Make a V8 string by making a copy of Latin-1 chars. </summary>
+    inline v8::Local<v8::String> MakeLatin1V8String(v8::Isolate *isolate, const char* str, size_t length) {
+        return v8::String::NewFromOneByte(
+            isolate,
+            reinterpret_cast<const uint8_t*>(str),
+            v8::NewStringType::kNormal,
+            static_cast<int>(length)).ToLocalChecked();
+    }
+
     /// <summary> Make a V8 string by making a copy of const char*. </summary>
+    /// <remarks> ASCII chars, like most marshalled JSON, are copied as they are instead of being decoded from UTF-8. </remarks>
     inline v8::Local<v8::String> MakeV8String(v8::Isolate *isolate, const char* str, int length = -1) {
-        return v8::String::NewFromUtf8(isolate, str, v8::NewStringType::kNormal, length).ToLocalChecked();
+        auto size = length < 0 ? std::strlen(str) : static_cast<size_t>(length);
+        if (napa::utils::IsAscii(str, size)) {
+            return MakeLatin1V8String(isolate, str, size);
+        }
+        return v8::String::NewFromUtf8(isolate, str, v8::NewStringType::kNormal, static_cast<int>(size)).ToLocalChecked();
     }
 
     /// <summary> Make a V8 string from std::string. </summary>
@@ -40,6 +60,27 @@ namespace v8_helpers {
         return MakeV8String(isolate, str.c_str(), static_cast<int>(str.length()));
     }
 
+    /// <summary> Write a V8 string into a one-byte buffer, if it only contains Latin-1 chars. </summary>
+    /// <param name="str"> The V8 string. </param>
+    /// <param name="latin1"> Receives the Latin-1 chars, left as is if the string has others. </param>
+    /// <returns> True if the string only contains Latin-1 chars. </returns>
+    /// <remarks> Latin-1 takes half the memory of UTF-16, and V8 makes one-byte strings from it without decoding. </remarks>
+    inline bool WriteOneByte(const v8::Local<v8::String>& str, std::string& latin1) {
+        if (!str->ContainsOnlyOneByte()) {
+            return false;
+        }
+
+        latin1.resize(str->Length());
+        if (!latin1.empty()) {
+            str->WriteOneByte(
+                reinterpret_cast<uint8_t*>(&latin1[0]),
+                0,
+                static_cast<int>(latin1.size()),
+                v8::String::NO_NULL_TERMINATION);
+        }
+        return true;
+    }
+
     /// <summary> Make a V8 string from napa::stl::U16String. </summary>
     inline v8::Local<v8::String> MakeV8String(v8::Isolate *isolate, const napa::stl::U16String& str) {
         return MakeV8String(isolate, str.c_str(), static_cast<int>(str.length()));
@@ -106,6 +147,61 @@ namespace v8_helpers {
         return MakeExternalV8String(isolate, str.data(), str.length());
     }
 
+    /// <summary> External one-byte string resource that owns its chars. V8 garbage collection frees it. </summary>
+    template <typename String>
+    class ExternalOneByteStringOwner : public v8::String::ExternalOneByteStringResource {
+    public:
+        explicit ExternalOneByteStringOwner(String&& str) : _str(std::move(str)) {}
+        const char* data() const override { return _str.data(); }
+        size_t length() const override { return _str.length(); }
+
+    private:
+        String _str;
+    };
+
+    /// <summary> External two-byte string resource that owns its chars. V8 garbage collection frees it. </summary>
+    template <typename String>
+    class ExternalTwoByteStringOwner : public v8::String::ExternalStringResource {
+    public:
+        explicit ExternalTwoByteStringOwner(String&& str) : _str(std::move(str)) {}
+        const uint16_t* data() const override { return reinterpret_cast<const uint16_t*>(_str.data()); }
+        size_t length() const override { return _str.length(); }
+
+    private:
+        String _str;
+    };
+
+    /// <summary> Make an external V8 string that takes over the buffer of std::string. </summary>
+    /// <remarks> The input data should only contains Latin-1 chars. </remarks>
+    inline v8::Local<v8::String> MakeOwnedExternalV8String(v8::Isolate *isolate, std::string&& str) {
+        auto externalResource = new ExternalOneByteStringOwner<std::string>(std::move(str));
+        return v8::String::NewExternalOneByte(isolate, externalResource).ToLocalChecked();
+    }
+
+    /// <summary> Make an external V8 string that takes over the buffer of std::u16string. </summary>
+    inline v8::Local<v8::String> MakeOwnedExternalV8String(v8::Isolate *isolate, std::u16string&& str) {
+        auto externalResource = new ExternalTwoByteStringOwner<std::u16string>(std::move(str));
+        return v8::String::NewExternalTwoByte(isolate, externalResource).ToLocalChecked();
+    }
+
+    /// <summary> Make a V8 string from std::string that is no longer needed. </summary>
+    /// <remarks> Long ASCII strings, like marshalled results, keep their buffer as an external string instead of being copied. </remarks>
+    inline v8::Local<v8::String> MakeV8String(v8::Isolate *isolate, std::string&& str) {
+        if (str.length() >= EXTERNAL_STRING_MIN_LENGTH && napa::utils::IsAscii(str.data(), str.length())) {
+            return MakeOwnedExternalV8String(isolate, std::move(str));
+        }
+        return MakeV8String(isolate, str.c_str(), static_cast<int>(str.length()));
+    }
+
+    /// <summary> Make a V8 string from std::u16string that is no longer needed. </summary>
+    /// <remarks> Long strings keep their buffer as an external string instead of being copied. </remarks>
+    inline v8::Local<v8::String> MakeV8String(v8::Isolate *isolate, std::u16string&& str) {
+        if (str.length() >= EXTERNAL_STRING_MIN_LENGTH) {
+            return MakeOwnedExternalV8String(isolate, std::move(str));
+        }
+        return MakeV8String(isolate, str.c_str(), static_cast<int>(str.length()));
+    }
+
     /// <summary> Converts a V8 string object to a movable Utf8String which supports an allocator. </summary>
     template <typename Alloc>
     class Utf8StringWithAllocator {
@@ -130,6 +226,21 @@ namespace v8_helpers {
             if (!val->ToString(context).ToLocal(&str)) {
                 return;
             }
+
+            // ASCII is the same in UTF-8, so one-byte strings of ASCII chars are copied without measuring and encoding them.
+            if (str->IsOneByte()) {
+                auto length = static_cast<size_t>(str->Length());
+                auto data = _alloc.allocate(length + 1);
+                str->WriteOneByte(reinterpret_cast<uint8_t*>(data), 0, static_cast<int>(length), v8::String::NO_NULL_TERMINATION);
+                if (napa::utils::IsAscii(data, length)) {
+                    data[length] = '\0';
+                    _data = data;
+                    _length = length;
+                    return;
+                }
+                _alloc.deallocate(data, length + 1);
+            }
+
             _length = str->Utf8Length();
             _data = _alloc.allocate(_length + 1);
             str->WriteUtf8(_data);
@@ -137,7 +248,7 @@ namespace v8_helpers {
 
         ~Utf8StringWithAllocator() {
             if (_data != nullptr) {
-                _alloc.deallocate(_data, _length);
+                _alloc.deallocate(_data, _length + 1);
             }
         }
 
@@ -5,8 +5,12 @@
 
 #include "napa/capi.h"
 
+#include <algorithm>
 #include <functional>
 #include <future>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 namespace napa {
 
@@ -54,22 +58,86 @@ namespace napa {
             return _zoneId;
         }
 
+        /// <summary> Retrieves the number of calls that are waiting for a zone worker. </summary>
+        size_t GetQueueLength() const {
+            return napa_zone_get_queue_length(_handle);
+        }
+
+        /// <summary> Retrieves the number of running zone workers. </summary>
+        uint32_t GetWorkerCount() const {
+            return napa_zone_get_worker_count(_handle);
+        }
+
+        /// <summary> Cancels the calls that were made with the given cancellation token. </summary>
+        void Cancel(uint64_t token) {
+            napa_zone_cancel(_handle, token);
+        }
+
+        /// <summary> Runs the queued calls, then disposes the zone workers and frees the zone id, see napa_zone_recycle. </summary>
+        ResultCode Recycle() {
+            return napa_zone_recycle(_handle);
+        }
+
+        /// <summary> Serves the zone to Zone::Connect of other processes or hosts, throws if the address can't be listened on. </summary>
+        /// <param name="address"> The address to listen on, like '0.0.0.0:port', port 0 for a port chosen by the system. </param>
+        /// <returns> The port the zone is served on, for StopServing. </returns>
+        uint16_t Serve(const std::string& address) {
+            uint16_t port = 0;
+            auto res = napa_zone_serve(_handle, STD_STRING_TO_NAPA_STRING_REF(address), &port);
+            if (res != NAPA_RESULT_SUCCESS) {
+                throw std::runtime_error("Failed to serve zone '" + _zoneId + "' on '" + address + "'");
+            }
+            return port;
+        }
+
+        /// <summary> Stops serving the zone served on a port, see napa_zone_stop_serving. </summary>
+        static void StopServing(uint16_t port) {
+            napa_zone_stop_serving(port);
+        }
+
+        /// <summary>
+        ///     Serves the zone to Zone::ConnectSharedMemory of other processes of the host,
+        ///     throws if the segment can't be created or another running process serves the name.
+        /// </summary>
+        /// <param name="name"> The name of the shared memory segment, without path separators. </param>
+        void ServeSharedMemory(const std::string& name) {
+            auto res = napa_zone_serve_shared_memory(_handle, STD_STRING_TO_NAPA_STRING_REF(name));
+            if (res != NAPA_RESULT_SUCCESS) {
+                throw std::runtime_error("Failed to serve zone '" + _zoneId + "' on shared memory '" + name + "'");
+            }
+        }
+
+        /// <summary> Stops serving the zone served on a shared memory name, see napa_zone_stop_serving_shared_memory. </summary>
+        static void StopServingSharedMemory(const std::string& name) {
+            napa_zone_stop_serving_shared_memory(STD_STRING_TO_NAPA_STRING_REF(name));
+        }
+
         /// <see cref="Zone::Broadcast" />
         void Broadcast(const FunctionSpec& spec, BroadcastCallback callback) {
+            Broadcast(spec, {}, std::move(callback));
+        }
+
+        /// <summary> Executes a pre-loaded JS function on some zone workers asynchronously. </summary>
+        /// <param name="spec"> A function spec to call. </param>
+        /// <param name="workerIds"> The ids of the workers to run it, all workers if empty. </param>
+        /// <param name="callback"> A callback that is triggered when the running workers among them are done. </param>
+        void Broadcast(const FunctionSpec& spec, const std::vector<uint32_t>& workerIds, BroadcastCallback callback) {
             // Will be deleted on when the callback scope ends.
             auto context = new BroadcastCallback(std::move(callback));
 
             napa_zone_function_spec req;
             req.module = spec.module;
             req.function = spec.function;
-            req.arguments = spec.arguments.data();
-            req.arguments_count = spec.arguments.size();
+            std::vector<StringRef> argumentRefs;
+            const auto& arguments = GetArgumentRefs(spec, argumentRefs);
+            req.arguments = arguments.data();
+            req.arguments_count = arguments.size();
             req.options = spec.options;
 
             // Release ownership of transport context
             req.transport_context = reinterpret_cast<void*>(spec.transportContext.release());
 
-            napa_zone_broadcast(_handle, req, [](napa_zone_result result, void* context) {
+            napa_zone_broadcast_to_workers(_handle, req, workerIds.data(), workerIds.size(), [](napa_zone_result result, void* context) {
                 // Ensures the context is deleted when this scope ends.
                 std::unique_ptr<BroadcastCallback> callback(reinterpret_cast<BroadcastCallback*>(context));
 
@@ -77,6 +145,7 @@ namespace napa {
                 res.code = result.code;
                 res.errorMessage = NAPA_STRING_REF_TO_STD_STRING(result.error_message);
                 res.returnValue = NAPA_STRING_REF_TO_STD_STRING(result.return_value);
+                res.timing = result.timing;
 
                 // Assume ownership of transport context
                 res.transportContext.reset(
@@ -113,8 +182,10 @@ namespace napa {
             napa_zone_function_spec req;
             req.module = spec.module;
             req.function = spec.function;
-            req.arguments = spec.arguments.data();
-            req.arguments_count = spec.arguments.size();
+            std::vector<StringRef> argumentRefs;
+            const auto& arguments = GetArgumentRefs(spec, argumentRefs);
+            req.arguments = arguments.data();
+            req.arguments_count = arguments.size();
             req.options = spec.options;
 
             // Release ownership of transport context
@@ -128,6 +199,45 @@ namespace napa {
                 res.code = result.code;
                 res.errorMessage = NAPA_STRING_REF_TO_STD_STRING(result.error_message);
                 res.returnValue = NAPA_STRING_REF_TO_STD_STRING(result.return_value);
+                res.timing = result.timing;
+
+                // Assume ownership of transport context
+                res.transportContext.reset(
+                    reinterpret_cast<napa::transport::TransportContext*>(result.transport_context));
+
+                (*callback)(std::move(res));
+            }, context);
+        }
+
+        /// <summary> Executes a pre-loaded JS function asynchronously on the given worker. </summary>
+        /// <param name="workerId"> The id of the worker. </param>
+        /// <param name="spec"> A function spec to call. </param>
+        /// <param name="callback"> A callback that is triggered when execution is done. </param>
+        void ExecuteOnWorker(uint32_t workerId, const FunctionSpec& spec, ExecuteCallback callback) {
+            // Will be deleted on when the callback scope ends.
+            auto context = new ExecuteCallback(std::move(callback));
+
+            napa_zone_function_spec req;
+            req.module = spec.module;
+            req.function = spec.function;
+            std::vector<StringRef> argumentRefs;
+            const auto& arguments = GetArgumentRefs(spec, argumentRefs);
+            req.arguments = arguments.data();
+            req.arguments_count = arguments.size();
+            req.options = spec.options;
+
+            // Release ownership of transport context
+            req.transport_context = reinterpret_cast<void*>(spec.transportContext.release());
+
+            napa_zone_execute_on_worker(_handle, workerId, req, [](napa_zone_result result, void* context) {
+                // Ensures the context is deleted when this scope ends.
+                std::unique_ptr<ExecuteCallback> callback(reinterpret_cast<ExecuteCallback*>(context));
+
+                Result res;
+                res.code = result.code;
+                res.errorMessage = NAPA_STRING_REF_TO_STD_STRING(result.error_message);
+                res.returnValue = NAPA_STRING_REF_TO_STD_STRING(result.return_value);
+                res.timing = result.timing;
 
                 // Assume ownership of transport context
                 res.transportContext.reset(
@@ -150,6 +260,165 @@ namespace napa {
             return fut.get();
         }
 
+        /// <summary> Executes a batch of pre-loaded JS functions asynchronously. </summary>
+        /// <param name="specs"> The function specs to call. </param>
+        /// <param name="callback"> A callback that is triggered when all executions are done, with results in spec order. </param>
+        void ExecuteBatch(const std::vector<FunctionSpec>& specs, ExecuteBatchCallback callback) {
+            // Will be deleted on when the callback scope ends.
+            auto context = new ExecuteBatchCallback(std::move(callback));
+
+            std::vector<napa_zone_function_spec> reqs(specs.size());
+            std::vector<std::vector<StringRef>> argumentRefs(specs.size());
+            for (size_t i = 0; i < specs.size(); i++) {
+                const auto& spec = specs[i];
+                auto& req = reqs[i];
+
+                req.module = spec.module;
+                req.function = spec.function;
+                const auto& arguments = GetArgumentRefs(spec, argumentRefs[i]);
+                req.arguments = arguments.data();
+                req.arguments_count = arguments.size();
+                req.options = spec.options;
+
+                // Release ownership of transport context
+                req.transport_context = reinterpret_cast<void*>(spec.transportContext.release());
+            }
+
+            napa_zone_execute_batch(_handle, reqs.data(), reqs.size(), [](const napa_zone_result* results, size_t count, void* context) {
+                // Ensures the context is deleted when this scope ends.
+                std::unique_ptr<ExecuteBatchCallback> callback(reinterpret_cast<ExecuteBatchCallback*>(context));
+
+                std::vector<Result> res(count);
+                for (size_t i = 0; i < count; i++) {
+                    res[i].code = results[i].code;
+                    res[i].errorMessage = NAPA_STRING_REF_TO_STD_STRING(results[i].error_message);
+                    res[i].returnValue = NAPA_STRING_REF_TO_STD_STRING(results[i].return_value);
+                    res[i].timing = results[i].timing;
+
+                    // Assume ownership of transport context
+                    res[i].transportContext.reset(
+                        reinterpret_cast<napa::transport::TransportContext*>(results[i].transport_context));
+                }
+
+                (*callback)(std::move(res));
+            }, context);
+        }
+
+        /// <summary> Runs a native function asynchronously on a zone worker, next to JS calls and without entering V8. </summary>
+        /// <param name="function"> The native function, it must not use V8. </param>
+        /// <param name="callback"> A callback that is triggered once the function ran, or with the code it was dropped with. </param>
+        void ExecuteNative(NativeFunction function, NativeCallback callback) {
+            // Will be deleted on when the callback scope ends.
+            auto context = new std::pair<NativeFunction, NativeCallback>(std::move(function), std::move(callback));
+
+            napa_zone_execute_native(_handle, [](void* context) {
+                reinterpret_cast<std::pair<NativeFunction, NativeCallback>*>(context)->first();
+            }, context, [](napa_result_code code, void* context) {
+                // Ensures the context is deleted when this scope ends.
+                std::unique_ptr<std::pair<NativeFunction, NativeCallback>> functions(
+                    reinterpret_cast<std::pair<NativeFunction, NativeCallback>*>(context));
+
+                if (functions->second) {
+                    functions->second(code);
+                }
+            });
+        }
+
+        /// <see cref="Zone::GetHeapStatistics" />
+        void GetHeapStatistics(HeapStatisticsCallback callback) {
+            // Will be deleted on when the callback scope ends.
+            auto context = new HeapStatisticsCallback(std::move(callback));
+
+            napa_zone_get_heap_statistics(_handle, [](const napa_zone_heap_statistics* statistics, size_t count, void* context) {
+                // Ensures the context is deleted when this scope ends.
+                std::unique_ptr<HeapStatisticsCallback> callback(reinterpret_cast<HeapStatisticsCallback*>(context));
+
+                (*callback)(std::vector<HeapStatistics>(statistics, statistics + count));
+            }, context);
+        }
+
+        /// <summary> Reads the utilization counters of the zone and its running workers. </summary>
+        ZoneStats GetStats() const {
+            ZoneStats result;
+            napa_zone_get_stats(_handle, [](const napa_zone_stats* stats, void* context) {
+                auto& result = *reinterpret_cast<ZoneStats*>(context);
+                result.pendingTasks = stats->pending_tasks;
+                result.workers.assign(stats->workers, stats->workers + stats->workers_count);
+                for (size_t i = 0; i < stats->tenants_count; ++i) {
+                    const auto& tenant = stats->tenants[i];
+                    TenantStats tenantStats;
+                    tenantStats.tenant = tenant.tenant;
+                    tenantStats.name = NAPA_STRING_REF_TO_STD_STRING(tenant.name);
+                    tenantStats.queuedTasks = tenant.queued_tasks;
+                    tenantStats.dispatchedTasks = tenant.dispatched_tasks;
+                    tenantStats.waitTime = tenant.wait_time;
+                    tenantStats.maxWaitTime = tenant.max_wait_time;
+                    result.tenants.emplace_back(std::move(tenantStats));
+                }
+                for (size_t i = 0; i < stats->functions_count; ++i) {
+                    const auto& function = stats->functions[i];
+                    FunctionCounters counters;
+                    counters.function = NAPA_STRING_REF_TO_STD_STRING(function.function);
+                    counters.calls = function.calls;
+                    counters.cycles = function.cycles;
+                    counters.instructions = function.instructions;
+                    counters.cacheReferences = function.cache_references;
+                    counters.cacheMisses = function.cache_misses;
+                    result.functions.emplace_back(std::move(counters));
+                }
+            }, &result);
+            return result;
+        }
+
+        /// <summary> Reads the statistics of the calls of each function that ran in the zone, ordered by module and function. </summary>
+        std::vector<FunctionStats> GetFunctionStats() const {
+            std::vector<FunctionStats> result;
+            napa_zone_get_function_stats(_handle, [](const napa_zone_function_stats* stats, size_t count, void* context) {
+                auto& result = *reinterpret_cast<std::vector<FunctionStats>*>(context);
+                for (size_t i = 0; i < count; ++i) {
+                    FunctionStats functionStats;
+                    functionStats.module = NAPA_STRING_REF_TO_STD_STRING(stats[i].module);
+                    functionStats.function = NAPA_STRING_REF_TO_STD_STRING(stats[i].function);
+                    functionStats.calls = stats[i].calls;
+                    functionStats.errors = stats[i].errors;
+                    functionStats.totalTime = stats[i].total_time;
+                    functionStats.maxTime = stats[i].max_time;
+                    std::copy(std::begin(stats[i].histogram), std::end(stats[i].histogram), std::begin(functionStats.histogram));
+                    result.emplace_back(std::move(functionStats));
+                }
+            }, &result);
+            return result;
+        }
+
+        /// <see cref="Zone::NotifyMemoryPressure" />
+        void NotifyMemoryPressure(MemoryPressureLevel level) {
+            napa_zone_notify_memory_pressure(_handle, level);
+        }
+
+        /// <see cref="Zone::StartProfiling" />
+        void StartProfiling(const std::vector<uint32_t>& workerIds, uint32_t samplingInterval) {
+            napa_zone_start_profiling(_handle, workerIds.data(), workerIds.size(), samplingInterval);
+        }
+
+        /// <see cref="Zone::StopProfiling" />
+        void StopProfiling(CpuProfilesCallback callback) {
+            // Will be deleted on when the callback scope ends.
+            auto context = new CpuProfilesCallback(std::move(callback));
+
+            napa_zone_stop_profiling(_handle, [](const napa_zone_cpu_profile* profiles, size_t count, void* context) {
+                // Ensures the context is deleted when this scope ends.
+                std::unique_ptr<CpuProfilesCallback> callback(reinterpret_cast<CpuProfilesCallback*>(context));
+
+                std::vector<CpuProfile> res(count);
+                for (size_t i = 0; i < count; i++) {
+                    res[i].workerId = profiles[i].worker_id;
+                    res[i].profile = NAPA_STRING_REF_TO_STD_STRING(profiles[i].profile);
+                }
+
+                (*callback)(std::move(res));
+            }, context);
+        }
+
         /// <summary> Retrieves a new zone proxy for the zone id, throws if zone is not found. </summary>
         static std::unique_ptr<Zone> Get(const std::string& id) {
             auto handle = napa_zone_get(STD_STRING_TO_NAPA_STRING_REF(id));
@@ -171,8 +440,48 @@ namespace napa {
             return std::unique_ptr<Zone>(new Zone(std::move(zoneId), handle));
         }
 
+        /// <summary> Connects to a zone served by another process or host, throws if the address doesn't serve a zone. </summary>
+        /// <param name="address"> The address the zone is served on, like 'host:port'. </param>
+        /// <param name="connections"> The number of TCP connections calls are spread on. </param>
+        static std::unique_ptr<Zone> Connect(const std::string& address, uint32_t connections = 1) {
+            auto handle = napa_zone_connect(STD_STRING_TO_NAPA_STRING_REF(address), connections);
+            if (!handle) {
+                throw std::runtime_error("No zone is served at '" + address + "'");
+            }
+
+            auto zoneId = NAPA_STRING_REF_TO_STD_STRING(napa_zone_get_id(handle));
+            return std::unique_ptr<Zone>(new Zone(std::move(zoneId), handle));
+        }
+
+        /// <summary> Connects to a zone served by another process of the host on shared memory, throws if no process serves the name. </summary>
+        /// <param name="name"> The name the zone is served on. </param>
+        /// <param name="connections"> The number of channels calls are spread on. </param>
+        static std::unique_ptr<Zone> ConnectSharedMemory(const std::string& name, uint32_t connections = 1) {
+            auto handle = napa_zone_connect_shared_memory(STD_STRING_TO_NAPA_STRING_REF(name), connections);
+            if (!handle) {
+                throw std::runtime_error("No zone is served on shared memory '" + name + "'");
+            }
+
+            auto zoneId = NAPA_STRING_REF_TO_STD_STRING(napa_zone_get_id(handle));
+            return std::unique_ptr<Zone>(new Zone(std::move(zoneId), handle));
+        }
+
     private:
 
+        /// <summary> Returns the arguments of a spec as references, which reference its owned arguments if it has any. </summary>
+        /// <remarks> The C API copies the arguments it's given, so owned arguments are only moved by zones in the process. </remarks>
+        static const std::vector<StringRef>& GetArgumentRefs(const FunctionSpec& spec, std::vector<StringRef>& refs) {
+            if (spec.ownedArguments.empty()) {
+                return spec.arguments;
+            }
+
+            refs.reserve(spec.ownedArguments.size());
+            for (const auto& argument : spec.ownedArguments) {
+                refs.emplace_back(STD_STRING_TO_NAPA_STRING_REF(argument));
+            }
+            return refs;
+        }
+
         /// <summary> Private constructor to create a C++ zone proxy from a C handle. </summary>
         explicit Zone(const std::string& id, napa_zone_handle handle) : _zoneId(id), _handle(handle) {}
 
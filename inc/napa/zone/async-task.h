@@ -0,0 +1,300 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "napa/zone/async-task.h requires a compiler with C++20 coroutines."
+#endif
+
+#include <napa/async.h>
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace napa {
+namespace zone {
+
+    /// <summary>
+    ///     A coroutine of a native module, which chains asynchronous steps with co_await instead of callbacks.
+    ///     Each co_await on RunAsync or WaitForCompletion resumes on the Napa worker (or node event loop)
+    ///     that awaited, so the code between steps can use V8 of the calling isolate.
+    /// </summary>
+    /// <remarks>
+    ///     A task starts when it is awaited, or when Detach is called on it. Code after a step resumes inside a
+    ///     v8::HandleScope, but not in the v8::Context::Scope of the call that started the task.
+    /// </remarks>
+    /// <example>
+    ///     napa::zone::AsyncTask<void> Compute(std::shared_ptr<v8::Persistent<v8::Function>> callback) {
+    ///         auto data = co_await napa::zone::RunAsync([]() { return Load(); });
+    ///         auto result = co_await napa::zone::RunAsync([data]() { return Process(data); });
+    ///         // Back on the worker, call the JavaScript callback with the result.
+    ///     }
+    ///
+    ///     Compute(callback).Detach();
+    /// </example>
+    template <typename T>
+    class AsyncTask;
+
+    namespace internal {
+
+        /// <summary> A value or an exception set by a coroutine or by an asynchronous step. </summary>
+        template <typename T>
+        class AsyncResult {
+        public:
+            template <typename Function>
+            void Run(Function& function) {
+                try {
+                    _value.emplace(function());
+                } catch (...) {
+                    _error = std::current_exception();
+                }
+            }
+
+            void SetValue(T value) { _value.emplace(std::move(value)); }
+            void SetError(std::exception_ptr error) { _error = std::move(error); }
+            bool HasError() const { return _error != nullptr; }
+
+            T Get() {
+                if (_error != nullptr) {
+                    std::rethrow_exception(_error);
+                }
+                return std::move(*_value);
+            }
+
+        private:
+            std::optional<T> _value;
+            std::exception_ptr _error;
+        };
+
+        template <>
+        class AsyncResult<void> {
+        public:
+            template <typename Function>
+            void Run(Function& function) {
+                try {
+                    function();
+                } catch (...) {
+                    _error = std::current_exception();
+                }
+            }
+
+            void SetValue() {}
+            void SetError(std::exception_ptr error) { _error = std::move(error); }
+            bool HasError() const { return _error != nullptr; }
+
+            void Get() {
+                if (_error != nullptr) {
+                    std::rethrow_exception(_error);
+                }
+            }
+
+        private:
+            std::exception_ptr _error;
+        };
+
+        /// <summary> Promise parts that don't depend on the result type. </summary>
+        template <typename T>
+        struct AsyncTaskPromiseBase {
+            /// <summary> Resumes the awaiting coroutine, or destroys a detached one once it finished. </summary>
+            struct FinalAwaiter {
+                bool await_ready() const noexcept { return false; }
+
+                template <typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                    auto& promise = handle.promise();
+                    if (promise.detached) {
+                        // Nobody reads the result of a detached task, an exception escaping it is fatal.
+                        if (promise.result.HasError()) {
+                            std::terminate();
+                        }
+                        handle.destroy();
+                        return std::noop_coroutine();
+                    }
+                    return promise.continuation ? promise.continuation : std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            void unhandled_exception() { result.SetError(std::current_exception()); }
+
+            std::coroutine_handle<> continuation;
+            AsyncResult<T> result;
+            bool detached = false;
+        };
+
+        template <typename T>
+        struct AsyncTaskPromise : AsyncTaskPromiseBase<T> {
+            AsyncTask<T> get_return_object();
+            void return_value(T value) { this->result.SetValue(std::move(value)); }
+        };
+
+        template <>
+        struct AsyncTaskPromise<void> : AsyncTaskPromiseBase<void> {
+            AsyncTask<void> get_return_object();
+            void return_void() {}
+        };
+    }
+
+    template <typename T>
+    class AsyncTask {
+    public:
+        using promise_type = internal::AsyncTaskPromise<T>;
+
+        explicit AsyncTask(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+        AsyncTask(AsyncTask&& other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+
+        AsyncTask& operator=(AsyncTask&& other) noexcept {
+            if (this != &other) {
+                Destroy();
+                _handle = std::exchange(other._handle, nullptr);
+            }
+            return *this;
+        }
+
+        AsyncTask(const AsyncTask&) = delete;
+        AsyncTask& operator=(const AsyncTask&) = delete;
+
+        /// <summary> Destroys the coroutine, it must not be suspended in an asynchronous step. </summary>
+        ~AsyncTask() {
+            Destroy();
+        }
+
+        /// <summary> Starts the task without awaiting it, the coroutine frees itself once it finishes. </summary>
+        void Detach() {
+            auto handle = std::exchange(_handle, nullptr);
+            handle.promise().detached = true;
+            handle.resume();
+        }
+
+        /// <summary> Awaiting a task starts it, and resumes the awaiting coroutine with its result. </summary>
+        auto operator co_await() const noexcept {
+            struct Awaiter {
+                std::coroutine_handle<promise_type> handle;
+
+                bool await_ready() const noexcept { return handle.done(); }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                }
+
+                T await_resume() { return handle.promise().result.Get(); }
+            };
+            return Awaiter{ _handle };
+        }
+
+    private:
+        void Destroy() {
+            if (_handle) {
+                _handle.destroy();
+                _handle = nullptr;
+            }
+        }
+
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+    namespace internal {
+
+        template <typename T>
+        AsyncTask<T> AsyncTaskPromise<T>::get_return_object() {
+            return AsyncTask<T>(std::coroutine_handle<AsyncTaskPromise<T>>::from_promise(*this));
+        }
+
+        inline AsyncTask<void> AsyncTaskPromise<void>::get_return_object() {
+            return AsyncTask<void>(std::coroutine_handle<AsyncTaskPromise<void>>::from_promise(*this));
+        }
+
+        /// <summary> Awaiter running a function in the async work pool, resuming on the awaiting worker. </summary>
+        template <typename Function>
+        class AsyncWorkAwaiter {
+        public:
+            using ResultType = std::invoke_result_t<Function&>;
+
+            explicit AsyncWorkAwaiter(Function function) : _function(std::move(function)) {}
+
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> handle) {
+                auto continuation = CreateWorkerContinuation();
+                if (!continuation) {
+                    // Outside Napa workers and node, the function runs in place.
+                    _result.Run(_function);
+                    return false;
+                }
+
+                auto posted = PostToAsyncWorkPool([this, handle, continuation]() {
+                    _result.Run(_function);
+                    continuation([handle]() { handle.resume(); });
+                });
+                if (!posted) {
+                    _result.Run(_function);
+                    continuation([handle]() { handle.resume(); });
+                }
+                return true;
+            }
+
+            ResultType await_resume() { return _result.Get(); }
+
+        private:
+            Function _function;
+            AsyncResult<ResultType> _result;
+        };
+
+        /// <summary> Awaiter starting a callback based asynchronous function, resuming on the awaiting worker. </summary>
+        template <typename T, typename Start>
+        class CompletionAwaiter {
+        public:
+            explicit CompletionAwaiter(Start start) : _start(std::move(start)) {}
+
+            bool await_ready() const noexcept { return false; }
+
+            bool await_suspend(std::coroutine_handle<> handle) {
+                auto continuation = CreateWorkerContinuation();
+                if (!continuation) {
+                    throw std::runtime_error("WaitForCompletion must be awaited on a Napa worker or the node event loop.");
+                }
+
+                // The continuation is queued to the worker even when the function completes in place,
+                // so the coroutine never resumes inside the completion callback.
+                _start([this, handle, continuation](T value) {
+                    _value.emplace(std::move(value));
+                    continuation([handle]() { handle.resume(); });
+                });
+                return true;
+            }
+
+            T await_resume() { return std::move(*_value); }
+
+        private:
+            Start _start;
+            std::optional<T> _value;
+        };
+    }
+
+    /// <summary> Awaitable running a function in a separate thread, it resumes on the awaiting worker with the result. </summary>
+    /// <param name="function"> Function to run, an exception it throws is rethrown by co_await. </param>
+    template <typename Function>
+    internal::AsyncWorkAwaiter<Function> RunAsync(Function function) {
+        return internal::AsyncWorkAwaiter<Function>(std::move(function));
+    }
+
+    /// <summary> Awaitable starting a callback based asynchronous function, it resumes on the awaiting worker with the value. </summary>
+    /// <param name="start"> Called on co_await with a completion callback taking a T, which can be called from any thread once. </param>
+    template <typename T, typename Start>
+    internal::CompletionAwaiter<T, Start> WaitForCompletion(Start start) {
+        return internal::CompletionAwaiter<T, Start>(std::move(start));
+    }
+
+}   // End of namespace zone.
+}   // End of namespace napa.
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#ifdef BUILDING_NAPA_EXTENSION
+
+#include <napa/exports.h>
+
+struct uv_loop_s;
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Gets the libuv loop of the current Napa worker, to run asynchronous I/O of native modules. </summary>
+    /// <returns> The uv_loop_t of the worker, or null if the zone doesn't enable 'eventLoop'. </returns>
+    /// <remarks>
+    ///     The loop runs on the worker thread between tasks, its callbacks run in the worker's isolate and context
+    ///     but need their own v8::HandleScope. Handles left open are closed when the worker shuts down.
+    /// </remarks>
+    NAPA_API uv_loop_s* GetEventLoop();
+
+}   // End of namespace zone.
+}   // End of namespace napa.
+
+#else
+
+#include <uv.h>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Gets the libuv loop of node. </summary>
+    inline uv_loop_t* GetEventLoop() {
+        return uv_default_loop();
+    }
+
+}   // End of namespace zone.
+}   // End of namespace napa.
+
+#endif
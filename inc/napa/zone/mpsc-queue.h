@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> An unbounded lock-free multi-producer single-consumer queue. </summary>
+    /// <remarks>
+    ///     Producers push onto an intrusive stack with a single CAS. The consumer takes the whole stack with one
+    ///     exchange and reverses it, so values are drained in the order they were pushed and a drain costs one
+    ///     atomic operation no matter how many values are pending. Values taken beyond a drain's budget stay in
+    ///     a list private to the consumer, for the next drain.
+    /// </remarks>
+    template <typename T>
+    class MpscQueue {
+    public:
+
+        MpscQueue() : _head(nullptr), _taken(nullptr) {}
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        ~MpscQueue() {
+            for (auto node : { _head.exchange(nullptr, std::memory_order_acquire), _taken }) {
+                while (node != nullptr) {
+                    auto next = node->next;
+                    delete node;
+                    node = next;
+                }
+            }
+        }
+
+        /// <summary> Pushes a value, from any thread. </summary>
+        /// <returns> True if the queue was empty, which tells the producer to wake the consumer. </returns>
+        bool Push(T value) {
+            auto node = new Node{ std::move(value), _head.load(std::memory_order_relaxed) };
+            while (!_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+            return node->next == nullptr;
+        }
+
+        /// <summary> Pops pending values and calls the consumer with each, in the order they were pushed. </summary>
+        /// <remarks> Only one thread may drain at a time. Values pushed while draining are left for the next drain. </remarks>
+        /// <param name="consumer"> Called with each value. </param>
+        /// <param name="budget"> The most values to pop, the others stay pending. </param>
+        /// <returns> The number of values drained. </returns>
+        template <typename Consumer>
+        size_t Drain(Consumer&& consumer, size_t budget = std::numeric_limits<size_t>::max()) {
+            if (_taken == nullptr) {
+                auto node = _head.exchange(nullptr, std::memory_order_acquire);
+
+                // The stack holds the newest value first.
+                while (node != nullptr) {
+                    auto next = node->next;
+                    node->next = _taken;
+                    _taken = node;
+                    node = next;
+                }
+            }
+
+            size_t count = 0;
+            while (_taken != nullptr && count < budget) {
+                auto node = _taken;
+                _taken = node->next;
+                consumer(std::move(node->value));
+                delete node;
+                ++count;
+            }
+            return count;
+        }
+
+        /// <summary> Returns true if no value is pending. </summary>
+        /// <remarks> It must be called by the consumer. The answer may be stale by the time the caller uses it. </remarks>
+        bool Empty() const {
+            return _taken == nullptr && _head.load(std::memory_order_acquire) == nullptr;
+        }
+
+    private:
+        struct Node {
+            T value;
+            Node* next;
+        };
+
+        std::atomic<Node*> _head;
+
+        /// <summary> Values taken by the consumer but not drained yet, oldest first. </summary>
+        Node* _taken;
+    };
+}
+}
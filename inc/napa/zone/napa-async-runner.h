@@ -29,6 +29,10 @@ namespace zone {
     /// </summary>
     using AsyncCompleteCallback = std::function<void(v8::Local<v8::Function>, void*)>;
 
+    /// <summary> Runs a callback on the worker that created it, it can be called from any thread but only once. </summary>
+    /// <remarks> The callback runs inside v8::HandleScope, in a task of the worker. </remarks>
+    using WorkerContinuation = std::function<void(std::function<void()>)>;
+
     /// <summary> It runs a synchronous function in a separate thread and posts a completion into the current V8 execution loop. </summary>
     /// <param name="jsCallback"> Javascript callback. </summary>
     /// <param name="asyncWork"> Function to run asynchronously in separate thread. </param>
@@ -45,5 +49,14 @@ namespace zone {
                               const CompletionWork& asyncWork,
                               AsyncCompleteCallback asyncCompleteCallback);
 
+    /// <summary> It creates a continuation back to the current worker, which keeps running until the continuation is called. </summary>
+    /// <returns> The continuation, or an empty function if the current thread isn't a Napa worker. </returns>
+    NAPA_API WorkerContinuation CreateWorkerContinuation();
+
+    /// <summary> It runs a function in the async work pool of the current zone. </summary>
+    /// <param name="work"> Function to run in a separate thread. </param>
+    /// <returns> False if the current thread isn't a Napa worker, then the function doesn't run. </returns>
+    NAPA_API bool PostToAsyncWorkPool(std::function<void()> work);
+
 }   // End of namespace module.
 }   // End of namespace napa.
\ No newline at end of file
@@ -3,9 +3,12 @@
 
 #pragma once
 
+#include <napa/zone/mpsc-queue.h>
+
 #include <node.h>
 #include <uv.h>
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -30,6 +33,10 @@ namespace zone {
     /// </summary>
     using AsyncCompleteCallback = std::function<void(v8::Local<v8::Function>, void*)>;
 
+    /// <summary> Runs a callback on the event loop that created it, it can be called from any thread but only once. </summary>
+    /// <remarks> The callback runs inside v8::HandleScope. </remarks>
+    using WorkerContinuation = std::function<void(std::function<void()>)>;
+
     /// <summary> Class holding asynchronous callbacks and libuv request. </summary>
     struct AsyncContext {
         /// <summary> libuv request. </summary>
@@ -48,11 +55,8 @@ namespace zone {
         AsyncCompleteCallback asyncCompleteCallback;
     };
 
-    /// <summary> Class holding completion callback and libuv request. </summary>
+    /// <summary> Class holding completion callback. </summary>
     struct CompletionContext {
-        /// <summary> libuv request. </summary>
-        uv_async_t work;
-
         /// <summary> Javascript callback. </summary>
         v8::Persistent<v8::Function> jsCallback;
 
@@ -92,23 +96,77 @@ namespace zone {
         context->asyncCompleteCallback(jsCallback, context->result);
     }
 
-    /// <summary> Callback run in node event loop. </summary>
-    /// <param name="work"> libuv request holding asynchronous callbacks. </summary>
-    inline void RunCompletionCallback(uv_async_t* work) {
-        auto isolate = v8::Isolate::GetCurrent();
-        v8::HandleScope scope(isolate);
+    /// <summary> Completions of asynchronous functions, delivered to the node event loop in batches. </summary>
+    /// <remarks>
+    ///     Threads completing work push onto a lock-free queue, and one long-lived uv_async_t wakes the loop for all
+    ///     of them. A wakeup runs at most DRAIN_BUDGET completions and wakes the loop again for the rest, so a burst
+    ///     of completions doesn't hold the loop from other events. The handle keeps the loop alive only while
+    ///     completions are pending.
+    /// </remarks>
+    class CompletionQueue {
+    public:
 
-        auto context = static_cast<CompletionContext*>(work->data);
+        /// <summary> The most completions run per wakeup of the event loop. </summary>
+        static constexpr size_t DRAIN_BUDGET = 256;
 
-        auto jsCallback = v8::Local<v8::Function>::New(isolate, context->jsCallback);
-        context->asyncCompleteCallback(jsCallback, context->result);
+        /// <summary> Returns the queue of the node event loop, it must be first called on the loop thread. </summary>
+        static CompletionQueue& Get() {
+            static CompletionQueue queue;
+            return queue;
+        }
 
-        uv_close(reinterpret_cast<uv_handle_t*>(work), [](auto work) {
-            auto context = static_cast<CompletionContext*>(work->data);
-            context->jsCallback.Reset();
-            delete context;
-        });
-    }
+        /// <summary> Accounts for a completion to come, on the loop thread. </summary>
+        void Expect() {
+            if (_expected++ == 0) {
+                uv_ref(reinterpret_cast<uv_handle_t*>(&_wakeup));
+            }
+        }
+
+        /// <summary> Posts a completion, from any thread. </summary>
+        void Post(CompletionContext* context) {
+            // Only the completion that finds the queue empty needs to wake the loop.
+            if (_completions.Push(context)) {
+                uv_async_send(&_wakeup);
+            }
+        }
+
+    private:
+        CompletionQueue() : _expected(0) {
+            _wakeup.data = this;
+            uv_async_init(uv_default_loop(), &_wakeup, Run);
+            uv_unref(reinterpret_cast<uv_handle_t*>(&_wakeup));
+        }
+
+        /// <summary> Runs pending completions in the node event loop. </summary>
+        static void Run(uv_async_t* work) {
+            auto& queue = *static_cast<CompletionQueue*>(work->data);
+            auto isolate = v8::Isolate::GetCurrent();
+
+            auto count = queue._completions.Drain([isolate](CompletionContext* context) {
+                v8::HandleScope scope(isolate);
+
+                auto jsCallback = v8::Local<v8::Function>::New(isolate, context->jsCallback);
+                context->asyncCompleteCallback(jsCallback, context->result);
+
+                context->jsCallback.Reset();
+                delete context;
+            }, DRAIN_BUDGET);
+
+            queue._expected -= count;
+            if (!queue._completions.Empty()) {
+                // Continue in the next loop iteration, after the events that are ready now.
+                uv_async_send(&queue._wakeup);
+            } else if (queue._expected == 0) {
+                uv_unref(reinterpret_cast<uv_handle_t*>(&queue._wakeup));
+            }
+        }
+
+        uv_async_t _wakeup;
+        MpscQueue<CompletionContext*> _completions;
+
+        /// <summary> The number of completions not run yet, only used on the loop thread. </summary>
+        size_t _expected;
+    };
 
     /// <summary> It runs a synchronous function in a separate thread and posts a completion into the current V8 execution loop. </summary>
     /// <param name="jsCallback"> Javascript callback. </summary>
@@ -144,18 +202,57 @@ namespace zone {
 
         auto context = new CompletionContext();
 
-        context->work.data = context;
         context->jsCallback.Reset(isolate, jsCallback);
         context->asyncCompleteCallback = std::move(asyncCompleteCallback);
 
-        uv_async_init(uv_default_loop(), &context->work, RunCompletionCallback);
+        auto& completions = CompletionQueue::Get();
+        completions.Expect();
 
-        asyncWork([context](void* result) {
+        asyncWork([context, &completions](void* result) {
             context->result = result;
 
-            uv_async_send(&context->work);
+            completions.Post(context);
         });
     }
 
+    /// <summary> It creates a continuation back to the node event loop, which is kept alive until the continuation is called. </summary>
+    inline WorkerContinuation CreateWorkerContinuation() {
+        auto& completions = CompletionQueue::Get();
+        completions.Expect();
+
+        return [&completions](std::function<void()> callback) {
+            auto context = new CompletionContext();
+            context->asyncCompleteCallback = [callback](v8::Local<v8::Function>, void*) {
+                callback();
+            };
+            completions.Post(context);
+        };
+    }
+
+    /// <summary> Class holding a function run in the libuv thread pool. </summary>
+    struct WorkPoolContext {
+        /// <summary> libuv request. </summary>
+        uv_work_t work;
+
+        /// <summary> Function to run in separate thread. </summary>
+        std::function<void()> function;
+    };
+
+    /// <summary> It runs a function in the libuv thread pool. </summary>
+    /// <param name="work"> Function to run in a separate thread. </param>
+    /// <returns> Always true, the node event loop has a thread pool. </returns>
+    inline bool PostToAsyncWorkPool(std::function<void()> work) {
+        auto context = new WorkPoolContext();
+        context->work.data = context;
+        context->function = std::move(work);
+
+        uv_queue_work(
+            uv_default_loop(),
+            &context->work,
+            [](uv_work_t* work) { static_cast<WorkPoolContext*>(work->data)->function(); },
+            [](uv_work_t* work, int) { delete static_cast<WorkPoolContext*>(work->data); });
+        return true;
+    }
+
 }   // End of namespace module.
 }   // End of namespace napa.
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+let binding = require('./binding');
+
+/// <summary> Input of hash functions, strings are hashed as UTF-8. A SharedArrayBuffer is hashed like an ArrayBuffer. </summary>
+export type HashInput = string | ArrayBuffer | ArrayBufferView;
+
+/// <summary> Hashes input with the 64-bit xxHash algorithm (XXH64), a fast non-cryptographic hash. </summary>
+/// <param name="seed"> Seed of the hash, which is 0 by default. </param>
+/// <returns> The hash in 16 hexadecimal digits, since 64-bit values don't fit in numbers. </returns>
+export function xxhash64(input: HashInput, seed?: number): string {
+    return binding.hash.xxhash64(input, seed);
+}
+
+/// <summary> Computes the CRC-32C (Castagnoli) of input, with CRC instructions of the CPU when it has them. </summary>
+/// <param name="crc"> The CRC of preceding input, to compute the CRC of data given in parts. </param>
+/// <returns> The CRC as an unsigned 32-bit integer. </returns>
+export function crc32c(input: HashInput, crc?: number): number {
+    return binding.hash.crc32c(input, crc);
+}
+
+/// <summary> Computes the SHA-256 digest of input. </summary>
+/// <returns> The digest in 64 hexadecimal digits. </returns>
+export function sha256(input: HashInput): string {
+    return binding.hash.sha256(input);
+}
+
+/// <summary> Whether crc32c uses CRC instructions of the CPU. </summary>
+export function isCrc32cHardwareAccelerated(): boolean {
+    return binding.hash.hardwareCrc32c;
+}
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+import * as hash from './hash';
 import { log } from './log';
 import * as memory from './memory';
 import * as metric from './metric';
@@ -11,7 +12,7 @@ import * as transport from './transport';
 import * as v8 from './v8';
 import * as zone from './zone';
 
-export { log, memory, metric, runtime, store, sync, transport, v8, zone };
+export { hash, log, memory, metric, runtime, store, sync, transport, v8, zone };
 
 // Add execute proxy to global context.
 import { call } from './zone/function-call';
@@ -2,5 +2,8 @@
 // Licensed under the MIT license.
 
 export * from './memory/allocator';
+export * from './memory/array-buffer-pool';
+export * from './memory/malloc-library';
 export * from './memory/handle';
 export * from './memory/shareable';
+export * from './memory/shared-map';
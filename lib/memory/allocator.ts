@@ -17,6 +17,11 @@ export interface Allocator extends Shareable {
     /// <param name="sizeHint"> Hint for the size of memory to deallocate. Pass 0 if unknown. </param>
     deallocate(handle: Handle, sizeHint: number): void;
 
+    /// <summary> Allocate memory of requested size in bytes, which JavaScript reads and writes through an ArrayBuffer. </summary>
+    /// <param name="size"> Size in bytes to allocate. </param>
+    /// <remarks> The memory is deallocated when the ArrayBuffer is garbage collected. </remarks>
+    allocateBuffer(size: number): ArrayBuffer;
+
     /// <summary> Type of allocator for better debuggability. </summary>
     readonly type: string;
 }
@@ -27,6 +32,17 @@ export interface AllocatorDebugger extends Allocator {
     getDebugInfo(): string;
 }
 
+/// <summary> Javascript interface for a bump pointer arena, whose allocations are all released at once by reset. </summary>
+export interface Arena extends Allocator {
+    /// <summary> Release all memory allocated since the last reset, keeping the first chunk for the next allocations.
+    /// Buffers allocated before must not be used afterwards, as later allocations reuse their memory.
+    /// </summary>
+    reset(): void;
+
+    /// <summary> Number of bytes allocated since the last reset, including alignment padding. </summary>
+    readonly allocatedSize: number;
+}
+
 let binding = require('../binding');
 
 /// <summary> Export Crt allocator from napa.dll. </summary>
@@ -35,8 +51,24 @@ export let crtAllocator: Allocator = binding.getCrtAllocator();
 /// <summary> Export default allocator from napa.dll. </summary>
 export let defaultAllocator: Allocator = binding.getDefaultAllocator();
 
+/// <summary> Export pool allocator with thread caches from napa.dll. </summary>
+export let poolAllocator: Allocator = binding.getPoolAllocator();
+
 /// <summary> Create a debug allocator around allocator. </summary>
 /// <param name="allocator"> User allocator. </param>
 export function debugAllocator(allocator: Allocator): AllocatorDebugger {
     return new binding.AllocatorDebuggerWrap(allocator);
 }
+
+/// <summary> Create an arena allocating from chunks of the default allocator. It's not thread safe. </summary>
+/// <param name="capacity"> Size in bytes of a chunk, larger allocations get a chunk of their own. </param>
+export function createArena(capacity: number): Arena {
+    return new binding.ArenaWrap(capacity);
+}
+
+/// <summary> Create a profiling allocator debugger around allocator. </summary>
+/// <param name="allocator"> User allocator. </param>
+/// <param name="sampleInterval"> Capture the call stack of 1 in sampleInterval allocations, 0 (default) for none. </param>
+export function profileAllocator(allocator: Allocator, sampleInterval: number = 0): AllocatorDebugger {
+    return new binding.AllocatorDebuggerWrap(allocator, sampleInterval);
+}
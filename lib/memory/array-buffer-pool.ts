@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+let binding = require('../binding');
+
+/// <summary> Statistics of the pool that napa workers allocate ArrayBuffer memory from. </summary>
+export interface ArrayBufferPoolStats {
+    /// <summary> The number of buffers allocated so far. </summary>
+    allocations: number;
+
+    /// <summary> The number of allocations served by a pooled block. </summary>
+    poolHits: number;
+
+    /// <summary> The number of blocks mapped from the system. </summary>
+    mappedBlocks: number;
+
+    /// <summary> The number of mapped blocks backed by huge pages. </summary>
+    hugePageBlocks: number;
+
+    /// <summary> The number of buffers in use. </summary>
+    liveBuffers: number;
+
+    /// <summary> The total length of the buffers in use. </summary>
+    liveSize: number;
+
+    /// <summary> The number of released blocks kept for reuse. </summary>
+    pooledBlocks: number;
+
+    /// <summary> The total size of the released blocks kept for reuse. </summary>
+    pooledSize: number;
+}
+
+/// <summary> Get the statistics of the ArrayBuffer pool shared by all napa workers. </summary>
+export function getArrayBufferPoolStats(): ArrayBufferPoolStats {
+    return binding.getArrayBufferPoolStats();
+}
+
+/// <summary> The ArrayBuffer pool, taking SharedArrayBuffers from it in any isolate. </summary>
+export interface SharedBufferPool {
+    /// <summary> Create a SharedArrayBuffer over memory of the pool, which returns to it once the buffer is released.
+    /// The buffer can be transported to any zone, its memory returns to the pool once all its copies are collected.
+    /// </summary>
+    /// <param name="length"> The buffer length in bytes. </param>
+    /// <param name="zeroed"> Whether the memory is zero-filled, true by default. Reused memory is only cleared if so. </param>
+    allocate(length: number, zeroed?: boolean): SharedArrayBuffer;
+
+    /// <summary> Get the statistics of the pool. </summary>
+    getStats(): ArrayBufferPoolStats;
+}
+
+/// <summary> The SharedArrayBuffer view of the ArrayBuffer pool shared by all napa workers and node. </summary>
+export let sharedBufferPool: SharedBufferPool = {
+    allocate: (length: number, zeroed: boolean = true): SharedArrayBuffer => {
+        return binding.allocateSharedBuffer(length, zeroed);
+    },
+    getStats: getArrayBufferPoolStats
+};
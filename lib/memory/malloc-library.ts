@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+let binding = require('../binding');
+
+/// <summary> Statistics of the malloc library selected by the defaultAllocator platform setting, sizes it doesn't report are 0. </summary>
+export interface MallocLibraryStats {
+    /// <summary> 'mimalloc' or 'jemalloc', or empty if no malloc library is in use. </summary>
+    name: string;
+
+    /// <summary> Bytes allocated by the application. </summary>
+    allocatedSize: number;
+
+    /// <summary> Bytes the library committed, including its free lists and metadata. </summary>
+    committedSize: number;
+
+    /// <summary> Bytes of memory resident in physical pages. </summary>
+    residentSize: number;
+
+    /// <summary> The most bytes that were resident in physical pages. </summary>
+    peakResidentSize: number;
+}
+
+/// <summary> Get the statistics of the malloc library behind the default allocator. </summary>
+export function getMallocLibraryStats(): MallocLibraryStats {
+    return binding.getMallocLibraryStats();
+}
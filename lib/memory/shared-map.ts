@@ -0,0 +1,43 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import { Shareable } from './shareable';
+
+/// <summary> Values a shared map holds. ArrayBuffers and their views are copied in, reads return a copy. </summary>
+export type SharedMapValue = number | string | boolean | ArrayBuffer;
+
+/// <summary> A concurrent hash map of string keys to primitive values, shared by reference across workers. </summary>
+/// <remarks> Its corresponding C++ part is napa::memory::SharedMap. </remarks>
+export interface SharedMap extends Shareable {
+    /// <summary> Get the value of a key, undefined if the key is not in the map. </summary>
+    get(key: string): SharedMapValue;
+
+    /// <summary> Set the value of a key. </summary>
+    set(key: string, value: SharedMapValue | ArrayBufferView): void;
+
+    /// <summary> Add to the number of a key atomically, a missing key starts from 0. </summary>
+    /// <returns> The number after the addition. It throws if the key has a value that is not a number. </returns>
+    add(key: string, delta: number): number;
+
+    /// <summary> Tell if a key is in the map. </summary>
+    has(key: string): boolean;
+
+    /// <summary> Remove a key, it returns false if the key was not in the map. </summary>
+    delete(key: string): boolean;
+
+    /// <summary> Remove all keys. </summary>
+    clear(): void;
+
+    /// <summary> Get the keys of the map. </summary>
+    keys(): string[];
+
+    /// <summary> Number of keys in the map. </summary>
+    readonly size: number;
+}
+
+let binding = require('../binding');
+
+/// <summary> Create an empty shared map. </summary>
+export function createSharedMap(): SharedMap {
+    return binding.createSharedMap();
+}
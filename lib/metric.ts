@@ -9,6 +9,13 @@ export enum MetricType {
     Percentile,
 }
 
+/// <summary> A metric with its dimension values bound, returned by Metric.bind. </summary>
+export interface MetricSeries {
+    set(value: number): void;
+    increment(): void;
+    decrement(): void;
+}
+
 export interface Metric {
     readonly section: string;
     readonly name: string;
@@ -16,11 +23,56 @@ export interface Metric {
     set(value: number, dimensions?: string[]): void;
     increment(dimensions?: string[]): void;
     decrement(dimensions?: string[]): void;
+
+    /// <summary> Binds dimension values once, so updating the returned series doesn't convert them again. </summary>
+    /// <param name="buffered">
+    ///     True to buffer updates of the series in the current napa worker, which reports them in batches between tasks.
+    ///     Series of Percentile metrics, and series bound outside napa workers, are not buffered.
+    /// </param>
+    bind(dimensions?: string[], buffered?: boolean): MetricSeries;
 }
 
 /// <summary> A cache for metric wraps. </summary>
 var _metricsCache: { [key: string]: Metric } = {};
 
+/// <summary> The metric buffer slots of the current worker, null outside napa workers, undefined until read. </summary>
+var _metricSlots: Float64Array = undefined;
+
+function getMetricSlots(): Float64Array {
+    if (_metricSlots === undefined) {
+        _metricSlots = binding.getMetricSlots() || null;
+    }
+    return _metricSlots;
+}
+
+/// <summary> A series whose updates are buffered in the metric buffer slots of the current worker, see MetricBuffer. </summary>
+class BufferedMetricSeries implements MetricSeries {
+    private _increments: number;
+    private _value: number;
+
+    constructor(private _slots: Float64Array, index: number) {
+        this._increments = 1 + 2 * index;
+        this._value = 2 + 2 * index;
+    }
+
+    set(value: number): void {
+        // Increments before a set are overridden by it.
+        this._slots[this._increments] = 0;
+        this._slots[this._value] = value;
+        this._slots[0] = 1;
+    }
+
+    increment(): void {
+        this._slots[this._increments] += 1;
+        this._slots[0] = 1;
+    }
+
+    decrement(): void {
+        this._slots[this._increments] -= 1;
+        this._slots[0] = 1;
+    }
+}
+
 export function get(section: string, name: string, type: MetricType, dimensions: string[] = []) : Metric {
     let key: string = (section ? section : "") + "\\" + (name ? name : "");
 
@@ -34,7 +86,59 @@ export function get(section: string, name: string, type: MetricType, dimensions:
     let metricWrap: any = new binding.MetricWrap(section, name, type, dimensions);
     metricWrap.section = section;
     metricWrap.name = name;
+
+    let bindUnbuffered = metricWrap.bind;
+    metricWrap.bind = (dimensions?: string[], buffered?: boolean): MetricSeries => {
+        // Percentile metrics keep every value set, they can't be buffered as a last value.
+        if (buffered && type !== MetricType.Percentile) {
+            let slots = getMetricSlots();
+            let index: number = slots ? metricWrap.bufferSeries(dimensions) : -1;
+            if (index >= 0) {
+                return new BufferedMetricSeries(slots, index);
+            }
+        }
+        return bindUnbuffered.call(metricWrap, dimensions);
+    };
     _metricsCache[key] = metricWrap;
 
     return metricWrap;
 }
+
+/// <summary> Reports the updates of buffered series of the current worker now, instead of after the task. </summary>
+export function flush(): void {
+    binding.flushMetrics();
+}
+
+/// <summary> One series of a metric in a snapshot. </summary>
+export interface MetricSeriesSnapshot {
+    /// <summary> Dimension values of the series, keyed by dimension name. </summary>
+    dimensions: { [name: string]: string };
+
+    /// <summary> Last value of a Number, or total of a Rate. </summary>
+    value?: number;
+
+    /// <summary> Count, sum, bounds and p50, p90, p95, p99 and p999 of the values set on a Percentile. </summary>
+    count?: number;
+    sum?: number;
+    min?: number;
+    max?: number;
+    percentiles?: { [name: string]: number };
+}
+
+/// <summary> One metric in a snapshot. </summary>
+export interface MetricSnapshot {
+    section: string;
+    name: string;
+    type: 'number' | 'rate' | 'percentile';
+    series: MetricSeriesSnapshot[];
+}
+
+/// <summary> Reads all metrics, which requires the 'in-process' metric provider. </summary>
+/// <param name="format"> 'json' (default) returns the metrics, 'prometheus' formats them as the Prometheus text format. </param>
+export function snapshot(): MetricSnapshot[];
+export function snapshot(format: 'json'): MetricSnapshot[];
+export function snapshot(format: 'prometheus'): string;
+export function snapshot(format: 'json' | 'prometheus' = 'json'): MetricSnapshot[] | string {
+    let result: string = binding.metricSnapshot(format);
+    return format === 'json' ? JSON.parse(result) : result;
+}
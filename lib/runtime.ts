@@ -4,3 +4,16 @@
 export { 
     setPlatformSettings
 } from './runtime/platform';
+
+export {
+    writeModuleBundle
+} from './runtime/module-bundle';
+
+export {
+    TraceOptions,
+    startTrace,
+    stopTrace,
+    Span,
+    setSpanSampling,
+    exportSpans
+} from './runtime/tracing';
@@ -0,0 +1,13 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+let binding = require('../binding');
+
+/// <summary> 
+///     Writes the modules loaded so far by the zones of this process to a bundle file: their resolutions, sources and compiled code.
+///     Zones created with the 'bundle' setting then load modules from the bundle instead of probing and reading module files.
+/// </summary>
+/// <param name="path"> Path of the bundle file, replaced if it exists. </param>
+export function writeModuleBundle(path: string): void {
+    binding.writeModuleBundle(path);
+}
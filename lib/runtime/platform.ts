@@ -15,8 +15,50 @@ export interface PlatformSettings {
     /// <summary> The logging provider to use when outputting logs. </summary>
     loggingProvider?: string;
 
-    /// <summary> The metric provider to use when creating/setting metric values. </summary>
+    /// <summary> The file the 'async' logging provider appends to, the standard output by default. </summary>
+    logFile?: string;
+
+    /// <summary> The most verbose level that is logged, 'error', 'warning', 'info' or 'debug' (default). </summary>
+    logLevel?: string;
+
+    /// <summary> The comma separated sections the 'async' logging provider logs, all by default. </summary>
+    logSections?: string;
+
+    /// <summary> The metric provider to use when creating/setting metric values, 'in-process' for the built-in one. </summary>
     metricProvider?: string;
+
+    /// <summary> The directory to persist compiled JavaScript modules in, so they are not compiled again after a restart. </summary>
+    codeCacheDirectory?: string;
+
+    /// <summary>
+    ///     How long module resolution trusts the files and directories it probed, found or missing.
+    ///     'process' (default) for the life of the process, 'watch' until their directory changes (Linux only), 'off' to probe each time.
+    /// </summary>
+    moduleStatusCache?: string;
+
+    /// <summary>
+    ///     Parse JSON modules once per process, other workers deserialize the value the first one parsed
+    ///     instead of parsing the file again. Default is false.
+    /// </summary>
+    sharedJsonModules?: boolean;
+
+    /// <summary> The allocator behind the default allocator, 'crt' (default, or 'system'), 'pool', 'mimalloc' or 'jemalloc'. </summary>
+    defaultAllocator?: string;
+
+    /// <summary> The most bytes of released ArrayBuffer blocks kept for reuse by napa workers, 64MB by default, 0 to disable pooling. </summary>
+    arrayBufferPoolSize?: number;
+
+    /// <summary> Whether ArrayBuffer blocks of 2MB and more are backed by huge pages, 'none' (default), 'transparent' or 'explicit'. </summary>
+    arrayBufferHugePages?: string;
+
+    /// <summary> The number of isolates created ahead of time in the background for the workers of new zones, 0 (default) for none. </summary>
+    prewarmIsolates?: number;
+
+    /// <summary>
+    ///     The bytes of console output each napa worker buffers, written by a background thread every 10ms or once a buffer is full.
+    ///     0 (default) writes console output through.
+    /// </summary>
+    consoleBufferSize?: number;
 }
 
 /// <summary> Initialization of napa is only needed if we run in node. </summary>
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+let binding = require('../binding');
+
+/// <summary> Options of a trace. </summary>
+export interface TraceOptions {
+    /// <summary> The number of events each thread records at most, later events are dropped. Default is 16384. </summary>
+    eventsPerThread?: number;
+}
+
+/// <summary>
+///     Starts recording scheduler, worker, timer, async completion and GC events of all zones in this process.
+///     Each thread records to its own buffer, so tracing adds no contention between workers.
+/// </summary>
+/// <param name="options"> Options of the trace. </param>
+export function startTrace(options?: TraceOptions): void {
+    binding.startTrace(options != null ? options.eventsPerThread : undefined);
+}
+
+/// <summary> Stops recording and returns the trace, which can be loaded in chrome://tracing. </summary>
+/// <returns> The trace in Chrome trace event JSON. </returns>
+export function stopTrace(): string {
+    return binding.stopTrace();
+}
+
+/// <summary> The timing of a zone call of a sampled trace, or of a store operation made by one. </summary>
+export interface Span {
+
+    /// <summary> The trace of the span, 16 hex digits. </summary>
+    traceId: string;
+
+    /// <summary> The id of the span, 16 hex digits. </summary>
+    spanId: string;
+
+    /// <summary> The span of the call that made the call or operation, undefined for the root of a trace. </summary>
+    parentSpanId?: string;
+
+    /// <summary> 'call' for zone calls, 'store' for store operations. </summary>
+    kind: string;
+
+    /// <summary> 'module.function' of calls, the operation of store operations, i.e. 'get'. </summary>
+    name: string;
+
+    /// <summary> The zone a call ran in, or the store an operation was made on. </summary>
+    target: string;
+
+    /// <summary> Microseconds since epoch when the span started. </summary>
+    startTime: number;
+
+    /// <summary> Nanoseconds from the start to the end of the span. </summary>
+    duration: number;
+
+    /// <summary> Nanoseconds in each phase of calls, like Result.timing. </summary>
+    timing?: { queue: number, unmarshall: number, execute: number, marshall: number };
+
+    /// <summary> The result code of calls, 0 for success. </summary>
+    code: number;
+}
+
+/// <summary>
+///     Sets the share of new traces of zone calls whose spans are recorded. The call beginning a trace decides, and
+///     calls continuing it follow, so a trace is recorded as a whole. Sampled calls are timed like with
+///     CallOptions.recordTiming. By default no trace is sampled.
+/// </summary>
+/// <param name="sampleRate"> From 0, which samples none, to 1, which samples all traces. </param>
+/// <param name="capacity"> The number of spans kept until they are exported, the oldest are dropped first. Default is 4096. </param>
+export function setSpanSampling(sampleRate: number, capacity?: number): void {
+    binding.setSpanSampling(sampleRate, capacity);
+}
+
+/// <summary> Takes the spans recorded since the last export, oldest first. </summary>
+export function exportSpans(): Span[] {
+    return JSON.parse(binding.exportSpans());
+}
@@ -2,4 +2,7 @@
 // Licensed under the MIT license.
 
 export * from './store/store';
-export * from './store/store-api';
\ No newline at end of file
+export * from './store/store-api';
+export * from './store/frozen-value';
+export * from './store/store-reference';
+import './store/store-loader';
@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+let binding = require('../binding');
+
+/// <summary> An immutable value held in native memory, which every isolate reads in place. </summary>
+/// <remarks> A frozen value is transported between isolates by reference, reading it never copies the whole value. </remarks>
+export interface FrozenValue {
+    /// <summary> The value, a read-only proxy for arrays and objects. </summary>
+    readonly root: any;
+
+    /// <summary> Bytes of native memory the value takes. </summary>
+    readonly byteLength: number;
+}
+
+/// <summary> Freeze a value for reading in place from all isolates. </summary>
+/// <param name="value"> A JSON serializable value, which is frozen as JSON.stringify writes it. </param>
+/// <returns> A frozen value, or throws Error if the value is not JSON serializable. </returns>
+export function freeze(value: any): FrozenValue {
+    let json = JSON.stringify(value);
+    if (json === undefined) {
+        throw new Error(`Value of type "${typeof value}" can't be frozen.`);
+    }
+    return binding.createFrozenValue(json);
+}
+
+// Node kinds in the 3 low bits of a reference, see napa::store::FrozenValueKind.
+const KIND_MASK = 7;
+const KIND_NULL = 0;
+const KIND_FALSE = 1;
+const KIND_TRUE = 2;
+const KIND_ARRAY = 5;
+const KIND_OBJECT = 6;
+
+const WRAP = Symbol('wrap');
+const REFERENCE = Symbol('reference');
+
+/// <summary> Proxies of the containers of a frozen value read in this isolate, by reference. </summary>
+const PROXIES = Symbol('proxies');
+
+function read(wrap: any, reference: number): any {
+    switch (reference & KIND_MASK) {
+        case KIND_NULL: return null;
+        case KIND_FALSE: return false;
+        case KIND_TRUE: return true;
+        case KIND_ARRAY:
+        case KIND_OBJECT: return getProxy(wrap, reference);
+        default: return wrap.read(reference);
+    }
+}
+
+function getProxy(wrap: any, reference: number): any {
+    let proxies: Map<number, any> = wrap[PROXIES];
+    if (proxies === undefined) {
+        proxies = new Map<number, any>();
+        Object.defineProperty(wrap, PROXIES, { value: proxies });
+    }
+
+    let proxy = proxies.get(reference);
+    if (proxy === undefined) {
+        // Targets are an array or an object so that Array.isArray and JSON.stringify see the right shape.
+        let target: any = (reference & KIND_MASK) === KIND_ARRAY ? [] : {};
+        target[WRAP] = wrap;
+        target[REFERENCE] = reference;
+        proxy = new Proxy(target, handler);
+        proxies.set(reference, proxy);
+    }
+    return proxy;
+}
+
+function isArray(target: any): boolean {
+    return (target[REFERENCE] & KIND_MASK) === KIND_ARRAY;
+}
+
+function findChild(target: any, key: PropertyKey): number {
+    if (typeof key === 'symbol') {
+        return -1;
+    }
+    return target[WRAP].child(target[REFERENCE], key);
+}
+
+const handler: ProxyHandler<any> = {
+    get: (target: any, key: PropertyKey, receiver: any): any => {
+        if (key === 'length' && isArray(target)) {
+            return target[WRAP].count(target[REFERENCE]);
+        }
+        let child = findChild(target, key);
+        if (child < 0) {
+            // Symbols and prototype members, like Array.prototype.map.
+            return Reflect.get(target, key, receiver);
+        }
+        return read(target[WRAP], child);
+    },
+
+    has: (target: any, key: PropertyKey): boolean => {
+        if (key === 'length' && isArray(target)) {
+            return true;
+        }
+        return findChild(target, key) >= 0 || Reflect.has(target, key);
+    },
+
+    ownKeys: (target: any): PropertyKey[] => {
+        let keys: PropertyKey[] = target[WRAP].keys(target[REFERENCE]);
+        if (isArray(target)) {
+            keys.push('length');
+        }
+        return keys;
+    },
+
+    getOwnPropertyDescriptor: (target: any, key: PropertyKey): PropertyDescriptor => {
+        if (key === 'length' && isArray(target)) {
+            // Must match the non-configurable 'length' of the target array.
+            return { value: target[WRAP].count(target[REFERENCE]), writable: true, enumerable: false, configurable: false };
+        }
+        let child = findChild(target, key);
+        if (child < 0) {
+            return undefined;
+        }
+        return { value: read(target[WRAP], child), writable: false, enumerable: true, configurable: true };
+    },
+
+    set: (): boolean => false,
+    deleteProperty: (): boolean => false,
+    defineProperty: (): boolean => false,
+    setPrototypeOf: (): boolean => false
+};
+
+Object.defineProperty(binding.FrozenValueWrap.prototype, 'root', {
+    get: function(): any {
+        return read(this, this.rootReference);
+    }
+});
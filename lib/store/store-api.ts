@@ -1,17 +1,18 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
-import { Store } from './store';
+import { Store, StoreOptions, StoreStats } from './store';
 
 let binding = require('../binding');
 
 /// <summary> Create a store with an id. </summary>
 /// <param name="id"> String identifier which can be used to get the store from all isolates. </summary>
+/// <param name="options"> Options of the store. </summary>
 /// <returns> A store object or throws Error if store with this id already exists. </returns>
 /// <remarks> Store object will be destroyed when reference from all isolates are unreferenced. 
 /// It's usually a best practice to keep a long-living reference in user modules or global scope. </remarks>
-export function create(id: string): Store {
-    return binding.createStore(id);
+export function create(id: string, options?: StoreOptions): Store {
+    return binding.createStore(id, options);
 }
 
 /// <summary> Get a store with an id. </summary>
@@ -23,14 +24,21 @@ export function get(id: string): Store {
 
 /// <summary> Get a store with an id, or create it if not exist. </summary>
 /// <param name="id"> String identifier which can be used to get the store from all isolates. </summary>
+/// <param name="options"> Options of the store, only used when the store is created. </summary>
 /// <returns> A store object associated with the id. </returns>
 /// <remarks> Store object will be destroyed when reference from all isolates are unreferenced. 
 /// It's usually a best practice to keep a long-living reference in user modules or global scope. </remarks>
-export function getOrCreate(id: string): Store {
-    return binding.getOrCreateStore(id);
+export function getOrCreate(id: string, options?: StoreOptions): Store {
+    return binding.getOrCreateStore(id, options);
 }
 
 /// <summary> Returns number of stores that is alive. </summary>
 export function count(): number {
     return binding.getStoreCount();
-}
\ No newline at end of file
+}
+
+/// <summary> Returns memory accounting and counters of the living stores, in order of their ids. </summary>
+/// <remarks> Stores in shared memory count all their bytes as payload bytes, and don't report shared objects. </remarks>
+export function stats(): StoreStats[] {
+    return binding.getStoreStats();
+}
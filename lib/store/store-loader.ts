@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as path from 'path';
+import * as v8 from '../v8';
+import * as functionCall from '../zone/function-call';
+
+let binding = require('../binding');
+
+let setLoader: Function = binding.StoreWrap.prototype.setLoader;
+
+binding.StoreWrap.prototype.setLoader = function(moduleName: string, functionName: string, ttl?: number, waitTimeout?: number): void {
+    // The loader runs on the threads that call getOrLoad, relative modules are resolved from the caller.
+    // <caller> -> setLoader
+    //   1          0
+    if (typeof moduleName === 'string' && moduleName.length !== 0 && moduleName[0] === '.') {
+        moduleName = path.resolve(path.dirname(v8.currentStack(2)[1].getFileName()), moduleName);
+    }
+    let args: any[] = [moduleName, functionName];
+    if (ttl !== undefined || waitTimeout !== undefined) {
+        args.push(ttl);
+    }
+    if (waitTimeout !== undefined) {
+        args.push(waitTimeout);
+    }
+    setLoader.apply(this, args);
+};
+
+binding.StoreWrap.prototype.getOrLoad = function(key: string): any {
+    // Each isolate loads the loader from its module once, and keeps it with the other functions it resolved.
+    return this._getOrLoad(key, functionCall.loadFunction);
+};
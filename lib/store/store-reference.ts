@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as transport from '../transport';
+
+let binding = require('../binding');
+
+/// <summary> A reference to the value of a key in a store, which 'store.ref' returns to pass as an argument. </summary>
+/// <remarks>
+///     It is marshalled as the id of the store and the key. The receiving isolate unmarshalls it as the value of the key,
+///     which it gets from the store natively, so the value is never unmarshalled and marshalled again by the caller.
+///     The value is got when the reference is unmarshalled, keys set in between are seen by the receiver.
+/// </remarks>
+export class StoreReference implements transport.Transportable {
+    constructor(storeId: string, key: string) {
+        this.storeId = storeId;
+        this.key = key;
+    }
+
+    /// <summary> Id of the store. </summary>
+    readonly storeId: string;
+
+    /// <summary> Key of the value. </summary>
+    readonly key: string;
+
+    cid(): string {
+        return StoreReference._cid;
+    }
+
+    marshall(context: transport.TransportContext): object {
+        return { _cid: StoreReference._cid, id: this.storeId, key: this.key };
+    }
+
+    unmarshall(payload: object, context: transport.TransportContext): void {
+        throw new Error('A store reference is unmarshalled as the value it references.');
+    }
+
+    static readonly _cid: string = 'napajs.store.StoreReference';
+
+    /// <summary> Used by unmarshall instead of 'new' and 'unmarshall', it returns the value instead of a reference. </summary>
+    static _load(payload: any, context: transport.TransportContext): any {
+        return binding.getStoreValue(payload.id, payload.key);
+    }
+}
+
+transport.register(StoreReference);
+
+binding.StoreWrap.prototype.ref = function(key: string): StoreReference {
+    if (typeof key !== 'string') {
+        throw new TypeError('Argument \'key\' must be string.');
+    }
+    return new StoreReference(this.id, key);
+};
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+import { StoreReference } from './store-reference';
+
 /// <summary> Store is a facility to share (built-in JavaScript types or Transportable subclasses) objects across isolates. </summary>
 export interface Store {
     /// <summary> Id of this store. </summary>
@@ -8,6 +10,9 @@ export interface Store {
 
     /// <summary> Number of keys in this store. </summary>
     readonly size: number;
+
+    /// <summary> Bytes of keys and payloads in this store. </summary>
+    readonly byteSize: number;
     
     /// <summary> Check if this store has a key. </summary>
     /// <param name="key"> Case-sensitive string key. </summary>
@@ -19,12 +24,228 @@ export interface Store {
     /// <returns> Value for key, undefined if not found. </returns>
     get(key: string): any;
 
+    /// <summary> Set the loader of missing keys, which 'getOrLoad' runs once per missing key across all isolates. </summary>
+    /// <param name="moduleName"> Module of the loader, resolved like the module of zone.execute. Empty for a global function. </summary>
+    /// <param name="functionName"> Name of the loader, which can have multiple levels like 'foo.bar'. </summary>
+    /// <param name="ttl"> Milliseconds before loaded values expire, 0 (by default) for never. </summary>
+    /// <param name="waitTimeout"> Milliseconds callers wait for the load of a key on another thread, 10000 by default. </summary>
+    /// <remarks> The loader is called with the key, and returns its value, or undefined if it has none. </remarks>
+    setLoader(moduleName: string, functionName: string, ttl?: number, waitTimeout?: number): void;
+
+    /// <summary> Get JavaScript value by key, loading and setting it by the loader if the key is missing. </summary>
+    /// <param name="key"> Case-sensitive string key. </summary>
+    /// <returns> Value for key, undefined if the loader has none. </returns>
+    /// <remarks>
+    ///     Only one caller runs the loader of a missing key at a time, other callers on other threads wait for it
+    ///     and get the value it loaded, or throw the error it threw. A caller throws instead of waiting past the
+    ///     wait timeout, or for a loader that waits for a key the caller is loading.
+    /// </remarks>
+    getOrLoad(key: string): any;
+
+    /// <summary> Get a reference to the value of a key, to pass as an argument of zone.execute instead of the value. </summary>
+    /// <param name="key"> Case-sensitive string key. </summary>
+    /// <returns> A reference, which the worker unmarshalls as the value it gets from this store, undefined if not found. </returns>
+    ref(key: string): StoreReference;
+
+    /// <summary> Get JavaScript values of many keys at once, in one call to the store. </summary>
+    /// <param name="keys"> Case-sensitive string keys. </summary>
+    /// <returns> Values in the order of keys, undefined for keys not found. </returns>
+    getMany(keys: string[]): any[];
+
+    /// <summary> Get keys with a prefix in order, from a consistent snapshot of the store. </summary>
+    /// <param name="prefix"> Case-sensitive prefix, all keys if not given. </summary>
+    /// <returns> Keys in order. Stores created with 'ordered' scan only the keys returned. </returns>
+    keys(prefix?: string): string[];
+
+    /// <summary> Get pairs of keys and values in a range of keys in order, from a consistent snapshot of the store. </summary>
+    /// <param name="from"> Inclusive lower bound of keys. </summary>
+    /// <param name="to"> Exclusive upper bound of keys, no bound if not given. </summary>
+    /// <returns> Pairs of keys and values in order of keys. </returns>
+    range(from: string, to?: string): [string, any][];
+
     /// <summary> Insert or update a JavaScript value by key. </summary>
     /// <param name="key"> Case-sensitive string key. </summary>
     /// <param name="value"> Value. Any value of built-in JavaScript types or Transportable subclasses can be accepted. </summary>
-    set(key: string, value: any): void;
+    /// <param name="transferList">
+    ///     Optional ArrayBuffers in the value to move into the store instead of copying. They are detached from the caller,
+    ///     and the moved memory is shared by the values every 'get' returns. Options of type SetOptions can be passed instead.
+    /// </summary>
+    set(key: string, value: any, transferList?: ArrayBuffer[] | SetOptions): void;
+
+    /// <summary> Insert or update many JavaScript values at once, in one call to the store. </summary>
+    /// <param name="entries"> Pairs of case-sensitive string key and value, a later pair of the same key wins. </summary>
+    /// <param name="transferList"> Optional ArrayBuffers in any of the values to move into the store, or SetOptions for all values. </summary>
+    setMany(entries: [string, any][], transferList?: ArrayBuffer[] | SetOptions): void;
+
+    /// <summary> Change the value of a key by a JSON merge patch (RFC 7386), applied atomically by the store. </summary>
+    /// <param name="key"> Case-sensitive string key, which is set to the patch without its null members if it doesn't exist. </summary>
+    /// <param name="patch"> A JSON serializable value. Null members of objects remove members of the value. </summary>
+    /// <remarks> Throws if the key holds a number, or a value with SharedArrayBuffers or transferred ArrayBuffers. </remarks>
+    patch(key: string, patch: any): void;
+
+    /// <summary> Add an integer to a number kept by the store, which is created as 0 if the key doesn't exist. </summary>
+    /// <param name="key"> Case-sensitive string key. </summary>
+    /// <param name="delta"> Integer to add, 1 by default. </summary>
+    /// <returns> The number after adding. Throws if the key holds a value or a floating point number. </returns>
+    /// <remarks> Numbers are updated atomically without marshalling, 'get' returns them like values. </remarks>
+    increment(key: string, delta?: number): number;
+
+    /// <summary> Add to a number kept by the store, which is created as a floating point 0 if the key doesn't exist. </summary>
+    /// <param name="key"> Case-sensitive string key. </summary>
+    /// <param name="delta"> Number to add, which must be an integer if the key holds a number created by 'increment'. </summary>
+    /// <returns> The number after adding. </returns>
+    add(key: string, delta: number): number;
+
+    /// <summary> Replace a number kept by the store with desired if it equals expected. </summary>
+    /// <param name="key"> Case-sensitive string key. </summary>
+    /// <param name="expected"> Number the key is expected to hold. </summary>
+    /// <param name="desired"> Number to replace with. </summary>
+    /// <returns> True if replaced, false if the number didn't equal expected, or the key holds no number. </returns>
+    compareAndSet(key: string, expected: number, desired: number): boolean;
+
+    /// <summary> Get a number kept by the store. </summary>
+    /// <param name="key"> Case-sensitive string key. </summary>
+    /// <returns> The number, undefined if the key doesn't exist or holds a value set by 'set'. </returns>
+    getNumber(key: string): number;
+
+    /// <summary> Write values of this store to a snapshot file, which 'load' reads back after a restart. </summary>
+    /// <param name="path"> Path of the snapshot file, replaced if it exists. </summary>
+    /// <returns> Number of keys written. Values referencing SharedArrayBuffers or transferred ArrayBuffers are skipped. </returns>
+    snapshot(path: string): number;
+
+    /// <summary> Set values from a snapshot file written by 'snapshot', overwriting existing keys. </summary>
+    /// <param name="path"> Path of the snapshot file. </summary>
+    /// <returns> Number of keys set. Throws if the file can't be read or is not a valid snapshot, with no key set. </returns>
+    load(path: string): number;
+
+    /// <summary> Create a consistent read view, which reads values as they were when it was created. </summary>
+    /// <returns> The view. Throws for stores in shared memory. </returns>
+    /// <remarks>
+    ///     Writers don't wait for views, values they replace are kept while a view may read them.
+    ///     Release the view when the task is done with it, instead of waiting for garbage collection.
+    /// </remarks>
+    view(): StoreView;
+
+    /// <summary> Watch changes of a key, or of keys with a prefix. </summary>
+    /// <param name="pattern"> A key, or a prefix followed by '*'. </summary>
+    /// <param name="callback">
+    ///     Called in the current JavaScript thread with each key that is set, deleted, loaded or has its number updated.
+    ///     Keys changed again before the callback runs are passed once.
+    /// </param>
+    /// <returns> Id of the watch, to pass to 'unwatch'. </returns>
+    watch(pattern: string, callback: (key: string) => void): number;
+
+    /// <summary> Stop a watch created in the current JavaScript thread. </summary>
+    /// <param name="watchId"> Id returned by 'watch'. </summary>
+    /// <returns> False if the watch doesn't exist or is already stopped. </returns>
+    unwatch(watchId: number): boolean;
 
     /// <summary> Remove a key with its value from this store. </summary>
     /// <param name="key"> Case-sensitive string key. </summary>
     delete(key: string): void;
-}
\ No newline at end of file
+}
+/// <summary> A consistent read view of a store, created by 'view'. </summary>
+export interface StoreView {
+    /// <summary> Get JavaScript value by key, as it was when the view was created. </summary>
+    /// <returns> Value for key, undefined if not found. Numbers updated by 'increment', 'add' and 'compareAndSet' are read as they are now. </returns>
+    get(key: string): any;
+
+    /// <summary> Get JavaScript values of many keys, as they were when the view was created. </summary>
+    getMany(keys: string[]): any[];
+
+    /// <summary> Check if the store had a key when the view was created. </summary>
+    has(key: string): boolean;
+
+    /// <summary> Let the store drop the values kept for the view, which throws on reads afterwards. </summary>
+    release(): void;
+}
+
+/// <summary> Options to create a store. </summary>
+export interface StoreOptions {
+    /// <summary>
+    ///     Number of independently locked parts of the store, 1 by default and at most 256.
+    ///     Reads never block each other, more shards help stores that are written while many workers read them.
+    /// </summary>
+    shards?: number;
+
+    /// <summary>
+    ///     Objects returned by 'get' are deep frozen, and each worker reuses the object it unmarshalled
+    ///     until the key is set again, instead of unmarshalling the value on every 'get'. False by default.
+    /// </summary>
+    frozen?: boolean;
+
+    /// <summary>
+    ///     Maximum bytes of keys and payloads in the store, 0 (by default) for no limit.
+    ///     Setting a value beyond the limit evicts values not read recently, the budget is split evenly among shards.
+    /// </summary>
+    maxBytes?: number;
+
+    /// <summary>
+    ///     Keys are kept in order, so 'keys' and 'range' scan only the keys they return. False by default,
+    ///     in which case they scan and sort all keys.
+    /// </summary>
+    ordered?: boolean;
+
+    /// <summary>
+    ///     Payloads of at least this many bytes are kept compressed, 0 (by default) to never compress.
+    ///     Compression trades CPU on 'set' and 'get' for memory, stores in shared memory don't compress.
+    /// </summary>
+    compressionThreshold?: number;
+
+    /// <summary>
+    ///     Values of equal JSON are kept once, in a table shared by all interning stores of the process,
+    ///     and frozen stores reuse the object a worker unmarshalled for all keys of the value. False by default.
+    /// </summary>
+    intern?: boolean;
+}
+
+/// <summary> Options to set a value. </summary>
+export interface SetOptions {
+    /// <summary> Milliseconds before the value expires, 0 (by default) for never. </summary>
+    ttl?: number;
+
+    /// <summary> ArrayBuffers in the value to move into the store instead of copying, same as 'transferList' of 'set'. </summary>
+    transferList?: ArrayBuffer[];
+}
+
+/// <summary> Memory accounting and counters of a living store, returned by 'stats'. </summary>
+export interface StoreStats {
+    /// <summary> Id of the store. </summary>
+    id: string;
+
+    /// <summary> Number of keys in the store. </summary>
+    size: number;
+
+    /// <summary> Bytes of keys and payloads in the store, the sum of keyBytes and payloadBytes. </summary>
+    byteSize: number;
+
+    /// <summary> Bytes of keys in the store. </summary>
+    keyBytes: number;
+
+    /// <summary> Bytes of payloads as they are kept, compressed or not. A number takes 8 bytes. </summary>
+    payloadBytes: number;
+
+    /// <summary> Number of shared objects, like SharedArrayBuffers, the values hold. </summary>
+    sharedObjects: number;
+
+    /// <summary> Bytes of native memory the shared objects hold, which are not part of byteSize. </summary>
+    sharedObjectBytes: number;
+
+    /// <summary> Number of gets that found a value. </summary>
+    hits: number;
+
+    /// <summary> Number of gets that found no value, or an expired one. </summary>
+    misses: number;
+
+    /// <summary> Number of values evicted to stay within maxBytes. </summary>
+    evictions: number;
+
+    /// <summary> Number of expired values dropped. </summary>
+    expirations: number;
+
+    /// <summary> Number of times the loader ran for a missing key. </summary>
+    loads: number;
+
+    /// <summary> Number of 'getOrLoad' calls that waited for the load of another call instead of running the loader. </summary>
+    loadWaits: number;
+}
@@ -2,3 +2,7 @@
 // Licensed under the MIT license.
 
 export * from './sync/lock';
+export * from './sync/channel';
+export * from './sync/semaphore';
+export * from './sync/barrier';
+export * from './sync/count-down-latch';
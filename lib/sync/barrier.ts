@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+let binding = require('../binding');
+
+export interface Barrier {
+    /// <summary> The number of parties that arrive before all of them are released. </summary>
+    readonly parties: number;
+
+    /// <summary> The number of parties arrived in the current phase. </summary>
+    readonly arrived: number;
+
+    /// <summary> Arrive asynchronously, waiting for the other parties without blocking the worker. </summary>
+    /// <returns> A Promise resolved once all parties arrived, with true for the last party to arrive. </returns>
+    arrive(): Promise<boolean>;
+
+    /// <summary> Arrive synchronously, blocking the worker until all parties arrived. </summary>
+    /// <returns> True for the last party to arrive. </returns>
+    arriveSync(): boolean;
+}
+
+/// <summary> Create a barrier shared across workers, reusable once all parties are released. </summary>
+/// <param name="parties"> The number of parties, at least 1. </param>
+export function createBarrier(parties: number): Barrier {
+    return binding.createBarrier(parties);
+}
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+let binding = require('../binding');
+
+export interface Channel {
+    /// <summary> The number of values the channel holds before senders wait. </summary>
+    readonly capacity: number;
+
+    /// <summary> The number of values waiting to be received, including those of waiting senders. </summary>
+    readonly size: number;
+
+    /// <summary> Whether the channel is closed. </summary>
+    readonly closed: boolean;
+
+    /// <summary> Send a value asynchronously, waiting for room while the channel is full without blocking the worker. </summary>
+    /// <param name="value"> A transportable value. </param>
+    /// <param name="transferList"> Optional. ArrayBuffers to move to the receiver instead of copying, they are detached from the sender. </param>
+    /// <returns> A Promise resolved once the value is accepted, rejected if the channel is closed. </returns>
+    send(value: any, transferList?: ArrayBuffer[]): Promise<void>;
+
+    /// <summary> Send a value synchronously, blocking the worker while the channel is full. </summary>
+    /// <param name="value"> A transportable value. </param>
+    /// <param name="transferList"> Optional. ArrayBuffers to move to the receiver instead of copying, they are detached once the value is sent. </param>
+    /// <param name="timeoutInMs"> Optional. The longest time to wait for room, waits until there is room if not specified. </param>
+    /// <remarks> It throws if the channel is closed or stays full until the timeout. </remarks>
+    sendSync(value: any, transferList?: ArrayBuffer[], timeoutInMs?: number): void;
+
+    /// <summary> Receive a value asynchronously, waiting for one while the channel is empty without blocking the worker. </summary>
+    /// <returns> A Promise of the received value, rejected if the channel is closed and all its values are received. </returns>
+    receive(): Promise<any>;
+
+    /// <summary> Receive a value synchronously, blocking the worker while the channel is empty. </summary>
+    /// <param name="timeoutInMs"> Optional. The longest time to wait for a value, waits until there is one if not specified. </param>
+    /// <remarks> It throws if the channel is closed and all its values are received, or if it stays empty until the timeout. </remarks>
+    receiveSync(timeoutInMs?: number): any;
+
+    /// <summary> Close the channel, later sends fail and receives fail once the remaining values are received. </summary>
+    close(): void;
+}
+
+/// <summary> Create a bounded channel to stream values between workers. </summary>
+/// <param name="capacity"> The number of values the channel holds before senders wait. </param>
+export function createChannel(capacity: number): Channel {
+    return binding.createChannel(capacity);
+}
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+let binding = require('../binding');
+
+export interface CountDownLatch {
+    /// <summary> The count left before the latch opens. </summary>
+    readonly count: number;
+
+    /// <summary> Decrease the count, the latch opens once it reaches zero. </summary>
+    /// <param name="count"> Optional. The amount to count down, 1 if not specified. </param>
+    countDown(count?: number): void;
+
+    /// <summary> Wait asynchronously for the latch to open without blocking the worker. </summary>
+    /// <returns> A Promise resolved once the count reaches zero. </returns>
+    wait(): Promise<void>;
+
+    /// <summary> Wait synchronously for the latch to open, blocking the worker. </summary>
+    /// <param name="timeoutInMs"> Optional. The longest time to wait, waits until the latch opens if not specified. </param>
+    /// <remarks> It throws if the latch is still closed at the timeout. </remarks>
+    waitSync(timeoutInMs?: number): void;
+}
+
+/// <summary> Create a one-shot latch shared across workers. </summary>
+/// <param name="count"> The count to reach zero before the latch opens. </param>
+export function createCountDownLatch(count: number): CountDownLatch {
+    return binding.createCountDownLatch(count);
+}
@@ -12,12 +12,60 @@ export interface Lock {
     /// </summary>
     /// <param name="func"> The input function to run. </summary>
     /// <param name="params"> Optional. A list of parameters that passed to func. </summary>
+    /// <param name="timeoutInMs"> Optional. The longest time to wait for the lock, waits until it's available if not specified. </summary>
     /// <returns> The value that the input function returns. </returns>
     /// <remarks> This function will obtain the lock before running the input function. It will wait until the
-    /// lock is available. If the input function throws exception, the exception will be thrown out. </remarks>
-    guardSync(func: (...params: any[]) => any, params?: any[]): any;
+    /// lock is available or the timeout is reached, in which case it throws without running the input function.
+    /// If the input function throws exception, the exception will be thrown out. </remarks>
+    guardSync(func: (...params: any[]) => any, params?: any[], timeoutInMs?: number): any;
+
+    /// <summary>
+    /// Run input function synchronously if the lock is available right away, without waiting for it.
+    /// Lock will be released once execution finishes or an exception is thrown.
+    /// </summary>
+    /// <param name="func"> The input function to run. </summary>
+    /// <param name="params"> Optional. A list of parameters that passed to func. </summary>
+    /// <returns> The value that the input function returns, or undefined if the lock is held by others. </returns>
+    tryGuardSync(func: (...params: any[]) => any, params?: any[]): any;
+
+    /// <summary>
+    /// Obtain the lock asynchronously and run input function once it's obtained.
+    /// While the lock is held by others, the worker serves other tasks instead of waiting.
+    /// Lock will be released once execution finishes, or once the Promise returned by the function settles.
+    /// </summary>
+    /// <param name="func"> The input function to run, which may return a Promise. </summary>
+    /// <param name="params"> Optional. A list of parameters that passed to func. </summary>
+    /// <returns> A Promise of the value that the input function returns, rejected if the function throws. </returns>
+    guard(func: (...params: any[]) => any, params?: any[]): Promise<any>;
+}
+
+export interface ReadWriteLock {
+    /// <summary>
+    /// Obtain the read (shared) lock and run input function synchronously.
+    /// Multiple readers can hold the lock together while no writer holds it.
+    /// Lock will be released once execution finishes or an exception is thrown.
+    /// </summary>
+    /// <param name="func"> The input function to run. </summary>
+    /// <param name="params"> Optional. A list of parameters that passed to func. </summary>
+    /// <param name="timeoutInMs"> Optional. The longest time to wait for the lock, waits until it's available if not specified. </summary>
+    /// <returns> The value that the input function returns. </returns>
+    guardReadSync(func: (...params: any[]) => any, params?: any[], timeoutInMs?: number): any;
+
+    /// <summary>
+    /// Obtain the write (exclusive) lock and run input function synchronously.
+    /// Lock will be released once execution finishes or an exception is thrown.
+    /// </summary>
+    /// <param name="func"> The input function to run. </summary>
+    /// <param name="params"> Optional. A list of parameters that passed to func. </summary>
+    /// <param name="timeoutInMs"> Optional. The longest time to wait for the lock, waits until it's available if not specified. </summary>
+    /// <returns> The value that the input function returns. </returns>
+    guardWriteSync(func: (...params: any[]) => any, params?: any[], timeoutInMs?: number): any;
 }
 
 export function createLock(): Lock {
     return binding.createLock();
-}
\ No newline at end of file
+}
+
+export function createReadWriteLock(): ReadWriteLock {
+    return binding.createReadWriteLock();
+}
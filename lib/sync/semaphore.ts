@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+let binding = require('../binding');
+
+export interface Semaphore {
+    /// <summary> The number of permits available. </summary>
+    readonly count: number;
+
+    /// <summary> Acquire a permit asynchronously, waiting for one without blocking the worker. </summary>
+    /// <returns> A Promise resolved once a permit is acquired. </returns>
+    acquire(): Promise<void>;
+
+    /// <summary> Acquire a permit synchronously, blocking the worker until one is available. </summary>
+    /// <param name="timeoutInMs"> Optional. The longest time to wait for a permit, waits until there is one if not specified. </param>
+    /// <remarks> It throws if no permit is available until the timeout. </remarks>
+    acquireSync(timeoutInMs?: number): void;
+
+    /// <summary> Acquire a permit if one is available right away. </summary>
+    /// <returns> True if a permit was acquired. </returns>
+    tryAcquire(): boolean;
+
+    /// <summary> Release permits, waiters are served in the order they asked. </summary>
+    /// <param name="count"> Optional. The number of permits to release, 1 if not specified. </param>
+    release(count?: number): void;
+}
+
+/// <summary> Create a counting semaphore shared across workers. </summary>
+/// <param name="count"> The number of permits initially available. </param>
+export function createSemaphore(count: number): Semaphore {
+    return binding.createSemaphore(count);
+}
@@ -24,4 +24,5 @@ export function createTransportContext(owning: boolean = true, handle : Handle =
 }
 
 export let saveFunction = functionTransporter.save;
-export let loadFunction = functionTransporter.load;
\ No newline at end of file
+export let loadFunction = functionTransporter.load;
+export let preloadFunction = functionTransporter.preload;
\ No newline at end of file
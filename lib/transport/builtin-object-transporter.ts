@@ -9,10 +9,24 @@ import { Shareable } from '../memory/shareable';
 export interface SerializedData extends Shareable {
 }
 
-export function serializeValue(jsValue: any): SerializedData {
-    return require('../binding').serializeValue(jsValue);
+export function serializeValue(jsValue: any, transferList?: ArrayBuffer[]): SerializedData {
+    return require('../binding').serializeValue(jsValue, transferList);
+}
+
+/// <summary> Detach transferred ArrayBuffers from the sender, once all values referencing them are serialized. </summary>
+export function detachArrayBuffers(transferList: ArrayBuffer[]) {
+    require('../binding').detachArrayBuffers(transferList);
 }
 
 export function deserializeValue(serializedData: SerializedData): any {
     return require('../binding').deserializeValue(serializedData);
 }
+
+/// <summary> Serialize a value into bytes, native objects in it are marshalled with the transport context. </summary>
+export function serializeValueToBytes(jsValue: any, context: any, transferList?: ArrayBuffer[]): ArrayBuffer {
+    return require('../binding').serializeValueToBytes(jsValue, context, transferList);
+}
+
+export function deserializeValueFromBytes(bytes: ArrayBuffer, context: any): any {
+    return require('../binding').deserializeValueFromBytes(bytes, context);
+}
@@ -8,12 +8,14 @@ import { Store } from '../store/store';
 import * as assert from 'assert';
 import * as path from 'path';
 
+let binding = require('../binding');
+
 /// <summary> Function hash to function cache. </summary>
-let _hashToFunctionCache: {[hash: string]: (...args: any[]) => any} = {};
+let _hashToFunctionCache = new Map<string, (...args: any[]) => any>();
 
 /// <summary> Function to hash cache. </summary>
-/// <remarks> Function cannot be used as a key in TypeScript. </remarks>
-let _functionToHashCache: any = {};
+/// <remarks> Keyed by function identity, so a saved function is never stringified again. </remarks>
+let _functionToHashCache = new WeakMap<(...args: any[]) => any, string>();
 
 /// <summary> Marshalled function body cache. </summary>
 let _store: Store;
@@ -41,7 +43,7 @@ function getStore(): Store {
 
 /// <summary> Save function and get a hash string to use it later. </summary>
 export function save(func: (...args: any[]) => any): string {
-    let hash = _functionToHashCache[(<any>(func))];
+    let hash = _functionToHashCache.get(func);
     if (hash == null) {
         // Should happen only on first marshall of input function in current isolate.
         let origin = (<any>func).origin || '';
@@ -60,7 +62,7 @@ export function save(func: (...args: any[]) => any): string {
 
 /// <summary> Load a function with a hash retrieved from `save`. </summary>
 export function load(hash: string): (...args: any[]) => any {
-    let func = _hashToFunctionCache[hash];
+    let func = _hashToFunctionCache.get(hash);
     if (func == null) {
         // Should happen only on first unmarshall of given hash in current isolate..
         let def: FunctionDef = getStore().get(hash);
@@ -73,25 +75,22 @@ export function load(hash: string): (...args: any[]) => any {
     return func;
 }
 
+/// <summary> Load a function ahead of its first call, which then finds it in the cache of current isolate. </summary>
+/// <remarks> Zones broadcast it to their workers when a function is first saved. </remarks>
+export function preload(hash: string): void {
+    load(hash);
+}
+
 /// <summary> Cache function with its hash in current isolate. </summary>
 function cacheFunction(hash: string, func: (...args: any[]) => any) {
-    _functionToHashCache[<any>(func)] = hash;
-    _hashToFunctionCache[hash] = func;
+    _functionToHashCache.set(func, hash);
+    _hashToFunctionCache.set(hash, func);
 }
 
-/// <summary> Generate hash for function definition using DJB2 algorithm. 
-/// See: https://en.wikipedia.org/wiki/DJB2 
-/// </summary>
+/// <summary> Generate hash for function definition using the native 64-bit xxHash, which hashes its UTF-8 bytes. </summary>
+/// <remarks> The length of the definition is appended, so definitions with colliding hashes must also have equal lengths. </remarks>
 function getFunctionHash(signature: string): string {
-    let hash = 5381;
-    for (let i = 0; i < signature.length; ++i) {
-        hash = (hash * 33) ^ signature.charCodeAt(i);
-    }
-
-    /* JavaScript does bitwise operations (like XOR, above) on 32-bit signed
-    * integers. Since we want the results to be always positive, convert the
-    * signed int to an unsigned by doing an unsigned bitshift. */
-    return (hash >>> 0).toString(16);
+    return binding.hash.xxhash64(signature) + '-' + signature.length.toString(16);
 }
 
 declare var __in_napa: boolean;
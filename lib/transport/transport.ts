@@ -10,22 +10,61 @@ import * as path from 'path';
 let _registry: Map<string, new(...args: any[]) => transportable.Transportable> 
     = new Map<string, new(...args: any[]) => transportable.Transportable>();
 
+/// <summary> Built-in types carried by V8 serialization, as structured clone does. </summary>
 let _builtInTypeWhitelist = new Set();
 [
     'ArrayBuffer',
+    'Date',
     'Float32Array',
     'Float64Array',
     'Int16Array',
     'Int32Array',
     'Int8Array',
+    'Map',
+    'RegExp',
+    'Set',
     'SharedArrayBuffer',
     'Uint16Array',
     'Uint32Array',
     'Uint8Array'
 ].forEach((type) => { _builtInTypeWhitelist.add(type); });
 
+/// <summary> Fixed-layout encode and decode functions of a TransportableObject sub-class registered with a schema. </summary>
+export interface SchemaCodec {
+    /// <summary> Returns the payload of an instance, { _cid: cid, _v: [values of the schema properties] }. </summary>
+    encode(object: any): object;
+
+    /// <summary> Creates an instance from the values of a payload, which already have inner objects transported. </summary>
+    decode(values: any[]): any;
+}
+
+/// <summary> Per-isolate constructor => codec registry, for classes registered with a schema. </summary>
+let _codecs: Map<Function, SchemaCodec> = new Map<Function, SchemaCodec>();
+
+/// <summary> Generates the codec of a schema, with one property access per schema property and no reflection. </summary>
+function createSchemaCodec(subClass: new(...args: any[]) => any, cid: string, schema: string[]): SchemaCodec {
+    let names = schema.map((name) => JSON.stringify(name));
+    let values = names.map((name) => `object[${name}]`).join(', ');
+    let assignments = names.map((name, i) => `object[${name}] = values[${i}];`).join('\n');
+
+    return {
+        encode: <(object: any) => object>new Function('object', `return { _cid: ${JSON.stringify(cid)}, _v: [${values}] };`),
+        decode: <(values: any[]) => any>new Function('subClass', 'values', `var object = new subClass();\n${assignments}\nreturn object;`)
+            .bind(null, subClass)
+    };
+}
+
+/// <summary> Returns the codec of a class registered with a schema, undefined if it has none. </summary>
+export function getSchemaCodec(subClass: Function): SchemaCodec {
+    return _codecs.get(subClass);
+}
+
 /// <summary> Register a TransportableObject sub-class with a Constructor ID (cid). </summary>
-export function register(subClass: new(...args: any[]) => any) {
+/// <param name="schema">
+///     Optional names of the properties that make the state of a TransportableObject sub-class. Instances are then
+///     marshalled as an array of these properties, with generated functions instead of save() and load().
+/// </param>
+export function register(subClass: new(...args: any[]) => any, schema?: string[]) {
     // Check cid from constructor first, which is for TransportableObject. 
     // Thus we don't need to construct the object to get cid according to Transportable interface. 
     let cid: string = (<any>subClass)['_cid'];
@@ -38,11 +77,18 @@ export function register(subClass: new(...args: any[]) => any) {
     if (_registry.has(cid)) {
         throw new Error(`Constructor ID (cid) "${cid}" is already registered.`);
     }
+    if (schema != null) {
+        if (!(subClass.prototype instanceof transportable.TransportableObject)) {
+            throw new Error(`Class "${subClass.name}" must extend TransportableObject to be registered with a schema.`);
+        }
+        _codecs.set(subClass, createSchemaCodec(subClass, cid, schema));
+    }
     _registry.set(cid, subClass);
 }
 
 /// <summary> Marshall transform a JS value to a plain JS value that will be stringified. </summary> 
-export function marshallTransform(jsValue: any, context: transportable.TransportContext): any {
+/// <param name="transferList"> ArrayBuffers to move to the receiver instead of copying. </param>
+export function marshallTransform(jsValue: any, context: transportable.TransportContext, transferList?: ArrayBuffer[]): any {
      if (jsValue != null && typeof jsValue === 'object' && !Array.isArray(jsValue)) {
         let constructorName = Object.getPrototypeOf(jsValue).constructor.name;
         if (constructorName !== 'Object') {
@@ -52,7 +98,7 @@ export function marshallTransform(jsValue: any, context: transportable.Transport
                 }
                 return <transportable.Transportable>(jsValue).marshall(context);
             } else if (_builtInTypeWhitelist.has(constructorName)) {
-                let serializedData = builtinObjectTransporter.serializeValue(jsValue);
+                let serializedData = builtinObjectTransporter.serializeValue(jsValue, transferList);
                 if (serializedData) {
                     return { _serialized : serializedData };
                 } else {
@@ -84,6 +130,15 @@ function unmarshallTransform(payload: any, context: transportable.TransportConte
         if (subClass == null) {
             throw new Error(`Unrecognized Constructor ID (cid) "${cid}". Please ensure @cid is applied on the class or transport.register is called on the class.`);
         }
+        // Payloads of classes without a schema may have a '_v' property of their own.
+        let codec = _codecs.get(subClass);
+        if (codec != null && payload._v !== undefined) {
+            return codec.decode(payload._v);
+        }
+        if (subClass.hasOwnProperty('_load')) {
+            // Native shareable wraps reuse the wrap of an object already loaded in this isolate.
+            return (<any>subClass)._load(payload, context);
+        }
         let object = new subClass();
         object.unmarshall(payload, context);
         return object;
@@ -104,6 +159,12 @@ export function unmarshall(
     if (json === "undefined") {
         return undefined;
     }
+
+    // Marshalled transportables, functions and built-in objects are all marked by one of these keys. Most payloads
+    // have neither, and a plain parse spares calling the reviver for every value.
+    if (json.indexOf('"_cid"') < 0 && json.indexOf('"_serialized"') < 0) {
+        return JSON.parse(json);
+    }
     return JSON.parse(json, 
         (key: any, value: any): any => {
             return unmarshallTransform(value, context);
@@ -113,18 +174,51 @@ export function unmarshall(
 /// <summary> Marshall a JavaScript value to JSON. </summary>
 /// <param name="jsValue"> JavaScript value to stringify, which maybe built-in JavaScript types or transportable objects. </param>
 /// <param name="context"> Transport context to save shared pointers. </param>
+/// <param name="transferList">
+///     ArrayBuffers to move to the receiver instead of copying.
+///     They stay usable until 'detach' is called with the list, which the caller does after marshalling all values.
+/// </param>
 /// <returns> JSON string. </returns>
 export function marshall(
     jsValue: any, 
-    context: transportable.TransportContext): string {
+    context: transportable.TransportContext,
+    transferList?: ArrayBuffer[]): string {
 
     // Function is transportable only as root object. 
     // This is to avoid unexpected marshalling on member functions.
     if (typeof jsValue === 'function') {
         return `{"_cid": "function", "hash": "${functionTransporter.save(jsValue)}"}`;
     }
-    return JSON.stringify(jsValue,
-        (key: string, value: any) => {
-            return marshallTransform(value, context);
-        });
+
+    // The native marshaller writes what JSON.stringify would with marshallTransform as replacer,
+    // without calling back into JS for each value.
+    return require('../binding').marshall(jsValue, context, transferList);
+}
+
+/// <summary> Marshall a JavaScript value to bytes with V8 serialization, which skips stringifying the value graph. </summary>
+/// <param name="jsValue"> JavaScript value to serialize, native objects in it are marshalled with the transport context. </param>
+/// <param name="context"> Transport context to save shared pointers and SharedArrayBuffers. </param>
+/// <param name="transferList"> ArrayBuffers to move to the receiver instead of copying, see 'marshall'. </param>
+/// <returns> ArrayBuffer of serialized bytes. </returns>
+/// <remarks> Transportable JavaScript class instances are serialized as plain objects. </remarks>
+export function marshallBinary(
+    jsValue: any,
+    context: transportable.TransportContext,
+    transferList?: ArrayBuffer[]): ArrayBuffer {
+    return builtinObjectTransporter.serializeValueToBytes(jsValue, context, transferList);
+}
+
+/// <summary> Unmarshall a JavaScript value from bytes created by 'marshallBinary'. </summary>
+/// <param name="bytes"> ArrayBuffer of serialized bytes. </param>
+/// <param name="context"> Transport context to load shared pointers and SharedArrayBuffers. </param>
+export function unmarshallBinary(bytes: ArrayBuffer, context: transportable.TransportContext): any {
+    return builtinObjectTransporter.deserializeValueFromBytes(bytes, context);
+}
+
+/// <summary> Detach transferred ArrayBuffers from the sender, after all values referencing them are marshalled. </summary>
+/// <param name="transferList"> The transfer list passed to 'marshall'. </param>
+export function detach(transferList: ArrayBuffer[]) {
+    if (transferList != null && transferList.length !== 0) {
+        builtinObjectTransporter.detachArrayBuffers(transferList);
+    }
 }
\ No newline at end of file
@@ -80,6 +80,11 @@ export abstract class TransportableObject implements Transportable{
     /// <summary> Marshall object into plain JavaScript object. </summary>
     /// <returns> Plain JavaScript value. </returns>
     marshall(context: TransportContext): object {
+        let codec = transport.getSchemaCodec(Object.getPrototypeOf(this).constructor);
+        if (codec !== undefined) {
+            return codec.encode(this);
+        }
+
         let payload = {
             _cid: this.cid()
         };
@@ -150,7 +155,8 @@ export function isTransportable(jsValue: any): boolean {
 
 /// <summary> Decorator 'cid' to register a transportable class with a 'cid'. </summary>
 /// <param name="guid"> If specified, use this GUID as cid. </param>
-export function cid<T extends TransportableObject>(guid?: string) {
+/// <param name="schema"> If specified, the properties instances are marshalled with, see transport.register. </param>
+export function cid<T extends TransportableObject>(guid?: string, schema?: string[]) {
     let moduleName: string = null;
     if (!guid) {
         moduleName = extractModuleName(v8.currentStack(2)[1].getFileName());
@@ -159,7 +165,7 @@ export function cid<T extends TransportableObject>(guid?: string) {
     return (constructor: new(...args: any[]) => any ) => {
         let cid = moduleName ? `${moduleName}.${constructor.name}` : guid;
         (<any>constructor)['_cid'] = cid;
-        transport.register(constructor);
+        transport.register(constructor, schema);
     }
 }
 
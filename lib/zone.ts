@@ -3,8 +3,13 @@
 
 import * as zone from './zone/zone';
 import * as impl from './zone/zone-impl';
+import * as group from './zone/zone-group';
+import * as functionCall from './zone/function-call';
 
 import * as platform from './runtime/platform';
+import * as v8 from './v8';
+
+import * as path from 'path';
 
 let binding = require('./binding');
 
@@ -15,8 +20,72 @@ declare var __in_napa: boolean;
 /// <summary> A unique id to identify the zone. </summary>
 /// <param name="settings"> The settings of the new zone. </param>
 export function create(id: string, settings: zone.ZoneSettings = zone.DEFAULT_SETTINGS) : zone.Zone {
+    return createZone(id, settings);
+}
+
+/// <summary>
+///     Creates a zone group of new member zones, i.e. one per NUMA node, which presents the members as a single zone.
+///     The members are named after the group, like 'group.0' and 'group.1'.
+/// </summary>
+/// <param name="id"> A unique id to identify the group, the prefix of the ids of its members. </param>
+/// <param name="members"> The settings of each member zone. </param>
+/// <param name="settings"> The settings of the group. </param>
+export function createGroup(id: string, members: zone.ZoneSettings[], settings: group.ZoneGroupSettings = group.DEFAULT_GROUP_SETTINGS) : group.ZoneGroup {
+    let zones: zone.Zone[] = [];
+    for (let i = 0; i < members.length; i++) {
+        zones.push(createZone(`${id}.${i}`, members[i]));
+    }
+    return new group.ZoneGroup(id, zones, settings, binding.getCurrentZone().getId());
+}
+
+/// <summary> Presents existing zones as a zone group, i.e. the members of a group created in another isolate. </summary>
+/// <param name="id"> The id of the group. </param>
+/// <param name="members"> The member zones. </param>
+/// <param name="settings"> The settings of the group. </param>
+export function groupOf(id: string, members: zone.Zone[], settings: group.ZoneGroupSettings = group.DEFAULT_GROUP_SETTINGS) : group.ZoneGroup {
     platform.initialize();
-    return new impl.ZoneImpl(binding.createZone(id, settings));
+    return new group.ZoneGroup(id, members, settings, binding.getCurrentZone().getId());
+}
+
+/// <summary> Creates a zone for create and createGroup, relative modules in settings are resolved from their caller. </summary>
+function createZone(id: string, settings: zone.ZoneSettings) : zone.Zone {
+    platform.initialize();
+
+    let copy: any = null;
+    let update = (name: string, value: any) => {
+        if (copy == null) {
+            copy = {};
+            Object.keys(settings).forEach((key: string) => { copy[key] = (settings as any)[key]; });
+        }
+        copy[name] = value;
+    };
+
+    // Settings are passed as strings, tenant weights and rate limits given as objects are joined like 'gold:4,silver:2'.
+    ['tenantWeights', 'tenantRateLimits'].forEach((name: string) => {
+        let values = (settings as any)[name];
+        if (values != null && typeof values === 'object') {
+            update(name, Object.keys(values).map((tenant: string) => tenant + ':' + values[tenant]).join(','));
+        }
+    });
+
+    // Workers load the preloaded and warm-up modules before anything else, relative ones are resolved from the caller.
+    // <caller> -> create -> createZone
+    //   2          1          0
+    let isRelative = (moduleName: string) => moduleName != null && moduleName.length != 0 && moduleName[0] === '.';
+    let preload = Array.isArray(settings.preload) ? settings.preload : [];
+    let callerDirectory: string = null;
+    if (preload.some(isRelative) || isRelative(settings.warmupModule)) {
+        callerDirectory = path.dirname(v8.currentStack(3)[2].getFileName());
+    }
+    let resolve = (moduleName: string) => isRelative(moduleName) ? path.resolve(callerDirectory, moduleName) : moduleName;
+
+    if (Array.isArray(settings.preload)) {
+        update('preload', preload.map(resolve).join(','));
+    }
+    if (isRelative(settings.warmupModule)) {
+        update('warmupModule', resolve(settings.warmupModule));
+    }
+    return new impl.ZoneImpl(binding.createZone(id, copy != null ? copy : settings));
 }
 
 /// <summary> Returns the zone associated with the provided id. </summary>
@@ -25,6 +94,92 @@ export function get(id: string) : zone.Zone {
     return new impl.ZoneImpl(binding.getZone(id));
 }
 
+/// <summary>
+///     Connects to a zone served by another process or host, whose calls are pipelined over a pool of TCP connections.
+///     Calls name functions of modules the remote zone can load, or broadcast source code. Anonymous functions and shared
+///     objects don't cross processes. A failed connection is not reconnected.
+/// </summary>
+/// <param name="address"> The address the zone is served on, like 'host:port'. </param>
+/// <param name="connections"> The number of connections calls are spread on. Default is 1. </param>
+export function connect(address: string, connections: number = 1) : zone.Zone {
+    platform.initialize();
+    return new impl.ZoneImpl(binding.connectZone(address, connections));
+}
+
+/// <summary>
+///     Serves a zone to napa.zone.connect of other processes or hosts, until stopServing.
+///     Clients are not authenticated, a zone should only be served on a trusted network.
+/// </summary>
+/// <param name="target"> The zone, or its id. </param>
+/// <param name="address"> The address to listen on, like '0.0.0.0:8300', port 0 for a port chosen by the system. </param>
+/// <returns> The port the zone is served on. </returns>
+export function serve(target: zone.Zone | string, address: string) : number {
+    platform.initialize();
+    let id = typeof target === 'string' ? target : target.id;
+    return binding.getZone(id).serve(address);
+}
+
+/// <summary> Stops serving the zone served on a port, and closes its connections. </summary>
+/// <param name="port"> The port returned by serve. </param>
+export function stopServing(port: number) : void {
+    platform.initialize();
+    binding.stopServingZone(port);
+}
+
+/// <summary>
+///     Connects to a zone served by another process of the host on shared memory, see serveSharedMemory.
+///     Calls are made like with connect, copied through rings of the shared memory rather than sockets.
+/// </summary>
+/// <param name="name"> The name the zone is served on. </param>
+/// <param name="connections"> The number of channels calls are spread on. Default is 1. </param>
+export function connectSharedMemory(name: string, connections: number = 1) : zone.Zone {
+    platform.initialize();
+    return new impl.ZoneImpl(binding.connectZoneSharedMemory(name, connections));
+}
+
+/// <summary> Serves a zone to napa.zone.connectSharedMemory of other processes of the host, until stopServingSharedMemory. </summary>
+/// <param name="target"> The zone, or its id. </param>
+/// <param name="name"> The name of the shared memory segment, without path separators. </param>
+export function serveSharedMemory(target: zone.Zone | string, name: string) : void {
+    platform.initialize();
+    let id = typeof target === 'string' ? target : target.id;
+    binding.getZone(id).serveSharedMemory(name);
+}
+
+/// <summary> Stops serving the zone served on a shared memory name, and closes its channels. </summary>
+/// <param name="name"> The name given to serveSharedMemory. </param>
+export function stopServingSharedMemory(name: string) : void {
+    platform.initialize();
+    binding.stopServingZoneSharedMemory(name);
+}
+
+/// <summary>
+///     Throws if the call running on this worker is past its deadline, so long running functions stop cleanly
+///     before they are terminated. See ZoneSettings.timeoutGracePeriod.
+/// </summary>
+export function checkDeadline(): void {
+    functionCall.checkDeadline();
+}
+
+/// <summary>
+///     Returns the trace of the zone call running on this worker, or undefined outside zone calls. Calls made while
+///     the function runs continue the trace by themselves, calls made after an await continue it by passing it as
+///     CallOptions.trace.
+/// </summary>
+export function getTraceContext(): zone.TraceContext {
+    return binding.getTraceContext();
+}
+
+/// <summary>
+///     Marks a function to be called with LazyArguments instead of unmarshalled arguments, so arguments it only passes
+///     on are never parsed. It marks the function in the isolate it runs in, so it is called where the function is defined,
+///     e.g. by the module exporting it. Calls with TransportOption.BINARY still get unmarshalled arguments.
+/// </summary>
+/// <returns> The function itself. </returns>
+export function lazyArgs<T extends Function>(func: T): T {
+    return functionCall.markLazyArgs(func);
+}
+
 /// TODO: add function getOrCreate(id: string, settings: zone.ZoneSettings): Zone.
 
 /// <summary> Define a getter property 'current' to retrieve the current zone. </summary>
@@ -45,4 +200,5 @@ Object.defineProperty(exports, "node", {
     }
 });
 
-export * from './zone/zone';
\ No newline at end of file
+export * from './zone/zone';
+export { ZoneGroup, ZoneGroupSettings, DEFAULT_GROUP_SETTINGS } from './zone/zone-group';
\ No newline at end of file
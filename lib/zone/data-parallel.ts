@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as transport from '../transport';
+
+/// <summary> Maps the elements of a chunk in a worker, called by zone.map. </summary>
+/// <param name="hash"> The hash of the saved mapping function. </param>
+/// <param name="items"> The chunk, or the whole typed array when it is on a SharedArrayBuffer. </param>
+/// <param name="begin"> The index of the first element of the chunk in items. </param>
+/// <param name="end"> The index after the last element of the chunk in items. </param>
+/// <param name="base"> The index of items[0] in the mapped array. </param>
+/// <returns> The mapped elements of the chunk. </returns>
+export function mapChunk(hash: string, items: ArrayLike<any>, begin: number, end: number, base: number): any[] {
+    let func = transport.loadFunction(hash);
+    let values = new Array(end - begin);
+    for (let i = begin; i < end; i++) {
+        values[i - begin] = func(items[i], base + i);
+    }
+    return values;
+}
+
+/// <summary> Runs a kernel over a range of a typed array on a SharedArrayBuffer in a worker, called by zone.parallelFor. </summary>
+/// <param name="hash"> The hash of the saved kernel. </param>
+/// <param name="items"> The whole typed array, shared by all ranges. </param>
+/// <param name="begin"> The index of the first element of the range, appended by the native zone. </param>
+/// <param name="end"> The index after the last element of the range, appended by the native zone. </param>
+export function forRange(hash: string, items: ArrayBufferView, begin: number, end: number): void {
+    transport.loadFunction(hash)(items, begin, end);
+}
+
+/// <summary> Reduces the elements of a chunk in a worker, called by zone.reduce. </summary>
+/// <param name="hash"> The hash of the saved reducing function. </param>
+/// <param name="items"> The chunk, or the whole typed array when it is on a SharedArrayBuffer. </param>
+/// <param name="begin"> The index of the first element of the chunk in items. </param>
+/// <param name="end"> The index after the last element of the chunk in items, chunks are never empty. </param>
+/// <returns> The reduced value of the chunk, starting from its first element. </returns>
+export function reduceChunk(hash: string, items: ArrayLike<any>, begin: number, end: number): any {
+    let func = transport.loadFunction(hash);
+    let value = items[begin];
+    for (let i = begin + 1; i < end; i++) {
+        value = func(value, items[i]);
+    }
+    return value;
+}
@@ -2,7 +2,8 @@
 // Licensed under the MIT license.
 
 import * as transport from '../transport';
-import { CallOptions } from './zone';
+import * as zone from './zone';
+import { CallOptions, TransportOption } from './zone';
 
 /// <summary> Rejection type </summary>
 /// TODO: we need a better mapping between error code and result code.
@@ -14,8 +15,8 @@ export enum RejectionType {
 /// <summary> Interface for Call context. </summary>
 export interface CallContext {
 
-    /// <summary> Resolve task with marshalled result. </summary>
-    resolve(result: string): void;
+    /// <summary> Resolve task with marshalled result, or serialized bytes for TransportOption.BINARY. </summary>
+    resolve(result: string | ArrayBuffer): void;
 
     /// <summary> Reject task with reason. </summary>
     reject(reason: any): void;
@@ -23,20 +24,29 @@ export interface CallContext {
     /// <summary> Reject task with a rejection type and reason. </summary>
     reject(type: RejectionType, reason: any): void;
 
+    /// <summary> Record that the function started, when options.recordTiming is set or the call's trace is sampled. </summary>
+    markStarted(): void;
+
+    /// <summary> Record that the function returned, when options.recordTiming is set or the call's trace is sampled. </summary>
+    markFinished(): void;
+
     /// <summary> Returns whether task has finished (either completed or cancelled). </summary>
     readonly finished: boolean;
 
     /// <summary> Elapse in nano-seconds since task started. </summary>
     readonly elapse: [number, number];
 
+    /// <summary> Milliseconds since epoch the call should finish by, from its timeout or deadline, 0 for none. </summary>
+    readonly deadline: number;
+
     /// <summary> Module name to select function. </summary>
     readonly module: string;
 
     /// <summary> Function name to execute. </summary>
     readonly function: string;
 
-    /// <summary> Marshalled arguments. </summary>
-    readonly args: string[];
+    /// <summary> Marshalled arguments, or one ArrayBuffer of all arguments for TransportOption.BINARY. </summary>
+    readonly args: any[];
 
     /// <summary> Transport context. </summary>
     readonly transportContext: transport.TransportContext;
@@ -58,22 +68,25 @@ export interface CallContext {
 ///        function name: target function name from the module.
 ///
 ///     function name can have multiple levels like 'foo.bar'.
+///
+///     Returns true when the call completed before returning, then the context is not referenced anymore
+///     and its wrap is reused by the next call. Returns false when completion waits for a promise.
 /// </summary>
-export function call(context: CallContext): void {
+export function call(context: CallContext): boolean {
     // Cache the context since every call to context.transportContext will create a new wrap upon inner TransportContext pointer.
     let transportContext = context.transportContext;
+    let options = context.options;
     let result: any = undefined;
+    _currentDeadline = context.deadline;
     try {
-        result = callFunction(
-            context.module, 
-            context.function, 
-            context.args, 
-            transportContext,
-            context.options);
+        result = callFunction(context, transportContext, options);
     }
     catch(error) {
-        context.reject(error);
-        return;
+        rejectCall(context, error);
+        return true;
+    }
+    finally {
+        _currentDeadline = 0;
     }
 
     if (result != null 
@@ -81,70 +94,176 @@ export function call(context: CallContext): void {
         && typeof result['then'] === 'function') {
         // Delay completion if return value is a promise.
         result.then((value: any) => {
-            finishCall(context, transportContext, value);
+            finishCall(context, transportContext, options, value);
         })
         .catch((error: any) => {
-            context.reject(error);
+            rejectCall(context, error);
         });
-        return;
+        return false;
+    }
+    finishCall(context, transportContext, options, result);
+    return true;
+}
+
+/// <summary> Error message of calls that stopped at their deadline. </summary>
+const DEADLINE_EXCEEDED_MESSAGE = 'Deadline exceeded';
+
+/// <summary> The deadline of the call running synchronously on this worker, 0 for none. </summary>
+let _currentDeadline = 0;
+
+/// <summary>
+///     Throws if the call running on this worker is past its deadline, i.e. its timeout ran out.
+///     Long running functions check it to stop cleanly within the zone's timeoutGracePeriod,
+///     the call is then rejected as timed out without terminating the worker.
+///     Only the synchronous part of a call has a deadline, continuations of returned promises don't.
+/// </summary>
+export function checkDeadline(): void {
+    if (_currentDeadline > 0 && Date.now() >= _currentDeadline) {
+        let error: any = new Error(DEADLINE_EXCEEDED_MESSAGE);
+        error.deadlineExceeded = true;
+        throw error;
+    }
+}
+
+/// <summary> Reject a call with an error, calls that stopped at their deadline are rejected as timed out. </summary>
+function rejectCall(context: CallContext, error: any) {
+    if (error != null && error.deadlineExceeded === true) {
+        context.reject(RejectionType.TIMEOUT, DEADLINE_EXCEEDED_MESSAGE);
+    } else {
+        context.reject(error);
+    }
+}
+
+/// <summary>
+///     Functions resolved from modules in this isolate, by module name and then function name.
+///     Modules are cached by require, so repeated calls skip loading the module and walking the function name.
+///     Global functions are not cached since they can be redefined, e.g. by zone.broadcast.
+/// </summary>
+let _resolvedFunctions = new Map<string, Map<string, Function>>();
+
+/// <summary> Functions marked by zone.lazyArgs in this isolate. </summary>
+let _lazyArgFunctions = new WeakSet<Function>();
+
+/// <summary> Mark a function to get its arguments as LazyArguments, see zone.lazyArgs. </summary>
+export function markLazyArgs<T extends Function>(func: T): T {
+    if (typeof func !== 'function') {
+        throw new TypeError('lazyArgs expects a function.');
+    }
+    _lazyArgFunctions.add(func);
+    return func;
+}
+
+/// <summary> An argument of a function marked by zone.lazyArgs, unmarshalled on the first access of its value. </summary>
+class LazyArgument implements zone.LazyArgument {
+    constructor(payload: string, transportContext: transport.TransportContext) {
+        this._payload = payload;
+        this._transportContext = transportContext;
+    }
+
+    get payload(): string {
+        return this._payload;
     }
-    finishCall(context, transportContext, result);
+
+    get value(): any {
+        if (!this._unmarshalled) {
+            this._value = transport.unmarshall(this._payload, this._transportContext);
+            this._unmarshalled = true;
+        }
+        return this._value;
+    }
+
+    private _payload: string;
+    private _transportContext: transport.TransportContext;
+    private _value: any;
+    private _unmarshalled: boolean = false;
+}
+
+/// <summary> Whether arguments and result are transported in bytes. </summary>
+function isBinary(options: CallOptions): boolean {
+    return options != null && options.transport === TransportOption.BINARY;
 }
 
 /// <summary> Call a function. </summary>
 function callFunction(
-    moduleName: string, 
-    functionName: string, 
-    marshalledArgs: string[], 
+    context: CallContext,
     transportContext: transport.TransportContext,
     options: CallOptions): any {
 
-    let module: any = null;
-    let useAnonymousFunction: boolean = false;
+    let func = loadFunction(context.module, context.function);
+    let marshalledArgs = context.args;
+
+    // Bytes of TransportOption.BINARY hold all arguments, they are unmarshalled at once even for lazyArgs functions.
+    let args = isBinary(options) ?
+        transport.unmarshallBinary(marshalledArgs[0], transportContext)
+        : _lazyArgFunctions.has(func) ?
+            marshalledArgs.map((arg) => { return new LazyArgument(arg, transportContext); })
+            : marshalledArgs.map((arg) => { return transport.unmarshall(arg, transportContext); });
+
+    if (options.recordTiming) {
+        context.markStarted();
+    }
+    return func.apply(this, args);
+}
 
+/// <summary> Load the function of a call, see `call` for how module and function names are given. </summary>
+export function loadFunction(moduleName: string, functionName: string): Function {
     if (moduleName == null || moduleName.length === 0 || moduleName === 'global') {
-        module = global;
-    } else if (moduleName === '__function') {
-        useAnonymousFunction = true;
-    } else {
-        module = require(moduleName);
+        return resolveFunction(global, moduleName, functionName);
+    }
+    if (moduleName === '__function') {
+        return transport.loadFunction(functionName);
     }
 
-    let func = null;
-    if (useAnonymousFunction) {
-        func = transport.loadFunction(functionName);
-    } else {
-        if (module == null) {
-            throw new Error(`Cannot load module \"${moduleName}\".`);
+    let moduleFunctions = _resolvedFunctions.get(moduleName);
+    let func = moduleFunctions != null ? moduleFunctions.get(functionName) : undefined;
+    if (func === undefined) {
+        func = resolveFunction(require(moduleName), moduleName, functionName);
+        if (moduleFunctions == null) {
+            moduleFunctions = new Map<string, Function>();
+            _resolvedFunctions.set(moduleName, moduleFunctions);
         }
-        func = module;
-        if (functionName != null && functionName.length != 0) {
-            var path = functionName.split('.');
-            for (let item of path) {
-                func = func[item];
-                if (func === undefined) {
-                    throw new Error("Cannot find function '" + functionName + "' in module '" + moduleName + "'");
-                }
+        moduleFunctions.set(functionName, func);
+    }
+    return func;
+}
+
+/// <summary> Resolve a function by its name, which can have multiple levels like 'foo.bar', from a module. </summary>
+function resolveFunction(module: any, moduleName: string, functionName: string): Function {
+    if (module == null) {
+        throw new Error(`Cannot load module \"${moduleName}\".`);
+    }
+    let func = module;
+    if (functionName != null && functionName.length != 0) {
+        var path = functionName.split('.');
+        for (let item of path) {
+            func = func[item];
+            if (func === undefined) {
+                throw new Error("Cannot find function '" + functionName + "' in module '" + moduleName + "'");
             }
         }
-        if (typeof func !== 'function') {
-            throw new Error("'" + functionName + "' in module '" + moduleName + "' is not a function");
-        }
     }
-
-    let args = marshalledArgs.map((arg) => { return transport.unmarshall(arg, transportContext); });
-    return func.apply(this, args);
+    if (typeof func !== 'function') {
+        throw new Error("'" + functionName + "' in module '" + moduleName + "' is not a function");
+    }
+    return func;
 }
 
 /// <summary> Finish call with result. </summary>
 function finishCall(
     context: CallContext, 
     transportContext: transport.TransportContext, 
+    options: CallOptions,
     result: any) {
 
-    let payload: string = undefined;
+    if (options.recordTiming) {
+        context.markFinished();
+    }
+
+    let payload: string | ArrayBuffer = undefined;
     try {
-        payload = transport.marshall(result, transportContext);
+        payload = isBinary(options) ?
+            transport.marshallBinary(result, transportContext)
+            : transport.marshall(result, transportContext);
     }
     catch (error) {
         context.reject(error);
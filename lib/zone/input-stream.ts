@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as zone from './zone';
+
+/// <summary> A write waiting for room in the stream. </summary>
+interface PendingWrite {
+    item: any;
+    resolve: () => void;
+    reject: (error: any) => void;
+}
+
+/// <summary> A read waiting for a result. </summary>
+interface PendingRead {
+    resolve: (result: IteratorResult<any>) => void;
+    reject: (error: any) => void;
+}
+
+/// <summary> Limits of an input stream, resolved from its options. </summary>
+export interface InputStreamLimits {
+    concurrency: number;
+    capacity: number;
+    maxQueueLength: number;
+    ordered: boolean;
+}
+
+/// <summary> The stream zone.createStream returns, which calls a function for each item written and yields the results. </summary>
+/// <remarks>
+///     An item is called once fewer than 'concurrency' calls are in flight, fewer than 'capacity' results wait to be read,
+///     and the zone has fewer than 'maxQueueLength' calls waiting for a worker, unless none of the stream's calls is in
+///     flight. Until then its write is pending, so a producer awaiting its writes never runs ahead of the zone.
+/// </remarks>
+export class InputStream implements zone.InputStream {
+
+    /// <param name="call"> Calls the function of the stream with an item. </param>
+    /// <param name="queueLength"> Gets the number of calls waiting for a worker of the zone. </param>
+    constructor(call: (item: any) => Promise<zone.Result>, queueLength: () => number, limits: InputStreamLimits) {
+        this._call = call;
+        this._queueLength = queueLength;
+        this._limits = limits;
+    }
+
+    write(item: any): Promise<void> {
+        if (this._ended) {
+            return Promise.reject(new Error('Cannot write to a stream after it ended'));
+        }
+        if (this._failed) {
+            return Promise.reject(this._error);
+        }
+        return new Promise<void>((resolve, reject) => {
+            this._writes.push({ item: item, resolve: resolve, reject: reject });
+            this.admit();
+        });
+    }
+
+    end(): void {
+        this._ended = true;
+        this.settle();
+    }
+
+    next(): Promise<IteratorResult<any>> {
+        return new Promise<IteratorResult<any>>((resolve, reject) => {
+            this._reads.push({ resolve: resolve, reject: reject });
+            this.settle();
+        });
+    }
+
+    return(): Promise<IteratorResult<any>> {
+        // Calls in flight run to completion, their results are dropped.
+        this._ended = true;
+        this._closed = true;
+        this._ready = [];
+        this._completed = {};
+        this._completedCount = 0;
+        this.rejectWrites(new Error('The stream was closed'));
+        this.settle();
+        return Promise.resolve({ done: true, value: undefined });
+    }
+
+    /// <summary> Calls the function with the pending writes while the stream has room. </summary>
+    private admit(): void {
+        while (this._writes.length > 0 && this.hasRoom()) {
+            let write = this._writes.shift();
+            let index = this._written++;
+            this._inFlight++;
+            this._call(write.item).then(
+                (result: zone.Result) => this.complete(index, result.value, null),
+                (error: any) => this.complete(index, undefined, error != null ? error : new Error('The call failed')));
+            write.resolve();
+        }
+    }
+
+    private hasRoom(): boolean {
+        if (this._failed || this._closed
+            || this._inFlight >= this._limits.concurrency
+            || this._ready.length + this._completedCount >= this._limits.capacity) {
+            return false;
+        }
+
+        // The zone's queue only holds back a stream that has a call in flight, whose completion checks it again.
+        return this._inFlight === 0 || this._queueLength() < this._limits.maxQueueLength;
+    }
+
+    private complete(index: number, value: any, error: any): void {
+        this._inFlight--;
+        if (this._closed) {
+            return;
+        }
+
+        if (error != null) {
+            if (!this._failed) {
+                this._failed = true;
+                this._error = error;
+                this.rejectWrites(error);
+            }
+        } else if (!this._limits.ordered) {
+            this._ready.push(value);
+        } else {
+            // Results that are ahead of the next one to emit wait for it.
+            this._completed[index] = value;
+            this._completedCount++;
+            while (this._completed.hasOwnProperty(<any>this._emitted)) {
+                this._ready.push(this._completed[this._emitted]);
+                delete this._completed[this._emitted];
+                this._completedCount--;
+                this._emitted++;
+            }
+        }
+        this.settle();
+    }
+
+    /// <summary> Serves the pending reads, then admits the writes that fit in the room reads made. </summary>
+    private settle(): void {
+        while (this._reads.length > 0) {
+            if (this._ready.length > 0) {
+                this._reads.shift().resolve({ done: false, value: this._ready.shift() });
+            } else if (this._failed && !this._closed) {
+                this._reads.shift().reject(this._error);
+            } else if (this._closed || (this._ended && this._writes.length === 0 && this._inFlight === 0)) {
+                this._reads.shift().resolve({ done: true, value: undefined });
+            } else {
+                break;
+            }
+        }
+        this.admit();
+    }
+
+    private rejectWrites(error: any): void {
+        let writes = this._writes;
+        this._writes = [];
+        for (let write of writes) {
+            write.reject(error);
+        }
+    }
+
+    private _call: (item: any) => Promise<zone.Result>;
+    private _queueLength: () => number;
+    private _limits: InputStreamLimits;
+
+    private _writes: PendingWrite[] = [];
+    private _reads: PendingRead[] = [];
+
+    /// <summary> Results ready to be read, in the order they are emitted. </summary>
+    private _ready: any[] = [];
+
+    /// <summary> Results of ordered streams that completed before a previous item, by item index. </summary>
+    private _completed: { [index: number]: any } = {};
+    private _completedCount: number = 0;
+
+    private _written: number = 0;
+    private _emitted: number = 0;
+    private _inFlight: number = 0;
+
+    private _ended: boolean = false;
+    private _closed: boolean = false;
+    private _failed: boolean = false;
+    private _error: any = null;
+}
+
+// Makes streams work with `for await`, where the runtime has async iterators.
+if ((<any>Symbol).asyncIterator != null) {
+    (<any>InputStream.prototype)[(<any>Symbol).asyncIterator] = function() {
+        return this;
+    };
+}
@@ -0,0 +1,24 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import { log } from '../log';
+
+/// <summary>
+///     Load the modules of ZoneSettings.preload. It is run by the bootstrap script of each worker, so the first calls
+///     find the modules loaded. Modules are required from this directory, as calls require them, so they are resolved
+///     the same way and share the module cache. A module that fails to load is logged and loaded again by the first call.
+/// </summary>
+/// <returns> The number of modules loaded. </returns>
+export function run(moduleNames: string[]): number {
+    let loaded = 0;
+    for (let moduleName of moduleNames) {
+        try {
+            require(moduleName);
+            loaded++;
+        }
+        catch (error) {
+            log.warn('Zone', `Failed to preload module '${moduleName}': ${error}`);
+        }
+    }
+    return loaded;
+}
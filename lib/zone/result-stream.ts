@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as zone from './zone';
+import * as functionCall from './function-call';
+import { Channel } from '../sync/channel';
+
+/// <summary> Streams the values a function yields into a channel in a worker, called by zone.executeStream. </summary>
+/// <param name="channel"> The channel the caller receives from, closed once the function is done or failed. </param>
+/// <param name="moduleName"> The module of the function, like for zone.execute. </param>
+/// <param name="functionName"> The name of the function, like for zone.execute. </param>
+/// <returns> A promise of the number of values sent, rejected if the function failed or the caller stopped reading. </returns>
+/// <remarks>
+///     The function returns an iterable, an async iterable, or a promise of either. Each value is sent once the channel
+///     has room, so a producer never runs more than the channel capacity ahead of the caller.
+/// </remarks>
+export function streamResult(channel: Channel, moduleName: string, functionName: string, ...args: any[]): Promise<number> {
+    let count = 0;
+    let iterator: any = null;
+    let closeIterator = () => {
+        // Lets generators run their finally blocks when the caller stopped reading.
+        if (iterator != null && typeof iterator.return === 'function') {
+            try {
+                iterator.return();
+            }
+            catch (error) {
+            }
+        }
+    };
+
+    return new Promise<number>((resolve, reject) => {
+        let fail = (error: any) => {
+            closeIterator();
+            channel.close();
+            reject(error);
+        };
+
+        // Each step settles on its own, so a long stream doesn't build a chain of pending promises.
+        let step = () => {
+            Promise.resolve(iterator.next()).then((result: IteratorResult<any>) => {
+                if (result.done) {
+                    channel.close();
+                    resolve(count);
+                    return;
+                }
+                return Promise.resolve(result.value)
+                    .then((value: any) => channel.send(value))
+                    .then(() => {
+                        ++count;
+                        step();
+                    });
+            }).catch(fail);
+        };
+
+        try {
+            let func = functionCall.loadFunction(moduleName, functionName);
+            Promise.resolve(func.apply(this, args)).then((iterable: any) => {
+                iterator = getIterator(iterable);
+                step();
+            }).catch(fail);
+        }
+        catch (error) {
+            fail(error);
+        }
+    });
+}
+
+/// <summary> Get the iterator of an async or sync iterable. </summary>
+function getIterator(iterable: any): any {
+    let asyncIterator = (<any>Symbol).asyncIterator;
+    if (iterable != null && asyncIterator != null && typeof iterable[asyncIterator] === 'function') {
+        return iterable[asyncIterator]();
+    }
+    if (iterable != null && typeof iterable[Symbol.iterator] === 'function') {
+        return iterable[Symbol.iterator]();
+    }
+    throw new TypeError('A streaming function must return an iterable or an async iterable.');
+}
+
+/// <summary> The caller side of zone.executeStream, an async iterator over the values received from the channel. </summary>
+export class ResultStream implements zone.ResultStream {
+
+    constructor(channel: Channel, call: Promise<zone.Result>) {
+        this._channel = channel;
+        this._call = call;
+
+        // The call settles once the stream ends, its failure is reported by next() instead.
+        this._call.catch(() => {});
+    }
+
+    next(): Promise<IteratorResult<any>> {
+        if (this._done) {
+            return Promise.resolve({ done: true, value: undefined });
+        }
+
+        // A receive fails only once the channel is closed and drained, then the call tells how the stream ended.
+        return this._channel.receive().then(
+            (value: any) => ({ done: false, value: value }),
+            () => {
+                this._done = true;
+                return this._call.then((): IteratorResult<any> => ({ done: true, value: undefined }));
+            });
+    }
+
+    return(): Promise<IteratorResult<any>> {
+        // The worker stops at its next send, values it sent but the caller didn't receive are dropped.
+        this._done = true;
+        this._channel.close();
+        return Promise.resolve({ done: true, value: undefined });
+    }
+
+    private _channel: Channel;
+    private _call: Promise<zone.Result>;
+    private _done: boolean = false;
+}
+
+// Makes streams work with `for await`, where the runtime has async iterators.
+if ((<any>Symbol).asyncIterator != null) {
+    (<any>ResultStream.prototype)[(<any>Symbol).asyncIterator] = function() {
+        return this;
+    };
+}
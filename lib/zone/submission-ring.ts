@@ -0,0 +1,310 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as zone from './zone';
+import * as functionCall from './function-call';
+
+/// <summary> Atomics are not in the es2015 library the module is typed with. </summary>
+const atomics: any = (<any>global).Atomics;
+
+/// <summary> Indices of the control words, followed by the length and status of each slot. </summary>
+const SUBMITTED = 0;
+const COMPLETED = 1;
+const CLOSED = 2;
+const HEADER_LENGTH = 4;
+
+/// <summary> Status of a slot once its call completed. </summary>
+const STATUS_VALUE = 0;
+const STATUS_UNDEFINED = 1;
+const STATUS_ERROR = 2;
+
+/// <summary> Times the worker checks for a submission before it waits, so back to back calls don't sleep. </summary>
+const SPIN_COUNT = 1000;
+
+/// <summary> The longest wait of the worker, after which it checks for a close it missed. </summary>
+const MAX_WAIT_MS = 100;
+
+/// <summary> Event loop turns Node polls for results without Atomics.waitAsync, before it backs off to timers. </summary>
+const POLL_TURNS = 8;
+
+/// <summary> The delay between polls once Node backs off, doubled while no call completes up to the longest. </summary>
+const MIN_POLL_DELAY_MS = 1;
+const MAX_POLL_DELAY_MS = 16;
+
+/// <summary> Characters decoded per String.fromCharCode call, under the argument limit of functions. </summary>
+const DECODE_CHUNK = 8192;
+
+/// <summary> Writes a string into a slot as UTF-16 code units. </summary>
+/// <returns> False if the string is longer than the slot. </returns>
+function writeSlot(control: Int32Array, data: Uint16Array, slot: number, slotChars: number, status: number, text: string): boolean {
+    if (text.length > slotChars) {
+        return false;
+    }
+
+    let offset = slot * slotChars;
+    for (let i = 0; i < text.length; i++) {
+        data[offset + i] = text.charCodeAt(i);
+    }
+    control[HEADER_LENGTH + slot * 2] = text.length;
+    control[HEADER_LENGTH + slot * 2 + 1] = status;
+    return true;
+}
+
+/// <summary> Reads the string of a slot. </summary>
+function readSlot(control: Int32Array, data: Uint16Array, slot: number, slotChars: number): string {
+    let offset = slot * slotChars;
+    let length = control[HEADER_LENGTH + slot * 2];
+    let text = '';
+    for (let i = 0; i < length; i += DECODE_CHUNK) {
+        text += String.fromCharCode.apply(null, data.subarray(offset + i, offset + Math.min(length, i + DECODE_CHUNK)));
+    }
+    return text;
+}
+
+/// <summary> Serves the calls submitted to a ring in a worker, called by zone.createRing. </summary>
+/// <param name="control"> The control words and slot headers, on the SharedArrayBuffer of the ring. </param>
+/// <param name="data"> The slots, on the SharedArrayBuffer of the ring. </param>
+/// <param name="moduleName"> The module of the function, like for zone.execute. </param>
+/// <param name="functionName"> The name of the function, like for zone.execute. </param>
+/// <returns> The number of calls served, once the ring is closed. </returns>
+/// <remarks>
+///     The worker runs the calls in the order they were submitted, writes each result into the slot of its call,
+///     and sleeps in Atomics.wait between calls. It keeps the worker until the ring is closed.
+/// </remarks>
+export function serveRing(control: Int32Array, data: Uint16Array, moduleName: string, functionName: string): number {
+    let func = functionCall.loadFunction(moduleName, functionName);
+    let slots = (control.length - HEADER_LENGTH) / 2;
+    let slotChars = data.length / slots;
+
+    let next = 0;
+    while (true) {
+        let spins = 0;
+        while (atomics.load(control, SUBMITTED) === next) {
+            if (atomics.load(control, CLOSED) !== 0) {
+                return next;
+            }
+            if (++spins > SPIN_COUNT) {
+                atomics.wait(control, SUBMITTED, next, MAX_WAIT_MS);
+            }
+        }
+
+        let slot = next % slots;
+        let status = STATUS_VALUE;
+        let text: string;
+        try {
+            let result = func.apply(this, JSON.parse(readSlot(control, data, slot, slotChars)));
+            text = JSON.stringify(result);
+            if (text === undefined) {
+                status = STATUS_UNDEFINED;
+                text = '';
+            }
+        }
+        catch (error) {
+            status = STATUS_ERROR;
+            text = error instanceof Error ? error.message : String(error);
+        }
+
+        if (!writeSlot(control, data, slot, slotChars, status, text)) {
+            writeSlot(control, data, slot, slotChars, STATUS_ERROR, `Result of ${text.length} characters exceeds the slot`);
+        }
+
+        ++next;
+        atomics.store(control, COMPLETED, next);
+        atomics.notify(control, COMPLETED);
+    }
+}
+
+/// <summary> The Node side of zone.createRing, which writes calls into the slots of the ring and reads their results back. </summary>
+export class SubmissionRing implements zone.SubmissionRing {
+
+    constructor(slots: number, slotSize: number, serve: (control: Int32Array, data: Uint16Array) => Promise<zone.Result>) {
+        let sharedArrayBuffer: any = (<any>global).SharedArrayBuffer;
+        if (sharedArrayBuffer == null || atomics == null) {
+            throw new Error('Submission rings need SharedArrayBuffer and Atomics');
+        }
+
+        this._slots = slots;
+        this._slotChars = Math.max(Math.floor(slotSize / 2), 1);
+        this._control = new Int32Array(new sharedArrayBuffer((HEADER_LENGTH + slots * 2) * 4));
+        this._data = new Uint16Array(new sharedArrayBuffer(slots * this._slotChars * 2));
+        this._calls = new Array(slots);
+
+        // The call ends once the ring is closed and drained, or fails if the worker went away, i.e. recycled.
+        this._served = serve(this._control, this._data).then(
+            (result: zone.Result) => {
+                this.fail(new Error('Submission ring is closed'));
+                return <number>result.value;
+            },
+            (error: any) => {
+                this.fail(error);
+                throw error;
+            });
+        this._served.catch(() => {});
+    }
+
+    get pending(): number {
+        return this._submitted - this._completed + this._backlog.length;
+    }
+
+    submit(...args: any[]): Promise<any> {
+        if (this._closed) {
+            return Promise.reject(new Error('Submission ring is closed'));
+        }
+
+        let text = JSON.stringify(args);
+        if (text.length > this._slotChars) {
+            return Promise.reject(new RangeError(`Arguments of ${text.length} characters exceed the slot`));
+        }
+
+        return new Promise<any>((resolve, reject) => {
+            this._backlog.push({ text: text, resolve: resolve, reject: reject });
+            this.flush();
+        });
+    }
+
+    close(): Promise<number> {
+        if (!this._closed) {
+            // Calls in the slots are still served, the worker only leaves once it caught up.
+            this._closed = true;
+            this.rejectBacklog(new Error('Submission ring is closed'));
+            atomics.store(this._control, CLOSED, 1);
+            atomics.notify(this._control, SUBMITTED);
+        }
+        return this._served;
+    }
+
+    /// <summary> Writes waiting calls into the slots whose results were read. </summary>
+    private flush(): void {
+        if (this._closed) {
+            return;
+        }
+
+        let submitted = this._submitted;
+        while (this._backlog.length > 0 && submitted - this._completed < this._slots) {
+            let call = this._backlog.shift();
+            let slot = submitted % this._slots;
+            writeSlot(this._control, this._data, slot, this._slotChars, STATUS_VALUE, call.text);
+            this._calls[slot] = call;
+            ++submitted;
+        }
+
+        if (submitted !== this._submitted) {
+            this._submitted = submitted;
+            atomics.store(this._control, SUBMITTED, submitted);
+            atomics.notify(this._control, SUBMITTED, 1);
+            this.watch();
+        }
+    }
+
+    /// <summary> Waits for the worker to complete calls without blocking the event loop, while calls are in flight. </summary>
+    private watch(): void {
+        if (this._watching || this._completed === this._submitted) {
+            return;
+        }
+        this._watching = true;
+
+        let completed = this._completed;
+        let wake = () => {
+            this._watching = false;
+            this.drain();
+        };
+
+        // Atomics.waitAsync wakes up on the notify of the worker, older runtimes poll for results.
+        if (typeof atomics.waitAsync === 'function') {
+            let result = atomics.waitAsync(this._control, COMPLETED, completed);
+            if (result.async) {
+                result.value.then(wake);
+            } else {
+                setImmediate(wake);
+            }
+        } else {
+            this.poll(wake);
+        }
+    }
+
+    /// <summary>
+    /// Polls for results between event loop turns, then backs off to timers of a growing delay while no call completes,
+    /// so a long call doesn't spin the Node thread.
+    /// </summary>
+    private poll(wake: () => void): void {
+        let idlePolls = this._idlePolls++;
+        if (idlePolls < POLL_TURNS) {
+            setImmediate(wake);
+        } else {
+            let delay = Math.min(MIN_POLL_DELAY_MS * Math.pow(2, idlePolls - POLL_TURNS), MAX_POLL_DELAY_MS);
+            setTimeout(wake, delay);
+        }
+    }
+
+    /// <summary> Settles the calls the worker completed, then submits waiting calls into their slots. </summary>
+    private drain(): void {
+        this.settle();
+        this.flush();
+        this.watch();
+    }
+
+    /// <summary> Settles the calls the worker completed. </summary>
+    private settle(): void {
+        let completed = atomics.load(this._control, COMPLETED);
+        if (this._completed < completed) {
+            this._idlePolls = 0;
+        }
+        while (this._completed < completed) {
+            let slot = this._completed % this._slots;
+            let call = this._calls[slot];
+            this._calls[slot] = null;
+            ++this._completed;
+
+            let text = readSlot(this._control, this._data, slot, this._slotChars);
+            let status = this._control[HEADER_LENGTH + slot * 2 + 1];
+            if (status === STATUS_ERROR) {
+                call.reject(new Error(text));
+            } else if (status === STATUS_UNDEFINED) {
+                call.resolve(undefined);
+            } else {
+                call.resolve(JSON.parse(text));
+            }
+        }
+    }
+
+    /// <summary> Rejects the calls still in the ring once the worker stopped serving it. </summary>
+    private fail(error: any): void {
+        this._closed = true;
+        this.settle();
+        for (let i = 0; i < this._slots; i++) {
+            if (this._calls[i] != null) {
+                this._calls[i].reject(error);
+                this._calls[i] = null;
+            }
+        }
+        this.rejectBacklog(error);
+        this._completed = this._submitted;
+    }
+
+    /// <summary> Rejects the calls waiting for a slot. </summary>
+    private rejectBacklog(error: any): void {
+        for (let call of this._backlog.splice(0)) {
+            call.reject(error);
+        }
+    }
+
+    private _slots: number;
+    private _slotChars: number;
+    private _control: Int32Array;
+    private _data: Uint16Array;
+    private _calls: PendingCall[];
+    private _backlog: PendingCall[] = [];
+    private _submitted: number = 0;
+    private _completed: number = 0;
+    private _watching: boolean = false;
+    private _idlePolls: number = 0;
+    private _closed: boolean = false;
+    private _served: Promise<number>;
+}
+
+/// <summary> A call submitted to a ring, until its result is read. </summary>
+interface PendingCall {
+    text: string;
+    resolve: (value: any) => void;
+    reject: (error: any) => void;
+}
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as fs from 'fs';
+import * as transport from '../transport';
+import { log } from '../log';
+import { loadFunction } from './function-call';
+
+/// <summary> Read warm-up samples, each line is the JSON array of the marshalled arguments of a call. </summary>
+function readSamples(samplesFile: string): string[][] {
+    let samples: string[][] = [];
+    for (let line of fs.readFileSync(samplesFile).toString().split('\n')) {
+        line = line.trim();
+        if (line.length === 0) {
+            continue;
+        }
+        let sample = JSON.parse(line);
+        if (!Array.isArray(sample)) {
+            throw new Error(`A warm-up sample is not an array of arguments: ${line}`);
+        }
+        samples.push(sample);
+    }
+    return samples;
+}
+
+/// <summary>
+///     Warm up a worker by calling a function with the samples of a file, so the JIT optimizes it before the worker
+///     serves calls. It is run by the bootstrap script of each worker of a zone with warm-up settings.
+///     Arguments are unmarshalled for each call, so the function gets fresh arguments as real calls do.
+///     Promises the function returns are not waited for. Failures are logged and don't fail the bootstrap of the worker.
+/// </summary>
+/// <returns> The number of calls made. </returns>
+export function run(moduleName: string, functionName: string, samplesFile: string, iterations: number): number {
+    let calls = 0;
+    try {
+        let func = loadFunction(moduleName, functionName);
+
+        // Without samples yet, e.g. while they are recorded, the workers only load the function.
+        if (samplesFile == null || samplesFile.length === 0 || !fs.existsSync(samplesFile)) {
+            return 0;
+        }
+
+        let samples = readSamples(samplesFile);
+        let transportContext = transport.createTransportContext(true);
+        for (let i = 0; i < iterations; i++) {
+            for (let sample of samples) {
+                let args = sample.map((arg: string) => { return transport.unmarshall(arg, transportContext); });
+                let result = func.apply(null, args);
+                if (result != null && typeof result === 'object' && typeof result['then'] === 'function') {
+                    result.then(null, (): void => {});
+                }
+                calls++;
+            }
+        }
+    }
+    catch (error) {
+        log.warn('Zone', `Warm-up of '${functionName}' in '${moduleName}' stopped after ${calls} calls: ${error}`);
+    }
+    return calls;
+}
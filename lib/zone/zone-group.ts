@@ -0,0 +1,405 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as path from 'path';
+import * as zone from './zone';
+import * as v8 from '../v8';
+
+/// <summary> Describes the available settings of a zone group. </summary>
+export interface ZoneGroupSettings {
+
+    /// <summary>
+    ///     The number of calls the preferred member of a call, by routing key or locality, may have waiting beyond
+    ///     the least loaded member before the call goes to the least loaded member instead. Defaults to 16.
+    /// </summary>
+    routingImbalance?: number;
+}
+
+/// <summary> Default ZoneGroupSettings. </summary>
+export let DEFAULT_GROUP_SETTINGS: ZoneGroupSettings = {
+    routingImbalance: 16
+};
+
+/// <summary>
+///     Resolves a function's origin or a relative module name from the caller of the group,
+///     since the member zone is called one frame further away from it.
+/// </summary>
+function resolveFromCaller(target: any) : any {
+    // <caller> -> group method -> resolveFromCaller
+    //   2             1                 0
+    if (typeof target === 'function') {
+        if (target.origin == null) {
+            target.origin = v8.currentStack(3)[2].getFileName();
+        }
+        return target;
+    }
+    if (target != null && target.length != 0 && !path.isAbsolute(target)) {
+        return path.resolve(path.dirname(v8.currentStack(3)[2].getFileName()), target);
+    }
+    return target;
+}
+
+/// <summary> Hashes a routing key to 32 bits, strings with FNV-1a. </summary>
+function hashRoutingKey(key: string | number) : number {
+    if (typeof key === 'number') {
+        return Math.abs(Math.floor(key)) >>> 0;
+    }
+    let hash = 0x811c9dc5;
+    for (let i = 0; i < key.length; i++) {
+        hash = Math.imul(hash ^ key.charCodeAt(i), 0x01000193);
+    }
+    return hash >>> 0;
+}
+
+/// <summary>
+///     A zone made of member zones, i.e. one per NUMA node, which calls are spread over.
+///     A call goes to the member with the fewest waiting calls, unless it has a routing key, which sticks it to a member,
+///     or it's made from a worker of a member, which keeps it on that member; within the group's routingImbalance.
+///     Broadcasts run on all members, batches are split over members by their number of workers.
+/// </summary>
+/// <remarks>
+///     Worker ids of the group number the running workers of the members one member after another,
+///     so they shift when a member before scales.
+/// </remarks>
+export class ZoneGroup implements zone.Zone {
+
+    /// <summary> Constructor. </summary>
+    /// <param name="id"> The id of the group. </param>
+    /// <param name="members"> The member zones, at least one. </param>
+    /// <param name="settings"> The settings of the group. </param>
+    /// <param name="currentZoneId"> The id of the zone the group is created in, whose calls stay on it if it's a member. </param>
+    constructor(id: string, members: zone.Zone[], settings: ZoneGroupSettings = DEFAULT_GROUP_SETTINGS, currentZoneId?: string) {
+        if (members == null || members.length === 0) {
+            throw new Error("A zone group needs at least one member zone");
+        }
+        this._id = id;
+        this._members = members.slice();
+        this._routingImbalance = settings.routingImbalance != null ? settings.routingImbalance : DEFAULT_GROUP_SETTINGS.routingImbalance;
+        this._local = this._members.map((member: zone.Zone) => member.id).indexOf(currentZoneId);
+    }
+
+    public get id(): string {
+        return this._id;
+    }
+
+    /// <summary> The member zones. </summary>
+    public get members(): zone.Zone[] {
+        return this._members.slice();
+    }
+
+    public get queueLength(): number {
+        return this._members.reduce((total: number, member: zone.Zone) => total + member.queueLength, 0);
+    }
+
+    public get workerCount(): number {
+        return this._members.reduce((total: number, member: zone.Zone) => total + member.workerCount, 0);
+    }
+
+    public toJSON(): any {
+        return { id: this._id, type: 'group', members: this._members.map((member: zone.Zone) => member.id) };
+    }
+
+    public broadcast(arg1: any, arg2?: any, options?: zone.BroadcastOptions) : Promise<void> {
+        let func = typeof arg1 === 'function' ? resolveFromCaller(arg1) : arg1;
+        if (options == null || options.workers == null) {
+            return Promise.all(this._members.map((member: zone.Zone) => member.broadcast(func, arg2))).then(() => {});
+        }
+
+        let workers = this.splitWorkerIds(options.workers);
+        return Promise.all(this._members.map((member: zone.Zone, i: number) => member.broadcast(func, arg2, { workers: workers[i] })))
+            .then(() => {});
+    }
+
+    public broadcastSync(arg1: any, arg2?: any) : void {
+        let func = typeof arg1 === 'function' ? resolveFromCaller(arg1) : arg1;
+        for (let member of this._members) {
+            member.broadcastSync(func, arg2);
+        }
+    }
+
+    public execute(arg1: any, arg2?: any, arg3?: any, arg4?: any) : Promise<zone.Result> {
+        let target = resolveFromCaller(arg1);
+        return this.pick(typeof arg1 === 'function' ? arg3 : arg4).execute(target, arg2, arg3, arg4);
+    }
+
+    public executeOnWorker(workerId: number, arg1: any, arg2?: any, arg3?: any, arg4?: any) : Promise<zone.Result> {
+        let target = resolveFromCaller(arg1);
+        let offsets = this.getWorkerOffsets();
+        for (let i = this._members.length - 1; i >= 0; i--) {
+            if (workerId >= offsets[i]) {
+                return this._members[i].executeOnWorker(workerId - offsets[i], target, arg2, arg3, arg4);
+            }
+        }
+        return Promise.reject(`Worker ${workerId} is not a worker of zone group ${this._id}`);
+    }
+
+    public executeStream(arg1: any, arg2?: any, arg3?: any, arg4?: any) : zone.ResultStream {
+        let target = resolveFromCaller(arg1);
+        return this.pick(typeof arg1 === 'function' ? arg3 : arg4).executeStream(target, arg2, arg3, arg4);
+    }
+
+    public createStream(arg1: any, arg2?: any, arg3?: any) : zone.InputStream {
+        let target = resolveFromCaller(arg1);
+        return this.pick(typeof arg1 === 'function' ? arg2 : arg3).createStream(target, arg2, arg3);
+    }
+
+    public createRing(arg1: any, arg2?: any, arg3?: any) : zone.SubmissionRing {
+        let target = resolveFromCaller(arg1);
+        return this.pick().createRing(target, arg2, arg3);
+    }
+
+    public executeBatch(arg1: any, arg2: any, arg3?: any, arg4?: any) : Promise<zone.Result[]> {
+        let target = resolveFromCaller(arg1);
+        if (typeof arg1 === 'function') {
+            return this.split(arg2, (member: zone.Zone, argsList: any[][]) => member.executeBatch(target, argsList, arg3));
+        }
+        return this.split(arg3, (member: zone.Zone, argsList: any[][]) => member.executeBatch(target, arg2, argsList, arg4));
+    }
+
+    public pipe(stages: zone.PipelineStage[], args?: any[]) : Promise<zone.Result> {
+        let first = this.pick(stages.length !== 0 ? stages[0].options : undefined);
+        let resolved: zone.PipelineStage[] = [];
+        for (let stage of stages) {
+            resolved.push({
+                zone: stage.zone != null ? stage.zone : first,
+                module: typeof stage.function === 'function' ? stage.module : resolveFromCaller(stage.module),
+                function: typeof stage.function === 'function' ? resolveFromCaller(stage.function) : stage.function,
+                options: stage.options
+            });
+        }
+        return first.pipe(resolved, args);
+    }
+
+    public graph() : zone.Graph {
+        return this.pick().graph();
+    }
+
+    public map(items: ArrayLike<any>, func: (value: any, index: number) => any, options?: zone.DataParallelOptions) : Promise<any[]> {
+        // The function is given the index of each element in items, so items are mapped by a single member.
+        resolveFromCaller(func);
+        return this.pick(options).map(items, func, options);
+    }
+
+    public parallelFor(items: ArrayBufferView, func: (items: any, begin: number, end: number) => void, options?: zone.ParallelForOptions) : Promise<void> {
+        resolveFromCaller(func);
+        return this.pick(options).parallelFor(items, func, options);
+    }
+
+    public reduce(items: ArrayLike<any>, func: (previous: any, value: any) => any, initialValue?: any, options?: zone.DataParallelOptions) : Promise<any> {
+        resolveFromCaller(func);
+        let member = this.pick(options);
+        return arguments.length >= 3 ? member.reduce(items, func, initialValue, options) : member.reduce(items, func);
+    }
+
+    public getHeapStatistics() : Promise<zone.HeapStatistics[]> {
+        let offsets = this.getWorkerOffsets();
+        return Promise.all(this._members.map((member: zone.Zone) => member.getHeapStatistics()))
+            .then((statistics: zone.HeapStatistics[][]) => [].concat.apply([], statistics.map((list: zone.HeapStatistics[], i: number) =>
+                list.map((s: zone.HeapStatistics) => Object.assign({}, s, { workerId: s.workerId + offsets[i] })))));
+    }
+
+    public getStats() : zone.ZoneStats {
+        let offsets = this.getWorkerOffsets();
+        let pendingTasks = 0;
+        let workers: zone.WorkerStats[] = [];
+        let tenants: { [tenant: string]: any } = {};
+        let functions: { [name: string]: any } = {};
+        this._members.forEach((member: zone.Zone, i: number) => {
+            let stats = member.getStats();
+            pendingTasks += stats.pendingTasks;
+            for (let worker of stats.workers) {
+                workers.push(Object.assign({}, worker, { workerId: worker.workerId + offsets[i] }));
+            }
+            for (let tenant of stats.tenants) {
+                let total = tenants[tenant.tenant];
+                if (total == null) {
+                    tenants[tenant.tenant] = Object.assign({}, tenant);
+                } else {
+                    total.queuedTasks += tenant.queuedTasks;
+                    total.dispatchedTasks += tenant.dispatchedTasks;
+                    total.waitTime += tenant.waitTime;
+                    total.maxWaitTime = Math.max(total.maxWaitTime, tenant.maxWaitTime);
+                }
+            }
+            for (let counters of stats.functions) {
+                let total = functions[counters.function];
+                if (total == null) {
+                    functions[counters.function] = Object.assign({}, counters);
+                } else {
+                    total.calls += counters.calls;
+                    total.cycles += counters.cycles;
+                    total.instructions += counters.instructions;
+                    total.cacheReferences += counters.cacheReferences;
+                    total.cacheMisses += counters.cacheMisses;
+                    total.instructionsPerCycle = total.cycles === 0 ? 0 : total.instructions / total.cycles;
+                    total.cacheMissRate = total.cacheReferences === 0 ? 0 : total.cacheMisses / total.cacheReferences;
+                }
+            }
+        });
+        return {
+            pendingTasks: pendingTasks,
+            workers: workers,
+            tenants: Object.keys(tenants).map((tenant: string) => tenants[tenant]),
+            functions: Object.keys(functions).sort().map((name: string) => functions[name])
+        };
+    }
+
+    public getFunctionStats() : zone.FunctionStats[] {
+        // Keys sort by module, then function, as '\0' sorts first.
+        let functions: { [key: string]: any } = {};
+        for (let member of this._members) {
+            for (let stats of member.getFunctionStats()) {
+                let key = stats.module + '\0' + stats.function;
+                let total = functions[key];
+                if (total == null) {
+                    functions[key] = Object.assign({}, stats, { histogram: stats.histogram.map(bucket => Object.assign({}, bucket)) });
+                    continue;
+                }
+
+                total.calls += stats.calls;
+                total.errors += stats.errors;
+                total.totalTime += stats.totalTime;
+                total.maxTime = Math.max(total.maxTime, stats.maxTime);
+                total.averageTime = total.calls === 0 ? 0 : total.totalTime / total.calls;
+                for (let bucket of stats.histogram) {
+                    let totalBucket = total.histogram.filter((b: zone.FunctionStatsBucket) => b.upperBound === bucket.upperBound)[0];
+                    if (totalBucket == null) {
+                        total.histogram.push(Object.assign({}, bucket));
+                    } else {
+                        totalBucket.count += bucket.count;
+                    }
+                }
+                total.histogram.sort((a: zone.FunctionStatsBucket, b: zone.FunctionStatsBucket) => a.upperBound - b.upperBound);
+            }
+        }
+        return Object.keys(functions).sort().map((key: string) => functions[key]);
+    }
+
+    public notifyMemoryPressure(level: zone.MemoryPressureLevel) : void {
+        for (let member of this._members) {
+            member.notifyMemoryPressure(level);
+        }
+    }
+
+    public startProfiling(workerIds: number[] = [], samplingIntervalUs: number = 0) : void {
+        if (workerIds.length === 0) {
+            this._members.forEach((member: zone.Zone) => member.startProfiling([], samplingIntervalUs));
+            return;
+        }
+
+        // Members given no worker would profile all of theirs.
+        let workers = this.splitWorkerIds(workerIds);
+        this._members.forEach((member: zone.Zone, i: number) => {
+            if (workers[i].length !== 0) {
+                member.startProfiling(workers[i], samplingIntervalUs);
+            }
+        });
+    }
+
+    public stopProfiling() : Promise<zone.CpuProfile[]> {
+        let offsets = this.getWorkerOffsets();
+        return Promise.all(this._members.map((member: zone.Zone) => member.stopProfiling()))
+            .then((profiles: zone.CpuProfile[][]) => [].concat.apply([], profiles.map((list: zone.CpuProfile[], i: number) =>
+                list.map((p: zone.CpuProfile) => ({ workerId: p.workerId + offsets[i], profile: p.profile })))));
+    }
+
+    public recycle() : Promise<void> {
+        return Promise.all(this._members.map((member: zone.Zone) => member.recycle())).then(() => {});
+    }
+
+    /// <summary> Returns the member a call with the options goes to, i.e. for a stage of a pipeline on the group. </summary>
+    public select(options?: zone.CallOptions) : zone.Zone {
+        return this.pick(options);
+    }
+
+    /// <summary> Returns the member a call goes to. </summary>
+    private pick(options?: zone.CallOptions) : zone.Zone {
+        let count = this._members.length;
+        if (count === 1) {
+            return this._members[0];
+        }
+
+        // Members are visited from a rotating start, so idle members take calls in turns.
+        let start = this._next;
+        this._next = (this._next + 1) % count;
+        let lengths = this._members.map((member: zone.Zone) => member.queueLength);
+        let least = start;
+        for (let i = 1; i < count; i++) {
+            let index = (start + i) % count;
+            if (lengths[index] < lengths[least]) {
+                least = index;
+            }
+        }
+
+        let preferred = this._local;
+        if (options != null && options.routingKey != null) {
+            preferred = hashRoutingKey(options.routingKey) % count;
+        }
+        if (preferred >= 0 && lengths[preferred] <= lengths[least] + this._routingImbalance) {
+            return this._members[preferred];
+        }
+        return this._members[least];
+    }
+
+    /// <summary> Returns the group worker id of the first worker of each member. </summary>
+    private getWorkerOffsets() : number[] {
+        let offsets: number[] = [];
+        let offset = 0;
+        for (let member of this._members) {
+            offsets.push(offset);
+            offset += member.workerCount;
+        }
+        return offsets;
+    }
+
+    /// <summary> Splits group worker ids into the worker ids of each member. </summary>
+    private splitWorkerIds(workerIds: number[]) : number[][] {
+        let offsets = this.getWorkerOffsets();
+        let counts = this._members.map((member: zone.Zone) => member.workerCount);
+        return this._members.map((member: zone.Zone, i: number) => workerIds
+            .filter((id: number) => id >= offsets[i] && id < offsets[i] + counts[i])
+            .map((id: number) => id - offsets[i]));
+    }
+
+    /// <summary> Splits [0, length) into consecutive slices, one per member with workers, sized by their number of workers. </summary>
+    private sliceByWorkers(length: number) : { member: zone.Zone, begin: number, end: number }[] {
+        let counts = this._members.map((member: zone.Zone) => Math.max(member.workerCount, 0));
+        let total = counts.reduce((sum: number, count: number) => sum + count, 0);
+        if (total === 0 || length === 0) {
+            return [{ member: this._members[0], begin: 0, end: length }];
+        }
+
+        let slices: { member: zone.Zone, begin: number, end: number }[] = [];
+        let begin = 0;
+        let workers = 0;
+        this._members.forEach((member: zone.Zone, i: number) => {
+            workers += counts[i];
+            let end = Math.round(length * workers / total);
+            if (end > begin) {
+                slices.push({ member: member, begin: begin, end: end });
+                begin = end;
+            }
+        });
+        return slices;
+    }
+
+    /// <summary> Runs a batch in slices on the members, and joins their results in order. </summary>
+    private split(argsList: any[][], run: (member: zone.Zone, argsList: any[][]) => Promise<zone.Result[]>) : Promise<zone.Result[]> {
+        if (argsList == null || argsList.length === 0) {
+            return run(this.pick(), argsList);
+        }
+        let slices = this.sliceByWorkers(argsList.length);
+        return Promise.all(slices.map((slice) => run(slice.member, argsList.slice(slice.begin, slice.end))))
+            .then((parts: zone.Result[][]) => [].concat.apply([], parts));
+    }
+
+    private _id: string;
+    private _members: zone.Zone[];
+    private _routingImbalance: number;
+
+    /// <summary> The index of the member the group was created in, -1 if it wasn't created in a member. </summary>
+    private _local: number;
+
+    /// <summary> The member the next pick starts from. </summary>
+    private _next: number = 0;
+}
@@ -5,6 +5,11 @@ import * as path from 'path';
 import * as zone from './zone';
 import * as transport from '../transport';
 import * as v8 from '../v8';
+import * as sync from '../sync';
+import { ResultStream } from './result-stream';
+import { InputStream } from './input-stream';
+import { SubmissionRing } from './submission-ring';
+import { ZoneGroup } from './zone-group';
 
 interface FunctionSpec {
     module: string;
@@ -14,22 +19,35 @@ interface FunctionSpec {
     transportContext: transport.TransportContext;
 }
 
+interface BatchSpec {
+    module: string;
+    function: string;
+    arguments: any[][];
+    options: zone.CallOptions;
+    transportContexts: transport.TransportContext[];
+}
+
 class Result implements zone.Result{
 
-     constructor(payload: string, transportContext: transport.TransportContext) {
+     constructor(payload: string | ArrayBuffer, transportContext: transport.TransportContext, timing?: zone.CallTiming) {
           this._payload = payload;
           this._transportContext = transportContext; 
+          this._timing = timing;
      }
 
+     /// <summary> Unmarshalled on first access, so results that are only passed through are never parsed. </summary>
      get value(): any {
-         if (this._value == null) {
-             this._value = transport.unmarshall(this._payload, this._transportContext);
+         if (!this._unmarshalled) {
+             this._value = this._payload instanceof ArrayBuffer ?
+                 transport.unmarshallBinary(this._payload, this._transportContext)
+                 : transport.unmarshall(this._payload, this._transportContext);
+             this._unmarshalled = true;
          }
 
          return this._value;
      }
 
-     get payload(): string {
+     get payload(): string | ArrayBuffer {
          return this._payload; 
      }
 
@@ -37,13 +55,27 @@ class Result implements zone.Result{
          return this._transportContext; 
      }
 
+     get timing(): zone.CallTiming {
+         return this._timing;
+     }
+
      private _transportContext: transport.TransportContext;
-     private _payload: string;
+     private _payload: string | ArrayBuffer;
      private _value: any;
+     private _unmarshalled: boolean = false;
+     private _timing: zone.CallTiming;
 };
 
 declare var __in_napa: boolean;
 
+/// <summary> Whether all arguments of a call are marshalled into one ArrayBuffer. </summary>
+function isBinary(options: zone.CallOptions): boolean {
+    return options != null && options.transport === zone.TransportOption.BINARY;
+}
+
+/// <summary> Error message of calls that were cancelled before they were made. </summary>
+const CANCELLED_MESSAGE = "The request was cancelled";
+
 /// <summary> Helper function to workaround possible delay in Promise resolve/reject when working with Node event loop.
 /// See https://github.com/audreyt/node-webworker-threads/issues/123#issuecomment-254019552
 /// </summary>
@@ -57,7 +89,91 @@ function runImmediately(func : () => void) {
     }
 }
 
+/// <summary> Module exporting the function transport API, which workers load to preload functions. </summary>
+const TRANSPORT_MODULE = path.resolve(__dirname, '../transport');
+
+/// <summary> Module exporting the chunk functions of map and reduce, which workers load to run chunks. </summary>
+const DATA_PARALLEL_MODULE = path.resolve(__dirname, './data-parallel');
+
+/// <summary> Module exporting the producer side of executeStream, which workers load to stream results. </summary>
+const RESULT_STREAM_MODULE = path.resolve(__dirname, './result-stream');
+
+/// <summary> Module exporting the worker side of createRing. </summary>
+const SUBMISSION_RING_MODULE = path.resolve(__dirname, './submission-ring');
+
+/// <summary> Default number and bytes of the slots of a submission ring. </summary>
+const DEFAULT_RING_SLOTS = 64;
+const DEFAULT_RING_SLOT_SIZE = 4096;
+
+/// <summary> Returns the zone a stage or a task runs on, the member a zone group picks for it. </summary>
+function memberOf(target: zone.Zone, options: zone.CallOptions): zone.Zone {
+    return target instanceof ZoneGroup ? target.select(options) : target;
+}
+
+/// <summary> Values a streaming worker sends ahead of the caller by default. </summary>
+const DEFAULT_STREAM_CAPACITY = 16;
+
+/// <summary> Whether a typed array can be shared with the workers instead of copied. </summary>
+function isShared(items: ArrayLike<any>): boolean {
+    return ArrayBuffer.isView(items)
+        && Object.prototype.toString.call((<ArrayBufferView><any>items).buffer) === '[object SharedArrayBuffer]';
+}
+
+/// <summary> Copies a range of elements, typed arrays are copied into a typed array of the range only. </summary>
+function slice(items: ArrayLike<any>, begin: number, end: number): ArrayLike<any> {
+    let sliceable = <any>items;
+    return typeof sliceable.slice === 'function' ? sliceable.slice(begin, end) : Array.prototype.slice.call(items, begin, end);
+}
+
+/// <summary> Hashes of the anonymous functions already distributed to the workers of each zone. </summary>
+let _distributedFunctions = new Map<string, Set<string>>();
+
 /// <summary> Zone consists of Napa isolates. </summary>
+/// <summary> A task graph of a zone, whose tasks are turned into calls each time it runs. </summary>
+class GraphImpl implements zone.Graph {
+
+    constructor(zone: ZoneImpl) {
+        this._zone = zone;
+    }
+
+    public task(name: string, task: zone.GraphTask) : zone.Graph {
+        if (this._names.indexOf(name) >= 0) {
+            throw new Error(`Task "${name}" is already in the graph`);
+        }
+
+        // Functions and relative modules are resolved from the caller of task, the graph runs them from elsewhere.
+        // <caller> -> task
+        //   1          0
+        let func: any = task.function;
+        if (typeof func === 'function' && func.origin == null) {
+            func.origin = v8.currentStack(2)[1].getFileName();
+        }
+        let moduleName = task.module;
+        if (moduleName != null && moduleName.length != 0 && !path.isAbsolute(moduleName)) {
+            moduleName = path.resolve(path.dirname(v8.currentStack(2)[1].getFileName()), moduleName);
+        }
+
+        this._names.push(name);
+        this._tasks.push({
+            zone: task.zone,
+            module: moduleName,
+            function: task.function,
+            args: task.args,
+            dependsOn: task.dependsOn,
+            options: task.options
+        });
+        return this;
+    }
+
+    public run() : Promise<{ [name: string]: zone.Result }> {
+        return this._zone.runGraph(this._names, this._tasks);
+    }
+
+    private _zone: ZoneImpl;
+    private _names: string[] = [];
+    private _tasks: zone.GraphTask[] = [];
+}
+
 export class ZoneImpl implements zone.Zone {
     private _nativeZone: any;
 
@@ -69,12 +185,28 @@ export class ZoneImpl implements zone.Zone {
         return this._nativeZone.getId();
     }
 
+    public get queueLength(): number {
+        return this._nativeZone.getQueueLength();
+    }
+
+    public get workerCount(): number {
+        return this._nativeZone.getWorkerCount();
+    }
+
     public toJSON(): any {
         return { id: this.id, type: this.id === 'node'? 'node': 'napa' };
     }
 
-    public broadcast(arg1: any, arg2?: any) : Promise<void> {
+    public broadcast(arg1: any, arg2?: any, options?: zone.BroadcastOptions) : Promise<void> {
         let spec: FunctionSpec = this.createBroadcastRequest(arg1, arg2);
+        // An empty list of workers targets none of them, no list targets all of them.
+        let workerIds: number[] = [];
+        if (options != null && options.workers != null) {
+            if (options.workers.length === 0) {
+                return Promise.resolve();
+            }
+            workerIds = options.workers;
+        }
 
         return new Promise<void>((resolve, reject) => {
             this._nativeZone.broadcast(spec, (result: any) => {
@@ -85,7 +217,7 @@ export class ZoneImpl implements zone.Zone {
                         reject(result.errorMessage);
                     }
                 });
-            });
+            }, workerIds);
         });
     }
 
@@ -99,6 +231,44 @@ export class ZoneImpl implements zone.Zone {
 
     public execute(arg1: any, arg2?: any, arg3?: any, arg4?: any) : Promise<zone.Result> {
         let spec : FunctionSpec = this.createExecuteRequest(arg1, arg2, arg3, arg4);
+        return this.executeRequest(spec);
+    }
+
+    public executeStream(arg1: any, arg2?: any, arg3?: any, arg4?: any) : zone.ResultStream {
+        let spec : FunctionSpec = this.createExecuteRequest(arg1, arg2, arg3, arg4);
+        let options: zone.StreamOptions = spec.options;
+        let capacity = options.capacity != null && options.capacity > 0 ? options.capacity : DEFAULT_STREAM_CAPACITY;
+        let channel = sync.createChannel(capacity);
+        if (isBinary(options)) {
+            channel.close();
+            return new ResultStream(channel, Promise.reject("TransportOption.BINARY is not supported by executeStream"));
+        }
+
+        // The call returns the number of values sent, which is neither worth caching nor sharing with identical calls.
+        let callOptions: zone.CallOptions = {};
+        for (let key of Object.keys(options)) {
+            if (key !== 'cache' && key !== 'coalesce') {
+                (<any>callOptions)[key] = (<any>options)[key];
+            }
+        }
+
+        // The worker resolves the function the caller gave from the arguments that precede its own.
+        spec.arguments = [
+            transport.marshall(channel, spec.transportContext),
+            transport.marshall(spec.module, null),
+            transport.marshall(spec.function, null)
+        ].concat(spec.arguments);
+        spec.module = RESULT_STREAM_MODULE;
+        spec.function = 'streamResult';
+        spec.options = callOptions;
+        return new ResultStream(channel, this.executeRequest(spec));
+    }
+
+    /// <summary> Makes a call of execute or executeStream. </summary>
+    private executeRequest(spec: FunctionSpec) : Promise<zone.Result> {
+        if (!this.listenForCancellation(spec.options)) {
+            return Promise.reject(CANCELLED_MESSAGE);
+        }
         
         return new Promise<zone.Result>((resolve, reject) => {
             this._nativeZone.execute(spec, (result: any) => {
@@ -106,7 +276,8 @@ export class ZoneImpl implements zone.Zone {
                     if (result.code === 0) {
                         resolve(new Result(
                             result.returnValue,
-                            transport.createTransportContext(true, result.contextHandle)));
+                            transport.createTransportContext(true, result.contextHandle),
+                            result.timing));
                     } else {
                         reject(result.errorMessage);
                     }
@@ -115,6 +286,385 @@ export class ZoneImpl implements zone.Zone {
         });
     }
 
+    public executeOnWorker(workerId: number, arg1: any, arg2?: any, arg3?: any, arg4?: any) : Promise<zone.Result> {
+        let spec : FunctionSpec = this.createExecuteRequest(arg1, arg2, arg3, arg4);
+        if (!this.listenForCancellation(spec.options)) {
+            return Promise.reject(CANCELLED_MESSAGE);
+        }
+
+        return new Promise<zone.Result>((resolve, reject) => {
+            this._nativeZone.executeOnWorker(workerId, spec, (result: any) => {
+                runImmediately(() => {
+                    if (result.code === 0) {
+                        resolve(new Result(
+                            result.returnValue,
+                            transport.createTransportContext(true, result.contextHandle),
+                            result.timing));
+                    } else {
+                        reject(result.errorMessage);
+                    }
+                })
+            });
+        });
+    }
+
+    public executeBatch(arg1: any, arg2: any, arg3?: any, arg4?: any) : Promise<zone.Result[]> {
+        let spec : BatchSpec = this.createExecuteBatchRequest(arg1, arg2, arg3, arg4);
+        if (!this.listenForCancellation(spec.options)) {
+            return Promise.reject(CANCELLED_MESSAGE);
+        }
+
+        return new Promise<zone.Result[]>((resolve, reject) => {
+            this._nativeZone.executeBatch(spec, (results: any[]) => {
+                runImmediately(() => {
+                    let values = results.map((result: any) => new Result(
+                        result.returnValue,
+                        transport.createTransportContext(true, result.contextHandle),
+                        result.timing));
+
+                    for (let result of results) {
+                        if (result.code !== 0) {
+                            reject(result.errorMessage);
+                            return;
+                        }
+                    }
+                    resolve(values);
+                })
+            });
+        });
+    }
+
+    public createStream(arg1: any, arg2?: any, arg3?: any) : zone.InputStream {
+        // Items are called from the stream, so the function and a relative module are resolved from the caller here.
+        // <caller> -> createStream
+        //   1            0
+        let options: zone.InputStreamOptions;
+        let call: (item: any) => Promise<zone.Result>;
+        if (typeof arg1 === 'function') {
+            if (arg1.origin == null) {
+                arg1.origin = v8.currentStack(2)[1].getFileName();
+            }
+            options = arg2;
+            call = (item: any) => this.execute(arg1, [item], options);
+        } else {
+            let moduleName: string = arg1;
+            if (moduleName != null && moduleName.length != 0 && !path.isAbsolute(moduleName)) {
+                moduleName = path.resolve(path.dirname(v8.currentStack(2)[1].getFileName()), moduleName);
+            }
+            options = arg3;
+            call = (item: any) => this.execute(moduleName, arg2, [item], options);
+        }
+
+        let workers = Math.max(this.workerCount, 1);
+        let concurrency = options != null && options.concurrency > 0 ? options.concurrency : workers;
+        return new InputStream(call, () => this.queueLength, {
+            concurrency: concurrency,
+            capacity: options != null && options.capacity > 0 ? options.capacity : concurrency,
+            maxQueueLength: options != null && options.maxQueueLength > 0 ? options.maxQueueLength : workers,
+            ordered: options == null || options.ordered !== false
+        });
+    }
+
+    public createRing(arg1: any, arg2?: any, arg3?: any) : zone.SubmissionRing {
+        // The node zone would wait for calls on the thread submitting them.
+        if (this.id === 'node') {
+            throw new Error('createRing is not supported by the node zone');
+        }
+
+        // Resolves the function and a relative module from the caller, like execute.
+        let options: zone.RingOptions = typeof arg1 === 'function' ? arg2 : arg3;
+        let target: FunctionSpec = typeof arg1 === 'function'
+            ? this.createExecuteRequest(arg1, [])
+            : this.createExecuteRequest(arg1, arg2, []);
+
+        let slots = options != null && options.slots > 0 ? Math.floor(options.slots) : DEFAULT_RING_SLOTS;
+        let slotSize = options != null && options.slotSize > 0 ? options.slotSize : DEFAULT_RING_SLOT_SIZE;
+        return new SubmissionRing(slots, slotSize, (control: Int32Array, data: Uint16Array) =>
+            this.execute(SUBMISSION_RING_MODULE, 'serveRing', [control, data, target.module, target.function]));
+    }
+
+    public pipe(stages: zone.PipelineStage[], args?: any[]) : Promise<zone.Result> {
+        let nativeStages: any[] = [];
+        for (let i = 0; i < stages.length; i++) {
+            let stage = stages[i];
+            let stageZone = stage.zone != null ? <ZoneImpl>memberOf(stage.zone, stage.options) : this;
+            if (isBinary(stage.options)) {
+                return Promise.reject("TransportOption.BINARY is not supported in pipelines");
+            }
+
+            // Only the first stage has marshalled arguments, the others are given the result of their previous stage.
+            let spec : FunctionSpec = typeof stage.function === 'function' ?
+                stageZone.createExecuteRequest(stage.function, i === 0 ? args : [], stage.options)
+                : stageZone.createExecuteRequest(stage.module != null ? stage.module : "", stage.function, i === 0 ? args : [], stage.options);
+            if (i > 0) {
+                spec.transportContext = null;
+            }
+            if (!stageZone.listenForCancellation(spec.options)) {
+                return Promise.reject(CANCELLED_MESSAGE);
+            }
+            nativeStages.push({ zoneId: stageZone.id, spec: spec });
+        }
+
+        return new Promise<zone.Result>((resolve, reject) => {
+            this._nativeZone.pipe(nativeStages, (result: any) => {
+                runImmediately(() => {
+                    if (result.code === 0) {
+                        resolve(new Result(
+                            result.returnValue,
+                            transport.createTransportContext(true, result.contextHandle),
+                            result.timing));
+                    } else {
+                        reject(result.errorMessage);
+                    }
+                })
+            });
+        });
+    }
+
+    public graph() : zone.Graph {
+        return new GraphImpl(this);
+    }
+
+    /// <summary> Runs the tasks of a graph, called by Graph.run. </summary>
+    public runGraph(names: string[], tasks: zone.GraphTask[]) : Promise<{ [name: string]: zone.Result }> {
+        let indices: { [name: string]: number } = {};
+        names.forEach((name: string, i: number) => { indices[name] = i; });
+
+        let nativeTasks: any[] = [];
+        for (let i = 0; i < tasks.length; i++) {
+            let task = tasks[i];
+            let taskZone = task.zone != null ? <ZoneImpl>memberOf(task.zone, task.options) : this;
+            if (isBinary(task.options)) {
+                return Promise.reject("TransportOption.BINARY is not supported in graphs");
+            }
+
+            let dependencies: number[] = [];
+            for (let dependency of (task.dependsOn != null ? task.dependsOn : [])) {
+                if (!indices.hasOwnProperty(dependency)) {
+                    return Promise.reject(`Task "${names[i]}" depends on task "${dependency}" which is not in the graph`);
+                }
+                dependencies.push(indices[dependency]);
+            }
+
+            let spec : FunctionSpec = typeof task.function === 'function' ?
+                taskZone.createExecuteRequest(task.function, task.args, task.options)
+                : taskZone.createExecuteRequest(task.module != null ? task.module : "", task.function, task.args, task.options);
+            if (!taskZone.listenForCancellation(spec.options)) {
+                return Promise.reject(CANCELLED_MESSAGE);
+            }
+            nativeTasks.push({ zoneId: taskZone.id, name: names[i], spec: spec, dependencies: dependencies });
+        }
+
+        return new Promise<{ [name: string]: zone.Result }>((resolve, reject) => {
+            this._nativeZone.runGraph(nativeTasks, (results: any[]) => {
+                runImmediately(() => {
+                    let values: { [name: string]: zone.Result } = {};
+                    for (let i = 0; i < results.length; i++) {
+                        let result = results[i];
+                        if (result.code !== 0) {
+                            reject(result.errorMessage);
+                            return;
+                        }
+                        values[names[i]] = new Result(
+                            result.returnValue,
+                            transport.createTransportContext(true, result.contextHandle),
+                            result.timing);
+                    }
+                    resolve(values);
+                })
+            });
+        });
+    }
+
+    public map(items: ArrayLike<any>, func: (value: any, index: number) => any, options?: zone.DataParallelOptions) : Promise<any[]> {
+        if (items.length === 0) {
+            return Promise.resolve([]);
+        }
+
+        let argsList = this.createChunks(items, this.saveFunction(func, true), options, true);
+        return this.executeBatch(DATA_PARALLEL_MODULE, 'mapChunk', argsList, options)
+            .then((results: zone.Result[]) => [].concat.apply([], results.map((result: zone.Result) => result.value)));
+    }
+
+    public parallelFor(items: ArrayBufferView, func: (items: any, begin: number, end: number) => void, options?: zone.ParallelForOptions) : Promise<void> {
+        if (!isShared(items)) {
+            return Promise.reject(new TypeError('parallelFor needs a typed array on a SharedArrayBuffer'));
+        }
+        if (isBinary(options)) {
+            return Promise.reject("TransportOption.BINARY is not supported by parallelFor");
+        }
+
+        let length = (<ArrayLike<any>><any>items).length;
+        if (length === 0) {
+            return Promise.resolve();
+        }
+
+        let grain = options != null ? options.grain : undefined;
+        if (grain == null || grain <= 0) {
+            grain = Math.ceil(length / Math.max(this.workerCount, 1));
+        }
+
+        // The typed array is marshalled once, the native zone appends the bounds of each range to the arguments.
+        let spec : FunctionSpec = this.createExecuteRequest(DATA_PARALLEL_MODULE, 'forRange', [this.saveFunction(func, true), items], options);
+        if (!this.listenForCancellation(spec.options)) {
+            return Promise.reject(CANCELLED_MESSAGE);
+        }
+
+        return new Promise<void>((resolve, reject) => {
+            this._nativeZone.parallelFor(spec, length, grain, (result: any) => {
+                runImmediately(() => {
+                    if (result.code === 0) {
+                        resolve();
+                    } else {
+                        reject(result.errorMessage);
+                    }
+                });
+            });
+        });
+    }
+
+    public reduce(items: ArrayLike<any>, func: (previous: any, value: any) => any, initialValue?: any, options?: zone.DataParallelOptions) : Promise<any> {
+        let hasInitialValue = arguments.length >= 3;
+        if (items.length === 0) {
+            return hasInitialValue ? Promise.resolve(initialValue) : Promise.reject(new TypeError('Reduce of empty array with no initial value'));
+        }
+
+        // Chunks are reduced from their first element, the initial value is only applied once.
+        let argsList = this.createChunks(items, this.saveFunction(func, true), options, false);
+        return this.executeBatch(DATA_PARALLEL_MODULE, 'reduceChunk', argsList, options)
+            .then((results: zone.Result[]) => {
+                let values = results.map((result: zone.Result) => result.value);
+                return hasInitialValue ? values.reduce(func, initialValue) : values.reduce(func);
+            });
+    }
+
+    /// <summary> Splits elements into the argument lists of chunk calls of map or reduce. </summary>
+    /// <remarks>
+    ///     By default there is one chunk per worker. A zone with calls waiting gets half as many larger chunks,
+    ///     its workers are busy and more chunks would only add marshalling.
+    /// </remarks>
+    private createChunks(items: ArrayLike<any>, hash: string, options: zone.DataParallelOptions, withBase: boolean) : any[][] {
+        let chunkSize = options != null ? options.chunkSize : undefined;
+        if (chunkSize == null || chunkSize <= 0) {
+            let workerCount = Math.max(this.workerCount, 1);
+            let chunkCount = this.queueLength >= workerCount ? Math.ceil(workerCount / 2) : workerCount;
+            chunkSize = Math.ceil(items.length / chunkCount);
+        }
+
+        // Typed arrays on a SharedArrayBuffer are passed whole, each chunk works on its range.
+        let shared = isShared(items);
+        let argsList: any[][] = [];
+        for (let begin = 0; begin < items.length; begin += chunkSize) {
+            let end = Math.min(begin + chunkSize, items.length);
+            let args = shared ?
+                [hash, items, begin, end]
+                : [hash, slice(items, begin, end), 0, end - begin];
+            if (withBase) {
+                args.push(shared ? 0 : begin);
+            }
+            argsList.push(args);
+        }
+        return argsList;
+    }
+
+    public getHeapStatistics() : Promise<zone.HeapStatistics[]> {
+        return new Promise<zone.HeapStatistics[]>((resolve) => {
+            this._nativeZone.getHeapStatistics((statistics: zone.HeapStatistics[]) => {
+                runImmediately(() => {
+                    resolve(statistics);
+                });
+            });
+        });
+    }
+
+    public getStats() : zone.ZoneStats {
+        return this._nativeZone.getStats();
+    }
+
+    public getFunctionStats() : zone.FunctionStats[] {
+        return this._nativeZone.getFunctionStats();
+    }
+
+    public notifyMemoryPressure(level: zone.MemoryPressureLevel) : void {
+        this._nativeZone.notifyMemoryPressure(level);
+    }
+
+    public startProfiling(workerIds: number[] = [], samplingIntervalUs: number = 0) : void {
+        this._nativeZone.startProfiling(workerIds, samplingIntervalUs);
+    }
+
+    public stopProfiling() : Promise<zone.CpuProfile[]> {
+        return new Promise<zone.CpuProfile[]>((resolve) => {
+            this._nativeZone.stopProfiling((profiles: zone.CpuProfile[]) => {
+                runImmediately(() => {
+                    resolve(profiles);
+                });
+            });
+        });
+    }
+
+    public recycle() : Promise<void> {
+        return new Promise<void>((resolve, reject) => {
+            this._nativeZone.recycle((code: number, message: string) => {
+                runImmediately(() => {
+                    if (code === 0) {
+                        resolve();
+                    } else {
+                        reject(new Error(message));
+                    }
+                });
+            });
+        });
+    }
+
+    /// <summary> Forwards the cancellation of the call's token to this zone, returns false if it is already cancelled. </summary>
+    private listenForCancellation(options: zone.CallOptions) : boolean {
+        let token = options.cancellationToken;
+        if (token == null) {
+            return true;
+        }
+        if (token.cancelled) {
+            return false;
+        }
+
+        token.onCancel(this.id, () => {
+            this._nativeZone.cancel(token.id);
+        });
+        return true;
+    }
+
+    /// <summary> Save an anonymous function, and on its first save for this zone, have all workers load it ahead of its calls. </summary>
+    /// <remarks> Broadcasting functions already loads them on all workers, so they are only marked as distributed. </remarks>
+    private saveFunction(func: (...args: any[]) => any, preload: boolean) : string {
+        let hash = transport.saveFunction(func);
+
+        let id = this.id;
+        let distributed = _distributedFunctions.get(id);
+        if (distributed == null) {
+            distributed = new Set<string>();
+            _distributedFunctions.set(id, distributed);
+        }
+        if (distributed.has(hash)) {
+            return hash;
+        }
+        distributed.add(hash);
+
+        // Node zone runs on a single isolate, where a call loads the function as early as a preload would.
+        if (preload && id !== 'node') {
+            let spec: FunctionSpec = {
+                module: TRANSPORT_MODULE,
+                function: "preloadFunction",
+                arguments: [transport.marshall(hash, null)],
+                options: zone.DEFAULT_CALL_OPTIONS,
+                transportContext: null
+            };
+
+            // A failed preload is not an error, the call loads the function itself.
+            this._nativeZone.broadcast(spec, (result: any) => {});
+        }
+        return hash;
+    }
+
     private createBroadcastRequest(arg1: any, arg2?: any) : FunctionSpec {
         if (typeof arg1 === "function") {
             // broadcast with function
@@ -126,7 +676,7 @@ export class ZoneImpl implements zone.Zone {
             }
             return {
                 module: "__function",
-                function: transport.saveFunction(arg1),
+                function: this.saveFunction(arg1, false),
                 arguments: (arg2 == null
                            ? []
                            : (<Array<any>>arg2).map(arg => transport.marshall(arg, null))),
@@ -161,7 +711,7 @@ export class ZoneImpl implements zone.Zone {
                 arg1.origin = v8.currentStack(3)[2].getFileName();
             }
 
-            functionName = transport.saveFunction(arg1);
+            functionName = this.saveFunction(arg1, true);
             args = arg2;
             options = arg3;
         }
@@ -187,12 +737,80 @@ export class ZoneImpl implements zone.Zone {
 
         // Create a non-owning transport context which will be passed to execute call.
         let transportContext: transport.TransportContext = transport.createTransportContext(false);
+        let transferList = options != null ? options.transferList : undefined;
+        let marshalledArgs = isBinary(options) ?
+            [transport.marshallBinary(args, transportContext, transferList)]
+            : (<Array<any>>args).map(arg => transport.marshall(arg, transportContext, transferList));
+        transport.detach(transferList);
+
         return {
             module: moduleName,
             function: functionName,
-            arguments: (<Array<any>>args).map(arg => transport.marshall(arg, transportContext)),
+            arguments: marshalledArgs,
             options: options != null? options: zone.DEFAULT_CALL_OPTIONS,
             transportContext: transportContext
         };
     }
-}
\ No newline at end of file
+
+    private createExecuteBatchRequest(arg1: any, arg2: any, arg3?: any, arg4?: any) : BatchSpec {
+
+        let moduleName: string = null;
+        let functionName: string = null;
+        let argsList: any[][] = null;
+        let options: zone.CallOptions = undefined;
+
+        if (typeof arg1 === 'function') {
+            moduleName = "__function";
+            if (arg1.origin == null) {
+                // We get caller stack at index 2.
+                // <caller> -> executeBatch -> createExecuteBatchRequest
+                //   2           1                    0
+                arg1.origin = v8.currentStack(3)[2].getFileName();
+            }
+
+            functionName = this.saveFunction(arg1, true);
+            argsList = arg2;
+            options = arg3;
+        }
+        else {
+            moduleName = arg1;
+            // If module name is relative path, try to deduce from call site.
+            if (moduleName != null 
+                && moduleName.length != 0 
+                && !path.isAbsolute(moduleName)) {
+
+                moduleName = path.resolve(
+                    path.dirname(v8.currentStack(3)[2].getFileName()), 
+                    moduleName);
+            }
+            functionName = arg2;
+            argsList = arg3;
+            options = arg4;
+        }
+
+        if (argsList == null) {
+            argsList = [];
+        }
+
+        // Each call gets its own non-owning transport context, like a single execute call.
+        let transportContexts: transport.TransportContext[] = [];
+        let transferList = options != null ? options.transferList : undefined;
+        let marshalledArgsList: any[][] = argsList.map((args: any[]) => {
+            let transportContext = transport.createTransportContext(false);
+            transportContexts.push(transportContext);
+            if (isBinary(options)) {
+                return [transport.marshallBinary(args == null ? [] : args, transportContext, transferList)];
+            }
+            return (args == null ? [] : args).map(arg => transport.marshall(arg, transportContext, transferList));
+        });
+        transport.detach(transferList);
+
+        return {
+            module: moduleName,
+            function: functionName,
+            arguments: marshalledArgsList,
+            options: options != null? options: zone.DEFAULT_CALL_OPTIONS,
+            transportContexts: transportContexts
+        };
+    }
+}
@@ -6,8 +6,235 @@ import * as transport from "../transport";
 /// <summary> Describes the available settings for customizing a zone. </summary>
 export interface ZoneSettings {
 
-    /// <summary> The number of workers that will serve zone requests. </summary>
-    workers?: number;
+    /// <summary>
+    ///     The number of workers that will serve zone requests.
+    ///     'auto' for one per logical CPU, 'physical' for one per physical core, within cpuSet and numaNode when given.
+    /// </summary>
+    workers?: number | 'auto' | 'physical';
+
+    /// <summary> The minimum number of workers when the zone scales, defaults to workers. </summary>
+    minWorkers?: number;
+
+    /// <summary>
+    ///     The maximum number of workers when the zone scales, defaults to workers.
+    ///     Workers are started when calls queue up and retired when they stay idle.
+    /// </summary>
+    maxWorkers?: number;
+
+    /// <summary> Time in milliseconds an idle worker is kept before it is retired. </summary>
+    workerIdleTimeout?: number;
+
+    /// <summary> The number of waiting calls per starting worker that triggers starting another worker. </summary>
+    scaleUpQueueDepth?: number;
+
+    /// <summary> The number of calls a worker runs before it is replaced by a new worker, 0 (default) to never recycle. </summary>
+    maxTasksPerWorker?: number;
+
+    /// <summary> The used heap size in megabytes a worker reaches before it is replaced by a new worker, 0 (default) to never recycle. </summary>
+    maxHeapBeforeRecycle?: number;
+
+    /// <summary>
+    ///     A worker whose heap gets near its limit fails its waiting calls with NAPA_RESULT_HEAP_LIMIT_REACHED
+    ///     and is replaced by a new worker, instead of V8 aborting the process. Default is false.
+    /// </summary>
+    recycleOnHeapLimit?: boolean;
+
+    /// <summary>
+    ///     Time in milliseconds a worker runs a task before it's considered stuck, the calls waiting for it then go to
+    ///     other workers. 0 (default) to never check.
+    /// </summary>
+    stuckWorkerThreshold?: number;
+
+    /// <summary> Terminate the task of a stuck worker and replace the worker by a new one. </summary>
+    recycleStuckWorkers?: boolean;
+
+    /// <summary> The size in megabytes of the cache of results of calls made with CallOptions.cache, 0 to never cache. Default is 16. </summary>
+    resultCacheSize?: number;
+
+    /// <summary> Time in microseconds an idle worker spins before it yields. </summary>
+    idleSpinTime?: number;
+
+    /// <summary> Time in microseconds an idle worker yields before it parks. </summary>
+    idleYieldTime?: number;
+
+    /// <summary> Idle workers never park, which burns CPU for the lowest wake up latency. </summary>
+    lowLatency?: boolean;
+
+    /// <summary> Time in milliseconds an idle worker lets V8 collect garbage before it parks, 0 (default) to let V8 decide. </summary>
+    idleGcTime?: number;
+
+    /// <summary>
+    ///     Garbage collection trade-off of the workers, 'default', 'latency', 'throughput' or 'memory'.
+    ///     It sets the young generation size of the workers and idleGcTime, unless idleGcTime is given as well.
+    /// </summary>
+    gcProfile?: string;
+
+    /// <summary>
+    ///     When workers run the microtasks of promises, 'auto' (default) for V8 to run them after each call,
+    ///     or 'batched' to run them after microtaskBatchSize calls or microtaskTimeSlice microseconds.
+    /// </summary>
+    microtaskPolicy?: string;
+
+    /// <summary> Number of calls a worker runs between runs of microtasks, for the 'batched' microtaskPolicy. Default is 32. </summary>
+    microtaskBatchSize?: number;
+
+    /// <summary> Time in microseconds a worker runs calls between runs of microtasks, for the 'batched' microtaskPolicy. Default is 1000. </summary>
+    microtaskTimeSlice?: number;
+
+    /// <summary>
+    ///     How tasks are dispatched to workers, 'synchronized' (default), 'lockFree' or 'workStealing'.
+    ///     'lockFree' lets callers hand tasks to idle workers directly instead of going through a synchronizer thread.
+    ///     'workStealing' additionally keeps one pending queue per worker, idle workers steal from busy peers.
+    /// </summary>
+    scheduler?: string;
+
+    /// <summary> Logical CPUs the workers can run on, like '0-3,8' or [0, 1, 2, 3]. </summary>
+    cpuSet?: string | number[];
+
+    /// <summary> The NUMA node to place the workers on. </summary>
+    numaNode?: number;
+
+    /// <summary> Pin each worker to a distinct physical core. </summary>
+    pinWorkersToCores?: boolean;
+
+    /// <summary>
+    ///     The scheduling priority of the worker threads, 'high', 'normal' (default), 'low' or 'background'.
+    ///     Workers of background zones run on the CPU time interactive zones leave.
+    /// </summary>
+    threadPriority?: string;
+
+    /// <summary> The allocator native modules get for the zone, 'default' (default), 'crt' or 'pool'. </summary>
+    allocator?: string;
+
+    /// <summary> The chunk size in bytes of each worker's task arena for request scoped native data, defaults to 64KB. </summary>
+    taskArenaChunkSize?: number;
+
+    /// <summary> The maximum number of calls waiting for a worker, 0 for no limit. </summary>
+    maxQueueLength?: number;
+
+    /// <summary> What happens to a new call when the queue is full, 'reject' (default), 'block' or 'dropOldest'. </summary>
+    overloadPolicy?: string;
+
+    /// <summary> The number of routed calls that may wait for a busy worker before they go to any worker. </summary>
+    routingImbalance?: number;
+
+    /// <summary>
+    ///     Weights of the tenants sharing the queue, like { gold: 4, silver: 2 } or 'gold:4,silver:2'.
+    ///     Waiting calls of different tenants are dispatched in turns, each tenant as many calls per turn as its weight.
+    ///     Tenants without a weight have a weight of 1. Requires the 'synchronized' scheduler.
+    /// </summary>
+    tenantWeights?: string | { [tenant: string]: number };
+
+    /// <summary>
+    ///     Maximum number of calls per second the zone accepts, calls over the rate fail at once with NAPA_RESULT_RATE_LIMITED.
+    ///     A burst of a second of calls passes after a quiet second. By default 0, for no limit.
+    /// </summary>
+    rateLimit?: number;
+
+    /// <summary>
+    ///     Maximum numbers of calls per second of tenants, like { gold: 100, '*': 10 } or 'gold:100,*:10'.
+    ///     '*' applies to each tenant without its own rate, calls of the default tenant are only limited by rateLimit.
+    /// </summary>
+    tenantRateLimits?: string | { [tenant: string]: number };
+
+    /// <summary>
+    ///     Highest adaptive limit of calls zone.execute has in flight, calls over the limit fail at once with NAPA_RESULT_ZONE_OVERLOADED.
+    ///     The limit starts at the number of workers and follows the latency of calls. By default 0, for no limit.
+    /// </summary>
+    maxConcurrency?: number;
+
+    /// <summary>
+    ///     The number of tenants per worker whose calls run in a context of their own, with their own globals and
+    ///     modules, while sharing the worker's thread and isolate. 0 (default) to run all calls in the worker's context.
+    /// </summary>
+    tenantContexts?: number;
+
+    /// <summary>
+    ///     The number of calls a worker may have in flight, i.e. returned a promise that is still pending,
+    ///     before it takes new calls. 0 (default) for no limit.
+    /// </summary>
+    maxInFlightPerWorker?: number;
+
+    /// <summary>
+    ///     The milliseconds a call may run past its timeout before its worker is terminated, so it can stop
+    ///     by itself after checking napa.zone.checkDeadline(). 0 (default) terminates on timeout.
+    /// </summary>
+    timeoutGracePeriod?: number;
+
+    /// <summary>
+    ///     The milliseconds a call runs before its JavaScript stack is captured and logged as a slow call.
+    ///     0 (default) to disable.
+    /// </summary>
+    slowTaskThreshold?: number;
+
+    /// <summary>
+    ///     Each worker reads the CPU cycles, instructions and cache misses of its calls from the hardware counters,
+    ///     which zone.getStats() reports by function. Defaults to false.
+    /// </summary>
+    hardwareCounters?: boolean;
+
+    /// <summary> The maximum number of threads running asynchronous works of native modules, defaults to 4. </summary>
+    asyncWorkers?: number;
+
+    /// <summary>
+    ///     Each worker runs a libuv event loop between tasks, for native modules doing asynchronous I/O.
+    ///     It requires Napa built with NAPA_WORKER_EVENT_LOOP, defaults to false.
+    /// </summary>
+    eventLoop?: boolean;
+
+    /// <summary>
+    ///     Milliseconds JavaScript timers of the workers may fire late, so a worker wakes up once for timers due close together.
+    ///     0 (default) fires each timer on time.
+    /// </summary>
+    timerSlack?: number;
+
+    /// <summary> Fire intervals on multiples of their period, so intervals of a period fire together. Defaults to false. </summary>
+    alignedIntervals?: boolean;
+
+    /// <summary>
+    ///     Load JavaScript modules wrapped in a function in the worker's context like node.js, instead of a context per module.
+    ///     It saves memory and load time for applications with many modules, modules then share the same globals.
+    /// </summary>
+    sharedModuleContext?: boolean;
+
+    /// <summary>
+    ///     Resolve and read the modules a module requires with string literals on the async work pool, while it loads,
+    ///     so a cold start of a deep dependency tree doesn't wait on the disk one module at a time. Defaults to false.
+    /// </summary>
+    modulePrefetch?: boolean;
+
+    /// <summary> Path of a script that is run once into a V8 startup snapshot, workers start with its globals defined. </summary>
+    startupScript?: string;
+
+    /// <summary> Path of the V8 startup snapshot file, it is created from startupScript when it doesn't exist. </summary>
+    startupSnapshot?: string;
+
+    /// <summary> Path of a module bundle written by napa.runtime.writeModuleBundle, modules are then loaded from it. </summary>
+    bundle?: string;
+
+    /// <summary>
+    ///     Modules each worker loads on bootstrap, before it serves calls. A relative path is resolved from the caller
+    ///     of napa.zone.create.
+    /// </summary>
+    preload?: string[];
+
+    /// <summary>
+    ///     The module of a function each worker calls with the warm-up samples before it serves calls, so the JIT
+    ///     optimizes the function first. A relative path is resolved from the caller of napa.zone.create.
+    /// </summary>
+    warmupModule?: string;
+
+    /// <summary> The function of warmupModule each worker calls with the warm-up samples. </summary>
+    warmupFunction?: string;
+
+    /// <summary> Path of the warm-up samples, one JSON array of the marshalled arguments of a call per line. </summary>
+    warmupSamples?: string;
+
+    /// <summary> The number of times each worker calls the warm-up function with each sample. Default is 100. </summary>
+    warmupIterations?: number;
+
+    /// <summary> Path of a file the arguments of the first 1000 calls of the warm-up function are recorded into as samples. </summary>
+    warmupRecord?: string;
 }
 
 /// <summary> Default ZoneSettings </summary>
@@ -28,6 +255,63 @@ export enum TransportOption {
 
     /// <summary> transport.marshall/unmarshall will be done by user manually. </summary>
     MANUAL,
+
+    /// <summary>
+    ///     Arguments and the return value are serialized as a whole into bytes by V8's ValueSerializer.
+    ///     It is faster than AUTO for large values, but instances of JavaScript Transportable classes lose their classes.
+    /// </summary>
+    BINARY,
+}
+
+/// <summary>
+///     Withdraws the calls it was passed to, like an AbortSignal. Calls still waiting for a worker are dropped,
+///     running calls are terminated, and both are rejected. Calls made after cancel() are rejected right away.
+/// </summary>
+export class CancellationToken {
+
+    constructor() {
+        // Tokens are passed across workers and zones, so ids are drawn at random rather than counted per isolate.
+        this._id = Math.floor(Math.random() * (Number.MAX_SAFE_INTEGER - 1)) + 1;
+    }
+
+    /// <summary> The numeric token that identifies the calls in a zone. </summary>
+    get id(): number {
+        return this._id;
+    }
+
+    /// <summary> Whether cancel() was called. </summary>
+    get cancelled(): boolean {
+        return this._cancelled;
+    }
+
+    /// <summary> Cancels the calls made with this token. </summary>
+    cancel(): void {
+        if (this._cancelled) {
+            return;
+        }
+        this._cancelled = true;
+
+        let listeners = this._listeners;
+        this._listeners = {};
+        for (let key of Object.keys(listeners)) {
+            listeners[key]();
+        }
+    }
+
+    /// <summary> Registers a listener that is called once on cancel(), a listener is registered once per key. </summary>
+    /// <param name="key"> The key of the listener, like the id of the zone that needs to be notified. </param>
+    /// <param name="listener"> The listener. </param>
+    onCancel(key: string, listener: () => void): void {
+        if (this._cancelled) {
+            listener();
+        } else if (this._listeners[key] == null) {
+            this._listeners[key] = listener;
+        }
+    }
+
+    private _id: number;
+    private _cancelled: boolean = false;
+    private _listeners: { [key: string]: () => void } = {};
 }
 
 /// <summary> Represent the options of calling a function. </summary>
@@ -37,7 +321,98 @@ export interface CallOptions {
     timeout?: number,
 
     /// <summary> Transport option on passing arguments. By default set to TransportOption.AUTO </summary>
-    transport?: TransportOption
+    transport?: TransportOption,
+
+    /// <summary> Scheduling priority, higher priority calls are dispatched first when all workers are busy. By default set to 0. </summary>
+    priority?: number,
+
+    /// <summary>
+    ///     Absolute deadline in milliseconds since Unix epoch (like Date.now()). By default set to 0 for no deadline.
+    ///     A call that hasn't started by its deadline is rejected with a timeout error without running.
+    /// </summary>
+    deadline?: number,
+
+    /// <summary>
+    ///     Calls with the same routing key prefer the same worker, so state cached in worker globals stays warm.
+    ///     By default calls are not routed.
+    /// </summary>
+    routingKey?: string | number,
+
+    /// <summary>
+    ///     The tenant the call is made for. Waiting calls of different tenants are dispatched in turns, as often as the
+    ///     zone's tenantWeights, so a tenant flooding the zone doesn't starve the others. By default the default tenant.
+    /// </summary>
+    tenant?: string | number,
+
+    /// <summary> Token to withdraw the call with. By default calls can't be cancelled. </summary>
+    cancellationToken?: CancellationToken,
+
+    /// <summary>
+    ///     ArrayBuffers in the arguments to move to the callee instead of copying.
+    ///     They are detached from the caller once the call is made. By default all ArrayBuffers are copied.
+    /// </summary>
+    transferList?: ArrayBuffer[],
+
+    /// <summary> Whether Result.timing carries the time spent in each phase of the call. By default set to false. </summary>
+    recordTiming?: boolean,
+
+    /// <summary> Whether the worker collects garbage right after the call returns. By default set to false. </summary>
+    collectGarbage?: boolean,
+
+    /// <summary>
+    ///     Caches the result of a pure function, so identical calls within ttlMs return it without running.
+    ///     Results are keyed by module, function and key, or the marshalled arguments without a key.
+    ///     Only napa zone calls made by execute are cached. By default results are not cached.
+    /// </summary>
+    cache?: { key?: string | number, ttlMs: number },
+
+    /// <summary>
+    ///     Whether the call joins an identical call in flight and receives its result instead of running.
+    ///     Calls are identical like for cache. Only napa zone calls made by execute coalesce. By default set to false.
+    /// </summary>
+    coalesce?: boolean,
+
+    /// <summary>
+    ///     Whether the call ignores the deadline of the zone call it's made from. By default set to false,
+    ///     a call made while a zone call runs is limited to what is left of that call's deadline and timeout.
+    /// </summary>
+    detachDeadline?: boolean,
+
+    /// <summary>
+    ///     Marshalled arguments and return values of at least this many bytes are compressed while they wait in queues.
+    ///     By default set to 0, which never compresses. Binary transport is never compressed.
+    /// </summary>
+    compressionThreshold?: number,
+
+    /// <summary>
+    ///     The trace the call continues, i.e. from zone.getTraceContext() before an await, or of a request traced by
+    ///     another service. By default a call made while a zone call runs continues its trace, other calls begin a
+    ///     new trace, which is sampled by runtime.setSpanSampling.
+    /// </summary>
+    trace?: TraceContext
+}
+
+/// <summary> The trace and span of a zone call, which the calls it makes and the logs it writes carry. </summary>
+export interface TraceContext {
+
+    /// <summary> The trace of the request the call serves, 16 hex digits. </summary>
+    traceId: string;
+
+    /// <summary> The span of the call, 16 hex digits. Calls continuing the trace are its children. </summary>
+    spanId: string;
+
+    /// <summary> Whether spans of the trace are recorded. </summary>
+    sampled: boolean;
+}
+
+/// <summary> Represent the options of broadcasting a function. </summary>
+export interface BroadcastOptions {
+
+    /// <summary>
+    ///     The ids of the workers to run the function, they run it again when they restart.
+    ///     By default all workers run it.
+    /// </summary>
+    workers?: number[]
 }
 
 /// <summary> Default execution options. </summary>
@@ -47,20 +422,385 @@ export let DEFAULT_CALL_OPTIONS: CallOptions = {
     timeout: 0,
 
     /// <summary> Set argument transport option to automatic. </summary>
-    transport: TransportOption.AUTO
+    transport: TransportOption.AUTO,
+
+    /// <summary> Normal priority. </summary>
+    priority: 0,
+
+    /// <summary> No deadline. </summary>
+    deadline: 0
+}
+
+/// <summary> Time in nanoseconds a call spent in each phase, 0 for phases it didn't reach. </summary>
+export interface CallTiming {
+
+    /// <summary> From the call being made until a worker dispatched it. </summary>
+    readonly queue: number;
+
+    /// <summary> From the dispatch until the function started, which includes loading it and unmarshalling the arguments. </summary>
+    readonly unmarshall: number;
+
+    /// <summary> From the function starting until it returned, or its returned promise settled. </summary>
+    readonly execute: number;
+
+    /// <summary> From the function returning until the call finished, which includes marshalling the result. </summary>
+    readonly marshall: number;
+}
+
+/// <summary> An argument passed to a function marked by zone.lazyArgs. </summary>
+export interface LazyArgument {
+
+    /// <summary> The marshalled argument, which can be passed on without parsing it. </summary>
+    readonly payload: string;
+
+    /// <summary> The unmarshalled argument, unmarshalled on first access and then cached. </summary>
+    readonly value: any;
 }
 
 /// <summary> Represent the result of an execute call. </summary>
 export interface Result {
 
-    /// <summary> The unmarshalled result value. </summary>
+    /// <summary> The unmarshalled result value, unmarshalled on first access and then cached. </summary>
     readonly value : any;
 
-    /// <summary> A marshalled result. </summary>
-    readonly payload : string;
+    /// <summary> A marshalled result, or an ArrayBuffer of serialized bytes for TransportOption.BINARY. </summary>
+    readonly payload : string | ArrayBuffer;
 
     /// <summary> Transport context carries additional information needed to unmarshall. </summary>
     readonly transportContext : transport.TransportContext;
+
+    /// <summary> Time spent in each phase of the call, only set for napa zone calls made with CallOptions.recordTiming. </summary>
+    readonly timing? : CallTiming;
+}
+
+/// <summary> V8 heap statistics of a zone worker, in bytes. </summary>
+export interface HeapStatistics {
+
+    /// <summary> The id of the worker. </summary>
+    readonly workerId: number;
+
+    /// <summary> Heap reserved by V8. </summary>
+    readonly totalHeapSize: number;
+
+    /// <summary> Heap reserved for executable code. </summary>
+    readonly totalHeapSizeExecutable: number;
+
+    /// <summary> Heap backed by physical memory. </summary>
+    readonly totalPhysicalSize: number;
+
+    /// <summary> What V8 can still allocate before reaching the heap size limit. </summary>
+    readonly totalAvailableSize: number;
+
+    /// <summary> Heap used by objects. </summary>
+    readonly usedHeapSize: number;
+
+    /// <summary> The heap size limit of the worker. </summary>
+    readonly heapSizeLimit: number;
+
+    /// <summary> Memory V8 allocated with malloc. </summary>
+    readonly mallocedMemory: number;
+
+    /// <summary> The most memory V8 allocated with malloc. </summary>
+    readonly peakMallocedMemory: number;
+}
+
+/// <summary> Utilization counters of a zone worker since it started. </summary>
+export interface WorkerStats {
+
+    /// <summary> The id of the worker. </summary>
+    readonly workerId: number;
+
+    /// <summary> Milliseconds spent running calls, broadcasts and timers. </summary>
+    readonly busyTime: number;
+
+    /// <summary> Milliseconds spent waiting for calls, not counting the current wait of an idle worker. </summary>
+    readonly idleTime: number;
+
+    /// <summary> The number of tasks the worker ran. </summary>
+    readonly executedTasks: number;
+
+    /// <summary> The number of tasks queued on the worker. </summary>
+    readonly queuedTasks: number;
+
+    /// <summary> The number of immediate tasks queued on the worker, which run ahead of its other queued tasks. </summary>
+    readonly queuedImmediateTasks: number;
+}
+
+/// <summary> Utilization counters of a zone and its running workers. </summary>
+export interface ZoneStats {
+
+    /// <summary> The number of calls waiting in the zone for an idle worker. </summary>
+    readonly pendingTasks: number;
+
+    /// <summary> The counters of each running worker, ordered by worker id. Empty for the node zone. </summary>
+    readonly workers: WorkerStats[];
+
+    /// <summary> The counters of each tenant whose calls waited for an idle worker. Empty for the node zone. </summary>
+    readonly tenants: TenantStats[];
+
+    /// <summary>
+    ///     The hardware counters of each function called, ordered by function.
+    ///     Empty unless the zone has the hardwareCounters setting and the counters can be read.
+    /// </summary>
+    readonly functions: FunctionCounters[];
+}
+
+/// <summary> Counters of the calls of a tenant that waited in a zone for an idle worker. </summary>
+export interface TenantStats {
+
+    /// <summary> The tenant name from tenantWeights, its key for other tenants, or '' for the default tenant. </summary>
+    readonly tenant: string;
+
+    /// <summary> The number of calls of the tenant waiting for an idle worker. </summary>
+    readonly queuedTasks: number;
+
+    /// <summary> The number of calls of the tenant that waited and were dispatched. </summary>
+    readonly dispatchedTasks: number;
+
+    /// <summary> Milliseconds the dispatched calls waited in total. </summary>
+    readonly waitTime: number;
+
+    /// <summary> Milliseconds the longest dispatched call waited. </summary>
+    readonly maxWaitTime: number;
+}
+
+/// <summary> Hardware counters of the calls of a function, summed over the workers of a zone. </summary>
+export interface FunctionCounters {
+
+    /// <summary> 'module.function', or the function name for functions of the global scope. </summary>
+    readonly function: string;
+
+    /// <summary> The number of calls counted. </summary>
+    readonly calls: number;
+
+    /// <summary> CPU cycles the calls ran in user mode. </summary>
+    readonly cycles: number;
+
+    /// <summary> Instructions the calls retired in user mode. </summary>
+    readonly instructions: number;
+
+    /// <summary> Last level cache references of the calls. </summary>
+    readonly cacheReferences: number;
+
+    /// <summary> Last level cache misses of the calls. </summary>
+    readonly cacheMisses: number;
+
+    /// <summary> Instructions per cycle, 0 without cycles. </summary>
+    readonly instructionsPerCycle: number;
+
+    /// <summary> Cache misses per cache reference, 0 without cache references. </summary>
+    readonly cacheMissRate: number;
+}
+
+/// <summary> Statistics of the calls of a function that ran in a zone. </summary>
+export interface FunctionStats {
+
+    /// <summary> The module of the function, '' for functions of the global scope. </summary>
+    readonly module: string;
+
+    /// <summary> The function name. </summary>
+    readonly function: string;
+
+    /// <summary> The number of calls that finished after a worker dispatched them. </summary>
+    readonly calls: number;
+
+    /// <summary> The number of those calls that were rejected, i.e. threw, timed out or were cancelled. </summary>
+    readonly errors: number;
+
+    /// <summary> Milliseconds from dispatch to result, summed over the calls. </summary>
+    readonly totalTime: number;
+
+    /// <summary> Milliseconds from dispatch to result of the longest call. </summary>
+    readonly maxTime: number;
+
+    /// <summary> Milliseconds from dispatch to result per call, on average. </summary>
+    readonly averageTime: number;
+
+    /// <summary> The number of calls by execution time, for the buckets with calls, by increasing upper bound. </summary>
+    readonly histogram: FunctionStatsBucket[];
+}
+
+/// <summary> A bucket of the execution time histogram of a function. </summary>
+export interface FunctionStatsBucket {
+
+    /// <summary>
+    ///     Milliseconds the calls of the bucket ran under, and at least half as long except in the first bucket.
+    ///     Buckets are powers of 2 microseconds, the last bucket ends at Infinity.
+    /// </summary>
+    readonly upperBound: number;
+
+    /// <summary> The number of calls in the bucket. </summary>
+    readonly count: number;
+}
+
+/// <summary> Options of zone.map and zone.reduce, the call options apply to every chunk. </summary>
+export interface DataParallelOptions extends CallOptions {
+
+    /// <summary> The number of elements per chunk, by default chosen from the number of workers and the queue length. </summary>
+    chunkSize?: number;
+}
+
+/// <summary> Options of zone.executeStream, the call options apply to the whole stream. </summary>
+export interface StreamOptions extends CallOptions {
+
+    /// <summary> The number of values the worker sends ahead of the caller before it waits, defaults to 16. </summary>
+    capacity?: number;
+}
+
+/// <summary> The values a function yields in a worker, received as the caller reads them. </summary>
+/// <remarks> It's an async iterator, which `for await` takes where the runtime has Symbol.asyncIterator. </remarks>
+export interface ResultStream {
+
+    /// <summary> Receives the next value, rejected if the function failed. </summary>
+    next(): Promise<IteratorResult<any>>;
+
+    /// <summary> Stops reading, the worker stops producing at its next value. </summary>
+    return(): Promise<IteratorResult<any>>;
+}
+
+/// <summary> Options of zone.createRing. </summary>
+export interface RingOptions {
+
+    /// <summary> The number of calls in flight in the ring, more wait on the Node side for a free slot. Defaults to 64. </summary>
+    slots?: number;
+
+    /// <summary> The bytes of a slot, which hold the JSON of the arguments of a call, then of its result. Defaults to 4096. </summary>
+    slotSize?: number;
+}
+
+/// <summary> Calls to a zone written into the slots of a SharedArrayBuffer, which a worker of the zone serves. </summary>
+export interface SubmissionRing {
+
+    /// <summary> The number of calls submitted whose results were not read yet. </summary>
+    readonly pending: number;
+
+    /// <summary> Calls the function of the ring. </summary>
+    /// <param name="args"> The arguments, which have to fit the slot as JSON. </param>
+    /// <returns> A promise of the return value, rejected with the message of the error the function threw. </returns>
+    submit(...args: any[]): Promise<any>;
+
+    /// <summary> Closes the ring, calls waiting for a slot are rejected and calls in the slots are still served. </summary>
+    /// <returns> A promise of the number of calls served, once the worker left the ring. </returns>
+    close(): Promise<number>;
+}
+
+/// <summary> Options of zone.createStream, the call options apply to the call of each item. </summary>
+export interface InputStreamOptions extends CallOptions {
+
+    /// <summary> The number of items called at the same time, defaults to the number of workers. </summary>
+    concurrency?: number;
+
+    /// <summary> Whether results are yielded in the order of the items, or as they complete. Defaults to true. </summary>
+    ordered?: boolean;
+
+    /// <summary> The number of results waiting to be read before writes wait, defaults to concurrency. </summary>
+    capacity?: number;
+
+    /// <summary> The number of calls waiting for a worker of the zone from which writes wait, defaults to the number of workers. </summary>
+    maxQueueLength?: number;
+}
+
+/// <summary> Items fed to zone workers one call each, with bounded work in flight, whose results are read as an async iterator. </summary>
+export interface InputStream {
+
+    /// <summary> Writes an item, which is called once the stream has room. </summary>
+    /// <returns> A promise resolved once the item is called, rejected if the stream failed or was closed. </returns>
+    write(item: any): Promise<void>;
+
+    /// <summary> Ends the stream, the results of the items written so far can be read. </summary>
+    end(): void;
+
+    /// <summary> Reads the next result, rejected with the error of the first item that failed. </summary>
+    next(): Promise<IteratorResult<any>>;
+
+    /// <summary> Stops reading, pending writes are rejected and results of calls in flight are dropped. </summary>
+    return(): Promise<IteratorResult<any>>;
+}
+
+/// <summary> Options of zone.parallelFor, the call options apply to every range. </summary>
+export interface ParallelForOptions extends CallOptions {
+
+    /// <summary> The number of elements per range, by default the elements are split evenly over the workers. </summary>
+    grain?: number;
+}
+
+/// <summary> A function call of a pipeline, which takes the result of the previous stage as its single argument. </summary>
+export interface PipelineStage {
+
+    /// <summary> The zone the function runs on, by default the zone the pipeline starts on. </summary>
+    zone?: Zone;
+
+    /// <summary> The module that exports the function, empty for a function that was broadcast. </summary>
+    module?: string;
+
+    /// <summary> The function name, or the JS function to execute. </summary>
+    function: string | ((...args: any[]) => any);
+
+    /// <summary> Call options of the stage, defaults to DEFAULT_CALL_OPTIONS. TransportOption.BINARY is not supported. </summary>
+    options?: CallOptions;
+}
+
+/// <summary> A function call of a task graph, which takes its arguments followed by the results of its dependencies. </summary>
+export interface GraphTask {
+
+    /// <summary> The zone the function runs on, by default the zone the graph was created on. </summary>
+    zone?: Zone;
+
+    /// <summary> The module that exports the function, empty for a function that was broadcast. </summary>
+    module?: string;
+
+    /// <summary> The function name, or the JS function to execute. </summary>
+    function: string | ((...args: any[]) => any);
+
+    /// <summary> The arguments of the function, before the results of its dependencies. </summary>
+    args?: any[];
+
+    /// <summary> The names of the tasks whose results are passed to the function, in the order of its arguments. </summary>
+    dependsOn?: string[];
+
+    /// <summary> Call options of the task, defaults to DEFAULT_CALL_OPTIONS. TransportOption.BINARY is not supported. </summary>
+    options?: CallOptions;
+}
+
+/// <summary> Tasks and their dependencies, run by native code as soon as the tasks they depend on have succeeded. </summary>
+export interface Graph {
+
+    /// <summary> Adds a task to the graph. </summary>
+    /// <param name="name"> The name of the task, unique in the graph. </param>
+    /// <param name="task"> The function call of the task. </param>
+    /// <returns> The graph, to chain the tasks. </returns>
+    task(name: string, task: GraphTask) : Graph;
+
+    /// <summary> Runs the tasks of the graph, each as soon as its dependencies have succeeded. </summary>
+    /// <returns> A promise of the results by task name, rejected if any task failed or the graph has a cycle. </returns>
+    /// <remarks>
+    ///     Results are passed from task to task in native code, marshalled as they are, without going through Node.
+    ///     Tasks depending on a failed task are not executed. A graph can run more than once.
+    /// </remarks>
+    run() : Promise<{ [name: string]: Result }>;
+}
+
+/// <summary> CPU profile recorded by a zone worker. </summary>
+export interface CpuProfile {
+
+    /// <summary> The id of the worker. </summary>
+    readonly workerId: number;
+
+    /// <summary> The profile in the .cpuprofile JSON format, which Chrome DevTools loads. </summary>
+    readonly profile: string;
+}
+
+/// <summary> Represent how urgently zone workers should release memory. </summary>
+export enum MemoryPressureLevel {
+
+    /// <summary> Memory pressure is over, workers go back to their usual collections. </summary>
+    NONE,
+
+    /// <summary> Workers collect garbage more eagerly. </summary>
+    MODERATE,
+
+    /// <summary> Workers collect all the garbage they can, right away. </summary>
+    CRITICAL,
 }
 
 /// <summary>
@@ -83,6 +823,12 @@ export interface Zone {
     /// <summary> The zone id. </summary>
     readonly id: string;
 
+    /// <summary> The number of calls that are waiting for a worker. </summary>
+    readonly queueLength: number;
+
+    /// <summary> The number of running workers, 1 for the node zone. </summary>
+    readonly workerCount: number;
+
     /// <summary> Compiles and run the provided source code on all zone workers. </summary>
     /// <param name="source"> A valid javascript source code. </param>
     /// <returns> A promise which is resolved when broadcast completes, and rejected when failed. </returns>
@@ -101,8 +847,9 @@ export interface Zone {
     ///     Broadcast is designed for the purpose of bootstrapping/changing internal state on all workers.
     ///     Function broadcast returns a promise of void, telling whether the operation succeeded or failed.
     ///     Promise will be rejected on failure from any worker, though most likely all workers will fail if one fails.
+    ///     With options.workers only the given workers run it, i.e. to roll out a new config in stages.
     /// </remarks>
-    broadcast(func: (...args: any[]) => void | Promise<void>, args?: any[]) : Promise<void>;
+    broadcast(func: (...args: any[]) => void | Promise<void>, args?: any[], options?: BroadcastOptions) : Promise<void>;
 
     /// <summary> Compiles and run the provided source code on all zone workers synchronously. </summary>
     /// <param name="source"> A valid javascript source code. </param>
@@ -138,5 +885,164 @@ export interface Zone {
     /// <param name="options"> Call options, defaults to DEFAULT_CALL_OPTIONS. </param>
     /// <returns> A promise of result which is resolved when execute completes, and rejected when failed. </returns>
     execute(func: (...args: any[]) => any, args?: any[], options?: CallOptions) : Promise<Result>;
+
+    /// <summary> Executes the function on a given zone worker, for workloads sharded by worker. </summary>
+    /// <param name="workerId"> The id of the worker, from 0 to workers - 1. </param>
+    /// <param name="module"> The module name that contains the function to execute. </param>
+    /// <param name="func"> The function name to execute. </param>
+    /// <param name="args"> The arguments that will pass to the function. </param>
+    /// <param name="options"> Call options, defaults to DEFAULT_CALL_OPTIONS. </param>
+    /// <returns> A promise of result which is resolved when execute completes, and rejected when failed. </returns>
+    /// <remarks>
+    ///     The call waits behind the other tasks of the worker and is never taken by another worker.
+    ///     It is rejected if the worker is not running. Queue depth per worker is in getStats().workers[].queuedTasks.
+    /// </remarks>
+    executeOnWorker(workerId: number, module: string, func: string, args?: any[], options?: CallOptions) : Promise<Result>;
+
+    /// <summary> Executes the function on a given zone worker, for workloads sharded by worker. </summary>
+    /// <param name="workerId"> The id of the worker, from 0 to workers - 1. </param>
+    /// <param name="func"> The JS function to execute. </param>
+    /// <param name="args"> The arguments that will pass to the function. </param>
+    /// <param name="options"> Call options, defaults to DEFAULT_CALL_OPTIONS. </param>
+    /// <returns> A promise of result which is resolved when execute completes, and rejected when failed. </returns>
+    executeOnWorker(workerId: number, func: (...args: any[]) => any, args?: any[], options?: CallOptions) : Promise<Result>;
+
+    /// <summary> Executes a function returning an iterable on one of the zone workers, and streams its values to the caller. </summary>
+    /// <param name="module"> The module name that contains the function to execute. </param>
+    /// <param name="func"> The function name to execute, which returns an iterable, an async iterable, or a promise of either. </param>
+    /// <param name="args"> The arguments that will pass to the function. </param>
+    /// <param name="options"> The channel capacity, and the call options of the stream. </param>
+    /// <returns> An async iterator of the values, in the order the function yields them. </returns>
+    /// <remarks>
+    ///     Values are marshalled one by one through a bounded channel, so neither side holds the whole result,
+    ///     and the worker waits without blocking while the caller is `capacity` values behind.
+    ///     A timeout applies to the whole stream. TransportOption.BINARY, cache and coalesce are not supported.
+    /// </remarks>
+    executeStream(module: string, func: string, args?: any[], options?: StreamOptions) : ResultStream;
+
+    /// <summary> Executes a function returning an iterable on one of the zone workers, and streams its values to the caller. </summary>
+    /// <param name="func"> The JS function to execute, which returns an iterable, an async iterable, or a promise of either. </param>
+    /// <param name="args"> The arguments that will pass to the function. </param>
+    /// <param name="options"> The channel capacity, and the call options of the stream. </param>
+    /// <returns> An async iterator of the values, in the order the function yields them. </returns>
+    executeStream(func: (...args: any[]) => any, args?: any[], options?: StreamOptions) : ResultStream;
+
+    /// <summary> Creates a stream that calls a function with each item written to it, and yields the results. </summary>
+    /// <param name="module"> The module name that contains the function to execute. </param>
+    /// <param name="func"> The function name to execute, called with one item. </param>
+    /// <param name="options"> The limits of the stream, and the call options of each item. </param>
+    createStream(module: string, func: string, options?: InputStreamOptions) : InputStream;
+
+    /// <summary> Creates a stream that calls a function with each item written to it, and yields the results. </summary>
+    /// <param name="func"> The JS function to execute, called with one item. </param>
+    /// <param name="options"> The limits of the stream, and the call options of each item. </param>
+    createStream(func: (item: any) => any, options?: InputStreamOptions) : InputStream;
+
+    /// <summary> Creates a ring of calls to a synchronous function, served by one zone worker until it is closed. </summary>
+    /// <param name="module"> The module name that contains the function to execute. </param>
+    /// <param name="func"> The function name to execute, which returns a value that JSON can represent. </param>
+    /// <param name="options"> The number and size of the slots of the ring. </param>
+    /// <remarks>
+    ///     Calls skip the native bridge of execute: arguments and results go through a SharedArrayBuffer, and each side
+    ///     wakes up the other with Atomics. The worker of the ring runs no other call until the ring is closed.
+    ///     It is not supported by the node zone.
+    /// </remarks>
+    createRing(module: string, func: string, options?: RingOptions) : SubmissionRing;
+
+    /// <summary> Creates a ring of calls to a synchronous function, served by one zone worker until it is closed. </summary>
+    /// <param name="func"> The JS function to execute, which returns a value that JSON can represent. </param>
+    /// <param name="options"> The number and size of the slots of the ring. </param>
+    createRing(func: (...args: any[]) => any, options?: RingOptions) : SubmissionRing;
+
+    /// <summary> Executes the function once per arguments list, spreading the calls over the zone workers. </summary>
+    /// <param name="module"> The module name that contains the function to execute. </param>
+    /// <param name="func"> The function name to execute. </param>
+    /// <param name="argsList"> A list of arguments, one entry per call. </param>
+    /// <param name="options"> Call options shared by all calls, defaults to DEFAULT_CALL_OPTIONS. </param>
+    /// <returns> A promise of results in the order of argsList, rejected if any call failed. </returns>
+    /// <remarks>
+    ///     The calls are split into one chunk per worker, and each chunk runs as a single task.
+    ///     A timeout in options applies to each chunk rather than to individual calls.
+    /// </remarks>
+    executeBatch(module: string, func: string, argsList: any[][], options?: CallOptions) : Promise<Result[]>;
+
+    /// <summary> Executes the function once per arguments list, spreading the calls over the zone workers. </summary>
+    /// <param name="func"> The JS function to execute. </param>
+    /// <param name="argsList"> A list of arguments, one entry per call. </param>
+    /// <param name="options"> Call options shared by all calls, defaults to DEFAULT_CALL_OPTIONS. </param>
+    /// <returns> A promise of results in the order of argsList, rejected if any call failed. </returns>
+    /// <remarks>
+    ///     The calls are split into one chunk per worker, and each chunk runs as a single task.
+    ///     A timeout in options applies to each chunk rather than to individual calls.
+    /// </remarks>
+    executeBatch(func: (...args: any[]) => any, argsList: any[][], options?: CallOptions) : Promise<Result[]>;
+
+    /// <summary> Executes a chain of functions, possibly on other zones, passing each result to the next function. </summary>
+    /// <param name="stages"> The functions to execute in order. </param>
+    /// <param name="args"> The arguments of the first function. </param>
+    /// <returns> A promise of the result of the last function, rejected at the first stage that failed. </returns>
+    /// <remarks> Results are handed from zone to zone in native code, marshalled as they are, without going through Node. </remarks>
+    pipe(stages: PipelineStage[], args?: any[]) : Promise<Result>;
+
+    /// <summary> Creates an empty task graph, for jobs like fan-out and fan-in made of calls depending on each other. </summary>
+    /// <returns> A graph whose tasks run on this zone, unless they name another one. </returns>
+    graph() : Graph;
+
+    /// <summary> Maps the elements of an array or typed array on the zone workers, chunk by chunk. </summary>
+    /// <param name="items"> The elements to map. Typed arrays on a SharedArrayBuffer are shared with the workers instead of copied. </param>
+    /// <param name="func"> The mapping function, called with an element and its index. </param>
+    /// <param name="options"> The chunk size, and the call options of the chunks. </param>
+    /// <returns> A promise of the mapped elements in order, rejected if any chunk failed. </returns>
+    map(items: ArrayLike<any>, func: (value: any, index: number) => any, options?: DataParallelOptions) : Promise<any[]>;
+
+    /// <summary> Runs a kernel over ranges of a typed array on a SharedArrayBuffer, on the zone workers. </summary>
+    /// <param name="items"> A typed array on a SharedArrayBuffer, which all ranges share without copies. </param>
+    /// <param name="func"> The kernel, called with the typed array and the [begin, end) range it works on. </param>
+    /// <param name="options"> The grain, and the call options of the ranges. </param>
+    /// <returns> A promise resolved once all ranges are done, rejected with the first failure. </returns>
+    parallelFor(items: ArrayBufferView, func: (items: any, begin: number, end: number) => void, options?: ParallelForOptions) : Promise<void>;
+
+    /// <summary> Reduces the elements of an array or typed array on the zone workers, chunk by chunk. </summary>
+    /// <param name="items"> The elements to reduce. Typed arrays on a SharedArrayBuffer are shared with the workers instead of copied. </param>
+    /// <param name="func"> The reducing function, which has to be associative since chunks are reduced separately. </param>
+    /// <param name="initialValue"> The value the reduction starts from, by default the first element. </param>
+    /// <param name="options"> The chunk size, and the call options of the chunks. </param>
+    /// <returns> A promise of the reduced value, rejected if any chunk failed. </returns>
+    reduce(items: ArrayLike<any>, func: (previous: any, value: any) => any, initialValue?: any, options?: DataParallelOptions) : Promise<any>;
+
+    /// <summary> Collects the V8 heap statistics of the running zone workers. </summary>
+    /// <returns> A promise of the statistics of each worker, ordered by worker id. Empty for the node zone. </returns>
+    /// <remarks> Workers read their statistics ahead of their queued calls, but after the call they are running. </remarks>
+    getHeapStatistics() : Promise<HeapStatistics[]>;
+
+    /// <summary> Reads the utilization counters of the zone and its running workers. </summary>
+    /// <returns> The number of waiting calls, and the busy and idle time, executed tasks and queue depth of each worker. </returns>
+    getStats() : ZoneStats;
+
+    /// <summary> Reads the statistics of the calls of each function that ran in the zone, since the zone was created. </summary>
+    /// <returns> The calls, errors and execution times of each function, ordered by module and function. Empty for the node zone. </returns>
+    getFunctionStats() : FunctionStats[];
+
+    /// <summary> Notifies the running zone workers of memory pressure, ahead of their queued calls. </summary>
+    /// <param name="level"> The memory pressure level. </param>
+    /// <remarks> It has no effect on the node zone. </remarks>
+    notifyMemoryPressure(level: MemoryPressureLevel) : void;
+
+    /// <summary> Starts sampling the CPU profile of zone workers, ahead of their queued calls. </summary>
+    /// <param name="workerIds"> The ids of the workers to profile, all running workers by default. </param>
+    /// <param name="samplingIntervalUs"> The sampling interval in microseconds, the V8 default by default. </param>
+    /// <remarks> Workers that are already profiling keep their profile. It has no effect on the node zone. </remarks>
+    startProfiling(workerIds?: number[], samplingIntervalUs?: number) : void;
+
+    /// <summary> Stops the CPU profiling of all zone workers. </summary>
+    /// <returns> A promise of the profiles of the workers that were profiling, ordered by worker id. </returns>
+    stopProfiling() : Promise<CpuProfile[]>;
+
+    /// <summary>
+    ///     Runs the calls queued on the zone, then disposes its workers and frees its id for a new zone, without waiting
+    ///     for every Zone object of it to be garbage collected. Calls made through any of them afterwards fail.
+    /// </summary>
+    /// <returns> A promise resolved once the workers are disposed, rejected for the node zone or from a worker of the zone. </returns>
+    recycle() : Promise<void>;
 }
 
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+using namespace napa::microbench;
+
+namespace {
+    std::vector<std::unique_ptr<Benchmark>>& GetBenchmarks() {
+        static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+        return benchmarks;
+    }
+
+    constexpr int64_t MAX_ITERATIONS = 1000000000;
+
+    struct RunResult {
+        int64_t iterations;
+        std::chrono::nanoseconds elapsed;
+        int64_t items;
+    };
+
+    /// <summary> Runs the benchmark once on the given number of threads, elapsed is the slowest thread's. </summary>
+    RunResult Run(Benchmark::Function function, int64_t iterations, int64_t argument, int threads) {
+        std::vector<std::unique_ptr<State>> states;
+        for (int i = 0; i < threads; ++i) {
+            states.emplace_back(new State(iterations, argument, i, threads));
+        }
+
+        if (threads == 1) {
+            function(*states[0]);
+        } else {
+            std::vector<std::thread> workers;
+            for (int i = 0; i < threads; ++i) {
+                workers.emplace_back([function, &states, i]() { function(*states[i]); });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        RunResult result = { iterations * threads, std::chrono::nanoseconds(0), 0 };
+        for (const auto& state : states) {
+            result.elapsed = std::max(result.elapsed, state->GetElapsed());
+            result.items += state->GetItemsProcessed();
+        }
+        return result;
+    }
+
+    void Report(const std::string& name, const RunResult& result) {
+        auto elapsed = static_cast<double>(result.elapsed.count());
+        std::printf("%-56s %12lld %14.1f ns/op", name.c_str(), static_cast<long long>(result.iterations),
+            elapsed / result.iterations);
+        if (result.items > 0) {
+            std::printf(" %14.1f ns/item", elapsed / result.items);
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+}
+
+State::State(int64_t iterations, int64_t argument, int threadIndex, int threads) :
+    _iterations(iterations),
+    _argument(argument),
+    _threadIndex(threadIndex),
+    _threads(threads),
+    _items(0),
+    _elapsed(0) {}
+
+void State::StartTimer() {
+    _start = std::chrono::steady_clock::now();
+}
+
+void State::StopTimer() {
+    _elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start);
+}
+
+Benchmark::Benchmark(const char* name, Function function) : _name(name), _function(function) {}
+
+Benchmark* Benchmark::Arg(int64_t argument) {
+    _arguments.push_back(argument);
+    return this;
+}
+
+Benchmark* Benchmark::Threads(int threads) {
+    _threads.push_back(threads);
+    return this;
+}
+
+Benchmark* napa::microbench::RegisterBenchmark(const char* name, Benchmark::Function function) {
+    auto& benchmarks = GetBenchmarks();
+    benchmarks.emplace_back(new Benchmark(name, function));
+    return benchmarks.back().get();
+}
+
+void napa::microbench::RunBenchmarks(const std::string& filter, double minTime) {
+    auto minElapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(minTime));
+
+    std::printf("%-56s %12s %14s\n", "Benchmark", "Iterations", "Time");
+    for (const auto& benchmark : GetBenchmarks()) {
+        auto arguments = benchmark->GetArguments();
+        if (arguments.empty()) {
+            arguments.push_back(0);
+        }
+        auto threadCounts = benchmark->GetThreads();
+        if (threadCounts.empty()) {
+            threadCounts.push_back(1);
+        }
+
+        for (auto argument : arguments) {
+            for (auto threads : threadCounts) {
+                auto name = benchmark->GetName();
+                if (!benchmark->GetArguments().empty()) {
+                    name += "/" + std::to_string(argument);
+                }
+                if (!benchmark->GetThreads().empty()) {
+                    name += "/threads:" + std::to_string(threads);
+                }
+                if (name.find(filter) == std::string::npos) {
+                    continue;
+                }
+
+                // Grow the iterations until a run takes the minimum time, the last run is the one reported.
+                int64_t iterations = 1;
+                while (true) {
+                    auto result = Run(benchmark->GetFunction(), iterations, argument, threads);
+                    if (result.elapsed >= minElapsed || iterations >= MAX_ITERATIONS) {
+                        Report(name, result);
+                        break;
+                    }
+
+                    auto multiplier = result.elapsed.count() > 0
+                        ? 1.4 * minElapsed.count() / result.elapsed.count()
+                        : 10.0;
+                    auto next = static_cast<int64_t>(iterations * std::min(std::max(multiplier, 2.0), 10.0));
+                    iterations = std::min(next, MAX_ITERATIONS);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace microbench {
+
+    /// <summary> State of a benchmark run, the benchmark times the loop `for (auto _ : state) { ... }`. </summary>
+    /// <remarks> Code before and after the loop is not timed, and each thread of a run has its own state. </remarks>
+    class State {
+    public:
+        State(int64_t iterations, int64_t argument, int threadIndex, int threads);
+
+        /// <summary> Iterates the timed loop, starting the clock on begin and stopping it after the last iteration. </summary>
+        class Iterator {
+        public:
+            Iterator(State* state, int64_t remaining) : _state(state), _remaining(remaining) {}
+
+            bool operator!=(const Iterator&) {
+                if (_remaining-- > 0) {
+                    return true;
+                }
+                _state->StopTimer();
+                return false;
+            }
+
+            void operator++() {}
+
+            int operator*() const {
+                return 0;
+            }
+
+        private:
+            State* _state;
+            int64_t _remaining;
+        };
+
+        Iterator begin() {
+            StartTimer();
+            return Iterator(this, _iterations);
+        }
+
+        Iterator end() {
+            return Iterator(this, 0);
+        }
+
+        /// <summary> The argument the benchmark was registered with, 0 if none. </summary>
+        int64_t range() const {
+            return _argument;
+        }
+
+        /// <summary> The index of the calling thread in a multi-threaded run. </summary>
+        int thread_index() const {
+            return _threadIndex;
+        }
+
+        /// <summary> The number of threads running the benchmark together. </summary>
+        int threads() const {
+            return _threads;
+        }
+
+        /// <summary> The number of iterations of the timed loop. </summary>
+        int64_t iterations() const {
+            return _iterations;
+        }
+
+        /// <summary> Reports the number of items processed by the loop, to also report the time per item. </summary>
+        void SetItemsProcessed(int64_t items) {
+            _items = items;
+        }
+
+        int64_t GetItemsProcessed() const {
+            return _items;
+        }
+
+        std::chrono::nanoseconds GetElapsed() const {
+            return _elapsed;
+        }
+
+    private:
+        void StartTimer();
+        void StopTimer();
+
+        const int64_t _iterations;
+        const int64_t _argument;
+        const int _threadIndex;
+        const int _threads;
+        int64_t _items;
+        std::chrono::steady_clock::time_point _start;
+        std::chrono::nanoseconds _elapsed;
+    };
+
+    /// <summary> A registered benchmark, which runs once per argument and thread count. </summary>
+    class Benchmark {
+    public:
+        typedef void (*Function)(State&);
+
+        Benchmark(const char* name, Function function);
+
+        /// <summary> Adds an argument, returned by State::range(). </summary>
+        Benchmark* Arg(int64_t argument);
+
+        /// <summary> Adds a number of threads that run the benchmark together. </summary>
+        Benchmark* Threads(int threads);
+
+        const std::string& GetName() const {
+            return _name;
+        }
+
+        Function GetFunction() const {
+            return _function;
+        }
+
+        const std::vector<int64_t>& GetArguments() const {
+            return _arguments;
+        }
+
+        const std::vector<int>& GetThreads() const {
+            return _threads;
+        }
+
+    private:
+        std::string _name;
+        Function _function;
+        std::vector<int64_t> _arguments;
+        std::vector<int> _threads;
+    };
+
+    /// <summary> Registers a benchmark, use NAPA_BENCHMARK instead. </summary>
+    Benchmark* RegisterBenchmark(const char* name, Benchmark::Function function);
+
+    /// <summary> Runs the registered benchmarks whose names contain the filter, and prints their results. </summary>
+    /// <param name="filter"> Substring of the names of benchmarks to run, empty for all. </param>
+    /// <param name="minTime"> The least time in seconds each benchmark is timed for. </param>
+    void RunBenchmarks(const std::string& filter, double minTime);
+
+    /// <summary> Keeps the compiler from optimizing away a value computed by the benchmark. </summary>
+    template <typename T>
+    inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile char sink;
+        sink = *reinterpret_cast<const volatile char*>(&value);
+#endif
+    }
+}
+}
+
+#define NAPA_BENCHMARK_CONCAT_INNER(a, b) a##b
+#define NAPA_BENCHMARK_CONCAT(a, b) NAPA_BENCHMARK_CONCAT_INNER(a, b)
+
+/// <summary> Registers a function `void (State&)` as a benchmark, options chain like `->Arg(8)->Threads(4)`. </summary>
+#define NAPA_BENCHMARK(function) \
+    static ::napa::microbench::Benchmark* NAPA_BENCHMARK_CONCAT(_napaBenchmark, __LINE__) = \
+        ::napa::microbench::RegisterBenchmark(#function, function)
@@ -0,0 +1,33 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "benchmark.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace {
+    const char FILTER_OPTION[] = "--filter=";
+    const char MIN_TIME_OPTION[] = "--min-time=";
+}
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    double minTime = 0.5;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], FILTER_OPTION, sizeof(FILTER_OPTION) - 1) == 0) {
+            filter = argv[i] + sizeof(FILTER_OPTION) - 1;
+        } else if (std::strncmp(argv[i], MIN_TIME_OPTION, sizeof(MIN_TIME_OPTION) - 1) == 0) {
+            minTime = std::atof(argv[i] + sizeof(MIN_TIME_OPTION) - 1);
+        } else {
+            std::fprintf(stderr, "Usage: %s [%s<substring>] [%s<seconds>]\n", argv[0], FILTER_OPTION, MIN_TIME_OPTION);
+            return 1;
+        }
+    }
+
+    napa::microbench::RunBenchmarks(filter, minTime);
+    return 0;
+}
@@ -0,0 +1,19 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+var path = require('path');
+var childProcess = require('child_process');
+
+try {
+    childProcess.execFileSync(
+        path.join(__dirname, 'build/bin/', process.platform === 'win32'? 'napa-microbench.exe': 'napa-microbench'),
+        process.argv.slice(2),
+        {
+            cwd: path.join(__dirname, 'build/bin'),
+            stdio: 'inherit'
+        }
+    );
+}
+catch(err) {
+    process.exit(1); // Error
+}
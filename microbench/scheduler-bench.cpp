@@ -0,0 +1,172 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "benchmark.h"
+
+#include <zone/scheduler.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace napa;
+using namespace napa::zone;
+using namespace napa::settings;
+using namespace napa::microbench;
+
+namespace {
+
+    /// <summary> A task that only counts its executions, to time the scheduler alone. </summary>
+    class CountingTask : public Task {
+    public:
+        explicit CountingTask(std::atomic<int64_t>& executed) : _executed(executed) {}
+
+        void Execute() override {
+            _executed.fetch_add(1, std::memory_order_release);
+        }
+
+        void Reject(napa::ResultCode /*code*/, const std::string& /*reason*/) override {}
+
+    private:
+        std::atomic<int64_t>& _executed;
+    };
+
+    /// <summary> A synthetic worker running tasks on its own thread, without an isolate. </summary>
+    class BenchWorker {
+    public:
+        BenchWorker(WorkerId id,
+                    const ZoneSettings&,
+                    std::function<void(WorkerId)> setupCompleteCallback,
+                    std::function<void(WorkerId)> idleCallback) :
+            _state(std::make_unique<SharedState>()) {
+
+            auto state = _state.get();
+            state->id = id;
+            state->idleCallback = std::move(idleCallback);
+            state->thread = std::thread([state]() { state->Run(); });
+            setupCompleteCallback(id);
+        }
+
+        BenchWorker(BenchWorker&&) = default;
+
+        ~BenchWorker() {
+            if (_state == nullptr) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(_state->mutex);
+                _state->stopping = true;
+            }
+            _state->ready.notify_one();
+            _state->thread.join();
+        }
+
+        void Start() {
+            _state->idleCallback(_state->id);
+        }
+
+        void Schedule(std::shared_ptr<Task> task, SchedulePhase phase = SchedulePhase::DefaultPhase) {
+            {
+                std::lock_guard<std::mutex> lock(_state->mutex);
+                _state->tasks.emplace_back(std::move(task));
+            }
+            _state->ready.notify_one();
+        }
+
+        /// <summary> Tasks are taken as soon as they are scheduled, none are left to reroute. </summary>
+        bool Unschedule(const std::shared_ptr<Task>& /*task*/) {
+            return false;
+        }
+
+        /// <summary> Benchmark tasks are too short to be watched for running too long. </summary>
+        std::chrono::milliseconds GetBusyDuration() const {
+            return std::chrono::milliseconds(0);
+        }
+
+        /// <summary> Benchmark tasks run no JavaScript to terminate. </summary>
+        void TerminateExecution() {}
+
+        /// <summary> Benchmark workers are never recycled. </summary>
+        bool NeedsRecycling() const {
+            return false;
+        }
+
+        /// <summary> Benchmark workers have no heap to run out of. </summary>
+        bool IsSheddingLoad() const {
+            return false;
+        }
+
+    private:
+        struct SharedState {
+            void Run() {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (true) {
+                    ready.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                    if (tasks.empty()) {
+                        return;
+                    }
+                    auto task = std::move(tasks.front());
+                    tasks.pop_front();
+                    lock.unlock();
+
+                    task->Execute();
+                    idleCallback(id);
+                    lock.lock();
+                }
+            }
+
+            WorkerId id;
+            std::function<void(WorkerId)> idleCallback;
+            std::mutex mutex;
+            std::condition_variable ready;
+            std::deque<std::shared_ptr<Task>> tasks;
+            bool stopping = false;
+            std::thread thread;
+        };
+
+        std::unique_ptr<SharedState> _state;
+    };
+
+    /// <summary> Schedules batches of range() tasks on 4 workers and waits for each batch to drain. </summary>
+    void BenchmarkScheduleBatch(State& state, SchedulerType type) {
+        ZoneSettings settings;
+        settings.workers = 4;
+        settings.scheduler = type;
+
+        std::atomic<int64_t> executed(0);
+        auto task = std::make_shared<CountingTask>(executed);
+        SchedulerImpl<BenchWorker> scheduler(settings, [](WorkerId) {});
+
+        int64_t scheduled = 0;
+        for (auto _ : state) {
+            for (int64_t i = 0; i < state.range(); ++i) {
+                scheduler.Schedule(task);
+            }
+            scheduled += state.range();
+            while (executed.load(std::memory_order_acquire) < scheduled) {
+                std::this_thread::yield();
+            }
+        }
+        state.SetItemsProcessed(scheduled);
+    }
+
+    void BM_ScheduleSynchronized(State& state) {
+        BenchmarkScheduleBatch(state, SchedulerType::Synchronized);
+    }
+
+    void BM_ScheduleLockFree(State& state) {
+        BenchmarkScheduleBatch(state, SchedulerType::LockFree);
+    }
+
+    void BM_ScheduleWorkStealing(State& state) {
+        BenchmarkScheduleBatch(state, SchedulerType::WorkStealing);
+    }
+
+    NAPA_BENCHMARK(BM_ScheduleSynchronized)->Arg(1)->Arg(64);
+    NAPA_BENCHMARK(BM_ScheduleLockFree)->Arg(1)->Arg(64);
+    NAPA_BENCHMARK(BM_ScheduleWorkStealing)->Arg(1)->Arg(64);
+}
@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "benchmark.h"
+
+#include <store/store.h>
+
+#include <napa/memory/allocator.h>
+#include <providers/nop-metric-provider.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace napa::store;
+using namespace napa::microbench;
+
+namespace {
+
+    /// <summary> The benchmarks don't link napa's allocators, transport contexts of values allocate from the CRT. </summary>
+    class BenchAllocator : public napa::memory::Allocator {
+    public:
+        void* Allocate(size_t size) override {
+            return std::malloc(size);
+        }
+
+        void Deallocate(void* memory, size_t) override {
+            std::free(memory);
+        }
+
+        const char* GetType() const override {
+            return "BenchAllocator";
+        }
+
+        bool operator==(const Allocator& other) const override {
+            return std::strcmp(other.GetType(), GetType()) == 0;
+        }
+    };
+
+    constexpr int KEY_COUNT = 1024;
+
+    /// <summary> A store with KEY_COUNT keys per number of shards, shared by the threads of a run. </summary>
+    std::shared_ptr<Store> GetBenchStore(uint32_t shards) {
+        auto id = "microbench-store-" + std::to_string(shards);
+        auto store = GetStore(id.c_str());
+        if (store != nullptr) {
+            return store;
+        }
+
+        StoreOptions options;
+        options.shards = shards;
+        store = GetOrCreateStore(id.c_str(), options);
+        for (int i = 0; i < KEY_COUNT; ++i) {
+            auto value = std::make_shared<Store::ValueType>();
+            value->oneBytePayload = "{\"value\":" + std::to_string(i) + "}";
+            store->Set(("key" + std::to_string(i)).c_str(), std::move(value));
+        }
+        return store;
+    }
+
+    std::vector<std::string> MakeKeys() {
+        std::vector<std::string> keys;
+        for (int i = 0; i < KEY_COUNT; ++i) {
+            keys.push_back("key" + std::to_string(i));
+        }
+        return keys;
+    }
+
+    /// <summary> Reads keys of a store with range() shards, from all threads of the run. </summary>
+    void BM_StoreGet(State& state) {
+        auto store = GetBenchStore(static_cast<uint32_t>(state.range()));
+        auto keys = MakeKeys();
+
+        size_t i = state.thread_index();
+        for (auto _ : state) {
+            auto value = store->Get(keys[i++ % KEY_COUNT].c_str());
+            DoNotOptimize(value);
+        }
+    }
+
+    /// <summary> Overwrites keys of a store with range() shards, from all threads of the run. </summary>
+    void BM_StoreSet(State& state) {
+        auto store = GetBenchStore(static_cast<uint32_t>(state.range()));
+        auto keys = MakeKeys();
+        auto value = std::make_shared<Store::ValueType>();
+        value->oneBytePayload = "{\"value\":0}";
+
+        size_t i = state.thread_index();
+        for (auto _ : state) {
+            store->Set(keys[i++ % KEY_COUNT].c_str(), value);
+        }
+    }
+
+    /// <summary> Mixes one write for every 15 reads, from all threads of the run. </summary>
+    void BM_StoreMixed(State& state) {
+        auto store = GetBenchStore(static_cast<uint32_t>(state.range()));
+        auto keys = MakeKeys();
+        auto value = std::make_shared<Store::ValueType>();
+        value->oneBytePayload = "{\"value\":0}";
+
+        size_t i = state.thread_index();
+        for (auto _ : state) {
+            auto& key = keys[i++ % KEY_COUNT];
+            if (i % 16 == 0) {
+                store->Set(key.c_str(), value);
+            } else {
+                auto result = store->Get(key.c_str());
+                DoNotOptimize(result);
+            }
+        }
+    }
+
+    NAPA_BENCHMARK(BM_StoreGet)->Arg(1)->Arg(16)->Threads(1)->Threads(4);
+    NAPA_BENCHMARK(BM_StoreSet)->Arg(1)->Arg(16)->Threads(1)->Threads(4);
+    NAPA_BENCHMARK(BM_StoreMixed)->Arg(1)->Arg(16)->Threads(1)->Threads(4);
+}
+
+napa::memory::Allocator& napa::memory::GetDefaultAllocator() {
+    static BenchAllocator allocator;
+    return allocator;
+}
+
+napa::providers::MetricProvider& napa::providers::GetMetricProvider() {
+    static napa::providers::NopMetricProvider provider;
+    return provider;
+}
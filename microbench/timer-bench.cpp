@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "benchmark.h"
+
+#include <zone/timer.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+using namespace napa::zone;
+using namespace napa::microbench;
+
+namespace {
+
+    /// <summary> Starts and stops a timer that never fires, the hot path of call timeouts. </summary>
+    void BM_TimerStartStop(State& state) {
+        Timer timer([]() {}, std::chrono::milliseconds(60000));
+        for (auto _ : state) {
+            timer.Start();
+            timer.Stop();
+        }
+    }
+
+    /// <summary> Starts range() timers and then stops them all, so stops find a populated wheel. </summary>
+    void BM_TimerStartMany(State& state) {
+        std::vector<std::unique_ptr<Timer>> timers;
+        for (int64_t i = 0; i < state.range(); ++i) {
+            timers.emplace_back(new Timer([]() {}, std::chrono::milliseconds(60000 + i)));
+        }
+
+        for (auto _ : state) {
+            for (auto& timer : timers) {
+                timer->Start();
+            }
+            for (auto& timer : timers) {
+                timer->Stop();
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * state.range());
+    }
+
+    /// <summary> Creates and destroys a timer, as done per call with a timeout. </summary>
+    void BM_TimerCreateDestroy(State& state) {
+        for (auto _ : state) {
+            Timer timer([]() {}, std::chrono::milliseconds(60000));
+            timer.Start();
+        }
+    }
+
+    NAPA_BENCHMARK(BM_TimerStartStop)->Threads(1)->Threads(4);
+    NAPA_BENCHMARK(BM_TimerStartMany)->Arg(1024);
+    NAPA_BENCHMARK(BM_TimerCreateDestroy)->Threads(1)->Threads(4);
+}
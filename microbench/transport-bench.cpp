@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "benchmark.h"
+
+#include <napa/transport/transport-context.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace napa::transport;
+using namespace napa::microbench;
+
+namespace {
+
+    /// <summary> Saves range() shared pointers and loads them back, as a call marshalling shared objects does. </summary>
+    void BM_TransportSaveLoadShared(State& state) {
+        std::vector<std::shared_ptr<int>> pointers;
+        for (int64_t i = 0; i < state.range(); ++i) {
+            pointers.push_back(std::make_shared<int>(static_cast<int>(i)));
+        }
+
+        for (auto _ : state) {
+            TransportContext context;
+            for (auto& pointer : pointers) {
+                context.SaveShared(pointer);
+            }
+            for (auto& pointer : pointers) {
+                auto loaded = context.LoadShared<int>(reinterpret_cast<uintptr_t>(pointer.get()));
+                DoNotOptimize(loaded);
+            }
+        }
+        state.SetItemsProcessed(state.iterations() * state.range());
+    }
+
+    /// <summary> Moves a transport context holding range() shared pointers, as results do between threads. </summary>
+    void BM_TransportMove(State& state) {
+        TransportContext context;
+        for (int64_t i = 0; i < state.range(); ++i) {
+            context.SaveShared(std::make_shared<int>(static_cast<int>(i)));
+        }
+
+        for (auto _ : state) {
+            TransportContext moved(std::move(context));
+            context = std::move(moved);
+        }
+        DoNotOptimize(context.GetSharedCount());
+    }
+
+    NAPA_BENCHMARK(BM_TransportSaveLoadShared)->Arg(1)->Arg(16);
+    NAPA_BENCHMARK(BM_TransportMove)->Arg(16);
+}
@@ -0,0 +1 @@
+module.exports = 3;
\ No newline at end of file
@@ -0,0 +1 @@
+module.exports = 1;
\ No newline at end of file
@@ -39,6 +39,7 @@ void Shutdown(const v8::FunctionCallbackInfo<v8::Value>&) {
 
 void InitAll(v8::Local<v8::Object> exports, v8::Local<v8::Object> module) {
     // Init node zone before initialize modules.
+    napa::node_zone::Init();
     napa::zone::NodeZone::Init(napa::node_zone::Broadcast, napa::node_zone::Execute);
 
     // Init core napa modules.
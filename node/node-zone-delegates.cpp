@@ -3,45 +3,61 @@
 
 #include "node-zone-delegates.h"
 
+#include <zone/block-pool.h>
 #include <zone/call-task.h>
 #include <zone/eval-task.h>
 
+#include <napa/zone/mpsc-queue.h>
+
 #include <uv.h>
 
-struct AsyncContext {
-    /// <summary> libuv request. </summary>
-    uv_async_t work;
+#include <functional>
+#include <memory>
 
-    /// <summary> Callback that will be running in Node event loop. </summary>
-    std::function<void()> callback;
-};
+namespace {
+    /// <summary> Callbacks scheduled by napa workers, waiting to run in the Node event loop. </summary>
+    napa::zone::MpscQueue<std::function<void()>> _pendingCallbacks;
 
-/// <summary> Run an async work item in Node. </summary>
-void Run(uv_async_t* work) {
-    auto context = static_cast<AsyncContext*>(work->data);
+    /// <summary> The handle that wakes the Node event loop, created once on the loop thread. </summary>
+    uv_async_t _wakeup;
 
-    context->callback();
+    /// <summary> The pool that call tasks run in the Node event loop allocate from. </summary>
+    constexpr size_t TASK_POOL_MAX_FREE_BLOCKS = 64;
+    std::shared_ptr<napa::zone::BlockPool> _taskPool = std::make_shared<napa::zone::BlockPool>(TASK_POOL_MAX_FREE_BLOCKS);
 
-    uv_close(reinterpret_cast<uv_handle_t*>(work), [](auto work) {
-        auto context = static_cast<AsyncContext*>(work->data);
-        delete context;
-    });
+    /// <summary> Runs all callbacks scheduled since the last wakeup, libuv coalesces the sends of a wakeup. </summary>
+    void RunPendingCallbacks(uv_async_t*) {
+        _pendingCallbacks.Drain([](std::function<void()> callback) {
+            callback();
+        });
+    }
+
+    /// <summary> Schedule a function in Node event loop. </summary>
+    void ScheduleInNode(std::function<void()> callback) {
+        // Only the first callback pushed to an empty queue needs to wake the loop, the drain picks up the others.
+        if (_pendingCallbacks.Push(std::move(callback))) {
+            uv_async_send(&_wakeup);
+        }
+    }
 }
 
-/// <summary> Schedule a function in Node event loop. </summary>
-void ScheduleInNode(std::function<void()> callback) {
-    auto context = new AsyncContext();
-    context->work.data = context;
-    context->callback = std::move(callback);
+void napa::node_zone::Init() {
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    initialized = true;
+
+    uv_async_init(uv_default_loop(), &_wakeup, RunPendingCallbacks);
 
-    uv_async_init(uv_default_loop(), &context->work, Run);
-    uv_async_send(&context->work);
+    // The handle lives as long as the process, it must not keep the Node event loop alive by itself.
+    uv_unref(reinterpret_cast<uv_handle_t*>(&_wakeup));
 }
 
 void napa::node_zone::Broadcast(const napa::FunctionSpec& spec, napa::BroadcastCallback callback) {
     auto requestContext = std::make_shared<napa::zone::CallContext>(spec, callback);
     ScheduleInNode([requestContext = std::move(requestContext)]() {
-        napa::zone::CallTask task(std::move(requestContext));
+        napa::zone::CallTask task(std::move(requestContext), _taskPool);
         task.Execute();
     });
 }
@@ -49,7 +65,7 @@ void napa::node_zone::Broadcast(const napa::FunctionSpec& spec, napa::BroadcastC
 void napa::node_zone::Execute(const napa::FunctionSpec& spec, napa::ExecuteCallback callback) {
     auto requestContext = std::make_shared<napa::zone::CallContext>(spec, callback);
     ScheduleInNode([requestContext = std::move(requestContext)]() {
-        napa::zone::CallTask task(std::move(requestContext));
+        napa::zone::CallTask task(std::move(requestContext), _taskPool);
         task.Execute();
     });
 }
@@ -8,6 +8,9 @@
 namespace napa {
 namespace node_zone {
 
+    /// <summary> Creates the handle that wakes the Node event loop, it must be called on the loop thread first. </summary>
+    void Init();
+
     /// <summary> Broadcast to Node zone. </summary>
     void Broadcast(const napa::FunctionSpec& spec, napa::BroadcastCallback callback);
 
@@ -0,0 +1,39 @@
+#!/usr/bin/env node
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+// Writes a module bundle of an application for the 'bundle' zone setting.
+// Usage: create-module-bundle <bundle-file> <module>... [--sharedModuleContext]
+// The modules are required in a zone, so the bundle holds them and every module they require.
+
+"use strict";
+var path = require("path");
+
+var args = process.argv.slice(2);
+var sharedModuleContext = args.indexOf("--sharedModuleContext") >= 0;
+args = args.filter(function (arg) { return arg !== "--sharedModuleContext"; });
+
+if (args.length < 2) {
+    console.error("Usage: create-module-bundle <bundle-file> <module>... [--sharedModuleContext]");
+    process.exit(1);
+}
+
+var napa = require("../lib/index");
+var bundlePath = path.resolve(args[0]);
+
+// Modules are compiled for the module context mode of the zones that load the bundle.
+var zone = napa.zone.create("module-bundle", { workers: 1, sharedModuleContext: sharedModuleContext });
+
+var requires = args.slice(1).map(function (name) {
+    var resolved = name.startsWith(".") ? path.resolve(name) : name;
+    return zone.broadcast("require(" + JSON.stringify(resolved) + ");");
+});
+
+Promise.all(requires).then(function () {
+    napa.runtime.writeModuleBundle(bundlePath);
+    console.log("Module bundle written to " + bundlePath);
+    process.exit(0);
+}, function (error) {
+    console.error("Failed to load the modules: " + error);
+    process.exit(1);
+});
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "capi-results.h"
+
+#include <napa/assert.h>
+
+using namespace napa;
+
+napa_zone_result api::ToZoneResult(Result& result) {
+    napa_zone_result res;
+    res.code = result.code;
+    res.error_message = STD_STRING_TO_NAPA_STRING_REF(result.errorMessage);
+    res.return_value = STD_STRING_TO_NAPA_STRING_REF(result.returnValue);
+    res.timing = result.timing;
+
+    // Release ownership of transport context
+    res.transport_context = reinterpret_cast<void*>(result.transportContext.release());
+    return res;
+}
+
+napa_zone_result api::ToRetainedResult(Result& result, napa_result_buffer_handle& buffer) {
+    // Moving the strings keeps the marshalled value where the worker wrote it.
+    buffer = new napa_result_buffer();
+    buffer->references = 1;
+    buffer->errorMessage = std::move(result.errorMessage);
+    buffer->returnValue = std::move(result.returnValue);
+
+    auto res = ToZoneResult(result);
+    res.error_message = STD_STRING_TO_NAPA_STRING_REF(buffer->errorMessage);
+    res.return_value = STD_STRING_TO_NAPA_STRING_REF(buffer->returnValue);
+    return res;
+}
+
+napa_zone_result api::ToBufferedResult(Result& result, char* buffer, size_t bufferSize) {
+    auto res = ToZoneResult(result);
+    if (result.returnValue.size() > bufferSize) {
+        res.code = NAPA_RESULT_RESULT_BUFFER_TOO_SMALL;
+        res.return_value = NAPA_STRING_REF_WITH_SIZE(nullptr, result.returnValue.size());
+    } else {
+        result.returnValue.copy(buffer, result.returnValue.size());
+        res.return_value = NAPA_STRING_REF_WITH_SIZE(buffer, result.returnValue.size());
+    }
+    return res;
+}
+
+void api::RetainResultBuffer(napa_result_buffer_handle buffer) {
+    NAPA_ASSERT(buffer, "Result buffer is null");
+
+    buffer->references.fetch_add(1, std::memory_order_relaxed);
+}
+
+void api::ReleaseResultBuffer(napa_result_buffer_handle buffer) {
+    if (buffer != nullptr && buffer->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        delete buffer;
+    }
+}
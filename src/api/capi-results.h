@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// <summary> The strings of a retained result, moved out of the result and freed with the last reference. </summary>
+struct napa_result_buffer {
+    std::atomic<uint32_t> references;
+    std::string errorMessage;
+    std::string returnValue;
+};
+
+namespace napa {
+namespace api {
+
+    /// <summary> Converts a result to the C API, the strings reference the ones of the result. </summary>
+    /// <remarks> The transport context is released to the caller of the C API. </remarks>
+    napa_zone_result ToZoneResult(Result& result);
+
+    /// <summary> Converts a result to the C API, moving its strings into a new result buffer. </summary>
+    /// <param name="result"> The result, whose strings are moved out. </param>
+    /// <param name="buffer"> Set to the result buffer, which has one reference owned by the caller. </param>
+    napa_zone_result ToRetainedResult(Result& result, napa_result_buffer_handle& buffer);
+
+    /// <summary> Converts a result to the C API, copying its return value into a buffer of the caller. </summary>
+    /// <remarks>
+    ///     If the return value doesn't fit, the code is NAPA_RESULT_RESULT_BUFFER_TOO_SMALL, and the return value has
+    ///     a null data with the size needed. The error message references the one of the result.
+    /// </remarks>
+    napa_zone_result ToBufferedResult(Result& result, char* buffer, size_t bufferSize);
+
+    /// <summary> Adds a reference to a result buffer. </summary>
+    void RetainResultBuffer(napa_result_buffer_handle buffer);
+
+    /// <summary> Releases a reference of a result buffer, which is freed with its last reference. </summary>
+    /// <param name="buffer"> The result buffer, or null to do nothing. </param>
+    void ReleaseResultBuffer(napa_result_buffer_handle buffer);
+}
+}
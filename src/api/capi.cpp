@@ -3,17 +3,39 @@
 
 #include <napa/capi.h>
 
+#include "capi-results.h"
+
+#include <memory/array-buffer-pool.h>
+#include <memory/malloc-library.h>
+#include <memory/pool-allocator.h>
+#include <module/loader/code-cache.h>
+#include <module/loader/file-status-cache.h>
+#include <module/loader/json-module-cache.h>
+#include <module/loader/module-bundle.h>
+#include <platform/thread.h>
 #include <providers/providers.h>
 #include <settings/settings-parser.h>
 #include <v8-extensions/v8-common.h>
+#include <zone/isolate-pool.h>
+#include <zone/call-context.h>
 #include <zone/napa-zone.h>
 #include <zone/node-zone.h>
+#include <zone/remote-zone.h>
+#include <zone/span-recorder.h>
+#include <zone/trace-recorder.h>
 #include <zone/worker-context.h>
+#include <zone/zone-server.h>
+#include <utils/console-buffer.h>
 
 #include <napa/log.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <cstring>
 #include <fstream>
+#include <iterator>
+#include <mutex>
 #include <sstream>
 #include <thread>
 #include <unordered_map>
@@ -31,6 +53,58 @@ struct napa_zone {
     std::shared_ptr<zone::Zone> zone;
 };
 
+/// <summary> The per thread slot a synchronous call waits on, and where its result is kept until the next call. </summary>
+/// <remarks>
+///     If the wait times out the slot is abandoned to the pending call, which deletes it once it completes,
+///     and the thread uses a new slot for its next call.
+/// </remarks>
+struct SyncCallSlot {
+    static constexpr uint32_t WAITING = 0;
+    static constexpr uint32_t COMPLETED = 1;
+    static constexpr uint32_t ABANDONED = 2;
+
+    std::atomic<uint32_t> state;
+    Result result;
+};
+
+/// <summary> Owns the slot of the calling thread, unless it was abandoned to a pending call. </summary>
+struct SyncCallSlotHolder {
+    SyncCallSlotHolder() : slot(new SyncCallSlot()) {}
+
+    ~SyncCallSlotHolder() {
+        delete slot;
+    }
+
+    SyncCallSlot* slot;
+};
+
+static thread_local SyncCallSlotHolder _syncCallSlot;
+
+/// <summary> Converts a function spec of the C API, taking ownership of its transport context. </summary>
+static FunctionSpec ToFunctionSpec(const napa_zone_function_spec& spec) {
+    FunctionSpec req;
+    req.module = spec.module;
+    req.function = spec.function;
+
+    req.arguments.reserve(spec.arguments_count);
+    for (size_t i = 0; i < spec.arguments_count; i++) {
+        req.arguments.emplace_back(spec.arguments[i]);
+    }
+
+    req.options = spec.options;
+
+    // Assume ownership of transport context
+    req.transportContext.reset(reinterpret_cast<napa::transport::TransportContext*>(spec.transport_context));
+    return req;
+}
+
+/// <summary> Converts a result to the C API, the strings reference the ones of the result. </summary>
+/// <remarks> A return value the call compressed is decompressed in place first. </remarks>
+static napa_zone_result ToZoneResult(Result& result, TransportOption transport) {
+    napa::zone::CallContext::DecompressResult(result, transport);
+    return api::ToZoneResult(result);
+}
+
 napa_zone_handle napa_zone_create(napa_string_ref id) {
     NAPA_ASSERT(_initialized, "Napa wasn't initialized");
 
@@ -102,6 +176,112 @@ napa_result_code napa_zone_release(napa_zone_handle handle) {
     return NAPA_RESULT_SUCCESS;
 }
 
+napa_result_code napa_zone_recycle(napa_zone_handle handle) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+
+    return handle->zone->Recycle();
+}
+
+/// <summary> Zones served by napa_zone_serve, by port, and by napa_zone_serve_shared_memory, by name. </summary>
+static std::mutex _serversLock;
+static std::unordered_map<uint16_t, std::unique_ptr<zone::ZoneServer>> _servers;
+static std::unordered_map<std::string, std::unique_ptr<zone::ZoneServer>> _sharedMemoryServers;
+
+napa_zone_handle napa_zone_connect(napa_string_ref address, uint32_t connections) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+
+    auto zone = zone::RemoteZone::Connect(NAPA_STRING_REF_TO_STD_STRING(address), connections);
+    if (zone == nullptr) {
+        NAPA_DEBUG("Api", "Failed to connect to a remote zone at '%s'", NAPA_STRING_REF_TO_STD_STRING(address).c_str());
+        return nullptr;
+    }
+
+    auto id = zone->GetId();
+    return new napa_zone { std::move(id), std::move(zone) };
+}
+
+napa_result_code napa_zone_serve(napa_zone_handle handle, napa_string_ref address, uint16_t* port) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(port, "Port is null");
+
+    auto server = zone::ZoneServer::Start(handle->zone, NAPA_STRING_REF_TO_STD_STRING(address));
+    if (server == nullptr) {
+        return NAPA_RESULT_REMOTE_CONNECTION_ERROR;
+    }
+
+    *port = server->GetPort();
+    std::lock_guard<std::mutex> lock(_serversLock);
+    _servers[*port] = std::move(server);
+    return NAPA_RESULT_SUCCESS;
+}
+
+napa_result_code napa_zone_stop_serving(uint16_t port) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+
+    // The server is destroyed outside of the lock, which waits for its connections to close.
+    std::unique_ptr<zone::ZoneServer> server;
+    {
+        std::lock_guard<std::mutex> lock(_serversLock);
+        auto it = _servers.find(port);
+        if (it != _servers.end()) {
+            server = std::move(it->second);
+            _servers.erase(it);
+        }
+    }
+    return NAPA_RESULT_SUCCESS;
+}
+
+napa_zone_handle napa_zone_connect_shared_memory(napa_string_ref name, uint32_t connections) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+
+    auto zone = zone::RemoteZone::ConnectSharedMemory(NAPA_STRING_REF_TO_STD_STRING(name), connections);
+    if (zone == nullptr) {
+        NAPA_DEBUG("Api", "Failed to connect to a remote zone on shared memory '%s'", NAPA_STRING_REF_TO_STD_STRING(name).c_str());
+        return nullptr;
+    }
+
+    auto id = zone->GetId();
+    return new napa_zone { std::move(id), std::move(zone) };
+}
+
+napa_result_code napa_zone_serve_shared_memory(napa_zone_handle handle, napa_string_ref name) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+
+    auto segmentName = NAPA_STRING_REF_TO_STD_STRING(name);
+    std::lock_guard<std::mutex> lock(_serversLock);
+    if (_sharedMemoryServers.find(segmentName) != _sharedMemoryServers.end()) {
+        return NAPA_RESULT_REMOTE_CONNECTION_ERROR;
+    }
+
+    auto server = zone::ZoneServer::StartSharedMemory(handle->zone, segmentName);
+    if (server == nullptr) {
+        return NAPA_RESULT_REMOTE_CONNECTION_ERROR;
+    }
+    _sharedMemoryServers.emplace(std::move(segmentName), std::move(server));
+    return NAPA_RESULT_SUCCESS;
+}
+
+napa_result_code napa_zone_stop_serving_shared_memory(napa_string_ref name) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+
+    std::unique_ptr<zone::ZoneServer> server;
+    {
+        std::lock_guard<std::mutex> lock(_serversLock);
+        auto it = _sharedMemoryServers.find(NAPA_STRING_REF_TO_STD_STRING(name));
+        if (it != _sharedMemoryServers.end()) {
+            server = std::move(it->second);
+            _sharedMemoryServers.erase(it);
+        }
+    }
+    return NAPA_RESULT_SUCCESS;
+}
+
 napa_string_ref napa_zone_get_id(napa_zone_handle handle) {
     NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
     NAPA_ASSERT(handle, "Zone handle is null");
@@ -109,13 +289,47 @@ napa_string_ref napa_zone_get_id(napa_zone_handle handle) {
     return STD_STRING_TO_NAPA_STRING_REF(handle->id);
 }
 
+size_t napa_zone_get_queue_length(napa_zone_handle handle) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+
+    return handle->zone->GetQueueLength();
+}
+
+uint32_t napa_zone_get_worker_count(napa_zone_handle handle) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+
+    return handle->zone->GetWorkerCount();
+}
+
+void napa_zone_cancel(napa_zone_handle handle, uint64_t token) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+
+    handle->zone->Cancel(token);
+}
+
 void napa_zone_broadcast(napa_zone_handle handle,
                          napa_zone_function_spec spec,
                          napa_zone_broadcast_callback callback,
                          void* context) {
+    napa_zone_broadcast_to_workers(handle, spec, nullptr, 0, callback, context);
+}
+
+void napa_zone_broadcast_to_workers(napa_zone_handle handle,
+                                    napa_zone_function_spec spec,
+                                    const uint32_t* worker_ids,
+                                    size_t worker_ids_count,
+                                    napa_zone_broadcast_callback callback,
+                                    void* context) {
     NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
     NAPA_ASSERT(handle, "Zone handle is null");
     NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(worker_ids != nullptr || worker_ids_count == 0, "Worker ids are null");
 
     FunctionSpec req;
     req.module = spec.module;
@@ -132,16 +346,10 @@ void napa_zone_broadcast(napa_zone_handle handle,
     req.transportContext.reset(reinterpret_cast<napa::transport::TransportContext*>(spec.transport_context));
 
 
-    handle->zone->Broadcast(req, [callback, context](Result result) {
-        napa_zone_result res;
-        res.code = result.code;
-        res.error_message = STD_STRING_TO_NAPA_STRING_REF(result.errorMessage);
-        res.return_value = STD_STRING_TO_NAPA_STRING_REF(result.returnValue);
-
-        // Release ownership of transport context
-        res.transport_context = reinterpret_cast<void*>(result.transportContext.release());
-
-        callback(res, context);
+    std::vector<uint32_t> workerIds(worker_ids, worker_ids + worker_ids_count);
+    auto transport = req.options.transport;
+    handle->zone->Broadcast(req, workerIds, [callback, context, transport](Result result) {
+        callback(ToZoneResult(result, transport), context);
     });
 }
 
@@ -153,34 +361,325 @@ void napa_zone_execute(napa_zone_handle handle,
     NAPA_ASSERT(handle, "Zone handle is null");
     NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
 
-    FunctionSpec req;
-    req.module = spec.module;
-    req.function = spec.function;
+    auto req = ToFunctionSpec(spec);
 
-    req.arguments.reserve(spec.arguments_count);
-    for (size_t i = 0; i < spec.arguments_count; i++) {
-        req.arguments.emplace_back(spec.arguments[i]);
+    auto transport = req.options.transport;
+    handle->zone->Execute(req, [callback, context, transport](Result result) {
+        callback(ToZoneResult(result, transport), context);
+    });
+}
+
+void napa_zone_execute_on_worker(napa_zone_handle handle,
+                                 uint32_t worker_id,
+                                 napa_zone_function_spec spec,
+                                 napa_zone_execute_callback callback,
+                                 void* context) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+
+    auto req = ToFunctionSpec(spec);
+
+    auto transport = req.options.transport;
+    handle->zone->ExecuteOnWorker(worker_id, req, [callback, context, transport](Result result) {
+        callback(ToZoneResult(result, transport), context);
+    });
+}
+
+void napa_zone_execute_retained(napa_zone_handle handle,
+                                napa_zone_function_spec spec,
+                                napa_zone_execute_retained_callback callback,
+                                void* context) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+
+    auto req = ToFunctionSpec(spec);
+
+    auto transport = req.options.transport;
+    handle->zone->Execute(req, [callback, context, transport](Result result) {
+        napa::zone::CallContext::DecompressResult(result, transport);
+
+        napa_result_buffer_handle buffer;
+        auto res = api::ToRetainedResult(result, buffer);
+        callback(res, buffer, context);
+    });
+}
+
+void napa_zone_execute_into(napa_zone_handle handle,
+                            napa_zone_function_spec spec,
+                            char* buffer,
+                            size_t buffer_size,
+                            napa_zone_execute_callback callback,
+                            void* context) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(buffer != nullptr || buffer_size == 0, "Result buffer is null");
+
+    auto req = ToFunctionSpec(spec);
+
+    auto transport = req.options.transport;
+    handle->zone->Execute(req, [buffer, buffer_size, callback, context, transport](Result result) {
+        napa::zone::CallContext::DecompressResult(result, transport);
+        callback(api::ToBufferedResult(result, buffer, buffer_size), context);
+    });
+}
+
+napa_result_code napa_zone_execute_sync(napa_zone_handle handle,
+                                         napa_zone_function_spec spec,
+                                         uint32_t timeout,
+                                         napa_zone_result* result) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(result, "Result is null");
+
+    auto req = ToFunctionSpec(spec);
+
+    // The previous result of the slot is released here, its strings were valid until this call.
+    auto slot = _syncCallSlot.slot;
+    slot->result = Result();
+    slot->state.store(SyncCallSlot::WAITING, std::memory_order_relaxed);
+
+    handle->zone->Execute(req, [slot](Result result) {
+        slot->result = std::move(result);
+
+        auto expected = SyncCallSlot::WAITING;
+        if (slot->state.compare_exchange_strong(expected, SyncCallSlot::COMPLETED, std::memory_order_acq_rel)) {
+            napa::platform::WakeOnValue(slot->state);
+        } else {
+            // The caller stopped waiting, the slot is ours.
+            delete slot;
+        }
+    });
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    while (slot->state.load(std::memory_order_acquire) == SyncCallSlot::WAITING) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0 || !napa::platform::WaitOnValue(slot->state, SyncCallSlot::WAITING, remaining)) {
+            auto expected = SyncCallSlot::WAITING;
+            if (slot->state.compare_exchange_strong(expected, SyncCallSlot::ABANDONED, std::memory_order_acq_rel)) {
+                _syncCallSlot.slot = new SyncCallSlot();
+
+                *result = napa_zone_result();
+                result->code = NAPA_RESULT_TIMEOUT;
+                result->error_message = NAPA_STRING_REF("Synchronous execute timed out");
+                return NAPA_RESULT_TIMEOUT;
+            }
+        }
     }
 
-    req.options = spec.options;
+    *result = ToZoneResult(slot->result, req.options.transport);
+    return result->code;
+}
 
-    // Assume ownership of transport context
-    req.transportContext.reset(reinterpret_cast<napa::transport::TransportContext*>(spec.transport_context));
+void napa_result_retain(napa_result_buffer_handle buffer) {
+    api::RetainResultBuffer(buffer);
+}
+
+void napa_result_release(napa_result_buffer_handle buffer) {
+    api::ReleaseResultBuffer(buffer);
+}
+
+void napa_zone_execute_batch(napa_zone_handle handle,
+                             const napa_zone_function_spec* specs,
+                             size_t specs_count,
+                             napa_zone_execute_batch_callback callback,
+                             void* context) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(specs != nullptr || specs_count == 0, "Function specs are null");
+
+    std::vector<FunctionSpec> reqs;
+    reqs.reserve(specs_count);
+    for (size_t i = 0; i < specs_count; i++) {
+        reqs.emplace_back(ToFunctionSpec(specs[i]));
+    }
+
+    std::vector<TransportOption> transports;
+    transports.reserve(reqs.size());
+    for (auto& req : reqs) {
+        transports.push_back(req.options.transport);
+    }
+
+    handle->zone->ExecuteBatch(reqs, [callback, context, transports = std::move(transports)](std::vector<Result> results) {
+        std::vector<napa_zone_result> res(results.size());
+        for (size_t i = 0; i < results.size(); i++) {
+            res[i] = ToZoneResult(results[i], transports[i]);
+        }
+
+        callback(res.data(), res.size(), context);
+    });
+}
+
+void napa_zone_execute_native(napa_zone_handle handle,
+                              napa_zone_native_function function,
+                              void* context,
+                              napa_zone_native_callback callback) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(function != nullptr, "'function' should be a valid function.");
+
+    handle->zone->ExecuteNative([function, context]() {
+        function(context);
+    }, [callback, context](ResultCode code) {
+        if (callback != nullptr) {
+            callback(code, context);
+        }
+    });
+}
+
+void napa_zone_get_heap_statistics(napa_zone_handle handle,
+                                   napa_zone_heap_statistics_callback callback,
+                                   void* context) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+
+    handle->zone->GetHeapStatistics([callback, context](std::vector<HeapStatistics> statistics) {
+        callback(statistics.data(), statistics.size(), context);
+    });
+}
+
+void napa_zone_get_stats(napa_zone_handle handle, napa_zone_stats_callback callback, void* context) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(callback != nullptr, "'callback' should be a valid function.");
+
+    auto stats = handle->zone->GetStats();
+
+    napa_zone_stats result;
+    result.pending_tasks = stats.pendingTasks;
+    result.workers = stats.workers.data();
+    result.workers_count = stats.workers.size();
+
+    std::vector<napa_zone_tenant_stats> tenants;
+    tenants.reserve(stats.tenants.size());
+    for (const auto& tenant : stats.tenants) {
+        tenants.push_back({
+            tenant.tenant,
+            STD_STRING_TO_NAPA_STRING_REF(tenant.name),
+            tenant.queuedTasks,
+            tenant.dispatchedTasks,
+            tenant.waitTime,
+            tenant.maxWaitTime });
+    }
+    result.tenants = tenants.data();
+    result.tenants_count = tenants.size();
+
+    std::vector<napa_zone_function_counters> functions;
+    functions.reserve(stats.functions.size());
+    for (const auto& function : stats.functions) {
+        functions.push_back({
+            STD_STRING_TO_NAPA_STRING_REF(function.function),
+            function.calls,
+            function.cycles,
+            function.instructions,
+            function.cacheReferences,
+            function.cacheMisses });
+    }
+    result.functions = functions.data();
+    result.functions_count = functions.size();
+    callback(&result, context);
+}
+
+void napa_zone_get_function_stats(napa_zone_handle handle, napa_zone_function_stats_callback callback, void* context) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(callback != nullptr, "'callback' should be a valid function.");
+
+    auto stats = handle->zone->GetFunctionStats();
+
+    std::vector<napa_zone_function_stats> result;
+    result.reserve(stats.size());
+    for (const auto& function : stats) {
+        napa_zone_function_stats entry;
+        entry.module = STD_STRING_TO_NAPA_STRING_REF(function.module);
+        entry.function = STD_STRING_TO_NAPA_STRING_REF(function.function);
+        entry.calls = function.calls;
+        entry.errors = function.errors;
+        entry.total_time = function.totalTime;
+        entry.max_time = function.maxTime;
+        std::copy(std::begin(function.histogram), std::end(function.histogram), std::begin(entry.histogram));
+        result.push_back(entry);
+    }
+    callback(result.data(), result.size(), context);
+}
+
+void napa_zone_notify_memory_pressure(napa_zone_handle handle, napa_memory_pressure_level level) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+
+    handle->zone->NotifyMemoryPressure(level);
+}
+
+void napa_zone_start_profiling(napa_zone_handle handle,
+                               const uint32_t* worker_ids,
+                               size_t worker_ids_count,
+                               uint32_t sampling_interval) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
+    NAPA_ASSERT(worker_ids != nullptr || worker_ids_count == 0, "Worker ids are null");
+
+    std::vector<uint32_t> workerIds(worker_ids, worker_ids + worker_ids_count);
+    handle->zone->StartProfiling(workerIds, sampling_interval);
+}
 
-    handle->zone->Execute(req, [callback, context](Result result) {
-        napa_zone_result res;
-        res.code = result.code;
-        res.error_message = STD_STRING_TO_NAPA_STRING_REF(result.errorMessage);
-        res.return_value = STD_STRING_TO_NAPA_STRING_REF(result.returnValue);
+void napa_zone_stop_profiling(napa_zone_handle handle,
+                              napa_zone_cpu_profiles_callback callback,
+                              void* context) {
+    NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
+    NAPA_ASSERT(handle, "Zone handle is null");
+    NAPA_ASSERT(handle->zone, "Zone handle wasn't initialized");
 
-        // Release ownership of transport context
-        res.transport_context = reinterpret_cast<void*>(result.transportContext.release());
+    handle->zone->StopProfiling([callback, context](std::vector<CpuProfile> profiles) {
+        std::vector<napa_zone_cpu_profile> res(profiles.size());
+        for (size_t i = 0; i < profiles.size(); i++) {
+            res[i].worker_id = profiles[i].workerId;
+            res[i].profile = STD_STRING_TO_NAPA_STRING_REF(profiles[i].profile);
+        }
 
-        callback(res, context);
+        callback(res.data(), res.size(), context);
     });
 }
 
 static napa_result_code napa_initialize_common() {
+    const napa::memory::MallocLibrary* mallocLibrary = nullptr;
+    switch (_platformSettings.defaultAllocator) {
+        case napa::settings::AllocatorType::Pool:
+            napa_allocator_set(napa::memory::PoolAllocate, napa::memory::PoolDeallocate);
+            break;
+        case napa::settings::AllocatorType::Mimalloc:
+        case napa::settings::AllocatorType::Jemalloc: {
+            auto name = _platformSettings.defaultAllocator == napa::settings::AllocatorType::Mimalloc ? "mimalloc" : "jemalloc";
+            mallocLibrary = napa::memory::LoadMallocLibrary(name);
+            if (mallocLibrary != nullptr) {
+                napa::memory::SetMallocLibrary(mallocLibrary);
+                napa_allocator_set(mallocLibrary->allocate, mallocLibrary->deallocate);
+            } else {
+                LOG_WARNING("Api", "%s can't be loaded, the C runtime allocator is used instead", name);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    napa::memory::ArrayBufferPoolOptions arrayBufferPoolOptions;
+    arrayBufferPoolOptions.mallocLibrary = mallocLibrary;
+    arrayBufferPoolOptions.maxPooledSize = static_cast<size_t>(_platformSettings.arrayBufferPoolSize);
+    arrayBufferPoolOptions.hugePages = _platformSettings.arrayBufferHugePages;
+    if (!napa::memory::SetArrayBufferPoolOptions(arrayBufferPoolOptions)) {
+        LOG_WARNING("Api", "ArrayBuffer pool is already in use, its settings are ignored");
+    }
+
     if (!napa::providers::Initialize(_platformSettings)) {
         return NAPA_RESULT_PROVIDERS_INIT_ERROR;
     }
@@ -189,6 +688,20 @@ static napa_result_code napa_initialize_common() {
         return NAPA_RESULT_V8_INIT_ERROR;
     }
 
+    napa::module::CodeCache::GetInstance().SetDirectory(_platformSettings.codeCacheDirectory);
+    napa::module::FileStatusCache::GetInstance().SetMode(_platformSettings.moduleStatusCache);
+    napa::module::JsonModuleCache::GetInstance().SetEnabled(_platformSettings.sharedJsonModules);
+
+    if (_platformSettings.prewarmIsolates > 0) {
+        napa::zone::IsolatePool::GetInstance().SetSize(_platformSettings.prewarmIsolates);
+    }
+
+    if (_platformSettings.consoleBufferSize > 0) {
+        napa::utils::ConsoleBufferOptions consoleBufferOptions;
+        consoleBufferOptions.flushSize = _platformSettings.consoleBufferSize;
+        napa::utils::GetConsoleBuffer().Start(consoleBufferOptions);
+    }
+
     _initialized = true;
 
     NAPA_DEBUG("Api", "Napa platform initialized successfully");
@@ -219,6 +732,19 @@ napa_result_code napa_initialize_from_console(int argc, const char* argv[]) {
 napa_result_code napa_shutdown() {
     NAPA_ASSERT(_initialized, "Napa platform wasn't initialized");
 
+    // Served zones stop taking calls before their workers go away.
+    {
+        std::lock_guard<std::mutex> lock(_serversLock);
+        _servers.clear();
+        _sharedMemoryServers.clear();
+    }
+
+    // Pooled isolates are disposed while V8 is still up.
+    napa::zone::IsolatePool::GetInstance().SetSize(0);
+
+    // Console output buffered by workers is written before shutdown returns.
+    napa::utils::GetConsoleBuffer().Stop();
+
     napa::providers::Shutdown();
     napa::v8_common::Shutdown();
 
@@ -247,6 +773,75 @@ const char* napa_result_code_to_string(napa_result_code code) {
 }
 
 
+///////////////////////////////////////////////////////////////
+/// Implementation of napa.metric C API
+
+napa_result_code napa_metric_snapshot(
+    napa_metric_snapshot_format format,
+    napa_metric_snapshot_callback callback,
+    void* context) {
+    NAPA_ASSERT(callback != nullptr, "'callback' should be a valid function.");
+
+    std::string snapshot;
+    if (!napa::providers::GetMetricSnapshot(format, snapshot)) {
+        return NAPA_RESULT_METRIC_SNAPSHOT_ERROR;
+    }
+
+    callback(STD_STRING_TO_NAPA_STRING_REF(snapshot), context);
+    return NAPA_RESULT_SUCCESS;
+}
+
+napa_result_code napa_module_bundle_write(napa_string_ref path) {
+    auto written = napa::module::ModuleBundle::Write(
+        NAPA_STRING_REF_TO_STD_STRING(path),
+        napa::module::ModuleResolverCache::GetInstance(),
+        napa::module::ModuleSourceCache::GetInstance(),
+        napa::module::CodeCache::GetInstance());
+
+    return written ? NAPA_RESULT_SUCCESS : NAPA_RESULT_MODULE_BUNDLE_ERROR;
+}
+
+
+///////////////////////////////////////////////////////////////
+/// Implementation of napa.trace C API
+
+napa_result_code napa_trace_start(size_t events_per_thread) {
+    if (events_per_thread == 0) {
+        events_per_thread = napa::zone::DEFAULT_TRACE_EVENTS_PER_THREAD;
+    }
+
+    auto started = napa::zone::TraceRecorder::GetInstance().Start(events_per_thread);
+    return started ? NAPA_RESULT_SUCCESS : NAPA_RESULT_TRACE_STARTED;
+}
+
+napa_result_code napa_trace_stop(napa_trace_callback callback, void* context) {
+    NAPA_ASSERT(callback != nullptr, "'callback' should be a valid function.");
+
+    std::string trace;
+    if (!napa::zone::TraceRecorder::GetInstance().Stop(trace)) {
+        return NAPA_RESULT_TRACE_NOT_STARTED;
+    }
+
+    callback(STD_STRING_TO_NAPA_STRING_REF(trace), context);
+    return NAPA_RESULT_SUCCESS;
+}
+
+void napa_spans_set_sampling(double sample_rate, size_t capacity) {
+    if (capacity == 0) {
+        capacity = napa::zone::DEFAULT_SPAN_CAPACITY;
+    }
+
+    napa::zone::SpanRecorder::GetInstance().SetSampling(sample_rate, capacity);
+}
+
+void napa_spans_export(napa_trace_callback callback, void* context) {
+    NAPA_ASSERT(callback != nullptr, "'callback' should be a valid function.");
+
+    auto spans = napa::zone::SpanRecorder::ToJson(napa::zone::SpanRecorder::GetInstance().Export());
+    callback(STD_STRING_TO_NAPA_STRING_REF(spans), context);
+}
+
+
 ///////////////////////////////////////////////////////////////
 /// Implementation of napa.memory C API
 
@@ -258,6 +853,14 @@ void napa_free(void* pointer, size_t /*size_hint*/) {
     ::free(pointer);
 }
 
+void* napa_pool_allocate(size_t size) {
+    return napa::memory::PoolAllocate(size);
+}
+
+void napa_pool_deallocate(void* pointer, size_t size_hint) {
+    napa::memory::PoolDeallocate(pointer, size_hint);
+}
+
 namespace {
     napa_allocate_callback _global_allocate = napa_malloc;
     napa_deallocate_callback _global_deallocate = napa_free;
@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "arena-allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace napa::memory;
+
+namespace {
+    constexpr size_t ALIGNMENT = 16;
+
+    size_t AlignUp(size_t size) {
+        return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+}
+
+/// <summary> Chunk headers keep allocations aligned. </summary>
+static const size_t CHUNK_HEADER_SIZE = AlignUp(sizeof(void*) + sizeof(size_t));
+
+ArenaAllocator::ArenaAllocator(Allocator& backing, size_t chunkSize) :
+    _backing(backing),
+    _chunkSize(std::max(AlignUp(chunkSize), CHUNK_HEADER_SIZE + ALIGNMENT)),
+    _chunks(nullptr),
+    _current(nullptr),
+    _end(nullptr),
+    _allocatedSize(0) {
+}
+
+ArenaAllocator::~ArenaAllocator() {
+    while (_chunks != nullptr) {
+        auto chunk = _chunks;
+        _chunks = chunk->previous;
+        _backing.Deallocate(chunk, chunk->size);
+    }
+}
+
+void* ArenaAllocator::Allocate(size_t size) {
+    size = AlignUp(std::max<size_t>(size, 1));
+    _allocatedSize += size;
+
+    if (static_cast<size_t>(_end - _current) >= size) {
+        auto memory = _current;
+        _current += size;
+        return memory;
+    }
+    return AllocateChunk(size);
+}
+
+void ArenaAllocator::Deallocate(void*, size_t) {
+}
+
+const char* ArenaAllocator::GetType() const {
+    return "ArenaAllocator";
+}
+
+bool ArenaAllocator::operator==(const Allocator& other) const {
+    return &other == this;
+}
+
+void ArenaAllocator::Reset() {
+    _allocatedSize = 0;
+    if (_chunks == nullptr) {
+        return;
+    }
+
+    // The oldest regular chunk is kept, so a steady flow of tasks doesn't touch the backing allocator.
+    Chunk* kept = nullptr;
+    for (auto chunk = _chunks; chunk != nullptr; chunk = chunk->previous) {
+        if (chunk->size == _chunkSize) {
+            kept = chunk;
+        }
+    }
+    while (_chunks != nullptr) {
+        auto chunk = _chunks;
+        _chunks = chunk->previous;
+        if (chunk != kept) {
+            _backing.Deallocate(chunk, chunk->size);
+        }
+    }
+
+    _chunks = kept;
+    if (kept != nullptr) {
+        kept->previous = nullptr;
+        _current = reinterpret_cast<char*>(kept) + CHUNK_HEADER_SIZE;
+        _end = reinterpret_cast<char*>(kept) + kept->size;
+    } else {
+        _current = _end = nullptr;
+    }
+}
+
+size_t ArenaAllocator::GetAllocatedSize() const {
+    return _allocatedSize;
+}
+
+void* ArenaAllocator::AllocateChunk(size_t size) {
+    // Allocations larger than half a chunk get a chunk of their own, so the current chunk keeps serving small ones.
+    bool dedicated = size > (_chunkSize - CHUNK_HEADER_SIZE) / 2;
+    auto chunkSize = dedicated ? CHUNK_HEADER_SIZE + size : _chunkSize;
+
+    auto chunk = static_cast<Chunk*>(_backing.Allocate(chunkSize));
+    chunk->size = chunkSize;
+    chunk->previous = _chunks;
+    _chunks = chunk;
+
+    auto memory = reinterpret_cast<char*>(chunk) + CHUNK_HEADER_SIZE;
+    if (!dedicated) {
+        _current = memory + size;
+        _end = reinterpret_cast<char*>(chunk) + chunkSize;
+    }
+    return memory;
+}
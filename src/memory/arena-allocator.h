@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/memory/allocator.h>
+
+#include <cstddef>
+
+namespace napa {
+namespace memory {
+
+    /// <summary> A bump pointer allocator whose memory is all released at once by Reset. </summary>
+    /// <remarks>
+    ///     Allocations are carved from chunks of the backing allocator and Deallocate does nothing. Reset keeps the
+    ///     first chunk for the next round and returns the others. It's not thread safe, each thread owns its arena.
+    /// </remarks>
+    class ArenaAllocator : public Allocator {
+    public:
+        /// <summary> Constructor. </summary>
+        /// <param name="backing"> The allocator chunks come from, it must outlive the arena. </param>
+        /// <param name="chunkSize"> The size of a chunk, larger allocations get a chunk of their own. </param>
+        ArenaAllocator(Allocator& backing, size_t chunkSize);
+
+        /// <summary> Destructor. Returns all chunks to the backing allocator. </summary>
+        ~ArenaAllocator();
+
+        ArenaAllocator(const ArenaAllocator&) = delete;
+        ArenaAllocator& operator=(const ArenaAllocator&) = delete;
+
+        /// <summary> Allocates 16 bytes aligned memory valid until the next Reset. </summary>
+        void* Allocate(size_t size) override;
+
+        /// <summary> Does nothing, memory is released by Reset. </summary>
+        void Deallocate(void* memory, size_t sizeHint) override;
+
+        /// <summary> Get allocator type for better debuggability. </summary>
+        const char* GetType() const override;
+
+        /// <summary> Tell if another allocator is this arena. </summary>
+        bool operator==(const Allocator& other) const override;
+
+        /// <summary> Releases all memory allocated since the last reset. </summary>
+        void Reset();
+
+        /// <summary> Returns the number of bytes allocated since the last reset, including alignment padding. </summary>
+        size_t GetAllocatedSize() const;
+
+    private:
+        /// <summary> Chunks link to the previous one, the allocations follow the header. </summary>
+        struct Chunk {
+            Chunk* previous;
+            size_t size;
+        };
+
+        /// <summary> Adds a chunk that holds at least the given size, and makes it current if it's a regular one. </summary>
+        void* AllocateChunk(size_t size);
+
+        Allocator& _backing;
+        const size_t _chunkSize;
+        Chunk* _chunks;
+        char* _current;
+        char* _end;
+        size_t _allocatedSize;
+    };
+}
+}
@@ -0,0 +1,237 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "array-buffer-pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using namespace napa::memory;
+
+namespace {
+
+    constexpr size_t MIN_POOLED_POWER = 15;
+
+    size_t RoundUp(size_t size, size_t alignment) {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    /// <summary> Class 0 is MIN_POOLED_LENGTH, then 2^power < blockSize <= 2^(power + 1) is split into 4 steps. </summary>
+    size_t GetClassIndex(size_t blockSize) {
+        if (blockSize <= ArrayBufferPool::MIN_POOLED_LENGTH) {
+            return 0;
+        }
+        size_t power = MIN_POOLED_POWER;
+        while ((size_t(1) << (power + 1)) < blockSize) {
+            ++power;
+        }
+        size_t step = size_t(1) << (power - 2);
+        size_t offset = (blockSize - (size_t(1) << power) + step - 1) / step - 1;
+        return 1 + (power - MIN_POOLED_POWER) * 4 + offset;
+    }
+
+    size_t GetClassSize(size_t index) {
+        if (index == 0) {
+            return ArrayBufferPool::MIN_POOLED_LENGTH;
+        }
+        size_t power = MIN_POOLED_POWER + (index - 1) / 4;
+        size_t step = size_t(1) << (power - 2);
+        return (size_t(1) << power) + ((index - 1) % 4 + 1) * step;
+    }
+}
+
+constexpr size_t ArrayBufferPool::MIN_POOLED_LENGTH;
+constexpr size_t ArrayBufferPool::MAX_POOLED_LENGTH;
+
+ArrayBufferPool::ArrayBufferPool(const ArrayBufferPoolOptions& options) :
+    _options(options),
+    _allocations(0),
+    _poolHits(0),
+    _mappedBlocks(0),
+    _hugePageBlocks(0),
+    _liveBuffers(0),
+    _liveSize(0),
+    _pooledBlocks(0),
+    _pooledSize(0) {
+}
+
+ArrayBufferPool::~ArrayBufferPool() {
+    Trim();
+}
+
+void* ArrayBufferPool::Allocate(size_t length, bool zeroed) {
+    void* data = nullptr;
+    auto blockSize = GetBlockSize(length);
+    if (blockSize == 0) {
+        // Allocated lengths of 0 must still be distinct pointers.
+        auto size = std::max<size_t>(length, 1);
+        auto library = _options.mallocLibrary;
+        if (library != nullptr) {
+            data = zeroed ? library->allocateZeroed(size) : library->allocate(size);
+        } else {
+            data = zeroed ? std::calloc(1, size) : std::malloc(size);
+        }
+    } else {
+        if (blockSize <= MAX_POOLED_LENGTH) {
+            auto& sizeClass = _classes[GetClassIndex(blockSize)];
+            {
+                std::lock_guard<std::mutex> lock(sizeClass.mutex);
+                auto block = sizeClass.blocks;
+                if (block != nullptr) {
+                    sizeClass.blocks = block->next;
+                    data = block;
+                }
+            }
+            if (data != nullptr) {
+                _pooledBlocks--;
+                _pooledSize -= blockSize;
+                _poolHits++;
+
+                // Only pooled blocks were written to, fresh mappings are zero-filled.
+                if (zeroed) {
+                    std::memset(data, 0, length);
+                }
+            }
+        }
+        if (data == nullptr) {
+            data = MapBlock(blockSize);
+        }
+        if (data == nullptr && _pooledBlocks > 0) {
+            // Blocks pooled for other lengths are returned to make room.
+            Trim();
+            data = MapBlock(blockSize);
+        }
+    }
+
+    if (data != nullptr) {
+        _allocations++;
+        _liveBuffers++;
+        _liveSize += length;
+    }
+    return data;
+}
+
+void ArrayBufferPool::Free(void* data, size_t length) {
+    if (data == nullptr) {
+        return;
+    }
+    _liveBuffers--;
+    _liveSize -= length;
+
+    auto blockSize = GetBlockSize(length);
+    if (blockSize == 0) {
+        if (_options.mallocLibrary != nullptr) {
+            _options.mallocLibrary->deallocate(data, length);
+        } else {
+            std::free(data);
+        }
+        return;
+    }
+
+    if (blockSize <= MAX_POOLED_LENGTH) {
+        if (_pooledSize.fetch_add(blockSize) + blockSize <= _options.maxPooledSize) {
+            auto& sizeClass = _classes[GetClassIndex(blockSize)];
+            auto block = static_cast<FreeBlock*>(data);
+            {
+                std::lock_guard<std::mutex> lock(sizeClass.mutex);
+                block->next = sizeClass.blocks;
+                sizeClass.blocks = block;
+            }
+            _pooledBlocks++;
+            return;
+        }
+        _pooledSize -= blockSize;
+    }
+    UnmapBlock(data, blockSize);
+}
+
+size_t ArrayBufferPool::GetBlockSize(size_t length) const {
+    if (length < MIN_POOLED_LENGTH) {
+        return 0;
+    }
+
+    auto blockSize = length <= MAX_POOLED_LENGTH ? GetClassSize(GetClassIndex(length)) : RoundUp(length, platform::GetPageSize());
+    if (_options.hugePages != platform::HugePages::None && blockSize >= platform::HUGE_PAGE_SIZE) {
+        blockSize = RoundUp(blockSize, platform::HUGE_PAGE_SIZE);
+    }
+    return blockSize;
+}
+
+ArrayBufferPoolStats ArrayBufferPool::GetStats() const {
+    ArrayBufferPoolStats stats;
+    stats.allocations = _allocations;
+    stats.poolHits = _poolHits;
+    stats.mappedBlocks = _mappedBlocks;
+    stats.hugePageBlocks = _hugePageBlocks;
+    stats.liveBuffers = _liveBuffers;
+    stats.liveSize = _liveSize;
+    stats.pooledBlocks = _pooledBlocks;
+    stats.pooledSize = _pooledSize;
+    return stats;
+}
+
+void ArrayBufferPool::Trim() {
+    for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i) {
+        auto& sizeClass = _classes[i];
+        FreeBlock* blocks = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(sizeClass.mutex);
+            std::swap(blocks, sizeClass.blocks);
+        }
+
+        auto blockSize = GetClassSize(i);
+        while (blocks != nullptr) {
+            auto next = blocks->next;
+            UnmapBlock(blocks, blockSize);
+            _pooledBlocks--;
+            _pooledSize -= blockSize;
+            blocks = next;
+        }
+    }
+}
+
+void* ArrayBufferPool::MapBlock(size_t blockSize) {
+    bool hugePagesUsed = false;
+    auto block = platform::MapPages(blockSize, _options.hugePages, &hugePagesUsed);
+    if (block != nullptr) {
+        _mappedBlocks++;
+        if (hugePagesUsed) {
+            _hugePageBlocks++;
+        }
+    }
+    return block;
+}
+
+void ArrayBufferPool::UnmapBlock(void* block, size_t blockSize) {
+    platform::UnmapPages(block, blockSize);
+}
+
+namespace {
+    std::mutex _poolMutex;
+    std::atomic<ArrayBufferPool*> _pool(nullptr);
+    ArrayBufferPoolOptions _poolOptions;
+}
+
+bool napa::memory::SetArrayBufferPoolOptions(const ArrayBufferPoolOptions& options) {
+    std::lock_guard<std::mutex> lock(_poolMutex);
+    if (_pool.load() != nullptr) {
+        return false;
+    }
+    _poolOptions = options;
+    return true;
+}
+
+ArrayBufferPool& napa::memory::GetArrayBufferPool() {
+    auto pool = _pool.load(std::memory_order_acquire);
+    if (pool == nullptr) {
+        std::lock_guard<std::mutex> lock(_poolMutex);
+        pool = _pool.load();
+        if (pool == nullptr) {
+            // Isolates may release buffers during process exit, so the pool is never destroyed.
+            pool = new ArrayBufferPool(_poolOptions);
+            _pool.store(pool, std::memory_order_release);
+        }
+    }
+    return *pool;
+}
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "malloc-library.h"
+
+#include <napa/memory/array-buffer-pool.h>
+#include <platform/virtual-memory.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace napa {
+namespace memory {
+
+    /// <summary> Options of an ArrayBufferPool. </summary>
+    struct ArrayBufferPoolOptions {
+
+        /// <summary> The most memory released blocks may keep, beyond which they're returned to the system. 0 disables pooling. </summary>
+        size_t maxPooledSize = 64 * 1024 * 1024;
+
+        /// <summary> Whether blocks of at least platform::HUGE_PAGE_SIZE are backed by huge pages. </summary>
+        platform::HugePages hugePages = platform::HugePages::None;
+
+        /// <summary> The library buffers shorter than MIN_POOLED_LENGTH come from, nullptr for the C runtime. </summary>
+        const MallocLibrary* mallocLibrary = nullptr;
+    };
+
+    /// <summary> Size class pools of zero-filled pages for ArrayBuffer memory. </summary>
+    /// <remarks>
+    ///     Buffers shorter than MIN_POOLED_LENGTH come from calloc, or the malloc library of the options. Longer ones are page mappings, which the system
+    ///     zero-fills, rounded up to one of 4 size classes per power of 2. Released blocks up to MAX_POOLED_LENGTH are kept
+    ///     for reuse, and are cleared again only when a zero-filled buffer is asked for. The owner of a buffer releases it
+    ///     with its length, which is how its block size is known.
+    /// </remarks>
+    class ArrayBufferPool {
+    public:
+
+        /// <summary> Buffers from this length on are page mappings. </summary>
+        static constexpr size_t MIN_POOLED_LENGTH = 32 * 1024;
+
+        /// <summary> Released blocks of buffers up to this length are kept for reuse. </summary>
+        static constexpr size_t MAX_POOLED_LENGTH = 4 * 1024 * 1024;
+
+        /// <summary> Constructor. </summary>
+        explicit ArrayBufferPool(const ArrayBufferPoolOptions& options);
+
+        /// <summary> Returns the pooled blocks to the system, buffers in use must be released before. </summary>
+        ~ArrayBufferPool();
+
+        ArrayBufferPool(const ArrayBufferPool&) = delete;
+        ArrayBufferPool& operator=(const ArrayBufferPool&) = delete;
+
+        /// <summary> Allocate memory of a buffer. </summary>
+        /// <param name="length"> The buffer length. </param>
+        /// <param name="zeroed"> Whether the memory must be zero-filled. </param>
+        /// <returns> The memory, or nullptr if there's none left. </returns>
+        void* Allocate(size_t length, bool zeroed);
+
+        /// <summary> Release memory of a buffer. </summary>
+        /// <param name="data"> The memory from Allocate, nullptr is ignored. </param>
+        /// <param name="length"> The length it was allocated with. </param>
+        void Free(void* data, size_t length);
+
+        /// <summary> Get the size of the block serving a buffer length, or 0 if it comes from calloc. </summary>
+        size_t GetBlockSize(size_t length) const;
+
+        /// <summary> Get the pool statistics. </summary>
+        ArrayBufferPoolStats GetStats() const;
+
+        /// <summary> Return the pooled blocks to the system. </summary>
+        void Trim();
+
+    private:
+
+        /// <summary> 4 classes per power of 2 from MIN_POOLED_LENGTH to MAX_POOLED_LENGTH. </summary>
+        static constexpr size_t SIZE_CLASS_COUNT = 7 * 4 + 1;
+
+        /// <summary> A released block links to the next one in place. </summary>
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        struct SizeClass {
+            std::mutex mutex;
+            FreeBlock* blocks = nullptr;
+        };
+
+        void* MapBlock(size_t blockSize);
+        void UnmapBlock(void* block, size_t blockSize);
+
+        const ArrayBufferPoolOptions _options;
+        SizeClass _classes[SIZE_CLASS_COUNT];
+
+        std::atomic<uint64_t> _allocations;
+        std::atomic<uint64_t> _poolHits;
+        std::atomic<uint64_t> _mappedBlocks;
+        std::atomic<uint64_t> _hugePageBlocks;
+        std::atomic<uint64_t> _liveBuffers;
+        std::atomic<uint64_t> _liveSize;
+        std::atomic<uint64_t> _pooledBlocks;
+        std::atomic<uint64_t> _pooledSize;
+    };
+
+    /// <summary> Set the options of the pool shared by all isolates. </summary>
+    /// <returns> False if the pool is already in use, and keeps its options. </returns>
+    bool SetArrayBufferPoolOptions(const ArrayBufferPoolOptions& options);
+
+    /// <summary> Get the pool shared by all isolates, which is never destroyed. </summary>
+    ArrayBufferPool& GetArrayBufferPool();
+}
+}
@@ -1,6 +1,11 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
+#include "array-buffer-pool.h"
+#include "pool-allocator.h"
+
+#include <zone/worker-context.h>
+
 #include <napa/memory.h>
 #include <napa/capi.h>
 #include <cstring>
@@ -63,6 +68,35 @@ public:
     }
 };
 
+/// <summary> Allocator that uses the size class pool with thread caches from napa.dll. </summary>
+class PoolAllocator: public napa::memory::Allocator {
+public:
+    /// <summary> Allocate memory of given size. </summary>
+    /// <param name="size"> Requested size. </summary>
+    /// <returns> Allocated memory. May throw if error happens. </returns>
+    void* Allocate(size_t size) override {
+        return napa::memory::PoolAllocate(size);
+    }
+
+    /// <summary> Deallocate memory allocated from this allocator. </summary>
+    /// <param name="memory"> Pointer to the memory. </summary>
+    /// <param name="sizeHint"> Hint of size to delete. 0 if not available from caller. </summary>
+    /// <returns> None. May throw if error happens. </returns>
+    void Deallocate(void* memory, size_t sizeHint) override {
+        napa::memory::PoolDeallocate(memory, sizeHint);
+    }
+
+    /// <summary> Get allocator type for better debuggability. </summary>
+    const char* GetType() const override {
+        return "PoolAllocator";
+    }
+
+    /// <summary> Tell if another allocator equals to this allocator. </summary>
+    bool operator==(const Allocator& other) const override {
+        return std::strcmp(other.GetType(), GetType()) == 0;
+    }
+};
+
 namespace napa {
 namespace memory {
 
@@ -70,6 +104,7 @@ namespace memory {
         // Never destory to ensure they live longer than all consumers.
         auto _crtAllocator = new CrtAllocator();
         auto _defaultAllocator = new DefaultAllocator();
+        auto _poolAllocator = new PoolAllocator();
     }
 
     Allocator& GetCrtAllocator() {
@@ -79,5 +114,23 @@ namespace memory {
     Allocator& GetDefaultAllocator() {
         return *_defaultAllocator;
     }
+
+    Allocator& GetPoolAllocator() {
+        return *_poolAllocator;
+    }
+
+    Allocator& GetZoneAllocator() {
+        auto allocator = static_cast<Allocator*>(zone::WorkerContext::Get(zone::WorkerContextItem::ALLOCATOR));
+        return allocator != nullptr ? *allocator : *_defaultAllocator;
+    }
+
+    Allocator& GetTaskArena() {
+        auto arena = static_cast<Allocator*>(zone::WorkerContext::Get(zone::WorkerContextItem::TASK_ARENA));
+        return arena != nullptr ? *arena : GetZoneAllocator();
+    }
+
+    ArrayBufferPoolStats GetArrayBufferPoolStats() {
+        return GetArrayBufferPool().GetStats();
+    }
 } // namespace memory
 } // namespace napa
\ No newline at end of file
@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "malloc-library.h"
+
+#include <platform/dll.h>
+#include <platform/platform.h>
+
+#include <napa/log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+using namespace napa;
+using namespace napa::memory;
+
+namespace {
+
+    /// <summary> Opens the first library that can be loaded, nullptr if none can. </summary>
+    std::unique_ptr<dll::SharedLibrary> OpenLibrary(const std::vector<std::string>& fileNames) {
+        for (const auto& fileName : fileNames) {
+            try {
+                return std::make_unique<dll::SharedLibrary>(fileName);
+            } catch (const std::runtime_error&) {
+                // Try the next name.
+            }
+        }
+        return nullptr;
+    }
+
+    /// <summary> Entry points of mimalloc. </summary>
+    namespace mimalloc {
+        void* (*_malloc)(size_t size) = nullptr;
+        void* (*_zalloc)(size_t size) = nullptr;
+        void (*_free)(void* memory) = nullptr;
+        void (*_processInfo)(size_t* elapsedMsecs, size_t* userMsecs, size_t* systemMsecs,
+                             size_t* currentRss, size_t* peakRss,
+                             size_t* currentCommit, size_t* peakCommit, size_t* pageFaults) = nullptr;
+
+        void* Allocate(size_t size) {
+            return _malloc(size);
+        }
+
+        void* AllocateZeroed(size_t size) {
+            return _zalloc(size);
+        }
+
+        void Deallocate(void* memory, size_t /*sizeHint*/) {
+            _free(memory);
+        }
+
+        void GetStats(MallocLibraryStats& stats) {
+            if (_processInfo == nullptr) {
+                return;
+            }
+            size_t currentRss = 0;
+            size_t peakRss = 0;
+            size_t currentCommit = 0;
+            _processInfo(nullptr, nullptr, nullptr, &currentRss, &peakRss, &currentCommit, nullptr, nullptr);
+
+            stats.committedSize = currentCommit;
+            stats.residentSize = currentRss;
+            stats.peakResidentSize = peakRss;
+        }
+
+        const MallocLibrary* Load() {
+            static std::vector<std::string> fileNames = {
+#ifdef SUPPORT_POSIX
+                "libmimalloc.so.2", "libmimalloc.so", "libmimalloc.dylib"
+#else
+                "mimalloc-override.dll", "mimalloc.dll"
+#endif
+            };
+
+            static auto library = OpenLibrary(fileNames);
+            if (library == nullptr) {
+                return nullptr;
+            }
+
+            _malloc = library->Import<void*(size_t)>("mi_malloc");
+            _zalloc = library->Import<void*(size_t)>("mi_zalloc");
+            _free = library->Import<void(void*)>("mi_free");
+            _processInfo = library->Import<void(size_t*, size_t*, size_t*, size_t*, size_t*, size_t*, size_t*, size_t*)>(
+                "mi_process_info");
+            if (_malloc == nullptr || _zalloc == nullptr || _free == nullptr) {
+                return nullptr;
+            }
+
+            static const MallocLibrary entryPoints = { "mimalloc", Allocate, AllocateZeroed, Deallocate, GetStats };
+            return &entryPoints;
+        }
+    }
+
+    /// <summary> Entry points of jemalloc, through its non-standard API so an unprefixed build isn't mistaken for malloc. </summary>
+    namespace jemalloc {
+        constexpr int MALLOCX_ZERO = 0x40;
+
+        void* (*_mallocx)(size_t size, int flags) = nullptr;
+        void (*_dallocx)(void* memory, int flags) = nullptr;
+        int (*_mallctl)(const char* name, void* oldValue, size_t* oldSize, void* newValue, size_t newSize) = nullptr;
+
+        void* Allocate(size_t size) {
+            // Requests of 0 bytes are undefined for mallocx.
+            return _mallocx(std::max<size_t>(size, 1), 0);
+        }
+
+        void* AllocateZeroed(size_t size) {
+            return _mallocx(std::max<size_t>(size, 1), MALLOCX_ZERO);
+        }
+
+        void Deallocate(void* memory, size_t /*sizeHint*/) {
+            // Size hints are not always the allocated size, which sdallocx requires.
+            if (memory != nullptr) {
+                _dallocx(memory, 0);
+            }
+        }
+
+        uint64_t ReadSize(const char* name) {
+            size_t value = 0;
+            size_t size = sizeof(value);
+            return _mallctl(name, &value, &size, nullptr, 0) == 0 ? value : 0;
+        }
+
+        void GetStats(MallocLibraryStats& stats) {
+            // Statistics are a snapshot taken when the epoch advances.
+            uint64_t epoch = 1;
+            size_t size = sizeof(epoch);
+            _mallctl("epoch", &epoch, &size, &epoch, size);
+
+            stats.allocatedSize = ReadSize("stats.allocated");
+            stats.committedSize = ReadSize("stats.active");
+            stats.residentSize = ReadSize("stats.resident");
+        }
+
+        const MallocLibrary* Load() {
+            static std::vector<std::string> fileNames = {
+#ifdef SUPPORT_POSIX
+                "libjemalloc.so.2", "libjemalloc.so", "libjemalloc.dylib"
+#else
+                "jemalloc.dll"
+#endif
+            };
+
+            static auto library = OpenLibrary(fileNames);
+            if (library == nullptr) {
+                return nullptr;
+            }
+
+            _mallocx = library->Import<void*(size_t, int)>("mallocx");
+            _dallocx = library->Import<void(void*, int)>("dallocx");
+            _mallctl = library->Import<int(const char*, void*, size_t*, void*, size_t)>("mallctl");
+            if (_mallocx == nullptr || _dallocx == nullptr || _mallctl == nullptr) {
+                return nullptr;
+            }
+
+            static const MallocLibrary entryPoints = { "jemalloc", Allocate, AllocateZeroed, Deallocate, GetStats };
+            return &entryPoints;
+        }
+    }
+
+    std::atomic<const MallocLibrary*> _library(nullptr);
+}
+
+const MallocLibrary* napa::memory::LoadMallocLibrary(const std::string& name) {
+    // Libraries are loaded once, the entry points are never reset.
+    static std::mutex loadLock;
+    std::lock_guard<std::mutex> lock(loadLock);
+
+    if (name == "mimalloc") {
+        static auto library = mimalloc::Load();
+        return library;
+    } else if (name == "jemalloc") {
+        static auto library = jemalloc::Load();
+        return library;
+    }
+
+    LOG_ERROR("Memory", "Unknown malloc library: %s", name.c_str());
+    return nullptr;
+}
+
+void napa::memory::SetMallocLibrary(const MallocLibrary* library) {
+    _library = library;
+}
+
+const MallocLibrary* napa::memory::GetMallocLibrary() {
+    return _library;
+}
+
+MallocLibraryStats napa::memory::GetMallocLibraryStats() {
+    MallocLibraryStats stats = {};
+    stats.name = "";
+
+    auto library = GetMallocLibrary();
+    if (library != nullptr) {
+        stats.name = library->name;
+        library->getStats(stats);
+    }
+    return stats;
+}
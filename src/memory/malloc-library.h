@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/memory/malloc-library.h>
+
+#include <cstddef>
+#include <string>
+
+namespace napa {
+namespace memory {
+
+    /// <summary> Entry points of a malloc library loaded at run time. </summary>
+    struct MallocLibrary {
+
+        /// <summary> The name the library was loaded by. </summary>
+        const char* name;
+
+        /// <summary> Allocates memory, with the signature of napa_allocate_callback. </summary>
+        void* (*allocate)(size_t size);
+
+        /// <summary> Allocates zero-filled memory. </summary>
+        void* (*allocateZeroed)(size_t size);
+
+        /// <summary> Deallocates memory, with the signature of napa_deallocate_callback. </summary>
+        void (*deallocate)(void* memory, size_t sizeHint);
+
+        /// <summary> Fills the sizes of the statistics. </summary>
+        void (*getStats)(MallocLibraryStats& stats);
+    };
+
+    /// <summary> Loads a malloc library, 'mimalloc' or 'jemalloc'. </summary>
+    /// <remarks>
+    ///     The library isn't linked to napa, it is found in the process if it was linked or preloaded with it,
+    ///     otherwise on the library search path. Loaded libraries stay loaded with the process.
+    /// </remarks>
+    /// <returns> The library, or nullptr if the name is unknown or the library wasn't found. </returns>
+    const MallocLibrary* LoadMallocLibrary(const std::string& name);
+
+    /// <summary> Makes the library the one GetMallocLibraryStats reports, before it serves any memory. </summary>
+    void SetMallocLibrary(const MallocLibrary* library);
+
+    /// <summary> Returns the library set by SetMallocLibrary, or nullptr if there is none. </summary>
+    const MallocLibrary* GetMallocLibrary();
+}
+}
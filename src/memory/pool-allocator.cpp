@@ -0,0 +1,257 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "pool-allocator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+using namespace napa::memory;
+
+namespace {
+
+    /// <summary> Blocks of 16 bytes steps up to 256 bytes, then 4 classes per power of 2 up to 32KB. </summary>
+    constexpr size_t SMALL_CLASS_COUNT = 16;
+    constexpr size_t SMALL_CLASS_LIMIT = 256;
+    constexpr size_t SIZE_CLASS_COUNT = SMALL_CLASS_COUNT + 7 * 4;
+
+    /// <summary> Blocks are carved from spans of at least this size. </summary>
+    constexpr size_t SPAN_SIZE = 64 * 1024;
+
+    /// <summary> The size class recorded for memory from the C runtime allocator. </summary>
+    constexpr uint32_t LARGE_CLASS = UINT32_MAX;
+
+    /// <summary> Tells a pool header from whatever precedes memory the pool didn't allocate. </summary>
+    constexpr uint32_t HEADER_MAGIC = 0x4e415041;
+
+    /// <summary> Precedes every allocation, its size keeps the memory 16 bytes aligned. </summary>
+    /// <remarks> The magic is right before the memory, where C runtime allocators keep the high bits of a chunk size. </remarks>
+    struct Header {
+        uint32_t sizeClass;
+        uint32_t reserved[2];
+        uint32_t magic;
+    };
+
+    static_assert(sizeof(Header) == 16, "Header must keep allocations 16 bytes aligned.");
+
+    /// <summary> A released block links to the next one in place. </summary>
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    size_t GetClassIndex(size_t blockSize) {
+        if (blockSize <= SMALL_CLASS_LIMIT) {
+            return blockSize == 0 ? 0 : (blockSize - 1) / 16;
+        }
+
+        // 2^power < blockSize <= 2^(power + 1), split into 4 steps.
+        size_t power = 8;
+        while ((size_t(1) << (power + 1)) < blockSize) {
+            ++power;
+        }
+        size_t step = size_t(1) << (power - 2);
+        size_t offset = (blockSize - (size_t(1) << power) + step - 1) / step - 1;
+        return SMALL_CLASS_COUNT + (power - 8) * 4 + offset;
+    }
+
+    size_t GetClassSize(size_t index) {
+        if (index < SMALL_CLASS_COUNT) {
+            return (index + 1) * 16;
+        }
+        size_t power = 8 + (index - SMALL_CLASS_COUNT) / 4;
+        size_t offset = (index - SMALL_CLASS_COUNT) % 4;
+        return (size_t(1) << power) + (offset + 1) * (size_t(1) << (power - 2));
+    }
+
+    /// <summary> The number of blocks moved between a thread cache and the pool at once. </summary>
+    size_t GetBatchSize(size_t index) {
+        return std::min<size_t>(64, std::max<size_t>(2, SPAN_SIZE / 2 / GetClassSize(index)));
+    }
+
+    /// <summary> Blocks shared by all threads, one lock per size class. </summary>
+    class CentralPool {
+    public:
+        /// <summary> Takes up to count blocks, carving a new span if there are none. </summary>
+        FreeBlock* Take(size_t index, size_t count, size_t& taken) {
+            auto& sizeClass = _sizeClasses[index];
+            std::lock_guard<std::mutex> lock(sizeClass.lock);
+            if (sizeClass.head == nullptr) {
+                Carve(index, sizeClass);
+            }
+
+            auto head = sizeClass.head;
+            auto tail = head;
+            taken = 1;
+            while (taken < count && tail->next != nullptr) {
+                tail = tail->next;
+                ++taken;
+            }
+            sizeClass.head = tail->next;
+            tail->next = nullptr;
+            return head;
+        }
+
+        /// <summary> Returns a list of blocks ending with tail. </summary>
+        void Give(size_t index, FreeBlock* head, FreeBlock* tail) {
+            auto& sizeClass = _sizeClasses[index];
+            std::lock_guard<std::mutex> lock(sizeClass.lock);
+            tail->next = sizeClass.head;
+            sizeClass.head = head;
+        }
+
+    private:
+        struct SizeClass {
+            std::mutex lock;
+            FreeBlock* head = nullptr;
+        };
+
+        static void Carve(size_t index, SizeClass& sizeClass) {
+            auto blockSize = GetClassSize(index);
+            auto spanSize = std::max(SPAN_SIZE, blockSize * 4);
+            auto span = static_cast<char*>(std::malloc(spanSize));
+            if (span == nullptr) {
+                throw std::bad_alloc();
+            }
+
+            // malloc aligns to 16 bytes on supported platforms, and all class sizes are multiples of 16.
+            FreeBlock* head = nullptr;
+            for (size_t offset = (spanSize / blockSize) * blockSize; offset > 0; offset -= blockSize) {
+                auto block = reinterpret_cast<FreeBlock*>(span + offset - blockSize);
+                block->next = head;
+                head = block;
+            }
+            sizeClass.head = head;
+        }
+
+        SizeClass _sizeClasses[SIZE_CLASS_COUNT];
+    };
+
+    // Never destroyed, threads may release memory after static destruction.
+    CentralPool& GetCentralPool() {
+        static auto pool = new CentralPool();
+        return *pool;
+    }
+
+    /// <summary> Blocks released by a thread, used by it without locking. </summary>
+    class ThreadCache {
+    public:
+        ~ThreadCache();
+
+        void* Allocate(size_t index) {
+            auto& sizeClass = _sizeClasses[index];
+            if (sizeClass.head == nullptr) {
+                sizeClass.head = GetCentralPool().Take(index, GetBatchSize(index), sizeClass.count);
+            }
+            auto block = sizeClass.head;
+            sizeClass.head = block->next;
+            --sizeClass.count;
+            return block;
+        }
+
+        void Deallocate(size_t index, void* memory) {
+            auto& sizeClass = _sizeClasses[index];
+            auto block = static_cast<FreeBlock*>(memory);
+            block->next = sizeClass.head;
+            sizeClass.head = block;
+
+            // Keep up to 2 batches, so a thread alternating allocations and releases doesn't bounce on the pool.
+            auto batchSize = GetBatchSize(index);
+            if (++sizeClass.count > 2 * batchSize) {
+                Release(index, batchSize);
+            }
+        }
+
+    private:
+        /// <summary> Returns count blocks to the central pool. </summary>
+        void Release(size_t index, size_t count) {
+            auto& sizeClass = _sizeClasses[index];
+            auto head = sizeClass.head;
+            auto tail = head;
+            for (size_t i = 1; i < count; ++i) {
+                tail = tail->next;
+            }
+            sizeClass.head = tail->next;
+            sizeClass.count -= count;
+            GetCentralPool().Give(index, head, tail);
+        }
+
+        struct SizeClass {
+            FreeBlock* head = nullptr;
+            size_t count = 0;
+        };
+
+        SizeClass _sizeClasses[SIZE_CLASS_COUNT];
+    };
+
+    /// <summary> Set once the thread cache is destroyed, later calls on the thread go to the central pool. </summary>
+    thread_local bool _threadCacheDestroyed = false;
+
+    ThreadCache::~ThreadCache() {
+        for (size_t index = 0; index < SIZE_CLASS_COUNT; ++index) {
+            if (_sizeClasses[index].count > 0) {
+                Release(index, _sizeClasses[index].count);
+            }
+        }
+        _threadCacheDestroyed = true;
+    }
+
+    ThreadCache& GetThreadCache() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+}
+
+void* napa::memory::PoolAllocate(size_t size) {
+    Header* header = nullptr;
+    if (size > POOL_MAX_POOLED_SIZE) {
+        header = static_cast<Header*>(std::malloc(size + sizeof(Header)));
+        if (header == nullptr) {
+            throw std::bad_alloc();
+        }
+        header->sizeClass = LARGE_CLASS;
+    } else {
+        auto index = GetClassIndex(size + sizeof(Header));
+        if (!_threadCacheDestroyed) {
+            header = static_cast<Header*>(GetThreadCache().Allocate(index));
+        } else {
+            size_t taken = 0;
+            header = reinterpret_cast<Header*>(GetCentralPool().Take(index, 1, taken));
+        }
+        header->sizeClass = static_cast<uint32_t>(index);
+    }
+    header->magic = HEADER_MAGIC;
+    return header + 1;
+}
+
+void napa::memory::PoolDeallocate(void* memory, size_t) {
+    if (memory == nullptr) {
+        return;
+    }
+
+    auto header = static_cast<Header*>(memory) - 1;
+    if (header->magic != HEADER_MAGIC) {
+        // Memory allocated by the C runtime allocator before the pool was selected.
+        std::free(memory);
+        return;
+    }
+    header->magic = 0;
+
+    if (header->sizeClass == LARGE_CLASS) {
+        std::free(header);
+    } else if (!_threadCacheDestroyed) {
+        GetThreadCache().Deallocate(header->sizeClass, header);
+    } else {
+        auto block = reinterpret_cast<FreeBlock*>(header);
+        GetCentralPool().Give(header->sizeClass, block, block);
+    }
+}
+
+size_t napa::memory::GetPoolBlockSize(size_t size) {
+    if (size > POOL_MAX_POOLED_SIZE) {
+        return 0;
+    }
+    return GetClassSize(GetClassIndex(size + sizeof(Header))) - sizeof(Header);
+}
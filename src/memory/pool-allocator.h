@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+
+namespace napa {
+namespace memory {
+
+    /// <summary> The largest request served from the pool, larger ones go to the C runtime allocator. </summary>
+    constexpr size_t POOL_MAX_POOLED_SIZE = 32768 - 16;
+
+    /// <summary> Allocates memory from the process wide size class pool. </summary>
+    /// <remarks>
+    ///     Each thread caches released blocks per size class and only takes the pool lock of a size class to move
+    ///     a batch of blocks in or out of its cache. Blocks are carved from spans that are never returned to the system,
+    ///     and a thread's cache goes back to the pool when the thread exits. Memory is 16 bytes aligned.
+    /// </remarks>
+    /// <param name="size"> Requested size. </param>
+    /// <returns> Allocated memory. Throws std::bad_alloc if no memory is available. </returns>
+    void* PoolAllocate(size_t size);
+
+    /// <summary> Deallocates memory from PoolAllocate, on any thread. </summary>
+    /// <param name="memory"> Pointer to the memory, nullptr is ignored. </param>
+    /// <param name="sizeHint"> Unused, blocks record their size class. </param>
+    void PoolDeallocate(void* memory, size_t sizeHint);
+
+    /// <summary> Returns the usable size of a block serving the requested size, or 0 if it's not pooled. </summary>
+    size_t GetPoolBlockSize(size_t size);
+}
+}
@@ -0,0 +1,203 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "profiling-allocator-debugger.h"
+
+#include <platform/process.h>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+using namespace napa::memory;
+
+namespace {
+
+    /// <summary> Precedes every allocation with its size, its size keeps the memory 16 bytes aligned. </summary>
+    struct Header {
+        uint64_t size;
+        uint64_t reserved;
+    };
+
+    static_assert(sizeof(Header) == 16, "Header must keep allocations 16 bytes aligned.");
+
+    /// <summary> Threads are spread over shards in the order they first allocate. </summary>
+    size_t GetShardIndex() {
+        static std::atomic<size_t> nextIndex(0);
+        thread_local size_t index = nextIndex++ % ProfilingAllocatorDebugger::SHARD_COUNT;
+        return index;
+    }
+
+    size_t GetBucketIndex(size_t size) {
+        size_t index = 0;
+        while (index + 1 < ProfilingAllocatorDebugger::HISTOGRAM_BUCKET_COUNT && (size_t(16) << index) < size) {
+            ++index;
+        }
+        return index;
+    }
+
+    void WriteJsonString(std::ostream& stream, const std::string& value) {
+        stream << '"';
+        for (auto c : value) {
+            if (c == '"' || c == '\\') {
+                stream << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                stream << ' ';
+            } else {
+                stream << c;
+            }
+        }
+        stream << '"';
+    }
+}
+
+ProfilingAllocatorDebugger::Shard::Shard() {
+    for (auto& bucket : histogram) {
+        bucket = 0;
+    }
+}
+
+ProfilingAllocatorDebugger::ProfilingAllocatorDebugger(std::shared_ptr<Allocator> allocator, uint32_t sampleInterval) :
+    _allocator(std::move(allocator)),
+    _sampleInterval(sampleInterval),
+    _liveSize(0),
+    _peakLiveSize(0),
+    _droppedSamples(0) {
+    std::stringstream stream;
+    stream << "ProfilingAllocatorDebugger<" << _allocator->GetType() << ">";
+    _typeName = stream.str();
+}
+
+void* ProfilingAllocatorDebugger::Allocate(size_t size) {
+    auto header = static_cast<Header*>(_allocator->Allocate(size + sizeof(Header)));
+    header->size = size;
+
+    auto& shard = _shards[GetShardIndex()];
+    auto count = shard.allocateCount.fetch_add(1, std::memory_order_relaxed) + 1;
+    shard.allocatedSize.fetch_add(size, std::memory_order_relaxed);
+    shard.histogram[GetBucketIndex(size)].fetch_add(1, std::memory_order_relaxed);
+    AddLiveSize(shard, static_cast<int64_t>(size));
+
+    if (_sampleInterval != 0 && count % _sampleInterval == 0) {
+        RecordSample(size);
+    }
+    return header + 1;
+}
+
+void ProfilingAllocatorDebugger::Deallocate(void* memory, size_t) {
+    if (memory == nullptr) {
+        return;
+    }
+
+    auto header = static_cast<Header*>(memory) - 1;
+    auto size = static_cast<size_t>(header->size);
+
+    auto& shard = _shards[GetShardIndex()];
+    shard.deallocateCount.fetch_add(1, std::memory_order_relaxed);
+    shard.deallocatedSize.fetch_add(size, std::memory_order_relaxed);
+    AddLiveSize(shard, -static_cast<int64_t>(size));
+
+    _allocator->Deallocate(header, size + sizeof(Header));
+}
+
+const char* ProfilingAllocatorDebugger::GetType() const {
+    return _typeName.c_str();
+}
+
+bool ProfilingAllocatorDebugger::operator==(const Allocator& other) const {
+    return &other == this;
+}
+
+void ProfilingAllocatorDebugger::AddLiveSize(Shard& shard, int64_t size) {
+    auto live = shard.liveSize.fetch_add(size, std::memory_order_relaxed) + size;
+    if (live < LIVE_SIZE_STEP && live > -LIVE_SIZE_STEP) {
+        return;
+    }
+
+    auto step = shard.liveSize.exchange(0, std::memory_order_relaxed);
+    auto total = _liveSize.fetch_add(step, std::memory_order_relaxed) + step;
+    auto peak = _peakLiveSize.load(std::memory_order_relaxed);
+    while (total > peak && !_peakLiveSize.compare_exchange_weak(peak, total, std::memory_order_relaxed)) {
+    }
+}
+
+void ProfilingAllocatorDebugger::RecordSample(size_t size) {
+    void* frames[MAX_STACK_DEPTH];
+
+    // Leave out RecordSample and Allocate.
+    auto depth = platform::CaptureStackTrace(frames, MAX_STACK_DEPTH, 2);
+    std::vector<void*> stack(frames, frames + depth);
+
+    std::lock_guard<std::mutex> lock(_samplesLock);
+    auto iter = _samples.find(stack);
+    if (iter == _samples.end()) {
+        if (_samples.size() >= MAX_STACKS) {
+            _droppedSamples++;
+            return;
+        }
+        iter = _samples.emplace(std::move(stack), Sample()).first;
+    }
+    iter->second.count++;
+    iter->second.size += size;
+}
+
+std::string ProfilingAllocatorDebugger::GetDebugInfo() const {
+    uint64_t allocateCount = 0;
+    uint64_t deallocateCount = 0;
+    uint64_t allocatedSize = 0;
+    uint64_t deallocatedSize = 0;
+    int64_t liveSize = _liveSize.load();
+    uint64_t histogram[HISTOGRAM_BUCKET_COUNT] = {};
+    for (const auto& shard : _shards) {
+        allocateCount += shard.allocateCount.load();
+        deallocateCount += shard.deallocateCount.load();
+        allocatedSize += shard.allocatedSize.load();
+        deallocatedSize += shard.deallocatedSize.load();
+        liveSize += shard.liveSize.load();
+        for (size_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i) {
+            histogram[i] += shard.histogram[i].load();
+        }
+    }
+    auto peakLiveSize = std::max(_peakLiveSize.load(), liveSize);
+
+    std::stringstream stream;
+    stream << "{ "
+        << "\"allocate\": " << allocateCount
+        << ", \"deallocate\": " << deallocateCount
+        << ", \"allocatedSize\": " << allocatedSize
+        << ", \"deallocatedSize\": " << deallocatedSize
+        << ", \"liveSize\": " << liveSize
+        << ", \"peakLiveSize\": " << peakLiveSize
+        << ", \"sizeHistogram\": [";
+
+    bool first = true;
+    for (size_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i) {
+        if (histogram[i] == 0) {
+            continue;
+        }
+        stream << (first ? " " : ", ") << "{ \"maxSize\": " << (uint64_t(16) << i) << ", \"count\": " << histogram[i] << " }";
+        first = false;
+    }
+
+    stream << " ], \"sampleInterval\": " << _sampleInterval << ", \"samples\": [";
+
+    // Symbols are resolved when reported, so sampling only records addresses.
+    std::lock_guard<std::mutex> lock(_samplesLock);
+    first = true;
+    for (const auto& sample : _samples) {
+        stream << (first ? " " : ", ") << "{ \"count\": " << sample.second.count << ", \"size\": " << sample.second.size << ", \"stack\": [";
+        for (auto frame = sample.first.rbegin(); frame != sample.first.rend(); ++frame) {
+            stream << (frame == sample.first.rbegin() ? " " : ", ");
+            WriteJsonString(stream, platform::GetSymbolName(*frame));
+        }
+        stream << " ] }";
+        first = false;
+    }
+    stream << " ], \"droppedSamples\": " << _droppedSamples << " }";
+
+    return stream.str();
+}
+
+std::shared_ptr<AllocatorDebugger> napa::memory::CreateProfilingAllocatorDebugger(std::shared_ptr<Allocator> allocator, uint32_t sampleInterval) {
+    return std::make_shared<ProfilingAllocatorDebugger>(std::move(allocator), sampleInterval);
+}
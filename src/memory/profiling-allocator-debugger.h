@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/memory/allocator-debugger.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace memory {
+
+    /// <summary> Allocator debugger that profiles sizes, live and peak memory, and sampled allocation stacks. </summary>
+    /// <remarks>
+    ///     Counters are spread over shards that threads pick once, so threads rarely update the same counters.
+    ///     Each allocation is prefixed by its size, which makes live memory exact whatever size hints callers pass.
+    ///     Live memory reaches the shared total in steps, so the peak is accurate within LIVE_SIZE_STEP per shard.
+    /// </remarks>
+    class ProfilingAllocatorDebugger : public AllocatorDebugger {
+    public:
+        /// <summary> The number of counter shards. </summary>
+        static constexpr size_t SHARD_COUNT = 16;
+
+        /// <summary> Size histogram buckets, bucket i counts sizes up to 16 << i bytes. </summary>
+        static constexpr size_t HISTOGRAM_BUCKET_COUNT = 32;
+
+        /// <summary> The live memory a shard accumulates before it updates the shared total. </summary>
+        static constexpr int64_t LIVE_SIZE_STEP = 64 * 1024;
+
+        /// <summary> The deepest stack recorded for a sample. </summary>
+        static constexpr size_t MAX_STACK_DEPTH = 32;
+
+        /// <summary> The number of distinct stacks kept, further ones are counted as dropped. </summary>
+        static constexpr size_t MAX_STACKS = 4096;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="allocator"> Actual allocator to allocate/deallocate memory. </param>
+        /// <param name="sampleInterval"> Capture the stack of 1 in sampleInterval allocations, 0 for none. </param>
+        ProfilingAllocatorDebugger(std::shared_ptr<Allocator> allocator, uint32_t sampleInterval);
+
+        /// <summary> Allocate memory of given size. </summary>
+        void* Allocate(size_t size) override;
+
+        /// <summary> Deallocate memory allocated from this allocator. </summary>
+        void Deallocate(void* memory, size_t sizeHint) override;
+
+        /// <summary> Get allocator type for better debuggability. </summary>
+        const char* GetType() const override;
+
+        /// <summary> Get the profile in JSON, with stacks of samples ordered from the outermost frame. </summary>
+        std::string GetDebugInfo() const override;
+
+        /// <summary> Tell if another allocator equals to this allocator. </summary>
+        bool operator==(const Allocator& other) const override;
+
+    private:
+        /// <summary> Counters of a group of threads. Shards span several cache lines, so neighbors rarely share one. </summary>
+        struct Shard {
+            std::atomic<uint64_t> allocateCount{ 0 };
+            std::atomic<uint64_t> deallocateCount{ 0 };
+            std::atomic<uint64_t> allocatedSize{ 0 };
+            std::atomic<uint64_t> deallocatedSize{ 0 };
+            std::atomic<int64_t> liveSize{ 0 };
+            std::atomic<uint64_t> histogram[HISTOGRAM_BUCKET_COUNT];
+
+            Shard();
+        };
+
+        /// <summary> Allocations sampled with the same stack. </summary>
+        struct Sample {
+            uint64_t count = 0;
+            uint64_t size = 0;
+        };
+
+        /// <summary> Adds to the live memory of a shard, and to the shared total once it accumulated a step. </summary>
+        void AddLiveSize(Shard& shard, int64_t size);
+
+        /// <summary> Records the stack of an allocation. </summary>
+        void RecordSample(size_t size);
+
+        std::shared_ptr<Allocator> _allocator;
+        std::string _typeName;
+        const uint32_t _sampleInterval;
+
+        Shard _shards[SHARD_COUNT];
+        std::atomic<int64_t> _liveSize;
+        std::atomic<int64_t> _peakLiveSize;
+
+        mutable std::mutex _samplesLock;
+        std::map<std::vector<void*>, Sample> _samples;
+        uint64_t _droppedSamples;
+    };
+}
+}
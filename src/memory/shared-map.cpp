@@ -0,0 +1,211 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "shared-map.h"
+
+#include <cstring>
+#include <utility>
+
+using namespace napa::memory;
+
+namespace {
+
+    /// <summary> The capacity of a shard's table once it holds a key. </summary>
+    constexpr size_t MIN_CAPACITY = 8;
+
+    size_t RoundUpToPowerOf2(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+SharedMap::SharedMap(size_t shards) : _size(0) {
+    auto count = RoundUpToPowerOf2(shards == 0 ? 1 : shards);
+    _shards = std::make_unique<Shard[]>(count);
+    _shardMask = count - 1;
+}
+
+bool SharedMap::Get(const char* key, size_t length, SharedMapValue& value) const {
+    auto hash = Hash(key, length);
+    auto& shard = GetShard(hash);
+
+    std::lock_guard<std::mutex> lock(shard.lock);
+    auto slot = Find(shard, hash, key, length);
+    if (slot == nullptr) {
+        return false;
+    }
+    value.type = slot->value.type;
+    value.number = slot->value.number;
+    value.boolean = slot->value.boolean;
+    value.bytes.assign(slot->value.bytes);
+    return true;
+}
+
+void SharedMap::Set(const char* key, size_t length, SharedMapValue value) {
+    auto hash = Hash(key, length);
+    auto& shard = GetShard(hash);
+
+    std::lock_guard<std::mutex> lock(shard.lock);
+    Insert(shard, hash, key, length).value = std::move(value);
+}
+
+bool SharedMap::Add(const char* key, size_t length, double delta, double& result) {
+    auto hash = Hash(key, length);
+    auto& shard = GetShard(hash);
+
+    std::lock_guard<std::mutex> lock(shard.lock);
+    auto slot = Find(shard, hash, key, length);
+    if (slot == nullptr) {
+        slot = &Insert(shard, hash, key, length);
+        slot->value = SharedMapValue();
+    } else if (slot->value.type != SharedMapValueType::Number) {
+        return false;
+    }
+    slot->value.number += delta;
+    result = slot->value.number;
+    return true;
+}
+
+bool SharedMap::Has(const char* key, size_t length) const {
+    auto hash = Hash(key, length);
+    auto& shard = GetShard(hash);
+
+    std::lock_guard<std::mutex> lock(shard.lock);
+    return Find(shard, hash, key, length) != nullptr;
+}
+
+bool SharedMap::Delete(const char* key, size_t length) {
+    auto hash = Hash(key, length);
+    auto& shard = GetShard(hash);
+
+    std::lock_guard<std::mutex> lock(shard.lock);
+    auto slot = Find(shard, hash, key, length);
+    if (slot == nullptr) {
+        return false;
+    }
+
+    // The slot stays on the probe sequences of other keys, it's only reused by inserts and rehashes.
+    slot->state = SlotState::Deleted;
+    slot->key = std::string();
+    slot->value = SharedMapValue();
+    shard.count--;
+    shard.deleted++;
+    _size--;
+    return true;
+}
+
+void SharedMap::Clear() {
+    for (size_t i = 0; i <= _shardMask; i++) {
+        auto& shard = _shards[i];
+        std::lock_guard<std::mutex> lock(shard.lock);
+        _size -= shard.count;
+        shard.slots.clear();
+        shard.slots.shrink_to_fit();
+        shard.count = 0;
+        shard.deleted = 0;
+    }
+}
+
+size_t SharedMap::GetSize() const {
+    return _size;
+}
+
+std::vector<std::string> SharedMap::GetKeys() const {
+    std::vector<std::string> keys;
+    keys.reserve(_size);
+    for (size_t i = 0; i <= _shardMask; i++) {
+        auto& shard = _shards[i];
+        std::lock_guard<std::mutex> lock(shard.lock);
+        for (const auto& slot : shard.slots) {
+            if (slot.state == SlotState::Used) {
+                keys.push_back(slot.key);
+            }
+        }
+    }
+    return keys;
+}
+
+uint64_t SharedMap::Hash(const char* key, size_t length) {
+    // FNV-1a, keys are short and hashed once per call.
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<uint8_t>(key[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+SharedMap::Shard& SharedMap::GetShard(uint64_t hash) const {
+    // High bits pick the shard, low bits the slot within it.
+    return _shards[(hash >> 48) & _shardMask];
+}
+
+SharedMap::Slot* SharedMap::Find(Shard& shard, uint64_t hash, const char* key, size_t length) {
+    if (shard.slots.empty()) {
+        return nullptr;
+    }
+
+    auto mask = shard.slots.size() - 1;
+    for (auto index = hash & mask; ; index = (index + 1) & mask) {
+        auto& slot = shard.slots[index];
+        if (slot.state == SlotState::Empty) {
+            return nullptr;
+        }
+        if (slot.state == SlotState::Used
+            && slot.hash == hash
+            && slot.key.size() == length
+            && std::memcmp(slot.key.data(), key, length) == 0) {
+            return &slot;
+        }
+    }
+}
+
+SharedMap::Slot& SharedMap::Insert(Shard& shard, uint64_t hash, const char* key, size_t length) {
+    auto existing = Find(shard, hash, key, length);
+    if (existing != nullptr) {
+        return *existing;
+    }
+
+    // Tables are at most 3/4 full, counting deleted slots, so probes always reach an empty slot.
+    if ((shard.count + shard.deleted + 1) * 4 > shard.slots.size() * 3) {
+        auto capacity = std::max(MIN_CAPACITY, RoundUpToPowerOf2((shard.count + 1) * 2));
+        Rehash(shard, capacity);
+    }
+
+    auto mask = shard.slots.size() - 1;
+    auto index = hash & mask;
+    while (shard.slots[index].state == SlotState::Used) {
+        index = (index + 1) & mask;
+    }
+
+    auto& slot = shard.slots[index];
+    if (slot.state == SlotState::Deleted) {
+        shard.deleted--;
+    }
+    slot.state = SlotState::Used;
+    slot.hash = hash;
+    slot.key.assign(key, length);
+    shard.count++;
+    _size++;
+    return slot;
+}
+
+void SharedMap::Rehash(Shard& shard, size_t capacity) {
+    std::vector<Slot> slots(capacity);
+    auto mask = capacity - 1;
+    for (auto& slot : shard.slots) {
+        if (slot.state != SlotState::Used) {
+            continue;
+        }
+        auto index = slot.hash & mask;
+        while (slots[index].state == SlotState::Used) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = std::move(slot);
+    }
+    shard.slots = std::move(slots);
+    shard.deleted = 0;
+}
@@ -0,0 +1,124 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace memory {
+
+    /// <summary> Types of the values of a SharedMap. </summary>
+    enum class SharedMapValueType : uint8_t {
+        Number,
+        Boolean,
+        String,
+        ArrayBuffer
+    };
+
+    /// <summary> A value of a SharedMap, strings are UTF-8 and ArrayBuffers are copied in and out. </summary>
+    struct SharedMapValue {
+        SharedMapValueType type = SharedMapValueType::Number;
+        double number = 0;
+        bool boolean = false;
+
+        /// <summary> The UTF-8 of a string or the content of an ArrayBuffer. </summary>
+        std::string bytes;
+    };
+
+    /// <summary>
+    ///     A concurrent hash map of string keys to primitive values, shared by all workers of a process.
+    ///     Keys are hashed to shards, each an open addressing table with linear probing behind a lock of its own,
+    ///     so threads working on different keys rarely wait for each other.
+    /// </summary>
+    class SharedMap {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="shards"> The number of shards, rounded up to a power of 2. </param>
+        explicit SharedMap(size_t shards = 16);
+
+        SharedMap(const SharedMap&) = delete;
+        SharedMap& operator=(const SharedMap&) = delete;
+
+        /// <summary> Reads the value of a key. </summary>
+        /// <returns> False if the key is not in the map, the value is left unchanged then. </returns>
+        /// <remarks> The bytes of the value are assigned, a value reused across calls doesn't allocate for short ones. </remarks>
+        bool Get(const char* key, size_t length, SharedMapValue& value) const;
+
+        /// <summary> Sets the value of a key, replacing its previous value. </summary>
+        void Set(const char* key, size_t length, SharedMapValue value);
+
+        /// <summary> Adds to the number of a key atomically, a missing key starts from 0. </summary>
+        /// <param name="result"> The number after the addition. </param>
+        /// <returns> False if the key has a value that is not a number, it's left unchanged then. </returns>
+        bool Add(const char* key, size_t length, double delta, double& result);
+
+        /// <summary> Returns whether a key is in the map. </summary>
+        bool Has(const char* key, size_t length) const;
+
+        /// <summary> Removes a key, returns false if it was not in the map. </summary>
+        bool Delete(const char* key, size_t length);
+
+        /// <summary> Removes all keys. </summary>
+        void Clear();
+
+        /// <summary> Returns the number of keys. </summary>
+        size_t GetSize() const;
+
+        /// <summary> Returns the keys, keys set or deleted meanwhile may be missed. </summary>
+        std::vector<std::string> GetKeys() const;
+
+    private:
+
+        enum class SlotState : uint8_t {
+            Empty,
+            Used,
+            Deleted
+        };
+
+        struct Slot {
+            SlotState state = SlotState::Empty;
+            uint64_t hash = 0;
+            std::string key;
+            SharedMapValue value;
+        };
+
+        /// <summary> An open addressing table, its capacity is a power of 2. </summary>
+        struct Shard {
+            mutable std::mutex lock;
+            std::vector<Slot> slots;
+
+            /// <summary> The number of used slots. </summary>
+            size_t count = 0;
+
+            /// <summary> The number of deleted slots, which probes go past until the table is rehashed. </summary>
+            size_t deleted = 0;
+        };
+
+        static uint64_t Hash(const char* key, size_t length);
+
+        Shard& GetShard(uint64_t hash) const;
+
+        /// <summary> Returns the slot of a key, or nullptr if it is not in the shard. The shard is locked. </summary>
+        static Slot* Find(Shard& shard, uint64_t hash, const char* key, size_t length);
+
+        /// <summary> Returns the slot of a key, using a free slot if it is not in the shard. The shard is locked. </summary>
+        Slot& Insert(Shard& shard, uint64_t hash, const char* key, size_t length);
+
+        /// <summary> Moves the used slots to a table sized for them, which drops deleted slots. The shard is locked. </summary>
+        static void Rehash(Shard& shard, size_t capacity);
+
+        std::unique_ptr<Shard[]> _shards;
+        size_t _shardMask;
+        std::atomic<size_t> _size;
+    };
+
+}
+}
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "napa/napa-binding.h"
+#include "napa/numeric.h"
 
 #include "node/console.h"
 #include "node/file-system.h"
@@ -30,4 +31,5 @@
     INITIALIZE_CORE_MODULE(registerer, "path", false, path::Init);                              \
     INITIALIZE_CORE_MODULE(registerer, "process", true, process::Init);                         \
     INITIALIZE_CORE_MODULE(registerer, "tty_wrap", false, tty_wrap::Init);                      \
+    INITIALIZE_CORE_MODULE(registerer, "napa-numeric", false, numeric::Init);                   \
     INITIALIZE_CORE_MODULE(registerer, "napa-binding", false, binding::Init);
@@ -23,6 +23,7 @@ void AllocatorDebuggerWrap::Init(){
 
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "allocate", AllocatorWrap::AllocateCallback);
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "deallocate", AllocatorWrap::DeallocateCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "allocateBuffer", AllocatorWrap::AllocateBufferCallback);
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "getDebugInfo", GetDebugInfoCallback);
     NAPA_SET_ACCESSOR(constructorTemplate, "type", AllocatorWrap::GetTypeCallback, nullptr);
 
@@ -36,7 +37,7 @@ void AllocatorDebuggerWrap::ConstructorCallback(const v8::FunctionCallbackInfo<v
     v8::HandleScope scope(isolate);
 
     JS_ENSURE(isolate, args.IsConstructCall(), "Class \"AllocatorDebuggerWrap\" allows constructor call only.");
-    CHECK_ARG(isolate, args.Length() <= 1, "Class \"AllocatorDebuggerWrap\" requires 1 argument of \"allocator\" in constructor.'");
+    CHECK_ARG(isolate, args.Length() <= 2, "Class \"AllocatorDebuggerWrap\" accepts arguments of \"allocator\" and \"sampleInterval\" in constructor.'");
 
     std::shared_ptr<napa::memory::Allocator> allocator;
     if (args.Length() == 0) {
@@ -51,8 +52,20 @@ void AllocatorDebuggerWrap::ConstructorCallback(const v8::FunctionCallbackInfo<v
         allocator = allocatorWrap->Get();
     }
 
+    // A sample interval selects the profiling allocator debugger.
+    std::shared_ptr<napa::memory::AllocatorDebugger> allocatorDebugger;
+    if (args.Length() < 2 || args[1]->IsUndefined()) {
+        allocatorDebugger = NAPA_MAKE_SHARED<napa::memory::SimpleAllocatorDebugger>(allocator);
+    }
+    else {
+        CHECK_ARG(isolate, args[1]->IsUint32(), "Argument \"sampleInterval\" should be a non-negative integer.");
+        allocatorDebugger = napa::memory::CreateProfilingAllocatorDebugger(
+            allocator,
+            args[1]->Uint32Value(isolate->GetCurrentContext()).FromJust());
+    }
+
     // It's deleted when its Javascript object is garbage collected by V8's GC.
-    auto wrap = new AllocatorDebuggerWrap(NAPA_MAKE_SHARED<napa::memory::SimpleAllocatorDebugger>(allocator));
+    auto wrap = new AllocatorDebuggerWrap(std::move(allocatorDebugger));
     wrap->Wrap(args.This());
     args.GetReturnValue().Set(args.This());
 }
@@ -3,8 +3,26 @@
 
 #include "allocator-wrap.h"
 
+#include <napa/module/binding/basic-wraps.h>
+
+#include <algorithm>
+
 using namespace napa::module;
 
+namespace {
+
+    /// <summary> Memory of an ArrayBuffer from allocateBuffer, returned to its allocator when the buffer is collected. </summary>
+    struct BufferAllocation {
+        std::shared_ptr<napa::memory::Allocator> allocator;
+        void* data;
+        size_t size;
+
+        ~BufferAllocation() {
+            allocator->Deallocate(data, size);
+        }
+    };
+}
+
 NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(AllocatorWrap);
 
 void AllocatorWrap::Init() {
@@ -17,6 +35,7 @@ void AllocatorWrap::Init() {
     
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "allocate", AllocateCallback);
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "deallocate", DeallocateCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "allocateBuffer", AllocateBufferCallback);
     NAPA_SET_ACCESSOR(constructorTemplate, "type", GetTypeCallback, nullptr);
 
     auto constructor = constructorTemplate->GetFunction();
@@ -59,6 +78,39 @@ void AllocatorWrap::DeallocateCallback(const v8::FunctionCallbackInfo<v8::Value>
     allocator->Deallocate(reinterpret_cast<void*>(result.first), args[1]->Uint32Value());
 }
 
+void AllocatorWrap::AllocateBufferCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument of 'size' is required for \"allocateBuffer\".");
+    CHECK_ARG(isolate, args[0]->IsUint32(), "Argument \"size\" must be a unsigned integer.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<AllocatorWrap>(args.Holder());
+    auto allocator = thisObject->Get();
+    JS_ENSURE(isolate, allocator != nullptr, "AllocatorWrap is not attached with any C++ allocator.");
+
+    // Allocators may return null for 0 bytes, while an empty buffer still needs memory of its own.
+    auto length = args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust();
+    auto size = std::max<size_t>(length, 1);
+    auto data = allocator->Allocate(size);
+    JS_ENSURE(isolate, data != nullptr, "\"%s\" failed to allocate %u bytes.", allocator->GetType(), length);
+
+    auto allocation = std::make_shared<BufferAllocation>();
+    allocation->allocator = std::move(allocator);
+    allocation->data = data;
+    allocation->size = size;
+
+    // Like fs.mapFile, the ArrayBuffer doesn't own its memory, its '_allocation' property keeps the memory alive
+    // by the lifetime of the ArrayBuffer. It bypasses the ArrayBuffer allocator of V8, the wrap reports its size to V8.
+    auto context = isolate->GetCurrentContext();
+    auto arrayBuffer = v8::ArrayBuffer::New(isolate, data, length);
+    (void)arrayBuffer->CreateDataProperty(context,
+        v8_helpers::MakeV8String(isolate, "_allocation"),
+        binding::CreateShareableWrap(std::move(allocation), "SharedPtrWrap", size));
+
+    args.GetReturnValue().Set(arrayBuffer);
+}
+
 void AllocatorWrap::GetTypeCallback(v8::Local<v8::String> /*propertyName*/, const v8::PropertyCallbackInfo<v8::Value>& args){
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
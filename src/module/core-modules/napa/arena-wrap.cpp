@@ -0,0 +1,77 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "arena-wrap.h"
+
+#include <napa/memory.h>
+#include <memory/arena-allocator.h>
+
+using namespace napa::module;
+
+NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(ArenaWrap);
+
+ArenaWrap::ArenaWrap(std::shared_ptr<napa::memory::Allocator> arena) {
+    this->_object = std::move(arena);
+}
+
+void ArenaWrap::Init() {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto constructorTemplate = v8::FunctionTemplate::New(isolate, ConstructorCallback);
+    constructorTemplate->SetClassName(v8_helpers::MakeV8String(isolate, exportName));
+    constructorTemplate->InstanceTemplate()->SetInternalFieldCount(1);
+
+    InitConstructorTemplate<ArenaWrap>(constructorTemplate);
+
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "allocate", AllocatorWrap::AllocateCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "deallocate", AllocatorWrap::DeallocateCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "allocateBuffer", AllocatorWrap::AllocateBufferCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "reset", ResetCallback);
+    NAPA_SET_ACCESSOR(constructorTemplate, "type", AllocatorWrap::GetTypeCallback, nullptr);
+    NAPA_SET_ACCESSOR(constructorTemplate, "allocatedSize", GetAllocatedSizeCallback, nullptr);
+
+    auto constructor = constructorTemplate->GetFunction();
+    InitConstructor("<Arena>", constructor);
+    NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructor);
+}
+
+void ArenaWrap::ConstructorCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    JS_ENSURE(isolate, args.IsConstructCall(), "Class \"ArenaWrap\" allows constructor call only.");
+    CHECK_ARG(isolate, args.Length() <= 1, "Class \"ArenaWrap\" accepts an argument of \"capacity\" in constructor.");
+
+    // Without a capacity the wrap is empty, until unmarshall loads the arena of another wrap into it.
+    std::shared_ptr<napa::memory::Allocator> arena;
+    if (args.Length() == 1) {
+        CHECK_ARG(isolate, args[0]->IsUint32(), "Argument \"capacity\" should be a positive integer.");
+        auto capacity = args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust();
+        CHECK_ARG(isolate, capacity > 0, "Argument \"capacity\" should be a positive integer.");
+
+        // Chunks of capacity bytes come from the default allocator, the first one is kept across resets.
+        arena = NAPA_MAKE_SHARED<napa::memory::ArenaAllocator>(napa::memory::GetDefaultAllocator(), capacity);
+    }
+
+    // It's deleted when its Javascript object is garbage collected by V8's GC.
+    auto wrap = new ArenaWrap(std::move(arena));
+    wrap->Wrap(args.This());
+    args.GetReturnValue().Set(args.This());
+}
+
+void ArenaWrap::ResetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<ShareableWrap>(args.Holder());
+    auto arena = thisObject->Get<napa::memory::ArenaAllocator>();
+    JS_ENSURE(isolate, arena != nullptr, "ArenaWrap is not attached with any C++ arena.");
+
+    arena->Reset();
+}
+
+void ArenaWrap::GetAllocatedSizeCallback(v8::Local<v8::String> /*propertyName*/, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<ShareableWrap>(args.Holder());
+    auto arena = thisObject->Get<napa::memory::ArenaAllocator>();
+    args.GetReturnValue().Set(static_cast<double>(arena != nullptr ? arena->GetAllocatedSize() : 0));
+}
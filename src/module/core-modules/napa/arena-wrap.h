@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "allocator-wrap.h"
+
+#include <napa/module.h>
+
+namespace napa {
+namespace module {
+
+    /// <summary> It wraps napa::memory::ArenaAllocator. </summary>
+    /// <remarks> Reference: napajs/lib/memory/allocator.ts#Arena </remarks>
+    class ArenaWrap: public AllocatorWrap {
+    public:
+        /// <summary> Init this wrap. </summary>
+        static void Init();
+
+        /// <summary> Declare constructor in public, so we can export class constructor to JavaScript world. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "ArenaWrap";
+
+    private:
+        /// <summary> Constructor. </summary>
+        explicit ArenaWrap(std::shared_ptr<napa::memory::Allocator> arena);
+
+        /// <summary> No copy allowed. </summary>
+        ArenaWrap(const ArenaWrap&) = delete;
+        ArenaWrap& operator=(const ArenaWrap&) = delete;
+
+        /// <summary> ArenaWrap.constructor </summary>
+        static void ConstructorCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Arena.reset(): void </summary>
+        static void ResetCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements readonly Arena.allocatedSize: number </summary>
+        static void GetAllocatedSizeCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+    };
+}
+}
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "barrier-wrap.h"
+#include "sync-helpers.h"
+
+#include <zone/barrier.h>
+
+#include <napa/async.h>
+#include <napa/module/binding/wraps.h>
+
+#include <cstdint>
+#include <memory>
+
+using namespace napa::module;
+using napa::zone::Barrier;
+
+NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(napa::module::BarrierWrap);
+
+void BarrierWrap::Init() {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto constructorTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<BarrierWrap>);
+    constructorTemplate->SetClassName(v8_helpers::MakeV8String(isolate, exportName));
+    constructorTemplate->InstanceTemplate()->SetInternalFieldCount(1);
+
+    InitConstructorTemplate<BarrierWrap>(constructorTemplate);
+
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "arrive", ArriveCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "arriveSync", ArriveSyncCallback);
+    NAPA_SET_ACCESSOR(constructorTemplate, "parties", GetPartiesCallback, nullptr);
+    NAPA_SET_ACCESSOR(constructorTemplate, "arrived", GetArrivedCallback, nullptr);
+
+    auto constructor = constructorTemplate->GetFunction();
+    InitConstructor("<BarrierWrap>", constructor);
+    NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructor);
+}
+
+v8::Local<v8::Object> BarrierWrap::NewInstance(uint32_t parties) {
+    return binding::CreateShareableWrap(std::make_shared<Barrier>(parties), exportName);
+}
+
+void BarrierWrap::ArriveCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    v8::Local<v8::Promise::Resolver> resolver;
+    if (!v8::Promise::Resolver::New(context).ToLocal(&resolver)) {
+        return;
+    }
+    args.GetReturnValue().Set(resolver->GetPromise());
+    auto settle = sync_helpers::MakeSettleFunction(context, resolver);
+
+    // The worker serves other tasks until the last party arrives, its thread schedules the worker back.
+    auto barrier = NAPA_OBJECTWRAP::Unwrap<BarrierWrap>(args.Holder())->Get<Barrier>();
+    napa::zone::DoAsyncWork(settle,
+        [barrier](std::function<void(void*)> complete) {
+            barrier->ArriveAndWaitAsync([complete](bool last) {
+                complete(reinterpret_cast<void*>(static_cast<uintptr_t>(last)));
+            });
+        },
+        [](v8::Local<v8::Function> settle, void* result) {
+            auto isolate = v8::Isolate::GetCurrent();
+            sync_helpers::Settle(settle, true, v8::Boolean::New(isolate, reinterpret_cast<uintptr_t>(result) != 0));
+        });
+}
+
+void BarrierWrap::ArriveSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto barrier = NAPA_OBJECTWRAP::Unwrap<BarrierWrap>(args.Holder())->Get<Barrier>();
+    args.GetReturnValue().Set(barrier->ArriveAndWait());
+}
+
+void BarrierWrap::GetPartiesCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto barrier = NAPA_OBJECTWRAP::Unwrap<BarrierWrap>(args.Holder())->Get<Barrier>();
+    args.GetReturnValue().Set(barrier->GetParties());
+}
+
+void BarrierWrap::GetArrivedCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto barrier = NAPA_OBJECTWRAP::Unwrap<BarrierWrap>(args.Holder())->Get<Barrier>();
+    args.GetReturnValue().Set(barrier->GetArrived());
+}
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/module.h>
+#include <napa/module/shareable-wrap.h>
+
+namespace napa {
+namespace module {
+
+    /// <summary> An object wrap to expose barrier APIs. </summary>
+    class BarrierWrap : public ShareableWrap {
+    public:
+
+        /// <summary> Initializes the wrap. </summary>
+        static void Init();
+
+        /// <summary> Creates a new instance of BarrierWrap. </summary>
+        /// <param name="parties"> The number of parties that complete a phase. </param>
+        static v8::Local<v8::Object> NewInstance(uint32_t parties);
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "BarrierWrap";
+
+        /// <summary> Declare persistent constructor to create Barrier Javascript wrapper instance. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
+    private:
+
+        // BarrierWrap methods
+        static void ArriveCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void ArriveSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        // BarrierWrap accessors
+        static void GetPartiesCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+        static void GetArrivedCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+    };
+}
+}
@@ -5,12 +5,69 @@
 #include "transport-context-wrap-impl.h"
 
 #include <napa/transport.h>
+#include <zone/worker-context.h>
+
+#include <cstring>
+#include <vector>
 
 using namespace napa;
 using namespace napa::module;
 
 NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(CallContextWrap);
 
+namespace {
+    /// <summary> External string over an argument of a call, which keeps the call context alive while V8 references it. </summary>
+    class CallArgumentResource : public v8::String::ExternalOneByteStringResource {
+    public:
+        CallArgumentResource(std::shared_ptr<zone::CallContext> call, const std::string& argument) :
+            _call(std::move(call)), _data(argument.data()), _length(argument.size()) {}
+
+        const char* data() const override { return _data; }
+        size_t length() const override { return _length; }
+
+    private:
+        std::shared_ptr<zone::CallContext> _call;
+        const char* _data;
+        size_t _length;
+    };
+
+    /// <summary> Wraps released by the calls of the current worker, reused by its next calls. </summary>
+    class CallContextWrapPool {
+    public:
+        /// <summary> Get the pool of the current isolate. </summary>
+        static CallContextWrapPool& GetCurrent() {
+            auto pool = static_cast<CallContextWrapPool*>(
+                napa::zone::WorkerContext::Get(napa::zone::WorkerContextItem::CALL_CONTEXT_WRAP_POOL));
+            if (pool == nullptr) {
+                // Like persistent constructors, the pool lives as long as the isolate.
+                pool = new CallContextWrapPool();
+                napa::zone::WorkerContext::Set(napa::zone::WorkerContextItem::CALL_CONTEXT_WRAP_POOL, pool);
+            }
+            return *pool;
+        }
+
+        /// <summary> Take a released wrap, empty if there is none. </summary>
+        v8::Local<v8::Object> Take(v8::Isolate* isolate) {
+            if (_wraps.empty()) {
+                return v8::Local<v8::Object>();
+            }
+            auto wrap = v8::Local<v8::Object>::New(isolate, _wraps.back());
+            _wraps.pop_back();
+            return wrap;
+        }
+
+        /// <summary> Keep a released wrap, unless the pool is full. </summary>
+        void Put(v8::Isolate* isolate, v8::Local<v8::Object> wrap) {
+            if (_wraps.size() < CallContextWrap::POOL_CAPACITY) {
+                _wraps.emplace_back(isolate, wrap);
+            }
+        }
+
+    private:
+        std::vector<v8::Global<v8::Object>> _wraps;
+    };
+}
+
 void CallContextWrap::Init() {
     auto isolate = v8::Isolate::GetCurrent();
     auto constructorTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<CallContextWrap>);
@@ -21,8 +78,11 @@ void CallContextWrap::Init() {
     
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "resolve", ResolveCallback);
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "reject", RejectCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "markStarted", MarkStartedCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "markFinished", MarkFinishedCallback);
     NAPA_SET_ACCESSOR(constructorTemplate, "finished", IsFinishedCallback, nullptr);
     NAPA_SET_ACCESSOR(constructorTemplate, "elapse", GetElapseCallback, nullptr);
+    NAPA_SET_ACCESSOR(constructorTemplate, "deadline", GetDeadlineCallback, nullptr);
     NAPA_SET_ACCESSOR(constructorTemplate, "module", GetModuleCallback, nullptr);
     NAPA_SET_ACCESSOR(constructorTemplate, "function", GetFunctionCallback, nullptr);
     NAPA_SET_ACCESSOR(constructorTemplate, "args", GetArgumentsCallback, nullptr);
@@ -38,6 +98,22 @@ v8::Local<v8::Object> CallContextWrap::NewInstance(std::shared_ptr<zone::CallCon
     return ShareableWrap::NewInstance<CallContextWrap>(call);
 }
 
+v8::Local<v8::Object> CallContextWrap::Acquire(std::shared_ptr<zone::CallContext> call) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto wrap = CallContextWrapPool::GetCurrent().Take(isolate);
+    if (wrap.IsEmpty()) {
+        return NewInstance(std::move(call));
+    }
+    ShareableWrap::Set(wrap, std::move(call));
+    return wrap;
+}
+
+void CallContextWrap::Release(v8::Local<v8::Object> wrap) {
+    // Drop the call context right away, a pooled wrap must not keep a finished call alive.
+    ShareableWrap::Set(wrap, std::shared_ptr<zone::CallContext>());
+    CallContextWrapPool::GetCurrent().Put(v8::Isolate::GetCurrent(), wrap);
+}
+
 zone::CallContext& CallContextWrap::GetRef() {
     return ShareableWrap::GetRef<zone::CallContext>();
 }
@@ -47,10 +123,29 @@ void CallContextWrap::ResolveCallback(const v8::FunctionCallbackInfo<v8::Value>&
     v8::HandleScope scope(isolate);
 
     CHECK_ARG(isolate, args.Length() == 1, "1 argument of 'result' is required for \"resolve\".");
-    
-    v8::String::Utf8Value result(args[0]);
+
     auto thisObject = NAPA_OBJECTWRAP::Unwrap<CallContextWrap>(args.Holder());
-    auto success = thisObject->GetRef().Resolve(std::string(*result, result.length()));
+    bool success = false;
+
+    // A binary result is resolved with the bytes of an ArrayBuffer or ArrayBufferView.
+    if (args[0]->IsArrayBuffer() || args[0]->IsArrayBufferView()) {
+        size_t offset = 0;
+        size_t length = 0;
+        v8::Local<v8::ArrayBuffer> buffer;
+        if (args[0]->IsArrayBuffer()) {
+            buffer = v8::Local<v8::ArrayBuffer>::Cast(args[0]);
+            length = buffer->ByteLength();
+        } else {
+            auto view = v8::Local<v8::ArrayBufferView>::Cast(args[0]);
+            buffer = view->Buffer();
+            offset = view->ByteOffset();
+            length = view->ByteLength();
+        }
+        auto data = static_cast<const char*>(buffer->GetContents().Data()) + offset;
+        success = thisObject->GetRef().Resolve(std::string(data, length));
+    } else {
+        success = thisObject->GetRef().Resolve(v8_helpers::V8ValueTo<std::string>(args[0]));
+    }
 
     JS_ENSURE(isolate, success, "Resolve call failed: Already finished.");
 }
@@ -80,6 +175,16 @@ void CallContextWrap::RejectCallback(const v8::FunctionCallbackInfo<v8::Value>&
     JS_ENSURE(isolate, success, "Reject call failed: Already finished.");
 }
 
+void CallContextWrap::MarkStartedCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<CallContextWrap>(args.Holder());
+    thisObject->GetRef().MarkStarted();
+}
+
+void CallContextWrap::MarkFinishedCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<CallContextWrap>(args.Holder());
+    thisObject->GetRef().MarkFinished();
+}
+
 void CallContextWrap::IsFinishedCallback(v8::Local<v8::String> /*propertyName*/, const v8::PropertyCallbackInfo<v8::Value>& args){
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
@@ -94,6 +199,13 @@ void CallContextWrap::GetElapseCallback(v8::Local<v8::String> /*propertyName*/,
     args.GetReturnValue().Set(v8_helpers::HrtimeToV8Uint32Array(isolate, thisObject->GetRef().GetElapse().count()));
 }
 
+void CallContextWrap::GetDeadlineCallback(v8::Local<v8::String> /*propertyName*/, const v8::PropertyCallbackInfo<v8::Value>& args){
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<CallContextWrap>(args.Holder());
+    args.GetReturnValue().Set(static_cast<double>(thisObject->GetRef().GetDeadline()));
+}
+
 void CallContextWrap::GetModuleCallback(v8::Local<v8::String> /*propertyName*/, const v8::PropertyCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
@@ -114,11 +226,24 @@ void CallContextWrap::GetArgumentsCallback(v8::Local<v8::String> /*propertyName*
     auto context = isolate->GetCurrentContext();
     auto thisObject = NAPA_OBJECTWRAP::Unwrap<CallContextWrap>(args.Holder());
 
+    JS_ENSURE(isolate, thisObject->GetRef().DecompressArguments(), "Compressed arguments are corrupted.");
     auto& cppArgs = thisObject->GetRef().GetArguments();
+    auto binary = thisObject->GetRef().GetOptions().transport == BINARY;
     auto jsArgs = v8::Array::New(isolate, static_cast<int>(cppArgs.size()));
     for (size_t i = 0; i < cppArgs.size(); ++i) {
-        // TODO: Switch to 2-bytes external string.
-        (void)jsArgs->CreateDataProperty(context, static_cast<uint32_t>(i), v8_helpers::MakeV8String(isolate, cppArgs[i]));
+        v8::Local<v8::Value> arg;
+        if (binary) {
+            auto bytes = v8::ArrayBuffer::New(isolate, cppArgs[i].size());
+            std::memcpy(bytes->GetContents().Data(), cppArgs[i].data(), cppArgs[i].size());
+            arg = bytes;
+        } else if (cppArgs[i].size() >= v8_helpers::EXTERNAL_STRING_MIN_LENGTH && napa::utils::IsAscii(cppArgs[i].data(), cppArgs[i].size())) {
+            // Marshalled JSON is mostly ASCII, V8 reads it in place instead of copying it. V8 garbage collection frees the resource.
+            auto resource = new CallArgumentResource(thisObject->Get<zone::CallContext>(), cppArgs[i]);
+            arg = v8::String::NewExternalOneByte(isolate, resource).ToLocalChecked();
+        } else {
+            arg = v8_helpers::MakeV8String(isolate, cppArgs[i]);
+        }
+        (void)jsArgs->CreateDataProperty(context, static_cast<uint32_t>(i), arg);
     }
     args.GetReturnValue().Set(jsArgs);
 }
@@ -130,8 +255,20 @@ void CallContextWrap::GetTransportContextCallback(v8::Local<v8::String> /*proper
     auto thisObject = NAPA_OBJECTWRAP::Unwrap<CallContextWrap>(args.Holder());
 
     auto& transportContext = thisObject->GetRef().GetTransportContext();
+
+    // A reused call context wrap re-points the transport context wrap it created for an earlier call.
+    if (!thisObject->_transportContextWrap.IsEmpty()) {
+        auto wrap = v8::Local<v8::Object>::New(isolate, thisObject->_transportContextWrap);
+        NAPA_OBJECTWRAP::Unwrap<TransportContextWrapImpl>(wrap)->Reset(&transportContext);
+        args.GetReturnValue().Set(wrap);
+        return;
+    }
+
     // Create a non-owning transport context wrap, since transport context is always owned by call context. 
     auto wrap = TransportContextWrapImpl::NewInstance(false, &transportContext);
+    if (!wrap.IsEmpty()) {
+        thisObject->_transportContextWrap.Reset(isolate, wrap);
+    }
     args.GetReturnValue().Set(wrap);
 }
 
@@ -139,9 +276,59 @@ void CallContextWrap::GetOptionsCallback(v8::Local<v8::String> /*propertyName*/,
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
     
+    auto context = isolate->GetCurrentContext();
+
     // Prepare execute options.
-    // NOTE: export necessary fields from CallContext.GetOptions to jsOptions object here. Now it's empty.
+    // NOTE: export necessary fields from CallContext.GetOptions to jsOptions object here.
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<CallContextWrap>(args.Holder());
+    const auto& options = thisObject->GetRef().GetOptions();
+
     auto jsOptions = v8::Object::New(isolate);
+    (void)jsOptions->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "timeout"),
+        v8::Uint32::NewFromUnsigned(isolate, options.timeout));
+
+    (void)jsOptions->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "priority"),
+        v8::Uint32::NewFromUnsigned(isolate, options.priority));
+
+    (void)jsOptions->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "deadline"),
+        v8::Number::New(isolate, static_cast<double>(options.deadline)));
+
+    (void)jsOptions->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "transport"),
+        v8::Uint32::NewFromUnsigned(isolate, static_cast<uint32_t>(options.transport)));
+
+    // Calls of sampled traces are timed for their spans as well.
+    (void)jsOptions->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "recordTiming"),
+        v8::Boolean::New(isolate, thisObject->GetRef().IsTimed()));
+
+    (void)jsOptions->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "collectGarbage"),
+        v8::Boolean::New(isolate, options.collect_garbage != 0));
+
+    (void)jsOptions->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "cacheTtl"),
+        v8::Uint32::NewFromUnsigned(isolate, options.cache_ttl));
+
+    (void)jsOptions->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "coalesce"),
+        v8::Boolean::New(isolate, options.coalesce != 0));
+
+    (void)jsOptions->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "detachDeadline"),
+        v8::Boolean::New(isolate, options.detach_deadline != 0));
 
     args.GetReturnValue().Set(jsOptions);
 }
@@ -23,6 +23,16 @@ namespace module {
         /// <summary> Create a new instance of wrap associating with specific call context. </summary>
         static v8::Local<v8::Object> NewInstance(std::shared_ptr<zone::CallContext> call);
 
+        /// <summary> Get a wrap released earlier on this worker, or a new one, associating with specific call context. </summary>
+        static v8::Local<v8::Object> Acquire(std::shared_ptr<zone::CallContext> call);
+
+        /// <summary> Release a wrap for reuse by a later call of this worker. </summary>
+        /// <remarks> The wrap must not be referenced by JavaScript anymore, since it will serve another call. </remarks>
+        static void Release(v8::Local<v8::Object> wrap);
+
+        /// <summary> Number of released wraps each worker keeps for reuse. </summary>
+        static constexpr size_t POOL_CAPACITY = 4;
+
         /// <summary> Get call context. </summary>
         zone::CallContext& GetRef();
 
@@ -39,6 +49,12 @@ namespace module {
         /// <summary> It implements CallContext.reject(reason: string): void </summary>
         static void RejectCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+        /// <summary> It implements CallContext.markStarted(): void </summary>
+        static void MarkStartedCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements CallContext.markFinished(): void </summary>
+        static void MarkFinishedCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
         /// <summary> It implements CallContext.finished: boolean </summary>
         static void IsFinishedCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
 
@@ -59,6 +75,13 @@ namespace module {
 
         /// <summary> It implements CallContext.elapse: [number, number] (precision in nano-second) </summary>
         static void GetElapseCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements CallContext.deadline: number (milliseconds since epoch, 0 for none) </summary>
+        static void GetDeadlineCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+
+    private:
+        /// <summary> Non-owning transport context wrap, re-pointed to the transport context of the current call. </summary>
+        v8::Global<v8::Object> _transportContextWrap;
     };
 }
 }
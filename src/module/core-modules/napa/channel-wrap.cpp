@@ -0,0 +1,271 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "channel-wrap.h"
+#include "sync-helpers.h"
+
+#include <zone/channel.h>
+
+#include <napa/async.h>
+#include <napa/module/binding/wraps.h>
+#include <napa/transport.h>
+
+#include <memory>
+#include <string>
+
+using namespace napa::module;
+using napa::zone::ChannelStatus;
+
+NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(napa::module::ChannelWrap);
+
+namespace {
+
+    /// <summary> A value in flight, marshalled by the sender and unmarshalled by the receiver. </summary>
+    /// <remarks> Transferred ArrayBuffers and SharedArrayBuffers move through the transport context without copies. </remarks>
+    struct ChannelMessage {
+        std::u16string payload;
+        napa::transport::TransportContext transportContext;
+    };
+
+    using ChannelMessagePtr = std::shared_ptr<ChannelMessage>;
+    using Channel = napa::zone::Channel<ChannelMessagePtr>;
+
+    /// <summary> A receive waiting for a value, the sending thread fills it before scheduling it back. </summary>
+    struct PendingReceive {
+        bool received = false;
+        ChannelMessagePtr message;
+    };
+
+    const char* CLOSED_MESSAGE = "Channel is closed.";
+
+    /// <summary> Marshalls a value to send, throws in JS if it can't be marshalled. </summary>
+    ChannelMessagePtr MarshallMessage(v8::Local<v8::Value> value, v8::Local<v8::Value> transferList) {
+        auto message = std::make_shared<ChannelMessage>();
+        auto payload = napa::transport::Marshall(value, &message->transportContext, transferList);
+        SHORT_CIRCUIT_ON_PENDING_EXCEPTION(payload, nullptr);
+
+        message->payload = napa::v8_helpers::V8ValueTo<std::u16string>(payload.ToLocalChecked());
+        return message;
+    }
+
+    /// <summary> Unmarshalls a received value, the result is empty if unmarshalling threw. </summary>
+    /// <remarks> A message is received once, so a long payload becomes an external string instead of being copied. </remarks>
+    v8::MaybeLocal<v8::Value> UnmarshallMessage(v8::Isolate* isolate, const ChannelMessagePtr& message) {
+        return napa::transport::Unmarshall(
+            napa::v8_helpers::MakeV8String(isolate, std::move(message->payload)),
+            &message->transportContext);
+    }
+
+    /// <summary> Settles a receive promise with a received value, or rejects it if the channel is closed. </summary>
+    void SettleReceive(v8::Local<v8::Function> settle, bool received, const ChannelMessagePtr& message) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+
+        if (!received) {
+            sync_helpers::Settle(settle, false, v8::Exception::Error(napa::v8_helpers::MakeV8String(isolate, CLOSED_MESSAGE)));
+            return;
+        }
+
+        v8::TryCatch tryCatch(isolate);
+        v8::Local<v8::Value> value;
+        if (UnmarshallMessage(isolate, message).ToLocal(&value) && !tryCatch.HasCaught()) {
+            sync_helpers::Settle(settle, true, value);
+        } else {
+            auto exception = tryCatch.Exception();
+            tryCatch.Reset();
+            sync_helpers::Settle(settle, false, exception);
+        }
+    }
+
+    /// <summary> Settles a send promise, or rejects it if the channel is closed. </summary>
+    void SettleSend(v8::Local<v8::Function> settle, bool sent) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+
+        sync_helpers::Settle(
+            settle,
+            sent,
+            sent ? v8::Local<v8::Value>(v8::Undefined(isolate))
+                 : v8::Exception::Error(napa::v8_helpers::MakeV8String(isolate, CLOSED_MESSAGE)));
+    }
+}
+
+void ChannelWrap::Init() {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto constructorTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<ChannelWrap>);
+    constructorTemplate->SetClassName(v8_helpers::MakeV8String(isolate, exportName));
+    constructorTemplate->InstanceTemplate()->SetInternalFieldCount(1);
+
+    InitConstructorTemplate<ChannelWrap>(constructorTemplate);
+
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "send", SendCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "sendSync", SendSyncCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "receive", ReceiveCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "receiveSync", ReceiveSyncCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "close", CloseCallback);
+    NAPA_SET_ACCESSOR(constructorTemplate, "capacity", GetCapacityCallback, nullptr);
+    NAPA_SET_ACCESSOR(constructorTemplate, "size", GetSizeCallback, nullptr);
+    NAPA_SET_ACCESSOR(constructorTemplate, "closed", GetClosedCallback, nullptr);
+
+    auto constructor = constructorTemplate->GetFunction();
+    InitConstructor("<ChannelWrap>", constructor);
+    NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructor);
+}
+
+v8::Local<v8::Object> ChannelWrap::NewInstance(size_t capacity) {
+    return binding::CreateShareableWrap(std::make_shared<Channel>(capacity), exportName);
+}
+
+void ChannelWrap::SendCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() >= 1, "1 argument is required for calling 'send'.");
+    CHECK_ARG(isolate, args.Length() < 2 || args[1]->IsUndefined() || args[1]->IsArray(),
+        "Argument \"transferList\" shall be an array of ArrayBuffers.");
+
+    auto transferList = args.Length() >= 2 && args[1]->IsArray() ? args[1] : v8::Local<v8::Value>();
+    auto message = MarshallMessage(args[0], transferList);
+    if (message == nullptr) {
+        return;
+    }
+
+    v8::Local<v8::Promise::Resolver> resolver;
+    if (!v8::Promise::Resolver::New(context).ToLocal(&resolver)) {
+        return;
+    }
+    args.GetReturnValue().Set(resolver->GetPromise());
+    auto settle = sync_helpers::MakeSettleFunction(context, resolver);
+
+    // The sender lets go of transferred ArrayBuffers right away, even if the send waits for room.
+    if (!transferList.IsEmpty()) {
+        napa::transport::Detach(transferList);
+    }
+
+    auto channel = NAPA_OBJECTWRAP::Unwrap<ChannelWrap>(args.Holder())->Get<Channel>();
+    auto status = channel->SendFor(message, std::chrono::milliseconds(0));
+    if (status != ChannelStatus::TIMEOUT) {
+        SettleSend(settle, status == ChannelStatus::SUCCESS);
+        return;
+    }
+
+    // The channel is full, the worker serves other tasks until a receiver makes room.
+    napa::zone::DoAsyncWork(settle,
+        [channel, message](std::function<void(void*)> complete) {
+            channel->SendAsync(message, [complete](bool sent) {
+                complete(reinterpret_cast<void*>(static_cast<uintptr_t>(sent)));
+            });
+        },
+        [](v8::Local<v8::Function> settle, void* result) {
+            SettleSend(settle, reinterpret_cast<uintptr_t>(result) != 0);
+        });
+}
+
+void ChannelWrap::SendSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() >= 1, "1 argument is required for calling 'sendSync'.");
+    CHECK_ARG(isolate, args.Length() < 2 || args[1]->IsUndefined() || args[1]->IsArray(),
+        "Argument \"transferList\" shall be an array of ArrayBuffers.");
+
+    bool hasTimeout = false;
+    std::chrono::milliseconds timeout(0);
+    if (!sync_helpers::GetTimeoutArgument(args, 2, hasTimeout, timeout)) {
+        return;
+    }
+
+    auto transferList = args.Length() >= 2 && args[1]->IsArray() ? args[1] : v8::Local<v8::Value>();
+    auto message = MarshallMessage(args[0], transferList);
+    if (message == nullptr) {
+        return;
+    }
+
+    auto channel = NAPA_OBJECTWRAP::Unwrap<ChannelWrap>(args.Holder())->Get<Channel>();
+    auto status = hasTimeout ? channel->SendFor(message, timeout) : channel->Send(message);
+    JS_ENSURE(isolate, status != ChannelStatus::CLOSED, "%s", CLOSED_MESSAGE);
+    JS_ENSURE(isolate, status != ChannelStatus::TIMEOUT,
+        "Channel stayed full for %d milliseconds.", static_cast<int>(timeout.count()));
+
+    // Transferred ArrayBuffers stay with the sender if the value wasn't sent.
+    if (!transferList.IsEmpty()) {
+        napa::transport::Detach(transferList);
+    }
+}
+
+void ChannelWrap::ReceiveCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    v8::Local<v8::Promise::Resolver> resolver;
+    if (!v8::Promise::Resolver::New(context).ToLocal(&resolver)) {
+        return;
+    }
+    args.GetReturnValue().Set(resolver->GetPromise());
+    auto settle = sync_helpers::MakeSettleFunction(context, resolver);
+
+    auto channel = NAPA_OBJECTWRAP::Unwrap<ChannelWrap>(args.Holder())->Get<Channel>();
+    ChannelMessagePtr message;
+    auto status = channel->ReceiveFor(message, std::chrono::milliseconds(0));
+    if (status != ChannelStatus::TIMEOUT) {
+        SettleReceive(settle, status == ChannelStatus::SUCCESS, message);
+        return;
+    }
+
+    // The channel is empty, the worker serves other tasks until a sender hands it a value.
+    auto pending = std::make_shared<PendingReceive>();
+    napa::zone::DoAsyncWork(settle,
+        [channel, pending](std::function<void(void*)> complete) {
+            channel->ReceiveAsync([pending, complete](bool received, ChannelMessagePtr message) {
+                pending->received = received;
+                pending->message = std::move(message);
+                complete(nullptr);
+            });
+        },
+        [pending](v8::Local<v8::Function> settle, void*) {
+            SettleReceive(settle, pending->received, pending->message);
+        });
+}
+
+void ChannelWrap::ReceiveSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    bool hasTimeout = false;
+    std::chrono::milliseconds timeout(0);
+    if (!sync_helpers::GetTimeoutArgument(args, 0, hasTimeout, timeout)) {
+        return;
+    }
+
+    auto channel = NAPA_OBJECTWRAP::Unwrap<ChannelWrap>(args.Holder())->Get<Channel>();
+    ChannelMessagePtr message;
+    auto status = hasTimeout ? channel->ReceiveFor(message, timeout) : channel->Receive(message);
+    JS_ENSURE(isolate, status != ChannelStatus::CLOSED, "%s", CLOSED_MESSAGE);
+    JS_ENSURE(isolate, status != ChannelStatus::TIMEOUT,
+        "Channel stayed empty for %d milliseconds.", static_cast<int>(timeout.count()));
+
+    auto value = UnmarshallMessage(isolate, message);
+    RETURN_ON_PENDING_EXCEPTION(value);
+    args.GetReturnValue().Set(value.ToLocalChecked());
+}
+
+void ChannelWrap::CloseCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    NAPA_OBJECTWRAP::Unwrap<ChannelWrap>(args.Holder())->Get<Channel>()->Close();
+}
+
+void ChannelWrap::GetCapacityCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto channel = NAPA_OBJECTWRAP::Unwrap<ChannelWrap>(args.Holder())->Get<Channel>();
+    args.GetReturnValue().Set(static_cast<uint32_t>(channel->GetCapacity()));
+}
+
+void ChannelWrap::GetSizeCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto channel = NAPA_OBJECTWRAP::Unwrap<ChannelWrap>(args.Holder())->Get<Channel>();
+    args.GetReturnValue().Set(static_cast<uint32_t>(channel->GetSize()));
+}
+
+void ChannelWrap::GetClosedCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto channel = NAPA_OBJECTWRAP::Unwrap<ChannelWrap>(args.Holder())->Get<Channel>();
+    args.GetReturnValue().Set(channel->IsClosed());
+}
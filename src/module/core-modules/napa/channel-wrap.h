@@ -0,0 +1,44 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/module.h>
+#include <napa/module/shareable-wrap.h>
+
+namespace napa {
+namespace module {
+
+    /// <summary> An object wrap to expose channel APIs. </summary>
+    class ChannelWrap : public ShareableWrap {
+    public:
+
+        /// <summary> Initializes the wrap. </summary>
+        static void Init();
+
+        /// <summary> Creates a new instance of ChannelWrap. </summary>
+        /// <param name="capacity"> The number of values the channel holds before senders wait. </param>
+        static v8::Local<v8::Object> NewInstance(size_t capacity);
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "ChannelWrap";
+
+        /// <summary> Declare persistent constructor to create Channel Javascript wrapper instance. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
+    private:
+
+        // ChannelWrap methods
+        static void SendCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void SendSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void ReceiveCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void ReceiveSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void CloseCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        // ChannelWrap accessors
+        static void GetCapacityCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+        static void GetSizeCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+        static void GetClosedCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+    };
+}
+}
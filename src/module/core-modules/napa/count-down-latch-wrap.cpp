@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "count-down-latch-wrap.h"
+#include "sync-helpers.h"
+
+#include <zone/count-down-latch.h>
+
+#include <napa/async.h>
+#include <napa/module/binding/wraps.h>
+
+#include <memory>
+
+using namespace napa::module;
+using napa::zone::CountDownLatch;
+
+NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(napa::module::CountDownLatchWrap);
+
+void CountDownLatchWrap::Init() {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto constructorTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<CountDownLatchWrap>);
+    constructorTemplate->SetClassName(v8_helpers::MakeV8String(isolate, exportName));
+    constructorTemplate->InstanceTemplate()->SetInternalFieldCount(1);
+
+    InitConstructorTemplate<CountDownLatchWrap>(constructorTemplate);
+
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "countDown", CountDownCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "wait", WaitCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "waitSync", WaitSyncCallback);
+    NAPA_SET_ACCESSOR(constructorTemplate, "count", GetCountCallback, nullptr);
+
+    auto constructor = constructorTemplate->GetFunction();
+    InitConstructor("<CountDownLatchWrap>", constructor);
+    NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructor);
+}
+
+v8::Local<v8::Object> CountDownLatchWrap::NewInstance(uint32_t count) {
+    return binding::CreateShareableWrap(std::make_shared<CountDownLatch>(count), exportName);
+}
+
+void CountDownLatchWrap::CountDownCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 0 || args[0]->IsUndefined() || args[0]->IsUint32(),
+        "Argument \"count\" shall be a non-negative integer.");
+
+    uint32_t count = 1;
+    if (args.Length() > 0 && args[0]->IsUint32()) {
+        count = args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust();
+    }
+    NAPA_OBJECTWRAP::Unwrap<CountDownLatchWrap>(args.Holder())->Get<CountDownLatch>()->CountDown(count);
+}
+
+void CountDownLatchWrap::WaitCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    v8::Local<v8::Promise::Resolver> resolver;
+    if (!v8::Promise::Resolver::New(context).ToLocal(&resolver)) {
+        return;
+    }
+    args.GetReturnValue().Set(resolver->GetPromise());
+    auto settle = sync_helpers::MakeSettleFunction(context, resolver);
+
+    auto latch = NAPA_OBJECTWRAP::Unwrap<CountDownLatchWrap>(args.Holder())->Get<CountDownLatch>();
+    if (latch->GetCount() == 0) {
+        sync_helpers::Settle(settle, true, v8::Undefined(isolate));
+        return;
+    }
+
+    // The latch is closed, the worker serves other tasks until the opening thread schedules it back.
+    napa::zone::DoAsyncWork(settle,
+        [latch](std::function<void(void*)> complete) {
+            latch->WaitAsync([complete]() {
+                complete(nullptr);
+            });
+        },
+        [](v8::Local<v8::Function> settle, void*) {
+            sync_helpers::Settle(settle, true, v8::Undefined(v8::Isolate::GetCurrent()));
+        });
+}
+
+void CountDownLatchWrap::WaitSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    bool hasTimeout = false;
+    std::chrono::milliseconds timeout(0);
+    if (!sync_helpers::GetTimeoutArgument(args, 0, hasTimeout, timeout)) {
+        return;
+    }
+
+    auto latch = NAPA_OBJECTWRAP::Unwrap<CountDownLatchWrap>(args.Holder())->Get<CountDownLatch>();
+    if (!hasTimeout) {
+        latch->Wait();
+    } else {
+        JS_ENSURE(isolate, latch->WaitFor(timeout),
+            "Latch is not open in %d milliseconds.", static_cast<int>(timeout.count()));
+    }
+}
+
+void CountDownLatchWrap::GetCountCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto latch = NAPA_OBJECTWRAP::Unwrap<CountDownLatchWrap>(args.Holder())->Get<CountDownLatch>();
+    args.GetReturnValue().Set(latch->GetCount());
+}
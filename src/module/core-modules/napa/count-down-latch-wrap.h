@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/module.h>
+#include <napa/module/shareable-wrap.h>
+
+namespace napa {
+namespace module {
+
+    /// <summary> An object wrap to expose count down latch APIs. </summary>
+    class CountDownLatchWrap : public ShareableWrap {
+    public:
+
+        /// <summary> Initializes the wrap. </summary>
+        static void Init();
+
+        /// <summary> Creates a new instance of CountDownLatchWrap. </summary>
+        /// <param name="count"> The number of count downs that open the latch. </param>
+        static v8::Local<v8::Object> NewInstance(uint32_t count);
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "CountDownLatchWrap";
+
+        /// <summary> Declare persistent constructor to create CountDownLatch Javascript wrapper instance. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
+    private:
+
+        // CountDownLatchWrap methods
+        static void CountDownCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void WaitCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void WaitSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        // CountDownLatchWrap accessors
+        static void GetCountCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+    };
+}
+}
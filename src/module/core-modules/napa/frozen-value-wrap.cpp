@@ -0,0 +1,200 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "frozen-value-wrap.h"
+
+#include <napa/module/binding/wraps.h>
+
+using namespace napa::module;
+using napa::store::FrozenValue;
+using napa::store::FrozenValueKind;
+
+NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(napa::module::FrozenValueWrap);
+
+namespace {
+
+    /// <summary> Make the reference of a node passed to scripts. </summary>
+    double MakeReference(const FrozenValue& value, uint32_t node) {
+        return static_cast<double>(node | static_cast<uint32_t>(value.GetKind(node)));
+    }
+
+    /// <summary> Get the frozen value and the node of a reference argument. </summary>
+    /// <returns> Null with an exception thrown if the reference is not of a node of the value. </returns>
+    const FrozenValue* GetNodeArgument(const v8::FunctionCallbackInfo<v8::Value>& args, uint32_t& node) {
+        auto isolate = v8::Isolate::GetCurrent();
+        auto value = NAPA_OBJECTWRAP::Unwrap<FrozenValueWrap>(args.Holder())->Get<FrozenValue>().get();
+        JS_ENSURE_WITH_RETURN(isolate, value != nullptr, nullptr, "Frozen value is not loaded.");
+        JS_ENSURE_WITH_RETURN(isolate, args.Length() > 0 && args[0]->IsUint32(), nullptr,
+            "Argument \"reference\" shall be a node reference.");
+
+        node = args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust() & ~7u;
+        JS_ENSURE_WITH_RETURN(isolate, value->IsNode(node), nullptr, "Argument \"reference\" is not a node of the value.");
+        return value;
+    }
+
+    /// <summary> Parse a canonical array index, like the keys a proxy gets for elements. </summary>
+    bool ParseIndex(const char* key, size_t length, uint32_t& index) {
+        if (length == 0 || length > 10 || (length > 1 && key[0] == '0')) {
+            return false;
+        }
+        uint64_t result = 0;
+        for (size_t i = 0; i < length; ++i) {
+            if (key[i] < '0' || key[i] > '9') {
+                return false;
+            }
+            result = result * 10 + static_cast<uint64_t>(key[i] - '0');
+        }
+        if (result >= FrozenValue::NOT_FOUND) {
+            return false;
+        }
+        index = static_cast<uint32_t>(result);
+        return true;
+    }
+}
+
+void FrozenValueWrap::Init() {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto constructorTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<FrozenValueWrap>);
+    constructorTemplate->SetClassName(v8_helpers::MakeV8String(isolate, exportName));
+    constructorTemplate->InstanceTemplate()->SetInternalFieldCount(1);
+
+    InitConstructorTemplate<FrozenValueWrap>(constructorTemplate);
+
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "child", ChildCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "read", ReadCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "count", CountCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "keys", KeysCallback);
+    NAPA_SET_ACCESSOR(constructorTemplate, "rootReference", GetRootReferenceCallback, nullptr);
+    NAPA_SET_ACCESSOR(constructorTemplate, "byteLength", GetByteLengthCallback, nullptr);
+
+    auto constructor = constructorTemplate->GetFunction();
+    InitConstructor("<FrozenValueWrap>", constructor);
+    NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructor);
+}
+
+v8::Local<v8::Object> FrozenValueWrap::NewInstance(std::shared_ptr<FrozenValue> value) {
+    auto byteLength = value->GetByteLength();
+    return binding::CreateShareableWrap(std::move(value), exportName, byteLength);
+}
+
+void FrozenValueWrap::ChildCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    uint32_t node = 0;
+    auto value = GetNodeArgument(args, node);
+    if (value == nullptr) {
+        return;
+    }
+    CHECK_ARG(isolate, args.Length() == 2 && (args[1]->IsString() || args[1]->IsUint32()),
+        "Argument \"key\" shall be a string or an index.");
+
+    auto child = FrozenValue::NOT_FOUND;
+    auto kind = value->GetKind(node);
+    if (kind == FrozenValueKind::Array) {
+        uint32_t index = 0;
+        if (args[1]->IsUint32()) {
+            child = value->GetElement(node, args[1]->Uint32Value(isolate->GetCurrentContext()).FromJust());
+        } else {
+            v8::String::Utf8Value key(args[1]);
+            if (ParseIndex(*key, static_cast<size_t>(key.length()), index)) {
+                child = value->GetElement(node, index);
+            }
+        }
+    } else if (kind == FrozenValueKind::Object) {
+        v8::String::Utf8Value key(args[1]);
+        child = value->FindProperty(node, *key, static_cast<size_t>(key.length()));
+    }
+
+    if (child == FrozenValue::NOT_FOUND) {
+        args.GetReturnValue().Set(-1);
+        return;
+    }
+    args.GetReturnValue().Set(MakeReference(*value, child));
+}
+
+void FrozenValueWrap::ReadCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    uint32_t node = 0;
+    auto value = GetNodeArgument(args, node);
+    if (value == nullptr) {
+        return;
+    }
+
+    switch (value->GetKind(node)) {
+    case FrozenValueKind::Null:
+        args.GetReturnValue().SetNull();
+        break;
+    case FrozenValueKind::False:
+    case FrozenValueKind::True:
+        args.GetReturnValue().Set(value->GetKind(node) == FrozenValueKind::True);
+        break;
+    case FrozenValueKind::Number:
+        args.GetReturnValue().Set(value->GetNumber(node));
+        break;
+    case FrozenValueKind::String:
+        args.GetReturnValue().Set(v8::String::NewFromUtf8(
+            isolate,
+            value->GetString(node),
+            v8::NewStringType::kNormal,
+            static_cast<int>(value->GetCount(node))).ToLocalChecked());
+        break;
+    default:
+        JS_FAIL(isolate, "Arrays and objects of a frozen value are read through their proxies.");
+    }
+}
+
+void FrozenValueWrap::CountCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    uint32_t node = 0;
+    auto value = GetNodeArgument(args, node);
+    if (value == nullptr) {
+        return;
+    }
+    auto kind = value->GetKind(node);
+    args.GetReturnValue().Set(kind == FrozenValueKind::Array || kind == FrozenValueKind::Object ? value->GetCount(node) : 0);
+}
+
+void FrozenValueWrap::KeysCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    uint32_t node = 0;
+    auto value = GetNodeArgument(args, node);
+    if (value == nullptr) {
+        return;
+    }
+
+    auto kind = value->GetKind(node);
+    auto count = kind == FrozenValueKind::Array || kind == FrozenValueKind::Object ? value->GetCount(node) : 0;
+    auto keys = v8::Array::New(isolate, static_cast<int>(count));
+    for (uint32_t i = 0; i < count; ++i) {
+        v8::Local<v8::Value> key;
+        if (kind == FrozenValueKind::Array) {
+            key = v8_helpers::MakeV8String(isolate, std::to_string(i));
+        } else {
+            auto keyNode = value->GetPropertyKey(node, i);
+            key = v8::String::NewFromUtf8(
+                isolate,
+                value->GetString(keyNode),
+                v8::NewStringType::kNormal,
+                static_cast<int>(value->GetCount(keyNode))).ToLocalChecked();
+        }
+        (void)keys->Set(context, i, key);
+    }
+    args.GetReturnValue().Set(keys);
+}
+
+void FrozenValueWrap::GetRootReferenceCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto value = NAPA_OBJECTWRAP::Unwrap<FrozenValueWrap>(args.Holder())->Get<FrozenValue>();
+    if (value != nullptr) {
+        args.GetReturnValue().Set(MakeReference(*value, value->GetRoot()));
+    }
+}
+
+void FrozenValueWrap::GetByteLengthCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto value = NAPA_OBJECTWRAP::Unwrap<FrozenValueWrap>(args.Holder())->Get<FrozenValue>();
+    args.GetReturnValue().Set(static_cast<double>(value != nullptr ? value->GetByteLength() : 0));
+}
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/module.h>
+#include <napa/module/shareable-wrap.h>
+
+#include <store/frozen-value.h>
+
+namespace napa {
+namespace module {
+
+    /// <summary> An object wrap of napa::store::FrozenValue, read through the proxies of napajs/lib/store/frozen-value.ts. </summary>
+    /// <remarks>
+    /// Nodes are passed to and from scripts as references, the offset of the node with its kind in the 3 low bits,
+    /// so a proxy tells a scalar from a container without calling back.
+    /// </remarks>
+    class FrozenValueWrap : public ShareableWrap {
+    public:
+
+        /// <summary> Initializes the wrap. </summary>
+        static void Init();
+
+        /// <summary> Creates a new instance of FrozenValueWrap. </summary>
+        static v8::Local<v8::Object> NewInstance(std::shared_ptr<napa::store::FrozenValue> value);
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "FrozenValueWrap";
+
+        /// <summary> Declare persistent constructor to create FrozenValue Javascript wrapper instance. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
+    private:
+
+        /// <summary> It implements FrozenValueWrap.child(reference: number, key: string | number): number, -1 if not found. </summary>
+        static void ChildCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements FrozenValueWrap.read(reference: number): number | string </summary>
+        static void ReadCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements FrozenValueWrap.count(reference: number): number </summary>
+        static void CountCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements FrozenValueWrap.keys(reference: number): string[] </summary>
+        static void KeysCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        // FrozenValueWrap accessors
+        static void GetRootReferenceCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+        static void GetByteLengthCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+    };
+}
+}
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "hash.h"
+
+#include <napa/module.h>
+#include <utils/hash.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+using namespace napa;
+using namespace napa::module;
+using namespace napa::v8_helpers;
+
+namespace {
+
+    /// <summary> Bytes of a hash input, strings are hashed as UTF-8. </summary>
+    struct InputBytes {
+        const void* data = nullptr;
+        size_t length = 0;
+
+        /// <summary> The UTF-8 bytes of string inputs. </summary>
+        std::string utf8;
+    };
+
+    /// <summary> Get the bytes of a string, ArrayBuffer, SharedArrayBuffer or ArrayBufferView argument. </summary>
+    /// <returns> False with an exception thrown if the argument is of another type. </returns>
+    bool GetInput(const v8::FunctionCallbackInfo<v8::Value>& args, InputBytes& input) {
+        auto isolate = v8::Isolate::GetCurrent();
+        JS_ENSURE_WITH_RETURN(isolate, args.Length() > 0, false, "Argument \"input\" is required.");
+
+        auto value = args[0];
+        if (value->IsString()) {
+            v8::String::Utf8Value utf8(value);
+            input.utf8.assign(*utf8, utf8.length());
+            input.data = input.utf8.data();
+            input.length = input.utf8.size();
+        } else if (value->IsArrayBuffer()) {
+            auto contents = v8::Local<v8::ArrayBuffer>::Cast(value)->GetContents();
+            input.data = contents.Data();
+            input.length = contents.ByteLength();
+        } else if (value->IsSharedArrayBuffer()) {
+            auto contents = v8::Local<v8::SharedArrayBuffer>::Cast(value)->GetContents();
+            input.data = contents.Data();
+            input.length = contents.ByteLength();
+        } else if (value->IsArrayBufferView()) {
+            auto view = v8::Local<v8::ArrayBufferView>::Cast(value);
+            v8::Local<v8::Value> buffer = view->Buffer();
+            void* contents = buffer->IsSharedArrayBuffer()
+                ? v8::Local<v8::SharedArrayBuffer>::Cast(buffer)->GetContents().Data()
+                : v8::Local<v8::ArrayBuffer>::Cast(buffer)->GetContents().Data();
+            input.data = static_cast<const uint8_t*>(contents) + view->ByteOffset();
+            input.length = view->ByteLength();
+        } else {
+            JS_ENSURE_WITH_RETURN(isolate, false, false,
+                "Argument \"input\" shall be a string, an ArrayBuffer or an ArrayBufferView.");
+        }
+        return true;
+    }
+
+    /// <summary> It implements hash.xxhash64(input: string | ArrayBuffer | ArrayBufferView, seed?: number): string </summary>
+    /// <remarks> 64-bit hashes don't fit in numbers, they're returned as 16 hexadecimal digits. </remarks>
+    void XxHash64Callback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        auto context = isolate->GetCurrentContext();
+
+        InputBytes input;
+        if (!GetInput(args, input)) {
+            return;
+        }
+
+        uint64_t seed = 0;
+        if (args.Length() > 1 && !args[1]->IsUndefined()) {
+            CHECK_ARG(isolate, args[1]->IsNumber(), "Argument \"seed\" shall be a number.");
+            seed = static_cast<uint64_t>(args[1]->IntegerValue(context).FromJust());
+        }
+
+        char hex[17];
+        std::snprintf(hex, sizeof(hex), "%016llx",
+            static_cast<unsigned long long>(utils::hash::XxHash64(input.data, input.length, seed)));
+        args.GetReturnValue().Set(MakeV8String(isolate, hex));
+    }
+
+    /// <summary> It implements hash.crc32c(input: string | ArrayBuffer | ArrayBufferView, crc?: number): number </summary>
+    void Crc32cCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        auto context = isolate->GetCurrentContext();
+
+        InputBytes input;
+        if (!GetInput(args, input)) {
+            return;
+        }
+
+        uint32_t crc = 0;
+        if (args.Length() > 1 && !args[1]->IsUndefined()) {
+            CHECK_ARG(isolate, args[1]->IsUint32(), "Argument \"crc\" shall be an unsigned 32-bit integer.");
+            crc = args[1]->Uint32Value(context).FromJust();
+        }
+        args.GetReturnValue().Set(utils::hash::Crc32c(input.data, input.length, crc));
+    }
+
+    /// <summary> It implements hash.sha256(input: string | ArrayBuffer | ArrayBufferView): string </summary>
+    void Sha256Callback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+
+        InputBytes input;
+        if (!GetInput(args, input)) {
+            return;
+        }
+
+        static const char* DIGITS = "0123456789abcdef";
+        auto digest = utils::hash::Sha256(input.data, input.length);
+        std::string hex;
+        hex.reserve(digest.size() * 2);
+        for (auto byte : digest) {
+            hex.push_back(DIGITS[byte >> 4]);
+            hex.push_back(DIGITS[byte & 0xF]);
+        }
+        args.GetReturnValue().Set(MakeV8String(isolate, hex));
+    }
+}
+
+void hash::Init(v8::Local<v8::Object> exports) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    NAPA_SET_METHOD(exports, "xxhash64", XxHash64Callback);
+    NAPA_SET_METHOD(exports, "crc32c", Crc32cCallback);
+    NAPA_SET_METHOD(exports, "sha256", Sha256Callback);
+
+    (void)exports->CreateDataProperty(
+        isolate->GetCurrentContext(),
+        MakeV8String(isolate, "hardwareCrc32c"),
+        v8::Boolean::New(isolate, utils::hash::IsCrc32cHardwareAccelerated()));
+}
@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <v8.h>
+
+namespace napa {
+namespace module {
+
+/// <summary> Native hash functions of namespace 'hash', over strings and binary data. </summary>
+namespace hash {
+
+    /// <summary> Set hash functions. </summary>
+    /// <param name="exports"> Object to set functions. </param>
+    void Init(v8::Local<v8::Object> exports);
+
+}   // End of namespace hash
+}   // End of namespace module
+}   // End of namespace napa
@@ -2,17 +2,109 @@
 // Licensed under the MIT license.
 
 #include "lock-wrap.h"
+#include "sync-helpers.h"
 
+#include <zone/async-lock.h>
+
+#include <napa/async.h>
 #include <napa/module/binding/wraps.h>
 
 #include <memory>
-#include <mutex>
 #include <vector>
 
 using namespace napa::module;
+using napa::zone::AsyncLock;
 
 NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(napa::module::LockWrap);
 
+namespace {
+
+    /// <summary> A guard waiting for the lock, it keeps its arguments alive until it runs. </summary>
+    struct PendingGuard {
+        v8::Persistent<v8::Object> holder;
+        v8::Persistent<v8::Value> params;
+        v8::Persistent<v8::Promise::Resolver> resolver;
+
+        ~PendingGuard() {
+            holder.Reset();
+            params.Reset();
+            resolver.Reset();
+        }
+    };
+
+    /// <summary> Releases the lock of a guard once the promise returned by its function settles. </summary>
+    /// <remarks> Callback data is an array of the lock wrap and the resolver of the guard promise. </remarks>
+    template <bool fulfilled>
+    void OnGuardedPromiseSettled(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+        auto context = isolate->GetCurrentContext();
+
+        auto data = v8::Local<v8::Array>::Cast(args.Data());
+        auto holder = v8::Local<v8::Object>::Cast(data->Get(context, 0).ToLocalChecked());
+        auto resolver = v8::Local<v8::Promise::Resolver>::Cast(data->Get(context, 1).ToLocalChecked());
+
+        NAPA_OBJECTWRAP::Unwrap<LockWrap>(holder)->Get<AsyncLock>()->Unlock();
+
+        auto value = args.Length() > 0 ? args[0] : v8::Local<v8::Value>(v8::Undefined(isolate));
+        if (fulfilled) {
+            (void)resolver->Resolve(context, value);
+        } else {
+            (void)resolver->Reject(context, value);
+        }
+    }
+
+    /// <summary> Runs the function of a guard that holds the lock, and settles the guard promise with its outcome. </summary>
+    /// <remarks> The lock is released once the function returns, or once the promise it returns settles. </remarks>
+    void RunGuard(v8::Local<v8::Object> holder,
+                  v8::Local<v8::Function> func,
+                  v8::Local<v8::Value> params,
+                  v8::Local<v8::Promise::Resolver> resolver) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+        auto context = isolate->GetCurrentContext();
+
+        std::vector<v8::Local<v8::Value>> argv;
+        if (params->IsArray()) {
+            auto paramsArray = v8::Local<v8::Array>::Cast(params);
+            argv.reserve(paramsArray->Length());
+            for (uint32_t i = 0; i < paramsArray->Length(); i++) {
+                argv.emplace_back(paramsArray->Get(context, i).ToLocalChecked());
+            }
+        }
+
+        v8::TryCatch tryCatch(isolate);
+        auto result = func->Call(context, holder, static_cast<int>(argv.size()), argv.empty() ? nullptr : argv.data());
+        auto lock = NAPA_OBJECTWRAP::Unwrap<LockWrap>(holder)->Get<AsyncLock>();
+
+        v8::Local<v8::Value> value;
+        if (!result.ToLocal(&value) || tryCatch.HasCaught()) {
+            lock->Unlock();
+            (void)resolver->Reject(context, tryCatch.Exception());
+            return;
+        }
+
+        if (!value->IsPromise()) {
+            lock->Unlock();
+            (void)resolver->Resolve(context, value);
+            return;
+        }
+
+        auto data = v8::Array::New(isolate, 2);
+        (void)data->Set(context, 0, holder);
+        (void)data->Set(context, 1, resolver);
+
+        auto onFulfilled = v8::Function::New(context, OnGuardedPromiseSettled<true>, data).ToLocalChecked();
+        auto onRejected = v8::Function::New(context, OnGuardedPromiseSettled<false>, data).ToLocalChecked();
+
+        // Rejections skip onFulfilled and reach onRejected through the promise returned by 'Then'.
+        v8::Local<v8::Promise> chained;
+        if (v8::Local<v8::Promise>::Cast(value)->Then(context, onFulfilled).ToLocal(&chained)) {
+            (void)chained->Catch(context, onRejected);
+        }
+    }
+}
+
 void LockWrap::Init() {
     auto isolate = v8::Isolate::GetCurrent();
     auto constructorTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<LockWrap>);
@@ -22,6 +114,8 @@ void LockWrap::Init() {
     InitConstructorTemplate<LockWrap>(constructorTemplate);
 
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "guardSync", GuardSyncCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "tryGuardSync", TryGuardSyncCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "guard", GuardCallback);
 
     auto constructor = constructorTemplate->GetFunction();
     InitConstructor("<LockWrap>", constructor);
@@ -29,51 +123,92 @@ void LockWrap::Init() {
 }
 
 v8::Local<v8::Object> LockWrap::NewInstance() {
-    return binding::CreateShareableWrap(std::make_shared<std::mutex>(), exportName);
+    return binding::CreateShareableWrap(std::make_shared<AsyncLock>(), exportName);
 }
 
 void LockWrap::GuardSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
 
-    CHECK_ARG(isolate, args.Length() >= 1, "1 argument is required for calling 'guardSync'.");
-    CHECK_ARG(isolate, args[0]->IsFunction(), "Argument \"func\" shall be 'Function' type.");
-    CHECK_ARG(isolate, args.Length() < 2 || args[1]->IsArray(), "Argument \"params\" shall be a valid array.");
+    bool hasTimeout = false;
+    std::chrono::milliseconds timeout;
+    if (!sync_helpers::CheckGuardArguments(args, "guardSync")
+        || !sync_helpers::GetTimeoutArgument(args, 2, hasTimeout, timeout)) {
+        return;
+    }
 
-    auto context = isolate->GetCurrentContext();
-    auto holder = args.Holder();
-    auto thisObject = NAPA_OBJECTWRAP::Unwrap<LockWrap>(args.Holder());
+    auto lock = NAPA_OBJECTWRAP::Unwrap<LockWrap>(args.Holder())->Get<AsyncLock>();
+    if (!hasTimeout) {
+        lock->Lock();
+    } else {
+        JS_ENSURE(isolate, lock->TryLockFor(timeout),
+            "Lock is not obtained in %d milliseconds.", static_cast<int>(timeout.count()));
+    }
 
-    v8::TryCatch tryCatch(isolate);
-    try {
-        auto mutex = thisObject->Get<std::mutex>();
-        std::lock_guard<std::mutex> guard(*mutex);
+    sync_helpers::CallGuardedFunction(args);
+    lock->Unlock();
+}
 
-        std::vector<v8::Local<v8::Value>> params;
+void LockWrap::TryGuardSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
 
-        if (args.Length() >= 2) {
-            auto paramsArray = v8::Local<v8::Array>::Cast(args[1]);
-            int paramsLength = paramsArray->Length();
-            params.reserve(paramsLength);
+    if (!sync_helpers::CheckGuardArguments(args, "tryGuardSync")) {
+        return;
+    }
 
-            for (int i = 0; i < paramsLength; i++) {
-                auto item = paramsArray->Get(context, i).ToLocalChecked();
-                params.emplace_back(item);
-            }
-        }
+    auto lock = NAPA_OBJECTWRAP::Unwrap<LockWrap>(args.Holder())->Get<AsyncLock>();
+    if (lock->TryLock()) {
+        sync_helpers::CallGuardedFunction(args);
+        lock->Unlock();
+    }
+}
 
-        auto result = v8::Local<v8::Function>::Cast(args[0])->Call(
-            context,
-            holder,
-            static_cast<int>(params.size()),
-            params.empty() ? nullptr : params.data());
+void LockWrap::GuardCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
 
-        if (result.IsEmpty() || tryCatch.HasCaught()) {
-            tryCatch.ReThrow();
-        } else {
-            args.GetReturnValue().Set(result.ToLocalChecked());
-        }
-    } catch (const std::system_error& ex) {
-        isolate->ThrowException(v8::Exception::Error(v8_helpers::MakeV8String(isolate, ex.what())));
+    if (!sync_helpers::CheckGuardArguments(args, "guard")) {
+        return;
+    }
+
+    auto context = isolate->GetCurrentContext();
+    auto holder = args.Holder();
+    auto func = v8::Local<v8::Function>::Cast(args[0]);
+    auto params = args.Length() >= 2 ? args[1] : v8::Local<v8::Value>(v8::Undefined(isolate));
+
+    v8::Local<v8::Promise::Resolver> resolver;
+    if (!v8::Promise::Resolver::New(context).ToLocal(&resolver)) {
+        return;
     }
+    args.GetReturnValue().Set(resolver->GetPromise());
+
+    auto lock = NAPA_OBJECTWRAP::Unwrap<LockWrap>(holder)->Get<AsyncLock>();
+    if (lock->TryLock()) {
+        RunGuard(holder, func, params, resolver);
+        return;
+    }
+
+    // The worker serves other tasks while the guard waits, the releasing thread schedules it back.
+    auto pending = std::make_shared<PendingGuard>();
+    pending->holder.Reset(isolate, holder);
+    pending->params.Reset(isolate, params);
+    pending->resolver.Reset(isolate, resolver);
+
+    napa::zone::DoAsyncWork(func,
+        [lock](std::function<void(void*)> complete) {
+            lock->LockAsync([complete]() {
+                complete(nullptr);
+            });
+        },
+        [pending](v8::Local<v8::Function> func, void*) {
+            auto isolate = v8::Isolate::GetCurrent();
+            v8::HandleScope scope(isolate);
+
+            RunGuard(
+                v8::Local<v8::Object>::New(isolate, pending->holder),
+                func,
+                v8::Local<v8::Value>::New(isolate, pending->params),
+                v8::Local<v8::Promise::Resolver>::New(isolate, pending->resolver));
+        });
 }
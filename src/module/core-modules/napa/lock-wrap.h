@@ -29,6 +29,8 @@ namespace module {
 
         // LockWrap methods
         static void GuardSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void TryGuardSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void GuardCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
     };
 }
-}
\ No newline at end of file
+}
@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "metric-series-wrap.h"
+
+using namespace napa::module;
+using namespace napa::v8_helpers;
+
+NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(MetricSeriesWrap);
+
+void MetricSeriesWrap::Init() {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    // Prepare constructor template.
+    auto functionTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<MetricSeriesWrap>);
+    functionTemplate->SetClassName(MakeV8String(isolate, exportName));
+    functionTemplate->InstanceTemplate()->SetInternalFieldCount(1);
+
+    // Prototypes.
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "set", Set);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "increment", Increment);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "decrement", Decrement);
+
+    // Set persistent constructor into V8.
+    NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, functionTemplate->GetFunction());
+}
+
+v8::Local<v8::Object> MetricSeriesWrap::NewInstance(
+    napa::providers::Metric* metric,
+    std::vector<std::string> dimensionValues) {
+
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    auto constructor = NAPA_GET_PERSISTENT_CONSTRUCTOR(exportName, MetricSeriesWrap);
+    auto object = constructor->NewInstance(context).ToLocalChecked();
+    auto wrap = NAPA_OBJECTWRAP::Unwrap<MetricSeriesWrap>(object);
+
+    wrap->_metric = metric;
+    wrap->_dimensionValues = std::move(dimensionValues);
+    wrap->_dimensions.reserve(wrap->_dimensionValues.size());
+    for (const auto& value : wrap->_dimensionValues) {
+        wrap->_dimensions.emplace_back(value.c_str());
+    }
+    return object;
+}
+
+void MetricSeriesWrap::Set(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    CHECK_ARG(isolate, args[0]->IsUint32(), "'value' argument must be a valid Uint32");
+
+    auto wrap = NAPA_OBJECTWRAP::Unwrap<MetricSeriesWrap>(args.Holder());
+    wrap->_metric->Set(args[0]->Uint32Value(), wrap->_dimensions.size(), wrap->_dimensions.data());
+}
+
+void MetricSeriesWrap::Increment(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto wrap = NAPA_OBJECTWRAP::Unwrap<MetricSeriesWrap>(args.Holder());
+    wrap->_metric->Increment(1, wrap->_dimensions.size(), wrap->_dimensions.data());
+}
+
+void MetricSeriesWrap::Decrement(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto wrap = NAPA_OBJECTWRAP::Unwrap<MetricSeriesWrap>(args.Holder());
+    wrap->_metric->Decrement(1, wrap->_dimensions.size(), wrap->_dimensions.data());
+}
@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/module.h>
+#include <napa/providers/metric.h>
+
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace module {
+
+    /// <summary> An object wrap to expose a metric with its dimension values bound, returned by MetricWrap.bind. </summary>
+    /// <remarks> Dimension values are converted once when bound, so updates pass them to the metric as they are. </remarks>
+    class MetricSeriesWrap : public NAPA_OBJECTWRAP {
+    public:
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "MetricSeriesWrap";
+
+        /// <summary> Initializes the wrap. </summary>
+        static void Init();
+
+        /// <summary> Create a new MetricSeriesWrap instance that binds the dimension values of a metric. </summary>
+        static v8::Local<v8::Object> NewInstance(
+            napa::providers::Metric* metric,
+            std::vector<std::string> dimensionValues);
+
+    private:
+
+        /// <summary> Declare persistent constructor to create MetricSeries Javascript wrapper instance. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
+        /// <summary> The underlying metric. </summary>
+        napa::providers::Metric* _metric = nullptr;
+
+        /// <summary> The bound dimension values, and the pointers to them passed to the metric. </summary>
+        std::vector<std::string> _dimensionValues;
+        std::vector<const char*> _dimensions;
+
+        // MetricSeriesWrap methods
+        static void Set(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void Increment(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void Decrement(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> Friend default constructor callback. </summary>
+        template <typename WrapType>
+        friend void napa::module::DefaultConstructorCallback(const v8::FunctionCallbackInfo<v8::Value>&);
+    };
+}
+}
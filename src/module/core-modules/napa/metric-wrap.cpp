@@ -2,6 +2,9 @@
 // Licensed under the MIT license.
 
 #include "metric-wrap.h"
+#include "metric-series-wrap.h"
+
+#include <providers/metric-buffer.h>
 
 using namespace napa::module;
 using namespace napa::v8_helpers;
@@ -20,6 +23,8 @@ void MetricWrap::Init() {
     NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "set", Set);
     NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "increment", Increment);
     NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "decrement", Decrement);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "bind", Bind);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "bufferSeries", BufferSeries);
 
     // Set persistent constructor into V8.
     NAPA_SET_PERSISTENT_CONSTRUCTOR(_exportName, functionTemplate->GetFunction());
@@ -88,6 +93,37 @@ void MetricWrap::Decrement(const v8::FunctionCallbackInfo<v8::Value>& args) {
     });
 }
 
+void MetricWrap::Bind(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    InvokeWithDimensions(args, 0, [&args](napa::providers::Metric* metric, std::vector<const char*>& dimensions) {
+        args.GetReturnValue().Set(MetricSeriesWrap::NewInstance(
+            metric,
+            std::vector<std::string>(dimensions.begin(), dimensions.end())));
+    });
+}
+
+void MetricWrap::BufferSeries(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    // Returns the index of the series in the metric buffer of the worker, or -1 if the series can't be buffered.
+    args.GetReturnValue().Set(-1);
+
+    auto buffer = napa::providers::MetricBuffer::GetCurrent();
+    if (buffer == nullptr) {
+        return;
+    }
+
+    InvokeWithDimensions(args, 0, [&args, buffer](napa::providers::Metric* metric, std::vector<const char*>& dimensions) {
+        uint32_t index;
+        if (metric != nullptr && buffer->AddSeries(metric, std::vector<std::string>(dimensions.begin(), dimensions.end()), index)) {
+            args.GetReturnValue().Set(index);
+        }
+    });
+}
+
 template <typename Func>
 void MetricWrap::InvokeWithDimensions(const v8::FunctionCallbackInfo<v8::Value>& args, uint32_t index, Func&& func) {
     auto isolate = v8::Isolate::GetCurrent();
@@ -49,6 +49,8 @@ namespace module {
         static void Set(const v8::FunctionCallbackInfo<v8::Value>& args);
         static void Increment(const v8::FunctionCallbackInfo<v8::Value>& args);
         static void Decrement(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void Bind(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void BufferSeries(const v8::FunctionCallbackInfo<v8::Value>& args);
 
         /// <summary>
         ///     Helper method that extracts the dimensions and metric from args and calls the func 
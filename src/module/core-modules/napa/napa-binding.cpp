@@ -4,16 +4,28 @@
 #include "napa-binding.h"
 
 #include "allocator-debugger-wrap.h"
+#include "arena-wrap.h"
 #include "allocator-wrap.h"
+#include "barrier-wrap.h"
 #include "call-context-wrap.h"
+#include "channel-wrap.h"
+#include "count-down-latch-wrap.h"
+#include "frozen-value-wrap.h"
+#include "hash.h"
 #include "lock-wrap.h"
+#include "metric-series-wrap.h"
 #include "metric-wrap.h"
+#include "read-write-lock-wrap.h"
+#include "semaphore-wrap.h"
+#include "shared-map-wrap.h"
 #include "shared-ptr-wrap.h"
+#include "store-view-wrap.h"
 #include "store-wrap.h"
 #include "timer-wrap.h"
 #include "transport-context-wrap-impl.h"
 #include "zone-wrap.h"
 
+#include <zone/call-context.h>
 #include <zone/worker-context.h>
 
 #include <napa/zone.h>
@@ -23,8 +35,18 @@
 #include <napa/providers/logging.h>
 #include <napa/providers/metric.h>
 
+#include <providers/metric-buffer.h>
 #include <v8-extensions/v8-extensions-macros.h>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <cmath>
+#include <string>
+#include <unordered_set>
+#include <vector>
 #if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+    #include <v8-extensions/serialized-data.h>
     #include <v8-extensions/v8-extensions.h>
 #endif
 
@@ -103,19 +125,117 @@ static void GetCurrentZone(const v8::FunctionCallbackInfo<v8::Value>& args) {
     args.GetReturnValue().Set(ZoneWrap::NewInstance(napa::Zone::GetCurrent()));
 }
 
+static void ConnectZone(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args[0]->IsString(), "first argument to connectZone must be the address");
+    CHECK_ARG(isolate, args[1]->IsUndefined() || args[1]->IsUint32(), "second argument to connectZone must be the number of connections");
+    v8::String::Utf8Value address(args[0]->ToString());
+    auto connections = args[1]->IsUndefined() ? 1u : args[1]->Uint32Value(context).FromJust();
+
+    try {
+        auto zoneProxy = napa::Zone::Connect(*address, connections);
+        args.GetReturnValue().Set(ZoneWrap::NewInstance(std::move(zoneProxy)));
+    } catch (const std::runtime_error& ex) {
+        JS_FAIL(isolate, ex.what());
+    }
+}
+
+static void ConnectZoneSharedMemory(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args[0]->IsString(), "first argument to connectZoneSharedMemory must be the name");
+    CHECK_ARG(isolate, args[1]->IsUndefined() || args[1]->IsUint32(), "second argument to connectZoneSharedMemory must be the number of connections");
+    v8::String::Utf8Value name(args[0]->ToString());
+    auto connections = args[1]->IsUndefined() ? 1u : args[1]->Uint32Value(context).FromJust();
+
+    try {
+        auto zoneProxy = napa::Zone::ConnectSharedMemory(*name, connections);
+        args.GetReturnValue().Set(ZoneWrap::NewInstance(std::move(zoneProxy)));
+    } catch (const std::runtime_error& ex) {
+        JS_FAIL(isolate, ex.what());
+    }
+}
+
+static void StopServingZoneSharedMemory(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    CHECK_ARG(isolate, args[0]->IsString(), "first argument to stopServingZoneSharedMemory must be the name");
+    v8::String::Utf8Value name(args[0]->ToString());
+    napa::Zone::StopServingSharedMemory(*name);
+}
+
+static void StopServingZone(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args[0]->IsUint32(), "first argument to stopServingZone must be the port");
+    napa::Zone::StopServing(static_cast<uint16_t>(args[0]->Uint32Value(context).FromJust()));
+}
+
 /////////////////////////////////////////////////////////////////////
 /// Store APIs
 
+/// <summary> Read store options from an optional JS object. </summary>
+static napa::store::StoreOptions ReadStoreOptions(v8::Local<v8::Value> value) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    napa::store::StoreOptions options;
+    if (value->IsObject()) {
+        auto object = v8::Local<v8::Object>::Cast(value);
+        auto shards = object->Get(context, napa::v8_helpers::MakeV8String(isolate, "shards"));
+        if (!shards.IsEmpty() && shards.ToLocalChecked()->IsNumber()) {
+            options.shards = shards.ToLocalChecked()->Uint32Value(context).FromJust();
+        }
+
+        auto frozen = object->Get(context, napa::v8_helpers::MakeV8String(isolate, "frozen"));
+        if (!frozen.IsEmpty() && frozen.ToLocalChecked()->IsBoolean()) {
+            options.frozen = frozen.ToLocalChecked()->BooleanValue(context).FromJust();
+        }
+
+        auto maxBytes = object->Get(context, napa::v8_helpers::MakeV8String(isolate, "maxBytes"));
+        if (!maxBytes.IsEmpty() && maxBytes.ToLocalChecked()->IsNumber()) {
+            options.maxBytes = static_cast<size_t>(maxBytes.ToLocalChecked()->IntegerValue(context).FromJust());
+        }
+
+        auto ordered = object->Get(context, napa::v8_helpers::MakeV8String(isolate, "ordered"));
+        if (!ordered.IsEmpty() && ordered.ToLocalChecked()->IsBoolean()) {
+            options.ordered = ordered.ToLocalChecked()->BooleanValue(context).FromJust();
+        }
+
+        auto compressionThreshold = object->Get(context, napa::v8_helpers::MakeV8String(isolate, "compressionThreshold"));
+        if (!compressionThreshold.IsEmpty() && compressionThreshold.ToLocalChecked()->IsNumber()) {
+            options.compressionThreshold = static_cast<size_t>(compressionThreshold.ToLocalChecked()->IntegerValue(context).FromJust());
+        }
+
+        auto intern = object->Get(context, napa::v8_helpers::MakeV8String(isolate, "intern"));
+        if (!intern.IsEmpty() && intern.ToLocalChecked()->IsBoolean()) {
+            options.intern = intern.ToLocalChecked()->BooleanValue(context).FromJust();
+        }
+    }
+    return options;
+}
+
 static void CreateStore(const v8::FunctionCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
 
-    CHECK_ARG(isolate, args.Length() == 1, "1 argument of 'id' is required.");
+    CHECK_ARG(isolate, args.Length() == 1 || args.Length() == 2, "1 argument of 'id' is required.");
     CHECK_ARG(isolate, args[0]->IsString(), "Argument 'id' must be string.");
+    CHECK_ARG(isolate, args.Length() == 1 || args[1]->IsObject() || args[1]->IsUndefined(), "Argument 'options' must be an object.");
 
     auto id = napa::v8_helpers::V8ValueTo<std::string>(args[0]);
-    auto store = napa::store::CreateStore(id.c_str());
+    auto store = napa::store::CreateStore(id.c_str(), ReadStoreOptions(args[1]));
 
+    JS_ENSURE(isolate,
+        store != nullptr || !napa::store::IsSharedStoreId(id.c_str()) || napa::store::GetStore(id.c_str()) != nullptr,
+        "Shared memory of store \"%s\" can't be mapped.",
+        id.c_str());
     JS_ENSURE(isolate, store != nullptr, "Store with id \"%s\" already exists.", id.c_str());
 
     args.GetReturnValue().Set(StoreWrap::NewInstance(store));
@@ -125,12 +245,14 @@ static void GetOrCreateStore(const v8::FunctionCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
 
-    CHECK_ARG(isolate, args.Length() == 1, "1 argument of 'id' is required.");
+    CHECK_ARG(isolate, args.Length() == 1 || args.Length() == 2, "1 argument of 'id' is required.");
     CHECK_ARG(isolate, args[0]->IsString(), "Argument 'id' must be string.");
+    CHECK_ARG(isolate, args.Length() == 1 || args[1]->IsObject() || args[1]->IsUndefined(), "Argument 'options' must be an object.");
 
     auto id = napa::v8_helpers::V8ValueTo<std::string>(args[0]);
-    auto store = napa::store::GetOrCreateStore(id.c_str());
+    auto store = napa::store::GetOrCreateStore(id.c_str(), ReadStoreOptions(args[1]));
 
+    JS_ENSURE(isolate, store != nullptr, "Shared memory of store \"%s\" can't be mapped.", id.c_str());
     args.GetReturnValue().Set(StoreWrap::NewInstance(store));
 }
 
@@ -149,8 +271,81 @@ static void GetStore(const v8::FunctionCallbackInfo<v8::Value>& args) {
     }
 }
 
-static void GetStoreCount(const v8::FunctionCallbackInfo<v8::Value>& args) {
-    args.GetReturnValue().Set(static_cast<uint32_t>(napa::store::GetStoreCount()));
+static void GetStoreValue(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 2, "2 arguments of 'id' and 'key' are required.");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'id' must be string.");
+    CHECK_ARG(isolate, args[1]->IsString(), "Argument 'key' must be string.");
+
+    // Unlike getStore, no wrap is created for the store, references are resolved once per call argument.
+    auto id = napa::v8_helpers::V8ValueTo<std::string>(args[0]);
+    auto store = napa::store::GetStore(id.c_str());
+    JS_ENSURE(isolate, store != nullptr, "Store \"%s\" doesn't exist.", id.c_str());
+
+    auto value = StoreWrap::GetValue(*store, napa::v8_helpers::V8ValueTo<std::string>(args[1]));
+    RETURN_ON_PENDING_EXCEPTION(value);
+
+    args.GetReturnValue().Set(value.ToLocalChecked());
+}
+
+static uint32_t GetStoreCount() {
+    return static_cast<uint32_t>(napa::store::GetStoreCount());
+}
+
+static void GetStoreStats(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    auto stores = napa::store::GetStores();
+    auto jsStores = v8::Array::New(isolate, static_cast<int>(stores.size()));
+    for (uint32_t i = 0; i < stores.size(); i++) {
+        auto statistics = stores[i]->GetStatistics();
+        auto jsStats = v8::Object::New(isolate);
+        auto setProperty = [&](const char* name, uint64_t value) {
+            (void)jsStats->CreateDataProperty(
+                context,
+                v8_helpers::MakeV8String(isolate, name),
+                v8::Number::New(isolate, static_cast<double>(value)));
+        };
+
+        (void)jsStats->CreateDataProperty(
+            context,
+            v8_helpers::MakeV8String(isolate, "id"),
+            v8_helpers::MakeV8String(isolate, stores[i]->GetId()));
+        setProperty("size", stores[i]->Size());
+        setProperty("byteSize", statistics.bytes);
+        setProperty("keyBytes", statistics.keyBytes);
+        setProperty("payloadBytes", statistics.payloadBytes);
+        setProperty("sharedObjects", statistics.sharedObjects);
+        setProperty("sharedObjectBytes", statistics.sharedObjectBytes);
+        setProperty("hits", statistics.hits);
+        setProperty("misses", statistics.misses);
+        setProperty("evictions", statistics.evictions);
+        setProperty("expirations", statistics.expirations);
+        setProperty("loads", statistics.loads);
+        setProperty("loadWaits", statistics.loadWaits);
+
+        (void)jsStores->Set(context, i, jsStats);
+    }
+
+    args.GetReturnValue().Set(jsStores);
+}
+
+static void CreateFrozenValue(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1 && args[0]->IsString(), "1 argument of 'json' is required.");
+
+    v8::String::Utf8Value json(args[0]);
+    auto value = napa::store::FrozenValue::FromJson(*json, static_cast<size_t>(json.length()));
+    JS_ENSURE(isolate, value != nullptr,
+        "Value can't be frozen, it's nested deeper than %u levels or takes over 4 GB.", napa::store::FrozenValue::MAX_DEPTH);
+
+    args.GetReturnValue().Set(FrozenValueWrap::NewInstance(std::move(value)));
 }
 
 /////////////////////////////////////////////////////////////////////
@@ -163,6 +358,53 @@ static void CreateLock(const v8::FunctionCallbackInfo<v8::Value>& args) {
     args.GetReturnValue().Set(LockWrap::NewInstance());
 }
 
+static void CreateChannel(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1 && args[0]->IsUint32() && args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust() > 0,
+        "Argument \"capacity\" shall be a positive integer.");
+
+    args.GetReturnValue().Set(ChannelWrap::NewInstance(args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust()));
+}
+
+static void CreateReadWriteLock(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    args.GetReturnValue().Set(ReadWriteLockWrap::NewInstance());
+}
+
+static void CreateSemaphore(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1 && args[0]->IsUint32(),
+        "Argument \"count\" shall be a non-negative integer.");
+
+    args.GetReturnValue().Set(SemaphoreWrap::NewInstance(args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust()));
+}
+
+static void CreateBarrier(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1 && args[0]->IsUint32() && args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust() > 0,
+        "Argument \"parties\" shall be a positive integer.");
+
+    args.GetReturnValue().Set(BarrierWrap::NewInstance(args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust()));
+}
+
+static void CreateCountDownLatch(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1 && args[0]->IsUint32(),
+        "Argument \"count\" shall be a non-negative integer.");
+
+    args.GetReturnValue().Set(CountDownLatchWrap::NewInstance(args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust()));
+}
+
 static void GetCrtAllocator(const v8::FunctionCallbackInfo<v8::Value>& args) {
     args.GetReturnValue().Set(binding::CreateAllocatorWrap(
         std::shared_ptr<napa::memory::Allocator>(
@@ -177,6 +419,241 @@ static void GetDefaultAllocator(const v8::FunctionCallbackInfo<v8::Value>& args)
             [](napa::memory::Allocator*){})));
 }
 
+static void GetPoolAllocator(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    args.GetReturnValue().Set(binding::CreateAllocatorWrap(
+        std::shared_ptr<napa::memory::Allocator>(
+            &napa::memory::GetPoolAllocator(),
+            [](napa::memory::Allocator*){})));
+}
+
+static void GetArrayBufferPoolStats(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    auto stats = napa::memory::GetArrayBufferPoolStats();
+    auto jsStats = v8::Object::New(isolate);
+    auto setProperty = [&](const char* name, uint64_t value) {
+        (void)jsStats->CreateDataProperty(
+            context,
+            v8_helpers::MakeV8String(isolate, name),
+            v8::Number::New(isolate, static_cast<double>(value)));
+    };
+
+    setProperty("allocations", stats.allocations);
+    setProperty("poolHits", stats.poolHits);
+    setProperty("mappedBlocks", stats.mappedBlocks);
+    setProperty("hugePageBlocks", stats.hugePageBlocks);
+    setProperty("liveBuffers", stats.liveBuffers);
+    setProperty("liveSize", stats.liveSize);
+    setProperty("pooledBlocks", stats.pooledBlocks);
+    setProperty("pooledSize", stats.pooledSize);
+
+    args.GetReturnValue().Set(jsStats);
+}
+
+static void AllocateSharedBuffer(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    #if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+
+    CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"allocateSharedBuffer\".");
+    CHECK_ARG(isolate, args[0]->IsUint32(), "Argument \"length\" shall be a non-negative integer.");
+    CHECK_ARG(isolate, args[1]->IsBoolean(), "Argument \"zeroed\" shall be a boolean.");
+
+    auto context = isolate->GetCurrentContext();
+    v8::Local<v8::SharedArrayBuffer> sharedArrayBuffer;
+    if (v8_extensions::Utils::NewPooledSharedArrayBuffer(
+        isolate,
+        args[0]->Uint32Value(context).FromJust(),
+        args[1].As<v8::Boolean>()->Value()).ToLocal(&sharedArrayBuffer)) {
+        args.GetReturnValue().Set(sharedArrayBuffer);
+    }
+
+    #else
+
+    isolate->ThrowException(v8::Exception::TypeError(napa::v8_helpers::MakeV8String(
+        isolate,
+        "It requires v8 newer than 6.2.x to pool SharedArrayBuffers. \
+        If run in node mode, please make sure the node version is v9.0.0 or above.")));
+
+    #endif
+}
+
+static void GetMallocLibraryStats(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    auto stats = napa::memory::GetMallocLibraryStats();
+    auto jsStats = v8::Object::New(isolate);
+    auto setProperty = [&](const char* name, uint64_t value) {
+        (void)jsStats->CreateDataProperty(
+            context,
+            v8_helpers::MakeV8String(isolate, name),
+            v8::Number::New(isolate, static_cast<double>(value)));
+    };
+
+    (void)jsStats->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "name"),
+        v8_helpers::MakeV8String(isolate, stats.name));
+    setProperty("allocatedSize", stats.allocatedSize);
+    setProperty("committedSize", stats.committedSize);
+    setProperty("residentSize", stats.residentSize);
+    setProperty("peakResidentSize", stats.peakResidentSize);
+
+    args.GetReturnValue().Set(jsStats);
+}
+
+static void CreateSharedMap(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    args.GetReturnValue().Set(SharedMapWrap::NewInstance());
+}
+
+static void MetricSnapshot(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args[0]->IsString(), "'format' must be 'json' or 'prometheus'");
+    auto format = napa::v8_helpers::V8ValueTo<std::string>(args[0]);
+    CHECK_ARG(isolate, format == "json" || format == "prometheus", "'format' must be 'json' or 'prometheus'");
+
+    std::string snapshot;
+    auto code = napa_metric_snapshot(
+        format == "json" ? METRIC_SNAPSHOT_JSON : METRIC_SNAPSHOT_PROMETHEUS,
+        [](napa_string_ref value, void* context) {
+            *static_cast<std::string*>(context) = NAPA_STRING_REF_TO_STD_STRING(value);
+        },
+        &snapshot);
+    JS_ENSURE(isolate, code == NAPA_RESULT_SUCCESS, "%s", napa_result_code_to_string(code));
+
+    args.GetReturnValue().Set(napa::v8_helpers::MakeV8String(isolate, snapshot));
+}
+
+static v8::Local<v8::Value> GetMetricSlots() {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto buffer = napa::providers::MetricBuffer::GetCurrent();
+    if (buffer == nullptr) {
+        return v8::Undefined(isolate);
+    }
+
+    // The slots are owned by the worker, which outlives its isolate.
+    return napa::v8_helpers::MakeExternalTypedArray(isolate, buffer->GetSlots(), buffer->GetSlotCount());
+}
+
+static void FlushMetrics() {
+    auto buffer = napa::providers::MetricBuffer::GetCurrent();
+    if (buffer != nullptr) {
+        buffer->Flush();
+    }
+}
+
+static void WriteModuleBundle(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args[0]->IsString(), "'path' must be a string");
+    auto path = napa::v8_helpers::V8ValueTo<std::string>(args[0]);
+
+    auto code = napa_module_bundle_write(STD_STRING_TO_NAPA_STRING_REF(path));
+    JS_ENSURE(isolate, code == NAPA_RESULT_SUCCESS, "%s", napa_result_code_to_string(code));
+}
+
+static void StartTrace(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    size_t eventsPerThread = 0;
+    if (args.Length() > 0 && !args[0]->IsUndefined()) {
+        CHECK_ARG(isolate, args[0]->IsUint32(), "'eventsPerThread' must be a positive integer");
+        eventsPerThread = args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust();
+    }
+
+    auto code = napa_trace_start(eventsPerThread);
+    JS_ENSURE(isolate, code == NAPA_RESULT_SUCCESS, "%s", napa_result_code_to_string(code));
+}
+
+static void StopTrace(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    std::string trace;
+    auto code = napa_trace_stop(
+        [](napa_string_ref value, void* context) {
+            *static_cast<std::string*>(context) = NAPA_STRING_REF_TO_STD_STRING(value);
+        },
+        &trace);
+    JS_ENSURE(isolate, code == NAPA_RESULT_SUCCESS, "%s", napa_result_code_to_string(code));
+
+    args.GetReturnValue().Set(napa::v8_helpers::MakeV8String(isolate, trace));
+}
+
+static void SetSpanSampling(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() > 0 && args[0]->IsNumber(), "'sampleRate' must be a number");
+    auto sampleRate = args[0]->NumberValue(context).FromJust();
+    CHECK_ARG(isolate, sampleRate >= 0 && sampleRate <= 1, "'sampleRate' must be between 0 and 1");
+
+    size_t capacity = 0;
+    if (args.Length() > 1 && !args[1]->IsUndefined()) {
+        CHECK_ARG(isolate, args[1]->IsUint32() && args[1]->Uint32Value(context).FromJust() > 0, "'capacity' must be a positive integer");
+        capacity = args[1]->Uint32Value(context).FromJust();
+    }
+
+    napa_spans_set_sampling(sampleRate, capacity);
+}
+
+static void ExportSpans(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    std::string spans;
+    napa_spans_export(
+        [](napa_string_ref value, void* context) {
+            *static_cast<std::string*>(context) = NAPA_STRING_REF_TO_STD_STRING(value);
+        },
+        &spans);
+
+    args.GetReturnValue().Set(napa::v8_helpers::MakeV8String(isolate, spans));
+}
+
+static void GetTraceContext(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    // Only zone calls running synchronously on this thread have a trace.
+    auto callContext = static_cast<napa::zone::CallContext*>(
+        napa::zone::WorkerContext::Get(napa::zone::WorkerContextItem::CALL_CONTEXT));
+    if (callContext == nullptr || callContext->GetTrace().traceId == 0) {
+        return;
+    }
+
+    const auto& trace = callContext->GetTrace();
+    auto jsTrace = v8::Object::New(isolate);
+    (void)jsTrace->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "traceId"),
+        v8_helpers::MakeV8String(isolate, napa::zone::SpanRecorder::FormatId(trace.traceId)));
+    (void)jsTrace->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "spanId"),
+        v8_helpers::MakeV8String(isolate, napa::zone::SpanRecorder::FormatId(trace.spanId)));
+    (void)jsTrace->CreateDataProperty(
+        context,
+        v8_helpers::MakeV8String(isolate, "sampled"),
+        v8::Boolean::New(isolate, trace.sampled));
+
+    args.GetReturnValue().Set(jsTrace);
+}
+
 static void Log(const v8::FunctionCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
@@ -186,6 +663,9 @@ static void Log(const v8::FunctionCallbackInfo<v8::Value>& args) {
     CHECK_ARG(isolate, args[1]->IsString() || args[1]->IsUndefined(), "'section' must be a valid string or undefined");
 
     auto level = static_cast<napa::providers::LoggingProvider::Verboseness>(args[0]->Uint32Value());
+    if (!napa::providers::IsLogLevelEnabled(level)) {
+        return;
+    }
 
     napa::v8_helpers::Utf8String sectionValue;
     const char* section = "";
@@ -211,6 +691,15 @@ static void Log(const v8::FunctionCallbackInfo<v8::Value>& args) {
         traceId = traceIdValue.Length() > 0 ? traceIdValue.Data() : "";
     }
 
+    // Logs written by a zone call without a trace id carry the trace of the call.
+    std::string callTraceId;
+    auto callContext = static_cast<napa::zone::CallContext*>(
+        napa::zone::WorkerContext::Get(napa::zone::WorkerContextItem::CALL_CONTEXT));
+    if (*traceId == '\0' && callContext != nullptr && callContext->GetTrace().traceId != 0) {
+        callTraceId = napa::zone::SpanRecorder::FormatId(callContext->GetTrace().traceId);
+        traceId = callTraceId.c_str();
+    }
+
     v8::String::Utf8Value message(args[3]->ToString());
 
     // Get the first frame in user code.
@@ -229,11 +718,13 @@ void SerializeValue(const v8::FunctionCallbackInfo<v8::Value>& args) {
 
     #if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
 
-    CHECK_ARG(isolate, args.Length() == 1, "1 argument is required for \"serializeValue\".");
+    CHECK_ARG(isolate, args.Length() == 1 || args.Length() == 2, "1 or 2 arguments are required for \"serializeValue\".");
+    CHECK_ARG(isolate, args.Length() == 1 || args[1]->IsArray() || args[1]->IsUndefined(), "Argument \"transferList\" shall be an array.");
 
-    auto serializedData = v8_extensions::Utils::SerializeValue(isolate, args[0]);
+    auto transferList = args.Length() == 2 && args[1]->IsArray() ? v8::Local<v8::Array>::Cast(args[1]) : v8::Local<v8::Array>();
+    auto serializedData = v8_extensions::Utils::SerializeValue(isolate, args[0], transferList);
     if (serializedData) {
-        args.GetReturnValue().Set(binding::CreateShareableWrap(serializedData));
+        args.GetReturnValue().Set(binding::CreateShareableWrap(serializedData, "SharedPtrWrap", serializedData->GetSize()));
     }
 
     #else
@@ -246,6 +737,18 @@ void SerializeValue(const v8::FunctionCallbackInfo<v8::Value>& args) {
     #endif
 }
 
+static void DetachArrayBuffers(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    #if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+
+    CHECK_ARG(isolate, args.Length() == 1 && args[0]->IsArray(), "1 argument of array is required for \"detachArrayBuffers\".");
+    v8_extensions::Utils::DetachArrayBuffers(isolate, v8::Local<v8::Array>::Cast(args[0]));
+
+    #endif
+}
+
 void DeserializeValue(const v8::FunctionCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
@@ -272,6 +775,394 @@ void DeserializeValue(const v8::FunctionCallbackInfo<v8::Value>& args) {
     #endif
 }
 
+static void SerializeValueToBytes(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    #if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+
+    CHECK_ARG(isolate, args.Length() == 2 || args.Length() == 3, "2 or 3 arguments are required for \"serializeValueToBytes\".");
+    CHECK_ARG(isolate, args[1]->IsObject(), "Argument \"transportContext\" shall be 'TransportContextWrap' type.");
+    CHECK_ARG(isolate, args.Length() == 2 || args[2]->IsArray() || args[2]->IsUndefined(), "Argument \"transferList\" shall be an array.");
+
+    auto transferList = args.Length() == 3 && args[2]->IsArray() ? v8::Local<v8::Array>::Cast(args[2]) : v8::Local<v8::Array>();
+    v8::Local<v8::ArrayBuffer> bytes;
+    if (v8_extensions::Utils::SerializeValueToBytes(isolate, args[0], transferList, v8::Local<v8::Object>::Cast(args[1])).ToLocal(&bytes)) {
+        args.GetReturnValue().Set(bytes);
+    }
+
+    #else
+
+    isolate->ThrowException(v8::Exception::TypeError(napa::v8_helpers::MakeV8String(
+        isolate,
+        "It requires v8 newer than 6.2.x to transport in binary. \
+        If run in node mode, please make sure the node version is v9.0.0 or above.")));
+
+    #endif
+}
+
+static void DeserializeValueFromBytes(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    #if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+
+    CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"deserializeValueFromBytes\".");
+    CHECK_ARG(isolate, args[0]->IsArrayBuffer(), "Argument \"bytes\" shall be an ArrayBuffer.");
+    CHECK_ARG(isolate, args[1]->IsObject(), "Argument \"transportContext\" shall be 'TransportContextWrap' type.");
+
+    auto contents = v8::Local<v8::ArrayBuffer>::Cast(args[0])->GetContents();
+    v8::Local<v8::Value> value;
+    if (v8_extensions::Utils::DeserializeValueFromBytes(
+        isolate,
+        static_cast<const uint8_t*>(contents.Data()),
+        contents.ByteLength(),
+        v8::Local<v8::Object>::Cast(args[1])).ToLocal(&value)) {
+        args.GetReturnValue().Set(value);
+    }
+
+    #else
+
+    isolate->ThrowException(v8::Exception::TypeError(napa::v8_helpers::MakeV8String(
+        isolate,
+        "It requires v8 newer than 6.2.x to transport in binary. \
+        If run in node mode, please make sure the node version is v9.0.0 or above.")));
+
+    #endif
+}
+
+/////////////////////////////////////////////////////////////////////
+/// Native JSON marshaller of transport.marshall
+
+namespace {
+
+    /// <summary>
+    ///     Writes a value as the JSON that JSON.stringify makes with transport.marshallTransform as replacer, walking the
+    ///     value graph natively so no JS callback runs per value. Only the marshall methods of transportables and
+    ///     toJSON methods are called into.
+    /// </summary>
+    class JsonMarshaller {
+    public:
+
+        /// <summary> Objects nested deeper are rejected with a RangeError, as the native stack is not checked. </summary>
+        static constexpr size_t MAX_DEPTH = 1024;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="isolate"> The isolate of the value. </param>
+        /// <param name="transportContext"> TransportContextWrap passed to the marshall methods, or null/undefined. </param>
+        /// <param name="transferList"> ArrayBuffers to move instead of copying, may be empty. </param>
+        JsonMarshaller(v8::Isolate* isolate, v8::Local<v8::Value> transportContext, v8::Local<v8::Array> transferList) :
+            _isolate(isolate),
+            _context(isolate->GetCurrentContext()),
+            _transportContext(transportContext),
+            _transferList(transferList),
+            _writer(_buffer) {}
+
+        /// <summary> Writes a value, nothing is written for values JSON.stringify returns undefined for. </summary>
+        /// <param name="value"> The value to write. </param>
+        /// <param name="written"> Receives whether the value was written. </param>
+        /// <returns> False if an exception was thrown. </returns>
+        bool Write(v8::Local<v8::Value> value, bool& written) {
+            written = false;
+            if (!Prepare(v8_helpers::MakeV8String(_isolate, ""), value)) {
+                return false;
+            }
+            if (!HasJsonValue(value)) {
+                return true;
+            }
+            written = true;
+            return WriteValue(value);
+        }
+
+        /// <summary> Returns the JSON written. </summary>
+        const rapidjson::StringBuffer& GetBuffer() const {
+            return _buffer;
+        }
+
+    private:
+
+        /// <summary> Applies toJSON and marshallTransform to a property value, as JSON.stringify does before writing it. </summary>
+        /// <param name="key"> The key of the property, or the index of the element. </param>
+        /// <param name="value"> The value of the property, receives the value to write. </param>
+        bool Prepare(v8::Local<v8::Value> key, v8::Local<v8::Value>& value) {
+            if (!value->IsObject() || value->IsFunction()) {
+                return true;
+            }
+            auto object = v8::Local<v8::Object>::Cast(value);
+
+            // Dates are transported as built-in objects, instead of the string of their toJSON.
+            if (object->IsDate()) {
+                return Transform(object, value);
+            }
+
+            v8::Local<v8::Value> toJson;
+            if (!object->Get(_context, v8_helpers::MakeV8String(_isolate, "toJSON")).ToLocal(&toJson)) {
+                return false;
+            }
+            if (toJson->IsFunction()) {
+                v8::Local<v8::String> name;
+                if (!key->ToString(_context).ToLocal(&name)) {
+                    return false;
+                }
+                v8::Local<v8::Value> argv[] = { name };
+                if (!v8::Local<v8::Function>::Cast(toJson)->Call(_context, object, 1, argv).ToLocal(&value)) {
+                    return false;
+                }
+            }
+
+            if (value->IsObject() && !value->IsArray() && !value->IsFunction()) {
+                return Transform(v8::Local<v8::Object>::Cast(value), value);
+            }
+            return true;
+        }
+
+        /// <summary> Returns false for undefined, functions and symbols, which objects skip and arrays write as null. </summary>
+        static bool HasJsonValue(v8::Local<v8::Value> value) {
+            return !value->IsUndefined() && !value->IsFunction() && !value->IsSymbol();
+        }
+
+        /// <summary> Replaces non plain objects by their transported form, see transport.marshallTransform. </summary>
+        bool Transform(v8::Local<v8::Object> object, v8::Local<v8::Value>& transformed) {
+            auto constructorName = v8_helpers::V8ValueTo<std::string>(object->GetConstructorName());
+            if (constructorName == "Object") {
+                return true;
+            }
+
+            v8::Local<v8::Value> cid;
+            if (!object->Get(_context, v8_helpers::MakeV8String(_isolate, "cid")).ToLocal(&cid)) {
+                return false;
+            }
+            if (cid->IsFunction()) {
+                if (_transportContext->IsNullOrUndefined()) {
+                    return ThrowError("Cannot transport type \"" + constructorName + "\" without a transport context.");
+                }
+
+                v8::Local<v8::Value> marshall;
+                if (!object->Get(_context, v8_helpers::MakeV8String(_isolate, "marshall")).ToLocal(&marshall)) {
+                    return false;
+                }
+                if (!marshall->IsFunction()) {
+                    return ThrowError("Object type \"" + constructorName + "\" has no marshall method.");
+                }
+
+                v8::Local<v8::Value> argv[] = { _transportContext };
+                return v8::Local<v8::Function>::Cast(marshall)->Call(_context, object, 1, argv).ToLocal(&transformed);
+            }
+
+            if (IsBuiltInType(constructorName)) {
+            #if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+                auto serializedData = v8_extensions::Utils::SerializeValue(_isolate, object, _transferList);
+                if (!serializedData) {
+                    return ThrowError("Failed to serialize object with type of \"" + constructorName + "\".");
+                }
+
+                // The wrap is a transportable, marshalled with the transport context when written.
+                auto payload = v8::Object::New(_isolate);
+                (void)payload->CreateDataProperty(
+                    _context,
+                    v8_helpers::MakeV8String(_isolate, "_serialized"),
+                    binding::CreateShareableWrap(serializedData, "SharedPtrWrap", serializedData->GetSize()));
+                transformed = payload;
+                return true;
+            #else
+                _isolate->ThrowException(v8::Exception::TypeError(napa::v8_helpers::MakeV8String(
+                    _isolate,
+                    "It requires v8 newer than 6.2.x to transport builtin types. \
+                    If run in node mode, please make sure the node version is v9.0.0 or above.")));
+                return false;
+            #endif
+            }
+
+            return ThrowError("Object type \"" + constructorName + "\" is not transportable.");
+        }
+
+        /// <summary> Writes a prepared value that has a JSON value, its properties are prepared as they are written. </summary>
+        bool WriteValue(v8::Local<v8::Value> value) {
+            if (value->IsNull()) {
+                _writer.Null();
+            } else if (value->IsBoolean()) {
+                _writer.Bool(value->IsTrue());
+            } else if (value->IsInt32()) {
+                _writer.Int(value->Int32Value(_context).FromJust());
+            } else if (value->IsNumber()) {
+                WriteNumber(value->NumberValue(_context).FromJust());
+            } else if (value->IsString()) {
+                v8::String::Utf8Value utf8(value);
+                _writer.String(*utf8, static_cast<rapidjson::SizeType>(utf8.length()));
+            } else if (value->IsArray()) {
+                return WriteArray(v8::Local<v8::Array>::Cast(value));
+            } else if (value->IsObject()) {
+                return WriteObject(v8::Local<v8::Object>::Cast(value));
+            } else {
+                // Only BigInts are left.
+                _isolate->ThrowException(v8::Exception::TypeError(
+                    v8_helpers::MakeV8String(_isolate, "Do not know how to serialize a BigInt")));
+                return false;
+            }
+            return true;
+        }
+
+        /// <summary> Writes numbers the way JSON.stringify does, integers without fraction and non finite ones as null. </summary>
+        void WriteNumber(double value) {
+            constexpr double MAX_SAFE_INTEGER = 9007199254740991.0;
+            if (!std::isfinite(value)) {
+                _writer.Null();
+            } else if (value == std::trunc(value) && std::fabs(value) <= MAX_SAFE_INTEGER) {
+                // Covers -0, which JSON.stringify writes as 0.
+                _writer.Int64(static_cast<int64_t>(value));
+            } else {
+                _writer.Double(value);
+            }
+        }
+
+        bool WriteArray(v8::Local<v8::Array> array) {
+            v8::HandleScope scope(_isolate);
+            if (!Enter(array)) {
+                return false;
+            }
+
+            _writer.StartArray();
+            auto length = array->Length();
+            for (uint32_t i = 0; i < length; ++i) {
+                v8::Local<v8::Value> element;
+                if (!array->Get(_context, i).ToLocal(&element)) {
+                    return false;
+                }
+
+                if (!Prepare(v8::Integer::NewFromUnsigned(_isolate, i), element)) {
+                    return false;
+                }
+                if (!HasJsonValue(element)) {
+                    _writer.Null();
+                } else if (!WriteValue(element)) {
+                    return false;
+                }
+            }
+            _writer.EndArray();
+
+            _stack.pop_back();
+            return true;
+        }
+
+        bool WriteObject(v8::Local<v8::Object> object) {
+            v8::HandleScope scope(_isolate);
+            if (!Enter(object)) {
+                return false;
+            }
+
+            // Own enumerable string keys in the order JSON.stringify visits them.
+            v8::Local<v8::Array> keys;
+            if (!object->GetOwnPropertyNames(_context).ToLocal(&keys)) {
+                return false;
+            }
+
+            _writer.StartObject();
+            auto length = keys->Length();
+            for (uint32_t i = 0; i < length; ++i) {
+                v8::Local<v8::Value> key;
+                v8::Local<v8::Value> property;
+                if (!keys->Get(_context, i).ToLocal(&key) || !object->Get(_context, key).ToLocal(&property)) {
+                    return false;
+                }
+
+                v8::Local<v8::String> name;
+                if (!key->ToString(_context).ToLocal(&name)) {
+                    return false;
+                }
+
+                if (!Prepare(name, property)) {
+                    return false;
+                }
+                if (!HasJsonValue(property)) {
+                    continue;
+                }
+
+                v8::String::Utf8Value utf8(name);
+                _writer.Key(*utf8, static_cast<rapidjson::SizeType>(utf8.length()));
+                if (!WriteValue(property)) {
+                    return false;
+                }
+            }
+            _writer.EndObject();
+
+            _stack.pop_back();
+            return true;
+        }
+
+        /// <summary> Pushes an object on the stack of objects being written, rejecting cycles like JSON.stringify. </summary>
+        bool Enter(v8::Local<v8::Object> object) {
+            for (const auto& parent : _stack) {
+                if (parent->StrictEquals(object)) {
+                    _isolate->ThrowException(v8::Exception::TypeError(
+                        v8_helpers::MakeV8String(_isolate, "Converting circular structure to JSON")));
+                    return false;
+                }
+            }
+            if (_stack.size() >= MAX_DEPTH) {
+                _isolate->ThrowException(v8::Exception::RangeError(
+                    v8_helpers::MakeV8String(_isolate, "Object is nested too deeply to transport.")));
+                return false;
+            }
+            _stack.push_back(object);
+            return true;
+        }
+
+        bool ThrowError(const std::string& message) {
+            _isolate->ThrowException(v8::Exception::Error(v8_helpers::MakeV8String(_isolate, message)));
+            return false;
+        }
+
+        static bool IsBuiltInType(const std::string& constructorName) {
+            static const std::unordered_set<std::string> builtInTypeWhitelist = {
+                "ArrayBuffer",
+                "Date",
+                "Float32Array",
+                "Float64Array",
+                "Int16Array",
+                "Int32Array",
+                "Int8Array",
+                "Map",
+                "RegExp",
+                "Set",
+                "SharedArrayBuffer",
+                "Uint16Array",
+                "Uint32Array",
+                "Uint8Array"
+            };
+            return builtInTypeWhitelist.count(constructorName) != 0;
+        }
+
+        v8::Isolate* _isolate;
+        v8::Local<v8::Context> _context;
+        v8::Local<v8::Value> _transportContext;
+        v8::Local<v8::Array> _transferList;
+
+        /// <summary> The objects being written, from the root. </summary>
+        std::vector<v8::Local<v8::Object>> _stack;
+
+        rapidjson::StringBuffer _buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> _writer;
+    };
+}
+
+static void Marshall(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() >= 1 && args.Length() <= 3, "1 to 3 arguments are required for \"marshall\".");
+    CHECK_ARG(isolate, args.Length() < 3 || args[2]->IsArray() || args[2]->IsUndefined(), "Argument \"transferList\" shall be an array.");
+
+    auto transportContext = args.Length() >= 2 ? args[1] : v8::Local<v8::Value>(v8::Undefined(isolate));
+    auto transferList = args.Length() == 3 && args[2]->IsArray() ? v8::Local<v8::Array>::Cast(args[2]) : v8::Local<v8::Array>();
+
+    JsonMarshaller marshaller(isolate, transportContext, transferList);
+    bool written = false;
+    if (marshaller.Write(args[0], written) && written) {
+        const auto& buffer = marshaller.GetBuffer();
+        args.GetReturnValue().Set(v8_helpers::MakeV8String(isolate, buffer.GetString(), static_cast<int>(buffer.GetSize())));
+    }
+}
+
 /////////////////////////////////////////////////////////////////////
 /// Timers APIs, these APIs only valid in non-node isolation, i.e., 
 /// they are not needed when building the napa_binding.node
@@ -303,40 +1194,94 @@ void binding::Init(v8::Local<v8::Object> exports, v8::Local<v8::Object> module)
 
     AllocatorDebuggerWrap::Init();
     AllocatorWrap::Init();
+    ArenaWrap::Init();
+    BarrierWrap::Init();
     CallContextWrap::Init();
+    ChannelWrap::Init();
+    CountDownLatchWrap::Init();
+    FrozenValueWrap::Init();
     LockWrap::Init();
+    MetricSeriesWrap::Init();
     MetricWrap::Init();
+    ReadWriteLockWrap::Init();
+    SemaphoreWrap::Init();
+    SharedMapWrap::Init();
     SharedPtrWrap::Init();
+    StoreViewWrap::Init();
     StoreWrap::Init();
     TransportContextWrapImpl::Init();
     ZoneWrap::Init();
 
     NAPA_EXPORT_OBJECTWRAP(exports, "AllocatorDebuggerWrap", AllocatorDebuggerWrap);
     NAPA_EXPORT_OBJECTWRAP(exports, "AllocatorWrap", AllocatorWrap);
+    NAPA_EXPORT_OBJECTWRAP(exports, "ArenaWrap", ArenaWrap);
+    NAPA_EXPORT_OBJECTWRAP(exports, "BarrierWrap", BarrierWrap);
     NAPA_EXPORT_OBJECTWRAP(exports, "CallContextWrap", CallContextWrap);
+    NAPA_EXPORT_OBJECTWRAP(exports, "ChannelWrap", ChannelWrap);
+    NAPA_EXPORT_OBJECTWRAP(exports, "CountDownLatchWrap", CountDownLatchWrap);
+    NAPA_EXPORT_OBJECTWRAP(exports, "FrozenValueWrap", FrozenValueWrap);
     NAPA_EXPORT_OBJECTWRAP(exports, "LockWrap", LockWrap);
     NAPA_EXPORT_OBJECTWRAP(exports, "MetricWrap", MetricWrap);
+    NAPA_EXPORT_OBJECTWRAP(exports, "ReadWriteLockWrap", ReadWriteLockWrap);
+    NAPA_EXPORT_OBJECTWRAP(exports, "SemaphoreWrap", SemaphoreWrap);
+    NAPA_EXPORT_OBJECTWRAP(exports, "SharedMapWrap", SharedMapWrap);
     NAPA_EXPORT_OBJECTWRAP(exports, "SharedPtrWrap", SharedPtrWrap);
+    NAPA_EXPORT_OBJECTWRAP(exports, "StoreWrap", StoreWrap);
     NAPA_EXPORT_OBJECTWRAP(exports, "TransportContextWrap", TransportContextWrapImpl);
 
     NAPA_SET_METHOD(exports, "createZone", CreateZone);
     NAPA_SET_METHOD(exports, "getZone", GetZone);
     NAPA_SET_METHOD(exports, "getCurrentZone", GetCurrentZone);
+    NAPA_SET_METHOD(exports, "connectZone", ConnectZone);
+    NAPA_SET_METHOD(exports, "stopServingZone", StopServingZone);
+    NAPA_SET_METHOD(exports, "connectZoneSharedMemory", ConnectZoneSharedMemory);
+    NAPA_SET_METHOD(exports, "stopServingZoneSharedMemory", StopServingZoneSharedMemory);
 
     NAPA_SET_METHOD(exports, "createStore", CreateStore);
     NAPA_SET_METHOD(exports, "getOrCreateStore", GetOrCreateStore);
     NAPA_SET_METHOD(exports, "getStore", GetStore);
-    NAPA_SET_METHOD(exports, "getStoreCount", GetStoreCount);
+    NAPA_SET_METHOD(exports, "getStoreValue", GetStoreValue);
+    NAPA_EXPORT_FUNCTION(exports, "getStoreCount", GetStoreCount);
+    NAPA_SET_METHOD(exports, "getStoreStats", GetStoreStats);
+    NAPA_SET_METHOD(exports, "createFrozenValue", CreateFrozenValue);
 
     NAPA_SET_METHOD(exports, "createLock", CreateLock);
+    NAPA_SET_METHOD(exports, "createReadWriteLock", CreateReadWriteLock);
+    NAPA_SET_METHOD(exports, "createChannel", CreateChannel);
+    NAPA_SET_METHOD(exports, "createSemaphore", CreateSemaphore);
+    NAPA_SET_METHOD(exports, "createBarrier", CreateBarrier);
+    NAPA_SET_METHOD(exports, "createCountDownLatch", CreateCountDownLatch);
     
     NAPA_SET_METHOD(exports, "getCrtAllocator", GetCrtAllocator);
     NAPA_SET_METHOD(exports, "getDefaultAllocator", GetDefaultAllocator);
+    NAPA_SET_METHOD(exports, "getPoolAllocator", GetPoolAllocator);
+    NAPA_SET_METHOD(exports, "getArrayBufferPoolStats", GetArrayBufferPoolStats);
+    NAPA_SET_METHOD(exports, "allocateSharedBuffer", AllocateSharedBuffer);
+    NAPA_SET_METHOD(exports, "getMallocLibraryStats", GetMallocLibraryStats);
+    NAPA_SET_METHOD(exports, "createSharedMap", CreateSharedMap);
 
     NAPA_SET_METHOD(exports, "log", Log);
+    NAPA_SET_METHOD(exports, "metricSnapshot", MetricSnapshot);
+    NAPA_EXPORT_FUNCTION(exports, "getMetricSlots", GetMetricSlots);
+    NAPA_EXPORT_FUNCTION(exports, "flushMetrics", FlushMetrics);
+    NAPA_SET_METHOD(exports, "writeModuleBundle", WriteModuleBundle);
+    NAPA_SET_METHOD(exports, "startTrace", StartTrace);
+    NAPA_SET_METHOD(exports, "stopTrace", StopTrace);
+    NAPA_SET_METHOD(exports, "setSpanSampling", SetSpanSampling);
+    NAPA_SET_METHOD(exports, "exportSpans", ExportSpans);
+    NAPA_SET_METHOD(exports, "getTraceContext", GetTraceContext);
 
     NAPA_SET_METHOD(exports, "serializeValue", SerializeValue);
     NAPA_SET_METHOD(exports, "deserializeValue", DeserializeValue);
+    NAPA_SET_METHOD(exports, "detachArrayBuffers", DetachArrayBuffers);
+    NAPA_SET_METHOD(exports, "serializeValueToBytes", SerializeValueToBytes);
+    NAPA_SET_METHOD(exports, "deserializeValueFromBytes", DeserializeValueFromBytes);
+    NAPA_SET_METHOD(exports, "marshall", Marshall);
+
+    auto isolate = v8::Isolate::GetCurrent();
+    auto hashExports = v8::Object::New(isolate);
+    hash::Init(hashExports);
+    (void)exports->CreateDataProperty(isolate->GetCurrentContext(), v8_helpers::MakeV8String(isolate, "hash"), hashExports);
 
     InitNapaOnlyBindings(exports);
 }
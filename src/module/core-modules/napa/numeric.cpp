@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "numeric.h"
+
+#include <napa/module.h>
+#include <utils/numeric-kernels.h>
+
+#include <cstdint>
+#include <limits>
+
+using namespace napa;
+using namespace napa::module;
+using namespace napa::utils::numeric;
+
+namespace {
+
+    /// <summary> The elements of a Float32Array or Float64Array argument, narrowed to a range. </summary>
+    struct ArrayArgument {
+        bool isDouble = false;
+        uint8_t* data = nullptr;
+        size_t length = 0;
+
+        template <typename T>
+        T* Get() const {
+            return reinterpret_cast<T*>(data);
+        }
+    };
+
+    /// <summary> Get the elements of a typed array argument, which may be on a SharedArrayBuffer. </summary>
+    /// <returns> False with an exception thrown if the argument is not a Float32Array or a Float64Array. </returns>
+    bool GetArray(v8::Local<v8::Value> value, const char* name, ArrayArgument& array) {
+        auto isolate = v8::Isolate::GetCurrent();
+        JS_ENSURE_WITH_RETURN(isolate, value->IsFloat32Array() || value->IsFloat64Array(), false,
+            "Argument \"%s\" shall be a Float32Array or a Float64Array.", name);
+
+        auto view = v8::Local<v8::TypedArray>::Cast(value);
+        v8::Local<v8::Value> buffer = view->Buffer();
+        void* contents = buffer->IsSharedArrayBuffer()
+            ? v8::Local<v8::SharedArrayBuffer>::Cast(buffer)->GetContents().Data()
+            : v8::Local<v8::ArrayBuffer>::Cast(buffer)->GetContents().Data();
+
+        array.isDouble = value->IsFloat64Array();
+        array.data = static_cast<uint8_t*>(contents) + view->ByteOffset();
+        array.length = view->Length();
+        return true;
+    }
+
+    /// <summary> Narrow arrays to the optional [begin, end) range of arguments, like the range of zone.parallelFor. </summary>
+    /// <returns> False with an exception thrown if the range is not within the arrays. </returns>
+    bool GetRange(const v8::FunctionCallbackInfo<v8::Value>& args, int index, ArrayArgument* arrays, size_t count) {
+        auto isolate = v8::Isolate::GetCurrent();
+        auto context = isolate->GetCurrentContext();
+
+        // Without a range, arrays must be of a length.
+        size_t length = arrays[0].length;
+        for (size_t i = 1; i < count; i++) {
+            JS_ENSURE_WITH_RETURN(isolate, args.Length() > index || arrays[i].length == length, false,
+                "Arrays shall be of the same length.");
+            JS_ENSURE_WITH_RETURN(isolate, arrays[i].isDouble == arrays[0].isDouble, false,
+                "Arrays shall be of the same type.");
+            length = arrays[i].length < length ? arrays[i].length : length;
+        }
+
+        size_t begin = 0;
+        size_t end = length;
+        if (args.Length() > index && !args[index]->IsUndefined()) {
+            JS_ENSURE_WITH_RETURN(isolate, args[index]->IsUint32(), false, "Argument \"begin\" shall be an index.");
+            begin = args[index]->Uint32Value(context).FromJust();
+        }
+        if (args.Length() > index + 1 && !args[index + 1]->IsUndefined()) {
+            JS_ENSURE_WITH_RETURN(isolate, args[index + 1]->IsUint32(), false, "Argument \"end\" shall be an index.");
+            end = args[index + 1]->Uint32Value(context).FromJust();
+        }
+        JS_ENSURE_WITH_RETURN(isolate, begin <= end && end <= length, false,
+            "Range [%zu, %zu) is not within arrays of length %zu.", begin, end, length);
+
+        auto elementSize = arrays[0].isDouble ? sizeof(double) : sizeof(float);
+        for (size_t i = 0; i < count; i++) {
+            arrays[i].data += begin * elementSize;
+            arrays[i].length = end - begin;
+        }
+        return true;
+    }
+
+    /// <summary> Get a number argument. </summary>
+    /// <returns> False with an exception thrown if the argument is not a number. </returns>
+    bool GetNumber(const v8::FunctionCallbackInfo<v8::Value>& args, int index, const char* name, double& number) {
+        auto isolate = v8::Isolate::GetCurrent();
+        JS_ENSURE_WITH_RETURN(isolate, args.Length() > index && args[index]->IsNumber(), false,
+            "Argument \"%s\" shall be a number.", name);
+        number = args[index]->NumberValue(isolate->GetCurrentContext()).FromJust();
+        return true;
+    }
+
+    /// <summary> It implements numeric.sum(array: Float32Array | Float64Array, begin?: number, end?: number): number </summary>
+    void SumCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        ArrayArgument array;
+        if (!GetArray(args[0], "array", array) || !GetRange(args, 1, &array, 1)) {
+            return;
+        }
+        args.GetReturnValue().Set(array.isDouble
+            ? GetDoubleKernels().sum(array.Get<double>(), array.length)
+            : static_cast<double>(GetFloatKernels().sum(array.Get<float>(), array.length)));
+    }
+
+    /// <summary> It implements numeric.dot(left: Float32Array | Float64Array, right: Float32Array | Float64Array, begin?: number, end?: number): number </summary>
+    void DotCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        ArrayArgument arrays[2];
+        if (!GetArray(args[0], "left", arrays[0]) || !GetArray(args[1], "right", arrays[1]) || !GetRange(args, 2, arrays, 2)) {
+            return;
+        }
+        args.GetReturnValue().Set(arrays[0].isDouble
+            ? GetDoubleKernels().dot(arrays[0].Get<double>(), arrays[1].Get<double>(), arrays[0].length)
+            : static_cast<double>(GetFloatKernels().dot(arrays[0].Get<float>(), arrays[1].Get<float>(), arrays[0].length)));
+    }
+
+    /// <summary> It implements numeric.min and numeric.max, which are Infinity and -Infinity for no element as Math.min and Math.max. </summary>
+    template <bool smallest>
+    void ExtremeCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        ArrayArgument array;
+        if (!GetArray(args[0], "array", array) || !GetRange(args, 1, &array, 1)) {
+            return;
+        }
+        if (array.length == 0) {
+            auto infinity = std::numeric_limits<double>::infinity();
+            args.GetReturnValue().Set(smallest ? infinity : -infinity);
+            return;
+        }
+        if (array.isDouble) {
+            auto& kernels = GetDoubleKernels();
+            args.GetReturnValue().Set((smallest ? kernels.minimum : kernels.maximum)(array.Get<double>(), array.length));
+        } else {
+            auto& kernels = GetFloatKernels();
+            args.GetReturnValue().Set(static_cast<double>(
+                (smallest ? kernels.minimum : kernels.maximum)(array.Get<float>(), array.length)));
+        }
+    }
+
+    /// <summary> It implements numeric.scale(array: Float32Array | Float64Array, factor: number, begin?: number, end?: number): void </summary>
+    void ScaleCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        ArrayArgument array;
+        double factor = 0;
+        if (!GetArray(args[0], "array", array) || !GetNumber(args, 1, "factor", factor) || !GetRange(args, 2, &array, 1)) {
+            return;
+        }
+        if (array.isDouble) {
+            GetDoubleKernels().scale(array.Get<double>(), array.length, factor);
+        } else {
+            GetFloatKernels().scale(array.Get<float>(), array.length, static_cast<float>(factor));
+        }
+    }
+
+    /// <summary> It implements numeric.axpy(alpha: number, x: Float32Array | Float64Array, y: Float32Array | Float64Array, begin?: number, end?: number): void </summary>
+    void AxpyCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        double alpha = 0;
+        ArrayArgument arrays[2];
+        if (!GetNumber(args, 0, "alpha", alpha)
+            || !GetArray(args[1], "x", arrays[0])
+            || !GetArray(args[2], "y", arrays[1])
+            || !GetRange(args, 3, arrays, 2)) {
+            return;
+        }
+        if (arrays[0].isDouble) {
+            GetDoubleKernels().axpy(alpha, arrays[0].Get<double>(), arrays[1].Get<double>(), arrays[0].length);
+        } else {
+            GetFloatKernels().axpy(static_cast<float>(alpha), arrays[0].Get<float>(), arrays[1].Get<float>(), arrays[0].length);
+        }
+    }
+}
+
+void numeric::Init(v8::Local<v8::Object> exports) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    NAPA_SET_METHOD(exports, "sum", SumCallback);
+    NAPA_SET_METHOD(exports, "dot", DotCallback);
+    NAPA_SET_METHOD(exports, "min", ExtremeCallback<true>);
+    NAPA_SET_METHOD(exports, "max", ExtremeCallback<false>);
+    NAPA_SET_METHOD(exports, "scale", ScaleCallback);
+    NAPA_SET_METHOD(exports, "axpy", AxpyCallback);
+
+    (void)exports->CreateDataProperty(
+        isolate->GetCurrentContext(),
+        v8_helpers::MakeV8String(isolate, "instructionSet"),
+        v8_helpers::MakeV8String(isolate, GetInstructionSetName(GetBestInstructionSet())));
+}
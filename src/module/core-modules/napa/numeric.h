@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <v8.h>
+
+namespace napa {
+namespace module {
+
+/// <summary> Napa core module 'napa-numeric' of vectorized kernels over Float32Array and Float64Array. </summary>
+namespace numeric {
+
+    /// <summary> Set numeric object. </summary>
+    /// <param name="exports"> Object to set module. </param>
+    void Init(v8::Local<v8::Object> exports);
+
+}   // End of namespace numeric
+}   // End of namespace module
+}   // End of namespace napa
@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "read-write-lock-wrap.h"
+#include "sync-helpers.h"
+
+#include <napa/module/binding/wraps.h>
+
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+using namespace napa;
+using namespace napa::module;
+
+NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(napa::module::ReadWriteLockWrap);
+
+namespace {
+
+    /// <summary> Runs a guard method with the lock obtained, or throws in JS if it's not obtained in time. </summary>
+    /// <param name="args"> Guard method arguments: func, params and timeoutInMs. </param>
+    /// <param name="methodName"> Guard method name used in error messages. </param>
+    template <typename LockType>
+    void GuardSync(const v8::FunctionCallbackInfo<v8::Value>& args, const char* methodName) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+
+        bool hasTimeout = false;
+        std::chrono::milliseconds timeout;
+        if (!sync_helpers::CheckGuardArguments(args, methodName)
+            || !sync_helpers::GetTimeoutArgument(args, 2, hasTimeout, timeout)) {
+            return;
+        }
+
+        auto thisObject = NAPA_OBJECTWRAP::Unwrap<ReadWriteLockWrap>(args.Holder());
+
+        try {
+            auto mutex = thisObject->Get<std::shared_timed_mutex>();
+            LockType guard(*mutex, std::defer_lock);
+            if (!hasTimeout) {
+                guard.lock();
+            } else {
+                JS_ENSURE(isolate, guard.try_lock_for(timeout),
+                    "Lock is not obtained in %d milliseconds.", static_cast<int>(timeout.count()));
+            }
+            sync_helpers::CallGuardedFunction(args);
+        } catch (const std::system_error& ex) {
+            isolate->ThrowException(v8::Exception::Error(v8_helpers::MakeV8String(isolate, ex.what())));
+        }
+    }
+}
+
+void ReadWriteLockWrap::Init() {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto constructorTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<ReadWriteLockWrap>);
+    constructorTemplate->SetClassName(v8_helpers::MakeV8String(isolate, exportName));
+    constructorTemplate->InstanceTemplate()->SetInternalFieldCount(1);
+
+    InitConstructorTemplate<ReadWriteLockWrap>(constructorTemplate);
+
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "guardReadSync", GuardReadSyncCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "guardWriteSync", GuardWriteSyncCallback);
+
+    auto constructor = constructorTemplate->GetFunction();
+    InitConstructor("<ReadWriteLockWrap>", constructor);
+    NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructor);
+}
+
+v8::Local<v8::Object> ReadWriteLockWrap::NewInstance() {
+    return binding::CreateShareableWrap(std::make_shared<std::shared_timed_mutex>(), exportName);
+}
+
+void ReadWriteLockWrap::GuardReadSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    GuardSync<std::shared_lock<std::shared_timed_mutex>>(args, "guardReadSync");
+}
+
+void ReadWriteLockWrap::GuardWriteSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    GuardSync<std::unique_lock<std::shared_timed_mutex>>(args, "guardWriteSync");
+}
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/module.h>
+#include <napa/module/shareable-wrap.h>
+
+namespace napa {
+namespace module {
+
+    /// <summary> An object wrap to expose read-write lock APIs. </summary>
+    class ReadWriteLockWrap : public ShareableWrap {
+    public:
+
+        /// <summary> Initializes the wrap. </summary>
+        static void Init();
+
+        /// <summary> Creates a new instance of ReadWriteLockWrap. </summary>
+        static v8::Local<v8::Object> NewInstance();
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "ReadWriteLockWrap";
+
+        /// <summary> Declare persistent constructor to create ReadWriteLock Javascript wrapper instance. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
+    private:
+
+        // ReadWriteLockWrap methods
+        static void GuardReadSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void GuardWriteSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+    };
+}
+}
@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "semaphore-wrap.h"
+#include "sync-helpers.h"
+
+#include <zone/semaphore.h>
+
+#include <napa/async.h>
+#include <napa/module/binding/wraps.h>
+
+#include <memory>
+
+using namespace napa::module;
+using napa::zone::Semaphore;
+
+NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(napa::module::SemaphoreWrap);
+
+void SemaphoreWrap::Init() {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto constructorTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<SemaphoreWrap>);
+    constructorTemplate->SetClassName(v8_helpers::MakeV8String(isolate, exportName));
+    constructorTemplate->InstanceTemplate()->SetInternalFieldCount(1);
+
+    InitConstructorTemplate<SemaphoreWrap>(constructorTemplate);
+
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "acquire", AcquireCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "acquireSync", AcquireSyncCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "tryAcquire", TryAcquireCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "release", ReleaseCallback);
+    NAPA_SET_ACCESSOR(constructorTemplate, "count", GetCountCallback, nullptr);
+
+    auto constructor = constructorTemplate->GetFunction();
+    InitConstructor("<SemaphoreWrap>", constructor);
+    NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructor);
+}
+
+v8::Local<v8::Object> SemaphoreWrap::NewInstance(uint32_t count) {
+    return binding::CreateShareableWrap(std::make_shared<Semaphore>(count), exportName);
+}
+
+void SemaphoreWrap::AcquireCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    v8::Local<v8::Promise::Resolver> resolver;
+    if (!v8::Promise::Resolver::New(context).ToLocal(&resolver)) {
+        return;
+    }
+    args.GetReturnValue().Set(resolver->GetPromise());
+    auto settle = sync_helpers::MakeSettleFunction(context, resolver);
+
+    auto semaphore = NAPA_OBJECTWRAP::Unwrap<SemaphoreWrap>(args.Holder())->Get<Semaphore>();
+    if (semaphore->TryAcquire()) {
+        sync_helpers::Settle(settle, true, v8::Undefined(isolate));
+        return;
+    }
+
+    // No permit is available, the worker serves other tasks until the releasing thread schedules it back.
+    napa::zone::DoAsyncWork(settle,
+        [semaphore](std::function<void(void*)> complete) {
+            semaphore->AcquireAsync([complete]() {
+                complete(nullptr);
+            });
+        },
+        [](v8::Local<v8::Function> settle, void*) {
+            sync_helpers::Settle(settle, true, v8::Undefined(v8::Isolate::GetCurrent()));
+        });
+}
+
+void SemaphoreWrap::AcquireSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    bool hasTimeout = false;
+    std::chrono::milliseconds timeout(0);
+    if (!sync_helpers::GetTimeoutArgument(args, 0, hasTimeout, timeout)) {
+        return;
+    }
+
+    auto semaphore = NAPA_OBJECTWRAP::Unwrap<SemaphoreWrap>(args.Holder())->Get<Semaphore>();
+    if (!hasTimeout) {
+        semaphore->Acquire();
+    } else {
+        JS_ENSURE(isolate, semaphore->TryAcquireFor(timeout),
+            "Semaphore permit is not acquired in %d milliseconds.", static_cast<int>(timeout.count()));
+    }
+}
+
+void SemaphoreWrap::TryAcquireCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto semaphore = NAPA_OBJECTWRAP::Unwrap<SemaphoreWrap>(args.Holder())->Get<Semaphore>();
+    args.GetReturnValue().Set(semaphore->TryAcquire());
+}
+
+void SemaphoreWrap::ReleaseCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 0 || args[0]->IsUndefined() || args[0]->IsUint32(),
+        "Argument \"count\" shall be a non-negative integer.");
+
+    uint32_t count = 1;
+    if (args.Length() > 0 && args[0]->IsUint32()) {
+        count = args[0]->Uint32Value(isolate->GetCurrentContext()).FromJust();
+    }
+    NAPA_OBJECTWRAP::Unwrap<SemaphoreWrap>(args.Holder())->Get<Semaphore>()->Release(count);
+}
+
+void SemaphoreWrap::GetCountCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto semaphore = NAPA_OBJECTWRAP::Unwrap<SemaphoreWrap>(args.Holder())->Get<Semaphore>();
+    args.GetReturnValue().Set(semaphore->GetCount());
+}
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/module.h>
+#include <napa/module/shareable-wrap.h>
+
+namespace napa {
+namespace module {
+
+    /// <summary> An object wrap to expose semaphore APIs. </summary>
+    class SemaphoreWrap : public ShareableWrap {
+    public:
+
+        /// <summary> Initializes the wrap. </summary>
+        static void Init();
+
+        /// <summary> Creates a new instance of SemaphoreWrap. </summary>
+        /// <param name="count"> The number of permits available initially. </param>
+        static v8::Local<v8::Object> NewInstance(uint32_t count);
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "SemaphoreWrap";
+
+        /// <summary> Declare persistent constructor to create Semaphore Javascript wrapper instance. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
+    private:
+
+        // SemaphoreWrap methods
+        static void AcquireCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void AcquireSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void TryAcquireCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void ReleaseCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        // SemaphoreWrap accessors
+        static void GetCountCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+    };
+}
+}
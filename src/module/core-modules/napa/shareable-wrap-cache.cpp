@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <zone/worker-context.h>
+
+#include <napa/module/binding.h>
+#include <napa/module/shareable-wrap.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+using namespace napa::module;
+
+namespace {
+
+    /// <summary> Wraps of shared objects in the current isolate, so transporting an object again doesn't create another wrap. </summary>
+    /// <remarks> Wraps are held weakly, once the isolate drops a wrap it's collected and removed from the cache. </remarks>
+    class ShareableWrapCache {
+    public:
+        /// <summary> Get the cache of the current isolate. </summary>
+        static ShareableWrapCache& GetCurrent() {
+            auto cache = static_cast<ShareableWrapCache*>(
+                napa::zone::WorkerContext::Get(napa::zone::WorkerContextItem::SHAREABLE_WRAP_CACHE));
+            if (cache == nullptr) {
+                // Like the store value cache, the cache lives as long as the isolate.
+                cache = new ShareableWrapCache();
+                napa::zone::WorkerContext::Set(napa::zone::WorkerContextItem::SHAREABLE_WRAP_CACHE, cache);
+            }
+            return *cache;
+        }
+
+        /// <summary> Find the wrap of an object, empty if not cached or the wrap was loaded with another object since. </summary>
+        v8::Local<v8::Object> Find(const void* object, const char* wrapType) {
+            auto entry = FindEntry(object, wrapType);
+            if (entry == nullptr) {
+                return v8::Local<v8::Object>();
+            }
+
+            auto wrap = v8::Local<v8::Object>::New(v8::Isolate::GetCurrent(), entry->wrap);
+            if (NAPA_OBJECTWRAP::Unwrap<ShareableWrap>(wrap)->Get().get() != object) {
+                return v8::Local<v8::Object>();
+            }
+            return wrap;
+        }
+
+        /// <summary> Cache the wrap of an object, replacing the wrap cached earlier. </summary>
+        void Insert(const void* object, const char* wrapType, v8::Local<v8::Object> wrap) {
+            auto entry = FindEntry(object, wrapType);
+            if (entry == nullptr) {
+                auto newEntry = std::make_unique<Entry>();
+                newEntry->cache = this;
+                newEntry->object = object;
+                newEntry->wrapType = wrapType;
+                entry = newEntry.get();
+                _entries.emplace(object, std::move(newEntry));
+            }
+            entry->wrap.Reset(v8::Isolate::GetCurrent(), wrap);
+            entry->wrap.SetWeak(entry, OnCollected, v8::WeakCallbackType::kParameter);
+        }
+
+    private:
+        struct Entry {
+            ShareableWrapCache* cache;
+            const void* object;
+            std::string wrapType;
+            v8::Global<v8::Object> wrap;
+        };
+
+        using EntryMap = std::unordered_multimap<const void*, std::unique_ptr<Entry>>;
+
+        Entry* FindEntry(const void* object, const char* wrapType) {
+            auto range = _entries.equal_range(object);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (std::strcmp(it->second->wrapType.c_str(), wrapType) == 0) {
+                    return it->second.get();
+                }
+            }
+            return nullptr;
+        }
+
+        static void OnCollected(const v8::WeakCallbackInfo<Entry>& info) {
+            auto entry = info.GetParameter();
+            entry->wrap.Reset();
+
+            auto& entries = entry->cache->_entries;
+            auto range = entries.equal_range(entry->object);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second.get() == entry) {
+                    entries.erase(it);
+                    break;
+                }
+            }
+        }
+
+        EntryMap _entries;
+    };
+}
+
+v8::Local<v8::Object> napa::module::binding::FindShareableWrap(const void* object, const char* wrapType) {
+    return ShareableWrapCache::GetCurrent().Find(object, wrapType);
+}
+
+void napa::module::binding::CacheShareableWrap(const void* object, const char* wrapType, v8::Local<v8::Object> wrap) {
+    ShareableWrapCache::GetCurrent().Insert(object, wrapType, wrap);
+}
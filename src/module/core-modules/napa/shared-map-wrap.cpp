@@ -0,0 +1,216 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "shared-map-wrap.h"
+
+#include <napa/module/binding/wraps.h>
+
+#include <cstring>
+
+using namespace napa::module;
+using napa::memory::SharedMap;
+using napa::memory::SharedMapValue;
+using napa::memory::SharedMapValueType;
+
+NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(napa::module::SharedMapWrap);
+
+namespace {
+
+    /// <summary> Get the map of a wrap and check its key argument. </summary>
+    /// <returns> Null with an exception thrown if the wrap is empty or the key is not a string. </returns>
+    SharedMap* GetMapWithKey(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        auto map = NAPA_OBJECTWRAP::Unwrap<SharedMapWrap>(args.Holder())->Get<SharedMap>().get();
+        JS_ENSURE_WITH_RETURN(isolate, map != nullptr, nullptr, "SharedMapWrap is not attached with any C++ map.");
+        JS_ENSURE_WITH_RETURN(isolate, args.Length() > 0 && args[0]->IsString(), nullptr,
+            "Argument \"key\" shall be a string.");
+        return map;
+    }
+}
+
+void SharedMapWrap::Init() {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto constructorTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<SharedMapWrap>);
+    constructorTemplate->SetClassName(v8_helpers::MakeV8String(isolate, exportName));
+    constructorTemplate->InstanceTemplate()->SetInternalFieldCount(1);
+
+    InitConstructorTemplate<SharedMapWrap>(constructorTemplate);
+
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "get", GetCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "set", SetCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "add", AddCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "has", HasCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "delete", DeleteCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "clear", ClearCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "keys", KeysCallback);
+    NAPA_SET_ACCESSOR(constructorTemplate, "size", GetSizeCallback, nullptr);
+
+    auto constructor = constructorTemplate->GetFunction();
+    InitConstructor("<SharedMapWrap>", constructor);
+    NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructor);
+}
+
+v8::Local<v8::Object> SharedMapWrap::NewInstance() {
+    return binding::CreateShareableWrap(std::make_shared<SharedMap>(), exportName);
+}
+
+void SharedMapWrap::GetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    auto map = GetMapWithKey(args);
+    if (map == nullptr) {
+        return;
+    }
+
+    // The value is reused by the calls of a thread, so reading strings and buffers doesn't allocate native memory.
+    thread_local SharedMapValue value;
+    v8::String::Utf8Value key(args[0]);
+    if (!map->Get(*key, static_cast<size_t>(key.length()), value)) {
+        return;
+    }
+
+    switch (value.type) {
+    case SharedMapValueType::Number:
+        args.GetReturnValue().Set(value.number);
+        break;
+    case SharedMapValueType::Boolean:
+        args.GetReturnValue().Set(value.boolean);
+        break;
+    case SharedMapValueType::String:
+        args.GetReturnValue().Set(v8::String::NewFromUtf8(
+            isolate,
+            value.bytes.data(),
+            v8::NewStringType::kNormal,
+            static_cast<int>(value.bytes.size())).ToLocalChecked());
+        break;
+    case SharedMapValueType::ArrayBuffer: {
+        auto buffer = v8::ArrayBuffer::New(isolate, value.bytes.size());
+        if (!value.bytes.empty()) {
+            std::memcpy(buffer->GetContents().Data(), value.bytes.data(), value.bytes.size());
+        }
+        args.GetReturnValue().Set(buffer);
+        break;
+    }
+    }
+}
+
+void SharedMapWrap::SetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    auto map = GetMapWithKey(args);
+    if (map == nullptr) {
+        return;
+    }
+    CHECK_ARG(isolate, args.Length() == 2, "Argument \"value\" is required for \"set\".");
+
+    SharedMapValue value;
+    auto argument = args[1];
+    if (argument->IsNumber()) {
+        value.number = argument->NumberValue(isolate->GetCurrentContext()).FromJust();
+    } else if (argument->IsBoolean()) {
+        value.type = SharedMapValueType::Boolean;
+        value.boolean = v8::Local<v8::Boolean>::Cast(argument)->Value();
+    } else if (argument->IsString()) {
+        value.type = SharedMapValueType::String;
+        v8::String::Utf8Value string(argument);
+        value.bytes.assign(*string, static_cast<size_t>(string.length()));
+    } else if (argument->IsArrayBuffer() || argument->IsArrayBufferView()) {
+        // Views store the bytes they see, which are read back as an ArrayBuffer.
+        size_t offset = 0;
+        size_t length = 0;
+        v8::Local<v8::ArrayBuffer> buffer;
+        if (argument->IsArrayBuffer()) {
+            buffer = v8::Local<v8::ArrayBuffer>::Cast(argument);
+            length = buffer->ByteLength();
+        } else {
+            auto view = v8::Local<v8::ArrayBufferView>::Cast(argument);
+            buffer = view->Buffer();
+            offset = view->ByteOffset();
+            length = view->ByteLength();
+        }
+        value.type = SharedMapValueType::ArrayBuffer;
+        value.bytes.assign(static_cast<const char*>(buffer->GetContents().Data()) + offset, length);
+    } else {
+        JS_FAIL(isolate, "Argument \"value\" shall be a number, a string, a boolean or an ArrayBuffer.");
+    }
+
+    v8::String::Utf8Value key(args[0]);
+    map->Set(*key, static_cast<size_t>(key.length()), std::move(value));
+}
+
+void SharedMapWrap::AddCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    auto map = GetMapWithKey(args);
+    if (map == nullptr) {
+        return;
+    }
+    CHECK_ARG(isolate, args.Length() == 2 && args[1]->IsNumber(), "Argument \"delta\" shall be a number.");
+
+    v8::String::Utf8Value key(args[0]);
+    double result = 0;
+    auto added = map->Add(
+        *key,
+        static_cast<size_t>(key.length()),
+        args[1]->NumberValue(isolate->GetCurrentContext()).FromJust(),
+        result);
+    JS_ENSURE(isolate, added, "The value of key \"%s\" is not a number.", *key);
+
+    args.GetReturnValue().Set(result);
+}
+
+void SharedMapWrap::HasCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto map = GetMapWithKey(args);
+    if (map == nullptr) {
+        return;
+    }
+
+    v8::String::Utf8Value key(args[0]);
+    args.GetReturnValue().Set(map->Has(*key, static_cast<size_t>(key.length())));
+}
+
+void SharedMapWrap::DeleteCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto map = GetMapWithKey(args);
+    if (map == nullptr) {
+        return;
+    }
+
+    v8::String::Utf8Value key(args[0]);
+    args.GetReturnValue().Set(map->Delete(*key, static_cast<size_t>(key.length())));
+}
+
+void SharedMapWrap::ClearCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto map = NAPA_OBJECTWRAP::Unwrap<SharedMapWrap>(args.Holder())->Get<SharedMap>();
+    JS_ENSURE(isolate, map != nullptr, "SharedMapWrap is not attached with any C++ map.");
+
+    map->Clear();
+}
+
+void SharedMapWrap::KeysCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    auto map = NAPA_OBJECTWRAP::Unwrap<SharedMapWrap>(args.Holder())->Get<SharedMap>();
+    JS_ENSURE(isolate, map != nullptr, "SharedMapWrap is not attached with any C++ map.");
+
+    auto keys = map->GetKeys();
+    auto result = v8::Array::New(isolate, static_cast<int>(keys.size()));
+    for (uint32_t i = 0; i < keys.size(); ++i) {
+        (void)result->Set(context, i, v8::String::NewFromUtf8(
+            isolate,
+            keys[i].data(),
+            v8::NewStringType::kNormal,
+            static_cast<int>(keys[i].size())).ToLocalChecked());
+    }
+    args.GetReturnValue().Set(result);
+}
+
+void SharedMapWrap::GetSizeCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto map = NAPA_OBJECTWRAP::Unwrap<SharedMapWrap>(args.Holder())->Get<SharedMap>();
+    args.GetReturnValue().Set(static_cast<double>(map != nullptr ? map->GetSize() : 0));
+}
@@ -0,0 +1,58 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/module.h>
+#include <napa/module/shareable-wrap.h>
+
+#include <memory/shared-map.h>
+
+namespace napa {
+namespace module {
+
+    /// <summary> An object wrap of napa::memory::SharedMap. </summary>
+    /// <remarks> Reference: napajs/lib/memory/shared-map.ts#SharedMap </remarks>
+    class SharedMapWrap : public ShareableWrap {
+    public:
+
+        /// <summary> Initializes the wrap. </summary>
+        static void Init();
+
+        /// <summary> Creates a new instance of SharedMapWrap with an empty map. </summary>
+        static v8::Local<v8::Object> NewInstance();
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "SharedMapWrap";
+
+        /// <summary> Declare persistent constructor to create SharedMap Javascript wrapper instance. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
+    private:
+
+        /// <summary> It implements SharedMap.get(key: string): number | string | boolean | ArrayBuffer | undefined </summary>
+        static void GetCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements SharedMap.set(key: string, value: number | string | boolean | ArrayBuffer): void </summary>
+        static void SetCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements SharedMap.add(key: string, delta: number): number </summary>
+        static void AddCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements SharedMap.has(key: string): boolean </summary>
+        static void HasCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements SharedMap.delete(key: string): boolean </summary>
+        static void DeleteCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements SharedMap.clear(): void </summary>
+        static void ClearCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements SharedMap.keys(): string[] </summary>
+        static void KeysCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements readonly SharedMap.size: number </summary>
+        static void GetSizeCallback(v8::Local<v8::String> propertyName, const v8::PropertyCallbackInfo<v8::Value>& args);
+    };
+}
+}
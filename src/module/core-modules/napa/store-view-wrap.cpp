@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "store-view-wrap.h"
+#include "store-wrap.h"
+
+#include <string>
+#include <vector>
+
+using namespace napa::module;
+
+NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(StoreViewWrap);
+
+void StoreViewWrap::Init() {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto constructorTemplate = v8::FunctionTemplate::New(isolate, DefaultConstructorCallback<StoreViewWrap>);
+    constructorTemplate->SetClassName(v8_helpers::MakeV8String(isolate, exportName));
+    constructorTemplate->InstanceTemplate()->SetInternalFieldCount(1);
+
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "get", GetCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "getMany", GetManyCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "has", HasCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "release", ReleaseCallback);
+
+    NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructorTemplate->GetFunction());
+}
+
+v8::Local<v8::Object> StoreViewWrap::NewInstance(std::shared_ptr<napa::store::Store> store, std::shared_ptr<napa::store::Store::View> view) {
+    auto object = napa::module::NewInstance<StoreViewWrap>().ToLocalChecked();
+    auto wrap = NAPA_OBJECTWRAP::Unwrap<StoreViewWrap>(object);
+    wrap->_store = std::move(store);
+    wrap->_view = std::move(view);
+    return object;
+}
+
+void StoreViewWrap::GetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"get\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'key' must be string.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreViewWrap>(args.Holder());
+    JS_ENSURE(isolate, thisObject->_view != nullptr, "View of store \"%s\" is released.", thisObject->_store->GetId());
+
+    auto key = v8_helpers::V8ValueTo<std::string>(args[0]);
+    auto storeValue = thisObject->_view->Get(key.c_str());
+    if (storeValue == nullptr) {
+        args.GetReturnValue().SetUndefined();
+        return;
+    }
+
+    auto value = StoreWrap::UnmarshallValue(*thisObject->_store, key, storeValue);
+    RETURN_ON_PENDING_EXCEPTION(value);
+    args.GetReturnValue().Set(value.ToLocalChecked());
+}
+
+void StoreViewWrap::GetManyCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"getMany\".");
+    CHECK_ARG(isolate, args[0]->IsArray(), "Argument 'keys' must be an array of strings.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreViewWrap>(args.Holder());
+    JS_ENSURE(isolate, thisObject->_view != nullptr, "View of store \"%s\" is released.", thisObject->_store->GetId());
+
+    auto array = v8::Local<v8::Array>::Cast(args[0]);
+    std::vector<std::string> keys;
+    keys.reserve(array->Length());
+    for (uint32_t i = 0; i < array->Length(); ++i) {
+        auto key = array->Get(context, i);
+        RETURN_ON_PENDING_EXCEPTION(key);
+        CHECK_ARG(isolate, key.ToLocalChecked()->IsString(), "Key %u of 'keys' must be string.", i);
+        keys.emplace_back(v8_helpers::V8ValueTo<std::string>(key.ToLocalChecked()));
+    }
+
+    auto storeValues = thisObject->_view->GetMany(keys);
+    auto values = v8::Array::New(isolate, static_cast<int>(keys.size()));
+    for (uint32_t i = 0; i < keys.size(); ++i) {
+        v8::Local<v8::Value> value = v8::Undefined(isolate);
+        if (storeValues[i] != nullptr) {
+            auto maybeValue = StoreWrap::UnmarshallValue(*thisObject->_store, keys[i], storeValues[i]);
+            RETURN_ON_PENDING_EXCEPTION(maybeValue);
+            value = maybeValue.ToLocalChecked();
+        }
+        (void)values->Set(context, i, value);
+    }
+    args.GetReturnValue().Set(values);
+}
+
+void StoreViewWrap::HasCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"has\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'key' must be string.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreViewWrap>(args.Holder());
+    JS_ENSURE(isolate, thisObject->_view != nullptr, "View of store \"%s\" is released.", thisObject->_store->GetId());
+
+    args.GetReturnValue().Set(thisObject->_view->Has(v8_helpers::V8ValueTo<std::string>(args[0]).c_str()));
+}
+
+void StoreViewWrap::ReleaseCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    // The store drops the values kept for the view, instead of waiting for the wrap to be collected.
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreViewWrap>(args.Holder());
+    thisObject->_view.reset();
+}
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/module.h>
+
+#include <store/store.h>
+
+namespace napa {
+namespace module {
+
+    /// <summary> It wraps napa::store::Store::View. </summary>
+    /// <remarks> Reference: napajs/lib/store/store.ts#StoreView </remarks>
+    class StoreViewWrap: public NAPA_OBJECTWRAP {
+    public:
+        /// <summary> Init this wrap. </summary>
+        static void Init();
+
+        /// <summary> It creates an instance of StoreViewWrap with a view of a store. </summary>
+        static v8::Local<v8::Object> NewInstance(std::shared_ptr<napa::store::Store> store, std::shared_ptr<napa::store::Store::View> view);
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "StoreViewWrap";
+
+        /// <summary> Declare persistent constructor to create StoreView Javascript wrapper instance. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
+    private:
+        /// <summary> Default constructor. </summary>
+        StoreViewWrap() = default;
+
+        /// <summary> No copy allowed. </summary>
+        StoreViewWrap(const StoreViewWrap&) = delete;
+        StoreViewWrap& operator=(const StoreViewWrap&) = delete;
+
+        /// <summary> It implements StoreView.get(key: string): any </summary>
+        static void GetCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements StoreView.getMany(keys: string[]): any[] </summary>
+        static void GetManyCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements StoreView.has(key: string): boolean </summary>
+        static void HasCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements StoreView.release(): void </summary>
+        static void ReleaseCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> Friend default constructor callback. </summary>
+        template <typename T>
+        friend void napa::module::DefaultConstructorCallback(const v8::FunctionCallbackInfo<v8::Value>&);
+
+        template <typename T>
+        friend v8::MaybeLocal<v8::Object> napa::module::NewInstance(int argc, v8::Local<v8::Value> argv[]);
+
+        /// <summary> Store of the view, which unmarshalls values of frozen stores from the value cache. </summary>
+        std::shared_ptr<napa::store::Store> _store;
+
+        /// <summary> The view, empty once released. </summary>
+        std::shared_ptr<napa::store::Store::View> _view;
+    };
+}
+}
@@ -2,10 +2,371 @@
 // Licensed under the MIT license.
 
 #include "store-wrap.h"
+#include "store-view-wrap.h"
+
+#include <zone/call-context.h>
+#include <zone/worker-context.h>
+
+#include <napa/async.h>
 #include <napa/transport.h>
 
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 using namespace napa::module;
 
+namespace {
+
+    /// <summary> The trace of the zone call running on this thread, store operations are spans of it if it's sampled. </summary>
+    const napa::zone::TraceContext* GetCallTrace() {
+        auto callContext = static_cast<napa::zone::CallContext*>(
+            napa::zone::WorkerContext::Get(napa::zone::WorkerContextItem::CALL_CONTEXT));
+        return callContext != nullptr ? &callContext->GetTrace() : nullptr;
+    }
+
+    /// <summary> Values unmarshalled from frozen stores in the current isolate, reused until their entries change. </summary>
+    /// <remarks> Values are held weakly, once the isolate drops them they are collected and unmarshalled again. </remarks>
+    class StoreValueCache {
+    public:
+        /// <summary> Get the cache of the current isolate. </summary>
+        static StoreValueCache& GetCurrent() {
+            auto cache = static_cast<StoreValueCache*>(
+                napa::zone::WorkerContext::Get(napa::zone::WorkerContextItem::STORE_VALUE_CACHE));
+            if (cache == nullptr) {
+                // Like persistent constructors, the cache lives as long as the isolate.
+                cache = new StoreValueCache();
+                napa::zone::WorkerContext::Set(napa::zone::WorkerContextItem::STORE_VALUE_CACHE, cache);
+            }
+            return *cache;
+        }
+
+        /// <summary> Find a cached value, empty if not cached or cached from another version. </summary>
+        v8::Local<v8::Object> Find(const std::string& key, uint64_t version) {
+            auto it = _entries.find(key);
+            if (it == _entries.end() || it->second->version != version) {
+                return v8::Local<v8::Object>();
+            }
+            return v8::Local<v8::Object>::New(v8::Isolate::GetCurrent(), it->second->value);
+        }
+
+        /// <summary> Cache a value of a version, replacing the value cached from an earlier version. </summary>
+        void Insert(const std::string& key, uint64_t version, v8::Local<v8::Object> value) {
+            auto entry = std::make_unique<Entry>();
+            entry->cache = this;
+            entry->key = key;
+            entry->version = version;
+            entry->value.Reset(v8::Isolate::GetCurrent(), value);
+            entry->value.SetWeak(entry.get(), OnCollected, v8::WeakCallbackType::kParameter);
+            _entries[key] = std::move(entry);
+        }
+
+    private:
+        struct Entry {
+            StoreValueCache* cache;
+            std::string key;
+            uint64_t version;
+            v8::Global<v8::Object> value;
+        };
+
+        static void OnCollected(const v8::WeakCallbackInfo<Entry>& info) {
+            auto entry = info.GetParameter();
+            entry->value.Reset();
+
+            auto key = entry->key;
+            entry->cache->_entries.erase(key);
+        }
+
+        std::unordered_map<std::string, std::unique_ptr<Entry>> _entries;
+    };
+
+    /// <summary> A watch of a JavaScript callback, which is called in the isolate that created the watch. </summary>
+    /// <remarks>
+    /// The watch keeps an asynchronous work armed, which a change of the store completes. Changes that come before
+    /// the callback runs are coalesced, each changed key is passed to the callback once, then the work is armed again.
+    /// </remarks>
+    struct StoreWatch {
+        /// <summary> The watched store. </summary>
+        std::shared_ptr<napa::store::Store> store;
+
+        /// <summary> Id of the watch in the store. </summary>
+        uint64_t id = 0;
+
+        /// <summary> Guards members below, which are changed by the threads that change the store. </summary>
+        std::mutex lock;
+
+        /// <summary> Changed keys not yet passed to the callback, in the order of their first change. </summary>
+        std::vector<std::string> pendingKeys;
+        std::unordered_set<std::string> pendingKeySet;
+
+        /// <summary> Completion of the armed asynchronous work, empty if it's not armed or already completed. </summary>
+        std::function<void(void*)> complete;
+
+        /// <summary> False once unwatched. </summary>
+        bool active = true;
+    };
+
+    /// <summary> Watches created in the current isolate, by id. </summary>
+    using StoreWatches = std::unordered_map<uint64_t, std::shared_ptr<StoreWatch>>;
+
+    StoreWatches& GetCurrentWatches() {
+        auto watches = static_cast<StoreWatches*>(
+            napa::zone::WorkerContext::Get(napa::zone::WorkerContextItem::STORE_WATCHES));
+        if (watches == nullptr) {
+            // Like the value cache, watches live as long as the isolate.
+            watches = new StoreWatches();
+            napa::zone::WorkerContext::Set(napa::zone::WorkerContextItem::STORE_WATCHES, watches);
+        }
+        return *watches;
+    }
+
+    /// <summary> Record a changed key, and complete the armed work if it's not completed yet. </summary>
+    void NotifyWatch(const std::shared_ptr<StoreWatch>& watch, const std::string& key) {
+        std::function<void(void*)> complete;
+        {
+            std::lock_guard<std::mutex> lock(watch->lock);
+            if (!watch->active) {
+                return;
+            }
+            if (watch->pendingKeySet.insert(key).second) {
+                watch->pendingKeys.push_back(key);
+            }
+            complete.swap(watch->complete);
+        }
+        if (complete) {
+            complete(nullptr);
+        }
+    }
+
+    /// <summary> Arm the asynchronous work of a watch, in the isolate that created the watch. </summary>
+    void ArmWatch(std::shared_ptr<StoreWatch> watch, v8::Local<v8::Function> jsCallback) {
+        napa::zone::DoAsyncWork(jsCallback,
+            [watch](std::function<void(void*)> complete) {
+                {
+                    std::lock_guard<std::mutex> lock(watch->lock);
+                    if (watch->active && watch->pendingKeys.empty()) {
+                        watch->complete = std::move(complete);
+                        return;
+                    }
+                }
+                // Keys changed while the callback ran, or the watch stopped.
+                complete(nullptr);
+            },
+            [watch](v8::Local<v8::Function> jsCallback, void*) {
+                auto isolate = v8::Isolate::GetCurrent();
+                auto context = isolate->GetCurrentContext();
+                v8::HandleScope scope(isolate);
+
+                std::vector<std::string> keys;
+                {
+                    std::lock_guard<std::mutex> lock(watch->lock);
+                    if (!watch->active) {
+                        return;
+                    }
+                    keys.swap(watch->pendingKeys);
+                    watch->pendingKeySet.clear();
+                }
+
+                // The work is armed before the callbacks run, so a callback can unwatch.
+                ArmWatch(watch, jsCallback);
+                for (auto& key : keys) {
+                    v8::Local<v8::Value> argv[] = { napa::v8_helpers::MakeV8String(isolate, key) };
+                    (void)jsCallback->Call(context, context->Global(), 1, argv);
+                }
+            });
+    }
+
+    /// <summary> Freeze an object and the objects it references, so it can be shared by all gets. </summary>
+    /// <remarks> ArrayBuffers and typed arrays can't be frozen, they are left writable. </remarks>
+    void DeepFreeze(v8::Local<v8::Context> context, v8::Local<v8::Object> root) {
+        // Objects are tracked by identity hash, since unmarshalled transportable objects can reference each other.
+        std::unordered_map<int, std::vector<v8::Local<v8::Object>>> visited;
+        std::vector<v8::Local<v8::Object>> pending = { root };
+
+        while (!pending.empty()) {
+            auto object = pending.back();
+            pending.pop_back();
+
+            auto& sameHash = visited[object->GetIdentityHash()];
+            bool seen = false;
+            for (auto& other : sameHash) {
+                seen = seen || other->StrictEquals(object);
+            }
+            if (seen || object->IsArrayBuffer() || object->IsArrayBufferView() || object->IsSharedArrayBuffer()) {
+                continue;
+            }
+            sameHash.push_back(object);
+
+            v8::Local<v8::Array> names;
+            if (object->GetOwnPropertyNames(context).ToLocal(&names)) {
+                for (uint32_t i = 0; i < names->Length(); ++i) {
+                    v8::Local<v8::Value> value;
+                    if (object->Get(context, names->Get(context, i).ToLocalChecked()).ToLocal(&value) && value->IsObject()) {
+                        pending.push_back(v8::Local<v8::Object>::Cast(value));
+                    }
+                }
+            }
+            (void)object->SetIntegrityLevel(context, v8::IntegrityLevel::kFrozen);
+        }
+    }
+
+    /// <summary> Read the last argument of "set" and "setMany", either a transfer list or SetOptions. </summary>
+    /// <returns> False with an exception thrown if the argument is invalid. </returns>
+    bool ReadSetOptions(v8::Isolate* isolate, v8::Local<v8::Value> arg, v8::Local<v8::Value>& transferList, uint32_t& ttl) {
+        if (arg->IsUndefined()) {
+            return true;
+        }
+        CHECK_ARG_WITH_RETURN(isolate, arg->IsObject(), false, "Argument \"transferList\" must be an array or options of \"set\".");
+
+        if (arg->IsArray()) {
+            transferList = arg;
+            return true;
+        }
+
+        auto context = isolate->GetCurrentContext();
+        auto options = v8::Local<v8::Object>::Cast(arg);
+        auto ttlValue = options->Get(context, napa::v8_helpers::MakeV8String(isolate, "ttl"));
+        SHORT_CIRCUIT_ON_PENDING_EXCEPTION(ttlValue, false);
+        if (!ttlValue.ToLocalChecked()->IsUndefined()) {
+            CHECK_ARG_WITH_RETURN(isolate, ttlValue.ToLocalChecked()->IsNumber(), false, "Option \"ttl\" must be a number of milliseconds.");
+            ttl = ttlValue.ToLocalChecked()->Uint32Value(context).FromJust();
+        }
+
+        auto transferListValue = options->Get(context, napa::v8_helpers::MakeV8String(isolate, "transferList"));
+        SHORT_CIRCUIT_ON_PENDING_EXCEPTION(transferListValue, false);
+        if (!transferListValue.ToLocalChecked()->IsUndefined()) {
+            CHECK_ARG_WITH_RETURN(isolate, transferListValue.ToLocalChecked()->IsArray(), false, "Option \"transferList\" must be an array.");
+            transferList = transferListValue.ToLocalChecked();
+        }
+        return true;
+    }
+
+    /// <summary> Marshall a JavaScript value into a store value. ArrayBuffers in the transfer list are moved, but not detached yet. </summary>
+    /// <returns> The store value, or nullptr with an exception pending if marshalling failed. </returns>
+    std::shared_ptr<napa::store::Store::ValueType> MarshallStoreValue(
+        const napa::store::Store& store,
+        v8::Local<v8::Value> value,
+        v8::Local<v8::Value> transferList) {
+
+        auto isolate = v8::Isolate::GetCurrent();
+        napa::transport::TransportContext transportContext;
+        auto payload = napa::transport::Marshall(value, &transportContext, transferList);
+        SHORT_CIRCUIT_ON_PENDING_EXCEPTION(payload, nullptr);
+
+        // Other processes can't see objects in the memory of this process.
+        JS_ENSURE_WITH_RETURN(isolate,
+            !napa::store::IsSharedStoreId(store.GetId()) || transportContext.GetSharedCount() == 0,
+            nullptr,
+            "Values of shared store \"%s\" can't reference SharedArrayBuffers or transferred ArrayBuffers.",
+            store.GetId());
+
+        auto storeValue = std::make_shared<napa::store::Store::ValueType>();
+        auto payloadString = payload.ToLocalChecked();
+
+        // JSON of mostly ASCII values fits in Latin-1, which takes half the memory of UTF-16.
+        if (!napa::v8_helpers::WriteOneByte(payloadString, storeValue->oneBytePayload)) {
+            storeValue->payload = napa::v8_helpers::V8ValueTo<std::u16string>(payloadString);
+        }
+        storeValue->transportContext = std::move(transportContext);
+
+        // Shared stores keep payloads in named shared memory, which other processes read as is.
+        if (!napa::store::IsSharedStoreId(store.GetId())) {
+            storeValue->Compress(store.GetOptions().compressionThreshold);
+        }
+        return storeValue;
+    }
+
+    /// <summary> External string over the payload of a store value, which keeps the value alive while V8 references it. </summary>
+    /// <remarks> Strings unmarshalled from the payload may be slices of it, so it can outlive the store entry. </remarks>
+    template <typename Resource, typename Char>
+    class StorePayloadResource : public Resource {
+    public:
+        StorePayloadResource(std::shared_ptr<napa::store::Store::ValueType> storeValue, const Char* data, size_t length) :
+            _storeValue(std::move(storeValue)), _data(data), _length(length) {}
+
+        const Char* data() const override { return _data; }
+        size_t length() const override { return _length; }
+
+    private:
+        std::shared_ptr<napa::store::Store::ValueType> _storeValue;
+        const Char* _data;
+        size_t _length;
+    };
+
+    /// <summary> Make an external V8 string over the payload of a store value, without copying it. </summary>
+    /// <returns> The string, or empty with an exception thrown if the compressed payload is corrupted. </returns>
+    v8::MaybeLocal<v8::String> MakePayloadString(v8::Isolate* isolate, const std::shared_ptr<napa::store::Store::ValueType>& storeValue) {
+        // V8 garbage collection frees the resources.
+        if (storeValue->IsCompressed()) {
+            std::string oneBytePayload;
+            std::u16string payload;
+            JS_ENSURE_WITH_RETURN(isolate,
+                storeValue->Decompress(oneBytePayload, payload),
+                v8::MaybeLocal<v8::String>(),
+                "Compressed store value is corrupted.");
+
+            // The decompressed payload is owned by its string.
+            return storeValue->compressedTwoByte
+                ? napa::v8_helpers::MakeOwnedExternalV8String(isolate, std::move(payload))
+                : napa::v8_helpers::MakeOwnedExternalV8String(isolate, std::move(oneBytePayload));
+        }
+
+        if (storeValue->IsOneByte()) {
+            auto& payload = storeValue->oneBytePayload;
+            auto resource = new StorePayloadResource<v8::String::ExternalOneByteStringResource, char>(
+                storeValue, payload.data(), payload.size());
+            return v8::String::NewExternalOneByte(isolate, resource).ToLocalChecked();
+        }
+
+        auto& payload = storeValue->payload;
+        auto resource = new StorePayloadResource<v8::String::ExternalStringResource, uint16_t>(
+            storeValue, reinterpret_cast<const uint16_t*>(payload.data()), payload.size());
+        return v8::String::NewExternalTwoByte(isolate, resource).ToLocalChecked();
+    }
+
+    /// <summary> Unmarshall a store value. </summary>
+    /// <remarks>
+    /// Frozen values can't be changed by the caller, the value unmarshalled by this isolate is returned until the key is set again.
+    /// Interned values are cached by their versions instead, so keys and stores of the same payload share the value.
+    /// </remarks>
+    v8::MaybeLocal<v8::Value> UnmarshallStoreValue(
+        v8::Isolate* isolate,
+        napa::store::Store& store,
+        const std::string& key,
+        const std::shared_ptr<napa::store::Store::ValueType>& storeValue) {
+
+        auto frozen = store.GetOptions().frozen;
+        std::string cacheKey;
+        if (frozen) {
+            cacheKey = storeValue->interned
+                ? std::string(1, '\0') + std::to_string(storeValue->version)
+                : std::string(store.GetId()) + '\0' + key;
+            auto cachedValue = StoreValueCache::GetCurrent().Find(cacheKey, storeValue->version);
+            if (!cachedValue.IsEmpty()) {
+                return cachedValue;
+            }
+        }
+
+        auto payload = MakePayloadString(isolate, storeValue);
+        SHORT_CIRCUIT_ON_PENDING_EXCEPTION(payload, v8::MaybeLocal<v8::Value>());
+
+        auto value = napa::transport::Unmarshall(payload.ToLocalChecked(), &(storeValue->transportContext));
+        SHORT_CIRCUIT_ON_PENDING_EXCEPTION(value, v8::MaybeLocal<v8::Value>());
+
+        auto jsValue = value.ToLocalChecked();
+        if (frozen && jsValue->IsObject()) {
+            auto object = v8::Local<v8::Object>::Cast(jsValue);
+            DeepFreeze(isolate->GetCurrentContext(), object);
+            StoreValueCache::GetCurrent().Insert(cacheKey, storeValue->version, object);
+        }
+        return jsValue;
+    }
+}
+
 NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(StoreWrap);
     
 void StoreWrap::Init() {
@@ -16,10 +377,27 @@ void StoreWrap::Init() {
 
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "set", SetCallback);
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "get", GetCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "setLoader", SetLoaderCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "_getOrLoad", GetOrLoadCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "setMany", SetManyCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "patch", PatchCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "view", ViewCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "getMany", GetManyCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "keys", KeysCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "range", RangeCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "increment", IncrementCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "add", AddCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "compareAndSet", CompareAndSetCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "getNumber", GetNumberCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "snapshot", SnapshotCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "load", LoadCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "watch", WatchCallback);
+    NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "unwatch", UnwatchCallback);
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "has", HasCallback);
     NAPA_SET_PROTOTYPE_METHOD(constructorTemplate, "delete", DeleteCallback);
     NAPA_SET_ACCESSOR(constructorTemplate, "id", GetIdCallback, nullptr);
     NAPA_SET_ACCESSOR(constructorTemplate, "size", GetSizeCallback, nullptr);
+    NAPA_SET_ACCESSOR(constructorTemplate, "byteSize", GetByteSizeCallback, nullptr);
 
     NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, constructorTemplate->GetFunction());
 }
@@ -39,24 +417,100 @@ void StoreWrap::SetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
     
-    CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"set\".");
+    CHECK_ARG(isolate, args.Length() == 2 || args.Length() == 3, "2 or 3 arguments are required for \"set\".");
     CHECK_ARG(isolate, args[0]->IsString(), "Argument \"key\" must be string.");
 
     auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
     auto& store = thisObject->Get();
+    napa::zone::SpanScope span(GetCallTrace(), "store", "set", store.GetId());
 
-    // Marshall value object into payload.
-    napa::transport::TransportContext transportContext;
-    auto payload = napa::transport::Marshall(args[1], &transportContext);
-    
-    RETURN_ON_PENDING_EXCEPTION(payload);
+    v8::Local<v8::Value> transferList;
+    uint32_t ttl = 0;
+    if (args.Length() == 3 && !ReadSetOptions(isolate, args[2], transferList, ttl)) {
+        return;
+    }
+
+    auto storeValue = MarshallStoreValue(store, args[1], transferList);
+    if (storeValue == nullptr) {
+        return;
+    }
+
+    if (!transferList.IsEmpty()) {
+        napa::transport::Detach(transferList);
+    }
     
-    store.Set(
-        v8_helpers::V8ValueTo<std::string>(args[0]).c_str(),
-        std::make_shared<napa::store::Store::ValueType>(napa::store::Store::ValueType {
-            v8_helpers::V8ValueTo<std::u16string>(payload.ToLocalChecked()),
-            std::move(transportContext)
-        }));
+    store.Set(v8_helpers::V8ValueTo<std::string>(args[0]).c_str(), std::move(storeValue), ttl);
+}
+
+void StoreWrap::SetManyCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1 || args.Length() == 2, "1 or 2 arguments are required for \"setMany\".");
+    CHECK_ARG(isolate, args[0]->IsArray(), "Argument \"entries\" must be an array of [key, value] pairs.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+    napa::zone::SpanScope span(GetCallTrace(), "store", "setMany", store.GetId());
+
+    v8::Local<v8::Value> transferList;
+    uint32_t ttl = 0;
+    if (args.Length() == 2 && !ReadSetOptions(isolate, args[1], transferList, ttl)) {
+        return;
+    }
+
+    // All values are marshalled before any of them is set, so a failure leaves the store unchanged.
+    auto array = v8::Local<v8::Array>::Cast(args[0]);
+    napa::store::Store::EntryList entries;
+    entries.reserve(array->Length());
+    for (uint32_t i = 0; i < array->Length(); ++i) {
+        auto entry = array->Get(context, i);
+        RETURN_ON_PENDING_EXCEPTION(entry);
+        CHECK_ARG(isolate, entry.ToLocalChecked()->IsArray(), "Entry %u of \"entries\" must be a [key, value] pair.", i);
+
+        auto pair = v8::Local<v8::Array>::Cast(entry.ToLocalChecked());
+        auto key = pair->Get(context, 0);
+        RETURN_ON_PENDING_EXCEPTION(key);
+        CHECK_ARG(isolate, key.ToLocalChecked()->IsString(), "Key of entry %u of \"entries\" must be string.", i);
+
+        auto value = pair->Get(context, 1);
+        RETURN_ON_PENDING_EXCEPTION(value);
+
+        auto storeValue = MarshallStoreValue(store, value.ToLocalChecked(), transferList);
+        if (storeValue == nullptr) {
+            return;
+        }
+        entries.emplace_back(v8_helpers::V8ValueTo<std::string>(key.ToLocalChecked()), std::move(storeValue));
+    }
+
+    if (!transferList.IsEmpty()) {
+        napa::transport::Detach(transferList);
+    }
+
+    store.SetMany(entries, ttl);
+}
+
+void StoreWrap::PatchCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"patch\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument \"key\" must be string.");
+    CHECK_ARG(isolate, !args[1]->IsUndefined() && !args[1]->IsFunction(), "Argument \"patch\" must be JSON serializable.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+    napa::zone::SpanScope span(GetCallTrace(), "store", "patch", store.GetId());
+
+    auto patch = v8::JSON::Stringify(context, args[1]);
+    RETURN_ON_PENDING_EXCEPTION(patch);
+
+    auto key = v8_helpers::V8ValueTo<std::string>(args[0]);
+    JS_ENSURE(isolate,
+        store.Patch(key.c_str(), v8_helpers::V8ValueTo<std::u16string>(patch.ToLocalChecked())),
+        "Key \"%s\" doesn't hold a value that can be patched.", key.c_str());
 }
 
 void StoreWrap::GetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
@@ -68,18 +522,454 @@ void StoreWrap::GetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
 
     auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
     auto& store = thisObject->Get();
+    napa::zone::SpanScope span(GetCallTrace(), "store", "get", store.GetId());
+
+    auto value = GetValue(store, v8_helpers::V8ValueTo<std::string>(args[0]));
+    RETURN_ON_PENDING_EXCEPTION(value);
+
+    args.GetReturnValue().Set(value.ToLocalChecked());
+}
+
+void StoreWrap::SetLoaderCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() >= 2 && args.Length() <= 4, "2 to 4 arguments are required for \"setLoader\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument \"moduleName\" must be string.");
+    CHECK_ARG(isolate, args[1]->IsString(), "Argument \"functionName\" must be string.");
+    CHECK_ARG(isolate, args.Length() == 2 || args[2]->IsUndefined() || args[2]->IsUint32(),
+        "Argument \"ttl\" must be a non-negative integer of milliseconds.");
+    CHECK_ARG(isolate, args.Length() < 4 || args[3]->IsUndefined() || args[3]->IsUint32(),
+        "Argument \"waitTimeout\" must be a non-negative integer of milliseconds.");
+
+    auto functionName = v8_helpers::V8ValueTo<std::string>(args[1]);
+    CHECK_ARG(isolate, !functionName.empty(), "Argument \"functionName\" must not be empty.");
+
+    uint32_t ttl = 0;
+    if (args.Length() >= 3 && args[2]->IsUint32()) {
+        ttl = args[2]->Uint32Value(isolate->GetCurrentContext()).FromJust();
+    }
+
+    uint32_t waitTimeout = napa::store::DEFAULT_LOAD_WAIT_TIMEOUT;
+    if (args.Length() == 4 && args[3]->IsUint32()) {
+        waitTimeout = args[3]->Uint32Value(isolate->GetCurrentContext()).FromJust();
+    }
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    thisObject->Get().SetLoader(v8_helpers::V8ValueTo<std::string>(args[0]), functionName, ttl, waitTimeout);
+}
+
+namespace {
+
+    /// <summary> Ends the load of a key when the loader returns, throws or is terminated, so waiters never wait forever. </summary>
+    class LoadScope {
+    public:
+        LoadScope(napa::store::Store& store, std::string key) : _store(store), _key(std::move(key)) {
+            _error = "Loader of store \"" + std::string(store.GetId()) + "\" was terminated while loading \"" + _key + "\".";
+        }
+
+        ~LoadScope() {
+            _store.EndLoad(_key.c_str(), std::move(_value), _error);
+        }
+
+        void Succeed(std::shared_ptr<napa::store::Store::ValueType> value) {
+            _value = std::move(value);
+            _error.clear();
+        }
+
+        void Fail(std::string error) {
+            _error = std::move(error);
+        }
+
+    private:
+        napa::store::Store& _store;
+        std::string _key;
+        std::shared_ptr<napa::store::Store::ValueType> _value;
+        std::string _error;
+    };
+}
+
+void StoreWrap::GetOrLoadCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"_getOrLoad\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument \"key\" must be string.");
+    CHECK_ARG(isolate, args[1]->IsFunction(), "Argument \"loadFunction\" must be a function.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+    napa::zone::SpanScope span(GetCallTrace(), "store", "getOrLoad", store.GetId());
 
-    // Marshall value object into payload.
     auto key = v8_helpers::V8ValueTo<std::string>(args[0]);
     auto storeValue = store.Get(key.c_str());
-    if (storeValue != nullptr) {
-        auto value = napa::transport::Unmarshall(
-            v8_helpers::MakeExternalV8String(isolate, storeValue->payload), 
-            &(storeValue->transportContext));
+    if (storeValue == nullptr) {
+        std::string moduleName;
+        std::string functionName;
+        uint32_t ttl = 0;
+        JS_ENSURE(isolate, store.GetLoader(moduleName, functionName, ttl), "Store \"%s\" has no loader.", store.GetId());
+
+        std::string error;
+        auto status = store.BeginLoad(key.c_str(), storeValue, error);
+        JS_ENSURE(isolate, status != napa::store::Store::LoadStatus::REENTERED,
+            "Loader of store \"%s\" can't get \"%s\" it's loading.", store.GetId(), key.c_str());
+        JS_ENSURE(isolate, status != napa::store::Store::LoadStatus::CYCLE,
+            "Loader of store \"%s\" can't get \"%s\", whose loader waits for a key this one is loading.",
+            store.GetId(), key.c_str());
+        JS_ENSURE(isolate, status != napa::store::Store::LoadStatus::TIMEDOUT,
+            "Timed out waiting for the load of \"%s\" of store \"%s\".", key.c_str(), store.GetId());
+        JS_ENSURE(isolate, status != napa::store::Store::LoadStatus::FAILED, "%s", error.c_str());
+
+        if (status == napa::store::Store::LoadStatus::LOAD) {
+            LoadScope load(store, key);
+
+            // The key may have been loaded by another thread between the miss and the begin of this load.
+            storeValue = store.Get(key.c_str());
+            if (storeValue == nullptr) {
+                v8::TryCatch tryCatch(isolate);
+                v8::Local<v8::Value> loadArgv[] = {
+                    v8_helpers::MakeV8String(isolate, moduleName),
+                    v8_helpers::MakeV8String(isolate, functionName)
+                };
+                auto loader = v8::Local<v8::Function>::Cast(args[1])->Call(context, v8::Undefined(isolate), 2, loadArgv);
+
+                v8::MaybeLocal<v8::Value> result;
+                if (!loader.IsEmpty() && loader.ToLocalChecked()->IsFunction()) {
+                    v8::Local<v8::Value> argv[] = { args[0] };
+                    result = v8::Local<v8::Function>::Cast(loader.ToLocalChecked())->Call(context, v8::Undefined(isolate), 1, argv);
+                }
+
+                if (result.IsEmpty() || tryCatch.HasCaught()) {
+                    if (tryCatch.HasCaught() && !tryCatch.HasTerminated()) {
+                        load.Fail(v8_helpers::V8ValueTo<std::string>(tryCatch.Exception()));
+                        tryCatch.ReThrow();
+                    }
+                    return;
+                }
+
+                auto value = result.ToLocalChecked();
+                if (value->IsPromise()) {
+                    // Callers wait on their threads, a promise would have to settle on the thread of the loader.
+                    auto message = "Loader of store \"" + std::string(store.GetId()) + "\" must return the value, not a promise.";
+                    isolate->ThrowException(v8::Exception::TypeError(v8_helpers::MakeV8String(isolate, message)));
+                    load.Fail("TypeError: " + message);
+                    tryCatch.ReThrow();
+                    return;
+                }
 
+                if (!value->IsUndefined()) {
+                    storeValue = MarshallStoreValue(store, value, v8::Local<v8::Value>());
+                    if (storeValue == nullptr) {
+                        load.Fail(v8_helpers::V8ValueTo<std::string>(tryCatch.Exception()));
+                        tryCatch.ReThrow();
+                        return;
+                    }
+                    store.Set(key.c_str(), storeValue, ttl);
+                }
+            }
+            load.Succeed(storeValue);
+        }
+
+        if (storeValue == nullptr) {
+            args.GetReturnValue().SetUndefined();
+            return;
+        }
+    }
+
+    auto value = UnmarshallStoreValue(isolate, store, key, storeValue);
+    RETURN_ON_PENDING_EXCEPTION(value);
+
+    args.GetReturnValue().Set(value.ToLocalChecked());
+}
+
+v8::MaybeLocal<v8::Value> StoreWrap::GetValue(napa::store::Store& store, const std::string& key) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto storeValue = store.Get(key.c_str());
+    if (storeValue == nullptr) {
+        return v8::Local<v8::Value>(v8::Undefined(isolate));
+    }
+    return UnmarshallStoreValue(isolate, store, key, storeValue);
+}
+
+v8::MaybeLocal<v8::Value> StoreWrap::UnmarshallValue(
+    napa::store::Store& store,
+    const std::string& key,
+    const std::shared_ptr<napa::store::Store::ValueType>& storeValue) {
+    return UnmarshallStoreValue(v8::Isolate::GetCurrent(), store, key, storeValue);
+}
+
+void StoreWrap::ViewCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 0, "No argument is allowed for \"view\".");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto view = thisObject->_store->CreateView();
+    JS_ENSURE(isolate, view != nullptr, "Store \"%s\" in shared memory has no views.", thisObject->_store->GetId());
+
+    args.GetReturnValue().Set(StoreViewWrap::NewInstance(thisObject->_store, std::move(view)));
+}
+
+void StoreWrap::GetManyCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"getMany\".");
+    CHECK_ARG(isolate, args[0]->IsArray(), "Argument 'keys' must be an array of strings.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+    napa::zone::SpanScope span(GetCallTrace(), "store", "getMany", store.GetId());
+
+    auto array = v8::Local<v8::Array>::Cast(args[0]);
+    std::vector<std::string> keys;
+    keys.reserve(array->Length());
+    for (uint32_t i = 0; i < array->Length(); ++i) {
+        auto key = array->Get(context, i);
+        RETURN_ON_PENDING_EXCEPTION(key);
+        CHECK_ARG(isolate, key.ToLocalChecked()->IsString(), "Key %u of 'keys' must be string.", i);
+        keys.emplace_back(v8_helpers::V8ValueTo<std::string>(key.ToLocalChecked()));
+    }
+
+    auto storeValues = store.GetMany(keys);
+    auto values = v8::Array::New(isolate, static_cast<int>(keys.size()));
+    for (uint32_t i = 0; i < keys.size(); ++i) {
+        v8::Local<v8::Value> value = v8::Undefined(isolate);
+        if (storeValues[i] != nullptr) {
+            auto maybeValue = UnmarshallStoreValue(isolate, store, keys[i], storeValues[i]);
+            RETURN_ON_PENDING_EXCEPTION(maybeValue);
+            value = maybeValue.ToLocalChecked();
+        }
+        (void)values->Set(context, i, value);
+    }
+    args.GetReturnValue().Set(values);
+}
+
+void StoreWrap::KeysCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() <= 1, "0 or 1 argument are allowed for \"keys\".");
+    CHECK_ARG(isolate, args.Length() == 0 || args[0]->IsUndefined() || args[0]->IsString(), "Argument 'prefix' must be string.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto prefix = args.Length() == 1 && args[0]->IsString() ? v8_helpers::V8ValueTo<std::string>(args[0]) : std::string();
+
+    auto keys = thisObject->Get().Keys(prefix.c_str());
+    auto array = v8::Array::New(isolate, static_cast<int>(keys.size()));
+    for (uint32_t i = 0; i < keys.size(); ++i) {
+        (void)array->Set(context, i, v8_helpers::MakeV8String(isolate, keys[i]));
+    }
+    args.GetReturnValue().Set(array);
+}
+
+void StoreWrap::RangeCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1 || args.Length() == 2, "1 or 2 arguments are required for \"range\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'from' must be string.");
+    CHECK_ARG(isolate, args.Length() == 1 || args[1]->IsUndefined() || args[1]->IsString(), "Argument 'to' must be string.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+    auto from = v8_helpers::V8ValueTo<std::string>(args[0]);
+    auto to = args.Length() == 2 && args[1]->IsString() ? v8_helpers::V8ValueTo<std::string>(args[1]) : std::string();
+
+    auto entries = store.Range(from.c_str(), to.c_str());
+    auto array = v8::Array::New(isolate, static_cast<int>(entries.size()));
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+        auto value = UnmarshallStoreValue(isolate, store, entries[i].first, entries[i].second);
         RETURN_ON_PENDING_EXCEPTION(value);
-        args.GetReturnValue().Set(value.ToLocalChecked());
+
+        auto pair = v8::Array::New(isolate, 2);
+        (void)pair->Set(context, 0, v8_helpers::MakeV8String(isolate, entries[i].first));
+        (void)pair->Set(context, 1, value.ToLocalChecked());
+        (void)array->Set(context, i, pair);
     }
+    args.GetReturnValue().Set(array);
+}
+
+void StoreWrap::IncrementCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1 || args.Length() == 2, "1 or 2 arguments are required for \"increment\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'key' must be string.");
+    CHECK_ARG(isolate, args.Length() == 1 || args[1]->IsUndefined() || args[1]->IsNumber(), "Argument 'delta' must be an integer.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+
+    int64_t delta = 1;
+    if (args.Length() == 2 && args[1]->IsNumber()) {
+        auto number = args[1]->NumberValue(context).FromJust();
+        CHECK_ARG(isolate, std::trunc(number) == number, "Argument 'delta' must be an integer.");
+        delta = args[1]->IntegerValue(context).FromJust();
+    }
+
+    auto key = v8_helpers::V8ValueTo<std::string>(args[0]);
+    int64_t result = 0;
+    JS_ENSURE(isolate, store.Increment(key.c_str(), delta, result), "Key \"%s\" doesn't hold an integer number.", key.c_str());
+
+    args.GetReturnValue().Set(static_cast<double>(result));
+}
+
+void StoreWrap::AddCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"add\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'key' must be string.");
+    CHECK_ARG(isolate, args[1]->IsNumber(), "Argument 'delta' must be a number.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+
+    auto key = v8_helpers::V8ValueTo<std::string>(args[0]);
+    double result = 0;
+    JS_ENSURE(isolate,
+        store.Add(key.c_str(), args[1]->NumberValue(context).FromJust(), result),
+        "Key \"%s\" doesn't hold a number, or holds an integer number that 'delta' is not.", key.c_str());
+
+    args.GetReturnValue().Set(result);
+}
+
+void StoreWrap::CompareAndSetCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 3, "3 arguments are required for \"compareAndSet\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'key' must be string.");
+    CHECK_ARG(isolate, args[1]->IsNumber(), "Argument 'expected' must be a number.");
+    CHECK_ARG(isolate, args[2]->IsNumber(), "Argument 'desired' must be a number.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+
+    args.GetReturnValue().Set(store.CompareAndSet(
+        v8_helpers::V8ValueTo<std::string>(args[0]).c_str(),
+        args[1]->NumberValue(context).FromJust(),
+        args[2]->NumberValue(context).FromJust()));
+}
+
+void StoreWrap::GetNumberCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"getNumber\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'key' must be string.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+
+    double value = 0;
+    if (store.GetNumber(v8_helpers::V8ValueTo<std::string>(args[0]).c_str(), value)) {
+        args.GetReturnValue().Set(value);
+    }
+}
+
+void StoreWrap::SnapshotCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"snapshot\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'path' must be string.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+
+    auto path = v8_helpers::V8ValueTo<std::string>(args[0]);
+    size_t saved = 0;
+    JS_ENSURE(isolate, store.Snapshot(path.c_str(), saved), "Failed to write snapshot of store \"%s\" to \"%s\".", store.GetId(), path.c_str());
+
+    args.GetReturnValue().Set(static_cast<double>(saved));
+}
+
+void StoreWrap::LoadCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"load\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'path' must be string.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+
+    auto path = v8_helpers::V8ValueTo<std::string>(args[0]);
+    size_t loaded = 0;
+    JS_ENSURE(isolate, store.Load(path.c_str(), loaded), "Failed to load store \"%s\" from snapshot \"%s\".", store.GetId(), path.c_str());
+
+    args.GetReturnValue().Set(static_cast<double>(loaded));
+}
+
+void StoreWrap::WatchCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"watch\".");
+    CHECK_ARG(isolate, args[0]->IsString(), "Argument 'pattern' must be string.");
+    CHECK_ARG(isolate, args[1]->IsFunction(), "Argument 'callback' must be a function.");
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+
+    auto watch = std::make_shared<StoreWatch>();
+    watch->store = thisObject->_store;
+
+    // The store holds the watch weakly, an unwatched watch is freed once its pending work is done.
+    std::weak_ptr<StoreWatch> weakWatch = watch;
+    watch->id = watch->store->Watch(
+        v8_helpers::V8ValueTo<std::string>(args[0]).c_str(),
+        [weakWatch](const std::string& key) {
+            if (auto watch = weakWatch.lock()) {
+                NotifyWatch(watch, key);
+            }
+        });
+
+    GetCurrentWatches()[watch->id] = watch;
+    ArmWatch(watch, v8::Local<v8::Function>::Cast(args[1]));
+
+    args.GetReturnValue().Set(static_cast<double>(watch->id));
+}
+
+void StoreWrap::UnwatchCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument are required for \"unwatch\".");
+    CHECK_ARG(isolate, args[0]->IsNumber(), "Argument 'watchId' must be a number.");
+
+    // Watches are stopped by the isolate that created them, since their callbacks belong to it.
+    auto& watches = GetCurrentWatches();
+    auto it = watches.find(static_cast<uint64_t>(args[0]->NumberValue(isolate->GetCurrentContext()).FromJust()));
+    if (it == watches.end()) {
+        args.GetReturnValue().Set(false);
+        return;
+    }
+
+    auto watch = std::move(it->second);
+    watches.erase(it);
+    watch->store->Unwatch(watch->id);
+
+    // Complete the armed work, so it lets the worker go.
+    std::function<void(void*)> complete;
+    {
+        std::lock_guard<std::mutex> lock(watch->lock);
+        watch->active = false;
+        complete.swap(watch->complete);
+    }
+    if (complete) {
+        complete(nullptr);
+    }
+    args.GetReturnValue().Set(true);
 }
 
 void StoreWrap::HasCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
@@ -128,3 +1018,13 @@ void StoreWrap::GetSizeCallback(v8::Local<v8::String>, const v8::PropertyCallbac
     args.GetReturnValue().Set(static_cast<uint32_t>(store.Size()));
 }
 
+void StoreWrap::GetByteSizeCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    auto thisObject = NAPA_OBJECTWRAP::Unwrap<StoreWrap>(args.Holder());
+    auto& store = thisObject->Get();
+
+    args.GetReturnValue().Set(static_cast<double>(store.GetStatistics().bytes));
+}
+
@@ -23,6 +23,23 @@ namespace module {
         /// <summary> Get napa::store::Store from wrap. </summary>
         napa::store::Store& Get();
 
+        /// <summary> Get the value of a key as Store.get does, from the value cache of the current isolate for frozen stores. </summary>
+        /// <returns> Undefined if the key doesn't exist, or empty with an exception thrown if the value can't be unmarshalled. </returns>
+        static v8::MaybeLocal<v8::Value> GetValue(napa::store::Store& store, const std::string& key);
+
+        /// <summary> Unmarshall a value of a key as Store.get does, from the value cache of the current isolate for frozen stores. </summary>
+        /// <returns> The value, or empty with an exception thrown if the value can't be unmarshalled. </returns>
+        static v8::MaybeLocal<v8::Value> UnmarshallValue(
+            napa::store::Store& store,
+            const std::string& key,
+            const std::shared_ptr<napa::store::Store::ValueType>& storeValue);
+
+        /// <summary> Exported class name. </summary>
+        static constexpr const char* exportName = "StoreWrap";
+
+        /// <summary> Declare constructor in public, so napajs/lib/store/store-reference.ts can add Store.ref to its prototype. </summary>
+        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
+
     private:
         /// <summary> Default constructor. </summary>
         StoreWrap() = default;
@@ -31,12 +48,63 @@ namespace module {
         StoreWrap(const StoreWrap&) = delete;
         StoreWrap& operator=(const StoreWrap&) = delete;
 
-        /// <summary> It implements Store.set(key: string, value: any): void </summary>
+        /// <summary> It implements Store.set(key: string, value: any, transferList?: ArrayBuffer[] | SetOptions): void </summary>
         static void SetCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+        /// <summary> It implements Store.setMany(entries: [string, any][], transferList?: ArrayBuffer[] | SetOptions): void </summary>
+        static void SetManyCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.patch(key: string, patch: any): void </summary>
+        static void PatchCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.view(): StoreView </summary>
+        static void ViewCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.setLoader(moduleName: string, functionName: string, ttl?: number): void </summary>
+        static void SetLoaderCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary>
+        /// It implements Store.getOrLoad(key: string): any, with the function that loads the loader from napajs/lib/store/store-loader.ts:
+        ///     _getOrLoad(key: string, loadFunction: (moduleName: string, functionName: string) => Function): any
+        /// </summary>
+        static void GetOrLoadCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
         /// <summary> It implements Store.get(key: string): any </summary>
         static void GetCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+        /// <summary> It implements Store.getMany(keys: string[]): any[] </summary>
+        static void GetManyCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.keys(prefix?: string): string[] </summary>
+        static void KeysCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.range(from: string, to?: string): [string, any][] </summary>
+        static void RangeCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.increment(key: string, delta?: number): number </summary>
+        static void IncrementCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.add(key: string, delta: number): number </summary>
+        static void AddCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.compareAndSet(key: string, expected: number, desired: number): boolean </summary>
+        static void CompareAndSetCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.getNumber(key: string): number </summary>
+        static void GetNumberCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.snapshot(path: string): number </summary>
+        static void SnapshotCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.load(path: string): number </summary>
+        static void LoadCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.watch(pattern: string, callback: (key: string) => void): number </summary>
+        static void WatchCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.unwatch(watchId: number): boolean </summary>
+        static void UnwatchCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
         /// <summary> It implements Store.has(key: string): boolean </summary>
         static void HasCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
 
@@ -48,6 +116,9 @@ namespace module {
 
         /// <summary> It implements Store.size </summary>
         static void GetSizeCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args);
+
+        /// <summary> It implements Store.byteSize </summary>
+        static void GetByteSizeCallback(v8::Local<v8::String>, const v8::PropertyCallbackInfo<v8::Value>& args);
         
         /// <summary> Friend default constructor callback. </summary>
         template <typename T>
@@ -56,12 +127,6 @@ namespace module {
         template <typename T>
         friend v8::MaybeLocal<v8::Object> napa::module::NewInstance(int argc, v8::Local<v8::Value> argv[]);
 
-        /// <summary> Exported class name. </summary>
-        static constexpr const char* exportName = "StoreWrap";
-
-        /// <summary> Hid constructor from public access. </summary>
-        NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
-
         /// <summary> Store. </summary>
         std::shared_ptr<napa::store::Store> _store;
     };
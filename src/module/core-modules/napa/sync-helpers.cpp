@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "sync-helpers.h"
+
+#include <vector>
+
+using namespace napa::module;
+
+bool sync_helpers::CheckGuardArguments(const v8::FunctionCallbackInfo<v8::Value>& args, const char* methodName) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    CHECK_ARG_WITH_RETURN(isolate, args.Length() >= 1, false, "1 argument is required for calling '%s'.", methodName);
+    CHECK_ARG_WITH_RETURN(isolate, args[0]->IsFunction(), false, "Argument \"func\" shall be 'Function' type.");
+    CHECK_ARG_WITH_RETURN(isolate,
+        args.Length() < 2 || args[1]->IsUndefined() || args[1]->IsArray(),
+        false,
+        "Argument \"params\" shall be a valid array.");
+    return true;
+}
+
+bool sync_helpers::GetTimeoutArgument(
+    const v8::FunctionCallbackInfo<v8::Value>& args,
+    int index,
+    bool& hasTimeout,
+    std::chrono::milliseconds& timeout) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    hasTimeout = args.Length() > index && !args[index]->IsUndefined();
+    if (hasTimeout) {
+        CHECK_ARG_WITH_RETURN(isolate, args[index]->IsNumber(), false, "Argument \"timeoutInMs\" shall be a number.");
+
+        auto value = args[index]->NumberValue(isolate->GetCurrentContext()).FromJust();
+        CHECK_ARG_WITH_RETURN(isolate, value >= 0, false, "Argument \"timeoutInMs\" shall be non-negative.");
+        timeout = std::chrono::milliseconds(static_cast<int64_t>(value));
+    }
+    return true;
+}
+
+void sync_helpers::CallGuardedFunction(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    std::vector<v8::Local<v8::Value>> params;
+    if (args.Length() >= 2 && args[1]->IsArray()) {
+        auto paramsArray = v8::Local<v8::Array>::Cast(args[1]);
+        int paramsLength = paramsArray->Length();
+        params.reserve(paramsLength);
+
+        for (int i = 0; i < paramsLength; i++) {
+            auto item = paramsArray->Get(context, i).ToLocalChecked();
+            params.emplace_back(item);
+        }
+    }
+
+    v8::TryCatch tryCatch(isolate);
+    auto result = v8::Local<v8::Function>::Cast(args[0])->Call(
+        context,
+        args.Holder(),
+        static_cast<int>(params.size()),
+        params.empty() ? nullptr : params.data());
+
+    if (result.IsEmpty() || tryCatch.HasCaught()) {
+        tryCatch.ReThrow();
+    } else {
+        args.GetReturnValue().Set(result.ToLocalChecked());
+    }
+}
+
+namespace {
+
+    void SettleCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+        auto context = isolate->GetCurrentContext();
+
+        auto resolver = v8::Local<v8::Promise::Resolver>::Cast(args.Data());
+        if (args[0]->IsTrue()) {
+            (void)resolver->Resolve(context, args[1]);
+        } else {
+            (void)resolver->Reject(context, args[1]);
+        }
+    }
+}
+
+v8::Local<v8::Function> sync_helpers::MakeSettleFunction(
+    v8::Local<v8::Context> context,
+    v8::Local<v8::Promise::Resolver> resolver) {
+    return v8::Function::New(context, SettleCallback, resolver).ToLocalChecked();
+}
+
+void sync_helpers::Settle(v8::Local<v8::Function> settle, bool fulfilled, v8::Local<v8::Value> value) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    v8::Local<v8::Value> argv[] = { v8::Boolean::New(isolate, fulfilled), value };
+    (void)settle->Call(context, context->Global(), 2, argv);
+}
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/module.h>
+
+#include <chrono>
+
+namespace napa {
+namespace module {
+
+    namespace sync_helpers {
+
+        /// <summary> Checks the 'func' and 'params' arguments of a guard method, throws in JS if they are invalid. </summary>
+        /// <param name="args"> Guard method arguments, 'func' and 'params' come first. </param>
+        /// <param name="methodName"> Guard method name used in error messages. </param>
+        /// <returns> True if arguments are valid. </returns>
+        bool CheckGuardArguments(const v8::FunctionCallbackInfo<v8::Value>& args, const char* methodName);
+
+        /// <summary> Reads the optional 'timeoutInMs' argument of a guard method, throws in JS if it is invalid. </summary>
+        /// <param name="args"> Guard method arguments. </param>
+        /// <param name="index"> Index of the argument. </param>
+        /// <param name="hasTimeout"> Set to true if the argument is present. </param>
+        /// <param name="timeout"> Set to the timeout if the argument is present. </param>
+        /// <returns> True if the argument is absent or valid. </returns>
+        bool GetTimeoutArgument(
+            const v8::FunctionCallbackInfo<v8::Value>& args,
+            int index,
+            bool& hasTimeout,
+            std::chrono::milliseconds& timeout);
+
+        /// <summary> Calls 'func' with 'params' while the caller holds the lock, returns or rethrows what 'func' does. </summary>
+        /// <param name="args"> Guard method arguments, checked by CheckGuardArguments. </param>
+        void CallGuardedFunction(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+        /// <summary> Makes a function that settles a promise, called with (true, value) to resolve or (false, reason) to reject. </summary>
+        /// <remarks> It serves as the Javascript callback of asynchronous waits of napa.sync objects. </remarks>
+        v8::Local<v8::Function> MakeSettleFunction(v8::Local<v8::Context> context, v8::Local<v8::Promise::Resolver> resolver);
+
+        /// <summary> Calls a function made by MakeSettleFunction. </summary>
+        /// <param name="settle"> The settle function. </param>
+        /// <param name="fulfilled"> True to resolve the promise, false to reject it. </param>
+        /// <param name="value"> The value to resolve with, or the reason to reject with. </param>
+        void Settle(v8::Local<v8::Function> settle, bool fulfilled, v8::Local<v8::Value> value);
+    }
+}
+}
@@ -16,6 +16,7 @@
 #include <zone/worker.h>
 #include <zone/scheduler.h>
 #include <zone/worker-context.h>
+#include <zone/worker-timers.h>
 #include <zone/async-context.h>
 #include <zone/task.h>
 
@@ -64,6 +65,9 @@ namespace zone {
             _callback();
         }
 
+        /// <summary> Overrides Task.Reject, timers of a worker that stopped don't fire. </summary>
+        virtual void Reject(napa::ResultCode /*code*/, const std::string& /*reason*/) override {}
+
     private:
         Callback _callback;
     };
@@ -103,62 +107,99 @@ napa::zone::Timer& TimerWrap::Get() {
 static void EmptyWeakCallback(const v8::WeakCallbackInfo<int>& data) {
 }
 
+/// <summary> Runs the callback of an active timeout, returns true if it's an interval to re-arm. </summary>
+static bool RunTimeout(Isolate* isolate, Local<Context> context, Local<Object> timeout) {
+    Local<Boolean> active = Local<Boolean>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_active")));
+    if (!active->Value()) {
+        return false;
+    }
+
+    Local<Function> cb = Local<Function>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_callback")));
+    Local<Array> args = Local<Array>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_args")));
+    
+    std::vector<Local<Value>> parameters;
+    parameters.reserve(args->Length());
+    for (int i = 0; i < static_cast<int>(args->Length()); ++i) {
+        Local<Value> v = args->Get(context, i).ToLocalChecked();
+        parameters.emplace_back(v);
+    }
+    cb->Call(context, context->Global(), static_cast<int>(parameters.size()), parameters.data());
+
+    Local<Number> interval = Local<Number>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_repeat")));
+    return interval->Value() >= 1;
+}
+
+/// <summary> Releases the handles of a timeout that doesn't run again. </summary>
+static void DestroyTimeout(
+        const std::shared_ptr<Persistent<Object>>& sharedTimeout,
+        const std::shared_ptr<Persistent<Context>>& sharedContext,
+        const std::function<void(void)>& onDestroy)
+{
+    if (!sharedTimeout->IsEmpty()) {
+        sharedTimeout->SetWeak((int*)nullptr, EmptyWeakCallback, v8::WeakCallbackType::kParameter);
+        sharedTimeout->Reset();
+    }
+    if (!sharedContext->IsEmpty()) {
+        sharedContext->SetWeak((int*)nullptr, EmptyWeakCallback, v8::WeakCallbackType::kParameter);
+        sharedContext->Reset();
+    }
+    onDestroy();
+}
+
 std::shared_ptr<napa::zone::CallbackTask> buildTimeoutTask(
         std::shared_ptr<Persistent<Object>> sharedTimeout,
-        std::shared_ptr<Persistent<Context>> sharedContext)
+        std::shared_ptr<Persistent<Context>> sharedContext,
+        std::function<void(void)> onDestroy)
 {
     return std::make_shared<napa::zone::CallbackTask>(
-        [sharedTimeout, sharedContext]() {
+        [sharedTimeout, sharedContext, onDestroy]() {
             auto isolate = Isolate::GetCurrent();
             HandleScope handleScope(isolate);
             auto context = Local<Context>::New(isolate, *sharedContext);
             Context::Scope contextScope(context);
 
             auto timeout = Local<Object>::New(isolate, *sharedTimeout);
-
-            bool needDestroy = true;
-            Local<Boolean> active = Local<Boolean>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_active")));
-            if (active->Value()) {
-                Local<Function> cb = Local<Function>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_callback")));
-                Local<Array> args = Local<Array>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_args")));
-                
-                std::vector<Local<Value>> parameters;
-                parameters.reserve(args->Length());
-                for (int i = 0; i < static_cast<int>(args->Length()); ++i) {
-                    Local<Value> v = args->Get(context, i).ToLocalChecked();
-                    parameters.emplace_back(v);
-                }
-                cb->Call(context, context->Global(), static_cast<int>(parameters.size()), parameters.data());
-
-                Local<Number> interval = Local<Number>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_repeat")));
-                bool isInterval = (interval->Value() >= 1);
-                if (isInterval) {
-                    auto jsTimer = NAPA_OBJECTWRAP::Unwrap<TimerWrap>(
-                        Local<Object>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_timer"))));
-
-                    //Re-arm the interval timer in napa's timer schedule thread.
-                    jsTimer->Get().Start();
-
-                    // If not interval timer, global v8 handle for Timeout and Context will be SetWeak.
-                    // Otherwise keep holding the hanle as they will be used some time later.
-                    needDestroy = false;
-                }
-            }
-
-            if (needDestroy) {
-                if (!sharedTimeout->IsEmpty()) {
-                    sharedTimeout->SetWeak((int*)nullptr, EmptyWeakCallback, v8::WeakCallbackType::kParameter);
-                    sharedTimeout->Reset();
-                }
-                if (!sharedContext->IsEmpty()) {
-                    sharedContext->SetWeak((int*)nullptr, EmptyWeakCallback, v8::WeakCallbackType::kParameter);
-                    sharedContext->Reset();
-                }
+            if (RunTimeout(isolate, context, timeout)) {
+                auto jsTimer = NAPA_OBJECTWRAP::Unwrap<TimerWrap>(
+                    Local<Object>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_timer"))));
+
+                // Re-arm the interval timer in napa's timer schedule thread.
+                // The handles for Timeout and Context are kept as they will be used some time later.
+                jsTimer->Get().Start();
+                return;
             }
+            DestroyTimeout(sharedTimeout, sharedContext, onDestroy);
         }
     );
 }
 
+/// <summary> Starts a timeout in the timers of the current worker, which fires it between tasks. </summary>
+static void StartWorkerTimeout(
+        napa::zone::WorkerTimers& timers,
+        std::chrono::milliseconds after,
+        std::shared_ptr<Persistent<Object>> sharedTimeout,
+        std::shared_ptr<Persistent<Context>> sharedContext,
+        std::function<void(void)> onDestroy)
+{
+    auto isolate = Isolate::GetCurrent();
+    auto timeout = Local<Object>::New(isolate, *sharedTimeout);
+    auto repeat = Local<Number>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_repeat")));
+
+    timers.Add([&timers, after, sharedTimeout, sharedContext, onDestroy]() {
+        auto isolate = Isolate::GetCurrent();
+        HandleScope handleScope(isolate);
+        auto context = Local<Context>::New(isolate, *sharedContext);
+        Context::Scope contextScope(context);
+
+        auto timeout = Local<Object>::New(isolate, *sharedTimeout);
+        if (RunTimeout(isolate, context, timeout)) {
+            StartWorkerTimeout(timers, after, sharedTimeout, sharedContext, onDestroy);
+            return;
+        }
+        DestroyTimeout(sharedTimeout, sharedContext, onDestroy);
+    }, after, repeat->Value() >= 1);
+}
+
 void TimerWrap::SetImmediateCallback(const FunctionCallbackInfo<Value>& args) {
     auto isolate = Isolate::GetCurrent();
     HandleScope scope(isolate);
@@ -181,10 +222,15 @@ void TimerWrap::SetImmediateCallback(const FunctionCallbackInfo<Value>& args) {
     auto context = isolate->GetCurrentContext();
     auto sharedContext = std::make_shared<Persistent<Context>>(isolate, context);
 
-    auto immediateCallbackTask = buildTimeoutTask(sharedTimeout, sharedContext);
-
     auto workerId = static_cast<WorkerId>(
         reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
+
+    // The callback is pinned to this worker, keep it running until the callback is done.
+    scheduler->RetainWorker(workerId);
+    auto immediateCallbackTask = buildTimeoutTask(sharedTimeout, sharedContext, [scheduler, workerId]() {
+        scheduler->ReleaseWorker(workerId);
+    });
+
     scheduler->ScheduleOnWorker(workerId, immediateCallbackTask, SchedulePhase::ImmediatePhase);
 }
 
@@ -213,13 +259,29 @@ void TimerWrap::SetTimersCallback(const FunctionCallbackInfo<Value>& args) {
     auto context = isolate->GetCurrentContext();
     auto sharedContext = std::make_shared<Persistent<Context>>(isolate, context);
 
+    // The callback is pinned to this worker, keep it running until the timer is done.
+    // A cleared timer still fires and releases the worker, since clearing only deactivates the timeout.
+    scheduler->RetainWorker(workerId);
+
     Local<Number> after = Local<Number>::Cast(timeout->Get(String::NewFromUtf8(isolate, "_after")));
     std::chrono::milliseconds msAfter{static_cast<int>(after->Value())};
+
+    // Napa workers fire their timers themselves without a round trip through the timer threads and the scheduler.
+    auto workerTimers = napa::zone::WorkerTimers::GetCurrent();
+    if (workerTimers != nullptr) {
+        StartWorkerTimeout(*workerTimers, msAfter, sharedTimeout, sharedContext, [scheduler, workerId]() {
+            scheduler->ReleaseWorker(workerId);
+        });
+        return;
+    }
+
     auto sharedTimer = std::make_shared<napa::zone::Timer>(
         [sharedTimeout, sharedContext, scheduler, workerId]() {
-            auto timerCallbackTask = buildTimeoutTask(sharedTimeout, sharedContext);
+            auto timerCallbackTask = buildTimeoutTask(sharedTimeout, sharedContext, [scheduler, workerId]() {
+                scheduler->ReleaseWorker(workerId);
+            });
             scheduler->ScheduleOnWorker(workerId, timerCallbackTask, SchedulePhase::DefaultPhase);
-        }, msAfter);
+        }, msAfter, std::chrono::milliseconds(zone->GetSettings().timerSlack));
 
     auto jsTimer = TimerWrap::NewInstance(sharedTimer);
     timeout->Set(String::NewFromUtf8(isolate, "_timer"), jsTimer);
@@ -5,6 +5,7 @@
 
 #include <napa/module/shareable-wrap.h>
 #include <napa/module/binding/wraps.h>
+#include <napa/log.h>
 
 using namespace napa;
 using namespace napa::transport;
@@ -38,6 +39,11 @@ TransportContext* TransportContextWrapImpl::Get() {
     return _context;
 }
 
+void TransportContextWrapImpl::Reset(TransportContext* context) {
+    NAPA_ASSERT(!_owning, "Only a non-owning transport context wrap can be re-pointed");
+    _context = context;
+}
+
 void TransportContextWrapImpl::Init() {
     auto isolate = v8::Isolate::GetCurrent();
     auto constructorTemplate = v8::FunctionTemplate::New(isolate, TransportContextWrapImpl::ConstructorCallback);
@@ -99,7 +105,7 @@ void TransportContextWrapImpl::SaveSharedCallback(const v8::FunctionCallbackInfo
 
     auto thisObject = NAPA_OBJECTWRAP::Unwrap<TransportContextWrap>(args.Holder());
     auto sharedWrap = NAPA_OBJECTWRAP::Unwrap<ShareableWrap>(v8::Local<v8::Object>::Cast(args[0]));
-    thisObject->Get()->SaveShared(sharedWrap->Get<void>());
+    thisObject->Get()->SaveShared(sharedWrap->Get<void>(), sharedWrap->GetExternalSize());
 }
 
 void TransportContextWrapImpl::LoadSharedCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
@@ -114,5 +120,6 @@ void TransportContextWrapImpl::LoadSharedCallback(const v8::FunctionCallbackInfo
     auto thisObject = NAPA_OBJECTWRAP::Unwrap<TransportContextWrap>(args.Holder());
     auto object = thisObject->Get()->LoadShared<void>(result.first);
 
-    args.GetReturnValue().Set(binding::CreateShareableWrap(object));
+    args.GetReturnValue().Set(binding::CreateShareableWrap(
+        object, "SharedPtrWrap", thisObject->Get()->GetExternalSize(result.first)));
 }
@@ -25,6 +25,9 @@ namespace module {
         /// <summary> Get transport context. </summary>
         napa::transport::TransportContext* Get() override;
 
+        /// <summary> Point a non-owning wrap to another transport context. </summary>
+        void Reset(napa::transport::TransportContext* context);
+
         /// <summary> Declare constructor in public, so we can export class constructor to JavaScript world. </summary>
         NAPA_DECLARE_PERSISTENT_CONSTRUCTOR();
 
@@ -9,8 +9,18 @@
 #include <napa/assert.h>
 #include <napa/async.h>
 #include <napa/v8-helpers.h>
+#include <utils/hash.h>
+#include <utils/payload-compression.h>
+#include <zone/span-recorder.h>
+#include <zone/task-graph.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 #include <vector>
 
 using namespace napa::module;
@@ -18,10 +28,36 @@ using namespace napa::v8_helpers;
 
 NAPA_DEFINE_PERSISTENT_CONSTRUCTOR(ZoneWrap);
 
+/// <summary> A function call of a pipeline, with the zone it runs on. </summary>
+struct PipelineStage {
+    std::unique_ptr<napa::Zone> zone;
+    std::string module;
+    std::string function;
+    napa::CallOptions options;
+};
+using Pipeline = std::vector<PipelineStage>;
+
 // Forward declaration.
-static v8::Local<v8::Object> CreateResponseObject(const napa::Result& result);
+static void ExecutePipelineStage(
+    std::shared_ptr<Pipeline> pipeline,
+    size_t index,
+    std::vector<std::string> arguments,
+    std::unique_ptr<napa::transport::TransportContext> transportContext,
+    std::function<void(napa::Result)> complete);
+static v8::Local<v8::Object> CreateResponseObject(const napa::Result& result, napa::TransportOption transport = AUTO);
+static v8::Local<v8::Object> CreateHeapStatisticsObject(const napa::HeapStatistics& statistics);
+static v8::Local<v8::Object> CreateWorkerStatsObject(const napa::WorkerStats& stats);
+static v8::Local<v8::Object> CreateTenantStatsObject(const napa::TenantStats& stats);
+static v8::Local<v8::Object> CreateFunctionCountersObject(const napa::FunctionCounters& counters);
+static v8::Local<v8::Object> CreateFunctionStatsObject(const napa::FunctionStats& stats);
+static void ReadArguments(v8::Local<v8::Array> array, std::vector<std::string>& arguments);
 template <typename Func>
 static void CreateRequestAndExecute(v8::Local<v8::Object> obj, Func&& func);
+template <typename Func>
+static void CreateBatchRequestAndExecute(v8::Local<v8::Object> obj, Func&& func);
+static uint64_t ParseRoutingKey(v8::Local<v8::Value> value);
+static uint64_t ParseCancellationToken(v8::Local<v8::Value> value);
+static bool ParseTraceContext(v8::Local<v8::Value> value, napa::CallOptions& options);
 
 void ZoneWrap::Init() {
     auto isolate = v8::Isolate::GetCurrent();
@@ -33,10 +69,27 @@ void ZoneWrap::Init() {
 
     // Prototypes.
     NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "getId", GetId);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "getQueueLength", GetQueueLength);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "getWorkerCount", GetWorkerCount);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "cancel", Cancel);
     NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "broadcast", Broadcast);
     NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "broadcastSync", BroadcastSync);
     NODE_SET_PROTOTYPE_METHOD(functionTemplate, "execute", Execute);
     NODE_SET_PROTOTYPE_METHOD(functionTemplate, "executeSync", ExecuteSync);
+    NODE_SET_PROTOTYPE_METHOD(functionTemplate, "executeOnWorker", ExecuteOnWorker);
+    NODE_SET_PROTOTYPE_METHOD(functionTemplate, "executeBatch", ExecuteBatch);
+    NODE_SET_PROTOTYPE_METHOD(functionTemplate, "pipe", Pipe);
+    NODE_SET_PROTOTYPE_METHOD(functionTemplate, "runGraph", RunGraph);
+    NODE_SET_PROTOTYPE_METHOD(functionTemplate, "parallelFor", ParallelFor);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "getHeapStatistics", GetHeapStatistics);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "getStats", GetStats);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "getFunctionStats", GetFunctionStats);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "notifyMemoryPressure", NotifyMemoryPressure);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "startProfiling", StartProfiling);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "stopProfiling", StopProfiling);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "recycle", Recycle);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "serve", Serve);
+    NAPA_SET_PROTOTYPE_METHOD(functionTemplate, "serveSharedMemory", ServeSharedMemory);
 
     // Set persistent constructor into V8.
     NAPA_SET_PERSISTENT_CONSTRUCTOR(exportName, functionTemplate->GetFunction());
@@ -62,20 +115,58 @@ void ZoneWrap::GetId(const v8::FunctionCallbackInfo<v8::Value>& args) {
     args.GetReturnValue().Set(MakeV8String(isolate, wrap->_zoneProxy->GetId()));
 }
 
+void ZoneWrap::GetQueueLength(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+
+    args.GetReturnValue().Set(v8::Number::New(isolate, static_cast<double>(wrap->_zoneProxy->GetQueueLength())));
+}
+
+void ZoneWrap::GetWorkerCount(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+
+    args.GetReturnValue().Set(v8::Uint32::NewFromUnsigned(isolate, wrap->_zoneProxy->GetWorkerCount()));
+}
+
+void ZoneWrap::Cancel(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    CHECK_ARG(isolate, args.Length() == 1, "1 argument is required for \"cancel\".");
+    CHECK_ARG(isolate, args[0]->IsNumber() || args[0]->IsObject(), "the cancellation token must be a number or a CancellationToken.");
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+    wrap->_zoneProxy->Cancel(ParseCancellationToken(args[0]));
+}
+
 void ZoneWrap::Broadcast(const v8::FunctionCallbackInfo<v8::Value>& args) {
     auto isolate = v8::Isolate::GetCurrent();
 
     CHECK_ARG(isolate, args[0]->IsObject(), "first argument to zone.broadcast must be the function spec object");
     CHECK_ARG(isolate, args[1]->IsFunction(), "second argument to zone.broadcast must be the callback");
-    
-    v8::String::Utf8Value source(args[0]->ToString());
+    CHECK_ARG(isolate, args.Length() < 3 || args[2]->IsUndefined() || args[2]->IsArray(), "third argument to zone.broadcast must be an array of worker ids");
+
+    // Worker ids are optional, all workers run the broadcast without them.
+    std::vector<uint32_t> workerIds;
+    if (args.Length() > 2 && args[2]->IsArray()) {
+        auto context = isolate->GetCurrentContext();
+        auto array = v8::Local<v8::Array>::Cast(args[2]);
+        workerIds.reserve(array->Length());
+        for (uint32_t i = 0; i < array->Length(); i++) {
+            auto workerId = array->Get(context, i).ToLocalChecked();
+            CHECK_ARG(isolate, workerId->IsUint32(), "worker ids must be unsigned integers.");
+            workerIds.emplace_back(workerId->Uint32Value(context).FromJust());
+        }
+    }
 
     napa::zone::DoAsyncWork(v8::Local<v8::Function>::Cast(args[1]),
-        [&args](std::function<void(void*)> complete) {
-            CreateRequestAndExecute(args[0]->ToObject(), [&args, &complete](const napa::FunctionSpec& spec) {
+        [&args, &workerIds](std::function<void(void*)> complete) {
+            CreateRequestAndExecute(args[0]->ToObject(), [&args, &complete, &workerIds](const napa::FunctionSpec& spec) {
                 auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
 
-                wrap->_zoneProxy->Broadcast(spec, [complete = std::move(complete)](napa::Result result) {
+                wrap->_zoneProxy->Broadcast(spec, workerIds, [complete = std::move(complete)](napa::Result result) {
                     complete(new napa::Result(std::move(result)));
                 });
             });
@@ -117,17 +208,21 @@ void ZoneWrap::Execute(const v8::FunctionCallbackInfo<v8::Value>& args) {
     CHECK_ARG(isolate, args[0]->IsObject(), "first argument to zone.execute must be the function spec object");
     CHECK_ARG(isolate, args[1]->IsFunction(), "second argument to zone.execute must be the callback");
 
+    // Binary results are returned as ArrayBuffers, the transport option is kept for the completion.
+    auto transport = std::make_shared<napa::TransportOption>(AUTO);
+
     napa::zone::DoAsyncWork(v8::Local<v8::Function>::Cast(args[1]),
-        [&args](std::function<void(void*)> complete) {
-            CreateRequestAndExecute(args[0]->ToObject(), [&args, &complete](const napa::FunctionSpec& spec) {
+        [&args, transport](std::function<void(void*)> complete) {
+            CreateRequestAndExecute(args[0]->ToObject(), [&args, &complete, &transport](const napa::FunctionSpec& spec) {
                 auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
 
+                *transport = spec.options.transport;
                 wrap->_zoneProxy->Execute(spec, [complete = std::move(complete)](napa::Result result) {
                     complete(new napa::Result(std::move(result)));
                 });
             });
         },
-        [](auto jsCallback, void* res) {
+        [transport](auto jsCallback, void* res) {
             auto isolate = v8::Isolate::GetCurrent();
             auto context = isolate->GetCurrentContext();
 
@@ -136,7 +231,49 @@ void ZoneWrap::Execute(const v8::FunctionCallbackInfo<v8::Value>& args) {
             v8::HandleScope scope(isolate);
 
             std::vector<v8::Local<v8::Value>> argv;
-            argv.emplace_back(CreateResponseObject(*result));
+            argv.emplace_back(CreateResponseObject(*result, *transport));
+
+            (void)jsCallback->Call(context, context->Global(), static_cast<int>(argv.size()), argv.data());
+
+            delete result;
+        }
+    );
+}
+
+void ZoneWrap::ExecuteOnWorker(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args[0]->IsUint32(), "first argument to zone.executeOnWorker must be the worker id");
+    CHECK_ARG(isolate, args[1]->IsObject(), "second argument to zone.executeOnWorker must be the function spec object");
+    CHECK_ARG(isolate, args[2]->IsFunction(), "third argument to zone.executeOnWorker must be the callback");
+
+    auto workerId = args[0]->Uint32Value(context).FromJust();
+
+    // Binary results are returned as ArrayBuffers, the transport option is kept for the completion.
+    auto transport = std::make_shared<napa::TransportOption>(AUTO);
+
+    napa::zone::DoAsyncWork(v8::Local<v8::Function>::Cast(args[2]),
+        [&args, workerId, transport](std::function<void(void*)> complete) {
+            CreateRequestAndExecute(args[1]->ToObject(), [&args, &complete, workerId, &transport](const napa::FunctionSpec& spec) {
+                auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+
+                *transport = spec.options.transport;
+                wrap->_zoneProxy->ExecuteOnWorker(workerId, spec, [complete = std::move(complete)](napa::Result result) {
+                    complete(new napa::Result(std::move(result)));
+                });
+            });
+        },
+        [transport](auto jsCallback, void* res) {
+            auto isolate = v8::Isolate::GetCurrent();
+            auto context = isolate->GetCurrentContext();
+
+            auto result = static_cast<napa::Result*>(res);
+
+            v8::HandleScope scope(isolate);
+
+            std::vector<v8::Local<v8::Value>> argv;
+            argv.emplace_back(CreateResponseObject(*result, *transport));
 
             (void)jsCallback->Call(context, context->Global(), static_cast<int>(argv.size()), argv.data());
 
@@ -154,30 +291,655 @@ void ZoneWrap::ExecuteSync(const v8::FunctionCallbackInfo<v8::Value>& args) {
         auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
 
         napa::Result result = wrap->_zoneProxy->ExecuteSync(spec);
-        args.GetReturnValue().Set(CreateResponseObject(result));
+        args.GetReturnValue().Set(CreateResponseObject(result, spec.options.transport));
     });
 }
 
-static v8::Local<v8::Object> CreateResponseObject(const napa::Result& result) {
+void ZoneWrap::ExecuteBatch(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    CHECK_ARG(isolate, args[0]->IsObject(), "first argument to zone.executeBatch must be the batch spec object");
+    CHECK_ARG(isolate, args[1]->IsFunction(), "second argument to zone.executeBatch must be the callback");
+
+    // All calls of a batch share the options, hence the transport option.
+    auto transport = std::make_shared<napa::TransportOption>(AUTO);
+
+    napa::zone::DoAsyncWork(v8::Local<v8::Function>::Cast(args[1]),
+        [&args, transport](std::function<void(void*)> complete) {
+            CreateBatchRequestAndExecute(args[0]->ToObject(), [&args, &complete, &transport](const std::vector<napa::FunctionSpec>& specs) {
+                auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+
+                if (!specs.empty()) {
+                    *transport = specs.front().options.transport;
+                }
+                wrap->_zoneProxy->ExecuteBatch(specs, [complete = std::move(complete)](std::vector<napa::Result> results) {
+                    complete(new std::vector<napa::Result>(std::move(results)));
+                });
+            });
+        },
+        [transport](auto jsCallback, void* res) {
+            auto isolate = v8::Isolate::GetCurrent();
+            auto context = isolate->GetCurrentContext();
+
+            auto results = static_cast<std::vector<napa::Result>*>(res);
+
+            v8::HandleScope scope(isolate);
+
+            auto responses = v8::Array::New(isolate, static_cast<int>(results->size()));
+            for (size_t i = 0; i < results->size(); i++) {
+                (void)responses->CreateDataProperty(context, static_cast<uint32_t>(i), CreateResponseObject((*results)[i], *transport));
+            }
+
+            std::vector<v8::Local<v8::Value>> argv;
+            argv.emplace_back(responses);
+
+            (void)jsCallback->Call(context, context->Global(), static_cast<int>(argv.size()), argv.data());
+
+            delete results;
+        }
+    );
+}
+
+void ZoneWrap::Pipe(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args[0]->IsArray(), "first argument to zone.pipe must be the array of stages");
+    CHECK_ARG(isolate, args[1]->IsFunction(), "second argument to zone.pipe must be the callback");
+
+    auto stages = v8::Local<v8::Array>::Cast(args[0]);
+    CHECK_ARG(isolate, stages->Length() > 0, "a pipeline needs at least one stage");
+
+    // Stages only keep what they need once the specs are parsed, only the first stage has arguments.
+    auto pipeline = std::make_shared<Pipeline>();
+    std::vector<std::string> arguments;
+    std::unique_ptr<napa::transport::TransportContext> transportContext;
+
+    for (uint32_t i = 0; i < stages->Length(); i++) {
+        auto stageValue = stages->Get(context, i).ToLocalChecked();
+        CHECK_ARG(isolate, stageValue->IsObject(), "stage %u of the pipeline must be an object", i);
+        auto stage = v8::Local<v8::Object>::Cast(stageValue);
+
+        auto zoneIdValue = stage->Get(context, MakeV8String(isolate, "zoneId")).ToLocalChecked();
+        CHECK_ARG(isolate, zoneIdValue->IsString(), "stage %u of the pipeline must have a zone id", i);
+        auto zoneId = V8ValueTo<std::string>(zoneIdValue);
+
+        std::unique_ptr<napa::Zone> zoneProxy;
+        try {
+            zoneProxy = napa::Zone::Get(zoneId);
+        } catch (const std::runtime_error& ex) {
+            JS_FAIL(isolate, ex.what());
+        }
+
+        auto specValue = stage->Get(context, MakeV8String(isolate, "spec")).ToLocalChecked();
+        CHECK_ARG(isolate, specValue->IsObject(), "stage %u of the pipeline must have a function spec", i);
+
+        auto parsed = false;
+        CreateRequestAndExecute(specValue->ToObject(), [&](const napa::FunctionSpec& spec) {
+            pipeline->push_back({ std::move(zoneProxy), NAPA_STRING_REF_TO_STD_STRING(spec.module), NAPA_STRING_REF_TO_STD_STRING(spec.function), spec.options });
+            if (i == 0) {
+                arguments = std::move(spec.ownedArguments);
+                transportContext = std::move(spec.transportContext);
+            }
+            parsed = true;
+        });
+        if (!parsed) {
+            return;
+        }
+    }
+
+    // Payloads pass from stage to stage as is, stages have to marshall them the same way.
+    napa::zone::DoAsyncWork(v8::Local<v8::Function>::Cast(args[1]),
+        [&](std::function<void(void*)> complete) {
+            ExecutePipelineStage(pipeline, 0, std::move(arguments), std::move(transportContext), [complete = std::move(complete)](napa::Result result) {
+                complete(new napa::Result(std::move(result)));
+            });
+        },
+        [](auto jsCallback, void* res) {
+            auto isolate = v8::Isolate::GetCurrent();
+            auto context = isolate->GetCurrentContext();
+
+            auto result = static_cast<napa::Result*>(res);
+
+            v8::HandleScope scope(isolate);
+
+            std::vector<v8::Local<v8::Value>> argv;
+            argv.emplace_back(CreateResponseObject(*result));
+
+            (void)jsCallback->Call(context, context->Global(), static_cast<int>(argv.size()), argv.data());
+
+            delete result;
+        }
+    );
+}
+
+void ZoneWrap::RunGraph(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args[0]->IsArray(), "first argument to zone.runGraph must be the array of tasks");
+    CHECK_ARG(isolate, args[1]->IsFunction(), "second argument to zone.runGraph must be the callback");
+
+    auto taskValues = v8::Local<v8::Array>::Cast(args[0]);
+
+    // Tasks on the same zone share its proxy.
+    std::unordered_map<std::string, std::shared_ptr<napa::Zone>> zones;
+    std::vector<napa::zone::GraphTask> tasks;
+    tasks.reserve(taskValues->Length());
+
+    for (uint32_t i = 0; i < taskValues->Length(); i++) {
+        auto taskValue = taskValues->Get(context, i).ToLocalChecked();
+        CHECK_ARG(isolate, taskValue->IsObject(), "task %u of the graph must be an object", i);
+        auto taskObject = v8::Local<v8::Object>::Cast(taskValue);
+
+        auto zoneIdValue = taskObject->Get(context, MakeV8String(isolate, "zoneId")).ToLocalChecked();
+        CHECK_ARG(isolate, zoneIdValue->IsString(), "task %u of the graph must have a zone id", i);
+        auto zoneId = V8ValueTo<std::string>(zoneIdValue);
+
+        auto& zoneProxy = zones[zoneId];
+        if (zoneProxy == nullptr) {
+            try {
+                zoneProxy = napa::Zone::Get(zoneId);
+            } catch (const std::runtime_error& ex) {
+                JS_FAIL(isolate, ex.what());
+            }
+        }
+
+        auto nameValue = taskObject->Get(context, MakeV8String(isolate, "name")).ToLocalChecked();
+        CHECK_ARG(isolate, nameValue->IsString(), "task %u of the graph must have a name", i);
+
+        auto dependenciesValue = taskObject->Get(context, MakeV8String(isolate, "dependencies")).ToLocalChecked();
+        CHECK_ARG(isolate, dependenciesValue->IsArray(), "task %u of the graph must have an array of dependencies", i);
+        auto dependencies = v8::Local<v8::Array>::Cast(dependenciesValue);
+
+        napa::zone::GraphTask task;
+        task.name = V8ValueTo<std::string>(nameValue);
+        for (uint32_t j = 0; j < dependencies->Length(); j++) {
+            auto dependency = dependencies->Get(context, j).ToLocalChecked();
+            CHECK_ARG(isolate, dependency->IsUint32(), "dependencies of task %u of the graph must be task indices", i);
+            task.dependencies.push_back(dependency->Uint32Value(context).FromJust());
+        }
+        task.execute = [zoneProxy](const napa::FunctionSpec& spec, napa::ExecuteCallback callback) {
+            zoneProxy->Execute(spec, std::move(callback));
+        };
+
+        auto specValue = taskObject->Get(context, MakeV8String(isolate, "spec")).ToLocalChecked();
+        CHECK_ARG(isolate, specValue->IsObject(), "task %u of the graph must have a function spec", i);
+
+        auto parsed = false;
+        CreateRequestAndExecute(specValue->ToObject(), [&](const napa::FunctionSpec& spec) {
+            task.module = NAPA_STRING_REF_TO_STD_STRING(spec.module);
+            task.function = NAPA_STRING_REF_TO_STD_STRING(spec.function);
+            task.arguments = std::move(spec.ownedArguments);
+            task.options = spec.options;
+            task.transportContext = std::move(spec.transportContext);
+            parsed = true;
+        });
+        if (!parsed) {
+            return;
+        }
+        tasks.push_back(std::move(task));
+    }
+
+    std::string error;
+    if (!napa::zone::TaskGraph::Validate(tasks, error)) {
+        JS_FAIL(isolate, error.c_str());
+    }
+
+    // Payloads pass from task to task as is, dependents have to marshall them the same way.
+    napa::zone::DoAsyncWork(v8::Local<v8::Function>::Cast(args[1]),
+        [&](std::function<void(void*)> complete) {
+            napa::zone::TaskGraph::Run(std::move(tasks), [complete = std::move(complete)](std::vector<napa::Result> results) {
+                complete(new std::vector<napa::Result>(std::move(results)));
+            });
+        },
+        [](auto jsCallback, void* res) {
+            auto isolate = v8::Isolate::GetCurrent();
+            auto context = isolate->GetCurrentContext();
+
+            auto results = static_cast<std::vector<napa::Result>*>(res);
+
+            v8::HandleScope scope(isolate);
+
+            auto responses = v8::Array::New(isolate, static_cast<int>(results->size()));
+            for (size_t i = 0; i < results->size(); i++) {
+                (void)responses->CreateDataProperty(context, static_cast<uint32_t>(i), CreateResponseObject((*results)[i]));
+            }
+
+            std::vector<v8::Local<v8::Value>> argv;
+            argv.emplace_back(responses);
+
+            (void)jsCallback->Call(context, context->Global(), static_cast<int>(argv.size()), argv.data());
+
+            delete results;
+        }
+    );
+}
+
+void ZoneWrap::ParallelFor(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args[0]->IsObject(), "first argument to zone.parallelFor must be the function spec object");
+    CHECK_ARG(isolate, args[1]->IsUint32(), "second argument to zone.parallelFor must be the number of elements");
+    CHECK_ARG(isolate, args[2]->IsUint32() && args[2]->Uint32Value(context).FromJust() > 0, "third argument to zone.parallelFor must be a positive grain");
+    CHECK_ARG(isolate, args[3]->IsFunction(), "fourth argument to zone.parallelFor must be the callback");
+
+    auto length = args[1]->Uint32Value(context).FromJust();
+    auto grain = args[2]->Uint32Value(context).FromJust();
+
+    /// <summary> Counts down the ranges in flight, the first failure is reported once all ranges are done. </summary>
+    struct Ranges {
+        std::atomic<uint32_t> remaining;
+        std::mutex lock;
+        napa::Result failure;
+        std::function<void(void*)> complete;
+    };
+
+    napa::zone::DoAsyncWork(v8::Local<v8::Function>::Cast(args[3]),
+        [&args, length, grain](std::function<void(void*)> complete) {
+            CreateRequestAndExecute(args[0]->ToObject(), [&](const napa::FunctionSpec& spec) {
+                auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+
+                auto rangeCount = std::max((length + grain - 1) / grain, 1u);
+                auto ranges = std::make_shared<Ranges>();
+                ranges->remaining = rangeCount;
+                ranges->failure.code = NAPA_RESULT_SUCCESS;
+                ranges->complete = std::move(complete);
+
+                // Every range gets the same arguments followed by its bounds, and shares the handles of the arguments,
+                // so a typed array on a SharedArrayBuffer is marshalled once and never copied.
+                for (uint32_t begin = 0, i = 0; i < rangeCount; begin += grain, i++) {
+                    napa::FunctionSpec rangeSpec;
+                    rangeSpec.module = spec.module;
+                    rangeSpec.function = spec.function;
+                    rangeSpec.ownedArguments = spec.ownedArguments;
+                    rangeSpec.ownedArguments.emplace_back(std::to_string(begin));
+                    rangeSpec.ownedArguments.emplace_back(std::to_string(std::min(begin + grain, length)));
+                    rangeSpec.options = spec.options;
+                    rangeSpec.transportContext = spec.transportContext != nullptr
+                        ? spec.transportContext->Share()
+                        : std::make_unique<napa::transport::TransportContext>();
+
+                    wrap->_zoneProxy->Execute(rangeSpec, [ranges](napa::Result result) {
+                        if (result.code != NAPA_RESULT_SUCCESS) {
+                            std::lock_guard<std::mutex> lock(ranges->lock);
+                            if (ranges->failure.code == NAPA_RESULT_SUCCESS) {
+                                ranges->failure = std::move(result);
+                            }
+                        }
+                        if (--ranges->remaining == 0) {
+                            ranges->complete(new napa::Result(std::move(ranges->failure)));
+                        }
+                    });
+                }
+            });
+        },
+        [](auto jsCallback, void* res) {
+            auto isolate = v8::Isolate::GetCurrent();
+            auto context = isolate->GetCurrentContext();
+
+            auto result = static_cast<napa::Result*>(res);
+
+            v8::HandleScope scope(isolate);
+
+            std::vector<v8::Local<v8::Value>> argv;
+            argv.emplace_back(CreateResponseObject(*result));
+
+            (void)jsCallback->Call(context, context->Global(), static_cast<int>(argv.size()), argv.data());
+
+            delete result;
+        }
+    );
+}
+
+void ZoneWrap::GetHeapStatistics(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    CHECK_ARG(isolate, args[0]->IsFunction(), "first argument to zone.getHeapStatistics must be the callback");
+
+    napa::zone::DoAsyncWork(v8::Local<v8::Function>::Cast(args[0]),
+        [&args](std::function<void(void*)> complete) {
+            auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+
+            wrap->_zoneProxy->GetHeapStatistics([complete = std::move(complete)](std::vector<napa::HeapStatistics> statistics) {
+                complete(new std::vector<napa::HeapStatistics>(std::move(statistics)));
+            });
+        },
+        [](auto jsCallback, void* res) {
+            auto isolate = v8::Isolate::GetCurrent();
+            auto context = isolate->GetCurrentContext();
+
+            auto statistics = static_cast<std::vector<napa::HeapStatistics>*>(res);
+
+            v8::HandleScope scope(isolate);
+
+            auto workers = v8::Array::New(isolate, static_cast<int>(statistics->size()));
+            for (size_t i = 0; i < statistics->size(); i++) {
+                (void)workers->CreateDataProperty(context, static_cast<uint32_t>(i), CreateHeapStatisticsObject((*statistics)[i]));
+            }
+
+            std::vector<v8::Local<v8::Value>> argv;
+            argv.emplace_back(workers);
+
+            (void)jsCallback->Call(context, context->Global(), static_cast<int>(argv.size()), argv.data());
+
+            delete statistics;
+        }
+    );
+}
+
+void ZoneWrap::GetStats(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+    auto stats = wrap->_zoneProxy->GetStats();
+
+    auto workers = v8::Array::New(isolate, static_cast<int>(stats.workers.size()));
+    for (size_t i = 0; i < stats.workers.size(); ++i) {
+        (void)workers->CreateDataProperty(context, static_cast<uint32_t>(i), CreateWorkerStatsObject(stats.workers[i]));
+    }
+
+    auto statsObject = v8::Object::New(isolate);
+    (void)statsObject->CreateDataProperty(
+        context,
+        MakeV8String(isolate, "pendingTasks"),
+        v8::Number::New(isolate, static_cast<double>(stats.pendingTasks)));
+    (void)statsObject->CreateDataProperty(context, MakeV8String(isolate, "workers"), workers);
+
+    auto tenants = v8::Array::New(isolate, static_cast<int>(stats.tenants.size()));
+    for (size_t i = 0; i < stats.tenants.size(); ++i) {
+        (void)tenants->CreateDataProperty(context, static_cast<uint32_t>(i), CreateTenantStatsObject(stats.tenants[i]));
+    }
+    (void)statsObject->CreateDataProperty(context, MakeV8String(isolate, "tenants"), tenants);
+
+    auto functions = v8::Array::New(isolate, static_cast<int>(stats.functions.size()));
+    for (size_t i = 0; i < stats.functions.size(); ++i) {
+        (void)functions->CreateDataProperty(
+            context, static_cast<uint32_t>(i), CreateFunctionCountersObject(stats.functions[i]));
+    }
+    (void)statsObject->CreateDataProperty(context, MakeV8String(isolate, "functions"), functions);
+
+    args.GetReturnValue().Set(statsObject);
+}
+
+void ZoneWrap::GetFunctionStats(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+    auto stats = wrap->_zoneProxy->GetFunctionStats();
+
+    auto functions = v8::Array::New(isolate, static_cast<int>(stats.size()));
+    for (size_t i = 0; i < stats.size(); ++i) {
+        (void)functions->CreateDataProperty(context, static_cast<uint32_t>(i), CreateFunctionStatsObject(stats[i]));
+    }
+    args.GetReturnValue().Set(functions);
+}
+
+void ZoneWrap::NotifyMemoryPressure(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() == 1 && args[0]->IsUint32(), "the memory pressure level must be an unsigned integer.");
+
+    auto level = args[0]->Uint32Value(context).FromJust();
+    CHECK_ARG(isolate, level <= MEMORY_PRESSURE_CRITICAL, "the memory pressure level must be one of MemoryPressureLevel.");
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+    wrap->_zoneProxy->NotifyMemoryPressure(static_cast<napa::MemoryPressureLevel>(level));
+}
+
+void ZoneWrap::StartProfiling(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    CHECK_ARG(isolate, args.Length() == 2, "2 arguments are required for \"startProfiling\".");
+    CHECK_ARG(isolate, args[0]->IsArray(), "first argument to zone.startProfiling must be an array of worker ids.");
+    CHECK_ARG(isolate, args[1]->IsUint32(), "second argument to zone.startProfiling must be the sampling interval.");
+
+    auto array = v8::Local<v8::Array>::Cast(args[0]);
+    std::vector<uint32_t> workerIds;
+    workerIds.reserve(array->Length());
+    for (uint32_t i = 0; i < array->Length(); i++) {
+        auto workerId = array->Get(context, i).ToLocalChecked();
+        CHECK_ARG(isolate, workerId->IsUint32(), "worker ids must be unsigned integers.");
+        workerIds.emplace_back(workerId->Uint32Value(context).FromJust());
+    }
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+    wrap->_zoneProxy->StartProfiling(workerIds, args[1]->Uint32Value(context).FromJust());
+}
+
+void ZoneWrap::StopProfiling(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    CHECK_ARG(isolate, args[0]->IsFunction(), "first argument to zone.stopProfiling must be the callback");
+
+    napa::zone::DoAsyncWork(v8::Local<v8::Function>::Cast(args[0]),
+        [&args](std::function<void(void*)> complete) {
+            auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+
+            wrap->_zoneProxy->StopProfiling([complete = std::move(complete)](std::vector<napa::CpuProfile> profiles) {
+                complete(new std::vector<napa::CpuProfile>(std::move(profiles)));
+            });
+        },
+        [](auto jsCallback, void* res) {
+            auto isolate = v8::Isolate::GetCurrent();
+            auto context = isolate->GetCurrentContext();
+
+            auto profiles = static_cast<std::vector<napa::CpuProfile>*>(res);
+
+            v8::HandleScope scope(isolate);
+
+            auto workers = v8::Array::New(isolate, static_cast<int>(profiles->size()));
+            for (size_t i = 0; i < profiles->size(); i++) {
+                const auto& profile = (*profiles)[i];
+
+                auto profileObject = v8::Object::New(isolate);
+                (void)profileObject->CreateDataProperty(
+                    context,
+                    MakeV8String(isolate, "workerId"),
+                    v8::Uint32::NewFromUnsigned(isolate, profile.workerId));
+                (void)profileObject->CreateDataProperty(
+                    context,
+                    MakeV8String(isolate, "profile"),
+                    MakeV8String(isolate, profile.profile));
+
+                (void)workers->CreateDataProperty(context, static_cast<uint32_t>(i), profileObject);
+            }
+
+            std::vector<v8::Local<v8::Value>> argv;
+            argv.emplace_back(workers);
+
+            (void)jsCallback->Call(context, context->Global(), static_cast<int>(argv.size()), argv.data());
+
+            delete profiles;
+        }
+    );
+}
+
+static v8::Local<v8::Object> CreateHeapStatisticsObject(const napa::HeapStatistics& statistics) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    auto statisticsObject = v8::Object::New(isolate);
+
+    auto setField = [&](const char* name, double value) {
+        (void)statisticsObject->CreateDataProperty(context, MakeV8String(isolate, name), v8::Number::New(isolate, value));
+    };
+
+    setField("workerId", statistics.worker_id);
+    setField("totalHeapSize", static_cast<double>(statistics.total_heap_size));
+    setField("totalHeapSizeExecutable", static_cast<double>(statistics.total_heap_size_executable));
+    setField("totalPhysicalSize", static_cast<double>(statistics.total_physical_size));
+    setField("totalAvailableSize", static_cast<double>(statistics.total_available_size));
+    setField("usedHeapSize", static_cast<double>(statistics.used_heap_size));
+    setField("heapSizeLimit", static_cast<double>(statistics.heap_size_limit));
+    setField("mallocedMemory", static_cast<double>(statistics.malloced_memory));
+    setField("peakMallocedMemory", static_cast<double>(statistics.peak_malloced_memory));
+
+    return statisticsObject;
+}
+
+static v8::Local<v8::Object> CreateWorkerStatsObject(const napa::WorkerStats& stats) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    auto statsObject = v8::Object::New(isolate);
+
+    auto setField = [&](const char* name, double value) {
+        (void)statsObject->CreateDataProperty(context, MakeV8String(isolate, name), v8::Number::New(isolate, value));
+    };
+
+    // Times are converted from nanoseconds to the milliseconds used across the JavaScript API.
+    setField("workerId", stats.worker_id);
+    setField("busyTime", static_cast<double>(stats.busy_time) / 1e6);
+    setField("idleTime", static_cast<double>(stats.idle_time) / 1e6);
+    setField("executedTasks", static_cast<double>(stats.executed_tasks));
+    setField("queuedTasks", static_cast<double>(stats.queued_tasks));
+    setField("queuedImmediateTasks", static_cast<double>(stats.queued_immediate_tasks));
+
+    return statsObject;
+}
+
+static v8::Local<v8::Object> CreateTenantStatsObject(const napa::TenantStats& stats) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    auto statsObject = v8::Object::New(isolate);
+
+    auto setField = [&](const char* name, double value) {
+        (void)statsObject->CreateDataProperty(context, MakeV8String(isolate, name), v8::Number::New(isolate, value));
+    };
+
+    // Tenants without a weight are named by their key, which doesn't fit a JavaScript number.
+    auto name = stats.name.empty() && stats.tenant != 0 ? std::to_string(stats.tenant) : stats.name;
+    (void)statsObject->CreateDataProperty(context, MakeV8String(isolate, "tenant"), MakeV8String(isolate, name));
+    setField("queuedTasks", static_cast<double>(stats.queuedTasks));
+    setField("dispatchedTasks", static_cast<double>(stats.dispatchedTasks));
+    setField("waitTime", static_cast<double>(stats.waitTime) / 1e6);
+    setField("maxWaitTime", static_cast<double>(stats.maxWaitTime) / 1e6);
+
+    return statsObject;
+}
+
+static v8::Local<v8::Object> CreateFunctionCountersObject(const napa::FunctionCounters& counters) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    auto countersObject = v8::Object::New(isolate);
+
+    auto setField = [&](const char* name, double value) {
+        (void)countersObject->CreateDataProperty(context, MakeV8String(isolate, name), v8::Number::New(isolate, value));
+    };
+
+    (void)countersObject->CreateDataProperty(
+        context,
+        MakeV8String(isolate, "function"),
+        MakeV8String(isolate, counters.function));
+    setField("calls", static_cast<double>(counters.calls));
+    setField("cycles", static_cast<double>(counters.cycles));
+    setField("instructions", static_cast<double>(counters.instructions));
+    setField("cacheReferences", static_cast<double>(counters.cacheReferences));
+    setField("cacheMisses", static_cast<double>(counters.cacheMisses));
+    setField("instructionsPerCycle", counters.cycles == 0 ?
+        0 : static_cast<double>(counters.instructions) / static_cast<double>(counters.cycles));
+    setField("cacheMissRate", counters.cacheReferences == 0 ?
+        0 : static_cast<double>(counters.cacheMisses) / static_cast<double>(counters.cacheReferences));
+
+    return countersObject;
+}
+
+static v8::Local<v8::Object> CreateFunctionStatsObject(const napa::FunctionStats& stats) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    auto statsObject = v8::Object::New(isolate);
+
+    auto setField = [&](const char* name, double value) {
+        (void)statsObject->CreateDataProperty(context, MakeV8String(isolate, name), v8::Number::New(isolate, value));
+    };
+
+    (void)statsObject->CreateDataProperty(context, MakeV8String(isolate, "module"), MakeV8String(isolate, stats.module));
+    (void)statsObject->CreateDataProperty(context, MakeV8String(isolate, "function"), MakeV8String(isolate, stats.function));
+    setField("calls", static_cast<double>(stats.calls));
+    setField("errors", static_cast<double>(stats.errors));
+    setField("totalTime", static_cast<double>(stats.totalTime) / 1e6);
+    setField("maxTime", static_cast<double>(stats.maxTime) / 1e6);
+    setField("averageTime", stats.calls == 0 ? 0 : static_cast<double>(stats.totalTime) / 1e6 / static_cast<double>(stats.calls));
+
+    // Only buckets with calls are listed, each with the milliseconds its calls ran under.
+    auto histogram = v8::Array::New(isolate);
+    uint32_t index = 0;
+    for (size_t i = 0; i < NAPA_FUNCTION_STATS_HISTOGRAM_BUCKETS; ++i) {
+        if (stats.histogram[i] == 0) {
+            continue;
+        }
+
+        auto upperBound = i + 1 < NAPA_FUNCTION_STATS_HISTOGRAM_BUCKETS ?
+            static_cast<double>(1ULL << i) / 1e3 : std::numeric_limits<double>::infinity();
+        auto bucket = v8::Object::New(isolate);
+        (void)bucket->CreateDataProperty(context, MakeV8String(isolate, "upperBound"), v8::Number::New(isolate, upperBound));
+        (void)bucket->CreateDataProperty(
+            context,
+            MakeV8String(isolate, "count"),
+            v8::Number::New(isolate, static_cast<double>(stats.histogram[i])));
+        (void)histogram->CreateDataProperty(context, index++, bucket);
+    }
+    (void)statsObject->CreateDataProperty(context, MakeV8String(isolate, "histogram"), histogram);
+
+    return statsObject;
+}
+
+static v8::Local<v8::Object> CreateResponseObject(const napa::Result& result, napa::TransportOption transport) {
     auto isolate = v8::Isolate::GetCurrent();
     auto context = isolate->GetCurrentContext();
 
     auto responseObject = v8::Object::New(isolate);
 
+    // Return values of calls with a compression threshold may arrive compressed.
+    auto code = result.code;
+    const std::string* errorMessage = &result.errorMessage;
+    auto compressed = code == NAPA_RESULT_SUCCESS && transport != BINARY && napa::utils::IsCompressedPayload(result.returnValue);
+    std::string decompressedResult;
+    if (compressed) {
+        static const std::string corruptedMessage = "Compressed return value is corrupted.";
+        decompressedResult.resize(napa::utils::GetDecompressedSize(result.returnValue));
+        if (!napa::utils::DecompressPayload(result.returnValue, &decompressedResult[0])) {
+            code = NAPA_RESULT_INTERNAL_ERROR;
+            errorMessage = &corruptedMessage;
+            decompressedResult.clear();
+        }
+    }
+
     (void)responseObject->CreateDataProperty(
         context,
         MakeV8String(isolate, "code"),
-        v8::Uint32::NewFromUnsigned(isolate, result.code));
+        v8::Uint32::NewFromUnsigned(isolate, code));
 
     (void)responseObject->CreateDataProperty(
         context,
         MakeV8String(isolate, "errorMessage"),
-        MakeV8String(isolate, result.errorMessage));
+        MakeV8String(isolate, *errorMessage));
 
+    // A binary return value is copied into an ArrayBuffer, a failed call returns an empty string.
+    v8::Local<v8::Value> returnValue;
+    if (transport == BINARY && code == NAPA_RESULT_SUCCESS) {
+        auto bytes = v8::ArrayBuffer::New(isolate, result.returnValue.size());
+        std::memcpy(bytes->GetContents().Data(), result.returnValue.data(), result.returnValue.size());
+        returnValue = bytes;
+    } else if (compressed) {
+        // The decompressed result isn't needed after this, a long one becomes an external string over its buffer.
+        returnValue = MakeV8String(isolate, std::move(decompressedResult));
+    } else {
+        returnValue = MakeV8String(isolate, result.returnValue);
+    }
     (void)responseObject->CreateDataProperty(
         context,
         MakeV8String(isolate, "returnValue"),
-        MakeV8String(isolate, result.returnValue));
+        returnValue);
 
     // Transport context handle
     v8::Local<v8::Value> contextHandleValue;
@@ -192,6 +954,24 @@ static v8::Local<v8::Object> CreateResponseObject(const napa::Result& result) {
         MakeV8String(isolate, "contextHandle"),
         contextHandleValue);
 
+    // Timing is only recorded when the call options ask for it, the queue phase is never 0 then.
+    const auto& timing = result.timing;
+    if (timing.queue != 0) {
+        auto timingObject = v8::Object::New(isolate);
+        auto setPhase = [&](const char* name, int64_t nanoseconds) {
+            (void)timingObject->CreateDataProperty(
+                context,
+                MakeV8String(isolate, name),
+                v8::Number::New(isolate, static_cast<double>(nanoseconds)));
+        };
+        setPhase("queue", timing.queue);
+        setPhase("unmarshall", timing.unmarshall);
+        setPhase("execute", timing.execute);
+        setPhase("marshall", timing.marshall);
+
+        (void)responseObject->CreateDataProperty(context, MakeV8String(isolate, "timing"), timingObject);
+    }
+
     return responseObject;
 }
 
@@ -222,14 +1002,8 @@ static void CreateRequestAndExecute(v8::Local<v8::Object> obj, Func&& func) {
 
     // arguments are optional in a spec
     maybe = obj->Get(context, MakeV8String(isolate, "arguments"));
-    std::vector<Utf8String> arguments;
     if (!maybe.IsEmpty()) {
-        arguments = V8ArrayToVector<Utf8String>(isolate, v8::Local<v8::Array>::Cast(maybe.ToLocalChecked()));
-
-        spec.arguments.reserve(arguments.size());
-        for (const auto& arg : arguments) {
-            spec.arguments.emplace_back(NAPA_STRING_REF_WITH_SIZE(arg.Data(), arg.Length()));
-        }
+        ReadArguments(v8::Local<v8::Array>::Cast(maybe.ToLocalChecked()), spec.ownedArguments);
     }
 
     // options argument is optional.
@@ -250,6 +1024,90 @@ static void CreateRequestAndExecute(v8::Local<v8::Object> obj, Func&& func) {
         if (!maybe.IsEmpty()) {
             spec.options.transport = static_cast<napa::TransportOption>(maybe.ToLocalChecked()->Uint32Value(context).FromJust());
         }
+
+        // priority is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "priority"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            spec.options.priority = maybe.ToLocalChecked()->Uint32Value(context).FromJust();
+        }
+
+        // deadline is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "deadline"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            spec.options.deadline = maybe.ToLocalChecked()->IntegerValue(context).FromJust();
+        }
+
+        // routingKey is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "routingKey"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            spec.options.routing_key = ParseRoutingKey(maybe.ToLocalChecked());
+        }
+
+        // tenant is optional, its key is hashed like routingKey.
+        maybe = options->Get(context, MakeV8String(isolate, "tenant"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            spec.options.tenant = ParseRoutingKey(maybe.ToLocalChecked());
+        }
+
+        // cancellationToken is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "cancellationToken"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            spec.options.cancellation_token = ParseCancellationToken(maybe.ToLocalChecked());
+        }
+
+        // recordTiming is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "recordTiming"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            spec.options.record_timing = maybe.ToLocalChecked()->BooleanValue() ? 1 : 0;
+        }
+
+        // collectGarbage is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "collectGarbage"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            spec.options.collect_garbage = maybe.ToLocalChecked()->BooleanValue() ? 1 : 0;
+        }
+
+        // cache is optional, its key is hashed like routingKey.
+        maybe = options->Get(context, MakeV8String(isolate, "cache"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            JS_ENSURE(isolate, maybe.ToLocalChecked()->IsObject(), "option 'cache' must be an object.");
+            auto cache = v8::Local<v8::Object>::Cast(maybe.ToLocalChecked());
+
+            maybe = cache->Get(context, MakeV8String(isolate, "ttlMs"));
+            if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+                spec.options.cache_ttl = maybe.ToLocalChecked()->Uint32Value(context).FromJust();
+            }
+
+            maybe = cache->Get(context, MakeV8String(isolate, "key"));
+            if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+                spec.options.cache_key = ParseRoutingKey(maybe.ToLocalChecked());
+            }
+        }
+
+        // coalesce is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "coalesce"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            spec.options.coalesce = maybe.ToLocalChecked()->BooleanValue() ? 1 : 0;
+        }
+
+        // detachDeadline is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "detachDeadline"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            spec.options.detach_deadline = maybe.ToLocalChecked()->BooleanValue() ? 1 : 0;
+        }
+
+        // compressionThreshold is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "compressionThreshold"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            spec.options.compression_threshold = maybe.ToLocalChecked()->Uint32Value(context).FromJust();
+        }
+
+        // trace is optional.
+        maybe = options->Get(context, MakeV8String(isolate, "trace"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            JS_ENSURE(isolate, ParseTraceContext(maybe.ToLocalChecked(), spec.options),
+                "option 'trace' must be an object with hex string 'traceId' and 'spanId'.");
+        }
     }
 
     // transportContext property is mandatory in a spec
@@ -268,3 +1126,323 @@ static void CreateRequestAndExecute(v8::Local<v8::Object> obj, Func&& func) {
     // Execute
     func(spec);
 }
+
+template <typename Func>
+static void CreateBatchRequestAndExecute(v8::Local<v8::Object> obj, Func&& func) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    // module property is optional in a batch spec
+    Utf8String module;
+    auto maybe = obj->Get(context, MakeV8String(isolate, "module"));
+    if (!maybe.IsEmpty()) {
+        module = Utf8String(maybe.ToLocalChecked());
+    }
+
+    // function property is mandatory in a batch spec
+    maybe = obj->Get(context, MakeV8String(isolate, "function"));
+    CHECK_ARG(isolate, !maybe.IsEmpty(), "function property is missing in batch spec object");
+
+    auto functionValue = maybe.ToLocalChecked();
+    CHECK_ARG(isolate, functionValue->IsString(), "function property in batch spec object must be a string");
+
+    v8::String::Utf8Value function(functionValue->ToString());
+
+    // options argument is optional and shared by all calls.
+    auto options = napa::DefaultCallOptions();
+    maybe = obj->Get(context, MakeV8String(isolate, "options"));
+    if (!maybe.IsEmpty()) {
+        auto optionsValue = maybe.ToLocalChecked();
+        JS_ENSURE(isolate, optionsValue->IsObject(), "argument 'options' must be an object.");
+        auto optionsObject = v8::Local<v8::Object>::Cast(optionsValue);
+
+        // timeout is optional.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "timeout"));
+        if (!maybe.IsEmpty()) {
+            options.timeout = maybe.ToLocalChecked()->Uint32Value(context).FromJust();
+        }
+
+        // transport option is optional.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "transport"));
+        if (!maybe.IsEmpty()) {
+            options.transport = static_cast<napa::TransportOption>(maybe.ToLocalChecked()->Uint32Value(context).FromJust());
+        }
+
+        // priority is optional.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "priority"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            options.priority = maybe.ToLocalChecked()->Uint32Value(context).FromJust();
+        }
+
+        // deadline is optional.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "deadline"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            options.deadline = maybe.ToLocalChecked()->IntegerValue(context).FromJust();
+        }
+
+        // routingKey is optional.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "routingKey"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            options.routing_key = ParseRoutingKey(maybe.ToLocalChecked());
+        }
+
+        // tenant is optional, its key is hashed like routingKey.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "tenant"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            options.tenant = ParseRoutingKey(maybe.ToLocalChecked());
+        }
+
+        // cancellationToken is optional.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "cancellationToken"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            options.cancellation_token = ParseCancellationToken(maybe.ToLocalChecked());
+        }
+
+        // recordTiming is optional.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "recordTiming"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            options.record_timing = maybe.ToLocalChecked()->BooleanValue() ? 1 : 0;
+        }
+
+        // collectGarbage is optional.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "collectGarbage"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            options.collect_garbage = maybe.ToLocalChecked()->BooleanValue() ? 1 : 0;
+        }
+
+        // detachDeadline is optional.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "detachDeadline"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            options.detach_deadline = maybe.ToLocalChecked()->BooleanValue() ? 1 : 0;
+        }
+
+        // compressionThreshold is optional.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "compressionThreshold"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            options.compression_threshold = maybe.ToLocalChecked()->Uint32Value(context).FromJust();
+        }
+
+        // trace is optional.
+        maybe = optionsObject->Get(context, MakeV8String(isolate, "trace"));
+        if (!maybe.IsEmpty() && !maybe.ToLocalChecked()->IsUndefined()) {
+            JS_ENSURE(isolate, ParseTraceContext(maybe.ToLocalChecked(), options),
+                "option 'trace' must be an object with hex string 'traceId' and 'spanId'.");
+        }
+    }
+
+    // arguments property is mandatory in a batch spec, one array of marshalled arguments per call.
+    maybe = obj->Get(context, MakeV8String(isolate, "arguments"));
+    CHECK_ARG(isolate, !maybe.IsEmpty() && maybe.ToLocalChecked()->IsArray(), "arguments property in batch spec object must be an array");
+    auto argumentsArray = v8::Local<v8::Array>::Cast(maybe.ToLocalChecked());
+
+    // transportContexts property is mandatory in a batch spec, one transport context per call.
+    maybe = obj->Get(context, MakeV8String(isolate, "transportContexts"));
+    CHECK_ARG(isolate, !maybe.IsEmpty() && maybe.ToLocalChecked()->IsArray(), "transportContexts property in batch spec object must be an array");
+    auto transportContextsArray = v8::Local<v8::Array>::Cast(maybe.ToLocalChecked());
+
+    auto count = argumentsArray->Length();
+    CHECK_ARG(isolate, transportContextsArray->Length() == count, "arguments and transportContexts must have the same length");
+
+    std::vector<napa::FunctionSpec> specs(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        auto& spec = specs[i];
+        spec.module = NAPA_STRING_REF_WITH_SIZE(module.Data(), module.Length());
+        spec.function = NAPA_STRING_REF_WITH_SIZE(*function, static_cast<size_t>(function.length()));
+        spec.options = options;
+
+        auto argumentsValue = argumentsArray->Get(context, i).ToLocalChecked();
+        CHECK_ARG(isolate, argumentsValue->IsArray(), "each element of arguments in batch spec object must be an array");
+
+        ReadArguments(v8::Local<v8::Array>::Cast(argumentsValue), spec.ownedArguments);
+
+        auto transportContextValue = transportContextsArray->Get(context, i).ToLocalChecked();
+        if (!transportContextValue->IsNull()) {
+            CHECK_ARG(isolate, transportContextValue->IsObject(), "transportContext must be null or an object.");
+            auto transportContextWrap = NAPA_OBJECTWRAP::Unwrap<TransportContextWrapImpl>(transportContextValue->ToObject());
+            spec.transportContext.reset(transportContextWrap->Get());
+        }
+    }
+
+    // Execute
+    func(specs);
+}
+
+/// <summary> Reads marshalled arguments into strings that the call takes over, so they are copied only once. </summary>
+static void ReadArguments(v8::Local<v8::Array> array, std::vector<std::string>& arguments) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    arguments.reserve(array->Length());
+    for (uint32_t i = 0; i < array->Length(); i++) {
+        auto value = array->Get(context, i).ToLocalChecked();
+
+        if (value->IsArrayBuffer() || value->IsArrayBufferView()) {
+            size_t offset = 0;
+            size_t length = 0;
+            v8::Local<v8::ArrayBuffer> buffer;
+            if (value->IsArrayBuffer()) {
+                buffer = v8::Local<v8::ArrayBuffer>::Cast(value);
+                length = buffer->ByteLength();
+            } else {
+                auto view = v8::Local<v8::ArrayBufferView>::Cast(value);
+                buffer = view->Buffer();
+                offset = view->ByteOffset();
+                length = view->ByteLength();
+            }
+            auto data = static_cast<const char*>(buffer->GetContents().Data()) + offset;
+            arguments.emplace_back(data, length);
+            continue;
+        }
+
+        // Marshalled JSON is mostly ASCII, which is copied without being encoded.
+        arguments.emplace_back(V8ValueTo<std::string>(value));
+    }
+}
+
+static void ExecutePipelineStage(
+    std::shared_ptr<Pipeline> pipeline,
+    size_t index,
+    std::vector<std::string> arguments,
+    std::unique_ptr<napa::transport::TransportContext> transportContext,
+    std::function<void(napa::Result)> complete) {
+
+    auto& stage = (*pipeline)[index];
+
+    napa::FunctionSpec spec;
+    spec.module = STD_STRING_TO_NAPA_STRING_REF(stage.module);
+    spec.function = STD_STRING_TO_NAPA_STRING_REF(stage.function);
+    spec.ownedArguments = std::move(arguments);
+    spec.options = stage.options;
+    spec.transportContext = std::move(transportContext);
+
+    stage.zone->Execute(spec, [pipeline, index, complete = std::move(complete)](napa::Result result) {
+        if (result.code != NAPA_RESULT_SUCCESS || index + 1 == pipeline->size()) {
+            complete(std::move(result));
+            return;
+        }
+
+        // The marshalled result is the argument of the next stage, along with the handles it refers to.
+        std::vector<std::string> nextArguments;
+        nextArguments.emplace_back(std::move(result.returnValue));
+        ExecutePipelineStage(pipeline, index + 1, std::move(nextArguments), std::move(result.transportContext), std::move(complete));
+    });
+}
+
+static uint64_t ParseRoutingKey(v8::Local<v8::Value> value) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    if (value->IsNumber()) {
+        return static_cast<uint64_t>(value->IntegerValue(context).FromJust());
+    }
+
+    // String keys are hashed with xxHash, so the same key maps to the same worker in every process.
+    v8::String::Utf8Value key(value->ToString());
+    return napa::utils::hash::HashRoutingKey(*key, static_cast<size_t>(key.length()));
+}
+
+static uint64_t ParseCancellationToken(v8::Local<v8::Value> value) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    // A CancellationToken object carries its numeric token in the 'id' property.
+    if (value->IsObject()) {
+        auto maybe = v8::Local<v8::Object>::Cast(value)->Get(context, MakeV8String(isolate, "id"));
+        if (maybe.IsEmpty() || !maybe.ToLocalChecked()->IsNumber()) {
+            return 0;
+        }
+        value = maybe.ToLocalChecked();
+    }
+
+    if (!value->IsNumber()) {
+        return 0;
+    }
+    return static_cast<uint64_t>(value->IntegerValue(context).FromJust());
+}
+
+static bool ParseTraceContext(v8::Local<v8::Value> value, napa::CallOptions& options) {
+    auto isolate = v8::Isolate::GetCurrent();
+    auto context = isolate->GetCurrentContext();
+
+    if (!value->IsObject()) {
+        return false;
+    }
+    auto trace = v8::Local<v8::Object>::Cast(value);
+
+    // A TraceContext carries the ids as hex strings, since they don't fit in a number.
+    auto readId = [&](const char* name, uint64_t& id) {
+        auto maybe = trace->Get(context, MakeV8String(isolate, name));
+        if (maybe.IsEmpty() || !maybe.ToLocalChecked()->IsString()) {
+            return false;
+        }
+        return napa::zone::SpanRecorder::ParseId(napa::v8_helpers::V8ValueTo<std::string>(maybe.ToLocalChecked()), id);
+    };
+
+    uint64_t traceId = 0;
+    uint64_t spanId = 0;
+    if (!readId("traceId", traceId) || !readId("spanId", spanId) || traceId == 0) {
+        return false;
+    }
+
+    auto sampled = trace->Get(context, MakeV8String(isolate, "sampled"));
+    options.trace_id = traceId;
+    options.parent_span_id = spanId;
+    options.trace_sampled = !sampled.IsEmpty() && sampled.ToLocalChecked()->BooleanValue() ? 1 : 0;
+    return true;
+}
+
+void ZoneWrap::Recycle(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    CHECK_ARG(isolate, args[0]->IsFunction(), "first argument to zone.recycle must be the callback");
+
+    // Recycling waits for the queued calls and the workers to stop, which must not block the calling isolate.
+    // The JS zone holds the wrap until the callback is called.
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+    auto zoneProxy = wrap->_zoneProxy.get();
+    napa::zone::PostAsyncWork(v8::Local<v8::Function>::Cast(args[0]),
+        [zoneProxy]() -> void* {
+            return reinterpret_cast<void*>(static_cast<uintptr_t>(zoneProxy->Recycle()));
+        },
+        [](auto jsCallback, void* result) {
+            auto isolate = v8::Isolate::GetCurrent();
+            auto context = isolate->GetCurrentContext();
+
+            auto code = static_cast<napa::ResultCode>(reinterpret_cast<uintptr_t>(result));
+            v8::Local<v8::Value> argv[] = {
+                v8::Int32::New(isolate, static_cast<int32_t>(code)),
+                MakeV8String(isolate, napa_result_code_to_string(code))
+            };
+            (void)jsCallback->Call(context, context->Global(), 2, argv);
+        }
+    );
+}
+
+void ZoneWrap::Serve(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    CHECK_ARG(isolate, args[0]->IsString(), "first argument to zone.serve must be the address");
+    v8::String::Utf8Value address(args[0]->ToString());
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+    try {
+        args.GetReturnValue().Set(v8::Uint32::NewFromUnsigned(isolate, wrap->_zoneProxy->Serve(*address)));
+    } catch (const std::runtime_error& ex) {
+        JS_FAIL(isolate, ex.what());
+    }
+}
+
+void ZoneWrap::ServeSharedMemory(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+
+    CHECK_ARG(isolate, args[0]->IsString(), "first argument to zone.serveSharedMemory must be the name");
+    v8::String::Utf8Value name(args[0]->ToString());
+
+    auto wrap = ObjectWrap::Unwrap<ZoneWrap>(args.Holder());
+    try {
+        wrap->_zoneProxy->ServeSharedMemory(*name);
+    } catch (const std::runtime_error& ex) {
+        JS_FAIL(isolate, ex.what());
+    }
+}
@@ -37,10 +37,27 @@ namespace module {
 
         // ZoneWrap methods
         static void GetId(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void GetQueueLength(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void GetWorkerCount(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void Cancel(const v8::FunctionCallbackInfo<v8::Value>& args);
         static void Broadcast(const v8::FunctionCallbackInfo<v8::Value>& args);
         static void BroadcastSync(const v8::FunctionCallbackInfo<v8::Value>& args);
         static void Execute(const v8::FunctionCallbackInfo<v8::Value>& args);
         static void ExecuteSync(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void ExecuteOnWorker(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void ExecuteBatch(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void Pipe(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void RunGraph(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void ParallelFor(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void GetHeapStatistics(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void GetStats(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void GetFunctionStats(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void NotifyMemoryPressure(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void StartProfiling(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void StopProfiling(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void Recycle(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void Serve(const v8::FunctionCallbackInfo<v8::Value>& args);
+        static void ServeSharedMemory(const v8::FunctionCallbackInfo<v8::Value>& args);
 
         /// <summary> Friend default constructor callback. </summary>
         template <typename WrapType>
@@ -4,8 +4,8 @@
 #include "console.h"
 
 #include <napa/module.h>
+#include <utils/console-buffer.h>
 
-#include <iostream>
 #include <sstream>
 
 using namespace napa;
@@ -40,7 +40,8 @@ namespace {
             message.pop_back();
         }
 
-        std::cout << message << std::endl;
+        // Written through unless the 'consoleBufferSize' platform setting is set.
+        napa::utils::GetConsoleBuffer().WriteLine(message);
 
         args.GetReturnValue().Set(args.Holder());
     }
@@ -10,8 +10,11 @@
 
 #include <algorithm>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 
 using namespace napa;
 using namespace napa::module;
@@ -22,6 +25,16 @@ namespace {
         return filesystem::Path(file).Absolute().Normalize().String();
     }
 
+    /// <summary> A mapping held by the cache, along with the file status it was made from. </summary>
+    struct MappedFileEntry {
+        filesystem::FileStatus status;
+        std::weak_ptr<filesystem::MappedFile> file;
+    };
+
+    /// <summary> Mappings alive in the process, so all workers share a single mapping per file. </summary>
+    std::mutex mappedFilesLock;
+    std::unordered_map<std::string, MappedFileEntry> mappedFiles;
+
 }   // End of anonymous namespace.
 
 std::string file_system_helpers::ReadFileSync(const std::string& filename) {
@@ -95,6 +108,52 @@ bool file_system_helpers::ExistsSync(const std::string& path) {
     return filesystem::Exists(GetFileFullPath(path));
 }
 
+filesystem::FileStatus file_system_helpers::StatSync(const std::string& path) {
+    auto fullPath = GetFileFullPath(path);
+
+    filesystem::FileStatus status;
+    if (!filesystem::GetFileStatus(fullPath, status)) {
+        std::ostringstream oss;
+        oss << "Can't stat " << fullPath;
+        throw std::runtime_error(oss.str());
+    }
+    return status;
+}
+
+std::shared_ptr<filesystem::MappedFile> file_system_helpers::MapFileSync(const std::string& filename) {
+    auto fileFullPath = GetFileFullPath(filename);
+    auto status = StatSync(fileFullPath);
+
+    std::lock_guard<std::mutex> lock(mappedFilesLock);
+
+    // Reuse the mapping unless the file has changed since it was mapped.
+    auto& entry = mappedFiles[fileFullPath];
+    auto file = entry.file.lock();
+    if (file != nullptr
+        && entry.status.size == status.size
+        && entry.status.modifiedTime == status.modifiedTime) {
+        return file;
+    }
+
+    file = std::make_shared<filesystem::MappedFile>(fileFullPath);
+    if (!file->IsOpen()) {
+        mappedFiles.erase(fileFullPath);
+
+        std::ostringstream oss;
+        oss << "Can't map " << fileFullPath;
+        throw std::runtime_error(oss.str());
+    }
+
+    // Released mappings leave expired entries, drop them as the cache grows.
+    for (auto it = mappedFiles.begin(); it != mappedFiles.end(); ) {
+        it = it->second.file.expired() && it->first != fileFullPath ? mappedFiles.erase(it) : std::next(it);
+    }
+
+    entry.status = status;
+    entry.file = file;
+    return file;
+}
+
 std::vector<std::string> file_system_helpers::ReadDirectorySync(const std::string& directory) {
     std::vector<std::string> names;
     filesystem::PathIterator iterator(GetFileFullPath(directory));
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <platform/filesystem.h>
+
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -31,11 +34,21 @@ namespace file_system_helpers {
     /// <returns> True if path exists. </returns>
     bool ExistsSync(const std::string& path);
 
+    /// <summary> Get the status of a path synchronously. </summary>
+    /// <param name="path"> Path to check. </param>
+    /// <returns> Status of the file or directory, it throws if the path doesn't exist. </returns>
+    filesystem::FileStatus StatSync(const std::string& path);
+
     /// <summary> Read a directory synchronously. </summary>
     /// <param name="directory"> Directory to read. </param>
     /// <returns> File and directory names except '.' and '..'. </returns>
     std::vector<std::string> ReadDirectorySync(const std::string& directory);
 
+    /// <summary> Map a file into memory synchronously. </summary>
+    /// <param name="filename"> Filename to map. </param>
+    /// <returns> The mapping, shared by all callers while the file stays unchanged. It throws if the file can't be mapped. </returns>
+    std::shared_ptr<filesystem::MappedFile> MapFileSync(const std::string& filename);
+
 }   // End of namespace file_system_helpers
 }   // End of namespace module
 }   // End of namespace napa
@@ -5,12 +5,46 @@
 #include "file-system-helpers.h"
 
 #include <napa/module.h>
+#include <napa/module/binding/basic-wraps.h>
+#include <napa/zone/napa-async-runner.h>
+
+#include <memory>
+#include <sstream>
 
 using namespace napa;
 using namespace napa::module;
 
 namespace {
 
+    /// <summary> Read file asynchronously. </summary>
+    /// <param name="args"> It holds filename and a callback receiving an error and the content. </param>
+    void ReadFileCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    /// <summary> Write file asynchronously. </summary>
+    /// <param name="args"> It holds filename, string to write and a callback receiving an error. </param>
+    void WriteFileCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    /// <summary> Make directory asynchronously. </summary>
+    /// <param name="args"> It holds directory to make and a callback receiving an error. </param>
+    void MkdirCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    /// <summary> Read a directory asynchronously. </summary>
+    /// <param name="args"> It holds the directory and a callback receiving an error and the names. </param>
+    void ReaddirCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    /// <summary> Get the status of a path asynchronously. </summary>
+    /// <param name="args"> It holds the path and a callback receiving an error and the stats. </param>
+    void StatCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    /// <summary> Get the status of a path synchronously. </summary>
+    /// <param name="args"> A string argument of path. </param>
+    void StatSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+    /// <summary> Map a file into memory synchronously. </summary>
+    /// <param name="args"> A string argument of file name. </param>
+    /// <remarks> It returns an ArrayBuffer backed by the mapping, which is shared with other workers. </remarks>
+    void MapFileCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
+
     /// <summary> Read file synchronously. </summary>
     /// <param name="args"> It holds filename. </param>
     void ReadFileSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
@@ -39,10 +73,215 @@ void file_system::Init(v8::Local<v8::Object> exports) {
     NAPA_SET_METHOD(exports, "mkdirSync", MkdirSyncCallback);
     NAPA_SET_METHOD(exports, "existsSync", ExistsSyncCallback);
     NAPA_SET_METHOD(exports, "readdirSync", ReaddirSyncCallback);
+    NAPA_SET_METHOD(exports, "statSync", StatSyncCallback);
+    NAPA_SET_METHOD(exports, "mapFile", MapFileCallback);
+
+    NAPA_SET_METHOD(exports, "readFile", ReadFileCallback);
+    NAPA_SET_METHOD(exports, "writeFile", WriteFileCallback);
+    NAPA_SET_METHOD(exports, "mkdir", MkdirCallback);
+    NAPA_SET_METHOD(exports, "readdir", ReaddirCallback);
+    NAPA_SET_METHOD(exports, "stat", StatCallback);
 }
 
 namespace {
 
+    /// <summary> Outcome of an asynchronous operation, passed from the async work thread to the isolate. </summary>
+    template <typename T>
+    struct AsyncResult {
+        std::string error;
+        T value;
+    };
+
+    /// <summary> Runs a file operation in the zone's async work pool and calls back node.js style. </summary>
+    /// <param name="callback"> Javascript callback, receiving an error or null followed by the converted result. </param>
+    /// <param name="operation"> Operation run in the pool, it throws on failure. </param>
+    /// <param name="converter"> Converts the result into a V8 value, it runs in the isolate. </param>
+    template <typename T, typename Operation, typename Converter>
+    void PostFileSystemWork(v8::Local<v8::Function> callback, Operation operation, Converter converter) {
+        napa::zone::PostAsyncWork(
+            callback,
+            [operation]() -> void* {
+                // This runs at the async work thread, it must not touch V8.
+                auto result = new AsyncResult<T>();
+                try {
+                    result->value = operation();
+                } catch (const std::exception& ex) {
+                    result->error = ex.what();
+                }
+                return result;
+            },
+            [converter](v8::Local<v8::Function> jsCallback, void* data) {
+                std::unique_ptr<AsyncResult<T>> result(static_cast<AsyncResult<T>*>(data));
+
+                auto isolate = v8::Isolate::GetCurrent();
+                auto context = isolate->GetCurrentContext();
+
+                if (!result->error.empty()) {
+                    v8::Local<v8::Value> argv[] = { v8::Exception::Error(v8_helpers::MakeV8String(isolate, result->error)) };
+                    (void)jsCallback->Call(context, context->Global(), 1, argv);
+                } else {
+                    v8::Local<v8::Value> argv[] = { v8::Null(isolate), converter(isolate, result->value) };
+                    (void)jsCallback->Call(context, context->Global(), 2, argv);
+                }
+            });
+    }
+
+    /// <summary> Converter for operations without a result. </summary>
+    v8::Local<v8::Value> ToUndefined(v8::Isolate* isolate, bool) {
+        return v8::Undefined(isolate);
+    }
+
+    v8::Local<v8::Value> ToString(v8::Isolate* isolate, const std::string& value) {
+        return v8_helpers::MakeV8String(isolate, value);
+    }
+
+    v8::Local<v8::Value> ToNameArray(v8::Isolate* isolate, const std::vector<std::string>& names) {
+        auto context = isolate->GetCurrentContext();
+        auto count = static_cast<uint32_t>(names.size());
+        auto result = v8::Array::New(isolate, count);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            (void)result->CreateDataProperty(context, i, v8_helpers::MakeV8String(isolate, names[i]));
+        }
+        return result;
+    }
+
+    /// <summary> Returns the boolean bound as callback data, for the methods of a stats object. </summary>
+    void ReturnDataCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        args.GetReturnValue().Set(args.Data());
+    }
+
+    /// <summary> Makes an object with the fields and methods of node.js' fs.Stats that Napa supports. </summary>
+    v8::Local<v8::Value> ToStats(v8::Isolate* isolate, const filesystem::FileStatus& status) {
+        auto context = isolate->GetCurrentContext();
+        auto stats = v8::Object::New(isolate);
+
+        (void)stats->CreateDataProperty(context,
+            v8_helpers::MakeV8String(isolate, "size"),
+            v8::Number::New(isolate, static_cast<double>(status.size)));
+        (void)stats->CreateDataProperty(context,
+            v8_helpers::MakeV8String(isolate, "mtimeMs"),
+            v8::Number::New(isolate, static_cast<double>(status.modifiedTime)));
+        (void)stats->CreateDataProperty(context,
+            v8_helpers::MakeV8String(isolate, "mtime"),
+            v8::Date::New(context, static_cast<double>(status.modifiedTime)).ToLocalChecked());
+        (void)stats->CreateDataProperty(context,
+            v8_helpers::MakeV8String(isolate, "isFile"),
+            v8::Function::New(context, ReturnDataCallback, v8::Boolean::New(isolate, status.isFile)).ToLocalChecked());
+        (void)stats->CreateDataProperty(context,
+            v8_helpers::MakeV8String(isolate, "isDirectory"),
+            v8::Function::New(context, ReturnDataCallback, v8::Boolean::New(isolate, status.isDirectory)).ToLocalChecked());
+
+        return stats;
+    }
+
+    void ReadFileCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+
+        CHECK_ARG(isolate,
+            args.Length() >= 2 && args[0]->IsString() && args[args.Length() - 1]->IsFunction(),
+            "fs.readFile requires a string of file path as the 1st argument and a callback as the last argument.");
+
+        std::string filename = *v8::String::Utf8Value(args[0]);
+        PostFileSystemWork<std::string>(
+            v8::Local<v8::Function>::Cast(args[args.Length() - 1]),
+            [filename]() { return file_system_helpers::ReadFileSync(filename); },
+            ToString);
+    }
+
+    void WriteFileCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+
+        CHECK_ARG(isolate,
+            args.Length() >= 3 && args[0]->IsString() && args[1]->IsString() && args[args.Length() - 1]->IsFunction(),
+            "fs.writeFile requires a string of file name, a string of data to write and a callback.");
+
+        std::string filename = *v8::String::Utf8Value(args[0]);
+        v8::String::Utf8Value utf8Content(args[1]);
+        std::string content(*utf8Content, static_cast<size_t>(utf8Content.length()));
+        PostFileSystemWork<bool>(
+            v8::Local<v8::Function>::Cast(args[args.Length() - 1]),
+            [filename, content]() {
+                file_system_helpers::WriteFileSync(filename, content.data(), content.size());
+                return true;
+            },
+            ToUndefined);
+    }
+
+    void MkdirCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+
+        CHECK_ARG(isolate,
+            args.Length() >= 2 && args[0]->IsString() && args[args.Length() - 1]->IsFunction(),
+            "fs.mkdir requires a string of the directory and a callback.");
+
+        std::string directory = *v8::String::Utf8Value(args[0]);
+        PostFileSystemWork<bool>(
+            v8::Local<v8::Function>::Cast(args[args.Length() - 1]),
+            [directory]() {
+                file_system_helpers::MkdirSync(directory);
+                return true;
+            },
+            ToUndefined);
+    }
+
+    void ReaddirCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+
+        CHECK_ARG(isolate,
+            args.Length() >= 2 && args[0]->IsString() && args[args.Length() - 1]->IsFunction(),
+            "fs.readdir requires a string of the directory and a callback.");
+
+        std::string directory = *v8::String::Utf8Value(args[0]);
+        PostFileSystemWork<std::vector<std::string>>(
+            v8::Local<v8::Function>::Cast(args[args.Length() - 1]),
+            [directory]() {
+                if (!file_system_helpers::StatSync(directory).isDirectory) {
+                    std::ostringstream oss;
+                    oss << "Not a directory " << directory;
+                    throw std::runtime_error(oss.str());
+                }
+                return file_system_helpers::ReadDirectorySync(directory);
+            },
+            ToNameArray);
+    }
+
+    void StatCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+
+        CHECK_ARG(isolate,
+            args.Length() >= 2 && args[0]->IsString() && args[args.Length() - 1]->IsFunction(),
+            "fs.stat requires a string of the path and a callback.");
+
+        std::string path = *v8::String::Utf8Value(args[0]);
+        PostFileSystemWork<filesystem::FileStatus>(
+            v8::Local<v8::Function>::Cast(args[args.Length() - 1]),
+            [path]() { return file_system_helpers::StatSync(path); },
+            ToStats);
+    }
+
+    void StatSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+
+        CHECK_ARG(isolate,
+            args.Length() >= 1 && args[0]->IsString(),
+            "fs.statSync requires a string as the 1st parameter for the path.");
+
+        v8::String::Utf8Value path(args[0]);
+
+        try {
+            args.GetReturnValue().Set(ToStats(isolate, file_system_helpers::StatSync(std::string(*path))));
+        } catch (const std::exception& ex) {
+            isolate->ThrowException(v8::Exception::Error(v8_helpers::MakeV8String(isolate, ex.what())));
+        }
+    }
+
     void ReadFileSyncCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
         auto isolate = v8::Isolate::GetCurrent();
         v8::HandleScope scope(isolate);
@@ -157,4 +396,35 @@ namespace {
         args.GetReturnValue().Set(result);
     }
 
+
+    void MapFileCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+
+        CHECK_ARG(isolate,
+            args.Length() >= 1 && args[0]->IsString(),
+            "fs.mapFile requires a string as the 1st parameter for file name.");
+
+        v8::String::Utf8Value filename(args[0]);
+
+        std::shared_ptr<filesystem::MappedFile> file;
+        try {
+            file = file_system_helpers::MapFileSync(std::string(*filename));
+        } catch (const std::exception& ex) {
+            isolate->ThrowException(v8::Exception::Error(v8_helpers::MakeV8String(isolate, ex.what())));
+            return;
+        }
+
+        // The ArrayBuffer doesn't own the memory, so set its '_mappedFile' property to a ShareableWrap of the mapping.
+        // This keeps the mapping alive by the lifetime of the ArrayBuffer, like an externalized SharedArrayBuffer.
+        // It is not '_externalized', as the memory can't be transferred to other workers.
+        auto context = isolate->GetCurrentContext();
+        auto arrayBuffer = v8::ArrayBuffer::New(isolate, file->Data(), file->Size());
+        (void)arrayBuffer->CreateDataProperty(context,
+            v8_helpers::MakeV8String(isolate, "_mappedFile"),
+            binding::CreateShareableWrap(std::move(file)));
+
+        args.GetReturnValue().Set(arrayBuffer);
+    }
+
 }   // End of anonymous namespace.
\ No newline at end of file
@@ -16,6 +16,48 @@ void TypeCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
     args.GetReturnValue().Set(v8_helpers::MakeV8String(isolate, platform::GetOSType()));
 }
 
+void CpuTopologyCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    const auto& topology = platform::GetCpuTopology();
+    auto setProperty = [&](v8::Local<v8::Object> object, const char* name, v8::Local<v8::Value> value) {
+        (void)object->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, name), value);
+    };
+
+    auto numaNodes = v8::Array::New(isolate, static_cast<int>(topology.numaNodes.size()));
+    for (uint32_t i = 0; i < topology.numaNodes.size(); ++i) {
+        const auto& node = topology.numaNodes[i];
+        auto cpus = v8::Array::New(isolate, static_cast<int>(node.cpus.size()));
+        for (uint32_t j = 0; j < node.cpus.size(); ++j) {
+            (void)cpus->Set(context, j, v8::Integer::NewFromUnsigned(isolate, node.cpus[j]));
+        }
+
+        auto nodeObject = v8::Object::New(isolate);
+        setProperty(nodeObject, "id", v8::Integer::NewFromUnsigned(isolate, node.id));
+        setProperty(nodeObject, "cpus", cpus);
+        (void)numaNodes->Set(context, i, nodeObject);
+    }
+
+    auto caches = v8::Array::New(isolate, static_cast<int>(topology.caches.size()));
+    for (uint32_t i = 0; i < topology.caches.size(); ++i) {
+        const auto& cache = topology.caches[i];
+        auto cacheObject = v8::Object::New(isolate);
+        setProperty(cacheObject, "level", v8::Integer::NewFromUnsigned(isolate, cache.level));
+        setProperty(cacheObject, "type", v8_helpers::MakeV8String(isolate, cache.type));
+        setProperty(cacheObject, "size", v8::Number::New(isolate, static_cast<double>(cache.size)));
+        (void)caches->Set(context, i, cacheObject);
+    }
+
+    auto result = v8::Object::New(isolate);
+    setProperty(result, "logicalCpus", v8::Integer::NewFromUnsigned(isolate, topology.logicalCpus));
+    setProperty(result, "physicalCores", v8::Integer::NewFromUnsigned(isolate, topology.physicalCores));
+    setProperty(result, "numaNodes", numaNodes);
+    setProperty(result, "caches", caches);
+    args.GetReturnValue().Set(result);
+}
+
 void os::Init(v8::Local<v8::Object> exports) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
@@ -23,4 +65,5 @@ void os::Init(v8::Local<v8::Object> exports) {
     auto context = isolate->GetCurrentContext();
 
     NAPA_SET_METHOD(exports, "type", TypeCallback);
+    NAPA_SET_METHOD(exports, "cpuTopology", CpuTopologyCallback);
 }
\ No newline at end of file
@@ -7,12 +7,13 @@
 #include <platform/filesystem.h>
 #include <platform/os.h>
 #include <platform/process.h>
+#include <platform/thread.h>
+#include <v8-extensions/v8-extensions-macros.h>
 
 #include <chrono>
 #include <iostream>
 #include <sstream>
 
-
 using namespace napa;
 using namespace napa::module;
 
@@ -30,6 +31,15 @@ namespace {
     /// <summary> Callback to hrtime. </summary>
     void HrtimeCallback(const v8::FunctionCallbackInfo<v8::Value>&);
 
+    /// <summary> Callback to hrtime.bigint. </summary>
+    void HrtimeBigintCallback(const v8::FunctionCallbackInfo<v8::Value>&);
+
+    /// <summary> Callback to cpuUsage, of the worker thread. </summary>
+    void CpuUsageCallback(const v8::FunctionCallbackInfo<v8::Value>&);
+
+    /// <summary> Callback to memoryUsage, of the worker isolate. </summary>
+    void MemoryUsageCallback(const v8::FunctionCallbackInfo<v8::Value>&);
+
     /// <summary> Callback to umask. </summary>
     void UmaskCallback(const v8::FunctionCallbackInfo<v8::Value>&);
 
@@ -52,6 +62,15 @@ void process::Init(v8::Local<v8::Object> exports) {
     NAPA_SET_METHOD(exports, "exit", ExitCallback);
     NAPA_SET_METHOD(exports, "hrtime", HrtimeCallback);
     NAPA_SET_METHOD(exports, "umask", UmaskCallback);
+    NAPA_SET_METHOD(exports, "cpuUsage", CpuUsageCallback);
+    NAPA_SET_METHOD(exports, "memoryUsage", MemoryUsageCallback);
+
+    v8::Local<v8::Value> hrtime;
+    if (exports->Get(context, v8_helpers::MakeV8String(isolate, "hrtime")).ToLocal(&hrtime) && hrtime->IsFunction()) {
+        auto bigint = v8::FunctionTemplate::New(isolate, HrtimeBigintCallback)->GetFunction();
+        bigint->SetName(v8_helpers::MakeV8String(isolate, "bigint"));
+        (void)hrtime.As<v8::Object>()->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "bigint"), bigint);
+    }
 
     auto argc = platform::GetArgc();
     auto argv = platform::GetArgv();
@@ -144,6 +163,79 @@ namespace {
         args.GetReturnValue().Set(v8_helpers::HrtimeToV8Uint32Array(isolate, time));
     }
 
+    void HrtimeBigintCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+
+        // The same clock as hrtime, in nanoseconds, without the array of hrtime.
+        uint64_t time = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+
+    #if V8_VERSION_EQUALS_TO_OR_NEWER_THAN(6, 7)
+        args.GetReturnValue().Set(v8::BigInt::NewFromUnsigned(isolate, time));
+    #else
+        (void)time;
+        isolate->ThrowException(v8::Exception::TypeError(v8_helpers::MakeV8String(
+            isolate,
+            "process.hrtime.bigint requires v8 6.7 or newer.")));
+    #endif
+    }
+
+    void CpuUsageCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+        auto context = isolate->GetCurrentContext();
+
+        // Each worker runs on its own thread, so the CPU time of the thread is the cost of the worker.
+        platform::ThreadCpuUsage usage;
+        JS_ENSURE(isolate, platform::GetCurrentThreadCpuUsage(usage), "process.cpuUsage is not supported on this platform.");
+
+        auto user = static_cast<double>(usage.user);
+        auto system = static_cast<double>(usage.system);
+        auto userKey = v8_helpers::MakeV8String(isolate, "user");
+        auto systemKey = v8_helpers::MakeV8String(isolate, "system");
+
+        if (args.Length() > 0 && !args[0]->IsUndefined()) {
+            CHECK_ARG(isolate, args[0]->IsObject(), "The 1st argument of cpuUsage must be an object of a previous usage.");
+            auto previous = args[0].As<v8::Object>();
+
+            v8::Local<v8::Value> previousUser;
+            v8::Local<v8::Value> previousSystem;
+            CHECK_ARG(isolate,
+                previous->Get(context, userKey).ToLocal(&previousUser) && previousUser->IsNumber()
+                && previous->Get(context, systemKey).ToLocal(&previousSystem) && previousSystem->IsNumber(),
+                "The previous usage must have numbers of \"user\" and \"system\".");
+            user -= previousUser.As<v8::Number>()->Value();
+            system -= previousSystem.As<v8::Number>()->Value();
+        }
+
+        auto result = v8::Object::New(isolate);
+        (void)result->CreateDataProperty(context, userKey, v8::Number::New(isolate, user));
+        (void)result->CreateDataProperty(context, systemKey, v8::Number::New(isolate, system));
+        args.GetReturnValue().Set(result);
+    }
+
+    void MemoryUsageCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+        auto context = isolate->GetCurrentContext();
+
+        // The heap is of the worker isolate, the resident set is shared by the process.
+        v8::HeapStatistics statistics;
+        isolate->GetHeapStatistics(&statistics);
+
+        auto result = v8::Object::New(isolate);
+        auto setProperty = [&](const char* name, size_t value) {
+            (void)result->CreateDataProperty(
+                context,
+                v8_helpers::MakeV8String(isolate, name),
+                v8::Number::New(isolate, static_cast<double>(value)));
+        };
+        setProperty("rss", platform::GetResidentSetSize());
+        setProperty("heapTotal", statistics.total_heap_size());
+        setProperty("heapUsed", statistics.used_heap_size());
+        setProperty("external", static_cast<size_t>(isolate->AdjustAmountOfExternalAllocatedMemory(0)));
+        args.GetReturnValue().Set(result);
+    }
+
     void UmaskCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
         auto isolate = v8::Isolate::GetCurrent();
         v8::HandleScope scope(isolate);
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "code-cache.h"
+#include "module-bundle.h"
+
+#include <platform/filesystem.h>
+
+#include <napa/log.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+using namespace napa;
+using namespace napa::module;
+
+namespace {
+
+    /// <summary> Marks files written by this cache, the version is bumped when the layout changes. </summary>
+    constexpr uint64_t CODE_CACHE_FILE_MAGIC = 0x3130434143415041ull;
+
+    constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+}
+
+CodeCache::CodeCache(std::string directory) : _directory(std::move(directory)) {}
+
+CodeCache& CodeCache::GetInstance() {
+    static CodeCache instance;
+    return instance;
+}
+
+void CodeCache::SetDirectory(std::string directory) {
+    if (!directory.empty() && !filesystem::MakeDirectories(directory)) {
+        LOG_WARNING("CodeCache", "Failed to create code cache directory \"%s\", code is cached in memory only.", directory.c_str());
+        directory.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _directory = std::move(directory);
+}
+
+CodeCache::Data CodeCache::Get(const std::string& path, uint64_t contentHash) {
+    std::unique_lock<std::mutex> lock(_lock);
+
+    auto iter = _entries.find(path);
+    if (iter != _entries.end() && iter->second.contentHash == contentHash) {
+        return iter->second.data;
+    }
+
+    for (const auto& bundle : _bundles) {
+        auto data = bundle->GetCode(path, contentHash);
+        if (data != nullptr) {
+            _entries[path] = Entry{ contentHash, data };
+            return data;
+        }
+    }
+
+    if (_directory.empty()) {
+        return nullptr;
+    }
+
+    // Reading the file under the lock lets only one worker load it, the others get it from memory.
+    auto data = ReadFile(_directory, path, contentHash);
+    if (data != nullptr) {
+        _entries[path] = Entry{ contentHash, data };
+    }
+    return data;
+}
+
+void CodeCache::Insert(const std::string& path, uint64_t contentHash, std::string data) {
+    auto shared = std::make_shared<const std::string>(std::move(data));
+
+    std::string directory;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto& entry = _entries[path];
+        if (entry.data != nullptr && entry.contentHash == contentHash) {
+            // Another worker compiled the same content first.
+            return;
+        }
+        entry = Entry{ contentHash, shared };
+        directory = _directory;
+    }
+
+    if (!directory.empty()) {
+        WriteFile(directory, path, contentHash, *shared);
+    }
+}
+
+void CodeCache::Remove(const std::string& path, uint64_t contentHash) {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto iter = _entries.find(path);
+    if (iter != _entries.end() && iter->second.contentHash == contentHash) {
+        _entries.erase(iter);
+    }
+
+    if (!_directory.empty()) {
+        std::remove(GetFilePath(_directory, path).c_str());
+    }
+}
+
+void CodeCache::AddBundle(std::shared_ptr<const ModuleBundle> bundle) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _bundles.emplace_back(std::move(bundle));
+}
+
+std::vector<std::pair<std::string, CodeCache::Entry>> CodeCache::GetEntries() {
+    std::lock_guard<std::mutex> lock(_lock);
+    return std::vector<std::pair<std::string, Entry>>(_entries.begin(), _entries.end());
+}
+
+uint64_t CodeCache::HashContent(const char* content, size_t size) {
+    // FNV-1a, the hash only tells contents apart and doesn't need to resist collisions on purpose.
+    auto hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(content[i]);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+std::string CodeCache::GetFilePath(const std::string& directory, const std::string& path) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.codecache",
+        static_cast<unsigned long long>(HashContent(path.data(), path.size())));
+
+    return (filesystem::Path(directory) / name).String();
+}
+
+CodeCache::Data CodeCache::ReadFile(const std::string& directory, const std::string& path, uint64_t contentHash) {
+    std::ifstream file(GetFilePath(directory, path), std::ios::binary);
+    if (!file) {
+        return nullptr;
+    }
+
+    uint64_t header[2];
+    if (!file.read(reinterpret_cast<char*>(header), sizeof(header))
+        || header[0] != CODE_CACHE_FILE_MAGIC
+        || header[1] != contentHash) {
+        return nullptr;
+    }
+
+    auto data = std::make_shared<std::string>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (data->empty()) {
+        return nullptr;
+    }
+    return data;
+}
+
+void CodeCache::WriteFile(const std::string& directory, const std::string& path, uint64_t contentHash, const std::string& data) {
+    auto filePath = GetFilePath(directory, path);
+
+    std::stringstream tempPath;
+    tempPath << filePath << "." << std::this_thread::get_id() << "."
+        << std::chrono::steady_clock::now().time_since_epoch().count() << ".tmp";
+
+    {
+        std::ofstream file(tempPath.str(), std::ios::binary | std::ios::trunc);
+        uint64_t header[2] = { CODE_CACHE_FILE_MAGIC, contentHash };
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(data.data(), data.size());
+        if (!file.good()) {
+            file.close();
+            std::remove(tempPath.str().c_str());
+            LOG_WARNING("CodeCache", "Failed to write code cache file for \"%s\".", path.c_str());
+            return;
+        }
+    }
+
+    // Rename replaces the file in one step, a reader sees either the old or the new entry.
+    // Windows doesn't rename over an existing file, so the old one is removed first there.
+    if (std::rename(tempPath.str().c_str(), filePath.c_str()) != 0) {
+        std::remove(filePath.c_str());
+        if (std::rename(tempPath.str().c_str(), filePath.c_str()) != 0) {
+            std::remove(tempPath.str().c_str());
+        }
+    }
+}
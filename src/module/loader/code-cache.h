@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace napa {
+namespace module {
+
+    class ModuleBundle;
+
+    /// <summary>
+    ///     Process wide cache of compiled Javascript modules, shared by the workers of all zones.
+    ///     Entries are keyed by module path and content hash, so a changed file never gets stale code.
+    /// </summary>
+    /// <remarks> When a directory is set, entries are persisted there and survive process restarts. </remarks>
+    class CodeCache {
+    public:
+
+        /// <summary> Compiled code produced by V8. </summary>
+        using Data = std::shared_ptr<const std::string>;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="directory"> Directory that persists the entries, empty to keep them in memory only. </param>
+        explicit CodeCache(std::string directory = "");
+
+        /// <summary> Non-copyable. </summary>
+        CodeCache(const CodeCache&) = delete;
+        CodeCache& operator=(const CodeCache&) = delete;
+
+        /// <summary> Returns the cache used by the module loaders. </summary>
+        static CodeCache& GetInstance();
+
+        /// <summary> Sets the directory that persists the entries, empty to keep them in memory only. </summary>
+        void SetDirectory(std::string directory);
+
+        /// <summary> Looks up the compiled code of a module, loading it from the directory on a memory miss. </summary>
+        /// <param name="path"> Module path. </param>
+        /// <param name="contentHash"> Hash of the module source, see HashContent. </param>
+        /// <returns> The compiled code, nullptr if it's not cached. </returns>
+        Data Get(const std::string& path, uint64_t contentHash);
+
+        /// <summary> Caches the compiled code of a module, replacing the code of an older content. </summary>
+        /// <param name="path"> Module path. </param>
+        /// <param name="contentHash"> Hash of the module source, see HashContent. </param>
+        /// <param name="data"> The compiled code. </param>
+        void Insert(const std::string& path, uint64_t contentHash, std::string data);
+
+        /// <summary> Drops the compiled code of a module, e.g. when V8 rejected it. </summary>
+        void Remove(const std::string& path, uint64_t contentHash);
+
+        /// <summary> Returns the hash identifying a module source. </summary>
+        static uint64_t HashContent(const char* content, size_t size);
+
+        /// <summary> The compiled code of the latest content of a module. </summary>
+        struct Entry {
+            uint64_t contentHash;
+            Data data;
+        };
+
+        /// <summary> Serves the compiled code of a bundle, on a memory miss before the directory is looked up. </summary>
+        void AddBundle(std::shared_ptr<const ModuleBundle> bundle);
+
+        /// <summary> Returns the module paths and compiled code held in memory. </summary>
+        std::vector<std::pair<std::string, Entry>> GetEntries();
+
+    private:
+
+        /// <summary> Returns the file persisting the entry of a module. </summary>
+        static std::string GetFilePath(const std::string& directory, const std::string& path);
+
+        /// <summary> Reads a persisted entry, returns nullptr if it's missing or for another content. </summary>
+        static Data ReadFile(const std::string& directory, const std::string& path, uint64_t contentHash);
+
+        /// <summary> Persists an entry, replacing the file atomically so concurrent processes never read a partial one. </summary>
+        static void WriteFile(const std::string& directory, const std::string& path, uint64_t contentHash, const std::string& data);
+
+        std::mutex _lock;
+        std::string _directory;
+        std::unordered_map<std::string, Entry> _entries;
+        std::vector<std::shared_ptr<const ModuleBundle>> _bundles;
+    };
+
+}   // End of namespace module.
+}   // End of namespace napa.
@@ -0,0 +1,364 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "file-status-cache.h"
+
+#include <platform/platform.h>
+
+#include <napa/log.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+
+#ifdef OS_LINUX
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace napa;
+using namespace napa::module;
+
+namespace {
+
+    /// <summary> What a path was found to be. </summary>
+    enum class FileKind : uint8_t {
+        Missing,
+        File,
+        Directory,
+        Other
+    };
+
+    FileKind Probe(const filesystem::Path& path) {
+        filesystem::FileStatus status;
+        if (!filesystem::GetFileStatus(path, status)) {
+            return FileKind::Missing;
+        }
+        return status.isFile ? FileKind::File : (status.isDirectory ? FileKind::Directory : FileKind::Other);
+    }
+
+    /// <summary> Splits a path into the directory holding it and its name in that directory. </summary>
+    void SplitPath(const std::string& path, std::string& directory, std::string& name) {
+        auto pos = path.find_last_of("/\\");
+        if (pos == std::string::npos) {
+            directory = ".";
+            name = path;
+        } else {
+            directory = path.substr(0, pos);
+            name = path.substr(pos + 1);
+        }
+    }
+
+    /// <summary> Tell if a path is a directory or inside it. </summary>
+    bool IsInDirectory(const std::string& path, const std::string& directory) {
+        return path.size() >= directory.size()
+            && path.compare(0, directory.size(), directory) == 0
+            && (path.size() == directory.size() || path[directory.size()] == '/' || path[directory.size()] == '\\');
+    }
+}
+
+class FileStatusCache::FileStatusCacheImpl {
+public:
+    explicit FileStatusCacheImpl(FileStatusCacheMode mode);
+    ~FileStatusCacheImpl();
+
+    void SetMode(FileStatusCacheMode mode);
+    FileStatusCacheMode GetMode() const;
+    FileKind GetKind(const filesystem::Path& path);
+    void Invalidate(const std::string& directory);
+    void Clear();
+
+private:
+
+    /// <summary> Cached statuses of the entries of a directory. </summary>
+    struct Directory {
+        std::unordered_map<std::string, FileKind> entries;
+        int watch = -1;
+    };
+
+    /// <summary> Drops the statuses of a directory entry and of everything cached below it. Needs the exclusive lock. </summary>
+    void InvalidateEntry(const std::string& directory, const std::string& name);
+
+    /// <summary> Drops cached directories matching a condition, removing their watches. Needs the exclusive lock. </summary>
+    template <typename Predicate>
+    void EraseDirectories(Predicate predicate);
+
+    bool StartWatching();
+    void StopWatching();
+    void RunWatcher();
+
+    mutable std::shared_timed_mutex _lock;
+    std::unordered_map<std::string, Directory> _directories;
+    FileStatusCacheMode _mode;
+
+    /// <summary> Incremented by invalidations, a status probed across one is not cached. </summary>
+    std::atomic<uint64_t> _generation;
+
+    int _inotify;
+    int _stopPipe[2];
+    std::thread _watcher;
+    std::unordered_map<int, std::string> _watches;
+};
+
+FileStatusCache::FileStatusCache(FileStatusCacheMode mode) : _impl(std::make_unique<FileStatusCacheImpl>(mode)) {}
+
+FileStatusCache::~FileStatusCache() = default;
+
+FileStatusCache& FileStatusCache::GetInstance() {
+    static FileStatusCache instance;
+    return instance;
+}
+
+void FileStatusCache::SetMode(FileStatusCacheMode mode) {
+    _impl->SetMode(mode);
+}
+
+FileStatusCacheMode FileStatusCache::GetMode() const {
+    return _impl->GetMode();
+}
+
+bool FileStatusCache::IsRegularFile(const filesystem::Path& path) {
+    return _impl->GetKind(path) == FileKind::File;
+}
+
+bool FileStatusCache::IsDirectory(const filesystem::Path& path) {
+    return _impl->GetKind(path) == FileKind::Directory;
+}
+
+void FileStatusCache::Invalidate(const std::string& directory) {
+    _impl->Invalidate(directory);
+}
+
+void FileStatusCache::Clear() {
+    _impl->Clear();
+}
+
+FileStatusCache::FileStatusCacheImpl::FileStatusCacheImpl(FileStatusCacheMode mode)
+    : _mode(FileStatusCacheMode::Off), _generation(0), _inotify(-1), _stopPipe{ -1, -1 } {
+    SetMode(mode);
+}
+
+FileStatusCache::FileStatusCacheImpl::~FileStatusCacheImpl() {
+    StopWatching();
+}
+
+void FileStatusCache::FileStatusCacheImpl::SetMode(FileStatusCacheMode mode) {
+    StopWatching();
+
+    if (mode == FileStatusCacheMode::Watch && !StartWatching()) {
+        LOG_WARNING("Module", "Can't watch module directories, file statuses are not cached.");
+        mode = FileStatusCacheMode::Off;
+    }
+
+    std::unique_lock<std::shared_timed_mutex> lock(_lock);
+    _directories.clear();
+    _generation++;
+    _mode = mode;
+}
+
+FileStatusCacheMode FileStatusCache::FileStatusCacheImpl::GetMode() const {
+    std::shared_lock<std::shared_timed_mutex> lock(_lock);
+    return _mode;
+}
+
+FileKind FileStatusCache::FileStatusCacheImpl::GetKind(const filesystem::Path& path) {
+    std::string directoryPath, name;
+    SplitPath(path.String(), directoryPath, name);
+
+    uint64_t generation;
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(_lock);
+        if (_mode == FileStatusCacheMode::Off) {
+            lock.unlock();
+            return Probe(path);
+        }
+
+        auto directory = _directories.find(directoryPath);
+        if (directory != _directories.end()) {
+            auto entry = directory->second.entries.find(name);
+            if (entry != directory->second.entries.end()) {
+                return entry->second;
+            }
+        }
+        generation = _generation;
+    }
+
+#ifdef OS_LINUX
+    // The directory is watched before it's probed, so a change right after the probe isn't missed.
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(_lock);
+        if (_mode == FileStatusCacheMode::Watch && _directories.find(directoryPath) == _directories.end()) {
+            auto watch = ::inotify_add_watch(_inotify, directoryPath.c_str(),
+                IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+            if (watch < 0) {
+                // A missing directory can't be watched, its entries are probed each time.
+                lock.unlock();
+                return Probe(path);
+            }
+            _directories[directoryPath].watch = watch;
+            _watches[watch] = directoryPath;
+        }
+    }
+#endif
+
+    auto kind = Probe(path);
+
+    std::unique_lock<std::shared_timed_mutex> lock(_lock);
+    if (_generation == generation && _mode != FileStatusCacheMode::Off) {
+        _directories[directoryPath].entries.emplace(std::move(name), kind);
+    }
+    return kind;
+}
+
+void FileStatusCache::FileStatusCacheImpl::Invalidate(const std::string& directory) {
+    std::unique_lock<std::shared_timed_mutex> lock(_lock);
+    _generation++;
+
+    EraseDirectories([&directory](const std::string& path) {
+        return IsInDirectory(path, directory);
+    });
+}
+
+void FileStatusCache::FileStatusCacheImpl::Clear() {
+    std::unique_lock<std::shared_timed_mutex> lock(_lock);
+    _generation++;
+
+    EraseDirectories([](const std::string&) { return true; });
+}
+
+void FileStatusCache::FileStatusCacheImpl::InvalidateEntry(const std::string& directory, const std::string& name) {
+    _generation++;
+
+    auto iter = _directories.find(directory);
+    if (iter != _directories.end()) {
+        iter->second.entries.erase(name);
+    }
+
+    // A moved or removed directory takes the statuses cached below it along.
+    auto path = directory + '/' + name;
+    EraseDirectories([&path](const std::string& cached) {
+        return IsInDirectory(cached, path);
+    });
+}
+
+template <typename Predicate>
+void FileStatusCache::FileStatusCacheImpl::EraseDirectories(Predicate predicate) {
+    for (auto iter = _directories.begin(); iter != _directories.end();) {
+        if (!predicate(iter->first)) {
+            ++iter;
+            continue;
+        }
+
+#ifdef OS_LINUX
+        if (iter->second.watch >= 0) {
+            (void)::inotify_rm_watch(_inotify, iter->second.watch);
+            _watches.erase(iter->second.watch);
+        }
+#endif
+        iter = _directories.erase(iter);
+    }
+}
+
+#ifdef OS_LINUX
+
+bool FileStatusCache::FileStatusCacheImpl::StartWatching() {
+    _inotify = ::inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if (_inotify < 0) {
+        return false;
+    }
+
+    if (::pipe(_stopPipe) != 0) {
+        (void)::close(_inotify);
+        _inotify = -1;
+        return false;
+    }
+
+    _watcher = std::thread(&FileStatusCacheImpl::RunWatcher, this);
+    return true;
+}
+
+void FileStatusCache::FileStatusCacheImpl::StopWatching() {
+    if (_inotify < 0) {
+        return;
+    }
+
+    char stop = 0;
+    (void)::write(_stopPipe[1], &stop, sizeof(stop));
+    _watcher.join();
+
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(_lock);
+        EraseDirectories([](const std::string&) { return true; });
+        _mode = FileStatusCacheMode::Off;
+    }
+
+    (void)::close(_inotify);
+    (void)::close(_stopPipe[0]);
+    (void)::close(_stopPipe[1]);
+    _inotify = -1;
+}
+
+void FileStatusCache::FileStatusCacheImpl::RunWatcher() {
+    alignas(inotify_event) char buffer[4096];
+
+    while (true) {
+        pollfd fds[] = { { _inotify, POLLIN, 0 }, { _stopPipe[0], POLLIN, 0 } };
+        if (::poll(fds, 2, -1) < 0) {
+            continue;
+        }
+        if (fds[1].revents != 0) {
+            return;
+        }
+
+        auto length = ::read(_inotify, buffer, sizeof(buffer));
+        if (length <= 0) {
+            continue;
+        }
+
+        std::unique_lock<std::shared_timed_mutex> lock(_lock);
+        for (char* current = buffer; current < buffer + length;) {
+            auto event = reinterpret_cast<inotify_event*>(current);
+            current += sizeof(inotify_event) + event->len;
+
+            if ((event->mask & IN_Q_OVERFLOW) != 0) {
+                // Events were lost, nothing cached can be trusted.
+                _generation++;
+                EraseDirectories([](const std::string&) { return true; });
+                continue;
+            }
+
+            auto watch = _watches.find(event->wd);
+            if (watch == _watches.end()) {
+                continue;
+            }
+            auto directory = watch->second;
+
+            if ((event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) != 0) {
+                _generation++;
+                EraseDirectories([&directory](const std::string& path) {
+                    return IsInDirectory(path, directory);
+                });
+            } else if (event->len > 0) {
+                InvalidateEntry(directory, event->name);
+            }
+        }
+    }
+}
+
+#else
+
+bool FileStatusCache::FileStatusCacheImpl::StartWatching() {
+    return false;
+}
+
+void FileStatusCache::FileStatusCacheImpl::StopWatching() {
+}
+
+void FileStatusCache::FileStatusCacheImpl::RunWatcher() {
+}
+
+#endif
@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <platform/filesystem.h>
+
+#include <memory>
+#include <string>
+
+namespace napa {
+namespace module {
+
+    /// <summary> How long the module resolver trusts the file statuses it probed. </summary>
+    enum class FileStatusCacheMode {
+
+        /// <summary> Statuses are probed on every resolution. </summary>
+        Off,
+
+        /// <summary> Statuses, including missing files, are cached for the life of the process. </summary>
+        Process,
+
+        /// <summary> Statuses are cached until the directory holding them changes, on Linux only. </summary>
+        Watch
+    };
+
+    /// <summary>
+    ///     Process wide cache of the files and directories the module resolvers of all workers probe, so resolving
+    ///     deep dependency trees mostly avoids file system calls. Statuses are grouped by the directory holding them,
+    ///     a change in a watched directory drops the statuses of that directory only.
+    /// </summary>
+    class FileStatusCache {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="mode"> The cache mode, Watch falls back to Off where directories can't be watched. </param>
+        explicit FileStatusCache(FileStatusCacheMode mode = FileStatusCacheMode::Process);
+
+        /// <summary> Stops watching directories. </summary>
+        ~FileStatusCache();
+
+        /// <summary> Non-copyable. </summary>
+        FileStatusCache(const FileStatusCache&) = delete;
+        FileStatusCache& operator=(const FileStatusCache&) = delete;
+
+        /// <summary> Returns the cache used by the module resolvers. </summary>
+        static FileStatusCache& GetInstance();
+
+        /// <summary> Sets the cache mode, dropping the statuses cached so far. </summary>
+        void SetMode(FileStatusCacheMode mode);
+
+        /// <summary> Returns the mode in effect. </summary>
+        FileStatusCacheMode GetMode() const;
+
+        /// <summary> Tell if a path is a regular file. </summary>
+        /// <param name="path"> A normalized path. </param>
+        bool IsRegularFile(const filesystem::Path& path);
+
+        /// <summary> Tell if a path is a directory. </summary>
+        /// <param name="path"> A normalized path. </param>
+        bool IsDirectory(const filesystem::Path& path);
+
+        /// <summary> Drops the cached statuses of the entries of a directory. </summary>
+        void Invalidate(const std::string& directory);
+
+        /// <summary> Drops all cached statuses. </summary>
+        void Clear();
+
+    private:
+        class FileStatusCacheImpl;
+        std::unique_ptr<FileStatusCacheImpl> _impl;
+    };
+
+}   // End of namespace module.
+}   // End of namespace napa.
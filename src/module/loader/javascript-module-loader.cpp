@@ -2,16 +2,29 @@
 // Licensed under the MIT license.
 
 #include "javascript-module-loader.h"
+#include "code-cache.h"
 #include "module-cache.h"
 #include "module-loader-helpers.h"
 
+#include <platform/filesystem.h>
+
 #include <napa/v8-helpers.h>
+#include <v8-extensions/v8-extensions-macros.h>
+
+#include <memory>
+#include <string>
 
 using namespace napa;
 using namespace napa::module;
 
-JavascriptModuleLoader::JavascriptModuleLoader(BuiltInModulesSetter builtInModulesSetter, ModuleCache& moduleCache)
-    : _builtInModulesSetter(std::move(builtInModulesSetter)) , _moduleCache(moduleCache) {}
+JavascriptModuleLoader::JavascriptModuleLoader(BuiltInModulesSetter builtInModulesSetter,
+                                               ModuleCache& moduleCache,
+                                               ModuleRequireCreator requireCreator,
+                                               ModulePrefetcher::Post prefetchPost)
+    : _builtInModulesSetter(std::move(builtInModulesSetter)),
+      _moduleCache(moduleCache),
+      _requireCreator(std::move(requireCreator)),
+      _prefetchPost(std::move(prefetchPost)) {}
 
 bool JavascriptModuleLoader::TryGet(const std::string& path, v8::Local<v8::Value> arg, v8::Local<v8::Object>& module) {
     auto isolate = v8::Isolate::GetCurrent();
@@ -23,11 +36,35 @@ bool JavascriptModuleLoader::TryGet(const std::string& path, v8::Local<v8::Value
     if (!fromContent) {
         source = module_loader_helpers::ReadModuleFile(path);
         JS_ENSURE_WITH_RETURN(isolate, !source.IsEmpty(), false, "Can't read Javascript module: \"%s\"", path.c_str());
+
+        // Dependencies are fetched on the pool while the module runs up to its requires.
+        if (_prefetchPost != nullptr) {
+            ModulePrefetcher::GetInstance().Prefetch(path, _prefetchPost);
+        }
     } else {
         JS_ENSURE_WITH_RETURN(isolate, arg->IsString(), false, "The 2nd argument of 'require' must be content of string type.");
         source = v8::Local<v8::String>::Cast(arg);
     }
 
+    v8::Local<v8::Object> exports;
+    auto succeeded = _requireCreator != nullptr ?
+        TryGetInCurrentContext(path, fromContent, source, exports) :
+        TryGetInModuleContext(path, fromContent, source, exports);
+    if (!succeeded) {
+        return false;
+    }
+
+    module = scope.Escape(exports);
+    return true;
+}
+
+bool JavascriptModuleLoader::TryGetInModuleContext(const std::string& path,
+                                                   bool fromContent,
+                                                   v8::Local<v8::String> source,
+                                                   v8::Local<v8::Object>& module) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::EscapableHandleScope scope(isolate);
+
     auto context = isolate->GetCurrentContext();
 
     auto moduleContext = v8::Context::New(isolate);
@@ -48,8 +85,6 @@ bool JavascriptModuleLoader::TryGet(const std::string& path, v8::Local<v8::Value
 
     v8::TryCatch tryCatch(isolate);
     {
-        auto origin = v8::ScriptOrigin(v8_helpers::MakeV8String(isolate, path));
-
         // The wrapper set 'this' reference to module.exports in module's top level code
         v8::Local<v8::String> wrappedSource = v8::String::Concat(
             v8_helpers::MakeV8String(isolate, "(function(){"),
@@ -58,8 +93,9 @@ bool JavascriptModuleLoader::TryGet(const std::string& path, v8::Local<v8::Value
                 v8_helpers::MakeV8String(isolate, "}).apply(module.exports);")
             )
         );
-        auto script = v8::Script::Compile(wrappedSource, &origin);
-        if (script.IsEmpty() || tryCatch.HasCaught()) {
+
+        v8::Local<v8::Script> script;
+        if (!Compile(path, fromContent, wrappedSource).ToLocal(&script) || tryCatch.HasCaught()) {
             tryCatch.ReThrow();
             return false;
         }
@@ -74,4 +110,137 @@ bool JavascriptModuleLoader::TryGet(const std::string& path, v8::Local<v8::Value
     // Export a loaded module.
     module = scope.Escape(module_loader_helpers::ExportModule(moduleContext->Global(), nullptr));
     return true;
-}
\ No newline at end of file
+}
+
+bool JavascriptModuleLoader::TryGetInCurrentContext(const std::string& path,
+                                                    bool fromContent,
+                                                    v8::Local<v8::String> source,
+                                                    v8::Local<v8::Object>& module) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::EscapableHandleScope scope(isolate);
+
+    auto context = isolate->GetCurrentContext();
+
+    // The same module object a module context gets, with a 'require' bound to the module.
+    auto moduleObject = v8::Object::New(isolate);
+    auto exports = v8::Object::New(isolate);
+    auto require = _requireCreator(moduleObject);
+    (void)moduleObject->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "exports"), exports);
+    (void)moduleObject->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "paths"), v8::Array::New(isolate));
+    (void)moduleObject->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "id"), v8_helpers::MakeV8String(isolate, path));
+    (void)moduleObject->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "filename"), v8_helpers::MakeV8String(isolate, path));
+    (void)moduleObject->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "require"), require);
+
+    // To prevent cycle, cache unloaded module first.
+    if (!fromContent) {
+        _moduleCache.Upsert(path, exports);
+    }
+
+    v8::TryCatch tryCatch(isolate);
+    {
+        // Like node.js, module variables are the wrapper parameters and 'this' is module.exports.
+        // The new line keeps a comment on the last line of the source from commenting out the wrapper.
+        v8::Local<v8::String> wrappedSource = v8::String::Concat(
+            v8_helpers::MakeV8String(isolate, "(function(exports, require, module, __filename, __dirname){"),
+            v8::String::Concat(
+                source,
+                v8_helpers::MakeV8String(isolate, "\n})")
+            )
+        );
+
+        v8::Local<v8::Script> script;
+        if (!Compile(path, fromContent, wrappedSource).ToLocal(&script) || tryCatch.HasCaught()) {
+            tryCatch.ReThrow();
+            return false;
+        }
+
+        v8::Local<v8::Value> wrapper;
+        if (!script->Run(context).ToLocal(&wrapper) || tryCatch.HasCaught()) {
+            tryCatch.ReThrow();
+            return false;
+        }
+
+        auto dirname = filesystem::Path(path).Parent().Normalize().String();
+        v8::Local<v8::Value> argv[] = {
+            exports,
+            require,
+            moduleObject,
+            v8_helpers::MakeV8String(isolate, path),
+            v8_helpers::MakeV8String(isolate, dirname)
+        };
+
+        auto run = v8::Local<v8::Function>::Cast(wrapper)->Call(context, exports, static_cast<int>(sizeof(argv) / sizeof(argv[0])), argv);
+        if (run.IsEmpty() || tryCatch.HasCaught()) {
+            tryCatch.ReThrow();
+            return false;
+        }
+    }
+
+    // Export a loaded module, the module may have replaced module.exports.
+    auto exported = moduleObject->Get(context, v8_helpers::MakeV8String(isolate, "exports")).ToLocalChecked();
+    JS_ENSURE_WITH_RETURN(isolate, exported->IsObject(), false, "module.exports of \"%s\" must be an object.", path.c_str());
+
+    module = scope.Escape(v8::Local<v8::Object>::Cast(exported));
+    return true;
+}
+
+v8::MaybeLocal<v8::Script> JavascriptModuleLoader::Compile(const std::string& path,
+                                                          bool fromContent,
+                                                          v8::Local<v8::String> wrappedSource) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::EscapableHandleScope scope(isolate);
+
+    auto context = isolate->GetCurrentContext();
+    auto origin = v8::ScriptOrigin(v8_helpers::MakeV8String(isolate, path));
+
+    // Modules are compiled once per process, workers reuse the code compiled by the first of them.
+    // Modules from content, like functions sent across zones, share a path with other contents,
+    // so each content gets its own entry instead of replacing the code of the previous one.
+    auto& codeCache = CodeCache::GetInstance();
+    v8::String::Utf8Value utf8Source(wrappedSource);
+    auto contentHash = CodeCache::HashContent(*utf8Source, utf8Source.length());
+    auto cacheKey = fromContent ? path + "#" + std::to_string(contentHash) : path;
+    auto cachedCode = codeCache.Get(cacheKey, contentHash);
+
+    // The source owns the cached data object, not the buffer, which cachedCode keeps alive.
+    v8::ScriptCompiler::Source scriptSource(
+        wrappedSource,
+        origin,
+        cachedCode == nullptr ? nullptr : new v8::ScriptCompiler::CachedData(
+            reinterpret_cast<const uint8_t*>(cachedCode->data()), static_cast<int>(cachedCode->size())));
+
+    auto options = v8::ScriptCompiler::kNoCompileOptions;
+    if (cachedCode != nullptr) {
+        options = v8::ScriptCompiler::kConsumeCodeCache;
+    }
+#if !(V8_VERSION_CHECK_FOR_CREATE_CODE_CACHE)
+    else {
+        options = v8::ScriptCompiler::kProduceCodeCache;
+    }
+#endif
+
+    v8::Local<v8::Script> script;
+    if (!v8::ScriptCompiler::Compile(context, &scriptSource, options).ToLocal(&script)) {
+        return v8::MaybeLocal<v8::Script>();
+    }
+
+    if (cachedCode != nullptr) {
+        // V8 rejects code from another V8 version or flags and compiles the source instead.
+        if (scriptSource.GetCachedData()->rejected) {
+            codeCache.Remove(cacheKey, contentHash);
+        }
+    } else {
+#if V8_VERSION_CHECK_FOR_CREATE_CODE_CACHE
+        std::unique_ptr<v8::ScriptCompiler::CachedData> producedCode(
+            v8::ScriptCompiler::CreateCodeCache(script->GetUnboundScript()));
+        auto producedData = producedCode.get();
+#else
+        auto producedData = scriptSource.GetCachedData();
+#endif
+        if (producedData != nullptr && producedData->length > 0) {
+            codeCache.Insert(cacheKey, contentHash, std::string(reinterpret_cast<const char*>(producedData->data), producedData->length));
+        }
+    }
+
+    return scope.Escape(script);
+}
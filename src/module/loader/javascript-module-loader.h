@@ -4,6 +4,7 @@
 #pragma once
 
 #include "module-file-loader.h"
+#include "module-prefetcher.h"
 
 #include <string>
 
@@ -14,13 +15,22 @@ namespace module {
     class ModuleCache;
 
     /// <summary> It loads a module from javascript file or content from arg. </summary>
+    /// <remarks>
+    ///     By default each module runs in its own V8 context. With a require creator, modules are wrapped
+    ///     in a function like node.js does and run in the current context, which saves a context per module.
+    /// </remarks>
     class JavascriptModuleLoader : public ModuleFileLoader {
     public:
 
         /// <summary> Constructor. </summary>
         /// <param name="builtInSetter"> Built-in modules registerer. </param>
         /// <param name="moduleCache"> Cache for all modules. </param>
-        JavascriptModuleLoader(BuiltInModulesSetter builtInModulesSetter, ModuleCache& moduleCache);
+        /// <param name="requireCreator"> Creates 'require' of function wrapped modules, nullptr for a context per module. </param>
+        /// <param name="prefetchPost"> Runs the prefetch of dependencies of module files on a pool, nullptr to not prefetch. </param>
+        JavascriptModuleLoader(BuiltInModulesSetter builtInModulesSetter,
+                               ModuleCache& moduleCache,
+                               ModuleRequireCreator requireCreator = nullptr,
+                               ModulePrefetcher::Post prefetchPost = nullptr);
 
         /// <summary> It loads a module from javascript file. </summary>
         /// <param name="path"> Module path called by require(). </param>
@@ -31,11 +41,27 @@ namespace module {
 
     private:
 
+        /// <summary> It loads a module in a context of its own. </summary>
+        bool TryGetInModuleContext(const std::string& path, bool fromContent, v8::Local<v8::String> source, v8::Local<v8::Object>& module);
+
+        /// <summary> It loads a module wrapped in a function, in the current context. </summary>
+        bool TryGetInCurrentContext(const std::string& path, bool fromContent, v8::Local<v8::String> source, v8::Local<v8::Object>& module);
+
+        /// <summary> It compiles the wrapped source of a module, through the code cache for module files. </summary>
+        /// <returns> The compiled script, empty if compilation threw. </returns>
+        v8::MaybeLocal<v8::Script> Compile(const std::string& path, bool fromContent, v8::Local<v8::String> wrappedSource);
+
         /// Built-in modules registerer.
         BuiltInModulesSetter _builtInModulesSetter;
 
         /// Module cache instance.
         ModuleCache& _moduleCache;
+
+        /// Creates 'require' of function wrapped modules, nullptr when modules get their own context.
+        ModuleRequireCreator _requireCreator;
+
+        /// Runs the prefetch of dependencies on a pool, nullptr when they are not prefetched.
+        ModulePrefetcher::Post _prefetchPost;
     };
 
 }   // End of namespace module.
@@ -0,0 +1,45 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "json-module-cache.h"
+
+using namespace napa;
+using namespace napa::module;
+
+JsonModuleCache& JsonModuleCache::GetInstance() {
+    static JsonModuleCache instance;
+    return instance;
+}
+
+void JsonModuleCache::SetEnabled(bool enabled) {
+    _enabled = enabled;
+}
+
+bool JsonModuleCache::IsEnabled() const {
+    return _enabled;
+}
+
+JsonModuleCache::Data JsonModuleCache::Get(const std::string& path, const Creator& create) {
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto& slot = _entries[path];
+        if (slot == nullptr) {
+            slot = std::make_shared<Entry>();
+        }
+        entry = slot;
+    }
+
+    // Other workers requiring the same file wait for the first one, while modules of other files go on.
+    std::lock_guard<std::mutex> lock(entry->lock);
+    if (entry->data != nullptr) {
+        return entry->data;
+    }
+
+    auto data = create();
+    if (!data.empty()) {
+        entry->data = std::make_shared<const std::string>(std::move(data));
+    }
+    return nullptr;
+}
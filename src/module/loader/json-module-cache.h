@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace napa {
+namespace module {
+
+    /// <summary>
+    ///     Process wide cache of JSON modules in V8's serialization format, so a JSON file is parsed by the first
+    ///     worker that requires it and deserialized by the others. Isolates don't share heaps, each worker still gets
+    ///     its own copy of the value, without the cost of parsing its text.
+    /// </summary>
+    /// <remarks> Like module sources, an entry is immutable once created, a changed file needs a new process. </remarks>
+    class JsonModuleCache {
+    public:
+
+        /// <summary> Serialized value shared by all workers. </summary>
+        using Data = std::shared_ptr<const std::string>;
+
+        /// <summary> Creates the serialized value of a module, an empty string if it can't be serialized. </summary>
+        using Creator = std::function<std::string()>;
+
+        /// <summary> Constructor. </summary>
+        JsonModuleCache() = default;
+
+        /// <summary> Non-copyable. </summary>
+        JsonModuleCache(const JsonModuleCache&) = delete;
+        JsonModuleCache& operator=(const JsonModuleCache&) = delete;
+
+        /// <summary> Returns the cache used by the JSON module loader. </summary>
+        static JsonModuleCache& GetInstance();
+
+        /// <summary> Sets whether JSON modules are cached, they are parsed by each worker otherwise. </summary>
+        void SetEnabled(bool enabled);
+
+        /// <summary> Returns whether JSON modules are cached. </summary>
+        bool IsEnabled() const;
+
+        /// <summary> Returns the serialized value of a module, creating it on first use. </summary>
+        /// <param name="path"> Module file path. </param>
+        /// <param name="create"> Creates the serialized value, called by the first caller only. </param>
+        /// <returns> The serialized value, nullptr if the caller created it or if it couldn't be created. </returns>
+        /// <remarks>
+        ///     Other callers for the same path wait until the value is created. Failures are not cached, a later caller
+        ///     creates the value again. The creator must not call back into the cache.
+        /// </remarks>
+        Data Get(const std::string& path, const Creator& create);
+
+    private:
+
+        /// <summary> A JSON module, its lock is held while the first worker creates its value. </summary>
+        struct Entry {
+            std::mutex lock;
+            Data data;
+        };
+
+        std::atomic<bool> _enabled{ false };
+        std::mutex _lock;
+        std::unordered_map<std::string, std::shared_ptr<Entry>> _entries;
+    };
+
+}   // End of namespace module.
+}   // End of namespace napa.
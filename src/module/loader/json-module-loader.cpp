@@ -2,23 +2,101 @@
 // Licensed under the MIT license.
 
 #include "json-module-loader.h"
+#include "json-module-cache.h"
 #include "module-loader-helpers.h"
 
 #include <napa/v8-helpers.h>
+#include <v8-extensions/v8-extensions-macros.h>
+
+#include <cstdlib>
 
 using namespace napa;
 using namespace napa::module;
 
+namespace {
+
+    v8::MaybeLocal<v8::Value> ParseJsonModule(const std::string& path) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::EscapableHandleScope scope(isolate);
+
+        auto source = module_loader_helpers::ReadModuleFile(path);
+        if (source.IsEmpty()) {
+            return v8::MaybeLocal<v8::Value>();
+        }
+        v8::Local<v8::Value> json;
+        if (!v8::JSON::Parse(isolate, source).ToLocal(&json)) {
+            return v8::MaybeLocal<v8::Value>();
+        }
+        return scope.Escape(json);
+    }
+
+#if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+
+    std::string SerializeJsonModule(v8::Local<v8::Value> json) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::HandleScope scope(isolate);
+
+        v8::ValueSerializer serializer(isolate);
+        serializer.WriteHeader();
+        if (!serializer.WriteValue(isolate->GetCurrentContext(), json).FromMaybe(false)) {
+            return std::string();
+        }
+
+        // Without a delegate, the serializer allocates its buffer with realloc.
+        auto buffer = serializer.Release();
+        std::string data(reinterpret_cast<const char*>(buffer.first), buffer.second);
+        std::free(buffer.first);
+        return data;
+    }
+
+    v8::MaybeLocal<v8::Value> DeserializeJsonModule(const std::string& data) {
+        auto isolate = v8::Isolate::GetCurrent();
+        v8::EscapableHandleScope scope(isolate);
+        auto context = isolate->GetCurrentContext();
+
+        v8::ValueDeserializer deserializer(isolate, reinterpret_cast<const uint8_t*>(data.data()), data.size());
+        if (!deserializer.ReadHeader(context).FromMaybe(false)) {
+            return v8::MaybeLocal<v8::Value>();
+        }
+        v8::Local<v8::Value> json;
+        if (!deserializer.ReadValue(context).ToLocal(&json)) {
+            return v8::MaybeLocal<v8::Value>();
+        }
+        return scope.Escape(json);
+    }
+
+#endif
+
+}
+
 bool JsonModuleLoader::TryGet(const std::string& path, v8::Local<v8::Value> arg, v8::Local<v8::Object>& module) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::EscapableHandleScope scope(isolate);
 
-    auto source = module_loader_helpers::ReadModuleFile(path);
-    JS_ENSURE_WITH_RETURN(isolate, !source.IsEmpty(), false, "Can't read JSON module: \"%s\"", path.c_str());
+    v8::MaybeLocal<v8::Value> json;
+#if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
+    auto& cache = JsonModuleCache::GetInstance();
+    if (cache.IsEnabled()) {
+        // The first worker parses the file and serializes the value for the others, which deserialize it.
+        auto data = cache.Get(path, [&path, &json]() {
+            json = ParseJsonModule(path);
+            return json.IsEmpty() ? std::string() : SerializeJsonModule(json.ToLocalChecked());
+        });
+        if (data != nullptr) {
+            json = DeserializeJsonModule(*data);
+        }
+    } else {
+        json = ParseJsonModule(path);
+    }
+#else
+    json = ParseJsonModule(path);
+#endif
 
-    auto json = v8::JSON::Parse(isolate, source).ToLocalChecked();
-    JS_ENSURE_WITH_RETURN(isolate, !json.IsEmpty(), false, "Can't parse JSON from \"%s\"", path.c_str());
+    // Reading or parsing the file threw an exception already.
+    if (json.IsEmpty()) {
+        return false;
+    }
 
-    module = scope.Escape(json->ToObject(isolate->GetCurrentContext()).ToLocalChecked());
+    module = scope.Escape(json.ToLocalChecked()->ToObject(isolate->GetCurrentContext()).ToLocalChecked());
     return true;
 }
@@ -0,0 +1,255 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "module-bundle.h"
+
+#include <napa/log.h>
+
+#include <cstring>
+#include <fstream>
+#include <mutex>
+
+using namespace napa;
+using namespace napa::module;
+
+namespace {
+
+    /// <summary> Marks bundle files, the version is bumped when the layout changes. </summary>
+    constexpr uint64_t MODULE_BUNDLE_FILE_MAGIC = 0x31304c444e425041ull;
+
+    /// <summary>
+    ///     The file starts with the magic and the numbers of resolutions, sources and compiled code, followed by
+    ///     the records of each in that order. Numbers are 64-bit and strings are prefixed by their 64-bit length.
+    /// </summary>
+    class BundleWriter {
+    public:
+        explicit BundleWriter(std::ofstream& file) : _file(file) {}
+
+        void WriteNumber(uint64_t value) {
+            _file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void WriteString(const std::string& value) {
+            WriteNumber(value.size());
+            _file.write(value.data(), value.size());
+        }
+
+    private:
+        std::ofstream& _file;
+    };
+
+    /// <summary> Reads the records of a mapped bundle, failing on any record past the end of the file. </summary>
+    class BundleReader {
+    public:
+        BundleReader(const char* data, size_t size) : _data(data), _size(size), _offset(0) {}
+
+        bool ReadNumber(uint64_t& value) {
+            if (_size - _offset < sizeof(value)) {
+                return false;
+            }
+            std::memcpy(&value, _data + _offset, sizeof(value));
+            _offset += sizeof(value);
+            return true;
+        }
+
+        bool ReadSpan(const char*& data, size_t& size) {
+            uint64_t length;
+            if (!ReadNumber(length) || _size - _offset < length) {
+                return false;
+            }
+            data = _data + _offset;
+            size = static_cast<size_t>(length);
+            _offset += size;
+            return true;
+        }
+
+        bool ReadString(std::string& value) {
+            const char* data;
+            size_t size;
+            if (!ReadSpan(data, size)) {
+                return false;
+            }
+            value.assign(data, size);
+            return true;
+        }
+
+        bool IsEnd() const {
+            return _offset == _size;
+        }
+
+    private:
+        const char* _data;
+        size_t _size;
+        size_t _offset;
+    };
+}
+
+bool ModuleBundle::Write(const std::string& path,
+                         ModuleResolverCache& resolverCache,
+                         ModuleSourceCache& sourceCache,
+                         CodeCache& codeCache) {
+    auto resolutions = resolverCache.GetEntries();
+    auto sources = sourceCache.GetEntries();
+    auto code = codeCache.GetEntries();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        LOG_ERROR("ModuleBundle", "Failed to create module bundle \"%s\".", path.c_str());
+        return false;
+    }
+
+    BundleWriter writer(file);
+    writer.WriteNumber(MODULE_BUNDLE_FILE_MAGIC);
+    writer.WriteNumber(resolutions.size());
+    writer.WriteNumber(sources.size());
+    writer.WriteNumber(code.size());
+
+    for (const auto& resolution : resolutions) {
+        writer.WriteString(resolution.name);
+        writer.WriteString(resolution.path);
+        writer.WriteNumber(static_cast<uint64_t>(resolution.moduleInfo.type));
+        writer.WriteString(resolution.moduleInfo.fullPath);
+        writer.WriteString(resolution.moduleInfo.packageJsonPath);
+    }
+
+    for (const auto& source : sources) {
+        writer.WriteString(source.first);
+        writer.WriteString(*source.second);
+    }
+
+    for (const auto& entry : code) {
+        writer.WriteString(entry.first);
+        writer.WriteNumber(entry.second.contentHash);
+        writer.WriteString(*entry.second.data);
+    }
+
+    if (!file.good()) {
+        LOG_ERROR("ModuleBundle", "Failed to write module bundle \"%s\".", path.c_str());
+        return false;
+    }
+
+    NAPA_DEBUG("ModuleBundle", "Wrote module bundle \"%s\" with %zu resolutions, %zu sources and %zu compiled modules.",
+        path.c_str(), resolutions.size(), sources.size(), code.size());
+    return true;
+}
+
+std::shared_ptr<const ModuleBundle> ModuleBundle::Open(const std::string& path) {
+    auto file = std::make_unique<filesystem::MappedFile>(path);
+    if (!file->IsOpen()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<ModuleBundle> bundle(new ModuleBundle(std::move(file)));
+    if (!bundle->Parse()) {
+        return nullptr;
+    }
+    return bundle;
+}
+
+void ModuleBundle::Install(std::shared_ptr<const ModuleBundle> bundle,
+                           ModuleResolverCache& resolverCache,
+                           ModuleSourceCache& sourceCache,
+                           CodeCache& codeCache) {
+    for (const auto& resolution : bundle->GetResolutions()) {
+        resolverCache.Insert(resolution.name.c_str(), resolution.path.c_str(), resolution.moduleInfo);
+    }
+    sourceCache.AddBundle(bundle);
+    codeCache.AddBundle(std::move(bundle));
+}
+
+bool ModuleBundle::Install(const std::string& path) {
+    static std::mutex mutex;
+    static std::unordered_map<std::string, bool> installed;
+
+    // Zones sharing a bundle install it once, a bundle that failed to open is not retried either.
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto iter = installed.find(path);
+    if (iter != installed.end()) {
+        return iter->second;
+    }
+
+    auto bundle = Open(path);
+    if (bundle == nullptr) {
+        LOG_ERROR("ModuleBundle", "Failed to open module bundle \"%s\", modules are loaded from their files.", path.c_str());
+    } else {
+        Install(bundle, ModuleResolverCache::GetInstance(), ModuleSourceCache::GetInstance(), CodeCache::GetInstance());
+        NAPA_DEBUG("ModuleBundle", "Installed module bundle \"%s\".", path.c_str());
+    }
+
+    installed.emplace(path, bundle != nullptr);
+    return bundle != nullptr;
+}
+
+ModuleSourceCache::Source ModuleBundle::GetSource(const std::string& path) const {
+    auto iter = _sources.find(path);
+    if (iter == _sources.end()) {
+        return nullptr;
+    }
+    return std::make_shared<const std::string>(iter->second.data, iter->second.size);
+}
+
+CodeCache::Data ModuleBundle::GetCode(const std::string& path, uint64_t contentHash) const {
+    auto iter = _code.find(path);
+    if (iter == _code.end() || iter->second.contentHash != contentHash) {
+        return nullptr;
+    }
+    return std::make_shared<const std::string>(iter->second.data.data, iter->second.data.size);
+}
+
+const std::vector<ModuleResolverCache::Entry>& ModuleBundle::GetResolutions() const {
+    return _resolutions;
+}
+
+ModuleBundle::ModuleBundle(std::unique_ptr<filesystem::MappedFile> file) : _file(std::move(file)) {}
+
+bool ModuleBundle::Parse() {
+    BundleReader reader(static_cast<const char*>(_file->Data()), _file->Size());
+
+    uint64_t magic, resolutionCount, sourceCount, codeCount;
+    if (!reader.ReadNumber(magic)
+        || magic != MODULE_BUNDLE_FILE_MAGIC
+        || !reader.ReadNumber(resolutionCount)
+        || !reader.ReadNumber(sourceCount)
+        || !reader.ReadNumber(codeCount)) {
+        return false;
+    }
+
+    for (uint64_t i = 0; i < resolutionCount; i++) {
+        ModuleResolverCache::Entry resolution;
+        uint64_t type;
+        if (!reader.ReadString(resolution.name)
+            || !reader.ReadString(resolution.path)
+            || !reader.ReadNumber(type)
+            || type >= static_cast<uint64_t>(ModuleType::END_OF_MODULE_TYPE)
+            || !reader.ReadString(resolution.moduleInfo.fullPath)
+            || !reader.ReadString(resolution.moduleInfo.packageJsonPath)) {
+            return false;
+        }
+        resolution.moduleInfo.type = static_cast<ModuleType>(type);
+        _resolutions.emplace_back(std::move(resolution));
+    }
+
+    // Sources and code stay in the mapped file until a module is required.
+    for (uint64_t i = 0; i < sourceCount; i++) {
+        std::string path;
+        Span source;
+        if (!reader.ReadString(path) || !reader.ReadSpan(source.data, source.size)) {
+            return false;
+        }
+        _sources.emplace(std::move(path), source);
+    }
+
+    for (uint64_t i = 0; i < codeCount; i++) {
+        std::string path;
+        Code code;
+        if (!reader.ReadString(path)
+            || !reader.ReadNumber(code.contentHash)
+            || !reader.ReadSpan(code.data.data, code.data.size)) {
+            return false;
+        }
+        _code.emplace(std::move(path), code);
+    }
+
+    return reader.IsEnd();
+}
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "code-cache.h"
+#include "module-resolver-cache.h"
+#include "module-source-cache.h"
+
+#include <platform/filesystem.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace napa {
+namespace module {
+
+    /// <summary>
+    ///     A file holding module resolutions, module sources and compiled code, so workers bootstrap an application
+    ///     without probing and reading its module files. It's written from the module caches of a process that
+    ///     loaded the application, and served from a memory mapping by the module caches of other processes.
+    /// </summary>
+    /// <remarks>
+    ///     Like the caches it fills, a bundle is trusted as is: a module changed after the bundle was written keeps
+    ///     its bundled source, the bundle must be written again. Compiled code is still checked by V8.
+    /// </remarks>
+    class ModuleBundle {
+    public:
+
+        /// <summary> Writes the content of module caches to a bundle file. </summary>
+        /// <param name="path"> Bundle file path, replaced if it exists. </param>
+        /// <returns> False if the file can't be written. </returns>
+        static bool Write(const std::string& path,
+                          ModuleResolverCache& resolverCache,
+                          ModuleSourceCache& sourceCache,
+                          CodeCache& codeCache);
+
+        /// <summary> Maps a bundle file. </summary>
+        /// <returns> The bundle, nullptr if the file can't be mapped or is not a valid bundle. </returns>
+        static std::shared_ptr<const ModuleBundle> Open(const std::string& path);
+
+        /// <summary> Makes module caches serve the content of a bundle. </summary>
+        /// <remarks> Resolutions are copied into the resolver cache, sources and code are read on first use. </remarks>
+        static void Install(std::shared_ptr<const ModuleBundle> bundle,
+                            ModuleResolverCache& resolverCache,
+                            ModuleSourceCache& sourceCache,
+                            CodeCache& codeCache);
+
+        /// <summary> Opens and installs a bundle into the caches used by the module loaders, once per process. </summary>
+        /// <returns> False if the bundle couldn't be opened, modules are then loaded from their files. </returns>
+        static bool Install(const std::string& path);
+
+        /// <summary> Non-copyable. </summary>
+        ModuleBundle(const ModuleBundle&) = delete;
+        ModuleBundle& operator=(const ModuleBundle&) = delete;
+
+        /// <summary> Returns the bundled source of a module file, nullptr if it's not bundled. </summary>
+        ModuleSourceCache::Source GetSource(const std::string& path) const;
+
+        /// <summary> Returns the bundled compiled code of a module, nullptr if it's not bundled for this content. </summary>
+        CodeCache::Data GetCode(const std::string& path, uint64_t contentHash) const;
+
+        /// <summary> Returns the bundled module resolutions. </summary>
+        const std::vector<ModuleResolverCache::Entry>& GetResolutions() const;
+
+    private:
+
+        /// <summary> Bytes inside the mapped file. </summary>
+        struct Span {
+            const char* data;
+            size_t size;
+        };
+
+        /// <summary> Compiled code and the hash of the content it was compiled from. </summary>
+        struct Code {
+            uint64_t contentHash;
+            Span data;
+        };
+
+        /// <summary> Constructor. </summary>
+        explicit ModuleBundle(std::unique_ptr<filesystem::MappedFile> file);
+
+        /// <summary> Indexes the mapped file, returns false if it's not a valid bundle. </summary>
+        bool Parse();
+
+        std::unique_ptr<filesystem::MappedFile> _file;
+        std::vector<ModuleResolverCache::Entry> _resolutions;
+        std::unordered_map<std::string, Span> _sources;
+        std::unordered_map<std::string, Code> _code;
+    };
+
+}   // End of namespace module.
+}   // End of namespace napa.
@@ -2,6 +2,7 @@
 // Licensed under the MIT license.
 
 #include "module-loader-helpers.h" 
+#include "module-source-cache.h"
 
 #include <module/core-modules/node/file-system-helpers.h>
 #include <platform/dll.h>
@@ -169,21 +170,22 @@ v8::Local<v8::String> module_loader_helpers::ReadModuleFile(const std::string& p
     auto isolate = v8::Isolate::GetCurrent();
     v8::EscapableHandleScope scope(isolate);
 
-    std::string content;
+    // Workers of all zones share the sources, the file is read by the first worker that requires it.
+    ModuleSourceCache::Source content;
     try {
-        content = file_system_helpers::ReadFileSync(path);
+        content = ModuleSourceCache::GetInstance().Get(path);
     } catch (const std::exception& ex) {
         isolate->ThrowException(v8::Exception::Error(v8_helpers::MakeV8String(isolate, ex.what())));
         return scope.Escape(v8::Local<v8::String>());
     }
 
     JS_ENSURE_WITH_RETURN(isolate,
-                          !content.empty(),
+                          !content->empty(),
                           scope.Escape(v8::Local<v8::String>()),
                           "\"%s\" is empty",
                           path.c_str());
 
-    return scope.Escape(v8_helpers::MakeV8String(isolate, content));
+    return scope.Escape(v8_helpers::MakeV8String(isolate, *content));
 }
 
 namespace {
@@ -9,17 +9,20 @@
 #include "json-module-loader.h"
 #include "module-cache.h"
 #include "module-loader-helpers.h"
+#include "module-prefetcher.h"
 #include "module-resolver.h"
 
 #include <module/core-modules/core-modules.h>
 #include <platform/filesystem.h>
 
 // TODO: decouple dependencies between module-loader and zone.
+#include <zone/napa-zone.h>
 #include <zone/worker-context.h>
 
 #include <napa/log.h>
 #include <napa/module.h>
 
+#include <unordered_map>
 #include <unordered_set>
 
 using namespace napa;
@@ -39,12 +42,16 @@ using namespace napa::module;
 ///     It exists as Javascript file at './lib' or '../lib' directory.
 ///     It can be accessed with only require() and cached at only module cache.
 ///     If javascript core file exists, it overrides binary core module.
+/// Core modules are registered at bootstrap and loaded when first accessed, built-in modules are accessors
+/// on the global object of each context until then.
 /// </remarks>
 class ModuleLoader::ModuleLoaderImpl {
 public:
 
     /// <summary> Constructor. </summary>
-    ModuleLoaderImpl();
+    /// <param name="sharedModuleContext"> True to load javascript modules wrapped in a function in the worker's context. </param>
+    /// <param name="modulePrefetch"> True to prefetch the dependencies of javascript module files on the async work pool. </param>
+    ModuleLoaderImpl(bool sharedModuleContext, bool modulePrefetch);
 
     /// <summary> Bootstrap core modules into module loader. </summary>
     /// <remarks>
@@ -67,19 +74,54 @@ private:
     /// <param name="args"> Module name. </param>
     static void BindingCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+    /// <summary> Accessor of a built-in module on a global object, it loads the module on first access. </summary>
+    /// <param name="property"> Module name. </param>
+    /// <param name="info"> V8 property info to return module object. </param>
+    static void BuiltInModuleGetter(v8::Local<v8::Name> property, const v8::PropertyCallbackInfo<v8::Value>& info);
+
+    /// <summary> Accessor to replace a built-in module on a global object, like a data property does. </summary>
+    static void BuiltInModuleSetter(v8::Local<v8::Name> property,
+                                    v8::Local<v8::Value> value,
+                                    const v8::PropertyCallbackInfo<void>& info);
+
     /// <summary> It loads a module. </summary>
     /// <param name="path"> Module path called by require(). </param>
     /// <param name="args"> V8 argument to return module object. </param>
     void RequireModule(const char* path,
                        const v8::FunctionCallbackInfo<v8::Value>& args);
 
-    /// <summary> It registers a binary core module. </summary>
+    /// <summary> Core module registered at bootstrap. </summary>
+    struct CoreModule {
+        /// <summary> Initialization function of the binary module, empty for javascript only modules. </summary>
+        napa::module::ModuleInitializer initializer;
+
+        /// <summary> True if it's a built-in module. </summary>
+        bool isBuiltIn = false;
+
+        /// <summary> True while its javascript file is loaded, the binary module serves it meanwhile. </summary>
+        bool isLoading = false;
+    };
+
+    /// <summary> It registers a binary core module, which is initialized when first accessed. </summary>
     /// <param name="name"> Module name. </param>
     /// <param name="isBuiltInModule"> True if it's a built-in module, which doesn't need require() to call. </param>
     /// <param name="initializer"> Module initialization function. </param>
-    void LoadBinaryCoreModule(const char* name,
-                              bool isBuiltInModule,
-                              const napa::module::ModuleInitializer& initializer);
+    void RegisterBinaryCoreModule(const char* name,
+                                  bool isBuiltInModule,
+                                  const napa::module::ModuleInitializer& initializer);
+
+    /// <summary> It loads a core module, its javascript file overriding its binary module. </summary>
+    /// <param name="name"> Module name. </param>
+    /// <param name="module"> Module object if it succeeds. </param>
+    /// <returns> False if it's not a core module or its loading failed. </returns>
+    bool LoadCoreModule(const std::string& name, v8::Local<v8::Object>& module);
+
+    /// <summary> It initializes the binary module of a core module once and puts it into binding cache. </summary>
+    /// <param name="name"> Module name. </param>
+    /// <param name="coreModule"> Registered core module. </param>
+    /// <param name="module"> Module object if it succeeds. </param>
+    /// <returns> False if the core module has no binary module. </returns>
+    bool LoadBinaryCoreModule(const std::string& name, const CoreModule& coreModule, v8::Local<v8::Object>& module);
 
     /// <summary> It sets up built-in modules at each module's' context. </summary>
     /// <param name="context"> V8 context. </param>
@@ -89,10 +131,14 @@ private:
     /// <param name="context"> V8 context. </param>
     void SetupRequire(v8::Local<v8::Context> context);
 
-    /// <summary> It adds the extra functions, which access module loader's function, into built-in modules. <summary>
-    /// <param name="context"> V8 context. </param>
-    /// <remarks> It assumes that calling built-in modules are already loaded into a context. </remarks>
-    void DecorateBuiltInModules(v8::Local<v8::Context> context);
+    /// <summary> It creates a require function bound to a module, which resolves paths relative to module.filename. </summary>
+    /// <param name="module"> Module object. </param>
+    v8::Local<v8::Function> CreateModuleRequire(v8::Local<v8::Object> module);
+
+    /// <summary> It adds the extra functions, which access module loader's function, into binary core modules. <summary>
+    /// <param name="name"> Module name. </param>
+    /// <param name="module"> Binary module object, right after it's initialized. </param>
+    void DecorateBinaryCoreModule(const std::string& name, v8::Local<v8::Object> module);
 
     /// <summary> Module cache to avoid module loading overhead. </summary>
     ModuleCache _moduleCache;
@@ -106,14 +152,17 @@ private:
     /// <summary> Built-in module list. </summary>
     std::unordered_set<std::string> _builtInNames;
 
+    /// <summary> Core modules by name. </summary>
+    std::unordered_map<std::string, CoreModule> _coreModules;
+
     /// <summary> Module loaders. </summary>
     std::array<std::unique_ptr<ModuleFileLoader>, static_cast<size_t>(ModuleType::END_OF_MODULE_TYPE)> _loaders;
 };
 
-void ModuleLoader::CreateModuleLoader() {
+void ModuleLoader::CreateModuleLoader(bool sharedModuleContext, bool modulePrefetch) {
     auto moduleLoader = reinterpret_cast<ModuleLoader*>(zone::WorkerContext::Get(zone::WorkerContextItem::MODULE_LOADER));
     if (moduleLoader == nullptr) {
-        moduleLoader = new ModuleLoader();
+        moduleLoader = new ModuleLoader(sharedModuleContext, modulePrefetch);
         zone::WorkerContext::Set(zone::WorkerContextItem::MODULE_LOADER, moduleLoader);
 
         // Now, Javascript core module's 'require' can find module loader instance correctly.
@@ -122,21 +171,43 @@ void ModuleLoader::CreateModuleLoader() {
     NAPA_DEBUG("ModuleLoader", "Module loader is created successfully.");
 }
 
-ModuleLoader::ModuleLoader() : _impl(std::make_unique<ModuleLoader::ModuleLoaderImpl>()) {}
+ModuleLoader::ModuleLoader(bool sharedModuleContext, bool modulePrefetch) :
+    _impl(std::make_unique<ModuleLoader::ModuleLoaderImpl>(sharedModuleContext, modulePrefetch)) {}
 
 ModuleLoader::~ModuleLoader() = default;
 
-ModuleLoader::ModuleLoaderImpl::ModuleLoaderImpl() {
+ModuleLoader::ModuleLoaderImpl::ModuleLoaderImpl(bool sharedModuleContext, bool modulePrefetch) {
     auto builtInModulesSetter = [this](v8::Local<v8::Context> context) {
         SetupRequire(context);
         SetupBuiltInModules(context);
     };
 
+    // Function wrapped modules see the built-in modules of the worker's context, they only need their own require.
+    ModuleRequireCreator requireCreator;
+    if (sharedModuleContext) {
+        requireCreator = [this](v8::Local<v8::Object> module) {
+            return CreateModuleRequire(module);
+        };
+    }
+
+    // Prefetches run on the pool of the worker's zone, from the worker and from the pool threads fanning out in turn.
+    // The pool outlives them, since it drains its tasks before the zone goes away.
+    ModulePrefetcher::Post prefetchPost;
+    auto napaZone = reinterpret_cast<zone::NapaZone*>(zone::WorkerContext::Get(zone::WorkerContextItem::ZONE));
+    if (modulePrefetch && napaZone != nullptr) {
+        auto pool = &napaZone->GetAsyncWorkPool();
+        prefetchPost = [pool](std::function<void()> work) {
+            pool->Execute(std::move(work));
+            return true;
+        };
+    }
+
     // Set up module loaders for each module type.
+    // Core modules keep their own contexts, they are loaded once per worker.
     _loaders = {{
         nullptr,
         std::make_unique<CoreModuleLoader>(builtInModulesSetter, _moduleCache, _bindingCache),
-        std::make_unique<JavascriptModuleLoader>(builtInModulesSetter, _moduleCache),
+        std::make_unique<JavascriptModuleLoader>(builtInModulesSetter, _moduleCache, std::move(requireCreator), std::move(prefetchPost)),
         std::make_unique<JsonModuleLoader>(),
         std::make_unique<BinaryModuleLoader>(builtInModulesSetter)
     }};
@@ -153,37 +224,25 @@ void ModuleLoader::ModuleLoaderImpl::Bootstrap() {
     // 'require' needs to be available in top-level context before core-module is loaded.
     SetupRequire(context);
 
-    // Initialize core modules listed in core-modules.h.
-    INITIALIZE_CORE_MODULES(LoadBinaryCoreModule)
-    NAPA_DEBUG("ModuleLoader", "Binary core modules are loaded.");
+    // Register core modules listed in core-modules.h.
+    INITIALIZE_CORE_MODULES(RegisterBinaryCoreModule)
 
-    // Set up built-in modules from binaries.
-    SetupBuiltInModules(context);
-
-    // Load core module information from 'core-modules.json'.
+    // Register core modules listed in 'core-modules.json', their javascript files override binary modules.
     auto coreModuleInfos = module_loader_helpers::ReadCoreModulesJson();
     for (auto& info : coreModuleInfos) {
         _resolver.SetAsCoreModule(info.name.c_str());
+        ModulePrefetcher::GetInstance().AddCoreModule(info.name);
 
+        auto& coreModule = _coreModules[info.name];
         if (info.isBuiltIn) {
+            coreModule.isBuiltIn = true;
             _builtInNames.emplace(std::move(info.name));
         }
     }
+    NAPA_DEBUG("ModuleLoader", "Core modules are registered.");
 
-    auto& coreModuleLoader = _loaders[static_cast<size_t>(ModuleType::CORE)];
-
-    // Override built-in modules with javascript file if exists.
-    for (const auto& name : _builtInNames) {
-        v8::Local<v8::Object> module;
-        if (coreModuleLoader->TryGet(name, v8::Local<v8::Value>(), module)) {
-            // If javascript core module exists, replace the existing one.
-            _moduleCache.Upsert(name, module);
-            (void)context->Global()->Set(context,
-                                         v8_helpers::MakeV8String(isolate, name),
-                                         module);
-        }
-    }
-    NAPA_DEBUG("ModuleLoader", "JavaScript core modules are loaded.");
+    // Built-in modules are loaded when the top-level context first touches them.
+    SetupBuiltInModules(context);
 }
 
 void ModuleLoader::ModuleLoaderImpl::RequireCallback(const v8::FunctionCallbackInfo<v8::Value>& args) {
@@ -211,7 +270,16 @@ void ModuleLoader::ModuleLoaderImpl::ResolveCallback(const v8::FunctionCallbackI
     JS_ENSURE(isolate, moduleLoader != nullptr, "Module loader is not initialized");
 
     v8::String::Utf8Value path(args[0]);
-    auto contextDir = module_loader_helpers::GetCurrentContextDirectory();
+
+    // A resolve bound to a module resolves relative to module.filename.
+    std::string contextDir;
+    if (args.Data()->IsObject()) {
+        contextDir = module_loader_helpers::GetModuleDirectory(v8::Local<v8::Object>::Cast(args.Data()));
+    }
+
+    if (contextDir.empty()) {
+        contextDir = module_loader_helpers::GetCurrentContextDirectory();
+    }
 
     auto moduleInfo = moduleLoader->_impl->_resolver.Resolve(*path, contextDir.c_str());
     JS_ENSURE(isolate, moduleInfo.type != ModuleType::NONE, "Cannot find module \"%s\"", *path);
@@ -231,7 +299,12 @@ void ModuleLoader::ModuleLoaderImpl::BindingCallback(const v8::FunctionCallbackI
     v8::String::Utf8Value name(args[0]);
     v8::Local<v8::Object> module;
 
-    if (moduleLoader->_impl->_bindingCache.TryGet(*name, module)) {
+    // Binary modules of built-in modules are not bound.
+    auto& impl = moduleLoader->_impl;
+    auto coreModule = impl->_coreModules.find(*name);
+    if (coreModule != impl->_coreModules.end()
+        && !coreModule->second.isBuiltIn
+        && impl->LoadBinaryCoreModule(*name, coreModule->second, module)) {
         args.GetReturnValue().Set(module);
         return;
     }
@@ -240,6 +313,37 @@ void ModuleLoader::ModuleLoaderImpl::BindingCallback(const v8::FunctionCallbackI
     args.GetReturnValue().SetUndefined();
 }
 
+void ModuleLoader::ModuleLoaderImpl::BuiltInModuleGetter(v8::Local<v8::Name> property,
+                                                         const v8::PropertyCallbackInfo<v8::Value>& info) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
+
+    auto moduleLoader = reinterpret_cast<ModuleLoader*>(zone::WorkerContext::Get(zone::WorkerContextItem::MODULE_LOADER));
+    JS_ENSURE(isolate, moduleLoader != nullptr, "Module loader is not initialized");
+
+    v8::String::Utf8Value name(property);
+    v8::Local<v8::Object> module;
+    if (!moduleLoader->_impl->LoadCoreModule(*name, module)) {
+        // Exception has already been thrown upon loader failure.
+        info.GetReturnValue().SetUndefined();
+        return;
+    }
+
+    // Later accesses get the module without calling back.
+    (void)info.Holder()->CreateDataProperty(context, property, module);
+    info.GetReturnValue().Set(module);
+}
+
+void ModuleLoader::ModuleLoaderImpl::BuiltInModuleSetter(v8::Local<v8::Name> property,
+                                                         v8::Local<v8::Value> value,
+                                                         const v8::PropertyCallbackInfo<void>& info) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    (void)info.Holder()->CreateDataProperty(isolate->GetCurrentContext(), property, value);
+}
+
 void ModuleLoader::ModuleLoaderImpl::RequireModule(const char* path, const v8::FunctionCallbackInfo<v8::Value>& args) {
     if (path == nullptr) {
         args.GetReturnValue().SetUndefined();
@@ -253,9 +357,11 @@ void ModuleLoader::ModuleLoaderImpl::RequireModule(const char* path, const v8::F
     auto arg = args.Length() == 1 ? v8::Local<v8::Value>() : args[1]; 
     bool fromContent = !arg.IsEmpty() && arg->IsString();
 
-    // If require is called with a module receiver, use module.filename to deduce context directory.
+    // If require is bound to a module or called with a module receiver, use module.filename to deduce context directory.
     std::string contextDir;
-    if (!args.Holder().IsEmpty()) {
+    if (args.Data()->IsObject()) {
+        contextDir = module_loader_helpers::GetModuleDirectory(v8::Local<v8::Object>::Cast(args.Data()));
+    } else if (!args.Holder().IsEmpty()) {
         contextDir = module_loader_helpers::GetModuleDirectory(args.Holder());
     }
 
@@ -286,6 +392,16 @@ void ModuleLoader::ModuleLoaderImpl::RequireModule(const char* path, const v8::F
         }
     }
 
+    if (moduleInfo.type == ModuleType::CORE) {
+        if (LoadCoreModule(moduleInfo.fullPath, module)) {
+            args.GetReturnValue().Set(module);
+        } else {
+            // Exception has already been thrown upon loader failure.
+            args.GetReturnValue().SetUndefined();
+        }
+        return;
+    }
+
     auto& loader = _loaders[static_cast<size_t>(moduleInfo.type)];
     JS_ENSURE(isolate, loader != nullptr, "No proper module loader is defined");
 
@@ -305,12 +421,69 @@ void ModuleLoader::ModuleLoaderImpl::RequireModule(const char* path, const v8::F
     args.GetReturnValue().Set(module);
 }
 
-void ModuleLoader::ModuleLoaderImpl::LoadBinaryCoreModule(
+void ModuleLoader::ModuleLoaderImpl::RegisterBinaryCoreModule(
         const char* name,
         bool isBuiltInModule,
         const napa::module::ModuleInitializer& initializer) {
+    // Put it into module resolver to prevent from resolving as user module.
+    _resolver.SetAsCoreModule(name);
+    ModulePrefetcher::GetInstance().AddCoreModule(name);
+
+    auto& coreModule = _coreModules[name];
+    coreModule.initializer = initializer;
+
+    if (isBuiltInModule) {
+        coreModule.isBuiltIn = true;
+        _builtInNames.emplace(name);
+    }
+}
+
+bool ModuleLoader::ModuleLoaderImpl::LoadCoreModule(const std::string& name, v8::Local<v8::Object>& module) {
+    // This makes the same behavior with node.js, i.e. a loaded core module is shared by all requires.
+    if (_moduleCache.TryGet(name, module)) {
+        return true;
+    }
+
+    auto iter = _coreModules.find(name);
+    if (iter == _coreModules.end()) {
+        return false;
+    }
+    auto& coreModule = iter->second;
+
+    // A javascript file overriding a built-in module sees its binary module through the global object.
+    auto hasBinaryModule = LoadBinaryCoreModule(name, coreModule, module);
+    if (coreModule.isLoading) {
+        return hasBinaryModule;
+    }
+
+    // Core module loader falls back to the binary module if no javascript file exists.
+    coreModule.isLoading = true;
+    auto succeeded = _loaders[static_cast<size_t>(ModuleType::CORE)]->TryGet(name, v8::Local<v8::Value>(), module);
+    coreModule.isLoading = false;
+
+    if (!succeeded) {
+        NAPA_DEBUG("ModuleLoader", "Cannot load core module \"%s\".", name.c_str());
+        return false;
+    }
+
+    NAPA_DEBUG("ModuleLoader", "Loaded core module (first time): \"%s\".", name.c_str());
+    _moduleCache.Upsert(name, module);
+    return true;
+}
+
+bool ModuleLoader::ModuleLoaderImpl::LoadBinaryCoreModule(const std::string& name,
+                                                          const CoreModule& coreModule,
+                                                          v8::Local<v8::Object>& module) {
+    if (_bindingCache.TryGet(name, module)) {
+        return true;
+    }
+
+    if (coreModule.initializer == nullptr) {
+        return false;
+    }
+
     auto isolate = v8::Isolate::GetCurrent();
-    v8::HandleScope scope(isolate);
+    v8::EscapableHandleScope scope(isolate);
 
     auto context = isolate->GetCurrentContext();
 
@@ -323,40 +496,29 @@ void ModuleLoader::ModuleLoaderImpl::LoadBinaryCoreModule(
 
     module_loader_helpers::SetupModuleContext(context, moduleContext, module_loader_helpers::GetNapaDllPath());
 
-    // Put it into module resolver to prevent from resolving as user module.
-    _resolver.SetAsCoreModule(name);
-
-    auto module = module_loader_helpers::ExportModule(moduleContext->Global(), initializer);
+    auto exports = module_loader_helpers::ExportModule(moduleContext->Global(), coreModule.initializer);
+    DecorateBinaryCoreModule(name, exports);
 
-    if (isBuiltInModule) {
-        _builtInNames.emplace(name);
+    // Put into binding cache.
+    // Only binary modules of non built-in modules can be accessed by process.binding().
+    _bindingCache.Upsert(name, exports);
+    NAPA_DEBUG("ModuleLoader", "Initialized binary core module: \"%s\".", name.c_str());
 
-        // Put core module into cache.
-        // This makes the same behavior with node.js, i.e. it must be loaded by 'require'.
-        _moduleCache.Upsert(name, module);
-    } else {
-        // Put into binding cache.
-        // It must be accessed by process.binding(), not by require().
-        _bindingCache.Upsert(name, module);
-    }
+    module = scope.Escape(exports);
+    return true;
 }
 
 void ModuleLoader::ModuleLoaderImpl::SetupBuiltInModules(v8::Local<v8::Context> context) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
 
-    // Assume that built-in modules are already cached.
+    // Built-in modules are loaded on first access, which replaces the accessors by the modules.
     for (const auto& name : _builtInNames) {
-        v8::Local<v8::Object> module;
-        if (_moduleCache.TryGet(name, module)) {
-            (void)context->Global()->CreateDataProperty(context,
-                                                        v8_helpers::MakeV8String(isolate, name),
-                                                        module);
-        }
+        (void)context->Global()->SetAccessor(context,
+                                             v8_helpers::MakeV8String(isolate, name),
+                                             BuiltInModuleGetter,
+                                             BuiltInModuleSetter);
     }
-
-    // Can decorate a context after loading up built-in modules.
-    DecorateBuiltInModules(context);
 }
 
 void ModuleLoader::ModuleLoaderImpl::SetupRequire(v8::Local<v8::Context> context) {
@@ -378,18 +540,31 @@ void ModuleLoader::ModuleLoaderImpl::SetupRequire(v8::Local<v8::Context> context
                                       resolveFunctionTemplate->GetFunction());
 }
 
+v8::Local<v8::Function> ModuleLoader::ModuleLoaderImpl::CreateModuleRequire(v8::Local<v8::Object> module) {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::EscapableHandleScope scope(isolate);
+
+    auto context = isolate->GetCurrentContext();
+
+    // The module is passed as callback data, RequireCallback and ResolveCallback take the directory from it.
+    auto require = v8::Function::New(context, RequireCallback, module).ToLocalChecked();
+    auto resolve = v8::Function::New(context, ResolveCallback, module).ToLocalChecked();
+    (void)require->CreateDataProperty(context, v8_helpers::MakeV8String(isolate, "resolve"), resolve);
+
+    return scope.Escape(require);
+}
+
 // If we have more decorations, move them out from this class.
-void ModuleLoader::ModuleLoaderImpl::DecorateBuiltInModules(v8::Local<v8::Context> context) {
+void ModuleLoader::ModuleLoaderImpl::DecorateBinaryCoreModule(const std::string& name, v8::Local<v8::Object> module) {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
+    auto context = isolate->GetCurrentContext();
 
-    // Add process.binding()
-    auto process = context->Global()->Get(context,
-                                          v8_helpers::MakeV8String(isolate, "process")).ToLocalChecked()->ToObject();
-    JS_ENSURE(isolate, !process.IsEmpty(), "Process built-in module doesn't exist");
-
-    auto bindingFunctionTemplate = v8::FunctionTemplate::New(isolate, BindingCallback);
-    (void)process->CreateDataProperty(context,
-                                      v8_helpers::MakeV8String(isolate, "binding"),
-                                      bindingFunctionTemplate->GetFunction());
+    // Add process.binding(), javascript process module copies it from the binary one.
+    if (name == "process") {
+        auto bindingFunctionTemplate = v8::FunctionTemplate::New(isolate, BindingCallback);
+        (void)module->CreateDataProperty(context,
+                                         v8_helpers::MakeV8String(isolate, "binding"),
+                                         bindingFunctionTemplate->GetFunction());
+    }
 }
@@ -17,7 +17,15 @@ namespace module {
     public:
 
         /// <summary> It creates a module loader. One thread can have only one module loader. </summary>
-        static void CreateModuleLoader();
+        /// <param name="sharedModuleContext">
+        ///     True to load javascript modules wrapped in a function in the worker's context,
+        ///     false to give each module a context of its own.
+        /// </param>
+        /// <param name="modulePrefetch">
+        ///     True to resolve and read the static requires of each javascript module file on the async work pool of the zone,
+        ///     while the module runs.
+        /// </param>
+        static void CreateModuleLoader(bool sharedModuleContext = false, bool modulePrefetch = false);
 
         /// <summary>
         /// A helper macro to create a module loader instance at current thread.
@@ -34,7 +42,7 @@ namespace module {
     private:
 
         /// <summary> Constructor. </summary>
-        ModuleLoader();
+        ModuleLoader(bool sharedModuleContext, bool modulePrefetch);
 
         /// <summary> Default destructor. </summary>
         ~ModuleLoader();
@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "module-prefetcher.h"
+#include "module-resolver.h"
+#include "module-source-cache.h"
+
+#include <platform/filesystem.h>
+
+#include <cctype>
+#include <exception>
+
+using namespace napa;
+using namespace napa::module;
+
+namespace {
+
+    constexpr const char REQUIRE[] = "require";
+    constexpr size_t REQUIRE_LENGTH = sizeof(REQUIRE) - 1;
+
+    bool IsIdentifierChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+    }
+
+    size_t SkipSpaces(const std::string& source, size_t i) {
+        while (i < source.size() && std::isspace(static_cast<unsigned char>(source[i]))) {
+            ++i;
+        }
+        return i;
+    }
+
+    /// <summary> Skips a quoted string from its opening quote, to the character after its closing quote. </summary>
+    /// <remarks> Quotes of regular expressions look like strings, a line break ends them so the scan recovers on the next line. </remarks>
+    size_t SkipString(const std::string& source, size_t i) {
+        auto quote = source[i++];
+        while (i < source.size()) {
+            auto c = source[i++];
+            if (c == '\\') {
+                ++i;
+            } else if (c == quote || (c == '\n' && quote != '`')) {
+                break;
+            }
+        }
+        return i;
+    }
+
+    /// <summary> Reads the literal argument of a require at the position after 'require'. </summary>
+    /// <returns> The position after the closing parenthesis, or npos if the argument isn't a string literal. </returns>
+    size_t ReadRequire(const std::string& source, size_t i, std::string& name) {
+        i = SkipSpaces(source, i);
+        if (i >= source.size() || source[i] != '(') {
+            return std::string::npos;
+        }
+
+        i = SkipSpaces(source, i + 1);
+        if (i >= source.size() || (source[i] != '\'' && source[i] != '"')) {
+            return std::string::npos;
+        }
+
+        auto quote = source[i++];
+        auto begin = i;
+        while (i < source.size() && source[i] != quote) {
+            if (source[i] == '\\' || source[i] == '\n') {
+                return std::string::npos;
+            }
+            ++i;
+        }
+
+        auto end = i;
+        i = SkipSpaces(source, i + 1);
+        if (i >= source.size() || source[i] != ')' || end == begin) {
+            return std::string::npos;
+        }
+        name.assign(source, begin, end - begin);
+        return i + 1;
+    }
+
+    /// <summary> Each pool thread has its own resolver, they share the process wide resolver cache. </summary>
+    ModuleResolver& GetThreadResolver() {
+        thread_local ModuleResolver resolver;
+        return resolver;
+    }
+}
+
+ModulePrefetcher& ModulePrefetcher::GetInstance() {
+    static ModulePrefetcher instance;
+    return instance;
+}
+
+std::vector<std::string> ModulePrefetcher::ScanRequires(const std::string& source) {
+    std::vector<std::string> names;
+    size_t i = 0;
+    while (i < source.size()) {
+        auto c = source[i];
+        if (c == '/' && i + 1 < source.size() && source[i + 1] == '/') {
+            i = source.find('\n', i);
+            continue;
+        }
+        if (c == '/' && i + 1 < source.size() && source[i + 1] == '*') {
+            i = source.find("*/", i + 2);
+            i = i == std::string::npos ? i : i + 2;
+            continue;
+        }
+        if (c == '\'' || c == '"' || c == '`') {
+            i = SkipString(source, i);
+            continue;
+        }
+        if (!IsIdentifierChar(c)) {
+            ++i;
+            continue;
+        }
+
+        // Member calls like 'loader.require(...)' and longer identifiers are not the require of the module.
+        auto begin = i;
+        while (i < source.size() && IsIdentifierChar(source[i])) {
+            ++i;
+        }
+        if (i - begin != REQUIRE_LENGTH
+            || source.compare(begin, REQUIRE_LENGTH, REQUIRE) != 0
+            || (begin > 0 && source[begin - 1] == '.')) {
+            continue;
+        }
+
+        std::string name;
+        auto end = ReadRequire(source, i, name);
+        if (end != std::string::npos) {
+            names.emplace_back(std::move(name));
+            i = end;
+        }
+    }
+    return names;
+}
+
+void ModulePrefetcher::AddCoreModule(const std::string& name) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _coreModules.emplace(name);
+}
+
+void ModulePrefetcher::Prefetch(const std::string& path, Post post) {
+    if (!Claim(path)) {
+        return;
+    }
+
+    // The worker goes on running the module, the scan of its source runs on the pool.
+    (void)post([this, path, post]() {
+        Scan(path, post);
+    });
+}
+
+size_t ModulePrefetcher::GetScannedCount() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _scanned.size();
+}
+
+void ModulePrefetcher::Scan(const std::string& path, const Post& post) {
+    ModuleSourceCache::Source source;
+    try {
+        source = ModuleSourceCache::GetInstance().Get(path);
+    } catch (const std::exception&) {
+        // Require reports the failure of the read.
+        return;
+    }
+
+    auto directory = filesystem::Path(path).Dirname().String();
+    for (auto& name : ScanRequires(*source)) {
+        if (IsCoreModule(name)) {
+            continue;
+        }
+        if (!post([this, name, directory, post]() { Fetch(name, directory, post); })) {
+            return;
+        }
+    }
+}
+
+void ModulePrefetcher::Fetch(const std::string& name, const std::string& directory, const Post& post) {
+    auto moduleInfo = GetThreadResolver().Resolve(name.c_str(), directory.c_str());
+    if (moduleInfo.type != ModuleType::JAVASCRIPT || !Claim(moduleInfo.fullPath)) {
+        return;
+    }
+
+    // A dependency is scanned on the thread that resolved it, its own dependencies fan out on the pool.
+    Scan(moduleInfo.fullPath, post);
+}
+
+bool ModulePrefetcher::Claim(const std::string& path) {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _scanned.emplace(path).second;
+}
+
+bool ModulePrefetcher::IsCoreModule(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _coreModules.find(name) != _coreModules.end();
+}
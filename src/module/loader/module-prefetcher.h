@@ -0,0 +1,75 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace napa {
+namespace module {
+
+    /// <summary>
+    ///     Process wide prefetcher of module dependencies. The static requires of a module are resolved and their
+    ///     sources read in parallel on a pool, so the requires that run the module hit warm resolver and source caches
+    ///     instead of waiting on the disk one dependency at a time.
+    /// </summary>
+    /// <remarks>
+    ///     Prefetching is only a hint. Dependencies that can't be resolved or read are left to require, which reports
+    ///     the error as it would without prefetching. The dependencies of a module are scanned once per process.
+    /// </remarks>
+    class ModulePrefetcher {
+    public:
+
+        /// <summary> Runs a function on a pool thread, returns false if it can't. </summary>
+        using Post = std::function<bool(std::function<void()>)>;
+
+        /// <summary> Constructor. </summary>
+        ModulePrefetcher() = default;
+
+        /// <summary> Non-copyable. </summary>
+        ModulePrefetcher(const ModulePrefetcher&) = delete;
+        ModulePrefetcher& operator=(const ModulePrefetcher&) = delete;
+
+        /// <summary> Returns the prefetcher used by the module loaders. </summary>
+        static ModulePrefetcher& GetInstance();
+
+        /// <summary> Returns the modules a source requires with string literals, like require('./a') or require("b"). </summary>
+        /// <remarks> Comments are skipped, requires built from expressions are not seen. </remarks>
+        static std::vector<std::string> ScanRequires(const std::string& source);
+
+        /// <summary> Registers a core module, which is not resolved from files. </summary>
+        void AddCoreModule(const std::string& name);
+
+        /// <summary> Prefetches the dependencies of a module file, and their dependencies in turn. </summary>
+        /// <param name="path"> Full path of a JavaScript module, whose source is read into the source cache. </param>
+        /// <param name="post"> Runs the scan of the module and the fetch of each dependency on the pool. </param>
+        void Prefetch(const std::string& path, Post post);
+
+        /// <summary> Returns the number of modules whose dependencies were scanned. </summary>
+        size_t GetScannedCount() const;
+
+    private:
+
+        /// <summary> Reads the source of a module, then posts the fetch of each dependency. </summary>
+        void Scan(const std::string& path, const Post& post);
+
+        /// <summary> Resolves a dependency, then scans it if it's a JavaScript module not scanned yet. </summary>
+        void Fetch(const std::string& name, const std::string& directory, const Post& post);
+
+        /// <summary> Returns true if the module is claimed for scanning, false if it was claimed before. </summary>
+        bool Claim(const std::string& path);
+
+        /// <summary> Returns true if the name is of a core module. </summary>
+        bool IsCoreModule(const std::string& name) const;
+
+        mutable std::mutex _lock;
+        std::unordered_set<std::string> _scanned;
+        std::unordered_set<std::string> _coreModules;
+    };
+
+}   // End of namespace module.
+}   // End of namespace napa.
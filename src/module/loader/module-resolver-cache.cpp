@@ -3,43 +3,72 @@
 
 #include "module-resolver-cache.h"
 
+#include <array>
+#include <cstring>
 #include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
+#include <vector>
 
 using namespace napa;
 using namespace napa::module;
 
-struct ModuleResolverCacheKey {
-    std::string _name;
-    std::string _path;
+namespace {
 
-    bool operator==(const ModuleResolverCacheKey& other) const {
-        return _name == other._name && _path == other._path;
-    }
-};
+    /// <summary> Number of independently locked parts of the cache, a power of 2. </summary>
+    constexpr size_t SHARD_COUNT = 16;
 
-namespace std {
-    template<>
-    struct hash<ModuleResolverCacheKey> {
-        std::size_t operator()(ModuleResolverCacheKey key) const {
-            return std::hash<std::string>{}(key._name) ^ std::hash<std::string>{}(key._path);
+    constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    /// <summary> Hashes a key in place with FNV-1a, so a lookup doesn't copy the strings. </summary>
+    /// <remarks> The terminating zero of name is hashed too, so ("ab", "c") and ("a", "bc") or swapped keys differ. </remarks>
+    uint64_t HashKey(const char* name, const char* path) {
+        auto hash = FNV_OFFSET_BASIS;
+        for (auto c = name; ; c++) {
+            hash ^= static_cast<unsigned char>(*c);
+            hash *= FNV_PRIME;
+            if (*c == '\0') {
+                break;
+            }
         }
-    };
+        for (auto c = path; *c != '\0'; c++) {
+            hash ^= static_cast<unsigned char>(*c);
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
 }
 
 class ModuleResolverCache::ModuleResolverCacheImpl {
 public:
     ModuleInfo Lookup(const char* name, const char* path);
     void Insert(const char* name, const char* path, const ModuleInfo& moduleInfo);
+    std::vector<Entry> GetEntries();
 private:
-    std::mutex _lock;
-    std::unordered_map<ModuleResolverCacheKey, ModuleInfo> _resolvedModules;
+
+    /// <summary> Entries are only added, so lookups share the lock and only inserts take it exclusively. </summary>
+    struct alignas(64) Shard {
+        std::shared_timed_mutex lock;
+        std::unordered_map<uint64_t, std::vector<Entry>> entries;
+    };
+
+    Shard& GetShard(uint64_t hash);
+
+    const Entry* Find(const Shard& shard, uint64_t hash, const char* name, const char* path) const;
+
+    std::array<Shard, SHARD_COUNT> _shards;
 };
 
 ModuleResolverCache::ModuleResolverCache() : _impl(std::make_unique<ModuleResolverCache::ModuleResolverCacheImpl>()) {}
 
 ModuleResolverCache::~ModuleResolverCache() = default;
 
+ModuleResolverCache& ModuleResolverCache::GetInstance() {
+    static ModuleResolverCache instance;
+    return instance;
+}
+
 ModuleInfo ModuleResolverCache::Lookup(const char* name, const char* path) {
     return _impl->Lookup(name, path);
 }
@@ -48,23 +77,70 @@ void ModuleResolverCache::Insert(const char* name, const char* path, const Modul
     _impl->Insert(name, path, moduleInfo);
 }
 
+std::vector<ModuleResolverCache::Entry> ModuleResolverCache::GetEntries() {
+    return _impl->GetEntries();
+}
+
 ModuleInfo ModuleResolverCache::ModuleResolverCacheImpl::Lookup(const char* name, const char* path) {
-    ModuleResolverCacheKey key{name, path};
+    auto hash = HashKey(name, path);
+    auto& shard = GetShard(hash);
 
-    std::lock_guard<std::mutex> lock(_lock);
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(shard.lock);
 
-    auto result = _resolvedModules.find(key);
-    if (result != _resolvedModules.end()) {
-        return result->second;
+        auto entry = Find(shard, hash, name, path);
+        if (entry != nullptr) {
+            return entry->moduleInfo;
+        }
     }
 
     return ModuleInfo{ModuleType::NONE, name, path};
 }
 
 void ModuleResolverCache::ModuleResolverCacheImpl::Insert(const char* name, const char* path, const ModuleInfo& moduleInfo) {
-    ModuleResolverCacheKey key{name, path};
-    
-    std::lock_guard<std::mutex> lock(_lock);
+    auto hash = HashKey(name, path);
+    auto& shard = GetShard(hash);
 
-    _resolvedModules.emplace(std::make_pair(key, moduleInfo));
+    std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+
+    // The first resolution wins, like emplace did.
+    if (Find(shard, hash, name, path) == nullptr) {
+        shard.entries[hash].push_back(Entry{ name, path, moduleInfo });
+    }
+}
+
+std::vector<ModuleResolverCache::Entry> ModuleResolverCache::ModuleResolverCacheImpl::GetEntries() {
+    std::vector<Entry> entries;
+    for (auto& shard : _shards) {
+        std::shared_lock<std::shared_timed_mutex> lock(shard.lock);
+        for (const auto& bucket : shard.entries) {
+            entries.insert(entries.end(), bucket.second.begin(), bucket.second.end());
+        }
+    }
+    return entries;
+}
+
+ModuleResolverCache::ModuleResolverCacheImpl::Shard& ModuleResolverCache::ModuleResolverCacheImpl::GetShard(uint64_t hash) {
+    // The map buckets by the low bits, the shard is picked from the high bits so they stay independent.
+    return _shards[static_cast<size_t>(hash >> 32) & (SHARD_COUNT - 1)];
+}
+
+const ModuleResolverCache::Entry* ModuleResolverCache::ModuleResolverCacheImpl::Find(
+    const Shard& shard,
+    uint64_t hash,
+    const char* name,
+    const char* path) const {
+
+    auto iter = shard.entries.find(hash);
+    if (iter == shard.entries.end()) {
+        return nullptr;
+    }
+
+    // Entries only share a bucket on a full 64-bit hash collision, the strings tell them apart.
+    for (const auto& entry : iter->second) {
+        if (std::strcmp(entry.name.c_str(), name) == 0 && std::strcmp(entry.path.c_str(), path) == 0) {
+            return &entry;
+        }
+    }
+    return nullptr;
 }
@@ -6,6 +6,8 @@
 #include "module-resolver.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace napa {
 namespace module {
@@ -17,6 +19,13 @@ namespace module {
     class ModuleResolverCache {
     public:
 
+        /// <summary> The resolution of a module name from a context path. </summary>
+        struct Entry {
+            std::string name;
+            std::string path;
+            ModuleInfo moduleInfo;
+        };
+
         /// <summary> Constructor. </summary>
         ModuleResolverCache();
 
@@ -31,6 +40,9 @@ namespace module {
         ModuleResolverCache(ModuleResolverCache&&) = default;
         ModuleResolverCache& operator=(ModuleResolverCache&&) = default;
 
+        /// <summary> Returns the cache shared by the module resolvers of all workers. </summary>
+        static ModuleResolverCache& GetInstance();
+
         /// <summary> Lookup the module info. </summary>
         /// <param name="name"> Module name or path. </param>
         /// <param name="path"> Current context path. If nullptr, it'll be current path. </param>
@@ -42,6 +54,9 @@ namespace module {
         /// <param name="path"> Current context path. If nullptr, it'll be current path. </param>
         void Insert(const char* name, const char* path, const ModuleInfo& moduleInfo);
 
+        /// <summary> Returns a copy of all cached resolutions. </summary>
+        std::vector<Entry> GetEntries();
+
     private:
         class ModuleResolverCacheImpl;
         std::unique_ptr<ModuleResolverCacheImpl> _impl;
@@ -2,6 +2,7 @@
 // Licensed under the MIT license.
 
 #include "module-resolver.h"
+#include "file-status-cache.h"
 #include "module-resolver-cache.h"
 
 #include <platform/filesystem.h>
@@ -15,7 +16,6 @@
 #include <rapidjson/istreamwrapper.h>
 
 #include <fstream>
-#include <sstream>
 #include <unordered_set>
 
 using namespace napa;
@@ -110,8 +110,11 @@ private:
     /// <summary> Paths in 'NODE_PATH' environment variable. </summary>
     std::vector<std::string> _nodePaths;
 
-    /// <summary> Module info cache for all loaded modules. </summary>
-    ModuleResolverCache _cache;
+    /// <summary> Module info cache for all loaded modules, shared by all workers so each module is resolved once. </summary>
+    ModuleResolverCache& _cache = ModuleResolverCache::GetInstance();
+
+    /// <summary> Statuses of the probed files and directories, shared by all workers so each path is probed once. </summary>
+    FileStatusCache& _statusCache = FileStatusCache::GetInstance();
 };
 
 ModuleResolver::ModuleResolver() : _impl(std::make_unique<ModuleResolver::ModuleResolverImpl>()) {}
@@ -217,7 +220,7 @@ ModuleInfo ModuleResolver::ModuleResolverImpl::LoadAsFile(const filesystem::Path
                                                           const filesystem::Path& path) {
     auto fullPath = (path / name).Normalize();
 
-    if (filesystem::IsRegularFile(fullPath)) {
+    if (_statusCache.IsRegularFile(fullPath)) {
         ModuleType type = ModuleType::JAVASCRIPT;
 
         auto extension = fullPath.Extension().String();
@@ -238,7 +241,7 @@ ModuleInfo ModuleResolver::ModuleResolverImpl::LoadAsDirectory(const filesystem:
     auto fullPath = (path / name).Normalize();
 
     auto packageJson = fullPath / "package.json";
-    if (filesystem::IsRegularFile(packageJson)) {
+    if (_statusCache.IsRegularFile(packageJson)) {
         rapidjson::Document package;
         try {
             std::ifstream ifs(packageJson.String());
@@ -280,15 +283,17 @@ ModuleInfo ModuleResolver::ModuleResolverImpl::LoadNodeModules(const filesystem:
 
 std::vector<std::string> ModuleResolver::ModuleResolverImpl::GetNodeModulesPaths(const filesystem::Path& path) {
     std::vector<std::string> subpaths;
-    subpaths.reserve(256);
 
-    for (filesystem::Path subpath(path); !subpath.IsEmpty(); subpath = subpath.Parent().Normalize()) {
+    // Parents are resolved in place, and the candidate reuses its buffer, so walking up allocates little.
+    filesystem::Path modulePath;
+    for (filesystem::Path subpath(path); !subpath.IsEmpty(); (subpath /= "..").Normalize()) {
         if (subpath.Filename().String() == "node_modules") {
             continue;
         }
 
-        auto modulePath = subpath / "node_modules";
-        if (filesystem::IsDirectory(modulePath)) {
+        modulePath = subpath.String();
+        modulePath /= "node_modules";
+        if (_statusCache.IsDirectory(modulePath)) {
             subpaths.emplace_back(modulePath.String());
         }
     }
@@ -297,21 +302,18 @@ std::vector<std::string> ModuleResolver::ModuleResolverImpl::GetNodeModulesPaths
 }
 
 ModuleInfo ModuleResolver::ModuleResolverImpl::TryExtensions(const filesystem::Path& path) {
-    std::ostringstream oss;
-    oss << path.String() << JAVASCRIPT_MODULE_EXTENSION;
-
-    auto modulePath = filesystem::Path(oss.str());
-    if (filesystem::IsRegularFile(modulePath)) {
+    auto modulePath = filesystem::Path(path.String() + JAVASCRIPT_MODULE_EXTENSION);
+    if (_statusCache.IsRegularFile(modulePath)) {
         return ModuleInfo{ModuleType::JAVASCRIPT, modulePath.String(), std::string()};
     }
 
     modulePath.ReplaceExtension(JSON_OBJECT_EXTENSION);
-    if (filesystem::IsRegularFile(modulePath)) {
+    if (_statusCache.IsRegularFile(modulePath)) {
         return ModuleInfo{ModuleType::JSON, modulePath.String(), std::string()};
     }
 
     modulePath.ReplaceExtension(NAPA_MODULE_EXTENSION);
-    if (filesystem::IsRegularFile(modulePath)) {
+    if (_statusCache.IsRegularFile(modulePath)) {
         return ModuleInfo{ModuleType::NAPA, modulePath.String(), std::string()};
     }
 
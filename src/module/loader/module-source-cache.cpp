@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "module-source-cache.h"
+#include "module-bundle.h"
+
+#include <module/core-modules/node/file-system-helpers.h>
+
+using namespace napa;
+using namespace napa::module;
+
+ModuleSourceCache& ModuleSourceCache::GetInstance() {
+    static ModuleSourceCache instance;
+    return instance;
+}
+
+ModuleSourceCache::Source ModuleSourceCache::Get(const std::string& path) {
+    std::shared_ptr<Entry> entry;
+    std::vector<std::shared_ptr<const ModuleBundle>> bundles;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto& slot = _entries[path];
+        if (slot == nullptr) {
+            slot = std::make_shared<Entry>();
+        }
+        entry = slot;
+
+        if (entry->source == nullptr) {
+            bundles = _bundles;
+        }
+    }
+
+    // Other workers requiring the same file wait for the first read instead of reading the file too,
+    // while reads of other files go on.
+    std::lock_guard<std::mutex> lock(entry->lock);
+    if (entry->source == nullptr) {
+        for (const auto& bundle : bundles) {
+            entry->source = bundle->GetSource(path);
+            if (entry->source != nullptr) {
+                return entry->source;
+            }
+        }
+        entry->source = std::make_shared<const std::string>(file_system_helpers::ReadFileSync(path));
+    }
+    return entry->source;
+}
+
+void ModuleSourceCache::AddBundle(std::shared_ptr<const ModuleBundle> bundle) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _bundles.emplace_back(std::move(bundle));
+}
+
+std::vector<std::pair<std::string, ModuleSourceCache::Source>> ModuleSourceCache::GetEntries() {
+    std::vector<std::pair<std::string, std::shared_ptr<Entry>>> entries;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        entries.assign(_entries.begin(), _entries.end());
+    }
+
+    // A file that failed to read has no source and is left out.
+    std::vector<std::pair<std::string, Source>> sources;
+    for (auto& entry : entries) {
+        std::lock_guard<std::mutex> lock(entry.second->lock);
+        if (entry.second->source != nullptr) {
+            sources.emplace_back(entry.first, entry.second->source);
+        }
+    }
+    return sources;
+}
@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace napa {
+namespace module {
+
+    class ModuleBundle;
+
+    /// <summary>
+    ///     Process wide cache of module sources, so a module file is read once no matter how many workers require it.
+    ///     Sources are immutable once read, like the resolution of a module, a changed file needs a new process.
+    /// </summary>
+    class ModuleSourceCache {
+    public:
+
+        /// <summary> Module source shared by all workers. </summary>
+        using Source = std::shared_ptr<const std::string>;
+
+        /// <summary> Constructor. </summary>
+        ModuleSourceCache() = default;
+
+        /// <summary> Non-copyable. </summary>
+        ModuleSourceCache(const ModuleSourceCache&) = delete;
+        ModuleSourceCache& operator=(const ModuleSourceCache&) = delete;
+
+        /// <summary> Returns the cache used by the module loaders. </summary>
+        static ModuleSourceCache& GetInstance();
+
+        /// <summary> Returns the source of a module file, reading it on first use. </summary>
+        /// <param name="path"> Module file path. </param>
+        /// <returns> The file content. </returns>
+        /// <remarks> Throws std::runtime_error if the file can't be read, failures are not cached. </remarks>
+        Source Get(const std::string& path);
+
+        /// <summary> Serves the sources of a bundle, a file is read only if no bundle holds it. </summary>
+        void AddBundle(std::shared_ptr<const ModuleBundle> bundle);
+
+        /// <summary> Returns the paths and sources read so far. </summary>
+        std::vector<std::pair<std::string, Source>> GetEntries();
+
+    private:
+
+        /// <summary> A module file, its lock is held while the first worker reads it. </summary>
+        struct Entry {
+            std::mutex lock;
+            Source source;
+        };
+
+        std::mutex _lock;
+        std::unordered_map<std::string, std::shared_ptr<Entry>> _entries;
+        std::vector<std::shared_ptr<const ModuleBundle>> _bundles;
+    };
+
+}   // End of namespace module.
+}   // End of namespace napa.
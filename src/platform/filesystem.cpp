@@ -17,6 +17,11 @@
 #include <mach-o/dyld.h>
 #endif
 
+#ifdef SUPPORT_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
 namespace napa {
 namespace filesystem {
 using CharType = Path::CharType;
@@ -136,41 +141,6 @@ namespace {
         }
     }
 
-    /// <summary> Format path name from path meta-data. </summary>
-    std::string FormatPathString(
-        bool hasUncPrefix,
-        const std::string& driveSpec,
-        bool isAbsolute,
-        const std::vector<StringType>& segments,
-        const CharType* seperator = platform::DIR_SEPARATOR) {
-
-        // Output normalized string.
-        std::stringstream ss;
-
-        if (hasUncPrefix) {
-            ss << "\\\\?\\";
-        }
-
-        // Drive spec could be empty.
-        ss << driveSpec;
-
-        if (isAbsolute) {
-            ss << platform::DIR_SEPARATOR;
-        }
-
-        for (auto it = segments.begin(); it != segments.end(); ++it) {
-            if (it != segments.begin()) {
-                ss << seperator;
-            }
-            ss << *it;
-        }
-        auto path = ss.str();
-        if (path.size() == 0) {
-            return ".";
-        }
-        return path;
-    }
-
 }
 
 Path& Path::operator=(const CharType* path) {
@@ -248,22 +218,78 @@ Path& Path::Append(const Path& path) {
 }
 
 Path& Path::Normalize() {
-    if (!_pathname.empty()) {
-        std::string driveSpec;
-        bool hasUncPrefix = false;
-        bool isAbsolute = false;
-        std::vector<StringType> segs;
+    if (_pathname.empty()) {
+        return *this;
+    }
 
-        Parse(_pathname, &hasUncPrefix, &driveSpec, &isAbsolute, &segs);
+    // Segments are compacted within the string, as Parse would resolve them. The output is never
+    // longer than what was read, so normalizing a path doesn't allocate.
+    auto isSegmentSeparator = [](CharType ch) { return ch == '/' || ch == '\\'; };
+    auto& path = _pathname;
+    auto size = path.size();
 
-        // No parent path.
-        if (isAbsolute && segs.size() > 0 && segs[0] == "..") {
-            _pathname = "";
+    bool unc = false;
+    StringType::size_type pathStart = 0;
+    if (!ParseDriveSpec(path, &unc).empty()) {
+        pathStart = (unc ? 4 : 0) + 2;
+    }
+
+    auto isAbsolute = size > pathStart && IsSeparator(path[pathStart]);
+    auto write = pathStart;
+    if (isAbsolute) {
+        path[write++] = platform::DIR_SEPARATOR[0];
+    }
+    auto segmentsStart = write;
+
+    // The resolved segments are some '..' followed by 'named' others, which a '..' backtracks.
+    size_t named = 0;
+    for (auto read = pathStart; read < size;) {
+        if (isSegmentSeparator(path[read])) {
+            read++;
+            continue;
         }
-        else {
-            _pathname = FormatPathString(hasUncPrefix, driveSpec, isAbsolute, segs, platform::DIR_SEPARATOR);
+        auto segmentStart = read;
+        while (read < size && !isSegmentSeparator(path[read])) {
+            read++;
+        }
+        auto length = read - segmentStart;
+
+        if (length == 1 && path[segmentStart] == '.') {
+            continue;
+        }
+        if (length == 2 && path[segmentStart] == '.' && path[segmentStart + 1] == '.') {
+            if (named > 0) {
+                while (write > segmentsStart && path[write - 1] != platform::DIR_SEPARATOR[0]) {
+                    write--;
+                }
+                if (write > segmentsStart) {
+                    write--;
+                }
+                named--;
+                continue;
+            }
+            if (isAbsolute) {
+                // No parent path.
+                path.clear();
+                return *this;
+            }
+        } else {
+            named++;
+        }
+
+        if (write > segmentsStart) {
+            path[write++] = platform::DIR_SEPARATOR[0];
+        }
+        for (auto i = segmentStart; i < read; i++) {
+            path[write++] = path[i];
         }
     }
+
+    if (write == 0) {
+        path = ".";
+    } else {
+        path.resize(write);
+    }
     return *this;
 }
 
@@ -532,6 +558,32 @@ bool IsDirectory(const Path& path) {
 #endif
 }
 
+bool GetFileStatus(const Path& path, FileStatus& status) {
+#ifdef SUPPORT_POSIX
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return false;
+    }
+    status.size = static_cast<uint64_t>(st.st_size);
+    status.modifiedTime = static_cast<int64_t>(st.st_mtime) * 1000;
+    status.isFile = S_ISREG(st.st_mode);
+    status.isDirectory = S_ISDIR(st.st_mode);
+#else
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data)) {
+        return false;
+    }
+    status.size = (static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+
+    // File times count 100ns intervals since 1601-01-01.
+    auto fileTime = (static_cast<int64_t>(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+    status.modifiedTime = (fileTime - 116444736000000000LL) / 10000;
+    status.isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    status.isFile = !status.isDirectory;
+#endif
+    return true;
+}
+
 bool MakeDirectory(const Path& path) {
 #ifdef SUPPORT_POSIX
     return ::mkdir(path.c_str(), S_IRWXU | S_IRWXG | S_IRWXO) == 0 || errno == EEXIST;
@@ -626,5 +678,76 @@ bool PathIterator::Next() {
     return true;
 }
 
+MappedFile::MappedFile(const Path& path)
+    : _open(false), _data(nullptr), _size(0) {
+    FileStatus status;
+    if (!GetFileStatus(path, status) || !status.isFile) {
+        return;
+    }
+    if (status.size == 0) {
+        // Zero length mappings are not allowed.
+        _open = true;
+        return;
+    }
+
+#ifdef SUPPORT_POSIX
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    auto data = ::mmap(nullptr, static_cast<size_t>(status.size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    (void)::close(fd);
+
+    if (data != MAP_FAILED) {
+        _data = data;
+        _size = static_cast<size_t>(status.size);
+        _open = true;
+    }
+#else
+    auto file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    auto mapping = ::CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    (void)::CloseHandle(file);
+    if (mapping == nullptr) {
+        return;
+    }
+
+    // The view keeps the mapping object alive.
+    auto data = ::MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    (void)::CloseHandle(mapping);
+
+    if (data != nullptr) {
+        _data = data;
+        _size = static_cast<size_t>(status.size);
+        _open = true;
+    }
+#endif
+}
+
+MappedFile::~MappedFile() {
+    if (_data == nullptr) {
+        return;
+    }
+#ifdef SUPPORT_POSIX
+    (void)::munmap(_data, _size);
+#else
+    (void)::UnmapViewOfFile(_data);
+#endif
+}
+
+bool MappedFile::IsOpen() const {
+    return _open;
+}
+
+void* MappedFile::Data() const {
+    return _data;
+}
+
+size_t MappedFile::Size() const {
+    return _size;
+}
+
 }
 }
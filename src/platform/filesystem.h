@@ -5,6 +5,7 @@
 #include <platform/platform.h>
 #include <platform/os.h>
 
+#include <cstdint>
 #include <string>
 
 #ifdef SUPPORT_POSIX
@@ -181,6 +182,25 @@ namespace filesystem {
     /// <summary> Tell if a path is a directory. </summary>
     bool IsDirectory(const Path& path);
 
+    /// <summary> Status of a file or directory. </summary>
+    struct FileStatus {
+        /// <summary> Size in bytes. </summary>
+        uint64_t size = 0;
+
+        /// <summary> Last modification time in milliseconds since the Unix epoch. </summary>
+        int64_t modifiedTime = 0;
+
+        /// <summary> True for a regular file. </summary>
+        bool isFile = false;
+
+        /// <summary> True for a directory. </summary>
+        bool isDirectory = false;
+    };
+
+    /// <summary> Get the status of a path. </summary>
+    /// <returns> True if the path exists, false otherwise. </returns>
+    bool GetFileStatus(const Path& path, FileStatus& status);
+
     /// <summary> Make a directory. </summary>
     /// <returns> True if succeed or directory already exists, false if operation failed. </returns>
     bool MakeDirectory(const Path& path);
@@ -215,5 +235,32 @@ namespace filesystem {
         Path _base;
         Path _currentPath;
     };
+
+    /// <summary> A file mapped into memory, the mapping is released on destruction. </summary>
+    /// <remarks>
+    /// Pages are mapped copy-on-write, so writes to the memory are private to the process and never reach the file.
+    /// </remarks>
+    class MappedFile {
+    public:
+        MappedFile(const Path& path);
+        ~MappedFile();
+
+        /// <summary> Tell if the file was mapped. Empty files are mapped with no data. </summary>
+        bool IsOpen() const;
+
+        /// <summary> Start of the mapped memory, or nullptr if empty. </summary>
+        void* Data() const;
+
+        /// <summary> Size of the mapped memory in bytes. </summary>
+        size_t Size() const;
+
+    private:
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool _open;
+        void* _data;
+        size_t _size;
+    };
 }
 }
\ No newline at end of file
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <platform/hardware-counters.h>
+#include <platform/platform.h>
+
+#if defined(OS_LINUX)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstring>
+#endif
+
+namespace napa {
+namespace platform {
+
+#if defined(OS_LINUX)
+
+namespace {
+
+    /// <summary> The counters of a group, in the order they are opened, the first leads the group. </summary>
+    const uint64_t COUNTER_CONFIGS[] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_REFERENCES,
+        PERF_COUNT_HW_CACHE_MISSES
+    };
+
+    const size_t COUNTER_COUNT = sizeof(COUNTER_CONFIGS) / sizeof(COUNTER_CONFIGS[0]);
+
+    /// <summary> The counters of a thread, opened as a group which counts the thread on any CPU, in user mode. </summary>
+    class CounterGroup {
+    public:
+        CounterGroup() {
+            for (auto& fd : _fds) {
+                fd = -1;
+            }
+
+            for (size_t i = 0; i < COUNTER_COUNT; i++) {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = COUNTER_CONFIGS[i];
+                attr.read_format = PERF_FORMAT_GROUP;
+                attr.disabled = i == 0 ? 1 : 0;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+
+                _fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : _fds[0], 0));
+                if (_fds[i] < 0) {
+                    Close();
+                    return;
+                }
+            }
+
+            ioctl(_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+
+        ~CounterGroup() {
+            Close();
+        }
+
+        CounterGroup(const CounterGroup&) = delete;
+        CounterGroup& operator=(const CounterGroup&) = delete;
+
+        bool IsOpen() const {
+            return _fds[0] >= 0;
+        }
+
+        bool Read(HardwareCounterSample& sample) const {
+            if (!IsOpen()) {
+                return false;
+            }
+
+            // With PERF_FORMAT_GROUP the leader reads the number of counters, then each value in the order opened.
+            uint64_t values[1 + COUNTER_COUNT];
+            if (read(_fds[0], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values))
+                || values[0] != COUNTER_COUNT) {
+                return false;
+            }
+
+            sample.cycles = values[1];
+            sample.instructions = values[2];
+            sample.cacheReferences = values[3];
+            sample.cacheMisses = values[4];
+            return true;
+        }
+
+    private:
+        void Close() {
+            for (auto& fd : _fds) {
+                if (fd >= 0) {
+                    close(fd);
+                    fd = -1;
+                }
+            }
+        }
+
+        int _fds[COUNTER_COUNT];
+    };
+}
+
+bool AreHardwareCountersSupported() {
+    CounterGroup group;
+    HardwareCounterSample sample;
+    return group.Read(sample);
+}
+
+bool ReadThreadHardwareCounters(HardwareCounterSample& sample) {
+    // The group counts the thread it was opened on, so each thread opens its own, and keeps it until it exits.
+    thread_local CounterGroup group;
+    return group.Read(sample);
+}
+
+#else
+
+bool AreHardwareCountersSupported() {
+    return false;
+}
+
+bool ReadThreadHardwareCounters(HardwareCounterSample&) {
+    return false;
+}
+
+#endif
+
+}
+}
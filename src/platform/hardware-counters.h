@@ -0,0 +1,29 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+
+namespace napa {
+namespace platform {
+
+    /// <summary> Hardware counters of the calling thread, counted in user mode since the thread first read them. </summary>
+    struct HardwareCounterSample {
+        uint64_t cycles = 0;
+        uint64_t instructions = 0;
+        uint64_t cacheReferences = 0;
+        uint64_t cacheMisses = 0;
+    };
+
+    /// <summary> Returns true if the hardware counters can be read, i.e. the CPU has a PMU the process may use. </summary>
+    /// <remarks> On Linux it's perf_event_open, which perf_event_paranoid may restrict, and virtual machines may lack. </remarks>
+    bool AreHardwareCountersSupported();
+
+    /// <summary> Reads the hardware counters of the calling thread. </summary>
+    /// <remarks> The counters are opened as one group on the first read of a thread, so they are scheduled together. </remarks>
+    /// <param name="sample"> Out parameter that receives the counters. </param>
+    /// <returns> True if the counters were read, false if they are not supported. </returns>
+    bool ReadThreadHardwareCounters(HardwareCounterSample& sample);
+}
+}
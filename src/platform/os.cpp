@@ -3,16 +3,148 @@
 
 #include <platform/os.h>
 #include <platform/platform.h>
+#include <platform/thread.h>
 
 #ifdef SUPPORT_POSIX
 #include <sys/utsname.h>
 #endif
 
+#ifdef SUPPORT_WINDOWS
+#include <windows.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
 #include <stdexcept>
 
 namespace napa {
 namespace platform {
 
+namespace {
+#if defined(OS_LINUX)
+    /// <summary> Reads the first line of a sysfs file, returns an empty string if the file doesn't exist. </summary>
+    std::string ReadSysfsLine(const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    /// <summary> Parses a sysfs size like '32K', returns 0 if it's malformed. </summary>
+    uint64_t ParseSysfsSize(const std::string& str) {
+        auto end = str.find_first_not_of("0123456789");
+        if (end == 0 || str.empty()) {
+            return 0;
+        }
+
+        uint64_t size = std::stoull(str.substr(0, end));
+        auto unit = end == std::string::npos ? '\0' : str[end];
+        switch (unit) {
+            case 'K': return size << 10;
+            case 'M': return size << 20;
+            case 'G': return size << 30;
+            default: return size;
+        }
+    }
+
+    void ReadNumaNodes(CpuTopology& topology) {
+        std::vector<uint32_t> nodes;
+        if (!ParseCpuList(ReadSysfsLine("/sys/devices/system/node/online"), nodes)) {
+            return;
+        }
+
+        for (auto node : nodes) {
+            auto cpus = GetNumaNodeCpus(node);
+            if (!cpus.empty()) {
+                topology.numaNodes.push_back({ node, std::move(cpus) });
+            }
+        }
+    }
+
+    void ReadCaches(CpuTopology& topology) {
+        for (uint32_t index = 0; ; ++index) {
+            auto directory = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+            auto level = ReadSysfsLine(directory + "level");
+            if (level.empty() || level.find_first_not_of("0123456789") != std::string::npos) {
+                break;
+            }
+
+            auto type = ReadSysfsLine(directory + "type");
+            std::transform(type.begin(), type.end(), type.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+            topology.caches.push_back({
+                static_cast<uint32_t>(std::stoul(level)),
+                type,
+                ParseSysfsSize(ReadSysfsLine(directory + "size")) });
+        }
+    }
+#elif defined(SUPPORT_WINDOWS)
+    void ReadNumaNodes(CpuTopology& topology) {
+        ULONG highest = 0;
+        if (!GetNumaHighestNodeNumber(&highest)) {
+            return;
+        }
+
+        for (uint32_t node = 0; node <= highest; ++node) {
+            auto cpus = GetNumaNodeCpus(node);
+            if (!cpus.empty()) {
+                topology.numaNodes.push_back({ node, std::move(cpus) });
+            }
+        }
+    }
+
+    void ReadCaches(CpuTopology& topology) {
+        DWORD length = 0;
+        GetLogicalProcessorInformation(nullptr, &length);
+
+        std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+        if (infos.empty() || !GetLogicalProcessorInformation(infos.data(), &length)) {
+            return;
+        }
+
+        for (const auto& info : infos) {
+            // Keep the caches of the first logical processor, like Linux reports them for cpu0.
+            if (info.Relationship != RelationCache || (info.ProcessorMask & 1) == 0) {
+                continue;
+            }
+
+            const char* type = "unified";
+            if (info.Cache.Type == CacheData) {
+                type = "data";
+            } else if (info.Cache.Type == CacheInstruction) {
+                type = "instruction";
+            }
+            topology.caches.push_back({ info.Cache.Level, type, info.Cache.Size });
+        }
+    }
+#else
+    void ReadNumaNodes(CpuTopology&) {}
+    void ReadCaches(CpuTopology&) {}
+#endif
+
+    CpuTopology ReadCpuTopology() {
+        CpuTopology topology;
+        topology.logicalCpus = GetCpuCount();
+        topology.physicalCores = static_cast<uint32_t>(GetPhysicalCoreCpus().size());
+
+        ReadNumaNodes(topology);
+        if (topology.numaNodes.empty()) {
+            // NUMA topology is not exposed, treat the machine as a single node.
+            NumaNodeInfo node = { 0, std::vector<uint32_t>(topology.logicalCpus) };
+            for (uint32_t cpu = 0; cpu < topology.logicalCpus; ++cpu) {
+                node.cpus[cpu] = cpu;
+            }
+            topology.numaNodes.push_back(std::move(node));
+        }
+
+        ReadCaches(topology);
+        std::stable_sort(topology.caches.begin(), topology.caches.end(), [](const CpuCacheInfo& left, const CpuCacheInfo& right) {
+            return left.level < right.level;
+        });
+        return topology;
+    }
+}
+
 const char* GetOSType() {
 #ifdef SUPPORT_POSIX
     static struct utsname info;
@@ -38,5 +170,10 @@ const char* GetOSType() {
     const char* DIR_SEPARATOR = "\\";
 #endif
 
+const CpuTopology& GetCpuTopology() {
+    static const CpuTopology topology = ReadCpuTopology();
+    return topology;
+}
+
 }
 }
@@ -3,6 +3,10 @@
 
 #pragma once
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 namespace napa {
 namespace platform {
     /// <summary> Get OS type. </summary>
@@ -13,5 +17,38 @@ namespace platform {
 
     /// <summary> Directory separator. </summary>
     extern const char* DIR_SEPARATOR;
+
+    /// <summary> A NUMA node and the logical CPUs it holds. </summary>
+    struct NumaNodeInfo {
+        uint32_t id;
+        std::vector<uint32_t> cpus;
+    };
+
+    /// <summary> A CPU cache, as seen by the first logical CPU. </summary>
+    struct CpuCacheInfo {
+        /// <summary> Cache level, 1 for L1. </summary>
+        uint32_t level;
+
+        /// <summary> 'data', 'instruction' or 'unified'. </summary>
+        std::string type;
+
+        /// <summary> Size in bytes. </summary>
+        uint64_t size;
+    };
+
+    /// <summary> The CPUs of the machine, for sizing and placing workers. </summary>
+    struct CpuTopology {
+        uint32_t logicalCpus = 0;
+        uint32_t physicalCores = 0;
+
+        /// <summary> NUMA nodes ordered by id, a single node 0 with all CPUs when NUMA is not exposed. </summary>
+        std::vector<NumaNodeInfo> numaNodes;
+
+        /// <summary> Caches ordered by level, empty when the system doesn't report them. </summary>
+        std::vector<CpuCacheInfo> caches;
+    };
+
+    /// <summary> Get the CPU topology of the machine, read once and cached. </summary>
+    const CpuTopology& GetCpuTopology();
 }
 }
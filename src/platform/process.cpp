@@ -8,19 +8,31 @@
 
 #include <unistd.h>
 #include <limits.h>
+#include <signal.h>
+#include <sys/types.h>
 #include <sys/syscall.h>
 
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+
 #else
 
 #include <windows.h>
 
 #include <io.h>
 #include <process.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
 
 #endif
 
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
 #include <functional>
 #include <memory>
 #include <sstream>
@@ -163,6 +175,48 @@ int32_t Gettid() {
 #endif
 }
 
+bool IsProcessRunning(int32_t pid) {
+    if (pid <= 0) {
+        return false;
+    }
+#ifdef SUPPORT_POSIX
+    // A process of another user can't be signaled, but it runs.
+    return ::kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#else
+    auto process = ::OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, static_cast<DWORD>(pid));
+    if (process == nullptr) {
+        return ::GetLastError() == ERROR_ACCESS_DENIED;
+    }
+    DWORD code = 0;
+    auto running = ::GetExitCodeProcess(process, &code) && code == STILL_ACTIVE;
+    ::CloseHandle(process);
+    return running;
+#endif
+}
+
+size_t GetResidentSetSize() {
+#if defined(OS_LINUX)
+    // The 2nd field of statm is the number of resident pages.
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    auto file = std::fopen("/proc/self/statm", "r");
+    if (file == nullptr) {
+        return 0;
+    }
+    auto fields = std::fscanf(file, "%lu %lu", &size, &resident);
+    std::fclose(file);
+    return fields == 2 ? static_cast<size_t>(resident) * static_cast<size_t>(sysconf(_SC_PAGESIZE)) : 0;
+#elif defined(SUPPORT_WINDOWS)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.WorkingSetSize;
+#else
+    return 0;
+#endif
+}
+
 int32_t Isatty(int32_t fd) {
 #ifdef SUPPORT_POSIX
     return static_cast<int32_t>(isatty(fd));
@@ -171,5 +225,62 @@ int32_t Isatty(int32_t fd) {
 #endif
 }
 
+size_t CaptureStackTrace(void** frames, size_t maxFrames, size_t skip) {
+    static constexpr size_t MAX_CAPTURED_FRAMES = 128;
+    void* captured[MAX_CAPTURED_FRAMES];
+
+    // This function's frame is left out as well.
+    skip++;
+#ifdef SUPPORT_POSIX
+    auto count = static_cast<size_t>(backtrace(captured, static_cast<int>(std::min(maxFrames + skip, MAX_CAPTURED_FRAMES))));
+#else
+    auto count = static_cast<size_t>(::CaptureStackBackTrace(0, static_cast<DWORD>(std::min(maxFrames + skip, MAX_CAPTURED_FRAMES)), captured, nullptr));
+#endif
+    if (count <= skip) {
+        return 0;
+    }
+
+    count = std::min(count - skip, maxFrames);
+    std::copy(captured + skip, captured + skip + count, frames);
+    return count;
+}
+
+std::string GetSymbolName(const void* address) {
+    std::stringstream stream;
+#ifdef SUPPORT_POSIX
+    Dl_info info;
+    if (dladdr(address, &info) == 0 || info.dli_fname == nullptr) {
+        stream << address;
+        return stream.str();
+    }
+
+    std::string module = info.dli_fname;
+    stream << module.substr(module.find_last_of('/') + 1) << '!';
+    if (info.dli_sname == nullptr) {
+        stream << '+' << reinterpret_cast<const void*>(
+            static_cast<const char*>(address) - static_cast<const char*>(info.dli_fbase));
+        return stream.str();
+    }
+
+    int status = 0;
+    std::unique_ptr<char, void(*)(void*)> demangled(abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status), std::free);
+    stream << (status == 0 && demangled != nullptr ? demangled.get() : info.dli_sname);
+#else
+    MEMORY_BASIC_INFORMATION mbi;
+    char path[MAX_PATH];
+    if (::VirtualQuery(address, &mbi, sizeof(mbi)) == 0
+        || ::GetModuleFileNameA(reinterpret_cast<HMODULE>(mbi.AllocationBase), path, sizeof(path)) == 0) {
+        stream << address;
+        return stream.str();
+    }
+
+    // Symbols need the debug help library and PDBs, tools resolve module offsets instead.
+    std::string module = path;
+    stream << module.substr(module.find_last_of('\\') + 1) << "!+" << reinterpret_cast<const void*>(
+        static_cast<const char*>(address) - static_cast<const char*>(mbi.AllocationBase));
+#endif
+    return stream.str();
+}
+
 }
 }
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -30,9 +31,26 @@ namespace platform {
     /// <summary> Return tid. </summary>
     int32_t Gettid();
 
+    /// <summary> Tell if a process of the host is running, i.e. the peer of a shared memory segment. </summary>
+    /// <param name="pid"> The process id. </param>
+    bool IsProcessRunning(int32_t pid);
+
+    /// <summary> Get the bytes of memory of the process resident in physical pages, 0 if not supported. </summary>
+    size_t GetResidentSetSize();
+
     /// <summary> Return nonzero value if a descriptor is associated with a character device. </summary>
     /// <param name="fd"> File descriptor. </param>
     int32_t Isatty(int32_t fd);
 
+    /// <summary> Capture the return addresses of the calling thread's stack, innermost first. </summary>
+    /// <param name="frames"> Receives the addresses. </param>
+    /// <param name="maxFrames"> The number of addresses frames can hold. </param>
+    /// <param name="skip"> The number of innermost frames to leave out, besides this function's. </param>
+    /// <returns> The number of addresses captured, 0 if not supported. </returns>
+    size_t CaptureStackTrace(void** frames, size_t maxFrames, size_t skip);
+
+    /// <summary> Describe a code address as 'module!symbol', or 'module!+offset' when the symbol is unknown. </summary>
+    std::string GetSymbolName(const void* address);
+
 }
 }
\ No newline at end of file
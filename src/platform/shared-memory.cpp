@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <platform/shared-memory.h>
+#include <platform/platform.h>
+
+#include <chrono>
+#include <thread>
+
+#ifdef SUPPORT_POSIX
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+namespace napa {
+namespace platform {
+
+namespace {
+
+    /// <summary> Longest time to wait for the creator of a segment to size it. </summary>
+    constexpr std::chrono::milliseconds SIZING_TIMEOUT(1000);
+
+#ifdef SUPPORT_POSIX
+    std::string GetSegmentName(const std::string& name) {
+        return "/" + name;
+    }
+#else
+    std::string GetSegmentName(const std::string& name) {
+        return "Local\\" + name;
+    }
+#endif
+}
+
+SharedMemory::SharedMemory(const std::string& name, size_t size)
+    : _created(false), _data(nullptr), _size(0) {
+    auto segmentName = GetSegmentName(name);
+
+#ifdef SUPPORT_POSIX
+    auto fd = ::shm_open(segmentName.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            (void)::close(fd);
+            (void)::shm_unlink(segmentName.c_str());
+            return;
+        }
+        _created = true;
+    } else {
+        if (errno != EEXIST) {
+            return;
+        }
+        fd = ::shm_open(segmentName.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            return;
+        }
+
+        // The segment exists once it's created, and it's sized right after.
+        struct stat status;
+        auto deadline = std::chrono::steady_clock::now() + SIZING_TIMEOUT;
+        while (::fstat(fd, &status) == 0 && status.st_size == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (::fstat(fd, &status) != 0 || status.st_size == 0) {
+            (void)::close(fd);
+            return;
+        }
+        size = static_cast<size_t>(status.st_size);
+    }
+
+    auto data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    (void)::close(fd);
+
+    if (data != MAP_FAILED) {
+        _data = data;
+        _size = size;
+    }
+#else
+    auto mapping = ::CreateFileMappingA(
+        INVALID_HANDLE_VALUE,
+        nullptr,
+        PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+        static_cast<DWORD>(size),
+        segmentName.c_str());
+    if (mapping == nullptr) {
+        return;
+    }
+    _created = ::GetLastError() != ERROR_ALREADY_EXISTS;
+
+    // The view keeps the mapping object alive.
+    auto data = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    (void)::CloseHandle(mapping);
+
+    MEMORY_BASIC_INFORMATION info;
+    if (data != nullptr && ::VirtualQuery(data, &info, sizeof(info)) != 0) {
+        _data = data;
+        _size = _created ? size : static_cast<size_t>(info.RegionSize);
+    }
+#endif
+}
+
+SharedMemory::~SharedMemory() {
+    if (_data == nullptr) {
+        return;
+    }
+#ifdef SUPPORT_POSIX
+    (void)::munmap(_data, _size);
+#else
+    (void)::UnmapViewOfFile(_data);
+#endif
+}
+
+bool SharedMemory::IsOpen() const {
+    return _data != nullptr;
+}
+
+bool SharedMemory::IsCreated() const {
+    return _created;
+}
+
+void* SharedMemory::Data() const {
+    return _data;
+}
+
+size_t SharedMemory::Size() const {
+    return _size;
+}
+
+bool RemoveSharedMemory(const std::string& name) {
+#ifdef SUPPORT_POSIX
+    return ::shm_unlink(GetSegmentName(name).c_str()) == 0;
+#else
+    // Segments are released once the last process unmaps them.
+    (void)name;
+    return false;
+#endif
+}
+
+}
+}
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace napa {
+namespace platform {
+
+    /// <summary> A named memory segment that processes on the same host map together. </summary>
+    /// <remarks>
+    /// On POSIX the segment outlives the processes that map it, until it's removed by RemoveSharedMemory or the host
+    /// restarts. On Windows it's released when the last process unmaps it. The mapping is released on destruction.
+    /// </remarks>
+    class SharedMemory {
+    public:
+        /// <summary> Open a segment, or create it zero-filled if it doesn't exist. </summary>
+        /// <param name="name"> Name of the segment, which must not contain path separators. </param>
+        /// <param name="size"> Size in bytes of a created segment. An opened segment keeps the size it was created with. </param>
+        SharedMemory(const std::string& name, size_t size);
+        ~SharedMemory();
+
+        /// <summary> Tell if the segment was mapped. </summary>
+        bool IsOpen() const;
+
+        /// <summary> Tell if this call created the segment, in which case the caller initializes it. </summary>
+        bool IsCreated() const;
+
+        /// <summary> Start of the mapped memory, or nullptr if not open. </summary>
+        void* Data() const;
+
+        /// <summary> Size of the mapped memory in bytes. </summary>
+        size_t Size() const;
+
+    private:
+        SharedMemory(const SharedMemory&) = delete;
+        SharedMemory& operator=(const SharedMemory&) = delete;
+
+        bool _created;
+        void* _data;
+        size_t _size;
+    };
+
+    /// <summary> Remove a named segment, processes that mapped it keep their mappings. </summary>
+    /// <returns> True if the segment existed and was removed. </returns>
+    bool RemoveSharedMemory(const std::string& name);
+}
+}
@@ -0,0 +1,298 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <platform/socket.h>
+#include <platform/platform.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#ifdef SUPPORT_POSIX
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#else
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#endif
+
+namespace napa {
+namespace platform {
+
+namespace {
+
+#ifdef SUPPORT_POSIX
+    constexpr intptr_t INVALID_HANDLE = -1;
+
+    void CloseHandle(intptr_t handle) {
+        (void)::close(static_cast<int>(handle));
+    }
+
+    bool IsInterrupted() {
+        return errno == EINTR;
+    }
+
+#ifdef MSG_NOSIGNAL
+    // A peer closing the connection fails the write instead of raising SIGPIPE.
+    constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    constexpr int SEND_FLAGS = 0;
+#endif
+#else
+    const intptr_t INVALID_HANDLE = static_cast<intptr_t>(INVALID_SOCKET);
+
+    void CloseHandle(intptr_t handle) {
+        (void)::closesocket(static_cast<SOCKET>(handle));
+    }
+
+    bool IsInterrupted() {
+        return ::WSAGetLastError() == WSAEINTR;
+    }
+
+    constexpr int SEND_FLAGS = 0;
+#endif
+
+    /// <summary> Initializes Winsock once per process, there is nothing to initialize on POSIX. </summary>
+    void InitializeSockets() {
+#ifdef SUPPORT_WINDOWS
+        static std::once_flag initialized;
+        std::call_once(initialized, []() {
+            WSADATA data;
+            (void)::WSAStartup(MAKEWORD(2, 2), &data);
+        });
+#endif
+    }
+
+    /// <summary> Resolves a host and port into addresses, to be freed by freeaddrinfo. </summary>
+    addrinfo* Resolve(const std::string& host, uint16_t port, bool passive) {
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+        if (passive) {
+            hints.ai_flags = AI_PASSIVE;
+        }
+
+        auto service = std::to_string(port);
+        addrinfo* addresses = nullptr;
+        if (::getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &addresses) != 0) {
+            return nullptr;
+        }
+        return addresses;
+    }
+}
+
+Socket::Socket() : _handle(INVALID_HANDLE) {}
+
+Socket::Socket(intptr_t handle) : _handle(handle) {}
+
+Socket::~Socket() {
+    Close();
+}
+
+Socket::Socket(Socket&& other) : _handle(other._handle) {
+    other._handle = INVALID_HANDLE;
+}
+
+Socket& Socket::operator=(Socket&& other) {
+    if (this != &other) {
+        Close();
+        _handle = other._handle;
+        other._handle = INVALID_HANDLE;
+    }
+    return *this;
+}
+
+Socket Socket::Connect(const std::string& host, uint16_t port) {
+    InitializeSockets();
+
+    auto addresses = Resolve(host, port, false);
+    if (addresses == nullptr) {
+        return Socket();
+    }
+
+    Socket socket;
+    for (auto address = addresses; address != nullptr; address = address->ai_next) {
+        auto handle = static_cast<intptr_t>(::socket(address->ai_family, address->ai_socktype, address->ai_protocol));
+        if (handle == INVALID_HANDLE) {
+            continue;
+        }
+        if (::connect(handle, address->ai_addr, static_cast<int>(address->ai_addrlen)) != 0) {
+            CloseHandle(handle);
+            continue;
+        }
+
+        int noDelay = 1;
+        (void)::setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+#if defined(SO_NOSIGPIPE)
+        int noSigPipe = 1;
+        (void)::setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+        socket = Socket(handle);
+        break;
+    }
+    ::freeaddrinfo(addresses);
+    return socket;
+}
+
+bool Socket::IsConnected() const {
+    return _handle != INVALID_HANDLE;
+}
+
+bool Socket::Write(const void* data, size_t size) {
+    auto bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        auto chunk = static_cast<int>(size < 0x40000000 ? size : 0x40000000);
+        auto written = ::send(_handle, bytes, chunk, SEND_FLAGS);
+        if (written < 0) {
+            if (IsInterrupted()) {
+                continue;
+            }
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool Socket::Read(void* data, size_t size) {
+    auto bytes = static_cast<char*>(data);
+    while (size > 0) {
+        auto chunk = static_cast<int>(size < 0x40000000 ? size : 0x40000000);
+        auto read = ::recv(_handle, bytes, chunk, 0);
+        if (read < 0 && IsInterrupted()) {
+            continue;
+        }
+        if (read <= 0) {
+            return false;
+        }
+        bytes += read;
+        size -= static_cast<size_t>(read);
+    }
+    return true;
+}
+
+void Socket::Shutdown() {
+    if (_handle != INVALID_HANDLE) {
+#ifdef SUPPORT_POSIX
+        (void)::shutdown(static_cast<int>(_handle), SHUT_RDWR);
+#else
+        (void)::shutdown(static_cast<SOCKET>(_handle), SD_BOTH);
+#endif
+    }
+}
+
+void Socket::Close() {
+    if (_handle != INVALID_HANDLE) {
+        CloseHandle(_handle);
+        _handle = INVALID_HANDLE;
+    }
+}
+
+Listener::Listener(const std::string& host, uint16_t port) : _handle(INVALID_HANDLE), _port(0) {
+    InitializeSockets();
+
+    auto addresses = Resolve(host, port, true);
+    if (addresses == nullptr) {
+        return;
+    }
+
+    for (auto address = addresses; address != nullptr; address = address->ai_next) {
+        auto handle = static_cast<intptr_t>(::socket(address->ai_family, address->ai_socktype, address->ai_protocol));
+        if (handle == INVALID_HANDLE) {
+            continue;
+        }
+
+        // A restarted server can listen again on the port of connections still waiting to time out.
+        int reuse = 1;
+        (void)::setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        if (::bind(handle, address->ai_addr, static_cast<int>(address->ai_addrlen)) != 0 || ::listen(handle, SOMAXCONN) != 0) {
+            CloseHandle(handle);
+            continue;
+        }
+
+        sockaddr_storage bound;
+        socklen_t length = sizeof(bound);
+        if (::getsockname(handle, reinterpret_cast<sockaddr*>(&bound), &length) == 0) {
+            _port = ntohs(bound.ss_family == AF_INET6
+                ? reinterpret_cast<sockaddr_in6*>(&bound)->sin6_port
+                : reinterpret_cast<sockaddr_in*>(&bound)->sin_port);
+        }
+        _handle = handle;
+        break;
+    }
+    ::freeaddrinfo(addresses);
+}
+
+Listener::~Listener() {
+    if (_handle != INVALID_HANDLE) {
+        CloseHandle(_handle);
+    }
+}
+
+bool Listener::IsListening() const {
+    return _handle != INVALID_HANDLE;
+}
+
+uint16_t Listener::GetPort() const {
+    return _port;
+}
+
+Socket Listener::Accept() {
+    for (;;) {
+        auto handle = static_cast<intptr_t>(::accept(_handle, nullptr, nullptr));
+        if (handle != INVALID_HANDLE) {
+            int noDelay = 1;
+            (void)::setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+#if defined(SO_NOSIGPIPE)
+            int noSigPipe = 1;
+            (void)::setsockopt(handle, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+            return Socket(handle);
+        }
+        if (!IsInterrupted()) {
+            return Socket();
+        }
+    }
+}
+
+void Listener::Shutdown() {
+    if (_handle != INVALID_HANDLE) {
+#ifdef SUPPORT_POSIX
+        (void)::shutdown(static_cast<int>(_handle), SHUT_RDWR);
+#else
+        // Winsock doesn't wake up accept on shutdown, closing the socket does.
+        CloseHandle(_handle);
+        _handle = INVALID_HANDLE;
+#endif
+    }
+}
+
+bool ParseAddress(const std::string& address, std::string& host, uint16_t& port) {
+    auto colon = address.rfind(':');
+    if (colon == std::string::npos || colon + 1 == address.size()) {
+        return false;
+    }
+
+    char* end = nullptr;
+    auto value = std::strtoul(address.c_str() + colon + 1, &end, 10);
+    if (*end != '\0' || value > 65535) {
+        return false;
+    }
+
+    host = address.substr(0, colon);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    port = static_cast<uint16_t>(value);
+    return true;
+}
+}
+}
@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace napa {
+namespace platform {
+
+    /// <summary> A connected TCP socket with blocking reads and writes, closed on destruction. </summary>
+    class Socket {
+    public:
+        /// <summary> Creates a socket that isn't connected. </summary>
+        Socket();
+
+        /// <summary> Takes over a connected native socket. </summary>
+        explicit Socket(intptr_t handle);
+
+        ~Socket();
+
+        Socket(Socket&& other);
+        Socket& operator=(Socket&& other);
+
+        /// <summary> Connects to a host and port, with Nagle's algorithm disabled since calls are small and pipelined. </summary>
+        /// <param name="host"> A host name or an IPv4 or IPv6 address. </param>
+        /// <param name="port"> The TCP port. </param>
+        /// <returns> A socket that isn't connected if connecting failed. </returns>
+        static Socket Connect(const std::string& host, uint16_t port);
+
+        /// <summary> Tell if the socket is connected. </summary>
+        bool IsConnected() const;
+
+        /// <summary> Writes all the bytes, unless the connection fails. </summary>
+        /// <returns> False if the connection failed. </returns>
+        bool Write(const void* data, size_t size);
+
+        /// <summary> Reads exactly size bytes, unless the connection fails or is closed by the peer. </summary>
+        /// <returns> False if the connection failed or was closed. </returns>
+        bool Read(void* data, size_t size);
+
+        /// <summary> Shuts both directions down, which makes blocked reads of other threads return, but keeps the handle. </summary>
+        void Shutdown();
+
+    private:
+        Socket(const Socket&) = delete;
+        Socket& operator=(const Socket&) = delete;
+
+        void Close();
+
+        intptr_t _handle;
+    };
+
+    /// <summary> A TCP socket listening for connections, closed on destruction. </summary>
+    class Listener {
+    public:
+        /// <summary> Listens on an address. </summary>
+        /// <param name="host"> The local address to listen on, like '0.0.0.0', or '127.0.0.1' for the host only. </param>
+        /// <param name="port"> The TCP port, 0 for a port chosen by the system. </param>
+        Listener(const std::string& host, uint16_t port);
+        ~Listener();
+
+        /// <summary> Tell if the socket is listening. </summary>
+        bool IsListening() const;
+
+        /// <summary> The port listened on, i.e. the one the system chose. </summary>
+        uint16_t GetPort() const;
+
+        /// <summary> Waits for the next connection. </summary>
+        /// <returns> A socket that isn't connected once the listener is shut down. </returns>
+        Socket Accept();
+
+        /// <summary> Stops listening, which makes a blocked Accept of another thread return. </summary>
+        void Shutdown();
+
+    private:
+        Listener(const Listener&) = delete;
+        Listener& operator=(const Listener&) = delete;
+
+        intptr_t _handle;
+        uint16_t _port;
+    };
+
+    /// <summary> Splits an address like 'host:port' or '[::1]:port' into its host and port. </summary>
+    /// <returns> False if the address has no valid port. </returns>
+    bool ParseAddress(const std::string& address, std::string& host, uint16_t& port);
+}
+}
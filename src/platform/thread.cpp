@@ -0,0 +1,363 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <platform/thread.h>
+#include <platform/platform.h>
+
+#if defined(OS_LINUX)
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(SUPPORT_WINDOWS)
+#include <windows.h>
+#pragma comment(lib, "synchronization.lib")
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+
+namespace napa {
+namespace platform {
+
+namespace {
+#if defined(OS_LINUX)
+    /// <summary> Reads a CPU list from a sysfs file, returns an empty list if the file doesn't exist. </summary>
+    std::vector<uint32_t> ReadCpuListFile(const std::string& path) {
+        std::vector<uint32_t> cpus;
+
+        std::ifstream file(path);
+        std::string content;
+        if (file && std::getline(file, content)) {
+            if (!ParseCpuList(content, cpus)) {
+                cpus.clear();
+            }
+        }
+        return cpus;
+    }
+#endif
+
+#if !defined(OS_LINUX) && !defined(SUPPORT_WINDOWS)
+    /// <summary> Condition variables for waits on values, picked by the address of the value. </summary>
+    struct ValueWaitBucket {
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    ValueWaitBucket& GetValueWaitBucket(const void* address) {
+        static ValueWaitBucket buckets[64];
+        return buckets[(reinterpret_cast<uintptr_t>(address) >> 4) % 64];
+    }
+#endif
+}
+
+bool ParseCpuList(const std::string& str, std::vector<uint32_t>& cpus) {
+    std::set<uint32_t> result;
+
+    std::stringstream stream(str);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        // Trim white spaces and new lines.
+        range.erase(std::remove_if(range.begin(), range.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); }), range.end());
+        if (range.empty()) {
+            continue;
+        }
+
+        auto dash = range.find('-');
+        auto first = range.substr(0, dash);
+        auto last = dash == std::string::npos ? first : range.substr(dash + 1);
+
+        if (first.empty() || last.empty()
+            || first.find_first_not_of("0123456789") != std::string::npos
+            || last.find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+
+        auto begin = static_cast<uint32_t>(std::stoul(first));
+        auto end = static_cast<uint32_t>(std::stoul(last));
+        if (begin > end) {
+            return false;
+        }
+
+        for (auto cpu = begin; cpu <= end; ++cpu) {
+            result.insert(cpu);
+        }
+    }
+
+    cpus.assign(result.begin(), result.end());
+    return true;
+}
+
+uint32_t GetCpuCount() {
+    auto count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+std::vector<uint32_t> GetNumaNodeCpus(uint32_t node) {
+#if defined(OS_LINUX)
+    return ReadCpuListFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+#elif defined(SUPPORT_WINDOWS)
+    std::vector<uint32_t> cpus;
+    ULONGLONG mask = 0;
+    if (node <= 0xFF && GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask)) {
+        for (uint32_t cpu = 0; cpu < 64; ++cpu) {
+            if (mask & (1ULL << cpu)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    return cpus;
+#else
+    // NUMA topology is not exposed, treat the machine as a single node.
+    if (node != 0) {
+        return {};
+    }
+
+    std::vector<uint32_t> cpus(GetCpuCount());
+    for (uint32_t cpu = 0; cpu < cpus.size(); ++cpu) {
+        cpus[cpu] = cpu;
+    }
+    return cpus;
+#endif
+}
+
+std::vector<uint32_t> GetPhysicalCoreCpus() {
+    std::vector<uint32_t> cpus;
+
+#if defined(OS_LINUX)
+    std::set<uint32_t> cores;
+    for (uint32_t cpu = 0; cpu < GetCpuCount(); ++cpu) {
+        auto siblings = ReadCpuListFile(
+            "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list");
+
+        // The first sibling represents the physical core.
+        cores.insert(siblings.empty() ? cpu : siblings.front());
+    }
+    cpus.assign(cores.begin(), cores.end());
+#elif defined(SUPPORT_WINDOWS)
+    DWORD length = 0;
+    GetLogicalProcessorInformation(nullptr, &length);
+
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!infos.empty() && GetLogicalProcessorInformation(infos.data(), &length)) {
+        for (const auto& info : infos) {
+            if (info.Relationship != RelationProcessorCore) {
+                continue;
+            }
+
+            // The lowest logical processor represents the physical core.
+            for (uint32_t cpu = 0; cpu < sizeof(ULONG_PTR) * 8; ++cpu) {
+                if (info.ProcessorMask & (static_cast<ULONG_PTR>(1) << cpu)) {
+                    cpus.push_back(cpu);
+                    break;
+                }
+            }
+        }
+        std::sort(cpus.begin(), cpus.end());
+    }
+#endif
+
+    if (cpus.empty()) {
+        for (uint32_t cpu = 0; cpu < GetCpuCount(); ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+bool SetCurrentThreadAffinity(const std::vector<uint32_t>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+
+#if defined(OS_LINUX)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : cpus) {
+        if (cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(SUPPORT_WINDOWS)
+    DWORD_PTR mask = 0;
+    for (auto cpu : cpus) {
+        if (cpu >= sizeof(DWORD_PTR) * 8) {
+            return false;
+        }
+        mask |= static_cast<DWORD_PTR>(1) << cpu;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+    // Thread affinity is not supported on this platform.
+    return false;
+#endif
+}
+
+bool SetCurrentThreadPriority(ThreadPriority priority) {
+#if defined(OS_LINUX)
+    // Nice values and policies are per thread on Linux, the thread is identified by its kernel id.
+    int nice = 0;
+    int policy = SCHED_OTHER;
+    switch (priority) {
+        case ThreadPriority::High: nice = -5; break;
+        case ThreadPriority::Normal: nice = 0; break;
+        case ThreadPriority::Low: nice = 10; break;
+        case ThreadPriority::Background: nice = 19; policy = SCHED_BATCH; break;
+    }
+
+    struct sched_param param;
+    param.sched_priority = 0;
+    if (pthread_setschedparam(pthread_self(), policy, &param) != 0) {
+        return false;
+    }
+    return setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), nice) == 0;
+#elif defined(SUPPORT_WINDOWS)
+    int value = THREAD_PRIORITY_NORMAL;
+    switch (priority) {
+        case ThreadPriority::High: value = THREAD_PRIORITY_ABOVE_NORMAL; break;
+        case ThreadPriority::Normal: value = THREAD_PRIORITY_NORMAL; break;
+        case ThreadPriority::Low: value = THREAD_PRIORITY_BELOW_NORMAL; break;
+        case ThreadPriority::Background: value = THREAD_MODE_BACKGROUND_BEGIN; break;
+    }
+    return SetThreadPriority(GetCurrentThread(), value) != 0;
+#else
+    // Thread priorities are not supported on this platform.
+    (void)priority;
+    return false;
+#endif
+}
+
+bool GetCurrentThreadCpuUsage(ThreadCpuUsage& usage) {
+#if defined(OS_LINUX)
+    struct rusage resources;
+    if (getrusage(RUSAGE_THREAD, &resources) != 0) {
+        return false;
+    }
+    usage.user = static_cast<uint64_t>(resources.ru_utime.tv_sec) * 1000000 + resources.ru_utime.tv_usec;
+    usage.system = static_cast<uint64_t>(resources.ru_stime.tv_sec) * 1000000 + resources.ru_stime.tv_usec;
+    return true;
+#elif defined(SUPPORT_WINDOWS)
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return false;
+    }
+
+    // File times count 100 nanoseconds.
+    auto toMicroseconds = [](const FILETIME& time) {
+        return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10;
+    };
+    usage.user = toMicroseconds(user);
+    usage.system = toMicroseconds(kernel);
+    return true;
+#else
+    // Per-thread CPU clocks are not supported on this platform.
+    (void)usage;
+    return false;
+#endif
+}
+
+void CpuRelax() {
+#if defined(SUPPORT_WINDOWS)
+    YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+bool WaitOnValue(const std::atomic<uint32_t>& value, uint32_t expected, std::chrono::milliseconds timeout) {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Atomic values must be waitable as plain values");
+
+    if (value.load(std::memory_order_acquire) != expected) {
+        return true;
+    }
+
+#if defined(OS_LINUX)
+    struct timespec relative;
+    relative.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    relative.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+    auto result = syscall(SYS_futex, reinterpret_cast<const uint32_t*>(&value), FUTEX_WAIT_PRIVATE, expected, &relative, nullptr, 0);
+    return result == 0 || errno != ETIMEDOUT;
+#elif defined(SUPPORT_WINDOWS)
+    auto address = const_cast<std::atomic<uint32_t>*>(&value);
+    if (WaitOnAddress(address, &expected, sizeof(expected), static_cast<DWORD>(timeout.count()))) {
+        return true;
+    }
+    return GetLastError() != ERROR_TIMEOUT;
+#else
+    auto& bucket = GetValueWaitBucket(&value);
+    std::unique_lock<std::mutex> lock(bucket.mutex);
+    return bucket.condition.wait_for(lock, timeout, [&value, expected]() {
+        return value.load(std::memory_order_acquire) != expected;
+    });
+#endif
+}
+
+bool WaitOnSharedValue(const std::atomic<uint32_t>& value, uint32_t expected, std::chrono::milliseconds timeout) {
+    if (value.load(std::memory_order_acquire) != expected) {
+        return true;
+    }
+
+#if defined(OS_LINUX)
+    struct timespec relative;
+    relative.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    relative.tv_nsec = static_cast<long>((timeout.count() % 1000) * 1000000);
+    auto result = syscall(SYS_futex, reinterpret_cast<const uint32_t*>(&value), FUTEX_WAIT, expected, &relative, nullptr, 0);
+    return result == 0 || errno != ETIMEDOUT;
+#else
+    // WaitOnAddress and condition variables only wake threads of the same process.
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (value.load(std::memory_order_acquire) == expected) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+#endif
+}
+
+void WakeOnSharedValue(std::atomic<uint32_t>& value) {
+#if defined(OS_LINUX)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&value), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#else
+    // Waiters poll the value.
+    (void)value;
+#endif
+}
+
+void WakeOnValue(std::atomic<uint32_t>& value) {
+#if defined(OS_LINUX)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&value), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#elif defined(SUPPORT_WINDOWS)
+    WakeByAddressAll(&value);
+#else
+    auto& bucket = GetValueWaitBucket(&value);
+    {
+        // Locking orders the change of the value before a waiter checking it.
+        std::lock_guard<std::mutex> lock(bucket.mutex);
+    }
+    bucket.condition.notify_all();
+#endif
+}
+
+}
+}
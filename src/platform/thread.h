@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace platform {
+
+    /// <summary> CPU time spent by a thread, in microseconds. </summary>
+    struct ThreadCpuUsage {
+        uint64_t user = 0;
+        uint64_t system = 0;
+    };
+
+    /// <summary> The scheduling priority of a thread relative to the other threads of the system. </summary>
+    enum class ThreadPriority {
+
+        /// <summary> Preempts threads of normal priority, raising the priority may require privileges. </summary>
+        High,
+
+        /// <summary> The priority threads are created with. </summary>
+        Normal,
+
+        /// <summary> Yields to threads of normal priority when both are runnable. </summary>
+        Low,
+
+        /// <summary> Runs on the CPU time other threads leave, and is never preferred to wake up, for batch work. </summary>
+        Background
+    };
+
+    /// <summary> Parses a CPU list like "0-3,8,10-11" into sorted unique CPU indices. </summary>
+    /// <param name="str"> The CPU list string. </param>
+    /// <param name="cpus"> Out parameter that receives the CPU indices. </param>
+    /// <returns> True if the string is a valid CPU list, false otherwise. </returns>
+    bool ParseCpuList(const std::string& str, std::vector<uint32_t>& cpus);
+
+    /// <summary> Get the number of logical CPUs. </summary>
+    uint32_t GetCpuCount();
+
+    /// <summary> Get the logical CPUs which belong to a NUMA node, empty if the node is unknown. </summary>
+    std::vector<uint32_t> GetNumaNodeCpus(uint32_t node);
+
+    /// <summary> Get one logical CPU per physical core, so hyper-threaded siblings are skipped. </summary>
+    std::vector<uint32_t> GetPhysicalCoreCpus();
+
+    /// <summary> Restrict the calling thread to run on the given logical CPUs. </summary>
+    /// <returns> True if the affinity was applied, false if it failed or is not supported. </returns>
+    bool SetCurrentThreadAffinity(const std::vector<uint32_t>& cpus);
+
+    /// <summary>
+    ///     Set the scheduling priority of the calling thread. On Linux it's the nice value of the thread, and the
+    ///     SCHED_BATCH policy for background threads. On Windows it's the thread priority, and the background mode.
+    /// </summary>
+    /// <returns> True if the priority was applied, false if it failed or is not supported. </returns>
+    bool SetCurrentThreadPriority(ThreadPriority priority);
+
+    /// <summary> Get the CPU time spent by the calling thread, from the per-thread clocks of the system. </summary>
+    /// <returns> False if it's not supported on this platform. </returns>
+    bool GetCurrentThreadCpuUsage(ThreadCpuUsage& usage);
+
+    /// <summary> Hints the CPU that the calling thread is spinning in a wait loop. </summary>
+    void CpuRelax();
+
+    /// <summary>
+    ///     Blocks the calling thread while the value equals expected, at most for the timeout. It uses a futex on
+    ///     Linux and WaitOnAddress on Windows, so waiting needs no mutex, and may return spuriously.
+    /// </summary>
+    /// <returns> False if the timeout elapsed, true if woken or if the value already differed. </returns>
+    bool WaitOnValue(const std::atomic<uint32_t>& value, uint32_t expected, std::chrono::milliseconds timeout);
+
+    /// <summary> Wakes all threads waiting in WaitOnValue on the value, after it was changed. </summary>
+    void WakeOnValue(std::atomic<uint32_t>& value);
+
+    /// <summary>
+    ///     Like WaitOnValue, for a value in shared memory that threads of other processes change. It uses a futex
+    ///     shared between processes on Linux, other platforms have no such wait and poll the value every millisecond.
+    /// </summary>
+    /// <returns> False if the timeout elapsed, true if woken or if the value already differed. </returns>
+    bool WaitOnSharedValue(const std::atomic<uint32_t>& value, uint32_t expected, std::chrono::milliseconds timeout);
+
+    /// <summary> Wakes all threads of any process waiting in WaitOnSharedValue on the value, after it was changed. </summary>
+    void WakeOnSharedValue(std::atomic<uint32_t>& value);
+}
+}
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <platform/tracepoint.h>
+
+#if defined(NAPA_TRACEPOINTS_ETW)
+
+// {3f5c6a2e-8d1b-4c47-9a0e-5b2d7c1f6e03}
+TRACELOGGING_DEFINE_PROVIDER(
+    napaTraceProvider,
+    "Napa",
+    (0x3f5c6a2e, 0x8d1b, 0x4c47, 0x9a, 0x0e, 0x5b, 0x2d, 0x7c, 0x1f, 0x6e, 0x03));
+
+namespace {
+
+    /// <summary> Registers the provider while the module is loaded, events written before are dropped. </summary>
+    struct ProviderRegistration {
+        ProviderRegistration() {
+            (void)TraceLoggingRegister(napaTraceProvider);
+        }
+
+        ~ProviderRegistration() {
+            TraceLoggingUnregister(napaTraceProvider);
+        }
+    } registration;
+}
+
+#endif
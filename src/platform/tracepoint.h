@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <platform/platform.h>
+
+/// <summary>
+///     Static tracepoints of the 'napa' provider, which tracing tools attach to in a running process.
+///
+///     On Linux they are USDT probes, a nop instruction each which the tool patches while attached, like:
+///         bpftrace -e 'usdt:/path/to/libnapa.so:napa:task__end { @ns[str(arg0)] = hist(arg2); }'
+///     On Windows they are TraceLogging events, whose arguments are only evaluated while a session enables the provider.
+///     They compile to nothing elsewhere, without <sys/sdt.h>, or with NAPA_TRACEPOINTS_DISABLED.
+///
+///     Arguments are named for TraceLogging, and must be integers or C strings. USDT probes get them by position.
+/// </summary>
+
+#if !defined(NAPA_TRACEPOINTS_DISABLED) && defined(OS_LINUX) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define NAPA_TRACEPOINTS_USDT
+#endif
+#elif !defined(NAPA_TRACEPOINTS_DISABLED) && defined(OS_WINDOWS)
+#define NAPA_TRACEPOINTS_ETW
+#endif
+
+#if defined(NAPA_TRACEPOINTS_USDT)
+
+#include <sys/sdt.h>
+
+#define NAPA_TRACEPOINT1(name, name1, arg1) \
+    DTRACE_PROBE1(napa, name, arg1)
+
+#define NAPA_TRACEPOINT2(name, name1, arg1, name2, arg2) \
+    DTRACE_PROBE2(napa, name, arg1, arg2)
+
+#define NAPA_TRACEPOINT3(name, name1, arg1, name2, arg2, name3, arg3) \
+    DTRACE_PROBE3(napa, name, arg1, arg2, arg3)
+
+#elif defined(NAPA_TRACEPOINTS_ETW)
+
+#include <windows.h>
+#include <TraceLoggingProvider.h>
+
+/// <summary> The 'Napa' TraceLogging provider, registered while the module is loaded. </summary>
+TRACELOGGING_DECLARE_PROVIDER(napaTraceProvider);
+
+#define NAPA_TRACEPOINT1(name, name1, arg1) \
+    TraceLoggingWrite(napaTraceProvider, #name, TraceLoggingValue(arg1, name1))
+
+#define NAPA_TRACEPOINT2(name, name1, arg1, name2, arg2) \
+    TraceLoggingWrite(napaTraceProvider, #name, TraceLoggingValue(arg1, name1), TraceLoggingValue(arg2, name2))
+
+#define NAPA_TRACEPOINT3(name, name1, arg1, name2, arg2, name3, arg3) \
+    TraceLoggingWrite(napaTraceProvider, #name, \
+        TraceLoggingValue(arg1, name1), TraceLoggingValue(arg2, name2), TraceLoggingValue(arg3, name3))
+
+#else
+
+#define NAPA_TRACEPOINT1(name, name1, arg1) ((void)0)
+#define NAPA_TRACEPOINT2(name, name1, arg1, name2, arg2) ((void)0)
+#define NAPA_TRACEPOINT3(name, name1, arg1, name2, arg2, name3, arg3) ((void)0)
+
+#endif
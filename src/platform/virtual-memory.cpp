@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <platform/virtual-memory.h>
+#include <platform/platform.h>
+
+#include <cstdint>
+
+#ifdef SUPPORT_POSIX
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#include <windows.h>
+#endif
+
+namespace napa {
+namespace platform {
+
+size_t GetPageSize() {
+#ifdef SUPPORT_POSIX
+    static const size_t pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#else
+    static const size_t pageSize = []() {
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+    }();
+#endif
+    return pageSize;
+}
+
+#ifdef SUPPORT_POSIX
+
+namespace {
+
+    void* MapAnonymous(size_t size, int flags) {
+        auto address = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+        return address == MAP_FAILED ? nullptr : address;
+    }
+
+    /// <summary> Map more than needed and trim both ends, so the mapping starts on a huge page boundary. </summary>
+    void* MapAligned(size_t size) {
+        auto address = static_cast<uint8_t*>(MapAnonymous(size + HUGE_PAGE_SIZE, 0));
+        if (address == nullptr) {
+            return nullptr;
+        }
+
+        auto offset = reinterpret_cast<uintptr_t>(address) % HUGE_PAGE_SIZE;
+        auto head = offset == 0 ? 0 : HUGE_PAGE_SIZE - offset;
+        if (head > 0) {
+            (void)::munmap(address, head);
+        }
+        auto tail = HUGE_PAGE_SIZE - head;
+        if (tail > 0) {
+            (void)::munmap(address + head + size, tail);
+        }
+        return address + head;
+    }
+}
+
+void* MapPages(size_t size, HugePages hugePages, bool* hugePagesUsed) {
+    if (hugePagesUsed != nullptr) {
+        *hugePagesUsed = false;
+    }
+
+#ifdef MAP_HUGETLB
+    if (hugePages == HugePages::Explicit && size % HUGE_PAGE_SIZE == 0) {
+        auto address = MapAnonymous(size, MAP_HUGETLB);
+        if (address != nullptr) {
+            if (hugePagesUsed != nullptr) {
+                *hugePagesUsed = true;
+            }
+            return address;
+        }
+    }
+#endif
+
+#ifdef MADV_HUGEPAGE
+    if (hugePages != HugePages::None && size >= HUGE_PAGE_SIZE) {
+        auto address = MapAligned(size);
+        if (address != nullptr && ::madvise(address, size, MADV_HUGEPAGE) == 0 && hugePagesUsed != nullptr) {
+            *hugePagesUsed = true;
+        }
+        return address;
+    }
+#endif
+
+    return MapAnonymous(size, 0);
+}
+
+void UnmapPages(void* address, size_t size) {
+    if (address != nullptr) {
+        (void)::munmap(address, size);
+    }
+}
+
+#else
+
+void* MapPages(size_t size, HugePages hugePages, bool* hugePagesUsed) {
+    if (hugePagesUsed != nullptr) {
+        *hugePagesUsed = false;
+    }
+
+    // Large pages need the SeLockMemoryPrivilege, and there is no transparent equivalent.
+    auto largePageSize = ::GetLargePageMinimum();
+    if (hugePages == HugePages::Explicit && largePageSize != 0 && size % largePageSize == 0) {
+        auto address = ::VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (address != nullptr) {
+            if (hugePagesUsed != nullptr) {
+                *hugePagesUsed = true;
+            }
+            return address;
+        }
+    }
+
+    return ::VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void UnmapPages(void* address, size_t size) {
+    if (address != nullptr) {
+        (void)::VirtualFree(address, 0, MEM_RELEASE);
+    }
+}
+
+#endif
+}
+}
@@ -0,0 +1,42 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+
+namespace napa {
+namespace platform {
+
+    /// <summary> Whether mapped pages are backed by huge pages. </summary>
+    enum class HugePages {
+
+        /// <summary> Regular pages only. </summary>
+        None,
+
+        /// <summary> The mapping is huge page aligned and the kernel is advised to back it by transparent huge pages. </summary>
+        Transparent,
+
+        /// <summary> The mapping is taken from the reserved huge pages, falling back to regular pages when there are none. </summary>
+        Explicit
+    };
+
+    /// <summary> The huge page size mappings are aligned to and sized for. </summary>
+    constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    /// <summary> Get the size of a regular page. </summary>
+    size_t GetPageSize();
+
+    /// <summary> Map zero-filled read-write private pages. </summary>
+    /// <param name="size"> Size of the mapping, a multiple of the page size, or of HUGE_PAGE_SIZE for explicit huge pages. </param>
+    /// <param name="hugePages"> Whether to back the mapping by huge pages. </param>
+    /// <param name="hugePagesUsed"> Set to whether the mapping was taken from explicit huge pages or advised for transparent ones. </param>
+    /// <returns> Start of the mapping, or nullptr on failure. </returns>
+    void* MapPages(size_t size, HugePages hugePages, bool* hugePagesUsed = nullptr);
+
+    /// <summary> Unmap pages from MapPages. </summary>
+    /// <param name="address"> Start of the mapping. </param>
+    /// <param name="size"> Size it was mapped with. </param>
+    void UnmapPages(void* address, size_t size);
+}
+}
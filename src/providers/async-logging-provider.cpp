@@ -0,0 +1,328 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "async-logging-provider.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+using namespace napa::providers;
+
+struct AsyncLoggingProvider::Ring {
+    explicit Ring(size_t capacity) : records(capacity), head(0), tail(0), abandoned(false) {}
+
+    std::vector<Record> records;
+
+    /// <summary> The next record to write, advanced by the writer thread. </summary>
+    std::atomic<uint64_t> head;
+
+    /// <summary> The next record to fill, advanced by the logging thread. </summary>
+    std::atomic<uint64_t> tail;
+
+    /// <summary> Set once the logging thread exits, so the ring is released when drained. </summary>
+    std::atomic<bool> abandoned;
+};
+
+namespace {
+
+    std::atomic<uint64_t> _nextProviderId(1);
+
+    /// <summary> The ring of the current thread, and the provider it belongs to. </summary>
+    struct ThreadRing {
+        uint64_t providerId = 0;
+        std::shared_ptr<AsyncLoggingProvider::Ring> ring;
+
+        ~ThreadRing() {
+            if (ring != nullptr) {
+                ring->abandoned.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local ThreadRing _threadRing;
+
+    template <size_t N>
+    void CopyField(char (&field)[N], const char* value) {
+        if (value == nullptr) {
+            field[0] = '\0';
+            return;
+        }
+        auto length = std::min(std::strlen(value), N - 1);
+        std::memcpy(field, value, length);
+        field[length] = '\0';
+    }
+
+    const char* GetLevelName(LoggingProvider::Verboseness level) {
+        switch (level) {
+            case LoggingProvider::Verboseness::Error:
+                return "Error";
+            case LoggingProvider::Verboseness::Warning:
+                return "Warning";
+            case LoggingProvider::Verboseness::Info:
+                return "Info";
+            default:
+                return "Debug";
+        }
+    }
+
+    void FillRecord(
+        AsyncLoggingProvider::Record& record,
+        LoggingProvider::Verboseness level,
+        const char* traceId,
+        const char* section,
+        const char* file,
+        int line,
+        const char* message) {
+        record.line = line;
+        record.level = level;
+        CopyField(record.traceId, traceId);
+        CopyField(record.section, section);
+        CopyField(record.file, file);
+        CopyField(record.message, message);
+    }
+
+    void AppendRecord(std::string& text, const AsyncLoggingProvider::Record& record) {
+        text += GetLevelName(record.level);
+        text += ' ';
+        if (record.traceId[0] != '\0') {
+            text += '(';
+            text += record.traceId;
+            text += ") ";
+        }
+        if (record.section[0] != '\0') {
+            text += '[';
+            text += record.section;
+            text += "] ";
+        }
+        text += record.message;
+        text += " [";
+        text += record.file;
+        text += ':';
+        text += std::to_string(record.line);
+        text += "]\n";
+    }
+}
+
+AsyncLoggingProvider::AsyncLoggingProvider(const AsyncLoggingOptions& options) :
+    _id(_nextProviderId++),
+    _options(options),
+    _output(stdout),
+    _sequence(0),
+    _dropped(0),
+    _reportedDropped(0),
+    _drainsStarted(0),
+    _drainsFinished(0),
+    _drainRequested(false),
+    _stopped(false) {
+
+    if (!_options.file.empty()) {
+        auto file = std::fopen(_options.file.c_str(), "a");
+        if (file != nullptr) {
+            _output = file;
+        } else {
+            std::fprintf(stderr, "Failed to open log file '%s', logging to the standard output\n", _options.file.c_str());
+        }
+    }
+
+    _writer = std::thread(&AsyncLoggingProvider::Run, this);
+}
+
+AsyncLoggingProvider::~AsyncLoggingProvider() {
+    Stop();
+    if (_output != stdout) {
+        (void)std::fclose(_output);
+    }
+}
+
+void AsyncLoggingProvider::LogMessage(
+    const char* section,
+    Verboseness level,
+    const char* traceId,
+    const char* file,
+    int line,
+    const char* message) {
+
+    if (_stopped.load(std::memory_order_acquire)) {
+        Record record;
+        FillRecord(record, level, traceId, section, file, line, message);
+
+        std::string text;
+        AppendRecord(text, record);
+        Write(text);
+        return;
+    }
+
+    auto& ring = GetThreadRing();
+    auto capacity = ring.records.size();
+    auto tail = ring.tail.load(std::memory_order_relaxed);
+    auto head = ring.head.load(std::memory_order_acquire);
+    if (tail - head >= capacity) {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto& record = ring.records[tail % capacity];
+    record.sequence = _sequence.fetch_add(1, std::memory_order_relaxed);
+    FillRecord(record, level, traceId, section, file, line, message);
+    ring.tail.store(tail + 1, std::memory_order_release);
+
+    // A wake up lost to a writer that is about to wait only delays the messages by up to a flush interval.
+    if (tail + 1 - head == capacity / 2) {
+        _drainRequested.store(true, std::memory_order_relaxed);
+        _wakeUp.notify_one();
+    }
+}
+
+bool AsyncLoggingProvider::IsLogEnabled(const char* section, Verboseness level) {
+    if (level > _options.level) {
+        return false;
+    }
+    if (_options.sections.empty()) {
+        return true;
+    }
+
+    auto name = section != nullptr ? section : "";
+    for (const auto& enabled : _options.sections) {
+        if (enabled == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void AsyncLoggingProvider::Destroy() {
+    Stop();
+}
+
+void AsyncLoggingProvider::Flush() {
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    if (_stopped) {
+        return;
+    }
+
+    // Any drain that starts from now on covers the messages logged so far.
+    auto target = _drainsStarted + 1;
+    _drainRequested = true;
+    _wakeUp.notify_one();
+    _drained.wait(lock, [this, target]() { return _drainsFinished >= target || _stopped; });
+}
+
+uint64_t AsyncLoggingProvider::GetDroppedCount() const {
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+AsyncLoggingProvider::Ring& AsyncLoggingProvider::GetThreadRing() {
+    if (_threadRing.providerId != _id) {
+        if (_threadRing.ring != nullptr) {
+            _threadRing.ring->abandoned.store(true, std::memory_order_release);
+        }
+        auto ring = std::make_shared<Ring>(std::max<size_t>(_options.bufferSize, 2));
+        {
+            std::lock_guard<std::mutex> lock(_ringsMutex);
+            _rings.push_back(ring);
+        }
+        _threadRing.ring = std::move(ring);
+        _threadRing.providerId = _id;
+    }
+    return *_threadRing.ring;
+}
+
+void AsyncLoggingProvider::Run() {
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    while (!_stopped) {
+        _wakeUp.wait_for(lock, _options.flushInterval, [this]() { return _drainRequested || _stopped; });
+
+        _drainRequested = false;
+        _drainsStarted++;
+        lock.unlock();
+        Drain();
+        lock.lock();
+        _drainsFinished++;
+        _drained.notify_all();
+    }
+}
+
+void AsyncLoggingProvider::Drain() {
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(_ringsMutex);
+        rings = _rings;
+    }
+
+    struct Pending {
+        Ring* ring;
+        uint64_t tail;
+        bool abandoned;
+    };
+    std::vector<Pending> pending;
+    std::vector<const Record*> records;
+    for (const auto& ring : rings) {
+        // The abandoned flag is read first, so the tail read after it is final.
+        auto abandoned = ring->abandoned.load(std::memory_order_acquire);
+        auto head = ring->head.load(std::memory_order_relaxed);
+        auto tail = ring->tail.load(std::memory_order_acquire);
+        for (auto i = head; i < tail; ++i) {
+            records.push_back(&ring->records[i % ring->records.size()]);
+        }
+        pending.push_back({ ring.get(), tail, abandoned });
+    }
+
+    std::sort(records.begin(), records.end(), [](const Record* left, const Record* right) {
+        return left->sequence < right->sequence;
+    });
+
+    std::string text;
+    for (auto record : records) {
+        AppendRecord(text, *record);
+    }
+
+    auto dropped = _dropped.load(std::memory_order_relaxed);
+    if (dropped > _reportedDropped) {
+        text += "Warning [Logging] " + std::to_string(dropped - _reportedDropped) +
+            " messages were dropped, as the log buffer of their thread was full\n";
+        _reportedDropped = dropped;
+    }
+
+    if (!text.empty()) {
+        Write(text);
+    }
+
+    bool released = false;
+    for (const auto& entry : pending) {
+        entry.ring->head.store(entry.tail, std::memory_order_release);
+        released |= entry.abandoned;
+    }
+
+    if (released) {
+        std::lock_guard<std::mutex> lock(_ringsMutex);
+        _rings.erase(
+            std::remove_if(_rings.begin(), _rings.end(), [](const std::shared_ptr<Ring>& ring) {
+                return ring->abandoned.load(std::memory_order_acquire) &&
+                    ring->head.load(std::memory_order_relaxed) == ring->tail.load(std::memory_order_acquire);
+            }),
+            _rings.end());
+    }
+}
+
+void AsyncLoggingProvider::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        if (_stopped) {
+            return;
+        }
+        _stopped = true;
+    }
+    _wakeUp.notify_one();
+    _drained.notify_all();
+    _writer.join();
+
+    // Whatever was logged while the writer thread stopped.
+    Drain();
+}
+
+void AsyncLoggingProvider::Write(const std::string& text) {
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    (void)std::fwrite(text.data(), 1, text.size(), _output);
+    (void)std::fflush(_output);
+}
@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/providers/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace napa {
+namespace providers {
+
+    /// <summary> Options of an AsyncLoggingProvider. </summary>
+    struct AsyncLoggingOptions {
+
+        /// <summary> The file messages are appended to, empty for the standard output. </summary>
+        std::string file;
+
+        /// <summary> The most verbose level that is logged. </summary>
+        LoggingProvider::Verboseness level = LoggingProvider::Verboseness::Debug;
+
+        /// <summary> The sections that are logged, empty for all. </summary>
+        std::vector<std::string> sections;
+
+        /// <summary> The number of messages each thread buffers, beyond which its messages are dropped. </summary>
+        size_t bufferSize = 256;
+
+        /// <summary> The longest time a message waits in a buffer. </summary>
+        std::chrono::milliseconds flushInterval = std::chrono::milliseconds(10);
+    };
+
+    /// <summary> A logging provider that buffers messages per thread, and writes them from a background thread. </summary>
+    /// <remarks>
+    ///     Each logging thread fills its own single producer ring buffer without taking a lock, and a message is
+    ///     dropped rather than waited for when the buffer is full. The writer thread drains all buffers every flush
+    ///     interval, or sooner once a buffer is half full, and writes the messages in logging order with one write.
+    ///     Messages logged after Destroy are written synchronously. Each message is written on a line of its level,
+    ///     its trace id if any, its section if any, the message and its location.
+    /// </remarks>
+    class AsyncLoggingProvider : public LoggingProvider {
+    public:
+
+        /// <summary> Constructor, which starts the writer thread. </summary>
+        explicit AsyncLoggingProvider(const AsyncLoggingOptions& options);
+
+        /// <summary> Writes the pending messages and stops the writer thread. </summary>
+        ~AsyncLoggingProvider();
+
+        virtual void LogMessage(
+            const char* section,
+            Verboseness level,
+            const char* traceId,
+            const char* file,
+            int line,
+            const char* message) override;
+
+        virtual bool IsLogEnabled(const char* section, Verboseness level) override;
+
+        /// <summary> Writes the pending messages and stops the writer thread, the provider stays usable. </summary>
+        virtual void Destroy() override;
+
+        /// <summary> Writes the messages buffered so far, and returns once they are written. </summary>
+        void Flush();
+
+        /// <summary> Returns the number of messages dropped because a buffer was full. </summary>
+        uint64_t GetDroppedCount() const;
+
+        /// <summary> A buffered message. </summary>
+        struct Record {
+            uint64_t sequence;
+            int line;
+            Verboseness level;
+            char traceId[64];
+            char section[64];
+            char file[256];
+            char message[512];
+        };
+
+        /// <summary> The ring buffer of a logging thread. </summary>
+        struct Ring;
+
+    private:
+
+        AsyncLoggingProvider(const AsyncLoggingProvider&) = delete;
+        AsyncLoggingProvider& operator=(const AsyncLoggingProvider&) = delete;
+
+        Ring& GetThreadRing();
+        void Run();
+        void Drain();
+        void Stop();
+        void Write(const std::string& text);
+
+        const uint64_t _id;
+        const AsyncLoggingOptions _options;
+        FILE* _output;
+
+        std::atomic<uint64_t> _sequence;
+        std::atomic<uint64_t> _dropped;
+        uint64_t _reportedDropped;
+
+        std::mutex _ringsMutex;
+        std::vector<std::shared_ptr<Ring>> _rings;
+
+        std::mutex _writerMutex;
+        std::condition_variable _wakeUp;
+        std::condition_variable _drained;
+        uint64_t _drainsStarted;
+        uint64_t _drainsFinished;
+        std::atomic<bool> _drainRequested;
+        std::atomic<bool> _stopped;
+
+        std::mutex _outputMutex;
+        std::thread _writer;
+    };
+}
+}
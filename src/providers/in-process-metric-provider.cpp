@@ -0,0 +1,543 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "in-process-metric-provider.h"
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace napa::providers;
+
+constexpr size_t MetricHistogram::SUB_BUCKET_BITS;
+constexpr size_t MetricHistogram::SUB_BUCKET_COUNT;
+constexpr size_t MetricHistogram::BUCKET_COUNT;
+constexpr size_t InProcessMetric::RATE_SHARD_COUNT;
+constexpr size_t InProcessMetric::SERIES_BUCKET_COUNT;
+
+const std::vector<double> InProcessMetric::QUANTILES = { 0.5, 0.9, 0.95, 0.99, 0.999 };
+
+namespace {
+
+    /// <summary> JSON names of InProcessMetric::QUANTILES. </summary>
+    const char* QUANTILE_NAMES[] = { "p50", "p90", "p95", "p99", "p999" };
+
+    /// <summary> Returns the index of the highest bit set, value must not be 0. </summary>
+    size_t GetHighestBit(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<size_t>(index);
+#else
+        return static_cast<size_t>(63 - __builtin_clzll(value));
+#endif
+    }
+
+    /// <summary> The rate shard of the calling thread, threads are spread over the shards in turn. </summary>
+    size_t GetRateShard() {
+        static std::atomic<size_t> nextShard(0);
+        thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % InProcessMetric::RATE_SHARD_COUNT;
+        return shard;
+    }
+
+    size_t HashDimensions(size_t numberOfDimensions, const char* dimensionValues[]) {
+        // FNV-1a, with a 0 byte after each value so ['ab', 'c'] and ['a', 'bc'] differ.
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < numberOfDimensions; ++i) {
+            for (auto p = dimensionValues[i]; *p != '\0'; ++p) {
+                hash = (hash ^ static_cast<uint8_t>(*p)) * 1099511628211ull;
+            }
+            hash *= 1099511628211ull;
+        }
+        return static_cast<size_t>(hash);
+    }
+
+    void UpdateMin(std::atomic<int64_t>& target, int64_t value) {
+        auto current = target.load(std::memory_order_relaxed);
+        while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    void UpdateMax(std::atomic<int64_t>& target, int64_t value) {
+        auto current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    const char* GetTypeName(MetricType type) {
+        switch (type) {
+            case MetricType::Number: return "number";
+            case MetricType::Rate: return "rate";
+            default: return "percentile";
+        }
+    }
+
+    /// <summary> Turns a string into a Prometheus metric or label name, invalid characters become '_'. </summary>
+    std::string ToPrometheusName(const std::string& name) {
+        std::string result;
+        result.reserve(name.size() + 1);
+        if (name.empty() || (name[0] >= '0' && name[0] <= '9')) {
+            result.push_back('_');
+        }
+        for (auto c : name) {
+            bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+            result.push_back(valid ? c : '_');
+        }
+        return result;
+    }
+
+    void AppendPrometheusLabels(
+        std::string& out,
+        const std::vector<std::string>& names,
+        const std::vector<std::string>& values,
+        const char* quantile) {
+
+        if (names.empty() && quantile == nullptr) {
+            return;
+        }
+
+        out.push_back('{');
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (i > 0) {
+                out.push_back(',');
+            }
+            out += ToPrometheusName(names[i]);
+            out += "=\"";
+            for (auto c : values[i]) {
+                if (c == '\\' || c == '"') {
+                    out.push_back('\\');
+                    out.push_back(c);
+                } else if (c == '\n') {
+                    out += "\\n";
+                } else {
+                    out.push_back(c);
+                }
+            }
+            out.push_back('"');
+        }
+        if (quantile != nullptr) {
+            if (!names.empty()) {
+                out.push_back(',');
+            }
+            out += "quantile=\"";
+            out += quantile;
+            out.push_back('"');
+        }
+        out.push_back('}');
+    }
+
+    void AppendPrometheusSample(
+        std::string& out,
+        const std::string& name,
+        const std::vector<std::string>& labelNames,
+        const std::vector<std::string>& labelValues,
+        const char* quantile,
+        int64_t value) {
+
+        out += name;
+        AppendPrometheusLabels(out, labelNames, labelValues, quantile);
+        out.push_back(' ');
+        out += std::to_string(value);
+        out.push_back('\n');
+    }
+
+    std::string FormatJson(const std::vector<MetricSnapshot>& snapshots) {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+        writer.StartArray();
+        for (const auto& metric : snapshots) {
+            writer.StartObject();
+            writer.Key("section");
+            writer.String(metric.section.c_str(), static_cast<rapidjson::SizeType>(metric.section.size()));
+            writer.Key("name");
+            writer.String(metric.name.c_str(), static_cast<rapidjson::SizeType>(metric.name.size()));
+            writer.Key("type");
+            writer.String(GetTypeName(metric.type));
+
+            writer.Key("series");
+            writer.StartArray();
+            for (const auto& series : metric.series) {
+                writer.StartObject();
+                writer.Key("dimensions");
+                writer.StartObject();
+                for (size_t i = 0; i < metric.dimensionNames.size(); ++i) {
+                    const auto& name = metric.dimensionNames[i];
+                    const auto& value = series.dimensionValues[i];
+                    writer.Key(name.c_str(), static_cast<rapidjson::SizeType>(name.size()));
+                    writer.String(value.c_str(), static_cast<rapidjson::SizeType>(value.size()));
+                }
+                writer.EndObject();
+
+                if (metric.type == MetricType::Percentile) {
+                    writer.Key("count");
+                    writer.Uint64(series.count);
+                    writer.Key("sum");
+                    writer.Int64(series.sum);
+                    writer.Key("min");
+                    writer.Int64(series.min);
+                    writer.Key("max");
+                    writer.Int64(series.max);
+                    writer.Key("percentiles");
+                    writer.StartObject();
+                    for (size_t i = 0; i < series.percentiles.size(); ++i) {
+                        writer.Key(QUANTILE_NAMES[i]);
+                        writer.Int64(series.percentiles[i].second);
+                    }
+                    writer.EndObject();
+                } else {
+                    writer.Key("value");
+                    writer.Int64(series.value);
+                }
+                writer.EndObject();
+            }
+            writer.EndArray();
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        return std::string(buffer.GetString(), buffer.GetSize());
+    }
+
+    std::string FormatPrometheus(const std::vector<MetricSnapshot>& snapshots) {
+        std::string out;
+        for (const auto& metric : snapshots) {
+            auto name = ToPrometheusName(metric.section.empty() ? metric.name : metric.section + "_" + metric.name);
+
+            out += "# TYPE ";
+            out += name;
+            switch (metric.type) {
+                case MetricType::Number: out += " gauge\n"; break;
+                case MetricType::Rate: out += " counter\n"; break;
+                default: out += " summary\n"; break;
+            }
+
+            for (const auto& series : metric.series) {
+                if (metric.type != MetricType::Percentile) {
+                    AppendPrometheusSample(out, name, metric.dimensionNames, series.dimensionValues, nullptr, series.value);
+                    continue;
+                }
+
+                for (const auto& percentile : series.percentiles) {
+                    char quantile[32];
+                    snprintf(quantile, sizeof(quantile), "%g", percentile.first);
+                    AppendPrometheusSample(
+                        out, name, metric.dimensionNames, series.dimensionValues, quantile, percentile.second);
+                }
+                AppendPrometheusSample(
+                    out, name + "_sum", metric.dimensionNames, series.dimensionValues, nullptr, series.sum);
+                AppendPrometheusSample(
+                    out,
+                    name + "_count",
+                    metric.dimensionNames,
+                    series.dimensionValues,
+                    nullptr,
+                    static_cast<int64_t>(series.count));
+            }
+        }
+        return out;
+    }
+}
+
+MetricHistogram::MetricHistogram() :
+    _sum(0),
+    _min(std::numeric_limits<int64_t>::max()),
+    _max(0) {
+
+    for (auto& bucket : _buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void MetricHistogram::Record(int64_t value) {
+    value = std::max<int64_t>(value, 0);
+
+    _buckets[GetBucketIndex(static_cast<uint64_t>(value))].fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(value, std::memory_order_relaxed);
+    UpdateMin(_min, value);
+    UpdateMax(_max, value);
+}
+
+void MetricHistogram::Read(const std::vector<double>& quantiles, MetricSeriesSnapshot& snapshot) const {
+    // Buckets are read one at a time while values may still be recorded, the count is taken from the copy so
+    // the quantiles are consistent with it.
+    std::vector<uint64_t> counts(BUCKET_COUNT);
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = _buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    snapshot.count = total;
+    snapshot.sum = _sum.load(std::memory_order_relaxed);
+    snapshot.min = total == 0 ? 0 : _min.load(std::memory_order_relaxed);
+    snapshot.max = _max.load(std::memory_order_relaxed);
+    snapshot.percentiles.clear();
+
+    for (auto quantile : quantiles) {
+        int64_t value = 0;
+        if (total > 0) {
+            auto rank = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(quantile * total)), 1);
+            uint64_t seen = 0;
+            size_t index = 0;
+            for (; index < BUCKET_COUNT - 1; ++index) {
+                seen += counts[index];
+                if (seen >= rank) {
+                    break;
+                }
+            }
+
+            auto upperBound = std::min<uint64_t>(GetBucketUpperBound(index), std::numeric_limits<int64_t>::max());
+            value = std::min(std::max(static_cast<int64_t>(upperBound), snapshot.min), snapshot.max);
+        }
+        snapshot.percentiles.emplace_back(quantile, value);
+    }
+}
+
+size_t MetricHistogram::GetBucketIndex(uint64_t value) {
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+
+    auto exponent = GetHighestBit(value);
+    auto subBucket = static_cast<size_t>(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKET_COUNT - 1);
+    return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + subBucket;
+}
+
+uint64_t MetricHistogram::GetBucketUpperBound(size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+
+    auto exponent = index / SUB_BUCKET_COUNT + SUB_BUCKET_BITS - 1;
+    auto shift = exponent - SUB_BUCKET_BITS;
+    uint64_t lowerBound = static_cast<uint64_t>(SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT) << shift;
+    return lowerBound + ((1ull << shift) - 1);
+}
+
+InProcessMetric::Series::Series(
+    MetricType type,
+    size_t numberOfDimensions,
+    const char* dimensionValues[],
+    size_t hash) :
+    dimensionValues(dimensionValues, dimensionValues + numberOfDimensions),
+    hash(hash),
+    next(nullptr),
+    value(0),
+    shards(nullptr) {
+
+    if (type == MetricType::Rate) {
+        size_t size = sizeof(RateShard) * RATE_SHARD_COUNT;
+        size_t space = size + alignof(RateShard) - 1;
+        shardBuffer.reset(new char[space]);
+        void* aligned = shardBuffer.get();
+        shards = static_cast<RateShard*>(std::align(alignof(RateShard), size, aligned, space));
+        for (size_t i = 0; i < RATE_SHARD_COUNT; ++i) {
+            new (&shards[i]) RateShard();
+            shards[i].value.store(0, std::memory_order_relaxed);
+        }
+    } else if (type == MetricType::Percentile) {
+        histogram = std::make_unique<MetricHistogram>();
+    }
+}
+
+void InProcessMetric::Series::Add(int64_t amount) {
+    if (shards) {
+        shards[GetRateShard()].value.fetch_add(amount, std::memory_order_relaxed);
+    } else {
+        value.fetch_add(amount, std::memory_order_relaxed);
+    }
+}
+
+InProcessMetric::InProcessMetric(
+    const char* section,
+    const char* name,
+    MetricType type,
+    size_t dimensions,
+    const char* dimensionNames[]) :
+    _section(section),
+    _name(name),
+    _type(type),
+    _dimensionNames(dimensionNames, dimensionNames + dimensions) {
+
+    for (auto& bucket : _series) {
+        bucket.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+InProcessMetric::~InProcessMetric() {
+    for (auto& bucket : _series) {
+        auto series = bucket.load(std::memory_order_relaxed);
+        while (series != nullptr) {
+            auto next = series->next;
+            delete series;
+            series = next;
+        }
+    }
+}
+
+bool InProcessMetric::Set(int64_t value, size_t numberOfDimensions, const char* dimensionValues[]) {
+    auto series = GetSeries(numberOfDimensions, dimensionValues);
+    if (series == nullptr) {
+        return false;
+    }
+
+    if (series->histogram) {
+        series->histogram->Record(value);
+    } else if (series->shards) {
+        // Setting a rate isn't atomic with concurrent increments, it's meant for resets.
+        series->shards[0].value.store(value, std::memory_order_relaxed);
+        for (size_t i = 1; i < RATE_SHARD_COUNT; ++i) {
+            series->shards[i].value.store(0, std::memory_order_relaxed);
+        }
+    } else {
+        series->value.store(value, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool InProcessMetric::Increment(uint64_t value, size_t numberOfDimensions, const char* dimensionValues[]) {
+    if (_type == MetricType::Percentile) {
+        return false;
+    }
+
+    auto series = GetSeries(numberOfDimensions, dimensionValues);
+    if (series == nullptr) {
+        return false;
+    }
+
+    series->Add(static_cast<int64_t>(value));
+    return true;
+}
+
+bool InProcessMetric::Decrement(uint64_t value, size_t numberOfDimensions, const char* dimensionValues[]) {
+    if (_type == MetricType::Percentile) {
+        return false;
+    }
+
+    auto series = GetSeries(numberOfDimensions, dimensionValues);
+    if (series == nullptr) {
+        return false;
+    }
+
+    series->Add(-static_cast<int64_t>(value));
+    return true;
+}
+
+InProcessMetric::Series* InProcessMetric::GetSeries(size_t numberOfDimensions, const char* dimensionValues[]) {
+    if (numberOfDimensions != _dimensionNames.size()) {
+        return nullptr;
+    }
+
+    auto hash = HashDimensions(numberOfDimensions, dimensionValues);
+    auto& bucket = _series[hash % SERIES_BUCKET_COUNT];
+
+    auto matches = [&](const Series* series) {
+        if (series->hash != hash) {
+            return false;
+        }
+        for (size_t i = 0; i < numberOfDimensions; ++i) {
+            if (series->dimensionValues[i] != dimensionValues[i]) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::unique_ptr<Series> created;
+    auto head = bucket.load(std::memory_order_acquire);
+    while (true) {
+        for (auto series = head; series != nullptr; series = series->next) {
+            if (matches(series)) {
+                return series;
+            }
+        }
+
+        if (!created) {
+            created = std::make_unique<Series>(_type, numberOfDimensions, dimensionValues, hash);
+        }
+        created->next = head;
+
+        // On failure 'head' is reloaded and searched again, another thread may have pushed the same series.
+        if (bucket.compare_exchange_weak(head, created.get(), std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return created.release();
+        }
+    }
+}
+
+MetricSnapshot InProcessMetric::Snapshot() const {
+    MetricSnapshot snapshot;
+    snapshot.section = _section;
+    snapshot.name = _name;
+    snapshot.type = _type;
+    snapshot.dimensionNames = _dimensionNames;
+
+    for (const auto& bucket : _series) {
+        for (auto series = bucket.load(std::memory_order_acquire); series != nullptr; series = series->next) {
+            MetricSeriesSnapshot seriesSnapshot;
+            seriesSnapshot.dimensionValues = series->dimensionValues;
+
+            if (series->histogram) {
+                series->histogram->Read(QUANTILES, seriesSnapshot);
+            } else if (series->shards) {
+                for (size_t i = 0; i < RATE_SHARD_COUNT; ++i) {
+                    seriesSnapshot.value += series->shards[i].value.load(std::memory_order_relaxed);
+                }
+            } else {
+                seriesSnapshot.value = series->value.load(std::memory_order_relaxed);
+            }
+            snapshot.series.emplace_back(std::move(seriesSnapshot));
+        }
+    }
+
+    std::sort(snapshot.series.begin(), snapshot.series.end(), [](const auto& left, const auto& right) {
+        return left.dimensionValues < right.dimensionValues;
+    });
+    return snapshot;
+}
+
+Metric* InProcessMetricProvider::GetMetric(
+    const char* section,
+    const char* name,
+    MetricType type,
+    size_t dimensions,
+    const char* dimensionNames[]) {
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    auto& metric = _metrics[std::make_pair(std::string(section), std::string(name))];
+    if (!metric) {
+        metric = std::make_unique<InProcessMetric>(section, name, type, dimensions, dimensionNames);
+    }
+    return metric.get();
+}
+
+std::vector<MetricSnapshot> InProcessMetricProvider::Snapshot() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::vector<MetricSnapshot> snapshots;
+    snapshots.reserve(_metrics.size());
+    for (const auto& metric : _metrics) {
+        snapshots.emplace_back(metric.second->Snapshot());
+    }
+    return snapshots;
+}
+
+std::string InProcessMetricProvider::Snapshot(napa_metric_snapshot_format format) const {
+    return FormatMetricSnapshots(Snapshot(), format);
+}
+
+std::string napa::providers::FormatMetricSnapshots(
+    const std::vector<MetricSnapshot>& snapshots,
+    napa_metric_snapshot_format format) {
+
+    return format == METRIC_SNAPSHOT_PROMETHEUS ? FormatPrometheus(snapshots) : FormatJson(snapshots);
+}
@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/providers/metric.h>
+#include <napa/types.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace providers {
+
+    /// <summary> The values of one series of a metric, as read by a snapshot. </summary>
+    struct MetricSeriesSnapshot {
+
+        /// <summary> The dimension values identifying the series. </summary>
+        std::vector<std::string> dimensionValues;
+
+        /// <summary> The current value of a Number, or the running total of a Rate. </summary>
+        int64_t value = 0;
+
+        /// <summary> The number of values set on a Percentile. </summary>
+        uint64_t count = 0;
+
+        /// <summary> The sum, smallest and largest values set on a Percentile. </summary>
+        int64_t sum = 0;
+        int64_t min = 0;
+        int64_t max = 0;
+
+        /// <summary> The quantiles of a Percentile, paired with their values. </summary>
+        std::vector<std::pair<double, int64_t>> percentiles;
+    };
+
+    /// <summary> One metric with all its series, as read by a snapshot. </summary>
+    struct MetricSnapshot {
+        std::string section;
+        std::string name;
+        MetricType type;
+        std::vector<std::string> dimensionNames;
+        std::vector<MetricSeriesSnapshot> series;
+    };
+
+    /// <summary> A log-linear histogram of non negative values, 32 buckets per power of 2 for a relative error of 3%. </summary>
+    class MetricHistogram {
+    public:
+
+        MetricHistogram();
+
+        /// <summary> Records a value, negative values are recorded as 0. </summary>
+        void Record(int64_t value);
+
+        /// <summary> Reads the count, sum, bounds and the given quantiles of the recorded values. </summary>
+        void Read(const std::vector<double>& quantiles, MetricSeriesSnapshot& snapshot) const;
+
+        /// <summary> Returns the bucket a value is recorded in. </summary>
+        static size_t GetBucketIndex(uint64_t value);
+
+        /// <summary> Returns the largest value that is recorded in a bucket. </summary>
+        static uint64_t GetBucketUpperBound(size_t index);
+
+        static constexpr size_t SUB_BUCKET_BITS = 5;
+        static constexpr size_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+        static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> _buckets;
+        std::atomic<int64_t> _sum;
+        std::atomic<int64_t> _min;
+        std::atomic<int64_t> _max;
+    };
+
+    /// <summary> A metric of the in-process provider. </summary>
+    /// <remarks>
+    ///     Series are found in an insert-only hash table without taking a lock or allocating, only the first use of a
+    ///     dimension combination allocates its series. A Rate spreads its increments over cache line sized shards
+    ///     picked by the calling thread, so threads counting the same series don't contend.
+    /// </remarks>
+    class InProcessMetric : public Metric {
+    public:
+
+        InProcessMetric(
+            const char* section,
+            const char* name,
+            MetricType type,
+            size_t dimensions,
+            const char* dimensionNames[]);
+
+        ~InProcessMetric();
+
+        bool Set(int64_t value, size_t numberOfDimensions, const char* dimensionValues[]) override;
+
+        bool Increment(uint64_t value, size_t numberOfDimensions, const char* dimensionValues[]) override;
+
+        bool Decrement(uint64_t value, size_t numberOfDimensions, const char* dimensionValues[]) override;
+
+        void Destroy() override {
+            // Don't actually delete. The provider owns its metrics.
+        }
+
+        /// <summary> Reads all series of the metric. </summary>
+        MetricSnapshot Snapshot() const;
+
+        MetricType GetType() const {
+            return _type;
+        }
+
+        size_t GetDimensionCount() const {
+            return _dimensionNames.size();
+        }
+
+        /// <summary> Quantiles reported for Percentile metrics. </summary>
+        static const std::vector<double> QUANTILES;
+
+        static constexpr size_t RATE_SHARD_COUNT = 16;
+        static constexpr size_t SERIES_BUCKET_COUNT = 64;
+
+    private:
+        struct alignas(64) RateShard {
+            std::atomic<int64_t> value;
+        };
+
+        struct Series {
+            Series(MetricType type, size_t numberOfDimensions, const char* dimensionValues[], size_t hash);
+
+            /// <summary> Adds a signed amount to a Number or a Rate. </summary>
+            void Add(int64_t value);
+
+            std::vector<std::string> dimensionValues;
+            size_t hash;
+            Series* next;
+
+            std::atomic<int64_t> value;
+
+            /// <summary> The shards of a Rate, in a buffer they are aligned in by hand since new[] ignores their alignment. </summary>
+            std::unique_ptr<char[]> shardBuffer;
+            RateShard* shards;
+
+            std::unique_ptr<MetricHistogram> histogram;
+        };
+
+        /// <summary> Finds or creates the series of the dimension values, nullptr if their number doesn't match. </summary>
+        Series* GetSeries(size_t numberOfDimensions, const char* dimensionValues[]);
+
+        const std::string _section;
+        const std::string _name;
+        const MetricType _type;
+        const std::vector<std::string> _dimensionNames;
+
+        std::array<std::atomic<Series*>, SERIES_BUCKET_COUNT> _series;
+    };
+
+    /// <summary> A metric provider that keeps metrics in the process, for scrapers to read them with snapshots. </summary>
+    /// <remarks>
+    ///     Snapshots hold the running values since the process started. Numbers report their last value, Rates their
+    ///     total, and Percentiles the count, sum, bounds and p50, p90, p95, p99 and p99.9 of all values set.
+    /// </remarks>
+    class InProcessMetricProvider : public MetricProvider {
+    public:
+
+        Metric* GetMetric(
+            const char* section,
+            const char* name,
+            MetricType type,
+            size_t dimensions,
+            const char* dimensionNames[]) override;
+
+        void Destroy() override {
+            // Don't actually delete. We're a lifetime process object.
+        }
+
+        /// <summary> Reads all metrics, ordered by section and name. </summary>
+        std::vector<MetricSnapshot> Snapshot() const;
+
+        /// <summary> Reads all metrics and formats them as JSON or as the Prometheus text format. </summary>
+        std::string Snapshot(napa_metric_snapshot_format format) const;
+
+    private:
+        mutable std::mutex _mutex;
+        std::map<std::pair<std::string, std::string>, std::unique_ptr<InProcessMetric>> _metrics;
+    };
+
+    /// <summary> Formats metric snapshots as JSON or as the Prometheus text format. </summary>
+    std::string FormatMetricSnapshots(const std::vector<MetricSnapshot>& snapshots, napa_metric_snapshot_format format);
+}
+}
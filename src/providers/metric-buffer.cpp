@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "metric-buffer.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace napa::providers;
+
+namespace {
+    thread_local MetricBuffer* _currentBuffer = nullptr;
+
+    /// <summary> Identifies a series by its metric and dimension values. </summary>
+    std::string MakeSeriesKey(const Metric* metric, const std::vector<std::string>& dimensionValues) {
+        auto key = std::to_string(reinterpret_cast<uintptr_t>(metric));
+        for (const auto& value : dimensionValues) {
+            key += '\0';
+            key += value;
+        }
+        return key;
+    }
+}
+
+MetricBuffer::MetricBuffer(uint32_t capacity) :
+    _capacity(capacity),
+    _slots(new double[1 + 2 * static_cast<size_t>(capacity)]) {
+
+    _slots[DIRTY_SLOT] = 0;
+    for (size_t i = 0; i < capacity; ++i) {
+        _slots[1 + 2 * i] = 0;
+        _slots[2 + 2 * i] = std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+MetricBuffer::~MetricBuffer() {
+    Flush();
+}
+
+bool MetricBuffer::AddSeries(Metric* metric, const std::vector<std::string>& dimensionValues, uint32_t& index) {
+    auto key = MakeSeriesKey(metric, dimensionValues);
+    auto it = _indices.find(key);
+    if (it != _indices.end()) {
+        index = it->second;
+        return true;
+    }
+
+    if (_series.size() >= _capacity) {
+        return false;
+    }
+
+    std::unique_ptr<Series> series(new Series{ metric, dimensionValues, {} });
+    series->dimensions.reserve(series->dimensionValues.size());
+    for (const auto& value : series->dimensionValues) {
+        series->dimensions.push_back(value.c_str());
+    }
+
+    index = static_cast<uint32_t>(_series.size());
+    _series.push_back(std::move(series));
+    _indices.emplace(std::move(key), index);
+    return true;
+}
+
+void MetricBuffer::Flush() {
+    if (_slots[DIRTY_SLOT] == 0) {
+        return;
+    }
+    _slots[DIRTY_SLOT] = 0;
+
+    for (size_t i = 0; i < _series.size(); ++i) {
+        auto& increments = _slots[1 + 2 * i];
+        auto& value = _slots[2 + 2 * i];
+        if (increments == 0 && std::isnan(value)) {
+            continue;
+        }
+
+        auto& series = *_series[i];
+        auto dimensions = series.dimensions.data();
+        if (!std::isnan(value)) {
+            (void)series.metric->Set(static_cast<int64_t>(value), series.dimensions.size(), dimensions);
+            value = std::numeric_limits<double>::quiet_NaN();
+        }
+        if (increments > 0) {
+            (void)series.metric->Increment(static_cast<uint64_t>(increments), series.dimensions.size(), dimensions);
+        } else if (increments < 0) {
+            (void)series.metric->Decrement(static_cast<uint64_t>(-increments), series.dimensions.size(), dimensions);
+        }
+        increments = 0;
+    }
+}
+
+MetricBuffer* MetricBuffer::GetCurrent() {
+    return _currentBuffer;
+}
+
+void MetricBuffer::SetCurrent(MetricBuffer* buffer) {
+    _currentBuffer = buffer;
+}
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/exports.h>
+#include <napa/providers/metric.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace napa {
+namespace providers {
+
+    /// <summary> Updates of metric series buffered by the JavaScript of a worker, reported to their metrics in batches. </summary>
+    /// <remarks>
+    ///     JavaScript updates the slots of a series in place through a Float64Array over them, without a binding call.
+    ///     Series i owns slots 1 + 2i, the sum of its pending increments, and 2 + 2i, its pending set value or NaN.
+    ///     A set clears the pending increments, which are applied after it. Slot 0 is non zero once any slot changed,
+    ///     so flushing a buffer without updates reads a single slot. Slots are only used by the thread owning the buffer.
+    /// </remarks>
+    class MetricBuffer {
+    public:
+
+        /// <summary> The most series a buffer holds by default. </summary>
+        static constexpr uint32_t DEFAULT_CAPACITY = 1024;
+
+        /// <summary> The slot that is non zero once any series was updated since the last flush. </summary>
+        static constexpr uint32_t DIRTY_SLOT = 0;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="capacity"> The most series the buffer holds. </param>
+        explicit MetricBuffer(uint32_t capacity = DEFAULT_CAPACITY);
+
+        /// <summary> Reports the pending updates. </summary>
+        ~MetricBuffer();
+
+        /// <summary> Buffers the updates of a series, the same metric and dimension values get the same series. </summary>
+        /// <param name="metric"> The metric of the series. </param>
+        /// <param name="dimensionValues"> The dimension values of the series. </param>
+        /// <param name="index"> Receives the index of the series, whose slots are 1 + 2 * index and 2 + 2 * index. </param>
+        /// <returns> False if the buffer holds its capacity of series. </returns>
+        NAPA_API bool AddSeries(Metric* metric, const std::vector<std::string>& dimensionValues, uint32_t& index);
+
+        /// <summary> Reports the pending updates to the metrics, and clears them. </summary>
+        NAPA_API void Flush();
+
+        /// <summary> Gets the slots, there are GetSlotCount() of them. </summary>
+        double* GetSlots() { return _slots.get(); }
+
+        /// <summary> Gets the number of slots. </summary>
+        size_t GetSlotCount() const { return 1 + 2 * static_cast<size_t>(_capacity); }
+
+        /// <summary> Gets the number of series. </summary>
+        size_t GetSeriesCount() const { return _series.size(); }
+
+        /// <summary> Gets the buffer of the current worker, null if the thread isn't a napa worker. </summary>
+        static NAPA_API MetricBuffer* GetCurrent();
+
+        /// <summary> Sets the buffer of the current worker. </summary>
+        static void SetCurrent(MetricBuffer* buffer);
+
+    private:
+
+        MetricBuffer(const MetricBuffer&) = delete;
+        MetricBuffer& operator=(const MetricBuffer&) = delete;
+
+        /// <summary> A buffered series, and the pointers to its dimension values passed to its metric. </summary>
+        struct Series {
+            Metric* metric;
+            std::vector<std::string> dimensionValues;
+            std::vector<const char*> dimensions;
+        };
+
+        const uint32_t _capacity;
+        std::unique_ptr<double[]> _slots;
+        std::vector<std::unique_ptr<Series>> _series;
+        std::unordered_map<std::string, uint32_t> _indices;
+    };
+}
+}
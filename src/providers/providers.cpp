@@ -3,7 +3,9 @@
 
 #include "providers.h"
 
+#include "async-logging-provider.h"
 #include "console-logging-provider.h"
+#include "in-process-metric-provider.h"
 #include "nop-logging-provider.h"
 #include "nop-metric-provider.h"
 
@@ -24,16 +26,21 @@ using namespace napa;
 using namespace napa::providers;
 
 // Forward declarations.
-static LoggingProvider* LoadLoggingProvider(const std::string& providerName);
+static LoggingProvider* LoadLoggingProvider(const settings::PlatformSettings& settings);
 static MetricProvider* LoadMetricProvider(const std::string& providerName);
 
+// Everything is logged until the platform settings say otherwise.
+std::atomic<int> napa::providers::activeLogLevel(static_cast<int>(LoggingProvider::Verboseness::Debug));
+
 // Providers - Initially assigned to defaults.
-static LoggingProvider* _loggingProvider = LoadLoggingProvider("");
+static LoggingProvider* _loggingProvider = LoadLoggingProvider(settings::PlatformSettings());
 static MetricProvider* _metricProvider = LoadMetricProvider("");
+static InProcessMetricProvider* _inProcessMetricProvider = nullptr;
 
 
 bool napa::providers::Initialize(const settings::PlatformSettings& settings) {
-    _loggingProvider = LoadLoggingProvider(settings.loggingProvider);
+    _loggingProvider = LoadLoggingProvider(settings);
+    activeLogLevel = settings.loggingProvider == "nop" ? -1 : static_cast<int>(settings.logLevel);
     _metricProvider = LoadMetricProvider(settings.metricProvider);
 
     return true;
@@ -57,6 +64,15 @@ MetricProvider& napa::providers::GetMetricProvider() {
     return *_metricProvider;
 }
 
+bool napa::providers::GetMetricSnapshot(napa_metric_snapshot_format format, std::string& snapshot) {
+    if (_inProcessMetricProvider == nullptr || _metricProvider != _inProcessMetricProvider) {
+        return false;
+    }
+
+    snapshot = _inProcessMetricProvider->Snapshot(format);
+    return true;
+}
+
 template <typename ProviderType>
 static ProviderType* LoadProvider(
     const std::string& providerName,
@@ -94,7 +110,8 @@ static ProviderType* LoadProvider(
     return createProviderFunc();
 }
 
-static LoggingProvider* LoadLoggingProvider(const std::string& providerName) {
+static LoggingProvider* LoadLoggingProvider(const settings::PlatformSettings& settings) {
+    const auto& providerName = settings.loggingProvider;
     if (providerName.empty() || providerName == "console") {
         static auto consoleLoggingProvider = std::make_unique<ConsoleLoggingProvider>();
         return consoleLoggingProvider.get();
@@ -105,6 +122,16 @@ static LoggingProvider* LoadLoggingProvider(const std::string& providerName) {
         return nopLoggingProvider.get();
     }
 
+    if (providerName == "async") {
+        AsyncLoggingOptions options;
+        options.file = settings.logFile;
+        options.level = settings.logLevel;
+        options.sections = settings.logSections;
+
+        static auto asyncLoggingProvider = std::make_unique<AsyncLoggingProvider>(options);
+        return asyncLoggingProvider.get();
+    }
+
     return LoadProvider<LoggingProvider>(providerName, "providers.logging", "CreateLoggingProvider");
 }
 
@@ -114,5 +141,11 @@ static MetricProvider* LoadMetricProvider(const std::string& providerName) {
         return nopMetricProvider.get();
     }
 
+    if (providerName == "in-process") {
+        static auto inProcessMetricProvider = std::make_unique<InProcessMetricProvider>();
+        _inProcessMetricProvider = inProcessMetricProvider.get();
+        return inProcessMetricProvider.get();
+    }
+
     return LoadProvider<MetricProvider>(providerName, "providers.metric", "CreateMetricProvider");;
 }
@@ -8,6 +8,10 @@
 
 #include "settings/settings.h"
 
+#include <napa/types.h>
+
+#include <string>
+
 
 namespace napa {
 namespace providers {
@@ -17,5 +21,9 @@ namespace providers {
 
     /// <summary> Clean up and destroy all loaded providers. </summary>
     void Shutdown();
+
+    /// <summary> Reads all metrics if the configured metric provider is 'in-process'. </summary>
+    /// <returns> False if the configured metric provider doesn't support snapshots. </returns>
+    bool GetMetricSnapshot(napa_metric_snapshot_format format, std::string& snapshot);
 }
 }
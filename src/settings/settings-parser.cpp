@@ -3,21 +3,125 @@
 
 #include "settings-parser.h"
 
+#include <platform/thread.h>
+#include <utils/hash.h>
+
 #include <napa/log.h>
 
 // Open source header only library for argument parsing.
 // https://github.com/Taywee/args
 #include <args/args.hxx>
 
+#include <algorithm>
+#include <iterator>
+#include <sstream>
+
 using namespace napa;
 using namespace napa::settings;
 
+static bool ParseBool(const std::string& str, bool& value) {
+    if (str == "true" || str == "1") {
+        value = true;
+    } else if (str == "false" || str == "0") {
+        value = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/// <summary> Parses positive numbers of tenants like 'gold:4,silver:2', into tenant weights or rate limits. </summary>
+/// <remarks> Names of digits only are tenant keys given as numbers, other names are hashed like string routing keys. </remarks>
+template <typename TenantValue>
+static bool ParseTenantValues(const std::string& str, std::vector<TenantValue>& values) {
+    std::vector<TenantValue> result;
+
+    std::stringstream stream(str);
+    std::string entry;
+    while (std::getline(stream, entry, ',')) {
+        auto colon = entry.rfind(':');
+        if (colon == std::string::npos || colon == 0 || colon + 1 == entry.size()) {
+            return false;
+        }
+
+        auto name = entry.substr(0, colon);
+        auto value = entry.substr(colon + 1);
+        if (value.size() > 9 || value.find_first_not_of("0123456789") != std::string::npos || std::stoul(value) == 0) {
+            return false;
+        }
+
+        uint64_t tenant = 0;
+        if (name.size() <= 19 && name.find_first_not_of("0123456789") == std::string::npos) {
+            tenant = std::stoull(name);
+        } else {
+            tenant = utils::hash::HashRoutingKey(name.data(), name.size());
+        }
+        result.push_back({ std::move(name), tenant, static_cast<uint32_t>(std::stoul(value)) });
+    }
+
+    values = std::move(result);
+    return true;
+}
+
+/// <summary> Parses a number of workers, or 'auto' for one per logical CPU and 'physical' for one per physical core. </summary>
+/// <remarks> CPUs are counted within the CPU set and NUMA node of the zone when they are given. </remarks>
+static bool ParseWorkers(const std::string& str, ZoneSettings& settings) {
+    if (str != "auto" && str != "physical") {
+        if (str.empty() || str.size() > 9 || str.find_first_not_of("0123456789") != std::string::npos) {
+            return false;
+        }
+        settings.workers = static_cast<uint32_t>(std::stoul(str));
+        return true;
+    }
+
+    std::vector<uint32_t> cpus;
+    for (uint32_t cpu = 0; cpu < platform::GetCpuCount(); ++cpu) {
+        cpus.push_back(cpu);
+    }
+
+    auto intersect = [&cpus](const std::vector<uint32_t>& allowed) {
+        std::vector<uint32_t> result;
+        std::set_intersection(cpus.begin(), cpus.end(), allowed.begin(), allowed.end(), std::back_inserter(result));
+        cpus = std::move(result);
+    };
+    if (!settings.cpuSet.empty()) {
+        intersect(settings.cpuSet);
+    }
+    if (settings.numaNode >= 0) {
+        intersect(platform::GetNumaNodeCpus(static_cast<uint32_t>(settings.numaNode)));
+    }
+
+    if (str == "physical") {
+        auto logicalCpus = cpus;
+        intersect(platform::GetPhysicalCoreCpus());
+
+        // CPU sets naming only hyper-threaded siblings still get one worker per CPU.
+        if (cpus.empty()) {
+            cpus = std::move(logicalCpus);
+        }
+    }
+
+    // A CPU set outside of the machine still gets a worker, its affinity is reported when workers start.
+    settings.workers = std::max<uint32_t>(static_cast<uint32_t>(cpus.size()), 1);
+    return true;
+}
 
 bool settings::Parse(const std::vector<std::string>& args, PlatformSettings& settings) {
     args::ArgumentParser parser("platform settings parser");
 
     args::ValueFlag<std::string> loggingProvider(parser, "loggingProvider", "logging provider", { "loggingProvider" });
+    args::ValueFlag<std::string> logFile(parser, "logFile", "file the async logging provider appends to", { "logFile" });
+    args::ValueFlag<std::string> logLevel(parser, "logLevel", "most verbose level logged: error, warning, info or debug", { "logLevel" });
+    args::ValueFlag<std::string> logSections(parser, "logSections", "comma separated sections logged", { "logSections" });
     args::ValueFlag<std::string> metricProvider(parser, "metricProvider", "metric provider", { "metricProvider" });
+    args::ValueFlag<std::string> codeCacheDirectory(parser, "codeCacheDirectory", "directory persisting compiled modules", { "codeCacheDirectory" });
+    args::ValueFlag<std::string> moduleStatusCache(parser, "moduleStatusCache", "module file status cache: process, watch or off", { "moduleStatusCache" });
+    args::ValueFlag<std::string> sharedJsonModules(parser, "sharedJsonModules", "parse JSON modules once per process", { "sharedJsonModules" });
+    args::ValueFlag<std::string> defaultAllocator(parser, "defaultAllocator", "default allocator: crt (or system), pool, mimalloc or jemalloc", { "defaultAllocator" });
+    args::ValueFlag<uint64_t> arrayBufferPoolSize(parser, "arrayBufferPoolSize", "bytes of released ArrayBuffer blocks kept for reuse", { "arrayBufferPoolSize" });
+    args::ValueFlag<std::string> arrayBufferHugePages(parser, "arrayBufferHugePages", "huge pages for ArrayBuffers: none, transparent or explicit", { "arrayBufferHugePages" });
+    args::ValueFlag<uint32_t> prewarmIsolates(parser, "prewarmIsolates", "isolates created ahead of time for zone workers", { "prewarmIsolates" });
+    args::ValueFlag<uint32_t> consoleBufferSize(parser, "consoleBufferSize", "bytes of console output buffered per thread", { "consoleBufferSize" });
 
     try {
         parser.ParseArgs(args);
@@ -31,21 +135,171 @@ bool settings::Parse(const std::vector<std::string>& args, PlatformSettings& set
         settings.loggingProvider = loggingProvider.Get();
     }
 
+    if (logFile) {
+        settings.logFile = logFile.Get();
+    }
+
+    if (logLevel) {
+        const auto& level = logLevel.Get();
+        if (level == "error") {
+            settings.logLevel = providers::LoggingProvider::Verboseness::Error;
+        } else if (level == "warning") {
+            settings.logLevel = providers::LoggingProvider::Verboseness::Warning;
+        } else if (level == "info") {
+            settings.logLevel = providers::LoggingProvider::Verboseness::Info;
+        } else if (level == "debug") {
+            settings.logLevel = providers::LoggingProvider::Verboseness::Debug;
+        } else {
+            LOG_ERROR("Settings", "Unknown log level: %s", level.c_str());
+            return false;
+        }
+    }
+
+    if (logSections) {
+        settings.logSections.clear();
+        std::stringstream sections(logSections.Get());
+        std::string section;
+        while (std::getline(sections, section, ',')) {
+            if (!section.empty()) {
+                settings.logSections.push_back(section);
+            }
+        }
+    }
+
     if (metricProvider) {
         settings.metricProvider = metricProvider.Get();
     }
 
+    if (codeCacheDirectory) {
+        settings.codeCacheDirectory = codeCacheDirectory.Get();
+    }
+
+    if (moduleStatusCache) {
+        const auto& mode = moduleStatusCache.Get();
+        if (mode == "process") {
+            settings.moduleStatusCache = module::FileStatusCacheMode::Process;
+        } else if (mode == "watch") {
+            settings.moduleStatusCache = module::FileStatusCacheMode::Watch;
+        } else if (mode == "off") {
+            settings.moduleStatusCache = module::FileStatusCacheMode::Off;
+        } else {
+            LOG_ERROR("Settings", "Unknown module status cache: %s", mode.c_str());
+            return false;
+        }
+    }
+
+    if (sharedJsonModules) {
+        if (!ParseBool(sharedJsonModules.Get(), settings.sharedJsonModules)) {
+            LOG_ERROR("Settings", "Invalid boolean value for sharedJsonModules: %s", sharedJsonModules.Get().c_str());
+            return false;
+        }
+    }
+
+    if (defaultAllocator) {
+        const auto& type = defaultAllocator.Get();
+        if (type == "crt" || type == "system") {
+            settings.defaultAllocator = AllocatorType::Crt;
+        } else if (type == "pool") {
+            settings.defaultAllocator = AllocatorType::Pool;
+        } else if (type == "mimalloc") {
+            settings.defaultAllocator = AllocatorType::Mimalloc;
+        } else if (type == "jemalloc") {
+            settings.defaultAllocator = AllocatorType::Jemalloc;
+        } else {
+            LOG_ERROR("Settings", "Unknown default allocator: %s", type.c_str());
+            return false;
+        }
+    }
+
+    if (arrayBufferPoolSize) {
+        settings.arrayBufferPoolSize = arrayBufferPoolSize.Get();
+    }
+
+    if (arrayBufferHugePages) {
+        const auto& hugePages = arrayBufferHugePages.Get();
+        if (hugePages == "none") {
+            settings.arrayBufferHugePages = platform::HugePages::None;
+        } else if (hugePages == "transparent") {
+            settings.arrayBufferHugePages = platform::HugePages::Transparent;
+        } else if (hugePages == "explicit") {
+            settings.arrayBufferHugePages = platform::HugePages::Explicit;
+        } else {
+            LOG_ERROR("Settings", "Unknown ArrayBuffer huge pages: %s", hugePages.c_str());
+            return false;
+        }
+    }
+
+    if (prewarmIsolates) {
+        settings.prewarmIsolates = prewarmIsolates.Get();
+    }
+
+    if (consoleBufferSize) {
+        settings.consoleBufferSize = consoleBufferSize.Get();
+    }
+
     return true;
 }
 
 bool settings::Parse(const std::vector<std::string>& args, ZoneSettings& settings) {
     args::ArgumentParser parser("zone settings parser");
 
-    args::ValueFlag<uint32_t> workers(parser, "workers", "number of zone workers", { "workers" });
+    args::ValueFlag<std::string> workers(parser, "workers", "number of zone workers, auto or physical", { "workers" });
+    args::ValueFlag<uint32_t> minWorkers(parser, "minWorkers", "minimum number of zone workers", { "minWorkers" });
+    args::ValueFlag<uint32_t> maxWorkers(parser, "maxWorkers", "maximum number of zone workers", { "maxWorkers" });
+    args::ValueFlag<uint32_t> workerIdleTimeout(parser, "workerIdleTimeout", "idle time in ms before a worker is retired", { "workerIdleTimeout" });
+    args::ValueFlag<uint32_t> scaleUpQueueDepth(parser, "scaleUpQueueDepth", "queued tasks that trigger starting a worker", { "scaleUpQueueDepth" });
+    args::ValueFlag<uint32_t> maxTasksPerWorker(parser, "maxTasksPerWorker", "tasks a worker runs before it is recycled", { "maxTasksPerWorker" });
+    args::ValueFlag<uint32_t> maxHeapBeforeRecycle(parser, "maxHeapBeforeRecycle", "used heap size in MB before a worker is recycled", { "maxHeapBeforeRecycle" });
+    args::ValueFlag<std::string> recycleOnHeapLimit(parser, "recycleOnHeapLimit", "replace workers near their heap limit", { "recycleOnHeapLimit" });
+    args::ValueFlag<uint32_t> stuckWorkerThreshold(parser, "stuckWorkerThreshold", "time in ms a worker runs a task before it's stuck", { "stuckWorkerThreshold" });
+    args::ValueFlag<std::string> recycleStuckWorkers(parser, "recycleStuckWorkers", "terminate and replace stuck workers", { "recycleStuckWorkers" });
+    args::ValueFlag<uint32_t> resultCacheSize(parser, "resultCacheSize", "size in MB of the call result cache", { "resultCacheSize" });
+    args::ValueFlag<uint32_t> idleSpinTime(parser, "idleSpinTime", "time in us an idle worker spins", { "idleSpinTime" });
+    args::ValueFlag<uint32_t> idleYieldTime(parser, "idleYieldTime", "time in us an idle worker yields", { "idleYieldTime" });
+    args::ValueFlag<std::string> lowLatency(parser, "lowLatency", "idle workers never park", { "lowLatency" });
+    args::ValueFlag<std::string> gcProfile(parser, "gcProfile", "garbage collection profile: default, latency, throughput or memory", { "gcProfile" });
+    args::ValueFlag<uint32_t> idleGcTime(parser, "idleGcTime", "time in ms an idle worker collects garbage before parking", { "idleGcTime" });
+    args::ValueFlag<std::string> microtaskPolicy(parser, "microtaskPolicy", "when workers run microtasks: auto or batched", { "microtaskPolicy" });
+    args::ValueFlag<uint32_t> microtaskBatchSize(parser, "microtaskBatchSize", "tasks a worker runs between runs of microtasks", { "microtaskBatchSize" });
+    args::ValueFlag<uint32_t> microtaskTimeSlice(parser, "microtaskTimeSlice", "time in us a worker runs tasks between runs of microtasks", { "microtaskTimeSlice" });
     args::ValueFlag<uint32_t> maxOldSpaceSize(parser, "maxOldSpaceSize", "max old space size in MB", { "maxOldSpaceSize" });
     args::ValueFlag<uint32_t> maxSemiSpaceSize(parser, "maxSemiSpaceSize", "max semi space size in MB", { "maxSemiSpaceSize" });
     args::ValueFlag<uint32_t> maxExecutableSize(parser, "maxExecutableSize", "max executable size in MB", { "maxExecutableSize" });
     args::ValueFlag<uint32_t> maxStackSize(parser, "maxStackSize", "max isolate stack size in bytes", { "maxStackSize" });
+    args::ValueFlag<std::string> sharedModuleContext(parser, "sharedModuleContext", "load modules in the worker's context", { "sharedModuleContext" });
+    args::ValueFlag<std::string> modulePrefetch(parser, "modulePrefetch", "prefetch static requires of modules in parallel", { "modulePrefetch" });
+    args::ValueFlag<std::string> startupScript(parser, "startupScript", "script run into the startup snapshot", { "startupScript" });
+    args::ValueFlag<std::string> startupSnapshot(parser, "startupSnapshot", "startup snapshot file", { "startupSnapshot" });
+    args::ValueFlag<std::string> bundle(parser, "bundle", "module bundle file", { "bundle" });
+    args::ValueFlag<std::string> preload(parser, "preload", "comma separated modules workers load on bootstrap", { "preload" });
+    args::ValueFlag<std::string> warmupModule(parser, "warmupModule", "module of the warm-up function", { "warmupModule" });
+    args::ValueFlag<std::string> warmupFunction(parser, "warmupFunction", "function workers call before serving calls", { "warmupFunction" });
+    args::ValueFlag<std::string> warmupSamples(parser, "warmupSamples", "file of warm-up samples", { "warmupSamples" });
+    args::ValueFlag<uint32_t> warmupIterations(parser, "warmupIterations", "calls of the warm-up function per sample", { "warmupIterations" });
+    args::ValueFlag<std::string> warmupRecord(parser, "warmupRecord", "file the warm-up samples are recorded into", { "warmupRecord" });
+    args::ValueFlag<std::string> scheduler(parser, "scheduler", "scheduler type: synchronized, lockFree or workStealing", { "scheduler" });
+    args::ValueFlag<uint32_t> maxQueueLength(parser, "maxQueueLength", "max number of tasks waiting for a worker", { "maxQueueLength" });
+    args::ValueFlag<std::string> overloadPolicy(parser, "overloadPolicy", "overload policy: reject, block or dropOldest", { "overloadPolicy" });
+    args::ValueFlag<uint32_t> routingImbalance(parser, "routingImbalance", "routed tasks waiting for a busy worker", { "routingImbalance" });
+    args::ValueFlag<std::string> tenantWeights(parser, "tenantWeights", "weights of tenants sharing the queue, like gold:4,silver:2", { "tenantWeights" });
+    args::ValueFlag<uint32_t> rateLimit(parser, "rateLimit", "max calls per second of the zone", { "rateLimit" });
+    args::ValueFlag<std::string> tenantRateLimits(parser, "tenantRateLimits", "max calls per second of tenants, like gold:100,*:10", { "tenantRateLimits" });
+    args::ValueFlag<uint32_t> maxConcurrency(parser, "maxConcurrency", "max adaptive limit of calls in flight", { "maxConcurrency" });
+    args::ValueFlag<uint32_t> tenantContexts(parser, "tenantContexts", "tenants per worker that run in their own context", { "tenantContexts" });
+    args::ValueFlag<uint32_t> maxInFlightPerWorker(parser, "maxInFlightPerWorker", "max calls in flight per worker", { "maxInFlightPerWorker" });
+    args::ValueFlag<uint32_t> timeoutGracePeriod(parser, "timeoutGracePeriod", "ms a call runs past its timeout before termination", { "timeoutGracePeriod" });
+    args::ValueFlag<uint32_t> slowTaskThreshold(parser, "slowTaskThreshold", "ms a call runs before it's reported as slow", { "slowTaskThreshold" });
+    args::ValueFlag<std::string> hardwareCounters(parser, "hardwareCounters", "count CPU cycles and cache misses per function", { "hardwareCounters" });
+    args::ValueFlag<uint32_t> asyncWorkers(parser, "asyncWorkers", "max number of threads running async works", { "asyncWorkers" });
+    args::ValueFlag<std::string> eventLoop(parser, "eventLoop", "run a libuv event loop in each worker", { "eventLoop" });
+    args::ValueFlag<uint32_t> timerSlack(parser, "timerSlack", "ms JavaScript timers may fire late to share wake ups", { "timerSlack" });
+    args::ValueFlag<std::string> alignedIntervals(parser, "alignedIntervals", "fire intervals on multiples of their period", { "alignedIntervals" });
+    args::ValueFlag<std::string> cpuSet(parser, "cpuSet", "logical CPUs for zone workers, like 0-3,8", { "cpuSet" });
+    args::ValueFlag<int32_t> numaNode(parser, "numaNode", "NUMA node for zone workers", { "numaNode" });
+    args::ValueFlag<std::string> pinWorkersToCores(parser, "pinWorkersToCores", "pin each worker to a physical core", { "pinWorkersToCores" });
+    args::ValueFlag<std::string> threadPriority(parser, "threadPriority", "worker thread priority: high, normal, low or background", { "threadPriority" });
+    args::ValueFlag<std::string> allocator(parser, "allocator", "zone allocator: default, crt or pool", { "allocator" });
+    args::ValueFlag<uint32_t> taskArenaChunkSize(parser, "taskArenaChunkSize", "chunk size in bytes of task arenas", { "taskArenaChunkSize" });
 
     try {
         parser.ParseArgs(args);
@@ -55,9 +309,124 @@ bool settings::Parse(const std::vector<std::string>& args, ZoneSettings& setting
         return false;
     }
 
-    if (workers) {
-        NAPA_ASSERT(workers.Get() > 0, "The number of workers must be greater than 0");
-        settings.workers = workers.Get();
+    if (minWorkers) {
+        settings.minWorkers = minWorkers.Get();
+    }
+
+    if (maxWorkers) {
+        settings.maxWorkers = maxWorkers.Get();
+    }
+
+    if (settings.minWorkers > 0 && settings.maxWorkers > 0 && settings.minWorkers > settings.maxWorkers) {
+        LOG_ERROR("Settings", "minWorkers (%u) must not be greater than maxWorkers (%u)", settings.minWorkers, settings.maxWorkers);
+        return false;
+    }
+
+    if (workerIdleTimeout) {
+        settings.workerIdleTimeout = workerIdleTimeout.Get();
+    }
+
+    if (scaleUpQueueDepth) {
+        NAPA_ASSERT(scaleUpQueueDepth.Get() > 0, "The scale up queue depth must be greater than 0");
+        settings.scaleUpQueueDepth = scaleUpQueueDepth.Get();
+    }
+
+    if (maxTasksPerWorker) {
+        settings.maxTasksPerWorker = maxTasksPerWorker.Get();
+    }
+
+    if (maxHeapBeforeRecycle) {
+        settings.maxHeapBeforeRecycle = maxHeapBeforeRecycle.Get();
+    }
+
+    if (recycleOnHeapLimit) {
+        if (!ParseBool(recycleOnHeapLimit.Get(), settings.recycleOnHeapLimit)) {
+            LOG_ERROR("Settings", "Invalid boolean value for recycleOnHeapLimit: %s", recycleOnHeapLimit.Get().c_str());
+            return false;
+        }
+    }
+
+    if (stuckWorkerThreshold) {
+        settings.stuckWorkerThreshold = stuckWorkerThreshold.Get();
+    }
+
+    if (recycleStuckWorkers) {
+        if (!ParseBool(recycleStuckWorkers.Get(), settings.recycleStuckWorkers)) {
+            LOG_ERROR("Settings", "Invalid boolean value for recycleStuckWorkers: %s", recycleStuckWorkers.Get().c_str());
+            return false;
+        }
+    }
+
+    if (resultCacheSize) {
+        settings.resultCacheSize = resultCacheSize.Get();
+    }
+
+    if (idleSpinTime) {
+        settings.idleSpinTime = idleSpinTime.Get();
+    }
+
+    if (idleYieldTime) {
+        settings.idleYieldTime = idleYieldTime.Get();
+    }
+
+    if (lowLatency) {
+        if (!ParseBool(lowLatency.Get(), settings.lowLatency)) {
+            LOG_ERROR("Settings", "Invalid boolean value for lowLatency: %s", lowLatency.Get().c_str());
+            return false;
+        }
+    }
+
+    // The profile goes first, the settings it sets can be given explicitly as well.
+    if (gcProfile) {
+        const auto& profile = gcProfile.Get();
+        if (profile == "default") {
+            settings.gcProfile = GcProfile::Default;
+            settings.maxSemiSpaceSize = 0;
+            settings.idleGcTime = 0;
+        } else if (profile == "latency") {
+            settings.gcProfile = GcProfile::Latency;
+            settings.maxSemiSpaceSize = 8;
+            settings.idleGcTime = 5;
+        } else if (profile == "throughput") {
+            settings.gcProfile = GcProfile::Throughput;
+            settings.maxSemiSpaceSize = 64;
+            settings.idleGcTime = 0;
+        } else if (profile == "memory") {
+            settings.gcProfile = GcProfile::Memory;
+            settings.maxSemiSpaceSize = 4;
+            settings.idleGcTime = 20;
+        } else {
+            LOG_ERROR("Settings", "Unknown GC profile: %s", profile.c_str());
+            return false;
+        }
+    }
+
+    if (idleGcTime) {
+        settings.idleGcTime = idleGcTime.Get();
+    }
+
+    if (microtaskPolicy) {
+        const auto& policy = microtaskPolicy.Get();
+        if (policy == "auto") {
+            settings.microtaskPolicy = MicrotaskPolicy::Auto;
+        } else if (policy == "batched") {
+            settings.microtaskPolicy = MicrotaskPolicy::Batched;
+        } else {
+            LOG_ERROR("Settings", "Unknown microtask policy: %s", policy.c_str());
+            return false;
+        }
+    }
+
+    if (microtaskBatchSize) {
+        if (microtaskBatchSize.Get() == 0) {
+            LOG_ERROR("Settings", "microtaskBatchSize must be greater than 0");
+            return false;
+        }
+        settings.microtaskBatchSize = microtaskBatchSize.Get();
+    }
+
+    if (microtaskTimeSlice) {
+        settings.microtaskTimeSlice = microtaskTimeSlice.Get();
     }
 
     if (maxOldSpaceSize) {
@@ -77,5 +446,244 @@ bool settings::Parse(const std::vector<std::string>& args, ZoneSettings& setting
         settings.maxStackSize = maxStackSize.Get();
     }
 
+    if (sharedModuleContext) {
+        if (!ParseBool(sharedModuleContext.Get(), settings.sharedModuleContext)) {
+            LOG_ERROR("Settings", "Invalid boolean value for sharedModuleContext: %s", sharedModuleContext.Get().c_str());
+            return false;
+        }
+    }
+
+    if (modulePrefetch) {
+        if (!ParseBool(modulePrefetch.Get(), settings.modulePrefetch)) {
+            LOG_ERROR("Settings", "Invalid boolean value for modulePrefetch: %s", modulePrefetch.Get().c_str());
+            return false;
+        }
+    }
+
+    if (startupScript) {
+        settings.startupScript = startupScript.Get();
+    }
+
+    if (startupSnapshot) {
+        settings.startupSnapshot = startupSnapshot.Get();
+    }
+
+    if (bundle) {
+        settings.bundle = bundle.Get();
+    }
+
+    if (preload) {
+        settings.preload.clear();
+        std::stringstream modules(preload.Get());
+        std::string module;
+        while (std::getline(modules, module, ',')) {
+            if (!module.empty()) {
+                settings.preload.push_back(module);
+            }
+        }
+    }
+
+    if (warmupModule) {
+        settings.warmupModule = warmupModule.Get();
+    }
+
+    if (warmupFunction) {
+        settings.warmupFunction = warmupFunction.Get();
+    }
+
+    if (warmupSamples) {
+        settings.warmupSamples = warmupSamples.Get();
+    }
+
+    if (warmupIterations) {
+        settings.warmupIterations = warmupIterations.Get();
+    }
+
+    if (warmupRecord) {
+        settings.warmupRecord = warmupRecord.Get();
+    }
+
+    // Workers warm up before any function is broadcast to them, the function must be exported by a module.
+    if (settings.warmupModule.empty() != settings.warmupFunction.empty()) {
+        LOG_ERROR("Settings", "warmupModule and warmupFunction must be set together");
+        return false;
+    }
+    if ((!settings.warmupSamples.empty() || !settings.warmupRecord.empty()) && settings.warmupFunction.empty()) {
+        LOG_ERROR("Settings", "warmupSamples and warmupRecord require warmupModule and warmupFunction");
+        return false;
+    }
+
+    if (scheduler) {
+        const auto& type = scheduler.Get();
+        if (type == "synchronized") {
+            settings.scheduler = SchedulerType::Synchronized;
+        } else if (type == "lockFree") {
+            settings.scheduler = SchedulerType::LockFree;
+        } else if (type == "workStealing") {
+            settings.scheduler = SchedulerType::WorkStealing;
+        } else {
+            LOG_ERROR("Settings", "Unknown scheduler type: %s", type.c_str());
+            return false;
+        }
+    }
+
+    if (maxQueueLength) {
+        settings.maxQueueLength = maxQueueLength.Get();
+    }
+
+    if (overloadPolicy) {
+        const auto& policy = overloadPolicy.Get();
+        if (policy == "reject") {
+            settings.overloadPolicy = OverloadPolicy::Reject;
+        } else if (policy == "block") {
+            settings.overloadPolicy = OverloadPolicy::Block;
+        } else if (policy == "dropOldest") {
+            settings.overloadPolicy = OverloadPolicy::DropOldest;
+        } else {
+            LOG_ERROR("Settings", "Unknown overload policy: %s", policy.c_str());
+            return false;
+        }
+    }
+
+    if (routingImbalance) {
+        settings.routingImbalance = routingImbalance.Get();
+    }
+
+    if (tenantWeights) {
+        if (!ParseTenantValues(tenantWeights.Get(), settings.tenantWeights)) {
+            LOG_ERROR("Settings", "Invalid tenant weights: %s", tenantWeights.Get().c_str());
+            return false;
+        }
+    }
+
+    if (rateLimit) {
+        settings.rateLimit = rateLimit.Get();
+    }
+
+    if (tenantRateLimits) {
+        if (!ParseTenantValues(tenantRateLimits.Get(), settings.tenantRateLimits)) {
+            LOG_ERROR("Settings", "Invalid tenant rate limits: %s", tenantRateLimits.Get().c_str());
+            return false;
+        }
+    }
+
+    if (maxConcurrency) {
+        settings.maxConcurrency = maxConcurrency.Get();
+    }
+
+    if (tenantContexts) {
+        settings.tenantContexts = tenantContexts.Get();
+    }
+
+    if (maxInFlightPerWorker) {
+        settings.maxInFlightPerWorker = maxInFlightPerWorker.Get();
+    }
+
+    if (timeoutGracePeriod) {
+        settings.timeoutGracePeriod = timeoutGracePeriod.Get();
+    }
+
+    if (slowTaskThreshold) {
+        settings.slowTaskThreshold = slowTaskThreshold.Get();
+    }
+
+    if (hardwareCounters) {
+        if (!ParseBool(hardwareCounters.Get(), settings.hardwareCounters)) {
+            LOG_ERROR("Settings", "Invalid boolean value for hardwareCounters: %s", hardwareCounters.Get().c_str());
+            return false;
+        }
+    }
+
+    if (asyncWorkers) {
+        if (asyncWorkers.Get() == 0) {
+            LOG_ERROR("Settings", "asyncWorkers must be greater than 0");
+            return false;
+        }
+        settings.asyncWorkers = asyncWorkers.Get();
+    }
+
+    if (eventLoop) {
+        if (!ParseBool(eventLoop.Get(), settings.eventLoop)) {
+            LOG_ERROR("Settings", "Invalid boolean value for eventLoop: %s", eventLoop.Get().c_str());
+            return false;
+        }
+    }
+
+    if (timerSlack) {
+        settings.timerSlack = timerSlack.Get();
+    }
+
+    if (alignedIntervals) {
+        if (!ParseBool(alignedIntervals.Get(), settings.alignedIntervals)) {
+            LOG_ERROR("Settings", "Invalid boolean value for alignedIntervals: %s", alignedIntervals.Get().c_str());
+            return false;
+        }
+    }
+
+    if (cpuSet) {
+        if (!platform::ParseCpuList(cpuSet.Get(), settings.cpuSet)) {
+            LOG_ERROR("Settings", "Invalid CPU set: %s", cpuSet.Get().c_str());
+            return false;
+        }
+    }
+
+    if (numaNode) {
+        settings.numaNode = numaNode.Get();
+    }
+
+    // Sized after the CPU set and NUMA node, which restrict the CPUs that 'auto' and 'physical' count.
+    if (workers) {
+        if (!ParseWorkers(workers.Get(), settings)) {
+            LOG_ERROR("Settings", "Invalid number of workers: %s", workers.Get().c_str());
+            return false;
+        }
+        NAPA_ASSERT(settings.workers > 0, "The number of workers must be greater than 0");
+    }
+
+    if (pinWorkersToCores) {
+        if (!ParseBool(pinWorkersToCores.Get(), settings.pinWorkersToCores)) {
+            LOG_ERROR("Settings", "Invalid boolean value for pinWorkersToCores: %s", pinWorkersToCores.Get().c_str());
+            return false;
+        }
+    }
+
+    if (threadPriority) {
+        const auto& priority = threadPriority.Get();
+        if (priority == "high") {
+            settings.threadPriority = platform::ThreadPriority::High;
+        } else if (priority == "normal") {
+            settings.threadPriority = platform::ThreadPriority::Normal;
+        } else if (priority == "low") {
+            settings.threadPriority = platform::ThreadPriority::Low;
+        } else if (priority == "background") {
+            settings.threadPriority = platform::ThreadPriority::Background;
+        } else {
+            LOG_ERROR("Settings", "Unknown thread priority: %s", priority.c_str());
+            return false;
+        }
+    }
+
+    if (allocator) {
+        const auto& type = allocator.Get();
+        if (type == "default") {
+            settings.allocator = AllocatorType::Default;
+        } else if (type == "crt") {
+            settings.allocator = AllocatorType::Crt;
+        } else if (type == "pool") {
+            settings.allocator = AllocatorType::Pool;
+        } else {
+            LOG_ERROR("Settings", "Unknown zone allocator: %s", type.c_str());
+            return false;
+        }
+    }
+
+    if (taskArenaChunkSize) {
+        if (taskArenaChunkSize.Get() < 1024) {
+            LOG_ERROR("Settings", "taskArenaChunkSize must be at least 1024");
+            return false;
+        }
+        settings.taskArenaChunkSize = taskArenaChunkSize.Get();
+    }
+
     return true;
 }
\ No newline at end of file
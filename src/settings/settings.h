@@ -3,21 +3,157 @@
 
 #pragma once
 
+#include <napa/providers/logging.h>
+#include <module/loader/file-status-cache.h>
+#include <platform/thread.h>
+#include <platform/virtual-memory.h>
+
 #include <algorithm>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 namespace napa {
 namespace settings {
 
+    /// <summary> The strategy a zone scheduler uses for dispatching tasks to workers. </summary>
+    enum class SchedulerType {
+
+        /// <summary> All dispatching is serialized through a single synchronizer thread. </summary>
+        Synchronized,
+
+        /// <summary> Callers claim idle workers and queue pending tasks without taking a lock. </summary>
+        LockFree,
+
+        /// <summary> Like LockFree, with one pending queue per worker and idle workers stealing from their peers. </summary>
+        WorkStealing
+    };
+
+    /// <summary> What a zone does with a new task when its queue is full. </summary>
+    enum class OverloadPolicy {
+
+        /// <summary> The new task is rejected with NAPA_RESULT_ZONE_OVERLOADED. </summary>
+        Reject,
+
+        /// <summary> The caller is blocked until the queue has room. </summary>
+        Block,
+
+        /// <summary> The oldest waiting task is rejected with NAPA_RESULT_ZONE_OVERLOADED to make room. </summary>
+        DropOldest
+    };
+
+    /// <summary> When workers run the microtasks of promises. </summary>
+    enum class MicrotaskPolicy {
+
+        /// <summary> V8 runs the microtasks after each task, timer and callback. </summary>
+        Auto,
+
+        /// <summary> Workers run the microtasks after a batch of tasks or a time slice, and before they wait for tasks. </summary>
+        Batched
+    };
+
+    /// <summary> Garbage collection trade-off of the workers of a zone, it sets their young generation size and idle collection. </summary>
+    enum class GcProfile {
+
+        /// <summary> V8 sizes the young generation and decides when to collect. </summary>
+        Default,
+
+        /// <summary> A small young generation for short scavenges, and collection while workers are idle. </summary>
+        Latency,
+
+        /// <summary> A large young generation, so fewer objects are scavenged and promoted. </summary>
+        Throughput,
+
+        /// <summary> A small young generation, and more collection while workers are idle to keep the heaps small. </summary>
+        Memory
+    };
+
+    /// <summary> The share of the zone queue a tenant gets, relative to the other tenants. </summary>
+    struct TenantWeight {
+
+        /// <summary> The tenant name, as given in the call options. </summary>
+        std::string name;
+
+        /// <summary> The tenant key calls carry, the name hashed like routing keys. </summary>
+        uint64_t tenant;
+
+        /// <summary> The number of tasks the tenant is dispatched per round, at least 1. </summary>
+        uint32_t weight;
+    };
+
+    /// <summary> The calls per second a tenant may make to a zone. </summary>
+    struct TenantRateLimit {
+
+        /// <summary> The tenant name, as given in the call options, or '*' for tenants without their own rate. </summary>
+        std::string name;
+
+        /// <summary> The tenant key calls carry, the name hashed like routing keys. </summary>
+        uint64_t tenant;
+
+        /// <summary> The calls per second, at least 1. </summary>
+        uint32_t rate;
+    };
+
+    /// <summary> The allocator behind napa_allocate and the default allocator, or behind a zone's allocator. </summary>
+    enum class AllocatorType {
+
+        /// <summary> For zones only, the default allocator, i.e. whatever napa_allocate uses. </summary>
+        Default,
+
+        /// <summary> C runtime malloc and free, unless napa_allocator_set is called. </summary>
+        Crt,
+
+        /// <summary> Size class pools with thread caches, see napa::memory::GetPoolAllocator. </summary>
+        Pool,
+
+        /// <summary> For the platform only, mimalloc loaded at initialization, see napa::memory::LoadMallocLibrary. </summary>
+        Mimalloc,
+
+        /// <summary> For the platform only, jemalloc loaded at initialization, see napa::memory::LoadMallocLibrary. </summary>
+        Jemalloc
+    };
+
     /// <summary> Platform settings - setting that affect all zones. </summary>
     struct PlatformSettings {
 
         /// <summary> The logging provider. </summary>
         std::string loggingProvider = "console";
 
+        /// <summary> The file the async logging provider appends to, empty for the standard output. </summary>
+        std::string logFile;
+
+        /// <summary> The most verbose level that is logged, checked before any logging provider is called. </summary>
+        providers::LoggingProvider::Verboseness logLevel = providers::LoggingProvider::Verboseness::Debug;
+
+        /// <summary> The sections the async logging provider logs, empty for all. </summary>
+        std::vector<std::string> logSections;
+
         /// <summary> The metric provider. </summary>
         std::string metricProvider;
+
+        /// <summary> The directory persisting compiled Javascript modules across restarts, empty to cache them in memory only. </summary>
+        std::string codeCacheDirectory;
+
+        /// <summary> How long module resolution trusts the statuses of the files and directories it probed. </summary>
+        module::FileStatusCacheMode moduleStatusCache = module::FileStatusCacheMode::Process;
+
+        /// <summary> Whether JSON modules are parsed once per process and deserialized by the other workers. </summary>
+        bool sharedJsonModules = false;
+
+        /// <summary> The allocator napa_allocate uses, selected at initialization before it serves any memory. </summary>
+        AllocatorType defaultAllocator = AllocatorType::Crt;
+
+        /// <summary> The most memory released ArrayBuffer blocks keep for reuse by all isolates, 0 to disable pooling. </summary>
+        uint64_t arrayBufferPoolSize = 64 * 1024 * 1024;
+
+        /// <summary> Whether ArrayBuffer blocks of 2MB and more are backed by huge pages. </summary>
+        platform::HugePages arrayBufferHugePages = platform::HugePages::None;
+
+        /// <summary> The number of isolates created ahead of time for the workers of new zones, 0 for none. </summary>
+        uint32_t prewarmIsolates = 0;
+
+        /// <summary> The bytes of console output a thread buffers before it's written, 0 to write console output through. </summary>
+        uint32_t consoleBufferSize = 0;
     };
 
     /// <summary> Zone specific settings. </summary>
@@ -29,6 +165,60 @@ namespace settings {
         /// <summary> The number of zone workers. </summary>
         uint32_t workers = 2;
 
+        /// <summary> The minimum number of zone workers when scaling, 0 to use the number of workers. </summary>
+        uint32_t minWorkers = 0;
+
+        /// <summary> The maximum number of zone workers when scaling, 0 to use the number of workers. </summary>
+        uint32_t maxWorkers = 0;
+
+        /// <summary> The time in milliseconds a worker stays idle before it is retired when scaling. </summary>
+        uint32_t workerIdleTimeout = 60000;
+
+        /// <summary> The number of queued tasks per starting worker that triggers starting another worker. </summary>
+        uint32_t scaleUpQueueDepth = 1;
+
+        /// <summary> The number of tasks a worker runs before it is replaced by a new worker, 0 to never recycle. </summary>
+        uint32_t maxTasksPerWorker = 0;
+
+        /// <summary> The used heap size in megabytes a worker reaches before it is replaced by a new worker, 0 to never recycle. </summary>
+        uint32_t maxHeapBeforeRecycle = 0;
+
+        /// <summary> A worker whose heap gets near its limit rejects its calls with NAPA_RESULT_HEAP_LIMIT_REACHED and is replaced. </summary>
+        bool recycleOnHeapLimit = false;
+
+        /// <summary> The milliseconds a worker runs a task before it's stuck and its waiting tasks go to other workers, 0 to disable. </summary>
+        uint32_t stuckWorkerThreshold = 0;
+
+        /// <summary> Stuck workers are terminated and replaced by new workers. </summary>
+        bool recycleStuckWorkers = false;
+
+        /// <summary> The size in megabytes of the cache of call results, 0 to never cache results. </summary>
+        uint32_t resultCacheSize = 16;
+
+        /// <summary> The time in microseconds an idle worker spins before it yields. </summary>
+        uint32_t idleSpinTime = 0;
+
+        /// <summary> The time in microseconds an idle worker yields before it parks. </summary>
+        uint32_t idleYieldTime = 0;
+
+        /// <summary> Idle workers keep spinning instead of parking, trading CPU for wake up latency. </summary>
+        bool lowLatency = false;
+
+        /// <summary> The time in milliseconds a worker gives V8 for garbage collection before it parks, 0 to let V8 decide. </summary>
+        uint32_t idleGcTime = 0;
+
+        /// <summary> The garbage collection profile, it sets maxSemiSpaceSize and idleGcTime unless they are given explicitly. </summary>
+        GcProfile gcProfile = GcProfile::Default;
+
+        /// <summary> When workers run the microtasks of promises. </summary>
+        MicrotaskPolicy microtaskPolicy = MicrotaskPolicy::Auto;
+
+        /// <summary> The number of tasks a worker runs between runs of microtasks, for MicrotaskPolicy::Batched. </summary>
+        uint32_t microtaskBatchSize = 32;
+
+        /// <summary> The time in microseconds a worker runs tasks between runs of microtasks, for MicrotaskPolicy::Batched. </summary>
+        uint32_t microtaskTimeSlice = 1000;
+
         /// <summary> Isolate memory constraint - The maximum old space size in megabytes. </summary>
         uint32_t maxOldSpaceSize = 0u;
 
@@ -40,6 +230,108 @@ namespace settings {
 
         /// <summary> The maximum size that the isolate stack is allowed to grow in bytes. </summary>
         uint32_t maxStackSize = 500 * 1024;
+
+        /// <summary> Javascript modules are wrapped in a function and run in the worker's context, instead of a context each. </summary>
+        bool sharedModuleContext = false;
+
+        /// <summary> The static requires of a module are resolved and read in parallel on the async work pool while it loads. </summary>
+        bool modulePrefetch = false;
+
+        /// <summary> Path of a script run once into a V8 startup snapshot that workers start from, empty for none. </summary>
+        std::string startupScript;
+
+        /// <summary> Path of the V8 startup snapshot blob, it's created from startupScript when missing. </summary>
+        std::string startupSnapshot;
+
+        /// <summary> Path of a module bundle that serves module resolutions, sources and compiled code. </summary>
+        std::string bundle;
+
+        /// <summary> Modules each worker loads on bootstrap, before it serves calls. </summary>
+        std::vector<std::string> preload;
+
+        /// <summary> The module of the function each worker calls with the warm-up samples before serving calls, empty for none. </summary>
+        std::string warmupModule;
+
+        /// <summary> The function each worker calls with the warm-up samples. </summary>
+        std::string warmupFunction;
+
+        /// <summary> Path of the warm-up samples, one JSON array of the marshalled arguments of a call per line. </summary>
+        std::string warmupSamples;
+
+        /// <summary> The number of times each worker calls the warm-up function with each sample. </summary>
+        uint32_t warmupIterations = 100;
+
+        /// <summary> Path of a file the arguments of the first calls of the warm-up function are recorded into, empty for none. </summary>
+        std::string warmupRecord;
+
+        /// <summary> The scheduler type used for dispatching tasks to zone workers. </summary>
+        SchedulerType scheduler = SchedulerType::Synchronized;
+
+        /// <summary> The maximum number of tasks waiting for a worker, 0 for no limit. </summary>
+        uint32_t maxQueueLength = 0;
+
+        /// <summary> What happens to a new task when the queue reached maxQueueLength. </summary>
+        OverloadPolicy overloadPolicy = OverloadPolicy::Reject;
+
+        /// <summary> The weights of tenants sharing the queue, tenants without one have a weight of 1. </summary>
+        std::vector<TenantWeight> tenantWeights;
+
+        /// <summary> The calls per second the zone accepts, calls over the rate are rejected with NAPA_RESULT_RATE_LIMITED, 0 for no limit. </summary>
+        uint32_t rateLimit = 0;
+
+        /// <summary> The calls per second tenants may make, calls over their rate are rejected with NAPA_RESULT_RATE_LIMITED. </summary>
+        std::vector<TenantRateLimit> tenantRateLimits;
+
+        /// <summary> The highest adaptive limit of calls in flight, calls over the limit are rejected with NAPA_RESULT_ZONE_OVERLOADED, 0 for no limit. </summary>
+        uint32_t maxConcurrency = 0;
+
+        /// <summary> The number of tenants per worker whose calls run in a context of their own, 0 to run all calls in the worker's context. </summary>
+        uint32_t tenantContexts = 0;
+
+        /// <summary> The number of routed tasks waiting for a busy worker before new ones go to any worker. </summary>
+        uint32_t routingImbalance = 4;
+
+        /// <summary> The number of dispatched calls a worker may have in flight before it takes new ones, 0 for no limit. </summary>
+        uint32_t maxInFlightPerWorker = 0;
+
+        /// <summary> The milliseconds a call may run past its timeout to stop by itself before it is terminated. </summary>
+        uint32_t timeoutGracePeriod = 0;
+
+        /// <summary> The milliseconds a call runs before its stack is captured and reported as slow, 0 to disable. </summary>
+        uint32_t slowTaskThreshold = 0;
+
+        /// <summary> Each worker reads the hardware counters around its calls, which the zone stats sum by function. </summary>
+        bool hardwareCounters = false;
+
+        /// <summary> The maximum number of threads running asynchronous works posted by the zone workers. </summary>
+        uint32_t asyncWorkers = 4;
+
+        /// <summary> Each worker runs a libuv event loop for asynchronous I/O of native modules. </summary>
+        bool eventLoop = false;
+
+        /// <summary> The milliseconds JavaScript timers of the workers may fire late, so timers due close together share a wake up. </summary>
+        uint32_t timerSlack = 0;
+
+        /// <summary> Whether JavaScript intervals fire on multiples of their period, so intervals of a period fire together. </summary>
+        bool alignedIntervals = false;
+
+        /// <summary> Logical CPUs the zone workers are allowed to run on, empty for no restriction. </summary>
+        std::vector<uint32_t> cpuSet;
+
+        /// <summary> The NUMA node the zone workers are placed on, -1 for no preference. </summary>
+        int32_t numaNode = -1;
+
+        /// <summary> Pins each worker to a distinct physical core within the allowed CPUs. </summary>
+        bool pinWorkersToCores = false;
+
+        /// <summary> The scheduling priority of the zone worker threads. </summary>
+        platform::ThreadPriority threadPriority = platform::ThreadPriority::Normal;
+
+        /// <summary> The allocator of the zone, which native modules get through napa::memory::GetZoneAllocator. </summary>
+        AllocatorType allocator = AllocatorType::Default;
+
+        /// <summary> The chunk size in bytes of each worker's task arena, which is reset after each call task. </summary>
+        uint32_t taskArenaChunkSize = 64 * 1024;
     };
 }
 }
\ No newline at end of file
@@ -0,0 +1,233 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "frozen-value.h"
+
+#include <rapidjson/document.h>
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+using namespace napa::store;
+
+constexpr uint32_t FrozenValue::NOT_FOUND;
+constexpr uint32_t FrozenValue::MAX_DEPTH;
+constexpr uint32_t FrozenValue::HEADER_SIZE;
+
+namespace napa {
+namespace store {
+
+    /// <summary> Writes the nodes of a parsed JSON document into the buffer of a frozen value. </summary>
+    class FrozenValueBuilder {
+    public:
+        explicit FrozenValueBuilder(FrozenValue& value) : _value(value) {}
+
+        /// <summary> Write a JSON value and its children. </summary>
+        /// <returns> False if it's nested too deep or the buffer would go over 4 GB. </returns>
+        bool Write(const rapidjson::Value& json, uint32_t depth, uint32_t& node) {
+            switch (json.GetType()) {
+            case rapidjson::kNullType:
+                return WriteHeader(FrozenValueKind::Null, 0, 0, node);
+
+            case rapidjson::kFalseType:
+                return WriteHeader(FrozenValueKind::False, 0, 0, node);
+
+            case rapidjson::kTrueType:
+                return WriteHeader(FrozenValueKind::True, 0, 0, node);
+
+            case rapidjson::kNumberType: {
+                if (!WriteHeader(FrozenValueKind::Number, 0, sizeof(double), node)) {
+                    return false;
+                }
+                auto number = json.GetDouble();
+                std::memcpy(&_value._buffer[node + FrozenValue::HEADER_SIZE], &number, sizeof(number));
+                return true;
+            }
+
+            case rapidjson::kStringType:
+                return WriteString(json.GetString(), json.GetStringLength(), node);
+
+            case rapidjson::kArrayType: {
+                if (depth >= FrozenValue::MAX_DEPTH) {
+                    return false;
+                }
+
+                auto count = json.Size();
+                if (!WriteHeader(FrozenValueKind::Array, count, static_cast<size_t>(count) * 4, node)) {
+                    return false;
+                }
+                for (uint32_t i = 0; i < count; ++i) {
+                    uint32_t element = 0;
+                    if (!Write(json[i], depth + 1, element)) {
+                        return false;
+                    }
+                    WriteUint32(node + FrozenValue::HEADER_SIZE + i * 4, element);
+                }
+                return true;
+            }
+
+            case rapidjson::kObjectType: {
+                if (depth >= FrozenValue::MAX_DEPTH) {
+                    return false;
+                }
+
+                auto count = json.MemberCount();
+                if (!WriteHeader(FrozenValueKind::Object, count, static_cast<size_t>(count) * 12, node)) {
+                    return false;
+                }
+
+                uint32_t i = 0;
+                for (auto member = json.MemberBegin(); member != json.MemberEnd(); ++member, ++i) {
+                    uint32_t key = 0;
+                    uint32_t value = 0;
+                    if (!WriteString(member->name.GetString(), member->name.GetStringLength(), key)
+                        || !Write(member->value, depth + 1, value)) {
+                        return false;
+                    }
+                    WriteUint32(node + FrozenValue::HEADER_SIZE + i * 8, key);
+                    WriteUint32(node + FrozenValue::HEADER_SIZE + i * 8 + 4, value);
+                }
+
+                std::vector<uint32_t> order(count);
+                for (i = 0; i < count; ++i) {
+                    order[i] = i;
+                }
+                std::stable_sort(order.begin(), order.end(), [this, node](uint32_t left, uint32_t right) {
+                    auto rightKey = _value.GetPropertyKey(node, right);
+                    return _value.CompareKey(
+                        _value.GetPropertyKey(node, left), _value.GetString(rightKey), _value.GetCount(rightKey)) < 0;
+                });
+
+                auto sorted = node + FrozenValue::HEADER_SIZE + count * 8;
+                for (i = 0; i < count; ++i) {
+                    WriteUint32(sorted + i * 4, order[i]);
+                }
+                return true;
+            }
+            }
+            return false;
+        }
+
+    private:
+        /// <summary> Append a node of a kind with room for its payload. </summary>
+        bool WriteHeader(FrozenValueKind kind, uint32_t count, size_t payloadSize, uint32_t& node) {
+            auto offset = (_value._buffer.size() + 7) & ~static_cast<size_t>(7);
+            auto end = offset + FrozenValue::HEADER_SIZE + payloadSize;
+            if (end > FrozenValue::NOT_FOUND) {
+                return false;
+            }
+
+            _value._buffer.resize(end);
+            node = static_cast<uint32_t>(offset);
+            WriteUint32(node, static_cast<uint32_t>(kind));
+            WriteUint32(node + 4, count);
+            return true;
+        }
+
+        /// <summary> Append a String node, or reuse the node of the same string. </summary>
+        bool WriteString(const char* data, uint32_t length, uint32_t& node) {
+            std::string text(data, length);
+            auto it = _strings.find(text);
+            if (it != _strings.end()) {
+                node = it->second;
+                return true;
+            }
+
+            if (!WriteHeader(FrozenValueKind::String, length, static_cast<size_t>(length) + 1, node)) {
+                return false;
+            }
+            std::memcpy(&_value._buffer[node + FrozenValue::HEADER_SIZE], data, length);
+            _strings.emplace(std::move(text), node);
+            return true;
+        }
+
+        void WriteUint32(uint32_t offset, uint32_t value) {
+            std::memcpy(&_value._buffer[offset], &value, sizeof(value));
+        }
+
+        FrozenValue& _value;
+        std::unordered_map<std::string, uint32_t> _strings;
+    };
+}
+}
+
+std::shared_ptr<FrozenValue> FrozenValue::FromJson(const char* json, size_t length) {
+    // The iterative parser takes deep documents without recursion, Write bounds the depth it takes.
+    rapidjson::Document document;
+    document.Parse<rapidjson::kParseIterativeFlag>(json, length);
+    if (document.HasParseError()) {
+        return nullptr;
+    }
+
+    auto value = std::make_shared<FrozenValue>();
+    FrozenValueBuilder builder(*value);
+    uint32_t root = 0;
+    if (!builder.Write(document, 0, root)) {
+        return nullptr;
+    }
+    value->_buffer.shrink_to_fit();
+    return value;
+}
+
+bool FrozenValue::IsNode(uint32_t node) const {
+    auto size = _buffer.size();
+    if (node % 8 != 0 || static_cast<size_t>(node) + HEADER_SIZE > size) {
+        return false;
+    }
+
+    size_t count = GetCount(node);
+    size_t payloadSize = 0;
+    switch (GetKind(node)) {
+    case FrozenValueKind::Null:
+    case FrozenValueKind::False:
+    case FrozenValueKind::True:
+        break;
+    case FrozenValueKind::Number:
+        payloadSize = sizeof(double);
+        break;
+    case FrozenValueKind::String:
+        payloadSize = count + 1;
+        break;
+    case FrozenValueKind::Array:
+        payloadSize = count * 4;
+        break;
+    case FrozenValueKind::Object:
+        payloadSize = count * 12;
+        break;
+    default:
+        return false;
+    }
+    return static_cast<size_t>(node) + HEADER_SIZE + payloadSize <= size;
+}
+
+uint32_t FrozenValue::FindProperty(uint32_t node, const char* key, size_t length) const {
+    auto count = GetCount(node);
+    auto sorted = node + HEADER_SIZE + count * 8;
+
+    uint32_t low = 0;
+    uint32_t high = count;
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        auto index = ReadUint32(sorted + middle * 4);
+        auto compared = CompareKey(GetPropertyKey(node, index), key, length);
+        if (compared == 0) {
+            return GetPropertyValue(node, index);
+        }
+        if (compared < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return NOT_FOUND;
+}
+
+int FrozenValue::CompareKey(uint32_t node, const char* key, size_t length) const {
+    auto nodeLength = static_cast<size_t>(GetCount(node));
+    auto compared = std::memcmp(GetString(node), key, std::min(nodeLength, length));
+    if (compared != 0) {
+        return compared;
+    }
+    return nodeLength < length ? -1 : (nodeLength > length ? 1 : 0);
+}
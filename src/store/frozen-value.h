@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/exports.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace napa {
+namespace store {
+
+    /// <summary> Kinds of nodes in a frozen value, which fit in the 3 low bits of a node offset. </summary>
+    enum class FrozenValueKind : uint32_t {
+        Null = 0,
+        False = 1,
+        True = 2,
+        Number = 3,
+        String = 4,
+        Array = 5,
+        Object = 6
+    };
+
+    /// <summary> An immutable JSON value in one compact buffer, which all isolates read in place without unmarshalling. </summary>
+    /// <remarks>
+    /// Nodes start at offsets aligned to 8 bytes, the root at offset 0. Each node has a header of its kind and count,
+    /// the count being the bytes of a string, the elements of an array or the properties of an object, followed by
+    ///   - Number: the double.
+    ///   - String: the UTF-8 bytes and a terminating NUL.
+    ///   - Array: the offsets of the elements.
+    ///   - Object: pairs of key and value offsets in their JSON order, then the indices of the pairs sorted by key.
+    /// Strings are written once however many keys and values they appear in.
+    /// </remarks>
+    class FrozenValue {
+    public:
+        /// <summary> Offset returned for elements and properties that don't exist. </summary>
+        static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+        /// <summary> Deepest nesting of arrays and objects a frozen value takes. </summary>
+        static constexpr uint32_t MAX_DEPTH = 1024;
+
+        /// <summary> Build a frozen value from JSON. </summary>
+        /// <param name="json"> UTF-8 JSON text. </param>
+        /// <param name="length"> Bytes of the text. </param>
+        /// <returns> The value, or nullptr if the text is not valid JSON, it's nested too deep or takes over 4 GB. </returns>
+        static NAPA_API std::shared_ptr<FrozenValue> FromJson(const char* json, size_t length);
+
+        /// <summary> Get the root node. </summary>
+        uint32_t GetRoot() const {
+            return 0;
+        }
+
+        /// <summary> Get the bytes of the buffer. </summary>
+        size_t GetByteLength() const {
+            return _buffer.size();
+        }
+
+        /// <summary> Tell if an offset is of a node in the buffer, for offsets that come from scripts. </summary>
+        NAPA_API bool IsNode(uint32_t node) const;
+
+        /// <summary> Get the kind of a node. </summary>
+        FrozenValueKind GetKind(uint32_t node) const {
+            return static_cast<FrozenValueKind>(ReadUint32(node));
+        }
+
+        /// <summary> Get the bytes of a string, the elements of an array or the properties of an object. </summary>
+        uint32_t GetCount(uint32_t node) const {
+            return ReadUint32(node + 4);
+        }
+
+        /// <summary> Get the number of a Number node. </summary>
+        double GetNumber(uint32_t node) const {
+            double value;
+            std::memcpy(&value, _buffer.data() + node + HEADER_SIZE, sizeof(value));
+            return value;
+        }
+
+        /// <summary> Get the NUL terminated UTF-8 bytes of a String node, GetCount tells their length. </summary>
+        const char* GetString(uint32_t node) const {
+            return reinterpret_cast<const char*>(_buffer.data() + node + HEADER_SIZE);
+        }
+
+        /// <summary> Get an element of an Array node, or NOT_FOUND if index is out of range. </summary>
+        uint32_t GetElement(uint32_t node, uint32_t index) const {
+            if (index >= GetCount(node)) {
+                return NOT_FOUND;
+            }
+            return ReadUint32(node + HEADER_SIZE + index * 4);
+        }
+
+        /// <summary> Get the String node of the key of a property of an Object node, in JSON order. </summary>
+        uint32_t GetPropertyKey(uint32_t node, uint32_t index) const {
+            return ReadUint32(node + HEADER_SIZE + index * 8);
+        }
+
+        /// <summary> Get the node of the value of a property of an Object node, in JSON order. </summary>
+        uint32_t GetPropertyValue(uint32_t node, uint32_t index) const {
+            return ReadUint32(node + HEADER_SIZE + index * 8 + 4);
+        }
+
+        /// <summary> Find the value of a property of an Object node by binary search of its sorted keys. </summary>
+        /// <returns> The node of the value, or NOT_FOUND. </returns>
+        NAPA_API uint32_t FindProperty(uint32_t node, const char* key, size_t length) const;
+
+    private:
+        static constexpr uint32_t HEADER_SIZE = 8;
+
+        friend class FrozenValueBuilder;
+
+        uint32_t ReadUint32(uint32_t offset) const {
+            uint32_t value;
+            std::memcpy(&value, _buffer.data() + offset, sizeof(value));
+            return value;
+        }
+
+        /// <summary> Compare a key with the bytes of a String node, like std::string::compare. </summary>
+        int CompareKey(uint32_t node, const char* key, size_t length) const;
+
+        std::vector<uint8_t> _buffer;
+    };
+}
+}
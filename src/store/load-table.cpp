@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "load-table.h"
+
+#include <chrono>
+
+using namespace napa::store;
+
+void LoadTable::SetLoader(const std::string& moduleName, const std::string& functionName, uint32_t ttl, uint32_t waitTimeout) {
+    std::lock_guard<std::mutex> lock(_access);
+    _moduleName = moduleName;
+    _functionName = functionName;
+    _ttl = ttl;
+    _waitTimeout = waitTimeout;
+}
+
+bool LoadTable::GetLoader(std::string& moduleName, std::string& functionName, uint32_t& ttl) const {
+    std::lock_guard<std::mutex> lock(_access);
+    if (_functionName.empty()) {
+        return false;
+    }
+    moduleName = _moduleName;
+    functionName = _functionName;
+    ttl = _ttl;
+    return true;
+}
+
+Store::LoadStatus LoadTable::Begin(const std::string& key, std::shared_ptr<Store::ValueType>& value, std::string& error) {
+    std::unique_lock<std::mutex> lock(_access);
+    auto it = _loads.find(key);
+    if (it == _loads.end()) {
+        auto load = std::make_shared<Load>();
+        load->loader = std::this_thread::get_id();
+        _loads.emplace(key, std::move(load));
+        ++_loadCount;
+        return Store::LoadStatus::LOAD;
+    }
+
+    // A loader that needs its own key would wait for itself.
+    auto self = std::this_thread::get_id();
+    auto load = it->second;
+    if (load->loader == self) {
+        return Store::LoadStatus::REENTERED;
+    }
+
+    // So would a loader whose thread waits, through the loads of other threads, for a key this thread is loading.
+    // Each wait is checked before it begins, so the chain of waits ends, the hops only bound it.
+    auto waited = _waiting.find(load->loader);
+    for (size_t hops = 0; waited != _waiting.end() && hops <= _waiting.size(); ++hops) {
+        if (waited->second->loader == self) {
+            return Store::LoadStatus::CYCLE;
+        }
+        waited = _waiting.find(waited->second->loader);
+    }
+
+    ++_waitCount;
+    _waiting[self] = load;
+    auto ended = _ended.wait_for(lock, std::chrono::milliseconds(_waitTimeout), [&load]() { return load->done; });
+    _waiting.erase(self);
+    if (!ended) {
+        return Store::LoadStatus::TIMEDOUT;
+    }
+
+    value = load->value;
+    error = load->error;
+    return error.empty() ? Store::LoadStatus::LOADED : Store::LoadStatus::FAILED;
+}
+
+void LoadTable::End(const std::string& key, std::shared_ptr<Store::ValueType> value, std::string error) {
+    {
+        std::lock_guard<std::mutex> lock(_access);
+        auto it = _loads.find(key);
+        if (it == _loads.end()) {
+            return;
+        }
+
+        // Waiters hold the load, the next miss of the key begins a new one.
+        auto& load = *it->second;
+        load.done = true;
+        load.value = std::move(value);
+        load.error = std::move(error);
+        _loads.erase(it);
+    }
+    _ended.notify_all();
+}
+
+uint64_t LoadTable::GetLoads() const {
+    std::lock_guard<std::mutex> lock(_access);
+    return _loadCount;
+}
+
+uint64_t LoadTable::GetWaits() const {
+    std::lock_guard<std::mutex> lock(_access);
+    return _waitCount;
+}
@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "store.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace napa {
+namespace store {
+
+    /// <summary> The loader of a store and the loads of missing keys in flight, so each key is loaded once at a time. </summary>
+    /// <remarks>
+    /// The first thread that begins the load of a key runs the loader, later threads wait for its end and share its result.
+    /// A wait is bounded by the wait timeout of the loader, and refused if the threads would wait for each other.
+    /// Loads are tracked in process memory, also for stores in named shared memory.
+    /// </remarks>
+    class LoadTable {
+    public:
+        /// <summary> Set the loader, replacing the one set before. Loads in flight complete with the loader they run. </summary>
+        void SetLoader(const std::string& moduleName, const std::string& functionName, uint32_t ttl, uint32_t waitTimeout);
+
+        /// <summary> Get the loader. </summary>
+        /// <returns> False if no loader is set. </returns>
+        bool GetLoader(std::string& moduleName, std::string& functionName, uint32_t& ttl) const;
+
+        /// <summary> Begin the load of a key, or wait for the end of the load in flight. </summary>
+        /// <param name="key"> The missing key. </param>
+        /// <param name="value"> Receives the value of the load waited for, nullptr if it loaded none. </param>
+        /// <param name="error"> Receives the error of the load waited for, if it failed. </param>
+        /// <returns>
+        ///     LOAD if the caller runs the loader, which it must end by End. REENTERED or CYCLE if the loader of the key
+        ///     waits for the calling thread, TIMEDOUT if the load didn't end in time, otherwise the result of the load.
+        /// </returns>
+        Store::LoadStatus Begin(const std::string& key, std::shared_ptr<Store::ValueType>& value, std::string& error);
+
+        /// <summary> End the load of a key, which wakes up the threads waiting for it. </summary>
+        /// <param name="key"> The key, whose load was begun by the calling thread. </param>
+        /// <param name="value"> The value set by the load, nullptr if it loaded none or failed. </param>
+        /// <param name="error"> Error of the load, empty if it succeeded. </param>
+        void End(const std::string& key, std::shared_ptr<Store::ValueType> value, std::string error);
+
+        /// <summary> Number of loads run. </summary>
+        uint64_t GetLoads() const;
+
+        /// <summary> Number of calls that waited for the load of another call instead of running one. </summary>
+        uint64_t GetWaits() const;
+
+    private:
+        /// <summary> A load in flight, whose result is kept for the threads waiting for it. </summary>
+        struct Load {
+            std::thread::id loader;
+            bool done = false;
+            std::shared_ptr<Store::ValueType> value;
+            std::string error;
+        };
+
+        std::string _moduleName;
+        std::string _functionName;
+        uint32_t _ttl = 0;
+        uint32_t _waitTimeout = DEFAULT_LOAD_WAIT_TIMEOUT;
+
+        std::unordered_map<std::string, std::shared_ptr<Load>> _loads;
+
+        /// <summary> The load each waiting thread waits for, to find the cycles a wait would close. </summary>
+        std::unordered_map<std::thread::id, std::shared_ptr<Load>> _waiting;
+
+        uint64_t _loadCount = 0;
+        uint64_t _waitCount = 0;
+
+        mutable std::mutex _access;
+        std::condition_variable _ended;
+    };
+}
+}
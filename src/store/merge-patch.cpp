@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "merge-patch.h"
+
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace napa::store;
+
+namespace {
+
+    using Encoding = rapidjson::UTF16<char16_t>;
+    using Document = rapidjson::GenericDocument<Encoding>;
+    using Value = rapidjson::GenericValue<Encoding>;
+
+    constexpr unsigned PARSE_FLAGS = rapidjson::kParseIterativeFlag | rapidjson::kParseFullPrecisionFlag;
+
+    /// <summary> Deepest nesting of objects in a patch, deeper patches are rejected. </summary>
+    constexpr uint32_t MAX_DEPTH = 1024;
+
+    /// <summary> Merge a patch into a target, as MergePatch of RFC 7386. </summary>
+    /// <returns> False if the patch is nested too deep. </returns>
+    bool Merge(Value& target, const Value& patch, Document::AllocatorType& allocator, uint32_t depth) {
+        if (!patch.IsObject()) {
+            target.CopyFrom(patch, allocator);
+            return true;
+        }
+        if (depth == MAX_DEPTH) {
+            return false;
+        }
+
+        if (!target.IsObject()) {
+            target.SetObject();
+        }
+        for (auto member = patch.MemberBegin(); member != patch.MemberEnd(); ++member) {
+            auto it = target.FindMember(member->name);
+            if (member->value.IsNull()) {
+                if (it != target.MemberEnd()) {
+                    // Erasing keeps the order of the other members, as JSON.stringify writes them.
+                    target.EraseMember(it);
+                }
+                continue;
+            }
+
+            if (it != target.MemberEnd()) {
+                if (!Merge(it->value, member->value, allocator, depth + 1)) {
+                    return false;
+                }
+                continue;
+            }
+
+            // Members added are merged into null, which drops null members of nested objects.
+            Value name(member->name, allocator);
+            Value value;
+            if (!Merge(value, member->value, allocator, depth + 1)) {
+                return false;
+            }
+            target.AddMember(name, value, allocator);
+        }
+        return true;
+    }
+
+    /// <summary> Parse JSON in UTF-16, which has no NUL characters since JSON escapes them. </summary>
+    void Parse(Document& document, const std::u16string& json) {
+        rapidjson::GenericStringStream<Encoding> stream(json.c_str());
+        document.ParseStream<PARSE_FLAGS, Encoding>(stream);
+    }
+
+    /// <summary> Widen a Latin-1 string, whose characters are the first 256 code points of UTF-16. </summary>
+    void WidenLatin1(const std::string& oneByte, std::u16string& payload) {
+        auto data = reinterpret_cast<const unsigned char*>(oneByte.data());
+        payload.assign(data, data + oneByte.size());
+    }
+
+    /// <summary> Get the JSON of a value in UTF-16, whichever string it's kept in. </summary>
+    bool GetPayload(const Store::ValueType& value, std::u16string& payload) {
+        if (value.IsCompressed()) {
+            std::string oneByte;
+            if (!value.Decompress(oneByte, payload)) {
+                return false;
+            }
+            if (!value.compressedTwoByte) {
+                WidenLatin1(oneByte, payload);
+            }
+            return true;
+        }
+        if (value.IsOneByte()) {
+            WidenLatin1(value.oneBytePayload, payload);
+            return true;
+        }
+        payload = value.payload;
+        return true;
+    }
+}
+
+bool napa::store::ApplyMergePatch(const Store::ValueType* target, const std::u16string& patch, Store::ValueType& result) {
+    Document patchDocument;
+    Parse(patchDocument, patch);
+    if (patchDocument.HasParseError()) {
+        return false;
+    }
+
+    Document document;
+    if (target != nullptr) {
+        std::u16string payload;
+        if (!GetPayload(*target, payload)) {
+            return false;
+        }
+        Parse(document, payload);
+        if (document.HasParseError()) {
+            return false;
+        }
+    }
+    if (!Merge(document, patchDocument, document.GetAllocator(), 0)) {
+        return false;
+    }
+
+    rapidjson::GenericStringBuffer<Encoding> buffer;
+    rapidjson::Writer<rapidjson::GenericStringBuffer<Encoding>, Encoding, Encoding> writer(buffer);
+    document.Accept(writer);
+
+    auto begin = buffer.GetString();
+    auto end = begin + buffer.GetLength();
+    if (std::all_of(begin, end, [](char16_t c) { return c <= 0xff; })) {
+        result.oneBytePayload.assign(begin, end);
+        result.payload.clear();
+    } else {
+        result.payload.assign(begin, end);
+        result.oneBytePayload.clear();
+    }
+    return true;
+}
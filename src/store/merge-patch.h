@@ -0,0 +1,20 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "store.h"
+
+#include <string>
+
+namespace napa {
+namespace store {
+
+    /// <summary> Apply a JSON merge patch (RFC 7386) to the payload of a value. </summary>
+    /// <param name="target"> The value to patch, nullptr to patch a missing value. It's not changed. </param>
+    /// <param name="patch"> JSON of the patch in UTF-16. Null members of objects remove members of the target. </param>
+    /// <param name="result"> Receives the patched payload, in Latin-1 if all its characters are, otherwise in UTF-16. </param>
+    /// <returns> False if the patch or the payload of the target is not valid JSON. </returns>
+    bool ApplyMergePatch(const Store::ValueType* target, const std::u16string& patch, Store::ValueType& result);
+}
+}
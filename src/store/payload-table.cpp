@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "payload-table.h"
+#include "store-helpers.h"
+
+#include <algorithm>
+#include <functional>
+#include <string>
+
+using namespace napa::store;
+
+namespace {
+
+    /// <summary> Kind of the string a payload is kept in, so equal bytes of different kinds don't match. </summary>
+    size_t GetPayloadKind(const Store::ValueType& value) {
+        if (value.IsCompressed()) {
+            return value.compressedTwoByte ? 3 : 2;
+        }
+        return value.IsOneByte() ? 1 : 0;
+    }
+
+    size_t HashPayload(const Store::ValueType& value) {
+        size_t hash = 0;
+        if (value.IsCompressed()) {
+            hash = std::hash<std::string>()(value.compressedPayload);
+        } else if (value.IsOneByte()) {
+            hash = std::hash<std::string>()(value.oneBytePayload);
+        } else {
+            hash = std::hash<std::u16string>()(value.payload);
+        }
+        return hash ^ GetPayloadKind(value);
+    }
+
+    bool PayloadEquals(const Store::ValueType& left, const Store::ValueType& right) {
+        if (GetPayloadKind(left) != GetPayloadKind(right)) {
+            return false;
+        }
+        if (left.IsCompressed()) {
+            return left.compressedPayload == right.compressedPayload;
+        }
+        return left.IsOneByte() ? left.oneBytePayload == right.oneBytePayload : left.payload == right.payload;
+    }
+}
+
+PayloadTable& PayloadTable::Get() {
+    static PayloadTable table;
+    return table;
+}
+
+std::shared_ptr<Store::ValueType> PayloadTable::Intern(std::shared_ptr<Store::ValueType> value) {
+    if (value->interned || value->transportContext.GetSharedCount() != 0) {
+        return value;
+    }
+
+    // Payloads are hashed before the lock is taken, only payloads of the same hash are compared under it.
+    auto hash = HashPayload(*value);
+
+    std::lock_guard<std::mutex> lock(_access);
+    auto& values = _values[hash];
+    for (auto it = values.begin(); it != values.end(); ) {
+        auto existing = it->lock();
+        if (existing == nullptr) {
+            it = values.erase(it);
+            --_size;
+            continue;
+        }
+        if (PayloadEquals(*existing, *value)) {
+            return existing;
+        }
+        ++it;
+    }
+
+    // The version stays with the payload, so readers can share what they unmarshalled from it across keys.
+    value->version = NextVersion();
+    value->interned = true;
+    values.emplace_back(value);
+    ++_size;
+    return value;
+}
+
+void PayloadTable::Sweep() {
+    std::lock_guard<std::mutex> lock(_access);
+    for (auto it = _values.begin(); it != _values.end(); ) {
+        auto& values = it->second;
+        auto end = std::remove_if(values.begin(), values.end(), [](const std::weak_ptr<Store::ValueType>& value) {
+            return value.expired();
+        });
+        _size -= static_cast<size_t>(values.end() - end);
+        values.erase(end, values.end());
+
+        if (values.empty()) {
+            it = _values.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+size_t PayloadTable::Size() const {
+    std::lock_guard<std::mutex> lock(_access);
+    return _size;
+}
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "store.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace napa {
+namespace store {
+
+    /// <summary> Payloads of interning stores by content, shared by all stores of the process. </summary>
+    /// <remarks>
+    /// The table holds values weakly, so a payload lives as long as an entry or a reader holds it, and the references
+    /// of payloads no longer held are dropped by the sweep of stores. Interned values are never changed afterwards.
+    /// </remarks>
+    class PayloadTable {
+    public:
+        /// <summary> Get the table of the process. </summary>
+        static PayloadTable& Get();
+
+        /// <summary> Get the interned value with the same payload, interning the value if there is none. </summary>
+        /// <param name="value"> A value to set, whose payload is kept as it is, compressed or not. </param>
+        /// <returns>
+        /// The interned value, or the value as it is if it has shared objects in its transport context,
+        /// whose payload only refers to them.
+        /// </returns>
+        std::shared_ptr<Store::ValueType> Intern(std::shared_ptr<Store::ValueType> value);
+
+        /// <summary> Drop references of payloads that are no longer held. </summary>
+        void Sweep();
+
+        /// <summary> Number of payloads in the table, including the ones not yet swept. </summary>
+        size_t Size() const;
+
+    private:
+        /// <summary> Values by hash of their payloads, values of different payloads may share a hash. </summary>
+        std::unordered_map<size_t, std::vector<std::weak_ptr<Store::ValueType>>> _values;
+
+        size_t _size = 0;
+
+        mutable std::mutex _access;
+    };
+}
+}
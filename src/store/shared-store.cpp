@@ -0,0 +1,734 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "shared-store.h"
+#include "load-table.h"
+#include "merge-patch.h"
+#include "store-helpers.h"
+
+#include <platform/shared-memory.h>
+#include <platform/tracepoint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace napa::store;
+
+namespace {
+
+    /// <summary> Magic stored by the creator of a segment once it's initialized. </summary>
+    constexpr uint32_t SEGMENT_MAGIC = 0x5453534e;
+
+    /// <summary> Version of the segment layout. </summary>
+    constexpr uint32_t SEGMENT_VERSION = 1;
+
+    /// <summary> Bytes of values of a segment if maxBytes is not given. </summary>
+    constexpr size_t DEFAULT_SEGMENT_BYTES = 64 * 1024 * 1024;
+
+    /// <summary> Bytes of values per slot of the hash table, which bounds the number of keys. </summary>
+    constexpr size_t BYTES_PER_SLOT = 256;
+
+    /// <summary> Longest name of a shared store, so it's a valid name of a segment on all platforms. </summary>
+    constexpr size_t MAX_NAME_LENGTH = 200;
+
+    /// <summary> Prefix of segment names, so they don't collide with segments of other programs. </summary>
+    constexpr const char* SEGMENT_NAME_PREFIX = "napa-store-";
+
+    /// <summary> Alignment of records in the heap of a segment. </summary>
+    constexpr size_t RECORD_ALIGNMENT = 8;
+
+    /// <summary> Longest time to wait for the creator of a segment to initialize it. </summary>
+    constexpr std::chrono::milliseconds INITIALIZE_TIMEOUT(1000);
+
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && sizeof(std::atomic<int64_t>) == sizeof(int64_t),
+        "Atomics in shared memory must be lock free, so processes can share them.");
+
+    /// <summary> Header of a segment, followed by the slots of the hash table and the heap of records. </summary>
+    /// <remarks> Locations in a segment are offsets from its start, since processes map it at different addresses. </remarks>
+    struct SegmentHeader {
+        /// <summary> SEGMENT_MAGIC once the creator initialized the segment. </summary>
+        std::atomic<uint32_t> magic;
+        uint32_t version;
+        uint64_t slotCount;
+        uint64_t heapBegin;
+        uint64_t heapEnd;
+
+        /// <summary> Offset of the first free byte of the heap, records are never freed. </summary>
+        std::atomic<uint64_t> heapTop;
+
+        /// <summary> Number of keys with values. </summary>
+        std::atomic<uint64_t> size;
+
+        /// <summary> Last version assigned to a value, shared by all processes. </summary>
+        std::atomic<uint64_t> lastVersion;
+
+        std::atomic<uint64_t> hits;
+        std::atomic<uint64_t> misses;
+        std::atomic<uint64_t> evictions;
+    };
+
+    /// <summary> A slot of the hash table, which belongs to one key forever once its hash is claimed. </summary>
+    struct Slot {
+        /// <summary> Hash of the key, 0 if the slot is free. </summary>
+        std::atomic<uint64_t> hash;
+
+        /// <summary> Offset of the key record, 0 until the process that claimed the slot wrote it. </summary>
+        std::atomic<uint64_t> keyOffset;
+
+        /// <summary> Offset of the value record, 0 if the key has no value. </summary>
+        std::atomic<uint64_t> valueOffset;
+    };
+
+    /// <summary> Record of a key, followed by its characters. </summary>
+    struct KeyRecord {
+        uint64_t length;
+    };
+
+    /// <summary> Kind of a value record. </summary>
+    enum class ValueKind : uint32_t {
+        Value = 0,
+        OneByteValue,
+        Integer,
+        Double
+    };
+
+    /// <summary> Record of a value, followed by its payload. Only the number changes once it's published. </summary>
+    struct ValueRecord {
+        ValueKind kind;
+        uint32_t reserved;
+
+        /// <summary> Milliseconds of the system clock since the Unix epoch when the value expires, 0 for never. </summary>
+        /// <remarks> Processes don't share a steady clock, so times to live follow the system clock. </remarks>
+        int64_t expireTime;
+
+        uint64_t version;
+
+        /// <summary> Number of characters of the payload, 0 for numbers. </summary>
+        uint64_t payloadLength;
+
+        /// <summary> The int64 number, or the bits of the double number. </summary>
+        std::atomic<int64_t> number;
+
+        bool IsNumber() const {
+            return kind == ValueKind::Integer || kind == ValueKind::Double;
+        }
+    };
+
+    size_t AlignUp(size_t offset, size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    /// <summary> Current time in milliseconds of the system clock, which expiration times are based on. </summary>
+    int64_t Now() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    /// <summary> Store in a segment of named shared memory, a lock-free hash table of keys over an append-only heap. </summary>
+    /// <remarks>
+    /// Records are published by swapping their offsets into slots, so readers in any process see either the old or
+    /// the new record. Replaced records are not freed, since another process may still read them.
+    /// </remarks>
+    class SharedStore : public Store {
+    public:
+        /// <summary> Open the segment of a store, or create and initialize it. </summary>
+        static std::shared_ptr<Store> Open(const char* id, const StoreOptions& options) {
+            std::string name(id + std::strlen(SHARED_STORE_PREFIX));
+            if (name.empty() || name.size() > MAX_NAME_LENGTH || name.find_first_of("/\\") != std::string::npos) {
+                return nullptr;
+            }
+
+            auto bytes = options.maxBytes == 0 ? DEFAULT_SEGMENT_BYTES : options.maxBytes;
+            auto slotCount = std::max<size_t>(bytes / BYTES_PER_SLOT, 1);
+            auto heapBegin = AlignUp(sizeof(SegmentHeader) + slotCount * sizeof(Slot), RECORD_ALIGNMENT);
+            std::unique_ptr<napa::platform::SharedMemory> memory(
+                new napa::platform::SharedMemory(SEGMENT_NAME_PREFIX + name, heapBegin + bytes));
+            if (!memory->IsOpen() || memory->Size() < sizeof(SegmentHeader)) {
+                return nullptr;
+            }
+
+            // Segments are zero-filled when they are created, which is an empty hash table.
+            auto header = static_cast<SegmentHeader*>(memory->Data());
+            if (memory->IsCreated()) {
+                header->version = SEGMENT_VERSION;
+                header->slotCount = slotCount;
+                header->heapBegin = heapBegin;
+                header->heapEnd = memory->Size();
+                header->heapTop.store(heapBegin);
+                header->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+            } else {
+                auto deadline = std::chrono::steady_clock::now() + INITIALIZE_TIMEOUT;
+                while (header->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC) {
+                    if (std::chrono::steady_clock::now() >= deadline) {
+                        return nullptr;
+                    }
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                if (header->version != SEGMENT_VERSION
+                    || header->heapEnd > memory->Size()
+                    || header->heapBegin < sizeof(SegmentHeader) + header->slotCount * sizeof(Slot)) {
+                    return nullptr;
+                }
+            }
+            return std::make_shared<SharedStore>(id, options, std::move(memory));
+        }
+
+        SharedStore(const char* id, const StoreOptions& options, std::unique_ptr<napa::platform::SharedMemory> memory)
+            : _id(id),
+              _options(options),
+              _memory(std::move(memory)),
+              _base(static_cast<char*>(_memory->Data())),
+              _header(static_cast<SegmentHeader*>(_memory->Data())),
+              _slots(reinterpret_cast<Slot*>(_base + sizeof(SegmentHeader))) {
+            _options.shards = 1;
+            _options.maxBytes = static_cast<size_t>(_header->heapEnd - _header->heapBegin);
+        }
+
+        const char* GetId() const override {
+            return _id.c_str();
+        }
+
+        const StoreOptions& GetOptions() const override {
+            return _options;
+        }
+
+        void Set(const char* key, std::shared_ptr<ValueType> value) override {
+            Set(key, std::move(value), 0);
+        }
+
+        void Set(const char* key, std::shared_ptr<ValueType> value, uint32_t ttl) override {
+            NAPA_TRACEPOINT3(store__set, "store", _id.c_str(), "key", key, "bytes", value->GetPayloadBytes());
+            if (SetValue(key, *value, ttl)) {
+                Notify(key);
+            }
+        }
+
+        std::shared_ptr<ValueType> Get(const char* key) const override {
+            auto record = FindValue(key);
+            NAPA_TRACEPOINT3(store__get, "store", _id.c_str(), "key", key, "found", record != nullptr ? 1 : 0);
+            if (record == nullptr) {
+                _header->misses.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            _header->hits.fetch_add(1, std::memory_order_relaxed);
+            return ToValue(*record);
+        }
+
+        void SetMany(const EntryList& entries, uint32_t ttl) override {
+            for (auto& entry : entries) {
+                if (SetValue(entry.first, *entry.second, ttl)) {
+                    Notify(entry.first);
+                }
+            }
+        }
+
+        std::vector<std::shared_ptr<ValueType>> GetMany(const std::vector<std::string>& keys) const override {
+            std::vector<std::shared_ptr<ValueType>> values;
+            values.reserve(keys.size());
+            for (auto& key : keys) {
+                values.emplace_back(Get(key.c_str()));
+            }
+            return values;
+        }
+
+        /// <remarks> Keys are scanned and sorted, other processes may change keys during the scan. </remarks>
+        std::vector<std::string> Keys(const char* prefix) const override {
+            std::vector<std::string> keys;
+            std::string keyPrefix(prefix);
+            Scan([&keyPrefix](const std::string& key) { return key.compare(0, keyPrefix.size(), keyPrefix) == 0; },
+                [&keys](std::string key, const ValueRecord&) { keys.emplace_back(std::move(key)); });
+            std::sort(keys.begin(), keys.end());
+            return keys;
+        }
+
+        /// <remarks> Keys are scanned and sorted, other processes may change keys during the scan. </remarks>
+        EntryList Range(const char* from, const char* to) const override {
+            EntryList entries;
+            std::string lowerBound(from);
+            std::string upperBound(to);
+            Scan([&lowerBound, &upperBound](const std::string& key) {
+                    return key >= lowerBound && (upperBound.empty() || key < upperBound);
+                },
+                [this, &entries](std::string key, const ValueRecord& record) {
+                    entries.emplace_back(std::move(key), ToValue(record));
+                });
+            std::sort(entries.begin(), entries.end(), [](const EntryList::value_type& left, const EntryList::value_type& right) {
+                return left.first < right.first;
+            });
+            return entries;
+        }
+
+        /// <remarks> The patched record replaces the record it was patched from, unless another process replaced it first. </remarks>
+        bool Patch(const char* key, const std::u16string& patch) override {
+            auto slot = FindSlot(key, true);
+            if (slot == nullptr) {
+                return false;
+            }
+            while (true) {
+                auto offset = slot->valueOffset.load(std::memory_order_acquire);
+                std::shared_ptr<ValueType> current;
+                int64_t expireTime = 0;
+                if (offset != 0 && !IsExpired(*At<ValueRecord>(offset))) {
+                    auto& record = *At<ValueRecord>(offset);
+                    if (record.IsNumber()) {
+                        return false;
+                    }
+                    current = ToValue(record);
+                    expireTime = record.expireTime;
+                }
+
+                ValueType value;
+                if (!ApplyMergePatch(current.get(), patch, value)) {
+                    return false;
+                }
+                auto created = value.IsOneByte()
+                    ? AllocateValue(ValueKind::OneByteValue, expireTime, value.oneBytePayload.data(), value.oneBytePayload.size(), 0)
+                    : AllocateValue(ValueKind::Value, expireTime, value.payload.data(), value.payload.size(), 0);
+                if (created == 0) {
+                    _header->evictions.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                if (slot->valueOffset.compare_exchange_strong(offset, created, std::memory_order_acq_rel)) {
+                    if (offset == 0) {
+                        _header->size.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    Notify(key);
+                    return true;
+                }
+                // Another writer replaced the record, the record created is left unused.
+            }
+        }
+
+        /// <remarks> Records are published in place without sequence numbers, so shared stores have no views. </remarks>
+        std::shared_ptr<View> CreateView() const override {
+            return nullptr;
+        }
+
+        /// <remarks> The loader and loads are of this process, other processes load the keys they miss themselves. </remarks>
+        void SetLoader(
+            const std::string& moduleName,
+            const std::string& functionName,
+            uint32_t ttl,
+            uint32_t waitTimeout) override {
+            _loads.SetLoader(moduleName, functionName, ttl, waitTimeout);
+        }
+
+        bool GetLoader(std::string& moduleName, std::string& functionName, uint32_t& ttl) const override {
+            return _loads.GetLoader(moduleName, functionName, ttl);
+        }
+
+        LoadStatus BeginLoad(const char* key, std::shared_ptr<ValueType>& value, std::string& error) override {
+            return _loads.Begin(key, value, error);
+        }
+
+        void EndLoad(const char* key, std::shared_ptr<ValueType> value, const std::string& error) override {
+            _loads.End(key, std::move(value), error);
+        }
+
+        bool Increment(const char* key, int64_t delta, int64_t& result) override {
+            auto updated = UpdateNumber(key, false, [delta, &result](ValueRecord& record) {
+                if (record.kind != ValueKind::Integer) {
+                    return false;
+                }
+                result = record.number.fetch_add(delta) + delta;
+                return true;
+            });
+            if (updated) {
+                Notify(key);
+            }
+            return updated;
+        }
+
+        bool Add(const char* key, double delta, double& result) override {
+            auto updated = UpdateNumber(key, true, [delta, &result](ValueRecord& record) {
+                if (record.kind == ValueKind::Integer) {
+                    if (!IsSafeInteger(delta)) {
+                        return false;
+                    }
+                    auto integerDelta = static_cast<int64_t>(delta);
+                    result = static_cast<double>(record.number.fetch_add(integerDelta) + integerDelta);
+                    return true;
+                }
+
+                auto bits = record.number.load();
+                while (!record.number.compare_exchange_weak(bits, DoubleToBits(BitsToDouble(bits) + delta))) {}
+                result = BitsToDouble(bits) + delta;
+                return true;
+            });
+            if (updated) {
+                Notify(key);
+            }
+            return updated;
+        }
+
+        bool CompareAndSet(const char* key, double expected, double desired) override {
+            auto record = FindValue(key);
+            if (record == nullptr || !record->IsNumber()) {
+                return false;
+            }
+
+            auto replaced = false;
+            if (record->kind == ValueKind::Integer) {
+                if (IsSafeInteger(expected) && IsSafeInteger(desired)) {
+                    auto bits = static_cast<int64_t>(expected);
+                    replaced = record->number.compare_exchange_strong(bits, static_cast<int64_t>(desired));
+                }
+            } else {
+                // Numbers are compared by value rather than by bits, so 0 equals -0.
+                auto bits = record->number.load();
+                while (!replaced && BitsToDouble(bits) == expected) {
+                    replaced = record->number.compare_exchange_weak(bits, DoubleToBits(desired));
+                }
+            }
+            if (replaced) {
+                Notify(key);
+            }
+            return replaced;
+        }
+
+        bool GetNumber(const char* key, double& value) const override {
+            auto record = FindValue(key);
+            if (record == nullptr || !record->IsNumber()) {
+                return false;
+            }
+            auto bits = record->number.load();
+            value = record->kind == ValueKind::Double ? BitsToDouble(bits) : static_cast<double>(bits);
+            return true;
+        }
+
+        /// <remarks> The segment keeps the values while the host runs, so shared stores are not snapshotted. </remarks>
+        bool Snapshot(const char*, size_t& saved) const override {
+            saved = 0;
+            return false;
+        }
+
+        bool Load(const char*, size_t& loaded) override {
+            loaded = 0;
+            return false;
+        }
+
+        bool Has(const char* key) const override {
+            return FindValue(key) != nullptr;
+        }
+
+        void Delete(const char* key) override {
+            auto slot = FindSlot(key, false);
+            if (slot == nullptr || slot->valueOffset.exchange(0, std::memory_order_acq_rel) == 0) {
+                return;
+            }
+            _header->size.fetch_sub(1, std::memory_order_relaxed);
+            Notify(key);
+        }
+
+        /// <remarks> Only changes made by the current process are notified. </remarks>
+        uint64_t Watch(const char* pattern, WatchCallback callback) override {
+            Watcher watcher;
+            watcher.id = NextWatchId();
+            watcher.prefix = pattern;
+            watcher.isPrefix = !watcher.prefix.empty() && watcher.prefix.back() == '*';
+            if (watcher.isPrefix) {
+                watcher.prefix.pop_back();
+            }
+            watcher.callback = std::move(callback);
+
+            std::lock_guard<std::mutex> lock(_watchersAccess);
+            _watchers.emplace_back(std::move(watcher));
+            return _watchers.back().id;
+        }
+
+        void Unwatch(uint64_t watchId) override {
+            std::lock_guard<std::mutex> lock(_watchersAccess);
+            _watchers.erase(
+                std::remove_if(_watchers.begin(), _watchers.end(), [watchId](const Watcher& watcher) {
+                    return watcher.id == watchId;
+                }),
+                _watchers.end());
+        }
+
+        /// <remarks> Expired values count until they are replaced or deleted. </remarks>
+        size_t Size() const override {
+            return static_cast<size_t>(_header->size.load(std::memory_order_relaxed));
+        }
+
+        StoreStatistics GetStatistics() const override {
+            StoreStatistics statistics = {};
+            statistics.hits = _header->hits.load(std::memory_order_relaxed);
+            statistics.misses = _header->misses.load(std::memory_order_relaxed);
+            statistics.evictions = _header->evictions.load(std::memory_order_relaxed);
+            statistics.bytes = static_cast<size_t>(_header->heapTop.load(std::memory_order_relaxed) - _header->heapBegin);
+            statistics.payloadBytes = statistics.bytes;
+            statistics.loads = _loads.GetLoads();
+            statistics.loadWaits = _loads.GetWaits();
+            return statistics;
+        }
+
+    private:
+        /// <summary> A watch of a key, or of keys with a prefix. </summary>
+        struct Watcher {
+            uint64_t id;
+            std::string prefix;
+            bool isPrefix;
+            WatchCallback callback;
+        };
+
+        template <typename T>
+        T* At(uint64_t offset) const {
+            return reinterpret_cast<T*>(_base + offset);
+        }
+
+        /// <summary> Allocate bytes from the heap. </summary>
+        /// <returns> Offset of the bytes, 0 if the heap is full. </returns>
+        uint64_t Allocate(size_t bytes) const {
+            bytes = AlignUp(bytes, RECORD_ALIGNMENT);
+            auto top = _header->heapTop.load(std::memory_order_relaxed);
+            do {
+                if (_header->heapEnd - top < bytes) {
+                    return 0;
+                }
+            } while (!_header->heapTop.compare_exchange_weak(top, top + bytes, std::memory_order_relaxed));
+            return top;
+        }
+
+        /// <summary> Write a key record to the heap. </summary>
+        /// <returns> Offset of the record, 0 if the heap is full. </returns>
+        uint64_t AllocateKey(const std::string& key) const {
+            auto offset = Allocate(sizeof(KeyRecord) + key.size());
+            if (offset != 0) {
+                auto record = At<KeyRecord>(offset);
+                record->length = key.size();
+                std::memcpy(record + 1, key.data(), key.size());
+            }
+            return offset;
+        }
+
+        /// <summary> Write a value record to the heap. </summary>
+        /// <param name="number"> The int64 number, or the bits of the double number. </param>
+        /// <returns> Offset of the record, 0 if the heap is full. </returns>
+        uint64_t AllocateValue(ValueKind kind, int64_t expireTime, const void* payload, size_t payloadLength, int64_t number) const {
+            auto charSize = kind == ValueKind::Value ? sizeof(char16_t) : sizeof(char);
+            auto offset = Allocate(sizeof(ValueRecord) + payloadLength * charSize);
+            if (offset != 0) {
+                auto record = new (At<ValueRecord>(offset)) ValueRecord();
+                record->kind = kind;
+                record->expireTime = expireTime;
+                record->version = ++_header->lastVersion;
+                record->payloadLength = payloadLength;
+                record->number.store(number);
+                if (payloadLength != 0) {
+                    // ValueRecord holds an atomic, the payload is addressed in bytes rather than as a record.
+                    std::memcpy(reinterpret_cast<char*>(record) + sizeof(ValueRecord), payload, payloadLength * charSize);
+                }
+            }
+            return offset;
+        }
+
+        /// <summary> Find the slot of a key, or claim a free slot for it. </summary>
+        /// <returns> The slot, nullptr if the key is not found, or the table or heap is full when claiming. </returns>
+        Slot* FindSlot(const std::string& key, bool claim) const {
+            auto hash = HashKey(key.c_str());
+            if (hash == 0) {
+                hash = 1;
+            }
+
+            // The key record is written before a slot is claimed, and reused if another process claims it first.
+            uint64_t keyOffset = 0;
+            auto slotCount = _header->slotCount;
+            for (uint64_t probe = 0; probe < slotCount; ++probe) {
+                auto& slot = _slots[(hash + probe) % slotCount];
+                auto slotHash = slot.hash.load(std::memory_order_acquire);
+                if (slotHash == 0) {
+                    if (!claim) {
+                        return nullptr;
+                    }
+                    if (keyOffset == 0 && (keyOffset = AllocateKey(key)) == 0) {
+                        return nullptr;
+                    }
+                    if (slot.hash.compare_exchange_strong(slotHash, hash, std::memory_order_acq_rel)) {
+                        slot.keyOffset.store(keyOffset, std::memory_order_release);
+                        return &slot;
+                    }
+                }
+                if (slotHash == hash && GetKey(slot) == key) {
+                    return &slot;
+                }
+            }
+            return nullptr;
+        }
+
+        /// <summary> Get the key of a claimed slot. </summary>
+        std::string GetKey(const Slot& slot) const {
+            // The key is written right after the slot is claimed.
+            uint64_t keyOffset;
+            while ((keyOffset = slot.keyOffset.load(std::memory_order_acquire)) == 0) {
+                std::this_thread::yield();
+            }
+            auto record = At<KeyRecord>(keyOffset);
+            return std::string(reinterpret_cast<const char*>(record + 1), static_cast<size_t>(record->length));
+        }
+
+        /// <summary> Find the value record of a key, nullptr if it has no value or the value expired. </summary>
+        ValueRecord* FindValue(const std::string& key) const {
+            auto slot = FindSlot(key, false);
+            if (slot == nullptr) {
+                return nullptr;
+            }
+            auto offset = slot->valueOffset.load(std::memory_order_acquire);
+            if (offset == 0 || IsExpired(*At<ValueRecord>(offset))) {
+                return nullptr;
+            }
+            return At<ValueRecord>(offset);
+        }
+
+        static bool IsExpired(const ValueRecord& record) {
+            return record.expireTime != 0 && record.expireTime <= Now();
+        }
+
+        /// <summary> Publish a value record in a slot. </summary>
+        void Publish(Slot& slot, uint64_t offset) const {
+            if (slot.valueOffset.exchange(offset, std::memory_order_acq_rel) == 0) {
+                _header->size.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        /// <summary> Copy a value into the segment and publish it. </summary>
+        /// <returns> False if the value was dropped. </returns>
+        bool SetValue(const std::string& key, ValueType& value, uint32_t ttl) {
+            auto slot = value.transportContext.GetSharedCount() == 0 ? FindSlot(key, true) : nullptr;
+            uint64_t offset = 0;
+            if (slot != nullptr) {
+                auto expireTime = ttl == 0 ? 0 : Now() + ttl;
+                offset = value.IsOneByte()
+                    ? AllocateValue(ValueKind::OneByteValue, expireTime, value.oneBytePayload.data(), value.oneBytePayload.size(), 0)
+                    : AllocateValue(ValueKind::Value, expireTime, value.payload.data(), value.payload.size(), 0);
+            }
+            if (offset == 0) {
+                _header->evictions.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            value.version = At<ValueRecord>(offset)->version;
+            Publish(*slot, offset);
+            return true;
+        }
+
+        /// <summary> Copy a value record out of the segment. </summary>
+        std::shared_ptr<ValueType> ToValue(const ValueRecord& record) const {
+            if (record.IsNumber()) {
+                return MarshallNumber(record.kind == ValueKind::Double, record.number.load());
+            }
+
+            auto value = std::make_shared<ValueType>();
+            value->version = record.version;
+            auto length = static_cast<size_t>(record.payloadLength);
+            auto payload = reinterpret_cast<const char*>(&record) + sizeof(ValueRecord);
+            if (record.kind == ValueKind::OneByteValue) {
+                value->oneBytePayload.assign(payload, length);
+            } else {
+                value->payload.assign(reinterpret_cast<const char16_t*>(payload), length);
+            }
+            return value;
+        }
+
+        /// <summary> Update a number in place, or create it if the key has no value. </summary>
+        /// <param name="isDouble"> Whether a number created is a double. </param>
+        /// <param name="update"> Updates the number record, returns false if the update doesn't apply to it. </param>
+        template <typename Update>
+        bool UpdateNumber(const char* key, bool isDouble, Update update) {
+            auto slot = FindSlot(key, true);
+            if (slot == nullptr) {
+                return false;
+            }
+            while (true) {
+                auto offset = slot->valueOffset.load(std::memory_order_acquire);
+                if (offset != 0 && !IsExpired(*At<ValueRecord>(offset))) {
+                    auto& record = *At<ValueRecord>(offset);
+                    return record.IsNumber() && update(record);
+                }
+
+                auto created = AllocateValue(
+                    isDouble ? ValueKind::Double : ValueKind::Integer, 0, nullptr, 0, isDouble ? DoubleToBits(0.0) : 0);
+                if (created == 0) {
+                    _header->evictions.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                if (slot->valueOffset.compare_exchange_strong(offset, created, std::memory_order_acq_rel)) {
+                    if (offset == 0) {
+                        _header->size.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    return update(*At<ValueRecord>(created));
+                }
+                // Another writer set the key first, the record created is left unused.
+            }
+        }
+
+        /// <summary> Visit keys with values that are not expired, in the order of slots. </summary>
+        template <typename Filter, typename Visit>
+        void Scan(Filter filter, Visit visit) const {
+            for (uint64_t i = 0; i < _header->slotCount; ++i) {
+                auto& slot = _slots[i];
+                if (slot.hash.load(std::memory_order_acquire) == 0) {
+                    continue;
+                }
+                auto offset = slot.valueOffset.load(std::memory_order_acquire);
+                if (offset == 0 || IsExpired(*At<ValueRecord>(offset))) {
+                    continue;
+                }
+                auto key = GetKey(slot);
+                if (filter(key)) {
+                    visit(std::move(key), *At<ValueRecord>(offset));
+                }
+            }
+        }
+
+        /// <summary> Call watchers of a key changed by this process, without the lock held. </summary>
+        void Notify(const std::string& key) const {
+            std::vector<WatchCallback> callbacks;
+            {
+                std::lock_guard<std::mutex> lock(_watchersAccess);
+                for (auto& watcher : _watchers) {
+                    if (watcher.isPrefix ? key.compare(0, watcher.prefix.size(), watcher.prefix) == 0 : key == watcher.prefix) {
+                        callbacks.push_back(watcher.callback);
+                    }
+                }
+            }
+            for (auto& callback : callbacks) {
+                callback(key);
+            }
+        }
+
+        /// <summary> ID. Case sensitive. </summary>
+        std::string _id;
+
+        /// <summary> Options, with maxBytes of the segment. </summary>
+        StoreOptions _options;
+
+        /// <summary> The mapped segment. </summary>
+        std::unique_ptr<napa::platform::SharedMemory> _memory;
+        char* _base;
+        SegmentHeader* _header;
+        Slot* _slots;
+
+        /// <summary> Watchers of changes made by this process. </summary>
+        std::vector<Watcher> _watchers;
+        mutable std::mutex _watchersAccess;
+
+        /// <summary> The loader of missing keys, and their loads in flight in this process. </summary>
+        LoadTable _loads;
+    };
+}
+
+namespace napa {
+namespace store {
+
+    std::shared_ptr<Store> CreateSharedStore(const char* id, const StoreOptions& options) {
+        return SharedStore::Open(id, options);
+    }
+} // namespace store
+} // namespace napa
@@ -0,0 +1,19 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "store.h"
+
+#include <memory>
+
+namespace napa {
+namespace store {
+
+    /// <summary> Open or create a store in named shared memory. </summary>
+    /// <param name="id"> Id of the store, starting with SHARED_STORE_PREFIX. </summary>
+    /// <param name="options"> Options of the store, maxBytes sizes the segment if it's created. </summary>
+    /// <returns> The store, or nullptr if the name is not valid or the segment can't be mapped. </returns>
+    std::shared_ptr<Store> CreateSharedStore(const char* id, const StoreOptions& options);
+}
+}
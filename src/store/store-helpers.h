@@ -0,0 +1,34 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "store.h"
+
+#include <cstdint>
+#include <memory>
+
+namespace napa {
+namespace store {
+
+    /// <summary> Hashes a key with FNV-1a, which is the same in all processes. </summary>
+    uint64_t HashKey(const char* key);
+
+    /// <summary> Get a new version of a value, unique across stores in the process. </summary>
+    uint64_t NextVersion();
+
+    /// <summary> Get a new watch id, unique across stores in the process. </summary>
+    uint64_t NextWatchId();
+
+    /// <summary> Whether a double is an integer an int64 number can take without losing precision. </summary>
+    bool IsSafeInteger(double value);
+
+    int64_t DoubleToBits(double value);
+
+    double BitsToDouble(int64_t bits);
+
+    /// <summary> Marshall a number into a value of its JSON payload. </summary>
+    /// <param name="number"> The int64 number, or the bits of the double number. </param>
+    std::shared_ptr<Store::ValueType> MarshallNumber(bool isDouble, int64_t number);
+}
+}
@@ -2,19 +2,124 @@
 // Licensed under the MIT license.
 
 #include "store.h"
+#include "store-helpers.h"
+#include "load-table.h"
+#include "merge-patch.h"
+#include "payload-table.h"
+#include "shared-store.h"
 
 #include <napa/memory.h>
+#include <napa/providers/metric.h>
+#include <platform/filesystem.h>
+#include <platform/tracepoint.h>
+#include <utils/payload-compression.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <mutex>
+#include <set>
+#include <shared_mutex>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 using namespace napa::store;
 
-class StoreImpl: public Store {
+namespace {
+
+    constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+    constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+    /// <summary> Interval of sweeping expired values and reporting metrics of stores. </summary>
+    constexpr std::chrono::seconds SWEEP_INTERVAL(1);
+
+    /// <summary> Last version assigned to a value, shared by all stores so a version never repeats. </summary>
+    std::atomic<uint64_t> _lastVersion(0);
+
+    /// <summary> Last id assigned to a watch, shared by all stores so a watch id is unique in the process. </summary>
+    std::atomic<uint64_t> _lastWatchId(0);
+
+    /// <summary> Largest integer that a double holds exactly. </summary>
+    constexpr double MAX_SAFE_INTEGER = 9007199254740991.0;
+
+    /// <summary> Magic at the start of store snapshot files. </summary>
+    constexpr char SNAPSHOT_MAGIC[8] = { 'N', 'A', 'P', 'A', 'S', 'N', 'A', 'P' };
+
+    /// <summary> Version of the snapshot file format. </summary>
+    /// <remarks> Version 2 added one-byte values, files of version 1 are still loaded. </remarks>
+    constexpr uint32_t SNAPSHOT_VERSION = 2;
+
+    /// <summary> Alignment of entries in snapshot files, so a mapped file can be read in place. </summary>
+    constexpr size_t SNAPSHOT_ALIGNMENT = 8;
+
+    /// <summary> Header of a snapshot file, followed by its entries. </summary>
+    /// <remarks> Snapshots are in the byte order of the machine that writes them. </remarks>
+    struct SnapshotHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t count;
+    };
+
+    /// <summary> Kind of an entry in a snapshot file. </summary>
+    enum class SnapshotEntryKind : uint32_t {
+        Value = 0,
+        Integer,
+        Double,
+        OneByteValue
+    };
+
+    /// <summary> Header of an entry in a snapshot file. </summary>
+    /// <remarks>
+    /// It's followed by the key, the payload, and padding to the next entry.
+    /// UTF-16 payloads are aligned to 2 bytes, Latin-1 payloads of one-byte values follow the key.
+    /// </remarks>
+    struct SnapshotEntryHeader {
+        uint32_t keyLength;
+        SnapshotEntryKind kind;
+
+        /// <summary> Number of characters of the payload, 0 for numbers. </summary>
+        uint64_t payloadLength;
+
+        /// <summary> The int64 number, or the bits of the double number. </summary>
+        int64_t number;
+
+        /// <summary> Remaining time to live in milliseconds, 0 for never expiring. </summary>
+        uint32_t ttl;
+        uint32_t reserved;
+    };
+
+    /// <summary> Bytes of a payload character of an entry kind. </summary>
+    size_t GetSnapshotCharSize(SnapshotEntryKind kind) {
+        return kind == SnapshotEntryKind::OneByteValue ? sizeof(char) : sizeof(char16_t);
+    }
+
+    size_t AlignUp(size_t offset, size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+    /// <summary> Current time in nanoseconds of the steady clock, which expiration times are based on. </summary>
+    int64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+class StoreImpl: public Store, public std::enable_shared_from_this<StoreImpl> {
 public:
     /// <summary> Constructor. </summary>
-    explicit StoreImpl(const char* id)
-        : _id(id) {
+    StoreImpl(const char* id, const StoreOptions& options)
+        : _id(id),
+          _options(options),
+          _shards(std::min(std::max(options.shards, 1u), MAX_STORE_SHARDS)) {
+        _options.shards = static_cast<uint32_t>(_shards.size());
+        _shardBudget = _options.maxBytes == 0 ? 0 : std::max<size_t>(_options.maxBytes / _shards.size(), 1);
     }
 
     /// <summary> Get ID of this store. </summary>
@@ -22,87 +127,1287 @@ public:
         return _id.c_str();
     }
 
+    /// <summary> Get options the store was created with. </summary>
+    const StoreOptions& GetOptions() const override {
+        return _options;
+    }
+
     /// <summary> Set value with a key. </summary>
     /// <param name="key"> Case-sensitive key to set. </param>
     /// <param name="value"> A shared pointer of ValueType,
     /// which is composed by a pair of payload and transport context. </returns>
     void Set(const char* key, std::shared_ptr<Store::ValueType> value) override {
-        std::lock_guard<std::mutex> lock(_storeAccess);
-        auto it = _valueMap.find(key);
-        if (it != _valueMap.end()) {
-            it->second = std::move(value);
-        } else {
-            _valueMap.emplace(std::string(key), std::move(value));
+        Set(key, std::move(value), 0);
+    }
+
+    /// <summary> Set value with a key, which expires after a time to live. </summary>
+    /// <param name="key"> Case-sensitive key to set. </param>
+    /// <param name="value"> A shared pointer of ValueType. </param>
+    /// <param name="ttl"> Time to live in milliseconds, 0 for never expiring. </param>
+    void Set(const char* key, std::shared_ptr<Store::ValueType> value, uint32_t ttl) override {
+        NAPA_TRACEPOINT3(store__set, "store", _id.c_str(), "key", key, "bytes", value->GetPayloadBytes());
+        value = Intern(std::move(value));
+        auto expireTime = GetExpireTime(ttl);
+        auto& shard = GetShard(key);
+        {
+            auto lock = LockForWrite(shard);
+            SetLocked(shard, key, std::move(value), expireTime);
         }
+        Notify(key);
     }
 
     /// <summary> Get value by a key. </summary>
     /// <param name="key"> Case-sensitive key to get. </param>
     /// <returns> A ValueType shared pointer, empty if not found. </returns>
     std::shared_ptr<ValueType> Get(const char* key) const override {
-        std::lock_guard<std::mutex> lock(_storeAccess);
-        auto it = _valueMap.find(key);
-        if (it != _valueMap.end()) {
-            return it->second;
+        auto& shard = GetShard(key);
+        std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+        auto value = GetLocked(shard, key, Now());
+        NAPA_TRACEPOINT3(store__get, "store", _id.c_str(), "key", key, "found", value != nullptr ? 1 : 0);
+        return value;
+    }
+
+    /// <summary> Set many values, taking the lock of each shard once. </summary>
+    void SetMany(const EntryList& entries, uint32_t ttl) override {
+        auto expireTime = GetExpireTime(ttl);
+        ForEachShard(_shards, entries.size(), [&entries](size_t i) { return entries[i].first.c_str(); },
+            [this, &entries, expireTime](Shard& shard, const std::vector<size_t>& indices) {
+                std::vector<std::shared_ptr<Store::ValueType>> values;
+                values.reserve(indices.size());
+                for (auto i : indices) {
+                    values.emplace_back(Intern(entries[i].second));
+                }
+                {
+                    auto lock = LockForWrite(shard);
+                    for (size_t j = 0; j < indices.size(); ++j) {
+                        SetLocked(shard, entries[indices[j]].first, std::move(values[j]), expireTime);
+                    }
+                }
+                for (auto i : indices) {
+                    Notify(entries[i].first);
+                }
+            });
+    }
+
+    /// <summary> Get many values, taking the lock of each shard once. </summary>
+    std::vector<std::shared_ptr<ValueType>> GetMany(const std::vector<std::string>& keys) const override {
+        std::vector<std::shared_ptr<ValueType>> values(keys.size());
+        auto now = Now();
+        ForEachShard(_shards, keys.size(), [&keys](size_t i) { return keys[i].c_str(); },
+            [&keys, &values, now](const Shard& shard, const std::vector<size_t>& indices) {
+                std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+                for (auto i : indices) {
+                    values[i] = GetLocked(shard, keys[i], now);
+                }
+            });
+        return values;
+    }
+
+    /// <summary> Get keys with a prefix, in order. </summary>
+    std::vector<std::string> Keys(const char* prefix) const override {
+        std::vector<std::string> keys;
+        std::string keyPrefix(prefix);
+        Scan(keyPrefix,
+            [&keyPrefix](const std::string& key) { return key.compare(0, keyPrefix.size(), keyPrefix) == 0; },
+            [&keys](const std::string& key, const Entry&) { keys.push_back(key); });
+        return keys;
+    }
+
+    /// <summary> Get keys and values in a range of keys, in order. </summary>
+    EntryList Range(const char* from, const char* to) const override {
+        EntryList entries;
+        std::string upperBound(to);
+        Scan(from,
+            [&upperBound](const std::string& key) { return upperBound.empty() || key < upperBound; },
+            [&entries](const std::string& key, const Entry& entry) {
+                entries.emplace_back(key, entry.value != nullptr ? entry.value : MarshallNumber(entry.isDouble, entry.number.load()));
+            });
+        return entries;
+    }
+
+    /// <summary> Apply a JSON merge patch to the value of a key atomically. </summary>
+    bool Patch(const char* key, const std::u16string& patch) override {
+        auto& shard = GetShard(key);
+        while (true) {
+            std::shared_ptr<Store::ValueType> current;
+            {
+                std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+                auto it = shard.valueMap.find(key);
+                if (it != shard.valueMap.end() && !it->second.IsExpired(Now())) {
+                    if (it->second.value == nullptr) {
+                        return false;
+                    }
+                    current = it->second.value;
+                }
+            }
+            if (current != nullptr && current->transportContext.GetSharedCount() != 0) {
+                return false;
+            }
+
+            // Large values are parsed and written without the lock, so readers of the shard don't wait for them.
+            auto value = std::make_shared<Store::ValueType>();
+            if (!ApplyMergePatch(current.get(), patch, *value)) {
+                return false;
+            }
+            value->Compress(_options.compressionThreshold);
+            value = Intern(std::move(value));
+
+            {
+                auto lock = LockForWrite(shard);
+                auto it = shard.valueMap.find(key);
+                auto exists = it != shard.valueMap.end() && !it->second.IsExpired(Now());
+                if (exists ? it->second.value != current : current != nullptr) {
+                    // Set by another writer after the value was read.
+                    continue;
+                }
+                SetLocked(shard, key, std::move(value), exists ? it->second.expireTime : 0);
+            }
+            Notify(key);
+            return true;
         }
-        return nullptr;
+    }
+
+    /// <summary> Create a consistent read view of this store. </summary>
+    std::shared_ptr<View> CreateView() const override {
+        return std::make_shared<ViewImpl>(shared_from_this());
+    }
+
+    void SetLoader(const std::string& moduleName, const std::string& functionName, uint32_t ttl, uint32_t waitTimeout) override {
+        _loads.SetLoader(moduleName, functionName, ttl, waitTimeout);
+    }
+
+    bool GetLoader(std::string& moduleName, std::string& functionName, uint32_t& ttl) const override {
+        return _loads.GetLoader(moduleName, functionName, ttl);
+    }
+
+    LoadStatus BeginLoad(const char* key, std::shared_ptr<Store::ValueType>& value, std::string& error) override {
+        return _loads.Begin(key, value, error);
+    }
+
+    void EndLoad(const char* key, std::shared_ptr<Store::ValueType> value, const std::string& error) override {
+        _loads.End(key, std::move(value), error);
+    }
+
+    /// <summary> Add to an integer number, which is created as 0 if the key doesn't exist. </summary>
+    bool Increment(const char* key, int64_t delta, int64_t& result) override {
+        auto updated = UpdateNumber(key, false, [delta, &result](Entry& entry) {
+            if (entry.isDouble) {
+                return false;
+            }
+            result = entry.number.fetch_add(delta) + delta;
+            return true;
+        });
+        if (updated) {
+            Notify(key);
+        }
+        return updated;
+    }
+
+    /// <summary> Add to a number, which is created as a floating point 0 if the key doesn't exist. </summary>
+    bool Add(const char* key, double delta, double& result) override {
+        auto updated = UpdateNumber(key, true, [delta, &result](Entry& entry) {
+            if (!entry.isDouble) {
+                if (!IsSafeInteger(delta)) {
+                    return false;
+                }
+                auto integerDelta = static_cast<int64_t>(delta);
+                result = static_cast<double>(entry.number.fetch_add(integerDelta) + integerDelta);
+                return true;
+            }
+
+            auto bits = entry.number.load();
+            while (!entry.number.compare_exchange_weak(bits, DoubleToBits(BitsToDouble(bits) + delta))) {}
+            result = BitsToDouble(bits) + delta;
+            return true;
+        });
+        if (updated) {
+            Notify(key);
+        }
+        return updated;
+    }
+
+    /// <summary> Replace a number with desired if it equals expected. </summary>
+    bool CompareAndSet(const char* key, double expected, double desired) override {
+        auto replaced = ReplaceNumber(key, expected, desired);
+        if (replaced) {
+            Notify(key);
+        }
+        return replaced;
+    }
+
+    /// <summary> Get a number by a key. </summary>
+    bool GetNumber(const char* key, double& value) const override {
+        auto& shard = GetShard(key);
+        std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+        auto it = shard.valueMap.find(key);
+        if (it == shard.valueMap.end() || it->second.value != nullptr || it->second.IsExpired(Now())) {
+            return false;
+        }
+        value = it->second.GetNumber();
+        return true;
+    }
+
+    /// <summary> Watch changes of a key, or of keys with a prefix. </summary>
+    uint64_t Watch(const char* pattern, WatchCallback callback) override {
+        auto watcher = std::make_shared<Watcher>();
+        watcher->id = NextWatchId();
+        watcher->prefix = pattern;
+        watcher->isPrefix = !watcher->prefix.empty() && watcher->prefix.back() == '*';
+        if (watcher->isPrefix) {
+            watcher->prefix.pop_back();
+        }
+        watcher->callback = std::move(callback);
+
+        std::lock_guard<std::mutex> lock(_watchersAccess);
+        auto watchers = std::make_shared<WatcherList>(*_watchers);
+        watchers->emplace_back(std::move(watcher));
+        _watchers = std::move(watchers);
+        _watched = true;
+        return _watchers->back()->id;
+    }
+
+    /// <summary> Stop a watch. </summary>
+    void Unwatch(uint64_t watchId) override {
+        std::lock_guard<std::mutex> lock(_watchersAccess);
+        auto watchers = std::make_shared<WatcherList>(*_watchers);
+        watchers->erase(
+            std::remove_if(watchers->begin(), watchers->end(), [watchId](const std::shared_ptr<const Watcher>& watcher) {
+                return watcher->id == watchId;
+            }),
+            watchers->end());
+        _watchers = std::move(watchers);
+        _watched = !_watchers->empty();
+    }
+
+    /// <summary> Write values and numbers of this store to a snapshot file. </summary>
+    bool Snapshot(const char* path, size_t& saved) const override {
+        saved = 0;
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        SnapshotHeader header = {};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        header.version = SNAPSHOT_VERSION;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        // Entries of a shard are buffered and written after its lock is released.
+        std::vector<char> buffer;
+        auto now = Now();
+        for (auto& shard : _shards) {
+            buffer.clear();
+            {
+                std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+                for (auto& pair : shard.valueMap) {
+                    auto& entry = pair.second;
+                    if (entry.IsExpired(now)
+                        || (entry.value != nullptr && entry.value->transportContext.GetSharedCount() != 0)) {
+                        continue;
+                    }
+                    AppendSnapshotEntry(buffer, pair.first, entry, now);
+                    header.count++;
+                }
+            }
+            file.write(buffer.data(), buffer.size());
+        }
+
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.close();
+        if (file.fail()) {
+            return false;
+        }
+        saved = static_cast<size_t>(header.count);
+        return true;
+    }
+
+    /// <summary> Set values and numbers from a snapshot file. </summary>
+    bool Load(const char* path, size_t& loaded) override {
+        loaded = 0;
+        napa::filesystem::MappedFile file(path);
+        if (!file.IsOpen() || file.Size() < sizeof(SnapshotHeader)) {
+            return false;
+        }
+
+        auto data = static_cast<const char*>(file.Data());
+        auto size = file.Size();
+        SnapshotHeader header;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 || header.version == 0 || header.version > SNAPSHOT_VERSION) {
+            return false;
+        }
+
+        // All entries are validated before any of them is set.
+        struct Record {
+            SnapshotEntryHeader header;
+            std::string key;
+            const char* payload;
+        };
+        std::vector<Record> records;
+        size_t offset = sizeof(header);
+        for (uint64_t i = 0; i < header.count; ++i) {
+            if (offset > size || size - offset < sizeof(SnapshotEntryHeader)) {
+                return false;
+            }
+            Record record;
+            std::memcpy(&record.header, data + offset, sizeof(SnapshotEntryHeader));
+            offset += sizeof(SnapshotEntryHeader);
+
+            if (record.header.keyLength > size - offset || record.header.kind > SnapshotEntryKind::OneByteValue) {
+                return false;
+            }
+            record.key.assign(data + offset, record.header.keyLength);
+            auto charSize = GetSnapshotCharSize(record.header.kind);
+            offset = AlignUp(offset + record.header.keyLength, charSize);
+
+            if (offset > size || record.header.payloadLength > (size - offset) / charSize) {
+                return false;
+            }
+            record.payload = data + offset;
+            offset = AlignUp(offset + static_cast<size_t>(record.header.payloadLength) * charSize, SNAPSHOT_ALIGNMENT);
+            records.emplace_back(std::move(record));
+        }
+
+        ForEachShard(_shards, records.size(), [&records](size_t i) { return records[i].key.c_str(); },
+            [this, &records](Shard& shard, const std::vector<size_t>& indices) {
+                // Values are made before the lock is taken, since compressing and interning them reads whole payloads.
+                std::vector<std::shared_ptr<Store::ValueType>> values(indices.size());
+                for (size_t j = 0; j < indices.size(); ++j) {
+                    auto& record = records[indices[j]];
+                    if (record.header.kind == SnapshotEntryKind::Integer || record.header.kind == SnapshotEntryKind::Double) {
+                        continue;
+                    }
+
+                    auto value = std::make_shared<Store::ValueType>();
+                    auto length = static_cast<size_t>(record.header.payloadLength);
+                    if (record.header.kind == SnapshotEntryKind::OneByteValue) {
+                        value->oneBytePayload.assign(record.payload, length);
+                    } else {
+                        value->payload.resize(length);
+                        std::memcpy(&value->payload[0], record.payload, length * sizeof(char16_t));
+                    }
+                    value->Compress(_options.compressionThreshold);
+                    values[j] = Intern(std::move(value));
+                }
+                {
+                    auto lock = LockForWrite(shard);
+                    for (size_t j = 0; j < indices.size(); ++j) {
+                        auto& record = records[indices[j]];
+                        if (values[j] == nullptr) {
+                            SetNumberLocked(shard, record.key, record.header.kind == SnapshotEntryKind::Double, record.header.number);
+                        } else {
+                            SetLocked(shard, record.key, std::move(values[j]), GetExpireTime(record.header.ttl));
+                        }
+                    }
+                }
+                for (auto i : indices) {
+                    Notify(records[i].key);
+                }
+            });
+
+        loaded = records.size();
+        return true;
     }
 
     /// <summary> Check if this store has a key. </summary>
     /// <param name="key"> Case-sensitive key. </param>
     /// <returns> True if the key exists in store. </returns>
     bool Has(const char* key) const override {
-        std::lock_guard<std::mutex> lock(_storeAccess);
-        return _valueMap.find(key) != _valueMap.end();
+        auto& shard = GetShard(key);
+        std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+        auto it = shard.valueMap.find(key);
+        return it != shard.valueMap.end() && !it->second.IsExpired(Now());
     }
 
     /// <summary> Delete a key. No-op if key is not found in store. </summary>
     void Delete(const char* key) override {
-        std::lock_guard<std::mutex> lock(_storeAccess);
-        _valueMap.erase(key);
+        auto& shard = GetShard(key);
+        {
+            auto lock = LockForWrite(shard);
+            auto it = shard.valueMap.find(key);
+            if (it == shard.valueMap.end()) {
+                return;
+            }
+            EraseLocked(shard, it);
+        }
+        Notify(key);
     }
 
     /// <summary> Return size of the store. </summary>
     size_t Size() const override {
-        std::lock_guard<std::mutex> lock(_storeAccess);
-        return _valueMap.size();
+        size_t size = 0;
+        for (auto& shard : _shards) {
+            std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+            size += shard.valueMap.size();
+        }
+        return size;
+    }
+
+    /// <summary> Get counters of this store. </summary>
+    StoreStatistics GetStatistics() const override {
+        StoreStatistics statistics = {};
+        for (auto& shard : _shards) {
+            std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+            statistics.hits += shard.hits.load(std::memory_order_relaxed);
+            statistics.misses += shard.misses.load(std::memory_order_relaxed);
+            statistics.evictions += shard.evictions;
+            statistics.expirations += shard.expirations;
+            statistics.bytes += shard.bytes;
+            statistics.keyBytes += shard.keyBytes;
+            statistics.sharedObjects += shard.sharedObjects;
+            statistics.sharedObjectBytes += shard.sharedObjectBytes;
+        }
+        statistics.payloadBytes = statistics.bytes - statistics.keyBytes;
+        statistics.loads = _loads.GetLoads();
+        statistics.loadWaits = _loads.GetWaits();
+        return statistics;
+    }
+
+    /// <summary> Drop expired values, one shard at a time. </summary>
+    void Sweep() {
+        auto now = Now();
+        for (auto& shard : _shards) {
+            auto lock = LockForWrite(shard);
+            for (auto it = shard.valueMap.begin(); it != shard.valueMap.end(); ) {
+                if (it->second.IsExpired(now)) {
+                    shard.expirations++;
+                    it = EraseLocked(shard, it);
+                } else {
+                    ++it;
+                }
+            }
+            PruneHistoryLocked(shard);
+        }
+    }
+
+    /// <summary> Report counters to the metric provider, with the store id as dimension. </summary>
+    void ReportMetrics() {
+        static const char* dimensionNames[] = { "Store" };
+        static auto hitsMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "StoreHits", napa::providers::MetricType::Rate, 1, dimensionNames);
+        static auto missesMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "StoreMisses", napa::providers::MetricType::Rate, 1, dimensionNames);
+        static auto evictionsMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "StoreEvictions", napa::providers::MetricType::Rate, 1, dimensionNames);
+        static auto expirationsMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "StoreExpirations", napa::providers::MetricType::Rate, 1, dimensionNames);
+        static auto loadsMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "StoreLoads", napa::providers::MetricType::Rate, 1, dimensionNames);
+        static auto loadWaitsMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "StoreLoadWaits", napa::providers::MetricType::Rate, 1, dimensionNames);
+        static auto bytesMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "StoreBytes", napa::providers::MetricType::Number, 1, dimensionNames);
+        static auto keyBytesMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "StoreKeyBytes", napa::providers::MetricType::Number, 1, dimensionNames);
+        static auto payloadBytesMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "StorePayloadBytes", napa::providers::MetricType::Number, 1, dimensionNames);
+        static auto sharedObjectsMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "StoreSharedObjects", napa::providers::MetricType::Number, 1, dimensionNames);
+
+        const char* dimensionValues[] = { _id.c_str() };
+        auto statistics = GetStatistics();
+        if (hitsMetric != nullptr) {
+            hitsMetric->Increment(statistics.hits - _reported.hits, 1, dimensionValues);
+        }
+        if (missesMetric != nullptr) {
+            missesMetric->Increment(statistics.misses - _reported.misses, 1, dimensionValues);
+        }
+        if (evictionsMetric != nullptr) {
+            evictionsMetric->Increment(statistics.evictions - _reported.evictions, 1, dimensionValues);
+        }
+        if (expirationsMetric != nullptr) {
+            expirationsMetric->Increment(statistics.expirations - _reported.expirations, 1, dimensionValues);
+        }
+        if (loadsMetric != nullptr) {
+            loadsMetric->Increment(statistics.loads - _reported.loads, 1, dimensionValues);
+        }
+        if (loadWaitsMetric != nullptr) {
+            loadWaitsMetric->Increment(statistics.loadWaits - _reported.loadWaits, 1, dimensionValues);
+        }
+        if (bytesMetric != nullptr) {
+            bytesMetric->Set(static_cast<int64_t>(statistics.bytes), 1, dimensionValues);
+        }
+        if (keyBytesMetric != nullptr) {
+            keyBytesMetric->Set(static_cast<int64_t>(statistics.keyBytes), 1, dimensionValues);
+        }
+        if (payloadBytesMetric != nullptr) {
+            payloadBytesMetric->Set(static_cast<int64_t>(statistics.payloadBytes), 1, dimensionValues);
+        }
+        if (sharedObjectsMetric != nullptr) {
+            sharedObjectsMetric->Set(static_cast<int64_t>(statistics.sharedObjects), 1, dimensionValues);
+        }
+        _reported = statistics;
     }
 
 private:
+    /// <summary> A value or a number, with its expiration and size. </summary>
+    struct Entry {
+        Entry(std::shared_ptr<Store::ValueType> value, int64_t expireTime, size_t bytes)
+            : value(std::move(value)),
+              expireTime(expireTime),
+              bytes(bytes),
+              referenced(false),
+              isDouble(false),
+              number(0) {
+        }
+
+        /// <summary> Constructor of a number entry. </summary>
+        /// <param name="number"> The int64 number, or the bits of the double number. </param>
+        Entry(bool isDouble, int64_t number, size_t bytes)
+            : expireTime(0),
+              bytes(bytes),
+              referenced(false),
+              isDouble(isDouble),
+              number(number) {
+        }
+
+        bool IsExpired(int64_t now) const {
+            return expireTime != 0 && expireTime <= now;
+        }
+
+        double GetNumber() const {
+            auto bits = number.load();
+            return isDouble ? BitsToDouble(bits) : static_cast<double>(bits);
+        }
+
+        /// <summary> Marshalled value, empty if the entry is a number. </summary>
+        std::shared_ptr<Store::ValueType> value;
+
+        /// <summary> Time in nanoseconds of the steady clock when the value expires, 0 for never. </summary>
+        int64_t expireTime;
+
+        /// <summary> Sequence number of the write that set the entry. </summary>
+        uint64_t sequence = 0;
+
+        /// <summary> Bytes of the key and payload. </summary>
+        size_t bytes;
+
+        /// <summary> Set by reads, the CLOCK hand gives a value a second chance if it was read since it passed. </summary>
+        mutable std::atomic<bool> referenced;
+
+        /// <summary> Whether the number is a double, or an int64. It's decided when the number is created. </summary>
+        bool isDouble;
+
+        /// <summary> The int64 number, or the bits of the double number. </summary>
+        std::atomic<int64_t> number;
+    };
+
+    /// <summary> A watch of a key, or of keys with a prefix. </summary>
+    struct Watcher {
+        uint64_t id;
+        std::string prefix;
+        bool isPrefix;
+        WatchCallback callback;
+
+        bool Matches(const std::string& key) const {
+            return isPrefix ? key.compare(0, prefix.size(), prefix) == 0 : key == prefix;
+        }
+    };
+
+    using WatcherList = std::vector<std::shared_ptr<const Watcher>>;
+
+    /// <summary> Call watchers of a key after it changed, without any lock held. </summary>
+    void Notify(const std::string& key) const {
+        if (!_watched) {
+            return;
+        }
+
+        std::shared_ptr<const WatcherList> watchers;
+        {
+            std::lock_guard<std::mutex> lock(_watchersAccess);
+            watchers = _watchers;
+        }
+        for (auto& watcher : *watchers) {
+            if (watcher->Matches(key)) {
+                watcher->callback(key);
+            }
+        }
+    }
+
+    using ValueMap = std::unordered_map<std::string, Entry>;
+
+    /// <summary> A value replaced or deleted while a view that reads it exists. </summary>
+    struct Version {
+        /// <summary> Sequence number of the write that set the value. </summary>
+        uint64_t set;
+
+        /// <summary> Sequence number of the write that replaced or deleted the value. </summary>
+        uint64_t replaced;
+
+        /// <summary> The value, or a number marshalled as it was when it was replaced. </summary>
+        std::shared_ptr<Store::ValueType> value;
+    };
+
+    /// <summary> Orders entries of a value map by key, and compares them with keys to find bounds. </summary>
+    struct KeyLess {
+        using is_transparent = void;
+
+        bool operator()(const ValueMap::value_type* left, const ValueMap::value_type* right) const {
+            return left->first < right->first;
+        }
+
+        bool operator()(const ValueMap::value_type* left, const std::string& right) const {
+            return left->first < right;
+        }
+
+        bool operator()(const std::string& left, const ValueMap::value_type* right) const {
+            return left < right->first;
+        }
+    };
+
+    /// <summary> A part of the store, reads share its lock and writes take it exclusively. </summary>
+    struct Shard {
+        /// <summary> Key to value map. </summary>
+        ValueMap valueMap;
+
+        /// <summary> Entries of the value map in key order, only kept by ordered stores. </summary>
+        /// <remarks> Nodes of the value map don't move, so the pointers stay valid until their entries are erased. </remarks>
+        std::set<const ValueMap::value_type*, KeyLess> orderedEntries;
+
+        /// <summary> Reader-writer lock to value map access. (use std::shared_mutex when C++17 is required) </summary>
+        mutable std::shared_timed_mutex access;
+
+        /// <summary> Sequence number of the write holding the exclusive lock. </summary>
+        uint64_t sequence = 0;
+
+        /// <summary> Replaced and deleted values of keys that views still read, oldest first. </summary>
+        std::unordered_map<std::string, std::vector<Version>> history;
+
+        /// <summary> Bytes of keys and payloads in this shard. </summary>
+        size_t bytes = 0;
+
+        /// <summary> Bytes of keys in this shard. </summary>
+        size_t keyBytes = 0;
+
+        /// <summary> Shared objects of the transport contexts of values in this shard, and the bytes they hold. </summary>
+        size_t sharedObjects = 0;
+        size_t sharedObjectBytes = 0;
+
+        /// <summary> Key of the value the CLOCK hand points to, eviction resumes from there. </summary>
+        std::string hand;
+
+        /// <summary> Counters updated under the shared lock are atomic, the others are guarded by the exclusive lock. </summary>
+        mutable std::atomic<uint64_t> hits { 0 };
+        mutable std::atomic<uint64_t> misses { 0 };
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+    };
+
+    /// <summary> Take the exclusive lock of a shard, with a new sequence number for what is written under it. </summary>
+    std::unique_lock<std::shared_timed_mutex> LockForWrite(Shard& shard) {
+        std::unique_lock<std::shared_timed_mutex> lock(shard.access);
+        shard.sequence = ++_sequence;
+        return lock;
+    }
+
+    /// <summary> A view, which reads the entries set before it and the versions they replaced after it. </summary>
+    class ViewImpl : public View {
+    public:
+        explicit ViewImpl(std::shared_ptr<const StoreImpl> store) : _store(std::move(store)) {
+            // Writers look for views after taking their sequence numbers, so a writer that doesn't see this view
+            // wrote after the sequence number the view reads up to.
+            std::lock_guard<std::mutex> lock(_store->_viewsAccess);
+            ++_store->_viewCount;
+            _sequence = _store->_sequence.load();
+            _store->_viewSequences.insert(_sequence);
+        }
+
+        ~ViewImpl() {
+            // Versions no longer read are dropped by the next sweep.
+            std::lock_guard<std::mutex> lock(_store->_viewsAccess);
+            _store->_viewSequences.erase(_store->_viewSequences.find(_sequence));
+            --_store->_viewCount;
+        }
+
+        std::shared_ptr<ValueType> Get(const char* key) const override {
+            auto& shard = _store->GetShard(key);
+            std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+            return GetLocked(shard, key, Now());
+        }
+
+        std::vector<std::shared_ptr<ValueType>> GetMany(const std::vector<std::string>& keys) const override {
+            std::vector<std::shared_ptr<ValueType>> values(keys.size());
+            auto now = Now();
+            ForEachShard(_store->_shards, keys.size(), [&keys](size_t i) { return keys[i].c_str(); },
+                [this, &keys, &values, now](const Shard& shard, const std::vector<size_t>& indices) {
+                    std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+                    for (auto i : indices) {
+                        values[i] = GetLocked(shard, keys[i], now);
+                    }
+                });
+            return values;
+        }
+
+        bool Has(const char* key) const override {
+            return Get(key) != nullptr;
+        }
+
+    private:
+        /// <summary> Get a value as it was when the view was created, from a shard whose lock is held by the caller. </summary>
+        std::shared_ptr<ValueType> GetLocked(const Shard& shard, const std::string& key, int64_t now) const {
+            auto it = shard.valueMap.find(key);
+            if (it != shard.valueMap.end() && it->second.sequence <= _sequence) {
+                if (it->second.IsExpired(now)) {
+                    return nullptr;
+                }
+                return it->second.value != nullptr ? it->second.value : MarshallNumber(it->second.isDouble, it->second.number.load());
+            }
+
+            auto history = shard.history.find(key);
+            if (history != shard.history.end()) {
+                for (auto& version : history->second) {
+                    if (version.set <= _sequence && _sequence < version.replaced) {
+                        return version.value;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        std::shared_ptr<const StoreImpl> _store;
+        uint64_t _sequence;
+    };
+
+    /// <summary> Tell if a view reads a version of a key between two sequence numbers. </summary>
+    bool IsViewed(uint64_t set, uint64_t replaced) const {
+        std::lock_guard<std::mutex> lock(_viewsAccess);
+        auto it = _viewSequences.lower_bound(set);
+        return it != _viewSequences.end() && *it < replaced;
+    }
+
+    /// <summary> Drop versions of a shard no view reads, whose exclusive lock is held by the caller. </summary>
+    void PruneHistoryLocked(Shard& shard) const {
+        if (shard.history.empty()) {
+            return;
+        }
+        if (_viewCount.load() == 0) {
+            shard.history.clear();
+            return;
+        }
+        for (auto it = shard.history.begin(); it != shard.history.end(); ) {
+            auto& versions = it->second;
+            versions.erase(
+                std::remove_if(versions.begin(), versions.end(), [this](const Version& version) {
+                    return !IsViewed(version.set, version.replaced);
+                }),
+                versions.end());
+            it = versions.empty() ? shard.history.erase(it) : std::next(it);
+        }
+    }
+
+    const Shard& GetShard(const char* key) const {
+        return _shards.size() == 1 ? _shards.front() : _shards[HashKey(key) % _shards.size()];
+    }
+
+    Shard& GetShard(const char* key) {
+        return const_cast<Shard&>(static_cast<const StoreImpl*>(this)->GetShard(key));
+    }
+
+    /// <summary> Group items by the shards of their keys, and call the handler once for each shard with items. </summary>
+    /// <remarks> Shards is either the const or non-const shards of a store. </remarks>
+    template <typename Shards, typename KeyOf, typename Handler>
+    static void ForEachShard(Shards& shards, size_t count, KeyOf keyOf, Handler handler) {
+        if (shards.size() == 1) {
+            std::vector<size_t> indices(count);
+            for (size_t i = 0; i < count; ++i) {
+                indices[i] = i;
+            }
+            handler(shards.front(), indices);
+            return;
+        }
+
+        std::vector<std::vector<size_t>> indicesOfShards(shards.size());
+        for (size_t i = 0; i < count; ++i) {
+            indicesOfShards[HashKey(keyOf(i)) % shards.size()].push_back(i);
+        }
+        for (size_t s = 0; s < shards.size(); ++s) {
+            if (!indicesOfShards[s].empty()) {
+                handler(shards[s], indicesOfShards[s]);
+            }
+        }
+    }
+
+    /// <summary> Visit entries from a key in key order, holding shared locks of all shards so they are consistent. </summary>
+    /// <param name="from"> Inclusive lower bound of keys. </param>
+    /// <param name="inRange"> Tells if a key from the lower bound is in the range, false for all keys after the first key out of it. </param>
+    /// <param name="visit"> Called with each key and entry in the range that is not expired. </param>
+    template <typename InRange, typename Visit>
+    void Scan(const std::string& from, InRange inRange, Visit visit) const {
+        // Writers hold one shard lock at a time, so taking all of them in order can't deadlock.
+        std::vector<std::shared_lock<std::shared_timed_mutex>> locks;
+        locks.reserve(_shards.size());
+        for (auto& shard : _shards) {
+            locks.emplace_back(shard.access);
+        }
+
+        std::vector<const ValueMap::value_type*> entries;
+        for (auto& shard : _shards) {
+            if (_options.ordered) {
+                for (auto it = shard.orderedEntries.lower_bound(from);
+                     it != shard.orderedEntries.end() && inRange((*it)->first);
+                     ++it) {
+                    entries.push_back(*it);
+                }
+            } else {
+                for (auto& pair : shard.valueMap) {
+                    if (pair.first >= from && inRange(pair.first)) {
+                        entries.push_back(&pair);
+                    }
+                }
+            }
+        }
+        if (!_options.ordered || _shards.size() > 1) {
+            std::sort(entries.begin(), entries.end(), KeyLess());
+        }
+
+        auto now = Now();
+        for (auto entry : entries) {
+            if (!entry->second.IsExpired(now)) {
+                visit(entry->first, entry->second);
+            }
+        }
+    }
+
+    /// <summary> Add an entry of a key that doesn't exist to a shard, whose exclusive lock is held by the caller. </summary>
+    /// <param name="args"> Arguments of the entry constructor. </param>
+    template <typename... Args>
+    Entry& EmplaceLocked(Shard& shard, std::string key, Args&&... args) {
+        auto it = shard.valueMap.emplace(
+            std::piecewise_construct,
+            std::forward_as_tuple(std::move(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...)).first;
+        it->second.sequence = shard.sequence;
+        Account(shard, *it, true);
+        if (_options.ordered) {
+            shard.orderedEntries.insert(&*it);
+        }
+        return it->second;
+    }
+
+    /// <summary> Erase an entry from a shard, whose exclusive lock is held by the caller. </summary>
+    /// <returns> Iterator of the entry after the erased one. </returns>
+    ValueMap::iterator EraseLocked(Shard& shard, ValueMap::const_iterator it) {
+        auto& entry = it->second;
+        if (_viewCount.load() != 0 && IsViewed(entry.sequence, shard.sequence)) {
+            shard.history[it->first].push_back(Version {
+                entry.sequence,
+                shard.sequence,
+                entry.value != nullptr ? entry.value : MarshallNumber(entry.isDouble, entry.number.load()) });
+        }
+        Account(shard, *it, false);
+        if (_options.ordered) {
+            shard.orderedEntries.erase(&*it);
+        }
+        return shard.valueMap.erase(it);
+    }
+
+    /// <summary> Add an entry to the byte and shared object counts of its shard, or take it out of them. </summary>
+    static void Account(Shard& shard, const ValueMap::value_type& entry, bool added) {
+        size_t sharedObjects = 0;
+        size_t sharedObjectBytes = 0;
+        if (entry.second.value != nullptr) {
+            auto& transportContext = entry.second.value->transportContext;
+            sharedObjects = transportContext.GetSharedCount();
+            sharedObjectBytes = sharedObjects == 0 ? 0 : transportContext.GetTotalExternalSize();
+        }
+
+        if (added) {
+            shard.bytes += entry.second.bytes;
+            shard.keyBytes += entry.first.size();
+            shard.sharedObjects += sharedObjects;
+            shard.sharedObjectBytes += sharedObjectBytes;
+        } else {
+            shard.bytes -= entry.second.bytes;
+            shard.keyBytes -= entry.first.size();
+            shard.sharedObjects -= sharedObjects;
+            shard.sharedObjectBytes -= sharedObjectBytes;
+        }
+    }
+
+    /// <summary> Time in nanoseconds of the steady clock when a value set now expires, 0 for never. </summary>
+    static int64_t GetExpireTime(uint32_t ttl) {
+        return ttl == 0 ? 0 : Now() + std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::milliseconds(ttl)).count();
+    }
+
+    /// <summary> Get the interned value of the payload of a value if the store interns, otherwise the value. </summary>
+    std::shared_ptr<Store::ValueType> Intern(std::shared_ptr<Store::ValueType> value) const {
+        return _options.intern ? PayloadTable::Get().Intern(std::move(value)) : value;
+    }
+
+    /// <summary> Set a value in a shard, whose exclusive lock is held by the caller. </summary>
+    void SetLocked(Shard& shard, std::string key, std::shared_ptr<Store::ValueType> value, int64_t expireTime) {
+        if (!value->interned) {
+            value->version = NextVersion();
+        }
+        auto bytes = key.size() + value->GetPayloadBytes();
+
+        // The old value doesn't count in the budget, and it's not a candidate of eviction.
+        auto it = shard.valueMap.find(key);
+        if (it != shard.valueMap.end()) {
+            EraseLocked(shard, it);
+        }
+        Evict(shard, bytes);
+        EmplaceLocked(shard, std::move(key), std::move(value), expireTime, bytes);
+    }
+
+    /// <summary> Get a value from a shard, whose lock is held by the caller. </summary>
+    static std::shared_ptr<Store::ValueType> GetLocked(const Shard& shard, const std::string& key, int64_t now) {
+        auto it = shard.valueMap.find(key);
+        if (it != shard.valueMap.end() && !it->second.IsExpired(now)) {
+            it->second.referenced.store(true, std::memory_order_relaxed);
+            shard.hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second.value != nullptr ? it->second.value : MarshallNumber(it->second.isDouble, it->second.number.load());
+        }
+        shard.misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    /// <summary> Replace a number with desired if it equals expected. </summary>
+    bool ReplaceNumber(const char* key, double expected, double desired) {
+        auto& shard = GetShard(key);
+        std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+        auto it = shard.valueMap.find(key);
+        if (it == shard.valueMap.end() || it->second.value != nullptr || it->second.IsExpired(Now())) {
+            return false;
+        }
+
+        auto& entry = it->second;
+        if (!entry.isDouble) {
+            if (!IsSafeInteger(expected) || !IsSafeInteger(desired)) {
+                return false;
+            }
+            auto bits = static_cast<int64_t>(expected);
+            return entry.number.compare_exchange_strong(bits, static_cast<int64_t>(desired));
+        }
+
+        // Numbers are compared by value rather than by bits, so 0 equals -0.
+        auto bits = entry.number.load();
+        while (BitsToDouble(bits) == expected) {
+            if (entry.number.compare_exchange_weak(bits, DoubleToBits(desired))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// <summary> Update a number under the shared lock, or create it under the exclusive lock if the key doesn't exist. </summary>
+    /// <param name="isDouble"> Whether a number created is a double. </param>
+    /// <param name="update"> Updates the number entry, returns false if the update doesn't apply to it. </param>
+    template <typename Update>
+    bool UpdateNumber(const char* key, bool isDouble, Update update) {
+        auto& shard = GetShard(key);
+        {
+            std::shared_lock<std::shared_timed_mutex> lock(shard.access);
+            auto it = shard.valueMap.find(key);
+            if (it != shard.valueMap.end() && !it->second.IsExpired(Now())) {
+                return it->second.value == nullptr && update(it->second);
+            }
+        }
+
+        auto lock = LockForWrite(shard);
+        auto it = shard.valueMap.find(key);
+        if (it != shard.valueMap.end() && !it->second.IsExpired(Now())) {
+            // Created or set by another writer after the shared lock was released.
+            return it->second.value == nullptr && update(it->second);
+        }
+        return update(SetNumberLocked(shard, key, isDouble, isDouble ? DoubleToBits(0.0) : 0));
+    }
+
+    /// <summary> Set a number in a shard, whose exclusive lock is held by the caller. </summary>
+    /// <param name="number"> The int64 number, or the bits of the double number. </param>
+    /// <returns> The number entry. </returns>
+    Entry& SetNumberLocked(Shard& shard, std::string key, bool isDouble, int64_t number) {
+        auto it = shard.valueMap.find(key);
+        if (it != shard.valueMap.end()) {
+            EraseLocked(shard, it);
+        }
+
+        auto bytes = key.size() + sizeof(int64_t);
+        Evict(shard, bytes);
+        return EmplaceLocked(shard, std::move(key), isDouble, number, bytes);
+    }
+
+    /// <summary> Append an entry to the buffer of a snapshot file. </summary>
+    static void AppendSnapshotEntry(std::vector<char>& buffer, const std::string& key, const Entry& entry, int64_t now) {
+        SnapshotEntryHeader header = {};
+        header.keyLength = static_cast<uint32_t>(key.size());
+        const std::string* oneBytePayload = nullptr;
+        const std::u16string* payload = nullptr;
+
+        // Snapshots keep payloads uncompressed, a store compressing payloads compresses them again on load.
+        std::string decompressedOneBytePayload;
+        std::u16string decompressedPayload;
+        if (entry.value == nullptr) {
+            header.kind = entry.isDouble ? SnapshotEntryKind::Double : SnapshotEntryKind::Integer;
+            header.number = entry.number.load();
+        } else if (entry.value->IsCompressed()) {
+            if (!entry.value->Decompress(decompressedOneBytePayload, decompressedPayload)) {
+                return;
+            }
+            if (entry.value->compressedTwoByte) {
+                payload = &decompressedPayload;
+            } else {
+                oneBytePayload = &decompressedOneBytePayload;
+            }
+        } else if (entry.value->IsOneByte()) {
+            oneBytePayload = &entry.value->oneBytePayload;
+        } else {
+            payload = &entry.value->payload;
+        }
+
+        const void* payloadData = nullptr;
+        if (oneBytePayload != nullptr) {
+            header.kind = SnapshotEntryKind::OneByteValue;
+            header.payloadLength = oneBytePayload->size();
+            payloadData = oneBytePayload->data();
+        } else if (payload != nullptr) {
+            header.kind = SnapshotEntryKind::Value;
+            header.payloadLength = payload->size();
+            payloadData = payload->data();
+        }
+        if (entry.expireTime != 0) {
+            // Round up, so a value about to expire doesn't become a value that never expires.
+            auto remaining = (entry.expireTime - now + 999999) / 1000000;
+            header.ttl = static_cast<uint32_t>(std::min<int64_t>(std::max<int64_t>(remaining, 1), UINT32_MAX));
+        }
+
+        auto offset = buffer.size();
+        auto charSize = GetSnapshotCharSize(header.kind);
+        auto payloadOffset = AlignUp(offset + sizeof(header) + key.size(), charSize);
+        auto payloadBytes = static_cast<size_t>(header.payloadLength) * charSize;
+        buffer.resize(AlignUp(payloadOffset + payloadBytes, SNAPSHOT_ALIGNMENT), '\0');
+
+        std::memcpy(&buffer[offset], &header, sizeof(header));
+        std::memcpy(&buffer[offset + sizeof(header)], key.data(), key.size());
+        if (payloadBytes != 0) {
+            std::memcpy(&buffer[payloadOffset], payloadData, payloadBytes);
+        }
+    }
+
+    /// <summary> Evict values with CLOCK until a value of the given size fits in the shard budget. </summary>
+    void Evict(Shard& shard, size_t incoming) {
+        if (_shardBudget == 0 || shard.bytes + incoming <= _shardBudget) {
+            return;
+        }
+
+        auto it = shard.valueMap.find(shard.hand);
+        while (shard.bytes + incoming > _shardBudget && !shard.valueMap.empty()) {
+            if (it == shard.valueMap.end()) {
+                it = shard.valueMap.begin();
+            }
+            if (it->second.referenced.exchange(false, std::memory_order_relaxed)) {
+                ++it;
+                continue;
+            }
+            shard.evictions++;
+            it = EraseLocked(shard, it);
+        }
+        shard.hand = it == shard.valueMap.end() ? std::string() : it->first;
+    }
+
     /// <summary> ID. Case sensitive. </summary>
     std::string _id;
 
-    /// <summary> Key to value map. </summary>
-    std::unordered_map<std::string, std::shared_ptr<Store::ValueType>> _valueMap;
+    /// <summary> Options. </summary>
+    StoreOptions _options;
+
+    /// <summary> Shards of the store, a key always goes to the same shard. </summary>
+    std::vector<Shard> _shards;
+
+    /// <summary> Byte budget of each shard, 0 for no limit. </summary>
+    size_t _shardBudget;
+
+    /// <summary> Last sequence number of a write. </summary>
+    std::atomic<uint64_t> _sequence { 0 };
+
+    /// <summary> Sequence numbers the views read up to, and their count, which writers check without the lock. </summary>
+    mutable std::multiset<uint64_t> _viewSequences;
+    mutable std::atomic<size_t> _viewCount { 0 };
+    mutable std::mutex _viewsAccess;
+
+    /// <summary> The loader of missing keys, and their loads in flight. </summary>
+    LoadTable _loads;
+
+    /// <summary> Counters at the last metrics report, only used by the sweeper thread. </summary>
+    StoreStatistics _reported = {};
+
+    /// <summary> Watchers, replaced as a whole when a watch starts or stops so notifying never holds the lock. </summary>
+    std::shared_ptr<const WatcherList> _watchers = std::make_shared<WatcherList>();
+    mutable std::mutex _watchersAccess;
 
-    /// <summary> Mutex to value map access. (use std::shared_mutex when it's public) </summary>
-    mutable std::mutex _storeAccess;
+    /// <summary> Whether there is any watcher, so changes of stores that are not watched don't take the lock. </summary>
+    std::atomic<bool> _watched { false };
 };
 
 namespace napa {
 namespace store {
 
+    uint64_t HashKey(const char* key) {
+        auto hash = FNV_OFFSET_BASIS;
+        for (auto c = key; *c != '\0'; c++) {
+            hash ^= static_cast<unsigned char>(*c);
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    uint64_t NextVersion() {
+        return ++_lastVersion;
+    }
+
+    uint64_t NextWatchId() {
+        return ++_lastWatchId;
+    }
+
+    bool IsSafeInteger(double value) {
+        return std::trunc(value) == value && std::fabs(value) <= MAX_SAFE_INTEGER;
+    }
+
+    int64_t DoubleToBits(double value) {
+        int64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    double BitsToDouble(int64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::shared_ptr<Store::ValueType> MarshallNumber(bool isDouble, int64_t number) {
+        // Same as JSON.stringify, non-finite numbers are marshalled as null.
+        char buffer[32] = "null";
+        if (!isDouble) {
+            std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(number));
+        } else if (std::isfinite(BitsToDouble(number))) {
+            std::snprintf(buffer, sizeof(buffer), "%.17g", BitsToDouble(number));
+        }
+
+        auto value = std::make_shared<Store::ValueType>();
+        value->oneBytePayload = buffer;
+        return value;
+    }
+
+    void Store::ValueType::Compress(size_t threshold) {
+        if (IsCompressed()) {
+            return;
+        }
+
+        auto twoByte = !IsOneByte();
+        auto compressed = twoByte
+            ? utils::CompressPayload(payload.data(), payload.size() * sizeof(char16_t), threshold, utils::PayloadSource::Store, compressedPayload)
+            : utils::CompressPayload(oneBytePayload.data(), oneBytePayload.size(), threshold, utils::PayloadSource::Store, compressedPayload);
+        if (compressed) {
+            compressedTwoByte = twoByte;
+            std::u16string().swap(payload);
+            std::string().swap(oneBytePayload);
+        }
+    }
+
+    bool Store::ValueType::Decompress(std::string& oneByte, std::u16string& twoByte) const {
+        auto size = utils::GetDecompressedSize(compressedPayload);
+        if (compressedTwoByte) {
+            twoByte.resize(size / sizeof(char16_t));
+            return utils::DecompressPayload(compressedPayload, &twoByte[0]);
+        }
+        oneByte.resize(size);
+        return utils::DecompressPayload(compressedPayload, &oneByte[0]);
+    }
+
     namespace {
         std::unordered_map<std::string, std::weak_ptr<Store>> _storeRegistry;
         std::mutex _registryAccess;
+
+        /// <summary> Background thread that sweeps expired values and reports metrics of all living stores. </summary>
+        class StoreSweeper {
+        public:
+            /// <summary> Start the sweeper with the first store, it stops when the process exits. </summary>
+            static void EnsureStarted() {
+                static StoreSweeper sweeper;
+            }
+
+        private:
+            StoreSweeper() : _stopped(false), _thread(&StoreSweeper::Run, this) {}
+
+            ~StoreSweeper() {
+                {
+                    std::lock_guard<std::mutex> lock(_stopAccess);
+                    _stopped = true;
+                }
+                _stopEvent.notify_one();
+                _thread.join();
+            }
+
+            void Run() {
+                std::unique_lock<std::mutex> lock(_stopAccess);
+                while (!_stopEvent.wait_for(lock, SWEEP_INTERVAL, [this]() { return _stopped; })) {
+                    lock.unlock();
+                    for (auto& store : GetLivingStores()) {
+                        store->Sweep();
+                        store->ReportMetrics();
+                    }
+                    PayloadTable::Get().Sweep();
+                    lock.lock();
+                }
+            }
+
+            static std::vector<std::shared_ptr<StoreImpl>> GetLivingStores() {
+                std::vector<std::shared_ptr<StoreImpl>> stores;
+                std::lock_guard<std::mutex> lock(_registryAccess);
+                for (auto& entry : _storeRegistry) {
+                    // Values of shared stores don't expire in the background, their space is not reclaimed anyway.
+                    if (IsSharedStoreId(entry.first.c_str())) {
+                        continue;
+                    }
+                    if (auto store = entry.second.lock()) {
+                        stores.emplace_back(std::static_pointer_cast<StoreImpl>(std::move(store)));
+                    }
+                }
+                return stores;
+            }
+
+            bool _stopped;
+            std::mutex _stopAccess;
+            std::condition_variable _stopEvent;
+            std::thread _thread;
+        };
     } // namespace
 
     std::shared_ptr<Store> CreateStore(const char* id) {
+        return CreateStore(id, StoreOptions());
+    }
+
+    std::shared_ptr<Store> CreateStore(const char* id, const StoreOptions& options) {
+        StoreSweeper::EnsureStarted();
+
         std::lock_guard<std::mutex> lockWrite(_registryAccess);
-        
+
         std::shared_ptr<Store> store;
         auto it = _storeRegistry.find(id);
+        if (it != _storeRegistry.end() && !it->second.expired()) {
+            return store;
+        }
+
+        store = IsSharedStoreId(id) ? CreateSharedStore(id, options) : std::make_shared<StoreImpl>(id, options);
+        if (store == nullptr) {
+            return store;
+        }
         if (it == _storeRegistry.end()) {
-            store = std::make_shared<StoreImpl>(id);
             _storeRegistry.insert(std::make_pair(std::string(id), store));
+        } else {
+            // The store with the same id was destroyed but not yet removed from the registry.
+            it->second = store;
         }
         return store;
     }
 
     std::shared_ptr<Store> GetOrCreateStore(const char* id) {
+        return GetOrCreateStore(id, StoreOptions());
+    }
+
+    std::shared_ptr<Store> GetOrCreateStore(const char* id, const StoreOptions& options) {
         auto store = GetStore(id);
         if (store == nullptr) {
-            store = CreateStore(id);
+            store = CreateStore(id, options);
             if (store == nullptr) {
                 // Already created just now. Lookup again.
                 store = GetStore(id);
@@ -131,5 +1436,27 @@ namespace store {
         }
         return _storeRegistry.size();
     }
+
+    std::vector<std::shared_ptr<Store>> GetStores() {
+        std::vector<std::pair<std::string, std::shared_ptr<Store>>> entries;
+        {
+            std::lock_guard<std::mutex> lockRead(_registryAccess);
+            for (auto& entry : _storeRegistry) {
+                if (auto store = entry.second.lock()) {
+                    entries.emplace_back(entry.first, std::move(store));
+                }
+            }
+        }
+        std::sort(entries.begin(), entries.end(), [](const auto& left, const auto& right) {
+            return left.first < right.first;
+        });
+
+        std::vector<std::shared_ptr<Store>> stores;
+        stores.reserve(entries.size());
+        for (auto& entry : entries) {
+            stores.emplace_back(std::move(entry.second));
+        }
+        return stores;
+    }
 } // namespace store
 } // namespace napa
@@ -6,12 +6,113 @@
 #include <napa/exports.h>
 #include <napa/transport/transport-context.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <string>
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace napa {
 namespace store {
 
+    /// <summary> Options to create a store. </summary>
+    struct StoreOptions {
+        /// <summary>
+        /// Number of independently locked parts of the store. Reads share the locks, so one shard suits most stores,
+        /// more shards spread writers and readers of stores that are updated while many workers read them.
+        /// </summary>
+        uint32_t shards = 1;
+
+        /// <summary>
+        /// Values are deep frozen when they are unmarshalled, so each isolate can reuse what it unmarshalled
+        /// until the entry is set again.
+        /// </summary>
+        bool frozen = false;
+
+        /// <summary>
+        /// Budget in bytes of keys and payloads, 0 for no limit. It's split evenly over the shards, a write that
+        /// goes over the budget of its shard evicts values that were not read recently (CLOCK) first.
+        /// </summary>
+        size_t maxBytes = 0;
+
+        /// <summary>
+        /// Keys are kept in order, so Keys and Range scan only the keys they return. Stores that are not ordered
+        /// scan and sort all keys, which suits stores that are rarely enumerated.
+        /// </summary>
+        bool ordered = false;
+
+        /// <summary>
+        /// Payloads of at least this many bytes are kept compressed in the LZ4 block format, 0 to never compress.
+        /// Stores in named shared memory don't compress.
+        /// </summary>
+        size_t compressionThreshold = 0;
+
+        /// <summary>
+        /// Values are interned by their payloads in a table shared by all interning stores of the process, so keys
+        /// set to the same payload keep it once, and frozen stores reuse what an isolate unmarshalled across them.
+        /// Payloads are interned after compression, values with shared objects and stores in named shared memory don't intern.
+        /// </summary>
+        bool intern = false;
+    };
+
+    /// <summary> Counters of a store since it was created. </summary>
+    struct StoreStatistics {
+        /// <summary> Number of Gets that found a value. </summary>
+        uint64_t hits;
+
+        /// <summary> Number of Gets that found no value, or an expired one. </summary>
+        uint64_t misses;
+
+        /// <summary> Number of values evicted to stay in the byte budget. </summary>
+        uint64_t evictions;
+
+        /// <summary> Number of expired values dropped. </summary>
+        uint64_t expirations;
+
+        /// <summary> Number of loads of missing keys the loader ran. </summary>
+        uint64_t loads;
+
+        /// <summary> Number of loads of missing keys that waited for a load in flight instead of running the loader. </summary>
+        uint64_t loadWaits;
+
+        /// <summary> Bytes of keys and payloads in the store. </summary>
+        size_t bytes;
+
+        /// <summary> Bytes of keys, which are part of bytes. </summary>
+        size_t keyBytes;
+
+        /// <summary> Bytes of payloads as they are kept, which are part of bytes. A number takes 8 bytes. </summary>
+        size_t payloadBytes;
+
+        /// <summary> Number of shared objects the transport contexts of values hold, like SharedArrayBuffers. </summary>
+        size_t sharedObjects;
+
+        /// <summary> Bytes of native memory the shared objects hold, as far as they report it. They're not part of bytes. </summary>
+        size_t sharedObjectBytes;
+    };
+
+    /// <summary> Maximum number of shards of a store. </summary>
+    constexpr uint32_t MAX_STORE_SHARDS = 256;
+
+    /// <summary> Milliseconds a caller waits for the load of a key on another thread, unless the loader sets it. </summary>
+    constexpr uint32_t DEFAULT_LOAD_WAIT_TIMEOUT = 10000;
+
+    /// <summary> Prefix of ids of stores in named shared memory, which processes on the same host share. </summary>
+    /// <remarks>
+    /// A shared store is an append-only segment of maxBytes (64 MB by default) with a lock-free hash table of keys.
+    /// Replaced and deleted values keep their space, values that don't fit are dropped and counted as evictions.
+    /// Values with shared objects in their transport contexts only live in process memory and are dropped too.
+    /// </remarks>
+    constexpr const char* SHARED_STORE_PREFIX = "shared://";
+
+    /// <summary> Tell if an id is of a store in named shared memory. </summary>
+    inline bool IsSharedStoreId(const char* id) {
+        return std::strncmp(id, SHARED_STORE_PREFIX, std::strlen(SHARED_STORE_PREFIX)) == 0;
+    }
+
     /// <summary> Class for memory store, which stores transportable JS objects across isolates. </summary>
     /// <remarks> Store is intended to be used by StoreWrap. 
     /// We expose Store in napa.dll instead of napa-binding for sharing memory between Napa and Node.JS. </remarks>
@@ -19,27 +120,255 @@ namespace store {
     public:
         /// Meta-data that is necessary to marshall/unmarshall JS values.
         struct ValueType {
-            /// <summary> JSON string from marshalled JS value. </summary>
+            /// <summary> JSON string from marshalled JS value in UTF-16, empty if it's kept in oneBytePayload. </summary>
             std::u16string payload;
 
+            /// <summary> JSON string from marshalled JS value in Latin-1, which takes half the memory of UTF-16. </summary>
+            /// <remarks> It's used when all characters of the string are Latin-1, like JSON of ASCII text. </remarks>
+            std::string oneBytePayload;
+
             /// <summary> TransportContext that is needed to unmarshall the JS value. </summary>
             napa::transport::TransportContext transportContext;
+
+            /// <summary> The JSON string compressed by napa::utils::CompressPayload, empty unless it's compressed. </summary>
+            /// <remarks> payload and oneBytePayload are empty while it's compressed, Decompress writes them back. </remarks>
+            std::string compressedPayload;
+
+            /// <summary> True if the compressed JSON string is in UTF-16, otherwise it's in Latin-1. </summary>
+            bool compressedTwoByte = false;
+
+            /// <summary> Version assigned by Set, unique across stores in the process. </summary>
+            /// <remarks> Interned values keep the version assigned once they were interned. </remarks>
+            uint64_t version = 0;
+
+            /// <summary> True if the value is in the payload table, it's then shared by keys and never changed. </summary>
+            bool interned = false;
+
+            /// <summary> True if the JSON string is kept in oneBytePayload. </summary>
+            bool IsOneByte() const {
+                return payload.empty() && !IsCompressed();
+            }
+
+            /// <summary> True if the JSON string is kept in compressedPayload. </summary>
+            bool IsCompressed() const {
+                return !compressedPayload.empty();
+            }
+
+            /// <summary> Bytes of the JSON string, as it's kept. </summary>
+            size_t GetPayloadBytes() const {
+                return oneBytePayload.size() + payload.size() * sizeof(char16_t) + compressedPayload.size();
+            }
+
+            /// <summary> Compress the JSON string if it takes at least threshold bytes and compression shrinks it. </summary>
+            /// <param name="threshold"> Bytes from which the string is compressed, 0 to never compress. </param>
+            NAPA_API void Compress(size_t threshold);
+
+            /// <summary> Decompress the JSON string into one of the strings, without changing this value. </summary>
+            /// <param name="oneByte"> Receives the Latin-1 string, unless the string is in UTF-16. </param>
+            /// <param name="twoByte"> Receives the UTF-16 string, if the string is in UTF-16. </param>
+            /// <returns> False if the compressed string is corrupted. </returns>
+            NAPA_API bool Decompress(std::string& oneByte, std::u16string& twoByte) const;
+        };
+
+        /// <summary> Callback of a watch, called with the key that changed. </summary>
+        using WatchCallback = std::function<void(const std::string& key)>;
+
+        /// <summary> Result of beginning the load of a missing key. </summary>
+        enum class LoadStatus {
+            /// <summary> The caller runs the loader, and ends the load by EndLoad. </summary>
+            LOAD,
+
+            /// <summary> Another thread loaded the key meanwhile. </summary>
+            LOADED,
+
+            /// <summary> The loader failed on another thread. </summary>
+            FAILED,
+
+            /// <summary> The calling thread is loading the key already, from the loader it runs. </summary>
+            REENTERED,
+
+            /// <summary> The thread loading the key waits, through the loads of other threads, for a key of the caller. </summary>
+            CYCLE,
+
+            /// <summary> The load on another thread didn't end within the wait timeout of the loader. </summary>
+            TIMEDOUT
+        };
+
+        /// <summary> Keys with their values, to set many values at once. </summary>
+        using EntryList = std::vector<std::pair<std::string, std::shared_ptr<ValueType>>>;
+
+        /// <summary> A consistent read view of a store, which reads values as they were when it was created. </summary>
+        /// <remarks>
+        /// Writes don't wait for views. Values replaced or deleted after the view was created are kept for it
+        /// until it's destroyed. Numbers updated in place by Increment, Add and CompareAndSet are read as they are now.
+        /// </remarks>
+        class View {
+        public:
+            /// <summary> Get value by a key, as it was when the view was created. </summary>
+            /// <returns> A ValueType shared pointer, empty if not found. </returns>
+            virtual std::shared_ptr<ValueType> Get(const char* key) const = 0;
+
+            /// <summary> Get many values, as they were when the view was created. </summary>
+            /// <returns> Values in the order of keys, empty for keys not found. </returns>
+            virtual std::vector<std::shared_ptr<ValueType>> GetMany(const std::vector<std::string>& keys) const = 0;
+
+            /// <summary> Check if the store had a key when the view was created. </summary>
+            virtual bool Has(const char* key) const = 0;
+
+            /// <summary> Destructor, which lets the store drop values kept for the view. </summary>
+            virtual ~View() = default;
         };
 
         /// <summary> Get ID of this store. </summary>
         virtual const char* GetId() const = 0;
 
+        /// <summary> Get options the store was created with. </summary>
+        virtual const StoreOptions& GetOptions() const = 0;
+
         /// <summary> Set value with a key. </summary>
         /// <param name="key"> Case-sensitive key to set. </param>
         /// <param name="value"> A shared pointer of ValueType,
         /// which is composed by a pair of payload and transport context. </returns>
         virtual void Set(const char* key, std::shared_ptr<ValueType> value) = 0;
 
+        /// <summary> Set value with a key, which expires after a time to live. </summary>
+        /// <param name="key"> Case-sensitive key to set. </param>
+        /// <param name="value"> A shared pointer of ValueType. </param>
+        /// <param name="ttl"> Time to live in milliseconds, 0 for never expiring. </param>
+        /// <remarks> Expired values are not returned, and dropped by a background sweep within a second. </remarks>
+        virtual void Set(const char* key, std::shared_ptr<ValueType> value, uint32_t ttl) = 0;
+
         /// <summary> Get value by a key. </summary>
         /// <param name="key"> Case-sensitive key to get. </param>
         /// <returns> A ValueType shared pointer, empty if not found. </returns>
         virtual std::shared_ptr<ValueType> Get(const char* key) const = 0;
 
+        /// <summary> Set many values, taking the lock of each shard once. </summary>
+        /// <param name="entries"> Keys with their values. A later entry of the same key wins. </param>
+        /// <param name="ttl"> Time to live in milliseconds of all values, 0 for never expiring. </param>
+        virtual void SetMany(const EntryList& entries, uint32_t ttl) = 0;
+
+        /// <summary> Get many values, taking the lock of each shard once. </summary>
+        /// <param name="keys"> Case-sensitive keys to get. </param>
+        /// <returns> Values in the order of keys, empty for keys not found. </returns>
+        virtual std::vector<std::shared_ptr<ValueType>> GetMany(const std::vector<std::string>& keys) const = 0;
+
+        /// <summary> Get keys with a prefix, in order. </summary>
+        /// <param name="prefix"> Case-sensitive prefix, empty for all keys. </param>
+        /// <returns> Keys in byte order, taken from a consistent snapshot of all shards. </returns>
+        virtual std::vector<std::string> Keys(const char* prefix) const = 0;
+
+        /// <summary> Get keys and values in a range of keys, in order. </summary>
+        /// <param name="from"> Inclusive lower bound of keys. </param>
+        /// <param name="to"> Exclusive upper bound of keys, empty for no bound. </param>
+        /// <returns>
+        /// Entries in byte order of keys, taken from a consistent snapshot of all shards.
+        /// Values are shared with the store, so iterating the snapshot doesn't copy them.
+        /// </returns>
+        virtual EntryList Range(const char* from, const char* to) const = 0;
+
+        /// <summary> Apply a JSON merge patch (RFC 7386) to the value of a key atomically. </summary>
+        /// <param name="key"> Case-sensitive key, which is set to the patch applied to null if it doesn't exist. </param>
+        /// <param name="patch"> JSON of the patch in UTF-16. </param>
+        /// <returns>
+        /// False if the key holds a number or a value with shared objects in its transport context,
+        /// or the patch or the payload is not valid JSON, in which case the value is not changed.
+        /// </returns>
+        /// <remarks>
+        /// The patch is applied without any lock held, and the patched value replaces the value only if the key
+        /// wasn't set meanwhile, otherwise it's applied again. The patched value keeps the time to live of the value.
+        /// </remarks>
+        virtual bool Patch(const char* key, const std::u16string& patch) = 0;
+
+        /// <summary> Create a consistent read view of this store. </summary>
+        /// <returns> The view, or nullptr for stores in named shared memory, which don't keep replaced values. </returns>
+        /// <remarks>
+        /// Each write under the lock of a shard gets a sequence number, SetMany writes the values of a shard at once.
+        /// A view reads the values of the writes that came before it, and none that came after it.
+        /// </remarks>
+        virtual std::shared_ptr<View> CreateView() const = 0;
+
+        /// <summary> Set the loader of missing keys, a function of a module that any isolate can load. </summary>
+        /// <param name="moduleName"> Module of the function, empty for a global function. </param>
+        /// <param name="functionName"> Name of the function, which can have multiple levels like 'foo.bar'. </param>
+        /// <param name="ttl"> Time to live in milliseconds of loaded values, 0 for never expiring. </param>
+        /// <param name="waitTimeout"> Milliseconds callers wait for the load of a key on another thread, 0 to not wait. </param>
+        virtual void SetLoader(
+            const std::string& moduleName,
+            const std::string& functionName,
+            uint32_t ttl,
+            uint32_t waitTimeout) = 0;
+
+        /// <summary> Get the loader of missing keys. </summary>
+        /// <returns> False if no loader is set. </returns>
+        virtual bool GetLoader(std::string& moduleName, std::string& functionName, uint32_t& ttl) const = 0;
+
+        /// <summary> Begin the load of a missing key, or wait for the load of the key another thread runs. </summary>
+        /// <param name="key"> Case-sensitive key, which the caller found missing. </param>
+        /// <param name="value"> Receives the value the other thread loaded, nullptr if it loaded none. </param>
+        /// <param name="error"> Receives the error of the loader on the other thread, if it failed. </param>
+        /// <returns>
+        ///     LOAD if the caller runs the loader, REENTERED or CYCLE if waiting would deadlock, TIMEDOUT if the other
+        ///     load didn't end within the wait timeout, otherwise the result of the other load.
+        /// </returns>
+        /// <remarks> Waiting blocks the calling thread until the other thread calls EndLoad, or the wait times out. </remarks>
+        virtual LoadStatus BeginLoad(const char* key, std::shared_ptr<ValueType>& value, std::string& error) = 0;
+
+        /// <summary> End the load of a key begun by BeginLoad, after the caller set the loaded value. </summary>
+        /// <param name="key"> Case-sensitive key. </param>
+        /// <param name="value"> The value set, which the threads waiting for the load get. nullptr if none was loaded. </param>
+        /// <param name="error"> Error of the loader, empty if it succeeded. </param>
+        virtual void EndLoad(const char* key, std::shared_ptr<ValueType> value, const std::string& error) = 0;
+
+        /// <summary> Add to an integer number, which is created as 0 if the key doesn't exist. </summary>
+        /// <param name="key"> Case-sensitive key. </param>
+        /// <param name="delta"> Integer to add. </param>
+        /// <param name="result"> Receives the number after adding. </param>
+        /// <returns> False if the key holds a value or a floating point number. </returns>
+        /// <remarks>
+        /// Numbers are kept by the store instead of being marshalled. Existing numbers are updated atomically
+        /// under the shared lock of their shard, Get returns them as values of their JSON payload.
+        /// </remarks>
+        virtual bool Increment(const char* key, int64_t delta, int64_t& result) = 0;
+
+        /// <summary> Add to a number, which is created as a floating point 0 if the key doesn't exist. </summary>
+        /// <param name="key"> Case-sensitive key. </param>
+        /// <param name="delta"> Number to add, which must be an integer if the key holds an integer number. </param>
+        /// <param name="result"> Receives the number after adding. </param>
+        /// <returns> False if the key holds a value, or an integer number and delta is not an integer. </returns>
+        virtual bool Add(const char* key, double delta, double& result) = 0;
+
+        /// <summary> Replace a number with desired if it equals expected. </summary>
+        /// <param name="key"> Case-sensitive key. </param>
+        /// <param name="expected"> Number the key is expected to hold. </param>
+        /// <param name="desired"> Number to replace with, which must be an integer if the key holds an integer number. </param>
+        /// <returns> True if the number was replaced, false if it didn't equal expected or the key holds no number. </returns>
+        virtual bool CompareAndSet(const char* key, double expected, double desired) = 0;
+
+        /// <summary> Get a number by a key. </summary>
+        /// <param name="key"> Case-sensitive key. </param>
+        /// <param name="value"> Receives the number. </param>
+        /// <returns> False if the key doesn't exist or holds a value. </returns>
+        virtual bool GetNumber(const char* key, double& value) const = 0;
+
+        /// <summary> Write values and numbers of this store to a snapshot file, which Load reads back after a restart. </summary>
+        /// <param name="path"> Path of the file, which is replaced if it exists. </param>
+        /// <param name="saved"> Receives the number of keys written. </param>
+        /// <returns> False if the file can't be written. </returns>
+        /// <remarks>
+        /// Each shard is written under its shared lock. Values with shared objects in their transport contexts,
+        /// like SharedArrayBuffers and transferred ArrayBuffers, only live in process memory and are skipped.
+        /// A time to live continues from what remained when the snapshot was taken.
+        /// </remarks>
+        virtual bool Snapshot(const char* path, size_t& saved) const = 0;
+
+        /// <summary> Set values and numbers from a snapshot file written by Snapshot. </summary>
+        /// <param name="path"> Path of the file. </param>
+        /// <param name="loaded"> Receives the number of keys set. </param>
+        /// <returns> False if the file can't be read or is not a valid snapshot, in which case nothing is set. </returns>
+        /// <remarks> The file is memory mapped and validated before the keys are set, existing keys are overwritten. </remarks>
+        virtual bool Load(const char* path, size_t& loaded) = 0;
+
         /// <summary> Check if this store has a key. </summary>
         /// <param name="key"> Case-sensitive key. </param>
         /// <returns> True if the key exists in store. </returns>
@@ -48,9 +377,27 @@ namespace store {
         /// <summary> Delete a key. No-op if key is not found in store. </summary>
         virtual void Delete(const char* key) = 0;
 
+        /// <summary> Watch changes of a key, or of keys with a prefix. </summary>
+        /// <param name="pattern"> A key, or a prefix followed by '*'. </param>
+        /// <param name="callback">
+        /// Called after a matching key is set, deleted, loaded or has its number updated,
+        /// on the thread that changed it and without any lock of the store held. It's not called for evicted or expired values.
+        /// </param>
+        /// <returns> Id of the watch, unique in the process. </returns>
+        virtual uint64_t Watch(const char* pattern, WatchCallback callback) = 0;
+
+        /// <summary> Stop a watch. A change being notified on another thread may still call its callback once. </summary>
+        /// <param name="watchId"> Id returned by Watch. </param>
+        virtual void Unwatch(uint64_t watchId) = 0;
+
         /// <summary> Return size of the store. </summary>
+        /// <remarks> Expired values count until they are swept. </remarks>
         virtual size_t Size() const = 0;
 
+        /// <summary> Get counters of this store. </summary>
+        /// <remarks> Stores in named shared memory report the bytes of their append-only heap, which they count as payload bytes. </remarks>
+        virtual StoreStatistics GetStatistics() const = 0;
+
         /// <summary> Destructor. </summary>
         virtual ~Store() = default;
     };
@@ -60,11 +407,26 @@ namespace store {
     /// <returns> Newly created store, or nullptr if store associated with id already exists. </summary>
     NAPA_API std::shared_ptr<Store> CreateStore(const char* id);
 
+    /// <summary> Create a store by id with options. </summary>
+    /// <param name="id"> Case-sensitive id, starting with SHARED_STORE_PREFIX for a store in named shared memory. </summary>
+    /// <param name="options"> Options of the new store, shards are clamped to [1, MAX_STORE_SHARDS]. </summary>
+    /// <returns>
+    /// Newly created store, or nullptr if store associated with id already exists in this process,
+    /// or its shared memory can't be mapped.
+    /// </summary>
+    NAPA_API std::shared_ptr<Store> CreateStore(const char* id, const StoreOptions& options);
+
     /// <summary> Get or create a store by id. </summary>
     /// <param name="id"> Case-sensitive id. </summary>
     /// <returns> Existing or newly created store. Should never be nullptr. </summary>
     NAPA_API std::shared_ptr<Store> GetOrCreateStore(const char* id);
 
+    /// <summary> Get or create a store by id, options only apply if the store is created. </summary>
+    /// <param name="id"> Case-sensitive id. </summary>
+    /// <param name="options"> Options of the store if it's created. </summary>
+    /// <returns> Existing or newly created store. Only nullptr if shared memory of a shared store can't be mapped. </summary>
+    NAPA_API std::shared_ptr<Store> GetOrCreateStore(const char* id, const StoreOptions& options);
+
     /// <summary> Get a store by id. </summary>
     /// <param name="id"> Case-sensitive id. </summary>
     /// <returns> Existing store or nullptr if not found. </summary>
@@ -72,5 +434,8 @@ namespace store {
 
     /// <summary> Get store count currently in use. </summary>
     NAPA_API size_t GetStoreCount();
+
+    /// <summary> Get the stores currently in use, in order of their ids. </summary>
+    NAPA_API std::vector<std::shared_ptr<Store>> GetStores();
 }
 }
\ No newline at end of file
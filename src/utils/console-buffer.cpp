@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "console-buffer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+using namespace napa::utils;
+
+struct ConsoleBuffer::ThreadBuffer {
+    std::mutex mutex;
+    std::string text;
+
+    /// <summary> Set once the writing thread exits, so the buffer is released when written. </summary>
+    std::atomic<bool> abandoned{ false };
+};
+
+namespace {
+
+    std::atomic<uint64_t> _nextBufferId(1);
+
+    /// <summary> The buffer of the current thread, and the console buffer it belongs to. </summary>
+    struct ThreadBufferHolder {
+        uint64_t ownerId = 0;
+        std::shared_ptr<ConsoleBuffer::ThreadBuffer> buffer;
+
+        ~ThreadBufferHolder() {
+            if (buffer != nullptr) {
+                buffer->abandoned.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    thread_local ThreadBufferHolder _threadBuffer;
+}
+
+ConsoleBuffer::ConsoleBuffer(std::function<void(const std::string&)> write) :
+    _id(_nextBufferId++),
+    _write(std::move(write)),
+    _flushSize(ConsoleBufferOptions().flushSize),
+    _flushInterval(ConsoleBufferOptions().flushInterval),
+    _flushRequested(false),
+    _started(false),
+    _stopping(false) {
+}
+
+ConsoleBuffer::~ConsoleBuffer() {
+    Stop();
+}
+
+void ConsoleBuffer::Start(const ConsoleBufferOptions& options) {
+    std::lock_guard<std::mutex> lock(_writerMutex);
+    _flushSize = std::max<size_t>(options.flushSize, 1);
+    _flushInterval = options.flushInterval;
+    if (_started) {
+        return;
+    }
+
+    _stopping = false;
+    _started = true;
+    _writer = std::thread(&ConsoleBuffer::Run, this);
+}
+
+void ConsoleBuffer::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(_writerMutex);
+        if (!_started || _stopping) {
+            return;
+        }
+        _stopping = true;
+    }
+    _wakeUp.notify_one();
+    _writer.join();
+
+    // Lines written while the writer thread stopped are flushed once it's gone, later lines are written through.
+    _started = false;
+    Flush();
+}
+
+bool ConsoleBuffer::IsStarted() const {
+    return _started.load(std::memory_order_acquire);
+}
+
+void ConsoleBuffer::WriteLine(const std::string& line) {
+    if (!_started.load(std::memory_order_acquire)) {
+        Write(line + '\n');
+        return;
+    }
+
+    auto& buffer = GetThreadBuffer();
+    size_t size;
+    {
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.text += line;
+        buffer.text += '\n';
+        size = buffer.text.size();
+    }
+
+    auto flushSize = _flushSize.load(std::memory_order_relaxed);
+    if (!_started.load(std::memory_order_acquire)) {
+        // Stopped while the line was buffered, its final flush may have missed it.
+        Flush();
+    } else if (size >= 4 * flushSize) {
+        // The writer thread falls behind, the output is written by this thread instead of growing the buffer.
+        Flush();
+    } else if (size >= flushSize && !_flushRequested.exchange(true, std::memory_order_relaxed)) {
+        // A wake up lost to a writer that is about to wait only delays the output by up to a flush interval.
+        _wakeUp.notify_one();
+    }
+}
+
+void ConsoleBuffer::Flush() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        buffers = _buffers;
+    }
+
+    // Buffers are taken under the output lock, so output flushed by another thread is written before them.
+    std::lock_guard<std::mutex> outputLock(_outputMutex);
+    std::string text;
+    bool released = false;
+    for (const auto& buffer : buffers) {
+        // The abandoned flag is read first, the text taken after it is the last of its thread.
+        auto abandoned = buffer->abandoned.load(std::memory_order_acquire);
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        text += buffer->text;
+        buffer->text.clear();
+        released |= abandoned;
+    }
+
+    if (!text.empty()) {
+        _write(text);
+    }
+
+    if (released) {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        _buffers.erase(
+            std::remove_if(_buffers.begin(), _buffers.end(), [](const std::shared_ptr<ThreadBuffer>& buffer) {
+                if (!buffer->abandoned.load(std::memory_order_acquire)) {
+                    return false;
+                }
+                std::lock_guard<std::mutex> lock(buffer->mutex);
+                return buffer->text.empty();
+            }),
+            _buffers.end());
+    }
+}
+
+ConsoleBuffer::ThreadBuffer& ConsoleBuffer::GetThreadBuffer() {
+    if (_threadBuffer.ownerId != _id) {
+        if (_threadBuffer.buffer != nullptr) {
+            _threadBuffer.buffer->abandoned.store(true, std::memory_order_release);
+        }
+        auto buffer = std::make_shared<ThreadBuffer>();
+        {
+            std::lock_guard<std::mutex> lock(_buffersMutex);
+            _buffers.push_back(buffer);
+        }
+        _threadBuffer.buffer = std::move(buffer);
+        _threadBuffer.ownerId = _id;
+    }
+    return *_threadBuffer.buffer;
+}
+
+void ConsoleBuffer::Run() {
+    std::unique_lock<std::mutex> lock(_writerMutex);
+    while (!_stopping) {
+        _wakeUp.wait_for(lock, _flushInterval, [this]() { return _flushRequested || _stopping; });
+
+        _flushRequested = false;
+        lock.unlock();
+        Flush();
+        lock.lock();
+    }
+}
+
+void ConsoleBuffer::Write(const std::string& text) {
+    std::lock_guard<std::mutex> lock(_outputMutex);
+    _write(text);
+}
+
+ConsoleBuffer& napa::utils::GetConsoleBuffer() {
+    static ConsoleBuffer buffer([](const std::string& text) {
+        std::cout.write(text.data(), static_cast<std::streamsize>(text.size()));
+        std::cout.flush();
+    });
+    return buffer;
+}
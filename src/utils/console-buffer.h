@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/exports.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace napa {
+namespace utils {
+
+    /// <summary> Options of the buffered console output. </summary>
+    struct ConsoleBufferOptions {
+
+        /// <summary> The bytes a thread buffers before its output is flushed without waiting for the interval. </summary>
+        size_t flushSize = 64 * 1024;
+
+        /// <summary> The longest time output waits in a buffer. </summary>
+        std::chrono::milliseconds flushInterval = std::chrono::milliseconds(10);
+    };
+
+    /// <summary> Console output of the threads of the process, buffered per thread and written by a background thread. </summary>
+    /// <remarks>
+    ///     Each thread appends its lines to its own buffer, under a lock only the writer thread contends for.
+    ///     The writer thread writes all buffers every flush interval, or sooner once a buffer reaches the flush size,
+    ///     with one write for all of them. Lines of a thread keep their order, lines of different threads are
+    ///     interleaved by buffer. A thread whose buffer grows past 4 times the flush size writes the buffers itself,
+    ///     so output is never dropped. Until Start and after Stop lines are written through.
+    /// </remarks>
+    class ConsoleBuffer {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="write"> Writes text to the output, called by one thread at a time. </param>
+        explicit ConsoleBuffer(std::function<void(const std::string&)> write);
+
+        /// <summary> Writes the buffered output and stops the writer thread. </summary>
+        ~ConsoleBuffer();
+
+        /// <summary> Starts buffering output, or changes the options if started. </summary>
+        void Start(const ConsoleBufferOptions& options);
+
+        /// <summary> Writes the buffered output and stops the writer thread, lines are written through afterwards. </summary>
+        void Stop();
+
+        /// <summary> Tells if output is buffered. </summary>
+        bool IsStarted() const;
+
+        /// <summary> Writes a line, a new line is appended to it. </summary>
+        void WriteLine(const std::string& line);
+
+        /// <summary> Writes the output buffered so far, and returns once it is written. </summary>
+        void Flush();
+
+        /// <summary> The buffer of a writing thread. </summary>
+        struct ThreadBuffer;
+
+    private:
+
+        ConsoleBuffer(const ConsoleBuffer&) = delete;
+        ConsoleBuffer& operator=(const ConsoleBuffer&) = delete;
+
+        ThreadBuffer& GetThreadBuffer();
+        void Run();
+        void Write(const std::string& text);
+
+        const uint64_t _id;
+        std::function<void(const std::string&)> _write;
+
+        std::atomic<size_t> _flushSize;
+        std::chrono::milliseconds _flushInterval;
+
+        std::mutex _buffersMutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> _buffers;
+
+        std::mutex _writerMutex;
+        std::condition_variable _wakeUp;
+        std::atomic<bool> _flushRequested;
+        std::atomic<bool> _started;
+        bool _stopping;
+        std::thread _writer;
+
+        /// <summary> Serializes writes, so buffers flushed by different threads aren't interleaved. </summary>
+        std::mutex _outputMutex;
+    };
+
+    /// <summary> Get the buffer of the standard output, which console.log of napa workers writes to. </summary>
+    /// <remarks> It's started by the 'consoleBufferSize' platform setting, and stopped by napa_shutdown or at exit. </remarks>
+    NAPA_API ConsoleBuffer& GetConsoleBuffer();
+}
+}
@@ -0,0 +1,298 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "hash.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define NAPA_HASH_SSE42
+#include <nmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define NAPA_HASH_ARM_CRC32
+#include <arm_acle.h>
+#endif
+
+using namespace napa::utils;
+
+namespace {
+
+    // Bytes are read as little-endian words, the byte order of the platforms napa runs on.
+    inline uint64_t Read64(const uint8_t* p) {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t Read32(const uint8_t* p) {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t RotateLeft(uint64_t value, int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline uint32_t RotateRight(uint32_t value, int bits) {
+        return (value >> bits) | (value << (32 - bits));
+    }
+
+    constexpr uint64_t XXH_PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t XXH_PRIME64_3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t XXH_PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t XxHashRound(uint64_t accumulator, uint64_t input) {
+        accumulator += input * XXH_PRIME64_2;
+        return RotateLeft(accumulator, 31) * XXH_PRIME64_1;
+    }
+
+    inline uint64_t XxHashMergeRound(uint64_t hash, uint64_t accumulator) {
+        hash ^= XxHashRound(0, accumulator);
+        return hash * XXH_PRIME64_1 + XXH_PRIME64_4;
+    }
+
+    /// <summary> Tables of the CRC-32C of a byte followed by 0 to 7 zero bytes, to process 8 bytes at a time. </summary>
+    struct Crc32cTables {
+        uint32_t table[8][256];
+
+        Crc32cTables() {
+            // 0x82F63B78 is the Castagnoli polynomial with reflected bits.
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; bit++) {
+                    crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+                }
+                table[0][i] = crc;
+            }
+            for (uint32_t i = 0; i < 256; i++) {
+                for (int slice = 1; slice < 8; slice++) {
+                    table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+                }
+            }
+        }
+    };
+
+    uint32_t SoftwareCrc32c(const uint8_t* p, size_t length, uint32_t crc) {
+        static const Crc32cTables tables;
+        auto& t = tables.table;
+
+        for (; length >= 8; p += 8, length -= 8) {
+            auto low = Read32(p) ^ crc;
+            auto high = Read32(p + 4);
+            crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+                ^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        }
+        for (; length > 0; p++, length--) {
+            crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xFF];
+        }
+        return crc;
+    }
+
+#if defined(NAPA_HASH_SSE42)
+
+    bool IsSse42Supported() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 20)) != 0;
+#else
+        return __builtin_cpu_supports("sse4.2");
+#endif
+    }
+
+    // The function is compiled for SSE4.2 alone, it's only called on CPUs that have it.
+#if !defined(_MSC_VER)
+    __attribute__((target("sse4.2")))
+#endif
+    uint32_t HardwareCrc32c(const uint8_t* p, size_t length, uint32_t crc) {
+        uint64_t crc64 = crc;
+        for (; length >= 8; p += 8, length -= 8) {
+            crc64 = _mm_crc32_u64(crc64, Read64(p));
+        }
+        crc = static_cast<uint32_t>(crc64);
+        for (; length > 0; p++, length--) {
+            crc = _mm_crc32_u8(crc, *p);
+        }
+        return crc;
+    }
+
+    const bool HARDWARE_CRC32C = IsSse42Supported();
+
+#elif defined(NAPA_HASH_ARM_CRC32)
+
+    uint32_t HardwareCrc32c(const uint8_t* p, size_t length, uint32_t crc) {
+        for (; length >= 8; p += 8, length -= 8) {
+            crc = __crc32cd(crc, Read64(p));
+        }
+        for (; length > 0; p++, length--) {
+            crc = __crc32cb(crc, *p);
+        }
+        return crc;
+    }
+
+    const bool HARDWARE_CRC32C = true;
+
+#else
+
+    const bool HARDWARE_CRC32C = false;
+
+#endif
+
+    const uint32_t SHA256_ROUND_CONSTANTS[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    /// <summary> Process a 64-byte block of a SHA-256 message. </summary>
+    void Sha256Block(uint32_t state[8], const uint8_t* block) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++) {
+            w[i] = (static_cast<uint32_t>(block[i * 4]) << 24) | (static_cast<uint32_t>(block[i * 4 + 1]) << 16)
+                | (static_cast<uint32_t>(block[i * 4 + 2]) << 8) | static_cast<uint32_t>(block[i * 4 + 3]);
+        }
+        for (int i = 16; i < 64; i++) {
+            auto s0 = RotateRight(w[i - 15], 7) ^ RotateRight(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            auto s1 = RotateRight(w[i - 2], 17) ^ RotateRight(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; i++) {
+            auto s1 = RotateRight(e, 6) ^ RotateRight(e, 11) ^ RotateRight(e, 25);
+            auto choice = (e & f) ^ (~e & g);
+            auto temp1 = h + s1 + choice + SHA256_ROUND_CONSTANTS[i] + w[i];
+            auto s0 = RotateRight(a, 2) ^ RotateRight(a, 13) ^ RotateRight(a, 22);
+            auto majority = (a & b) ^ (a & c) ^ (b & c);
+            auto temp2 = s0 + majority;
+
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+}
+
+uint64_t hash::XxHash64(const void* data, size_t length, uint64_t seed) {
+    auto p = static_cast<const uint8_t*>(data);
+    auto end = p + length;
+
+    uint64_t hash;
+    if (length >= 32) {
+        uint64_t v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        uint64_t v2 = seed + XXH_PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH_PRIME64_1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = XxHashRound(v1, Read64(p));
+            v2 = XxHashRound(v2, Read64(p + 8));
+            v3 = XxHashRound(v3, Read64(p + 16));
+            v4 = XxHashRound(v4, Read64(p + 24));
+        }
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = XxHashMergeRound(hash, v1);
+        hash = XxHashMergeRound(hash, v2);
+        hash = XxHashMergeRound(hash, v3);
+        hash = XxHashMergeRound(hash, v4);
+    } else {
+        hash = seed + XXH_PRIME64_5;
+    }
+    hash += static_cast<uint64_t>(length);
+
+    for (; p + 8 <= end; p += 8) {
+        hash ^= XxHashRound(0, Read64(p));
+        hash = RotateLeft(hash, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        hash ^= static_cast<uint64_t>(Read32(p)) * XXH_PRIME64_1;
+        hash = RotateLeft(hash, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        hash ^= *p * XXH_PRIME64_5;
+        hash = RotateLeft(hash, 11) * XXH_PRIME64_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint32_t hash::Crc32c(const void* data, size_t length, uint32_t crc) {
+    auto p = static_cast<const uint8_t*>(data);
+#if defined(NAPA_HASH_SSE42) || defined(NAPA_HASH_ARM_CRC32)
+    if (HARDWARE_CRC32C) {
+        return ~HardwareCrc32c(p, length, ~crc);
+    }
+#endif
+    return ~SoftwareCrc32c(p, length, ~crc);
+}
+
+bool hash::IsCrc32cHardwareAccelerated() {
+    return HARDWARE_CRC32C;
+}
+
+std::array<uint8_t, hash::SHA256_DIGEST_SIZE> hash::Sha256(const void* data, size_t length) {
+    uint32_t state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    auto p = static_cast<const uint8_t*>(data);
+    auto remaining = length;
+    for (; remaining >= 64; p += 64, remaining -= 64) {
+        Sha256Block(state, p);
+    }
+
+    // The message ends with a 1 bit, zero padding and its length in bits, in one or two blocks.
+    uint8_t tail[128] = {};
+    std::memcpy(tail, p, remaining);
+    tail[remaining] = 0x80;
+    size_t tailLength = remaining < 56 ? 64 : 128;
+    uint64_t bits = static_cast<uint64_t>(length) * 8;
+    for (int i = 0; i < 8; i++) {
+        tail[tailLength - 1 - i] = static_cast<uint8_t>(bits >> (i * 8));
+    }
+    for (size_t offset = 0; offset < tailLength; offset += 64) {
+        Sha256Block(state, tail + offset);
+    }
+
+    std::array<uint8_t, SHA256_DIGEST_SIZE> digest;
+    for (int i = 0; i < 8; i++) {
+        digest[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+    }
+    return digest;
+}
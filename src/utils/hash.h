@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace napa {
+namespace utils {
+namespace hash {
+
+    /// <summary> Bytes of a SHA-256 digest. </summary>
+    constexpr size_t SHA256_DIGEST_SIZE = 32;
+
+    /// <summary> Hash bytes with the 64-bit xxHash algorithm (XXH64). </summary>
+    /// <remarks> See: https://github.com/Cyan4973/xxHash. </remarks>
+    uint64_t XxHash64(const void* data, size_t length, uint64_t seed = 0);
+
+    /// <summary> Compute the CRC-32C (Castagnoli) of bytes, with SSE4.2 or ARMv8 CRC instructions when the CPU has them. </summary>
+    /// <param name="crc"> The CRC of preceding bytes, to compute the CRC of data given in parts. </param>
+    uint32_t Crc32c(const void* data, size_t length, uint32_t crc = 0);
+
+    /// <summary> Whether Crc32c uses CRC instructions of the CPU. </summary>
+    bool IsCrc32cHardwareAccelerated();
+
+    /// <summary> Compute the SHA-256 digest of bytes. </summary>
+    std::array<uint8_t, SHA256_DIGEST_SIZE> Sha256(const void* data, size_t length);
+
+    /// <summary> Hash a string routing key, tenant or cache key to the number the schedulers route calls by. </summary>
+    /// <remarks> It's stable across processes and platforms, so a key maps to the same worker everywhere. </remarks>
+    inline uint64_t HashRoutingKey(const char* key, size_t length) {
+        return XxHash64(key, length);
+    }
+
+}   // End of namespace hash
+}   // End of namespace utils
+}   // End of namespace napa
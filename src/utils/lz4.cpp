@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "lz4.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+using namespace napa::utils;
+
+namespace {
+
+    /// <summary> Shortest match a sequence encodes. </summary>
+    constexpr size_t MIN_MATCH = 4;
+
+    /// <summary> The block format ends with at least this many literals. </summary>
+    constexpr size_t LAST_LITERALS = 5;
+
+    /// <summary> The last match starts at least this many bytes before the end of the block. </summary>
+    constexpr size_t MATCH_FIND_LIMIT = 12;
+
+    /// <summary> Farthest back a match can be, offsets are 16 bits. </summary>
+    constexpr size_t MAX_OFFSET = 65535;
+
+    constexpr uint32_t HASH_BITS = 12;
+    constexpr uint32_t EMPTY_POSITION = UINT32_MAX;
+
+    /// <summary> Misses in a row before the scan steps over more than one byte, so incompressible input is skipped quickly. </summary>
+    constexpr uint32_t SKIP_TRIGGER = 6;
+
+    inline uint32_t Read32(const uint8_t* data) {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t Hash(uint32_t sequence) {
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    /// <summary> Write a length beyond what its 4 bits of the token hold. </summary>
+    inline uint8_t* WriteLength(uint8_t* output, size_t length) {
+        for (; length >= 255; length -= 255) {
+            *output++ = 255;
+        }
+        *output++ = static_cast<uint8_t>(length);
+        return output;
+    }
+
+    /// <summary> Read a length beyond what its 4 bits of the token hold. </summary>
+    /// <returns> False if the length runs past the end of the block. </returns>
+    inline bool ReadLength(const uint8_t* source, size_t sourceSize, size_t& position, size_t& length) {
+        uint8_t byte;
+        do {
+            if (position >= sourceSize) {
+                return false;
+            }
+            byte = source[position++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    }
+
+    /// <summary> Write a sequence of literals followed by a match, or only literals if matchLength is 0. </summary>
+    uint8_t* WriteSequence(uint8_t* output, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength) {
+        auto token = output++;
+        auto literalBits = static_cast<uint8_t>(std::min<size_t>(literalLength, 15));
+        if (literalLength >= 15) {
+            output = WriteLength(output, literalLength - 15);
+        }
+        std::memcpy(output, literals, literalLength);
+        output += literalLength;
+
+        if (matchLength == 0) {
+            *token = static_cast<uint8_t>(literalBits << 4);
+            return output;
+        }
+
+        *output++ = static_cast<uint8_t>(offset);
+        *output++ = static_cast<uint8_t>(offset >> 8);
+
+        auto extraMatchLength = matchLength - MIN_MATCH;
+        auto matchBits = static_cast<uint8_t>(std::min<size_t>(extraMatchLength, 15));
+        if (extraMatchLength >= 15) {
+            output = WriteLength(output, extraMatchLength - 15);
+        }
+        *token = static_cast<uint8_t>((literalBits << 4) | matchBits);
+        return output;
+    }
+}
+
+size_t lz4::Compress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationCapacity) {
+    if (destinationCapacity < CompressBound(sourceSize) || sourceSize > UINT32_MAX) {
+        return 0;
+    }
+
+    auto output = destination;
+    size_t anchor = 0;
+    if (sourceSize > MATCH_FIND_LIMIT) {
+        uint32_t positions[1 << HASH_BITS];
+        std::fill(std::begin(positions), std::end(positions), EMPTY_POSITION);
+
+        auto matchFindLimit = sourceSize - MATCH_FIND_LIMIT;
+        auto matchLimit = sourceSize - LAST_LITERALS;
+        size_t position = 0;
+        uint32_t misses = 0;
+        while (position < matchFindLimit) {
+            auto sequence = Read32(source + position);
+            auto& entry = positions[Hash(sequence)];
+            size_t candidate = entry;
+            entry = static_cast<uint32_t>(position);
+
+            if (candidate == EMPTY_POSITION
+                || position - candidate > MAX_OFFSET
+                || Read32(source + candidate) != sequence) {
+                position += 1 + (misses++ >> SKIP_TRIGGER);
+                continue;
+            }
+            misses = 0;
+
+            auto matchLength = MIN_MATCH;
+            while (position + matchLength < matchLimit && source[candidate + matchLength] == source[position + matchLength]) {
+                ++matchLength;
+            }
+
+            output = WriteSequence(output, source + anchor, position - anchor, position - candidate, matchLength);
+            position += matchLength;
+            anchor = position;
+        }
+    }
+
+    output = WriteSequence(output, source + anchor, sourceSize - anchor, 0, 0);
+    return static_cast<size_t>(output - destination);
+}
+
+bool lz4::Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize) {
+    size_t input = 0;
+    size_t output = 0;
+    while (input < sourceSize) {
+        auto token = source[input++];
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(source, sourceSize, input, literalLength)) {
+            return false;
+        }
+        if (literalLength > sourceSize - input || literalLength > destinationSize - output) {
+            return false;
+        }
+        std::memcpy(destination + output, source + input, literalLength);
+        input += literalLength;
+        output += literalLength;
+
+        // The last sequence has literals only.
+        if (input == sourceSize) {
+            return output == destinationSize;
+        }
+
+        if (sourceSize - input < 2) {
+            return false;
+        }
+        size_t offset = source[input] | (static_cast<size_t>(source[input + 1]) << 8);
+        input += 2;
+        if (offset == 0 || offset > output) {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(source, sourceSize, input, matchLength)) {
+            return false;
+        }
+        matchLength += MIN_MATCH;
+        if (matchLength > destinationSize - output) {
+            return false;
+        }
+
+        auto match = destination + output - offset;
+        if (offset >= matchLength) {
+            std::memcpy(destination + output, match, matchLength);
+        } else {
+            // Overlapping matches repeat the last offset bytes.
+            for (size_t i = 0; i < matchLength; ++i) {
+                destination[output + i] = match[i];
+            }
+        }
+        output += matchLength;
+    }
+    return false;
+}
@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace napa {
+namespace utils {
+namespace lz4 {
+
+    /// <summary> Get the most bytes Compress writes for an input size. </summary>
+    inline size_t CompressBound(size_t size) {
+        return size + size / 255 + 16;
+    }
+
+    /// <summary> Compress bytes into the LZ4 block format, with greedy matching on a hash table of 4 byte sequences. </summary>
+    /// <param name="source"> Bytes to compress. </param>
+    /// <param name="sourceSize"> Number of bytes to compress. </param>
+    /// <param name="destination"> Buffer to write the block to. </param>
+    /// <param name="destinationCapacity"> Bytes of the buffer, at least CompressBound(sourceSize). </param>
+    /// <returns> Bytes of the block, or 0 if the buffer is smaller than CompressBound(sourceSize). </returns>
+    size_t Compress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationCapacity);
+
+    /// <summary> Decompress a block of the LZ4 block format, checking that it stays within both buffers. </summary>
+    /// <param name="source"> The block. </param>
+    /// <param name="sourceSize"> Bytes of the block. </param>
+    /// <param name="destination"> Buffer to write the decompressed bytes to. </param>
+    /// <param name="destinationSize"> Number of bytes the block decompresses to. </param>
+    /// <returns> False if the block is malformed or doesn't decompress to exactly destinationSize bytes. </returns>
+    bool Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize);
+}
+}
+}
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+// This unit is compiled for AVX2 and FMA, see src/CMakeLists.txt. Its kernels are only called on CPUs that have them.
+
+#include "numeric-kernels-impl.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+using namespace napa::utils::numeric;
+
+#if defined(__AVX2__)
+
+namespace {
+
+    struct Avx2FloatVector {
+        using Scalar = float;
+        using Register = __m256;
+        using Mask = __m256;
+        static constexpr size_t LANES = 8;
+
+        static __m256 Zero() { return _mm256_setzero_ps(); }
+        static __m256 Set(float value) { return _mm256_set1_ps(value); }
+        static __m256 Load(const float* source) { return _mm256_loadu_ps(source); }
+        static void Store(float* destination, __m256 value) { _mm256_storeu_ps(destination, value); }
+        static __m256 Add(__m256 left, __m256 right) { return _mm256_add_ps(left, right); }
+        static __m256 Mul(__m256 left, __m256 right) { return _mm256_mul_ps(left, right); }
+        static __m256 MulAdd(__m256 left, __m256 right, __m256 addend) { return _mm256_fmadd_ps(left, right, addend); }
+        static __m256 Min(__m256 left, __m256 right) { return _mm256_min_ps(left, right); }
+        static __m256 Max(__m256 left, __m256 right) { return _mm256_max_ps(left, right); }
+        static __m256 Unordered(__m256 left, __m256 right) { return _mm256_cmp_ps(left, right, _CMP_UNORD_Q); }
+        static __m256 Or(__m256 left, __m256 right) { return _mm256_or_ps(left, right); }
+        static bool Any(__m256 mask) { return _mm256_movemask_ps(mask) != 0; }
+        static float ReduceAdd(__m256 value) {
+            auto half = _mm_add_ps(_mm256_castps256_ps128(value), _mm256_extractf128_ps(value, 1));
+            auto sum = _mm_add_ps(half, _mm_movehl_ps(half, half));
+            return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1)));
+        }
+    };
+
+    struct Avx2DoubleVector {
+        using Scalar = double;
+        using Register = __m256d;
+        using Mask = __m256d;
+        static constexpr size_t LANES = 4;
+
+        static __m256d Zero() { return _mm256_setzero_pd(); }
+        static __m256d Set(double value) { return _mm256_set1_pd(value); }
+        static __m256d Load(const double* source) { return _mm256_loadu_pd(source); }
+        static void Store(double* destination, __m256d value) { _mm256_storeu_pd(destination, value); }
+        static __m256d Add(__m256d left, __m256d right) { return _mm256_add_pd(left, right); }
+        static __m256d Mul(__m256d left, __m256d right) { return _mm256_mul_pd(left, right); }
+        static __m256d MulAdd(__m256d left, __m256d right, __m256d addend) { return _mm256_fmadd_pd(left, right, addend); }
+        static __m256d Min(__m256d left, __m256d right) { return _mm256_min_pd(left, right); }
+        static __m256d Max(__m256d left, __m256d right) { return _mm256_max_pd(left, right); }
+        static __m256d Unordered(__m256d left, __m256d right) { return _mm256_cmp_pd(left, right, _CMP_UNORD_Q); }
+        static __m256d Or(__m256d left, __m256d right) { return _mm256_or_pd(left, right); }
+        static bool Any(__m256d mask) { return _mm256_movemask_pd(mask) != 0; }
+        static double ReduceAdd(__m256d value) {
+            auto half = _mm_add_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+            return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+        }
+    };
+
+    const Kernels<float> avx2FloatKernels = kernels::MakeKernels<Avx2FloatVector>();
+    const Kernels<double> avx2DoubleKernels = kernels::MakeKernels<Avx2DoubleVector>();
+}
+
+const Kernels<float>* kernels::GetAvx2FloatKernels() {
+    return &avx2FloatKernels;
+}
+
+const Kernels<double>* kernels::GetAvx2DoubleKernels() {
+    return &avx2DoubleKernels;
+}
+
+#else
+
+const Kernels<float>* kernels::GetAvx2FloatKernels() {
+    return nullptr;
+}
+
+const Kernels<double>* kernels::GetAvx2DoubleKernels() {
+    return nullptr;
+}
+
+#endif
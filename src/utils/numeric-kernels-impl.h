@@ -0,0 +1,175 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "numeric-kernels.h"
+
+#include <cstddef>
+
+// Kernels are written once over a vector type V, which each instruction set defines in an anonymous namespace of its
+// own translation unit. Their instantiations then have internal linkage, so code compiled for AVX2 is never picked by
+// the linker for a CPU without it. They must only call V, std functions would be shared across units.
+//
+// V has Scalar, Register, Mask and LANES, and static Zero, Set, Load, Store, Add, Mul, MulAdd(a, b, c) = a * b + c,
+// Min, Max, Unordered(a, b) (lanes where either is NaN), Or, Any and ReduceAdd.
+
+namespace napa {
+namespace utils {
+namespace numeric {
+namespace kernels {
+
+    template <typename V>
+    typename V::Scalar Sum(const typename V::Scalar* values, size_t count) {
+        constexpr size_t lanes = V::LANES;
+
+        // 4 accumulators hide the latency of additions.
+        auto sum0 = V::Zero();
+        auto sum1 = V::Zero();
+        auto sum2 = V::Zero();
+        auto sum3 = V::Zero();
+        size_t i = 0;
+        for (; i + 4 * lanes <= count; i += 4 * lanes) {
+            sum0 = V::Add(sum0, V::Load(values + i));
+            sum1 = V::Add(sum1, V::Load(values + i + lanes));
+            sum2 = V::Add(sum2, V::Load(values + i + 2 * lanes));
+            sum3 = V::Add(sum3, V::Load(values + i + 3 * lanes));
+        }
+        for (; i + lanes <= count; i += lanes) {
+            sum0 = V::Add(sum0, V::Load(values + i));
+        }
+
+        auto result = V::ReduceAdd(V::Add(V::Add(sum0, sum1), V::Add(sum2, sum3)));
+        for (; i < count; i++) {
+            result += values[i];
+        }
+        return result;
+    }
+
+    template <typename V>
+    typename V::Scalar Dot(const typename V::Scalar* left, const typename V::Scalar* right, size_t count) {
+        constexpr size_t lanes = V::LANES;
+
+        auto sum0 = V::Zero();
+        auto sum1 = V::Zero();
+        auto sum2 = V::Zero();
+        auto sum3 = V::Zero();
+        size_t i = 0;
+        for (; i + 4 * lanes <= count; i += 4 * lanes) {
+            sum0 = V::MulAdd(V::Load(left + i), V::Load(right + i), sum0);
+            sum1 = V::MulAdd(V::Load(left + i + lanes), V::Load(right + i + lanes), sum1);
+            sum2 = V::MulAdd(V::Load(left + i + 2 * lanes), V::Load(right + i + 2 * lanes), sum2);
+            sum3 = V::MulAdd(V::Load(left + i + 3 * lanes), V::Load(right + i + 3 * lanes), sum3);
+        }
+        for (; i + lanes <= count; i += lanes) {
+            sum0 = V::MulAdd(V::Load(left + i), V::Load(right + i), sum0);
+        }
+
+        auto result = V::ReduceAdd(V::Add(V::Add(sum0, sum1), V::Add(sum2, sum3)));
+        for (; i < count; i++) {
+            result += left[i] * right[i];
+        }
+        return result;
+    }
+
+    /// <summary> Find the smallest or largest value one at a time, the first NaN if any. </summary>
+    template <typename V, bool smallest>
+    typename V::Scalar ExtremeOfEach(const typename V::Scalar* values, size_t count) {
+        auto result = values[0];
+        for (size_t i = 0; i < count; i++) {
+            auto value = values[i];
+            if (value != value) {
+                return value;
+            }
+            if (smallest ? value < result : value > result) {
+                result = value;
+            }
+        }
+        return result;
+    }
+
+    /// <summary> Find the smallest or largest value, NaN if any value is NaN as Math.min and Math.max do. </summary>
+    template <typename V, bool smallest>
+    typename V::Scalar Extreme(const typename V::Scalar* values, size_t count) {
+        constexpr size_t lanes = V::LANES;
+        if (count < lanes) {
+            return ExtremeOfEach<V, smallest>(values, count);
+        }
+
+        // Min and Max of vectors drop NaN in some lanes, NaN is tracked apart.
+        auto extreme = V::Load(values);
+        auto nan = V::Unordered(extreme, extreme);
+        size_t i = lanes;
+        for (; i + lanes <= count; i += lanes) {
+            auto vector = V::Load(values + i);
+            nan = V::Or(nan, V::Unordered(vector, vector));
+            extreme = smallest ? V::Min(extreme, vector) : V::Max(extreme, vector);
+        }
+
+        // The last vector overlaps the previous one, values seen twice don't change the result.
+        if (i < count) {
+            auto vector = V::Load(values + count - lanes);
+            nan = V::Or(nan, V::Unordered(vector, vector));
+            extreme = smallest ? V::Min(extreme, vector) : V::Max(extreme, vector);
+        }
+
+        if (V::Any(nan)) {
+            // Only inputs with NaN are scanned again, to return one of their NaN.
+            return ExtremeOfEach<V, smallest>(values, count);
+        }
+        typename V::Scalar lanesOfExtreme[lanes];
+        V::Store(lanesOfExtreme, extreme);
+        return ExtremeOfEach<V, smallest>(lanesOfExtreme, lanes);
+    }
+
+    template <typename V>
+    typename V::Scalar Minimum(const typename V::Scalar* values, size_t count) {
+        return Extreme<V, true>(values, count);
+    }
+
+    template <typename V>
+    typename V::Scalar Maximum(const typename V::Scalar* values, size_t count) {
+        return Extreme<V, false>(values, count);
+    }
+
+    template <typename V>
+    void Scale(typename V::Scalar* values, size_t count, typename V::Scalar factor) {
+        constexpr size_t lanes = V::LANES;
+
+        auto factors = V::Set(factor);
+        size_t i = 0;
+        for (; i + lanes <= count; i += lanes) {
+            V::Store(values + i, V::Mul(V::Load(values + i), factors));
+        }
+        for (; i < count; i++) {
+            values[i] *= factor;
+        }
+    }
+
+    template <typename V>
+    void Axpy(typename V::Scalar alpha, const typename V::Scalar* x, typename V::Scalar* y, size_t count) {
+        constexpr size_t lanes = V::LANES;
+
+        auto alphas = V::Set(alpha);
+        size_t i = 0;
+        for (; i + lanes <= count; i += lanes) {
+            V::Store(y + i, V::MulAdd(alphas, V::Load(x + i), V::Load(y + i)));
+        }
+        for (; i < count; i++) {
+            y[i] += alpha * x[i];
+        }
+    }
+
+    /// <summary> Make the kernels of a vector type. </summary>
+    template <typename V>
+    Kernels<typename V::Scalar> MakeKernels() {
+        return { Sum<V>, Dot<V>, Minimum<V>, Maximum<V>, Scale<V>, Axpy<V> };
+    }
+
+    /// <summary> Get the AVX2 kernels, nullptr if they're not compiled in. The caller checks the CPU supports AVX2. </summary>
+    const Kernels<float>* GetAvx2FloatKernels();
+    const Kernels<double>* GetAvx2DoubleKernels();
+}
+}
+}
+}
@@ -0,0 +1,282 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "numeric-kernels-impl.h"
+
+#include <initializer_list>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NAPA_NUMERIC_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define NAPA_NUMERIC_NEON
+#include <arm_neon.h>
+#endif
+
+using namespace napa::utils;
+using namespace napa::utils::numeric;
+
+namespace {
+
+    template <typename T>
+    struct ScalarVector {
+        using Scalar = T;
+        using Register = T;
+        using Mask = bool;
+        static constexpr size_t LANES = 1;
+
+        static T Zero() { return 0; }
+        static T Set(T value) { return value; }
+        static T Load(const T* source) { return *source; }
+        static void Store(T* destination, T value) { *destination = value; }
+        static T Add(T left, T right) { return left + right; }
+        static T Mul(T left, T right) { return left * right; }
+        static T MulAdd(T left, T right, T addend) { return left * right + addend; }
+        static T Min(T left, T right) { return right < left ? right : left; }
+        static T Max(T left, T right) { return right > left ? right : left; }
+        static bool Unordered(T left, T right) { return left != left || right != right; }
+        static bool Or(bool left, bool right) { return left || right; }
+        static bool Any(bool mask) { return mask; }
+        static T ReduceAdd(T value) { return value; }
+    };
+
+#if defined(NAPA_NUMERIC_SSE2)
+    struct Sse2FloatVector {
+        using Scalar = float;
+        using Register = __m128;
+        using Mask = __m128;
+        static constexpr size_t LANES = 4;
+
+        static __m128 Zero() { return _mm_setzero_ps(); }
+        static __m128 Set(float value) { return _mm_set1_ps(value); }
+        static __m128 Load(const float* source) { return _mm_loadu_ps(source); }
+        static void Store(float* destination, __m128 value) { _mm_storeu_ps(destination, value); }
+        static __m128 Add(__m128 left, __m128 right) { return _mm_add_ps(left, right); }
+        static __m128 Mul(__m128 left, __m128 right) { return _mm_mul_ps(left, right); }
+        static __m128 MulAdd(__m128 left, __m128 right, __m128 addend) { return _mm_add_ps(_mm_mul_ps(left, right), addend); }
+        static __m128 Min(__m128 left, __m128 right) { return _mm_min_ps(left, right); }
+        static __m128 Max(__m128 left, __m128 right) { return _mm_max_ps(left, right); }
+        static __m128 Unordered(__m128 left, __m128 right) { return _mm_cmpunord_ps(left, right); }
+        static __m128 Or(__m128 left, __m128 right) { return _mm_or_ps(left, right); }
+        static bool Any(__m128 mask) { return _mm_movemask_ps(mask) != 0; }
+        static float ReduceAdd(__m128 value) {
+            auto sum = _mm_add_ps(value, _mm_movehl_ps(value, value));
+            return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1)));
+        }
+    };
+
+    struct Sse2DoubleVector {
+        using Scalar = double;
+        using Register = __m128d;
+        using Mask = __m128d;
+        static constexpr size_t LANES = 2;
+
+        static __m128d Zero() { return _mm_setzero_pd(); }
+        static __m128d Set(double value) { return _mm_set1_pd(value); }
+        static __m128d Load(const double* source) { return _mm_loadu_pd(source); }
+        static void Store(double* destination, __m128d value) { _mm_storeu_pd(destination, value); }
+        static __m128d Add(__m128d left, __m128d right) { return _mm_add_pd(left, right); }
+        static __m128d Mul(__m128d left, __m128d right) { return _mm_mul_pd(left, right); }
+        static __m128d MulAdd(__m128d left, __m128d right, __m128d addend) { return _mm_add_pd(_mm_mul_pd(left, right), addend); }
+        static __m128d Min(__m128d left, __m128d right) { return _mm_min_pd(left, right); }
+        static __m128d Max(__m128d left, __m128d right) { return _mm_max_pd(left, right); }
+        static __m128d Unordered(__m128d left, __m128d right) { return _mm_cmpunord_pd(left, right); }
+        static __m128d Or(__m128d left, __m128d right) { return _mm_or_pd(left, right); }
+        static bool Any(__m128d mask) { return _mm_movemask_pd(mask) != 0; }
+        static double ReduceAdd(__m128d value) { return _mm_cvtsd_f64(_mm_add_sd(value, _mm_unpackhi_pd(value, value))); }
+    };
+#endif
+
+#if defined(NAPA_NUMERIC_NEON)
+    struct NeonFloatVector {
+        using Scalar = float;
+        using Register = float32x4_t;
+        using Mask = uint32x4_t;
+        static constexpr size_t LANES = 4;
+
+        static float32x4_t Zero() { return vdupq_n_f32(0); }
+        static float32x4_t Set(float value) { return vdupq_n_f32(value); }
+        static float32x4_t Load(const float* source) { return vld1q_f32(source); }
+        static void Store(float* destination, float32x4_t value) { vst1q_f32(destination, value); }
+        static float32x4_t Add(float32x4_t left, float32x4_t right) { return vaddq_f32(left, right); }
+        static float32x4_t Mul(float32x4_t left, float32x4_t right) { return vmulq_f32(left, right); }
+        static float32x4_t MulAdd(float32x4_t left, float32x4_t right, float32x4_t addend) { return vfmaq_f32(addend, left, right); }
+        static float32x4_t Min(float32x4_t left, float32x4_t right) { return vminq_f32(left, right); }
+        static float32x4_t Max(float32x4_t left, float32x4_t right) { return vmaxq_f32(left, right); }
+        static uint32x4_t Unordered(float32x4_t left, float32x4_t right) {
+            return vmvnq_u32(vandq_u32(vceqq_f32(left, left), vceqq_f32(right, right)));
+        }
+        static uint32x4_t Or(uint32x4_t left, uint32x4_t right) { return vorrq_u32(left, right); }
+        static bool Any(uint32x4_t mask) { return vmaxvq_u32(mask) != 0; }
+        static float ReduceAdd(float32x4_t value) { return vaddvq_f32(value); }
+    };
+
+    struct NeonDoubleVector {
+        using Scalar = double;
+        using Register = float64x2_t;
+        using Mask = uint64x2_t;
+        static constexpr size_t LANES = 2;
+
+        static float64x2_t Zero() { return vdupq_n_f64(0); }
+        static float64x2_t Set(double value) { return vdupq_n_f64(value); }
+        static float64x2_t Load(const double* source) { return vld1q_f64(source); }
+        static void Store(double* destination, float64x2_t value) { vst1q_f64(destination, value); }
+        static float64x2_t Add(float64x2_t left, float64x2_t right) { return vaddq_f64(left, right); }
+        static float64x2_t Mul(float64x2_t left, float64x2_t right) { return vmulq_f64(left, right); }
+        static float64x2_t MulAdd(float64x2_t left, float64x2_t right, float64x2_t addend) { return vfmaq_f64(addend, left, right); }
+        static float64x2_t Min(float64x2_t left, float64x2_t right) { return vminq_f64(left, right); }
+        static float64x2_t Max(float64x2_t left, float64x2_t right) { return vmaxq_f64(left, right); }
+        static uint64x2_t Unordered(float64x2_t left, float64x2_t right) {
+            auto ordered = vandq_u64(vceqq_f64(left, left), vceqq_f64(right, right));
+            return veorq_u64(ordered, vdupq_n_u64(~0ull));
+        }
+        static uint64x2_t Or(uint64x2_t left, uint64x2_t right) { return vorrq_u64(left, right); }
+        static bool Any(uint64x2_t mask) { return vmaxvq_u32(vreinterpretq_u32_u64(mask)) != 0; }
+        static double ReduceAdd(float64x2_t value) { return vaddvq_f64(value); }
+    };
+#endif
+
+    /// <summary> Whether the CPU and the OS support AVX2 and FMA. </summary>
+    bool IsAvx2Supported() {
+    #if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        // Both check the OS saves the AVX registers.
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    #elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+
+        __cpuid(info, 1);
+        const int fma = 1 << 12;
+        const int osxsave = 1 << 27;
+        const int avx = 1 << 28;
+        if ((info[2] & (fma | osxsave | avx)) != (fma | osxsave | avx) || (_xgetbv(0) & 6) != 6) {
+            return false;
+        }
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+    #else
+        return false;
+    #endif
+    }
+
+    bool IsSupported(InstructionSet instructionSet) {
+        switch (instructionSet) {
+        case InstructionSet::Scalar:
+            return true;
+        case InstructionSet::Sse2:
+        #if defined(NAPA_NUMERIC_SSE2)
+            return true;
+        #else
+            return false;
+        #endif
+        case InstructionSet::Avx2:
+            return kernels::GetAvx2FloatKernels() != nullptr && IsAvx2Supported();
+        case InstructionSet::Neon:
+        #if defined(NAPA_NUMERIC_NEON)
+            return true;
+        #else
+            return false;
+        #endif
+        }
+        return false;
+    }
+
+    const Kernels<float> scalarFloatKernels = kernels::MakeKernels<ScalarVector<float>>();
+    const Kernels<double> scalarDoubleKernels = kernels::MakeKernels<ScalarVector<double>>();
+
+#if defined(NAPA_NUMERIC_SSE2)
+    const Kernels<float> sse2FloatKernels = kernels::MakeKernels<Sse2FloatVector>();
+    const Kernels<double> sse2DoubleKernels = kernels::MakeKernels<Sse2DoubleVector>();
+#endif
+
+#if defined(NAPA_NUMERIC_NEON)
+    const Kernels<float> neonFloatKernels = kernels::MakeKernels<NeonFloatVector>();
+    const Kernels<double> neonDoubleKernels = kernels::MakeKernels<NeonDoubleVector>();
+#endif
+}
+
+const char* numeric::GetInstructionSetName(InstructionSet instructionSet) {
+    switch (instructionSet) {
+    case InstructionSet::Sse2:
+        return "sse2";
+    case InstructionSet::Avx2:
+        return "avx2";
+    case InstructionSet::Neon:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
+
+const Kernels<float>* numeric::GetFloatKernels(InstructionSet instructionSet) {
+    if (!IsSupported(instructionSet)) {
+        return nullptr;
+    }
+    switch (instructionSet) {
+#if defined(NAPA_NUMERIC_SSE2)
+    case InstructionSet::Sse2:
+        return &sse2FloatKernels;
+#endif
+    case InstructionSet::Avx2:
+        return kernels::GetAvx2FloatKernels();
+#if defined(NAPA_NUMERIC_NEON)
+    case InstructionSet::Neon:
+        return &neonFloatKernels;
+#endif
+    default:
+        return &scalarFloatKernels;
+    }
+}
+
+const Kernels<double>* numeric::GetDoubleKernels(InstructionSet instructionSet) {
+    if (!IsSupported(instructionSet)) {
+        return nullptr;
+    }
+    switch (instructionSet) {
+#if defined(NAPA_NUMERIC_SSE2)
+    case InstructionSet::Sse2:
+        return &sse2DoubleKernels;
+#endif
+    case InstructionSet::Avx2:
+        return kernels::GetAvx2DoubleKernels();
+#if defined(NAPA_NUMERIC_NEON)
+    case InstructionSet::Neon:
+        return &neonDoubleKernels;
+#endif
+    default:
+        return &scalarDoubleKernels;
+    }
+}
+
+InstructionSet numeric::GetBestInstructionSet() {
+    static const InstructionSet best = []() {
+        for (auto instructionSet : { InstructionSet::Avx2, InstructionSet::Sse2, InstructionSet::Neon }) {
+            if (IsSupported(instructionSet)) {
+                return instructionSet;
+            }
+        }
+        return InstructionSet::Scalar;
+    }();
+    return best;
+}
+
+const Kernels<float>& numeric::GetFloatKernels() {
+    static const Kernels<float>& best = *GetFloatKernels(GetBestInstructionSet());
+    return best;
+}
+
+const Kernels<double>& numeric::GetDoubleKernels() {
+    static const Kernels<double>& best = *GetDoubleKernels(GetBestInstructionSet());
+    return best;
+}
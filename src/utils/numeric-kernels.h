@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+
+namespace napa {
+namespace utils {
+namespace numeric {
+
+    /// <summary> Instruction sets the kernels are compiled for. </summary>
+    enum class InstructionSet {
+        /// <summary> Plain C++, for CPUs without any of the others. </summary>
+        Scalar,
+
+        /// <summary> 128 bit vectors of x86, which every x64 CPU has. </summary>
+        Sse2,
+
+        /// <summary> 256 bit vectors with fused multiply-add of x86. </summary>
+        Avx2,
+
+        /// <summary> 128 bit vectors of ARM64. </summary>
+        Neon
+    };
+
+    /// <summary> Get the name of an instruction set, such as 'avx2'. </summary>
+    const char* GetInstructionSetName(InstructionSet instructionSet);
+
+    /// <summary> Kernels over arrays of T compiled for an instruction set, which all take unaligned arrays. </summary>
+    /// <remarks>
+    ///     Vector kernels add in another order than a loop would, so sums and dot products may differ from it in the
+    ///     last bits. Sums of float arrays are accumulated in float, as BLAS does.
+    /// </remarks>
+    template <typename T>
+    struct Kernels {
+        /// <summary> Get the sum of values, 0 for none. </summary>
+        T (*sum)(const T* values, size_t count);
+
+        /// <summary> Get the sum of the products of the values of 2 arrays. </summary>
+        T (*dot)(const T* left, const T* right, size_t count);
+
+        /// <summary> Get the smallest of at least 1 value, NaN if any value is NaN. </summary>
+        T (*minimum)(const T* values, size_t count);
+
+        /// <summary> Get the largest of at least 1 value, NaN if any value is NaN. </summary>
+        T (*maximum)(const T* values, size_t count);
+
+        /// <summary> Multiply values by a factor in place. </summary>
+        void (*scale)(T* values, size_t count, T factor);
+
+        /// <summary> Add alpha times the values of x to the values of y in place. </summary>
+        void (*axpy)(T alpha, const T* x, T* y, size_t count);
+    };
+
+    /// <summary> Get the float kernels of an instruction set, nullptr if they're not compiled in or the CPU lacks it. </summary>
+    const Kernels<float>* GetFloatKernels(InstructionSet instructionSet);
+
+    /// <summary> Get the double kernels of an instruction set, nullptr if they're not compiled in or the CPU lacks it. </summary>
+    const Kernels<double>* GetDoubleKernels(InstructionSet instructionSet);
+
+    /// <summary> Get the widest instruction set of the CPU that kernels are compiled for, detected once per process. </summary>
+    InstructionSet GetBestInstructionSet();
+
+    /// <summary> Get the float kernels of the best instruction set. </summary>
+    const Kernels<float>& GetFloatKernels();
+
+    /// <summary> Get the double kernels of the best instruction set. </summary>
+    const Kernels<double>& GetDoubleKernels();
+}
+}
+}
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "payload-compression.h"
+#include "lz4.h"
+
+#include <napa/providers/metric.h>
+
+#include <atomic>
+
+using namespace napa::utils;
+
+namespace {
+
+    std::atomic<uint64_t> _compressedPayloads(0);
+    std::atomic<uint64_t> _bytesBefore(0);
+    std::atomic<uint64_t> _bytesAfter(0);
+
+    /// <summary> Count a payload at or over its threshold, and report its bytes to the metric provider. </summary>
+    void CountPayload(PayloadSource source, size_t before, size_t after) {
+        static const char* dimensionNames[] = { "Source" };
+        static auto beforeMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "PayloadBytesBeforeCompression", napa::providers::MetricType::Rate, 1, dimensionNames);
+        static auto afterMetric = napa::providers::GetMetricProvider().GetMetric(
+            "Napa", "PayloadBytesAfterCompression", napa::providers::MetricType::Rate, 1, dimensionNames);
+
+        if (after < before) {
+            _compressedPayloads.fetch_add(1, std::memory_order_relaxed);
+        }
+        _bytesBefore.fetch_add(before, std::memory_order_relaxed);
+        _bytesAfter.fetch_add(after, std::memory_order_relaxed);
+
+        const char* dimensionValues[] = { source == PayloadSource::Store ? "Store" : "Call" };
+        if (beforeMetric != nullptr) {
+            beforeMetric->Increment(before, 1, dimensionValues);
+        }
+        if (afterMetric != nullptr) {
+            afterMetric->Increment(after, 1, dimensionValues);
+        }
+    }
+}
+
+bool napa::utils::CompressPayload(const void* data, size_t size, size_t threshold, PayloadSource source, std::string& compressed) {
+    if (threshold == 0 || size < threshold || size > UINT32_MAX) {
+        return false;
+    }
+
+    std::string result(COMPRESSED_PAYLOAD_HEADER_SIZE + lz4::CompressBound(size), '\0');
+    auto blockSize = lz4::Compress(
+        static_cast<const uint8_t*>(data),
+        size,
+        reinterpret_cast<uint8_t*>(&result[COMPRESSED_PAYLOAD_HEADER_SIZE]),
+        result.size() - COMPRESSED_PAYLOAD_HEADER_SIZE);
+
+    auto compressedSize = COMPRESSED_PAYLOAD_HEADER_SIZE + blockSize;
+    if (blockSize == 0 || compressedSize >= size) {
+        CountPayload(source, size, size);
+        return false;
+    }
+    CountPayload(source, size, compressedSize);
+
+    auto decompressedSize = static_cast<uint32_t>(size);
+    std::memcpy(&result[0], COMPRESSED_PAYLOAD_MARKER, 4);
+    std::memcpy(&result[4], &decompressedSize, sizeof(decompressedSize));
+    result.resize(compressedSize);
+    result.shrink_to_fit();
+    compressed = std::move(result);
+    return true;
+}
+
+bool napa::utils::CompressPayload(std::string& payload, size_t threshold, PayloadSource source) {
+    return CompressPayload(payload.data(), payload.size(), threshold, source, payload);
+}
+
+bool napa::utils::DecompressPayload(const std::string& compressed, void* data) {
+    return lz4::Decompress(
+        reinterpret_cast<const uint8_t*>(compressed.data() + COMPRESSED_PAYLOAD_HEADER_SIZE),
+        compressed.size() - COMPRESSED_PAYLOAD_HEADER_SIZE,
+        static_cast<uint8_t*>(data),
+        GetDecompressedSize(compressed));
+}
+
+bool napa::utils::DecompressPayload(std::string& payload) {
+    if (!IsCompressedPayload(payload)) {
+        return true;
+    }
+
+    std::string result(GetDecompressedSize(payload), '\0');
+    if (!DecompressPayload(payload, result.empty() ? nullptr : &result[0])) {
+        return false;
+    }
+    payload = std::move(result);
+    return true;
+}
+
+PayloadCompressionStatistics napa::utils::GetPayloadCompressionStatistics() {
+    return {
+        _compressedPayloads.load(std::memory_order_relaxed),
+        _bytesBefore.load(std::memory_order_relaxed),
+        _bytesAfter.load(std::memory_order_relaxed)
+    };
+}
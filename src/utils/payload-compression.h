@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/exports.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace napa {
+namespace utils {
+
+    /// <summary> What a compressed payload was marshalled for, the dimension its byte counters are reported under. </summary>
+    enum class PayloadSource {
+        Store,
+        Call
+    };
+
+    /// <summary> Bytes of payloads at or over their compression threshold since the process started. </summary>
+    struct PayloadCompressionStatistics {
+        /// <summary> Number of payloads that were compressed. </summary>
+        uint64_t compressedPayloads;
+
+        /// <summary> Bytes of the payloads before compression, including payloads kept as is since they didn't shrink. </summary>
+        uint64_t bytesBefore;
+
+        /// <summary> Bytes of the payloads after compression, the size of payloads kept as is for those that didn't shrink. </summary>
+        uint64_t bytesAfter;
+    };
+
+    /// <summary> Bytes of the header of a compressed payload, a marker and the decompressed size. </summary>
+    constexpr size_t COMPRESSED_PAYLOAD_HEADER_SIZE = 8;
+
+    /// <summary> Compressed payloads start with a NUL, which JSON and V8 serialized payloads never start with. </summary>
+    constexpr const char* COMPRESSED_PAYLOAD_MARKER = "\0LZ4";
+
+    /// <summary> Compress a payload in the LZ4 block format, if it's at least threshold bytes and compression shrinks it. </summary>
+    /// <param name="data"> Bytes of the payload. </param>
+    /// <param name="size"> Number of bytes of the payload. </param>
+    /// <param name="threshold"> Bytes from which payloads are compressed, 0 to never compress. </param>
+    /// <param name="source"> What the payload was marshalled for. </param>
+    /// <param name="compressed"> Receives the compressed payload, with its header. </param>
+    /// <returns> True if the payload was compressed, otherwise compressed is left as is. </returns>
+    /// <remarks> Bytes before and after are reported to the metric provider as PayloadBytesBeforeCompression and PayloadBytesAfterCompression. </remarks>
+    NAPA_API bool CompressPayload(const void* data, size_t size, size_t threshold, PayloadSource source, std::string& compressed);
+
+    /// <summary> Compress a payload in place, see CompressPayload. </summary>
+    /// <returns> True if the payload was compressed. </returns>
+    NAPA_API bool CompressPayload(std::string& payload, size_t threshold, PayloadSource source);
+
+    /// <summary> Tell if a payload was compressed by CompressPayload. </summary>
+    inline bool IsCompressedPayload(const char* data, size_t size) {
+        return size >= COMPRESSED_PAYLOAD_HEADER_SIZE && std::memcmp(data, COMPRESSED_PAYLOAD_MARKER, 4) == 0;
+    }
+
+    /// <summary> Tell if a payload was compressed by CompressPayload. </summary>
+    inline bool IsCompressedPayload(const std::string& payload) {
+        return IsCompressedPayload(payload.data(), payload.size());
+    }
+
+    /// <summary> Get the bytes a compressed payload decompresses to. </summary>
+    inline size_t GetDecompressedSize(const std::string& compressed) {
+        uint32_t size;
+        std::memcpy(&size, compressed.data() + 4, sizeof(size));
+        return size;
+    }
+
+    /// <summary> Decompress a compressed payload. </summary>
+    /// <param name="compressed"> A payload compressed by CompressPayload. </param>
+    /// <param name="data"> Buffer of GetDecompressedSize(compressed) bytes. </param>
+    /// <returns> False if the payload is corrupted. </returns>
+    NAPA_API bool DecompressPayload(const std::string& compressed, void* data);
+
+    /// <summary> Decompress a payload in place if it's compressed. </summary>
+    /// <returns> False if the payload is compressed and corrupted. </returns>
+    NAPA_API bool DecompressPayload(std::string& payload);
+
+    /// <summary> Get the bytes of payloads compressed since the process started. </summary>
+    NAPA_API PayloadCompressionStatistics GetPayloadCompressionStatistics();
+}
+}
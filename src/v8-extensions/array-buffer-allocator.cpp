@@ -1,29 +1,37 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license.
 
-#include "v8-extensions-macros.h"
-
-#if !(V8_VERSION_CHECK_FOR_ARRAY_BUFFER_ALLOCATOR)
-
 #include "array-buffer-allocator.h"
 
-#include <cstring>
-#include <stdlib.h>
+#include <memory/array-buffer-pool.h>
+
 #include <v8.h>
 
 using namespace napa::v8_extensions;
 
+namespace {
+    thread_local bool _isCurrent = false;
+}
+
+ArrayBufferAllocator::ArrayBufferAllocator() : _pool(napa::memory::GetArrayBufferPool()) {
+}
+
 void* ArrayBufferAllocator::Allocate(size_t length) {
-    void* data = AllocateUninitialized(length);
-    return std::memset(data, 0, length);
+    return _pool.Allocate(length, true);
 }
 
 void* ArrayBufferAllocator::AllocateUninitialized(size_t length) {
-    return malloc(length);
+    return _pool.Allocate(length, false);
 }
 
 void ArrayBufferAllocator::Free(void* data, size_t length) {
-    free(data);
+    _pool.Free(data, length);
 }
 
-#endif
\ No newline at end of file
+bool ArrayBufferAllocator::IsCurrent() {
+    return _isCurrent;
+}
+
+void ArrayBufferAllocator::SetCurrent(bool current) {
+    _isCurrent = current;
+}
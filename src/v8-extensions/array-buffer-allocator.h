@@ -6,12 +6,19 @@
 #include <v8.h>
 
 namespace napa {
+namespace memory {
+    class ArrayBufferPool;
+}
+
 namespace v8_extensions {
 
-    ///<summary> Allocator that V8 uses to allocate |ArrayBuffer|'s memory. </summary>
+    ///<summary> Allocator that V8 uses to allocate |ArrayBuffer|'s memory, from the pool shared by all isolates. </summary>
     class ArrayBufferAllocator : public v8::ArrayBuffer::Allocator {
     public:
 
+        /// <summary> Constructor, the shared pool is created on first use. </summary>
+        ArrayBufferAllocator();
+
         /// <see> v8::ArrayBuffer::Allocator::Allocate </see>
         virtual void* Allocate(size_t length) override;
 
@@ -20,6 +27,15 @@ namespace v8_extensions {
 
         /// <see> v8::ArrayBuffer::Allocator::Free </see>
         virtual void Free(void* data, size_t length) override;
+
+        /// <summary> Tell if the isolate of the current thread allocates ArrayBuffer memory from the shared pool. </summary>
+        static bool IsCurrent();
+
+        /// <summary> Set whether the isolate of the current thread allocates from the shared pool, by napa workers. </summary>
+        static void SetCurrent(bool current);
+
+    private:
+        napa::memory::ArrayBufferPool& _pool;
     };
 }
 }
@@ -8,14 +8,24 @@
 #include "deserializer.h"
 
 #include <napa/module/binding/basic-wraps.h>
+#include <napa/transport.h>
 
 using namespace napa::v8_extensions;
 using namespace v8;
 
 Deserializer::Deserializer(Isolate* isolate, std::shared_ptr<SerializedData> data) :
+    Deserializer(isolate, data->GetData(), data->GetSize(), data, Local<Object>()) {}
+
+Deserializer::Deserializer(
+    Isolate* isolate,
+    const uint8_t* data,
+    size_t size,
+    std::shared_ptr<SerializedData> externals,
+    Local<Object> transportContextWrap) :
     _isolate(isolate),
-    _deserializer(isolate, data->GetData(), data->GetSize(), this),
-    _data(std::move(data)) {
+    _deserializer(isolate, data, size, this),
+    _data(std::move(externals)),
+    _transportContextWrap(transportContextWrap) {
     _deserializer.SetSupportsLegacyWireFormat(true);
 }
 
@@ -26,6 +36,25 @@ MaybeLocal<Value> Deserializer::ReadValue() {
         return MaybeLocal<Value>();
     }
 
+    if (_data == nullptr) {
+        return _deserializer.ReadValue(context);
+    }
+
+    uint32_t transferId = 0;
+    Local<String> externalizedKey = v8_helpers::MakeV8String(_isolate, "_externalized");
+    for (const auto& contents : _data->GetTransferredArrayBufferContents()) {
+        Local<ArrayBuffer> arrayBuffer = ArrayBuffer::New(
+            _isolate, contents.first.Data(), contents.first.ByteLength());
+
+        // The restored ArrayBuffer references the transferred memory without a copy,
+        // and its '_externalized' property extends the lifecycle of the ExternalizedContents.
+        arrayBuffer->CreateDataProperty(
+            context,
+            externalizedKey,
+            napa::module::binding::CreateShareableWrap(contents.second, "SharedPtrWrap", contents.first.ByteLength()));
+        _deserializer.TransferArrayBuffer(transferId++, arrayBuffer);
+    }
+
 #if !V8_VERSION_EQUALS_TO_OR_NEWER_THAN(6, 6)
 
     uint32_t index = 0;
@@ -33,7 +62,8 @@ MaybeLocal<Value> Deserializer::ReadValue() {
     for (const auto& contents : _data->GetExternalizedSharedArrayBufferContents()) {
         Local<SharedArrayBuffer> sharedArrayBuffers = SharedArrayBuffer::New(
             _isolate, contents.first.Data(), contents.first.ByteLength());
-        auto shareableWrap = napa::module::binding::CreateShareableWrap(contents.second);
+        auto shareableWrap = napa::module::binding::CreateShareableWrap(
+            contents.second, "SharedPtrWrap", contents.first.ByteLength());
 
         // After deserialization of a SharedArrayBuffer from its SerializedData,
         // set its '_externalized' property to a ShareableWrap of its ExternalizedContents.
@@ -47,6 +77,25 @@ MaybeLocal<Value> Deserializer::ReadValue() {
     return _deserializer.ReadValue(context);
 }
 
+MaybeLocal<Object> Deserializer::ReadHostObject(Isolate* isolate) {
+    uint32_t length = 0;
+    const void* payload = nullptr;
+    if (_transportContextWrap.IsEmpty()
+        || !_deserializer.ReadUint32(&length)
+        || !_deserializer.ReadRawBytes(length, &payload)) {
+        isolate->ThrowException(Exception::Error(v8_helpers::MakeV8String(isolate, "Unable to deserialize host object.")));
+        return MaybeLocal<Object>();
+    }
+
+    Local<Value> value;
+    auto payloadString = String::NewFromUtf8(
+        isolate, static_cast<const char*>(payload), NewStringType::kNormal, static_cast<int>(length)).ToLocalChecked();
+    if (!napa::transport::Unmarshall(payloadString, _transportContextWrap).ToLocal(&value) || !value->IsObject()) {
+        return MaybeLocal<Object>();
+    }
+    return Local<Object>::Cast(value);
+}
+
 #if V8_VERSION_EQUALS_TO_OR_NEWER_THAN(6, 6)
 
 MaybeLocal<SharedArrayBuffer> Deserializer::GetSharedArrayBufferFromId(
@@ -62,7 +111,8 @@ MaybeLocal<SharedArrayBuffer> Deserializer::GetSharedArrayBufferFromId(
         // by the lifetime of the restored SharedArrayBuffer object.
         Local<Context> context = _isolate->GetCurrentContext();
         Local<String> key = v8_helpers::MakeV8String(_isolate, "_externalized");
-        auto shareableWrap = napa::module::binding::CreateShareableWrap(externalizedSharedArrayBufferContents.second);
+        auto shareableWrap = napa::module::binding::CreateShareableWrap(
+            externalizedSharedArrayBufferContents.second, "SharedPtrWrap", contents.ByteLength());
         sharedArrayBuffer->CreateDataProperty(context, key, shareableWrap);
         return sharedArrayBuffer;
     }
@@ -17,13 +17,25 @@ namespace v8_extensions {
     ///   For each of the SharedArrayBuffer in the input SerializedData, 
     ///   1). create a SharedArrayBuffer instance from its SharedArrayBuffer::Contents stored in SerializedData.
     ///   2). generate a ShareableWrap of ExternalizedContents, and attach it to the SharedArrayBuffer instance.
+    ///   Transferred ArrayBuffers are restored the same way, as ArrayBuffers referencing the transferred memory.
+    /// Host objects are unmarshalled by napajs.transport from their payloads, with the transport context if given.
     /// </summary>
     class Deserializer : public v8::ValueDeserializer::Delegate {
     public:
         Deserializer(v8::Isolate* isolate, std::shared_ptr<SerializedData> data);
 
+        /// <summary> Deserialize from bytes, whose externalized contents are kept by 'externals' if any. </summary>
+        Deserializer(
+            v8::Isolate* isolate,
+            const uint8_t* data,
+            size_t size,
+            std::shared_ptr<SerializedData> externals,
+            v8::Local<v8::Object> transportContextWrap);
+
         v8::MaybeLocal<v8::Value> ReadValue();
 
+        v8::MaybeLocal<v8::Object> ReadHostObject(v8::Isolate* isolate) override;
+
 #if V8_VERSION_EQUALS_TO_OR_NEWER_THAN(6, 6)
 
         v8::MaybeLocal<v8::SharedArrayBuffer> GetSharedArrayBufferFromId(
@@ -38,6 +50,7 @@ namespace v8_extensions {
         v8::Isolate* _isolate;
         v8::ValueDeserializer _deserializer;
         std::shared_ptr<SerializedData> _data;
+        v8::Local<v8::Object> _transportContextWrap;
 
         Deserializer(const Deserializer&) = delete;
         Deserializer& operator=(const Deserializer&) = delete;
@@ -6,27 +6,59 @@
 #if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
 
 #include "externalized-contents.h"
+#include "array-buffer-allocator.h"
+
+#include <memory/array-buffer-pool.h>
 
 #include <stdlib.h>
 
 using namespace napa::v8_extensions;
 using namespace v8;
 
+namespace {
+
+    /// <summary> Releases memory of the C runtime, which node allocates ArrayBuffer memory from. </summary>
+    void FreeToCrt(void* data, size_t) {
+        free(data);
+    }
+
+    /// <summary> Napa workers allocate from the shared pool, other isolates are node's. </summary>
+    ExternalizedContents::FreeCallback GetCurrentFreeCallback() {
+        return ArrayBufferAllocator::IsCurrent() ? ExternalizedContents::FreeToArrayBufferPool : FreeToCrt;
+    }
+}
+
 ExternalizedContents::ExternalizedContents(const SharedArrayBuffer::Contents& contents) :
     _data(contents.Data()),
-    _size(contents.ByteLength()) {}
+    _size(contents.ByteLength()),
+    _free(GetCurrentFreeCallback()) {}
+
+ExternalizedContents::ExternalizedContents(const ArrayBuffer::Contents& contents) :
+    _data(contents.Data()),
+    _size(contents.ByteLength()),
+    _free(GetCurrentFreeCallback()) {}
+
+ExternalizedContents::ExternalizedContents(void* data, size_t size, FreeCallback free) :
+    _data(data),
+    _size(size),
+    _free(free) {}
 
 ExternalizedContents::ExternalizedContents(ExternalizedContents&& other) :
     _data(other._data),
-    _size(other._size) {
+    _size(other._size),
+    _free(other._free) {
     other._data = nullptr;
     other._size = 0;
 }
 
 ExternalizedContents& ExternalizedContents::operator=(ExternalizedContents&& other) {
     if (this != &other) {
+        if (_data != nullptr) {
+            _free(_data, _size);
+        }
         _data = other._data;
         _size = other._size;
+        _free = other._free;
         other._data = nullptr;
         other._size = 0;
     }
@@ -34,8 +66,13 @@ ExternalizedContents& ExternalizedContents::operator=(ExternalizedContents&& oth
 }
 
 ExternalizedContents::~ExternalizedContents() {
-    // TODO #146: Get array_buffer_allocator to free ExternalizedContents.
-    free(_data);
+    if (_data != nullptr) {
+        _free(_data, _size);
+    }
+}
+
+void ExternalizedContents::FreeToArrayBufferPool(void* data, size_t size) {
+    napa::memory::GetArrayBufferPool().Free(data, size);
 }
 
 #endif
@@ -9,24 +9,41 @@ namespace napa {
 namespace v8_extensions {
 
     /// <summary> 
-    /// 1. ExternalizedContents holds the externalized memory of a SharedArrayBuffer once it is serialized.
-    /// 2. Only 1 instance of ExternalizedContents would be generated for each SharedArrayBuffer.
-    ///    If a SharedArrayBuffer had been externalized, it will reuse the ExternalizedContents instance
+    /// 1. ExternalizedContents holds the externalized memory of a SharedArrayBuffer once it is serialized,
+    ///    or of an ArrayBuffer once it is transferred.
+    /// 2. Only 1 instance of ExternalizedContents would be generated for each SharedArrayBuffer or ArrayBuffer.
+    ///    If a SharedArrayBuffer or ArrayBuffer had been externalized, it will reuse the ExternalizedContents instance
     ///    created before in napa::v8_extensions::Utils::SerializeValue().
+    /// 3. The memory is released like the ArrayBuffer allocator it came from would, so memory of napa isolates
+    ///    returns to the ArrayBuffer pool shared by all isolates.
     /// </summary>
     class ExternalizedContents {
     public:
+        /// <summary> Releases the memory of contents. </summary>
+        typedef void (*FreeCallback)(void* data, size_t size);
+
+        /// <summary> Contents externalized from the isolate of the current thread, released as its allocator would. </summary>
         explicit ExternalizedContents(const v8::SharedArrayBuffer::Contents& contents);
 
+        /// <summary> Contents externalized from the isolate of the current thread, released as its allocator would. </summary>
+        explicit ExternalizedContents(const v8::ArrayBuffer::Contents& contents);
+
+        /// <summary> Contents of memory released by a callback. </summary>
+        ExternalizedContents(void* data, size_t size, FreeCallback free);
+
         ExternalizedContents(ExternalizedContents&& other);
 
         ExternalizedContents& operator=(ExternalizedContents&& other);
 
         ~ExternalizedContents();
 
+        /// <summary> Releases memory of the ArrayBuffer pool shared by all isolates. </summary>
+        static void FreeToArrayBufferPool(void* data, size_t size);
+
     private:
         void* _data;
         size_t _size;
+        FreeCallback _free;
 
         ExternalizedContents(const ExternalizedContents&) = delete;
         ExternalizedContents& operator=(const ExternalizedContents&) = delete;
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "serialization-buffer-pool.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+using namespace napa::v8_extensions;
+
+namespace {
+
+    /// <summary> Precedes each buffer, 16 bytes so that buffers keep the alignment of malloc. </summary>
+    struct alignas(16) BlockHeader {
+        size_t capacity;
+    };
+
+    constexpr size_t MIN_POOLED_BLOCK_SIZE = 256;
+
+    /// <summary> Block sizes 256, 512, ... up to MAX_POOLED_BLOCK_SIZE. </summary>
+    constexpr size_t SIZE_CLASS_COUNT = 9;
+
+    static_assert(
+        MIN_POOLED_BLOCK_SIZE << (SIZE_CLASS_COUNT - 1) == SerializationBufferPool::MAX_POOLED_BLOCK_SIZE,
+        "Size classes must end at MAX_POOLED_BLOCK_SIZE.");
+
+    /// <summary> Set once the cache of the calling thread is destroyed, blocks released later go to the system. </summary>
+    thread_local bool threadCacheDestroyed = false;
+
+    /// <summary> Released blocks of the calling thread, returned to the system when the thread exits. </summary>
+    struct ThreadCache {
+        BlockHeader* blocks[SIZE_CLASS_COUNT][SerializationBufferPool::MAX_POOLED_BLOCKS_PER_SIZE];
+        size_t counts[SIZE_CLASS_COUNT] = {};
+
+        ~ThreadCache() {
+            threadCacheDestroyed = true;
+            for (size_t i = 0; i < SIZE_CLASS_COUNT; ++i) {
+                while (counts[i] > 0) {
+                    std::free(blocks[i][--counts[i]]);
+                }
+            }
+        }
+    };
+
+    /// <summary> Get the cache of the calling thread, nullptr while the thread exits. </summary>
+    ThreadCache* GetThreadCache() {
+        if (threadCacheDestroyed) {
+            return nullptr;
+        }
+        static thread_local ThreadCache cache;
+        return &cache;
+    }
+
+    /// <summary> Get the size class of a block size, or SIZE_CLASS_COUNT if blocks of the size are not pooled. </summary>
+    size_t GetSizeClass(size_t blockSize) {
+        size_t sizeClass = 0;
+        for (size_t classSize = MIN_POOLED_BLOCK_SIZE; classSize < blockSize; classSize <<= 1) {
+            if (++sizeClass == SIZE_CLASS_COUNT) {
+                break;
+            }
+        }
+        return sizeClass;
+    }
+
+    BlockHeader* GetHeader(const void* buffer) {
+        return const_cast<BlockHeader*>(static_cast<const BlockHeader*>(buffer) - 1);
+    }
+
+    void* AllocateBlock(size_t size, size_t* actualSize) {
+        if (size > SIZE_MAX - sizeof(BlockHeader)) {
+            *actualSize = 0;
+            return nullptr;
+        }
+
+        auto blockSize = size + sizeof(BlockHeader);
+        auto sizeClass = GetSizeClass(blockSize);
+        BlockHeader* header = nullptr;
+        if (sizeClass < SIZE_CLASS_COUNT) {
+            blockSize = MIN_POOLED_BLOCK_SIZE << sizeClass;
+            auto cache = GetThreadCache();
+            if (cache != nullptr && cache->counts[sizeClass] > 0) {
+                header = cache->blocks[sizeClass][--cache->counts[sizeClass]];
+            }
+        }
+
+        if (header == nullptr) {
+            header = static_cast<BlockHeader*>(std::malloc(blockSize));
+            if (header == nullptr) {
+                *actualSize = 0;
+                return nullptr;
+            }
+            header->capacity = blockSize - sizeof(BlockHeader);
+        }
+
+        *actualSize = header->capacity;
+        return header + 1;
+    }
+}
+
+void* SerializationBufferPool::Reallocate(void* buffer, size_t size, size_t* actualSize) {
+    if (buffer != nullptr) {
+        auto capacity = GetCapacity(buffer);
+        if (capacity >= size) {
+            *actualSize = capacity;
+            return buffer;
+        }
+    }
+
+    auto result = AllocateBlock(size, actualSize);
+    if (result != nullptr && buffer != nullptr) {
+        std::memcpy(result, buffer, GetCapacity(buffer));
+        Free(buffer);
+    }
+    return result;
+}
+
+void SerializationBufferPool::Free(void* buffer) {
+    if (buffer == nullptr) {
+        return;
+    }
+
+    auto header = GetHeader(buffer);
+    auto sizeClass = GetSizeClass(header->capacity + sizeof(BlockHeader));
+    if (sizeClass < SIZE_CLASS_COUNT) {
+        auto cache = GetThreadCache();
+        if (cache != nullptr && cache->counts[sizeClass] < MAX_POOLED_BLOCKS_PER_SIZE) {
+            cache->blocks[sizeClass][cache->counts[sizeClass]++] = header;
+            return;
+        }
+    }
+    std::free(header);
+}
+
+size_t SerializationBufferPool::GetCapacity(const void* buffer) {
+    return GetHeader(buffer)->capacity;
+}
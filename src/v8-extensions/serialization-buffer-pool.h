@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+
+namespace napa {
+namespace v8_extensions {
+
+    /// <summary>
+    /// SerializationBufferPool serves the buffers ValueSerializer writes to, in place of realloc and free.
+    /// Buffers are rounded up to power of 2 blocks, which each thread keeps a few of per size once released,
+    /// so serializing small values reuses the buffers of values deserialized before instead of calling malloc.
+    /// A block records its capacity in front of the buffer, so growing and releasing it needs no size from the caller.
+    /// </summary>
+    class SerializationBufferPool {
+    public:
+        /// <summary> Blocks up to this size, the capacity of a buffer and its header, are kept for reuse. </summary>
+        static constexpr size_t MAX_POOLED_BLOCK_SIZE = 64 * 1024;
+
+        /// <summary> Released blocks each thread keeps for each size. </summary>
+        static constexpr size_t MAX_POOLED_BLOCKS_PER_SIZE = 8;
+
+        /// <summary> Reallocate a buffer with realloc semantics, contents up to the old capacity are kept. </summary>
+        /// <param name="buffer"> The buffer to grow, or nullptr to allocate a new one. </param>
+        /// <param name="size"> The size needed. </param>
+        /// <param name="actualSize"> Receives the capacity of the returned buffer, 0 on failure. </param>
+        /// <returns> The buffer, or nullptr if out of memory, in which case the old buffer is kept. </returns>
+        static void* Reallocate(void* buffer, size_t size, size_t* actualSize);
+
+        /// <summary> Release a buffer, nullptr is ignored. </summary>
+        static void Free(void* buffer);
+
+        /// <summary> Get the capacity of a buffer. </summary>
+        static size_t GetCapacity(const void* buffer);
+    };
+}
+}
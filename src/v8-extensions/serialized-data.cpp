@@ -6,8 +6,7 @@
 #if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
 
 #include "serialized-data.h"
-
-#include <stdlib.h>
+#include "serialization-buffer-pool.h"
 
 using namespace napa::v8_extensions;
 using namespace v8;
@@ -18,11 +17,16 @@ const uint8_t* SerializedData::GetData() const { return _data.get(); }
 
 size_t SerializedData::GetSize() const { return _size; }
 
-const std::vector<ExternalizedSharedArrayBufferContents>&
+const ExternalizedSharedArrayBufferContentsList&
 SerializedData::GetExternalizedSharedArrayBufferContents() const {
     return _externalizedSharedArrayBufferContents;
 }
 
-void SerializedData::DataDeleter::operator()(uint8_t* p) const { free(p); }
+const ExternalizedArrayBufferContentsList&
+SerializedData::GetTransferredArrayBufferContents() const {
+    return _transferredArrayBufferContents;
+}
+
+void SerializedData::DataDeleter::operator()(uint8_t* p) const { SerializationBufferPool::Free(p); }
 
 #endif
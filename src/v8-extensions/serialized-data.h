@@ -5,6 +5,10 @@
 
 #include "externalized-contents.h"
 
+#include <napa/stl/small-vector.h>
+
+#include <memory>
+
 namespace napa {
 namespace v8_extensions {
 
@@ -12,10 +16,26 @@ namespace v8_extensions {
 
     typedef std::pair<SharedArrayBuffer::Contents, std::shared_ptr<ExternalizedContents>> ExternalizedSharedArrayBufferContents;
 
+    typedef std::pair<ArrayBuffer::Contents, std::shared_ptr<ExternalizedContents>> ExternalizedArrayBufferContents;
+
+    /// <summary> Values rarely reference more than a couple of buffers, which are kept in place without allocating. </summary>
+    typedef napa::stl::SmallVector<
+        ExternalizedSharedArrayBufferContents,
+        2,
+        std::allocator<ExternalizedSharedArrayBufferContents>> ExternalizedSharedArrayBufferContentsList;
+
+    typedef napa::stl::SmallVector<
+        ExternalizedArrayBufferContents,
+        2,
+        std::allocator<ExternalizedArrayBufferContents>> ExternalizedArrayBufferContentsList;
+
     /// <summary>
     /// SerializedData holds the serialized data of a JavaScript object, and it is required during its deserialization.
     /// If the JavaScript object has properties or elements of SharedArrayBuffer or types based on SharedArrayBuffer, 
     /// like DataView and TypedArray, their ExternalizedContents will be stored in _externalizedSharedArrayBufferContents.
+    /// ArrayBuffers in the transfer list are moved instead of copied, their ExternalizedContents will be stored in
+    /// _transferredArrayBufferContents.
+    /// The data is written to a buffer of SerializationBufferPool, which is returned to the pool with SerializedData.
     /// </summary>
     class SerializedData {
     public:
@@ -25,7 +45,9 @@ namespace v8_extensions {
 
         size_t GetSize() const;
 
-        const std::vector<ExternalizedSharedArrayBufferContents>& GetExternalizedSharedArrayBufferContents() const;
+        const ExternalizedSharedArrayBufferContentsList& GetExternalizedSharedArrayBufferContents() const;
+
+        const ExternalizedArrayBufferContentsList& GetTransferredArrayBufferContents() const;
 
     private:
         struct DataDeleter {
@@ -34,7 +56,8 @@ namespace v8_extensions {
 
         std::unique_ptr<uint8_t, DataDeleter> _data;
         size_t _size;
-        std::vector<ExternalizedSharedArrayBufferContents> _externalizedSharedArrayBufferContents;
+        ExternalizedSharedArrayBufferContentsList _externalizedSharedArrayBufferContents;
+        ExternalizedArrayBufferContentsList _transferredArrayBufferContents;
 
     private:
         friend class Serializer;
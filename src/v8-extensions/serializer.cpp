@@ -6,22 +6,37 @@
 #if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
 
 #include "serializer.h"
+#include "serialization-buffer-pool.h"
 
 #include <napa/module/binding/basic-wraps.h>
-#include <stdlib.h>
+#include <napa/transport.h>
+#include <algorithm>
 
 using namespace napa::v8_extensions;
 using namespace v8;
 
 Serializer::Serializer(Isolate* isolate) :
+    Serializer(isolate, Local<Object>()) {}
+
+Serializer::Serializer(Isolate* isolate, Local<Object> transportContextWrap) :
     _isolate(isolate),
+    _transportContextWrap(transportContextWrap),
     _serializer(isolate, this) {}
 
 Maybe<bool> Serializer::WriteValue(Local<Value> value) {
+    return WriteValue(value, Local<Array>());
+}
+
+Maybe<bool> Serializer::WriteValue(Local<Value> value, Local<Array> transferList) {
     bool ok = false;
-    _data.reset(new SerializedData);
+    _data = std::make_shared<SerializedData>();
     _serializer.WriteHeader();
 
+    if (!transferList.IsEmpty() && !PrepareTransfer(transferList).To(&ok)) {
+        _data.reset();
+        return Nothing<bool>();
+    }
+
     Local<Context> context = _isolate->GetCurrentContext();
     if (!_serializer.WriteValue(context, value).To(&ok)) {
         _data.reset();
@@ -46,6 +61,24 @@ void Serializer::ThrowDataCloneError(Local<String> message) {
     _isolate->ThrowException(Exception::Error(message));
 }
 
+Maybe<bool> Serializer::WriteHostObject(Isolate* isolate, Local<Object> object) {
+    if (_transportContextWrap.IsEmpty()) {
+        ThrowDataCloneError(v8_helpers::MakeV8String(isolate, "Host objects can't be serialized without a transport context."));
+        return Nothing<bool>();
+    }
+
+    // Shared states of the host object are saved in the transport context by its marshall().
+    Local<String> payload;
+    if (!napa::transport::Marshall(object, _transportContextWrap).ToLocal(&payload)) {
+        return Nothing<bool>();
+    }
+
+    auto utf8Payload = napa::v8_helpers::V8ValueTo<std::string>(payload);
+    _serializer.WriteUint32(static_cast<uint32_t>(utf8Payload.size()));
+    _serializer.WriteRawBytes(utf8Payload.data(), utf8Payload.size());
+    return Just(true);
+}
+
 Maybe<uint32_t> Serializer::GetSharedArrayBufferId(
     Isolate* isolate,
     Local<SharedArrayBuffer> sharedArrayBuffer
@@ -62,12 +95,10 @@ Maybe<uint32_t> Serializer::GetSharedArrayBufferId(
 }
 
 void* Serializer::ReallocateBufferMemory(void* oldBuffer, size_t size, size_t* actualSize) {
-    void* result = realloc(oldBuffer, size);
-    *actualSize = result ? size : 0;
-    return result;
+    return SerializationBufferPool::Reallocate(oldBuffer, size, actualSize);
 }
 
-void Serializer::FreeBufferMemory(void* buffer) { free(buffer); }
+void Serializer::FreeBufferMemory(void* buffer) { SerializationBufferPool::Free(buffer); }
 
 ExternalizedSharedArrayBufferContents
 Serializer::MaybeExternalize(Local<SharedArrayBuffer> sharedArrayBuffer) {
@@ -91,12 +122,76 @@ Serializer::MaybeExternalize(Local<SharedArrayBuffer> sharedArrayBuffer) {
         // then store its ExternalizedContents in the '_externalized' property of the original SharedArrayBuffer.
         auto contents = sharedArrayBuffer->Externalize();
         auto externalizedContents = std::make_shared<ExternalizedContents>(contents);
-        auto shareableWrap = napa::module::binding::CreateShareableWrap(externalizedContents);
+        auto shareableWrap = napa::module::binding::CreateShareableWrap(
+            externalizedContents, "SharedPtrWrap", contents.ByteLength());
         sharedArrayBuffer->CreateDataProperty(context, key, shareableWrap);
         return std::make_pair(contents, externalizedContents);
     }
 }
 
+ExternalizedArrayBufferContents
+Serializer::MaybeExternalize(Local<ArrayBuffer> arrayBuffer) {
+    Local<Context> context = _isolate->GetCurrentContext();
+    Local<String> key = v8_helpers::MakeV8String(_isolate, "_externalized");
+    if (arrayBuffer->IsExternal()) {
+        // An ArrayBuffer transferred before holds its ExternalizedContents in the '_externalized' property.
+        // ArrayBuffers externalized by others are not owned by Napa, they are copied instead of transferred.
+        Local<Value> value;
+        bool ok = false;
+        if (arrayBuffer->Has(context, key).To(&ok) && ok
+            && arrayBuffer->Get(context, key).ToLocal(&value) && value->IsObject()) {
+            auto shareableWrap = NAPA_OBJECTWRAP::Unwrap<napa::module::ShareableWrap>(Local<Object>::Cast(value));
+            return std::make_pair(arrayBuffer->GetContents(), shareableWrap->Get<ExternalizedContents>());
+        }
+        return std::make_pair(arrayBuffer->GetContents(), nullptr);
+    } else {
+        // Take the ownership of the memory, and keep it alive by the lifetime of the original ArrayBuffer
+        // until it is detached.
+        auto contents = arrayBuffer->Externalize();
+        auto externalizedContents = std::make_shared<ExternalizedContents>(contents);
+        auto shareableWrap = napa::module::binding::CreateShareableWrap(
+            externalizedContents, "SharedPtrWrap", contents.ByteLength());
+        arrayBuffer->CreateDataProperty(context, key, shareableWrap);
+        return std::make_pair(contents, externalizedContents);
+    }
+}
+
+Maybe<bool> Serializer::PrepareTransfer(Local<Array> transferList) {
+    Local<Context> context = _isolate->GetCurrentContext();
+    std::vector<Local<ArrayBuffer>> arrayBuffers;
+
+    for (uint32_t i = 0; i < transferList->Length(); ++i) {
+        Local<Value> value;
+        if (!transferList->Get(context, i).ToLocal(&value)) {
+            return Nothing<bool>();
+        }
+        if (!value->IsArrayBuffer()) {
+            _isolate->ThrowException(Exception::TypeError(
+                v8_helpers::MakeV8String(_isolate, "Only ArrayBuffer can be transferred.")));
+            return Nothing<bool>();
+        }
+
+        auto arrayBuffer = Local<ArrayBuffer>::Cast(value);
+        if (arrayBuffer->ByteLength() == 0
+            || std::find(arrayBuffers.begin(), arrayBuffers.end(), arrayBuffer) != arrayBuffers.end()) {
+            // Nothing to move for an empty or detached ArrayBuffer.
+            continue;
+        }
+        arrayBuffers.push_back(arrayBuffer);
+    }
+
+    for (auto arrayBuffer : arrayBuffers) {
+        auto contents = MaybeExternalize(arrayBuffer);
+        if (contents.second == nullptr) {
+            continue;
+        }
+        _serializer.TransferArrayBuffer(static_cast<uint32_t>(_data->_transferredArrayBufferContents.size()), arrayBuffer);
+        _data->_transferredArrayBufferContents.push_back(std::move(contents));
+    }
+
+    return Just(true);
+}
+
 Maybe<bool> Serializer::FinalizeTransfer() {
     for (const auto& globalSharedArrayBuffer : _sharedArrayBuffers) {
         Local<SharedArrayBuffer> sharedArrayBuffer =
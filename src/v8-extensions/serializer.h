@@ -19,18 +19,29 @@ namespace v8_extensions {
     ///   2). a ShareableWrap of the ExternalizedContents will be set to the input SharedArrayBuffer.
     ///   If a SharedArrayBuffer has been serialized, the externalization will be skipped, and its ExternalizedContents
     ///   will be retrieved from the input SharedArrayBuffer and attached to its SerializedData.
+    /// ArrayBuffers in the transfer list are externalized the same way, and written by reference instead of by content.
+    /// The caller is responsible for detaching them once it finishes serializing, see Utils::DetachArrayBuffers().
+    /// Host objects (objects of native wraps) are marshalled by napajs.transport with the transport context if given,
+    /// and written as their payloads.
+    /// The serialized data is written to buffers from SerializationBufferPool instead of realloc.
     /// </summary>
     class Serializer : public v8::ValueSerializer::Delegate {
     public:
         explicit Serializer(v8::Isolate* isolate);
 
+        Serializer(v8::Isolate* isolate, v8::Local<v8::Object> transportContextWrap);
+
         v8::Maybe<bool> WriteValue(v8::Local<v8::Value> value);
 
+        v8::Maybe<bool> WriteValue(v8::Local<v8::Value> value, v8::Local<v8::Array> transferList);
+
         std::shared_ptr<SerializedData> Release();
 
     protected:
         void ThrowDataCloneError(v8::Local<v8::String> message) override;
 
+        v8::Maybe<bool> WriteHostObject(v8::Isolate* isolate, v8::Local<v8::Object> object) override;
+
         v8::Maybe<uint32_t> GetSharedArrayBufferId(
             v8::Isolate* isolate,
             v8::Local<v8::SharedArrayBuffer> sharedArrayBuffer
@@ -43,9 +54,14 @@ namespace v8_extensions {
     private:
         ExternalizedSharedArrayBufferContents MaybeExternalize(v8::Local<v8::SharedArrayBuffer> sharedArrayBuffer);
 
+        ExternalizedArrayBufferContents MaybeExternalize(v8::Local<v8::ArrayBuffer> arrayBuffer);
+
+        v8::Maybe<bool> PrepareTransfer(v8::Local<v8::Array> transferList);
+
         v8::Maybe<bool> FinalizeTransfer();
 
         v8::Isolate* _isolate;
+        v8::Local<v8::Object> _transportContextWrap;
         v8::ValueSerializer _serializer;
         std::shared_ptr<SerializedData> _data;
         std::vector<v8::Global<v8::SharedArrayBuffer>> _sharedArrayBuffers;
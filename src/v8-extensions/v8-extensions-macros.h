@@ -13,3 +13,12 @@
 
 #define V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER \
     V8_VERSION_EQUALS_TO_OR_NEWER_THAN(6, 2)
+
+#define V8_VERSION_CHECK_FOR_ARRAY_BUFFER_DETACH \
+    V8_VERSION_EQUALS_TO_OR_NEWER_THAN(7, 3)
+
+#define V8_VERSION_CHECK_FOR_CREATE_CODE_CACHE \
+    V8_VERSION_EQUALS_TO_OR_NEWER_THAN(6, 7)
+
+#define V8_VERSION_CHECK_FOR_MICROTASK_CHECKPOINT \
+    V8_VERSION_EQUALS_TO_OR_NEWER_THAN(7, 3)
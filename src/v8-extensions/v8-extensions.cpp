@@ -6,22 +6,61 @@
 #if V8_VERSION_CHECK_FOR_BUILT_IN_TYPE_TRANSPORTER
 
 #include "deserializer.h"
+#include "externalized-contents.h"
 #include "serializer.h"
 #include "v8-extensions.h"
 
+#include <memory/array-buffer-pool.h>
+#include <napa/module/binding/basic-wraps.h>
+#include <napa/module/transport-context-wrap.h>
+#include <napa/v8-helpers.h>
+
+#include <cstring>
+
 using namespace napa;
 using namespace v8;
 
 std::shared_ptr<v8_extensions::SerializedData>
 v8_extensions::Utils::SerializeValue(Isolate* isolate, Local<Value> value) {
+    return SerializeValue(isolate, value, Local<Array>());
+}
+
+std::shared_ptr<v8_extensions::SerializedData>
+v8_extensions::Utils::SerializeValue(Isolate* isolate, Local<Value> value, Local<Array> transferList) {
     bool ok = false;
     Serializer serializer(isolate);
-    if (serializer.WriteValue(value).To(&ok)) {
+    if (serializer.WriteValue(value, transferList).To(&ok)) {
         return serializer.Release();
     }
     return nullptr;
 }
 
+void
+v8_extensions::Utils::DetachArrayBuffers(Isolate* isolate, Local<Array> transferList) {
+    Local<Context> context = isolate->GetCurrentContext();
+    for (uint32_t i = 0; i < transferList->Length(); ++i) {
+        Local<Value> value;
+        if (transferList->Get(context, i).ToLocal(&value) && value->IsArrayBuffer()) {
+            auto arrayBuffer = Local<ArrayBuffer>::Cast(value);
+
+            // ArrayBuffers not owned by Napa were copied, they are left attached.
+            if (!arrayBuffer->IsExternal()
+                || !arrayBuffer->Has(context, v8_helpers::MakeV8String(isolate, "_externalized")).FromMaybe(false)) {
+                continue;
+            }
+#if V8_VERSION_CHECK_FOR_ARRAY_BUFFER_DETACH
+            if (arrayBuffer->IsDetachable()) {
+                arrayBuffer->Detach();
+            }
+#else
+            if (arrayBuffer->IsNeuterable()) {
+                arrayBuffer->Neuter();
+            }
+#endif
+        }
+    }
+}
+
 MaybeLocal<Value>
 v8_extensions::Utils::DeserializeValue(Isolate* isolate, std::shared_ptr<v8_extensions::SerializedData>& data) {
     Local<Value> value;
@@ -29,4 +68,79 @@ v8_extensions::Utils::DeserializeValue(Isolate* isolate, std::shared_ptr<v8_exte
     return deserializer.ReadValue();
 }
 
+MaybeLocal<ArrayBuffer>
+v8_extensions::Utils::SerializeValueToBytes(
+    Isolate* isolate,
+    Local<Value> value,
+    Local<Array> transferList,
+    Local<Object> transportContextWrap) {
+    bool ok = false;
+    Serializer serializer(isolate, transportContextWrap);
+    if (!serializer.WriteValue(value, transferList).To(&ok)) {
+        return MaybeLocal<ArrayBuffer>();
+    }
+    auto serializedData = serializer.Release();
+
+    // Externalized contents can't travel in bytes, their owner is saved in the transport context instead.
+    uint64_t handle = 0;
+    if (!serializedData->GetExternalizedSharedArrayBufferContents().empty()
+        || !serializedData->GetTransferredArrayBufferContents().empty()) {
+        auto transportContext = NAPA_OBJECTWRAP::Unwrap<module::TransportContextWrap>(transportContextWrap)->Get();
+        handle = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(serializedData.get()));
+        transportContext->SaveShared(serializedData);
+    }
+
+    auto size = serializedData->GetSize();
+    auto bytes = ArrayBuffer::New(isolate, size + sizeof(handle));
+    auto contents = bytes->GetContents();
+    std::memcpy(contents.Data(), serializedData->GetData(), size);
+    std::memcpy(static_cast<uint8_t*>(contents.Data()) + size, &handle, sizeof(handle));
+    return bytes;
+}
+
+MaybeLocal<Value>
+v8_extensions::Utils::DeserializeValueFromBytes(
+    Isolate* isolate,
+    const uint8_t* data,
+    size_t size,
+    Local<Object> transportContextWrap) {
+    uint64_t handle = 0;
+    if (size < sizeof(handle)) {
+        isolate->ThrowException(Exception::Error(v8_helpers::MakeV8String(isolate, "Invalid serialized bytes.")));
+        return MaybeLocal<Value>();
+    }
+    size -= sizeof(handle);
+    std::memcpy(&handle, data + size, sizeof(handle));
+
+    std::shared_ptr<SerializedData> externals;
+    if (handle != 0) {
+        auto transportContext = NAPA_OBJECTWRAP::Unwrap<module::TransportContextWrap>(transportContextWrap)->Get();
+        externals = transportContext->LoadShared<SerializedData>(static_cast<uintptr_t>(handle));
+    }
+
+    Deserializer deserializer(isolate, data, size, std::move(externals), transportContextWrap);
+    return deserializer.ReadValue();
+}
+
+MaybeLocal<SharedArrayBuffer>
+v8_extensions::Utils::NewPooledSharedArrayBuffer(Isolate* isolate, size_t length, bool zeroed) {
+    auto data = memory::GetArrayBufferPool().Allocate(length, zeroed);
+    if (data == nullptr) {
+        isolate->ThrowException(Exception::RangeError(
+            v8_helpers::MakeV8String(isolate, "Unable to allocate memory of the SharedArrayBuffer from the pool.")));
+        return MaybeLocal<SharedArrayBuffer>();
+    }
+
+    // Like a deserialized SharedArrayBuffer, its '_externalized' property holds the ExternalizedContents,
+    // which the serializer reuses instead of externalizing the buffer.
+    auto externalizedContents = std::make_shared<ExternalizedContents>(
+        data, length, ExternalizedContents::FreeToArrayBufferPool);
+    auto sharedArrayBuffer = SharedArrayBuffer::New(isolate, data, length);
+    sharedArrayBuffer->CreateDataProperty(
+        isolate->GetCurrentContext(),
+        v8_helpers::MakeV8String(isolate, "_externalized"),
+        module::binding::CreateShareableWrap(externalizedContents, "SharedPtrWrap", length));
+    return sharedArrayBuffer;
+}
+
 #endif
@@ -15,9 +15,47 @@ namespace v8_extensions {
         public:
         static std::shared_ptr<SerializedData>
         SerializeValue(v8::Isolate* isolate, v8::Local<v8::Value> value);
+
+        /// <summary> Serialize a value, moving the ArrayBuffers in the transfer list instead of copying them. </summary>
+        /// <remarks> The ArrayBuffers stay usable by the caller until DetachArrayBuffers() is called. </remarks>
+        static std::shared_ptr<SerializedData>
+        SerializeValue(v8::Isolate* isolate, v8::Local<v8::Value> value, v8::Local<v8::Array> transferList);
+
+        /// <summary> Detach the ArrayBuffers in a transfer list from the caller, after serializing is finished. </summary>
+        static void
+        DetachArrayBuffers(v8::Isolate* isolate, v8::Local<v8::Array> transferList);
         
         static v8::MaybeLocal<v8::Value>
         DeserializeValue(v8::Isolate* isolate, std::shared_ptr<SerializedData>& data);
+
+        /// <summary> Serialize a value into bytes, marshalling host objects with the transport context. </summary>
+        /// <remarks>
+        /// The bytes are the V8 serialized payload followed by a 64-bit handle. The handle refers to the SerializedData
+        /// saved in the transport context when the value holds shared or transferred ArrayBuffers, otherwise it's 0.
+        /// </remarks>
+        static v8::MaybeLocal<v8::ArrayBuffer>
+        SerializeValueToBytes(
+            v8::Isolate* isolate,
+            v8::Local<v8::Value> value,
+            v8::Local<v8::Array> transferList,
+            v8::Local<v8::Object> transportContextWrap);
+
+        /// <summary> Deserialize a value from bytes created by SerializeValueToBytes(). </summary>
+        static v8::MaybeLocal<v8::Value>
+        DeserializeValueFromBytes(
+            v8::Isolate* isolate,
+            const uint8_t* data,
+            size_t size,
+            v8::Local<v8::Object> transportContextWrap);
+
+        /// <summary> Create a SharedArrayBuffer over memory of the ArrayBuffer pool shared by all isolates. </summary>
+        /// <param name="zeroed"> Whether the memory must be zero-filled, pooled blocks are cleared only if it is. </param>
+        /// <remarks>
+        /// The buffer is externalized from the start, so transporting it doesn't externalize it again.
+        /// Its memory returns to the pool once the buffer and the buffers transported from it are all collected.
+        /// </remarks>
+        static v8::MaybeLocal<v8::SharedArrayBuffer>
+        NewPooledSharedArrayBuffer(v8::Isolate* isolate, size_t length, bool zeroed);
     };
 }
 }
@@ -2,24 +2,64 @@
 // Licensed under the MIT license.
 
 #include "async-complete-task.h"
+#include "trace-recorder.h"
+#include "worker-context.h"
 
 #include <v8.h>
 
 using namespace napa::zone;
 
-AsyncCompleteTask::AsyncCompleteTask(std::shared_ptr<AsyncContext> context) : _context(std::move(context)) {}
+AsyncCompletionQueue& AsyncCompletionQueue::GetCurrent() {
+    auto completions = static_cast<AsyncCompletionQueue*>(WorkerContext::Get(WorkerContextItem::ASYNC_COMPLETIONS));
+    if (completions == nullptr) {
+        completions = new AsyncCompletionQueue();
+        WorkerContext::Set(WorkerContextItem::ASYNC_COMPLETIONS, completions);
+    }
+    return *completions;
+}
 
-void AsyncCompleteTask::Execute() {
-    // If asyncWork is empty, don't need to wait for async result. It just posts a completion only.
-    if (_context->asyncWork != nullptr) {
-        _context->future.wait();
+void AsyncCompletionQueue::Post(std::shared_ptr<AsyncContext> context) {
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _pending.emplace_back(context);
+        if (_scheduled) {
+            return;
+        }
+        _scheduled = true;
+    }
+
+    // The worker is retained by the pending completion, so the task is queued locally without the synchronizer.
+    context->scheduler->ScheduleOnRetainedWorker(context->workerId, std::make_shared<AsyncCompleteTask>(*this));
+}
+
+void AsyncCompletionQueue::RunPending() {
+    {
+        // Completions posted from now on schedule another task.
+        std::lock_guard<std::mutex> lock(_lock);
+        _running.swap(_pending);
+        _scheduled = false;
     }
 
     auto isolate = v8::Isolate::GetCurrent();
-    v8::HandleScope scope(isolate);
+    for (auto& context : _running) {
+        // The completion is scheduled once the result is set, there is nothing to wait for.
+        TraceScope traceScope("async", "AsyncComplete", "worker", context->workerId);
+        v8::HandleScope scope(isolate);
 
-    auto jsCallback = v8::Local<v8::Function>::New(isolate, _context->jsCallback);
-    _context->asyncCompleteCallback(jsCallback, _context->result);
+        auto jsCallback = v8::Local<v8::Function>::New(isolate, context->jsCallback);
+        context->asyncCompleteCallback(jsCallback, context->result);
 
-    _context->jsCallback.Reset();
-}
\ No newline at end of file
+        context->jsCallback.Reset();
+
+        // Releasing the last retainment may let the worker go once it is idle, after this task.
+        context->scheduler->ReleaseWorker(context->workerId);
+        context.reset();
+    }
+    _running.clear();
+}
+
+AsyncCompleteTask::AsyncCompleteTask(AsyncCompletionQueue& completions) : _completions(completions) {}
+
+void AsyncCompleteTask::Execute() {
+    _completions.RunPending();
+}
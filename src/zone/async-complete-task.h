@@ -8,25 +8,64 @@
 #include <zone/task.h>
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace napa {
 namespace zone {
 
-    /// <summary> A task to run Javascript callback after asynchronous callback completes. </summary>
+    /// <summary> Completions of async work waiting to run on the worker that issued the work. </summary>
+    /// <remarks>
+    ///     Completions are posted from any thread. Only the first one posted while none is pending schedules an
+    ///     AsyncCompleteTask, which runs all completions posted until it starts. A worker with many parallel async
+    ///     calls then gets one task per batch of completions, instead of one per completion.
+    /// </remarks>
+    class AsyncCompletionQueue {
+    public:
+
+        /// <summary> Get the queue of the current worker, created on first use. </summary>
+        /// <remarks> Like the other caches of a worker, the queue lives as long as the thread. </remarks>
+        static AsyncCompletionQueue& GetCurrent();
+
+        /// <summary> Post the completion of async work, it can be called from any thread. </summary>
+        /// <param name="context"> The context of the async work, whose result is set. </param>
+        void Post(std::shared_ptr<AsyncContext> context);
+
+        /// <summary> Run the completions posted so far, on the worker thread. </summary>
+        void RunPending();
+
+    private:
+
+        std::mutex _lock;
+
+        /// <summary> Completions posted since the task started, guarded by the lock. </summary>
+        std::vector<std::shared_ptr<AsyncContext>> _pending;
+
+        /// <summary> Whether a task to run the completions is scheduled and didn't start yet, guarded by the lock. </summary>
+        bool _scheduled = false;
+
+        /// <summary> Completions being run, only touched by the worker thread, swapped with the pending ones to keep both buffers. </summary>
+        std::vector<std::shared_ptr<AsyncContext>> _running;
+    };
+
+    /// <summary> A task to run Javascript callbacks after asynchronous work completes. </summary>
     class AsyncCompleteTask : public Task {
     public:
 
         /// <summary> Constructor. </summary>
-        /// <param name="context"> Structure containing asynchronous work's context. </param>
-        AsyncCompleteTask(std::shared_ptr<AsyncContext> context);
+        /// <param name="completions"> Completions of the worker the task is scheduled on. </param>
+        AsyncCompleteTask(AsyncCompletionQueue& completions);
 
         /// <summary> Overrides Task.Execute to define running execution logic. </summary>
         virtual void Execute() override;
 
+        /// <summary> Overrides Task.Reject, completions run on their retained worker and are never dropped, see CanReject. </summary>
+        virtual void Reject(napa::ResultCode /*code*/, const std::string& /*reason*/) override {}
+
     private:
 
-        std::shared_ptr<AsyncContext> _context;
+        AsyncCompletionQueue& _completions;
     };
 
 }
-}
\ No newline at end of file
+}
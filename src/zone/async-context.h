@@ -10,10 +10,10 @@
 
 #include <v8.h>
 
-#include <future>
-
 namespace napa {
 namespace zone {
+
+    class AsyncCompletionQueue;
     
     /// <summary> Class holding asynchronous callbacks. </summary>
     struct AsyncContext {
@@ -26,8 +26,8 @@ namespace zone {
         /// <summary> Worker Id issueing asynchronous work. </summary>
         zone::WorkerId workerId;
 
-        /// <summary> Future to wait async callback. </summary>
-        std::future<void> future;
+        /// <summary> Completions of the worker issueing asynchronous work, the completion is posted to. </summary>
+        AsyncCompletionQueue* completions = nullptr;
 
         /// <summary> Javascript callback. </summary>
         v8::Persistent<v8::Function> jsCallback;
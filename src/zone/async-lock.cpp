@@ -0,0 +1,65 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "async-lock.h"
+
+using namespace napa::zone;
+
+AsyncLock::AsyncLock() : _held(false) {
+}
+
+void AsyncLock::Lock() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _released.wait(lock, [this]() { return !_held; });
+    _held = true;
+}
+
+bool AsyncLock::TryLock() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_held) {
+        return false;
+    }
+    _held = true;
+    return true;
+}
+
+bool AsyncLock::TryLockFor(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_released.wait_for(lock, timeout, [this]() { return !_held; })) {
+        return false;
+    }
+    _held = true;
+    return true;
+}
+
+void AsyncLock::LockAsync(Continuation continuation) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_held) {
+            _continuations.emplace_back(std::move(continuation));
+            return;
+        }
+        _held = true;
+    }
+    continuation();
+}
+
+void AsyncLock::Unlock() {
+    Continuation next;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_continuations.empty()) {
+            _held = false;
+        } else {
+            // The lock stays held, it's handed over to the continuation.
+            next = std::move(_continuations.front());
+            _continuations.pop_front();
+        }
+    }
+
+    if (next) {
+        next();
+    } else {
+        _released.notify_one();
+    }
+}
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> An exclusive lock that can be waited for synchronously, or asynchronously without holding a thread. </summary>
+    /// <remarks>
+    ///     Unlike std::mutex, the lock isn't owned by a thread, any thread can release it.
+    ///     On release the lock is handed to the oldest asynchronous waiter first, then to synchronous waiters.
+    ///     It's not recursive, obtaining it again while holding it never returns.
+    /// </remarks>
+    class AsyncLock {
+    public:
+
+        /// <summary> Called with the lock held, the callee is responsible for releasing it. </summary>
+        using Continuation = std::function<void()>;
+
+        AsyncLock();
+
+        AsyncLock(const AsyncLock&) = delete;
+        AsyncLock& operator=(const AsyncLock&) = delete;
+
+        /// <summary> Obtains the lock, blocking the calling thread until it's available. </summary>
+        void Lock();
+
+        /// <summary> Obtains the lock if it's available right away. </summary>
+        /// <returns> True if the lock was obtained. </returns>
+        bool TryLock();
+
+        /// <summary> Obtains the lock, blocking the calling thread at most for the given timeout. </summary>
+        /// <returns> True if the lock was obtained. </returns>
+        bool TryLockFor(std::chrono::milliseconds timeout);
+
+        /// <summary> Obtains the lock asynchronously. </summary>
+        /// <param name="continuation">
+        ///     Runs once the lock is obtained, on the calling thread if it's available right away,
+        ///     or otherwise on the thread that releases it. It should only schedule work and return.
+        /// </param>
+        void LockAsync(Continuation continuation);
+
+        /// <summary> Releases the lock, handing it to the next waiter if any. </summary>
+        void Unlock();
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _released;
+        std::deque<Continuation> _continuations;
+        bool _held;
+    };
+}
+}
@@ -7,6 +7,8 @@
 #include <zone/worker-context.h>
 #include <zone/napa-zone.h>
 
+#include <napa/providers/metric.h>
+
 using namespace napa;
 using namespace napa::zone;
 
@@ -21,6 +23,32 @@ namespace {
                                                    AsyncWork asyncWork,
                                                    AsyncCompleteCallback asyncCompleteCallback);
 
+    /// <summary> Reports the load of the zone's async work pool. </summary>
+    void ReportAsyncWorkMetrics(const NapaZone& zone);
+
+    /// <summary> A task to run the callback of a worker continuation. </summary>
+    class ContinuationTask : public Task {
+    public:
+        ContinuationTask(std::shared_ptr<Scheduler> scheduler, WorkerId workerId, std::function<void()> callback) :
+            _scheduler(std::move(scheduler)), _workerId(workerId), _callback(std::move(callback)) {}
+
+        void Execute() override {
+            auto isolate = v8::Isolate::GetCurrent();
+            v8::HandleScope scope(isolate);
+
+            _callback();
+            _scheduler->ReleaseWorker(_workerId);
+        }
+
+        // Continuations run on their retained worker and are never dropped, see CanReject.
+        void Reject(napa::ResultCode /*code*/, const std::string& /*reason*/) override {}
+
+    private:
+        std::shared_ptr<Scheduler> _scheduler;
+        WorkerId _workerId;
+        std::function<void()> _callback;
+    };
+
 }   // End of anonymous namespace.
 
 /// <summary> It runs a synchronous function in the separate thread and posts a completion into the current V8 execution loop. </summary>
@@ -35,12 +63,12 @@ void napa::zone::PostAsyncWork(v8::Local<v8::Function> jsCallback,
         return;
     }
 
-    context->future = std::async(std::launch::async, [context]() {
+    // The pool bounds the number of threads, work beyond it waits in the pool queue.
+    context->zone->GetAsyncWorkPool().Execute([context]() {
         context->result = context->asyncWork();
-
-        auto asyncCompleteTask = std::make_shared<AsyncCompleteTask>(context);
-        context->zone->GetScheduler()->ScheduleOnWorker(context->workerId, asyncCompleteTask);
+        context->completions->Post(context);
     });
+    ReportAsyncWorkMetrics(*context->zone);
 }
 
 /// <summary> It runs an asynchronous function and post a completion into the current V8 execution loop. </summary>
@@ -55,14 +83,43 @@ void napa::zone::DoAsyncWork(v8::Local<v8::Function> jsCallback,
         return;
     }
 
+    // The completion, i.e. of a call on another zone, goes straight onto the completions of the calling worker.
     asyncWork([context](void* result) {
         context->result = result;
-
-        auto asyncCompleteTask = std::make_shared<AsyncCompleteTask>(context);
-        context->zone->GetScheduler()->ScheduleOnWorker(context->workerId, asyncCompleteTask);
+        context->completions->Post(context);
     });
 }
 
+WorkerContinuation napa::zone::CreateWorkerContinuation() {
+    auto zone = reinterpret_cast<NapaZone*>(WorkerContext::Get(WorkerContextItem::ZONE));
+    if (zone == nullptr) {
+        return nullptr;
+    }
+
+    auto scheduler = zone->GetScheduler();
+    auto workerId = static_cast<WorkerId>(
+        reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
+
+    // The continuation is pinned to this worker, keep it running until the continuation is done.
+    scheduler->RetainWorker(workerId);
+
+    // The worker stays retained, so the task is queued locally from any thread without the scheduler's synchronizer.
+    return [scheduler, workerId](std::function<void()> callback) {
+        scheduler->ScheduleOnRetainedWorker(workerId, std::make_shared<ContinuationTask>(scheduler, workerId, std::move(callback)));
+    };
+}
+
+bool napa::zone::PostToAsyncWorkPool(std::function<void()> work) {
+    auto zone = reinterpret_cast<NapaZone*>(WorkerContext::Get(WorkerContextItem::ZONE));
+    if (zone == nullptr) {
+        return false;
+    }
+
+    zone->GetAsyncWorkPool().Execute(std::move(work));
+    ReportAsyncWorkMetrics(*zone);
+    return true;
+}
+
 namespace {
 
     std::shared_ptr<AsyncContext> PrepareAsyncWork(v8::Local<v8::Function> jsCallback,
@@ -82,6 +139,10 @@ namespace {
         context->workerId = static_cast<WorkerId>(
             reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
 
+        // The completion is pinned to this worker, keep it running until the completion is done.
+        context->scheduler->RetainWorker(context->workerId);
+        context->completions = &AsyncCompletionQueue::GetCurrent();
+
         context->jsCallback.Reset(isolate, jsCallback);
         context->asyncWork = std::move(asyncWork);
         context->asyncCompleteCallback = std::move(asyncCompleteCallback);
@@ -89,4 +150,17 @@ namespace {
         return context;
     }
 
+    void ReportAsyncWorkMetrics(const NapaZone& zone) {
+        static const char* dimensionNames[] = { "Zone" };
+        static auto queueLengthMetric = providers::GetMetricProvider().GetMetric(
+            "Napa", "AsyncWorkQueueLength", providers::MetricType::Number, 1, dimensionNames);
+        static auto activeWorkersMetric = providers::GetMetricProvider().GetMetric(
+            "Napa", "AsyncWorkActiveThreads", providers::MetricType::Number, 1, dimensionNames);
+
+        const char* dimensionValues[] = { zone.GetId().c_str() };
+        const auto& pool = zone.GetAsyncWorkPool();
+        queueLengthMetric->Set(static_cast<int64_t>(pool.GetQueueLength()), 1, dimensionValues);
+        activeWorkersMetric->Set(static_cast<int64_t>(pool.GetActiveWorkerCount()), 1, dimensionValues);
+    }
+
 }   // End of anonymous namespace.
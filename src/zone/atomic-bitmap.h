@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A fixed size bitmap whose bits can be set and claimed concurrently without locks. </summary>
+    class AtomicBitmap {
+    public:
+
+        /// <summary> Constructor. All bits are initially cleared. </summary>
+        /// <param name="size"> The number of bits. </param>
+        explicit AtomicBitmap(size_t size) :
+            _size(size),
+            _wordCount((size + BITS_PER_WORD - 1) / BITS_PER_WORD),
+            _words(std::make_unique<std::atomic<uint64_t>[]>(_wordCount)),
+            _claimHint(0) {
+
+            for (size_t i = 0; i < _wordCount; ++i) {
+                _words[i].store(0, std::memory_order_relaxed);
+            }
+        }
+
+        AtomicBitmap(const AtomicBitmap&) = delete;
+        AtomicBitmap& operator=(const AtomicBitmap&) = delete;
+
+        /// <summary> Sets a bit. </summary>
+        void Set(size_t index) {
+            _words[index / BITS_PER_WORD].fetch_or(Mask(index), std::memory_order_seq_cst);
+        }
+
+        /// <summary> Clears a bit. </summary>
+        /// <returns> True if the bit was set before the call. </returns>
+        bool Clear(size_t index) {
+            auto mask = Mask(index);
+            return (_words[index / BITS_PER_WORD].fetch_and(~mask, std::memory_order_seq_cst) & mask) != 0;
+        }
+
+        /// <summary> Clears all bits. </summary>
+        void ClearAll() {
+            for (size_t i = 0; i < _wordCount; ++i) {
+                _words[i].store(0, std::memory_order_seq_cst);
+            }
+        }
+
+        /// <summary> Returns whether a bit is set. </summary>
+        bool Test(size_t index) const {
+            return (_words[index / BITS_PER_WORD].load(std::memory_order_acquire) & Mask(index)) != 0;
+        }
+
+        /// <summary> Atomically finds and clears a set bit. </summary>
+        /// <param name="index"> Out parameter that receives the index of the claimed bit. </param>
+        /// <returns> True if a bit was claimed, false if no bit is set. </returns>
+        /// <remarks> The search starts at a rotating position so claims are spread across all bits. </remarks>
+        bool TryClaim(size_t& index) {
+            auto hint = _claimHint.fetch_add(1, std::memory_order_relaxed) % _size;
+            auto startWord = hint / BITS_PER_WORD;
+            auto startBit = hint % BITS_PER_WORD;
+
+            for (size_t i = 0; i <= _wordCount; ++i) {
+                auto wordIndex = (startWord + i) % _wordCount;
+                auto& word = _words[wordIndex];
+
+                // The first visit of the start word only looks at bits at or above the hint.
+                auto lowMask = (i == 0) ? ~((uint64_t(1) << startBit) - 1) : ~uint64_t(0);
+
+                auto bits = word.load(std::memory_order_acquire);
+                while ((bits & lowMask) != 0) {
+                    auto bit = CountTrailingZeros(bits & lowMask);
+                    auto mask = uint64_t(1) << bit;
+                    if (word.compare_exchange_weak(bits, bits & ~mask, std::memory_order_seq_cst)) {
+                        index = wordIndex * BITS_PER_WORD + bit;
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        /// <summary> Returns the number of bits. </summary>
+        size_t Size() const {
+            return _size;
+        }
+
+    private:
+
+        static constexpr size_t BITS_PER_WORD = 64;
+
+        static uint64_t Mask(size_t index) {
+            return uint64_t(1) << (index % BITS_PER_WORD);
+        }
+
+        static size_t CountTrailingZeros(uint64_t value) {
+#ifdef _MSC_VER
+            unsigned long result;
+            _BitScanForward64(&result, value);
+            return static_cast<size_t>(result);
+#else
+            return static_cast<size_t>(__builtin_ctzll(value));
+#endif
+        }
+
+        const size_t _size;
+        const size_t _wordCount;
+        std::unique_ptr<std::atomic<uint64_t>[]> _words;
+        std::atomic<size_t> _claimHint;
+    };
+}
+}
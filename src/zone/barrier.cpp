@@ -0,0 +1,53 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "barrier.h"
+
+using namespace napa::zone;
+
+Barrier::Barrier(uint32_t parties) : _parties(parties < 1 ? 1 : parties), _arrived(0), _phase(0) {
+}
+
+bool Barrier::ArriveAndWait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (++_arrived == _parties) {
+        CompletePhase(lock);
+        return true;
+    }
+
+    auto phase = _phase;
+    _completed.wait(lock, [this, phase]() { return _phase != phase; });
+    return false;
+}
+
+void Barrier::ArriveAndWaitAsync(Continuation continuation) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (++_arrived == _parties) {
+        CompletePhase(lock);
+        continuation(true);
+        return;
+    }
+    _continuations.emplace_back(std::move(continuation));
+}
+
+uint32_t Barrier::GetParties() const {
+    return _parties;
+}
+
+uint32_t Barrier::GetArrived() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _arrived;
+}
+
+void Barrier::CompletePhase(std::unique_lock<std::mutex>& lock) {
+    std::deque<Continuation> continuations;
+    continuations.swap(_continuations);
+    _arrived = 0;
+    ++_phase;
+    lock.unlock();
+
+    _completed.notify_all();
+    for (auto& continuation : continuations) {
+        continuation(false);
+    }
+}
@@ -0,0 +1,60 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A reusable barrier for a fixed number of parties, waited for synchronously or asynchronously. </summary>
+    /// <remarks> Once all parties arrived, they are all released and the barrier is ready for the next phase. </remarks>
+    class Barrier {
+    public:
+
+        /// <summary> Called once all parties arrived, with true for the party whose arrival completed the phase. </summary>
+        using Continuation = std::function<void(bool last)>;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="parties"> The number of parties that complete a phase, at least 1. </param>
+        explicit Barrier(uint32_t parties);
+
+        Barrier(const Barrier&) = delete;
+        Barrier& operator=(const Barrier&) = delete;
+
+        /// <summary> Arrives at the barrier, blocking the calling thread until all parties arrived. </summary>
+        /// <returns> True for the party whose arrival completed the phase. </returns>
+        bool ArriveAndWait();
+
+        /// <summary> Arrives at the barrier, waiting for the other parties asynchronously. </summary>
+        /// <param name="continuation">
+        ///     Runs once all parties arrived, on the thread of the last party to arrive.
+        ///     It should only schedule work and return.
+        /// </param>
+        void ArriveAndWaitAsync(Continuation continuation);
+
+        /// <summary> Returns the number of parties that complete a phase. </summary>
+        uint32_t GetParties() const;
+
+        /// <summary> Returns the number of parties that arrived in the current phase. </summary>
+        uint32_t GetArrived() const;
+
+    private:
+
+        /// <summary> Starts the next phase once the last party arrived, releases the lock and the waiters. </summary>
+        void CompletePhase(std::unique_lock<std::mutex>& lock);
+
+        mutable std::mutex _mutex;
+        std::condition_variable _completed;
+        std::deque<Continuation> _continuations;
+        const uint32_t _parties;
+        uint32_t _arrived;
+        uint64_t _phase;
+    };
+}
+}
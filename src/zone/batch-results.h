@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Collects the results of a batch execution and delivers them through a single callback. </summary>
+    class BatchResults : public std::enable_shared_from_this<BatchResults> {
+    public:
+
+        /// <summary> Creates a collector for a batch of a given size. </summary>
+        /// <param name="count"> The number of calls in the batch. </param>
+        /// <param name="callback"> Callback that is triggered once all calls completed. </param>
+        static std::shared_ptr<BatchResults> Create(size_t count, ExecuteBatchCallback callback) {
+            return std::shared_ptr<BatchResults>(new BatchResults(count, std::move(callback)));
+        }
+
+        /// <summary> Returns a callback that records the result of the call at the given index. </summary>
+        /// <remarks> The returned callback keeps the collector alive until it is invoked. </remarks>
+        ExecuteCallback CallbackAt(size_t index) {
+            auto self = shared_from_this();
+            return [self, index](Result result) {
+                self->_results[index] = std::move(result);
+                if (--self->_remaining == 0) {
+                    self->_callback(std::move(self->_results));
+                }
+            };
+        }
+
+    private:
+
+        BatchResults(size_t count, ExecuteBatchCallback callback) :
+            _results(count),
+            _remaining(count),
+            _callback(std::move(callback)) {}
+
+        /// <summary> Results in the order of the batch. </summary>
+        std::vector<Result> _results;
+
+        /// <summary> Number of calls that haven't completed yet. </summary>
+        std::atomic<size_t> _remaining;
+
+        /// <summary> Callback when all calls completed. </summary>
+        ExecuteBatchCallback _callback;
+    };
+}
+}
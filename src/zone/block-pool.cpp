@@ -0,0 +1,79 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "block-pool.h"
+
+#include <new>
+
+using namespace napa::zone;
+
+namespace {
+    size_t GetSizeClassIndex(size_t size) {
+        return size == 0 ? 0 : (size - 1) / BLOCK_POOL_SIZE_CLASS;
+    }
+}
+
+BlockPool::BlockPool(size_t maxFreeBlocks) : _maxFreeBlocks(maxFreeBlocks) {
+}
+
+BlockPool::~BlockPool() {
+    for (auto& sizeClass : _sizeClasses) {
+        while (sizeClass.head != nullptr) {
+            auto block = sizeClass.head;
+            sizeClass.head = block->next;
+            ::operator delete(block);
+        }
+    }
+}
+
+void* BlockPool::Allocate(size_t size) {
+    if (size > BLOCK_POOL_MAX_BLOCK_SIZE) {
+        return ::operator new(size);
+    }
+
+    auto index = GetSizeClassIndex(size);
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto& sizeClass = _sizeClasses[index];
+        if (sizeClass.head != nullptr) {
+            auto block = sizeClass.head;
+            sizeClass.head = block->next;
+            sizeClass.count--;
+            return block;
+        }
+    }
+
+    // Blocks are allocated with the full size of their class, so they can be reused by any size in the class.
+    return ::operator new((index + 1) * BLOCK_POOL_SIZE_CLASS);
+}
+
+void BlockPool::Deallocate(void* block, size_t size) {
+    if (size > BLOCK_POOL_MAX_BLOCK_SIZE) {
+        ::operator delete(block);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto& sizeClass = _sizeClasses[GetSizeClassIndex(size)];
+        if (sizeClass.count < _maxFreeBlocks) {
+            auto freeBlock = static_cast<FreeBlock*>(block);
+            freeBlock->next = sizeClass.head;
+            sizeClass.head = freeBlock;
+            sizeClass.count++;
+            return;
+        }
+    }
+
+    ::operator delete(block);
+}
+
+size_t BlockPool::GetFreeBlockCount() const {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    size_t count = 0;
+    for (const auto& sizeClass : _sizeClasses) {
+        count += sizeClass.count;
+    }
+    return count;
+}
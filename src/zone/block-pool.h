@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> The size granularity of blocks served by a block pool. </summary>
+    constexpr size_t BLOCK_POOL_SIZE_CLASS = 16;
+
+    /// <summary> The largest block served by a block pool, larger requests go to the global allocator. </summary>
+    constexpr size_t BLOCK_POOL_MAX_BLOCK_SIZE = 512;
+
+    /// <summary> A thread safe pool of small memory blocks, recycled through one intrusive free list per size class. </summary>
+    /// <remarks>
+    ///     Blocks are allocated from the global allocator the first time and kept in the free list when released,
+    ///     so a steady flow of same sized objects doesn't touch the global allocator anymore.
+    /// </remarks>
+    class BlockPool {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="maxFreeBlocks"> The number of released blocks kept per size class. </param>
+        explicit BlockPool(size_t maxFreeBlocks);
+
+        /// <summary> Destructor. Returns the free blocks to the global allocator. </summary>
+        ~BlockPool();
+
+        BlockPool(const BlockPool&) = delete;
+        BlockPool& operator=(const BlockPool&) = delete;
+
+        /// <summary> Allocates a block of at least the given size. </summary>
+        void* Allocate(size_t size);
+
+        /// <summary> Releases a block allocated from this pool with the same size. </summary>
+        void Deallocate(void* block, size_t size);
+
+        /// <summary> Returns the number of released blocks kept for reuse. </summary>
+        size_t GetFreeBlockCount() const;
+
+    private:
+
+        /// <summary> A released block links to the next one in place. </summary>
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        static constexpr size_t SIZE_CLASS_COUNT = BLOCK_POOL_MAX_BLOCK_SIZE / BLOCK_POOL_SIZE_CLASS;
+
+        struct SizeClass {
+            FreeBlock* head = nullptr;
+            size_t count = 0;
+        };
+
+        mutable std::mutex _lock;
+        SizeClass _sizeClasses[SIZE_CLASS_COUNT];
+        size_t _maxFreeBlocks;
+    };
+
+    /// <summary> STL allocator that allocates from a block pool, and keeps the pool alive while it is in use. </summary>
+    /// <remarks> Used with std::allocate_shared, the object and its control block come from the pool. </remarks>
+    template <typename T>
+    class PoolAllocator {
+    public:
+        using value_type = T;
+
+        explicit PoolAllocator(std::shared_ptr<BlockPool> pool) : _pool(std::move(pool)) {}
+
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>& other) : _pool(other._pool) {}
+
+        T* allocate(size_t count) {
+            return static_cast<T*>(_pool->Allocate(sizeof(T) * count));
+        }
+
+        void deallocate(T* pointer, size_t count) {
+            _pool->Deallocate(pointer, sizeof(T) * count);
+        }
+
+        template <typename U>
+        bool operator==(const PoolAllocator<U>& other) const {
+            return _pool == other._pool;
+        }
+
+        template <typename U>
+        bool operator!=(const PoolAllocator<U>& other) const {
+            return _pool != other._pool;
+        }
+
+    private:
+        template <typename U>
+        friend class PoolAllocator;
+
+        std::shared_ptr<BlockPool> _pool;
+    };
+
+    /// <summary> Creates a shared object whose memory, including its control block, comes from a block pool. </summary>
+    template <typename T, typename... Args>
+    std::shared_ptr<T> AllocateShared(const std::shared_ptr<BlockPool>& pool, Args&&... args) {
+        return std::allocate_shared<T>(PoolAllocator<T>(pool), std::forward<Args>(args)...);
+    }
+}
+}
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "call-coalescer.h"
+
+using namespace napa;
+using namespace napa::zone;
+
+bool CallCoalescer::Join(const std::string& key, Callback callback) {
+    std::lock_guard<std::mutex> lock(_lock);
+    auto& callbacks = _calls[key];
+    callbacks.emplace_back(std::move(callback));
+    return callbacks.size() == 1;
+}
+
+void CallCoalescer::Complete(const std::string& key, Result result) {
+    std::vector<Callback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto iter = _calls.find(key);
+        if (iter == _calls.end()) {
+            return;
+        }
+        callbacks.swap(iter->second);
+        _calls.erase(iter);
+    }
+
+    // Calls arriving from here on start a new call, the result is delivered outside of the lock.
+    for (size_t i = 1; i < callbacks.size(); i++) {
+        Result copy;
+        copy.code = result.code;
+        copy.errorMessage = result.errorMessage;
+        copy.returnValue = result.returnValue;
+        copy.transportContext = result.transportContext != nullptr
+            ? result.transportContext->Share()
+            : std::make_unique<napa::transport::TransportContext>();
+        copy.timing = result.timing;
+        callbacks[i](std::move(copy));
+    }
+    callbacks[0](std::move(result));
+}
+
+size_t CallCoalescer::GetInFlightCount() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _calls.size();
+}
@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary>
+    ///     Keeps track of the coalescing calls of a zone that are in flight, so identical calls arriving meanwhile
+    ///     wait for the first one instead of running, and all of them receive its result.
+    /// </summary>
+    class CallCoalescer {
+    public:
+
+        /// <summary> The callback of a call. </summary>
+        using Callback = std::function<void(Result)>;
+
+        /// <summary> Constructor. </summary>
+        CallCoalescer() = default;
+
+        /// <summary> Non-copyable. </summary>
+        CallCoalescer(const CallCoalescer&) = delete;
+        CallCoalescer& operator=(const CallCoalescer&) = delete;
+
+        /// <summary> Joins the in-flight call with a key, or starts one. </summary>
+        /// <param name="key"> The key of the call, see ResultCache::MakeKey. </param>
+        /// <param name="callback"> Receives the result of the call. </param>
+        /// <returns> True if no identical call is in flight and the caller has to run the call, then Complete it. </returns>
+        bool Join(const std::string& key, Callback callback);
+
+        /// <summary> Delivers the result of the in-flight call with a key to all calls that joined it. </summary>
+        /// <remarks> Each call after the first receives its own transport context, sharing the handles of the result. </remarks>
+        void Complete(const std::string& key, Result result);
+
+        /// <summary> Returns the number of calls in flight, not counting the calls that joined them. </summary>
+        size_t GetInFlightCount() const;
+
+    private:
+        mutable std::mutex _lock;
+        std::unordered_map<std::string, std::vector<Callback>> _calls;
+    };
+}
+}
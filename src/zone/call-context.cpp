@@ -10,7 +10,10 @@
 
 #include <napa/log.h>
 #include <napa/v8-helpers.h>
+#include <platform/tracepoint.h>
+#include <utils/payload-compression.h>
 
+#include <algorithm>
 #include <stdint.h>
 
 using namespace napa::zone;
@@ -18,36 +21,81 @@ using namespace napa::zone;
 CallContext::CallContext(const napa::FunctionSpec& spec, napa::ExecuteCallback callback) : 
     _module(NAPA_STRING_REF_TO_STD_STRING(spec.module)),
     _function(NAPA_STRING_REF_TO_STD_STRING(spec.function)),
-    _callback(callback),
-    _finished(false) {
+    _softDeadline(0),
+    _callback(std::move(callback)),
+    _finished(false),
+    _dispatchedAt(0),
+    _startedAt(0),
+    _finishedAt(0) {
 
     // Audit start time.
     _startTime = std::chrono::high_resolution_clock::now();
     
-    _arguments.reserve(spec.arguments.size());
-    for (auto& arg : spec.arguments) {
-        _arguments.emplace_back(NAPA_STRING_REF_TO_STD_STRING(arg));
+    // Owned arguments are taken over, so large marshalled payloads are not copied on the caller's thread.
+    if (!spec.ownedArguments.empty()) {
+        _arguments = std::move(spec.ownedArguments);
+    } else {
+        _arguments.reserve(spec.arguments.size());
+        for (auto& arg : spec.arguments) {
+            _arguments.emplace_back(NAPA_STRING_REF_TO_STD_STRING(arg));
+        }
     }
     _options = spec.options;
 
+    // Large arguments stay compressed while the call is queued. Binary arguments may start with any bytes, so they never are.
+    if (_options.compression_threshold != 0 && _options.transport != BINARY) {
+        for (auto& argument : _arguments) {
+            napa::utils::CompressPayload(argument, _options.compression_threshold, napa::utils::PayloadSource::Call);
+        }
+    }
+
     // Pass ownership of the transport context.
     _transportContext = std::move(spec.transportContext);
 }
 
+CallContext::CallContext(std::shared_ptr<const SharedFunctionSpec> spec,
+                         const napa::CallOptions& options,
+                         std::unique_ptr<napa::transport::TransportContext> transportContext,
+                         napa::ExecuteCallback callback) :
+    _sharedSpec(std::move(spec)),
+    _options(options),
+    _softDeadline(0),
+    _transportContext(std::move(transportContext)),
+    _callback(std::move(callback)),
+    _finished(false),
+    _dispatchedAt(0),
+    _startedAt(0),
+    _finishedAt(0) {
+
+    // Audit start time.
+    _startTime = std::chrono::high_resolution_clock::now();
+}
+
 bool CallContext::Resolve(std::string marshalledResult) {
     auto expected = false;
     if (!_finished.compare_exchange_strong(expected, true)) {
         return false;
     }
 
-    NAPA_DEBUG("CallTask", "Call to \"%s.%s\" is resolved successfully.", _module.c_str(), _function.c_str());
+    NAPA_DEBUG("CallTask", "Call to \"%s.%s\" is resolved successfully.", GetModule().c_str(), GetFunction().c_str());
+
+    // The result stays compressed until the caller reads it, see DecompressResult.
+    if (_options.compression_threshold != 0 && _options.transport != BINARY) {
+        napa::utils::CompressPayload(marshalledResult, _options.compression_threshold, napa::utils::PayloadSource::Call);
+    }
+
+    auto timing = GetTiming();
+    RecordSpan(NAPA_RESULT_SUCCESS, timing);
+    NAPA_TRACEPOINT3(call__resolve, "module", GetModule().c_str(), "function", GetFunction().c_str(), "executeNs", timing.execute);
 
     _callback({ 
         NAPA_RESULT_SUCCESS, 
         "", 
         std::move(marshalledResult),
-        std::move(_transportContext) 
+        std::move(_transportContext),
+        _options.record_timing != 0 ? timing : napa::CallTiming{ 0, 0, 0, 0 }
     });
+    RunFinishedCallback(NAPA_RESULT_SUCCESS);
     return true;
 }
 
@@ -57,9 +105,24 @@ bool CallContext::Reject(napa::ResultCode code, std::string reason) {
         return false;
     }
 
-    NAPA_DEBUG("CallTask", "Call to \"%s.%s\" was rejected: %s.", _module.c_str(), _function.c_str(), reason.c_str());
+    NAPA_DEBUG("CallTask", "Call to \"%s.%s\" was rejected: %s.", GetModule().c_str(), GetFunction().c_str(), reason.c_str());
+
+    auto timing = GetTiming();
+    RecordSpan(code, timing);
+    NAPA_TRACEPOINT3(call__reject, "module", GetModule().c_str(), "function", GetFunction().c_str(), "code", static_cast<int32_t>(code));
+
+    _callback({ code, reason, "", std::move(_transportContext), _options.record_timing != 0 ? timing : napa::CallTiming{ 0, 0, 0, 0 } });
+    RunFinishedCallback(code);
+    return true;
+}
 
-    _callback({ code, reason, "", std::move(_transportContext) });
+bool CallContext::SetFinishedCallback(std::function<void(napa::ResultCode)> callback) {
+    // A call finishing meanwhile either sees the callback or is seen as finished here.
+    std::lock_guard<std::mutex> lock(_finishedCallbackLock);
+    if (_finished) {
+        return false;
+    }
+    _finishedCallback = std::move(callback);
     return true;
 }
 
@@ -68,15 +131,39 @@ bool CallContext::IsFinished() const {
 }
 
 const std::string& CallContext::GetModule() const {
-    return _module;
+    return _sharedSpec != nullptr ? _sharedSpec->module : _module;
 }
 
 const std::string& CallContext::GetFunction() const {
-    return _function;
+    return _sharedSpec != nullptr ? _sharedSpec->function : _function;
 }
 
 const std::vector<std::string>& CallContext::GetArguments() const {
-    return _arguments;
+    return _sharedSpec != nullptr ? _sharedSpec->arguments : _arguments;
+}
+
+bool CallContext::DecompressArguments() {
+    // Shared specs are never compressed, and JSON never starts with the marker of a compressed payload.
+    if (_sharedSpec != nullptr || _options.transport == BINARY) {
+        return true;
+    }
+
+    for (auto& argument : _arguments) {
+        if (!napa::utils::DecompressPayload(argument)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CallContext::DecompressResult(napa::Result& result, napa::TransportOption transport) {
+    if (result.code != NAPA_RESULT_SUCCESS || transport == BINARY || napa::utils::DecompressPayload(result.returnValue)) {
+        return;
+    }
+
+    result.code = NAPA_RESULT_INTERNAL_ERROR;
+    result.errorMessage = "Compressed return value is corrupted.";
+    result.returnValue.clear();
 }
 
 napa::transport::TransportContext& CallContext::GetTransportContext() {
@@ -87,6 +174,110 @@ const napa::CallOptions& CallContext::GetOptions() const {
     return _options;
 }
 
+void CallContext::SetSoftDeadline(int64_t deadline) {
+    _softDeadline = deadline;
+}
+
+int64_t CallContext::GetDeadline() const {
+    if (_softDeadline == 0 || _options.deadline == 0) {
+        return std::max(_softDeadline, _options.deadline);
+    }
+    return std::min(_softDeadline, _options.deadline);
+}
+
+void CallContext::InheritDeadline(int64_t deadline) {
+    if (deadline > 0 && (_options.deadline == 0 || deadline < _options.deadline)) {
+        _options.deadline = deadline;
+    }
+}
+
+void CallContext::SetTrace(const TraceContext& trace, const std::string& zoneId) {
+    _trace = trace;
+    if (_trace.sampled) {
+        _zoneId = zoneId;
+    }
+}
+
+const TraceContext& CallContext::GetTrace() const {
+    return _trace;
+}
+
+bool CallContext::IsTimed() const {
+    return _options.record_timing != 0 || _trace.sampled;
+}
+
 std::chrono::nanoseconds CallContext::GetElapse() const {
     return std::chrono::high_resolution_clock::now() - _startTime;
-}
\ No newline at end of file
+}
+void CallContext::MarkDispatched() {
+    Mark(_dispatchedAt);
+}
+
+void CallContext::MarkStarted() {
+    Mark(_startedAt);
+}
+
+void CallContext::MarkFinished() {
+    Mark(_finishedAt);
+}
+
+void CallContext::Mark(std::atomic<int64_t>& mark) {
+    if (IsTimed()) {
+        mark.store(std::max<int64_t>(GetElapse().count(), 1), std::memory_order_relaxed);
+    }
+}
+
+void CallContext::RunFinishedCallback(napa::ResultCode code) {
+    std::function<void(napa::ResultCode)> callback;
+    {
+        std::lock_guard<std::mutex> lock(_finishedCallbackLock);
+        callback.swap(_finishedCallback);
+    }
+
+    if (callback) {
+        callback(code);
+    }
+}
+
+napa::CallTiming CallContext::GetTiming() const {
+    napa::CallTiming timing = { 0, 0, 0, 0 };
+    if (!IsTimed()) {
+        return timing;
+    }
+
+    auto end = GetElapse().count();
+    auto dispatched = _dispatchedAt.load(std::memory_order_relaxed);
+    auto started = _startedAt.load(std::memory_order_relaxed);
+    auto finished = _finishedAt.load(std::memory_order_relaxed);
+
+    timing.queue = dispatched != 0 ? dispatched : end;
+    if (dispatched != 0) {
+        timing.unmarshall = (started != 0 ? started : end) - dispatched;
+    }
+    if (started != 0) {
+        timing.execute = (finished != 0 ? finished : end) - started;
+    }
+    if (finished != 0) {
+        timing.marshall = end - finished;
+    }
+    return timing;
+}
+
+void CallContext::RecordSpan(napa::ResultCode code, const napa::CallTiming& timing) {
+    if (!_trace.sampled) {
+        return;
+    }
+
+    auto duration = GetElapse().count();
+    SpanRecorder::GetInstance().Record({
+        _trace.traceId,
+        _trace.spanId,
+        _trace.parentSpanId,
+        "call",
+        GetModule() + "." + GetFunction(),
+        _zoneId,
+        SpanRecorder::Now() - duration / 1000,
+        duration,
+        timing,
+        code });
+}
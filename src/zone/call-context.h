@@ -3,17 +3,28 @@
 
 #pragma once
 
+#include "span-recorder.h"
+
 #include <napa/types.h>
 #include <v8.h>
 
 #include <atomic>
 #include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace napa {
 namespace zone {
 
+    /// <summary> Module, function and marshalled arguments shared by several calls, i.e. of a broadcast. Immutable. </summary>
+    struct SharedFunctionSpec {
+        std::string module;
+        std::string function;
+        std::vector<std::string> arguments;
+    };
+
     /// <summary> Context of calling a JavaScript function. </summary>
     class CallContext {
 
@@ -21,6 +32,16 @@ namespace zone {
         /// <summary> Construct spec from external FunctionSpec. </summary>
         explicit CallContext(const napa::FunctionSpec& spec, napa::ExecuteCallback callback);
 
+        /// <summary> Construct spec that references a shared spec instead of copying it. </summary>
+        /// <param name="spec"> The module, function and arguments of the call. </param>
+        /// <param name="options"> The options of the call. </param>
+        /// <param name="transportContext"> The transport context of the arguments, may be null. </param>
+        /// <param name="callback"> Callback when the call completes. </param>
+        CallContext(std::shared_ptr<const SharedFunctionSpec> spec,
+                    const napa::CallOptions& options,
+                    std::unique_ptr<napa::transport::TransportContext> transportContext,
+                    napa::ExecuteCallback callback);
+
         /// <summary> Resolve current spec. </summary>
         /// <param name="result"> marshalled return value. </param>
         /// <returns> True if operation is successful, otherwise if task is already finished before. </returns>
@@ -33,6 +54,11 @@ namespace zone {
         /// <returns> True if operation is successful, otherwise if task is already finished before. </returns>
         bool Reject(napa::ResultCode code, std::string reason);
 
+        /// <summary> Sets a callback that runs once the call is resolved or rejected, after the result callback. </summary>
+        /// <param name="callback"> Called with the result code of the call. </param>
+        /// <returns> False if the call is finished already, then the callback never runs. </returns>
+        bool SetFinishedCallback(std::function<void(napa::ResultCode)> callback);
+
         /// <summary> Returns whether current job is completed or cancelled. </summary>
         bool IsFinished() const;
 
@@ -43,18 +69,73 @@ namespace zone {
         const std::string& GetFunction() const;
 
         /// <summary> Get marshalled arguments. </summary>
+        /// <remarks> Arguments may be compressed until DecompressArguments is called. </remarks>
         const std::vector<std::string>& GetArguments() const;
 
+        /// <summary> Decompress the arguments compressed by the caller, or forwarded compressed by a pipeline. </summary>
+        /// <returns> False if an argument is corrupted. </returns>
+        /// <remarks> Called on the worker, so the caller's thread only pays for compression. </remarks>
+        bool DecompressArguments();
+
+        /// <summary> Decompress the return value of a result, if the call compressed it. </summary>
+        /// <param name="result"> The result, which becomes an internal error if its return value is corrupted. </param>
+        /// <param name="transport"> The transport of the call, binary return values are never compressed. </param>
+        static void DecompressResult(napa::Result& result, napa::TransportOption transport);
+
         /// <summary> Get transport context. </summary>
         napa::transport::TransportContext& GetTransportContext();
 
         /// <summary> Get options. </summary>
         const napa::CallOptions& GetOptions() const;
 
+        /// <summary> Sets the time the call should stop by before it's terminated, when it runs with a timeout. </summary>
+        /// <param name="deadline"> Milliseconds since epoch, 0 for none. </param>
+        void SetSoftDeadline(int64_t deadline);
+
+        /// <summary> Get the time in milliseconds since epoch the call should finish by, 0 for none. </summary>
+        /// <remarks> The earliest of the deadline of its options and the time its timeout runs out. </remarks>
+        int64_t GetDeadline() const;
+
+        /// <summary> Moves the deadline of its options earlier, i.e. to the deadline of the call it's made from. </summary>
+        /// <param name="deadline"> Milliseconds since epoch, 0 keeps the deadline of its options. </param>
+        void InheritDeadline(int64_t deadline);
+
+        /// <summary> Sets the trace of the call, from SpanRecorder::StartCall. </summary>
+        /// <param name="trace"> The trace and span of the call. </param>
+        /// <param name="zoneId"> The zone the call runs in, the target of its span if the trace is sampled. </param>
+        void SetTrace(const TraceContext& trace, const std::string& zoneId);
+
+        /// <summary> Get the trace and span of the call, which calls it makes and logs it writes carry. </summary>
+        const TraceContext& GetTrace() const;
+
+        /// <summary> Whether the phases of the call are timed, for its options or for the span of a sampled trace. </summary>
+        bool IsTimed() const;
+
         /// <summary> Get elapse since task start in nano-second. </summary>
         std::chrono::nanoseconds GetElapse() const;
 
+        /// <summary> Records that a worker dispatched the call, if its options ask for timing. </summary>
+        void MarkDispatched();
+
+        /// <summary> Records that the function started, after the arguments were unmarshalled. </summary>
+        void MarkStarted();
+
+        /// <summary> Records that the function returned, before the result is marshalled. </summary>
+        void MarkFinished();
+
     private:
+        /// <summary> Records the elapse of a phase boundary, if the options ask for timing. </summary>
+        void Mark(std::atomic<int64_t>& mark);
+
+        /// <summary> Splits the elapse until now into phases, each ending at the next mark reached. </summary>
+        napa::CallTiming GetTiming() const;
+
+        /// <summary> Runs the finished callback, if one was set. Called once the call is finished. </summary>
+        void RunFinishedCallback(napa::ResultCode code);
+
+        /// <summary> Records the span of a sampled call once it finished. </summary>
+        void RecordSpan(napa::ResultCode code, const napa::CallTiming& timing);
+
         /// <summary> Module name. </summary>
         std::string _module;
 
@@ -64,9 +145,21 @@ namespace zone {
         /// <summary> Arguments. </summary>
         std::vector<std::string> _arguments;
 
+        /// <summary> Module, function and arguments used instead of the above, if the spec is shared. </summary>
+        std::shared_ptr<const SharedFunctionSpec> _sharedSpec;
+
         /// <summary> Execute options. </summary>
         napa::CallOptions _options;
 
+        /// <summary> The time in milliseconds since epoch the call's timeout runs out, 0 for none. </summary>
+        int64_t _softDeadline;
+
+        /// <summary> Trace and span of the call. </summary>
+        TraceContext _trace;
+
+        /// <summary> The zone the call runs in, only set for sampled traces. </summary>
+        std::string _zoneId;
+
         /// <summary> Transport context. </summary>
         std::unique_ptr<napa::transport::TransportContext> _transportContext;
 
@@ -76,8 +169,20 @@ namespace zone {
         /// <summary> Whether this task is finished. </summary>
         std::atomic<bool> _finished;
 
+        /// <summary> Callback when the call finishes, i.e. to count it out of its worker's calls in flight. </summary>
+        std::function<void(napa::ResultCode)> _finishedCallback;
+
+        /// <summary> Guards the finished callback, which is set on the worker while the call may finish on another thread. </summary>
+        std::mutex _finishedCallbackLock;
+
         /// <summary> Call start time. </summary>
         std::chrono::high_resolution_clock::time_point _startTime;
+
+        /// <summary> Elapse in nano-second when the call was dispatched, started and finished, 0 until reached. </summary>
+        /// <remarks> Atomic since a call may be rejected by another thread, i.e. on timeout or cancellation. </remarks>
+        std::atomic<int64_t> _dispatchedAt;
+        std::atomic<int64_t> _startedAt;
+        std::atomic<int64_t> _finishedAt;
     };
 }
 }
\ No newline at end of file
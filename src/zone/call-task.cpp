@@ -8,55 +8,270 @@
 
 #include "call-task.h"
 
+#include <memory/arena-allocator.h>
 #include <module/core-modules/napa/call-context-wrap.h>
+#include <platform/hardware-counters.h>
+#include <zone/napa-zone.h>
+#include <zone/worker-context.h>
 
 #include <napa/log.h>
 
+#include <algorithm>
+#include <chrono>
+
 using namespace napa::zone;
 using namespace napa::v8_helpers;
 
-napa::zone::CallTask::CallTask(std::shared_ptr<CallContext> context) : 
-    _context(std::move(context)) {
+/// <summary> Get the __napa_zone_call__ function of the current isolate, resolved once per worker. </summary>
+static v8::Local<v8::Value> GetZoneCallFunction(v8::Isolate* isolate, v8::Local<v8::Context> context) {
+    auto function = static_cast<v8::Persistent<v8::Function>*>(WorkerContext::Get(WorkerContextItem::ZONE_CALL_FUNCTION));
+    if (function != nullptr) {
+        return v8::Local<v8::Function>::New(isolate, *function);
+    }
+
+    auto value = context->Global()->Get(MakeExternalV8String(isolate, "__napa_zone_call__"));
+    if (value->IsFunction()) {
+        // Like persistent constructors, the handle lives as long as the isolate.
+        function = new v8::Persistent<v8::Function>(isolate, v8::Local<v8::Function>::Cast(value));
+        WorkerContext::Set(WorkerContextItem::ZONE_CALL_FUNCTION, function);
+    }
+    return value;
 }
 
-void CallTask::Execute() {
-    NAPA_DEBUG("CallTask", "Begin executing function (%s.%s).", _context->GetModule().c_str(), _context->GetFunction().c_str());
+/// <summary>
+///     Counts a call in flight on the current worker until it is resolved or rejected, which may be after the task returned,
+///     then records it in the statistics of its function.
+/// </summary>
+static void TrackInFlight(CallContext& callContext) {
+    auto zone = reinterpret_cast<NapaZone*>(WorkerContext::Get(WorkerContextItem::ZONE));
+    if (zone == nullptr) {
+        return;
+    }
+
+    // A call may be rejected after its zone is gone, i.e. by a timeout, so it doesn't keep the scheduler alive.
+    auto scheduler = zone->GetScheduler();
+    std::weak_ptr<Scheduler> weakScheduler = scheduler;
+    auto workerId = static_cast<WorkerId>(
+        reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
+
+    // The entry lives as long as its table, which the call holds until it finishes.
+    auto functionStatsTable = zone->GetFunctionStatsTable();
+    auto functionStats = functionStatsTable->GetEntry(workerId, callContext.GetModule(), callContext.GetFunction());
+    auto dispatchTime = std::chrono::steady_clock::now();
 
+    scheduler->OnCallDispatched(workerId);
+    auto finished = [weakScheduler, workerId, functionStatsTable, functionStats, dispatchTime](napa::ResultCode code) {
+        if (auto scheduler = weakScheduler.lock()) {
+            scheduler->OnCallFinished(workerId);
+        }
+        functionStats->Record(std::chrono::steady_clock::now() - dispatchTime, code != NAPA_RESULT_SUCCESS);
+    };
+    if (!callContext.SetFinishedCallback(std::move(finished))) {
+        scheduler->OnCallFinished(workerId);
+    }
+}
+
+/// <summary> Get the detector of slow calls of the current zone, null if it doesn't report slow calls. </summary>
+static SlowTaskDetector* GetSlowTaskDetector() {
+    auto zone = reinterpret_cast<NapaZone*>(WorkerContext::Get(WorkerContextItem::ZONE));
+    return zone != nullptr ? zone->GetSlowTaskDetector() : nullptr;
+}
+
+/// <summary> Get the hardware counters by function of the current zone, null if it doesn't count them. </summary>
+static FunctionCounterTable* GetFunctionCounterTable() {
+    auto zone = reinterpret_cast<NapaZone*>(WorkerContext::Get(WorkerContextItem::ZONE));
+    return zone != nullptr ? zone->GetFunctionCounterTable() : nullptr;
+}
+
+static int64_t NowInMilliseconds() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+napa::zone::CallTask::CallTask(std::shared_ptr<CallContext> context, std::shared_ptr<BlockPool> pool) :
+    _contexts(PoolAllocator<std::shared_ptr<CallContext>>(std::move(pool))) {
+    _contexts.reserve(1);
+    _contexts.emplace_back(std::move(context));
+}
+
+napa::zone::CallTask::CallTask(CallContexts contexts) :
+    _contexts(std::move(contexts)) {
+}
+
+void CallTask::Execute() {
     auto isolate = v8::Isolate::GetCurrent();
     v8::HandleScope scope(isolate);
     auto context = isolate->GetCurrentContext();
 
     // Get the module based main function from global scope.
-    auto executeFunction = context->Global()->Get(MakeExternalV8String(isolate, "__napa_zone_call__"));
+    auto executeFunction = GetZoneCallFunction(isolate, context);
     JS_ENSURE(isolate, executeFunction->IsFunction(), "__napa_zone_call__ function must exist in global scope");
 
-    // Create task wrap.
-    auto contextWrap = napa::module::CallContextWrap::NewInstance(_context);
-    v8::Local<v8::Value> argv[] = { contextWrap };
-
-    // Execute the function.
-    v8::TryCatch tryCatch(isolate);
-    auto res = v8::Local<v8::Function>::Cast(executeFunction)->Call(
-        isolate->GetCurrentContext(),
-        context->Global(),
-        1,
-        argv);
-
-    // Terminating an isolate may occur from a different thread, i.e. from timeout service.
-    // If the function call already finished successfully when the isolate is terminated it may lead
-    // to one the following:
-    //      1. Terminate was called before tryCatch.HasTerminated(), the user gets an error code.
-    //      2. Terminate was called after tryCatch.HasTerminated(), the user gets a success code.
-    //
-    //  In both cases the isolate is being restored since this happens before each task executes.
-    if (tryCatch.HasTerminated()) {
-        if (_terminationReason == TerminationReason::TIMEOUT) {
-            (void)_context->Reject(NAPA_RESULT_TIMEOUT, "Terminated due to timeout");
-        } else {
-            (void)_context->Reject(NAPA_RESULT_INTERNAL_ERROR, "Terminated with unknown reason");
+    SetRunningIsolate(isolate);
+    ExecuteCalls(isolate, context, v8::Local<v8::Function>::Cast(executeFunction));
+    SetRunningIsolate(nullptr);
+
+    // Calls leaving much garbage behind have it collected before the worker takes its next task.
+    auto collectGarbage = std::any_of(_contexts.begin(), _contexts.end(), [](const std::shared_ptr<CallContext>& callContext) {
+        return callContext->GetOptions().collect_garbage != 0;
+    });
+    if (collectGarbage) {
+        isolate->LowMemoryNotification();
+    }
+
+    // Request scoped memory of native modules lives until the calls of the task return.
+    auto arena = static_cast<napa::memory::ArenaAllocator*>(WorkerContext::Get(WorkerContextItem::TASK_ARENA));
+    if (arena != nullptr) {
+        arena->Reset();
+    }
+}
+
+void CallTask::ExecuteCalls(v8::Isolate* isolate, v8::Local<v8::Context> context, v8::Local<v8::Function> executeFunction) {
+    auto slowTaskDetector = GetSlowTaskDetector();
+    auto functionCounters = GetFunctionCounterTable();
+    auto workerId = static_cast<uint32_t>(
+        reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
+
+    for (size_t i = 0; i < _contexts.size(); i++) {
+        const auto& callContext = _contexts[i];
+
+        // A call that was cancelled while it was queued is dropped.
+        if (callContext->IsFinished()) {
+            continue;
+        }
+        NAPA_DEBUG("CallTask", "Begin executing function (%s.%s).", callContext->GetModule().c_str(), callContext->GetFunction().c_str());
+
+        // A call that is dispatched after its deadline is rejected without running.
+        auto deadline = callContext->GetOptions().deadline;
+        if (deadline > 0 && NowInMilliseconds() >= deadline) {
+            (void)callContext->Reject(NAPA_RESULT_TIMEOUT, "Deadline exceeded before execution");
+            continue;
+        }
+
+        // Handles created by each call are released before the next call in the chunk.
+        v8::HandleScope callScope(isolate);
+        TrackInFlight(*callContext);
+        callContext->SetSoftDeadline(_softDeadline);
+        callContext->MarkDispatched();
+
+        // Create task wrap, or reuse one released by an earlier call.
+        auto contextWrap = napa::module::CallContextWrap::Acquire(callContext);
+        v8::Local<v8::Value> argv[] = { contextWrap };
+
+        // Execute the function, watched by the slow call detector and counted by the hardware counters.
+        // Zone calls it makes synchronously inherit its deadline through the worker context.
+        v8::TryCatch tryCatch(isolate);
+        if (slowTaskDetector != nullptr) {
+            slowTaskDetector->Begin(workerId, isolate);
+        }
+        napa::platform::HardwareCounterSample countersBefore;
+        auto counting = functionCounters != nullptr && napa::platform::ReadThreadHardwareCounters(countersBefore);
+        WorkerContext::Set(WorkerContextItem::CALL_CONTEXT, callContext.get());
+        auto res = executeFunction->Call(
+            context,
+            context->Global(),
+            1,
+            argv);
+        WorkerContext::Set(WorkerContextItem::CALL_CONTEXT, nullptr);
+        napa::platform::HardwareCounterSample countersAfter;
+        if (counting && napa::platform::ReadThreadHardwareCounters(countersAfter)) {
+            napa::platform::HardwareCounterSample delta;
+            delta.cycles = countersAfter.cycles - countersBefore.cycles;
+            delta.instructions = countersAfter.instructions - countersBefore.instructions;
+            delta.cacheReferences = countersAfter.cacheReferences - countersBefore.cacheReferences;
+            delta.cacheMisses = countersAfter.cacheMisses - countersBefore.cacheMisses;
+            functionCounters->Add(workerId, callContext->GetModule(), callContext->GetFunction(), delta);
+        }
+        if (slowTaskDetector != nullptr) {
+            slowTaskDetector->End(workerId);
+        }
+
+        // Terminating an isolate may occur from a different thread, i.e. from timeout service.
+        // If the function call already finished successfully when the isolate is terminated it may lead
+        // to one the following:
+        //      1. Terminate was called before tryCatch.HasTerminated(), the user gets an error code.
+        //      2. Terminate was called after tryCatch.HasTerminated(), the user gets a success code.
+        //
+        //  In both cases the isolate is being restored since this happens before each task executes.
+        //  Calls of the chunk that didn't get to run are rejected with the same reason.
+        if (tryCatch.HasTerminated()) {
+            for (auto j = i; j < _contexts.size(); j++) {
+                if (_terminationReason == TerminationReason::TIMEOUT) {
+                    (void)_contexts[j]->Reject(NAPA_RESULT_TIMEOUT, "Terminated due to timeout");
+                } else if (_terminationReason == TerminationReason::CANCELLED) {
+                    (void)_contexts[j]->Reject(NAPA_RESULT_CANCELLED, "Terminated due to cancellation");
+                } else {
+                    (void)_contexts[j]->Reject(NAPA_RESULT_INTERNAL_ERROR, "Terminated with unknown reason");
+                }
+            }
+            return;
+        }
+
+        NAPA_ASSERT(!tryCatch.HasCaught(), "__napa_zone_call__ should catch all user exceptions and reject task.");
+
+        // __napa_zone_call__ returns true when the call completed without leaving continuations behind,
+        // nothing references the wrap anymore so it can serve the next call.
+        v8::Local<v8::Value> completed;
+        if (res.ToLocal(&completed) && completed->IsTrue()) {
+            napa::module::CallContextWrap::Release(contextWrap);
+        }
+    }
+}
+
+uint32_t CallTask::GetPriority() const {
+    uint32_t priority = 0;
+    for (const auto& callContext : _contexts) {
+        priority = std::max(priority, callContext->GetOptions().priority);
+    }
+    return priority;
+}
+
+int64_t CallTask::GetDeadline() const {
+    int64_t deadline = 0;
+    for (const auto& callContext : _contexts) {
+        auto callDeadline = callContext->GetOptions().deadline;
+        if (callDeadline > 0 && (deadline == 0 || callDeadline < deadline)) {
+            deadline = callDeadline;
+        }
+    }
+    return deadline;
+}
+
+uint64_t CallTask::GetRoutingKey() const {
+    for (const auto& callContext : _contexts) {
+        if (callContext->GetOptions().routing_key != 0) {
+            return callContext->GetOptions().routing_key;
+        }
+    }
+    return 0;
+}
+
+uint64_t CallTask::GetTenant() const {
+    for (const auto& callContext : _contexts) {
+        if (callContext->GetOptions().tenant != 0) {
+            return callContext->GetOptions().tenant;
         }
-        return;
     }
+    return 0;
+}
+
+void CallTask::Reject(napa::ResultCode code, const std::string& reason) {
+    for (const auto& callContext : _contexts) {
+        (void)callContext->Reject(code, reason);
+    }
+}
+
+void CallTask::Cancel() {
+    // Queued calls are finished right away, the worker skips them when the task is dispatched.
+    Reject(NAPA_RESULT_CANCELLED, "Cancelled by the caller");
+
+    std::lock_guard<std::mutex> lock(_runningLock);
+    if (_runningIsolate != nullptr) {
+        Terminate(TerminationReason::CANCELLED, _runningIsolate);
+    }
+}
 
-    NAPA_ASSERT(!tryCatch.HasCaught(), "__napa_zone_call__ should catch all user exceptions and reject task.");
+void CallTask::SetRunningIsolate(v8::Isolate* isolate) {
+    std::lock_guard<std::mutex> lock(_runningLock);
+    _runningIsolate = isolate;
 }
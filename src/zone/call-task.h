@@ -3,27 +3,71 @@
 
 #pragma once
 
+#include "block-pool.h"
 #include "call-context.h"
 #include "terminable-task.h"
 
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace napa {
 namespace zone {
 
+    /// <summary> Call contexts of a task, allocated from the zone's block pool. </summary>
+    using CallContexts = std::vector<std::shared_ptr<CallContext>, PoolAllocator<std::shared_ptr<CallContext>>>;
+
     /// <summary> A task for executing pre-loaded javascript functions. </summary>
     class CallTask : public TerminableTask {
     public:
         /// <summary> Constructor. </summary>
         /// <param name="context"> Call context. </param>
-        CallTask(std::shared_ptr<CallContext> context);
+        /// <param name="pool"> The block pool to allocate the context list from. </param>
+        CallTask(std::shared_ptr<CallContext> context, std::shared_ptr<BlockPool> pool);
+
+        /// <summary> Constructor for a chunk of calls that are executed one after another within a single task. </summary>
+        /// <param name="contexts"> Call contexts. </param>
+        CallTask(CallContexts contexts);
 
         /// <summary> Overrides Task.Execute to define execution logic. </summary>
         virtual void Execute() override;
 
+        /// <summary> The highest priority among the calls of this task. </summary>
+        virtual uint32_t GetPriority() const override;
+
+        /// <summary> The earliest deadline among the calls of this task. </summary>
+        virtual int64_t GetDeadline() const override;
+
+        /// <summary> The routing key of the first call of this task that has one. </summary>
+        virtual uint64_t GetRoutingKey() const override;
+
+        /// <summary> The tenant of the first call of this task that has one. </summary>
+        virtual uint64_t GetTenant() const override;
+
+        /// <summary> Rejects all calls of this task. </summary>
+        virtual void Reject(napa::ResultCode code, const std::string& reason) override;
+
+        /// <summary> Calls report their rejection to their callers. </summary>
+        virtual bool CanReject() const override { return true; }
+
+        /// <summary> Rejects all calls of this task as cancelled, and terminates the call that is running. </summary>
+        virtual void Cancel() override;
+
     private:
-        /// <summary> Call context. </summary>
-        std::shared_ptr<CallContext> _context;
+        /// <summary> Runs the calls one after another, returns early if the isolate was terminated. </summary>
+        void ExecuteCalls(v8::Isolate* isolate, v8::Local<v8::Context> context, v8::Local<v8::Function> executeFunction);
+
+        /// <summary> Sets the isolate the task runs on, nullptr when the task is not running. </summary>
+        void SetRunningIsolate(v8::Isolate* isolate);
+
+        /// <summary> Call contexts. </summary>
+        CallContexts _contexts;
+
+        /// <summary> Guards the running isolate, so cancellation never terminates the isolate after the task left it. </summary>
+        std::mutex _runningLock;
+
+        /// <summary> The isolate the task is running on. </summary>
+        v8::Isolate* _runningIsolate = nullptr;
     };
 }
 }
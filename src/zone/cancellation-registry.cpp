@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "cancellation-registry.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace napa::zone;
+
+/// <summary> The number of registered tasks that triggers the first sweep. </summary>
+static const size_t MIN_SWEEP_THRESHOLD = 64;
+
+CancellationRegistry::CancellationRegistry() : _taskCount(0), _sweepThreshold(MIN_SWEEP_THRESHOLD) {
+}
+
+void CancellationRegistry::Register(uint64_t token, const std::shared_ptr<Task>& task) {
+    if (token == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _tasks[token].emplace_back(task);
+    _taskCount++;
+
+    // Sweeping when the registry doubled keeps registration amortized constant time.
+    if (_taskCount >= _sweepThreshold) {
+        Sweep();
+        _sweepThreshold = std::max(MIN_SWEEP_THRESHOLD, _taskCount * 2);
+    }
+}
+
+size_t CancellationRegistry::Cancel(uint64_t token) {
+    std::vector<std::shared_ptr<Task>> tasks;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto iter = _tasks.find(token);
+        if (iter == _tasks.end()) {
+            return 0;
+        }
+
+        for (const auto& weakTask : iter->second) {
+            if (auto task = weakTask.lock()) {
+                tasks.emplace_back(std::move(task));
+            }
+        }
+        _taskCount -= iter->second.size();
+        _tasks.erase(iter);
+    }
+
+    // Cancelling completes the calls, which runs user callbacks, so it happens outside the lock.
+    for (const auto& task : tasks) {
+        task->Cancel();
+    }
+    return tasks.size();
+}
+
+size_t CancellationRegistry::GetTaskCount() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _taskCount;
+}
+
+void CancellationRegistry::Sweep() {
+    // Erasing moves entries of the table, so tokens left without tasks are erased after the pass.
+    std::vector<uint64_t> emptyTokens;
+    _taskCount = 0;
+    for (auto& entry : _tasks) {
+        auto& tasks = entry.second;
+        tasks.erase(
+            std::remove_if(tasks.begin(), tasks.end(), [](const std::weak_ptr<Task>& task) { return task.expired(); }),
+            tasks.end());
+
+        if (tasks.empty()) {
+            emptyTokens.push_back(entry.first);
+        }
+        _taskCount += tasks.size();
+    }
+
+    for (auto token : emptyTokens) {
+        _tasks.erase(token);
+    }
+}
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "task.h"
+
+#include <napa/stl/flat-hash-map.h>
+#include <napa/stl/small-vector.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Keeps track of the cancellable tasks of a zone by their cancellation token. </summary>
+    /// <remarks> Tasks are held weakly, completed tasks are swept away as new tasks are registered. </remarks>
+    class CancellationRegistry {
+    public:
+
+        /// <summary> Constructor. </summary>
+        CancellationRegistry();
+
+        /// <summary> Registers a task under a cancellation token. </summary>
+        /// <param name="token"> The cancellation token, 0 tokens are ignored. </param>
+        /// <param name="task"> The task to cancel with the token. </param>
+        void Register(uint64_t token, const std::shared_ptr<Task>& task);
+
+        /// <summary> Cancels all tasks that are alive and registered under a cancellation token. </summary>
+        /// <returns> The number of tasks that were cancelled. </returns>
+        size_t Cancel(uint64_t token);
+
+        /// <summary> Returns the number of registered tasks, including completed ones not swept yet. </summary>
+        size_t GetTaskCount() const;
+
+    private:
+
+        /// <summary> Removes completed tasks. </summary>
+        void Sweep();
+
+        /// <summary> Tokens are usually given to a single task, which is kept in place. </summary>
+        using TaskList = napa::stl::SmallVector<std::weak_ptr<Task>, 1, std::allocator<std::weak_ptr<Task>>>;
+
+        mutable std::mutex _lock;
+        napa::stl::FlatHashMap<
+            uint64_t,
+            TaskList,
+            std::hash<uint64_t>,
+            std::equal_to<uint64_t>,
+            std::allocator<std::pair<uint64_t, TaskList>>> _tasks;
+        size_t _taskCount;
+        size_t _sweepThreshold;
+    };
+}
+}
@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Outcome of a channel operation. </summary>
+    enum class ChannelStatus {
+        /// <summary> The item was sent or received. </summary>
+        SUCCESS,
+
+        /// <summary> The channel is closed, and for receives it's also drained. </summary>
+        CLOSED,
+
+        /// <summary> The channel stayed full or empty until the timeout. </summary>
+        TIMEOUT
+    };
+
+    /// <summary> A bounded multi-producer multi-consumer channel, waited for synchronously or asynchronously. </summary>
+    /// <remarks>
+    ///     Asynchronous waiters don't hold a thread, their continuations run on the thread that makes room or sends,
+    ///     and are served before synchronous waiters. Items are received in the order they are sent.
+    /// </remarks>
+    template <typename T>
+    class Channel {
+    public:
+
+        /// <summary> Called once an item was accepted by the channel, or with false when the channel is closed. </summary>
+        using SendContinuation = std::function<void(bool sent)>;
+
+        /// <summary> Called with a received item, or with false and an empty item when the channel is closed and drained. </summary>
+        using ReceiveContinuation = std::function<void(bool received, T item)>;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="capacity"> The number of items the channel holds before senders wait, at least 1. </param>
+        explicit Channel(size_t capacity) : _capacity(capacity < 1 ? 1 : capacity), _closed(false) {}
+
+        Channel(const Channel&) = delete;
+        Channel& operator=(const Channel&) = delete;
+
+        /// <summary> Sends an item, blocking the calling thread while the channel is full. </summary>
+        /// <param name="item"> The item to send, it is moved from only if it was sent. </param>
+        ChannelStatus Send(T& item) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _notFull.wait(lock, [this]() { return _closed || _items.size() < _capacity; });
+            return SendLocked(lock, item);
+        }
+
+        /// <summary> Sends an item, blocking the calling thread at most for the given timeout while the channel is full. </summary>
+        /// <param name="item"> The item to send, it is moved from only if it was sent. </param>
+        /// <param name="timeout"> The longest time to wait, zero to return right away. </param>
+        ChannelStatus SendFor(T& item, std::chrono::milliseconds timeout) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (!_notFull.wait_for(lock, timeout, [this]() { return _closed || _items.size() < _capacity; })) {
+                return ChannelStatus::TIMEOUT;
+            }
+            return SendLocked(lock, item);
+        }
+
+        /// <summary> Sends an item asynchronously. </summary>
+        /// <param name="item"> The item to send. </param>
+        /// <param name="continuation">
+        ///     Runs once the item is accepted, on the calling thread if there is room right away, or otherwise on
+        ///     the thread that makes room. It should only schedule work and return.
+        /// </param>
+        void SendAsync(T item, SendContinuation continuation) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (!_closed && _items.size() >= _capacity) {
+                _senders.emplace_back(std::move(item), std::move(continuation));
+                return;
+            }
+            auto status = SendLocked(lock, item);
+            if (lock.owns_lock()) {
+                lock.unlock();
+            }
+            continuation(status == ChannelStatus::SUCCESS);
+        }
+
+        /// <summary> Receives an item, blocking the calling thread while the channel is empty. </summary>
+        /// <param name="item"> Set to the received item on success. </param>
+        ChannelStatus Receive(T& item) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _notEmpty.wait(lock, [this]() { return _closed || !_items.empty(); });
+            return ReceiveLocked(lock, item);
+        }
+
+        /// <summary> Receives an item, blocking the calling thread at most for the given timeout while the channel is empty. </summary>
+        /// <param name="item"> Set to the received item on success. </param>
+        /// <param name="timeout"> The longest time to wait, zero to return right away. </param>
+        ChannelStatus ReceiveFor(T& item, std::chrono::milliseconds timeout) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (!_notEmpty.wait_for(lock, timeout, [this]() { return _closed || !_items.empty(); })) {
+                return ChannelStatus::TIMEOUT;
+            }
+            return ReceiveLocked(lock, item);
+        }
+
+        /// <summary> Receives an item asynchronously. </summary>
+        /// <param name="continuation">
+        ///     Runs with the item once there is one, on the calling thread if there is one right away, or otherwise
+        ///     on the thread that sends it. It should only schedule work and return.
+        /// </param>
+        void ReceiveAsync(ReceiveContinuation continuation) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (!_closed && _items.empty()) {
+                _receivers.emplace_back(std::move(continuation));
+                return;
+            }
+            T item;
+            auto status = ReceiveLocked(lock, item);
+            if (lock.owns_lock()) {
+                lock.unlock();
+            }
+            continuation(status == ChannelStatus::SUCCESS, std::move(item));
+        }
+
+        /// <summary> Closes the channel, sends fail from now on, and receives fail once the remaining items are received. </summary>
+        void Close() {
+            std::deque<ReceiveContinuation> receivers;
+            std::deque<std::pair<T, SendContinuation>> senders;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (_closed) {
+                    return;
+                }
+                _closed = true;
+                receivers.swap(_receivers);
+                senders.swap(_senders);
+            }
+            _notEmpty.notify_all();
+            _notFull.notify_all();
+
+            for (auto& receiver : receivers) {
+                receiver(false, T());
+            }
+            for (auto& sender : senders) {
+                sender.second(false);
+            }
+        }
+
+        /// <summary> Tells if the channel is closed. </summary>
+        bool IsClosed() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _closed;
+        }
+
+        /// <summary> Returns the number of items waiting to be received, including those of waiting senders. </summary>
+        size_t GetSize() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _items.size() + _senders.size();
+        }
+
+        /// <summary> Returns the capacity of the channel. </summary>
+        size_t GetCapacity() const {
+            return _capacity;
+        }
+
+    private:
+
+        /// <summary> Sends an item once there is room or the channel is closed, the lock may be released on return. </summary>
+        ChannelStatus SendLocked(std::unique_lock<std::mutex>& lock, T& item) {
+            if (_closed) {
+                return ChannelStatus::CLOSED;
+            }
+
+            // Receivers only wait on an empty channel, the item goes straight to the oldest of them.
+            if (!_receivers.empty()) {
+                auto receiver = std::move(_receivers.front());
+                _receivers.pop_front();
+                lock.unlock();
+
+                receiver(true, std::move(item));
+                return ChannelStatus::SUCCESS;
+            }
+
+            _items.emplace_back(std::move(item));
+            lock.unlock();
+            _notEmpty.notify_one();
+            return ChannelStatus::SUCCESS;
+        }
+
+        /// <summary> Receives an item once there is one or the channel is closed, the lock may be released on return. </summary>
+        ChannelStatus ReceiveLocked(std::unique_lock<std::mutex>& lock, T& item) {
+            if (_items.empty()) {
+                return ChannelStatus::CLOSED;
+            }
+            item = std::move(_items.front());
+            _items.pop_front();
+
+            // Senders only wait on a full channel, the room goes to the oldest of them.
+            if (!_senders.empty()) {
+                auto sender = std::move(_senders.front());
+                _senders.pop_front();
+                _items.emplace_back(std::move(sender.first));
+                lock.unlock();
+
+                sender.second(true);
+                return ChannelStatus::SUCCESS;
+            }
+
+            lock.unlock();
+            _notFull.notify_one();
+            return ChannelStatus::SUCCESS;
+        }
+
+        mutable std::mutex _mutex;
+        std::condition_variable _notEmpty;
+        std::condition_variable _notFull;
+        std::deque<T> _items;
+        std::deque<ReceiveContinuation> _receivers;
+        std::deque<std::pair<T, SendContinuation>> _senders;
+        const size_t _capacity;
+        bool _closed;
+    };
+}
+}
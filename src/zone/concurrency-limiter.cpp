@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "concurrency-limiter.h"
+
+#include <napa/providers/metric.h>
+
+#include <algorithm>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> The number of calls the lowest latency is taken over. </summary>
+    constexpr uint32_t LATENCY_WINDOW = 1000;
+
+    /// <summary> How many times the lowest latency a call may take before it lowers the limit. </summary>
+    constexpr int64_t LATENCY_TOLERANCE = 2;
+
+    /// <summary> The factor a slow or dropped call multiplies the limit by. </summary>
+    constexpr double BACKOFF_RATIO = 0.9;
+}
+
+ConcurrencyLimiter::ConcurrencyLimiter(std::string id, uint32_t minLimit, uint32_t maxLimit) :
+    _id(std::move(id)),
+    _minLimit(std::max(std::min(minLimit, maxLimit), 1u)),
+    _maxLimit(maxLimit),
+    _limit(_minLimit),
+    _inFlight(0),
+    _minLatency(std::chrono::nanoseconds::max()),
+    _windowMinLatency(std::chrono::nanoseconds::max()),
+    _windowCalls(0) {
+}
+
+bool ConcurrencyLimiter::IsEnabled() const {
+    return _maxLimit > 0;
+}
+
+bool ConcurrencyLimiter::TryAcquire() {
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_inFlight < static_cast<uint32_t>(_limit)) {
+            ++_inFlight;
+            return true;
+        }
+    }
+
+    static const char* dimensionNames[] = { "Zone" };
+    static auto limitedCallsMetric = providers::GetMetricProvider().GetMetric(
+        "Napa", "ConcurrencyLimitedCalls", providers::MetricType::Rate, 1, dimensionNames);
+    if (limitedCallsMetric != nullptr) {
+        const char* dimensionValues[] = { _id.c_str() };
+        limitedCallsMetric->Increment(1, 1, dimensionValues);
+    }
+    return false;
+}
+
+void ConcurrencyLimiter::Release(std::chrono::nanoseconds latency, bool dropped) {
+    Release(latency, dropped, Clock::now());
+}
+
+void ConcurrencyLimiter::Release(std::chrono::nanoseconds latency, bool dropped, Clock::time_point now) {
+    uint32_t previousLimit = 0;
+    uint32_t limit = 0;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        previousLimit = static_cast<uint32_t>(_limit);
+        auto inFlight = _inFlight;
+        if (_inFlight > 0) {
+            --_inFlight;
+        }
+
+        // The latency of a dropped call says when it gave up, not how long it would have taken.
+        if (dropped) {
+            Decrease(latency, now);
+        } else {
+            _minLatency = std::min(_minLatency, latency);
+            _windowMinLatency = std::min(_windowMinLatency, latency);
+            if (++_windowCalls == LATENCY_WINDOW) {
+                _minLatency = _windowMinLatency;
+                _windowMinLatency = std::chrono::nanoseconds::max();
+                _windowCalls = 0;
+            }
+
+            if (latency > _minLatency * LATENCY_TOLERANCE) {
+                Decrease(latency, now);
+            } else if (inFlight * 2 >= previousLimit) {
+                // Calls well under the limit say nothing about whether more would be fine.
+                _limit = std::min(_limit + 1 / _limit, _maxLimit);
+            }
+        }
+        limit = static_cast<uint32_t>(_limit);
+    }
+
+    if (limit != previousLimit) {
+        ReportLimit(limit);
+    }
+}
+
+uint32_t ConcurrencyLimiter::GetLimit() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return static_cast<uint32_t>(_limit);
+}
+
+uint32_t ConcurrencyLimiter::GetInFlightCount() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _inFlight;
+}
+
+void ConcurrencyLimiter::Decrease(std::chrono::nanoseconds latency, Clock::time_point now) {
+    // A call admitted before the last decrease was slowed down by the calls that caused it.
+    if (now - latency < _decreasedAt) {
+        return;
+    }
+    _limit = std::max(_limit * BACKOFF_RATIO, _minLimit);
+    _decreasedAt = now;
+}
+
+void ConcurrencyLimiter::ReportLimit(uint32_t limit) {
+    static const char* dimensionNames[] = { "Zone" };
+    static auto limitMetric = providers::GetMetricProvider().GetMetric(
+        "Napa", "ConcurrencyLimit", providers::MetricType::Number, 1, dimensionNames);
+    if (limitMetric != nullptr) {
+        const char* dimensionValues[] = { _id.c_str() };
+        limitMetric->Set(static_cast<int64_t>(limit), 1, dimensionValues);
+    }
+}
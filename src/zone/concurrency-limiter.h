@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> An adaptive limit of the calls a zone has in flight, from their admission until their result is delivered. </summary>
+    /// <remarks>
+    ///     The limit follows additive increase and multiplicative decrease on the latency of calls, which includes the
+    ///     time they were queued. A call that finishes within twice the lowest latency seen recently, while the zone
+    ///     uses at least half of its limit, raises the limit by one per round trip, i.e. by 1 / limit. A call slower than
+    ///     that, or one that timed out or was rejected as overloaded, lowers the limit by a tenth, at most once per round
+    ///     trip so the calls admitted before a decrease don't lower it again. The lowest latency is taken over windows of
+    ///     calls, so it rises again when calls get slower for good, e.g. after a deployment.
+    /// </remarks>
+    class ConcurrencyLimiter {
+    public:
+
+        using Clock = std::chrono::steady_clock;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="id"> The id of the zone, the dimension of its metrics. </param>
+        /// <param name="minLimit"> The lowest limit and the limit a zone starts with, at least 1. </param>
+        /// <param name="maxLimit"> The highest limit, 0 for no limit at all. </param>
+        ConcurrencyLimiter(std::string id, uint32_t minLimit, uint32_t maxLimit);
+
+        /// <summary> Non-copyable. </summary>
+        ConcurrencyLimiter(const ConcurrencyLimiter&) = delete;
+        ConcurrencyLimiter& operator=(const ConcurrencyLimiter&) = delete;
+
+        /// <summary> Returns true if calls are limited at all, other calls don't need to be admitted. </summary>
+        bool IsEnabled() const;
+
+        /// <summary> Admits a call if the calls in flight are under the limit. </summary>
+        /// <returns> False if the zone is at its limit and the call must be rejected. </returns>
+        bool TryAcquire();
+
+        /// <summary> Counts an admitted call out once its result is delivered, and adapts the limit to it. </summary>
+        /// <param name="latency"> The time from the admission of the call to its result. </param>
+        /// <param name="dropped"> Whether the call timed out or was rejected as overloaded. </param>
+        void Release(std::chrono::nanoseconds latency, bool dropped);
+
+        /// <summary> Counts an admitted call out at a given time, see Release. </summary>
+        void Release(std::chrono::nanoseconds latency, bool dropped, Clock::time_point now);
+
+        /// <summary> Returns the current limit. </summary>
+        uint32_t GetLimit() const;
+
+        /// <summary> Returns the number of admitted calls in flight. </summary>
+        uint32_t GetInFlightCount() const;
+
+    private:
+
+        /// <summary> Lowers the limit, unless the call was admitted before the last decrease. </summary>
+        void Decrease(std::chrono::nanoseconds latency, Clock::time_point now);
+
+        /// <summary> Sets the limit metric of the zone, once the limit changed. </summary>
+        void ReportLimit(uint32_t limit);
+
+        std::string _id;
+        double _minLimit;
+        double _maxLimit;
+
+        mutable std::mutex _lock;
+        double _limit;
+        uint32_t _inFlight;
+
+        /// <summary> The lowest latency of the last complete window, or of the first one until it completes. </summary>
+        std::chrono::nanoseconds _minLatency;
+
+        /// <summary> The lowest latency and the number of calls of the current window. </summary>
+        std::chrono::nanoseconds _windowMinLatency;
+        uint32_t _windowCalls;
+
+        Clock::time_point _decreasedAt;
+    };
+}
+}
@@ -0,0 +1,55 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "count-down-latch.h"
+
+using namespace napa::zone;
+
+CountDownLatch::CountDownLatch(uint32_t count) : _count(count) {
+}
+
+void CountDownLatch::CountDown(uint32_t count) {
+    std::deque<Continuation> continuations;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_count == 0) {
+            return;
+        }
+        _count = count < _count ? _count - count : 0;
+        if (_count > 0) {
+            return;
+        }
+        continuations.swap(_continuations);
+    }
+
+    _opened.notify_all();
+    for (auto& continuation : continuations) {
+        continuation();
+    }
+}
+
+void CountDownLatch::Wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _opened.wait(lock, [this]() { return _count == 0; });
+}
+
+bool CountDownLatch::WaitFor(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _opened.wait_for(lock, timeout, [this]() { return _count == 0; });
+}
+
+void CountDownLatch::WaitAsync(Continuation continuation) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_count > 0) {
+            _continuations.emplace_back(std::move(continuation));
+            return;
+        }
+    }
+    continuation();
+}
+
+uint32_t CountDownLatch::GetCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _count;
+}
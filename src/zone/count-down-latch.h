@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A single-use latch that opens once counted down to zero, waited for synchronously or asynchronously. </summary>
+    class CountDownLatch {
+    public:
+
+        /// <summary> Called once the latch is open. </summary>
+        using Continuation = std::function<void()>;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="count"> The number of count downs that open the latch. </param>
+        explicit CountDownLatch(uint32_t count);
+
+        CountDownLatch(const CountDownLatch&) = delete;
+        CountDownLatch& operator=(const CountDownLatch&) = delete;
+
+        /// <summary> Decrements the count, down to zero, and releases the waiters once the latch opens. </summary>
+        void CountDown(uint32_t count = 1);
+
+        /// <summary> Blocks the calling thread until the latch is open. </summary>
+        void Wait();
+
+        /// <summary> Blocks the calling thread at most for the given timeout until the latch is open. </summary>
+        /// <returns> True if the latch is open. </returns>
+        bool WaitFor(std::chrono::milliseconds timeout);
+
+        /// <summary> Waits for the latch asynchronously. </summary>
+        /// <param name="continuation">
+        ///     Runs once the latch is open, on the calling thread if it is already, or otherwise on the thread
+        ///     that opens it. It should only schedule work and return.
+        /// </param>
+        void WaitAsync(Continuation continuation);
+
+        /// <summary> Returns the number of count downs left before the latch opens. </summary>
+        uint32_t GetCount() const;
+
+    private:
+        mutable std::mutex _mutex;
+        std::condition_variable _opened;
+        std::deque<Continuation> _continuations;
+        uint32_t _count;
+    };
+}
+}
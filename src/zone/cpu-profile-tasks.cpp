@@ -0,0 +1,169 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+// See: https://groups.google.com/forum/#!topic/nodejs/onA0S01INtw
+#ifdef BUILDING_NODE_EXTENSION
+#include <node.h>
+#endif
+
+#include "cpu-profile-tasks.h"
+#include "worker-context.h"
+
+#include <napa/log.h>
+#include <napa/v8-helpers.h>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <v8.h>
+#include <v8-profiler.h>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> The title of the profile of a worker, a worker records one profile at a time. </summary>
+    constexpr const char* PROFILE_TITLE = "napa";
+
+    /// <summary> The CPU profiler of the worker, created when it starts profiling. </summary>
+    thread_local v8::CpuProfiler* _profiler = nullptr;
+
+    void WriteString(rapidjson::Writer<rapidjson::StringBuffer>& writer, v8::Local<v8::String> value) {
+        v8::String::Utf8Value utf8(value);
+        writer.String(*utf8 != nullptr ? *utf8 : "", static_cast<rapidjson::SizeType>(utf8.length()));
+    }
+
+    /// <summary> Writes the nodes of the call tree below a node, depth first. </summary>
+    void WriteNodes(rapidjson::Writer<rapidjson::StringBuffer>& writer, const v8::CpuProfileNode* node) {
+        writer.StartObject();
+        writer.Key("id");
+        writer.Uint(node->GetNodeId());
+
+        // Lines and columns of DevTools call frames are 0-based.
+        writer.Key("callFrame");
+        writer.StartObject();
+        writer.Key("functionName");
+        WriteString(writer, node->GetFunctionName());
+        writer.Key("scriptId");
+        writer.String(std::to_string(node->GetScriptId()).c_str());
+        writer.Key("url");
+        WriteString(writer, node->GetScriptResourceName());
+        writer.Key("lineNumber");
+        writer.Int(node->GetLineNumber() - 1);
+        writer.Key("columnNumber");
+        writer.Int(node->GetColumnNumber() - 1);
+        writer.EndObject();
+
+        writer.Key("hitCount");
+        writer.Uint(node->GetHitCount());
+
+        auto childrenCount = node->GetChildrenCount();
+        writer.Key("children");
+        writer.StartArray();
+        for (int i = 0; i < childrenCount; i++) {
+            writer.Uint(node->GetChild(i)->GetNodeId());
+        }
+        writer.EndArray();
+        writer.EndObject();
+
+        for (int i = 0; i < childrenCount; i++) {
+            WriteNodes(writer, node->GetChild(i));
+        }
+    }
+
+    /// <summary> Serializes a profile in the .cpuprofile format that Chrome DevTools loads. </summary>
+    std::string Serialize(const v8::CpuProfile* profile) {
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+
+        writer.StartObject();
+        writer.Key("nodes");
+        writer.StartArray();
+        WriteNodes(writer, profile->GetTopDownRoot());
+        writer.EndArray();
+
+        writer.Key("startTime");
+        writer.Int64(profile->GetStartTime());
+        writer.Key("endTime");
+        writer.Int64(profile->GetEndTime());
+
+        auto samplesCount = profile->GetSamplesCount();
+        writer.Key("samples");
+        writer.StartArray();
+        for (int i = 0; i < samplesCount; i++) {
+            writer.Uint(profile->GetSample(i)->GetNodeId());
+        }
+        writer.EndArray();
+
+        // Each sample is timed relative to the previous one, the first to the start of the profile.
+        writer.Key("timeDeltas");
+        writer.StartArray();
+        auto last = profile->GetStartTime();
+        for (int i = 0; i < samplesCount; i++) {
+            auto timestamp = profile->GetSampleTimestamp(i);
+            writer.Int64(timestamp - last);
+            last = timestamp;
+        }
+        writer.EndArray();
+        writer.EndObject();
+
+        return std::string(buffer.GetString(), buffer.GetSize());
+    }
+
+    uint32_t GetWorkerId() {
+        return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
+    }
+}
+
+StartCpuProfilingTask::StartCpuProfilingTask(uint32_t samplingInterval) : _samplingInterval(samplingInterval) {}
+
+void StartCpuProfilingTask::Execute() {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    if (_profiler != nullptr) {
+        NAPA_DEBUG("CpuProfiling", "Worker %u is already profiling", GetWorkerId());
+        return;
+    }
+
+    _profiler = v8::CpuProfiler::New(isolate);
+    if (_samplingInterval > 0) {
+        _profiler->SetSamplingInterval(static_cast<int>(_samplingInterval));
+    }
+    _profiler->StartProfiling(v8_helpers::MakeV8String(isolate, PROFILE_TITLE), true);
+
+    NAPA_DEBUG("CpuProfiling", "Worker %u started profiling", GetWorkerId());
+}
+
+StopCpuProfilingTask::StopCpuProfilingTask(std::function<void(CpuProfile)> callback) :
+    _callback(std::move(callback)) {}
+
+void StopCpuProfilingTask::Execute() {
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+
+    CpuProfile result;
+    result.workerId = GetWorkerId();
+
+    if (_profiler != nullptr) {
+        auto profile = _profiler->StopProfiling(v8_helpers::MakeV8String(isolate, PROFILE_TITLE));
+        if (profile != nullptr) {
+            result.profile = Serialize(profile);
+            profile->Delete();
+        }
+
+        _profiler->Dispose();
+        _profiler = nullptr;
+        NAPA_DEBUG("CpuProfiling", "Worker %u stopped profiling", result.workerId);
+    }
+
+    _callback(std::move(result));
+}
+
+void napa::zone::DisposeCpuProfiler() {
+    if (_profiler != nullptr) {
+        _profiler->Dispose();
+        _profiler = nullptr;
+    }
+}
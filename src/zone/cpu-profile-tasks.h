@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "task.h"
+
+#include <napa/types.h>
+
+#include <functional>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A task starting to sample the CPU profile of the isolate that runs it. </summary>
+    /// <remarks> A worker that is already profiling keeps its profile and sampling interval. </remarks>
+    class StartCpuProfilingTask : public Task {
+    public:
+        /// <summary> Constructor. </summary>
+        /// <param name="samplingInterval"> The sampling interval in microseconds, 0 for the V8 default. </param>
+        explicit StartCpuProfilingTask(uint32_t samplingInterval);
+
+        /// <summary> Overrides Task.Execute to start the CPU profiler. </summary>
+        virtual void Execute() override;
+
+        /// <summary> Overrides Task.Reject, a worker that doesn't run the task just isn't profiled. </summary>
+        virtual void Reject(napa::ResultCode /*code*/, const std::string& /*reason*/) override {}
+
+    private:
+        uint32_t _samplingInterval;
+    };
+
+    /// <summary> A task stopping the CPU profiler of the isolate that runs it. </summary>
+    class StopCpuProfilingTask : public Task {
+    public:
+        /// <summary> Constructor. </summary>
+        /// <param name="callback">
+        ///     A callback receiving the profile of the worker in the .cpuprofile format,
+        ///     or an empty profile if the worker wasn't profiling.
+        /// </param>
+        explicit StopCpuProfilingTask(std::function<void(CpuProfile)> callback);
+
+        /// <summary> Overrides Task.Execute to stop the CPU profiler and serialize the profile. </summary>
+        virtual void Execute() override;
+
+        /// <summary> Overrides Task.Reject to report an empty profile, like for a worker that wasn't profiling. </summary>
+        virtual void Reject(napa::ResultCode /*code*/, const std::string& /*reason*/) override { _callback(CpuProfile()); }
+
+    private:
+        std::function<void(CpuProfile)> _callback;
+    };
+
+    /// <summary> Discards the profile of the current worker, it must be called before its isolate is disposed. </summary>
+    void DisposeCpuProfiler();
+}
+}
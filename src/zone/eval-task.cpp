@@ -12,16 +12,51 @@
 
 #include <napa/log.h>
 #include <napa/v8-helpers.h>
+#include <v8-extensions/v8-extensions-macros.h>
 
 #include <v8.h>
 
 using namespace napa;
 using namespace napa::zone;
 
-EvalTask::EvalTask(std::string source, std::string sourceOrigin, BroadcastCallback callback) :
+EvalCodeCache::Data EvalCodeCache::Acquire() {
+    std::unique_lock<std::mutex> lock(_lock);
+    _completed.wait(lock, [this]() { return !_compiling; });
+    if (_data == nullptr && !_failed) {
+        _compiling = true;
+    }
+    return _data;
+}
+
+void EvalCodeCache::Complete(Data data) {
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _compiling = false;
+        if (data != nullptr) {
+            _data = std::move(data);
+        } else {
+            _failed = true;
+        }
+    }
+    _completed.notify_all();
+}
+
+void EvalCodeCache::Reject(const Data& data) {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_data == data) {
+        _data = nullptr;
+    }
+}
+
+EvalTask::EvalTask(std::string source, std::string sourceOrigin, BroadcastCallback callback, std::shared_ptr<EvalCodeCache> codeCache) :
     _source(std::move(source)),
     _sourceOrigin(std::move(sourceOrigin)),
-    _callback(std::move(callback)) {}
+    _callback(std::move(callback)),
+    _codeCache(std::move(codeCache)) {}
+
+void EvalTask::Reject(napa::ResultCode code, const std::string& reason) {
+    _callback({ code, reason, "", nullptr });
+}
 
 void EvalTask::Execute() {
     auto isolate = v8::Isolate::GetCurrent();
@@ -43,11 +78,59 @@ void EvalTask::Execute() {
     auto source = napa::v8_helpers::MakeV8String(isolate, _source);
     auto sourceOrigin = v8::ScriptOrigin(filename);
 
-    // Compile the source code.
+    // Compile the source code, from the code cache when another task compiled it already.
+    EvalCodeCache::Data cachedCode;
+    bool producer = false;
+    if (_codeCache != nullptr) {
+        cachedCode = _codeCache->Acquire();
+        producer = cachedCode == nullptr;
+    }
+
+    // The source owns the cached data object, not the buffer, which cachedCode keeps alive.
+    v8::ScriptCompiler::Source scriptSource(
+        source,
+        sourceOrigin,
+        cachedCode == nullptr ? nullptr : new v8::ScriptCompiler::CachedData(
+            reinterpret_cast<const uint8_t*>(cachedCode->data()), static_cast<int>(cachedCode->size())));
+
+    auto options = v8::ScriptCompiler::kNoCompileOptions;
+    if (cachedCode != nullptr) {
+        options = v8::ScriptCompiler::kConsumeCodeCache;
+    }
+#if !(V8_VERSION_CHECK_FOR_CREATE_CODE_CACHE)
+    else if (producer) {
+        options = v8::ScriptCompiler::kProduceCodeCache;
+    }
+#endif
+
     v8::MaybeLocal<v8::Script> compileResult;
     {
         v8::TryCatch tryCatch(isolate);
-        compileResult = v8::Script::Compile(context, source, &sourceOrigin);
+        compileResult = v8::ScriptCompiler::Compile(context, &scriptSource, options);
+
+        if (cachedCode != nullptr && scriptSource.GetCachedData()->rejected) {
+            // V8 rejects code from another V8 version or flags and compiles the source instead.
+            _codeCache->Reject(cachedCode);
+        } else if (producer) {
+            EvalCodeCache::Data producedCode;
+            if (!compileResult.IsEmpty()) {
+#if V8_VERSION_CHECK_FOR_CREATE_CODE_CACHE
+                std::unique_ptr<v8::ScriptCompiler::CachedData> ownedData(
+                    v8::ScriptCompiler::CreateCodeCache(compileResult.ToLocalChecked()->GetUnboundScript()));
+                auto producedData = ownedData.get();
+#else
+                auto producedData = scriptSource.GetCachedData();
+#endif
+                if (producedData != nullptr && producedData->length > 0) {
+                    producedCode = std::make_shared<const std::string>(
+                        reinterpret_cast<const char*>(producedData->data), producedData->length);
+                }
+            }
+
+            // Tasks waiting for the code go on, compiling the source themselves if none was produced.
+            _codeCache->Complete(std::move(producedCode));
+        }
+
         if (tryCatch.HasCaught()) {
             auto exception = tryCatch.Exception();
             v8::String::Utf8Value exceptionStr(exception);
@@ -7,12 +7,47 @@
 
 #include "napa/types.h"
 
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 
 namespace napa {
 namespace zone {
 
+    /// <summary> The code cache of a script run by many EvalTasks, e.g. on each worker of a zone. </summary>
+    /// <remarks>
+    ///     The first task compiles the script and produces the cache, tasks that start meanwhile wait for it
+    ///     instead of compiling the same script, then all of them consume it.
+    /// </remarks>
+    class EvalCodeCache {
+    public:
+
+        /// <summary> Compiled code produced by V8. </summary>
+        using Data = std::shared_ptr<const std::string>;
+
+        /// <summary> Returns the cached code, waiting for the task compiling it if there is one. </summary>
+        /// <returns> The cached code, nullptr if the caller compiles the script, in which case it must call Complete. </returns>
+        Data Acquire();
+
+        /// <summary> Completes the compilation started by a call to Acquire that returned nullptr. </summary>
+        /// <param name="data"> The produced code, nullptr if none was produced, e.g. if the script didn't compile. </param>
+        void Complete(Data data);
+
+        /// <summary> Drops the cached code after V8 rejected it, the next task compiles the script again. </summary>
+        void Reject(const Data& data);
+
+    private:
+        std::mutex _lock;
+        std::condition_variable _completed;
+        Data _data;
+        bool _compiling = false;
+
+        /// <summary> Once a compilation produced nothing, tasks compile the script without waiting for each other. </summary>
+        bool _failed = false;
+    };
+
     /// <summary> A task for evaluating javascript source code. </summary>
     class EvalTask : public Task {
     public:
@@ -20,17 +55,23 @@ namespace zone {
         /// <param name="source"> The JS source code to load on the isolate the runs this task. </param>
         /// <param name="sourceOrigin"> The origin of the source code. </param>
         /// <param name="callback"> A callback that is triggered when the task execution completed. </param>
+        /// <param name="codeCache"> The code cache shared by the tasks evaluating the same source, null for none. </param>
         EvalTask(std::string source,
             std::string sourceOrigin = "",
-            BroadcastCallback callback = [](Result) {});
+            BroadcastCallback callback = [](Result) {},
+            std::shared_ptr<EvalCodeCache> codeCache = nullptr);
 
         /// <summary> Overrides Task.Execute to define loading execution logic. </summary>
         virtual void Execute() override;
 
+        /// <summary> Overrides Task.Reject to report the code the broadcast was dropped with to its callback. </summary>
+        virtual void Reject(napa::ResultCode code, const std::string& reason) override;
+
     private:
         std::string _source;
         std::string _sourceOrigin;
         BroadcastCallback _callback;
+        std::shared_ptr<EvalCodeCache> _codeCache;
     };
 }
 }
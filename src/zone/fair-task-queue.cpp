@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "fair-task-queue.h"
+
+#include <algorithm>
+
+using namespace napa;
+using namespace napa::zone;
+
+FairTaskQueue::FairTaskQueue(const std::vector<settings::TenantWeight>& weights) : _sequence(0), _size(0) {
+    for (const auto& weight : weights) {
+        auto& tenant = _tenants[weight.tenant];
+        tenant.name = weight.name;
+        tenant.weight = std::max(weight.weight, 1u);
+    }
+}
+
+void FairTaskQueue::Push(std::shared_ptr<Task> task) {
+    auto key = task->GetTenant();
+    auto& tenant = _tenants[key];
+
+    // A tenant that had nothing waiting joins the round at its end.
+    if (tenant.tasks.empty()) {
+        tenant.deficit = 0;
+        tenant.turn = _round.insert(_round.end(), key);
+    }
+
+    auto priority = task->GetPriority();
+    auto deadline = task->GetDeadline();
+    tenant.tasks.push({ priority, deadline, _sequence++, std::move(task), std::chrono::steady_clock::now() });
+    _size++;
+}
+
+std::shared_ptr<Task> FairTaskQueue::Pop() {
+    if (_round.empty()) {
+        return nullptr;
+    }
+
+    auto key = _round.front();
+    auto& tenant = _tenants[key];
+
+    // Each turn starts with as many tasks as the tenant's weight, each task costs one.
+    if (tenant.deficit == 0) {
+        tenant.deficit = tenant.weight;
+    }
+    tenant.deficit--;
+
+    // The tenant keeps its turn until its share is spent or it has nothing left.
+    auto hasMore = tenant.tasks.size() > 1;
+    if (hasMore && tenant.deficit == 0) {
+        _round.splice(_round.end(), _round, tenant.turn);
+    }
+    return PopFrom(tenant, true);
+}
+
+std::shared_ptr<Task> FairTaskQueue::PopFromLongest() {
+    if (_round.empty()) {
+        return nullptr;
+    }
+
+    auto longest = std::max_element(_round.begin(), _round.end(), [this](uint64_t left, uint64_t right) {
+        return _tenants[left].tasks.size() < _tenants[right].tasks.size();
+    });
+    return PopFrom(_tenants[*longest], false);
+}
+
+bool FairTaskQueue::Empty() const {
+    return _size == 0;
+}
+
+size_t FairTaskQueue::Size() const {
+    return _size;
+}
+
+std::vector<TenantStats> FairTaskQueue::GetStats() const {
+    std::vector<TenantStats> stats;
+    for (const auto& entry : _tenants) {
+        const auto& tenant = entry.second;
+        if (tenant.tasks.empty() && tenant.dispatchedTasks == 0) {
+            continue;
+        }
+
+        TenantStats tenantStats;
+        tenantStats.tenant = entry.first;
+        tenantStats.name = tenant.name;
+        tenantStats.queuedTasks = tenant.tasks.size();
+        tenantStats.dispatchedTasks = tenant.dispatchedTasks;
+        tenantStats.waitTime = tenant.waitTime;
+        tenantStats.maxWaitTime = tenant.maxWaitTime;
+        stats.emplace_back(std::move(tenantStats));
+    }
+    return stats;
+}
+
+std::shared_ptr<Task> FairTaskQueue::PopFrom(Tenant& tenant, bool dispatched) {
+    auto task = tenant.tasks.top().task;
+    if (dispatched) {
+        auto waitTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - tenant.tasks.top().enqueueTime).count());
+        tenant.dispatchedTasks++;
+        tenant.waitTime += waitTime;
+        tenant.maxWaitTime = std::max(tenant.maxWaitTime, waitTime);
+    }
+    tenant.tasks.pop();
+    _size--;
+
+    if (tenant.tasks.empty()) {
+        _round.erase(tenant.turn);
+        tenant.deficit = 0;
+    }
+    return task;
+}
@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "task.h"
+
+#include <settings/settings.h>
+
+#include <napa/types.h>
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <queue>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A task waiting for an idle worker, ordered by priority, then deadline, then arrival. </summary>
+    struct NonScheduledTask {
+        uint32_t priority;
+        int64_t deadline;
+        uint64_t sequence;
+        std::shared_ptr<Task> task;
+
+        /// <summary> The time the task started waiting. </summary>
+        std::chrono::steady_clock::time_point enqueueTime = {};
+
+        /// <summary> Returns true if this task should be dispatched after the other one. </summary>
+        bool operator<(const NonScheduledTask& other) const {
+            if (priority != other.priority) {
+                return priority < other.priority;
+            }
+
+            // Tasks without a deadline go after tasks with one.
+            if (deadline != other.deadline) {
+                if (deadline == 0 || other.deadline == 0) {
+                    return deadline == 0;
+                }
+                return deadline > other.deadline;
+            }
+            return sequence > other.sequence;
+        }
+    };
+
+    /// <summary> Tasks waiting for an idle worker, with one queue per tenant served by deficit round robin. </summary>
+    /// <remarks>
+    ///     Each tenant with waiting tasks takes its turn and is dispatched as many tasks as its weight before the next
+    ///     tenant's turn, so a tenant flooding the zone only delays its own tasks. Within a tenant, tasks are ordered by
+    ///     priority, deadline and arrival, like a single queue when all tasks are of the default tenant.
+    ///     It is not thread-safe, the synchronized scheduler only touches it on its synchronizer thread.
+    /// </remarks>
+    class FairTaskQueue {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="weights"> The weights of the tenants, tenants without one have a weight of 1. </param>
+        explicit FairTaskQueue(const std::vector<settings::TenantWeight>& weights = {});
+
+        /// <summary> Non-copyable. </summary>
+        FairTaskQueue(const FairTaskQueue&) = delete;
+        FairTaskQueue& operator=(const FairTaskQueue&) = delete;
+
+        /// <summary> Puts a task into the queue of its tenant. </summary>
+        void Push(std::shared_ptr<Task> task);
+
+        /// <summary> Takes the next task to dispatch, the tenant whose turn it is gives its first task. </summary>
+        /// <returns> Null if the queue is empty. </returns>
+        std::shared_ptr<Task> Pop();
+
+        /// <summary> Takes the first task of the tenant with the most waiting tasks, to be dropped when the zone is overloaded. </summary>
+        /// <returns> Null if the queue is empty. </returns>
+        std::shared_ptr<Task> PopFromLongest();
+
+        /// <summary> Returns true if no task is waiting. </summary>
+        bool Empty() const;
+
+        /// <summary> Returns the number of waiting tasks of all tenants. </summary>
+        size_t Size() const;
+
+        /// <summary> Returns the statistics of the tenants whose tasks waited, ordered by tenant key. </summary>
+        std::vector<TenantStats> GetStats() const;
+
+    private:
+        struct Tenant {
+            std::string name;
+            uint32_t weight = 1;
+
+            /// <summary> The number of tasks the tenant may still be dispatched in its current turn. </summary>
+            uint32_t deficit = 0;
+
+            std::priority_queue<NonScheduledTask> tasks;
+
+            /// <summary> Where the tenant is in the round, valid while it has waiting tasks. </summary>
+            std::list<uint64_t>::iterator turn;
+
+            uint64_t dispatchedTasks = 0;
+            uint64_t waitTime = 0;
+            uint64_t maxWaitTime = 0;
+        };
+
+        /// <summary> Takes the first task of a tenant, and ends its turn if it has no more waiting tasks. </summary>
+        /// <param name="dispatched"> Whether the task is dispatched, which counts its wait, or dropped. </param>
+        std::shared_ptr<Task> PopFrom(Tenant& tenant, bool dispatched);
+
+        /// <summary> All tenants that had tasks waiting or have a weight. </summary>
+        std::map<uint64_t, Tenant> _tenants;
+
+        /// <summary> Tenants with waiting tasks in the order of their turns, the front tenant's turn is current. </summary>
+        std::list<uint64_t> _round;
+
+        /// <summary> Arrival counter for keeping FIFO order among equal tasks. </summary>
+        uint64_t _sequence;
+
+        /// <summary> The number of waiting tasks of all tenants. </summary>
+        size_t _size;
+    };
+}
+}
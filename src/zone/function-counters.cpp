@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "function-counters.h"
+
+#include <map>
+
+using namespace napa;
+using namespace napa::zone;
+
+FunctionCounterTable::FunctionCounterTable(uint32_t workerCount) {
+    _shards.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++) {
+        _shards.emplace_back(std::make_unique<Shard>());
+    }
+}
+
+void FunctionCounterTable::Add(
+    uint32_t workerId,
+    const std::string& module,
+    const std::string& function,
+    const platform::HardwareCounterSample& delta) {
+
+    if (workerId >= _shards.size()) {
+        return;
+    }
+
+    auto key = module.empty() ? function : module + "." + function;
+
+    auto& shard = *_shards[workerId];
+    std::lock_guard<std::mutex> lock(shard.lock);
+
+    auto& counters = shard.counters[key];
+    counters.calls++;
+    counters.cycles += delta.cycles;
+    counters.instructions += delta.instructions;
+    counters.cacheReferences += delta.cacheReferences;
+    counters.cacheMisses += delta.cacheMisses;
+}
+
+std::vector<FunctionCounters> FunctionCounterTable::GetCounters() const {
+    std::map<std::string, FunctionCounters> sums;
+    for (const auto& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard->lock);
+        for (const auto& entry : shard->counters) {
+            auto& sum = sums[entry.first];
+            sum.calls += entry.second.calls;
+            sum.cycles += entry.second.cycles;
+            sum.instructions += entry.second.instructions;
+            sum.cacheReferences += entry.second.cacheReferences;
+            sum.cacheMisses += entry.second.cacheMisses;
+        }
+    }
+
+    std::vector<FunctionCounters> result;
+    result.reserve(sums.size());
+    for (auto& entry : sums) {
+        entry.second.function = entry.first;
+        result.push_back(std::move(entry.second));
+    }
+    return result;
+}
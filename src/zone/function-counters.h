@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+#include <platform/hardware-counters.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Sums the hardware counters of the calls of a zone by function. </summary>
+    /// <remarks>
+    ///     Each worker adds to its own shard, so workers only contend with the readers of the stats,
+    ///     which sum the shards.
+    /// </remarks>
+    class FunctionCounterTable {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="workerCount"> The number of shards, one per worker. </param>
+        explicit FunctionCounterTable(uint32_t workerCount);
+
+        FunctionCounterTable(const FunctionCounterTable&) = delete;
+        FunctionCounterTable& operator=(const FunctionCounterTable&) = delete;
+
+        /// <summary> Adds the counters of a call. </summary>
+        /// <param name="workerId"> The worker which ran the call. </param>
+        /// <param name="module"> The module of the function, empty for functions of the global scope. </param>
+        /// <param name="function"> The function name. </param>
+        /// <param name="delta"> The counters the call took, i.e. the difference of the samples around it. </param>
+        void Add(
+            uint32_t workerId,
+            const std::string& module,
+            const std::string& function,
+            const platform::HardwareCounterSample& delta);
+
+        /// <summary> Returns the counters summed over the workers, ordered by function. </summary>
+        std::vector<FunctionCounters> GetCounters() const;
+
+    private:
+
+        /// <summary> The counters of a worker, aligned to a cache line so workers don't share one another's. </summary>
+        struct alignas(64) Shard {
+            mutable std::mutex lock;
+            std::unordered_map<std::string, FunctionCounters> counters;
+        };
+
+        std::vector<std::unique_ptr<Shard>> _shards;
+    };
+}
+}
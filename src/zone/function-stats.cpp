@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "function-stats.h"
+
+#include <napa/providers/metric.h>
+
+#include <algorithm>
+
+using namespace napa;
+using namespace napa::zone;
+
+FunctionStatsTable::Entry::Entry(const std::string& zoneId, const std::string& module, const std::string& function) :
+    _zoneId(zoneId),
+    _module(module),
+    _function(function),
+    _metricName(module.empty() ? function : module + "." + function),
+    _calls(0),
+    _errors(0),
+    _totalTime(0),
+    _maxTime(0) {
+
+    for (auto& bucket : _histogram) {
+        bucket = 0;
+    }
+}
+
+void FunctionStatsTable::Entry::Record(std::chrono::nanoseconds elapse, bool error) {
+    auto time = static_cast<uint64_t>(std::max<int64_t>(elapse.count(), 0));
+
+    _calls.fetch_add(1, std::memory_order_relaxed);
+    if (error) {
+        _errors.fetch_add(1, std::memory_order_relaxed);
+    }
+    _totalTime.fetch_add(time, std::memory_order_relaxed);
+    _histogram[GetBucketIndex(elapse)].fetch_add(1, std::memory_order_relaxed);
+
+    auto maxTime = _maxTime.load(std::memory_order_relaxed);
+    while (time > maxTime && !_maxTime.compare_exchange_weak(maxTime, time, std::memory_order_relaxed)) {}
+
+    static const char* dimensionNames[] = { "Zone", "Function" };
+    static auto callsMetric = providers::GetMetricProvider().GetMetric(
+        "Napa", "FunctionCalls", providers::MetricType::Rate, 2, dimensionNames);
+    static auto errorsMetric = providers::GetMetricProvider().GetMetric(
+        "Napa", "FunctionErrors", providers::MetricType::Rate, 2, dimensionNames);
+    static auto executionTimeMetric = providers::GetMetricProvider().GetMetric(
+        "Napa", "FunctionExecutionTime", providers::MetricType::Percentile, 2, dimensionNames);
+
+    const char* dimensionValues[] = { _zoneId.c_str(), _metricName.c_str() };
+    if (callsMetric != nullptr) {
+        callsMetric->Increment(1, 2, dimensionValues);
+    }
+    if (errorsMetric != nullptr && error) {
+        errorsMetric->Increment(1, 2, dimensionValues);
+    }
+    if (executionTimeMetric != nullptr) {
+        executionTimeMetric->Set(static_cast<int64_t>(time / 1000), 2, dimensionValues);
+    }
+}
+
+size_t FunctionStatsTable::Entry::GetBucketIndex(std::chrono::nanoseconds elapse) {
+    auto microseconds = elapse.count() > 0 ? static_cast<uint64_t>(elapse.count()) / 1000 : 0;
+
+    size_t index = 0;
+    while (microseconds > 0 && index < NAPA_FUNCTION_STATS_HISTOGRAM_BUCKETS - 1) {
+        microseconds >>= 1;
+        index++;
+    }
+    return index;
+}
+
+FunctionStatsTable::FunctionStatsTable(std::string zoneId, uint32_t workerCount) : _zoneId(std::move(zoneId)) {
+    _shards.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; i++) {
+        _shards.emplace_back(std::make_unique<Shard>());
+    }
+}
+
+FunctionStatsTable::Entry* FunctionStatsTable::GetEntry(
+    uint32_t workerId,
+    const std::string& module,
+    const std::string& function) {
+
+    if (workerId >= _shards.size()) {
+        return GetOrCreateEntry(module, function);
+    }
+
+    // Module names have no null character, so the key tells 'a.b' + 'c' from 'a' + 'b.c'.
+    std::string key;
+    key.reserve(module.size() + 1 + function.size());
+    key.append(module).push_back('\0');
+    key.append(function);
+
+    auto& shard = *_shards[workerId];
+    std::lock_guard<std::mutex> lock(shard.lock);
+
+    auto& entry = shard.entries[key];
+    if (entry == nullptr) {
+        entry = GetOrCreateEntry(module, function);
+    }
+    return entry;
+}
+
+FunctionStatsTable::Entry* FunctionStatsTable::GetOrCreateEntry(const std::string& module, const std::string& function) {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto& entry = _entries[std::make_pair(module, function)];
+    if (entry == nullptr) {
+        entry.reset(new Entry(_zoneId, module, function));
+    }
+    return entry.get();
+}
+
+std::vector<FunctionStats> FunctionStatsTable::GetStats() const {
+    std::lock_guard<std::mutex> lock(_lock);
+
+    std::vector<FunctionStats> result;
+    result.reserve(_entries.size());
+    for (const auto& pair : _entries) {
+        const auto& entry = *pair.second;
+
+        FunctionStats stats;
+        stats.module = entry._module;
+        stats.function = entry._function;
+        stats.calls = entry._calls.load(std::memory_order_relaxed);
+        stats.errors = entry._errors.load(std::memory_order_relaxed);
+        stats.totalTime = entry._totalTime.load(std::memory_order_relaxed);
+        stats.maxTime = entry._maxTime.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < NAPA_FUNCTION_STATS_HISTOGRAM_BUCKETS; i++) {
+            stats.histogram[i] = entry._histogram[i].load(std::memory_order_relaxed);
+        }
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Counts the calls of a zone by module and function, with their errors and execution times. </summary>
+    /// <remarks>
+    ///     Entries are created with the first call of a function and never removed, so workers keep a pointer to the
+    ///     entry of a call until it finishes, and record it with atomic operations only. Each worker caches the entries
+    ///     it found in a shard of its own, so looking up an entry only takes the table lock once per worker and function.
+    /// </remarks>
+    class FunctionStatsTable {
+    public:
+
+        /// <summary> The statistics of a function. </summary>
+        class Entry {
+        public:
+
+            /// <summary> Records a finished call, and reports it to the metric provider. </summary>
+            /// <param name="elapse"> The time from dispatch to result. </param>
+            /// <param name="error"> Whether the call was rejected. </param>
+            void Record(std::chrono::nanoseconds elapse, bool error);
+
+            /// <summary> Returns the histogram bucket of an execution time, see napa_zone_function_stats. </summary>
+            static size_t GetBucketIndex(std::chrono::nanoseconds elapse);
+
+        private:
+            friend class FunctionStatsTable;
+
+            Entry(const std::string& zoneId, const std::string& module, const std::string& function);
+
+            const std::string& _zoneId;
+            std::string _module;
+            std::string _function;
+
+            /// <summary> The function dimension of the metrics, like 'module.function'. </summary>
+            std::string _metricName;
+
+            std::atomic<uint64_t> _calls;
+            std::atomic<uint64_t> _errors;
+            std::atomic<uint64_t> _totalTime;
+            std::atomic<uint64_t> _maxTime;
+            std::array<std::atomic<uint64_t>, NAPA_FUNCTION_STATS_HISTOGRAM_BUCKETS> _histogram;
+        };
+
+        /// <summary> Constructor. </summary>
+        /// <param name="zoneId"> The zone, the zone dimension of the metrics. </param>
+        /// <param name="workerCount"> The number of shards, one per worker. </param>
+        FunctionStatsTable(std::string zoneId, uint32_t workerCount);
+
+        FunctionStatsTable(const FunctionStatsTable&) = delete;
+        FunctionStatsTable& operator=(const FunctionStatsTable&) = delete;
+
+        /// <summary> Gets the entry of a function, creating it with its first call. </summary>
+        /// <param name="workerId"> The worker looking up the entry, whose shard caches it. </param>
+        /// <param name="module"> The module of the function, empty for functions of the global scope. </param>
+        /// <param name="function"> The function name. </param>
+        /// <returns> The entry, which lives as long as the table. </returns>
+        Entry* GetEntry(uint32_t workerId, const std::string& module, const std::string& function);
+
+        /// <summary> Returns the statistics of each function called, ordered by module and function. </summary>
+        std::vector<FunctionStats> GetStats() const;
+
+    private:
+
+        /// <summary> The entries a worker looked up, aligned to a cache line so workers don't share one another's. </summary>
+        /// <remarks> Only its worker takes the lock, except while a recycled worker hands over to the next one. </remarks>
+        struct alignas(64) Shard {
+            std::mutex lock;
+            std::unordered_map<std::string, Entry*> entries;
+        };
+
+        /// <summary> Gets the entry of a function from the table, creating it if needed. </summary>
+        Entry* GetOrCreateEntry(const std::string& module, const std::string& function);
+
+        std::string _zoneId;
+        std::vector<std::unique_ptr<Shard>> _shards;
+
+        mutable std::mutex _lock;
+        std::map<std::pair<std::string, std::string>, std::unique_ptr<Entry>> _entries;
+    };
+}
+}
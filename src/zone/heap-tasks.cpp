@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+// See: https://groups.google.com/forum/#!topic/nodejs/onA0S01INtw
+#ifdef BUILDING_NODE_EXTENSION
+#include <node.h>
+#endif
+
+#include "heap-tasks.h"
+#include "worker-context.h"
+
+#include <napa/log.h>
+
+#include <v8.h>
+
+using namespace napa;
+using namespace napa::zone;
+
+HeapStatisticsTask::HeapStatisticsTask(std::function<void(const HeapStatistics&)> callback) :
+    _callback(std::move(callback)) {}
+
+void HeapStatisticsTask::Execute() {
+    v8::HeapStatistics heapStatistics;
+    v8::Isolate::GetCurrent()->GetHeapStatistics(&heapStatistics);
+
+    HeapStatistics statistics;
+    statistics.worker_id = static_cast<uint32_t>(
+        reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
+    statistics.total_heap_size = heapStatistics.total_heap_size();
+    statistics.total_heap_size_executable = heapStatistics.total_heap_size_executable();
+    statistics.total_physical_size = heapStatistics.total_physical_size();
+    statistics.total_available_size = heapStatistics.total_available_size();
+    statistics.used_heap_size = heapStatistics.used_heap_size();
+    statistics.heap_size_limit = heapStatistics.heap_size_limit();
+    statistics.malloced_memory = heapStatistics.malloced_memory();
+    statistics.peak_malloced_memory = heapStatistics.peak_malloced_memory();
+
+    _callback(statistics);
+}
+
+MemoryPressureTask::MemoryPressureTask(MemoryPressureLevel level) : _level(level) {}
+
+void MemoryPressureTask::Execute() {
+    NAPA_DEBUG("MemoryPressureTask", "Notify memory pressure level %d", static_cast<int>(_level));
+
+    // The levels of napa_memory_pressure_level follow v8::MemoryPressureLevel.
+    v8::Isolate::GetCurrent()->MemoryPressureNotification(static_cast<v8::MemoryPressureLevel>(_level));
+}
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "task.h"
+
+#include <napa/types.h>
+
+#include <functional>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A task reading the heap statistics of the isolate that runs it. </summary>
+    class HeapStatisticsTask : public Task {
+    public:
+        /// <summary> Constructor. </summary>
+        /// <param name="callback"> A callback receiving the statistics of the worker. </param>
+        explicit HeapStatisticsTask(std::function<void(const HeapStatistics&)> callback);
+
+        /// <summary> Overrides Task.Execute to read the heap statistics. </summary>
+        virtual void Execute() override;
+
+        /// <summary> Overrides Task.Reject to report empty statistics, so a collector waiting for each worker completes. </summary>
+        virtual void Reject(napa::ResultCode /*code*/, const std::string& /*reason*/) override { _callback(HeapStatistics()); }
+
+    private:
+        std::function<void(const HeapStatistics&)> _callback;
+    };
+
+    /// <summary> A task notifying the isolate that runs it of memory pressure. </summary>
+    class MemoryPressureTask : public Task {
+    public:
+        /// <summary> Constructor. </summary>
+        /// <param name="level"> The memory pressure level. </param>
+        explicit MemoryPressureTask(MemoryPressureLevel level);
+
+        /// <summary> Overrides Task.Execute to forward the memory pressure to V8. </summary>
+        virtual void Execute() override;
+
+        /// <summary> Overrides Task.Reject, the notification has no caller waiting for it. </summary>
+        virtual void Reject(napa::ResultCode /*code*/, const std::string& /*reason*/) override {}
+
+    private:
+        MemoryPressureLevel _level;
+    };
+}
+}
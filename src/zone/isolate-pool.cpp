@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "isolate-pool.h"
+#include "startup-snapshot.h"
+
+#include <napa/log.h>
+
+#include <v8-extensions/array-buffer-allocator.h>
+
+using namespace napa;
+using namespace napa::zone;
+
+IsolatePool& IsolatePool::GetInstance() {
+    static IsolatePool instance;
+    return instance;
+}
+
+IsolatePool::IsolatePool() : _size(0), _stopping(false) {}
+
+IsolatePool::~IsolatePool() {
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _stopping = true;
+    }
+    _refillEvent.notify_one();
+
+    if (_refillThread.joinable()) {
+        _refillThread.join();
+    }
+}
+
+void IsolatePool::SetSize(uint32_t size) {
+    auto stopping = (size == 0);
+
+    std::vector<v8::Isolate*> disposed;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _size = size;
+        _stopping = stopping;
+
+        if (stopping) {
+            disposed.swap(_isolates);
+        }
+    }
+    _refillEvent.notify_one();
+
+    if (stopping && _refillThread.joinable()) {
+        _refillThread.join();
+    } else if (!stopping && !_refillThread.joinable()) {
+        _refillThread = std::thread(&IsolatePool::RunRefill, this);
+    }
+
+    for (auto isolate : disposed) {
+        isolate->Dispose();
+    }
+    NAPA_DEBUG("IsolatePool", "Isolate pool size is set to %u.", size);
+}
+
+v8::Isolate* IsolatePool::Acquire(const settings::ZoneSettings& settings) {
+    if (IsPoolable(settings)) {
+        std::unique_lock<std::mutex> lock(_lock);
+        if (!_isolates.empty()) {
+            auto isolate = _isolates.back();
+            _isolates.pop_back();
+            lock.unlock();
+
+            _refillEvent.notify_one();
+            NAPA_DEBUG("IsolatePool", "Pooled isolate is acquired.");
+            return isolate;
+        }
+    }
+
+    return Create(settings);
+}
+
+v8::Isolate* IsolatePool::Create(const settings::ZoneSettings& settings) {
+    v8::Isolate::CreateParams createParams;
+
+    // All isolates allocate ArrayBuffer memory from the same pool.
+    static napa::v8_extensions::ArrayBufferAllocator commonAllocator;
+    createParams.array_buffer_allocator = &commonAllocator;
+
+    // Set the maximum V8 heap size.
+    createParams.constraints.set_max_old_space_size(settings.maxOldSpaceSize);
+    createParams.constraints.set_max_semi_space_size(settings.maxSemiSpaceSize);
+    createParams.constraints.set_max_executable_size(settings.maxExecutableSize);
+
+    // The default context created by the worker is deserialized from the snapshot, with the startup script already run.
+    auto snapshot = StartupSnapshot::Get(settings);
+    if (snapshot != nullptr) {
+        createParams.snapshot_blob = snapshot->GetStartupData();
+    }
+
+    return v8::Isolate::New(createParams);
+}
+
+bool IsolatePool::IsPoolable(const settings::ZoneSettings& settings) {
+    static const settings::ZoneSettings defaults;
+
+    return settings.maxOldSpaceSize == defaults.maxOldSpaceSize
+        && settings.maxSemiSpaceSize == defaults.maxSemiSpaceSize
+        && settings.maxExecutableSize == defaults.maxExecutableSize
+        && settings.startupScript.empty()
+        && settings.startupSnapshot.empty()
+        && settings.numaNode < 0
+        && settings.cpuSet.empty();
+}
+
+void IsolatePool::RunRefill() {
+    static const settings::ZoneSettings defaults;
+
+    std::unique_lock<std::mutex> lock(_lock);
+    while (true) {
+        _refillEvent.wait(lock, [this]() { return _stopping || _isolates.size() < _size; });
+        if (_stopping) {
+            return;
+        }
+
+        // Zones are created meanwhile, they create their isolates when the pool is empty.
+        lock.unlock();
+        auto isolate = Create(defaults);
+        lock.lock();
+
+        if (_stopping) {
+            // The pool was drained while the isolate was created.
+            lock.unlock();
+            isolate->Dispose();
+            return;
+        }
+        _isolates.push_back(isolate);
+    }
+}
@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <settings/settings.h>
+
+#include <v8.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary>
+    ///     Process wide pool of isolates created ahead of time by a background thread, so zone workers skip
+    ///     creating the heap of their isolate. A worker adopting a pooled isolate still sets up its context,
+    ///     module loader and core modules, since they are bound to the worker thread and its zone.
+    /// </summary>
+    /// <remarks>
+    ///     Isolates are pooled for the default heap constraints and no startup snapshot. Workers of zones with
+    ///     other isolate settings, or with a NUMA node or CPU set that their heap should be placed on, create
+    ///     their isolates as before.
+    /// </remarks>
+    class IsolatePool {
+    public:
+
+        /// <summary> Returns the pool zone workers take their isolates from. </summary>
+        static IsolatePool& GetInstance();
+
+        /// <summary> Stops refilling, isolates left in the pool are not disposed once V8 may be shut down. </summary>
+        ~IsolatePool();
+
+        /// <summary> Non-copyable. </summary>
+        IsolatePool(const IsolatePool&) = delete;
+        IsolatePool& operator=(const IsolatePool&) = delete;
+
+        /// <summary> Sets the number of isolates kept ready, refilling the pool in the background. </summary>
+        /// <param name="size"> The number of isolates, 0 to dispose the pooled isolates and stop refilling. </param>
+        void SetSize(uint32_t size);
+
+        /// <summary> Takes a pooled isolate if it fits the settings, or creates one. </summary>
+        /// <param name="settings"> The zone settings of the worker. </param>
+        /// <returns> An isolate that is not entered, owned by the caller. </returns>
+        v8::Isolate* Acquire(const settings::ZoneSettings& settings);
+
+        /// <summary> Creates an isolate with the heap constraints and the startup snapshot of a zone. </summary>
+        static v8::Isolate* Create(const settings::ZoneSettings& settings);
+
+    private:
+
+        /// <summary> Constructor. </summary>
+        IsolatePool();
+
+        /// <summary> Tell if pooled isolates fit the settings of a zone. </summary>
+        static bool IsPoolable(const settings::ZoneSettings& settings);
+
+        /// <summary> Creates isolates while the pool is short of its size. </summary>
+        void RunRefill();
+
+        std::mutex _lock;
+        std::condition_variable _refillEvent;
+        std::vector<v8::Isolate*> _isolates;
+        uint32_t _size;
+        bool _stopping;
+        std::thread _refillThread;
+    };
+}
+}
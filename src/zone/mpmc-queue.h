@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/log.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A bounded lock-free multi-producer multi-consumer queue. </summary>
+    /// <remarks>
+    ///     Based on Dmitry Vyukov's bounded MPMC queue: each cell carries a sequence number which tells
+    ///     producers and consumers whether the cell is ready to be written or read at a given position.
+    ///     Push and pop never block, they fail when the queue is full or empty respectively.
+    /// </remarks>
+    template <typename T>
+    class MpmcQueue {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="capacity"> The minimum capacity of the queue, rounded up to a power of 2. </param>
+        explicit MpmcQueue(size_t capacity) :
+            _capacity(RoundUpToPowerOfTwo(capacity)),
+            _mask(_capacity - 1),
+            _cells(std::make_unique<Cell[]>(_capacity)),
+            _enqueuePosition(0),
+            _dequeuePosition(0) {
+
+            for (size_t i = 0; i < _capacity; ++i) {
+                _cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpmcQueue(const MpmcQueue&) = delete;
+        MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+        /// <summary> Tries to push a value to the tail of the queue. </summary>
+        /// <param name="value"> The value to push, it is moved from only if the push succeeded. </param>
+        /// <returns> True if the value was pushed, false if the queue is full. </returns>
+        bool TryPush(T&& value) {
+            Cell* cell;
+            auto position = _enqueuePosition.load(std::memory_order_relaxed);
+            while (true) {
+                cell = &_cells[position & _mask];
+                auto sequence = cell->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if (diff == 0) {
+                    if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    position = _enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+
+            cell->value = std::move(value);
+            cell->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// <summary> Tries to pop a value from the head of the queue. </summary>
+        /// <param name="value"> Out parameter that receives the popped value. </param>
+        /// <returns> True if a value was popped, false if the queue is empty. </returns>
+        bool TryPop(T& value) {
+            Cell* cell;
+            auto position = _dequeuePosition.load(std::memory_order_relaxed);
+            while (true) {
+                cell = &_cells[position & _mask];
+                auto sequence = cell->sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+                if (diff == 0) {
+                    if (_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    position = _dequeuePosition.load(std::memory_order_relaxed);
+                }
+            }
+
+            value = std::move(cell->value);
+            cell->value = T();
+            cell->sequence.store(position + _mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// <summary> Returns true if there is no published value at the head of the queue. </summary>
+        /// <remarks> The answer may be stale by the time the caller uses it. </remarks>
+        bool Empty() const {
+            auto position = _dequeuePosition.load(std::memory_order_acquire);
+            auto sequence = _cells[position & _mask].sequence.load(std::memory_order_acquire);
+            return static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1) < 0;
+        }
+
+        /// <summary> Returns the capacity of the queue. </summary>
+        size_t Capacity() const {
+            return _capacity;
+        }
+
+    private:
+
+        static constexpr size_t CACHE_LINE_SIZE = 64;
+
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        static size_t RoundUpToPowerOfTwo(size_t value) {
+            NAPA_ASSERT(value > 0, "queue capacity must be greater than 0");
+
+            size_t result = 1;
+            while (result < value) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        const size_t _capacity;
+        const size_t _mask;
+        std::unique_ptr<Cell[]> _cells;
+
+        /// <summary> Producers and consumers positions live on separate cache lines to avoid false sharing. </summary>
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> _enqueuePosition;
+        alignas(CACHE_LINE_SIZE) std::atomic<size_t> _dequeuePosition;
+    };
+}
+}
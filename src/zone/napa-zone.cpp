@@ -3,19 +3,35 @@
 
 #include "napa-zone.h"
 
+#include <memory/arena-allocator.h>
+#include <module/loader/module-bundle.h>
 #include <module/loader/module-loader.h>
 #include <platform/dll.h>
 #include <platform/filesystem.h>
+#include <platform/hardware-counters.h>
 #include <utils/string.h>
+#include <zone/batch-results.h>
+#include <zone/cpu-profile-tasks.h>
 #include <zone/eval-task.h>
+#include <zone/heap-tasks.h>
+#include <zone/native-task.h>
+#include <zone/span-recorder.h>
 #include <zone/call-task.h>
 #include <zone/call-context.h>
 #include <zone/task-decorators.h>
+#include <zone/tenant-contexts.h>
 #include <zone/worker-context.h>
 
 #include <napa/log.h>
+#include <napa/memory.h>
+#include <napa/providers/metric.h>
 
+#include <rapidjson/document.h>
+
+#include <algorithm>
+#include <chrono>
 #include <future>
+#include <thread>
 
 using namespace napa;
 using namespace napa::zone;
@@ -28,6 +44,151 @@ std::unordered_map<std::string, std::weak_ptr<NapaZone>> NapaZone::_zones;
 static const std::string NAPAJS_MODULE_PATH = filesystem::Path(dll::ThisLineLocation()).Parent().Parent().Normalize().String();
 static const std::string BOOTSTRAP_SOURCE = "require('" + utils::string::ReplaceAllCopy(NAPAJS_MODULE_PATH, "\\", "\\\\") + "');";
 
+/// <summary> Quotes a string as a Javascript string literal. </summary>
+static std::string QuoteScriptString(const std::string& value) {
+    auto quoted = utils::string::ReplaceAllCopy(value, "\\", "\\\\");
+    utils::string::ReplaceAll(quoted, "'", "\\'");
+    return "'" + quoted + "'";
+}
+
+/// <summary>
+///     The script each worker runs on bootstrap, which loads 'napajs' and the preloaded modules,
+///     then runs the warm-up of the zone. Tenant contexts skip the warm-up.
+/// </summary>
+static std::string GetBootstrapSource(const settings::ZoneSettings& settings, bool warmup = true) {
+    auto source = BOOTSTRAP_SOURCE;
+    if (!settings.preload.empty()) {
+        source += "require(" + QuoteScriptString(NAPAJS_MODULE_PATH + "/lib/zone/preload") + ").run([";
+        for (size_t i = 0; i < settings.preload.size(); i++) {
+            source += (i == 0 ? "" : ", ") + QuoteScriptString(settings.preload[i]);
+        }
+        source += "]);";
+    }
+    if (warmup && !settings.warmupModule.empty()) {
+        source += "require(" + QuoteScriptString(NAPAJS_MODULE_PATH + "/lib/zone/warmup") + ").run("
+            + QuoteScriptString(settings.warmupModule) + ", "
+            + QuoteScriptString(settings.warmupFunction) + ", "
+            + QuoteScriptString(settings.warmupSamples) + ", "
+            + std::to_string(settings.warmupIterations) + ");";
+    }
+    return source;
+}
+
+/// <summary> The number of released blocks a zone keeps per size class for upcoming calls. </summary>
+static constexpr size_t TASK_POOL_MAX_FREE_BLOCKS = 1024;
+
+/// <summary> The task arena of a zone worker, its chunks are returned when the worker thread exits. </summary>
+static thread_local std::unique_ptr<napa::memory::ArenaAllocator> _taskArena;
+
+/// <summary> The number of frames captured from the stack of a slow call. </summary>
+static constexpr int SLOW_TASK_STACK_DEPTH = 16;
+
+/// <summary> A slow call reported to the isolate of its worker, there is one per worker. </summary>
+struct SlowTaskReport {
+    std::string zoneId;
+    uint32_t workerId;
+    SlowTaskDetector* detector;
+
+    /// <summary> The sequence of the reported call, 0 when no report is pending. </summary>
+    std::atomic<uint64_t> sequence;
+
+    /// <summary> How long the call had been running in milliseconds when it was reported. </summary>
+    std::atomic<int64_t> elapsed;
+};
+
+/// <summary> Formats a stack trace like formatStackTrace of lib/v8/stack-trace. </summary>
+static std::string FormatStackTrace(v8::Local<v8::StackTrace> stackTrace) {
+    std::string result;
+    for (int i = 0; i < stackTrace->GetFrameCount(); i++) {
+        auto frame = stackTrace->GetFrame(i);
+        v8::String::Utf8Value functionName(frame->GetFunctionName());
+        v8::String::Utf8Value scriptName(frame->GetScriptName());
+
+        result += "at ";
+        result += *functionName != nullptr ? *functionName : "";
+        result += "(";
+        result += *scriptName != nullptr ? *scriptName : "";
+        result += ":" + std::to_string(frame->GetLineNumber()) + ":" + std::to_string(frame->GetColumn()) + ")\n";
+    }
+    return result;
+}
+
+/// <summary> Interrupt callback that runs on the worker of a slow call, between two JavaScript statements. </summary>
+static void ReportSlowTask(v8::Isolate* isolate, void* data) {
+    auto report = static_cast<SlowTaskReport*>(data);
+
+    // The worker may run JavaScript again only after the reported call returned, its stack would be another one's.
+    auto sequence = report->sequence.exchange(0);
+    if (sequence == 0 || !report->detector->IsRunning(report->workerId, sequence)) {
+        return;
+    }
+
+    v8::HandleScope scope(isolate);
+    auto stack = FormatStackTrace(v8::StackTrace::CurrentStackTrace(isolate, SLOW_TASK_STACK_DEPTH));
+    LOG_WARNING("Zone", "Call on worker %u of zone \"%s\" has been running for %lld ms:\n%s",
+        report->workerId, report->zoneId.c_str(), static_cast<long long>(report->elapsed.load()), stack.c_str());
+
+    static const char* dimensionNames[] = { "Zone" };
+    static auto slowCallsMetric = providers::GetMetricProvider().GetMetric(
+        "Napa", "SlowCalls", providers::MetricType::Rate, 1, dimensionNames);
+    if (slowCallsMetric != nullptr) {
+        const char* dimensionValues[] = { report->zoneId.c_str() };
+        slowCallsMetric->Increment(1, 1, dimensionValues);
+    }
+}
+
+/// <summary> The allocator zone settings select. </summary>
+static napa::memory::Allocator& GetAllocator(settings::AllocatorType type) {
+    switch (type) {
+        case settings::AllocatorType::Crt:
+            return napa::memory::GetCrtAllocator();
+        case settings::AllocatorType::Pool:
+            return napa::memory::GetPoolAllocator();
+        default:
+            return napa::memory::GetDefaultAllocator();
+    }
+}
+
+/// <summary>
+///     The deadline and timeout a call runs with. A call made by a zone call running on the current thread is limited
+///     to what is left of the deadline of that call, unless it detaches from it.
+/// </summary>
+/// <param name="options"> The options of the call. </param>
+/// <param name="deadline"> Receives the deadline in milliseconds since epoch, 0 for none. </param>
+/// <param name="timeout"> Receives the timeout in milliseconds, 0 for none. </param>
+/// <returns> False if the deadline has already passed, the call would be rejected when dispatched. </returns>
+static bool GetEffectiveDeadline(const CallOptions& options, int64_t& deadline, uint32_t& timeout) {
+    deadline = options.deadline;
+    timeout = options.timeout;
+
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    auto caller = static_cast<CallContext*>(WorkerContext::Get(WorkerContextItem::CALL_CONTEXT));
+    if (caller != nullptr && options.detach_deadline == 0) {
+        auto callerDeadline = caller->GetDeadline();
+        if (callerDeadline > 0) {
+            if (deadline == 0 || callerDeadline < deadline) {
+                deadline = callerDeadline;
+            }
+            auto remaining = callerDeadline - now;
+            if (remaining > 0 && (timeout == 0 || remaining < timeout)) {
+                timeout = static_cast<uint32_t>(remaining);
+            }
+        }
+    }
+    return deadline == 0 || now < deadline;
+}
+
+/// <summary>
+///     The trace a call begins. A call made by a zone call running on the current thread continues the trace of
+///     that call, unless its options carry a trace.
+/// </summary>
+static TraceContext GetEffectiveTrace(const CallOptions& options) {
+    auto caller = static_cast<CallContext*>(WorkerContext::Get(WorkerContextItem::CALL_CONTEXT));
+    return SpanRecorder::GetInstance().StartCall(options, caller != nullptr ? &caller->GetTrace() : nullptr);
+}
+
 std::shared_ptr<NapaZone> NapaZone::Create(const settings::ZoneSettings& settings) {
     std::lock_guard<std::mutex> lock(_mutex);
 
@@ -73,7 +234,20 @@ std::shared_ptr<NapaZone> NapaZone::Get(const std::string& id) {
 }
 
 NapaZone::NapaZone(const settings::ZoneSettings& settings) : 
-    _settings(settings) {
+    _settings(settings),
+    _taskPool(std::make_shared<BlockPool>(TASK_POOL_MAX_FREE_BLOCKS)),
+    _resultCache(std::make_shared<ResultCache>(settings.id, static_cast<size_t>(settings.resultCacheSize) * 1024 * 1024)),
+    _coalescer(std::make_shared<CallCoalescer>()),
+    _rateLimiter(settings.rateLimit, settings.tenantRateLimits),
+    _concurrencyLimiter(std::make_shared<ConcurrencyLimiter>(settings.id, settings.workers, settings.maxConcurrency)),
+    _asyncWorkPool(std::make_unique<SimpleThreadPool>(settings.asyncWorkers)),
+    _recycled(false),
+    _callers(0) {
+
+    // Workers find the bundled modules in the process wide module caches.
+    if (!_settings.bundle.empty()) {
+        (void)module::ModuleBundle::Install(_settings.bundle);
+    }
 
     // Create the zone's scheduler.
     _scheduler = std::make_unique<Scheduler>(_settings, [this](WorkerId id) {
@@ -86,75 +260,650 @@ NapaZone::NapaZone(const settings::ZoneSettings& settings) :
         // Worker Id into TLS.
         WorkerContext::Set(WorkerContextItem::WORKER_ID, reinterpret_cast<void*>(static_cast<uintptr_t>(id)));
 
+        // Zone allocator and task arena into TLS.
+        auto& allocator = GetAllocator(_settings.allocator);
+        _taskArena = std::make_unique<napa::memory::ArenaAllocator>(allocator, _settings.taskArenaChunkSize);
+        WorkerContext::Set(WorkerContextItem::ALLOCATOR, &allocator);
+        WorkerContext::Set(WorkerContextItem::TASK_ARENA, _taskArena.get());
+
         // Load module loader and built-in modules of require, console and etc.
-        CREATE_MODULE_LOADER();
+        CREATE_MODULE_LOADER(_settings.sharedModuleContext, _settings.modulePrefetch);
+
+        // Contexts of tenants are created with their first call on the worker, and live as long as the worker.
+        if (_settings.tenantContexts > 0) {
+            WorkerContext::Set(
+                WorkerContextItem::TENANT_CONTEXTS,
+                new TenantContexts(
+                    _settings.tenantContexts, GetBootstrapSource(_settings, false), _settings.sharedModuleContext, _settings.modulePrefetch));
+        }
     });
 
-    // Bootstrap after zone is created.
+    // One deadline slot per worker the zone may run.
+    _timeoutWatchdog = std::make_shared<TimeoutWatchdog>(_scheduler->GetMaxWorkerCount(), [](TerminableTask* task, v8::Isolate* isolate) {
+        task->Terminate(TerminationReason::TIMEOUT, isolate);
+    });
+
+    // Slow calls are interrupted to capture their stack on their own worker. Interrupts still pending
+    // when the zone goes away are dropped with the isolates, before the detector and its reports.
+    if (_settings.slowTaskThreshold > 0) {
+        auto workerCount = _scheduler->GetMaxWorkerCount();
+        auto reports = std::shared_ptr<SlowTaskReport>(new SlowTaskReport[workerCount], std::default_delete<SlowTaskReport[]>());
+        _slowTaskDetector = std::make_unique<SlowTaskDetector>(
+            workerCount,
+            std::chrono::milliseconds(_settings.slowTaskThreshold),
+            [reports](uint32_t slot, uint64_t sequence, v8::Isolate* isolate, std::chrono::milliseconds elapsed) {
+                auto& report = reports.get()[slot];
+                report.elapsed = elapsed.count();
+                report.sequence = sequence;
+                isolate->RequestInterrupt(ReportSlowTask, &report);
+            });
+
+        for (uint32_t i = 0; i < workerCount; i++) {
+            auto& report = reports.get()[i];
+            report.zoneId = _settings.id;
+            report.workerId = i;
+            report.detector = _slowTaskDetector.get();
+            report.sequence = 0;
+            report.elapsed = 0;
+        }
+    }
+
+    _functionStats = std::make_shared<FunctionStatsTable>(_settings.id, _scheduler->GetMaxWorkerCount());
+
+    if (_settings.hardwareCounters) {
+        if (platform::AreHardwareCountersSupported()) {
+            _functionCounters = std::make_unique<FunctionCounterTable>(_scheduler->GetMaxWorkerCount());
+        } else {
+            LOG_WARNING("Zone", "Hardware counters can't be read, zone \"%s\" runs without them", _settings.id.c_str());
+        }
+    }
+
+    if (!_settings.warmupRecord.empty()) {
+        _warmupRecorder = std::make_unique<WarmupRecorder>(_settings.warmupRecord, _settings.warmupModule, _settings.warmupFunction);
+    }
+
+    // Bootstrap after zone is created. Workers warm up within the bootstrap script, before they take any other task.
+    auto bootstrapSource = GetBootstrapSource(_settings);
     std::promise<ResultCode> promise;
     auto future = promise.get_future();
 
     // Makes sure the callback is only called once, after all workers finished running the broadcast task.
-    auto counter = std::make_shared<std::atomic<uint32_t>>(_settings.workers);
-    auto callOnce = [&promise, counter](Result result) {
-        if (--(*counter) == 0) {
-            promise.set_value(result.code);
+    // Workers started later run the bootstrap script as well, without reporting back.
+    // The script is compiled by the first worker, the others consume its code cache.
+    auto counter = std::make_shared<std::atomic<uint32_t>>(0);
+    auto codeCache = std::make_shared<EvalCodeCache>();
+    _scheduler->ScheduleOnAllWorkers([&promise, counter, codeCache, bootstrapSource](uint32_t workerCount) -> std::shared_ptr<Task> {
+        if (workerCount == 0) {
+            return std::make_shared<EvalTask>(bootstrapSource, "", [](Result) {}, codeCache);
         }
-    };
 
-    auto bootstrapTask = std::make_shared<EvalTask>(BOOTSTRAP_SOURCE, "", std::move(callOnce));
-
-    _scheduler->ScheduleOnAllWorkers(std::move(bootstrapTask));
-    NAPA_DEBUG("Zone", "Scheduling bootstrap script \"%s\" to zone \"%s\"", BOOTSTRAP_SOURCE.c_str(), _settings.id.c_str());
+        counter->store(workerCount);
+        return std::make_shared<EvalTask>(bootstrapSource, "", [&promise, counter](Result result) {
+            if (--(*counter) == 0) {
+                promise.set_value(result.code);
+            }
+        }, codeCache);
+    });
+    NAPA_DEBUG("Zone", "Scheduling bootstrap script \"%s\" to zone \"%s\"", bootstrapSource.c_str(), _settings.id.c_str());
 
     NAPA_ASSERT(future.get() == NAPA_RESULT_SUCCESS, "Bootstrap Napa zone failed.");
 }
 
+NapaZone::~NapaZone() {
+    // Queued tasks run here, while the scheduler member is intact. Destroying it afterwards only releases it.
+    _scheduler->Shutdown();
+}
+
 const std::string& NapaZone::GetId() const {
     return _settings.id;
 }
 
-void NapaZone::Broadcast(const FunctionSpec& spec, BroadcastCallback callback) {
+size_t NapaZone::GetQueueLength() const {
+    Entry entry(*this);
+    return entry ? _scheduler->GetQueueLength() : 0;
+}
+
+uint32_t NapaZone::GetWorkerCount() const {
+    Entry entry(*this);
+    return entry ? _scheduler->GetWorkerCount() : 0;
+}
+
+void NapaZone::Cancel(uint64_t token) {
+    NAPA_DEBUG("Zone", "Cancel calls with token %llu on zone \"%s\"", static_cast<unsigned long long>(token), _settings.id.c_str());
+    _cancellations.Cancel(token);
+}
+
+void NapaZone::Broadcast(const FunctionSpec& spec, const std::vector<uint32_t>& workerIds, BroadcastCallback callback) {
+    Entry entry(*this);
+    if (!entry) {
+        callback({ NAPA_RESULT_ZONE_RECYCLED, "Zone was recycled", "", nullptr });
+        return;
+    }
+
+    // The spec only references the caller's memory, tasks are created later on the scheduling thread.
+    // All calls of the broadcast share one copy of it, however many workers run it.
+    auto sharedSpec = std::make_shared<SharedFunctionSpec>();
+    sharedSpec->module = NAPA_STRING_REF_TO_STD_STRING(spec.module);
+    sharedSpec->function = NAPA_STRING_REF_TO_STD_STRING(spec.function);
+    if (!spec.ownedArguments.empty()) {
+        sharedSpec->arguments = std::move(spec.ownedArguments);
+    } else {
+        sharedSpec->arguments.reserve(spec.arguments.size());
+        for (const auto& arg : spec.arguments) {
+            sharedSpec->arguments.emplace_back(NAPA_STRING_REF_TO_STD_STRING(arg));
+        }
+    }
+    std::shared_ptr<const SharedFunctionSpec> payload = std::move(sharedSpec);
+
+    // A source is evaluated rather than passed to the global eval, so it's compiled once for all workers.
+    std::shared_ptr<const std::string> evalSource;
+    std::shared_ptr<EvalCodeCache> codeCache;
+    if (payload->module.empty() && payload->function == "eval" && payload->arguments.size() == 1) {
+        rapidjson::Document document;
+        document.Parse(payload->arguments[0].c_str(), payload->arguments[0].size());
+        if (!document.HasParseError() && document.IsString()) {
+            evalSource = std::make_shared<const std::string>(document.GetString(), document.GetStringLength());
+            codeCache = std::make_shared<EvalCodeCache>();
+        }
+    }
+
+    // The transport context goes to the first call, as it did when broadcasting to each worker.
+    auto transportContext = std::make_shared<std::unique_ptr<transport::TransportContext>>(std::move(spec.transportContext));
+
     // Makes sure the callback is only called once, after all workers finished running the broadcast task.
-    auto counter = std::make_shared<std::atomic<uint32_t>>(_settings.workers);
-    auto callOnce = [this, callback = std::move(callback), counter](Result result) {
+    auto counter = std::make_shared<std::atomic<uint32_t>>(0);
+    auto callOnce = std::make_shared<ExecuteCallback>([callback = std::move(callback), counter](Result result) {
         if (--(*counter) == 0) {
             callback(std::move(result));
         }
-    };
+    });
+    auto created = std::make_shared<uint32_t>(0);
+
+    // Workers started later replay the broadcast without reporting back.
+    auto options = spec.options;
+
+    // The call on each worker is a span of the trace of the broadcast.
+    auto trace = GetEffectiveTrace(spec.options);
+    auto zoneId = _settings.id;
+
+    // The factory may outlive the zone, so it holds the pool and the watchdog rather than the zone.
+    auto pool = _taskPool;
+    auto watchdog = _timeoutWatchdog;
+    auto gracePeriod = std::chrono::milliseconds(_settings.timeoutGracePeriod);
+    auto createTask = [=](uint32_t workerCount) -> std::shared_ptr<Task> {
+        ExecuteCallback onResult = [](Result) {};
+        if (workerCount > 0) {
+            counter->store(workerCount);
+            onResult = *callOnce;
+
+            // The factory may be kept for replaying, it must not keep the caller's callback alive.
+            if (++(*created) == workerCount) {
+                *callOnce = nullptr;
+            }
+        } else if (*callOnce != nullptr && *created == 0) {
+            // None of the targeted workers is running, the broadcast is done already.
+            counter->store(1);
+            (*callOnce)({ NAPA_RESULT_SUCCESS, "", "", nullptr });
+            *callOnce = nullptr;
+            return nullptr;
+        }
 
-    for (WorkerId id = 0; id < _settings.workers; id++) {
-        std::shared_ptr<Task> task;
+        if (evalSource != nullptr) {
+            return std::make_shared<EvalTask>(*evalSource, "", std::move(onResult), codeCache);
+        }
 
-        if (spec.options.timeout > 0) {
-            task = std::make_shared<TimeoutTaskDecorator<CallTask>>(
-                std::chrono::milliseconds(spec.options.timeout),
-                std::make_shared<CallContext>(spec, callOnce));
-        } else {
-            task = std::make_shared<CallTask>(std::make_shared<CallContext>(spec, callOnce));
+        auto context = AllocateShared<CallContext>(pool, payload, options, std::move(*transportContext), std::move(onResult));
+        auto workerTrace = trace;
+        workerTrace.spanId = SpanRecorder::NewId();
+        context->SetTrace(workerTrace, zoneId);
+        if (options.timeout > 0) {
+            return AllocateShared<TimeoutTaskDecorator<CallTask>>(
+                pool, watchdog, std::chrono::milliseconds(options.timeout), gracePeriod, std::move(context), pool);
         }
+        return AllocateShared<CallTask>(pool, std::move(context), pool);
+    };
 
-        _scheduler->ScheduleOnWorker(id, std::move(task));
+    if (workerIds.empty()) {
+        _scheduler->ScheduleOnAllWorkers(std::move(createTask));
+        NAPA_DEBUG("Zone", "Broadcast function \"%s.%s\" on zone \"%s\"", spec.module.data, spec.function.data, _settings.id.c_str());
+        return;
+    }
+
+    // Workers of elastic zones have ids up to the maximum number of workers.
+    auto maxWorkers = _scheduler->GetMaxWorkerCount();
+    for (auto workerId : workerIds) {
+        if (workerId >= maxWorkers) {
+            LOG_WARNING("Zone", "Zone \"%s\" has no worker %u to broadcast to.", _settings.id.c_str(), workerId);
+        }
     }
 
-    NAPA_DEBUG("Zone", "Broadcast function \"%s.%s\" on zone \"%s\"", spec.module.data, spec.function.data, _settings.id.c_str());
+    _scheduler->ScheduleOnWorkers(workerIds, std::move(createTask));
+    NAPA_DEBUG("Zone", "Broadcast function \"%s.%s\" on %zu workers of zone \"%s\"",
+        spec.module.data, spec.function.data, workerIds.size(), _settings.id.c_str());
 }
 
 void NapaZone::Execute(const FunctionSpec& spec, ExecuteCallback callback) {
-    std::shared_ptr<Task> task;
+    Entry entry(*this);
+    if (!entry) {
+        callback({ NAPA_RESULT_ZONE_RECYCLED, "Zone was recycled", "", std::make_unique<napa::transport::TransportContext>() });
+        return;
+    }
 
-    if (spec.options.timeout > 0) {
-        task = std::make_shared<TimeoutTaskDecorator<CallTask>>(
-            std::chrono::milliseconds(spec.options.timeout),
-            std::make_shared<CallContext>(spec, std::move(callback)));
-    } else {
-        task = std::make_shared<CallTask>(std::make_shared<CallContext>(spec, std::move(callback)));
+    if (_warmupRecorder != nullptr) {
+        _warmupRecorder->Record(spec);
     }
-    
+
+    // Marshalled arguments referring to transported handles don't identify the call, such calls are not cached.
+    auto cacheable = spec.options.cache_ttl > 0
+        && _settings.resultCacheSize > 0
+        && (spec.transportContext == nullptr || spec.transportContext->GetSharedCount() == 0);
+    std::string key;
+    if (cacheable || spec.options.coalesce != 0) {
+        key = ResultCache::MakeKey(spec);
+    }
+
+    if (cacheable) {
+        std::string value;
+        if (_resultCache->Get(key, value)) {
+            NAPA_DEBUG("Zone", "Function \"%s.%s\" on zone \"%s\" returns a cached result", spec.module.data, spec.function.data, _settings.id.c_str());
+            callback({ NAPA_RESULT_SUCCESS, "", std::move(value), std::make_unique<napa::transport::TransportContext>() });
+            return;
+        }
+    }
+
+    // Cached results are served over the rate limits, only calls that would take a worker are limited.
+    if (!AcquireRateLimit(spec.options)) {
+        NAPA_DEBUG("Zone", "Function \"%s.%s\" on zone \"%s\" is over the rate limit", spec.module.data, spec.function.data, _settings.id.c_str());
+        callback({ NAPA_RESULT_RATE_LIMITED, "Rate limit exceeded", "", std::make_unique<napa::transport::TransportContext>() });
+        return;
+    }
+
+    // A call that can't start before its deadline is rejected without being queued.
+    int64_t deadline = 0;
+    uint32_t timeout = 0;
+    if (!GetEffectiveDeadline(spec.options, deadline, timeout)) {
+        NAPA_DEBUG("Zone", "Function \"%s.%s\" on zone \"%s\" is past its deadline", spec.module.data, spec.function.data, _settings.id.c_str());
+        callback({ NAPA_RESULT_TIMEOUT, "Deadline exceeded before execution", "", std::make_unique<napa::transport::TransportContext>() });
+        return;
+    }
+
+    // An identical call in flight delivers its result to this call as well.
+    if (spec.options.coalesce != 0) {
+        if (!_coalescer->Join(key, std::move(callback))) {
+            NAPA_DEBUG("Zone", "Function \"%s.%s\" on zone \"%s\" joins a call in flight", spec.module.data, spec.function.data, _settings.id.c_str());
+            return;
+        }
+        callback = [coalescer = _coalescer, key](Result result) {
+            coalescer->Complete(key, std::move(result));
+        };
+    }
+
+    // Calls joining a call in flight don't take a slot, the limit follows the latency of the calls that do.
+    if (_concurrencyLimiter->IsEnabled()) {
+        if (!_concurrencyLimiter->TryAcquire()) {
+            NAPA_DEBUG("Zone", "Function \"%s.%s\" on zone \"%s\" is over the concurrency limit", spec.module.data, spec.function.data, _settings.id.c_str());
+            callback({ NAPA_RESULT_ZONE_OVERLOADED, "Concurrency limit reached", "", std::make_unique<napa::transport::TransportContext>() });
+            return;
+        }
+        callback = [limiter = _concurrencyLimiter, admittedAt = ConcurrencyLimiter::Clock::now(), callback = std::move(callback)](Result result) {
+            auto now = ConcurrencyLimiter::Clock::now();
+            auto dropped = result.code == NAPA_RESULT_TIMEOUT || result.code == NAPA_RESULT_ZONE_OVERLOADED;
+            limiter->Release(now - admittedAt, dropped, now);
+            callback(std::move(result));
+        };
+    }
+
+    if (cacheable) {
+        // Results returning transported handles are only valid once, they are not cached either.
+        auto ttl = std::chrono::milliseconds(spec.options.cache_ttl);
+        callback = [cache = _resultCache, key = std::move(key), ttl, callback = std::move(callback)](Result result) {
+            if (result.code == NAPA_RESULT_SUCCESS
+                && (result.transportContext == nullptr || result.transportContext->GetSharedCount() == 0)) {
+                cache->Put(key, result.returnValue, ttl);
+            }
+            callback(std::move(result));
+        };
+    }
+
+    auto task = CreateCallTask(spec, std::move(callback), deadline, timeout);
+
     NAPA_DEBUG("Zone", "Execute function \"%s.%s\" on zone \"%s\"", spec.module.data, spec.function.data, _settings.id.c_str());
+    _cancellations.Register(spec.options.cancellation_token, task);
     _scheduler->Schedule(std::move(task));
 }
 
+void NapaZone::ExecuteOnWorker(uint32_t workerId, const FunctionSpec& spec, ExecuteCallback callback) {
+    Entry entry(*this);
+    if (!entry) {
+        callback({ NAPA_RESULT_ZONE_RECYCLED, "Zone was recycled", "", std::make_unique<napa::transport::TransportContext>() });
+        return;
+    }
+
+    // Workers of elastic zones have ids up to the maximum number of workers.
+    if (workerId >= _scheduler->GetMaxWorkerCount()) {
+        NAPA_DEBUG("Zone", "Zone \"%s\" has no worker %u to execute on", _settings.id.c_str(), workerId);
+        callback({ NAPA_RESULT_WORKER_NOT_RUNNING, "Worker is not running", "", std::make_unique<napa::transport::TransportContext>() });
+        return;
+    }
+
+    if (!AcquireRateLimit(spec.options)) {
+        callback({ NAPA_RESULT_RATE_LIMITED, "Rate limit exceeded", "", std::make_unique<napa::transport::TransportContext>() });
+        return;
+    }
+
+    // Calls on a worker are for its own state, they are neither cached nor coalesced.
+    int64_t deadline = 0;
+    uint32_t timeout = 0;
+    if (!GetEffectiveDeadline(spec.options, deadline, timeout)) {
+        callback({ NAPA_RESULT_TIMEOUT, "Deadline exceeded before execution", "", std::make_unique<napa::transport::TransportContext>() });
+        return;
+    }
+
+    auto task = CreateCallTask(spec, std::move(callback), deadline, timeout);
+
+    NAPA_DEBUG("Zone", "Execute function \"%s.%s\" on worker %u of zone \"%s\"", spec.module.data, spec.function.data, workerId, _settings.id.c_str());
+    _cancellations.Register(spec.options.cancellation_token, task);
+    _scheduler->ScheduleOnWorker(workerId, std::move(task));
+}
+
+std::shared_ptr<Task> NapaZone::CreateCallTask(
+    const FunctionSpec& spec,
+    ExecuteCallback callback,
+    int64_t deadline,
+    uint32_t timeout) {
+    // The task, its context and their control blocks are recycled through the zone's pool.
+    auto context = AllocateShared<CallContext>(_taskPool, spec, std::move(callback));
+    context->InheritDeadline(deadline);
+    context->SetTrace(GetEffectiveTrace(spec.options), _settings.id);
+    if (timeout > 0) {
+        return AllocateShared<TimeoutTaskDecorator<CallTask>>(
+            _taskPool,
+            _timeoutWatchdog,
+            std::chrono::milliseconds(timeout),
+            std::chrono::milliseconds(_settings.timeoutGracePeriod),
+            std::move(context),
+            _taskPool);
+    }
+    return AllocateShared<CallTask>(_taskPool, std::move(context), _taskPool);
+}
+
+bool NapaZone::AcquireRateLimit(const CallOptions& options) {
+    if (!_rateLimiter.IsEnabled() || _rateLimiter.TryAcquire(options.tenant)) {
+        return true;
+    }
+
+    static const char* dimensionNames[] = { "Zone" };
+    static auto rateLimitedCallsMetric = providers::GetMetricProvider().GetMetric(
+        "Napa", "RateLimitedCalls", providers::MetricType::Rate, 1, dimensionNames);
+    if (rateLimitedCallsMetric != nullptr) {
+        const char* dimensionValues[] = { _settings.id.c_str() };
+        rateLimitedCallsMetric->Increment(1, 1, dimensionValues);
+    }
+    return false;
+}
+
+void NapaZone::ExecuteBatch(const std::vector<FunctionSpec>& specs, ExecuteBatchCallback callback) {
+    if (specs.empty()) {
+        callback({});
+        return;
+    }
+
+    auto results = BatchResults::Create(specs.size(), std::move(callback));
+
+    Entry entry(*this);
+    if (!entry) {
+        for (size_t i = 0; i < specs.size(); i++) {
+            results->CallbackAt(i)({ NAPA_RESULT_ZONE_RECYCLED, "Zone was recycled", "", std::make_unique<napa::transport::TransportContext>() });
+        }
+        return;
+    }
+
+    // Each call of the batch counts against the rate limits, calls over them are rejected alone.
+    std::vector<size_t> admitted;
+    admitted.reserve(specs.size());
+    for (size_t i = 0; i < specs.size(); i++) {
+        if (AcquireRateLimit(specs[i].options)) {
+            admitted.push_back(i);
+        } else {
+            results->CallbackAt(i)({ NAPA_RESULT_RATE_LIMITED, "Rate limit exceeded", "", std::make_unique<napa::transport::TransportContext>() });
+        }
+    }
+    if (admitted.empty()) {
+        return;
+    }
+
+    // A task runs in the context of a single tenant, so calls of a tenant are chunked together.
+    auto tenantOf = [&specs](size_t index) { return specs[index].options.tenant; };
+    if (_settings.tenantContexts > 0) {
+        std::stable_sort(admitted.begin(), admitted.end(), [&tenantOf](size_t left, size_t right) {
+            return tenantOf(left) < tenantOf(right);
+        });
+    }
+
+    // Split the batch into one chunk per worker, each chunk runs as a single task.
+    auto chunkCount = std::min(admitted.size(), static_cast<size_t>(std::max(_scheduler->GetWorkerCount(), 1u)));
+    auto chunkSize = (admitted.size() + chunkCount - 1) / chunkCount;
+
+    for (size_t begin = 0, end = 0; begin < admitted.size(); begin = end) {
+        end = std::min(begin + chunkSize, admitted.size());
+        if (_settings.tenantContexts > 0) {
+            end = static_cast<size_t>(std::find_if(admitted.begin() + begin, admitted.begin() + end, [&](size_t index) {
+                return tenantOf(index) != tenantOf(admitted[begin]);
+            }) - admitted.begin());
+        }
+        const auto& first = specs[admitted[begin]];
+
+        CallContexts contexts{ PoolAllocator<std::shared_ptr<CallContext>>(_taskPool) };
+        contexts.reserve(end - begin);
+
+        // Calls past their deadline are rejected when the chunk is dispatched.
+        int64_t deadline = 0;
+        uint32_t timeout = 0;
+        for (auto i = begin; i < end; i++) {
+            auto index = admitted[i];
+            contexts.emplace_back(AllocateShared<CallContext>(_taskPool, specs[index], results->CallbackAt(index)));
+            (void)GetEffectiveDeadline(specs[index].options, deadline, timeout);
+            contexts.back()->InheritDeadline(deadline);
+            contexts.back()->SetTrace(GetEffectiveTrace(specs[index].options), _settings.id);
+        }
+
+        // The timeout of the first call in a chunk applies to the whole chunk.
+        std::shared_ptr<Task> task;
+        (void)GetEffectiveDeadline(first.options, deadline, timeout);
+        if (timeout > 0) {
+            task = AllocateShared<TimeoutTaskDecorator<CallTask>>(
+                _taskPool,
+                _timeoutWatchdog,
+                std::chrono::milliseconds(timeout),
+                std::chrono::milliseconds(_settings.timeoutGracePeriod),
+                std::move(contexts));
+        } else {
+            task = AllocateShared<CallTask>(_taskPool, std::move(contexts));
+        }
+
+        _cancellations.Register(first.options.cancellation_token, task);
+        _scheduler->Schedule(std::move(task));
+    }
+
+    NAPA_DEBUG("Zone", "Execute batch of %zu function calls on zone \"%s\"", specs.size(), _settings.id.c_str());
+}
+
+void NapaZone::ExecuteNative(NativeFunction function, NativeCallback callback) {
+    Entry entry(*this);
+    if (!entry) {
+        callback(NAPA_RESULT_ZONE_RECYCLED);
+        return;
+    }
+
+    // Native tasks share the pending queue and the workers of JS calls, so one scheduler governs both loads.
+    auto task = AllocateShared<NativeTask>(_taskPool, std::move(function), std::move(callback));
+
+    NAPA_DEBUG("Zone", "Execute native function on zone \"%s\"", _settings.id.c_str());
+    _scheduler->Schedule(std::move(task));
+}
+
+void NapaZone::GetHeapStatistics(HeapStatisticsCallback callback) {
+    struct Collector {
+        std::mutex lock;
+        std::vector<HeapStatistics> statistics;
+        std::atomic<uint32_t> pending;
+        HeapStatisticsCallback callback;
+    };
+
+    Entry entry(*this);
+    if (!entry) {
+        callback({});
+        return;
+    }
+
+    auto collector = std::make_shared<Collector>();
+    collector->callback = std::move(callback);
+
+    _scheduler->ScheduleOnRunningWorkers([collector](uint32_t workerCount) -> std::shared_ptr<Task> {
+        collector->pending = workerCount;
+        return std::make_shared<HeapStatisticsTask>([collector](const HeapStatistics& statistics) {
+            {
+                std::lock_guard<std::mutex> lock(collector->lock);
+                collector->statistics.push_back(statistics);
+            }
+            if (--collector->pending == 0) {
+                std::sort(collector->statistics.begin(), collector->statistics.end(),
+                    [](const HeapStatistics& left, const HeapStatistics& right) { return left.worker_id < right.worker_id; });
+                collector->callback(std::move(collector->statistics));
+            }
+        });
+    });
+
+    NAPA_DEBUG("Zone", "Collect heap statistics on zone \"%s\"", _settings.id.c_str());
+}
+
+ZoneStats NapaZone::GetStats() const {
+    Entry entry(*this);
+    if (!entry) {
+        return ZoneStats();
+    }
+
+    auto stats = _scheduler->GetStats();
+    if (_functionCounters != nullptr) {
+        stats.functions = _functionCounters->GetCounters();
+    }
+    return stats;
+}
+
+std::vector<FunctionStats> NapaZone::GetFunctionStats() const {
+    return _functionStats->GetStats();
+}
+
+void NapaZone::NotifyMemoryPressure(MemoryPressureLevel level) {
+    Entry entry(*this);
+    if (!entry) {
+        return;
+    }
+
+    _scheduler->ScheduleOnRunningWorkers([level](uint32_t) -> std::shared_ptr<Task> {
+        return std::make_shared<MemoryPressureTask>(level);
+    });
+
+    NAPA_DEBUG("Zone", "Notify memory pressure level %d on zone \"%s\"", static_cast<int>(level), _settings.id.c_str());
+}
+
+void NapaZone::StartProfiling(const std::vector<uint32_t>& workerIds, uint32_t samplingInterval) {
+    Entry entry(*this);
+    if (!entry) {
+        return;
+    }
+
+    if (workerIds.empty()) {
+        _scheduler->ScheduleOnRunningWorkers([samplingInterval](uint32_t) -> std::shared_ptr<Task> {
+            return std::make_shared<StartCpuProfilingTask>(samplingInterval);
+        });
+
+        NAPA_DEBUG("Zone", "Start profiling all workers on zone \"%s\"", _settings.id.c_str());
+        return;
+    }
+
+    // Workers of elastic zones have ids up to the maximum number of workers.
+    auto maxWorkers = _scheduler->GetMaxWorkerCount();
+    for (auto workerId : workerIds) {
+        if (workerId >= maxWorkers) {
+            LOG_WARNING("Zone", "Zone \"%s\" has no worker %u to profile.", _settings.id.c_str(), workerId);
+            continue;
+        }
+
+        _scheduler->ScheduleOnWorker(workerId, std::make_shared<StartCpuProfilingTask>(samplingInterval), SchedulePhase::ImmediatePhase);
+        NAPA_DEBUG("Zone", "Start profiling worker %u on zone \"%s\"", workerId, _settings.id.c_str());
+    }
+}
+
+void NapaZone::StopProfiling(CpuProfilesCallback callback) {
+    struct Collector {
+        std::mutex lock;
+        std::vector<CpuProfile> profiles;
+        std::atomic<uint32_t> pending;
+        CpuProfilesCallback callback;
+    };
+
+    Entry entry(*this);
+    if (!entry) {
+        callback({});
+        return;
+    }
+
+    auto collector = std::make_shared<Collector>();
+    collector->callback = std::move(callback);
+
+    _scheduler->ScheduleOnRunningWorkers([collector](uint32_t workerCount) -> std::shared_ptr<Task> {
+        collector->pending = workerCount;
+        return std::make_shared<StopCpuProfilingTask>([collector](CpuProfile profile) {
+            if (!profile.profile.empty()) {
+                std::lock_guard<std::mutex> lock(collector->lock);
+                collector->profiles.emplace_back(std::move(profile));
+            }
+            if (--collector->pending == 0) {
+                std::sort(collector->profiles.begin(), collector->profiles.end(),
+                    [](const CpuProfile& left, const CpuProfile& right) { return left.workerId < right.workerId; });
+                collector->callback(std::move(collector->profiles));
+            }
+        });
+    });
+
+    NAPA_DEBUG("Zone", "Stop profiling on zone \"%s\"", _settings.id.c_str());
+}
+
+ResultCode NapaZone::Recycle() {
+    // A worker of the zone would wait for itself to finish.
+    if (WorkerContext::Get(WorkerContextItem::ZONE) == reinterpret_cast<void*>(this)) {
+        LOG_WARNING("Zone", "Zone \"%s\" can't be recycled from its own worker.", _settings.id.c_str());
+        return NAPA_RESULT_ZONE_RECYCLE_ERROR;
+    }
+
+    if (_recycled.exchange(true)) {
+        return NAPA_RESULT_SUCCESS;
+    }
+
+    // The id is free for a new zone right away.
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto iter = _zones.find(_settings.id);
+        if (iter != _zones.end() && iter->second.lock().get() == this) {
+            _zones.erase(iter);
+        }
+    }
+
+    // Calls that entered before the flag was set finish scheduling their tasks, later calls are rejected.
+    while (_callers.load() != 0) {
+        std::this_thread::yield();
+    }
+
+    // Queued calls run before the workers dispose their isolates. The scheduler object stays, as asynchronous
+    // works and timers may still hold it, but it takes no tasks anymore.
+    _scheduler->Shutdown();
+    _resultCache->Clear();
+
+    NAPA_DEBUG("Zone", "Napa zone \"%s\" recycled.", _settings.id.c_str());
+    return NAPA_RESULT_SUCCESS;
+}
+
 const settings::ZoneSettings& NapaZone::GetSettings() const {
     return _settings;
 }
@@ -162,3 +911,23 @@ const settings::ZoneSettings& NapaZone::GetSettings() const {
 std::shared_ptr<Scheduler> NapaZone::GetScheduler() {
     return _scheduler;
 }
+
+SlowTaskDetector* NapaZone::GetSlowTaskDetector() {
+    return _slowTaskDetector.get();
+}
+
+FunctionCounterTable* NapaZone::GetFunctionCounterTable() {
+    return _functionCounters.get();
+}
+
+std::shared_ptr<FunctionStatsTable> NapaZone::GetFunctionStatsTable() {
+    return _functionStats;
+}
+
+SimpleThreadPool& NapaZone::GetAsyncWorkPool() {
+    return *_asyncWorkPool;
+}
+
+const SimpleThreadPool& NapaZone::GetAsyncWorkPool() const {
+    return *_asyncWorkPool;
+}
@@ -5,9 +5,22 @@
 
 #include "zone.h"
 
+#include "zone/block-pool.h"
+#include "zone/call-coalescer.h"
+#include "zone/cancellation-registry.h"
+#include "zone/concurrency-limiter.h"
+#include "zone/function-counters.h"
+#include "zone/function-stats.h"
+#include "zone/rate-limiter.h"
+#include "zone/result-cache.h"
+#include "zone/slow-task-detector.h"
+#include "zone/timeout-watchdog.h"
+#include "zone/warmup-recorder.h"
 #include "zone/scheduler.h"
+#include "zone/simple-thread-pool.h"
 #include "settings/settings.h"
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -26,15 +39,57 @@ namespace zone {
         /// <summary> Retrieves an existing zone by id. </summary>
         static std::shared_ptr<NapaZone> Get(const std::string& id);
 
+        /// <summary> Drains the tasks of the zone before its members are destroyed, since tasks still use them. </summary>
+        virtual ~NapaZone();
+
         /// <see cref="Zone::GetId" />
         virtual const std::string& GetId() const override;
 
+        /// <see cref="Zone::GetQueueLength" />
+        virtual size_t GetQueueLength() const override;
+
+        /// <see cref="Zone::GetWorkerCount" />
+        virtual uint32_t GetWorkerCount() const override;
+
+        /// <see cref="Zone::Cancel" />
+        virtual void Cancel(uint64_t token) override;
+
         /// <see cref="Zone::Broadcast" />
-        virtual void Broadcast(const FunctionSpec& spec, BroadcastCallback callback) override;
+        virtual void Broadcast(const FunctionSpec& spec, const std::vector<uint32_t>& workerIds, BroadcastCallback callback) override;
 
         /// <see cref="Zone::Execute" />
         virtual void Execute(const FunctionSpec& spec, ExecuteCallback callback) override;
 
+        /// <see cref="Zone::ExecuteOnWorker" />
+        virtual void ExecuteOnWorker(uint32_t workerId, const FunctionSpec& spec, ExecuteCallback callback) override;
+
+        /// <see cref="Zone::ExecuteBatch" />
+        virtual void ExecuteBatch(const std::vector<FunctionSpec>& specs, ExecuteBatchCallback callback) override;
+
+        /// <see cref="Zone::ExecuteNative" />
+        virtual void ExecuteNative(NativeFunction function, NativeCallback callback) override;
+
+        /// <see cref="Zone::GetHeapStatistics" />
+        virtual void GetHeapStatistics(HeapStatisticsCallback callback) override;
+
+        /// <see cref="Zone::GetStats" />
+        virtual ZoneStats GetStats() const override;
+
+        /// <see cref="Zone::GetFunctionStats" />
+        virtual std::vector<FunctionStats> GetFunctionStats() const override;
+
+        /// <see cref="Zone::NotifyMemoryPressure" />
+        virtual void NotifyMemoryPressure(MemoryPressureLevel level) override;
+
+        /// <see cref="Zone::StartProfiling" />
+        virtual void StartProfiling(const std::vector<uint32_t>& workerIds, uint32_t samplingInterval) override;
+
+        /// <see cref="Zone::StopProfiling" />
+        virtual void StopProfiling(CpuProfilesCallback callback) override;
+
+        /// <see cref="Zone::Recycle" />
+        virtual ResultCode Recycle() override;
+
         /// <summary> Retrieves the zone settings. </summary>
         const settings::ZoneSettings& GetSettings() const;
 
@@ -42,12 +97,108 @@ namespace zone {
         /// <remark> Asynchronous works keep the reference on scheduler, so they can finish up safely. </remarks>
         std::shared_ptr<zone::Scheduler> GetScheduler();
 
+        /// <summary> Retrieves the detector of slow calls, null unless 'slowTaskThreshold' is set. </summary>
+        zone::SlowTaskDetector* GetSlowTaskDetector();
+
+        /// <summary> Retrieves the hardware counters of calls by function, null unless 'hardwareCounters' is set and supported. </summary>
+        zone::FunctionCounterTable* GetFunctionCounterTable();
+
+        /// <summary> Retrieves the statistics of calls by function, shared with the calls in flight they are recorded from. </summary>
+        std::shared_ptr<zone::FunctionStatsTable> GetFunctionStatsTable();
+
+        /// <summary> Retrieves the thread pool that runs asynchronous works posted by the zone workers. </summary>
+        zone::SimpleThreadPool& GetAsyncWorkPool();
+
+        /// <summary> Retrieves the thread pool that runs asynchronous works posted by the zone workers. </summary>
+        const zone::SimpleThreadPool& GetAsyncWorkPool() const;
+
     private:
         explicit NapaZone(const settings::ZoneSettings& settings);
 
+        /// <summary> Counts a call on the zone while it's in scope, so Recycle waits for it before shutting the scheduler down. </summary>
+        class Entry {
+        public:
+            explicit Entry(const NapaZone& zone) : _zone(zone) {
+                _zone._callers.fetch_add(1);
+                _entered = !_zone._recycled.load();
+            }
+
+            ~Entry() {
+                _zone._callers.fetch_sub(1);
+            }
+
+            /// <summary> False if the zone is recycled, the call must then fail without using the scheduler. </summary>
+            explicit operator bool() const {
+                return _entered;
+            }
+
+            Entry(const Entry&) = delete;
+            Entry& operator=(const Entry&) = delete;
+
+        private:
+            const NapaZone& _zone;
+            bool _entered;
+        };
+
+        /// <summary> Creates the task of a call, with a timeout decorator if the call has a timeout. </summary>
+        /// <param name="deadline"> The deadline of the call in milliseconds since epoch, 0 for none. </param>
+        /// <param name="timeout"> The timeout of the call in milliseconds, 0 for none. </param>
+        std::shared_ptr<zone::Task> CreateCallTask(
+            const FunctionSpec& spec,
+            ExecuteCallback callback,
+            int64_t deadline,
+            uint32_t timeout);
+
+        /// <summary> Takes the tokens of a call from the rate limits of the zone and its tenant. </summary>
+        /// <returns> False if the call is over a rate limit and must be rejected with NAPA_RESULT_RATE_LIMITED. </returns>
+        bool AcquireRateLimit(const CallOptions& options);
+
         settings::ZoneSettings _settings;
+
+        /// <summary> Reports slow calls, declared before the scheduler so it outlives the workers. </summary>
+        std::unique_ptr<zone::SlowTaskDetector> _slowTaskDetector;
+
+        /// <summary> Sums hardware counters of calls, declared before the scheduler so it outlives the workers. </summary>
+        std::unique_ptr<zone::FunctionCounterTable> _functionCounters;
+
+        /// <summary> Counts calls by function, held by the calls in flight that may finish after the zone is destroyed. </summary>
+        std::shared_ptr<zone::FunctionStatsTable> _functionStats;
+
         std::shared_ptr<zone::Scheduler> _scheduler;
 
+        /// <summary> Recycles the memory of call tasks and contexts, so a call doesn't hit the global allocator. </summary>
+        std::shared_ptr<zone::BlockPool> _taskPool;
+
+        /// <summary> Results of calls made with a cache option, held by the callbacks of calls that may outlive the zone. </summary>
+        std::shared_ptr<zone::ResultCache> _resultCache;
+
+        /// <summary> Coalescing calls in flight, held by the callbacks of calls that may outlive the zone. </summary>
+        std::shared_ptr<zone::CallCoalescer> _coalescer;
+
+        /// <summary> Cancellable calls by their cancellation token. </summary>
+        zone::CancellationRegistry _cancellations;
+
+        /// <summary> Rejects calls over the rate limits of the zone and its tenants. </summary>
+        zone::RateLimiter _rateLimiter;
+
+        /// <summary> Rejects calls over the adaptive concurrency limit, held by the callbacks of calls that may outlive the zone. </summary>
+        std::shared_ptr<zone::ConcurrencyLimiter> _concurrencyLimiter;
+
+        /// <summary> Records the arguments of calls of the warm-up function, null unless 'warmupRecord' is set. </summary>
+        std::unique_ptr<zone::WarmupRecorder> _warmupRecorder;
+
+        /// <summary> Terminates calls that run past their timeout, held by timed tasks that may outlive the zone. </summary>
+        std::shared_ptr<zone::TimeoutWatchdog> _timeoutWatchdog;
+
+        /// <summary> Runs asynchronous works, it is destroyed first so pending works complete while the scheduler is alive. </summary>
+        std::unique_ptr<zone::SimpleThreadPool> _asyncWorkPool;
+
+        /// <summary> Set by Recycle before it waits for the calls that entered the zone to leave it. </summary>
+        std::atomic<bool> _recycled;
+
+        /// <summary> The number of calls in scope of an Entry. </summary>
+        mutable std::atomic<uint32_t> _callers;
+
         static std::mutex _mutex;
         static std::unordered_map<std::string, std::weak_ptr<NapaZone>> _zones;
     };
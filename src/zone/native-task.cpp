@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "native-task.h"
+
+#include <napa/log.h>
+
+#include <exception>
+
+using namespace napa;
+using namespace napa::zone;
+
+NativeTask::NativeTask(NativeFunction function, NativeCallback callback) :
+    _function(std::move(function)),
+    _callback(std::move(callback)) {
+}
+
+void NativeTask::Execute() {
+    auto code = NAPA_RESULT_SUCCESS;
+    try {
+        _function();
+    } catch (const std::exception& ex) {
+        // The worker loop doesn't expect tasks to throw, the failure is reported to the caller instead.
+        LOG_ERROR("NativeTask", "Native function threw an exception: %s", ex.what());
+        code = NAPA_RESULT_INTERNAL_ERROR;
+    }
+
+    if (_callback) {
+        _callback(code);
+    }
+}
+
+// NativeCallback only receives a result code, the reason is not reported.
+void NativeTask::Reject(napa::ResultCode code, const std::string& /*reason*/) {
+    NAPA_DEBUG("NativeTask", "Native function rejected with code %d", static_cast<int>(code));
+    if (_callback) {
+        _callback(code);
+    }
+}
@@ -0,0 +1,40 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <zone/task.h>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A task running a native function on a zone worker, without entering V8. </summary>
+    /// <remarks>
+    ///     The function is neither given a call context nor marshalled arguments, and no handle scope is opened for it,
+    ///     it shares the zone workers with JavaScript calls as a plain task of the scheduler.
+    /// </remarks>
+    class NativeTask : public Task {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="function"> The native function. </param>
+        /// <param name="callback"> A callback that is triggered once the function ran, or the task was rejected. </param>
+        NativeTask(NativeFunction function, NativeCallback callback);
+
+        /// <summary> Overrides Task.Execute to run the native function. </summary>
+        virtual void Execute() override;
+
+        /// <summary> Overrides Task.Reject to report the code the task was dropped with. </summary>
+        virtual void Reject(napa::ResultCode code, const std::string& reason) override;
+
+        /// <summary> The callback receives the code of the rejection. </summary>
+        virtual bool CanReject() const override { return true; }
+
+    private:
+
+        NativeFunction _function;
+        NativeCallback _callback;
+    };
+
+}
+}
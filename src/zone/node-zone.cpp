@@ -2,11 +2,14 @@
 // Licensed under the MIT license.
 
 #include "node-zone.h"
+#include "batch-results.h"
 
 #include "worker-context.h"
 
 #include <napa/assert.h>
 
+#include <algorithm>
+
 using namespace napa;
 using namespace napa::zone;
 
@@ -40,10 +43,87 @@ const std::string& NodeZone::GetId() const {
     return _id;
 }
 
-void NodeZone::Broadcast(const FunctionSpec& source, BroadcastCallback callback) {
+size_t NodeZone::GetQueueLength() const {
+    // Calls are queued by the node event loop, which doesn't expose its queue.
+    return 0;
+}
+
+uint32_t NodeZone::GetWorkerCount() const {
+    // Calls run on the node main thread.
+    return 1;
+}
+
+void NodeZone::Cancel(uint64_t) {
+    // Calls are handed to the node event loop right away, there is nothing left to withdraw.
+}
+
+void NodeZone::Broadcast(const FunctionSpec& source, const std::vector<uint32_t>& workerIds, BroadcastCallback callback) {
+    // The node zone runs on worker 0 only.
+    if (!workerIds.empty() && std::find(workerIds.begin(), workerIds.end(), 0u) == workerIds.end()) {
+        callback({ NAPA_RESULT_SUCCESS, "", "", nullptr });
+        return;
+    }
     _broadcast(source, callback);
 }
 
 void NodeZone::Execute(const FunctionSpec& spec, ExecuteCallback callback) {
     _execute(spec, callback);
 }
+
+void NodeZone::ExecuteOnWorker(uint32_t workerId, const FunctionSpec& spec, ExecuteCallback callback) {
+    // Calls run on the node main thread, the only worker of the node zone.
+    if (workerId != 0) {
+        callback({ NAPA_RESULT_WORKER_NOT_RUNNING, "Worker is not running", "", nullptr });
+        return;
+    }
+    _execute(spec, callback);
+}
+
+void NodeZone::ExecuteBatch(const std::vector<FunctionSpec>& specs, ExecuteBatchCallback callback) {
+    if (specs.empty()) {
+        callback({});
+        return;
+    }
+
+    // Node has a single event loop, so calls are delegated one by one and only completion is batched.
+    auto results = BatchResults::Create(specs.size(), std::move(callback));
+    for (size_t i = 0; i < specs.size(); i++) {
+        _execute(specs[i], results->CallbackAt(i));
+    }
+}
+
+void NodeZone::ExecuteNative(NativeFunction, NativeCallback callback) {
+    // Calls are delegated to the node event loop as JS functions, the node zone has no worker to run native functions on.
+    callback(NAPA_RESULT_WORKER_NOT_RUNNING);
+}
+
+void NodeZone::GetHeapStatistics(HeapStatisticsCallback callback) {
+    // The node isolate reports its heap through node's own 'v8' module.
+    callback({});
+}
+
+ZoneStats NodeZone::GetStats() const {
+    // Calls run on the node event loop, which has no worker of its own to count.
+    return ZoneStats();
+}
+
+std::vector<FunctionStats> NodeZone::GetFunctionStats() const {
+    return {};
+}
+
+void NodeZone::NotifyMemoryPressure(MemoryPressureLevel) {
+    // The node isolate is left to node, which has its own memory pressure handling.
+}
+
+void NodeZone::StartProfiling(const std::vector<uint32_t>&, uint32_t) {
+    // The node isolate is profiled through node's own inspector.
+}
+
+void NodeZone::StopProfiling(CpuProfilesCallback callback) {
+    callback({});
+}
+
+ResultCode NodeZone::Recycle() {
+    // The node isolate lives as long as node.
+    return NAPA_RESULT_ZONE_RECYCLE_ERROR;
+}
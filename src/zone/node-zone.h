@@ -33,12 +33,51 @@ namespace zone {
         /// <see cref="Zone::GetId" />
         virtual const std::string& GetId() const override;
 
+        /// <see cref="Zone::GetQueueLength" />
+        virtual size_t GetQueueLength() const override;
+
+        /// <see cref="Zone::GetWorkerCount" />
+        virtual uint32_t GetWorkerCount() const override;
+
+        /// <see cref="Zone::Cancel" />
+        virtual void Cancel(uint64_t token) override;
+
         /// <see cref="Zone::Broadcast" />
-        virtual void Broadcast(const FunctionSpec& spec, BroadcastCallback callback) override;
+        virtual void Broadcast(const FunctionSpec& spec, const std::vector<uint32_t>& workerIds, BroadcastCallback callback) override;
 
         /// <see cref="Zone::Execute" />
         virtual void Execute(const FunctionSpec& spec, ExecuteCallback callback) override;
 
+        /// <see cref="Zone::ExecuteOnWorker" />
+        virtual void ExecuteOnWorker(uint32_t workerId, const FunctionSpec& spec, ExecuteCallback callback) override;
+
+        /// <see cref="Zone::ExecuteBatch" />
+        virtual void ExecuteBatch(const std::vector<FunctionSpec>& specs, ExecuteBatchCallback callback) override;
+
+        /// <see cref="Zone::ExecuteNative" />
+        virtual void ExecuteNative(NativeFunction function, NativeCallback callback) override;
+
+        /// <see cref="Zone::GetHeapStatistics" />
+        virtual void GetHeapStatistics(HeapStatisticsCallback callback) override;
+
+        /// <see cref="Zone::GetStats" />
+        virtual ZoneStats GetStats() const override;
+
+        /// <summary> Calls of the node zone aren't counted, there are no statistics. </summary>
+        virtual std::vector<FunctionStats> GetFunctionStats() const override;
+
+        /// <see cref="Zone::NotifyMemoryPressure" />
+        virtual void NotifyMemoryPressure(MemoryPressureLevel level) override;
+
+        /// <see cref="Zone::StartProfiling" />
+        virtual void StartProfiling(const std::vector<uint32_t>& workerIds, uint32_t samplingInterval) override;
+
+        /// <see cref="Zone::StopProfiling" />
+        virtual void StopProfiling(CpuProfilesCallback callback) override;
+
+        /// <see cref="Zone::Recycle" />
+        virtual ResultCode Recycle() override;
+
     private:
         /// <summary> Constructor. </summary>
         NodeZone(BroadcastDelegate broadcast, ExecuteDelegate execute);
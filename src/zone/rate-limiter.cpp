@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "rate-limiter.h"
+
+#include <algorithm>
+
+using namespace napa;
+using namespace napa::zone;
+
+RateLimiter::RateLimiter(uint32_t rate, const std::vector<settings::TenantRateLimit>& tenantRates) :
+    _rate(rate),
+    _defaultTenantRate(0),
+    _zoneBucket{ static_cast<double>(rate), static_cast<double>(rate), Clock::now() } {
+
+    for (const auto& tenantRate : tenantRates) {
+        if (tenantRate.name == "*") {
+            _defaultTenantRate = tenantRate.rate;
+        } else {
+            _tenantRates[tenantRate.tenant] = tenantRate.rate;
+        }
+    }
+    _enabled = _rate > 0 || _defaultTenantRate > 0 || !_tenantRates.empty();
+}
+
+bool RateLimiter::IsEnabled() const {
+    return _enabled;
+}
+
+bool RateLimiter::TryAcquire(uint64_t tenant) {
+    return TryAcquire(tenant, Clock::now());
+}
+
+bool RateLimiter::TryAcquire(uint64_t tenant, Clock::time_point now) {
+    if (!_enabled) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto tenantBucket = GetTenantBucket(tenant, now);
+    if (tenantBucket != nullptr && tenantBucket->tokens < 1) {
+        return false;
+    }
+
+    if (_rate > 0) {
+        _zoneBucket.Refill(now);
+        if (_zoneBucket.tokens < 1) {
+            return false;
+        }
+        _zoneBucket.tokens -= 1;
+    }
+
+    // The tenant's token is only taken once the zone admitted the call, a call rejected by the zone costs its tenant nothing.
+    if (tenantBucket != nullptr) {
+        tenantBucket->tokens -= 1;
+    }
+    return true;
+}
+
+RateLimiter::Bucket* RateLimiter::GetTenantBucket(uint64_t tenant, Clock::time_point now) {
+    if (tenant == 0) {
+        return nullptr;
+    }
+
+    auto bucket = _tenantBuckets.find(tenant);
+    if (bucket == _tenantBuckets.end()) {
+        auto rate = _tenantRates.find(tenant);
+        auto tenantRate = rate != _tenantRates.end() ? rate->second : _defaultTenantRate;
+        if (tenantRate == 0) {
+            return nullptr;
+        }
+
+        // Tenants seen once keep their bucket, each is a few words and tenants are not expected to be unbounded.
+        bucket = _tenantBuckets.emplace(tenant, Bucket{ tenantRate, tenantRate, now }).first;
+    }
+
+    bucket->second.Refill(now);
+    return &bucket->second;
+}
+
+void RateLimiter::Bucket::Refill(Clock::time_point now) {
+    if (now <= refillTime) {
+        return;
+    }
+    auto elapsed = std::chrono::duration<double>(now - refillTime).count();
+    tokens = std::min(rate, tokens + elapsed * rate);
+    refillTime = now;
+}
@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <settings/settings.h>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Token buckets limiting the rate of calls of a zone and of each of its tenants. </summary>
+    /// <remarks>
+    ///     A bucket holds up to a second of calls at its rate and refills continuously, so a burst of that many calls
+    ///     passes after a quiet second. A call takes a token from its tenant's bucket and one from the zone's bucket,
+    ///     and is rejected if either is empty. Calls of the default tenant are only limited by the zone's rate.
+    /// </remarks>
+    class RateLimiter {
+    public:
+
+        using Clock = std::chrono::steady_clock;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="rate"> The calls per second of the zone, 0 for no limit. </param>
+        /// <param name="tenantRates"> The calls per second of tenants, a '*' entry applies to tenants without their own. </param>
+        RateLimiter(uint32_t rate, const std::vector<settings::TenantRateLimit>& tenantRates);
+
+        /// <summary> Non-copyable. </summary>
+        RateLimiter(const RateLimiter&) = delete;
+        RateLimiter& operator=(const RateLimiter&) = delete;
+
+        /// <summary> Returns true if calls are limited at all, other calls don't need to be checked. </summary>
+        bool IsEnabled() const;
+
+        /// <summary> Takes the tokens of a call of a tenant. </summary>
+        /// <returns> False if the call exceeds the rate of the zone or of its tenant, and must be rejected. </returns>
+        bool TryAcquire(uint64_t tenant);
+
+        /// <summary> Takes the tokens of a call of a tenant at a given time, see TryAcquire. </summary>
+        bool TryAcquire(uint64_t tenant, Clock::time_point now);
+
+    private:
+
+        /// <summary> A token bucket, full when it's created. </summary>
+        struct Bucket {
+            double rate;
+            double tokens;
+            Clock::time_point refillTime;
+
+            /// <summary> Adds the tokens accrued since the last refill, up to a second of tokens. </summary>
+            void Refill(Clock::time_point now);
+        };
+
+        /// <summary> Returns the bucket of a tenant, or null if the tenant is not limited. </summary>
+        Bucket* GetTenantBucket(uint64_t tenant, Clock::time_point now);
+
+        bool _enabled;
+        double _rate;
+        double _defaultTenantRate;
+        std::unordered_map<uint64_t, double> _tenantRates;
+
+        std::mutex _lock;
+        Bucket _zoneBucket;
+        std::unordered_map<uint64_t, Bucket> _tenantBuckets;
+    };
+}
+}
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "remote-channel.h"
+
+using namespace napa;
+using namespace napa::zone::remote;
+
+SocketChannel::SocketChannel(platform::Socket socket) : _socket(std::move(socket)) {}
+
+std::unique_ptr<SocketChannel> SocketChannel::Connect(const std::string& address) {
+    std::string host;
+    uint16_t port;
+    if (!platform::ParseAddress(address, host, port)) {
+        return nullptr;
+    }
+
+    auto socket = platform::Socket::Connect(host, port);
+    if (!socket.IsConnected()) {
+        return nullptr;
+    }
+    return std::make_unique<SocketChannel>(std::move(socket));
+}
+
+bool SocketChannel::Write(const void* data, size_t size) {
+    return _socket.Write(data, size);
+}
+
+bool SocketChannel::Read(void* data, size_t size) {
+    return _socket.Read(data, size);
+}
+
+void SocketChannel::Shutdown() {
+    _socket.Shutdown();
+}
+
+SocketChannelListener::SocketChannelListener(const std::string& host, uint16_t port) : _listener(host, port) {}
+
+bool SocketChannelListener::IsListening() const {
+    return _listener.IsListening();
+}
+
+uint16_t SocketChannelListener::GetPort() const {
+    return _listener.GetPort();
+}
+
+std::unique_ptr<Channel> SocketChannelListener::Accept() {
+    auto socket = _listener.Accept();
+    if (!socket.IsConnected()) {
+        return nullptr;
+    }
+    return std::make_unique<SocketChannel>(std::move(socket));
+}
+
+void SocketChannelListener::Shutdown() {
+    _listener.Shutdown();
+}
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <platform/socket.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace napa {
+namespace zone {
+namespace remote {
+
+    /// <summary>
+    ///     A byte stream to a process serving or using a zone, which messages of the remote protocol are exchanged on.
+    ///     Writes are made by one thread at a time, and reads by one thread.
+    /// </summary>
+    class Channel {
+    public:
+
+        /// <summary> Writes all the bytes, unless the channel fails or is shut down. </summary>
+        /// <returns> False if the channel failed or was shut down. </returns>
+        virtual bool Write(const void* data, size_t size) = 0;
+
+        /// <summary> Reads exactly size bytes, unless the channel fails or is shut down. </summary>
+        /// <returns> False if the channel failed or was shut down, by either side. </returns>
+        virtual bool Read(void* data, size_t size) = 0;
+
+        /// <summary> Shuts the channel down, which makes blocked reads and writes of other threads return. </summary>
+        virtual void Shutdown() = 0;
+
+        virtual ~Channel() {}
+    };
+
+    /// <summary> Waits for channels of processes connecting to a served zone. </summary>
+    class ChannelListener {
+    public:
+
+        /// <summary> Waits for the next channel. </summary>
+        /// <returns> nullptr once the listener is shut down. </returns>
+        virtual std::unique_ptr<Channel> Accept() = 0;
+
+        /// <summary> Stops listening, which makes a blocked Accept of another thread return. </summary>
+        virtual void Shutdown() = 0;
+
+        virtual ~ChannelListener() {}
+    };
+
+    /// <summary> A channel over a TCP connection. </summary>
+    class SocketChannel : public Channel {
+    public:
+        explicit SocketChannel(platform::Socket socket);
+
+        /// <summary> Connects to an address like 'host:port'. </summary>
+        /// <returns> nullptr if the address is invalid or couldn't be connected to. </returns>
+        static std::unique_ptr<SocketChannel> Connect(const std::string& address);
+
+        bool Write(const void* data, size_t size) override;
+        bool Read(void* data, size_t size) override;
+        void Shutdown() override;
+
+    private:
+        platform::Socket _socket;
+    };
+
+    /// <summary> Listens for TCP connections. </summary>
+    class SocketChannelListener : public ChannelListener {
+    public:
+
+        /// <summary> Listens on a local host and port, port 0 for a port chosen by the system. </summary>
+        SocketChannelListener(const std::string& host, uint16_t port);
+
+        /// <summary> Tell if the socket is listening. </summary>
+        bool IsListening() const;
+
+        /// <summary> The port listened on. </summary>
+        uint16_t GetPort() const;
+
+        std::unique_ptr<Channel> Accept() override;
+        void Shutdown() override;
+
+    private:
+        platform::Listener _listener;
+    };
+}
+}
+}
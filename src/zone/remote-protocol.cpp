@@ -0,0 +1,247 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "remote-protocol.h"
+
+#include <napa/transport/transport-context.h>
+
+#include <cstring>
+
+using namespace napa;
+using namespace napa::zone::remote;
+
+namespace {
+
+    /// <summary> Appends an integer in little-endian order, whatever the host order is. </summary>
+    template <typename T>
+    void Append(std::string& buffer, T value) {
+        char bytes[sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); i++) {
+            bytes[i] = static_cast<char>(static_cast<uint64_t>(value) >> (8 * i));
+        }
+        buffer.append(bytes, sizeof(T));
+    }
+
+    template <typename T>
+    T Load(const char* data) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+        }
+        return static_cast<T>(value);
+    }
+}
+
+MessageWriter::MessageWriter(MessageType type, uint64_t requestId) {
+    _buffer.reserve(256);
+    Append<uint32_t>(_buffer, 0);
+    Append<uint8_t>(_buffer, static_cast<uint8_t>(type));
+    Append<uint64_t>(_buffer, requestId);
+}
+
+void MessageWriter::WriteUInt32(uint32_t value) {
+    Append(_buffer, value);
+}
+
+void MessageWriter::WriteUInt64(uint64_t value) {
+    Append(_buffer, value);
+}
+
+void MessageWriter::WriteString(const char* data, size_t size) {
+    Append(_buffer, static_cast<uint32_t>(size));
+    _buffer.append(data != nullptr ? data : "", size);
+}
+
+void MessageWriter::WriteString(const std::string& value) {
+    WriteString(value.data(), value.size());
+}
+
+void MessageWriter::WriteSpec(const napa::FunctionSpec& spec) {
+    WriteString(spec.module.data, spec.module.size);
+    WriteString(spec.function.data, spec.function.size);
+
+    if (!spec.ownedArguments.empty()) {
+        WriteUInt32(static_cast<uint32_t>(spec.ownedArguments.size()));
+        for (const auto& argument : spec.ownedArguments) {
+            WriteString(argument);
+        }
+    } else {
+        WriteUInt32(static_cast<uint32_t>(spec.arguments.size()));
+        for (const auto& argument : spec.arguments) {
+            WriteString(argument.data, argument.size);
+        }
+    }
+
+    const auto& options = spec.options;
+    WriteUInt32(options.timeout);
+    WriteUInt32(static_cast<uint32_t>(options.transport));
+    WriteUInt32(options.priority);
+    WriteUInt64(static_cast<uint64_t>(options.deadline));
+    WriteUInt64(options.routing_key);
+    WriteUInt64(options.cancellation_token);
+    WriteUInt32(options.record_timing);
+    WriteUInt32(options.collect_garbage);
+    WriteUInt32(options.cache_ttl);
+    WriteUInt64(options.cache_key);
+    WriteUInt32(options.coalesce);
+    WriteUInt32(options.detach_deadline);
+    WriteUInt32(options.compression_threshold);
+    WriteUInt64(options.tenant);
+    WriteUInt64(options.trace_id);
+    WriteUInt64(options.parent_span_id);
+    WriteUInt32(options.trace_sampled);
+}
+
+void MessageWriter::WriteResult(const napa::Result& result) {
+    WriteUInt32(static_cast<uint32_t>(result.code));
+    WriteString(result.errorMessage);
+    WriteString(result.returnValue);
+    WriteUInt64(static_cast<uint64_t>(result.timing.queue));
+    WriteUInt64(static_cast<uint64_t>(result.timing.unmarshall));
+    WriteUInt64(static_cast<uint64_t>(result.timing.execute));
+    WriteUInt64(static_cast<uint64_t>(result.timing.marshall));
+}
+
+void MessageWriter::WriteHello(const Hello& hello) {
+    WriteUInt32(hello.version);
+    WriteUInt32(hello.workerCount);
+    WriteString(hello.zoneId);
+}
+
+std::string& MessageWriter::Finish() {
+    auto size = static_cast<uint32_t>(_buffer.size() - HEADER_SIZE);
+    for (size_t i = 0; i < 4; i++) {
+        _buffer[i] = static_cast<char>(size >> (8 * i));
+    }
+    return _buffer;
+}
+
+MessageReader::MessageReader(const char* data, size_t size) : _data(data), _size(size), _position(0) {}
+
+bool MessageReader::ReadUInt32(uint32_t& value) {
+    if (_size - _position < 4) {
+        return false;
+    }
+    value = Load<uint32_t>(_data + _position);
+    _position += 4;
+    return true;
+}
+
+bool MessageReader::ReadUInt64(uint64_t& value) {
+    if (_size - _position < 8) {
+        return false;
+    }
+    value = Load<uint64_t>(_data + _position);
+    _position += 8;
+    return true;
+}
+
+bool MessageReader::ReadString(std::string& value) {
+    uint32_t size;
+    if (!ReadUInt32(size) || _size - _position < size) {
+        return false;
+    }
+    value.assign(_data + _position, size);
+    _position += size;
+    return true;
+}
+
+bool MessageReader::ReadSpec(DecodedSpec& decoded) {
+    uint32_t count;
+    if (!ReadString(decoded.module) || !ReadString(decoded.function) || !ReadUInt32(count)) {
+        return false;
+    }
+
+    auto& spec = decoded.spec;
+    spec.module = STD_STRING_TO_NAPA_STRING_REF(decoded.module);
+    spec.function = STD_STRING_TO_NAPA_STRING_REF(decoded.function);
+
+    // Each argument takes at least its size, which bounds the count before anything is allocated.
+    if (count > (_size - _position) / 4) {
+        return false;
+    }
+    spec.ownedArguments.resize(count);
+    for (auto& argument : spec.ownedArguments) {
+        if (!ReadString(argument)) {
+            return false;
+        }
+    }
+
+    auto& options = spec.options;
+    uint32_t transport;
+    uint64_t deadline;
+    if (!ReadUInt32(options.timeout)
+        || !ReadUInt32(transport)
+        || !ReadUInt32(options.priority)
+        || !ReadUInt64(deadline)
+        || !ReadUInt64(options.routing_key)
+        || !ReadUInt64(options.cancellation_token)
+        || !ReadUInt32(options.record_timing)
+        || !ReadUInt32(options.collect_garbage)
+        || !ReadUInt32(options.cache_ttl)
+        || !ReadUInt64(options.cache_key)
+        || !ReadUInt32(options.coalesce)
+        || !ReadUInt32(options.detach_deadline)
+        || !ReadUInt32(options.compression_threshold)
+        || !ReadUInt64(options.tenant)
+        || !ReadUInt64(options.trace_id)
+        || !ReadUInt64(options.parent_span_id)
+        || !ReadUInt32(options.trace_sampled)) {
+        return false;
+    }
+    if (transport > BINARY) {
+        return false;
+    }
+    options.transport = static_cast<napa::TransportOption>(transport);
+    options.deadline = static_cast<int64_t>(deadline);
+
+    spec.transportContext = std::make_unique<napa::transport::TransportContext>();
+    return true;
+}
+
+bool MessageReader::ReadResult(napa::Result& result) {
+    uint32_t code;
+    uint64_t queue, unmarshall, execute, marshall;
+    if (!ReadUInt32(code)
+        || !ReadString(result.errorMessage)
+        || !ReadString(result.returnValue)
+        || !ReadUInt64(queue)
+        || !ReadUInt64(unmarshall)
+        || !ReadUInt64(execute)
+        || !ReadUInt64(marshall)) {
+        return false;
+    }
+    result.code = static_cast<napa::ResultCode>(code);
+    result.timing = { static_cast<int64_t>(queue), static_cast<int64_t>(unmarshall), static_cast<int64_t>(execute), static_cast<int64_t>(marshall) };
+    result.transportContext = std::make_unique<napa::transport::TransportContext>();
+    return true;
+}
+
+bool MessageReader::ReadHello(Hello& hello) {
+    return ReadUInt32(hello.version) && ReadUInt32(hello.workerCount) && ReadString(hello.zoneId);
+}
+
+bool MessageReader::IsAtEnd() const {
+    return _position == _size;
+}
+
+MessageHeader napa::zone::remote::ReadHeader(const char* data) {
+    MessageHeader header;
+    header.size = Load<uint32_t>(data);
+    header.type = static_cast<MessageType>(static_cast<uint8_t>(data[4]));
+    header.requestId = Load<uint64_t>(data + 5);
+    return header;
+}
+
+bool napa::zone::remote::ReadMessage(Channel& channel, MessageHeader& header, std::string& payload) {
+    char bytes[HEADER_SIZE];
+    if (!channel.Read(bytes, sizeof(bytes))) {
+        return false;
+    }
+    header = ReadHeader(bytes);
+    if (header.size > MAX_MESSAGE_SIZE) {
+        return false;
+    }
+    payload.resize(header.size);
+    return header.size == 0 || channel.Read(&payload[0], payload.size());
+}
@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+#include "remote-channel.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace zone {
+namespace remote {
+
+    /// <summary> The version of the protocol, a server and its clients speak the same version. </summary>
+    constexpr uint32_t PROTOCOL_VERSION = 1;
+
+    /// <summary> The largest message accepted, the connection is closed on larger ones. </summary>
+    constexpr uint32_t MAX_MESSAGE_SIZE = 1u << 30;
+
+    /// <summary> Size of a message header: payload size, type and request id, little-endian. </summary>
+    constexpr size_t HEADER_SIZE = 4 + 1 + 8;
+
+    /// <summary> Type of a message, requests are answered by a Result with the same request id. </summary>
+    enum class MessageType : uint8_t {
+
+        /// <summary> Sent by the server on accepting a connection: version, worker count and zone id. </summary>
+        Hello = 1,
+
+        /// <summary> A function spec to execute on any worker. </summary>
+        Execute = 2,
+
+        /// <summary> A worker id and a function spec to execute on it. </summary>
+        ExecuteOnWorker = 3,
+
+        /// <summary> Worker ids and a function spec to broadcast to them, all workers if none. </summary>
+        Broadcast = 4,
+
+        /// <summary> A cancellation token, which is not answered. </summary>
+        Cancel = 5,
+
+        /// <summary> The result of the request with the same id. </summary>
+        Result = 6
+    };
+
+    /// <summary> Header of a message, followed by 'size' bytes of payload. </summary>
+    struct MessageHeader {
+        uint32_t size;
+        MessageType type;
+        uint64_t requestId;
+    };
+
+    /// <summary> What a server says about itself in its Hello message. </summary>
+    struct Hello {
+        uint32_t version;
+        uint32_t workerCount;
+        std::string zoneId;
+    };
+
+    /// <summary> A function spec read from a message, which owns the strings the spec refers to. </summary>
+    struct DecodedSpec {
+        std::string module;
+        std::string function;
+        napa::FunctionSpec spec;
+
+        DecodedSpec() = default;
+        DecodedSpec(const DecodedSpec&) = delete;
+        DecodedSpec& operator=(const DecodedSpec&) = delete;
+    };
+
+    /// <summary> Writes a message into a buffer, which is sent as it is. </summary>
+    class MessageWriter {
+    public:
+
+        /// <summary> Begins a message, the header is completed by Finish. </summary>
+        MessageWriter(MessageType type, uint64_t requestId);
+
+        void WriteUInt32(uint32_t value);
+        void WriteUInt64(uint64_t value);
+        void WriteString(const char* data, size_t size);
+        void WriteString(const std::string& value);
+
+        /// <summary> Writes the module, function, arguments and options of a spec, not its transport context. </summary>
+        void WriteSpec(const napa::FunctionSpec& spec);
+
+        /// <summary> Writes the code, error message, return value and timing of a result, not its transport context. </summary>
+        void WriteResult(const napa::Result& result);
+
+        void WriteHello(const Hello& hello);
+
+        /// <summary> Completes the header, and returns the message. </summary>
+        std::string& Finish();
+
+    private:
+        std::string _buffer;
+    };
+
+    /// <summary> Reads the payload of a message, each read returns false once the payload is too short. </summary>
+    class MessageReader {
+    public:
+        MessageReader(const char* data, size_t size);
+
+        bool ReadUInt32(uint32_t& value);
+        bool ReadUInt64(uint64_t& value);
+        bool ReadString(std::string& value);
+
+        /// <summary> Reads a spec, whose arguments are owned arguments and whose transport context is empty. </summary>
+        bool ReadSpec(DecodedSpec& decoded);
+
+        /// <summary> Reads a result, whose transport context is empty. </summary>
+        bool ReadResult(napa::Result& result);
+
+        bool ReadHello(Hello& hello);
+
+        /// <summary> Tell if the whole payload was read. </summary>
+        bool IsAtEnd() const;
+
+    private:
+        const char* _data;
+        size_t _size;
+        size_t _position;
+    };
+
+    /// <summary> Reads a message header. </summary>
+    /// <param name="data"> HEADER_SIZE bytes. </param>
+    MessageHeader ReadHeader(const char* data);
+
+    /// <summary> Reads a whole message from a channel. </summary>
+    /// <returns> False if the connection failed, or the message is larger than MAX_MESSAGE_SIZE. </returns>
+    bool ReadMessage(Channel& channel, MessageHeader& header, std::string& payload);
+}
+}
+}
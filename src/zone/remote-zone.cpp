@@ -0,0 +1,379 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "remote-zone.h"
+
+#include <zone/batch-results.h>
+#include <zone/shared-memory-channel.h>
+
+#include <napa/log.h>
+
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+using namespace napa;
+using namespace napa::zone;
+using namespace napa::zone::remote;
+
+struct RemoteZone::DrainSignal {
+    std::mutex lock;
+    std::condition_variable drained;
+};
+
+/// <summary> A connection to the zone server, whose results are read by a thread of its own. </summary>
+struct RemoteZone::Connection {
+    std::unique_ptr<Channel> channel;
+
+    /// <summary> The zone id, for logging once the zone may be gone. </summary>
+    std::string zoneId;
+    std::shared_ptr<DrainSignal> drain;
+
+    /// <summary> Messages are written whole, one at a time. </summary>
+    std::mutex writeLock;
+
+    /// <summary> Guards the calls waiting for a result and the open flag. </summary>
+    std::mutex pendingLock;
+    std::unordered_map<uint64_t, ExecuteCallback> pending;
+    bool open = true;
+
+    /// <summary> The number of pending calls, read without the lock for picking a connection. </summary>
+    std::atomic<size_t> pendingCount { 0 };
+
+    std::thread reader;
+};
+
+namespace {
+
+    Result MakeResult(ResultCode code, const char* message) {
+        return { code, message, "", std::make_unique<napa::transport::TransportContext>() };
+    }
+}
+
+std::shared_ptr<RemoteZone> RemoteZone::Connect(const std::string& address, uint32_t connections) {
+    std::string host;
+    uint16_t port;
+    if (!platform::ParseAddress(address, host, port)) {
+        LOG_ERROR("RemoteZone", "Invalid remote zone address \"%s\", expected 'host:port'.", address.c_str());
+        return nullptr;
+    }
+
+    std::vector<std::unique_ptr<Channel>> channels;
+    for (uint32_t i = 0; i < std::max(connections, 1u); i++) {
+        auto channel = SocketChannel::Connect(address);
+        if (channel == nullptr) {
+            LOG_ERROR("RemoteZone", "Failed to connect to remote zone at \"%s\".", address.c_str());
+            return nullptr;
+        }
+        channels.emplace_back(std::move(channel));
+    }
+    return Open(std::move(channels), address);
+}
+
+std::shared_ptr<RemoteZone> RemoteZone::ConnectSharedMemory(const std::string& name, uint32_t connections) {
+    std::vector<std::unique_ptr<Channel>> channels;
+    for (uint32_t i = 0; i < std::max(connections, 1u); i++) {
+        auto channel = ConnectSharedMemoryChannel(name);
+        if (channel == nullptr) {
+            LOG_ERROR("RemoteZone", "Failed to connect to remote zone on shared memory \"%s\".", name.c_str());
+            return nullptr;
+        }
+        channels.emplace_back(std::move(channel));
+    }
+    return Open(std::move(channels), "shared memory " + name);
+}
+
+std::shared_ptr<RemoteZone> RemoteZone::Open(std::vector<std::unique_ptr<Channel>> channels, const std::string& source) {
+    std::shared_ptr<RemoteZone> zone(new RemoteZone());
+    zone->_drain = std::make_shared<DrainSignal>();
+    for (size_t i = 0; i < channels.size(); i++) {
+        auto connection = std::make_shared<Connection>();
+        connection->drain = zone->_drain;
+        connection->channel = std::move(channels[i]);
+
+        // The server says which zone it serves before anything else.
+        MessageHeader header;
+        std::string payload;
+        Hello hello;
+        if (!ReadMessage(*connection->channel, header, payload) || header.type != MessageType::Hello) {
+            LOG_ERROR("RemoteZone", "\"%s\" doesn't serve a zone.", source.c_str());
+            return nullptr;
+        }
+        MessageReader reader(payload.data(), payload.size());
+        if (!reader.ReadHello(hello) || hello.version != PROTOCOL_VERSION) {
+            LOG_ERROR("RemoteZone", "Zone served at \"%s\" speaks another protocol version.", source.c_str());
+            return nullptr;
+        }
+
+        if (i == 0) {
+            zone->_id = std::move(hello.zoneId);
+            zone->_workerCount = hello.workerCount;
+        } else if (hello.zoneId != zone->_id) {
+            LOG_ERROR("RemoteZone", "\"%s\" served zone \"%s\", then zone \"%s\".", source.c_str(), zone->_id.c_str(), hello.zoneId.c_str());
+            return nullptr;
+        }
+        zone->_connections.emplace_back(std::move(connection));
+    }
+
+    // Readers start once all connections are open, so a failed connect has no thread to join.
+    // They own their connection rather than the zone, which the destructor joins them with.
+    for (auto& connection : zone->_connections) {
+        connection->zoneId = zone->_id;
+        connection->reader = std::thread([connection]() { Read(connection); });
+    }
+
+    NAPA_DEBUG("RemoteZone", "Connected to zone \"%s\" at \"%s\" with %zu connections.",
+        zone->_id.c_str(), source.c_str(), zone->_connections.size());
+    return zone;
+}
+
+RemoteZone::~RemoteZone() {
+    for (auto& connection : _connections) {
+        Fail(*connection, NAPA_RESULT_REMOTE_CONNECTION_ERROR, "Remote zone was released");
+    }
+    for (auto& connection : _connections) {
+        if (!connection->reader.joinable()) {
+            continue;
+        }
+
+        // The last reference may be dropped by a result callback, on a reader thread which keeps its connection.
+        if (connection->reader.get_id() == std::this_thread::get_id()) {
+            connection->reader.detach();
+        } else {
+            connection->reader.join();
+        }
+    }
+}
+
+const std::string& RemoteZone::GetId() const {
+    return _id;
+}
+
+size_t RemoteZone::GetQueueLength() const {
+    size_t length = 0;
+    for (const auto& connection : _connections) {
+        length += connection->pendingCount.load();
+    }
+    return length;
+}
+
+uint32_t RemoteZone::GetWorkerCount() const {
+    return _recycled ? 0 : _workerCount;
+}
+
+void RemoteZone::Cancel(uint64_t token) {
+    // Calls with the token may have been sent on any connection.
+    MessageWriter writer(MessageType::Cancel, 0);
+    writer.WriteUInt64(token);
+    auto& message = writer.Finish();
+    for (auto& connection : _connections) {
+        std::lock_guard<std::mutex> lock(connection->writeLock);
+        (void)connection->channel->Write(message.data(), message.size());
+    }
+}
+
+void RemoteZone::Broadcast(const FunctionSpec& spec, const std::vector<uint32_t>& workerIds, BroadcastCallback callback) {
+    Send(MessageType::Broadcast, spec, workerIds, std::move(callback));
+}
+
+void RemoteZone::Execute(const FunctionSpec& spec, ExecuteCallback callback) {
+    Send(MessageType::Execute, spec, {}, std::move(callback));
+}
+
+void RemoteZone::ExecuteOnWorker(uint32_t workerId, const FunctionSpec& spec, ExecuteCallback callback) {
+    Send(MessageType::ExecuteOnWorker, spec, { workerId }, std::move(callback));
+}
+
+void RemoteZone::ExecuteBatch(const std::vector<FunctionSpec>& specs, ExecuteBatchCallback callback) {
+    if (specs.empty()) {
+        callback({});
+        return;
+    }
+
+    // Calls of a batch are pipelined like any others, only completion is batched.
+    auto results = BatchResults::Create(specs.size(), std::move(callback));
+    for (size_t i = 0; i < specs.size(); i++) {
+        Send(MessageType::Execute, specs[i], {}, results->CallbackAt(i));
+    }
+}
+
+void RemoteZone::ExecuteNative(NativeFunction, NativeCallback callback) {
+    callback(NAPA_RESULT_REMOTE_UNSUPPORTED);
+}
+
+void RemoteZone::GetHeapStatistics(HeapStatisticsCallback callback) {
+    callback({});
+}
+
+ZoneStats RemoteZone::GetStats() const {
+    ZoneStats stats;
+    stats.pendingTasks = GetQueueLength();
+    return stats;
+}
+
+std::vector<FunctionStats> RemoteZone::GetFunctionStats() const {
+    return {};
+}
+
+void RemoteZone::NotifyMemoryPressure(MemoryPressureLevel) {
+}
+
+void RemoteZone::StartProfiling(const std::vector<uint32_t>&, uint32_t) {
+}
+
+void RemoteZone::StopProfiling(CpuProfilesCallback callback) {
+    callback({});
+}
+
+ResultCode RemoteZone::Recycle() {
+    if (IsReaderThread()) {
+        return NAPA_RESULT_ZONE_RECYCLE_ERROR;
+    }
+
+    _recycled = true;
+    {
+        std::unique_lock<std::mutex> lock(_drain->lock);
+        _drain->drained.wait(lock, [this]() { return GetQueueLength() == 0; });
+    }
+    for (auto& connection : _connections) {
+        Fail(*connection, NAPA_RESULT_ZONE_RECYCLED, "Zone was recycled");
+    }
+    return NAPA_RESULT_SUCCESS;
+}
+
+void RemoteZone::Send(MessageType type, const FunctionSpec& spec, const std::vector<uint32_t>& workerIds, ExecuteCallback callback) {
+    if (_recycled) {
+        callback(MakeResult(NAPA_RESULT_ZONE_RECYCLED, "Zone was recycled"));
+        return;
+    }
+
+    // Shared objects live in the memory of this process.
+    if (spec.transportContext != nullptr && spec.transportContext->GetSharedCount() > 0) {
+        callback(MakeResult(NAPA_RESULT_REMOTE_UNSUPPORTED, "Shared objects can't be transported to a remote zone"));
+        return;
+    }
+
+    // The least loaded open connection takes the call.
+    Connection* connection = nullptr;
+    auto least = std::numeric_limits<size_t>::max();
+    for (auto& candidate : _connections) {
+        auto count = candidate->pendingCount.load();
+        if (count < least) {
+            std::lock_guard<std::mutex> lock(candidate->pendingLock);
+            if (candidate->open) {
+                connection = candidate.get();
+                least = count;
+            }
+        }
+    }
+    if (connection == nullptr) {
+        callback(MakeResult(NAPA_RESULT_REMOTE_CONNECTION_ERROR, "No connection to the remote zone is open"));
+        return;
+    }
+
+    auto requestId = _nextRequestId++;
+    MessageWriter writer(type, requestId);
+    if (type == MessageType::ExecuteOnWorker) {
+        writer.WriteUInt32(workerIds[0]);
+    } else if (type == MessageType::Broadcast) {
+        writer.WriteUInt32(static_cast<uint32_t>(workerIds.size()));
+        for (auto workerId : workerIds) {
+            writer.WriteUInt32(workerId);
+        }
+    }
+    writer.WriteSpec(spec);
+    auto& message = writer.Finish();
+    if (message.size() - HEADER_SIZE > MAX_MESSAGE_SIZE) {
+        callback(MakeResult(NAPA_RESULT_REMOTE_UNSUPPORTED, "Call is too large to send to a remote zone"));
+        return;
+    }
+
+    // The call waits for its result before it's written, which may come back before the write returns.
+    {
+        std::lock_guard<std::mutex> lock(connection->pendingLock);
+        if (!connection->open) {
+            callback(MakeResult(NAPA_RESULT_REMOTE_CONNECTION_ERROR, "The connection to the remote zone failed"));
+            return;
+        }
+        connection->pending.emplace(requestId, std::move(callback));
+        connection->pendingCount++;
+    }
+
+    bool written;
+    {
+        std::lock_guard<std::mutex> lock(connection->writeLock);
+        written = connection->channel->Write(message.data(), message.size());
+    }
+    if (!written) {
+        Fail(*connection, NAPA_RESULT_REMOTE_CONNECTION_ERROR, "The connection to the remote zone failed");
+    }
+}
+
+void RemoteZone::Read(const std::shared_ptr<Connection>& source) {
+    auto& connection = *source;
+    MessageHeader header;
+    std::string payload;
+    while (ReadMessage(*connection.channel, header, payload)) {
+        Result result;
+        MessageReader reader(payload.data(), payload.size());
+        if (header.type != MessageType::Result || !reader.ReadResult(result)) {
+            LOG_ERROR("RemoteZone", "Remote zone \"%s\" sent an invalid message.", connection.zoneId.c_str());
+            break;
+        }
+
+        ExecuteCallback callback;
+        {
+            std::lock_guard<std::mutex> lock(connection.pendingLock);
+            auto it = connection.pending.find(header.requestId);
+            if (it == connection.pending.end()) {
+                continue;
+            }
+            callback = std::move(it->second);
+            connection.pending.erase(it);
+
+            std::lock_guard<std::mutex> drainLock(connection.drain->lock);
+            connection.pendingCount--;
+        }
+        connection.drain->drained.notify_all();
+
+        callback(std::move(result));
+    }
+
+    Fail(connection, NAPA_RESULT_REMOTE_CONNECTION_ERROR, "The connection to the remote zone failed");
+}
+
+void RemoteZone::Fail(Connection& connection, ResultCode code, const char* message) {
+    std::unordered_map<uint64_t, ExecuteCallback> pending;
+    {
+        std::lock_guard<std::mutex> lock(connection.pendingLock);
+        if (connection.open) {
+            connection.open = false;
+            connection.channel->Shutdown();
+        }
+        pending.swap(connection.pending);
+    }
+
+    if (!pending.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(connection.drain->lock);
+            connection.pendingCount -= pending.size();
+        }
+        connection.drain->drained.notify_all();
+    }
+
+    for (auto& entry : pending) {
+        entry.second(MakeResult(code, message));
+    }
+}
+
+bool RemoteZone::IsReaderThread() const {
+    auto current = std::this_thread::get_id();
+    for (const auto& connection : _connections) {
+        if (connection->reader.get_id() == current) {
+            return true;
+        }
+    }
+    return false;
+}
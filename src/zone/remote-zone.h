@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "remote-protocol.h"
+#include "zone.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary>
+    ///     A zone of another process or host, served by a ZoneServer, whose calls are sent over a pool of connections,
+    ///     TCP connections or channels of a shared memory segment for a process of the same host.
+    ///     Calls are pipelined, each connection carries many calls at once and results come back in any order.
+    /// </summary>
+    /// <remarks>
+    ///     Only named functions of modules the remote zone can load are called, with marshalled arguments.
+    ///     Calls transporting shared objects fail with NAPA_RESULT_REMOTE_UNSUPPORTED, as do native functions.
+    ///     A failed connection is not reconnected, its calls fail with NAPA_RESULT_REMOTE_CONNECTION_ERROR
+    ///     and later calls use the other connections.
+    /// </remarks>
+    class RemoteZone : public Zone {
+    public:
+
+        /// <summary> Connects to a served zone. </summary>
+        /// <param name="address"> The address the zone is served on, like 'host:port'. </param>
+        /// <param name="connections"> The number of connections to open, at least 1. </param>
+        /// <returns> The remote zone, or nullptr if an address couldn't be connected to or doesn't serve a zone. </returns>
+        static std::shared_ptr<RemoteZone> Connect(const std::string& address, uint32_t connections);
+
+        /// <summary> Connects to a zone served by a process of the host on a shared memory segment. </summary>
+        /// <param name="name"> The name the zone is served on. </param>
+        /// <param name="connections"> The number of channels to open, at least 1, which each take a slot of the segment. </param>
+        /// <returns> The remote zone, or nullptr if no process serves the name or its slots are taken. </returns>
+        static std::shared_ptr<RemoteZone> ConnectSharedMemory(const std::string& name, uint32_t connections);
+
+        /// <summary> Fails the calls still waiting for a result, and closes the connections. </summary>
+        virtual ~RemoteZone();
+
+        /// <see cref="Zone::GetId" />
+        virtual const std::string& GetId() const override;
+
+        /// <summary> Get the number of calls sent and waiting for a result, since the remote queue isn't known. </summary>
+        virtual size_t GetQueueLength() const override;
+
+        /// <summary> Get the number of workers of the remote zone when it was connected to. </summary>
+        virtual uint32_t GetWorkerCount() const override;
+
+        /// <see cref="Zone::Cancel" />
+        virtual void Cancel(uint64_t token) override;
+
+        /// <see cref="Zone::Broadcast" />
+        virtual void Broadcast(const FunctionSpec& spec, const std::vector<uint32_t>& workerIds, BroadcastCallback callback) override;
+
+        /// <see cref="Zone::Execute" />
+        virtual void Execute(const FunctionSpec& spec, ExecuteCallback callback) override;
+
+        /// <see cref="Zone::ExecuteOnWorker" />
+        virtual void ExecuteOnWorker(uint32_t workerId, const FunctionSpec& spec, ExecuteCallback callback) override;
+
+        /// <see cref="Zone::ExecuteBatch" />
+        virtual void ExecuteBatch(const std::vector<FunctionSpec>& specs, ExecuteBatchCallback callback) override;
+
+        /// <summary> Native functions can't be sent to another process, the callback gets NAPA_RESULT_REMOTE_UNSUPPORTED. </summary>
+        virtual void ExecuteNative(NativeFunction function, NativeCallback callback) override;
+
+        /// <summary> The heap of remote workers isn't reported, the callback gets no statistics. </summary>
+        virtual void GetHeapStatistics(HeapStatisticsCallback callback) override;
+
+        /// <summary> Reports the calls waiting for a result as pending tasks, without worker stats. </summary>
+        virtual ZoneStats GetStats() const override;
+
+        /// <summary> Calls are counted by the zone of the remote process, there are no statistics here. </summary>
+        virtual std::vector<FunctionStats> GetFunctionStats() const override;
+
+        /// <summary> Memory pressure is left to the remote process. </summary>
+        virtual void NotifyMemoryPressure(MemoryPressureLevel level) override;
+
+        /// <summary> Remote workers are profiled in their own process. </summary>
+        virtual void StartProfiling(const std::vector<uint32_t>& workerIds, uint32_t samplingInterval) override;
+
+        /// <summary> Remote workers are profiled in their own process, the callback gets no profiles. </summary>
+        virtual void StopProfiling(CpuProfilesCallback callback) override;
+
+        /// <summary>
+        ///     Waits for the calls waiting for a result, then closes the connections. The remote zone itself keeps running.
+        ///     Later calls fail with NAPA_RESULT_ZONE_RECYCLED.
+        /// </summary>
+        /// <returns> NAPA_RESULT_ZONE_RECYCLE_ERROR if called from a result callback, which would wait for itself. </returns>
+        virtual ResultCode Recycle() override;
+
+    private:
+        struct Connection;
+        struct DrainSignal;
+
+        RemoteZone() = default;
+
+        /// <summary> Opens a zone on connected channels, once each says which zone it serves. </summary>
+        /// <param name="source"> Where the channels connect to, for logging. </param>
+        static std::shared_ptr<RemoteZone> Open(std::vector<std::unique_ptr<remote::Channel>> channels, const std::string& source);
+
+        /// <summary> Sends a request on the least loaded connection, the callback is triggered with its result. </summary>
+        void Send(remote::MessageType type, const FunctionSpec& spec, const std::vector<uint32_t>& workerIds, ExecuteCallback callback);
+
+        /// <summary> Reads results of a connection until it fails, on a thread that may outlive the zone. </summary>
+        static void Read(const std::shared_ptr<Connection>& connection);
+
+        /// <summary> Closes a connection, and fails the calls waiting for its results. </summary>
+        static void Fail(Connection& connection, ResultCode code, const char* message);
+
+        /// <summary> Tell if the calling thread reads results of a connection. </summary>
+        bool IsReaderThread() const;
+
+        std::string _id;
+        uint32_t _workerCount = 0;
+        std::vector<std::shared_ptr<Connection>> _connections;
+
+        /// <summary> Signaled as calls complete, for Recycle to wait on. </summary>
+        std::shared_ptr<DrainSignal> _drain;
+
+        std::atomic<uint64_t> _nextRequestId { 1 };
+        std::atomic<bool> _recycled { false };
+    };
+}
+}
@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "result-cache.h"
+
+#include <napa/providers/metric.h>
+
+#include <iterator>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> Appends a length prefixed field, so different splits of the same bytes make different keys. </summary>
+    void AppendField(std::string& key, const char* data, size_t size) {
+        key.append(std::to_string(size));
+        key.push_back(':');
+        key.append(data, size);
+    }
+}
+
+ResultCache::ResultCache(std::string id, size_t capacity) : _id(std::move(id)), _capacity(capacity) {}
+
+std::string ResultCache::MakeKey(const FunctionSpec& spec) {
+    std::string key;
+    AppendField(key, spec.module.data, spec.module.size);
+    AppendField(key, spec.function.data, spec.function.size);
+
+    if (spec.options.cache_key != 0) {
+        key.push_back('#');
+        key.append(std::to_string(spec.options.cache_key));
+    } else if (!spec.ownedArguments.empty()) {
+        for (const auto& argument : spec.ownedArguments) {
+            AppendField(key, argument.data(), argument.size());
+        }
+    } else {
+        for (const auto& argument : spec.arguments) {
+            AppendField(key, argument.data, argument.size);
+        }
+    }
+    return key;
+}
+
+bool ResultCache::Get(const std::string& key, std::string& value) {
+    bool hit = false;
+    bool expired = false;
+    size_t bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto iter = _index.find(key);
+        if (iter != _index.end()) {
+            if (iter->second->expireTime <= Clock::now()) {
+                expired = true;
+                _statistics.expirations++;
+                EraseLocked(iter->second);
+            } else {
+                hit = true;
+                _entries.splice(_entries.begin(), _entries, iter->second);
+                value = iter->second->value;
+            }
+        }
+
+        if (hit) {
+            _statistics.hits++;
+        } else {
+            _statistics.misses++;
+        }
+        bytes = _statistics.bytes;
+    }
+
+    ReportMetrics(hit ? 1 : 0, hit ? 0 : 1, 0, expired ? 1 : 0, bytes);
+    return hit;
+}
+
+void ResultCache::Put(const std::string& key, std::string value, std::chrono::milliseconds ttl) {
+    // A result that can't fit would evict everything else and still not be cached.
+    auto size = key.size() + value.size();
+    if (size > _capacity) {
+        return;
+    }
+
+    uint64_t evictions = 0;
+    size_t bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto iter = _index.find(key);
+        if (iter != _index.end()) {
+            EraseLocked(iter->second);
+        }
+
+        while (_statistics.bytes + size > _capacity) {
+            EraseLocked(std::prev(_entries.end()));
+            evictions++;
+        }
+
+        _entries.push_front({ key, std::move(value), Clock::now() + ttl });
+        _index.emplace(key, _entries.begin());
+        _statistics.entries++;
+        _statistics.bytes += size;
+        _statistics.evictions += evictions;
+        bytes = _statistics.bytes;
+    }
+
+    ReportMetrics(0, 0, evictions, 0, bytes);
+}
+
+void ResultCache::Clear() {
+    std::lock_guard<std::mutex> lock(_lock);
+    _entries.clear();
+    _index.clear();
+    _statistics.entries = 0;
+    _statistics.bytes = 0;
+}
+
+ResultCacheStatistics ResultCache::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _statistics;
+}
+
+void ResultCache::EraseLocked(EntryList::iterator entry) {
+    _statistics.entries--;
+    _statistics.bytes -= entry->key.size() + entry->value.size();
+    _index.erase(entry->key);
+    _entries.erase(entry);
+}
+
+void ResultCache::ReportMetrics(uint64_t hits, uint64_t misses, uint64_t evictions, uint64_t expirations, size_t bytes) {
+    static const char* dimensionNames[] = { "Zone" };
+    static auto hitsMetric = napa::providers::GetMetricProvider().GetMetric(
+        "Napa", "ResultCacheHits", napa::providers::MetricType::Rate, 1, dimensionNames);
+    static auto missesMetric = napa::providers::GetMetricProvider().GetMetric(
+        "Napa", "ResultCacheMisses", napa::providers::MetricType::Rate, 1, dimensionNames);
+    static auto evictionsMetric = napa::providers::GetMetricProvider().GetMetric(
+        "Napa", "ResultCacheEvictions", napa::providers::MetricType::Rate, 1, dimensionNames);
+    static auto expirationsMetric = napa::providers::GetMetricProvider().GetMetric(
+        "Napa", "ResultCacheExpirations", napa::providers::MetricType::Rate, 1, dimensionNames);
+    static auto bytesMetric = napa::providers::GetMetricProvider().GetMetric(
+        "Napa", "ResultCacheBytes", napa::providers::MetricType::Number, 1, dimensionNames);
+
+    const char* dimensionValues[] = { _id.c_str() };
+    if (hitsMetric != nullptr && hits > 0) {
+        hitsMetric->Increment(hits, 1, dimensionValues);
+    }
+    if (missesMetric != nullptr && misses > 0) {
+        missesMetric->Increment(misses, 1, dimensionValues);
+    }
+    if (evictionsMetric != nullptr && evictions > 0) {
+        evictionsMetric->Increment(evictions, 1, dimensionValues);
+    }
+    if (expirationsMetric != nullptr && expirations > 0) {
+        expirationsMetric->Increment(expirations, 1, dimensionValues);
+    }
+    if (bytesMetric != nullptr) {
+        bytesMetric->Set(static_cast<int64_t>(bytes), 1, dimensionValues);
+    }
+}
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Counters of a result cache. </summary>
+    struct ResultCacheStatistics {
+
+        /// <summary> Lookups that found a live result. </summary>
+        uint64_t hits = 0;
+
+        /// <summary> Lookups that found no result, or an expired one. </summary>
+        uint64_t misses = 0;
+
+        /// <summary> Results dropped to make room for newer ones. </summary>
+        uint64_t evictions = 0;
+
+        /// <summary> Results dropped once their time to live passed. </summary>
+        uint64_t expirations = 0;
+
+        /// <summary> The number of cached results. </summary>
+        size_t entries = 0;
+
+        /// <summary> The bytes held by the cached keys and results. </summary>
+        size_t bytes = 0;
+    };
+
+    /// <summary>
+    ///     Bounded cache of the marshalled results of zone calls, so repeated calls to pure functions return
+    ///     without being scheduled on a worker. The least recently used results are evicted once the cache is full.
+    /// </summary>
+    class ResultCache {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="id"> The id reported as the dimension of the cache metrics. </param>
+        /// <param name="capacity"> The bytes of keys and results the cache holds at most, 0 to cache nothing. </param>
+        ResultCache(std::string id, size_t capacity);
+
+        /// <summary> Non-copyable. </summary>
+        ResultCache(const ResultCache&) = delete;
+        ResultCache& operator=(const ResultCache&) = delete;
+
+        /// <summary> Returns the cache key of a call, from the key in its options or its module, function and arguments. </summary>
+        static std::string MakeKey(const FunctionSpec& spec);
+
+        /// <summary> Looks up a result. </summary>
+        /// <param name="key"> The cache key. </param>
+        /// <param name="value"> Receives the marshalled result on a hit. </param>
+        /// <returns> True if a live result was found. </returns>
+        bool Get(const std::string& key, std::string& value);
+
+        /// <summary> Caches a result, evicting the least recently used results it doesn't fit with. </summary>
+        /// <param name="key"> The cache key. </param>
+        /// <param name="value"> The marshalled result. </param>
+        /// <param name="ttl"> How long the result is returned for. </param>
+        void Put(const std::string& key, std::string value, std::chrono::milliseconds ttl);
+
+        /// <summary> Drops all results. </summary>
+        void Clear();
+
+        /// <summary> Returns the counters of the cache. </summary>
+        ResultCacheStatistics GetStatistics() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Entry {
+            std::string key;
+            std::string value;
+            Clock::time_point expireTime;
+        };
+        using EntryList = std::list<Entry>;
+
+        /// <summary> Drops an entry. Needs the lock. </summary>
+        void EraseLocked(EntryList::iterator entry);
+
+        /// <summary> Reports counter changes to the metric provider, with the cache id as dimension. </summary>
+        void ReportMetrics(uint64_t hits, uint64_t misses, uint64_t evictions, uint64_t expirations, size_t bytes);
+
+        std::string _id;
+        size_t _capacity;
+
+        mutable std::mutex _lock;
+
+        /// <summary> Entries from the most to the least recently used. </summary>
+        EntryList _entries;
+        std::unordered_map<std::string, EntryList::iterator> _index;
+        ResultCacheStatistics _statistics;
+    };
+}
+}
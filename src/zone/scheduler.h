@@ -3,18 +3,31 @@
 
 #pragma once
 
+#include "atomic-bitmap.h"
+#include "fair-task-queue.h"
+#include "mpmc-queue.h"
 #include "schedule-phase.h"
 #include "simple-thread-pool.h"
 #include "task.h"
+#include "timer.h"
+#include "trace-recorder.h"
 #include "worker.h"
 
+#include <platform/tracepoint.h>
 #include <settings/settings.h>
 
 #include <napa/log.h>
+#include <napa/providers/metric.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <thread>
 #include <vector>
@@ -22,7 +35,68 @@
 namespace napa {
 namespace zone {
 
+    /// <summary> The capacity of the pending queue used by the lock-free scheduler. </summary>
+    constexpr size_t LOCK_FREE_SCHEDULER_QUEUE_CAPACITY = 4096;
+
+    /// <summary> The capacity of each per worker queue used by the work-stealing scheduler. </summary>
+    constexpr size_t WORK_STEALING_SCHEDULER_QUEUE_CAPACITY = 1024;
+
+    /// <summary> Maps a routing key to one of a number of workers with jump consistent hashing. </summary>
+    /// <remarks> When the number of workers grows, only the keys that move to the new workers change worker. </remarks>
+    inline WorkerId GetRoutedWorker(uint64_t routingKey, uint32_t workerCount) {
+        int64_t worker = -1;
+        int64_t next = 0;
+        while (next < static_cast<int64_t>(workerCount)) {
+            worker = next;
+            routingKey = routingKey * 2862933555777941757ULL + 1;
+            next = static_cast<int64_t>((worker + 1) * (static_cast<double>(1LL << 31) / static_cast<double>((routingKey >> 33) + 1)));
+        }
+        return static_cast<WorkerId>(worker);
+    }
+
+    /// <summary> Creates the task a broadcast runs on one worker. </summary>
+    /// <param name="workerCount">
+    ///     The number of workers the broadcast is scheduled on, or 0 when it is replayed on a worker that started later.
+    /// </param>
+    using BroadcastTaskFactory = std::function<std::shared_ptr<Task>(uint32_t workerCount)>;
+
     /// <summary> The scheduler is responsible for assigning tasks to workers. </summary>
+    /// <remarks>
+    ///     With SchedulerType::Synchronized all book-keeping is serialized on a single synchronizer thread.
+    ///     With SchedulerType::LockFree callers claim an idle worker from an atomic bitmap and dispatch to it
+    ///     directly, or push the task to a lock-free pending queue that idle workers drain by themselves.
+    ///     SchedulerType::WorkStealing works the same way but keeps one pending queue per worker. Workers drain
+    ///     their own queue first and steal from their peers when it is empty. Tasks scheduled on a specific
+    ///     worker (async completions, broadcasts, immediate tasks) are pinned and never stolen.
+    ///
+    ///     With SchedulerType::Synchronized the number of workers can change between minWorkers and maxWorkers:
+    ///     a worker is started when the non-scheduled queue grows beyond scaleUpQueueDepth, and a worker that
+    ///     stayed idle for workerIdleTimeout is retired. Workers that still have pinned work are never retired.
+    ///
+    ///     With maxQueueLength set, tasks scheduled by Schedule() that wait for a worker are bounded and the
+    ///     overloadPolicy decides what happens to a new task when the queue is full. Pinned tasks are not counted.
+    ///
+    ///     With maxTasksPerWorker or maxHeapBeforeRecycle set, the synchronized scheduler recycles workers that
+    ///     reached either limit: a replacement is started in the background and replays the broadcasts, and it
+    ///     takes over the worker's slot once it is ready and the old worker is idle without pinned work.
+    ///
+    ///     In synchronized mode, waiting tasks are queued per tenant and tenants take turns by deficit round robin,
+    ///     each dispatched as many tasks per turn as its weight in tenantWeights. The lock-free modes ignore tenants.
+    ///
+    ///     A task with a routing key prefers the worker its key hashes to. In synchronized mode it waits for that
+    ///     worker unless routingImbalance tasks are waiting for it already, the lock-free modes only use the
+    ///     preferred worker when it is idle.
+    ///
+    ///     Workers count the calls they dispatched until their results are resolved or rejected, which may be long
+    ///     after the worker became idle when a call returned a promise. In synchronized mode new tasks go to the idle
+    ///     worker with the fewest calls in flight, and a worker with maxInFlightPerWorker calls in flight stays idle
+    ///     without taking tasks until one of them finishes.
+    ///
+    ///     With stuckWorkerThreshold set, the synchronized scheduler checks for workers that ran the same task for
+    ///     longer than the threshold. A stuck worker gives up the task dispatched to it that didn't start yet and its
+    ///     routed tasks, which go back to the non-scheduled queue, and new routed tasks skip it until it is idle again.
+    ///     With recycleStuckWorkers set, its JavaScript is terminated and it is recycled.
+    /// </remarks>
     template <typename WorkerType>
     class SchedulerImpl {
     public:
@@ -32,9 +106,16 @@ namespace zone {
         /// <param name="workerSetupCallback"> Callback to setup the isolate after worker created its isolate. </param>
         SchedulerImpl(const settings::ZoneSettings& settings, std::function<void(WorkerId)> workerSetupCallback);
 
-        /// <summary> Destructor. Waits for all tasks to finish. </summary>
+        /// <summary> Destructor. Waits for all tasks to finish, see Shutdown. </summary>
         ~SchedulerImpl();
 
+        /// <summary>
+        ///     Dispatches the waiting tasks, waits for all tasks to finish and destroys the workers.
+        ///     It is called by the destructor, or before by the owner to free the workers while others still hold the scheduler.
+        ///     The scheduler takes no tasks afterwards, calling it again does nothing.
+        /// </summary>
+        void Shutdown();
+
         /// <summary> Schedules the task on a single worker. </summary>
         /// <param name="task"> Task to schedule. </param>
         void Schedule(std::shared_ptr<Task> task);
@@ -51,6 +132,19 @@ namespace zone {
                               std::shared_ptr<Task> task,
                               SchedulePhase phase = SchedulePhase::DefaultPhase);
 
+        /// <summary> Schedules the task on a worker retained by RetainWorker, i.e. the completion of its async work. </summary>
+        /// <param name="workerId"> The id of the retained worker. </param>
+        /// <param name="task"> Task to schedule, it releases the worker when it runs. </param>
+        /// <param name="phase"> Which phase of the task, like Immediate or Normal. </param>
+        /// <remarks>
+        /// A retained worker is neither retired nor replaced, so the task joins its queue from any thread
+        /// without going through the synchronizer. An idle worker stays in the idle list meanwhile,
+        /// a call dispatched to it waits for the task to finish.
+        /// </remarks>
+        void ScheduleOnRetainedWorker(WorkerId workerId,
+                                      std::shared_ptr<Task> task,
+                                      SchedulePhase phase = SchedulePhase::DefaultPhase);
+
         /// <summary> Schedules the task on all workers. </summary>
         /// <param name="task"> Task to schedule. </param>
         /// <remarks>
@@ -59,16 +153,250 @@ namespace zone {
         /// </remarks>
         void ScheduleOnAllWorkers(std::shared_ptr<Task> task);
 
+        /// <summary> Schedules a task created by the factory on each worker. </summary>
+        /// <param name="createTask"> Creates the task for one worker. </param>
+        /// <remarks>
+        /// All tasks of the broadcast are created before any of them is scheduled.
+        /// If the number of workers can change, the factory is kept and replayed on workers that start later,
+        /// before they serve any other task.
+        /// </remarks>
+        void ScheduleOnAllWorkers(BroadcastTaskFactory createTask);
+
+        /// <summary> Schedules a task created by the factory on each of the given workers. </summary>
+        /// <param name="workerIds"> The ids of the workers, ids without a running worker are skipped. </param>
+        /// <param name="createTask"> Creates the task for one worker. </param>
+        /// <remarks>
+        /// Like ScheduleOnAllWorkers, the factory is replayed on the given workers when they start later.
+        /// If none of them is running, the factory is called once with a worker count of 0 and the task
+        /// is not scheduled, so the caller still learns that the broadcast is done.
+        /// </remarks>
+        void ScheduleOnWorkers(std::vector<WorkerId> workerIds, BroadcastTaskFactory createTask);
+
+        /// <summary> Schedules a task created by the factory on each running worker, ahead of their queued tasks. </summary>
+        /// <param name="createTask"> Creates the task for one worker. </param>
+        /// <remarks> Unlike broadcasts, the tasks are not replayed on workers that start later. </remarks>
+        void ScheduleOnRunningWorkers(BroadcastTaskFactory createTask);
+
+        /// <summary> Prevents a worker to be retired until a matching ReleaseWorker call. </summary>
+        /// <remarks> Called from the worker itself before it hands out work that will schedule back on it. </remarks>
+        void RetainWorker(WorkerId workerId);
+
+        /// <summary> Releases a worker retained by RetainWorker. </summary>
+        /// <remarks> Called from the pinned task that completes the work, while it runs on the worker. </remarks>
+        void ReleaseWorker(WorkerId workerId);
+
+        /// <summary> Counts a call dispatched by a worker as in flight, until a matching OnCallFinished call. </summary>
+        /// <remarks> Called from the worker itself before it runs the call. </remarks>
+        void OnCallDispatched(WorkerId workerId);
+
+        /// <summary> Counts a call counted by OnCallDispatched out once its result is resolved or rejected. </summary>
+        /// <remarks> Called from any thread, i.e. from the caller's thread when the call is cancelled. </remarks>
+        void OnCallFinished(WorkerId workerId);
+
+        /// <summary> Returns the number of calls dispatched by a worker whose results are still pending. </summary>
+        uint32_t GetInFlightCount(WorkerId workerId) const;
+
+        /// <summary> Returns the number of workers that are currently running. </summary>
+        uint32_t GetWorkerCount() const;
+
+        /// <summary> Returns the maximum number of workers, worker ids are below it. </summary>
+        uint32_t GetMaxWorkerCount() const;
+
+        /// <summary> Returns the number of tasks scheduled by Schedule() that are waiting for a worker. </summary>
+        size_t GetQueueLength() const;
+
+        /// <summary> Returns the number of tasks waiting for an idle worker and the counters of the running workers. </summary>
+        /// <remarks> In synchronized mode it waits for the synchronizer, where the waiting tasks are counted exactly. </remarks>
+        ZoneStats GetStats();
+
     private:
 
+        /// <summary> Applies the overload policy on the calling thread before a task is scheduled. </summary>
+        /// <returns> False if the task was rejected. </returns>
+        /// <remarks>
+        /// With OverloadPolicy::Block the caller waits here and reserves a slot. In synchronized mode the other
+        /// policies are applied on the synchronizer thread, where the queue length is exact.
+        /// </remarks>
+        bool AdmitTask(const std::shared_ptr<Task>& task);
+
+        /// <summary> Synchronized mode: counts a task that is about to wait for a worker, applying the overload policy. </summary>
+        /// <returns> False if the task was rejected. </returns>
+        bool AdmitNonScheduledTask(const std::shared_ptr<Task>& task);
+
+        /// <summary> Synchronized mode: rejects the oldest waiting task to make room for a new one. </summary>
+        void DropOldestTask();
+
+        /// <summary> Synchronized mode: takes a worker off the idle list and schedules the task on it. </summary>
+        void ScheduleOnIdleWorker(WorkerId workerId, std::shared_ptr<Task> task);
+
+        /// <summary> Synchronized mode: returns true if a worker reached maxInFlightPerWorker or is shedding its load. </summary>
+        bool IsSaturated(WorkerId workerId) const;
+
+        /// <summary> Returns true if a worker has pinned work or calls in flight, which must finish on it. </summary>
+        bool HasPinnedWork(WorkerId workerId) const;
+
+        /// <summary> Synchronized mode: gets the idle worker with the fewest calls in flight that isn't saturated. </summary>
+        /// <returns> False if there is no such worker. </returns>
+        bool TryGetLeastLoadedIdleWorker(WorkerId& workerId) const;
+
+        /// <summary>
+        ///     Synchronized mode: hands the next waiting task to a worker that became available,
+        ///     or puts the worker in the idle list if there is none or the worker is saturated.
+        /// </summary>
+        void DispatchToWorker(WorkerId workerId);
+
+        /// <summary> Gets the running worker a task is routed to. </summary>
+        /// <returns> False if the task has no routing key or its worker is not running. </returns>
+        bool TryGetPreferredWorker(const Task& task, WorkerId& workerId) const;
+
+        /// <summary> Accounts for a task that left the queue and wakes up a blocked caller. </summary>
+        void OnTaskDequeued();
+
+        /// <summary> Returns true if callers block while the queue is full. </summary>
+        bool IsBlockingAdmission() const;
+
+        /// <summary> Creates a worker for a slot, with the broadcasts to replay queued. </summary>
+        /// <param name="generation"> Identifies the worker in its idle notifications. </param>
+        std::unique_ptr<WorkerType> CreateWorker(WorkerId workerId, uint64_t generation);
+
+        /// <summary> Creates and starts a worker in an empty slot. </summary>
+        void StartWorker(WorkerId workerId);
+
+        /// <summary> Recycling: starts bootstrapping the replacement of a worker that reached its limits. </summary>
+        void StartReplacement(WorkerId workerId);
+
+        /// <summary> Recycling: disposes the idle worker of a slot and puts its ready replacement in the slot. </summary>
+        void SwapReplacement(WorkerId workerId);
+
+        /// <summary> Returns true if workers are recycled. </summary>
+        bool IsRecycling() const;
+
+        /// <summary> Stuck workers: moves the waiting tasks of workers that ran a task for too long to other workers. </summary>
+        void CheckStuckWorkers();
+
+        /// <summary> Stuck workers: puts the tasks waiting for a worker back into the non-scheduled queue. </summary>
+        void RerouteTasks(WorkerId workerId);
+
+        /// <summary> Elastic mode: starts a worker if the non-scheduled queue is too deep. </summary>
+        void ScaleUpIfNeeded();
+
+        /// <summary> Elastic mode: arms the timer for retiring idle workers. </summary>
+        void ScaleDownLater();
+
+        /// <summary> Elastic mode: retires workers that stayed idle long enough. </summary>
+        void RetireIdleWorkers();
+
+        /// <summary> Returns true if the number of workers can change. </summary>
+        bool IsElastic() const;
+
         /// <summary> The logic invoked when a worker is idle. </summary>
-        void IdleWorkerNotificationCallback(WorkerId workerId);
+        /// <param name="generation"> The generation of the notifying worker, telling it from its replacement. </param>
+        void IdleWorkerNotificationCallback(WorkerId workerId, uint64_t generation);
+
+        /// <summary> Lock-free mode: puts a task into the pending queue, spilling to the overflow queue when full. </summary>
+        void PushPendingTask(std::shared_ptr<Task> task);
+
+        /// <summary> Lock-free mode: pops a task for a worker, preferring its own pending queue. </summary>
+        bool TryPopPendingTask(WorkerId workerId, std::shared_ptr<Task>& task);
+
+        /// <summary> Lock-free mode: returns true if there may be pending tasks. </summary>
+        bool HasPendingTasks() const;
+
+        /// <summary> Lock-free mode: hands pending tasks to idle workers until either runs out. </summary>
+        void DispatchPendingTasks();
+
+        /// <summary> The settings used for starting workers. </summary>
+        settings::ZoneSettings _settings;
+
+        /// <summary> Callback to setup the isolate of a new worker. </summary>
+        std::function<void(WorkerId)> _workerSetupCallback;
+
+        /// <summary> The scheduler of the worker running on the current thread, null on other threads. </summary>
+        static thread_local const SchedulerImpl* _currentScheduler;
+
+        /// <summary> The id of the worker running on the current thread. </summary>
+        static thread_local WorkerId _currentWorkerId;
+
+        /// <summary> The workers that are used for running the tasks, null for slots without a running worker. </summary>
+        std::vector<std::unique_ptr<WorkerType>> _workers;
+
+        /// <summary> The lower bound of running workers. </summary>
+        uint32_t _minWorkers;
+
+        /// <summary> The upper bound of running workers, which is also the number of worker slots. </summary>
+        uint32_t _maxWorkers;
+
+        /// <summary> The number of running workers. </summary>
+        std::atomic<uint32_t> _workerCount;
+
+        /// <summary> Number of pinned works per worker that will schedule back on it. </summary>
+        std::unique_ptr<std::atomic<uint32_t>[]> _workerRetainCounts;
 
-        /// <summary> The workers that are used for running the tasks. </summary>
-        std::vector<WorkerType> _workers;
+        /// <summary> Number of calls dispatched per worker whose results are still pending. </summary>
+        std::unique_ptr<std::atomic<uint32_t>[]> _workerInFlightCounts;
+
+        /// <summary> Synchronized mode: set while shutting down, so saturated workers drain the waiting tasks. </summary>
+        bool _inFlightLimitLifted;
+
+        /// <summary> Elastic mode: flags of workers that started but didn't become idle yet. </summary>
+        std::vector<bool> _startingWorkersFlags;
+
+        /// <summary> Elastic mode: number of workers that started but didn't become idle yet. </summary>
+        uint32_t _startingWorkers;
+
+        /// <summary> Elastic mode: the time each idle worker became idle. </summary>
+        std::vector<std::chrono::steady_clock::time_point> _idleSince;
+
+        /// <summary> The generation of the worker running in each slot, each started worker gets a new one. </summary>
+        std::vector<uint64_t> _workerGenerations;
+
+        /// <summary> The generation given to the last started worker. </summary>
+        uint64_t _lastGeneration;
+
+        /// <summary> Recycling: replacements being bootstrapped, null for slots whose worker isn't being replaced. </summary>
+        std::vector<std::unique_ptr<WorkerType>> _replacements;
+
+        /// <summary> Recycling: the generation of the replacement of each slot. </summary>
+        std::vector<uint64_t> _replacementGenerations;
+
+        /// <summary> Recycling: whether the replacement of each slot finished bootstrapping. </summary>
+        std::vector<bool> _replacementsReady;
+
+        /// <summary> A broadcast replayed on new workers. </summary>
+        struct BroadcastRecord {
+            BroadcastTaskFactory createTask;
+
+            /// <summary> The workers it targets, all workers if empty. </summary>
+            std::vector<WorkerId> workerIds;
+        };
+
+        /// <summary> Elastic and recycling modes: broadcasts to replay on new workers, in the order they were scheduled. </summary>
+        std::vector<BroadcastRecord> _broadcastHistory;
+
+        /// <summary> Elastic mode: timer for retiring idle workers. </summary>
+        std::unique_ptr<Timer> _scaleDownTimer;
+
+        /// <summary> Elastic mode: whether the scale down timer is armed. </summary>
+        bool _scaleDownArmed;
+
+        /// <summary> Stuck workers: timer for checking the workers, re-armed after each check. </summary>
+        std::unique_ptr<Timer> _stuckWorkerTimer;
+
+        /// <summary> Stuck workers: whether each worker was found stuck and didn't become idle since. </summary>
+        std::vector<bool> _stuckWorkers;
+
+        /// <summary> Stuck workers: the last task dispatched to each worker by the scheduler, which may still be queued. </summary>
+        std::vector<std::weak_ptr<Task>> _dispatchedTasks;
 
         /// <summary> New tasks that weren't assigned to a specific worker. </summary>
-        std::queue<std::shared_ptr<Task>> _nonScheduledTasks;
+        /// <remarks>
+        ///     Tenants take turns, within a tenant highest priority first, earliest deadline first within a priority
+        ///     and FIFO otherwise.
+        /// </remarks>
+        FairTaskQueue _nonScheduledTasks;
+
+        /// <summary> Routed tasks waiting for their preferred worker, one FIFO queue per worker. </summary>
+        std::vector<std::queue<std::shared_ptr<Task>>> _routedTasks;
 
         /// <summary> List of idle workers, used when assigning non scheduled tasks. </summary>
         std::list<WorkerId> _idleWorkers;
@@ -84,70 +412,339 @@ namespace zone {
 
         /// <summary> Tasks being scheduled but not yet dispatched to worker or put into non-scheduled queue. </summary>
         std::atomic<size_t> _beingScheduled;
+
+        /// <summary> Returns true if the scheduler runs in lock-free or work-stealing mode. </summary>
+        bool IsLockFree() const;
+
+        /// <summary> Synchronized mode: returns the number of non-scheduled and routed tasks. </summary>
+        size_t GetPendingTaskCount() const;
+
+        /// <summary> Synchronized mode: reports the number of pending tasks, per tenant too, to the metric provider at most once a second. </summary>
+        void ReportPendingTasks();
+
+        /// <summary> Synchronized mode: the time of the last pending tasks report. </summary>
+        std::chrono::steady_clock::time_point _pendingTasksReportTime;
+
+        /// <summary>
+        ///     Lock-free mode: pending tasks. Holds a single shared queue in lock-free mode, one queue per worker
+        ///     in work-stealing mode, and is empty when the scheduler runs in synchronized mode.
+        /// </summary>
+        std::vector<std::unique_ptr<MpmcQueue<std::shared_ptr<Task>>>> _pendingQueues;
+
+        /// <summary> Work-stealing mode: round robin counter for picking the queue of a new task. </summary>
+        std::atomic<size_t> _nextPendingQueue;
+
+        /// <summary> Lock-free mode: bit i is set when worker i is idle. </summary>
+        AtomicBitmap _idleWorkersBitmap;
+
+        /// <summary> Lock-free mode: tasks that didn't fit into the pending queue. </summary>
+        std::queue<std::shared_ptr<Task>> _overflowTasks;
+
+        /// <summary> Lock-free mode: guards the overflow queue. </summary>
+        std::mutex _overflowLock;
+
+        /// <summary> Lock-free mode: number of tasks in the overflow queue, readable without the lock. </summary>
+        std::atomic<size_t> _overflowSize;
+
+        /// <summary> Idle notifications being processed on worker threads. </summary>
+        std::atomic<size_t> _activeNotifications;
+
+        /// <summary> The number of tasks scheduled by Schedule() that are waiting for a worker. </summary>
+        std::atomic<size_t> _queueLength;
+
+        /// <summary> Guards callers waiting for room in the queue. </summary>
+        std::mutex _admissionLock;
+
+        /// <summary> Signaled when a task left the queue. </summary>
+        std::condition_variable _admissionEvent;
+
+        /// <summary> Set once Shutdown started, while it waits for tasks to be dispatched and after. </summary>
+        std::atomic<bool> _draining;
+
+        /// <summary> Guards the destructor waiting for tasks to be dispatched. </summary>
+        std::mutex _drainLock;
+
+        /// <summary> Signaled while draining, when a task was dispatched or put into a queue. </summary>
+        std::condition_variable _drainEvent;
+
+        /// <summary> Wakes up the destructor while it waits for tasks to be dispatched. </summary>
+        void NotifyDrainProgress();
+
+        /// <summary> Blocks the destructor until a condition holds, checking it whenever it's notified and at least every millisecond. </summary>
+        /// <remarks> Progress that doesn't notify, like lock-free pending queues and idle notifications, is seen by the periodic check. </remarks>
+        template <typename Predicate>
+        void WaitForDrain(Predicate predicate);
+
+        /// <summary> Destroys workers on a thread each, so they all join their threads and dispose their isolates at once. </summary>
+        static void DestroyWorkers(std::vector<std::unique_ptr<WorkerType>>& workers);
     };
 
     typedef SchedulerImpl<Worker> Scheduler;
 
+    template <typename WorkerType>
+    thread_local const SchedulerImpl<WorkerType>* SchedulerImpl<WorkerType>::_currentScheduler = nullptr;
+
+    template <typename WorkerType>
+    thread_local WorkerId SchedulerImpl<WorkerType>::_currentWorkerId = 0;
+
     template <typename WorkerType>
     SchedulerImpl<WorkerType>::SchedulerImpl(const settings::ZoneSettings& settings, std::function<void(WorkerId)> workerSetupCallback) :
-        _idleWorkersFlags(settings.workers, _idleWorkers.end()),
-        _synchronizer(std::make_unique<SimpleThreadPool>(1)),
+        _settings(settings),
+        _workerSetupCallback(std::move(workerSetupCallback)),
+        _minWorkers(settings.workers),
+        _maxWorkers(settings.workers),
+        _workerCount(0),
+        _inFlightLimitLifted(false),
+        _startingWorkers(0),
+        _lastGeneration(0),
+        _scaleDownArmed(false),
+        _nonScheduledTasks(settings.tenantWeights),
         _shouldStop(false),
-        _beingScheduled(0) {
+        _beingScheduled(0),
+        _nextPendingQueue(0),
+        _idleWorkersBitmap(settings.workers),
+        _overflowSize(0),
+        _activeNotifications(0),
+        _queueLength(0),
+        _draining(false) {
 
-        _workers.reserve(settings.workers);
+        auto initialWorkers = settings.workers;
+        if (settings.scheduler == settings::SchedulerType::LockFree) {
+            _pendingQueues.emplace_back(
+                std::make_unique<MpmcQueue<std::shared_ptr<Task>>>(LOCK_FREE_SCHEDULER_QUEUE_CAPACITY));
+        } else if (settings.scheduler == settings::SchedulerType::WorkStealing) {
+            for (WorkerId i = 0; i < settings.workers; i++) {
+                _pendingQueues.emplace_back(
+                    std::make_unique<MpmcQueue<std::shared_ptr<Task>>>(WORK_STEALING_SCHEDULER_QUEUE_CAPACITY));
+            }
+        } else {
+            _synchronizer = std::make_unique<SimpleThreadPool>(1);
 
-        for (WorkerId i = 0; i < settings.workers; i++) {
-            _workers.emplace_back(i, settings, workerSetupCallback, [this](WorkerId workerId) {
-                IdleWorkerNotificationCallback(workerId);
-            });
-            _workers[i].Start();
+            // The initial number of workers is kept within the scaling bounds.
+            _minWorkers = settings.minWorkers > 0 ? settings.minWorkers : settings.workers;
+            _maxWorkers = std::max(settings.maxWorkers > 0 ? settings.maxWorkers : settings.workers, _minWorkers);
+            initialWorkers = std::min(std::max(settings.workers, _minWorkers), _maxWorkers);
+        }
+
+        if (IsLockFree() && (settings.minWorkers > 0 || settings.maxWorkers > 0)) {
+            LOG_WARNING("Scheduler", "Worker scaling requires the synchronized scheduler, using %u workers.", settings.workers);
+        }
+
+        if (IsLockFree() && (settings.maxTasksPerWorker > 0 || settings.maxHeapBeforeRecycle > 0)) {
+            LOG_WARNING("Scheduler", "Worker recycling requires the synchronized scheduler, workers are not recycled.");
+        }
+
+        if (IsLockFree() && !settings.tenantWeights.empty()) {
+            LOG_WARNING("Scheduler", "Tenant weights require the synchronized scheduler, tenants share a single queue.");
+        }
+
+        if (IsLockFree() && settings.maxInFlightPerWorker > 0) {
+            LOG_WARNING("Scheduler", "Limiting calls in flight requires the synchronized scheduler, the limit is ignored.");
+        }
+
+        if (IsLockFree() && settings.stuckWorkerThreshold > 0) {
+            LOG_WARNING("Scheduler", "Detecting stuck workers requires the synchronized scheduler, workers are not checked.");
+        }
+
+        if (IsLockFree() && settings.recycleOnHeapLimit) {
+            LOG_WARNING("Scheduler", "Recycling workers near their heap limit requires the synchronized scheduler, workers are not recycled.");
+        }
+
+        _workers.resize(_maxWorkers);
+        _routedTasks.resize(_maxWorkers);
+        _idleWorkersFlags.assign(_maxWorkers, _idleWorkers.end());
+        _workerGenerations.assign(_maxWorkers, 0);
+        if (IsRecycling()) {
+            _replacements.resize(_maxWorkers);
+            _replacementGenerations.assign(_maxWorkers, 0);
+            _replacementsReady.assign(_maxWorkers, false);
+        }
+        _workerRetainCounts = std::make_unique<std::atomic<uint32_t>[]>(_maxWorkers);
+        for (WorkerId i = 0; i < _maxWorkers; i++) {
+            _workerRetainCounts[i] = 0;
+        }
+        _workerInFlightCounts = std::make_unique<std::atomic<uint32_t>[]>(_maxWorkers);
+        for (WorkerId i = 0; i < _maxWorkers; i++) {
+            _workerInFlightCounts[i] = 0;
+        }
+
+        if (!IsLockFree() && settings.stuckWorkerThreshold > 0) {
+            _stuckWorkers.assign(_maxWorkers, false);
+            _dispatchedTasks.resize(_maxWorkers);
+            // Housekeeping timers have a quarter of their period as slack, they fire with other timers then.
+            auto stuckWorkerPeriod = std::max(settings.stuckWorkerThreshold / 2, 1u);
+            _stuckWorkerTimer = std::make_unique<Timer>([this]() {
+                _synchronizer->Execute([this]() { CheckStuckWorkers(); });
+            }, std::chrono::milliseconds(stuckWorkerPeriod), std::chrono::milliseconds(stuckWorkerPeriod / 4));
+            _stuckWorkerTimer->Start();
+        }
+
+        if (IsElastic()) {
+            _startingWorkersFlags.assign(_maxWorkers, false);
+            _idleSince.resize(_maxWorkers);
+            _scaleDownTimer = std::make_unique<Timer>([this]() {
+                _synchronizer->Execute([this]() { RetireIdleWorkers(); });
+            }, std::chrono::milliseconds(settings.workerIdleTimeout), std::chrono::milliseconds(settings.workerIdleTimeout / 4));
+        }
+
+        for (WorkerId i = 0; i < initialWorkers; i++) {
+            StartWorker(i);
         }
     }
 
     template <typename WorkerType>
     SchedulerImpl<WorkerType>::~SchedulerImpl() {
+        Shutdown();
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::Shutdown() {
+        if (_draining.exchange(true)) {
+            return;
+        }
         NAPA_DEBUG("Scheduler", "Shutting down: Start draining unscheduled tasks...");
 
-        // Wait for all tasks to be scheduled.
-        while (_beingScheduled > 0 || !_nonScheduledTasks.empty()) {
-            std::this_thread::yield();
+        // Calls in flight may never finish, saturated workers take the waiting tasks regardless.
+        if (!IsLockFree() && _settings.maxInFlightPerWorker > 0) {
+            _synchronizer->Execute([this]() {
+                _inFlightLimitLifted = true;
+
+                auto idleWorkers = _idleWorkers;
+                for (auto workerId : idleWorkers) {
+                    DispatchToWorker(workerId);
+                }
+            });
         }
 
+        // Wait for all tasks to be scheduled.
+        WaitForDrain([this]() {
+            return _beingScheduled == 0 && _queueLength == 0 && !(IsLockFree() && HasPendingTasks());
+        });
+
         // Signal scheduler callbacks to not process anymore tasks.
         _shouldStop = true;
 
+        // Wait for idle notifications that are still running on worker threads.
+        WaitForDrain([this]() { return _activeNotifications == 0; });
+
+        // The scale down and stuck worker timers are only touched on the synchronizer thread, so they are destroyed there.
+        // Their callbacks don't run anymore once they are destroyed.
+        if (_scaleDownTimer != nullptr || _stuckWorkerTimer != nullptr) {
+            std::promise<void> destroyed;
+            _synchronizer->Execute([this, &destroyed]() {
+                _scaleDownTimer = nullptr;
+                _stuckWorkerTimer = nullptr;
+                destroyed.set_value();
+            });
+            destroyed.get_future().wait();
+        }
+
         // Wait for synchronizer to finish his book-keeping.
         _synchronizer = nullptr;
 
         // Wait for all workers to finish processing remaining tasks.
+        DestroyWorkers(_workers);
+        DestroyWorkers(_replacements);
         _workers.clear();
+        _replacements.clear();
 
         NAPA_DEBUG("Scheduler", "Shutdown completed");
     }
 
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::NotifyDrainProgress() {
+        if (_draining) {
+            // Taking the lock makes sure the destructor is waiting, or checks the condition again, before it's notified.
+            { std::lock_guard<std::mutex> lock(_drainLock); }
+            _drainEvent.notify_all();
+        }
+    }
+
+    template <typename WorkerType>
+    template <typename Predicate>
+    void SchedulerImpl<WorkerType>::WaitForDrain(Predicate predicate) {
+        std::unique_lock<std::mutex> lock(_drainLock);
+        while (!predicate()) {
+            _drainEvent.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::DestroyWorkers(std::vector<std::unique_ptr<WorkerType>>& workers) {
+        // A worker drains its queue before it stops, so a zone stops in the time its slowest worker takes,
+        // instead of the sum of all workers.
+        std::vector<std::thread> threads;
+        threads.reserve(workers.size());
+        for (auto& worker : workers) {
+            if (worker != nullptr) {
+                threads.emplace_back([&worker]() { worker = nullptr; });
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
     template <typename WorkerType>
     void SchedulerImpl<WorkerType>::Schedule(std::shared_ptr<Task> task) {
         NAPA_ASSERT(task, "task is null");
+        if (!AdmitTask(task)) {
+            return;
+        }
         _beingScheduled++;
+
+        if (TraceRecorder::IsEnabled()) {
+            TraceRecorder::GetInstance().RecordInstant("scheduler", "Enqueue", "priority", task->GetPriority());
+        }
+        NAPA_TRACEPOINT2(schedule, "zone", _settings.id.c_str(), "priority", task->GetPriority());
+
+        if (IsLockFree()) {
+            // A routed task goes to its preferred worker if it is idle, like any other task otherwise.
+            WorkerId preferred;
+            if (TryGetPreferredWorker(*task, preferred) && _idleWorkersBitmap.Clear(preferred)) {
+                OnTaskDequeued();
+                _workers[preferred]->Schedule(std::move(task));
+
+                NAPA_DEBUG("Scheduler", "Scheduled routed task on worker %u.", preferred);
+            } else {
+                PushPendingTask(std::move(task));
+                DispatchPendingTasks();
+            }
+            _beingScheduled--;
+            NotifyDrainProgress();
+            return;
+        }
+
         _synchronizer->Execute([this, task]() {
-            if (_idleWorkers.empty()) {
-                NAPA_DEBUG("Scheduler", "All workers are busy, putting task to non-scheduled queue.");
+            // A routed task waits for its preferred worker, unless too many tasks are waiting for it already.
+            WorkerId preferred;
+            WorkerId idleWorker;
+            if (TryGetPreferredWorker(*task, preferred)
+                && ((_idleWorkersFlags[preferred] != _idleWorkers.end() && !IsSaturated(preferred))
+                    || _routedTasks[preferred].size() < _settings.routingImbalance)) {
 
-                // If there is no idle worker, put the task into the non-scheduled queue.
-                _nonScheduledTasks.emplace(std::move(task));
+                if (_idleWorkersFlags[preferred] != _idleWorkers.end() && !IsSaturated(preferred)) {
+                    ScheduleOnIdleWorker(preferred, std::move(task));
+                } else if (AdmitNonScheduledTask(task)) {
+                    _routedTasks[preferred].emplace(std::move(task));
+
+                    NAPA_DEBUG("Scheduler", "Worker %u is busy, putting task to its routed queue.", preferred);
+                }
+            } else if (TryGetLeastLoadedIdleWorker(idleWorker)) {
+                ScheduleOnIdleWorker(idleWorker, std::move(task));
             } else {
-                // Pop the worker id from the idle workers list.
-                auto workerId = _idleWorkers.front();
-                _idleWorkers.pop_front();
-                _idleWorkersFlags[workerId] = _idleWorkers.end();
+                NAPA_DEBUG("Scheduler", "All workers are busy, putting task to non-scheduled queue.");
 
-                // Schedule task on worker
-                _workers[workerId].Schedule(std::move(task));
+                // If there is no idle worker, put the task into the non-scheduled queue.
+                if (AdmitNonScheduledTask(task)) {
+                    _nonScheduledTasks.Push(std::move(task));
+                    ReportPendingTasks();
 
-                NAPA_DEBUG("Scheduler", "Scheduled task on worker %u.", workerId);
+                    ScaleUpIfNeeded();
+                }
             }
             _beingScheduled--;
+            NotifyDrainProgress();
         });
         
     }
@@ -157,7 +754,31 @@ namespace zone {
             WorkerId workerId, std::shared_ptr<Task> task, SchedulePhase phase) {
         NAPA_ASSERT(workerId < _workers.size(), "worker id out of range");
 
+        // A worker scheduling on itself, i.e. setImmediate or a timer, is busy with the current task,
+        // so the task joins its queue without going through the synchronizer.
+        if (_currentScheduler == this && _currentWorkerId == workerId) {
+            _workers[workerId]->Schedule(std::move(task), phase);
+
+            NAPA_DEBUG("Scheduler", "Worker %u scheduled task on itself.", workerId);
+            return;
+        }
+
+        if (IsLockFree()) {
+            // The worker gets busy, it notifies again once it drained its own queue.
+            _idleWorkersBitmap.Clear(workerId);
+            _workers[workerId]->Schedule(std::move(task), phase);
+
+            NAPA_DEBUG("Scheduler", "Explicitly scheduled task on worker %u.", workerId);
+            return;
+        }
+
         _synchronizer->Execute([workerId, this, task, phase]() {
+            if (_workers[workerId] == nullptr) {
+                LOG_ERROR("Scheduler", "Task is dropped since worker %u is not running.", workerId);
+                task->Reject(NAPA_RESULT_WORKER_NOT_RUNNING, "Worker is not running");
+                return;
+            }
+
             // If the worker is idle, change it's status.
             if (_idleWorkersFlags[workerId] != _idleWorkers.end()) {
                 _idleWorkers.erase(_idleWorkersFlags[workerId]);
@@ -165,7 +786,7 @@ namespace zone {
             }
 
             // Schedule task on worker
-            _workers[workerId].Schedule(std::move(task), phase);
+            _workers[workerId]->Schedule(std::move(task), phase);
 
             NAPA_DEBUG("Scheduler", "Explicitly scheduled task on worker %u.", workerId);
         });
@@ -175,6 +796,15 @@ namespace zone {
     void SchedulerImpl<WorkerType>::ScheduleOnAllWorkers(std::shared_ptr<Task> task) {
         NAPA_ASSERT(task, "task is null");
 
+        if (IsLockFree()) {
+            _idleWorkersBitmap.ClearAll();
+            for (auto& worker : _workers) {
+                worker->Schedule(task);
+            }
+            NAPA_DEBUG("Scheduler", "Scheduled task on all workers");
+            return;
+        }
+
         _synchronizer->Execute([this, task]() {
             // Clear all idle workers.
             _idleWorkers.clear();
@@ -182,40 +812,954 @@ namespace zone {
                 flag = _idleWorkers.end();
             }
 
-            // Schedule the task on all workers.
+            // Schedule the task on all workers, including replacements that are bootstrapping.
             for (auto& worker : _workers) {
-                worker.Schedule(task);
+                if (worker != nullptr) {
+                    worker->Schedule(task);
+                }
+            }
+            for (auto& replacement : _replacements) {
+                if (replacement != nullptr) {
+                    replacement->Schedule(task);
+                }
             }
             NAPA_DEBUG("Scheduler", "Scheduled task on all workers");
         });
     }
 
     template <typename WorkerType>
-    void SchedulerImpl<WorkerType>::IdleWorkerNotificationCallback(WorkerId workerId) {
-        NAPA_ASSERT(workerId < _workers.size(), "worker id out of range");
+    void SchedulerImpl<WorkerType>::ScheduleOnAllWorkers(BroadcastTaskFactory createTask) {
+        NAPA_ASSERT(createTask, "task factory is null");
 
-        if (_shouldStop) {
+        if (IsLockFree()) {
+            std::vector<std::shared_ptr<Task>> tasks;
+            tasks.reserve(_workers.size());
+            for (size_t i = 0; i < _workers.size(); i++) {
+                tasks.emplace_back(createTask(static_cast<uint32_t>(_workers.size())));
+            }
+
+            _idleWorkersBitmap.ClearAll();
+            for (size_t i = 0; i < _workers.size(); i++) {
+                _workers[i]->Schedule(std::move(tasks[i]));
+            }
+            NAPA_DEBUG("Scheduler", "Scheduled task on all workers");
             return;
         }
 
-        _synchronizer->Execute([this, workerId]() {
-            if (!_nonScheduledTasks.empty()) {
-                // If there is a non scheduled task, schedule it on the idle worker.
-                auto task = _nonScheduledTasks.front();
-                _nonScheduledTasks.pop();
-                _workers[workerId].Schedule(std::move(task));
+        _synchronizer->Execute([this, createTask]() {
+            auto workerCount = _workerCount.load();
 
-                NAPA_DEBUG("Scheduler", "Worker %u fetched a task from non-scheduled queue", workerId);
+            std::vector<std::shared_ptr<Task>> tasks;
+            tasks.reserve(workerCount);
+            for (uint32_t i = 0; i < workerCount; i++) {
+                tasks.emplace_back(createTask(workerCount));
+            }
+
+            // Clear all idle workers.
+            _idleWorkers.clear();
+            for (auto& flag : _idleWorkersFlags) {
+                flag = _idleWorkers.end();
+            }
+
+            auto next = tasks.begin();
+            for (auto& worker : _workers) {
+                if (worker != nullptr) {
+                    worker->Schedule(std::move(*next++));
+                }
+            }
+
+            // Replacements that are bootstrapping run it like new workers, without reporting back.
+            for (auto& replacement : _replacements) {
+                if (replacement != nullptr) {
+                    replacement->Schedule(createTask(0));
+                }
+            }
+
+            // Workers that start later run the same broadcasts.
+            if (IsElastic() || IsRecycling()) {
+                _broadcastHistory.push_back({ std::move(createTask), {} });
+            }
+            NAPA_DEBUG("Scheduler", "Scheduled task on all workers");
+        });
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::ScheduleOnWorkers(std::vector<WorkerId> workerIds, BroadcastTaskFactory createTask) {
+        NAPA_ASSERT(createTask, "task factory is null");
+
+        std::sort(workerIds.begin(), workerIds.end());
+        workerIds.erase(std::unique(workerIds.begin(), workerIds.end()), workerIds.end());
+        workerIds.erase(std::lower_bound(workerIds.begin(), workerIds.end(), static_cast<WorkerId>(_workers.size())), workerIds.end());
+
+        if (IsLockFree()) {
+            if (workerIds.empty()) {
+                (void)createTask(0);
+                return;
+            }
+
+            auto workerCount = static_cast<uint32_t>(workerIds.size());
+            std::vector<std::shared_ptr<Task>> tasks;
+            tasks.reserve(workerCount);
+            for (uint32_t i = 0; i < workerCount; i++) {
+                tasks.emplace_back(createTask(workerCount));
+            }
+
+            for (uint32_t i = 0; i < workerCount; i++) {
+                _idleWorkersBitmap.Clear(workerIds[i]);
+                _workers[workerIds[i]]->Schedule(std::move(tasks[i]));
+            }
+            NAPA_DEBUG("Scheduler", "Scheduled task on %u workers", workerCount);
+            return;
+        }
+
+        _synchronizer->Execute([this, workerIds = std::move(workerIds), createTask = std::move(createTask)]() mutable {
+            uint32_t workerCount = 0;
+            for (auto workerId : workerIds) {
+                if (_workers[workerId] != nullptr) {
+                    workerCount++;
+                }
+            }
+
+            if (workerCount == 0) {
+                (void)createTask(0);
             } else {
-                // Put worker in idle list.
-                if (_idleWorkersFlags[workerId] == _idleWorkers.end()) {
-                    auto iter = _idleWorkers.emplace(_idleWorkers.end(), workerId);
-                    _idleWorkersFlags[workerId] = iter;
+                std::vector<std::shared_ptr<Task>> tasks;
+                tasks.reserve(workerCount);
+                for (uint32_t i = 0; i < workerCount; i++) {
+                    tasks.emplace_back(createTask(workerCount));
+                }
 
-                    NAPA_DEBUG("Scheduler", "Worker %u becomes idle", workerId);
+                auto next = tasks.begin();
+                for (auto workerId : workerIds) {
+                    if (_workers[workerId] == nullptr) {
+                        continue;
+                    }
+
+                    // The worker gets busy, other idle workers keep their place in the idle list.
+                    if (_idleWorkersFlags[workerId] != _idleWorkers.end()) {
+                        _idleWorkers.erase(_idleWorkersFlags[workerId]);
+                        _idleWorkersFlags[workerId] = _idleWorkers.end();
+                    }
+                    _workers[workerId]->Schedule(std::move(*next++));
+                }
+            }
+
+            // Replacements that are bootstrapping run it like new workers, without reporting back.
+            for (auto workerId : workerIds) {
+                if (!_replacements.empty() && _replacements[workerId] != nullptr) {
+                    _replacements[workerId]->Schedule(createTask(0));
                 }
             }
+
+            // The given workers run the same broadcast when they start later.
+            if (IsElastic() || IsRecycling()) {
+                _broadcastHistory.push_back({ std::move(createTask), std::move(workerIds) });
+            }
+            NAPA_DEBUG("Scheduler", "Scheduled task on %u workers", workerCount);
         });
     }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::ScheduleOnRunningWorkers(BroadcastTaskFactory createTask) {
+        NAPA_ASSERT(createTask, "task factory is null");
+
+        if (IsLockFree()) {
+            std::vector<std::shared_ptr<Task>> tasks;
+            tasks.reserve(_workers.size());
+            for (size_t i = 0; i < _workers.size(); i++) {
+                tasks.emplace_back(createTask(static_cast<uint32_t>(_workers.size())));
+            }
+
+            _idleWorkersBitmap.ClearAll();
+            for (size_t i = 0; i < _workers.size(); i++) {
+                _workers[i]->Schedule(std::move(tasks[i]), SchedulePhase::ImmediatePhase);
+            }
+            NAPA_DEBUG("Scheduler", "Scheduled immediate task on running workers");
+            return;
+        }
+
+        _synchronizer->Execute([this, createTask]() {
+            auto workerCount = _workerCount.load();
+
+            std::vector<std::shared_ptr<Task>> tasks;
+            tasks.reserve(workerCount);
+            for (uint32_t i = 0; i < workerCount; i++) {
+                tasks.emplace_back(createTask(workerCount));
+            }
+
+            // Clear all idle workers.
+            _idleWorkers.clear();
+            for (auto& flag : _idleWorkersFlags) {
+                flag = _idleWorkers.end();
+            }
+
+            auto next = tasks.begin();
+            for (auto& worker : _workers) {
+                if (worker != nullptr) {
+                    worker->Schedule(std::move(*next++), SchedulePhase::ImmediatePhase);
+                }
+            }
+            NAPA_DEBUG("Scheduler", "Scheduled immediate task on running workers");
+        });
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::ScheduleOnRetainedWorker(
+            WorkerId workerId, std::shared_ptr<Task> task, SchedulePhase phase) {
+        NAPA_ASSERT(workerId < _workers.size(), "worker id out of range");
+        NAPA_ASSERT(_workerRetainCounts[workerId] > 0, "worker was not retained");
+
+        if (IsLockFree()) {
+            _idleWorkersBitmap.Clear(workerId);
+        }
+        _workers[workerId]->Schedule(std::move(task), phase);
+
+        NAPA_DEBUG("Scheduler", "Scheduled task on retained worker %u.", workerId);
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::RetainWorker(WorkerId workerId) {
+        NAPA_ASSERT(workerId < _maxWorkers, "worker id out of range");
+        _workerRetainCounts[workerId]++;
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::ReleaseWorker(WorkerId workerId) {
+        NAPA_ASSERT(workerId < _maxWorkers, "worker id out of range");
+        NAPA_ASSERT(_workerRetainCounts[workerId] > 0, "worker was not retained");
+
+        // The worker is running the releasing task, so it isn't retired before it becomes idle again.
+        _workerRetainCounts[workerId]--;
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::OnCallDispatched(WorkerId workerId) {
+        NAPA_ASSERT(workerId < _maxWorkers, "worker id out of range");
+        _workerInFlightCounts[workerId]++;
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::OnCallFinished(WorkerId workerId) {
+        NAPA_ASSERT(workerId < _maxWorkers, "worker id out of range");
+        NAPA_ASSERT(_workerInFlightCounts[workerId] > 0, "worker has no call in flight");
+
+        auto count = _workerInFlightCounts[workerId]--;
+        if (IsLockFree() || count != _settings.maxInFlightPerWorker) {
+            return;
+        }
+
+        // The worker was saturated. It takes waiting tasks once it becomes idle, but it may be idle already.
+        _activeNotifications++;
+        if (!_shouldStop) {
+            _synchronizer->Execute([this, workerId]() {
+                if (_workers[workerId] != nullptr && _idleWorkersFlags[workerId] != _idleWorkers.end()) {
+                    DispatchToWorker(workerId);
+                }
+            });
+        }
+        _activeNotifications--;
+    }
+
+    template <typename WorkerType>
+    uint32_t SchedulerImpl<WorkerType>::GetInFlightCount(WorkerId workerId) const {
+        NAPA_ASSERT(workerId < _maxWorkers, "worker id out of range");
+        return _workerInFlightCounts[workerId];
+    }
+
+    template <typename WorkerType>
+    uint32_t SchedulerImpl<WorkerType>::GetWorkerCount() const {
+        return _workerCount;
+    }
+
+    template <typename WorkerType>
+    uint32_t SchedulerImpl<WorkerType>::GetMaxWorkerCount() const {
+        return _maxWorkers;
+    }
+
+    template <typename WorkerType>
+    size_t SchedulerImpl<WorkerType>::GetQueueLength() const {
+        return _queueLength;
+    }
+
+    template <typename WorkerType>
+    ZoneStats SchedulerImpl<WorkerType>::GetStats() {
+        auto collect = [this](size_t pendingTasks) {
+            ZoneStats stats;
+            stats.pendingTasks = pendingTasks;
+            if (!IsLockFree()) {
+                stats.tenants = _nonScheduledTasks.GetStats();
+            }
+            for (auto& worker : _workers) {
+                if (worker != nullptr) {
+                    stats.workers.emplace_back(worker->GetStats());
+                }
+            }
+            return stats;
+        };
+
+        if (IsLockFree()) {
+            return collect(_queueLength);
+        }
+
+        // Workers are started and retired on the synchronizer, which also owns the waiting tasks.
+        std::promise<ZoneStats> promise;
+        _synchronizer->Execute([this, &promise, &collect]() {
+            promise.set_value(collect(GetPendingTaskCount()));
+        });
+        return promise.get_future().get();
+    }
+
+    template <typename WorkerType>
+    size_t SchedulerImpl<WorkerType>::GetPendingTaskCount() const {
+        auto count = _nonScheduledTasks.Size();
+        for (const auto& routedTasks : _routedTasks) {
+            count += routedTasks.size();
+        }
+        return count;
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::ReportPendingTasks() {
+        constexpr auto METRIC_REPORT_INTERVAL = std::chrono::seconds(1);
+
+        // A drained queue is reported right away, so the metric doesn't stay at its last non-zero value.
+        auto now = std::chrono::steady_clock::now();
+        if (now - _pendingTasksReportTime < METRIC_REPORT_INTERVAL && !_nonScheduledTasks.Empty()) {
+            return;
+        }
+        _pendingTasksReportTime = now;
+
+        static const char* dimensionNames[] = { "Zone" };
+        static auto pendingTasksMetric = providers::GetMetricProvider().GetMetric(
+            "Napa", "ZonePendingTasks", providers::MetricType::Number, 1, dimensionNames);
+
+        const char* dimensionValues[] = { _settings.id.c_str() };
+        if (pendingTasksMetric != nullptr) {
+            pendingTasksMetric->Set(static_cast<int64_t>(GetPendingTaskCount()), 1, dimensionValues);
+        }
+
+        // Zones without tenants only have the default tenant, which the zone metrics cover already.
+        if (_settings.tenantWeights.empty()) {
+            return;
+        }
+
+        static const char* tenantDimensionNames[] = { "Zone", "Tenant" };
+        static auto tenantPendingTasksMetric = providers::GetMetricProvider().GetMetric(
+            "Napa", "TenantPendingTasks", providers::MetricType::Number, 2, tenantDimensionNames);
+        static auto tenantWaitTimeMetric = providers::GetMetricProvider().GetMetric(
+            "Napa", "TenantAverageWaitTime", providers::MetricType::Number, 2, tenantDimensionNames);
+
+        for (const auto& tenant : _nonScheduledTasks.GetStats()) {
+            auto name = tenant.name.empty() ? std::to_string(tenant.tenant) : tenant.name;
+            const char* tenantDimensionValues[] = { _settings.id.c_str(), name.c_str() };
+            if (tenantPendingTasksMetric != nullptr) {
+                tenantPendingTasksMetric->Set(static_cast<int64_t>(tenant.queuedTasks), 2, tenantDimensionValues);
+            }
+            if (tenantWaitTimeMetric != nullptr && tenant.dispatchedTasks > 0) {
+                tenantWaitTimeMetric->Set(static_cast<int64_t>(tenant.waitTime / tenant.dispatchedTasks), 2, tenantDimensionValues);
+            }
+        }
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::AdmitTask(const std::shared_ptr<Task>& task) {
+        auto maxQueueLength = static_cast<size_t>(_settings.maxQueueLength);
+
+        if (IsBlockingAdmission()) {
+            std::unique_lock<std::mutex> lock(_admissionLock);
+            _admissionEvent.wait(lock, [this, maxQueueLength]() { return _queueLength < maxQueueLength; });
+
+            // The slot is reserved until the task is handed to a worker.
+            _queueLength++;
+            return true;
+        }
+
+        if (!IsLockFree()) {
+            return true;
+        }
+
+        if (maxQueueLength == 0) {
+            _queueLength++;
+            return true;
+        }
+
+        if (_settings.overloadPolicy == settings::OverloadPolicy::DropOldest) {
+            if (_queueLength.fetch_add(1) >= maxQueueLength) {
+                std::shared_ptr<Task> oldest;
+                if (TryPopPendingTask(0, oldest)) {
+                    oldest->Reject(NAPA_RESULT_ZONE_OVERLOADED, "Dropped from the full zone queue");
+                }
+            }
+            return true;
+        }
+
+        auto length = _queueLength.load();
+        do {
+            if (length >= maxQueueLength) {
+                task->Reject(NAPA_RESULT_ZONE_OVERLOADED, "The zone queue is full");
+                return false;
+            }
+        } while (!_queueLength.compare_exchange_weak(length, length + 1));
+        return true;
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::AdmitNonScheduledTask(const std::shared_ptr<Task>& task) {
+        // Blocked callers reserved their slot already.
+        if (IsBlockingAdmission()) {
+            return true;
+        }
+
+        if (_settings.maxQueueLength > 0 && _queueLength >= _settings.maxQueueLength) {
+            if (_settings.overloadPolicy != settings::OverloadPolicy::DropOldest) {
+                task->Reject(NAPA_RESULT_ZONE_OVERLOADED, "The zone queue is full");
+                return false;
+            }
+            DropOldestTask();
+        }
+
+        _queueLength++;
+        return true;
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::DropOldestTask() {
+        std::shared_ptr<Task> oldest;
+        if (!_nonScheduledTasks.Empty()) {
+            // The tenant with the most waiting tasks makes room, with the task it would dispatch next.
+            oldest = _nonScheduledTasks.PopFromLongest();
+        } else {
+            // All waiting tasks are routed, the longest routed queue makes room.
+            auto longest = std::max_element(_routedTasks.begin(), _routedTasks.end(),
+                [](const std::queue<std::shared_ptr<Task>>& left, const std::queue<std::shared_ptr<Task>>& right) {
+                    return left.size() < right.size();
+                });
+            oldest = std::move(longest->front());
+            longest->pop();
+        }
+        _queueLength--;
+
+        oldest->Reject(NAPA_RESULT_ZONE_OVERLOADED, "Dropped from the full zone queue");
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::ScheduleOnIdleWorker(WorkerId workerId, std::shared_ptr<Task> task) {
+        _idleWorkers.erase(_idleWorkersFlags[workerId]);
+        _idleWorkersFlags[workerId] = _idleWorkers.end();
+
+        if (!_dispatchedTasks.empty()) {
+            _dispatchedTasks[workerId] = task;
+        }
+        _workers[workerId]->Schedule(std::move(task));
+
+        // Releases the slot reserved by a blocked caller.
+        if (IsBlockingAdmission()) {
+            OnTaskDequeued();
+        }
+
+        NAPA_DEBUG("Scheduler", "Scheduled task on worker %u.", workerId);
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::IsSaturated(WorkerId workerId) const {
+        // A worker shedding its load takes no calls until its replacement takes over.
+        return (_settings.maxInFlightPerWorker > 0
+            && !_inFlightLimitLifted
+            && _workerInFlightCounts[workerId] >= _settings.maxInFlightPerWorker)
+            || _workers[workerId]->IsSheddingLoad();
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::HasPinnedWork(WorkerId workerId) const {
+        return _workerRetainCounts[workerId] > 0 || _workerInFlightCounts[workerId] > 0;
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::TryGetLeastLoadedIdleWorker(WorkerId& workerId) const {
+        // Among equally loaded workers, the one idle for the longest goes first.
+        auto found = false;
+        uint32_t fewest = 0;
+        for (auto id : _idleWorkers) {
+            if (IsSaturated(id)) {
+                continue;
+            }
+
+            uint32_t count = _workerInFlightCounts[id];
+            if (!found || count < fewest) {
+                found = true;
+                fewest = count;
+                workerId = id;
+            }
+        }
+        return found;
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::DispatchToWorker(WorkerId workerId) {
+        if (!IsSaturated(workerId)) {
+            std::shared_ptr<Task> task;
+            if (!_routedTasks[workerId].empty()) {
+                // Tasks routed to this worker go first.
+                task = std::move(_routedTasks[workerId].front());
+                _routedTasks[workerId].pop();
+
+                NAPA_DEBUG("Scheduler", "Worker %u fetched a task from its routed queue", workerId);
+            } else if (!_nonScheduledTasks.Empty()) {
+                // If there is a non scheduled task, schedule it on the idle worker.
+                task = _nonScheduledTasks.Pop();
+                ReportPendingTasks();
+
+                NAPA_DEBUG("Scheduler", "Worker %u fetched a task from non-scheduled queue", workerId);
+            }
+
+            if (task != nullptr) {
+                if (_idleWorkersFlags[workerId] != _idleWorkers.end()) {
+                    _idleWorkers.erase(_idleWorkersFlags[workerId]);
+                    _idleWorkersFlags[workerId] = _idleWorkers.end();
+                }
+                OnTaskDequeued();
+                if (!_dispatchedTasks.empty()) {
+                    _dispatchedTasks[workerId] = task;
+                }
+                _workers[workerId]->Schedule(std::move(task));
+                return;
+            }
+        }
+
+        // Put worker in idle list, a saturated worker stays there until its calls in flight drop below the limit.
+        if (_idleWorkersFlags[workerId] == _idleWorkers.end()) {
+            auto iter = _idleWorkers.emplace(_idleWorkers.end(), workerId);
+            _idleWorkersFlags[workerId] = iter;
+
+            if (IsElastic()) {
+                _idleSince[workerId] = std::chrono::steady_clock::now();
+                ScaleDownLater();
+            }
+
+            NAPA_DEBUG("Scheduler", "Worker %u becomes idle", workerId);
+        }
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::TryGetPreferredWorker(const Task& task, WorkerId& workerId) const {
+        auto routingKey = task.GetRoutingKey();
+        if (routingKey == 0) {
+            return false;
+        }
+
+        // Hashing over all worker slots keeps the key to worker mapping stable while the zone scales.
+        // Tasks of a stuck worker go to any worker until it's idle again.
+        workerId = GetRoutedWorker(routingKey, _maxWorkers);
+        return _workers[workerId] != nullptr && (_stuckWorkers.empty() || !_stuckWorkers[workerId]);
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::OnTaskDequeued() {
+        _queueLength--;
+        NotifyDrainProgress();
+
+        if (IsBlockingAdmission()) {
+            // Taking the lock makes sure a caller that just found the queue full is waiting before it is notified.
+            { std::lock_guard<std::mutex> lock(_admissionLock); }
+            _admissionEvent.notify_one();
+        }
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::IsBlockingAdmission() const {
+        return _settings.maxQueueLength > 0 && _settings.overloadPolicy == settings::OverloadPolicy::Block;
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::IdleWorkerNotificationCallback(WorkerId workerId, uint64_t generation) {
+        NAPA_ASSERT(workerId < _workers.size(), "worker id out of range");
+
+        if (IsLockFree()) {
+            _activeNotifications++;
+            if (!_shouldStop) {
+                std::shared_ptr<Task> task;
+                if (TryPopPendingTask(workerId, task)) {
+                    _workers[workerId]->Schedule(std::move(task));
+
+                    NAPA_DEBUG("Scheduler", "Worker %u fetched a task from pending queue", workerId);
+                } else {
+                    _idleWorkersBitmap.Set(workerId);
+
+                    NAPA_DEBUG("Scheduler", "Worker %u becomes idle", workerId);
+
+                    // A task may have been pushed after the pop above by a caller that saw no idle worker.
+                    DispatchPendingTasks();
+                }
+            }
+            _activeNotifications--;
+            return;
+        }
+
+        // The destructor waits for notifications that passed the stop check, so the synchronizer stays alive.
+        _activeNotifications++;
+        if (_shouldStop) {
+            _activeNotifications--;
+            return;
+        }
+
+        _synchronizer->Execute([this, workerId, generation]() {
+            // The notification may arrive after the worker was retired.
+            if (_workers[workerId] == nullptr) {
+                return;
+            }
+
+            if (generation != _workerGenerations[workerId]) {
+                // Only a replacement that finished bootstrapping is expected, other notifications come from replaced workers.
+                if (_replacements.empty()
+                    || _replacements[workerId] == nullptr
+                    || generation != _replacementGenerations[workerId]) {
+                    return;
+                }
+                _replacementsReady[workerId] = true;
+
+                // The replacement waits until the old worker is idle, without pinned work.
+                if (_idleWorkersFlags[workerId] == _idleWorkers.end() || HasPinnedWork(workerId)) {
+                    return;
+                }
+                SwapReplacement(workerId);
+            } else if (IsRecycling()) {
+                if (_replacements[workerId] == nullptr) {
+                    if (!_shouldStop && _workers[workerId]->NeedsRecycling()) {
+                        StartReplacement(workerId);
+                    }
+                } else if (_replacementsReady[workerId] && !HasPinnedWork(workerId)) {
+                    SwapReplacement(workerId);
+                }
+            }
+
+            if (IsElastic() && _startingWorkersFlags[workerId]) {
+                _startingWorkersFlags[workerId] = false;
+                _startingWorkers--;
+            }
+
+            // An idle worker is not stuck anymore, it's a new worker if it was replaced.
+            if (!_stuckWorkers.empty()) {
+                _stuckWorkers[workerId] = false;
+            }
+
+            DispatchToWorker(workerId);
+        });
+        _activeNotifications--;
+    }
+
+    template <typename WorkerType>
+    std::unique_ptr<WorkerType> SchedulerImpl<WorkerType>::CreateWorker(WorkerId workerId, uint64_t generation) {
+        // Workers run their setup on their own thread, which tells the thread which worker it runs.
+        auto setupCallback = [this](WorkerId id) {
+            _currentScheduler = this;
+            _currentWorkerId = id;
+            _workerSetupCallback(id);
+        };
+
+        auto worker = std::make_unique<WorkerType>(workerId, _settings, setupCallback, [this, generation](WorkerId id) {
+            IdleWorkerNotificationCallback(id, generation);
+        });
+
+        // Replay broadcasts so the new worker has the same state as its peers before it serves any task.
+        for (const auto& broadcast : _broadcastHistory) {
+            if (broadcast.workerIds.empty()
+                || std::binary_search(broadcast.workerIds.begin(), broadcast.workerIds.end(), workerId)) {
+                worker->Schedule(broadcast.createTask(0));
+            }
+        }
+        return worker;
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::StartWorker(WorkerId workerId) {
+        NAPA_ASSERT(_workers[workerId] == nullptr, "worker slot is in use");
+
+        _workerGenerations[workerId] = ++_lastGeneration;
+        auto worker = CreateWorker(workerId, _workerGenerations[workerId]);
+
+        if (IsElastic()) {
+            _startingWorkersFlags[workerId] = true;
+            _startingWorkers++;
+        }
+
+        _workers[workerId] = std::move(worker);
+        _workerCount++;
+        _workers[workerId]->Start();
+
+        NAPA_DEBUG("Scheduler", "Worker %u started, %u workers are running.", workerId, _workerCount.load());
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::StartReplacement(WorkerId workerId) {
+        NAPA_ASSERT(_replacements[workerId] == nullptr, "worker is being replaced already");
+
+        _replacementGenerations[workerId] = ++_lastGeneration;
+        _replacementsReady[workerId] = false;
+        _replacements[workerId] = CreateWorker(workerId, _replacementGenerations[workerId]);
+        _replacements[workerId]->Start();
+
+        NAPA_DEBUG("Scheduler", "Worker %u reached its recycling limits, its replacement started.", workerId);
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::SwapReplacement(WorkerId workerId) {
+        if (_idleWorkersFlags[workerId] != _idleWorkers.end()) {
+            _idleWorkers.erase(_idleWorkersFlags[workerId]);
+            _idleWorkersFlags[workerId] = _idleWorkers.end();
+        }
+
+        auto worker = std::move(_workers[workerId]);
+        _workers[workerId] = std::move(_replacements[workerId]);
+        _workerGenerations[workerId] = _replacementGenerations[workerId];
+        _replacementsReady[workerId] = false;
+
+        // The old worker is idle, destroying it drains what was scheduled on it meanwhile and waits for its thread.
+        worker = nullptr;
+
+        NAPA_DEBUG("Scheduler", "Worker %u was recycled.", workerId);
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::IsRecycling() const {
+        return !IsLockFree() && (_settings.maxTasksPerWorker > 0
+            || _settings.maxHeapBeforeRecycle > 0
+            || _settings.recycleOnHeapLimit
+            || (_settings.recycleStuckWorkers && _settings.stuckWorkerThreshold > 0));
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::CheckStuckWorkers() {
+        if (_shouldStop) {
+            return;
+        }
+
+        static const char* dimensionNames[] = { "Zone" };
+        static auto stuckWorkersMetric = providers::GetMetricProvider().GetMetric(
+            "Napa", "StuckWorkers", providers::MetricType::Rate, 1, dimensionNames);
+
+        auto threshold = std::chrono::milliseconds(_settings.stuckWorkerThreshold);
+        for (WorkerId workerId = 0; workerId < _maxWorkers; workerId++) {
+            if (_workers[workerId] == nullptr || _stuckWorkers[workerId] || _workers[workerId]->GetBusyDuration() < threshold) {
+                continue;
+            }
+            _stuckWorkers[workerId] = true;
+
+            LOG_WARNING("Scheduler", "Worker %u of zone \"%s\" made no progress for %u ms, its waiting tasks go to other workers.",
+                workerId, _settings.id.c_str(), _settings.stuckWorkerThreshold);
+
+            const char* dimensionValues[] = { _settings.id.c_str() };
+            if (stuckWorkersMetric != nullptr) {
+                stuckWorkersMetric->Increment(1, 1, dimensionValues);
+            }
+
+            RerouteTasks(workerId);
+
+            // The replacement takes over once the terminated worker is idle, like a worker that reached its limits.
+            if (_settings.recycleStuckWorkers) {
+                if (_replacements[workerId] == nullptr) {
+                    StartReplacement(workerId);
+                }
+                _workers[workerId]->TerminateExecution();
+            }
+        }
+
+        _stuckWorkerTimer->Start();
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::RerouteTasks(WorkerId workerId) {
+        // The dispatched task was handed out of the queue already, it's counted again while it waits.
+        auto rerouted = 0;
+        auto dispatched = _dispatchedTasks[workerId].lock();
+        if (dispatched != nullptr && _workers[workerId]->Unschedule(dispatched)) {
+            _queueLength++;
+            _nonScheduledTasks.Push(std::move(dispatched));
+            rerouted++;
+        }
+        _dispatchedTasks[workerId].reset();
+
+        auto& routedTasks = _routedTasks[workerId];
+        while (!routedTasks.empty()) {
+            _nonScheduledTasks.Push(std::move(routedTasks.front()));
+            routedTasks.pop();
+            rerouted++;
+        }
+
+        if (rerouted == 0) {
+            return;
+        }
+        NAPA_DEBUG("Scheduler", "Rerouted %d tasks of stuck worker %u.", rerouted, workerId);
+
+        auto idleWorkers = _idleWorkers;
+        for (auto id : idleWorkers) {
+            if (_nonScheduledTasks.Empty()) {
+                break;
+            }
+            DispatchToWorker(id);
+        }
+        ReportPendingTasks();
+        ScaleUpIfNeeded();
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::ScaleUpIfNeeded() {
+        if (!IsElastic() || _workerCount >= _maxWorkers) {
+            return;
+        }
+
+        // Workers that are still starting will take their share of the backlog.
+        auto depth = static_cast<size_t>(std::max(_settings.scaleUpQueueDepth, 1u));
+        if (_nonScheduledTasks.Size() < depth * (_startingWorkers + 1)) {
+            return;
+        }
+
+        for (WorkerId i = 0; i < _maxWorkers; i++) {
+            if (_workers[i] == nullptr) {
+                StartWorker(i);
+                return;
+            }
+        }
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::ScaleDownLater() {
+        if (_scaleDownTimer != nullptr && !_scaleDownArmed && _workerCount > _minWorkers) {
+            _scaleDownArmed = true;
+            _scaleDownTimer->Start();
+        }
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::RetireIdleWorkers() {
+        _scaleDownArmed = false;
+        if (_shouldStop) {
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto idleTimeout = std::chrono::milliseconds(_settings.workerIdleTimeout);
+        auto hasCandidates = false;
+
+        auto iter = _idleWorkers.begin();
+        while (iter != _idleWorkers.end() && _workerCount > _minWorkers) {
+            auto workerId = *iter;
+
+            // Workers with pinned work must stay, the work will schedule back on them.
+            if (now - _idleSince[workerId] < idleTimeout || HasPinnedWork(workerId)) {
+                hasCandidates = true;
+                ++iter;
+                continue;
+            }
+
+            iter = _idleWorkers.erase(iter);
+            _idleWorkersFlags[workerId] = _idleWorkers.end();
+
+            // The worker is idle, destroying it waits for its thread to exit. A replacement being bootstrapped goes too.
+            auto worker = std::move(_workers[workerId]);
+            _workerCount--;
+            worker = nullptr;
+            if (IsRecycling()) {
+                _replacements[workerId] = nullptr;
+            }
+
+            NAPA_DEBUG("Scheduler", "Worker %u retired, %u workers are running.", workerId, _workerCount.load());
+        }
+
+        if (hasCandidates) {
+            ScaleDownLater();
+        }
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::IsElastic() const {
+        return _minWorkers < _maxWorkers;
+    }
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::PushPendingTask(std::shared_ptr<Task> task) {
+        // Work-stealing mode spreads new tasks over the per worker queues.
+        auto& queue = _pendingQueues.size() == 1 ?
+            _pendingQueues[0] : _pendingQueues[_nextPendingQueue.fetch_add(1, std::memory_order_relaxed) % _pendingQueues.size()];
+
+        // Once tasks spilled into the overflow queue, keep using it until it is drained to preserve ordering.
+        if (_overflowSize > 0 || !queue->TryPush(std::move(task))) {
+            std::lock_guard<std::mutex> lock(_overflowLock);
+            _overflowTasks.emplace(std::move(task));
+            _overflowSize++;
+
+            NAPA_DEBUG("Scheduler", "Pending queue is full, putting task to overflow queue.");
+        }
+
+        // Make the task visible before checking for idle workers, pairs with the fence in DispatchPendingTasks.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::TryPopPendingTask(WorkerId workerId, std::shared_ptr<Task>& task) {
+        // Start from the worker's own queue, then steal from the peers that follow it.
+        auto count = _pendingQueues.size();
+        for (size_t i = 0; i < count; i++) {
+            if (_pendingQueues[(workerId + i) % count]->TryPop(task)) {
+                OnTaskDequeued();
+                return true;
+            }
+        }
+
+        if (_overflowSize == 0) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(_overflowLock);
+        if (_overflowTasks.empty()) {
+            return false;
+        }
+
+        task = std::move(_overflowTasks.front());
+        _overflowTasks.pop();
+        _overflowSize--;
+        OnTaskDequeued();
+        return true;
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::HasPendingTasks() const {
+        for (const auto& queue : _pendingQueues) {
+            if (!queue->Empty()) {
+                return true;
+            }
+        }
+        return _overflowSize > 0;
+    }
+
+    template <typename WorkerType>
+    bool SchedulerImpl<WorkerType>::IsLockFree() const {
+        return !_pendingQueues.empty();
+    }
+
+    template <typename WorkerType>
+    void SchedulerImpl<WorkerType>::DispatchPendingTasks() {
+        // Idle bits are published before pending tasks are checked and vice versa,
+        // so either a caller finds the idle worker or the idle worker finds the task.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        while (HasPendingTasks()) {
+            size_t workerId;
+            if (!_idleWorkersBitmap.TryClaim(workerId)) {
+                // All workers are busy, the next one to become idle will pick up the pending tasks.
+                return;
+            }
+
+            std::shared_ptr<Task> task;
+            if (!TryPopPendingTask(static_cast<WorkerId>(workerId), task)) {
+                // Someone else took the task, give the worker back and check again.
+                _idleWorkersBitmap.Set(workerId);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                continue;
+            }
+
+            _workers[workerId]->Schedule(std::move(task));
+
+            NAPA_DEBUG("Scheduler", "Scheduled task on worker %zu.", workerId);
+        }
+    }
 }
 }
@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "semaphore.h"
+
+#include <vector>
+
+using namespace napa::zone;
+
+Semaphore::Semaphore(uint32_t count) : _count(count) {
+}
+
+void Semaphore::Acquire() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _released.wait(lock, [this]() { return _count > 0; });
+    --_count;
+}
+
+bool Semaphore::TryAcquire() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_count == 0) {
+        return false;
+    }
+    --_count;
+    return true;
+}
+
+bool Semaphore::TryAcquireFor(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_released.wait_for(lock, timeout, [this]() { return _count > 0; })) {
+        return false;
+    }
+    --_count;
+    return true;
+}
+
+void Semaphore::AcquireAsync(Continuation continuation) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_count == 0) {
+            _continuations.emplace_back(std::move(continuation));
+            return;
+        }
+        --_count;
+    }
+    continuation();
+}
+
+void Semaphore::Release(uint32_t count) {
+    std::vector<Continuation> continuations;
+    bool available = false;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _count += count;
+
+        // Permits are handed over to queued continuations, which never see the count.
+        while (_count > 0 && !_continuations.empty()) {
+            continuations.emplace_back(std::move(_continuations.front()));
+            _continuations.pop_front();
+            --_count;
+        }
+        available = _count > 0;
+    }
+
+    if (available) {
+        _released.notify_all();
+    }
+    for (auto& continuation : continuations) {
+        continuation();
+    }
+}
+
+uint32_t Semaphore::GetCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _count;
+}
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A counting semaphore that can be waited for synchronously, or asynchronously without holding a thread. </summary>
+    /// <remarks> Released permits go to the oldest asynchronous waiters first, then to synchronous waiters. </remarks>
+    class Semaphore {
+    public:
+
+        /// <summary> Called with a permit acquired, the callee is responsible for releasing it. </summary>
+        using Continuation = std::function<void()>;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="count"> The number of permits available initially. </param>
+        explicit Semaphore(uint32_t count);
+
+        Semaphore(const Semaphore&) = delete;
+        Semaphore& operator=(const Semaphore&) = delete;
+
+        /// <summary> Acquires a permit, blocking the calling thread until one is available. </summary>
+        void Acquire();
+
+        /// <summary> Acquires a permit if one is available right away. </summary>
+        /// <returns> True if a permit was acquired. </returns>
+        bool TryAcquire();
+
+        /// <summary> Acquires a permit, blocking the calling thread at most for the given timeout. </summary>
+        /// <returns> True if a permit was acquired. </returns>
+        bool TryAcquireFor(std::chrono::milliseconds timeout);
+
+        /// <summary> Acquires a permit asynchronously. </summary>
+        /// <param name="continuation">
+        ///     Runs once a permit is acquired, on the calling thread if one is available right away,
+        ///     or otherwise on the thread that releases it. It should only schedule work and return.
+        /// </param>
+        void AcquireAsync(Continuation continuation);
+
+        /// <summary> Releases permits, handing them to waiters if any. </summary>
+        void Release(uint32_t count = 1);
+
+        /// <summary> Returns the number of permits available. </summary>
+        uint32_t GetCount() const;
+
+    private:
+        mutable std::mutex _mutex;
+        std::condition_variable _released;
+        std::deque<Continuation> _continuations;
+        uint32_t _count;
+    };
+}
+}
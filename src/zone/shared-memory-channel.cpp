@@ -0,0 +1,507 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "shared-memory-channel.h"
+
+#include <platform/process.h>
+#include <platform/shared-memory.h>
+#include <platform/thread.h>
+
+#include <napa/log.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+using namespace napa;
+using namespace napa::zone::remote;
+
+namespace {
+
+    /// <summary> Magic stored by the server of a segment once it's initialized. </summary>
+    constexpr uint32_t SEGMENT_MAGIC = 0x5a5a4e4e;
+
+    /// <summary> Version of the segment layout. </summary>
+    constexpr uint32_t SEGMENT_VERSION = 1;
+
+    /// <summary> Number of channels a segment can hold at once. </summary>
+    constexpr uint32_t SLOT_COUNT = 16;
+
+    /// <summary> Bytes of each ring, a power of 2. Larger messages stream through the ring. </summary>
+    constexpr uint32_t RING_SIZE = 256 * 1024;
+
+    /// <summary> Longest name of a served segment, so it's a valid name of a segment on all platforms. </summary>
+    constexpr size_t MAX_NAME_LENGTH = 200;
+
+    /// <summary> Prefix of segment names, so they don't collide with segments of other programs. </summary>
+    constexpr const char* SEGMENT_NAME_PREFIX = "napa-zone-";
+
+    /// <summary> Alignment of the shared parts of a segment, so the two processes don't share cache lines needlessly. </summary>
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
+    /// <summary> Times a reader or writer checks its ring before waiting, which keeps the latency of busy channels low. </summary>
+    constexpr uint32_t SPIN_COUNT = 1024;
+
+    /// <summary> Interval of waits, after which the peer process is checked to still run. </summary>
+    constexpr std::chrono::milliseconds PEER_CHECK_INTERVAL(100);
+
+    /// <summary> Longest time to wait for the server of a segment to initialize it. </summary>
+    constexpr std::chrono::milliseconds INITIALIZE_TIMEOUT(1000);
+
+    /// <summary> Longest time for a client to wait for the server to accept its slot. </summary>
+    constexpr std::chrono::milliseconds ACCEPT_TIMEOUT(1000);
+
+    static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "The ring size must be a power of 2.");
+    static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && sizeof(std::atomic<uint32_t>) == sizeof(uint32_t)
+        && sizeof(std::atomic<int32_t>) == sizeof(int32_t),
+        "Atomics in shared memory must be lock free, so processes can share them.");
+
+    /// <summary> States of a slot. </summary>
+    enum SlotState : uint32_t {
+        SLOT_FREE = 0,
+
+        /// <summary> A client took the slot and is storing its pid. </summary>
+        SLOT_CLAIMING,
+
+        /// <summary> A client waits for the server to accept the slot. </summary>
+        SLOT_CLAIMED,
+
+        SLOT_OPEN,
+
+        /// <summary> One side closed its channel, the other frees the slot when it closes its own. </summary>
+        SLOT_CLIENT_LEFT,
+        SLOT_SERVER_LEFT
+    };
+
+    /// <summary>
+    ///     Positions of a ring, which only grow. The writer owns 'written' and the reader owns 'read',
+    ///     each on a cache line of its own. A side that waits sets its flag and waits on the signal of the other side,
+    ///     which the other side bumps each time it moves its position.
+    /// </summary>
+    struct alignas(CACHE_LINE_SIZE) RingHeader {
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> written;
+        std::atomic<uint32_t> writtenSignal;
+        std::atomic<uint32_t> readerWaiting;
+
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> read;
+        std::atomic<uint32_t> readSignal;
+        std::atomic<uint32_t> writerWaiting;
+    };
+
+    /// <summary> A slot holding a channel, with a ring of calls from the client and a ring of results from the server. </summary>
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint32_t> state;
+        std::atomic<int32_t> clientPid;
+
+        /// <summary> Set by either side when it shuts its channel down. </summary>
+        std::atomic<uint32_t> closed;
+
+        RingHeader requests;
+        RingHeader responses;
+    };
+
+    /// <summary> Header of a segment, followed by its slots and by the data of their rings. </summary>
+    struct alignas(CACHE_LINE_SIZE) SegmentHeader {
+        /// <summary> SEGMENT_MAGIC once the server initialized the segment. </summary>
+        std::atomic<uint32_t> magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t ringSize;
+
+        /// <summary> The serving process, 0 once it stopped serving. </summary>
+        std::atomic<int32_t> serverPid;
+
+        /// <summary> Bumped by clients claiming a slot, to wake the server. </summary>
+        std::atomic<uint32_t> claimSignal;
+    };
+
+    size_t GetDataBegin(uint32_t slotCount) {
+        auto end = sizeof(SegmentHeader) + slotCount * sizeof(Slot);
+        return (end + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+    }
+
+    size_t GetSegmentSize(uint32_t slotCount, uint32_t ringSize) {
+        return GetDataBegin(slotCount) + static_cast<size_t>(slotCount) * 2 * ringSize;
+    }
+
+    SegmentHeader* GetHeader(platform::SharedMemory& memory) {
+        return static_cast<SegmentHeader*>(memory.Data());
+    }
+
+    Slot* GetSlot(platform::SharedMemory& memory, uint32_t index) {
+        return reinterpret_cast<Slot*>(static_cast<char*>(memory.Data()) + sizeof(SegmentHeader)) + index;
+    }
+
+    char* GetRingData(platform::SharedMemory& memory, uint32_t index, bool responses) {
+        auto header = GetHeader(memory);
+        return static_cast<char*>(memory.Data())
+            + GetDataBegin(header->slotCount)
+            + (static_cast<size_t>(index) * 2 + (responses ? 1 : 0)) * header->ringSize;
+    }
+
+    void ResetRing(RingHeader& ring) {
+        ring.written.store(0, std::memory_order_relaxed);
+        ring.writtenSignal.store(0, std::memory_order_relaxed);
+        ring.readerWaiting.store(0, std::memory_order_relaxed);
+        ring.read.store(0, std::memory_order_relaxed);
+        ring.readSignal.store(0, std::memory_order_relaxed);
+        ring.writerWaiting.store(0, std::memory_order_relaxed);
+    }
+
+    /// <summary> Frees a slot no side uses anymore. </summary>
+    void ResetSlot(Slot& slot) {
+        ResetRing(slot.requests);
+        ResetRing(slot.responses);
+        slot.closed.store(0, std::memory_order_relaxed);
+        slot.clientPid.store(0, std::memory_order_relaxed);
+        slot.state.store(SLOT_FREE, std::memory_order_release);
+    }
+
+    /// <summary> Bumps a signal after a position moved, and wakes the other side if it waits. </summary>
+    void Signal(std::atomic<uint32_t>& signal, std::atomic<uint32_t>& waiting) {
+        signal.fetch_add(1);
+        if (waiting.load() != 0) {
+            platform::WakeOnSharedValue(signal);
+        }
+    }
+
+    bool IsValidName(const std::string& name) {
+        return !name.empty() && name.size() <= MAX_NAME_LENGTH && name.find_first_of("/\\") == std::string::npos;
+    }
+
+    /// <summary> One side of a slot, that writes one ring and reads the other. </summary>
+    class SharedMemoryChannel : public Channel {
+    public:
+        SharedMemoryChannel(std::shared_ptr<platform::SharedMemory> memory, uint32_t index, bool server, int32_t serverPid) :
+            _memory(std::move(memory)),
+            _header(GetHeader(*_memory)),
+            _slot(GetSlot(*_memory, index)),
+            _server(server),
+            _serverPid(serverPid),
+            _out(server ? &_slot->responses : &_slot->requests),
+            _outData(GetRingData(*_memory, index, server)),
+            _in(server ? &_slot->requests : &_slot->responses),
+            _inData(GetRingData(*_memory, index, !server)),
+            _ringSize(_header->ringSize) {
+        }
+
+        /// <summary> Shuts the channel down and leaves the slot, the side leaving last frees it. </summary>
+        ~SharedMemoryChannel() {
+            Shutdown();
+
+            uint32_t left = _server ? SLOT_SERVER_LEFT : SLOT_CLIENT_LEFT;
+            uint32_t otherLeft = _server ? SLOT_CLIENT_LEFT : SLOT_SERVER_LEFT;
+            for (;;) {
+                uint32_t state = _slot->state.load();
+                if (state == otherLeft) {
+                    ResetSlot(*_slot);
+                    return;
+                }
+                if (state != SLOT_OPEN) {
+                    return;
+                }
+                if (_slot->state.compare_exchange_weak(state, left)) {
+                    // A peer that exited won't leave, and the slot would never be freed.
+                    if (!IsPeerRunning()) {
+                        ResetSlot(*_slot);
+                    }
+                    return;
+                }
+            }
+        }
+
+        bool Write(const void* data, size_t size) override {
+            auto& ring = *_out;
+            auto bytes = static_cast<const char*>(data);
+            while (size > 0) {
+                auto written = ring.written.load(std::memory_order_relaxed);
+                uint64_t free = 0;
+                if (!Await(ring.readSignal, ring.writerWaiting, [&]() {
+                    free = _ringSize - (written - ring.read.load());
+                    return free > 0;
+                })) {
+                    return false;
+                }
+
+                auto count = static_cast<size_t>(std::min<uint64_t>(free, size));
+                auto offset = static_cast<size_t>(written & (_ringSize - 1));
+                auto first = std::min<size_t>(count, _ringSize - offset);
+                std::memcpy(_outData + offset, bytes, first);
+                std::memcpy(_outData, bytes + first, count - first);
+
+                ring.written.store(written + count);
+                Signal(ring.writtenSignal, ring.readerWaiting);
+
+                bytes += count;
+                size -= count;
+            }
+            return true;
+        }
+
+        bool Read(void* data, size_t size) override {
+            auto& ring = *_in;
+            auto bytes = static_cast<char*>(data);
+            while (size > 0) {
+                auto read = ring.read.load(std::memory_order_relaxed);
+                uint64_t available = 0;
+                if (!Await(ring.writtenSignal, ring.readerWaiting, [&]() {
+                    available = ring.written.load() - read;
+                    return available > 0;
+                })) {
+                    return false;
+                }
+
+                auto count = static_cast<size_t>(std::min<uint64_t>(available, size));
+                auto offset = static_cast<size_t>(read & (_ringSize - 1));
+                auto first = std::min<size_t>(count, _ringSize - offset);
+                std::memcpy(bytes, _inData + offset, first);
+                std::memcpy(bytes + first, _inData, count - first);
+
+                ring.read.store(read + count);
+                Signal(ring.readSignal, ring.writerWaiting);
+
+                bytes += count;
+                size -= count;
+            }
+            return true;
+        }
+
+        void Shutdown() override {
+            _slot->closed.store(1);
+            for (auto ring : { &_slot->requests, &_slot->responses }) {
+                ring->writtenSignal.fetch_add(1);
+                ring->readSignal.fetch_add(1);
+                platform::WakeOnSharedValue(ring->writtenSignal);
+                platform::WakeOnSharedValue(ring->readSignal);
+            }
+        }
+
+    private:
+
+        /// <summary> Waits until the ring is ready for this side, spinning first. </summary>
+        /// <returns> False if the channel was shut down, or the peer exited. </returns>
+        template <typename Ready>
+        bool Await(std::atomic<uint32_t>& signal, std::atomic<uint32_t>& waiting, Ready ready) {
+            for (uint32_t i = 0; i < SPIN_COUNT; i++) {
+                if (_slot->closed.load(std::memory_order_relaxed) != 0) {
+                    return false;
+                }
+                if (ready()) {
+                    return true;
+                }
+                platform::CpuRelax();
+            }
+
+            for (;;) {
+                auto sampled = signal.load();
+                waiting.store(1);
+
+                // Checked after the flag is set, so the other side either sees the flag, or moved before the check.
+                if (_slot->closed.load() != 0) {
+                    waiting.store(0);
+                    return false;
+                }
+                if (ready()) {
+                    waiting.store(0);
+                    return true;
+                }
+
+                auto woken = platform::WaitOnSharedValue(signal, sampled, PEER_CHECK_INTERVAL);
+                waiting.store(0);
+                if (!woken && !IsPeerRunning()) {
+                    Shutdown();
+                    return false;
+                }
+            }
+        }
+
+        bool IsPeerRunning() const {
+            if (_server) {
+                return platform::IsProcessRunning(_slot->clientPid.load());
+            }
+            return _header->serverPid.load() == _serverPid && platform::IsProcessRunning(_serverPid);
+        }
+
+        std::shared_ptr<platform::SharedMemory> _memory;
+        SegmentHeader* _header;
+        Slot* _slot;
+        bool _server;
+        int32_t _serverPid;
+
+        RingHeader* _out;
+        char* _outData;
+        RingHeader* _in;
+        char* _inData;
+        uint32_t _ringSize;
+    };
+}
+
+std::unique_ptr<SharedMemoryChannelListener> SharedMemoryChannelListener::Create(const std::string& name) {
+    if (!IsValidName(name)) {
+        return nullptr;
+    }
+
+    auto segmentName = SEGMENT_NAME_PREFIX + name;
+    auto size = GetSegmentSize(SLOT_COUNT, RING_SIZE);
+    auto memory = std::make_shared<platform::SharedMemory>(segmentName, size);
+    if (memory->IsOpen() && !memory->IsCreated()) {
+        if (memory->Size() >= sizeof(SegmentHeader)) {
+            auto header = GetHeader(*memory);
+            if (header->magic.load(std::memory_order_acquire) == SEGMENT_MAGIC
+                && platform::IsProcessRunning(header->serverPid.load())) {
+                LOG_ERROR("SharedMemoryChannel", "Segment \"%s\" is served by process %d.", name.c_str(), header->serverPid.load());
+                return nullptr;
+            }
+        }
+
+        // A segment left by a server that exited, or created by a client looking for a server.
+        memory.reset();
+        (void)platform::RemoveSharedMemory(segmentName);
+        memory = std::make_shared<platform::SharedMemory>(segmentName, size);
+    }
+
+    // Where segments can't be removed while mapped, a segment left by a server is initialized again.
+    if (!memory->IsOpen() || memory->Size() < size) {
+        return nullptr;
+    }
+
+    auto header = GetHeader(*memory);
+    header->magic.store(0);
+    header->version = SEGMENT_VERSION;
+    header->slotCount = SLOT_COUNT;
+    header->ringSize = RING_SIZE;
+    header->claimSignal.store(0);
+    for (uint32_t i = 0; i < SLOT_COUNT; i++) {
+        ResetSlot(*GetSlot(*memory, i));
+    }
+    header->serverPid.store(platform::Getpid());
+    header->magic.store(SEGMENT_MAGIC, std::memory_order_release);
+
+    return std::unique_ptr<SharedMemoryChannelListener>(new SharedMemoryChannelListener(std::move(segmentName), std::move(memory)));
+}
+
+SharedMemoryChannelListener::SharedMemoryChannelListener(std::string segmentName, std::shared_ptr<platform::SharedMemory> memory) :
+    _segmentName(std::move(segmentName)),
+    _memory(std::move(memory)),
+    _stopped(false) {
+}
+
+SharedMemoryChannelListener::~SharedMemoryChannelListener() {
+    Shutdown();
+
+    // Open channels keep the mapping, while new clients no longer find the segment.
+    GetHeader(*_memory)->serverPid.store(0);
+    (void)platform::RemoveSharedMemory(_segmentName);
+}
+
+std::unique_ptr<Channel> SharedMemoryChannelListener::Accept() {
+    auto header = GetHeader(*_memory);
+    while (!_stopped) {
+        auto sampled = header->claimSignal.load();
+        for (uint32_t i = 0; i < SLOT_COUNT; i++) {
+            auto& slot = *GetSlot(*_memory, i);
+            uint32_t state = slot.state.load(std::memory_order_acquire);
+            if (state == SLOT_CLAIMED) {
+                if (!platform::IsProcessRunning(slot.clientPid.load())) {
+                    // The client exited while waiting, unless it gave the slot up meanwhile.
+                    if (slot.state.compare_exchange_strong(state, SLOT_CLAIMING)) {
+                        ResetSlot(slot);
+                    }
+                } else if (slot.state.compare_exchange_strong(state, SLOT_OPEN)) {
+                    platform::WakeOnSharedValue(slot.state);
+                    return std::make_unique<SharedMemoryChannel>(_memory, i, true, header->serverPid.load());
+                }
+            } else if (state == SLOT_SERVER_LEFT && !platform::IsProcessRunning(slot.clientPid.load())) {
+                // The client exited without leaving the slot.
+                if (slot.state.compare_exchange_strong(state, SLOT_CLAIMING)) {
+                    ResetSlot(slot);
+                }
+            }
+        }
+        (void)platform::WaitOnSharedValue(header->claimSignal, sampled, PEER_CHECK_INTERVAL);
+    }
+    return nullptr;
+}
+
+void SharedMemoryChannelListener::Shutdown() {
+    _stopped = true;
+    auto header = GetHeader(*_memory);
+    header->claimSignal.fetch_add(1);
+    platform::WakeOnSharedValue(header->claimSignal);
+}
+
+std::unique_ptr<Channel> napa::zone::remote::ConnectSharedMemoryChannel(const std::string& name) {
+    if (!IsValidName(name)) {
+        return nullptr;
+    }
+
+    auto segmentName = SEGMENT_NAME_PREFIX + name;
+    auto memory = std::make_shared<platform::SharedMemory>(segmentName, sizeof(SegmentHeader));
+    if (!memory->IsOpen()) {
+        return nullptr;
+    }
+    if (memory->IsCreated()) {
+        // No process serves the name.
+        memory.reset();
+        (void)platform::RemoveSharedMemory(segmentName);
+        return nullptr;
+    }
+
+    auto header = GetHeader(*memory);
+    auto deadline = std::chrono::steady_clock::now() + INITIALIZE_TIMEOUT;
+    while (header->magic.load(std::memory_order_acquire) != SEGMENT_MAGIC) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return nullptr;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (header->version != SEGMENT_VERSION
+        || header->ringSize == 0
+        || (header->ringSize & (header->ringSize - 1)) != 0
+        || memory->Size() < GetSegmentSize(header->slotCount, header->ringSize)) {
+        return nullptr;
+    }
+
+    auto serverPid = header->serverPid.load();
+    if (!platform::IsProcessRunning(serverPid)) {
+        return nullptr;
+    }
+
+    for (uint32_t i = 0; i < header->slotCount; i++) {
+        auto& slot = *GetSlot(*memory, i);
+        uint32_t state = SLOT_FREE;
+        if (!slot.state.compare_exchange_strong(state, SLOT_CLAIMING)) {
+            continue;
+        }
+        slot.clientPid.store(platform::Getpid());
+        slot.state.store(SLOT_CLAIMED);
+
+        header->claimSignal.fetch_add(1);
+        platform::WakeOnSharedValue(header->claimSignal);
+
+        auto acceptDeadline = std::chrono::steady_clock::now() + ACCEPT_TIMEOUT;
+        while (slot.state.load(std::memory_order_acquire) == SLOT_CLAIMED) {
+            if (std::chrono::steady_clock::now() >= acceptDeadline
+                || header->serverPid.load() != serverPid
+                || !platform::IsProcessRunning(serverPid)) {
+                // Given up, unless the server accepted the slot meanwhile.
+                state = SLOT_CLAIMED;
+                if (slot.state.compare_exchange_strong(state, SLOT_CLAIMING)) {
+                    ResetSlot(slot);
+                    return nullptr;
+                }
+                break;
+            }
+            (void)platform::WaitOnSharedValue(slot.state, SLOT_CLAIMED, PEER_CHECK_INTERVAL);
+        }
+
+        if (slot.state.load(std::memory_order_acquire) != SLOT_OPEN) {
+            return nullptr;
+        }
+        return std::make_unique<SharedMemoryChannel>(std::move(memory), i, false, serverPid);
+    }
+
+    LOG_WARNING("SharedMemoryChannel", "All %u slots of segment \"%s\" are taken.", header->slotCount, name.c_str());
+    return nullptr;
+}
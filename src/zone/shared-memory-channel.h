@@ -0,0 +1,59 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "remote-channel.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace napa {
+namespace platform {
+    class SharedMemory;
+}
+
+namespace zone {
+namespace remote {
+
+    /// <summary>
+    ///     Listens for processes of the host connecting to a served zone through a named shared memory segment.
+    ///     The segment has a fixed number of slots, each holding a pair of single producer, single consumer byte rings,
+    ///     one for calls and one for results. A client claims a free slot, and the listener accepts it as a channel.
+    ///     Readers and writers spin briefly, then wait on a futex shared between processes.
+    /// </summary>
+    /// <remarks>
+    ///     Each side of a slot checks that the other process still runs while it waits, so the channels of a process
+    ///     that exits without closing them fail, and its slots are freed.
+    /// </remarks>
+    class SharedMemoryChannelListener : public ChannelListener {
+    public:
+
+        /// <summary> Creates the segment of a served zone. </summary>
+        /// <param name="name"> The name of the segment, without path separators. </param>
+        /// <returns> nullptr if the name is invalid, the segment can't be created, or a running process serves it. </returns>
+        static std::unique_ptr<SharedMemoryChannelListener> Create(const std::string& name);
+
+        /// <summary> Marks the segment as no longer served, and removes it once its channels are closed. </summary>
+        ~SharedMemoryChannelListener();
+
+        std::unique_ptr<Channel> Accept() override;
+        void Shutdown() override;
+
+    private:
+        SharedMemoryChannelListener(std::string segmentName, std::shared_ptr<platform::SharedMemory> memory);
+
+        std::string _segmentName;
+        std::shared_ptr<platform::SharedMemory> _memory;
+        std::atomic<bool> _stopped;
+    };
+
+    /// <summary> Connects to a zone served on a shared memory segment of the host, by claiming a slot of the segment. </summary>
+    /// <param name="name"> The name of the segment. </param>
+    /// <returns> nullptr if no running process serves the segment, or all of its slots are taken. </returns>
+    std::unique_ptr<Channel> ConnectSharedMemoryChannel(const std::string& name);
+}
+}
+}
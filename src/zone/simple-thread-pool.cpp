@@ -13,10 +13,12 @@ void SimpleThreadPool::Worker::operator()() {
     while (true) {
         {
             std::unique_lock<std::mutex> lock(_pool._queueLock);
-            if (!_pool._isStopped) {
+            if (!_pool._isStopped && _pool._taskQueue.empty()) {
+                _pool._idleWorkers++;
                 _pool._queueCondition.wait(lock, [this]() {
                     return _pool._isStopped || !_pool._taskQueue.empty();
                 });
+                _pool._idleWorkers--;
             }
 
             // Drain all existing tasks before actually stopping.
@@ -26,18 +28,25 @@ void SimpleThreadPool::Worker::operator()() {
 
             task = std::move(_pool._taskQueue.front());
             _pool._taskQueue.pop();
+            _pool._queueLength--;
         }
 
+        _pool._activeWorkers++;
         task();
+        task = nullptr;
+        _pool._activeWorkers--;
     }
 }
 
-SimpleThreadPool::SimpleThreadPool(uint32_t numberOfWorkers) : _isStopped(false) {
-    _workers.reserve(numberOfWorkers);
+SimpleThreadPool::SimpleThreadPool(uint32_t numberOfWorkers) :
+    _maxWorkers(numberOfWorkers),
+    _idleWorkers(0),
+    _queueLength(0),
+    _activeWorkers(0),
+    _workerCount(0),
+    _isStopped(false) {
 
-    for (uint32_t i = 0; i < numberOfWorkers; ++i) {
-        _workers.emplace_back(Worker(*this));
-    }
+    _workers.reserve(numberOfWorkers);
 }
 
 SimpleThreadPool::~SimpleThreadPool() {
@@ -48,9 +57,38 @@ SimpleThreadPool::~SimpleThreadPool() {
 
     _queueCondition.notify_all();
 
+    // No worker is started once the pool is stopped, so the list doesn't change anymore.
     for (auto& thread : _workers) {
         if (thread.joinable()) {
             thread.join();
         }
     }
 }
+
+size_t SimpleThreadPool::GetQueueLength() const {
+    return _queueLength;
+}
+
+uint32_t SimpleThreadPool::GetActiveWorkerCount() const {
+    return _activeWorkers;
+}
+
+uint32_t SimpleThreadPool::GetWorkerCount() const {
+    return _workerCount;
+}
+
+void SimpleThreadPool::Post(std::function<void()> task) {
+    {
+        std::unique_lock<std::mutex> lock(_queueLock);
+        _taskQueue.emplace(std::move(task));
+        _queueLength++;
+
+        // Idle workers may already be woken up by earlier tasks, start more while tasks outnumber them.
+        if (!_isStopped && _taskQueue.size() > _idleWorkers && _workers.size() < _maxWorkers) {
+            _workers.emplace_back(Worker(*this));
+            _workerCount++;
+        }
+    }
+
+    _queueCondition.notify_one();
+}
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <functional>
 #include <mutex>
@@ -16,11 +17,12 @@ namespace napa {
 namespace zone {
 
     /// <summary> Simple thread pool. </summary>
+    /// <remarks> Threads are started on demand, when a task comes and no thread is idle, up to the number of workers. </remarks>
     class SimpleThreadPool {
     public:
 
         /// <summary> Constructor. </summary>
-        /// <param name="numberOfWorkers"> Number of workers. </param>
+        /// <param name="numberOfWorkers"> Maximum number of workers, which bounds the concurrency. </param>
         explicit SimpleThreadPool(uint32_t numberOfWorkers);
 
         /// <summary> Destructor. </summary>
@@ -32,8 +34,20 @@ namespace zone {
         template <typename T, typename... Args>
         void Execute(T&& function, Args&&... args);
 
+        /// <summary> Returns the number of tasks waiting for a worker. </summary>
+        size_t GetQueueLength() const;
+
+        /// <summary> Returns the number of workers that are running a task. </summary>
+        uint32_t GetActiveWorkerCount() const;
+
+        /// <summary> Returns the number of workers that were started. </summary>
+        uint32_t GetWorkerCount() const;
+
     private:
 
+        /// <summary> Queues a task, starting a worker if none is idle. </summary>
+        void Post(std::function<void()> task);
+
         /// <summary> Class for worker main loop. </summary>
         class Worker {
         public:
@@ -53,8 +67,19 @@ namespace zone {
         std::vector<std::thread> _workers;
         std::queue<std::function<void()>> _taskQueue;
 
+        /// <summary> Maximum number of workers. </summary>
+        uint32_t _maxWorkers;
+
+        /// <summary> Number of workers waiting for tasks, guarded by the queue lock. </summary>
+        uint32_t _idleWorkers;
+
+        /// <summary> Metrics, readable without the queue lock. </summary>
+        std::atomic<size_t> _queueLength;
+        std::atomic<uint32_t> _activeWorkers;
+        std::atomic<uint32_t> _workerCount;
+
         /// <summary> Critical section and event for task queue. </summary>
-        std::mutex _queueLock;
+        mutable std::mutex _queueLock;
         std::condition_variable _queueCondition;
 
         /// <summary> Flag to stop threads. </summary>
@@ -64,14 +89,7 @@ namespace zone {
 
     template <typename T, typename... Args>
     void SimpleThreadPool::Execute(T&& function, Args&&... args) {
-        auto task = std::bind(std::forward<T>(function), std::forward<Args>(args)...);
-
-        {
-            std::unique_lock<std::mutex> lock(_queueLock);
-            _taskQueue.emplace(task);
-        }
-
-        _queueCondition.notify_one();
+        Post(std::bind(std::forward<T>(function), std::forward<Args>(args)...));
     }
 
 }
@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "slow-task-detector.h"
+
+#include <algorithm>
+
+using namespace napa::zone;
+
+/// <summary> Start time value of a slot without a running call. </summary>
+static const int64_t NOT_RUNNING = 0;
+
+/// <summary> The longest interval between checks, slow calls are reported at most that late. </summary>
+static const std::chrono::milliseconds MAX_CHECK_INTERVAL(100);
+
+static int64_t NowInNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+SlowTaskDetector::SlowTaskDetector(uint32_t slotCount, std::chrono::milliseconds threshold, SlowTaskHandler handler) :
+    _slots(std::make_unique<Slot[]>(slotCount)),
+    _slotCount(slotCount),
+    _threshold(threshold),
+    _handler(std::move(handler)),
+    _running(true) {
+
+    for (uint32_t i = 0; i < _slotCount; i++) {
+        _slots[i].startTime = NOT_RUNNING;
+        _slots[i].sequence = 0;
+        _slots[i].reportedSequence = 0;
+        _slots[i].isolate = nullptr;
+    }
+
+    _thread = std::thread(&SlowTaskDetector::DetectorThreadFunc, this);
+}
+
+SlowTaskDetector::~SlowTaskDetector() {
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _running = false;
+    }
+    _stopEvent.notify_one();
+    _thread.join();
+}
+
+void SlowTaskDetector::Begin(uint32_t slot, v8::Isolate* isolate) {
+    auto& entry = _slots[slot];
+
+    // The sequence and isolate are published by the start time store, which the detector reads first.
+    entry.sequence.fetch_add(1, std::memory_order_relaxed);
+    entry.isolate.store(isolate, std::memory_order_relaxed);
+    entry.startTime.store(NowInNanoseconds());
+}
+
+void SlowTaskDetector::End(uint32_t slot) {
+    _slots[slot].startTime.store(NOT_RUNNING);
+}
+
+bool SlowTaskDetector::IsRunning(uint32_t slot, uint64_t sequence) const {
+    const auto& entry = _slots[slot];
+    return entry.startTime.load() != NOT_RUNNING && entry.sequence.load() == sequence;
+}
+
+void SlowTaskDetector::DetectorThreadFunc() {
+    // Checking a few times per threshold keeps the report late by a fraction of the threshold.
+    auto interval = std::max(std::min(_threshold / 4, MAX_CHECK_INTERVAL), std::chrono::milliseconds(1));
+
+    std::unique_lock<std::mutex> lock(_lock);
+    while (_running) {
+        lock.unlock();
+        CheckSlots();
+        lock.lock();
+
+        _stopEvent.wait_for(lock, interval, [this]() { return !_running; });
+    }
+}
+
+void SlowTaskDetector::CheckSlots() {
+    auto now = NowInNanoseconds();
+    auto threshold = std::chrono::duration_cast<std::chrono::nanoseconds>(_threshold).count();
+
+    for (uint32_t i = 0; i < _slotCount; i++) {
+        auto& entry = _slots[i];
+
+        auto startTime = entry.startTime.load();
+        if (startTime == NOT_RUNNING || now - startTime < threshold) {
+            continue;
+        }
+
+        // The call may have been replaced meanwhile, the handler tells them apart with IsRunning.
+        auto sequence = entry.sequence.load(std::memory_order_relaxed);
+        if (entry.reportedSequence.exchange(sequence) == sequence) {
+            continue;
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(now - startTime));
+        _handler(i, sequence, entry.isolate.load(std::memory_order_relaxed), elapsed);
+    }
+}
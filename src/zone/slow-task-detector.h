@@ -0,0 +1,90 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace v8 {
+    class Isolate;
+}
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Detects the calls running on the workers of a zone for longer than a threshold, from a single thread. </summary>
+    /// <remarks>
+    ///     Like the timeout watchdog, each worker owns a slot where it publishes the start of its current call,
+    ///     so workers only do a few atomic operations per call. Each slow call is reported once.
+    /// </remarks>
+    class SlowTaskDetector {
+    public:
+
+        /// <summary> Called on the detector thread for a call that ran past the threshold. </summary>
+        /// <param name="slot"> The worker slot. </param>
+        /// <param name="sequence"> Identifies the call within its slot, see IsRunning. </param>
+        /// <param name="isolate"> The isolate the call runs on. </param>
+        /// <param name="elapsed"> How long the call has been running. </param>
+        using SlowTaskHandler = std::function<void(
+            uint32_t slot, uint64_t sequence, v8::Isolate* isolate, std::chrono::milliseconds elapsed)>;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="slotCount"> The number of slots, one per worker. </param>
+        /// <param name="threshold"> The time a call runs before it is reported. </param>
+        /// <param name="handler"> Handles slow calls, typically captures their stack. </param>
+        SlowTaskDetector(uint32_t slotCount, std::chrono::milliseconds threshold, SlowTaskHandler handler);
+
+        /// <summary> Destructor. Stops the detector thread. </summary>
+        ~SlowTaskDetector();
+
+        SlowTaskDetector(const SlowTaskDetector&) = delete;
+        SlowTaskDetector& operator=(const SlowTaskDetector&) = delete;
+
+        /// <summary> Publishes the call a worker is about to run. </summary>
+        /// <param name="slot"> The worker slot. </param>
+        /// <param name="isolate"> The isolate the call runs on. </param>
+        void Begin(uint32_t slot, v8::Isolate* isolate);
+
+        /// <summary> Clears the slot of a worker once its call returned. </summary>
+        void End(uint32_t slot);
+
+        /// <summary> Returns true if the call reported with the sequence is still running on the worker. </summary>
+        /// <remarks> Called on the worker, i.e. by the handler's interrupt, to tell the reported call from later ones. </remarks>
+        bool IsRunning(uint32_t slot, uint64_t sequence) const;
+
+    private:
+
+        /// <summary> A worker slot, aligned to a cache line so workers don't share one another's. </summary>
+        struct alignas(64) Slot {
+            std::atomic<int64_t> startTime;
+            std::atomic<uint64_t> sequence;
+            std::atomic<uint64_t> reportedSequence;
+            std::atomic<v8::Isolate*> isolate;
+        };
+
+        /// <summary> Polls the slots and reports the calls that run past the threshold. </summary>
+        void DetectorThreadFunc();
+
+        /// <summary> Reports the calls past the threshold that weren't reported yet. </summary>
+        void CheckSlots();
+
+        std::unique_ptr<Slot[]> _slots;
+        uint32_t _slotCount;
+        std::chrono::milliseconds _threshold;
+        SlowTaskHandler _handler;
+
+        std::mutex _lock;
+        std::condition_variable _stopEvent;
+        bool _running;
+
+        std::thread _thread;
+    };
+}
+}
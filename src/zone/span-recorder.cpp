@@ -0,0 +1,215 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "span-recorder.h"
+
+#include <napa/log.h>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> Returns the next number of a SplitMix64 generator seeded once per thread. </summary>
+    uint64_t NextRandom() {
+        thread_local uint64_t state = (static_cast<uint64_t>(std::random_device()()) << 32)
+            ^ static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()))
+            ^ static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+
+        auto z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    /// <summary> Returns the sample threshold of a rate, see SpanRecorder::_sampleThreshold. </summary>
+    uint64_t ToThreshold(double sampleRate) {
+        if (!(sampleRate > 0)) {
+            return 0;
+        }
+        if (sampleRate >= 1) {
+            return UINT64_MAX;
+        }
+        return static_cast<uint64_t>(sampleRate * 18446744073709551615.0);
+    }
+}
+
+SpanRecorder& SpanRecorder::GetInstance() {
+    static SpanRecorder instance;
+    return instance;
+}
+
+SpanRecorder::SpanRecorder() : _sampleThreshold(0), _capacity(DEFAULT_SPAN_CAPACITY), _first(0), _dropped(0) {}
+
+uint64_t SpanRecorder::NewId() {
+    uint64_t id;
+    do {
+        id = NextRandom();
+    } while (id == 0);
+    return id;
+}
+
+int64_t SpanRecorder::Now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::string SpanRecorder::FormatId(uint64_t id) {
+    static const char digits[] = "0123456789abcdef";
+    std::string text(16, '0');
+    for (auto i = 15; i >= 0; i--, id >>= 4) {
+        text[i] = digits[id & 0xf];
+    }
+    return text;
+}
+
+bool SpanRecorder::ParseId(const std::string& text, uint64_t& id) {
+    if (text.empty() || text.size() > 16) {
+        return false;
+    }
+
+    uint64_t value = 0;
+    for (auto c : text) {
+        uint64_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = static_cast<uint64_t>(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = static_cast<uint64_t>(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = static_cast<uint64_t>(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        value = (value << 4) | digit;
+    }
+    id = value;
+    return true;
+}
+
+std::string SpanRecorder::ToJson(const std::vector<Span>& spans) {
+    rapidjson::StringBuffer stringBuffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(stringBuffer);
+
+    auto writeId = [&](const char* name, uint64_t id) {
+        auto text = FormatId(id);
+        writer.Key(name);
+        writer.String(text.c_str(), static_cast<rapidjson::SizeType>(text.size()));
+    };
+
+    writer.StartArray();
+    for (auto& span : spans) {
+        writer.StartObject();
+        writeId("traceId", span.traceId);
+        writeId("spanId", span.spanId);
+        if (span.parentSpanId != 0) {
+            writeId("parentSpanId", span.parentSpanId);
+        }
+        writer.Key("kind");
+        writer.String(span.kind);
+        writer.Key("name");
+        writer.String(span.name.c_str(), static_cast<rapidjson::SizeType>(span.name.size()));
+        writer.Key("target");
+        writer.String(span.target.c_str(), static_cast<rapidjson::SizeType>(span.target.size()));
+        writer.Key("startTime");
+        writer.Int64(span.startTime);
+        writer.Key("duration");
+        writer.Int64(span.duration);
+        if (span.timing.queue != 0) {
+            writer.Key("timing");
+            writer.StartObject();
+            writer.Key("queue");
+            writer.Int64(span.timing.queue);
+            writer.Key("unmarshall");
+            writer.Int64(span.timing.unmarshall);
+            writer.Key("execute");
+            writer.Int64(span.timing.execute);
+            writer.Key("marshall");
+            writer.Int64(span.timing.marshall);
+            writer.EndObject();
+        }
+        writer.Key("code");
+        writer.Int(static_cast<int>(span.code));
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    return std::string(stringBuffer.GetString(), stringBuffer.GetSize());
+}
+
+void SpanRecorder::SetSampling(double sampleRate, size_t capacity) {
+    NAPA_ASSERT(capacity > 0, "The span capacity must be positive.");
+
+    std::lock_guard<std::mutex> lock(_lock);
+    if (capacity != _capacity) {
+        // Keep the newest spans that fit, in order.
+        std::rotate(_spans.begin(), _spans.begin() + _first, _spans.end());
+        if (_spans.size() > capacity) {
+            _dropped += _spans.size() - capacity;
+            _spans.erase(_spans.begin(), _spans.end() - capacity);
+        }
+        _first = 0;
+        _capacity = capacity;
+    }
+    _sampleThreshold.store(ToThreshold(sampleRate), std::memory_order_relaxed);
+
+    NAPA_DEBUG("SpanRecorder", "Spans are sampled at rate %f with capacity %zu.", sampleRate, capacity);
+}
+
+double SpanRecorder::GetSampleRate() const {
+    return static_cast<double>(_sampleThreshold.load(std::memory_order_relaxed)) / 18446744073709551615.0;
+}
+
+TraceContext SpanRecorder::StartCall(const napa::CallOptions& options, const TraceContext* caller) {
+    TraceContext trace;
+    if (options.trace_id != 0) {
+        trace.traceId = options.trace_id;
+        trace.parentSpanId = options.parent_span_id;
+        trace.sampled = options.trace_sampled != 0;
+    } else if (caller != nullptr && caller->traceId != 0) {
+        trace.traceId = caller->traceId;
+        trace.parentSpanId = caller->spanId;
+        trace.sampled = caller->sampled;
+    } else {
+        // The head of a trace decides for all its calls.
+        auto threshold = _sampleThreshold.load(std::memory_order_relaxed);
+        trace.traceId = NewId();
+        trace.sampled = threshold != 0 && NextRandom() <= threshold;
+    }
+    trace.spanId = NewId();
+    return trace;
+}
+
+void SpanRecorder::Record(Span span) {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_spans.size() < _capacity) {
+        _spans.emplace_back(std::move(span));
+        return;
+    }
+
+    _spans[_first] = std::move(span);
+    _first = (_first + 1) % _capacity;
+    _dropped++;
+}
+
+std::vector<Span> SpanRecorder::Export() {
+    std::vector<Span> spans;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        spans.swap(_spans);
+        std::rotate(spans.begin(), spans.begin() + _first, spans.end());
+        _first = 0;
+    }
+    return spans;
+}
+
+uint64_t SpanRecorder::GetDropped() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _dropped;
+}
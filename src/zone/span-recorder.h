@@ -0,0 +1,183 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> The number of spans kept for export by default, the oldest spans are overwritten by new ones. </summary>
+    constexpr size_t DEFAULT_SPAN_CAPACITY = 4096;
+
+    /// <summary> Trace and span of a zone call, which the zone calls it makes inherit. </summary>
+    struct TraceContext {
+
+        /// <summary> The trace of the request the call serves, 0 for none. </summary>
+        uint64_t traceId = 0;
+
+        /// <summary> The span of the call. </summary>
+        uint64_t spanId = 0;
+
+        /// <summary> The span of the call that made this call, 0 for the root of a trace. </summary>
+        uint64_t parentSpanId = 0;
+
+        /// <summary> Whether spans of the trace are recorded, decided once by the root of the trace. </summary>
+        bool sampled = false;
+    };
+
+    /// <summary> The timing of a sampled zone call, or of a store operation made by one. </summary>
+    struct Span {
+        uint64_t traceId;
+        uint64_t spanId;
+        uint64_t parentSpanId;
+
+        /// <summary> "call" for zone calls, "store" for store operations, a string literal. </summary>
+        const char* kind;
+
+        /// <summary> "module.function" of calls, the operation of store operations, i.e. "get". </summary>
+        std::string name;
+
+        /// <summary> The zone a call ran in, or the store an operation was made on. </summary>
+        std::string target;
+
+        /// <summary> Microseconds since epoch when the span started. </summary>
+        int64_t startTime;
+
+        /// <summary> Nanoseconds from the start to the end of the span. </summary>
+        int64_t duration;
+
+        /// <summary> The phases of calls, zeros for store operations. </summary>
+        napa::CallTiming timing;
+
+        /// <summary> The result code of calls, NAPA_RESULT_SUCCESS for store operations. </summary>
+        napa::ResultCode code;
+    };
+
+    /// <summary>
+    ///     Decides which traces are sampled when they begin, and keeps the spans of sampled traces in a ring buffer
+    ///     until they are exported. Calls inherit the decision of the call they're made from, so a trace is recorded
+    ///     either completely or not at all, and unsampled calls only pay for two random ids.
+    /// </summary>
+    class SpanRecorder {
+    public:
+
+        /// <summary> Returns the recorder of the process. </summary>
+        static SpanRecorder& GetInstance();
+
+        /// <summary> Returns a random id for traces and spans, never 0. </summary>
+        static uint64_t NewId();
+
+        /// <summary> Returns the system clock time in microseconds since epoch. </summary>
+        static int64_t Now();
+
+        /// <summary> Formats an id as 16 lowercase hex digits. </summary>
+        static std::string FormatId(uint64_t id);
+
+        /// <summary> Parses an id of 1 to 16 hex digits. </summary>
+        /// <returns> False if the text is not a valid id. </returns>
+        static bool ParseId(const std::string& text, uint64_t& id);
+
+        /// <summary> Formats spans as a JSON array of objects, with ids formatted by FormatId. </summary>
+        static std::string ToJson(const std::vector<Span>& spans);
+
+        /// <summary> Non-copyable. </summary>
+        SpanRecorder(const SpanRecorder&) = delete;
+        SpanRecorder& operator=(const SpanRecorder&) = delete;
+
+        /// <summary> Sets the share of new traces that are sampled, and how many spans are kept for export. </summary>
+        /// <param name="sampleRate"> From 0, which samples no traces, to 1, which samples all of them. </param>
+        /// <param name="capacity"> The number of spans kept, spans not yet exported are dropped if it shrinks. </param>
+        void SetSampling(double sampleRate, size_t capacity = DEFAULT_SPAN_CAPACITY);
+
+        /// <summary> Returns the share of new traces that are sampled. </summary>
+        double GetSampleRate() const;
+
+        /// <summary> Begins the trace of a call. </summary>
+        /// <param name="options"> The options of the call, which continue the trace they carry. </param>
+        /// <param name="caller"> The trace of the call the call is made from, or null. </param>
+        /// <returns> A new span of the trace of the options or the caller, or of a new trace sampled by the sample rate. </returns>
+        TraceContext StartCall(const napa::CallOptions& options, const TraceContext* caller);
+
+        /// <summary> Keeps a span for export, overwriting the oldest span if the buffer is full. </summary>
+        void Record(Span span);
+
+        /// <summary> Takes the spans recorded since the last export, oldest first. </summary>
+        std::vector<Span> Export();
+
+        /// <summary> Returns the number of spans overwritten before they were exported. </summary>
+        uint64_t GetDropped() const;
+
+    private:
+        SpanRecorder();
+
+        /// <summary> New traces are sampled when a random number is below the threshold, 0 samples none. </summary>
+        std::atomic<uint64_t> _sampleThreshold;
+
+        /// <summary> Guards the ring buffer. </summary>
+        mutable std::mutex _lock;
+
+        /// <summary> The ring buffer, the oldest span is at _first once it's full. </summary>
+        std::vector<Span> _spans;
+        size_t _capacity;
+        size_t _first;
+        uint64_t _dropped;
+    };
+
+    /// <summary> Records a span of a store operation for the lifetime of the scope, if the trace it's made in is sampled. </summary>
+    class SpanScope {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="parent"> The trace of the call the operation is made by, or null. </param>
+        /// <param name="kind"> The kind of the span, a string literal. </param>
+        /// <param name="name"> The name of the operation, a string literal. </param>
+        /// <param name="target"> The object of the operation, i.e. the id of the store. </param>
+        SpanScope(const TraceContext* parent, const char* kind, const char* name, const char* target) :
+            _parent(parent != nullptr && parent->sampled ? parent : nullptr),
+            _kind(kind),
+            _name(name),
+            _target(target),
+            _startTime(_parent != nullptr ? SpanRecorder::Now() : 0),
+            _begin(_parent != nullptr ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point()) {}
+
+        /// <summary> Destructor. Records the span. </summary>
+        ~SpanScope() {
+            if (_parent != nullptr) {
+                auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - _begin).count();
+                SpanRecorder::GetInstance().Record({
+                    _parent->traceId,
+                    SpanRecorder::NewId(),
+                    _parent->spanId,
+                    _kind,
+                    _name,
+                    _target,
+                    _startTime,
+                    duration,
+                    { 0, 0, 0, 0 },
+                    NAPA_RESULT_SUCCESS });
+            }
+        }
+
+        SpanScope(const SpanScope&) = delete;
+        SpanScope& operator=(const SpanScope&) = delete;
+
+    private:
+        const TraceContext* _parent;
+        const char* _kind;
+        const char* _name;
+        const char* _target;
+        int64_t _startTime;
+        std::chrono::steady_clock::time_point _begin;
+    };
+}
+}
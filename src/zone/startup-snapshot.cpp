@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "startup-snapshot.h"
+
+#include <napa/log.h>
+
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> Reads a whole file, returns false if it can't be opened. </summary>
+    bool ReadFile(const std::string& path, std::string& content) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    /// <summary> Writes a whole file, returns false if it can't be written. </summary>
+    bool WriteFile(const std::string& path, const std::string& content) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+
+        file.write(content.data(), content.size());
+        return file.good();
+    }
+}
+
+std::shared_ptr<StartupSnapshot> StartupSnapshot::Get(const settings::ZoneSettings& settings) {
+    if (settings.startupScript.empty() && settings.startupSnapshot.empty()) {
+        return nullptr;
+    }
+
+    static std::mutex mutex;
+    static std::unordered_map<std::string, std::shared_ptr<StartupSnapshot>> snapshots;
+
+    // Workers of all zones wait here while the first of them builds the snapshot, so it is built once.
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto key = settings.startupScript + '\n' + settings.startupSnapshot;
+    auto iter = snapshots.find(key);
+    if (iter != snapshots.end()) {
+        return iter->second;
+    }
+
+    // A snapshot that failed to load is cached too, so zones don't retry and log on each worker.
+    auto snapshot = Load(settings.startupScript, settings.startupSnapshot);
+    snapshots.emplace(std::move(key), snapshot);
+    return snapshot;
+}
+
+std::shared_ptr<StartupSnapshot> StartupSnapshot::Load(const std::string& startupScript, const std::string& snapshotPath) {
+    std::string blob;
+    if (!snapshotPath.empty() && ReadFile(snapshotPath, blob) && !blob.empty()) {
+        NAPA_DEBUG("StartupSnapshot", "Loaded startup snapshot \"%s\".", snapshotPath.c_str());
+        return std::shared_ptr<StartupSnapshot>(new StartupSnapshot(std::move(blob)));
+    }
+
+    if (startupScript.empty()) {
+        LOG_ERROR("StartupSnapshot", "Failed to read startup snapshot \"%s\".", snapshotPath.c_str());
+        return nullptr;
+    }
+
+    std::string source;
+    if (!ReadFile(startupScript, source)) {
+        LOG_ERROR("StartupSnapshot", "Failed to read startup script \"%s\".", startupScript.c_str());
+        return nullptr;
+    }
+
+    // V8 runs the script in a fresh isolate and serializes the resulting heap.
+    auto data = v8::V8::CreateSnapshotDataBlob(source.c_str());
+    if (data.data == nullptr || data.raw_size <= 0) {
+        LOG_ERROR("StartupSnapshot", "Failed to create startup snapshot from \"%s\".", startupScript.c_str());
+        delete[] data.data;
+        return nullptr;
+    }
+
+    blob.assign(data.data, data.raw_size);
+    delete[] data.data;
+
+    NAPA_DEBUG("StartupSnapshot", "Created startup snapshot from \"%s\", %d bytes.", startupScript.c_str(), data.raw_size);
+
+    if (!snapshotPath.empty() && !WriteFile(snapshotPath, blob)) {
+        LOG_WARNING("StartupSnapshot", "Failed to save startup snapshot \"%s\".", snapshotPath.c_str());
+    }
+
+    return std::shared_ptr<StartupSnapshot>(new StartupSnapshot(std::move(blob)));
+}
+
+StartupSnapshot::StartupSnapshot(std::string blob) : _blob(std::move(blob)) {
+    _data.data = _blob.data();
+    _data.raw_size = static_cast<int>(_blob.size());
+}
+
+v8::StartupData* StartupSnapshot::GetStartupData() {
+    return &_data;
+}
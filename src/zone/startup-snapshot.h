@@ -0,0 +1,52 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <settings/settings.h>
+
+#include <v8.h>
+
+#include <memory>
+#include <string>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A V8 startup snapshot that zone workers create their isolates from. </summary>
+    /// <remarks>
+    ///     Snapshots are shared process wide, since V8 requires the blob to outlive every isolate created from it.
+    ///     It only holds plain JavaScript state, napa core modules bind native callbacks and are still set up per worker.
+    /// </remarks>
+    class StartupSnapshot {
+    public:
+
+        /// <summary> Gets the snapshot of a zone, building it from the startup script on first use. </summary>
+        /// <param name="settings"> The zone settings, which name the startup script and the snapshot file. </param>
+        /// <returns> The snapshot, nullptr if the zone uses none or it couldn't be loaded. </returns>
+        static std::shared_ptr<StartupSnapshot> Get(const settings::ZoneSettings& settings);
+
+        /// <summary> Non-copyable. </summary>
+        StartupSnapshot(const StartupSnapshot&) = delete;
+        StartupSnapshot& operator=(const StartupSnapshot&) = delete;
+
+        /// <summary> Returns the blob to set as v8::Isolate::CreateParams::snapshot_blob. </summary>
+        v8::StartupData* GetStartupData();
+
+    private:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="blob"> The serialized snapshot. </param>
+        explicit StartupSnapshot(std::string blob);
+
+        /// <summary> Loads the snapshot file, or builds it from the startup script and saves it when the file is missing. </summary>
+        static std::shared_ptr<StartupSnapshot> Load(const std::string& startupScript, const std::string& snapshotPath);
+
+        /// <summary> The serialized snapshot, owned so the startup data stays valid. </summary>
+        std::string _blob;
+
+        /// <summary> The view on the blob handed to V8. </summary>
+        v8::StartupData _data;
+    };
+}
+}
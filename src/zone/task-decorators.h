@@ -5,7 +5,8 @@
 
 #include "task.h"
 #include "terminable-task.h"
-#include "timer.h"
+#include "timeout-watchdog.h"
+#include "worker-context.h"
 
 #include <v8.h>
 
@@ -22,6 +23,34 @@ namespace zone {
         template <typename... Args>
         TaskDecorator(Args&&... args) : _innerTask(std::forward<Args>(args)...) {}
 
+        uint32_t GetPriority() const override {
+            return _innerTask.GetPriority();
+        }
+
+        int64_t GetDeadline() const override {
+            return _innerTask.GetDeadline();
+        }
+
+        uint64_t GetRoutingKey() const override {
+            return _innerTask.GetRoutingKey();
+        }
+
+        uint64_t GetTenant() const override {
+            return _innerTask.GetTenant();
+        }
+
+        void Reject(napa::ResultCode code, const std::string& reason) override {
+            _innerTask.Reject(code, reason);
+        }
+
+        bool CanReject() const override {
+            return _innerTask.CanReject();
+        }
+
+        void Cancel() override {
+            _innerTask.Cancel();
+        }
+
     protected:
         TaskType _innerTask;
     };
@@ -31,25 +60,41 @@ namespace zone {
     public:
         static_assert(std::is_base_of<TerminableTask, TaskType>::value, "TaskType must inherit from TerminableTask");
 
+        /// <summary> Constructor. </summary>
+        /// <param name="watchdog"> The zone's watchdog. </param>
+        /// <param name="timeout"> The time the task may run, it's asked to stop by then. </param>
+        /// <param name="gracePeriod"> The time the task may run past the timeout before it's terminated. </param>
         template <typename... Args>
-        TimeoutTaskDecorator(std::chrono::milliseconds timeout, Args&&... args) :
+        TimeoutTaskDecorator(
+            std::shared_ptr<TimeoutWatchdog> watchdog,
+            std::chrono::milliseconds timeout,
+            std::chrono::milliseconds gracePeriod,
+            Args&&... args) :
             TaskDecorator<TaskType>(std::forward<Args>(args)...),
-            _timeout(timeout) {}
+            _watchdog(std::move(watchdog)),
+            _timeout(timeout),
+            _gracePeriod(gracePeriod) {}
 
         void Execute() override {
             auto isolate = v8::Isolate::GetCurrent();
+            auto workerId = static_cast<uint32_t>(
+                reinterpret_cast<uintptr_t>(WorkerContext::Get(WorkerContextItem::WORKER_ID)));
 
-            // RAII - timer will automatically stop upon destruction.
-            napa::zone::Timer timer([this, isolate]() {
-                this->_innerTask.Terminate(TerminationReason::TIMEOUT, isolate);
-            }, _timeout);
-            timer.Start();
+            // JavaScript sees the timeout as a deadline to stop by itself, before the grace period runs out.
+            auto now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch());
+            this->_innerTask.SetSoftDeadline((now + _timeout).count());
 
+            // The zone's watchdog terminates the task if it is still running on this worker past the grace period.
+            _watchdog->Arm(workerId, &this->_innerTask, isolate, _timeout + _gracePeriod);
             this->_innerTask.Execute();
+            _watchdog->Disarm(workerId);
         }
 
     private:
+        std::shared_ptr<TimeoutWatchdog> _watchdog;
         std::chrono::milliseconds _timeout;
+        std::chrono::milliseconds _gracePeriod;
     };
 }
 }
\ No newline at end of file
@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "task-graph.h"
+
+#include <napa/transport/transport-context.h>
+
+using namespace napa;
+using namespace napa::zone;
+
+bool TaskGraph::Validate(const std::vector<GraphTask>& tasks, std::string& error) {
+    std::vector<size_t> pendingInputs(tasks.size());
+    std::vector<std::vector<size_t>> dependents(tasks.size());
+    for (size_t i = 0; i < tasks.size(); i++) {
+        for (auto dependency : tasks[i].dependencies) {
+            if (dependency >= tasks.size()) {
+                error = "Task \"" + tasks[i].name + "\" depends on a task that is not in the graph";
+                return false;
+            }
+            dependents[dependency].push_back(i);
+            pendingInputs[i]++;
+        }
+    }
+
+    // Tasks are visited in dependency order, those left unvisited are on a cycle or depend on one.
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        if (pendingInputs[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+    size_t visited = 0;
+    while (!ready.empty()) {
+        auto index = ready.back();
+        ready.pop_back();
+        visited++;
+        for (auto dependent : dependents[index]) {
+            if (--pendingInputs[dependent] == 0) {
+                ready.push_back(dependent);
+            }
+        }
+    }
+
+    if (visited < tasks.size()) {
+        for (size_t i = 0; i < tasks.size(); i++) {
+            if (pendingInputs[i] > 0) {
+                error = "Task \"" + tasks[i].name + "\" is on a dependency cycle or depends on one";
+                break;
+            }
+        }
+        return false;
+    }
+    return true;
+}
+
+void TaskGraph::Run(std::vector<GraphTask> tasks, CompleteCallback complete) {
+    if (tasks.empty()) {
+        complete({});
+        return;
+    }
+
+    auto graph = std::shared_ptr<TaskGraph>(new TaskGraph(std::move(tasks), std::move(complete)));
+
+    // Roots are collected first, tasks may complete while others are started.
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < graph->_tasks.size(); i++) {
+        if (graph->_pendingInputs[i] == 0) {
+            roots.push_back(i);
+        }
+    }
+    for (auto root : roots) {
+        graph->Start(root);
+    }
+}
+
+TaskGraph::TaskGraph(std::vector<GraphTask> tasks, CompleteCallback complete) :
+    _tasks(std::move(tasks)),
+    _dependents(_tasks.size()),
+    _results(_tasks.size()),
+    _pendingInputs(_tasks.size()),
+    _done(_tasks.size(), false),
+    _remaining(_tasks.size()),
+    _complete(std::move(complete)) {
+
+    for (size_t i = 0; i < _tasks.size(); i++) {
+        for (auto dependency : _tasks[i].dependencies) {
+            _dependents[dependency].push_back(i);
+            _pendingInputs[i]++;
+        }
+    }
+}
+
+void TaskGraph::Start(size_t index) {
+    auto& task = _tasks[index];
+
+    FunctionSpec spec;
+    spec.module = STD_STRING_TO_NAPA_STRING_REF(task.module);
+    spec.function = STD_STRING_TO_NAPA_STRING_REF(task.function);
+    spec.ownedArguments = std::move(task.arguments);
+    spec.options = task.options;
+    spec.transportContext = task.transportContext != nullptr
+        ? std::move(task.transportContext)
+        : std::make_unique<napa::transport::TransportContext>();
+
+    // Results of dependencies are final, they are read without the lock. Their handles are shared, since the results
+    // are also returned, and other dependents may load them as well.
+    for (auto dependency : task.dependencies) {
+        auto& input = _results[dependency];
+        spec.ownedArguments.push_back(input.returnValue);
+        if (input.transportContext != nullptr) {
+            spec.transportContext->ShareFrom(*input.transportContext);
+        }
+    }
+
+    auto self = shared_from_this();
+    task.execute(spec, [self, index](Result result) {
+        self->Complete(index, std::move(result));
+    });
+}
+
+void TaskGraph::Complete(size_t index, Result result) {
+    std::vector<size_t> ready;
+    bool completed = false;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto succeeded = result.code == NAPA_RESULT_SUCCESS;
+        auto code = result.code;
+        auto failure = "Dependency \"" + _tasks[index].name + "\" failed: " + result.errorMessage;
+
+        _results[index] = std::move(result);
+        _done[index] = true;
+        _remaining--;
+
+        if (succeeded) {
+            for (auto dependent : _dependents[index]) {
+                if (!_done[dependent] && --_pendingInputs[dependent] == 0) {
+                    ready.push_back(dependent);
+                }
+            }
+        } else {
+            // Tasks depending on a failed task, directly or not, fail with it without being executed.
+            std::vector<size_t> failed(_dependents[index]);
+            while (!failed.empty()) {
+                auto dependent = failed.back();
+                failed.pop_back();
+                if (_done[dependent]) {
+                    continue;
+                }
+                _results[dependent] = { code, failure, "", nullptr };
+                _done[dependent] = true;
+                _remaining--;
+                failed.insert(failed.end(), _dependents[dependent].begin(), _dependents[dependent].end());
+            }
+        }
+        completed = _remaining == 0;
+    }
+
+    // Tasks are started without the lock, a rejected call completes within Start.
+    for (auto dependent : ready) {
+        Start(dependent);
+    }
+    if (completed) {
+        _complete(std::move(_results));
+    }
+}
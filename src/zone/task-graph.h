@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A function call of a task graph, which takes its own arguments followed by the results of its dependencies. </summary>
+    struct GraphTask {
+
+        /// <summary> The task name, which failures of its dependents refer to. </summary>
+        std::string name;
+
+        /// <summary> The module that exports the function, empty for a function that was broadcast. </summary>
+        std::string module;
+
+        /// <summary> The function to execute. </summary>
+        std::string function;
+
+        /// <summary> The marshalled arguments of the task, before the results of its dependencies. </summary>
+        std::vector<std::string> arguments;
+
+        /// <summary> Call options of the task. </summary>
+        CallOptions options;
+
+        /// <summary> Handles the arguments refer to, null for none. </summary>
+        std::unique_ptr<napa::transport::TransportContext> transportContext;
+
+        /// <summary> The indices of the tasks whose results are passed to this task, in the order of its arguments. </summary>
+        std::vector<size_t> dependencies;
+
+        /// <summary> Executes the call of the task, on the zone it runs on. </summary>
+        std::function<void(const FunctionSpec&, ExecuteCallback)> execute;
+    };
+
+    /// <summary> Runs the tasks of a graph, each as soon as the tasks it depends on have succeeded. </summary>
+    /// <remarks>
+    ///     The marshalled result of a task is appended as is to the arguments of its dependents, along with the handles
+    ///     it refers to, so results go from task to task in native code. A task whose dependency failed is not executed,
+    ///     its result is the failure of the dependency.
+    /// </remarks>
+    class TaskGraph : public std::enable_shared_from_this<TaskGraph> {
+    public:
+
+        /// <summary> Callback with the results of all tasks, in the order of the tasks. </summary>
+        using CompleteCallback = std::function<void(std::vector<Result>)>;
+
+        /// <summary> Checks that the dependencies of the tasks are other tasks, without cycles. </summary>
+        /// <param name="error"> Receives the reason the graph is invalid. </param>
+        /// <returns> False if the graph can't run. </returns>
+        static bool Validate(const std::vector<GraphTask>& tasks, std::string& error);
+
+        /// <summary> Runs the tasks of a valid graph. </summary>
+        /// <param name="tasks"> The tasks, which Validate accepted. </param>
+        /// <param name="complete"> Callback that is triggered once all tasks completed, on the thread of the last one. </param>
+        static void Run(std::vector<GraphTask> tasks, CompleteCallback complete);
+
+    private:
+
+        TaskGraph(std::vector<GraphTask> tasks, CompleteCallback complete);
+
+        /// <summary> Executes a task whose dependencies all succeeded. </summary>
+        void Start(size_t index);
+
+        /// <summary> Records the result of a task, and starts the dependents it was the last input of. </summary>
+        void Complete(size_t index, Result result);
+
+        std::vector<GraphTask> _tasks;
+
+        /// <summary> The indices of the tasks that depend on each task. </summary>
+        std::vector<std::vector<size_t>> _dependents;
+
+        /// <summary> Results in the order of the tasks, final once the task is done. </summary>
+        std::vector<Result> _results;
+
+        std::mutex _lock;
+
+        /// <summary> The number of dependencies of each task that haven't completed yet. </summary>
+        std::vector<size_t> _pendingInputs;
+
+        /// <summary> Whether each task has its result, executed or failed by a dependency. </summary>
+        std::vector<bool> _done;
+
+        /// <summary> The number of tasks without a result yet. </summary>
+        size_t _remaining;
+
+        CompleteCallback _complete;
+    };
+}
+}
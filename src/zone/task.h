@@ -3,6 +3,11 @@
 
 #pragma once
 
+#include <napa/types.h>
+
+#include <stdint.h>
+#include <string>
+
 namespace napa {
 namespace zone {
 
@@ -13,6 +18,29 @@ namespace zone {
         /// <summary> Executes the task. </summary>
         virtual void Execute() = 0;
 
+        /// <summary> Scheduling priority, tasks with higher priority are dispatched first when all workers are busy. </summary>
+        virtual uint32_t GetPriority() const { return 0; }
+
+        /// <summary> Absolute deadline in milliseconds since Unix epoch, 0 if the task has no deadline. </summary>
+        virtual int64_t GetDeadline() const { return 0; }
+
+        /// <summary> Key that routes the task to a preferred worker, 0 if the task can run on any worker. </summary>
+        virtual uint64_t GetRoutingKey() const { return 0; }
+
+        /// <summary> Key of the tenant the task is dispatched for, 0 for the default tenant. </summary>
+        virtual uint64_t GetTenant() const { return 0; }
+
+        /// <summary> Called instead of Execute when the scheduler drops the task, to report the failure to the caller. </summary>
+        /// <remarks> Each task decides what a rejection means, tasks without a caller to report to leave it empty. </remarks>
+        virtual void Reject(napa::ResultCode code, const std::string& reason) = 0;
+
+        /// <summary> Whether Reject reports the failure to a caller, so a worker that sheds its load may reject the task. </summary>
+        /// <remarks> Tasks completing work pinned to a worker, like async completions, always have to run. </remarks>
+        virtual bool CanReject() const { return false; }
+
+        /// <summary> Withdraws the task on behalf of the caller, whether it is still queued or already running. </summary>
+        virtual void Cancel() {}
+
         /// <summary> Virtual destructor. </summary>
         virtual ~Task() = default;
     };
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "tenant-contexts.h"
+#include "eval-task.h"
+
+#include <module/loader/module-loader.h>
+#include <napa/log.h>
+
+using namespace napa;
+using namespace napa::zone;
+
+constexpr size_t TenantContexts::CONTEXT_ITEM_COUNT;
+
+const std::array<WorkerContextItem, TenantContexts::CONTEXT_ITEM_COUNT> TenantContexts::CONTEXT_ITEMS = {{
+    WorkerContextItem::MODULE_LOADER,
+    WorkerContextItem::NAPA_BINDING,
+    WorkerContextItem::ZONE_CALL_FUNCTION,
+    WorkerContextItem::STORE_VALUE_CACHE,
+    WorkerContextItem::SHAREABLE_WRAP_CACHE
+}};
+
+TenantContexts::TenantContexts(uint32_t maxContexts, std::string bootstrapSource, bool sharedModuleContext, bool modulePrefetch) :
+    _maxContexts(maxContexts),
+    _bootstrapSource(std::move(bootstrapSource)),
+    _sharedModuleContext(sharedModuleContext),
+    _modulePrefetch(modulePrefetch),
+    _limitReported(false) {}
+
+TenantContexts::Scope::Scope(uint64_t tenant) : _entry(nullptr) {
+    auto tenantContexts = static_cast<TenantContexts*>(WorkerContext::Get(WorkerContextItem::TENANT_CONTEXTS));
+    if (tenantContexts == nullptr || tenant == 0) {
+        return;
+    }
+
+    _entry = tenantContexts->GetEntry(tenant);
+    if (_entry == nullptr) {
+        return;
+    }
+
+    // The isolate keeps entered contexts alive, the handle is only needed to enter it.
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context>::New(isolate, _entry->context)->Enter();
+    SwapItems(*_entry);
+}
+
+TenantContexts::Scope::~Scope() {
+    if (_entry == nullptr) {
+        return;
+    }
+
+    SwapItems(*_entry);
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context>::New(isolate, _entry->context)->Exit();
+}
+
+TenantContexts::Entry* TenantContexts::GetEntry(uint64_t tenant) {
+    auto found = _entries.find(tenant);
+    if (found != _entries.end()) {
+        return found->second.get();
+    }
+
+    if (_entries.size() >= _maxContexts) {
+        if (!_limitReported) {
+            LOG_WARNING("Zone", "Worker reached %u tenant contexts, calls of other tenants run in the worker's context.", _maxContexts);
+            _limitReported = true;
+        }
+        return nullptr;
+    }
+
+    auto isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope scope(isolate);
+    auto context = v8::Context::New(isolate);
+
+    // Like the worker's context, an empty security token lets tenants call functions of other contexts they are given.
+    context->SetSecurityToken(v8::Undefined(isolate));
+
+    auto entry = std::make_unique<Entry>();
+    entry->context.Reset(isolate, context);
+    entry->items.fill(nullptr);
+
+    // The new context starts without the items of the worker's context, its module loader and napajs set its own.
+    Result bootstrapResult = { NAPA_RESULT_INTERNAL_ERROR, "Bootstrap did not complete", "", nullptr };
+    SwapItems(*entry);
+    {
+        v8::Context::Scope contextScope(context);
+        module::ModuleLoader::CreateModuleLoader(_sharedModuleContext, _modulePrefetch);
+
+        EvalTask bootstrap(_bootstrapSource, "", [&bootstrapResult](Result result) {
+            bootstrapResult = std::move(result);
+        });
+        bootstrap.Execute();
+    }
+    SwapItems(*entry);
+
+    if (bootstrapResult.code != NAPA_RESULT_SUCCESS) {
+        LOG_ERROR("Zone", "Failed to bootstrap the context of tenant %llu, its calls run in the worker's context: %s",
+            static_cast<unsigned long long>(tenant), bootstrapResult.errorMessage.c_str());
+        _entries.emplace(tenant, nullptr);
+        return nullptr;
+    }
+
+    NAPA_DEBUG("Zone", "Created the context of tenant %llu.", static_cast<unsigned long long>(tenant));
+    return _entries.emplace(tenant, std::move(entry)).first->second.get();
+}
+
+void TenantContexts::SwapItems(Entry& entry) {
+    for (size_t i = 0; i < CONTEXT_ITEM_COUNT; i++) {
+        auto current = WorkerContext::Get(CONTEXT_ITEMS[i]);
+        WorkerContext::Set(CONTEXT_ITEMS[i], entry.items[i]);
+        entry.items[i] = current;
+    }
+}
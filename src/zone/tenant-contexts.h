@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "worker-context.h"
+
+#include <v8.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> The contexts a worker runs the tasks of tenants in, so tenants sharing a zone don't share globals. </summary>
+    /// <remarks>
+    ///     A tenant gets its context on its first task, which runs the zone's bootstrap script in it with a module
+    ///     loader of its own, so the tenant has its own instances of napajs and of the modules it requires.
+    ///     Worker context items that hold objects of a context, like the module loader, are swapped while a tenant
+    ///     runs. Compiled code is shared through the process-wide code cache.
+    ///     Tenants past the limit, the default tenant and broadcasts run in the worker's context.
+    /// </remarks>
+    class TenantContexts {
+        struct Entry;
+
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="maxContexts"> The most tenants that get a context on this worker. </param>
+        /// <param name="bootstrapSource"> The script each new context runs, which loads napajs. </param>
+        /// <param name="sharedModuleContext"> Whether modules are loaded in the context that requires them. </param>
+        /// <param name="modulePrefetch"> Whether the dependencies of modules are prefetched while they load. </param>
+        TenantContexts(uint32_t maxContexts, std::string bootstrapSource, bool sharedModuleContext, bool modulePrefetch);
+
+        /// <summary> Non-copyable. </summary>
+        TenantContexts(const TenantContexts&) = delete;
+        TenantContexts& operator=(const TenantContexts&) = delete;
+
+        /// <summary> Runs the current thread in the context of a tenant, while the scope lives. </summary>
+        /// <remarks> Does nothing for the default tenant, on workers without tenant contexts or past their limit. </remarks>
+        class Scope {
+        public:
+            explicit Scope(uint64_t tenant);
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            Entry* _entry;
+        };
+
+    private:
+
+        /// <summary> The worker context items that refer to objects of a context. </summary>
+        static constexpr size_t CONTEXT_ITEM_COUNT = 5;
+        static const std::array<WorkerContextItem, CONTEXT_ITEM_COUNT> CONTEXT_ITEMS;
+
+        struct Entry {
+            v8::Global<v8::Context> context;
+
+            /// <summary> The tenant's values of CONTEXT_ITEMS while it doesn't run. </summary>
+            std::array<void*, CONTEXT_ITEM_COUNT> items;
+        };
+
+        /// <summary> Returns the context of a tenant, creating it on its first use. </summary>
+        /// <returns> Null if the tenant runs in the worker's context. </returns>
+        Entry* GetEntry(uint64_t tenant);
+
+        /// <summary> Swaps the worker context items with the ones of a tenant. </summary>
+        static void SwapItems(Entry& entry);
+
+        uint32_t _maxContexts;
+        std::string _bootstrapSource;
+        bool _sharedModuleContext;
+        bool _modulePrefetch;
+        bool _limitReported;
+
+        /// <summary> Contexts by tenant, null for tenants whose context failed to bootstrap. </summary>
+        std::unordered_map<uint64_t, std::unique_ptr<Entry>> _entries;
+    };
+}
+}
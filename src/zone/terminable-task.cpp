@@ -17,3 +17,7 @@ void TerminableTask::Terminate(TerminationReason reason, v8::Isolate* isolate) {
 
     isolate->TerminateExecution();
 }
+
+void TerminableTask::SetSoftDeadline(int64_t deadline) {
+    _softDeadline = deadline;
+}
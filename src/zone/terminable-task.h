@@ -15,7 +15,8 @@ namespace zone {
     /// <summary> Specifies the possible reasons for termination. </summary>
     enum class TerminationReason {
         UNKNOWN,
-        TIMEOUT
+        TIMEOUT,
+        CANCELLED
     };
 
     /// <summary> Base class for tasks that can be terminated. </summary>
@@ -27,8 +28,15 @@ namespace zone {
         /// <param name="isolate"> The isolate this task currently runs on. </param>
         void Terminate(TerminationReason reason, v8::Isolate* isolate);
 
+        /// <summary> Sets the time the task should stop by, before it's terminated after a grace period. </summary>
+        /// <param name="deadline"> Milliseconds since epoch, 0 for none. </param>
+        void SetSoftDeadline(int64_t deadline);
+
     protected:
         TerminationReason _terminationReason = TerminationReason::UNKNOWN;
+
+        /// <summary> The time in milliseconds since epoch the task should stop by, 0 for none. </summary>
+        int64_t _softDeadline = 0;
     };
 }
 }
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "timeout-watchdog.h"
+
+using namespace napa::zone;
+
+/// <summary> The interval at which armed slots are checked. </summary>
+static const std::chrono::milliseconds WATCHDOG_INTERVAL(1);
+
+/// <summary> The number of checks without any armed slot before the watchdog parks. </summary>
+static const uint32_t IDLE_CHECKS_BEFORE_PARKING = 100;
+
+/// <summary> Deadline value of a slot without a running timed task. </summary>
+static const int64_t DISARMED = 0;
+
+/// <summary> Deadline value of a slot whose task is being expired. </summary>
+static const int64_t EXPIRING = -1;
+
+static int64_t NowInNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+TimeoutWatchdog::TimeoutWatchdog(uint32_t slotCount, ExpirationHandler handler) :
+    _slots(std::make_unique<Slot[]>(slotCount)),
+    _slotCount(slotCount),
+    _handler(std::move(handler)),
+    _parked(false),
+    _running(true) {
+
+    for (uint32_t i = 0; i < _slotCount; i++) {
+        _slots[i].deadline = DISARMED;
+        _slots[i].task = nullptr;
+        _slots[i].isolate = nullptr;
+    }
+
+    _thread = std::thread(&TimeoutWatchdog::WatchdogThreadFunc, this);
+}
+
+TimeoutWatchdog::~TimeoutWatchdog() {
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _running = false;
+    }
+    _wakeUpEvent.notify_one();
+    _thread.join();
+}
+
+void TimeoutWatchdog::Arm(uint32_t slot, TerminableTask* task, v8::Isolate* isolate, std::chrono::milliseconds timeout) {
+    auto& entry = _slots[slot];
+
+    // The task and isolate are published by the deadline store, which the watchdog reads first.
+    entry.task.store(task, std::memory_order_relaxed);
+    entry.isolate.store(isolate, std::memory_order_relaxed);
+    entry.deadline.store(NowInNanoseconds() + std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count());
+
+    // Sequentially consistent with the watchdog parking, either it sees the deadline or the slot sees it parked.
+    if (_parked.load()) {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _parked = false;
+        }
+        _wakeUpEvent.notify_one();
+    }
+}
+
+void TimeoutWatchdog::Disarm(uint32_t slot) {
+    auto& deadline = _slots[slot].deadline;
+
+    while (true) {
+        auto expected = deadline.load();
+
+        // The task is being terminated, wait for the handler to return.
+        if (expected == EXPIRING) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        if (deadline.compare_exchange_weak(expected, DISARMED)) {
+            return;
+        }
+    }
+}
+
+void TimeoutWatchdog::WatchdogThreadFunc() {
+    uint32_t idleChecks = 0;
+
+    std::unique_lock<std::mutex> lock(_lock);
+    while (_running) {
+        lock.unlock();
+        auto armed = CheckSlots();
+        lock.lock();
+
+        if (armed) {
+            idleChecks = 0;
+        }
+        else if (++idleChecks >= IDLE_CHECKS_BEFORE_PARKING) {
+            // Check the slots again after announcing parking, so an arm that didn't see it is not missed.
+            _parked = true;
+            lock.unlock();
+            armed = CheckSlots();
+            lock.lock();
+
+            if (armed) {
+                _parked = false;
+            }
+            _wakeUpEvent.wait(lock, [this]() { return !_parked || !_running; });
+            idleChecks = 0;
+            continue;
+        }
+
+        _wakeUpEvent.wait_for(lock, WATCHDOG_INTERVAL, [this]() { return !_running; });
+    }
+}
+
+bool TimeoutWatchdog::CheckSlots() {
+    auto now = NowInNanoseconds();
+
+    bool armed = false;
+    for (uint32_t i = 0; i < _slotCount; i++) {
+        auto& entry = _slots[i];
+
+        auto deadline = entry.deadline.load();
+        if (deadline == DISARMED) {
+            continue;
+        }
+        armed = true;
+
+        // Claim the slot, so the worker waits in Disarm until the task is terminated.
+        if (deadline > 0 && deadline <= now && entry.deadline.compare_exchange_strong(deadline, EXPIRING)) {
+            _handler(entry.task.load(std::memory_order_relaxed), entry.isolate.load(std::memory_order_relaxed));
+            entry.deadline.store(DISARMED);
+        }
+    }
+    return armed;
+}
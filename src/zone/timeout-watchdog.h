@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "terminable-task.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Watches the deadlines of the tasks running on the workers of a zone from a single thread. </summary>
+    /// <remarks>
+    ///     Each worker owns a slot where it publishes the deadline of its current task, so arming and disarming
+    ///     a timeout are a few atomic operations on the worker thread, without locks or allocations.
+    ///     The watchdog polls the slots every millisecond while any of them is armed, and parks otherwise.
+    /// </remarks>
+    class TimeoutWatchdog {
+    public:
+
+        /// <summary> Called on the watchdog thread for a task that ran past its deadline. </summary>
+        using ExpirationHandler = std::function<void(TerminableTask* task, v8::Isolate* isolate)>;
+
+        /// <summary> Constructor. </summary>
+        /// <param name="slotCount"> The number of slots, one per worker. </param>
+        /// <param name="handler"> Handles expired tasks, typically terminates them due to timeout. </param>
+        TimeoutWatchdog(uint32_t slotCount, ExpirationHandler handler);
+
+        /// <summary> Destructor. Stops the watchdog thread. </summary>
+        ~TimeoutWatchdog();
+
+        TimeoutWatchdog(const TimeoutWatchdog&) = delete;
+        TimeoutWatchdog& operator=(const TimeoutWatchdog&) = delete;
+
+        /// <summary> Arms the slot of a worker for the task it is about to run. </summary>
+        /// <param name="slot"> The worker slot. </param>
+        /// <param name="task"> The running task. </param>
+        /// <param name="isolate"> The isolate the task runs on. </param>
+        /// <param name="timeout"> The time the task may run. </param>
+        void Arm(uint32_t slot, TerminableTask* task, v8::Isolate* isolate, std::chrono::milliseconds timeout);
+
+        /// <summary> Disarms the slot of a worker once its task completed. </summary>
+        /// <remarks> If the task is being expired, waits for the handler to return, so it never sees the next task. </remarks>
+        void Disarm(uint32_t slot);
+
+    private:
+
+        /// <summary> A worker slot, aligned to a cache line so workers don't share one another's. </summary>
+        struct alignas(64) Slot {
+            std::atomic<int64_t> deadline;
+            std::atomic<TerminableTask*> task;
+            std::atomic<v8::Isolate*> isolate;
+        };
+
+        /// <summary> Polls the slots and expires the tasks that ran past their deadline. </summary>
+        void WatchdogThreadFunc();
+
+        /// <summary> Expires the tasks past their deadline. </summary>
+        /// <returns> True if any slot is armed. </returns>
+        bool CheckSlots();
+
+        std::unique_ptr<Slot[]> _slots;
+        uint32_t _slotCount;
+        ExpirationHandler _handler;
+
+        /// <summary> Whether the watchdog thread waits for a slot to be armed. </summary>
+        std::atomic<bool> _parked;
+        std::mutex _lock;
+        std::condition_variable _wakeUpEvent;
+        bool _running;
+
+        std::thread _thread;
+    };
+}
+}
@@ -0,0 +1,41 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <cstdint>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Picks the millisecond tick in [earliest, earliest + slack] a timer fires at, so timers with slack share wake ups. </summary>
+    /// <param name="preferred"> A tick the thread already wakes up at, which is taken when it's in the window. </param>
+    /// <remarks>
+    ///     Otherwise it's the latest multiple in the window of the largest power of two up to slack + 1. Multiples of larger
+    ///     powers of two are multiples of the smaller ones, so timers of different slacks coalesce on the same ticks.
+    /// </remarks>
+    inline uint64_t CoalesceTick(uint64_t earliest, uint64_t slack, uint64_t preferred) {
+        if (slack == 0) {
+            return earliest;
+        }
+        if (preferred >= earliest && preferred - earliest <= slack) {
+            return preferred;
+        }
+
+        uint64_t granularity = 1;
+        while (granularity <= (slack + 1) / 2) {
+            granularity *= 2;
+        }
+        return (earliest + slack) / granularity * granularity;
+    }
+
+    /// <summary> Gets the first multiple of period after tick, where an aligned interval of that period fires next. </summary>
+    /// <remarks> Aligned intervals of a period fire on the same ticks, however long their callbacks run. </remarks>
+    inline uint64_t AlignTick(uint64_t tick, uint64_t period) {
+        if (period == 0) {
+            return tick;
+        }
+        return (tick / period + 1) * period;
+    }
+}
+}
@@ -2,56 +2,115 @@
 // Licensed under the MIT license.
 
 #include "timer.h"
+#include "timer-slack.h"
 
+#include <napa/assert.h>
 #include <napa/log.h>
+#include <platform/tracepoint.h>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <limits>
 #include <mutex>
-#include <queue>
 #include <stack>
 #include <thread>
-
-#include <iostream>
+#include <vector>
 
 using namespace napa::zone;
 
+/// <summary> The maximum number of timer shards, each one runs its own thread. </summary>
+static const uint32_t MAX_TIMER_SHARDS = 8;
+
+/// <summary> Each wheel level has 2^SLOT_BITS slots, a slot of a level spans a full turn of the level below. </summary>
+static const uint32_t SLOT_BITS = 6;
+static const uint32_t SLOT_COUNT = 1 << SLOT_BITS;
+static const uint64_t SLOT_MASK = SLOT_COUNT - 1;
+static const uint32_t LEVEL_COUNT = 4;
+
+/// <summary> Timers further than this many ticks are parked in the last level until they come in range. </summary>
+static const uint64_t MAX_TICKS = (1ULL << (SLOT_BITS * LEVEL_COUNT)) - 1;
+
+static const Timer::Index INVALID_INDEX = std::numeric_limits<Timer::Index>::max();
+static const uint64_t NO_WAKE_TICK = std::numeric_limits<uint64_t>::max();
+
 struct TimerInfo {
     bool active;
     std::chrono::milliseconds timeout;
+    std::chrono::milliseconds slack;
     Timer::Callback callback;
-};
 
-struct ActiveTimerEntry {
-    Timer::Index index;
-    std::chrono::high_resolution_clock::time_point expirationTime;
+    /// <summary> The tick at which the timer expires. </summary>
+    uint64_t expirationTick;
+
+    /// <summary> The wheel slot the timer is linked in, and its neighbours in the slot. </summary>
+    uint32_t slot;
+    Timer::Index previous;
+    Timer::Index next;
 };
 
-static bool operator<(const ActiveTimerEntry& first, const ActiveTimerEntry& second) {
-    // We want the entry that is closest to expire to be at the top of the queue.
-    return first.expirationTime > second.expirationTime;
-}
+/// <summary> A set of timing wheels served by one thread. </summary>
+struct TimerShard {
+    TimerShard();
+    ~TimerShard();
 
-struct TimersScheduler {
-    ~TimersScheduler();
+    void EnsureStarted();
+    void MainLoop();
 
-    bool StartMainLoop();
+    Timer::Index Add(TimerInfo info);
+    void Remove(Timer::Index index);
+    bool Arm(Timer::Index index);
+    void Disarm(Timer::Index index);
 
-    std::priority_queue<ActiveTimerEntry> activeTimers;
-    std::stack<Timer::Index> freeSlots;
+    uint64_t NowTick() const;
+    uint64_t ToTick(std::chrono::steady_clock::time_point time) const;
+
+    void Link(Timer::Index index);
+    void Unlink(Timer::Index index);
+    Timer::Index Detach(uint32_t slot);
+    void Advance(uint64_t tick);
+    void Cascade(uint32_t level);
+    void Expire(uint32_t slot);
+    uint64_t NextWakeTick() const;
 
     std::vector<TimerInfo> timers;
+    std::stack<Timer::Index> freeSlots;
+
+    /// <summary> Heads of the slot lists, level by level. </summary>
+    Timer::Index wheels[LEVEL_COUNT * SLOT_COUNT];
+
+    /// <summary> The last tick processed, ticks are milliseconds since the shard was created. </summary>
+    uint64_t currentTick;
+
+    /// <summary> The tick the thread sleeps until, that a new timer has to beat to wake it up. </summary>
+    uint64_t wakeTick;
+
+    size_t activeCount;
+    std::chrono::steady_clock::time_point epoch;
 
     std::condition_variable cv;
     std::mutex mutex;
-    std::atomic<bool> running;
+    bool running;
 
+    std::once_flag started;
     std::thread thread;
 };
 
-TimersScheduler::~TimersScheduler() {
-    running = false;
+TimerShard::TimerShard() :
+    currentTick(0),
+    wakeTick(NO_WAKE_TICK),
+    activeCount(0),
+    epoch(std::chrono::steady_clock::now()),
+    running(false) {
+    std::fill(std::begin(wheels), std::end(wheels), INVALID_INDEX);
+}
+
+TimerShard::~TimerShard() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
     cv.notify_one();
 
     if (thread.joinable()) {
@@ -59,101 +118,251 @@ TimersScheduler::~TimersScheduler() {
     }
 }
 
-bool TimersScheduler::StartMainLoop() {
-    running = true;
-    thread = std::thread([this]() {
-        std::unique_lock<std::mutex> lock(mutex);
+void TimerShard::EnsureStarted() {
+    std::call_once(started, [this]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = true;
+        thread = std::thread(&TimerShard::MainLoop, this);
+    });
+}
 
-        // Timers main loop.
-        while (running) {
-            cv.wait(lock, [this]() {
-                return !activeTimers.empty() || !running;
-            });
+void TimerShard::MainLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
 
-            if (!running) {
-                return;
-            }
+    // Timers main loop.
+    while (running) {
+        Advance(NowTick());
 
-            auto nextExpirationTime = activeTimers.top().expirationTime;
-            if (nextExpirationTime <= std::chrono::high_resolution_clock::now()) {
-                // Pop before callback(), so that it could be re-armed for interval task logic.
-                auto expiredTimer = activeTimers.top();
-                activeTimers.pop();
-
-                if (timers[expiredTimer.index].active) {
-                    timers[expiredTimer.index].active = false;
-
-                    try {
-                        // Fire the callback.
-                        // The callback is assumed to be very fast as it is meant to dispatch to appropriate
-                        // callback queues.
-                        timers[expiredTimer.index].callback();
-                    }
-                    catch (const std::exception &ex) {
-                        LOG_ERROR("Timers", "Timer callback threw an exception. %s", ex.what());
-                    }
-                }
-            }
-            else {
-                // Wait for timer expiration. Stop waiting if new urgent active timer is arm-ed.
-                cv.wait_until(lock, nextExpirationTime, [this, nextExpirationTime]() {
-                    return activeTimers.top().expirationTime < nextExpirationTime;
-                });
-            }
+        // Sleep until the next tick that may expire a timer, or until a timer is started.
+        wakeTick = activeCount == 0 ? NO_WAKE_TICK : NextWakeTick();
+        if (wakeTick == NO_WAKE_TICK) {
+            cv.wait(lock);
         }
-    });
+        else {
+            cv.wait_until(lock, epoch + std::chrono::milliseconds(wakeTick));
+        }
+    }
+}
 
-    return true;
+Timer::Index TimerShard::Add(TimerInfo info) {
+    Timer::Index index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.top();
+        freeSlots.pop();
+        timers[index] = std::move(info);
+    }
+    else {
+        NAPA_ASSERT(timers.size() < INVALID_INDEX, "Too many timers");
+        index = static_cast<Timer::Index>(timers.size());
+        timers.emplace_back(std::move(info));
+    }
+    return index;
 }
 
-static TimersScheduler _timersScheduler;
+void TimerShard::Remove(Timer::Index index) {
+    Disarm(index);
+    timers[index].callback = nullptr;
 
+    // Free the timer slot.
+    freeSlots.emplace(index);
+}
 
-Timer::Timer(Callback callback, std::chrono::milliseconds timeout) {
-    // Start the timers scheduler if this is the first timer created.
-    static bool init = _timersScheduler.StartMainLoop();
+bool TimerShard::Arm(Timer::Index index) {
+    auto& timerInfo = timers[index];
+    if (timerInfo.active) {
+        Unlink(index);
+    }
+    else {
+        timerInfo.active = true;
+        activeCount++;
+    }
 
-    std::lock_guard<std::mutex> lock(_timersScheduler.mutex);
+    // Round up, so the callback never fires before the timeout elapsed.
+    auto expirationTime = std::chrono::steady_clock::now() + timerInfo.timeout;
+    auto expirationTick = ToTick(expirationTime);
+    if (epoch + std::chrono::milliseconds(expirationTick) < expirationTime) {
+        expirationTick++;
+    }
 
-    TimerInfo timerInfo{ false, timeout, callback };
+    // The current tick was processed already, so the earliest a timer can expire is the next one.
+    // Timers with slack expire when the thread wakes up anyway if it does within their slack.
+    timerInfo.expirationTick = CoalesceTick(
+        std::max(expirationTick, currentTick + 1),
+        static_cast<uint64_t>(timerInfo.slack.count()),
+        wakeTick);
+    Link(index);
 
-    if (!_timersScheduler.freeSlots.empty()) {
-        _index = _timersScheduler.freeSlots.top();
-        _timersScheduler.freeSlots.pop();
+    return timerInfo.expirationTick < wakeTick;
+}
 
-        _timersScheduler.timers[_index] = std::move(timerInfo);
+void TimerShard::Disarm(Timer::Index index) {
+    auto& timerInfo = timers[index];
+    if (timerInfo.active) {
+        Unlink(index);
+        timerInfo.active = false;
+        activeCount--;
+    }
+}
+
+uint64_t TimerShard::NowTick() const {
+    return ToTick(std::chrono::steady_clock::now());
+}
+
+uint64_t TimerShard::ToTick(std::chrono::steady_clock::time_point time) const {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(time - epoch).count());
+}
+
+void TimerShard::Link(Timer::Index index) {
+    auto& timerInfo = timers[index];
+    auto expirationTick = std::min(timerInfo.expirationTick, currentTick + MAX_TICKS);
+    auto delta = expirationTick - currentTick;
+
+    // A timer goes to the lowest level that spans its remaining time, and moves down as the time passes.
+    uint32_t level = 0;
+    while (level + 1 < LEVEL_COUNT && delta >= (1ULL << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    auto slot = static_cast<uint32_t>(level * SLOT_COUNT + ((expirationTick >> (SLOT_BITS * level)) & SLOT_MASK));
+
+    timerInfo.slot = slot;
+    timerInfo.previous = INVALID_INDEX;
+    timerInfo.next = wheels[slot];
+    if (timerInfo.next != INVALID_INDEX) {
+        timers[timerInfo.next].previous = index;
+    }
+    wheels[slot] = index;
+}
+
+void TimerShard::Unlink(Timer::Index index) {
+    auto& timerInfo = timers[index];
+    if (timerInfo.previous != INVALID_INDEX) {
+        timers[timerInfo.previous].next = timerInfo.next;
     }
     else {
-        _index = static_cast<Timer::Index>(_timersScheduler.timers.size());
-        _timersScheduler.timers.emplace_back(timerInfo);
+        wheels[timerInfo.slot] = timerInfo.next;
+    }
+    if (timerInfo.next != INVALID_INDEX) {
+        timers[timerInfo.next].previous = timerInfo.previous;
     }
 }
 
-Timer::~Timer() {
-    std::lock_guard<std::mutex> lock(_timersScheduler.mutex);
+Timer::Index TimerShard::Detach(uint32_t slot) {
+    auto head = wheels[slot];
+    wheels[slot] = INVALID_INDEX;
+    return head;
+}
 
-    _timersScheduler.timers[_index].active = false;
+void TimerShard::Advance(uint64_t tick) {
+    while (currentTick < tick) {
+        currentTick++;
 
-    // Free the timer slot.
-    _timersScheduler.freeSlots.emplace(_index);
+        // When a level completes a turn, the next slot of the level above is spread over the levels below.
+        for (uint32_t level = 1; level < LEVEL_COUNT; level++) {
+            if (((currentTick >> (SLOT_BITS * (level - 1))) & SLOT_MASK) != 0) {
+                break;
+            }
+            Cascade(level);
+        }
+
+        Expire(static_cast<uint32_t>(currentTick & SLOT_MASK));
+    }
+}
+
+void TimerShard::Cascade(uint32_t level) {
+    auto slot = static_cast<uint32_t>(level * SLOT_COUNT + ((currentTick >> (SLOT_BITS * level)) & SLOT_MASK));
+    for (auto index = Detach(slot); index != INVALID_INDEX;) {
+        auto next = timers[index].next;
+        Link(index);
+        index = next;
+    }
+}
+
+void TimerShard::Expire(uint32_t slot) {
+    for (auto index = Detach(slot); index != INVALID_INDEX;) {
+        auto& timerInfo = timers[index];
+        auto next = timerInfo.next;
+
+        // Timers beyond the last level wrap around the wheels until they come in range.
+        if (timerInfo.expirationTick > currentTick) {
+            Link(index);
+        }
+        else {
+            timerInfo.active = false;
+            activeCount--;
+            NAPA_TRACEPOINT2(timer__fire, "timer", index, "lateTicks", currentTick - timerInfo.expirationTick);
+
+            try {
+                // Fire the callback.
+                // The callback is assumed to be very fast as it is meant to dispatch to appropriate
+                // callback queues.
+                timerInfo.callback();
+            }
+            catch (const std::exception &ex) {
+                LOG_ERROR("Timers", "Timer callback threw an exception. %s", ex.what());
+            }
+        }
+        index = next;
+    }
+}
+
+uint64_t TimerShard::NextWakeTick() const {
+    // Level 0 covers the ticks up to the next turn, the turn itself cascades the levels above.
+    auto turnTick = (currentTick | SLOT_MASK) + 1;
+    for (auto tick = currentTick + 1; tick < turnTick; tick++) {
+        if (wheels[tick & SLOT_MASK] != INVALID_INDEX) {
+            return tick;
+        }
+    }
+    return turnTick;
+}
+
+static TimerShard _timerShards[MAX_TIMER_SHARDS];
+
+/// <summary> Assigns the calling thread its timer shard, threads are spread over shards round robin. </summary>
+static uint32_t GetCurrentThreadShard() {
+    static const uint32_t shardCount = std::max(1u, std::min(MAX_TIMER_SHARDS, std::thread::hardware_concurrency()));
+    static std::atomic<uint32_t> nextShard(0);
+
+    thread_local uint32_t shard = nextShard++ % shardCount;
+    return shard;
+}
+
+Timer::Timer(Callback callback, std::chrono::milliseconds timeout, std::chrono::milliseconds slack) :
+    _shard(GetCurrentThreadShard()) {
+    auto& shard = _timerShards[_shard];
+
+    // Start the shard thread if this is the first timer created in the shard.
+    shard.EnsureStarted();
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    _index = shard.Add(TimerInfo{
+        false, timeout, std::max(slack, std::chrono::milliseconds(0)), std::move(callback), 0, 0, INVALID_INDEX, INVALID_INDEX });
+}
+
+Timer::~Timer() {
+    auto& shard = _timerShards[_shard];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.Remove(_index);
 }
 
 void Timer::Start() {
-    {
-        std::lock_guard<std::mutex> lock(_timersScheduler.mutex);
-        
-        auto& timerInfo = _timersScheduler.timers[_index];
-        timerInfo.active = true;
+    auto& shard = _timerShards[_shard];
 
-        ActiveTimerEntry entry = { _index, std::chrono::high_resolution_clock::now() + timerInfo.timeout };
-        _timersScheduler.activeTimers.emplace(std::move(entry));
+    bool wakeUp;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        wakeUp = shard.Arm(_index);
     }
 
-    _timersScheduler.cv.notify_one();
+    if (wakeUp) {
+        shard.cv.notify_one();
+    }
 }
 
 void Timer::Stop() {
-    std::lock_guard<std::mutex> lock(_timersScheduler.mutex);
+    auto& shard = _timerShards[_shard];
 
-    _timersScheduler.timers[_index].active = false;
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.Disarm(_index);
 }
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <memory>
 
@@ -11,15 +12,26 @@ namespace napa {
 namespace zone {
 
     /// <summary> A timer class that will trigger a callback after elapsed time. </summary>
+    /// <remarks>
+    ///     Timers are kept in hierarchical timing wheels with a millisecond tick, so starting and stopping are O(1).
+    ///     The wheels are sharded, and each thread creates its timers in its own shard to avoid contending one lock.
+    ///     The callback runs on the shard's thread while the shard is locked, it must be fast and must not
+    ///     start, stop or destroy timers.
+    ///     A timer with slack may fire up to that many milliseconds late, at a tick the shard's thread wakes up at
+    ///     anyway or on a coarse tick other timers with slack pick too, so the thread wakes up less often.
+    /// </remarks>
     class Timer {
     public:
-        typedef uint16_t Index;
+        typedef uint32_t Index;
         typedef std::function<void(void)> Callback;
 
         /// <summary> Creates a new timer which is not active initially. </summary>
         /// <param name="callback"> The callback. </param>
         /// <param name="timeout"> The timeout in millisecond after which the callback will be triggered. </param>
-        Timer(Callback callback, std::chrono::milliseconds timeout);
+        /// <param name="slack"> The milliseconds the callback may be triggered after the timeout, to share wake ups. </param>
+        Timer(Callback callback,
+              std::chrono::milliseconds timeout,
+              std::chrono::milliseconds slack = std::chrono::milliseconds(0));
 
         /// <summary> Destructor. Stops the timer. </summary>
         ~Timer();
@@ -31,6 +43,7 @@ namespace zone {
         void Stop();
 
     private:
+        uint32_t _shard;
         Index _index;
     };
 }
@@ -0,0 +1,265 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "trace-recorder.h"
+
+#include <napa/log.h>
+#include <platform/process.h>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include <chrono>
+
+using namespace napa;
+using namespace napa::zone;
+
+/// <summary> Events of a thread, appended by the thread that holds the buffer and read when a trace stops. </summary>
+struct TraceRecorder::ThreadBuffer {
+
+    /// <summary> Sized by the holding thread when it resets the buffer. </summary>
+    std::vector<TraceEvent> events;
+
+    /// <summary> The number of events recorded, published after each event is written. </summary>
+    std::atomic<size_t> count;
+
+    /// <summary> The number of events dropped since the buffer was full. </summary>
+    std::atomic<uint64_t> dropped;
+
+    /// <summary> The trace the events belong to. </summary>
+    std::atomic<uint32_t> generation;
+
+    /// <summary> Whether a live thread holds the buffer. </summary>
+    std::atomic<bool> inUse;
+
+    ThreadBuffer() : count(0), dropped(0), generation(0), inUse(true) {}
+};
+
+/// <summary> Gives the buffer back when its thread exits. </summary>
+struct TraceRecorder::ThreadBufferHolder {
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadBufferHolder() {
+        if (buffer != nullptr) {
+            buffer->inUse.store(false, std::memory_order_release);
+        }
+    }
+};
+
+std::atomic<bool> TraceRecorder::_enabled(false);
+
+namespace {
+
+    /// <summary> Writes a time in nanoseconds as the microseconds the trace event format uses. </summary>
+    void WriteMicroseconds(rapidjson::Writer<rapidjson::StringBuffer>& writer, int64_t nanoseconds) {
+        writer.Double(static_cast<double>(nanoseconds) / 1000.0);
+    }
+}
+
+TraceRecorder& TraceRecorder::GetInstance() {
+    static TraceRecorder instance;
+    return instance;
+}
+
+TraceRecorder::TraceRecorder() : _generation(0), _eventsPerThread(DEFAULT_TRACE_EVENTS_PER_THREAD), _startTime(0) {}
+
+int64_t TraceRecorder::Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool TraceRecorder::Start(size_t eventsPerThread) {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_enabled) {
+        return false;
+    }
+
+    _startTime = Now();
+    _eventsPerThread = eventsPerThread;
+
+    // Threads see the new generation with the capacity, and reset their buffers on their next event.
+    _generation.fetch_add(1, std::memory_order_release);
+    _enabled = true;
+
+    NAPA_DEBUG("TraceRecorder", "Trace started with %zu events per thread.", eventsPerThread);
+    return true;
+}
+
+bool TraceRecorder::Stop(std::string& json) {
+    std::lock_guard<std::mutex> lock(_lock);
+    if (!_enabled.exchange(false)) {
+        return false;
+    }
+
+    auto generation = _generation.load(std::memory_order_relaxed);
+    auto pid = platform::Getpid();
+
+    rapidjson::StringBuffer stringBuffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(stringBuffer);
+
+    writer.StartObject();
+    writer.Key("traceEvents");
+    writer.StartArray();
+
+    for (const auto& name : _threadNames) {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String("thread_name");
+        writer.Key("ph");
+        writer.String("M");
+        writer.Key("pid");
+        writer.Int(pid);
+        writer.Key("tid");
+        writer.Int(name.first);
+        writer.Key("args");
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(name.second.c_str(), static_cast<rapidjson::SizeType>(name.second.size()));
+        writer.EndObject();
+        writer.EndObject();
+    }
+
+    uint64_t dropped = 0;
+    for (const auto& buffer : _buffers) {
+        // Buffers not reset since the trace started hold no event of it.
+        if (buffer->generation.load(std::memory_order_acquire) != generation) {
+            continue;
+        }
+
+        // Events past the published count may still be written, they are left out.
+        auto count = buffer->count.load(std::memory_order_acquire);
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < count; ++i) {
+            const auto& event = buffer->events[i];
+            const char phase[] = { event.phase, '\0' };
+
+            writer.StartObject();
+            writer.Key("name");
+            writer.String(event.name);
+            writer.Key("cat");
+            writer.String(event.category);
+            writer.Key("ph");
+            writer.String(phase);
+            writer.Key("ts");
+            WriteMicroseconds(writer, event.timestamp - _startTime);
+            if (event.phase == 'X') {
+                writer.Key("dur");
+                WriteMicroseconds(writer, event.duration);
+            } else if (event.phase == 'i') {
+                writer.Key("s");
+                writer.String("t");
+            }
+            writer.Key("pid");
+            writer.Int(pid);
+            writer.Key("tid");
+            writer.Int(event.threadId);
+            if (event.argName != nullptr) {
+                writer.Key("args");
+                writer.StartObject();
+                writer.Key(event.argName);
+                writer.Int64(event.argValue);
+                writer.EndObject();
+            }
+            writer.EndObject();
+        }
+    }
+
+    writer.EndArray();
+    writer.Key("otherData");
+    writer.StartObject();
+    writer.Key("droppedEvents");
+    writer.Uint64(dropped);
+    writer.EndObject();
+    writer.EndObject();
+
+    if (dropped > 0) {
+        LOG_WARNING("TraceRecorder", "%llu trace events were dropped since thread buffers were full.",
+            static_cast<unsigned long long>(dropped));
+    }
+
+    json.assign(stringBuffer.GetString(), stringBuffer.GetSize());
+    return true;
+}
+
+void TraceRecorder::RecordInstant(const char* category, const char* name, const char* argName, int64_t argValue) {
+    if (!IsEnabled()) {
+        return;
+    }
+    Record({ Now(), 0, category, name, argName, argValue, 0, 'i' });
+}
+
+void TraceRecorder::RecordComplete(
+    const char* category,
+    const char* name,
+    int64_t begin,
+    const char* argName,
+    int64_t argValue) {
+    if (!IsEnabled()) {
+        return;
+    }
+    Record({ begin, Now() - begin, category, name, argName, argValue, 0, 'X' });
+}
+
+void TraceRecorder::RecordBegin(const char* category, const char* name) {
+    if (!IsEnabled()) {
+        return;
+    }
+    Record({ Now(), 0, category, name, nullptr, 0, 0, 'B' });
+}
+
+void TraceRecorder::RecordEnd(const char* category, const char* name) {
+    if (!IsEnabled()) {
+        return;
+    }
+    Record({ Now(), 0, category, name, nullptr, 0, 0, 'E' });
+}
+
+void TraceRecorder::SetThreadName(std::string name) {
+    std::lock_guard<std::mutex> lock(_lock);
+    _threadNames[platform::Gettid()] = std::move(name);
+}
+
+void TraceRecorder::Record(const TraceEvent& event) {
+    static thread_local int32_t threadId = platform::Gettid();
+
+    auto buffer = GetThreadBuffer();
+    auto generation = _generation.load(std::memory_order_acquire);
+    if (buffer->generation.load(std::memory_order_relaxed) != generation) {
+        // Only the holding thread writes the buffer, the trace reads it once the new generation is published.
+        buffer->events.resize(_eventsPerThread.load(std::memory_order_relaxed));
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->generation.store(generation, std::memory_order_release);
+    }
+
+    auto count = buffer->count.load(std::memory_order_relaxed);
+    if (count >= buffer->events.size()) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[count] = event;
+    buffer->events[count].threadId = threadId;
+    buffer->count.store(count + 1, std::memory_order_release);
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::GetThreadBuffer() {
+    static thread_local ThreadBufferHolder holder;
+    if (holder.buffer != nullptr) {
+        return holder.buffer;
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+    for (auto& buffer : _buffers) {
+        bool inUse = false;
+        if (buffer->inUse.compare_exchange_strong(inUse, true, std::memory_order_acquire)) {
+            holder.buffer = buffer.get();
+            return holder.buffer;
+        }
+    }
+
+    _buffers.emplace_back(std::make_unique<ThreadBuffer>());
+    holder.buffer = _buffers.back().get();
+    return holder.buffer;
+}
@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> The number of events each thread records in a trace by default. </summary>
+    constexpr size_t DEFAULT_TRACE_EVENTS_PER_THREAD = 16 * 1024;
+
+    /// <summary> An event of a trace, with the phase of the Chrome trace event format. </summary>
+    struct TraceEvent {
+
+        /// <summary> Steady clock time in nanoseconds, the start of complete events. </summary>
+        int64_t timestamp;
+
+        /// <summary> Duration in nanoseconds of complete events. </summary>
+        int64_t duration;
+
+        /// <summary> The category, a string literal. </summary>
+        const char* category;
+
+        /// <summary> The name, a string literal. </summary>
+        const char* name;
+
+        /// <summary> The name of the argument, a string literal, or null if the event has none. </summary>
+        const char* argName;
+
+        /// <summary> The value of the argument. </summary>
+        int64_t argValue;
+
+        /// <summary> The thread that recorded the event. </summary>
+        int32_t threadId;
+
+        /// <summary> 'X' for complete events, 'i' for instant events, 'B' and 'E' for the begin and end of durations. </summary>
+        char phase;
+    };
+
+    /// <summary>
+    ///     Records scheduler and worker activity of all zones in the process, dumped in the Chrome trace event format.
+    ///     Each thread appends to its own buffer without locks, so recording adds no contention between workers.
+    /// </summary>
+    /// <remarks>
+    ///     A thread reuses its buffer across traces, the buffer is reset by its thread on its first event of a new trace.
+    ///     Events past the buffer capacity are dropped and counted. Buffers of exited threads are taken by new threads.
+    /// </remarks>
+    class TraceRecorder {
+    public:
+
+        /// <summary> Returns the recorder of the process. </summary>
+        static TraceRecorder& GetInstance();
+
+        /// <summary> Returns true while a trace is recorded, checked before taking timestamps for events. </summary>
+        static bool IsEnabled() {
+            return _enabled.load(std::memory_order_relaxed);
+        }
+
+        /// <summary> Returns the steady clock time in nanoseconds. </summary>
+        static int64_t Now();
+
+        /// <summary> Non-copyable. </summary>
+        TraceRecorder(const TraceRecorder&) = delete;
+        TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+        /// <summary> Starts recording a trace. </summary>
+        /// <param name="eventsPerThread"> The number of events each thread records at most. </param>
+        /// <returns> False if a trace is already recorded. </returns>
+        bool Start(size_t eventsPerThread = DEFAULT_TRACE_EVENTS_PER_THREAD);
+
+        /// <summary> Stops recording and formats the trace as Chrome trace event JSON. </summary>
+        /// <param name="json"> Receives the trace. </param>
+        /// <returns> False if no trace is recorded. </returns>
+        bool Stop(std::string& json);
+
+        /// <summary> Records an event that happened at a point in time. </summary>
+        void RecordInstant(const char* category, const char* name, const char* argName = nullptr, int64_t argValue = 0);
+
+        /// <summary> Records an event that ran from a time until now. </summary>
+        /// <param name="begin"> The start time, from Now(). </param>
+        void RecordComplete(
+            const char* category,
+            const char* name,
+            int64_t begin,
+            const char* argName = nullptr,
+            int64_t argValue = 0);
+
+        /// <summary> Records the start of a duration ended by RecordEnd on the same thread. </summary>
+        void RecordBegin(const char* category, const char* name);
+
+        /// <summary> Records the end of a duration started by RecordBegin on the same thread. </summary>
+        void RecordEnd(const char* category, const char* name);
+
+        /// <summary> Names the calling thread in the traces, i.e. after the worker and zone it runs. </summary>
+        void SetThreadName(std::string name);
+
+    private:
+        struct ThreadBuffer;
+        struct ThreadBufferHolder;
+
+        TraceRecorder();
+
+        /// <summary> Appends an event to the buffer of the calling thread. </summary>
+        void Record(const TraceEvent& event);
+
+        /// <summary> Returns the buffer of the calling thread, taking a free one on its first event. </summary>
+        ThreadBuffer* GetThreadBuffer();
+
+        /// <summary> Whether a trace is recorded. </summary>
+        static std::atomic<bool> _enabled;
+
+        /// <summary> Identifies the current trace, so threads reset their buffers lazily. </summary>
+        std::atomic<uint32_t> _generation;
+
+        /// <summary> The capacity of the buffers in the current trace. </summary>
+        std::atomic<size_t> _eventsPerThread;
+
+        /// <summary> The time the current trace started. </summary>
+        int64_t _startTime;
+
+        /// <summary> Guards starting and stopping traces, taking buffers and naming threads. </summary>
+        std::mutex _lock;
+
+        std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+        std::unordered_map<int32_t, std::string> _threadNames;
+    };
+
+    /// <summary> Records a complete event for the lifetime of the scope, if a trace was recorded when it started. </summary>
+    class TraceScope {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="category"> The category, a string literal. </param>
+        /// <param name="name"> The name, a string literal. </param>
+        /// <param name="argName"> The name of the argument, a string literal, or null if the event has none. </param>
+        /// <param name="argValue"> The value of the argument. </param>
+        TraceScope(const char* category, const char* name, const char* argName = nullptr, int64_t argValue = 0) :
+            _category(category),
+            _name(name),
+            _argName(argName),
+            _argValue(argValue),
+            _begin(TraceRecorder::IsEnabled() ? TraceRecorder::Now() : -1) {}
+
+        /// <summary> Destructor. Records the event. </summary>
+        ~TraceScope() {
+            if (_begin >= 0 && TraceRecorder::IsEnabled()) {
+                TraceRecorder::GetInstance().RecordComplete(_category, _name, _begin, _argName, _argValue);
+            }
+        }
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+    private:
+        const char* _category;
+        const char* _name;
+        const char* _argName;
+        int64_t _argValue;
+        int64_t _begin;
+    };
+}
+}
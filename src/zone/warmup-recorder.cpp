@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "warmup-recorder.h"
+
+#include <napa/log.h>
+#include <napa/transport/transport-context.h>
+#include <utils/payload-compression.h>
+
+#include <cstdio>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    void AppendJsonString(std::string& line, const char* data, size_t size) {
+        line.push_back('"');
+        for (size_t i = 0; i < size; i++) {
+            auto c = data[i];
+            switch (c) {
+                case '"': line.append("\\\""); break;
+                case '\\': line.append("\\\\"); break;
+                case '\n': line.append("\\n"); break;
+                case '\r': line.append("\\r"); break;
+                case '\t': line.append("\\t"); break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[7];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                        line.append(escaped);
+                    } else {
+                        line.push_back(c);
+                    }
+            }
+        }
+        line.push_back('"');
+    }
+}
+
+WarmupRecorder::WarmupRecorder(std::string path, std::string module, std::string function, size_t maxSamples) :
+    _path(std::move(path)),
+    _module(std::move(module)),
+    _function(std::move(function)),
+    _maxSamples(maxSamples),
+    _done(maxSamples == 0),
+    _count(0) {
+}
+
+void WarmupRecorder::Record(const FunctionSpec& spec) {
+    if (_done.load(std::memory_order_relaxed)
+        || spec.options.transport == BINARY
+        || (spec.transportContext != nullptr && spec.transportContext->GetSharedCount() > 0)
+        || _function.compare(0, std::string::npos, spec.function.data, spec.function.size) != 0
+        || _module.compare(0, std::string::npos, spec.module.data, spec.module.size) != 0) {
+        return;
+    }
+
+    // Arguments are copied, compressed ones are decompressed, so the sample is plain JSON.
+    std::vector<std::string> arguments;
+    if (!spec.ownedArguments.empty()) {
+        arguments = spec.ownedArguments;
+    } else {
+        for (const auto& argument : spec.arguments) {
+            arguments.emplace_back(argument.data, argument.size);
+        }
+    }
+    for (auto& argument : arguments) {
+        if (!utils::DecompressPayload(argument)) {
+            return;
+        }
+    }
+    auto line = FormatSample(arguments);
+
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_count >= _maxSamples) {
+        return;
+    }
+    if (!_file.is_open()) {
+        _file.open(_path, std::ios::out | std::ios::trunc);
+        if (!_file) {
+            LOG_ERROR("Zone", "Failed to open warm-up samples file \"%s\"", _path.c_str());
+            _done = true;
+            return;
+        }
+    }
+
+    // Each sample is flushed, so samples survive a process that doesn't exit cleanly.
+    _file << line << '\n';
+    _file.flush();
+    if (++_count == _maxSamples) {
+        _file.close();
+        _done = true;
+    }
+}
+
+size_t WarmupRecorder::GetSampleCount() const {
+    std::lock_guard<std::mutex> lock(_lock);
+    return _count;
+}
+
+std::string WarmupRecorder::FormatSample(const std::vector<std::string>& arguments) {
+    std::string line("[");
+    for (size_t i = 0; i < arguments.size(); i++) {
+        if (i > 0) {
+            line.push_back(',');
+        }
+        AppendJsonString(line, arguments[i].data(), arguments[i].size());
+    }
+    line.push_back(']');
+    return line;
+}
@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <napa/types.h>
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> The number of calls a warm-up recorder keeps by default. </summary>
+    constexpr size_t DEFAULT_WARMUP_SAMPLES = 1000;
+
+    /// <summary> Records the arguments of the first calls of a function into a file of warm-up samples. </summary>
+    /// <remarks>
+    ///     Each line of the file is a sample, the JSON array of the marshalled arguments of a call as strings, which is
+    ///     what the warm-up of a zone replays. The file is truncated on the first sample. Calls passing handles or binary
+    ///     arguments are not recorded, they can't be replayed from a file.
+    /// </remarks>
+    class WarmupRecorder {
+    public:
+
+        /// <summary> Constructor. </summary>
+        /// <param name="path"> The file the samples are written to. </param>
+        /// <param name="module"> The module of the recorded function, as calls name it. </param>
+        /// <param name="function"> The recorded function. </param>
+        /// <param name="maxSamples"> The number of calls recorded at most. </param>
+        WarmupRecorder(std::string path, std::string module, std::string function, size_t maxSamples = DEFAULT_WARMUP_SAMPLES);
+
+        /// <summary> Non-copyable. </summary>
+        WarmupRecorder(const WarmupRecorder&) = delete;
+        WarmupRecorder& operator=(const WarmupRecorder&) = delete;
+
+        /// <summary> Records the arguments of a call if it's a call of the function and the recorder isn't full. </summary>
+        void Record(const FunctionSpec& spec);
+
+        /// <summary> Returns the number of samples written so far. </summary>
+        size_t GetSampleCount() const;
+
+        /// <summary> Formats marshalled arguments as a sample line, without the line break. </summary>
+        static std::string FormatSample(const std::vector<std::string>& arguments);
+
+    private:
+
+        std::string _path;
+        std::string _module;
+        std::string _function;
+        size_t _maxSamples;
+
+        /// <summary> Set once the recorder is full or its file can't be written, so other calls are not checked. </summary>
+        std::atomic<bool> _done;
+
+        mutable std::mutex _lock;
+        std::ofstream _file;
+        size_t _count;
+    };
+}
+}
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "worker-affinity.h"
+
+#include <platform/thread.h>
+
+#include <napa/log.h>
+
+#include <algorithm>
+#include <iterator>
+
+using namespace napa;
+using namespace napa::zone;
+
+std::vector<uint32_t> napa::zone::ComputeWorkerAffinity(
+    WorkerId id,
+    const settings::ZoneSettings& settings,
+    const std::vector<uint32_t>& numaNodeCpus,
+    const std::vector<uint32_t>& physicalCoreCpus) {
+
+    auto hasNumaNode = settings.numaNode >= 0;
+    if (settings.cpuSet.empty() && !hasNumaNode && !settings.pinWorkersToCores) {
+        return {};
+    }
+
+    // Candidate CPUs are the explicit CPU set, restricted to the NUMA node if both are given.
+    std::vector<uint32_t> candidates;
+    if (!settings.cpuSet.empty() && hasNumaNode) {
+        std::set_intersection(
+            settings.cpuSet.begin(), settings.cpuSet.end(),
+            numaNodeCpus.begin(), numaNodeCpus.end(),
+            std::back_inserter(candidates));
+    } else if (!settings.cpuSet.empty()) {
+        candidates = settings.cpuSet;
+    } else if (hasNumaNode) {
+        candidates = numaNodeCpus;
+    } else {
+        candidates = physicalCoreCpus;
+    }
+
+    if (!settings.pinWorkersToCores || candidates.empty()) {
+        return candidates;
+    }
+
+    // Skip hyper-threaded siblings so each worker owns a physical core, unless that leaves nothing.
+    std::vector<uint32_t> cores;
+    std::set_intersection(
+        candidates.begin(), candidates.end(),
+        physicalCoreCpus.begin(), physicalCoreCpus.end(),
+        std::back_inserter(cores));
+
+    if (cores.empty()) {
+        cores = std::move(candidates);
+    }
+
+    // Workers wrap around when there are more workers than cores.
+    return { cores[id % cores.size()] };
+}
+
+bool napa::zone::ApplyWorkerAffinity(WorkerId id, const settings::ZoneSettings& settings) {
+    if (settings.cpuSet.empty() && settings.numaNode < 0 && !settings.pinWorkersToCores) {
+        return true;
+    }
+
+    std::vector<uint32_t> numaNodeCpus;
+    if (settings.numaNode >= 0) {
+        numaNodeCpus = platform::GetNumaNodeCpus(static_cast<uint32_t>(settings.numaNode));
+    }
+
+    std::vector<uint32_t> physicalCoreCpus;
+    if (settings.pinWorkersToCores) {
+        physicalCoreCpus = platform::GetPhysicalCoreCpus();
+    }
+
+    auto cpus = ComputeWorkerAffinity(id, settings, numaNodeCpus, physicalCoreCpus);
+    if (cpus.empty()) {
+        LOG_WARNING("Worker", "(id=%u) No CPU matches the zone CPU set and NUMA node settings.", id);
+        return false;
+    }
+
+    if (!platform::SetCurrentThreadAffinity(cpus)) {
+        LOG_WARNING("Worker", "(id=%u) Failed to set thread affinity.", id);
+        return false;
+    }
+
+    NAPA_DEBUG("Worker", "(id=%u) Thread affinity set to %zu CPU(s), first CPU %u.", id, cpus.size(), cpus.front());
+    return true;
+}
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "worker.h"
+
+#include <settings/settings.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Computes the logical CPUs a worker should run on according to the zone settings. </summary>
+    /// <param name="id"> The worker id. </param>
+    /// <param name="settings"> The zone settings. </param>
+    /// <param name="numaNodeCpus"> The CPUs of the NUMA node from settings, ignored if no node is set. </param>
+    /// <param name="physicalCoreCpus"> One CPU per physical core, used when pinning workers to cores. </param>
+    /// <returns> The CPUs to run on, empty if the worker should not be restricted. </returns>
+    std::vector<uint32_t> ComputeWorkerAffinity(
+        WorkerId id,
+        const settings::ZoneSettings& settings,
+        const std::vector<uint32_t>& numaNodeCpus,
+        const std::vector<uint32_t>& physicalCoreCpus);
+
+    /// <summary> Applies the affinity from zone settings to the calling worker thread. </summary>
+    /// <returns> False if an affinity was requested but couldn't be applied, true otherwise. </returns>
+    bool ApplyWorkerAffinity(WorkerId id, const settings::ZoneSettings& settings);
+}
+}
@@ -24,7 +24,10 @@ void WorkerContext::Init() {
 
 void* WorkerContext::Get(WorkerContextItem item) {
     NAPA_ASSERT(item < WorkerContextItem::END_OF_WORKER_CONTEXT_ITEM, "Invalid WorkerContextItem");
-    return (*items)[static_cast<size_t>(item)];
+
+    // Threads that are not workers, like async work threads, have no worker context.
+    auto data = items.operator->();
+    return data != nullptr ? (*data)[static_cast<size_t>(item)] : nullptr;
 }
 
 void WorkerContext::Set(WorkerContextItem item, void* data) {
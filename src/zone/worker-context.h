@@ -6,6 +6,7 @@
 #include <napa/exports.h>
 
 #include <array>
+#include <cstdint>
 
 namespace napa {
 namespace zone {
@@ -30,6 +31,36 @@ namespace zone {
         /// <summary> Worker Id. </summary>
         WORKER_ID,
 
+        /// <summary> Values unmarshalled from frozen stores, reused by store.get. </summary>
+        STORE_VALUE_CACHE,
+
+        /// <summary> Store watches created by this worker, stopped by store.unwatch. </summary>
+        STORE_WATCHES,
+
+        /// <summary> Allocator of the zone, see napa::memory::GetZoneAllocator. </summary>
+        ALLOCATOR,
+
+        /// <summary> Arena reset after each call task, see napa::memory::GetTaskArena. </summary>
+        TASK_ARENA,
+
+        /// <summary> Persistent handle of the global __napa_zone_call__ function, resolved by the first call task. </summary>
+        ZONE_CALL_FUNCTION,
+
+        /// <summary> Call context wraps released by finished calls, reused by CallContextWrap::Acquire. </summary>
+        CALL_CONTEXT_WRAP_POOL,
+
+        /// <summary> Context of the call running synchronously on this worker, null between calls. </summary>
+        CALL_CONTEXT,
+
+        /// <summary> Wraps of shared objects by pointer, reused by binding::CreateShareableWrap and unmarshall. </summary>
+        SHAREABLE_WRAP_CACHE,
+
+        /// <summary> Contexts of the tenants served by this worker, null unless the zone sets tenantContexts. </summary>
+        TENANT_CONTEXTS,
+
+        /// <summary> Completions of async work issued by this worker, waiting to run on it. </summary>
+        ASYNC_COMPLETIONS,
+
         /// <summary> End of index. </summary>
         END_OF_WORKER_CONTEXT_ITEM
     };
@@ -43,7 +74,7 @@ namespace zone {
 
         /// <summary> Get stored TLS data. </summary>
         /// <param name="item"> Pre-defined data id for Napa specific data. </param>
-        /// <returns> Stored TLS data. </returns>
+        /// <returns> Stored TLS data, nullptr if not set or if the thread has no worker context. </returns>
         static void* Get(WorkerContextItem item);
 
         /// <summary> Set TLS data into the given slot. </summary>
@@ -0,0 +1,117 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "worker-event-loop.h"
+
+#include <napa/log.h>
+#include <napa/zone/event-loop.h>
+
+#ifdef NAPA_WORKER_EVENT_LOOP
+#include <uv.h>
+#endif
+
+using namespace napa::zone;
+
+#ifdef NAPA_WORKER_EVENT_LOOP
+
+namespace {
+    thread_local uv_loop_t* currentLoop = nullptr;
+}
+
+struct WorkerEventLoop::Impl {
+
+    /// <summary> The libuv loop. </summary>
+    uv_loop_t loop;
+
+    /// <summary> Handle signaled by Wake, it also keeps the loop alive when no native module uses it. </summary>
+    uv_async_t wakeHandle;
+
+    /// <summary> Timer bounding Wait. </summary>
+    uv_timer_t waitTimer;
+};
+
+WorkerEventLoop::WorkerEventLoop() : _impl(std::make_unique<Impl>()) {
+    uv_loop_init(&_impl->loop);
+
+    // Wake only needs to interrupt uv_run, the callback has nothing to do.
+    uv_async_init(&_impl->loop, &_impl->wakeHandle, [](uv_async_t*) {});
+
+    uv_timer_init(&_impl->loop, &_impl->waitTimer);
+    uv_unref(reinterpret_cast<uv_handle_t*>(&_impl->waitTimer));
+
+    currentLoop = &_impl->loop;
+}
+
+WorkerEventLoop::~WorkerEventLoop() {
+    currentLoop = nullptr;
+
+    // Close every handle, including the ones native modules didn't close, and run the close callbacks.
+    uv_walk(&_impl->loop, [](uv_handle_t* handle, void*) {
+        if (!uv_is_closing(handle)) {
+            uv_close(handle, nullptr);
+        }
+    }, nullptr);
+    uv_run(&_impl->loop, UV_RUN_DEFAULT);
+
+    if (uv_loop_close(&_impl->loop) != 0) {
+        LOG_WARNING("Worker", "The worker event loop was closed with pending requests.");
+    }
+}
+
+std::unique_ptr<WorkerEventLoop> WorkerEventLoop::Create() {
+    return std::unique_ptr<WorkerEventLoop>(new WorkerEventLoop());
+}
+
+void WorkerEventLoop::RunReady() {
+    uv_run(&_impl->loop, UV_RUN_NOWAIT);
+}
+
+void WorkerEventLoop::Wait(std::chrono::milliseconds timeout) {
+    if (timeout.count() >= 0) {
+        uv_timer_start(&_impl->waitTimer, [](uv_timer_t*) {}, static_cast<uint64_t>(timeout.count()), 0);
+    }
+
+    // The wake handle is always active, so this blocks until an event comes.
+    uv_run(&_impl->loop, UV_RUN_ONCE);
+    uv_timer_stop(&_impl->waitTimer);
+}
+
+void WorkerEventLoop::Wake() {
+    uv_async_send(&_impl->wakeHandle);
+}
+
+void* WorkerEventLoop::GetCurrent() {
+    return currentLoop;
+}
+
+#else
+
+struct WorkerEventLoop::Impl {};
+
+WorkerEventLoop::WorkerEventLoop() = default;
+
+WorkerEventLoop::~WorkerEventLoop() = default;
+
+std::unique_ptr<WorkerEventLoop> WorkerEventLoop::Create() {
+    LOG_WARNING("Worker", "Napa is built without NAPA_WORKER_EVENT_LOOP, workers run without an event loop.");
+    return nullptr;
+}
+
+void WorkerEventLoop::RunReady() {
+}
+
+void WorkerEventLoop::Wait(std::chrono::milliseconds) {
+}
+
+void WorkerEventLoop::Wake() {
+}
+
+void* WorkerEventLoop::GetCurrent() {
+    return nullptr;
+}
+
+#endif
+
+uv_loop_s* napa::zone::GetEventLoop() {
+    return static_cast<uv_loop_s*>(WorkerEventLoop::GetCurrent());
+}
@@ -0,0 +1,51 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> A libuv event loop of a worker, which runs I/O callbacks of native modules between tasks. </summary>
+    /// <remarks>
+    ///     The loop is created, run and destroyed by the worker thread, only Wake can be called from other threads.
+    ///     It's only available when Napa is built with NAPA_WORKER_EVENT_LOOP, see napa::zone::GetEventLoop.
+    /// </remarks>
+    class WorkerEventLoop {
+    public:
+
+        /// <summary> Creates the event loop of the current thread. </summary>
+        /// <returns> The loop, or null if Napa is built without worker event loops. </returns>
+        static std::unique_ptr<WorkerEventLoop> Create();
+
+        /// <summary> Closes the handles left open by native modules and the loop. </summary>
+        ~WorkerEventLoop();
+
+        WorkerEventLoop(const WorkerEventLoop&) = delete;
+        WorkerEventLoop& operator=(const WorkerEventLoop&) = delete;
+
+        /// <summary> Runs the callbacks of the events that are ready, without blocking. </summary>
+        void RunReady();
+
+        /// <summary> Blocks until an event is ready or Wake is called, and runs the callbacks of the ready events. </summary>
+        /// <param name="timeout"> The longest time to block, negative for no limit. </param>
+        void Wait(std::chrono::milliseconds timeout);
+
+        /// <summary> Makes a blocked or the next Wait return, from any thread. </summary>
+        void Wake();
+
+        /// <summary> Gets the loop of the worker running on the current thread, null on other threads. </summary>
+        /// <remarks> The returned pointer is a uv_loop_t*. </remarks>
+        static void* GetCurrent();
+
+    private:
+        WorkerEventLoop();
+
+        struct Impl;
+        std::unique_ptr<Impl> _impl;
+    };
+}
+}
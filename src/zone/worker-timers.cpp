@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "worker-timers.h"
+#include "timer-slack.h"
+#include "trace-recorder.h"
+
+#include <platform/tracepoint.h>
+
+#include <algorithm>
+#include <limits>
+
+using namespace napa::zone;
+
+namespace {
+    thread_local WorkerTimers* currentTimers = nullptr;
+
+    /// <summary> Rounds a time up to milliseconds since the clock epoch, the ticks timers with slack coalesce on. </summary>
+    uint64_t ToTick(WorkerTimers::Clock::time_point time) {
+        auto sinceEpoch = time.time_since_epoch();
+        auto tick = std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch);
+        if (tick < sinceEpoch) {
+            tick += std::chrono::milliseconds(1);
+        }
+        return static_cast<uint64_t>(tick.count());
+    }
+}
+
+WorkerTimers::WorkerTimers() : _sequence(0), _slack(0), _alignedIntervals(false) {
+}
+
+void WorkerTimers::SetSlack(std::chrono::milliseconds slack) {
+    _slack = std::max(slack, std::chrono::milliseconds(0));
+}
+
+void WorkerTimers::SetAlignedIntervals(bool alignedIntervals) {
+    _alignedIntervals = alignedIntervals;
+}
+
+void WorkerTimers::Add(Callback callback, std::chrono::milliseconds timeout, bool repeating) {
+    auto now = Clock::now();
+    auto due = now + timeout;
+    auto aligned = repeating && _alignedIntervals && timeout.count() > 0;
+    if (_slack.count() > 0 || aligned) {
+        auto earliest = aligned
+            ? AlignTick(ToTick(now), static_cast<uint64_t>(timeout.count()))
+            : ToTick(due);
+        auto preferred = _entries.empty() ? std::numeric_limits<uint64_t>::max() : ToTick(_entries.top().due);
+        auto tick = CoalesceTick(earliest, static_cast<uint64_t>(_slack.count()), preferred);
+        due = Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::milliseconds(tick)));
+    }
+    _entries.push(Entry{ due, _sequence++, std::move(callback) });
+}
+
+size_t WorkerTimers::FireDue() {
+    size_t fired = 0;
+    auto now = Clock::now();
+    auto added = _sequence;
+    while (!_entries.empty() && _entries.top().due <= now && _entries.top().sequence < added) {
+        // The callback may add timers, so it's taken out of the heap before it runs.
+        auto callback = std::move(const_cast<Entry&>(_entries.top()).callback);
+        NAPA_TRACEPOINT1(worker__timer__fire, "lateNs",
+            static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - _entries.top().due).count()));
+        _entries.pop();
+
+        {
+            TraceScope traceScope("timer", "Timer");
+            callback();
+        }
+        fired++;
+    }
+    return fired;
+}
+
+bool WorkerTimers::HasDue() const {
+    return !_entries.empty() && _entries.top().due <= Clock::now();
+}
+
+bool WorkerTimers::GetNextDue(Clock::time_point& due) const {
+    if (_entries.empty()) {
+        return false;
+    }
+    due = _entries.top().due;
+    return true;
+}
+
+size_t WorkerTimers::GetSize() const {
+    return _entries.size();
+}
+
+WorkerTimers* WorkerTimers::GetCurrent() {
+    return currentTimers;
+}
+
+void WorkerTimers::SetCurrent(WorkerTimers* timers) {
+    currentTimers = timers;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary> Timers of one worker, fired by the worker thread between tasks. </summary>
+    /// <remarks>
+    ///     The timers are kept in a binary heap that only the owning thread touches, so adding and firing
+    ///     a timer takes no lock. Timers due at the same time fire in the order they were added.
+    ///     With slack, timers may fire up to that many milliseconds late, with the next timer or on a coarse tick,
+    ///     so the worker wakes up once for timers due close to each other.
+    /// </remarks>
+    class WorkerTimers {
+    public:
+        typedef std::chrono::steady_clock Clock;
+        typedef std::function<void(void)> Callback;
+
+        WorkerTimers();
+
+        WorkerTimers(const WorkerTimers&) = delete;
+        WorkerTimers& operator=(const WorkerTimers&) = delete;
+
+        /// <summary> Sets the milliseconds timers may fire after their timeout, for timers added later. </summary>
+        void SetSlack(std::chrono::milliseconds slack);
+
+        /// <summary> Sets whether repeating timers fire on multiples of their timeout instead of after it. </summary>
+        void SetAlignedIntervals(bool alignedIntervals);
+
+        /// <summary> Adds a timer firing once after the timeout. </summary>
+        /// <param name="callback"> The callback, it may add timers. </param>
+        /// <param name="timeout"> The timeout in millisecond after which the callback will be triggered. </param>
+        /// <param name="repeating">
+        ///     Whether it is a tick of an interval, which fires on the next multiple of the timeout since the clock epoch
+        ///     when intervals are aligned. Then intervals of a period fire together, and the first tick may come sooner.
+        /// </param>
+        void Add(Callback callback, std::chrono::milliseconds timeout, bool repeating = false);
+
+        /// <summary> Fires the timers that are due, timers added by the callbacks fire on a later call. </summary>
+        /// <returns> The number of timers fired. </returns>
+        size_t FireDue();
+
+        /// <summary> Tells if a timer is due. </summary>
+        bool HasDue() const;
+
+        /// <summary> Gets the time the next timer is due. </summary>
+        /// <returns> False if there is no timer. </returns>
+        bool GetNextDue(Clock::time_point& due) const;
+
+        /// <summary> Returns the number of timers that didn't fire yet. </summary>
+        size_t GetSize() const;
+
+        /// <summary> Gets the timers of the worker running on the current thread, null on other threads. </summary>
+        static WorkerTimers* GetCurrent();
+
+        /// <summary> Sets the timers of the worker running on the current thread. </summary>
+        static void SetCurrent(WorkerTimers* timers);
+
+    private:
+        struct Entry {
+            Clock::time_point due;
+            uint64_t sequence;
+            Callback callback;
+
+            /// <summary> Orders the heap by due time first and adding order next, the earliest at its top. </summary>
+            bool operator<(const Entry& other) const {
+                return due != other.due ? due > other.due : sequence > other.sequence;
+            }
+        };
+
+        std::priority_queue<Entry, std::vector<Entry>> _entries;
+        uint64_t _sequence;
+
+        std::chrono::milliseconds _slack;
+        bool _alignedIntervals;
+    };
+}
+}
@@ -2,28 +2,40 @@
 // Licensed under the MIT license.
 
 #include "worker.h"
+#include "cpu-profile-tasks.h"
+#include "isolate-pool.h"
+#include "tenant-contexts.h"
+#include "trace-recorder.h"
+#include "worker-affinity.h"
+#include "worker-event-loop.h"
+#include "worker-timers.h"
 
 #include <napa/log.h>
+#include <napa/providers/metric.h>
+#include <platform/thread.h>
+#include <platform/tracepoint.h>
+#include <providers/metric-buffer.h>
+#include <v8-extensions/array-buffer-allocator.h>
+#include <v8-extensions/v8-extensions-macros.h>
 
 #include <v8.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdlib>
 #include <mutex>
 #include <queue>
 #include <thread>
 
-#include <v8-extensions/v8-extensions-macros.h>
-#if !(V8_VERSION_CHECK_FOR_ARRAY_BUFFER_ALLOCATOR)
-    #include <v8-extensions/array-buffer-allocator.h>
-#endif
-
 using namespace napa;
 using namespace napa::zone;
 
 // Forward declaration
-static v8::Isolate* CreateIsolate(const settings::ZoneSettings& settings);
 static void ConfigureIsolate(v8::Isolate* isolate, const settings::ZoneSettings& settings);
+static void FireTimers(v8::Isolate* isolate, WorkerTimers& timers, std::atomic<uint64_t>& busyTime, std::atomic<int64_t>& busySince);
+static void RunEventLoop(v8::Isolate* isolate, WorkerEventLoop* eventLoop);
 
 struct Worker::Impl {
 
@@ -45,6 +57,60 @@ struct Worker::Impl {
     /// <summary> Lock for task queue and immediate task queue. </summary>
     std::mutex queueLock;
 
+    /// <summary> Number of queued tasks, readable without the lock while the worker spins. </summary>
+    std::atomic<size_t> queuedTasks;
+
+    /// <summary> Whether the worker thread waits on hasTaskEvent, guarded by the queue lock. </summary>
+    bool parked;
+
+    /// <summary> Whether tasks ran since the worker last gave V8 idle time, only touched by the worker thread. </summary>
+    bool ranTasks;
+
+    /// <summary> The number of tasks the worker ran, written by the worker thread. </summary>
+    std::atomic<uint64_t> executedTasks;
+
+    /// <summary> Nanoseconds spent running tasks and timers, written by the worker thread. </summary>
+    std::atomic<uint64_t> busyTime;
+
+    /// <summary> Nanoseconds spent waiting for tasks, written by the worker thread. </summary>
+    std::atomic<uint64_t> idleTime;
+
+    /// <summary> Steady clock nanoseconds since the running task or timers started, 0 while waiting, written by the worker thread. </summary>
+    std::atomic<int64_t> busySince;
+
+    /// <summary> The counters at the last metric report, only touched by the worker thread. </summary>
+    uint64_t reportedTasks;
+    uint64_t reportedBusyTime;
+    uint64_t reportedIdleTime;
+
+    /// <summary> The time of the last metric report, only touched by the worker thread. </summary>
+    std::chrono::steady_clock::time_point reportTime;
+
+    /// <summary> Metric updates buffered by JavaScript running on this worker, only touched by the worker thread. </summary>
+    providers::MetricBuffer metricBuffer;
+
+    /// <summary> The time the metric buffer was last flushed, only touched by the worker thread. </summary>
+    std::chrono::steady_clock::time_point metricFlushTime;
+
+    /// <summary> The number of tasks run since microtasks last ran, only touched by the worker thread. </summary>
+    uint32_t tasksSinceMicrotasks;
+
+    /// <summary> The time microtasks last ran, only touched by the worker thread. </summary>
+    std::chrono::steady_clock::time_point microtasksTime;
+
+    /// <summary> Whether the worker reached a recycling limit, set by the worker thread. </summary>
+    std::atomic<bool> recycleDue;
+
+    /// <summary> Whether the heap got near its limit, the worker then rejects the calls it gets. Set by the worker thread. </summary>
+    std::atomic<bool> heapLimitReached;
+
+    /// <summary> Timers of JavaScript running on this worker, only touched by the worker thread. </summary>
+    WorkerTimers timers;
+
+    /// <summary> Event loop of native modules running on this worker, null unless 'eventLoop' is set. </summary>
+    /// <remarks> Created and run by the worker thread, other threads only wake it up under the queue lock. </remarks>
+    std::unique_ptr<WorkerEventLoop> eventLoop;
+
     /// <summary> V8 isolate associated with this worker. </summary>
     v8::Isolate* isolate;
 
@@ -65,9 +131,24 @@ Worker::Worker(WorkerId id,
     : _impl(std::make_unique<Worker::Impl>()) {
 
     _impl->id = id;
+    _impl->queuedTasks = 0;
+    _impl->parked = false;
+    _impl->ranTasks = false;
+    _impl->executedTasks = 0;
+    _impl->busyTime = 0;
+    _impl->idleTime = 0;
+    _impl->busySince = 0;
+    _impl->reportedTasks = 0;
+    _impl->reportedBusyTime = 0;
+    _impl->reportedIdleTime = 0;
+    _impl->recycleDue = false;
+    _impl->heapLimitReached = false;
+    _impl->tasksSinceMicrotasks = 0;
     _impl->setupCallback = std::move(setupCallback);
     _impl->idleNotificationCallback = std::move(idleNotificationCallback);
     _impl->settings = settings;
+    _impl->timers.SetSlack(std::chrono::milliseconds(settings.timerSlack));
+    _impl->timers.SetAlignedIntervals(settings.alignedIntervals);
 }
 
 Worker::~Worker() {
@@ -92,11 +173,16 @@ void Worker::Start() {
 
 void Worker::Schedule(std::shared_ptr<Task> task, SchedulePhase phase) {
     NAPA_ASSERT(task != nullptr, "Task should not be null");
+    if (TraceRecorder::IsEnabled()) {
+        TraceRecorder::GetInstance().RecordInstant("scheduler", "Dispatch", "worker", _impl->id);
+    }
+    NAPA_TRACEPOINT2(dispatch, "zone", _impl->settings.id.c_str(), "worker", _impl->id);
     Enqueue(task, phase);
     NAPA_DEBUG("Worker", "(id=%u) Task queued.", _impl->id);
 }
 
 void Worker::Enqueue(std::shared_ptr<Task> task, SchedulePhase phase) {
+    bool parked;
     {
         std::unique_lock<std::mutex> lock(_impl->queueLock);
         if (phase == SchedulePhase::ImmediatePhase && task != nullptr) {
@@ -105,13 +191,40 @@ void Worker::Enqueue(std::shared_ptr<Task> task, SchedulePhase phase) {
         else {
             _impl->tasks.emplace(std::move(task));
         }
+        _impl->queuedTasks++;
+        parked = _impl->parked;
+
+        // A worker with an event loop parks in the loop, the lock keeps the loop alive while it's woken up.
+        if (parked && _impl->eventLoop != nullptr) {
+            _impl->eventLoop->Wake();
+            return;
+        }
+    }
+
+    // A spinning worker sees the task without being woken up.
+    if (parked) {
+        _impl->hasTaskEvent.notify_one();
     }
-    _impl->hasTaskEvent.notify_one();
 }
 
 void Worker::WorkerThreadFunc(const settings::ZoneSettings& settings) {
     
-    _impl->isolate = CreateIsolate(settings);
+    // Set affinity before the isolate is created, so its heap is first touched on the local NUMA node.
+    (void)ApplyWorkerAffinity(_impl->id, settings);
+
+    // Threads start with the priority of their creator, only other priorities are applied.
+    if (settings.threadPriority != platform::ThreadPriority::Normal
+        && !platform::SetCurrentThreadPriority(settings.threadPriority)) {
+        LOG_WARNING("Worker", "(id=%u) Failed to set thread priority.", _impl->id);
+    }
+
+    // Zones with default isolate settings take an isolate created ahead of time if the pool has one.
+    // It's set under the queue lock, other threads terminate execution through it.
+    auto isolate = IsolatePool::GetInstance().Acquire(settings);
+    {
+        std::lock_guard<std::mutex> lock(_impl->queueLock);
+        _impl->isolate = isolate;
+    }
 
     // If any user of v8 library uses a locker on any isolate, all isolates must be locked before use.
     // Since we are 1-1 with threads and isolates, a top level lock that is never released is ok.
@@ -119,6 +232,25 @@ void Worker::WorkerThreadFunc(const settings::ZoneSettings& settings) {
 
     ConfigureIsolate(_impl->isolate, settings);
 
+    // V8 calls back from a garbage collection that didn't free enough memory, instead of failing with a fatal error.
+    // Only the synchronized scheduler replaces a worker, the others would keep dispatching calls to it.
+    if (settings.recycleOnHeapLimit && settings.scheduler == settings::SchedulerType::Synchronized) {
+        _impl->isolate->AddNearHeapLimitCallback([](void* data, size_t currentHeapLimit, size_t initialHeapLimit) {
+            auto impl = static_cast<Worker::Impl*>(data);
+
+            // JavaScript can't run within a garbage collection, the worker sheds its calls once the running task returns.
+            // A task that keeps allocating past the raised limit is terminated.
+            if (impl->heapLimitReached) {
+                impl->isolate->TerminateExecution();
+            } else {
+                LOG_ERROR("Worker", "(id=%u) Heap is near its limit of %zu bytes, the worker is recycled.", impl->id, currentHeapLimit);
+                impl->heapLimitReached = true;
+                impl->recycleDue = true;
+            }
+            return currentHeapLimit + initialHeapLimit / 2;
+        }, _impl.get());
+    }
+
     v8::Isolate::Scope isolateScope(_impl->isolate);
     v8::HandleScope handleScope(_impl->isolate);
     v8::Local<v8::Context> context = v8::Context::New(_impl->isolate);
@@ -129,13 +261,37 @@ void Worker::WorkerThreadFunc(const settings::ZoneSettings& settings) {
 
     NAPA_DEBUG("Worker", "(id=%u) V8 Isolate created.", _impl->id);
 
+    if (settings.eventLoop) {
+        auto eventLoop = WorkerEventLoop::Create();
+        std::lock_guard<std::mutex> lock(_impl->queueLock);
+        _impl->eventLoop = std::move(eventLoop);
+    }
+
+    TraceRecorder::GetInstance().SetThreadName(settings.id + " worker " + std::to_string(_impl->id));
+
     // Setup worker after isolate creation.
+    WorkerTimers::SetCurrent(&_impl->timers);
+    providers::MetricBuffer::SetCurrent(&_impl->metricBuffer);
+    v8_extensions::ArrayBufferAllocator::SetCurrent(true);
     _impl->setupCallback(_impl->id);
 
     NAPA_DEBUG("Worker", "(id=%u) Setup completed.", _impl->id);
 
+    using Clock = std::chrono::steady_clock;
+    auto elapsedSince = [](Clock::time_point start) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    };
+    _impl->reportTime = Clock::now();
+    _impl->metricFlushTime = _impl->reportTime;
+    _impl->microtasksTime = _impl->reportTime;
+
     while (true) {
+        // Timers fire between tasks, a busy worker delays them at most by the task it runs.
+        FireTimers(_impl->isolate, _impl->timers, _impl->busyTime, _impl->busySince);
+        RunEventLoop(_impl->isolate, _impl->eventLoop.get());
+
         std::shared_ptr<Task> task;
+        bool immediate = false;
 
         {
             // Logically one merged task queue is the concatenation of immediate queue and
@@ -144,12 +300,67 @@ void Worker::WorkerThreadFunc(const settings::ZoneSettings& settings) {
             // Inside each single queue (immediate or normal), tasks are first in first out.
             std::unique_lock<std::mutex> lock(_impl->queueLock);
             if (_impl->tasks.empty() && _impl->immediateTasks.empty()) {
+                // Timers fired while waiting count as busy, the rest of the wait as idle.
+                auto idleStart = Clock::now();
+                auto busyTime = _impl->busyTime.load(std::memory_order_relaxed);
+
+                // The callback may schedule tasks on this or other workers, so it must not run under the queue lock.
+                lock.unlock();
+                RunMicrotasks(settings, true);
+                FlushMetricBuffer(true);
+                ReportMetrics(settings);
+                CheckRecycleLimits(settings);
                 _impl->idleNotificationCallback(_impl->id);
 
-                // Wait until new tasks come.
-                _impl->hasTaskEvent.wait(
-                    lock, 
-                    [this]() { return !(_impl->tasks.empty() && _impl->immediateTasks.empty()); });
+                // Spinning and yielding avoid the wake up latency of parking when tasks come soon.
+                WaitBeforeParking(settings);
+                CollectGarbageBeforeParking(settings);
+                lock.lock();
+
+                // Wait until new tasks come, firing the timers that get due meanwhile.
+                auto hasTask = [this]() { return !(_impl->tasks.empty() && _impl->immediateTasks.empty()); };
+                while (!hasTask()) {
+                    WorkerTimers::Clock::time_point due;
+                    auto hasDue = _impl->timers.GetNextDue(due);
+
+                    if (hasDue && due <= WorkerTimers::Clock::now()) {
+                        lock.unlock();
+                        FireTimers(_impl->isolate, _impl->timers, _impl->busyTime, _impl->busySince);
+                        RunMicrotasks(settings, true);
+                        lock.lock();
+                        continue;
+                    }
+
+                    if (_impl->eventLoop != nullptr) {
+                        // Park in the event loop, which runs I/O callbacks until a task is enqueued or a timer is due.
+                        auto timeout = hasDue ?
+                            std::chrono::duration_cast<std::chrono::milliseconds>(due - WorkerTimers::Clock::now()) +
+                                std::chrono::milliseconds(1) :
+                            std::chrono::milliseconds(-1);
+                        _impl->parked = true;
+                        lock.unlock();
+                        _impl->isolate->CancelTerminateExecution();
+                        _impl->eventLoop->Wait(timeout);
+                        RunMicrotasks(settings, true);
+                        lock.lock();
+                        _impl->parked = false;
+                        continue;
+                    }
+
+                    if (!hasDue) {
+                        _impl->parked = true;
+                        _impl->hasTaskEvent.wait(lock, hasTask);
+                        _impl->parked = false;
+                        break;
+                    }
+
+                    _impl->parked = true;
+                    _impl->hasTaskEvent.wait_until(lock, due, hasTask);
+                    _impl->parked = false;
+                }
+
+                auto timersTime = _impl->busyTime.load(std::memory_order_relaxed) - busyTime;
+                _impl->idleTime.fetch_add(elapsedSince(idleStart) - timersTime, std::memory_order_relaxed);
             }
 
             if (_impl->immediateTasks.empty()) {
@@ -159,7 +370,9 @@ void Worker::WorkerThreadFunc(const settings::ZoneSettings& settings) {
             else {
                 task = _impl->immediateTasks.front();
                 _impl->immediateTasks.pop();
+                immediate = true;
             }
+            _impl->queuedTasks--;
         }
 
         // A null task means that the worker needs to shutdown.
@@ -171,31 +384,309 @@ void Worker::WorkerThreadFunc(const settings::ZoneSettings& settings) {
         // Resume execution capabilities if isolate was previously terminated.
         _impl->isolate->CancelTerminateExecution();
 
-        task->Execute();
+        // Near its heap limit, the worker rejects the calls it got until its replacement takes over. Tasks that
+        // can't be rejected, like async completions, broadcasts and timers, still run, so pinned work drains and
+        // releases the worker, which can then be replaced.
+        if (_impl->heapLimitReached && !immediate && task->CanReject()) {
+            task->Reject(NAPA_RESULT_HEAP_LIMIT_REACHED, "The worker is near its heap limit");
+            continue;
+        }
+
+        auto taskStart = Clock::now();
+        _impl->busySince.store(std::chrono::duration_cast<std::chrono::nanoseconds>(taskStart.time_since_epoch()).count(), std::memory_order_relaxed);
+        NAPA_TRACEPOINT3(task__start, "zone", settings.id.c_str(), "worker", _impl->id, "tenant", task->GetTenant());
+        {
+            TraceScope traceScope("worker", "Task", "worker", _impl->id);
+            TenantContexts::Scope tenantScope(task->GetTenant());
+            task->Execute();
+        }
+        _impl->busySince.store(0, std::memory_order_relaxed);
+        auto taskTime = elapsedSince(taskStart);
+        _impl->busyTime.fetch_add(taskTime, std::memory_order_relaxed);
+        NAPA_TRACEPOINT3(task__end, "zone", settings.id.c_str(), "worker", _impl->id, "ns", taskTime);
+        _impl->ranTasks = true;
+        _impl->executedTasks++;
+        _impl->tasksSinceMicrotasks++;
+
+        RunMicrotasks(settings, false);
+        FlushMetricBuffer(false);
+        ReportMetrics(settings);
+    }
+
+    FlushMetricBuffer(true);
+    providers::MetricBuffer::SetCurrent(nullptr);
+
+    // Handles left open by native modules are closed before the isolate is disposed.
+    std::unique_ptr<WorkerEventLoop> eventLoop;
+    {
+        std::lock_guard<std::mutex> lock(_impl->queueLock);
+        eventLoop = std::move(_impl->eventLoop);
+    }
+    eventLoop.reset();
+
+    // A worker retired or shut down while profiling drops its profile.
+    DisposeCpuProfiler();
+
+    WorkerTimers::SetCurrent(nullptr);
+    v8_extensions::ArrayBufferAllocator::SetCurrent(false);
+}
+
+bool Worker::Unschedule(const std::shared_ptr<Task>& task) {
+    std::lock_guard<std::mutex> lock(_impl->queueLock);
+
+    // The queue is rebuilt without the task, it's rare and the queue of a busy worker is short.
+    auto removed = false;
+    std::queue<std::shared_ptr<Task>> tasks;
+    while (!_impl->tasks.empty()) {
+        if (!removed && _impl->tasks.front() == task) {
+            removed = true;
+        } else {
+            tasks.emplace(std::move(_impl->tasks.front()));
+        }
+        _impl->tasks.pop();
+    }
+    _impl->tasks = std::move(tasks);
+
+    if (removed) {
+        _impl->queuedTasks--;
     }
+    return removed;
 }
 
-static v8::Isolate* CreateIsolate(const settings::ZoneSettings& settings) {
-    v8::Isolate::CreateParams createParams;
+std::chrono::milliseconds Worker::GetBusyDuration() const {
+    auto busySince = _impl->busySince.load(std::memory_order_relaxed);
+    if (busySince == 0) {
+        return std::chrono::milliseconds(0);
+    }
+    auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(std::max<int64_t>(now - busySince, 0)));
+}
 
-    // The allocator is a global V8 setting.
-#if V8_VERSION_CHECK_FOR_ARRAY_BUFFER_ALLOCATOR
-    static std::unique_ptr<v8::ArrayBuffer::Allocator> defaultArrayBufferAllocator(v8::ArrayBuffer::Allocator::NewDefaultAllocator());
-    createParams.array_buffer_allocator = defaultArrayBufferAllocator.get();
-#else
-    static napa::v8_extensions::ArrayBufferAllocator commonAllocator;
-    createParams.array_buffer_allocator = &commonAllocator;
-#endif
+void Worker::TerminateExecution() {
+    // The isolate is created by the worker thread, a worker that is still starting has nothing to terminate.
+    std::lock_guard<std::mutex> lock(_impl->queueLock);
+    if (_impl->isolate != nullptr) {
+        _impl->isolate->TerminateExecution();
+    }
+}
+
+bool Worker::NeedsRecycling() const {
+    return _impl->recycleDue;
+}
+
+bool Worker::IsSheddingLoad() const {
+    return _impl->heapLimitReached;
+}
+
+WorkerStats Worker::GetStats() const {
+    WorkerStats stats;
+    stats.worker_id = _impl->id;
+    stats.busy_time = _impl->busyTime;
+    stats.idle_time = _impl->idleTime;
+    stats.executed_tasks = _impl->executedTasks;
+
+    std::lock_guard<std::mutex> lock(_impl->queueLock);
+    stats.queued_tasks = _impl->tasks.size();
+    stats.queued_immediate_tasks = _impl->immediateTasks.size();
+    return stats;
+}
 
-    // Set the maximum V8 heap size.
-    createParams.constraints.set_max_old_space_size(settings.maxOldSpaceSize);
-    createParams.constraints.set_max_semi_space_size(settings.maxSemiSpaceSize);
-    createParams.constraints.set_max_executable_size(settings.maxExecutableSize);
+void Worker::FlushMetricBuffer(bool force) {
+    constexpr auto METRIC_FLUSH_INTERVAL = std::chrono::milliseconds(100);
 
-    return v8::Isolate::New(createParams);
+    auto now = std::chrono::steady_clock::now();
+    if (!force && now - _impl->metricFlushTime < METRIC_FLUSH_INTERVAL) {
+        return;
+    }
+    _impl->metricFlushTime = now;
+    _impl->metricBuffer.Flush();
+}
+
+void Worker::ReportMetrics(const settings::ZoneSettings& settings) {
+    constexpr auto METRIC_REPORT_INTERVAL = std::chrono::seconds(1);
+
+    auto now = std::chrono::steady_clock::now();
+    if (now - _impl->reportTime < METRIC_REPORT_INTERVAL) {
+        return;
+    }
+    _impl->reportTime = now;
+
+    static const char* dimensionNames[] = { "Zone", "Worker" };
+    static auto busyTimeMetric = providers::GetMetricProvider().GetMetric(
+        "Napa", "WorkerBusyTime", providers::MetricType::Rate, 2, dimensionNames);
+    static auto idleTimeMetric = providers::GetMetricProvider().GetMetric(
+        "Napa", "WorkerIdleTime", providers::MetricType::Rate, 2, dimensionNames);
+    static auto tasksMetric = providers::GetMetricProvider().GetMetric(
+        "Napa", "WorkerTasks", providers::MetricType::Rate, 2, dimensionNames);
+    static auto queueLengthMetric = providers::GetMetricProvider().GetMetric(
+        "Napa", "WorkerQueueLength", providers::MetricType::Number, 2, dimensionNames);
+
+    auto stats = GetStats();
+    auto workerId = std::to_string(_impl->id);
+    const char* dimensionValues[] = { settings.id.c_str(), workerId.c_str() };
+
+    // Times are reported in milliseconds, the remainder is carried to the next report.
+    constexpr uint64_t NANOSECONDS_PER_MILLISECOND = 1000 * 1000;
+    auto busyTime = (stats.busy_time - _impl->reportedBusyTime) / NANOSECONDS_PER_MILLISECOND;
+    auto idleTime = (stats.idle_time - _impl->reportedIdleTime) / NANOSECONDS_PER_MILLISECOND;
+    _impl->reportedBusyTime += busyTime * NANOSECONDS_PER_MILLISECOND;
+    _impl->reportedIdleTime += idleTime * NANOSECONDS_PER_MILLISECOND;
+
+    if (busyTimeMetric != nullptr && busyTime > 0) {
+        busyTimeMetric->Increment(busyTime, 2, dimensionValues);
+    }
+    if (idleTimeMetric != nullptr && idleTime > 0) {
+        idleTimeMetric->Increment(idleTime, 2, dimensionValues);
+    }
+    if (tasksMetric != nullptr && stats.executed_tasks > _impl->reportedTasks) {
+        tasksMetric->Increment(stats.executed_tasks - _impl->reportedTasks, 2, dimensionValues);
+    }
+    if (queueLengthMetric != nullptr) {
+        queueLengthMetric->Set(static_cast<int64_t>(stats.queued_tasks + stats.queued_immediate_tasks), 2, dimensionValues);
+    }
+    _impl->reportedTasks = stats.executed_tasks;
+}
+
+void Worker::CheckRecycleLimits(const settings::ZoneSettings& settings) {
+    if (_impl->recycleDue) {
+        return;
+    }
+
+    if (settings.maxTasksPerWorker > 0 && _impl->executedTasks >= settings.maxTasksPerWorker) {
+        NAPA_DEBUG("Worker", "(id=%u) Ran %llu tasks, it needs recycling.", _impl->id, static_cast<unsigned long long>(_impl->executedTasks));
+        _impl->recycleDue = true;
+        return;
+    }
+
+    if (settings.maxHeapBeforeRecycle > 0) {
+        v8::HeapStatistics statistics;
+        _impl->isolate->GetHeapStatistics(&statistics);
+
+        if (statistics.used_heap_size() >= static_cast<size_t>(settings.maxHeapBeforeRecycle) * 1024 * 1024) {
+            NAPA_DEBUG("Worker", "(id=%u) Used heap of %zu bytes, it needs recycling.", _impl->id, statistics.used_heap_size());
+            _impl->recycleDue = true;
+        }
+    }
+}
+
+void Worker::WaitBeforeParking(const settings::ZoneSettings& settings) {
+    using Clock = std::chrono::steady_clock;
+
+    // In low latency mode the worker never parks, it keeps spinning until a task comes.
+    if (settings.lowLatency) {
+        while (_impl->queuedTasks == 0 && !_impl->timers.HasDue()) {
+            // The event loop is polled instead, so its callbacks don't wait for the next task.
+            if (_impl->eventLoop != nullptr) {
+                RunEventLoop(_impl->isolate, _impl->eventLoop.get());
+            }
+            else {
+                platform::CpuRelax();
+            }
+        }
+        return;
+    }
+
+    auto spinEnd = Clock::now() + std::chrono::microseconds(settings.idleSpinTime);
+    while (_impl->queuedTasks == 0 && !_impl->timers.HasDue() && Clock::now() < spinEnd) {
+        platform::CpuRelax();
+    }
+
+    auto yieldEnd = Clock::now() + std::chrono::microseconds(settings.idleYieldTime);
+    while (_impl->queuedTasks == 0 && !_impl->timers.HasDue() && Clock::now() < yieldEnd) {
+        std::this_thread::yield();
+    }
+}
+
+void Worker::RunMicrotasks(const settings::ZoneSettings& settings, bool force) {
+    if (settings.microtaskPolicy != settings::MicrotaskPolicy::Batched) {
+        return;
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    if (!force
+        && _impl->tasksSinceMicrotasks < settings.microtaskBatchSize
+        && start - _impl->microtasksTime < std::chrono::microseconds(settings.microtaskTimeSlice)) {
+        return;
+    }
+
+    // Microtasks count as busy time, like the tasks that queued them.
+    _impl->busySince.store(std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count(), std::memory_order_relaxed);
+    {
+        TraceScope traceScope("worker", "Microtasks", "worker", _impl->id);
+
+        // Resume execution capabilities if isolate was previously terminated.
+        _impl->isolate->CancelTerminateExecution();
+    #if V8_VERSION_CHECK_FOR_MICROTASK_CHECKPOINT
+        _impl->isolate->PerformMicrotaskCheckpoint();
+    #else
+        _impl->isolate->RunMicrotasks();
+    #endif
+    }
+    _impl->busySince.store(0, std::memory_order_relaxed);
+
+    auto end = Clock::now();
+    _impl->busyTime.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()), std::memory_order_relaxed);
+    _impl->tasksSinceMicrotasks = 0;
+    _impl->microtasksTime = end;
+}
+
+void Worker::CollectGarbageBeforeParking(const settings::ZoneSettings& settings) {
+    using Clock = std::chrono::steady_clock;
+
+    if (settings.idleGcTime == 0 || !_impl->ranTasks) {
+        return;
+    }
+    _impl->ranTasks = false;
+
+    // Idle time is given in slices, so a task that comes meanwhile waits one slice at most.
+    constexpr auto IDLE_GC_SLICE = std::chrono::milliseconds(1);
+
+    auto end = Clock::now() + std::chrono::milliseconds(settings.idleGcTime);
+    while (_impl->queuedTasks == 0 && !_impl->timers.HasDue()) {
+        auto now = Clock::now();
+        if (now >= end) {
+            break;
+        }
+
+        // V8 deadlines are in seconds of the platform's monotonic clock, which the steady clock reads as well.
+        auto sliceEnd = std::min(end, now + IDLE_GC_SLICE);
+        auto deadline = std::chrono::duration<double>(sliceEnd.time_since_epoch()).count();
+        if (_impl->isolate->IdleNotificationDeadline(deadline)) {
+            // V8 has nothing left to collect.
+            break;
+        }
+    }
+}
+
+static void FireTimers(v8::Isolate* isolate, WorkerTimers& timers, std::atomic<uint64_t>& busyTime, std::atomic<int64_t>& busySince) {
+    if (timers.HasDue()) {
+        auto start = std::chrono::steady_clock::now();
+        busySince.store(std::chrono::duration_cast<std::chrono::nanoseconds>(start.time_since_epoch()).count(), std::memory_order_relaxed);
+
+        // Resume execution capabilities if isolate was previously terminated.
+        isolate->CancelTerminateExecution();
+        timers.FireDue();
+        busySince.store(0, std::memory_order_relaxed);
+
+        busyTime.fetch_add(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count()), std::memory_order_relaxed);
+    }
+}
+
+static void RunEventLoop(v8::Isolate* isolate, WorkerEventLoop* eventLoop) {
+    if (eventLoop != nullptr) {
+        // Resume execution capabilities if isolate was previously terminated.
+        isolate->CancelTerminateExecution();
+        eventLoop->RunReady();
+    }
 }
 
 static void ConfigureIsolate(v8::Isolate* isolate, const settings::ZoneSettings& settings) {
+    // Pooled isolates may have served a zone with another policy.
+    isolate->SetMicrotasksPolicy(settings.microtaskPolicy == settings::MicrotaskPolicy::Batched ?
+        v8::MicrotasksPolicy::kExplicit : v8::MicrotasksPolicy::kAuto);
+
     isolate->SetFatalErrorHandler([](const char* location, const char* message) {
         LOG_ERROR("V8", "V8 Fatal error at %s. Error: %s", location, message);
     });
@@ -206,6 +697,14 @@ static void ConfigureIsolate(v8::Isolate* isolate, const settings::ZoneSettings&
         return false;
     });
 
+    // Garbage collections show up in traces as durations on the worker thread.
+    isolate->AddGCPrologueCallback([](v8::Isolate*, v8::GCType, v8::GCCallbackFlags) {
+        TraceRecorder::GetInstance().RecordBegin("v8", "GC");
+    });
+    isolate->AddGCEpilogueCallback([](v8::Isolate*, v8::GCType, v8::GCCallbackFlags) {
+        TraceRecorder::GetInstance().RecordEnd("v8", "GC");
+    });
+
     // V8 takes a pointer to the minimum (x86 stack grows down) allowed stack address
     // so, capture the current top of the stack and calculate minimum allowed
     uint32_t currentStackAddress;
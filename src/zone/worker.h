@@ -7,6 +7,9 @@
 #include "schedule-phase.h"
 #include "settings/settings.h"
 
+#include <napa/types.h>
+
+#include <chrono>
 #include <functional>
 #include <memory>
 
@@ -51,6 +54,28 @@ namespace zone {
         /// <note> Same task instance may run on multiple workers, hence the use of shared_ptr. </node>
         void Schedule(std::shared_ptr<Task> task, SchedulePhase phase=SchedulePhase::DefaultPhase);
 
+        /// <summary> Removes a task from the queue of the worker if it didn't start yet, so it can run elsewhere. </summary>
+        /// <returns> True if the task was queued and is removed. </returns>
+        bool Unschedule(const std::shared_ptr<Task>& task);
+
+        /// <summary> Returns for how long the worker has been running its current task or timers, 0 while it waits for tasks. </summary>
+        std::chrono::milliseconds GetBusyDuration() const;
+
+        /// <summary> Terminates the JavaScript the worker is running, from any thread. </summary>
+        void TerminateExecution();
+
+        /// <summary> Returns true once the worker reached the task count or heap size it is recycled at. </summary>
+        /// <remarks> It is updated before the worker notifies that it is idle. </remarks>
+        bool NeedsRecycling() const;
+
+        /// <summary> Returns true once the heap of the worker got near its limit, the calls it gets are then rejected. </summary>
+        /// <remarks> The worker also needs recycling, it must not be given calls until it's replaced. </remarks>
+        bool IsSheddingLoad() const;
+
+        /// <summary> Returns the utilization counters of the worker and the depth of its queues. </summary>
+        /// <remarks> The idle time of a worker waiting for tasks is counted once it wakes up. </remarks>
+        WorkerStats GetStats() const;
+
     private:
 
         /// <summary> The worker thread logic. </summary>
@@ -58,6 +83,25 @@ namespace zone {
 
         /// <summary> Enqueue a task. </summary>
         void Enqueue(std::shared_ptr<Task> task, SchedulePhase phase);
+
+        /// <summary> Spins and yields according to the idle settings, returns early when a task comes or a timer is due. </summary>
+        void WaitBeforeParking(const settings::ZoneSettings& settings);
+
+        /// <summary> Gives V8 idle time for garbage collection once tasks ran, returns early when a task comes or a timer is due. </summary>
+        void CollectGarbageBeforeParking(const settings::ZoneSettings& settings);
+
+        /// <summary> Checks the number of tasks the worker ran and its heap size against the recycling settings. </summary>
+        void CheckRecycleLimits(const settings::ZoneSettings& settings);
+
+        /// <summary> Reports the counters that changed to the metric provider, at most once a second. </summary>
+        void ReportMetrics(const settings::ZoneSettings& settings);
+
+        /// <summary> Reports the metric updates JavaScript buffered, at most every 100ms unless forced. </summary>
+        void FlushMetricBuffer(bool force);
+
+        /// <summary> Runs the microtasks once a batch of tasks ran or the time slice passed, or when forced. </summary>
+        /// <remarks> Only workers with MicrotaskPolicy::Batched run them, V8 does for the others. </remarks>
+        void RunMicrotasks(const settings::ZoneSettings& settings, bool force);
         
         struct Impl;
         std::unique_ptr<Impl> _impl;
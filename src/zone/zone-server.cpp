@@ -0,0 +1,260 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include "zone-server.h"
+
+#include <zone/remote-protocol.h>
+#include <zone/shared-memory-channel.h>
+
+#include <napa/log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+
+using namespace napa;
+using namespace napa::zone;
+using namespace napa::zone::remote;
+
+/// <summary> A client connection, whose results are queued by the zone workers and written by a thread of its own. </summary>
+struct ZoneServer::Connection {
+    /// <summary>
+    ///     Released by the reader once the connection is closed, which frees its slot of a shared memory segment
+    ///     rather than waiting for the connection to be joined.
+    /// </summary>
+    std::shared_ptr<Channel> channel;
+
+    /// <summary> Guards the results waiting to be written, and whether the connection stopped taking them. </summary>
+    std::mutex queueLock;
+    std::condition_variable queued;
+    std::deque<std::string> results;
+    bool stopping = false;
+
+    /// <summary> Set once the reader is done, for the connection to be joined. </summary>
+    std::atomic<bool> closed { false };
+
+    std::thread reader;
+    std::thread writer;
+};
+
+std::unique_ptr<ZoneServer> ZoneServer::Start(std::shared_ptr<Zone> zone, const std::string& address) {
+    std::string host;
+    uint16_t port;
+    if (!platform::ParseAddress(address, host, port)) {
+        LOG_ERROR("ZoneServer", "Invalid address \"%s\" to serve zone \"%s\" on, expected 'host:port'.", address.c_str(), zone->GetId().c_str());
+        return nullptr;
+    }
+
+    auto listener = std::make_unique<SocketChannelListener>(host, port);
+    if (!listener->IsListening()) {
+        LOG_ERROR("ZoneServer", "Failed to listen on \"%s\" to serve zone \"%s\".", address.c_str(), zone->GetId().c_str());
+        return nullptr;
+    }
+
+    port = listener->GetPort();
+    std::unique_ptr<ZoneServer> server(new ZoneServer(std::move(zone), std::move(listener), port));
+    server->_acceptor = std::thread([server = server.get()]() { server->Accept(); });
+    NAPA_DEBUG("ZoneServer", "Zone \"%s\" served on port %u.", server->_zone->GetId().c_str(), port);
+    return server;
+}
+
+std::unique_ptr<ZoneServer> ZoneServer::StartSharedMemory(std::shared_ptr<Zone> zone, const std::string& name) {
+    auto listener = SharedMemoryChannelListener::Create(name);
+    if (listener == nullptr) {
+        LOG_ERROR("ZoneServer", "Failed to serve zone \"%s\" on shared memory \"%s\".", zone->GetId().c_str(), name.c_str());
+        return nullptr;
+    }
+
+    std::unique_ptr<ZoneServer> server(new ZoneServer(std::move(zone), std::move(listener), 0));
+    server->_acceptor = std::thread([server = server.get()]() { server->Accept(); });
+    NAPA_DEBUG("ZoneServer", "Zone \"%s\" served on shared memory \"%s\".", server->_zone->GetId().c_str(), name.c_str());
+    return server;
+}
+
+ZoneServer::ZoneServer(std::shared_ptr<Zone> zone, std::unique_ptr<ChannelListener> listener, uint16_t port) :
+    _zone(std::move(zone)),
+    _listener(std::move(listener)),
+    _port(port) {
+}
+
+ZoneServer::~ZoneServer() {
+    _listener->Shutdown();
+    if (_acceptor.joinable()) {
+        _acceptor.join();
+    }
+
+    // The acceptor is done, the connections don't change anymore.
+    for (auto& connection : _connections) {
+        auto channel = std::atomic_load(&connection->channel);
+        if (channel != nullptr) {
+            channel->Shutdown();
+        }
+    }
+    for (auto& connection : _connections) {
+        connection->reader.join();
+    }
+}
+
+uint16_t ZoneServer::GetPort() const {
+    return _port;
+}
+
+void ZoneServer::Accept() {
+    for (;;) {
+        auto channel = _listener->Accept();
+        if (channel == nullptr) {
+            return;
+        }
+
+        auto connection = std::make_shared<Connection>();
+        connection->channel = std::move(channel);
+
+        std::lock_guard<std::mutex> lock(_lock);
+
+        // Connections closed by their clients are joined as new ones come in.
+        auto closed = std::remove_if(_connections.begin(), _connections.end(), [](const std::shared_ptr<Connection>& existing) {
+            if (existing->closed) {
+                existing->reader.join();
+                return true;
+            }
+            return false;
+        });
+        _connections.erase(closed, _connections.end());
+
+        connection->reader = std::thread([this, connection]() { Read(connection); });
+        _connections.push_back(std::move(connection));
+    }
+}
+
+void ZoneServer::Read(std::shared_ptr<Connection> connection) {
+    auto channel = std::atomic_load(&connection->channel);
+    MessageWriter hello(MessageType::Hello, 0);
+    hello.WriteHello({ PROTOCOL_VERSION, _zone->GetWorkerCount(), _zone->GetId() });
+    auto& message = hello.Finish();
+    bool greeted = channel->Write(message.data(), message.size());
+
+    // Workers only queue results, a slow client must not hold up the zone.
+    connection->writer = std::thread([connection, channel]() { Write(*connection, *channel); });
+
+    MessageHeader header;
+    std::string payload;
+    while (greeted && ReadMessage(*channel, header, payload)) {
+        MessageReader reader(payload.data(), payload.size());
+
+        // The zone copies what it needs of a spec before returning, so specs are decoded on the stack.
+        DecodedSpec decoded;
+        bool valid = true;
+        switch (header.type) {
+            case MessageType::Execute:
+                valid = reader.ReadSpec(decoded) && reader.IsAtEnd();
+                if (valid) {
+                    _zone->Execute(decoded.spec, Reply(connection, header.requestId));
+                }
+                break;
+
+            case MessageType::ExecuteOnWorker: {
+                uint32_t workerId;
+                valid = reader.ReadUInt32(workerId) && reader.ReadSpec(decoded) && reader.IsAtEnd();
+                if (valid) {
+                    _zone->ExecuteOnWorker(workerId, decoded.spec, Reply(connection, header.requestId));
+                }
+                break;
+            }
+
+            case MessageType::Broadcast: {
+                uint32_t count;
+                std::vector<uint32_t> workerIds;
+                valid = reader.ReadUInt32(count) && count <= payload.size() / 4;
+                for (uint32_t i = 0; valid && i < count; i++) {
+                    uint32_t workerId;
+                    valid = reader.ReadUInt32(workerId);
+                    workerIds.push_back(workerId);
+                }
+                valid = valid && reader.ReadSpec(decoded) && reader.IsAtEnd();
+                if (valid) {
+                    _zone->Broadcast(decoded.spec, workerIds, Reply(connection, header.requestId));
+                }
+                break;
+            }
+
+            case MessageType::Cancel: {
+                uint64_t token;
+                valid = reader.ReadUInt64(token) && reader.IsAtEnd();
+                if (valid) {
+                    _zone->Cancel(token);
+                }
+                break;
+            }
+
+            default:
+                valid = false;
+                break;
+        }
+
+        if (!valid) {
+            LOG_ERROR("ZoneServer", "Client of zone \"%s\" sent an invalid message, closing its connection.", _zone->GetId().c_str());
+            break;
+        }
+    }
+
+    // Results of calls still running are dropped, the channel goes once the writer is done.
+    channel->Shutdown();
+    {
+        std::lock_guard<std::mutex> lock(connection->queueLock);
+        connection->stopping = true;
+        connection->results.clear();
+    }
+    connection->queued.notify_one();
+    connection->writer.join();
+
+    std::atomic_store(&connection->channel, std::shared_ptr<Channel>());
+    connection->closed = true;
+}
+
+void ZoneServer::Write(Connection& connection, Channel& channel) {
+    std::unique_lock<std::mutex> lock(connection.queueLock);
+    for (;;) {
+        connection.queued.wait(lock, [&connection]() { return connection.stopping || !connection.results.empty(); });
+        if (connection.stopping) {
+            return;
+        }
+
+        auto message = std::move(connection.results.front());
+        connection.results.pop_front();
+        lock.unlock();
+
+        // A failed write shuts the channel down, which ends the reader and then the writer.
+        if (!channel.Write(message.data(), message.size())) {
+            channel.Shutdown();
+        }
+        lock.lock();
+    }
+}
+
+ExecuteCallback ZoneServer::Reply(std::shared_ptr<Connection> connection, uint64_t requestId) {
+    return [connection = std::move(connection), requestId](Result result) {
+        // Shared objects live in the memory of this process.
+        if (result.code == NAPA_RESULT_SUCCESS
+            && result.transportContext != nullptr
+            && result.transportContext->GetSharedCount() > 0) {
+            result.code = NAPA_RESULT_REMOTE_UNSUPPORTED;
+            result.errorMessage = "Shared objects can't be transported from a remote zone";
+            result.returnValue.clear();
+        }
+
+        MessageWriter writer(MessageType::Result, requestId);
+        writer.WriteResult(result);
+        auto& message = writer.Finish();
+
+        // A client that went away loses its results.
+        {
+            std::lock_guard<std::mutex> lock(connection->queueLock);
+            if (connection->stopping) {
+                return;
+            }
+            connection->results.push_back(std::move(message));
+        }
+        connection->queued.notify_one();
+    };
+}
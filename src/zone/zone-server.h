@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include "zone.h"
+
+#include "remote-channel.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace napa {
+namespace zone {
+
+    /// <summary>
+    ///     Serves a zone to RemoteZone clients of other hosts over TCP, or of other processes of the host over shared memory.
+    ///     Each connection is read by a thread of its own, which hands calls to the zone as they arrive,
+    ///     and written by another, which sends back the results the zone workers queue as calls complete.
+    /// </summary>
+    /// <remarks> Clients are not authenticated, a zone should only be served on a trusted network. </remarks>
+    class ZoneServer {
+    public:
+
+        /// <summary> Starts serving a zone. </summary>
+        /// <param name="zone"> The zone, which the server keeps alive. </param>
+        /// <param name="address"> The address to listen on, like '0.0.0.0:port', or port 0 for a port chosen by the system. </param>
+        /// <returns> The server, or nullptr if the address can't be listened on. </returns>
+        static std::unique_ptr<ZoneServer> Start(std::shared_ptr<Zone> zone, const std::string& address);
+
+        /// <summary> Starts serving a zone to processes of the host on a shared memory segment. </summary>
+        /// <param name="zone"> The zone, which the server keeps alive. </param>
+        /// <param name="name"> The name of the segment, without path separators. </param>
+        /// <returns> The server, or nullptr if the segment can't be created or another running process serves the name. </returns>
+        static std::unique_ptr<ZoneServer> StartSharedMemory(std::shared_ptr<Zone> zone, const std::string& name);
+
+        /// <summary> Stops listening and closes the connections, results of calls still running are dropped. </summary>
+        ~ZoneServer();
+
+        /// <summary> The port the zone is served on, 0 if served on shared memory. </summary>
+        uint16_t GetPort() const;
+
+    private:
+        struct Connection;
+
+        ZoneServer(std::shared_ptr<Zone> zone, std::unique_ptr<remote::ChannelListener> listener, uint16_t port);
+
+        /// <summary> Accepts connections until the listener is shut down. </summary>
+        void Accept();
+
+        /// <summary> Reads calls of a connection until it's closed. </summary>
+        void Read(std::shared_ptr<Connection> connection);
+
+        /// <summary> Writes the results queued for a connection until it's closed. </summary>
+        static void Write(Connection& connection, remote::Channel& channel);
+
+        /// <summary> Returns a callback queuing the result of a request to be written back to the client. </summary>
+        static ExecuteCallback Reply(std::shared_ptr<Connection> connection, uint64_t requestId);
+
+        std::shared_ptr<Zone> _zone;
+        std::unique_ptr<remote::ChannelListener> _listener;
+        uint16_t _port;
+        std::thread _acceptor;
+
+        /// <summary> Guards the connections, which are joined on destruction. </summary>
+        std::mutex _lock;
+        std::vector<std::shared_ptr<Connection>> _connections;
+    };
+}
+}
@@ -14,16 +14,73 @@ namespace zone {
         /// <summary> Get the zone id. </summary>
         virtual const std::string& GetId() const = 0;
 
-        /// <summary> Executes a pre-loaded JS function on all zone workers asynchronously. </summary>
+        /// <summary> Get the number of calls that are waiting for a worker. </summary>
+        virtual size_t GetQueueLength() const = 0;
+
+        /// <summary> Get the number of workers that are running. </summary>
+        virtual uint32_t GetWorkerCount() const = 0;
+
+        /// <summary> Cancels the calls that were made with the given cancellation token. </summary>
+        /// <param name="token"> The cancellation token of the calls. </param>
+        virtual void Cancel(uint64_t token) = 0;
+
+        /// <summary> Executes a pre-loaded JS function on zone workers asynchronously. </summary>
         /// <param name="spec"> The function spec. </param>
+        /// <param name="workerIds"> The ids of the workers to run it, all workers if empty. </param>
         /// <param name="callback"> A callback that is triggered when broadcasting is done. </param>
-        virtual void Broadcast(const FunctionSpec& spec, BroadcastCallback callback) = 0;
+        virtual void Broadcast(const FunctionSpec& spec, const std::vector<uint32_t>& workerIds, BroadcastCallback callback) = 0;
 
         /// <summary> Executes a pre-loaded JS function asynchronously. </summary>
         /// <param name="spec"> The function spec. </param>
         /// <param name="callback"> A callback that is triggered when execution is done. </param>
         virtual void Execute(const FunctionSpec& spec, ExecuteCallback callback) = 0;
 
+        /// <summary> Executes a pre-loaded JS function asynchronously on the given worker, after the calls queued on it. </summary>
+        /// <param name="workerId"> The id of the worker. </param>
+        /// <param name="spec"> The function spec. </param>
+        /// <param name="callback"> A callback that is triggered when execution is done. </param>
+        virtual void ExecuteOnWorker(uint32_t workerId, const FunctionSpec& spec, ExecuteCallback callback) = 0;
+
+        /// <summary> Executes a batch of pre-loaded JS functions asynchronously. </summary>
+        /// <param name="specs"> The function specs. </param>
+        /// <param name="callback"> A callback that is triggered once all executions are done, with results in spec order. </param>
+        virtual void ExecuteBatch(const std::vector<FunctionSpec>& specs, ExecuteBatchCallback callback) = 0;
+
+        /// <summary> Runs a native function on a zone worker asynchronously, next to JS calls and without entering V8. </summary>
+        /// <param name="function"> The native function. </param>
+        /// <param name="callback"> A callback that is triggered once the function ran, or was dropped. </param>
+        virtual void ExecuteNative(NativeFunction function, NativeCallback callback) = 0;
+
+        /// <summary> Collects the heap statistics of the running zone workers asynchronously. </summary>
+        /// <param name="callback"> A callback that is triggered with the statistics of each worker once all reported. </param>
+        virtual void GetHeapStatistics(HeapStatisticsCallback callback) = 0;
+
+        /// <summary> Reads the utilization counters of the zone and its running workers. </summary>
+        virtual ZoneStats GetStats() const = 0;
+
+        /// <summary> Reads the statistics of the calls of each function that ran in the zone. </summary>
+        virtual std::vector<FunctionStats> GetFunctionStats() const = 0;
+
+        /// <summary> Notifies the running zone workers of memory pressure, ahead of their queued calls. </summary>
+        /// <param name="level"> The memory pressure level. </param>
+        virtual void NotifyMemoryPressure(MemoryPressureLevel level) = 0;
+
+        /// <summary> Starts sampling the CPU profile of zone workers, ahead of their queued calls. </summary>
+        /// <param name="workerIds"> The ids of the workers to profile, all running workers if empty. </param>
+        /// <param name="samplingInterval"> The sampling interval in microseconds, 0 for the V8 default. </param>
+        virtual void StartProfiling(const std::vector<uint32_t>& workerIds, uint32_t samplingInterval) = 0;
+
+        /// <summary> Stops the CPU profiling of all zone workers asynchronously. </summary>
+        /// <param name="callback"> A callback that is triggered with the profiles of the workers that were profiling. </param>
+        virtual void StopProfiling(CpuProfilesCallback callback) = 0;
+
+        /// <summary>
+        ///     Runs the calls queued on the zone, then disposes its workers and frees its id for a new zone,
+        ///     without waiting for the last reference on the zone to go away. Later calls fail with NAPA_RESULT_ZONE_RECYCLED.
+        /// </summary>
+        /// <returns> NAPA_RESULT_ZONE_RECYCLE_ERROR if called from a worker of the zone, which would wait for itself. </returns>
+        virtual ResultCode Recycle() = 0;
+
         /// <summary> Virtual destructor. </summary>
         virtual ~Zone() {}
     };
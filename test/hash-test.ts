@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+import * as napa from "../lib/index";
+import * as assert from 'assert';
+
+describe('napajs/hash', function() {
+    let napaZone = napa.zone.create('hash-zone');
+
+    it('#xxhash64', () => {
+        assert.strictEqual(napa.hash.xxhash64(''), 'ef46db3751d8e999');
+        assert.strictEqual(napa.hash.xxhash64('abc'), '44bc2cf5ad770999');
+        assert.strictEqual(napa.hash.xxhash64(new Uint8Array([97, 98, 99])), '44bc2cf5ad770999');
+        assert.notStrictEqual(napa.hash.xxhash64('abc', 1), napa.hash.xxhash64('abc'));
+    });
+
+    it('#crc32c', () => {
+        assert.strictEqual(napa.hash.crc32c('123456789'), 0xE3069283);
+        assert.strictEqual(napa.hash.crc32c(new ArrayBuffer(32)), 0x8A9136AA);
+
+        let crc = napa.hash.crc32c('1234');
+        assert.strictEqual(napa.hash.crc32c('56789', crc), 0xE3069283);
+    });
+
+    it('#sha256', () => {
+        assert.strictEqual(napa.hash.sha256('abc'), 'ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad');
+
+        let bytes = new Uint8Array(new SharedArrayBuffer(8));
+        bytes.set([0, 97, 98, 99], 2);
+        assert.strictEqual(napa.hash.sha256(bytes.subarray(3, 6)), napa.hash.sha256('abc'));
+    });
+
+    it('@napa: hashes match node', () => {
+        return napaZone.execute(() => {
+            var napa = require('../lib/index');
+            return [napa.hash.xxhash64('napa'), napa.hash.crc32c('napa'), napa.hash.sha256('napa')];
+        }).then((result) => {
+            assert.deepEqual(result.value, [napa.hash.xxhash64('napa'), napa.hash.crc32c('napa'), napa.hash.sha256('napa')]);
+        });
+    });
+
+    it('#input types', () => {
+        assert.throws(() => { napa.hash.xxhash64(<any>1); });
+        assert.throws(() => { napa.hash.sha256(<any>{}); });
+    });
+});
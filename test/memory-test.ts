@@ -45,6 +45,121 @@ describe('napajs/memory', function() {
             napaZone.execute('./napa-zone/test', "defaultAllocatorTest");
         });
 
+        it('@node: profileAllocator', () => {
+            let allocator = napa.memory.profileAllocator(napa.memory.defaultAllocator, 1);
+            let handle = allocator.allocate(10);
+            assert(!napa.memory.isEmpty(handle));
+            let debugInfo = JSON.parse(allocator.getDebugInfo());
+            assert.strictEqual(debugInfo.liveSize, 10);
+            assert.strictEqual(debugInfo.samples.length, 1);
+            allocator.deallocate(handle, 0);
+
+            debugInfo = JSON.parse(allocator.getDebugInfo());
+            assert.strictEqual(debugInfo.deallocatedSize, 10);
+            assert.strictEqual(debugInfo.liveSize, 0);
+            assert.strictEqual(debugInfo.peakLiveSize, 10);
+        });
+
+        it('@node: poolAllocator', () => {
+            let handle = napa.memory.poolAllocator.allocate(10);
+            assert(!napa.memory.isEmpty(handle));
+            assert.strictEqual(napa.memory.poolAllocator.type, 'PoolAllocator');
+            napa.memory.poolAllocator.deallocate(handle, 10);
+        });
+
+        it('@napa: poolAllocator', () => {
+            napaZone.execute('./napa-zone/test', "poolAllocatorTest");
+        });
+
+        it('@node: allocateBuffer', () => {
+            let allocator = napa.memory.debugAllocator(napa.memory.defaultAllocator);
+            let buffer = allocator.allocateBuffer(32);
+            assert.strictEqual(buffer.byteLength, 32);
+            new Uint32Array(buffer).fill(0xFFFFFFFF);
+            assert.strictEqual(new Uint8Array(buffer)[31], 0xFF);
+            assert.strictEqual(JSON.parse(allocator.getDebugInfo()).allocatedSize, 32);
+            assert.strictEqual(napa.memory.defaultAllocator.allocateBuffer(0).byteLength, 0);
+        });
+
+        it('@napa: allocateBuffer', () => {
+            napaZone.execute('./napa-zone/test', "allocateBufferTest");
+        });
+
+        it('@node: createArena', () => {
+            let arena = napa.memory.createArena(1024);
+            assert.strictEqual(arena.type, 'ArenaAllocator');
+            let small = arena.allocateBuffer(100);
+            let large = arena.allocateBuffer(4096);
+            assert.strictEqual(small.byteLength, 100);
+            assert.strictEqual(large.byteLength, 4096);
+            assert(arena.allocatedSize >= 4196);
+
+            arena.reset();
+            assert.strictEqual(arena.allocatedSize, 0);
+            assert.throws(() => napa.memory.createArena(0));
+        });
+
+        it('@napa: createArena', () => {
+            napaZone.execute('./napa-zone/test', "arenaTest");
+        });
+
+        it('@node: createSharedMap', () => {
+            let map = napa.memory.createSharedMap();
+            map.set('number', 1.5);
+            map.set('string', 'hello');
+            map.set('boolean', false);
+            map.set('buffer', new Uint8Array([1, 2]).buffer);
+            assert.strictEqual(map.size, 4);
+            assert.strictEqual(map.get('number'), 1.5);
+            assert.strictEqual(map.get('string'), 'hello');
+            assert.strictEqual(map.get('boolean'), false);
+            assert.deepEqual(Array.from(new Uint8Array(<ArrayBuffer>map.get('buffer'))), [1, 2]);
+            assert.strictEqual(map.get('missing'), undefined);
+
+            assert.strictEqual(map.add('counter', 2), 2);
+            assert.throws(() => map.add('string', 1));
+            assert.throws(() => map.set('object', <any>{}));
+
+            assert(map.delete('number'));
+            assert(!map.has('number'));
+            assert.deepEqual(map.keys().sort(), ['boolean', 'buffer', 'counter', 'string']);
+            map.clear();
+            assert.strictEqual(map.size, 0);
+        });
+
+        it('@napa: createSharedMap', () => {
+            let map = napa.memory.createSharedMap();
+            map.set('name', 'napa');
+            map.set('counter', 1);
+            return napaZone.execute('./napa-zone/test', "sharedMapTest", [map]).then((result) => {
+                assert.strictEqual(result.value, 2);
+                assert.strictEqual(map.get('flag'), true);
+                assert.deepEqual(Array.from(new Uint8Array(<ArrayBuffer>map.get('buffer'))), [1, 2, 3]);
+            });
+        });
+
+        it('@napa: arrayBufferPoolStats', () => {
+            return napaZone.execute('./napa-zone/test', "arrayBufferPoolTest");
+        });
+
+        it('@node: sharedBufferPool', () => {
+            let before = napa.memory.sharedBufferPool.getStats();
+            let buffer = napa.memory.sharedBufferPool.allocate(64 * 1024);
+            assert(buffer instanceof SharedArrayBuffer);
+            assert.strictEqual(buffer.byteLength, 64 * 1024);
+            assert.strictEqual(new Uint8Array(buffer)[64 * 1024 - 1], 0);
+            assert(napa.memory.sharedBufferPool.getStats().liveSize >= before.liveSize + 64 * 1024);
+        });
+
+        it('@napa: sharedBufferPool', () => {
+            let buffer = napa.memory.sharedBufferPool.allocate(64 * 1024);
+            new Uint8Array(buffer)[0] = 42;
+            return napaZone.execute('./napa-zone/test', "sharedBufferPoolTest", [buffer]).then((result) => {
+                assert.strictEqual(result.value, 42);
+                assert.strictEqual(new Uint8Array(buffer)[1], 1);
+            });
+        });
+
         it('@node: debugAllocator', () => {
             let allocator = napa.memory.debugAllocator(napa.memory.defaultAllocator);
             let handle = allocator.allocate(10);
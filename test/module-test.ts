@@ -68,6 +68,48 @@ describe('napajs/module', function () {
             }, [__dirname]);
         });
 
+        it('exported native functions', () => {
+            return napaZone.execute(() => {
+                var assert = require("assert");
+                var napaModule = require('../bin/simple-addon.napa');
+
+                assert.equal(napaModule.add(1, 2.5), 3.5);
+                assert.equal(napaModule.negate(7), -7);
+                assert.equal(napaModule.repeat("ab", 3), "ababab");
+                assert.equal(napaModule.isFunction(() => {}), true);
+                assert.equal(napaModule.isFunction(1), false);
+
+                assert.throws(() => { napaModule.add(1); }, TypeError);
+                assert.throws(() => { napaModule.add(1, "2"); }, /expects arguments \(number, number\)/);
+                assert.throws(() => { napaModule.repeat(3, 3); }, TypeError);
+            });
+        });
+
+        it('typed array conversions', () => {
+            return napaZone.execute(() => {
+                var assert = require("assert");
+                var napaModule = require('../bin/simple-addon.napa');
+
+                assert.equal(napaModule.sum(new Float64Array([1.5, 2.5, 3])), 7);
+                assert.equal(napaModule.sum(new Int32Array([1, 2, 3])), 6);
+                assert.equal(napaModule.sum([1, 2.5, 3]), 6.5);
+                assert.equal(napaModule.sum(new Float64Array(new ArrayBuffer(32), 8, 2)), 0);
+                assert(isNaN(napaModule.sum([1, "2"])));
+
+                var numbers = new Float64Array([1, 2, 3]);
+                napaModule.scale(numbers, 2);
+                assert.deepEqual(Array.from(numbers), [2, 4, 6]);
+
+                var squares = napaModule.squares([1, 2, 3]);
+                assert(squares instanceof Int32Array);
+                assert.deepEqual(Array.from(squares), [1, 4, 9]);
+
+                // Counters are a view of native memory, writes are seen by views created later.
+                napaModule.getCounters()[1] = 5;
+                assert.equal(napaModule.getCounters()[1], 5);
+            });
+        });
+
         it('circular dependencies', () => {
             return napaZone.execute(() => {
                 var assert = require("assert");
@@ -92,6 +134,35 @@ describe('napajs/module', function () {
         });
     });
 
+    describe('shared module context', function () {
+        let sharedContextZone = napa.zone.create('module-tests-shared-context-zone', { workers: 1, sharedModuleContext: true });
+
+        it('javascript module', () => {
+            return sharedContextZone.execute(() => {
+                var assert = require("assert");
+                var jsmodule = require('./module/jsmodule');
+
+                assert.notEqual(jsmodule, undefined);
+                assert.equal(jsmodule.wasLoaded, true);
+            });
+        });
+
+        it('javascript module with cycle', () => {
+            return sharedContextZone.execute(() => {
+                var assert = require("assert");
+                var cycle_a = require('./module/cycle-a.js');
+                var cycle_b = require('./module/cycle-b.js');
+
+                assert(cycle_a.done);
+                assert(cycle_b.done);
+            });
+        });
+
+        it('require.resolve', () => {
+            return sharedContextZone.execute("./module/resolution-tests.js", "run");
+        });
+    });
+
     describe('resolve', function () {
         // TODO: support correct __dirname in anonymous function and move tests from 'resolution-tests.js' here.
         it('require.resolve', () => {
@@ -168,6 +239,40 @@ describe('napajs/module', function () {
                     assert(!isNaN(process.pid));
                 });
             });
+
+            it('cpuUsage', () => {
+                return napaZone.execute(() => {
+                    var assert = require("assert");
+
+                    var start = process.cpuUsage();
+                    var end = Date.now() + 20;
+                    while (Date.now() < end) {}
+                    var usage = process.cpuUsage(start);
+                    assert(usage.user + usage.system > 0);
+                    assert(usage.user + usage.system < 1000000);
+                });
+            });
+
+            it('memoryUsage', () => {
+                return napaZone.execute(() => {
+                    var assert = require("assert");
+
+                    var usage = process.memoryUsage();
+                    assert(usage.heapUsed > 0);
+                    assert(usage.heapTotal >= usage.heapUsed);
+                    assert(usage.rss >= usage.heapTotal);
+                });
+            });
+
+            it('hrtime.bigint', () => {
+                return napaZone.execute(() => {
+                    var assert = require("assert");
+
+                    var start = (<any>process.hrtime).bigint();
+                    assert.equal(typeof start, 'bigint');
+                    assert((<any>process.hrtime).bigint() >= start);
+                });
+            });
         });
 
         describe('fs', function () {
@@ -245,6 +350,94 @@ describe('napajs/module', function () {
                     }
                 })
             });
+
+            it('statSync', () => {
+                return napaZone.execute(() => {
+                    var assert = require("assert");
+                    var fs = require('fs');
+
+                    var stats = fs.statSync(__dirname + '/module/test.json');
+                    assert(stats.isFile());
+                    assert(!stats.isDirectory());
+                    assert(stats.size > 0);
+
+                    assert(fs.statSync(__dirname + '/module').isDirectory());
+                    assert.throws(() => fs.statSync(__dirname + '/non-existing-file.txt'));
+                });
+            });
+
+            it('mapFile', () => {
+                return napaZone.execute(() => {
+                    var assert = require("assert");
+                    var fs = require('fs');
+
+                    var buffer = fs.mapFile(__dirname + '/module/test.json');
+                    assert(buffer instanceof ArrayBuffer);
+
+                    var content = String.fromCharCode.apply(null, new Uint8Array(buffer));
+                    assert.equal(content, fs.readFileSync(__dirname + '/module/test.json'));
+                    assert.throws(() => fs.mapFile(__dirname + '/non-existing-file.txt'));
+                });
+            });
+
+            it('readFile', () => {
+                return napaZone.execute(() => {
+                    var fs = require('fs');
+
+                    return new Promise((resolve, reject) => {
+                        fs.readFile(__dirname + '/module/test.json', (err: any, data: string) => {
+                            err ? reject(err) : resolve(JSON.parse(data).prop1);
+                        });
+                    });
+                }).then((result: napa.zone.Result) => {
+                    assert.equal(result.value, 'val1');
+                });
+            });
+
+            it('readFile with a non-existing file', () => {
+                return napaZone.execute(() => {
+                    var fs = require('fs');
+
+                    return new Promise((resolve) => {
+                        fs.readFile(__dirname + '/non-existing-file.txt', (err: any) => {
+                            resolve(err instanceof Error);
+                        });
+                    });
+                }).then((result: napa.zone.Result) => {
+                    assert.equal(result.value, true);
+                });
+            });
+
+            it('writeFile, stat and readdir', () => {
+                return napaZone.execute(() => {
+                    var fs = require('fs');
+
+                    var testDir = __dirname + '/module/test-async-dir';
+                    return new Promise((resolve, reject) => {
+                        fs.mkdir(testDir, (err: any) => {
+                            if (err) { return reject(err); }
+                            fs.writeFile(testDir + '/1', 'test', (err: any) => {
+                                if (err) { return reject(err); }
+                                fs.stat(testDir + '/1', (err: any, stats: any) => {
+                                    if (err) { return reject(err); }
+                                    fs.readdir(testDir, (err: any, names: string[]) => {
+                                        err ? reject(err) : resolve([stats.isFile(), stats.size, names]);
+                                    });
+                                });
+                            });
+                        });
+                    });
+                }).then((result: napa.zone.Result) => {
+                    assert.deepEqual(result.value, [true, 4, ['1']]);
+                }).then(() => {
+                    // Cleanup
+                    var fs = require('fs');
+                    if (fs.existsSync('./module/test-async-dir')) {
+                        fs.unlinkSync('./module/test-async-dir/1');
+                        fs.rmdirSync('./module/test-async-dir');
+                    }
+                });
+            });
         });
 
         describe('path', function () {
@@ -414,6 +607,57 @@ describe('napajs/module', function () {
                     assert(os.type() == "Windows_NT" || os.type() == "Darwin" || os.type() == "Linux");
                 });
             });
+
+            it('cpuTopology', () => {
+                return napaZone.execute(() => {
+                    var assert = require("assert");
+                    var os = require("os");
+
+                    var topology = os.cpuTopology();
+                    assert(topology.logicalCpus > 0);
+                    assert(topology.physicalCores > 0 && topology.physicalCores <= topology.logicalCpus);
+                    assert(topology.numaNodes.length > 0);
+                    topology.numaNodes.forEach((node: any) => {
+                        assert(typeof node.id == "number" && node.cpus.length > 0);
+                    });
+                    topology.caches.forEach((cache: any) => {
+                        assert(cache.level > 0 && cache.size >= 0);
+                    });
+                });
+            });
+        });
+
+        describe('napa-numeric', function () {
+            it('kernels', () => {
+                return napaZone.execute(() => {
+                    var assert = require("assert");
+                    var numeric = require("napa-numeric");
+
+                    assert(["scalar", "sse2", "avx2", "neon"].indexOf(numeric.instructionSet) >= 0);
+
+                    var x = new Float64Array([1, 2, 3, 4, 5]);
+                    var y = new Float64Array([1, 1, 1, 1, 1]);
+                    assert.equal(numeric.sum(x), 15);
+                    assert.equal(numeric.sum(x, 1, 3), 5);
+                    assert.equal(numeric.dot(x, y), 15);
+                    assert.equal(numeric.min(x), 1);
+                    assert.equal(numeric.max(x, 0, 2), 2);
+                    assert.equal(numeric.min(x, 2, 2), Infinity);
+
+                    numeric.axpy(2, x, y);
+                    assert.deepEqual(Array.from(y), [3, 5, 7, 9, 11]);
+                    numeric.scale(y, 0.5, 3);
+                    assert.deepEqual(Array.from(y), [3, 5, 7, 4.5, 5.5]);
+
+                    var floats = new Float32Array(new SharedArrayBuffer(16 * 4));
+                    floats.fill(0.5);
+                    assert.equal(numeric.sum(floats), 8);
+
+                    assert.throws(() => { numeric.dot(x, floats); });
+                    assert.throws(() => { numeric.sum(x, 0, 6); });
+                    assert.throws(() => { numeric.sum([1, 2]); });
+                });
+            });
         });
     });
 
@@ -463,5 +707,29 @@ describe('napajs/module', function () {
                 assert.equal(result.value, 9);
             });
         });
+
+        it('complete many parallel async works', () => {
+            return napaZone.execute(() => {
+                var napaModule = require('../bin/simple-addon.napa');
+
+                // Completions that come while others are pending run in the same task on the worker.
+                var promises = [];
+                for (var i = 0; i < 200; i++) {
+                    var obj = napaModule.createSimpleObjectWrap();
+                    obj.setValue(i);
+                    promises.push(new Promise((resolve) => {
+                        obj.postIncrementWork((newValue: number) => {
+                            resolve(newValue);
+                        });
+                    }));
+                }
+                return Promise.all(promises).then((values: number[]) => {
+                    return values.reduce((sum: number, value: number) => sum + value, 0);
+                });
+            }).then((result: napa.zone.Result) => {
+                // The sum of 1 to 200.
+                assert.equal(result.value, 20100);
+            });
+        });
     });
 });
\ No newline at end of file
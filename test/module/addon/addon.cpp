@@ -5,6 +5,9 @@
 
 #include "simple-object-wrap.h"
 
+#include <cmath>
+#include <vector>
+
 using namespace napa;
 using namespace napa::test;
 using namespace napa::module;
@@ -21,11 +24,81 @@ void CreateSimpleObjectWrap(const v8::FunctionCallbackInfo<v8::Value>& args) {
     SimpleObjectWrap::NewInstance(args);
 }
 
+double Add(double x, double y) {
+    return x + y;
+}
+
+int32_t Negate(int32_t value) {
+    return -value;
+}
+
+std::string Repeat(const std::string& text, uint32_t count) {
+    std::string result;
+    for (uint32_t i = 0; i < count; ++i) {
+        result += text;
+    }
+    return result;
+}
+
+bool IsFunction(v8::Local<v8::Value> value) {
+    return value->IsFunction();
+}
+
+double Sum(v8::Local<v8::Value> numbers) {
+    std::vector<double> elements;
+    if (!v8_helpers::V8NumbersToVector(v8::Isolate::GetCurrent(), numbers, elements)) {
+        return NAN;
+    }
+
+    double sum = 0;
+    for (auto element : elements) {
+        sum += element;
+    }
+    return sum;
+}
+
+void Scale(v8::Local<v8::Value> numbers, double factor) {
+    v8_helpers::TypedArrayContents<double> contents;
+    if (v8_helpers::GetTypedArrayContents(numbers, contents)) {
+        for (size_t i = 0; i < contents.length; ++i) {
+            contents.data[i] *= factor;
+        }
+    }
+}
+
+v8::Local<v8::Value> Squares(v8::Local<v8::Value> numbers) {
+    auto isolate = v8::Isolate::GetCurrent();
+    std::vector<int32_t> elements;
+    if (!v8_helpers::V8NumbersToVector(isolate, numbers, elements)) {
+        return v8::Undefined(isolate);
+    }
+
+    for (auto& element : elements) {
+        element *= element;
+    }
+    return v8_helpers::MakeTypedArray(isolate, elements);
+}
+
+v8::Local<v8::Value> GetCounters() {
+    static int32_t counters[4] = { 0 };
+    return v8_helpers::MakeExternalTypedArray(v8::Isolate::GetCurrent(), counters, 4);
+}
+
 void Init(v8::Local<v8::Object> exports) {
     SimpleObjectWrap::Init();
 
     NAPA_SET_METHOD(exports, "getModuleName", GetModuleName);
     NAPA_SET_METHOD(exports, "createSimpleObjectWrap", CreateSimpleObjectWrap);
+
+    NAPA_EXPORT_FUNCTION(exports, "add", Add);
+    NAPA_EXPORT_FUNCTION(exports, "negate", Negate);
+    NAPA_EXPORT_FUNCTION(exports, "repeat", Repeat);
+    NAPA_EXPORT_FUNCTION(exports, "isFunction", IsFunction);
+
+    NAPA_EXPORT_FUNCTION(exports, "sum", Sum);
+    NAPA_EXPORT_FUNCTION(exports, "scale", Scale);
+    NAPA_EXPORT_FUNCTION(exports, "squares", Squares);
+    NAPA_EXPORT_FUNCTION(exports, "getCounters", GetCounters);
 }
 
 NAPA_MODULE(addon, Init);
@@ -93,6 +93,25 @@ export function waitMS(waitTimeInMS: number): number {
     return wait - waitTimeInMS;
 }
 
+/// Counts the loops that stopped at their deadline, they leave the module state consistent.
+let stoppedLoops = 0;
+
+export function loopUntilDeadline(): number {
+    try {
+        while (true) {
+            napa.zone.checkDeadline();
+        }
+    }
+    catch (error) {
+        stoppedLoops++;
+        throw error;
+    }
+}
+
+export function getStoppedLoops(): number {
+    return stoppedLoops;
+}
+
 export function executeTestFunctionWithTimeout(id: string, waitTimeInMS: number, timeoutInMS?: number): Promise<any> {
     timeoutInMS = timeoutInMS ? timeoutInMS : Number.MAX_SAFE_INTEGER;
     let zone = napa.zone.get(id);
@@ -103,6 +122,24 @@ export function executeTestFunctionWithTimeout(id: string, waitTimeInMS: number,
     });
 }
 
+/// Makes a nested call once the deadline of the current call has passed, resolves to how the nested call ended.
+export function executeAfterDeadline(id: string, waitTimeInMS: number, detachDeadline: boolean): Promise<string> {
+    waitMS(waitTimeInMS);
+    return napa.zone.get(id).execute('./napa-zone/test', 'bar', ['done'], { detachDeadline: detachDeadline })
+        .then(() => 'resolved', () => 'rejected');
+}
+
+export function getTraceContext(): napa.zone.TraceContext {
+    return napa.zone.getTraceContext();
+}
+
+/// Resolves to the trace of this call and of the call it makes to another zone.
+export function executeTraced(id: string): Promise<any> {
+    let outer = napa.zone.getTraceContext();
+    return napa.zone.get(id).execute('./napa-zone/test', 'getTraceContext', [])
+        .then((result: napa.zone.Result) => ({ outer: outer, inner: result.value }));
+}
+
 export function executeWithTransportableArgs(id: string): Promise<any> {
     let zone = napa.zone.get(id);
     return new Promise((resolve, reject) => {
@@ -155,6 +192,58 @@ export function defaultAllocatorTest(): void {
     napa.memory.defaultAllocator.deallocate(handle, 10);
 }
 
+export function poolAllocatorTest(): void {
+    let handle = napa.memory.poolAllocator.allocate(10);
+    assert(!napa.memory.isEmpty(handle));
+    napa.memory.poolAllocator.deallocate(handle, 10);
+}
+
+export function arrayBufferPoolTest(): void {
+    let before = napa.memory.getArrayBufferPoolStats();
+    let buffer = new ArrayBuffer(100 * 1024);
+    assert.strictEqual(new Uint8Array(buffer)[100 * 1024 - 1], 0);
+
+    let after = napa.memory.getArrayBufferPoolStats();
+    assert(after.allocations > before.allocations);
+    assert(after.liveSize >= 100 * 1024);
+    assert(after.poolHits + after.mappedBlocks > 0);
+}
+
+export function allocateBufferTest(): void {
+    let buffer = napa.memory.poolAllocator.allocateBuffer(64);
+    assert.strictEqual(buffer.byteLength, 64);
+    let bytes = new Uint8Array(buffer);
+    bytes[63] = 7;
+    assert.strictEqual(bytes[63], 7);
+}
+
+export function arenaTest(): void {
+    let arena = napa.memory.createArena(4096);
+    let first = new Float64Array(arena.allocateBuffer(80));
+    first[9] = 1.5;
+    assert.strictEqual(first[9], 1.5);
+    assert(arena.allocatedSize >= 80);
+
+    arena.reset();
+    assert.strictEqual(arena.allocatedSize, 0);
+}
+
+export function sharedMapTest(map: napa.memory.SharedMap): number {
+    assert.strictEqual(map.get('name'), 'napa');
+    map.set('flag', true);
+    map.set('buffer', new Uint8Array([1, 2, 3]));
+    return map.add('counter', 1);
+}
+
+export function sharedBufferPoolTest(buffer: SharedArrayBuffer): number {
+    let bytes = new Uint8Array(buffer);
+    bytes[1] = 1;
+
+    let pooled = new Uint8Array(napa.memory.sharedBufferPool.allocate(100 * 1024, false));
+    assert.strictEqual(pooled.length, 100 * 1024);
+    return bytes[0];
+}
+
 export function debugAllocatorTest(): void {
     let allocator = napa.memory.debugAllocator(napa.memory.defaultAllocator);
     let handle = allocator.allocate(10);
@@ -304,4 +393,37 @@ export function nontransportableTest() {
     catch(error) {
     }
     assert(!success);
-}
\ No newline at end of file
+}
+let _warmupCalls: number = 0;
+let _warmupTotal: number = 0;
+
+export function warmUp(a: number, b: { x: number }): number {
+    _warmupCalls++;
+    _warmupTotal += a + b.x;
+    return a + b.x;
+}
+
+export function getWarmupCalls(): { calls: number, total: number } {
+    return { calls: _warmupCalls, total: _warmupTotal };
+}
+
+/// <summary> When this module was loaded in the isolate, zone settings may preload it. </summary>
+const _loadTime: number = Date.now();
+
+export function getLoadTime(): number {
+    return _loadTime;
+}
+
+/// <summary> Sets a global of the calling context, which tenant contexts keep apart. </summary>
+export function setTenantGlobal(value: any): void {
+    (<any>global).__tenantGlobal = value;
+}
+
+export function getTenantGlobal(): any {
+    return (<any>global).__tenantGlobal;
+}
+
+/// <summary> Passes on its first argument unparsed, and reads the property 'x' of its second. </summary>
+export const forwardLazyArgs = napa.zone.lazyArgs(function (forwarded: napa.zone.LazyArgument, read: napa.zone.LazyArgument) {
+    return { forwarded: forwarded.payload, x: read.value.x, cached: read.value === read.value };
+});
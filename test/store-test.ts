@@ -3,6 +3,7 @@
 
 import * as napa from "../lib/index";
 import * as assert from 'assert';
+import * as fs from 'fs';
 import * as path from 'path';
 
 describe('napajs/store', function () {
@@ -25,6 +26,294 @@ describe('napajs/store', function () {
         assert(!succeed);
     });
 
+    it('@node: store.create - sharded', () => {
+        let store = napa.store.create('sharded-store', { shards: 16 });
+        for (let i = 0; i < 100; ++i) {
+            store.set('key' + i, i);
+        }
+        assert.equal(store.size, 100);
+        assert.equal(store.get('key42'), 42);
+        store.delete('key42');
+        assert(!store.has('key42'));
+        assert.equal(store.size, 99);
+    });
+
+    let frozenStore = napa.store.create('frozen-store', { frozen: true });
+    it('@node: store.get - frozen', () => {
+        let store = frozenStore;
+        store.set('table', { a: [1, 2], b: { c: 'd' } });
+        let table = store.get('table');
+        assert(Object.isFrozen(table));
+        assert(Object.isFrozen(table.a));
+        assert(Object.isFrozen(table.b));
+        assert(store.get('table') === table);
+
+        store.set('table', { a: [3] });
+        let updated = store.get('table');
+        assert(updated !== table);
+        assert.deepEqual(updated, { a: [3] });
+    });
+
+    it('@napa: store.get - frozen', () => {
+        return napaZone.execute(() => {
+            const napa = require('../lib/index');
+            let store = napa.store.get('frozen-store');
+            return store.get('table') === store.get('table') && Object.isFrozen(store.get('table'));
+        }).then((result: napa.zone.Result) => {
+            assert(result.value);
+        });
+    });
+
+    let frozenValue = napa.store.freeze({ name: 'table', rows: [[1, 'a'], [2, null]], flags: { on: true, off: false } });
+    it('@node: freeze', () => {
+        let root = frozenValue.root;
+        assert.equal(root.name, 'table');
+        assert.equal(root.rows.length, 2);
+        assert.equal(root.rows[1][0], 2);
+        assert.strictEqual(root.rows[1][1], null);
+        assert.strictEqual(root.flags.off, false);
+        assert.strictEqual(root.missing, undefined);
+        assert(Array.isArray(root.rows));
+        assert.deepEqual(Object.keys(root), ['name', 'rows', 'flags']);
+        assert.equal(JSON.stringify(root), '{"name":"table","rows":[[1,"a"],[2,null]],"flags":{"on":true,"off":false}}');
+        assert(root.rows === frozenValue.root.rows);
+        assert(frozenValue.byteLength > 0);
+
+        assert.throws(() => { root.name = 'changed'; });
+        assert.throws(() => { delete root.rows; });
+        assert.equal(root.name, 'table');
+        assert.throws(() => napa.store.freeze(undefined));
+    });
+
+    it('@napa: freeze', () => {
+        return napaZone.execute((value: any) => {
+            return value.root.rows.map((row: any[]) => row[0]).join(',') + ':' + value.root.flags.on;
+        }, [frozenValue]).then((result: napa.zone.Result) => {
+            assert.equal(result.value, '1,2:true');
+        });
+    });
+
+    it('@node: store.set - ttl', (done: () => void) => {
+        let store = napa.store.create('ttl-store');
+        store.set('short', 1, { ttl: 10 });
+        store.set('long', 2, { ttl: 60 * 1000 });
+        assert.equal(store.get('short'), 1);
+        setTimeout(() => {
+            assert(!store.has('short'));
+            assert.equal(store.get('short'), undefined);
+            assert.equal(store.get('long'), 2);
+            done();
+        }, 50);
+    });
+
+    it('@node: store.set - maxBytes', () => {
+        let store = napa.store.create('max-bytes-store', { maxBytes: 1024 });
+        for (let i = 0; i < 100; ++i) {
+            store.set('key' + i, 'value of key ' + i);
+        }
+        assert(store.size < 100);
+        assert.equal(store.get('key99'), 'value of key 99');
+    });
+
+    it('@node: store.set - compressionThreshold', () => {
+        let store = napa.store.create('compressed-store', { compressionThreshold: 256 });
+        let document: any[] = [];
+        for (let i = 0; i < 100; ++i) {
+            document.push({ id: i, name: 'item', tags: ['a', 'b'] });
+        }
+        store.set('document', document);
+        store.set('wide', { text: '\u4e2d'.repeat(500) });
+        store.set('small', { id: 1 });
+        assert.deepEqual(store.get('document'), document);
+        assert.equal(store.get('wide').text, '\u4e2d'.repeat(500));
+        assert.deepEqual(store.get('small'), { id: 1 });
+    });
+
+    it('@node: store.set - intern', () => {
+        let store = napa.store.create('interned-store', { frozen: true, intern: true });
+        let config = { feature: 'on', limits: [1, 2, 3] };
+        store.set('tenant1', config);
+        store.set('tenant2', config);
+        store.set('tenant3', { feature: 'off' });
+        assert(store.get('tenant1') === store.get('tenant2'));
+        assert(store.get('tenant1') !== store.get('tenant3'));
+        assert.deepEqual(store.get('tenant2'), config);
+    });
+
+    it('@node: store.patch', () => {
+        let store = napa.store.create('patched-store');
+        store.set('user', { name: 'alice', address: { city: 'Seattle', zip: '98101' }, tags: ['a'] });
+        store.patch('user', { address: { zip: null }, tags: ['b', 'c'], active: true });
+        assert.deepEqual(store.get('user'), { name: 'alice', address: { city: 'Seattle' }, tags: ['b', 'c'], active: true });
+
+        store.patch('new', { a: 1, b: null, c: { d: null } });
+        assert.deepEqual(store.get('new'), { a: 1, c: {} });
+
+        store.increment('counter');
+        assert.throws(() => store.patch('counter', { a: 1 }));
+    });
+
+    it('@napa: store.patch', () => {
+        return napaZone.execute(() => {
+            let store = napa.store.getOrCreate('patched-store');
+            store.patch('user', { name: '\u4e2d' });
+            return store.get('user').name;
+        }).then((result: napa.zone.Result) => {
+            assert.equal(result.value, '\u4e2d');
+        });
+    });
+
+    it('@node: store.setLoader and store.getOrLoad', () => {
+        let store = napa.store.create('loaded-store');
+        let loaded: string[] = [];
+        (<any>global).loadStoreTestValue = (key: string) => {
+            loaded.push(key);
+            if (key === 'self') {
+                return store.getOrLoad('self');
+            }
+            return key === 'missing' ? undefined : { key: key };
+        };
+
+        assert.throws(() => store.getOrLoad('a'));
+        store.setLoader('', 'loadStoreTestValue');
+
+        assert.deepEqual(store.getOrLoad('a'), { key: 'a' });
+        assert.deepEqual(store.getOrLoad('a'), { key: 'a' });
+        assert.deepEqual(store.get('a'), { key: 'a' });
+        assert(store.getOrLoad('missing') === undefined);
+        assert(!store.has('missing'));
+        assert.throws(() => store.getOrLoad('self'));
+        assert.deepEqual(loaded, ['a', 'missing', 'self']);
+
+        let stats = napa.store.stats().filter((s: napa.store.StoreStats) => s.id === 'loaded-store')[0];
+        assert.equal(stats.loads, 3);
+        assert.equal(stats.loadWaits, 0);
+        delete (<any>global).loadStoreTestValue;
+    });
+
+    it('@node: store.view', () => {
+        let store = napa.store.create('viewed-store', { shards: 4 });
+        store.set('order', { items: ['a', 'b'] });
+        store.set('a', 1);
+        let view = store.view();
+        store.set('order', { items: ['c'] });
+        store.delete('a');
+        store.set('c', 3);
+
+        assert.deepEqual(view.get('order'), { items: ['a', 'b'] });
+        assert.deepEqual(view.getMany(['a', 'c']), [1, undefined]);
+        assert(view.has('a'));
+        assert(!view.has('c'));
+        assert.deepEqual(store.get('order'), { items: ['c'] });
+
+        view.release();
+        assert.throws(() => view.get('order'));
+    });
+
+    it('@node: store.setMany and store.getMany', () => {
+        let store = napa.store.create('many-store', { shards: 4 });
+        let entries: [string, any][] = [];
+        for (let i = 0; i < 50; ++i) {
+            entries.push(['key' + i, { index: i }]);
+        }
+        store.setMany(entries);
+        assert.equal(store.size, 50);
+        assert.deepEqual(store.getMany(['key7', 'missing', 'key42']), [{ index: 7 }, undefined, { index: 42 }]);
+    });
+
+    let refStore = napa.store.create('ref-store', { frozen: true });
+    it('@node: store.ref', () => {
+        refStore.set('table', { rows: [1, 2, 3] });
+        let ref = refStore.ref('table');
+        assert.equal(ref.storeId, 'ref-store');
+        assert.equal(ref.key, 'table');
+
+        // Unmarshalling a reference gets the value it references.
+        let context = napa.transport.createTransportContext();
+        let payload = napa.transport.marshall([ref, refStore.ref('missing')], context);
+        assert.deepEqual(napa.transport.unmarshall(payload, context), [{ rows: [1, 2, 3] }, undefined]);
+        assert.throws(() => refStore.ref(<any>1));
+    });
+
+    it('@napa: store.ref', () => {
+        return napaZone.execute((table: any, missing: any) => {
+            return table.rows.length + ':' + Object.isFrozen(table) + ':' + (missing === undefined);
+        }, [refStore.ref('table'), refStore.ref('missing')]).then((result: napa.zone.Result) => {
+            assert.equal(result.value, '3:true:true');
+        });
+    });
+
+    let numberStore = napa.store.create('number-store');
+    it('@node: store.increment and store.compareAndSet', () => {
+        let store = numberStore;
+        assert.equal(store.increment('counter'), 1);
+        assert.equal(store.increment('counter', 9), 10);
+        assert.equal(store.get('counter'), 10);
+        assert(!store.compareAndSet('counter', 9, 0));
+        assert(store.compareAndSet('counter', 10, 0));
+        assert.equal(store.getNumber('counter'), 0);
+
+        assert.equal(store.add('ratio', 0.5), 0.5);
+        assert.throws(() => store.increment('ratio'));
+        store.set('value', 1);
+        assert.equal(store.getNumber('value'), undefined);
+    });
+
+    it('@napa: store.increment', () => {
+        return napaZone.execute(() => {
+            const napa = require('../lib/index');
+            return napa.store.get('number-store').increment('counter');
+        }).then((result: napa.zone.Result) => {
+            assert.equal(result.value, 1);
+            assert.equal(numberStore.getNumber('counter'), 1);
+        });
+    });
+
+    it('@node: store.snapshot and store.load', () => {
+        let snapshotPath = path.resolve(__dirname, 'store-test.snap');
+        let store = napa.store.create('snapshot-store');
+        store.set('a', { b: [1, 2] });
+        store.increment('c', 3);
+        assert.equal(store.snapshot(snapshotPath), 2);
+
+        let loadedStore = napa.store.create('snapshot-store-loaded');
+        assert.equal(loadedStore.load(snapshotPath), 2);
+        assert.deepEqual(loadedStore.get('a'), { b: [1, 2] });
+        assert.equal(loadedStore.increment('c'), 4);
+        fs.unlinkSync(snapshotPath);
+        assert.throws(() => loadedStore.load(snapshotPath));
+    });
+
+    it('@node: store.keys and store.range', () => {
+        let store = napa.store.create('ordered-store', { shards: 4, ordered: true });
+        store.set('b:2', 2);
+        store.set('a:1', 1);
+        store.set('b:1', { c: 1 });
+        store.set('b:3', 3);
+        assert.deepEqual(store.keys('b:'), ['b:1', 'b:2', 'b:3']);
+        assert.deepEqual(store.keys(), ['a:1', 'b:1', 'b:2', 'b:3']);
+        assert.deepEqual(store.range('b:1', 'b:3'), [['b:1', { c: 1 }], ['b:2', 2]]);
+        assert.deepEqual(store.range('b:2'), [['b:2', 2], ['b:3', 3]]);
+    });
+
+    it('@node: store.watch and store.unwatch', (done) => {
+        let store = napa.store.create('watch-store');
+        let keys: string[] = [];
+        let watchId = store.watch('user:*', (key: string) => {
+            keys.push(key);
+            if (key === 'user:2') {
+                assert.deepEqual(keys, ['user:1', 'user:2']);
+                assert(store.unwatch(watchId));
+                assert(!store.unwatch(watchId));
+                done();
+            }
+        });
+        store.set('user:1', 1);
+        store.set('other', 1);
+        store.set('user:1', 2);
+        store.set('user:2', 1);
+    });
+
     let store2CreationComplete: Promise<napa.zone.Result>;
 
     it('@napa: store.getOrCreate', () => {
@@ -166,4 +455,27 @@ describe('napajs/store', function () {
         // delete 'a', 'b', 'c', 'd'
         assert.equal(store1.size, 6);
     });
+
+    it('@node: byteSize and stats', () => {
+        let store = napa.store.create('store-stats');
+        store.set('key', 'value');
+        store.set('buffer', new SharedArrayBuffer(1024));
+        assert(store.byteSize > 0);
+
+        let stats = napa.store.stats().filter(s => s.id === 'store-stats')[0];
+        assert(stats != null);
+        assert.equal(stats.size, 2);
+        assert.equal(stats.byteSize, store.byteSize);
+        assert.equal(stats.keyBytes, 'key'.length + 'buffer'.length);
+        assert.equal(stats.payloadBytes, stats.byteSize - stats.keyBytes);
+        assert.equal(stats.sharedObjects, 1);
+        assert(stats.sharedObjectBytes >= 0);
+
+        let ids = napa.store.stats().map(s => s.id);
+        assert.deepEqual(ids, ids.slice().sort());
+
+        store.delete('key');
+        store.delete('buffer');
+        assert.equal(store.byteSize, 0);
+    });
 });
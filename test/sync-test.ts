@@ -148,4 +148,287 @@ describe('napajs/sync', function () {
         }
     }).timeout(5000);
 
+    it('@node: sync.Lock - tryGuardSync obtains a free lock', () => {
+        let lock = napa.sync.createLock();
+        let value = lock.tryGuardSync((a: number, b: number) => {
+            return a + b;
+        }, [1, 2]);
+        assert.strictEqual(value, 3);
+    });
+
+    it('@napa: sync.Lock - tryGuardSync and timed guardSync on a held lock', () => {
+        let napaZone = napa.zone.create('zone-for-sync-test-3', { workers: 2 });
+        napaZone.broadcast(spinWait.toString());
+
+        let lock = napa.sync.createLock();
+        let exe1 = napaZone.execute(function (lock) {
+            lock.guardSync(function () {
+                (<any>global).spinWait(500);
+            });
+        }, [lock]);
+
+        let exe2 = napaZone.execute(function (lock) {
+            let assert = require('assert');
+            (<any>global).spinWait(100);
+
+            let ran = false;
+            let value = lock.tryGuardSync(function () {
+                ran = true;
+                return 1;
+            });
+            assert.strictEqual(value, undefined);
+            assert(!ran);
+
+            assert.throws(() => {
+                lock.guardSync(function () {
+                    ran = true;
+                }, [], 50);
+            });
+            assert(!ran);
+
+            return lock.guardSync(function () {
+                return 2;
+            }, [], 2000);
+        }, [lock]);
+
+        return Promise.all([exe1, exe2]).then(function (results) {
+            assert.strictEqual(results[1].value, 2);
+        });
+    }).timeout(5000);
+
+    it('@node: sync.Lock - guard holds the lock until the returned promise settles', () => {
+        let lock = napa.sync.createLock();
+        let order: number[] = [];
+
+        let first = lock.guard(() => {
+            return new Promise<number>((resolve) => {
+                setTimeout(() => {
+                    order.push(1);
+                    resolve(1);
+                }, 100);
+            });
+        });
+        let second = lock.guard((a: number) => {
+            order.push(a);
+            return a;
+        }, [2]);
+        let third = lock.guard(() => {
+            throw new Error('guarded error');
+        });
+
+        return Promise.all([first, second, third.catch((error: Error) => error.message)]).then((values) => {
+            assert.deepEqual(values, [1, 2, 'guarded error']);
+            assert.deepEqual(order, [1, 2]);
+            assert.strictEqual(lock.tryGuardSync(() => 3), 3);
+        });
+    });
+
+    it('@napa: sync.Lock - guard obtains a lock released by another worker', () => {
+        let napaZone = napa.zone.create('zone-for-sync-test-5', { workers: 2 });
+        napaZone.broadcast(spinWait.toString());
+
+        let lock = napa.sync.createLock();
+        let holder = napaZone.execute(function (lock) {
+            lock.guardSync(function () {
+                (<any>global).spinWait(300);
+            });
+        }, [lock]);
+
+        let waiter = napaZone.execute(function (lock) {
+            (<any>global).spinWait(100);
+            return lock.guard(function (value: number) {
+                return value;
+            }, [2]);
+        }, [lock]);
+
+        return Promise.all([holder, waiter]).then(function (results) {
+            assert.strictEqual(results[1].value, 2);
+        });
+    }).timeout(5000);
+
+    it('@node: sync.ReadWriteLock - parameters passing', () => {
+        let lock = napa.sync.createReadWriteLock();
+        let value = lock.guardReadSync((a: number, b: string) => {
+            return a + b;
+        }, [123, '456']);
+        assert.strictEqual(value, '123456');
+
+        value = lock.guardWriteSync((a: number) => {
+            return a * 2;
+        }, [21]);
+        assert.strictEqual(value, 42);
+    });
+
+    it('@napa: sync.ReadWriteLock - readers share the lock, writers do not', () => {
+        let napaZone = napa.zone.create('zone-for-sync-test-4', { workers: 2 });
+        napaZone.broadcast(spinWait.toString());
+
+        let lock = napa.sync.createReadWriteLock();
+        let reader = napaZone.execute(function (lock) {
+            lock.guardReadSync(function () {
+                (<any>global).spinWait(500);
+            });
+        }, [lock]);
+
+        let other = napaZone.execute(function (lock) {
+            let assert = require('assert');
+            (<any>global).spinWait(100);
+
+            // Another reader gets in right away, a writer times out.
+            assert.strictEqual(lock.guardReadSync(function () { return 1; }, [], 50), 1);
+            assert.throws(() => {
+                lock.guardWriteSync(function () {}, [], 50);
+            });
+            return lock.guardWriteSync(function () { return 2; }, [], 2000);
+        }, [lock]);
+
+        return Promise.all([reader, other]).then(function (results) {
+            assert.strictEqual(results[1].value, 2);
+        });
+    }).timeout(5000);
+
+    it('@node: sync.Channel - send and receive in order', () => {
+        let channel = napa.sync.createChannel(2);
+        assert.strictEqual(channel.capacity, 2);
+
+        channel.sendSync(1);
+        channel.sendSync({ field: 'value' });
+        assert.strictEqual(channel.size, 2);
+        assert.throws(() => {
+            channel.sendSync(3, [], 10);
+        });
+
+        assert.strictEqual(channel.receiveSync(), 1);
+        assert.deepEqual(channel.receiveSync(), { field: 'value' });
+        assert.throws(() => {
+            channel.receiveSync(10);
+        });
+    });
+
+    it('@node: sync.Channel - asynchronous receivers wait for senders', () => {
+        let channel = napa.sync.createChannel(1);
+        let received = Promise.all([channel.receive(), channel.receive()]);
+
+        return channel.send('a').then(() => channel.send('b')).then(() => received).then((values) => {
+            assert.deepEqual(values, ['a', 'b']);
+        });
+    });
+
+    it('@node: sync.Channel - close rejects waiters after the values are received', () => {
+        let channel = napa.sync.createChannel(1);
+        channel.sendSync(1);
+        let pendingSend = channel.send(2);
+
+        channel.close();
+        assert(channel.closed);
+        assert.throws(() => {
+            channel.sendSync(3);
+        });
+        assert.strictEqual(channel.receiveSync(), 1);
+
+        return Promise.all([
+            pendingSend.then(() => 'sent', () => 'rejected'),
+            channel.receive().then(() => 'received', () => 'rejected')
+        ]).then((outcomes) => {
+            assert.deepEqual(outcomes, ['rejected', 'rejected']);
+        });
+    });
+
+    it('@napa: sync.Channel - stream values between workers with transferred ArrayBuffers', () => {
+        let napaZone = napa.zone.create('zone-for-sync-test-6', { workers: 2 });
+        let channel = napa.sync.createChannel(2);
+        let count = 10;
+
+        let producer = napaZone.execute(function (channel, count: number) {
+            let assert = require('assert');
+            for (let i = 0; i < count; ++i) {
+                let buffer = new ArrayBuffer(4);
+                new Uint32Array(buffer)[0] = i;
+                channel.sendSync(buffer, [buffer]);
+                assert.strictEqual(buffer.byteLength, 0);
+            }
+            channel.close();
+        }, [channel, count]);
+
+        let consumer = napaZone.execute(function (channel) {
+            let sum = 0;
+            function consume(): Promise<number> {
+                return channel.receive().then((buffer: ArrayBuffer) => {
+                    sum += new Uint32Array(buffer)[0];
+                    return consume();
+                }, () => sum);
+            }
+            return consume();
+        }, [channel]);
+
+        return Promise.all([producer, consumer]).then(function (results) {
+            assert.strictEqual(results[1].value, 45);
+        });
+    }).timeout(5000);
+
+    it('@node: sync.Semaphore - acquire and release permits', () => {
+        let semaphore = napa.sync.createSemaphore(2);
+        assert.strictEqual(semaphore.count, 2);
+        semaphore.acquireSync();
+        assert(semaphore.tryAcquire());
+        assert(!semaphore.tryAcquire());
+        assert.throws(() => {
+            semaphore.acquireSync(10);
+        });
+
+        let acquired = semaphore.acquire();
+        semaphore.release(2);
+        return acquired.then(() => {
+            assert.strictEqual(semaphore.count, 1);
+        });
+    });
+
+    it('@node: sync.CountDownLatch - wait for the count to reach zero', () => {
+        let latch = napa.sync.createCountDownLatch(3);
+        assert.throws(() => {
+            latch.waitSync(10);
+        });
+
+        let opened = latch.wait();
+        latch.countDown();
+        latch.countDown(5);
+        assert.strictEqual(latch.count, 0);
+        latch.waitSync();
+        return opened;
+    });
+
+    it('@node: sync.Barrier - the last party releases the others', () => {
+        let barrier = napa.sync.createBarrier(2);
+        assert.strictEqual(barrier.parties, 2);
+
+        let first = barrier.arrive();
+        assert.strictEqual(barrier.arrived, 1);
+        let second = barrier.arrive();
+        return Promise.all([first, second]).then((lasts) => {
+            assert.deepEqual(lasts, [false, true]);
+            assert.strictEqual(barrier.arrived, 0);
+        });
+    });
+
+    it('@napa: sync.Barrier - workers wait for each other at every phase', () => {
+        let napaZone = napa.zone.create('zone-for-sync-test-7', { workers: 2 });
+        let barrier = napa.sync.createBarrier(2);
+        let latch = napa.sync.createCountDownLatch(2);
+
+        let tasks = [0, 1].map(() => napaZone.execute(function (barrier, latch) {
+            let lasts = 0;
+            for (let phase = 0; phase < 3; ++phase) {
+                if (barrier.arriveSync()) {
+                    ++lasts;
+                }
+            }
+            latch.countDown();
+            return lasts;
+        }, [barrier, latch]));
+
+        return Promise.all(tasks.concat(<any>latch.wait())).then(function (results) {
+            assert.strictEqual(results[0].value + results[1].value, 3);
+        });
+    }).timeout(5000);
+
 });
@@ -87,6 +87,79 @@ describe('napajs/transport', () => {
             t.nontransportableTest();
         });
 
+        it('@node: plain payloads', () => {
+            let value = { a: [1, 'two', { b: null }], c: 'not a "_cid" marker', d: true };
+            let tc = napa.transport.createTransportContext();
+            assert.deepEqual(napa.transport.unmarshall(napa.transport.marshall(value, tc), tc), value);
+            assert.deepEqual(napa.transport.unmarshall('[1,{"x":"_serialized"}]', tc), [1, { x: '_serialized' }]);
+        });
+
+        it('@node: classes registered with a schema', () => {
+            class SchemaPoint extends napa.transport.AutoTransportable {
+                x: number = 0;
+                y: any = null;
+            }
+            (<any>SchemaPoint)._cid = 'transport-test.SchemaPoint';
+            napa.transport.register(SchemaPoint, ['x', 'y']);
+
+            let point = new SchemaPoint();
+            point.x = 1;
+            point.y = new SchemaPoint();
+
+            let tc = napa.transport.createTransportContext();
+            let payload = napa.transport.marshall(point, tc);
+            assert.deepEqual(JSON.parse(payload)._v[0], 1);
+
+            let copy: SchemaPoint = napa.transport.unmarshall(payload, tc);
+            assert(copy instanceof SchemaPoint);
+            assert.strictEqual(copy.x, 1);
+            assert(copy.y instanceof SchemaPoint);
+            assert.strictEqual(copy.y.y, null);
+        });
+
+        it('@node: classes without a schema may have a _v property', () => {
+            class VersionedPoint extends napa.transport.AutoTransportable {
+                x: number = 0;
+                _v: number = 0;
+            }
+            (<any>VersionedPoint)._cid = 'transport-test.VersionedPoint';
+            napa.transport.register(VersionedPoint);
+
+            let point = new VersionedPoint();
+            point.x = 1;
+            point._v = 2;
+
+            let tc = napa.transport.createTransportContext();
+            let copy: VersionedPoint = napa.transport.unmarshall(napa.transport.marshall(point, tc), tc);
+            assert(copy instanceof VersionedPoint);
+            assert.strictEqual(copy.x, 1);
+            assert.strictEqual(copy._v, 2);
+        });
+
+        it('@node: shareable wraps of the same object are reused', () => {
+            let allocator = napa.memory.debugAllocator(napa.memory.crtAllocator);
+            let tc = napa.transport.createTransportContext();
+            let payload = napa.transport.marshall([allocator, allocator], tc);
+
+            let copies = napa.transport.unmarshall(payload, tc);
+            assert.strictEqual(copies[0], copies[1]);
+            assert.strictEqual(allocator.handle, allocator.handle);
+        });
+
+        it('@node: marshall matches JSON.stringify', () => {
+            let value: any = {
+                i: 1, d: 0.5, big: 1e300, nan: NaN, neg: -0, s: 'quote " and \n',
+                skipped: undefined, f: () => 1, date: new Date(0), list: [undefined, () => 1, null, 'x']
+            };
+            let tc = napa.transport.createTransportContext();
+            assert.deepEqual(JSON.parse(napa.transport.marshall(value, tc)), JSON.parse(JSON.stringify(value)));
+            assert.strictEqual(napa.transport.marshall(undefined, tc), undefined);
+
+            let cycle: any = { a: {} };
+            cycle.a.b = cycle;
+            assert.throws(() => napa.transport.marshall(cycle, tc));
+        });
+
         it('@napa: non-transportable', () => {
             napaZone.execute('./napa-zone/test', "nontransportableTest");
         });
@@ -337,6 +410,99 @@ describe('napajs/transport', () => {
                 }, timeout);
             });
         });
+
+        it('@node: transfer ArrayBuffer (AB)', () => {
+            let ab: ArrayBuffer = new ArrayBuffer(4);
+            let ta: Uint8Array = new Uint8Array(ab);
+            ta[0] = 1;
+            return transportTestZone.execute((ab: ArrayBuffer, ta: Uint8Array) => {
+                ta[1] = 2;
+                return new Uint8Array(ab).toString();
+            }, [ab, ta], { transferList: [ab] }).then((result: napa.zone.Result) => {
+                // The sender's ArrayBuffer is detached, both arguments were moved to the same memory.
+                assert.equal(ab.byteLength, 0);
+                assert.equal(ta.length, 0);
+                assert.equal(result.value, '1,2,0,0');
+            });
+        });
+
+        it('@node: transfer received ArrayBuffer (AB)', () => {
+            let ab: ArrayBuffer = new ArrayBuffer(4);
+            return transportTestZone.execute((ab: ArrayBuffer) => {
+                new Uint8Array(ab)[0] = 1;
+                const napa = require('../lib/index');
+                return napa.zone.node.execute((ab: ArrayBuffer) => {
+                    return new Uint8Array(ab).toString();
+                }, [ab], { transferList: [ab] }).then((result: any) => {
+                    return [ab.byteLength, result.value];
+                });
+            }, [ab], { transferList: [ab] }).then((result: napa.zone.Result) => {
+                assert.deepEqual(result.value, [0, '1,0,0,0']);
+            });
+        });
+
+        it('@node: transfer ArrayBuffer (AB) into store', () => {
+            let store = napa.store.getOrCreate('transfer-store');
+            let ab: ArrayBuffer = new ArrayBuffer(4);
+            new Uint8Array(ab)[0] = 1;
+            store.set('ab', ab, [ab]);
+            assert.equal(ab.byteLength, 0);
+
+            return transportTestZone.execute(() => {
+                const napa = require('../lib/index');
+                return new Uint8Array(napa.store.get('transfer-store').get('ab')).toString();
+            }).then((result: napa.zone.Result) => {
+                assert.equal(result.value, '1,0,0,0');
+            });
+        });
+
+        it('@node: transport Map, Set, Date and RegExp', () => {
+            let date = new Date(Date.UTC(2017, 6, 1));
+            let map = new Map<any, any>([['a', 1], [2, { b: [date] }]]);
+            let set = new Set<any>(['x', 3]);
+            return transportTestZone.execute((value: any) => {
+                let nested = value.map.get(2);
+                return {
+                    map: value.map instanceof Map ? Array.from(value.map.keys()) : null,
+                    set: value.set instanceof Set ? Array.from(value.set.values()) : null,
+                    time: value.date instanceof Date ? value.date.getTime() : null,
+                    nestedTime: nested.b[0] instanceof Date ? nested.b[0].getTime() : null,
+                    matches: value.pattern instanceof RegExp ? value.pattern.test('NAPA') : null,
+                    result: new Map([['date', value.date]])
+                };
+            }, [{ map: map, set: set, date: date, pattern: /napa/i }]).then((result: napa.zone.Result) => {
+                assert.deepEqual(result.value.map, ['a', 2]);
+                assert.deepEqual(result.value.set, ['x', 3]);
+                assert.equal(result.value.time, date.getTime());
+                assert.equal(result.value.nestedTime, date.getTime());
+                assert.equal(result.value.matches, true);
+                assert(result.value.result instanceof Map);
+                assert.equal(result.value.result.get('date').getTime(), date.getTime());
+            });
+        });
+
+        it('@node: binary transport of arguments and result', () => {
+            let ta = new Float64Array([1.5, 2.5]);
+            return transportTestZone.execute((value: any, ta: Float64Array) => {
+                return { sum: ta[0] + ta[1], keys: Object.keys(value), nested: value.nested };
+            }, [{ a: 1, nested: [1, 'two', null] }, ta], { transport: napa.zone.TransportOption.BINARY })
+                .then((result: napa.zone.Result) => {
+                    assert(result.payload instanceof ArrayBuffer);
+                    assert.deepEqual(result.value, { sum: 4, keys: ['a', 'nested'], nested: [1, 'two', null] });
+                });
+        });
+
+        it('@node: binary transport of native objects and transferred ArrayBuffer', () => {
+            let ab: ArrayBuffer = new ArrayBuffer(4);
+            new Uint8Array(ab)[0] = 1;
+            return transportTestZone.execute((allocator: any, ab: ArrayBuffer) => {
+                return [allocator.type, new Uint8Array(ab).toString()];
+            }, [napa.memory.crtAllocator, ab], { transport: napa.zone.TransportOption.BINARY, transferList: [ab] })
+                .then((result: napa.zone.Result) => {
+                    assert.equal(ab.byteLength, 0);
+                    assert.deepEqual(result.value, [napa.memory.crtAllocator.type, '1,0,0,0']);
+                });
+        });
     }
 
     let builtinTestGroup = 'Transport built-in objects';
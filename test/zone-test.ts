@@ -2,6 +2,7 @@
 // Licensed under the MIT license.
 
 import * as assert from "assert";
+import * as fs from "fs";
 import * as path from "path";
 import * as napa from "../lib/index";
 
@@ -179,6 +180,20 @@ describe('napajs/zone', function () {
             return napaZone1.execute('./napa-zone/test', "broadcastTestFunction", ['node']);
         });
 
+        it('@node: -> napa zone with anonymous function on some workers', () => {
+            return shouldFail(() => {
+                return napaZone1.broadcast((input: string) => {
+                    throw new Error(input);
+                }, ['worker 0'], { workers: [0] });
+            });
+        });
+
+        it('@node: -> napa zone with anonymous function on workers that are not running', () => {
+            return napaZone1.broadcast((input: string) => {
+                throw new Error(input);
+            }, ['worker 64'], { workers: [64] });
+        });
+
         // TODO #4: support transportable args in broadcast.
         it.skip('@node: -> node zone with transportable args', () => {
             return napa.zone.current.broadcast((allocator: any) => {
@@ -618,5 +633,1145 @@ describe('napajs/zone', function () {
 
         it.skip('@napa: -> napa zone with timed out in multiple hops', () => {
         });
+
+        it('@node: -> napa zone with deadline already passed', () => {
+            return shouldFail(() => {
+                return napaZone1.execute("", "foo", ['hello world'], { deadline: Date.now() - 1 });
+            });
+        });
+
+        it('@node: -> napa zone with priority and future deadline', () => {
+            return napaZone1.execute("", "foo", ['hello world'], { priority: 1, deadline: Date.now() + 60000 })
+                .then((result: napa.zone.Result) => {
+                    assert.equal(result.value, 'hello world');
+                });
+        });
+
+        it('@node: -> napa zone with timing recorded', () => {
+            return napaZone1.execute("", "foo", ['hello world'], { recordTiming: true })
+                .then((result: napa.zone.Result) => {
+                    assert.equal(result.value, 'hello world');
+                    assert(result.timing.queue > 0);
+                    assert(result.timing.unmarshall > 0);
+                    assert(result.timing.execute > 0);
+                    assert(result.timing.marshall > 0);
+                });
+        });
+
+        it('@node: -> napa zone without timing recorded', () => {
+            return napaZone1.execute("", "foo", ['hello world'])
+                .then((result: napa.zone.Result) => {
+                    assert.equal(result.timing, undefined);
+                });
+        });
+    });
+
+    describe('executeOnWorker', () => {
+        it('@node: -> napa zone keeps state on the given worker', () => {
+            return napaZone1.executeOnWorker(0, () => { (<any>global).shardState = 'worker0'; })
+                .then(() => napaZone1.executeOnWorker(0, () => (<any>global).shardState))
+                .then((result: napa.zone.Result) => {
+                    assert.strictEqual(result.value, 'worker0');
+                    return napaZone1.executeOnWorker(1, () => typeof (<any>global).shardState);
+                })
+                .then((result: napa.zone.Result) => {
+                    assert.strictEqual(result.value, 'undefined');
+                });
+        });
+
+        it('@node: -> napa zone rejects a worker that is not running', () => {
+            return shouldFail(() => napaZone1.executeOnWorker(64, () => 1));
+        });
+
+        it('@node: -> node zone runs worker 0 only', () => {
+            return napa.zone.node.executeOnWorker(0, () => 1)
+                .then((result: napa.zone.Result) => {
+                    assert.strictEqual(result.value, 1);
+                    return shouldFail(() => napa.zone.node.executeOnWorker(1, () => 1));
+                });
+        });
+    });
+
+    describe('executeBatch', () => {
+        let fooDef = 'function foo(input) { return input; }';
+        napaZone1.broadcast(fooDef);
+        napa.zone.node.broadcast(fooDef);
+
+        it('@node: -> napa zone with global function name', () => {
+            let argsList: number[][] = [];
+            for (let i = 0; i < 100; i++) {
+                argsList.push([i]);
+            }
+            return napaZone1.executeBatch("", "foo", argsList)
+                .then((results: napa.zone.Result[]) => {
+                    assert.deepEqual(results.map(result => result.value), argsList.map(args => args[0]));
+                });
+        });
+
+        it('@node: -> node zone with global function name', () => {
+            return napa.zone.node.executeBatch("", "foo", [[1], [2], [3]])
+                .then((results: napa.zone.Result[]) => {
+                    assert.deepEqual(results.map(result => result.value), [1, 2, 3]);
+                });
+        });
+
+        it('@node: -> napa zone with anonymous function', () => {
+            return napaZone1.executeBatch((a: number, b: number) => a + b, [[1, 2], [3, 4]])
+                .then((results: napa.zone.Result[]) => {
+                    assert.deepEqual(results.map(result => result.value), [3, 7]);
+                });
+        });
+
+        it('@node: -> napa zone with empty batch', () => {
+            return napaZone1.executeBatch("", "foo", [])
+                .then((results: napa.zone.Result[]) => {
+                    assert.equal(results.length, 0);
+                });
+        });
+
+        it('@node: -> napa zone with a failing call', () => {
+            return shouldFail(() => {
+                return napaZone1.executeBatch((input: number) => {
+                    if (input === 2) {
+                        throw new Error();
+                    }
+                    return input;
+                }, [[1], [2], [3]]);
+            });
+        });
+    });
+
+    describe('executeStream', () => {
+        function collect(stream: napa.zone.ResultStream, values: any[] = []): Promise<any[]> {
+            return stream.next().then((result: IteratorResult<any>) => {
+                if (result.done) {
+                    return values;
+                }
+                values.push(result.value);
+                return collect(stream, values);
+            });
+        }
+
+        it('@node: -> napa zone streams the values of an iterable', () => {
+            let stream = napaZone1.executeStream((count: number) => {
+                let values: any[] = [];
+                for (let i = 0; i < count; i++) {
+                    values.push({ index: i });
+                }
+                return values;
+            }, [100], { capacity: 4 });
+            return collect(stream).then((values: any[]) => {
+                assert.equal(values.length, 100);
+                assert.deepEqual(values[99], { index: 99 });
+            });
+        });
+
+        it('@node: -> napa zone streams the values of an iterator producing on demand', () => {
+            let stream = napaZone1.executeStream(() => {
+                let next = 0;
+                let iterator: any = {
+                    next: () => next < 3 ? { done: false, value: Promise.resolve(next++) } : { done: true }
+                };
+                iterator[Symbol.iterator] = () => iterator;
+                return iterator;
+            });
+            return collect(stream).then((values: any[]) => {
+                assert.deepEqual(values, [0, 1, 2]);
+            });
+        });
+
+        it('@node: -> node zone streams the values of an iterable', () => {
+            return collect(napa.zone.node.executeStream((a: number, b: number) => [a, b], [1, 2]))
+                .then((values: any[]) => {
+                    assert.deepEqual(values, [1, 2]);
+                });
+        });
+
+        it('@node: -> napa zone stops producing when the caller returns', () => {
+            let stream = napaZone1.executeStream(() => {
+                let iterator: any = { next: () => ({ done: false, value: 'forever' }) };
+                iterator[Symbol.iterator] = () => iterator;
+                return iterator;
+            }, [], { capacity: 1 });
+            return stream.next()
+                .then((result: IteratorResult<any>) => {
+                    assert.deepEqual(result, { done: false, value: 'forever' });
+                    return stream.return();
+                })
+                .then(() => stream.next())
+                .then((result: IteratorResult<any>) => {
+                    assert(result.done);
+                });
+        });
+
+        it('@node: -> napa zone rejects with the failure of the function', () => {
+            return shouldFail(() => collect(napaZone1.executeStream(() => {
+                throw new Error('stream failed');
+            })));
+        });
+
+        it('@node: -> napa zone rejects a function not returning an iterable', () => {
+            return shouldFail(() => collect(napaZone1.executeStream(() => 1)));
+        });
+    });
+
+    describe('elastic workers', () => {
+        let elasticZone: Zone = napa.zone.create('elastic-zone', { workers: 1, minWorkers: 1, maxWorkers: 4 });
+        elasticZone.broadcast('function slowAnswer() { var end = Date.now() + 50; while (Date.now() < end) {} return 42; }');
+
+        it('@node: new workers run earlier broadcasts', () => {
+            let calls: Promise<napa.zone.Result>[] = [];
+            for (let i = 0; i < 16; i++) {
+                calls.push(elasticZone.execute("", "slowAnswer", []));
+            }
+            return Promise.all(calls).then((results: napa.zone.Result[]) => {
+                results.forEach((result: napa.zone.Result) => assert.equal(result.value, 42));
+            });
+        });
+    });
+
+    describe('worker recycling', () => {
+        let recyclingZone: Zone = napa.zone.create('recycling-zone', { workers: 2, maxTasksPerWorker: 2 });
+        recyclingZone.broadcast('var answer = 42; function getAnswer() { return answer; }');
+
+        it('@node: recycled workers keep the broadcast state', () => {
+            let call = () => recyclingZone.execute("", "getAnswer", []);
+            let values: number[] = [];
+            let chain: Promise<void> = Promise.resolve();
+            for (let i = 0; i < 10; i++) {
+                chain = chain.then(call).then((result: napa.zone.Result) => { values.push(result.value); });
+            }
+            return chain.then(() => {
+                assert.equal(values.length, 10);
+                values.forEach((value: number) => assert.equal(value, 42));
+            });
+        });
+    });
+
+    describe('result cache', () => {
+        let cacheZone: Zone = napa.zone.create('cache-zone', { workers: 1 });
+        cacheZone.broadcast('var calls = 0; function countCalls(x) { return ++calls; } function getCalls() { return calls; }');
+
+        it('@node: returns cached results without running the function', () => {
+            let options = { cache: { ttlMs: 60000 } };
+            return cacheZone.execute("", "countCalls", [1], options)
+                .then(() => cacheZone.execute("", "countCalls", [1], options))
+                .then((result: napa.zone.Result) => {
+                    assert.equal(result.value, 1);
+                    return cacheZone.execute("", "countCalls", [2], options);
+                })
+                .then((result: napa.zone.Result) => {
+                    assert.equal(result.value, 2);
+                    return cacheZone.execute("", "getCalls", []);
+                })
+                .then((result: napa.zone.Result) => assert.equal(result.value, 2));
+        });
+
+        it('@node: calls with the same cache key share a result', () => {
+            let options = { cache: { key: 'shared', ttlMs: 60000 } };
+            return cacheZone.execute("", "countCalls", [3], options)
+                .then((first: napa.zone.Result) => cacheZone.execute("", "countCalls", [4], options)
+                    .then((second: napa.zone.Result) => assert.equal(second.value, first.value)));
+        });
+
+        it('@node: identical calls in flight coalesce', () => {
+            let options = { coalesce: true };
+            return Promise.all([
+                    cacheZone.execute("", "countCalls", [5], options),
+                    cacheZone.execute("", "countCalls", [5], options),
+                    cacheZone.execute("", "countCalls", [5], options)])
+                .then((results: napa.zone.Result[]) => {
+                    assert.equal(results[1].value, results[0].value);
+                    assert.equal(results[2].value, results[0].value);
+                });
+        });
+    });
+
+    describe('compression', () => {
+        let compressionZone: Zone = napa.zone.create('compression-zone', { workers: 1 });
+        compressionZone.broadcast('function echo(x) { return x; } function count(x) { return x.length; }');
+
+        let items: any[] = [];
+        for (let i = 0; i < 1000; ++i) {
+            items.push({ id: i, name: 'item' });
+        }
+
+        it('@node: compresses arguments and results over the threshold', () => {
+            return compressionZone.execute("", "echo", [items], { compressionThreshold: 1024 })
+                .then((result: napa.zone.Result) => assert.deepEqual(result.value, items));
+        });
+
+        it('@node: leaves payloads under the threshold as they are', () => {
+            return compressionZone.execute("", "count", [items], { compressionThreshold: 1024 * 1024 })
+                .then((result: napa.zone.Result) => assert.equal(result.value, 1000));
+        });
+
+        it('@node: pipes compressed results into the next stage', () => {
+            return compressionZone.pipe([
+                    { function: 'echo', options: { compressionThreshold: 1024 } },
+                    { function: 'count' }
+                ], [items])
+                .then((result: napa.zone.Result) => assert.equal(result.value, 1000));
+        });
+    });
+
+    describe('pipe', () => {
+        let firstZone: Zone = napa.zone.create('pipe-first-zone', { workers: 1 });
+        let secondZone: Zone = napa.zone.create('pipe-second-zone', { workers: 1 });
+        firstZone.broadcast('function double(x) { return x * 2; } function fail() { throw new Error("failed"); }');
+        secondZone.broadcast('function increment(x) { return x + 1; }');
+
+        it('@node: passes each result to the next stage', () => {
+            return firstZone.pipe([
+                    { function: 'double' },
+                    { zone: secondZone, function: 'increment' },
+                    { function: 'double' }
+                ], [10])
+                .then((result: napa.zone.Result) => assert.equal(result.value, 42));
+        });
+
+        it('@node: runs anonymous functions', () => {
+            return firstZone.pipe([
+                    { function: (x: number) => x * 3 },
+                    { zone: secondZone, function: (x: number) => x + 12 }
+                ], [10])
+                .then((result: napa.zone.Result) => assert.equal(result.value, 42));
+        });
+
+        it('@node: rejects at the first failing stage', () => {
+            return firstZone.pipe([{ function: 'fail' }, { zone: secondZone, function: 'increment' }], [])
+                .then(() => assert.fail('pipeline should fail'), (error: any) => assert(error != null));
+        });
+    });
+
+    describe('createRing', () => {
+        let ringZone: Zone = napa.zone.create('submission-ring-zone', { workers: 2 });
+        ringZone.broadcast('function ringAdd(a, b) { return a + b; } function ringFail(message) { throw new Error(message); }');
+        ringZone.broadcast('function ringSleep(ms) { var end = Date.now() + ms; while (Date.now() < end) {} return ms; }');
+
+        it('@node: returns the results of calls submitted to the ring', () => {
+            let ring = ringZone.createRing('', 'ringAdd', { slots: 4 });
+            let calls: Promise<number>[] = [];
+            for (let i = 0; i < 20; i++) {
+                calls.push(ring.submit(i, 1));
+            }
+            return Promise.all(calls).then((results: number[]) => {
+                assert.deepEqual(results, calls.map((call, i) => i + 1));
+                assert.equal(ring.pending, 0);
+                return ring.close();
+            }).then((served: number) => {
+                assert.equal(served, 20);
+            });
+        });
+
+        it('@node: rejects calls whose function threw', () => {
+            let ring = ringZone.createRing('', 'ringFail');
+            return ring.submit('ring failure').then(
+                () => assert.fail('call should fail'),
+                (error: Error) => {
+                    assert.equal(error.message, 'ring failure');
+                    return ring.close();
+                });
+        });
+
+        it('@node: serves anonymous functions', () => {
+            let ring = ringZone.createRing((s: string) => s.toUpperCase());
+            return ring.submit('napa').then((result: string) => {
+                assert.equal(result, 'NAPA');
+                return ring.close();
+            });
+        });
+
+        it('@node: rejects arguments larger than a slot', () => {
+            let ring = ringZone.createRing('', 'ringAdd', { slotSize: 16 });
+            return ring.submit('a long string that does not fit', 1).then(
+                () => assert.fail('call should fail'),
+                (error: Error) => {
+                    assert(error instanceof RangeError);
+                    return ring.close();
+                });
+        });
+
+        it('@node: rejects calls after the ring is closed', () => {
+            let ring = ringZone.createRing('', 'ringAdd');
+            return ring.close().then(() => ring.submit(1, 2)).then(
+                () => assert.fail('call should fail'),
+                (error: Error) => assert(/closed/.test(error.message)));
+        });
+
+        it('@node: backs off polling for a long call without Atomics.waitAsync', () => {
+            let atomics: any = (<any>global).Atomics;
+            let waitAsync = atomics.waitAsync;
+            let setImmediateFunction = global.setImmediate;
+            let setTimeoutFunction = global.setTimeout;
+            let polls = 0;
+
+            // The ring reads the timer functions from the global object when it polls.
+            delete atomics.waitAsync;
+            (<any>global).setImmediate = (...args: any[]) => { ++polls; return (<any>setImmediateFunction)(...args); };
+            (<any>global).setTimeout = (...args: any[]) => { ++polls; return (<any>setTimeoutFunction)(...args); };
+            let restore = () => {
+                if (waitAsync !== undefined) {
+                    atomics.waitAsync = waitAsync;
+                }
+                global.setImmediate = setImmediateFunction;
+                global.setTimeout = setTimeoutFunction;
+            };
+
+            let ring = ringZone.createRing('', 'ringSleep');
+            return ring.submit(500).then((result: number) => {
+                restore();
+                assert.equal(result, 500);
+
+                // 8 turns, then timers of 1, 2, 4 and 8ms, then every 16ms: about 40 polls, not one per turn.
+                assert(polls < 100, `polled ${polls} times`);
+                return ring.close();
+            }, (error: any) => {
+                restore();
+                throw error;
+            });
+        });
+    });
+
+    describe('createStream', () => {
+        let streamZone: Zone = napa.zone.create('input-stream-zone', { workers: 2 });
+        streamZone.broadcast('function slowSquare(x) { var end = Date.now() + (x % 3) * 5; while (Date.now() < end) {} return x * x; }');
+
+        function collect(stream: napa.zone.InputStream, values: any[] = []): Promise<any[]> {
+            return stream.next().then((result: IteratorResult<any>) => {
+                if (result.done) {
+                    return values;
+                }
+                values.push(result.value);
+                return collect(stream, values);
+            });
+        }
+
+        function writeAll(stream: napa.zone.InputStream, items: number[]): Promise<void> {
+            return items.reduce((previous: Promise<void>, item: number) => previous.then(() => stream.write(item)), Promise.resolve())
+                .then(() => stream.end());
+        }
+
+        it('@node: yields results in the order of the items', () => {
+            let stream = streamZone.createStream('', 'slowSquare', { concurrency: 2, capacity: 2 });
+            let items = [0, 1, 2, 3, 4, 5, 6, 7, 8, 9];
+            let written = writeAll(stream, items);
+            return Promise.all([written, collect(stream)]).then((results: any[]) => {
+                assert.deepEqual(results[1], items.map(x => x * x));
+            });
+        });
+
+        it('@node: yields results as they complete when not ordered', () => {
+            let stream = streamZone.createStream((x: number) => x + 1, { ordered: false });
+            let written = writeAll(stream, [1, 2, 3, 4]);
+            return Promise.all([written, collect(stream)]).then((results: any[]) => {
+                assert.deepEqual(results[1].sort(), [2, 3, 4, 5]);
+            });
+        });
+
+        it('@node: holds writes while the results are not read', () => {
+            let stream = streamZone.createStream((x: number) => x, { concurrency: 1, capacity: 1 });
+            let admitted = 0;
+            for (let i = 0; i < 4; i++) {
+                stream.write(i).then(() => admitted++, () => {});
+            }
+            return new Promise((resolve) => setTimeout(resolve, 50)).then(() => {
+                assert(admitted <= 2);
+                stream.end();
+                return collect(stream);
+            }).then((values: any[]) => {
+                assert.deepEqual(values, [0, 1, 2, 3]);
+            });
+        });
+
+        it('@node: rejects reads when an item fails', () => {
+            let stream = streamZone.createStream((x: number) => { if (x === 2) { throw new Error('bad item'); } return x; });
+            writeAll(stream, [1, 2, 3]).catch(() => {});
+            return collect(stream).then(() => assert.fail('stream should fail'), (error: any) => assert(error != null));
+        });
+    });
+
+    describe('graph', () => {
+        let graphZone: Zone = napa.zone.create('graph-zone', { workers: 2 });
+        let otherZone: Zone = napa.zone.create('graph-other-zone', { workers: 1 });
+        graphZone.broadcast('function square(x) { return x * x; } function sum() { var s = 0; for (var i = 0; i < arguments.length; i++) { s += arguments[i]; } return s; } function fail() { throw new Error("failed"); }');
+
+        it('@node: passes results of dependencies after the arguments', () => {
+            return graphZone.graph()
+                .task('a', { function: 'square', args: [3] })
+                .task('b', { function: 'square', args: [4] })
+                .task('c', { zone: otherZone, function: (x: number, y: number) => y - x, args: [], dependsOn: ['a', 'b'] })
+                .task('d', { function: 'sum', args: [100], dependsOn: ['c', 'a'] })
+                .run()
+                .then((results: { [name: string]: napa.zone.Result }) => {
+                    assert.equal(results['a'].value, 9);
+                    assert.equal(results['c'].value, 7);
+                    assert.equal(results['d'].value, 116);
+                });
+        });
+
+        it('@node: rejects when a task fails', () => {
+            return graphZone.graph()
+                .task('a', { function: 'fail' })
+                .task('b', { function: 'square', dependsOn: ['a'] })
+                .run()
+                .then(() => assert.fail('graph should fail'), (error: any) => assert(error != null));
+        });
+
+        it('@node: rejects unknown dependencies', () => {
+            return graphZone.graph()
+                .task('a', { function: 'square', args: [1], dependsOn: ['missing'] })
+                .run()
+                .then(() => assert.fail('graph should fail'), (error: any) => assert(error != null));
+        });
+
+        it('@node: throws on duplicate task names', () => {
+            assert.throws(() => graphZone.graph().task('a', { function: 'square' }).task('a', { function: 'square' }));
+        });
+    });
+
+    describe('map and reduce', () => {
+        let dataZone: Zone = napa.zone.create('data-parallel-zone', { workers: 2 });
+
+        it('@node: maps elements in order', () => {
+            let items: number[] = [];
+            for (let i = 0; i < 100; i++) {
+                items.push(i);
+            }
+            return dataZone.map(items, (x: number, index: number) => x * 2 + index, { chunkSize: 7 })
+                .then((values: any[]) => {
+                    assert.equal(values.length, 100);
+                    values.forEach((value: number, index: number) => assert.equal(value, index * 3));
+                });
+        });
+
+        it('@node: maps typed arrays', () => {
+            let items = new Int32Array([1, 2, 3, 4, 5]);
+            return dataZone.map(items, (x: number) => x * x)
+                .then((values: any[]) => assert.deepEqual(values, [1, 4, 9, 16, 25]));
+        });
+
+        it('@node: reduces elements', () => {
+            return dataZone.reduce([1, 2, 3, 4, 5], (sum: number, x: number) => sum + x, 10, { chunkSize: 2 })
+                .then((value: number) => assert.equal(value, 25));
+        });
+
+        it('@node: rejects reducing an empty array without an initial value', () => {
+            return dataZone.reduce([], (sum: number, x: number) => sum + x)
+                .then(() => assert.fail('reduce should fail'), (error: any) => assert(error instanceof TypeError));
+        });
+
+        it('@node: runs a kernel over ranges of a shared typed array', () => {
+            let items = new Int32Array(new SharedArrayBuffer(4 * 100));
+            return dataZone.parallelFor(items, (array: Int32Array, begin: number, end: number) => {
+                    for (let i = begin; i < end; i++) {
+                        array[i] = i * 2;
+                    }
+                }, { grain: 9 })
+                .then(() => {
+                    for (let i = 0; i < 100; i++) {
+                        assert.equal(items[i], i * 2);
+                    }
+                });
+        });
+
+        it('@node: parallelFor rejects typed arrays that are not shared', () => {
+            return dataZone.parallelFor(new Int32Array(4), () => {})
+                .then(() => assert.fail('parallelFor should fail'), (error: any) => assert(error instanceof TypeError));
+        });
+
+        it('@node: knows its worker count', () => {
+            assert.equal(dataZone.workerCount, 2);
+            assert.equal(napa.zone.node.workerCount, 1);
+        });
+    });
+
+    describe('bounded queue', () => {
+        let boundedZone: Zone = napa.zone.create('bounded-zone', { workers: 1, maxQueueLength: 2, overloadPolicy: 'reject' });
+        boundedZone.broadcast('function slowAnswer() { var end = Date.now() + 50; while (Date.now() < end) {} return 42; }');
+
+        it('@node: rejects calls when the queue is full', () => {
+            let calls: Promise<any>[] = [];
+            for (let i = 0; i < 8; i++) {
+                calls.push(boundedZone.execute("", "slowAnswer", []).then(
+                    (result: napa.zone.Result) => result.value,
+                    (error: any) => 'rejected'));
+            }
+            assert(boundedZone.queueLength <= 2);
+            return Promise.all(calls).then((values: any[]) => {
+                assert(values.indexOf(42) >= 0);
+                assert(values.indexOf('rejected') >= 0);
+                assert.equal(boundedZone.queueLength, 0);
+            });
+        });
+
+        it('@node: node zone has no queue', () => {
+            assert.equal(napa.zone.node.queueLength, 0);
+        });
+    });
+
+    describe('routing key', () => {
+        let routedZone: Zone = napa.zone.create('routed-zone', { workers: 4 });
+        routedZone.broadcast('var hits = 0; function hit() { return ++hits; }');
+
+        it('@node: calls with the same key run on the same worker', () => {
+            let values: number[] = [];
+            let call = () => routedZone.execute("", "hit", [], { routingKey: 'template-1' })
+                .then((result: napa.zone.Result) => { values.push(result.value); });
+
+            return call().then(call).then(call).then(call).then(() => {
+                assert.deepEqual(values, [1, 2, 3, 4]);
+            });
+        });
+    });
+
+    describe('soft timeout', () => {
+        let softZone: Zone = napa.zone.create('soft-timeout-zone', { workers: 1, timeoutGracePeriod: 5000 });
+
+        it('@node: a call stops at its deadline within the grace period', () => {
+            return shouldFail(() => softZone.execute('./napa-zone/test', 'loopUntilDeadline', [], { timeout: 50 }))
+                .then(() => softZone.execute('./napa-zone/test', 'getStoppedLoops', []))
+                .then((result: napa.zone.Result) => assert.equal(result.value, 1));
+        });
+
+        it('@napa: a nested call made after the deadline of its caller is rejected', () => {
+            return softZone.execute('./napa-zone/test', 'executeAfterDeadline', ['napa-zone2', 100, false], { timeout: 50 })
+                .then((result: napa.zone.Result) => assert.equal(result.value, 'rejected'));
+        });
+
+        it('@napa: a nested call detached from the deadline of its caller runs', () => {
+            return softZone.execute('./napa-zone/test', 'executeAfterDeadline', ['napa-zone2', 100, true], { timeout: 50 })
+                .then((result: napa.zone.Result) => assert.equal(result.value, 'resolved'));
+        });
+    });
+
+    describe('calls in flight', () => {
+        let limitedZone: Zone = napa.zone.create('in-flight-zone', { workers: 1, maxInFlightPerWorker: 1 });
+        limitedZone.broadcast('function delayed(ms) { return new Promise(function (resolve) { setTimeout(function () { resolve(Date.now()); }, ms); }); } function now() { return Date.now(); }');
+
+        it('@node: a worker with too many calls in flight takes new calls once they finish', () => {
+            return Promise.all([
+                    limitedZone.execute("", "delayed", [100]),
+                    limitedZone.execute("", "now", [])])
+                .then((results: napa.zone.Result[]) => {
+                    assert(results[1].value >= results[0].value);
+                });
+        });
+    });
+
+    describe('cancellation', () => {
+        let cancellableZone: Zone = napa.zone.create('cancellable-zone', { workers: 1 });
+        cancellableZone.broadcast('function spin(ms) { var end = Date.now() + ms; while (Date.now() < end) {} return ms; }');
+
+        it('@node: cancels queued and running calls', () => {
+            let token = new napa.zone.CancellationToken();
+            let running = cancellableZone.execute("", "spin", [5000], { cancellationToken: token });
+            let queued = cancellableZone.execute("", "spin", [5000], { cancellationToken: token });
+            let other = cancellableZone.execute("", "spin", [10]);
+
+            setTimeout(() => token.cancel(), 50);
+
+            let start = Date.now();
+            return Promise.all([
+                running.then(() => 'resolved', () => 'rejected'),
+                queued.then(() => 'resolved', () => 'rejected'),
+                other.then((result: napa.zone.Result) => result.value)
+            ]).then((values: any[]) => {
+                assert.deepEqual(values, ['rejected', 'rejected', 10]);
+                assert(Date.now() - start < 2000);
+            });
+        });
+
+        it('@node: rejects calls made with a cancelled token', () => {
+            let token = new napa.zone.CancellationToken();
+            token.cancel();
+            assert(token.cancelled);
+
+            return cancellableZone.execute("", "spin", [10], { cancellationToken: token }).then(
+                () => assert(false, 'call should be rejected'),
+                (error: any) => assert.equal(error, 'The request was cancelled'));
+        });
+    });
+
+    describe('heap statistics', () => {
+        let heapZone: Zone = napa.zone.create('heap-zone', { workers: 2 });
+
+        it('@node: reports the heap of each worker', () => {
+            return heapZone.getHeapStatistics().then((workers: napa.zone.HeapStatistics[]) => {
+                assert.deepEqual(workers.map(worker => worker.workerId), [0, 1]);
+                workers.forEach((worker: napa.zone.HeapStatistics) => {
+                    assert(worker.usedHeapSize > 0);
+                    assert(worker.heapSizeLimit >= worker.totalHeapSize);
+                });
+            });
+        });
+
+        it('@node: node zone reports no workers', () => {
+            return napa.zone.node.getHeapStatistics().then((workers: napa.zone.HeapStatistics[]) => {
+                assert.equal(workers.length, 0);
+            });
+        });
+
+        it('@node: workers keep serving calls after memory pressure', () => {
+            heapZone.notifyMemoryPressure(napa.zone.MemoryPressureLevel.CRITICAL);
+            return heapZone.execute((a: number, b: number) => a + b, [1, 2]).then((result: napa.zone.Result) => {
+                heapZone.notifyMemoryPressure(napa.zone.MemoryPressureLevel.NONE);
+                assert.equal(result.value, 3);
+            });
+        });
+    });
+
+    describe('stats', () => {
+        let statsZone: Zone = napa.zone.create('stats-zone', { workers: 2 });
+
+        it('@node: counts the tasks run by each worker', () => {
+            return Promise.all([1, 2, 3, 4].map(i => statsZone.execute((x: number) => x, [i])))
+                .then(() => {
+                    let stats = statsZone.getStats();
+                    assert.equal(stats.pendingTasks, 0);
+                    assert.deepEqual(stats.workers.map(worker => worker.workerId), [0, 1]);
+
+                    let executed = stats.workers.reduce((sum, worker) => sum + worker.executedTasks, 0);
+                    assert(executed >= 4);
+                    stats.workers.forEach(worker => {
+                        assert(worker.busyTime >= 0 && worker.idleTime >= 0);
+                    });
+                });
+        });
+
+        it('@node: returns no worker for the node zone', () => {
+            assert.equal(napa.zone.node.getStats().workers.length, 0);
+        });
+
+        it('@node: counts the calls and errors of each function', () => {
+            let functionZone: Zone = napa.zone.create('function-stats-zone', { workers: 2 });
+            functionZone.broadcast('function statsEcho(x) { return x; } function statsThrow() { throw new Error("failed"); }');
+            let calls = [1, 2, 3].map(i => functionZone.execute('', 'statsEcho', [i]))
+                .concat([functionZone.execute('', 'statsThrow', []).then(() => assert.fail(), () => undefined)]);
+            return Promise.all(calls).then(() => {
+                let stats = functionZone.getFunctionStats();
+                assert.deepEqual(stats.map(s => s.function), ['statsEcho', 'statsThrow']);
+                assert.equal(stats[0].module, '');
+                assert.equal(stats[0].calls, 3);
+                assert.equal(stats[0].errors, 0);
+                assert.equal(stats[1].calls, 1);
+                assert.equal(stats[1].errors, 1);
+                assert(stats[0].maxTime >= 0 && stats[0].totalTime >= stats[0].maxTime);
+                assert.equal(stats[0].histogram.reduce((sum, bucket) => sum + bucket.count, 0), 3);
+            });
+        });
+
+        it('@node: returns no function stats for the node zone', () => {
+            assert.equal(napa.zone.node.getFunctionStats().length, 0);
+        });
+
+        it('@node: returns no function counters without hardwareCounters', () => {
+            assert.equal(statsZone.getStats().functions.length, 0);
+        });
+
+        it('@node: counts the calls of each function with hardwareCounters', () => {
+            let countersZone: Zone = napa.zone.create('hardware-counters-zone', { workers: 1, hardwareCounters: true });
+            countersZone.broadcast('function countedSum(n) { var sum = 0; for (var i = 0; i < n; i++) { sum += i; } return sum; }');
+            return Promise.all([1000, 2000].map(n => countersZone.execute('', 'countedSum', [n])))
+                .then(() => {
+                    // Machines without hardware counters run the zone without them.
+                    let functions = countersZone.getStats().functions;
+                    if (functions.length > 0) {
+                        let counted = functions.filter(counters => counters.function === 'countedSum')[0];
+                        assert.equal(counted.calls, 2);
+                        assert(counted.instructions > 0 && counted.instructionsPerCycle > 0);
+                    }
+                });
+        });
+    });
+
+    describe('tenants', () => {
+        let tenantZone: Zone = napa.zone.create('tenant-zone', { workers: 1, tenantWeights: { gold: 2 } });
+        tenantZone.broadcast('function slowTenant(tenant) { var end = Date.now() + 20; while (Date.now() < end) {} return tenant; }');
+
+        it('@node: counts the waiting calls of each tenant', () => {
+            let calls: Promise<napa.zone.Result>[] = [];
+            ['free', 'free', 'free', 'gold', 'gold'].forEach((tenant: string) => {
+                calls.push(tenantZone.execute("", "slowTenant", [tenant], { tenant: tenant }));
+            });
+            return Promise.all(calls).then((results: napa.zone.Result[]) => {
+                assert.deepEqual(results.map(result => result.value), ['free', 'free', 'free', 'gold', 'gold']);
+
+                let gold = tenantZone.getStats().tenants.filter(tenant => tenant.tenant === 'gold');
+                assert.equal(gold.length, 1);
+                assert.equal(gold[0].queuedTasks, 0);
+                assert.equal(gold[0].dispatchedTasks, 2);
+                assert(gold[0].maxWaitTime <= gold[0].waitTime);
+            });
+        });
+    });
+
+    describe('rate limits', () => {
+        let limitedZone: Zone = napa.zone.create('limited-zone', { workers: 1, rateLimit: 100, tenantRateLimits: { '*': 2 } });
+
+        function callAll(count: number, options: napa.zone.CallOptions): Promise<any[]> {
+            let calls: Promise<any>[] = [];
+            for (let i = 0; i < count; i++) {
+                calls.push(limitedZone.execute((x: number) => x, [i], options).then(
+                    (result: napa.zone.Result) => result.value,
+                    (error: any) => 'rejected'));
+            }
+            return Promise.all(calls);
+        }
+
+        it('@node: rejects the calls of a tenant over its rate', () => {
+            return callAll(5, { tenant: 'free' }).then((values: any[]) => {
+                assert.deepEqual(values, [0, 1, 'rejected', 'rejected', 'rejected']);
+            });
+        });
+
+        it('@node: other tenants keep their own rate', () => {
+            return callAll(2, { tenant: 'other' }).then((values: any[]) => {
+                assert.deepEqual(values, [0, 1]);
+            });
+        });
+    });
+
+    describe('batched microtasks', () => {
+        let batchedZone: Zone = napa.zone.create('batched-microtask-zone', { workers: 1, microtaskPolicy: 'batched', microtaskBatchSize: 16 });
+
+        it('@node: calls returning promises complete with batched microtasks', () => {
+            let calls: Promise<napa.zone.Result>[] = [];
+            for (let i = 0; i < 40; i++) {
+                calls.push(batchedZone.execute((x: number) => Promise.resolve(x).then((y: number) => y * 2), [i]));
+            }
+            return Promise.all(calls).then((results: napa.zone.Result[]) => {
+                results.forEach((result: napa.zone.Result, i: number) => assert.strictEqual(result.value, i * 2));
+            });
+        });
+    });
+
+    describe('lazy arguments', () => {
+        it('@node: functions marked by lazyArgs get the payloads of their arguments', () => {
+            return napaZone1.execute('./napa-zone/test', 'forwardLazyArgs', [{ a: [1, 2] }, { x: 'y' }])
+                .then((result: napa.zone.Result) => {
+                    assert.deepEqual(JSON.parse(result.value.forwarded), { a: [1, 2] });
+                    assert.strictEqual(result.value.x, 'y');
+                    assert.strictEqual(result.value.cached, true);
+                });
+        });
+    });
+
+    describe('tenant contexts', () => {
+        let contextZone: Zone = napa.zone.create('tenant-context-zone', { workers: 1, tenantContexts: 2 });
+
+        function setThenGet(tenant: string, value: string): Promise<any> {
+            return contextZone.execute('./napa-zone/test', 'setTenantGlobal', [value], { tenant: tenant })
+                .then(() => contextZone.execute('./napa-zone/test', 'getTenantGlobal', [], { tenant: tenant }))
+                .then((result: napa.zone.Result) => result.value);
+        }
+
+        it('@node: calls of a tenant see the globals of the tenant only', () => {
+            return setThenGet('tenant-a', 'a').then((value: any) => {
+                assert.strictEqual(value, 'a');
+                return setThenGet('tenant-b', 'b');
+            }).then((value: any) => {
+                assert.strictEqual(value, 'b');
+                return contextZone.execute('./napa-zone/test', 'getTenantGlobal', [], { tenant: 'tenant-a' });
+            }).then((result: napa.zone.Result) => {
+                assert.strictEqual(result.value, 'a');
+                return contextZone.execute('./napa-zone/test', 'getTenantGlobal', []);
+            }).then((result: napa.zone.Result) => {
+                assert.strictEqual(result.value, undefined);
+            });
+        });
+
+        it('@node: tenants past the limit share the context of the worker', () => {
+            return setThenGet('tenant-c', 'c').then((value: any) => {
+                assert.strictEqual(value, 'c');
+                return contextZone.execute('./napa-zone/test', 'getTenantGlobal', []);
+            }).then((result: napa.zone.Result) => {
+                assert.strictEqual(result.value, 'c');
+            });
+        });
+    });
+
+    describe('preload', () => {
+        it('@node: workers load the preloaded modules before the zone is created', () => {
+            let preloadZone = napa.zone.create('preload-zone', {
+                workers: 2,
+                preload: ['./napa-zone/test', 'a-module-that-does-not-exist']
+            });
+            let created = Date.now();
+            return preloadZone.execute('./napa-zone/test', 'getLoadTime').then((result: napa.zone.Result) => {
+                assert(result.value <= created);
+            });
+        });
+    });
+
+    describe('warm-up', () => {
+        let samplesFile = path.join(__dirname, 'warmup-samples.txt');
+        let recordFile = path.join(__dirname, 'warmup-record.txt');
+
+        it('@node: workers call the warm-up function with each sample before serving calls', () => {
+            fs.writeFileSync(samplesFile, '["1","{\\"x\\":2}"]\n["3","{\\"x\\":4}"]\n');
+            let warmZone = napa.zone.create('warmup-zone', {
+                workers: 1,
+                warmupModule: './napa-zone/test',
+                warmupFunction: 'warmUp',
+                warmupSamples: samplesFile,
+                warmupIterations: 3
+            });
+            return warmZone.execute('./napa-zone/test', 'getWarmupCalls').then((result: napa.zone.Result) => {
+                assert.deepEqual(result.value, { calls: 6, total: 30 });
+            });
+        });
+
+        it('@node: records the arguments of calls as samples', () => {
+            let recordZone = napa.zone.create('warmup-record-zone', {
+                workers: 1,
+                warmupModule: './napa-zone/test',
+                warmupFunction: 'warmUp',
+                warmupRecord: recordFile
+            });
+            return Promise.all([
+                recordZone.execute('./napa-zone/test', 'warmUp', [1, { x: 2 }]),
+                recordZone.execute('./napa-zone/test', 'bar', [0])
+            ]).then(() => {
+                let samples = fs.readFileSync(recordFile).toString().split('\n').filter((line: string) => line.length > 0);
+                assert.deepEqual(samples.map((line: string) => JSON.parse(line)), [['1', '{"x":2}']]);
+            });
+        });
+    });
+
+    describe('cpu profiling', () => {
+        let profiledZone: Zone = napa.zone.create('profiled-zone', { workers: 2 });
+        profiledZone.broadcast('function spin(ms) { var end = Date.now() + ms; while (Date.now() < end) {} return ms; }');
+
+        it('@node: returns the profiles of the selected workers', () => {
+            profiledZone.startProfiling([1], 100);
+            return profiledZone.execute("", "spin", [50]).then(() => profiledZone.stopProfiling())
+                .then((profiles: napa.zone.CpuProfile[]) => {
+                    assert.deepEqual(profiles.map(profile => profile.workerId), [1]);
+
+                    let profile = JSON.parse(profiles[0].profile);
+                    assert(profile.nodes.length > 0);
+                    assert.equal(profile.samples.length, profile.timeDeltas.length);
+                    assert(profile.endTime >= profile.startTime);
+                });
+        });
+
+        it('@node: returns no profile when no worker is profiling', () => {
+            return profiledZone.stopProfiling().then((profiles: napa.zone.CpuProfile[]) => {
+                assert.equal(profiles.length, 0);
+            });
+        });
+    });
+
+    describe('tracing', () => {
+        let tracedZone: Zone = napa.zone.create('traced-zone', { workers: 2 });
+
+        it('@node: records scheduling and tasks of the zone', () => {
+            napa.runtime.startTrace();
+            return Promise.all([1, 2, 3, 4].map(i => tracedZone.execute((x: number) => x, [i])))
+                .then(() => {
+                    let trace = JSON.parse(napa.runtime.stopTrace());
+                    let names = trace.traceEvents.map((event: any) => event.name);
+                    assert(names.indexOf('Enqueue') >= 0);
+                    assert(names.indexOf('Dispatch') >= 0);
+                    assert(names.indexOf('Task') >= 0);
+                    assert.equal(trace.otherData.droppedEvents, 0);
+                });
+        });
+
+        it('@node: fails to stop when no trace is recorded', () => {
+            assert.throws(() => napa.runtime.stopTrace());
+        });
+
+        it('@node: nested calls continue the trace of their caller', () => {
+            napa.runtime.setSpanSampling(1);
+            napa.runtime.exportSpans();
+            return tracedZone.execute('./napa-zone/test', 'executeTraced', ['napa-zone1'])
+                .then((result: napa.zone.Result) => {
+                    napa.runtime.setSpanSampling(0);
+                    let outer = result.value.outer;
+                    let inner = result.value.inner;
+                    assert(outer.sampled);
+                    assert.equal(inner.traceId, outer.traceId);
+                    assert.notEqual(inner.spanId, outer.spanId);
+                    assert(inner.sampled);
+
+                    let spans = napa.runtime.exportSpans();
+                    let outerSpan = spans.filter(span => span.spanId === outer.spanId)[0];
+                    let innerSpan = spans.filter(span => span.spanId === inner.spanId)[0];
+                    assert.equal(outerSpan.target, 'traced-zone');
+                    assert(/\.executeTraced$/.test(outerSpan.name));
+                    assert.equal(outerSpan.parentSpanId, undefined);
+                    assert.equal(innerSpan.target, 'napa-zone1');
+                    assert.equal(innerSpan.kind, 'call');
+                    assert.equal(innerSpan.parentSpanId, outer.spanId);
+                    assert.equal(innerSpan.code, 0);
+                    assert(innerSpan.timing.execute > 0);
+                });
+        });
+
+        it('@node: calls continue the trace of their options', () => {
+            let trace = { traceId: '00000000000000ab', spanId: '0000000000000001', sampled: false };
+            return tracedZone.execute('./napa-zone/test', 'getTraceContext', [], { trace: trace })
+                .then((result: napa.zone.Result) => {
+                    assert.equal(result.value.traceId, trace.traceId);
+                    assert(!result.value.sampled);
+                    assert.equal(result.timing, undefined);
+                });
+        });
+
+        it('@node: unsampled calls record no spans', () => {
+            napa.runtime.exportSpans();
+            return tracedZone.execute('./napa-zone/test', 'getTraceContext', [])
+                .then((result: napa.zone.Result) => {
+                    assert.equal(result.value.traceId.length, 16);
+                    assert(!result.value.sampled);
+                    assert.equal(napa.runtime.exportSpans().length, 0);
+                });
+        });
+    });
+
+    describe('recycle', () => {
+        it('@node: rejects calls after the zone is recycled, and its id can be reused', () => {
+            let zone: Zone = napa.zone.create('recycled-zone', { workers: 2 });
+            return zone.execute((x: number) => x, [1])
+                .then(() => zone.recycle())
+                .then(() => zone.execute((x: number) => x, [2]))
+                .then(() => {
+                    assert.fail('Calls of a recycled zone should be rejected');
+                }, (error: any) => {
+                    assert(/recycled/.test(error.message));
+                    assert.throws(() => napa.zone.get('recycled-zone'));
+
+                    let recreated: Zone = napa.zone.create('recycled-zone', { workers: 1 });
+                    return recreated.execute((x: number) => x, [3]);
+                })
+                .then((result: napa.zone.Result) => {
+                    assert.equal(result.value, 3);
+                });
+        });
+
+        it('@node: recycling the node zone fails', () => {
+            return napa.zone.node.recycle().then(() => {
+                assert.fail('The node zone should not be recyclable');
+            }, (error: any) => {
+                assert(error instanceof Error);
+            });
+        });
+    });
+
+    describe('zone group', () => {
+        let zoneGroup = napa.zone.createGroup('zone-group', [{ workers: 1 }, { workers: 2 }]);
+
+        it('@node: presents its members as one zone', () => {
+            assert.deepEqual(zoneGroup.members.map((member: Zone) => member.id), ['zone-group.0', 'zone-group.1']);
+            assert.equal(zoneGroup.workerCount, 3);
+            assert.equal(zoneGroup.getStats().workers.map((worker: napa.zone.WorkerStats) => worker.workerId).join(','), '0,1,2');
+        });
+
+        it('@node: broadcasts to all members and spreads calls over them', () => {
+            return zoneGroup.broadcast("function groupName() { return 'zone-group'; }")
+                .then(() => Promise.all([1, 2, 3, 4, 5, 6].map(() => zoneGroup.execute('', 'groupName'))))
+                .then((results: napa.zone.Result[]) => {
+                    assert(results.every((result: napa.zone.Result) => result.value === 'zone-group'));
+                    return Promise.all([1, 2, 3, 4, 5, 6].map(() => zoneGroup.execute('./napa-zone/test', 'getCurrentZone')));
+                })
+                .then((results: napa.zone.Result[]) => {
+                    let members = results.map((result: napa.zone.Result) => result.value.id);
+                    assert(members.indexOf('zone-group.0') >= 0);
+                    assert(members.indexOf('zone-group.1') >= 0);
+                });
+        });
+
+        it('@node: calls with the same routing key go to the same member', () => {
+            let options = { routingKey: 'user-42' };
+            return Promise.all([1, 2, 3, 4].map(() => zoneGroup.execute('./napa-zone/test', 'getCurrentZone', [], options)))
+                .then((results: napa.zone.Result[]) => {
+                    let members = results.map((result: napa.zone.Result) => result.value.id);
+                    assert(members.every((member: string) => member === members[0]));
+                });
+        });
+
+        it('@node: splits batches over members and keeps their order', () => {
+            return zoneGroup.executeBatch((x: number) => x * 2, [[1], [2], [3], [4], [5], [6]])
+                .then((results: napa.zone.Result[]) => {
+                    assert.deepEqual(results.map((result: napa.zone.Result) => result.value), [2, 4, 6, 8, 10, 12]);
+                });
+        });
+
+        it('@node: runs calls on a worker of the group', () => {
+            return zoneGroup.executeOnWorker(2, './napa-zone/test', 'getCurrentZone')
+                .then((result: napa.zone.Result) => {
+                    assert.equal(result.value.id, 'zone-group.1');
+                });
+        });
+    });
+
+    describe('remote zone', () => {
+        let served: Zone = napa.zone.create('served-zone', { workers: 2 });
+        let port = napa.zone.serve(served, '127.0.0.1:0');
+        let remote: Zone = napa.zone.connect(`127.0.0.1:${port}`, 2);
+
+        it('@node: has the id and workers of the served zone', () => {
+            assert.equal(remote.id, 'served-zone');
+            assert.equal(remote.workerCount, 2);
+        });
+
+        it('@node: executes module functions on the served zone', () => {
+            return Promise.all([1, 2, 3, 4].map(() => remote.execute('./napa-zone/test', 'getCurrentZone')))
+                .then((results: napa.zone.Result[]) => {
+                    assert(results.every((result: napa.zone.Result) => result.value.id === 'served-zone'));
+                });
+        });
+
+        it('@node: broadcasts source code to the served zone', () => {
+            return remote.broadcast("function servedName() { return 'served'; }")
+                .then(() => remote.execute('', 'servedName'))
+                .then((result: napa.zone.Result) => {
+                    assert.equal(result.value, 'served');
+                });
+        });
+
+        it('@node: fails calls once the zone is no longer served', () => {
+            napa.zone.stopServing(port);
+            return remote.execute('./napa-zone/test', 'getCurrentZone').then(() => {
+                assert.fail('Calls of a zone no longer served should fail');
+            }, (error: any) => {
+                assert(/connection/.test(error.message));
+            });
+        });
+    });
+
+    describe('remote zone on shared memory', () => {
+        let name = `zone-test-${process.pid}`;
+        let served: Zone = napa.zone.create('shared-memory-served-zone', { workers: 2 });
+        napa.zone.serveSharedMemory(served, name);
+        let remote: Zone = napa.zone.connectSharedMemory(name, 2);
+
+        it('@node: has the id and workers of the served zone', () => {
+            assert.equal(remote.id, 'shared-memory-served-zone');
+            assert.equal(remote.workerCount, 2);
+        });
+
+        it('@node: executes module functions on the served zone', () => {
+            return Promise.all([1, 2, 3, 4].map(() => remote.execute('./napa-zone/test', 'getCurrentZone')))
+                .then((results: napa.zone.Result[]) => {
+                    assert(results.every((result: napa.zone.Result) => result.value.id === 'shared-memory-served-zone'));
+                });
+        });
+
+        it('@node: fails to serve a name twice', () => {
+            assert.throws(() => napa.zone.serveSharedMemory(served, name));
+        });
+
+        it('@node: fails calls once the zone is no longer served', () => {
+            napa.zone.stopServingSharedMemory(name);
+            assert.throws(() => napa.zone.connectSharedMemory(name));
+            return remote.execute('./napa-zone/test', 'getCurrentZone').then(() => {
+                assert.fail('Calls of a zone no longer served should fail');
+            }, (error: any) => {
+                assert(/connection/.test(error.message));
+            });
+        });
     });
-});
\ No newline at end of file
+});
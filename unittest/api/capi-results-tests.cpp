@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <api/capi-results.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+using namespace napa;
+
+namespace {
+
+    std::string ToString(napa_string_ref ref) {
+        return std::string(ref.data, ref.size);
+    }
+
+    Result MakeResult(ResultCode code, std::string errorMessage, std::string returnValue) {
+        Result result;
+        result.code = code;
+        result.errorMessage = std::move(errorMessage);
+        result.returnValue = std::move(returnValue);
+        result.transportContext = std::make_unique<transport::TransportContext>();
+        return result;
+    }
+}
+
+TEST_CASE("C API results reference the strings of the result by default", "[capi-results]") {
+    auto result = MakeResult(NAPA_RESULT_SUCCESS, "", "{\"value\":1}");
+    auto transportContext = result.transportContext.get();
+
+    auto res = api::ToZoneResult(result);
+    REQUIRE(res.code == NAPA_RESULT_SUCCESS);
+    REQUIRE(res.return_value.data == result.returnValue.data());
+    REQUIRE(ToString(res.return_value) == "{\"value\":1}");
+    REQUIRE(res.error_message.size == 0);
+
+    // The transport context is handed over to the caller.
+    REQUIRE(res.transport_context == transportContext);
+    REQUIRE(result.transportContext == nullptr);
+    delete reinterpret_cast<transport::TransportContext*>(res.transport_context);
+}
+
+TEST_CASE("C API results are written into a buffer of the caller", "[capi-results]") {
+    auto result = MakeResult(NAPA_RESULT_SUCCESS, "", "{\"value\":1}");
+    char buffer[32];
+
+    SECTION("A return value that fits is copied") {
+        auto res = api::ToBufferedResult(result, buffer, sizeof(buffer));
+        REQUIRE(res.code == NAPA_RESULT_SUCCESS);
+        REQUIRE(res.return_value.data == buffer);
+        REQUIRE(ToString(res.return_value) == "{\"value\":1}");
+        delete reinterpret_cast<transport::TransportContext*>(res.transport_context);
+    }
+
+    SECTION("A return value that fits exactly is copied") {
+        auto res = api::ToBufferedResult(result, buffer, result.returnValue.size());
+        REQUIRE(res.code == NAPA_RESULT_SUCCESS);
+        REQUIRE(ToString(res.return_value) == "{\"value\":1}");
+        delete reinterpret_cast<transport::TransportContext*>(res.transport_context);
+    }
+
+    SECTION("A buffer too small returns the size needed") {
+        std::memset(buffer, 0, sizeof(buffer));
+        auto res = api::ToBufferedResult(result, buffer, 4);
+        REQUIRE(res.code == NAPA_RESULT_RESULT_BUFFER_TOO_SMALL);
+        REQUIRE(res.return_value.data == nullptr);
+        REQUIRE(res.return_value.size == result.returnValue.size());
+        REQUIRE(buffer[0] == '\0');
+        delete reinterpret_cast<transport::TransportContext*>(res.transport_context);
+    }
+
+    SECTION("An error keeps its code and message") {
+        auto error = MakeResult(NAPA_RESULT_TIMEOUT, "Timed out", "");
+        auto res = api::ToBufferedResult(error, nullptr, 0);
+        REQUIRE(res.code == NAPA_RESULT_TIMEOUT);
+        REQUIRE(ToString(res.error_message) == "Timed out");
+        REQUIRE(res.return_value.size == 0);
+        delete reinterpret_cast<transport::TransportContext*>(res.transport_context);
+    }
+}
+
+TEST_CASE("C API retained results keep their strings until the last release", "[capi-results]") {
+    // Long enough not to be stored in the string itself, which a move would copy.
+    auto result = MakeResult(NAPA_RESULT_SUCCESS, "", "{\"value\":\"a retained return value\"}");
+    auto returnValue = result.returnValue.data();
+
+    napa_result_buffer_handle buffer = nullptr;
+    auto res = api::ToRetainedResult(result, buffer);
+    delete reinterpret_cast<transport::TransportContext*>(res.transport_context);
+    REQUIRE(buffer != nullptr);
+    REQUIRE(buffer->references == 1);
+    REQUIRE(res.code == NAPA_RESULT_SUCCESS);
+
+    // The strings are moved, not copied, and outlive the result.
+    REQUIRE(res.return_value.data == returnValue);
+    result = Result();
+    REQUIRE(ToString(res.return_value) == "{\"value\":\"a retained return value\"}");
+
+    api::RetainResultBuffer(buffer);
+    REQUIRE(buffer->references == 2);
+
+    api::ReleaseResultBuffer(buffer);
+    REQUIRE(buffer->references == 1);
+    REQUIRE(ToString(res.return_value) == "{\"value\":\"a retained return value\"}");
+
+    api::ReleaseResultBuffer(buffer);
+
+    // Releasing null does nothing.
+    api::ReleaseResultBuffer(nullptr);
+}
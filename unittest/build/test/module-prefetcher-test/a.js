@@ -0,0 +1 @@
+var b = require('./b'); var main = require('./main'); module.exports = b;
\ No newline at end of file
@@ -0,0 +1 @@
+module.exports = 'b';
\ No newline at end of file
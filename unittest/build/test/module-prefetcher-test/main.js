@@ -0,0 +1 @@
+var fs = require('fs'); var a = require('./a'); require('./missing');
\ No newline at end of file
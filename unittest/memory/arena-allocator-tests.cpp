@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <memory/arena-allocator.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+using namespace napa::memory;
+
+namespace {
+    /// <summary> Counts the chunks an arena holds from it. </summary>
+    class CountingAllocator : public Allocator {
+    public:
+        void* Allocate(size_t size) override {
+            ++allocations;
+            ++outstanding;
+            return std::malloc(size);
+        }
+
+        void Deallocate(void* memory, size_t) override {
+            --outstanding;
+            std::free(memory);
+        }
+
+        const char* GetType() const override {
+            return "CountingAllocator";
+        }
+
+        bool operator==(const Allocator& other) const override {
+            return &other == this;
+        }
+
+        size_t allocations = 0;
+        size_t outstanding = 0;
+    };
+}
+
+TEST_CASE("arena allocator bumps aligned allocations within a chunk", "[arena-allocator]") {
+    CountingAllocator backing;
+    ArenaAllocator arena(backing, 4096);
+
+    auto first = static_cast<char*>(arena.Allocate(1));
+    auto second = static_cast<char*>(arena.Allocate(24));
+    auto third = static_cast<char*>(arena.Allocate(0));
+
+    REQUIRE(reinterpret_cast<uintptr_t>(first) % 16 == 0);
+    REQUIRE(second == first + 16);
+    REQUIRE(third == second + 32);
+    REQUIRE(arena.GetAllocatedSize() == 64);
+    REQUIRE(backing.allocations == 1);
+
+    arena.Deallocate(second, 24);
+    REQUIRE(arena.Allocate(16) == third + 16);
+}
+
+TEST_CASE("arena allocator gives large allocations a chunk of their own", "[arena-allocator]") {
+    CountingAllocator backing;
+    ArenaAllocator arena(backing, 4096);
+
+    auto small = static_cast<char*>(arena.Allocate(16));
+    auto large = static_cast<char*>(arena.Allocate(10000));
+    std::memset(large, 1, 10000);
+    REQUIRE(backing.allocations == 2);
+
+    // The regular chunk keeps serving small allocations.
+    REQUIRE(arena.Allocate(16) == small + 16);
+    REQUIRE(backing.allocations == 2);
+}
+
+TEST_CASE("arena allocator reset keeps one chunk for the next round", "[arena-allocator]") {
+    CountingAllocator backing;
+    ArenaAllocator arena(backing, 1024);
+
+    auto first = arena.Allocate(256);
+    for (int i = 0; i < 20; ++i) {
+        arena.Allocate(256);
+    }
+    arena.Allocate(5000);
+    REQUIRE(backing.outstanding > 2);
+
+    arena.Reset();
+    REQUIRE(backing.outstanding == 1);
+    REQUIRE(arena.GetAllocatedSize() == 0);
+    REQUIRE(arena.Allocate(256) == first);
+
+    arena.Reset();
+    REQUIRE(backing.outstanding == 1);
+}
+
+TEST_CASE("arena allocator returns all chunks on destruction", "[arena-allocator]") {
+    CountingAllocator backing;
+    {
+        ArenaAllocator arena(backing, 1024);
+        for (int i = 0; i < 10; ++i) {
+            arena.Allocate(500);
+        }
+        arena.Allocate(100000);
+    }
+    REQUIRE(backing.outstanding == 0);
+}
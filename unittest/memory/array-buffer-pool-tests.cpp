@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <memory/array-buffer-pool.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace napa::memory;
+
+namespace {
+    bool IsZeroed(const void* data, size_t length) {
+        auto bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < length; ++i) {
+            if (bytes[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE("array buffer pool block sizes cover lengths", "[array-buffer-pool]") {
+    ArrayBufferPool pool(ArrayBufferPoolOptions{});
+
+    REQUIRE(pool.GetBlockSize(0) == 0);
+    REQUIRE(pool.GetBlockSize(ArrayBufferPool::MIN_POOLED_LENGTH - 1) == 0);
+    REQUIRE(pool.GetBlockSize(ArrayBufferPool::MIN_POOLED_LENGTH) == 32 * 1024);
+    REQUIRE(pool.GetBlockSize(32 * 1024 + 1) == 40 * 1024);
+    REQUIRE(pool.GetBlockSize(64 * 1024) == 64 * 1024);
+    REQUIRE(pool.GetBlockSize(100 * 1024) == 112 * 1024);
+    REQUIRE(pool.GetBlockSize(3 * 1024 * 1024) == 3 * 1024 * 1024);
+    REQUIRE(pool.GetBlockSize(ArrayBufferPool::MAX_POOLED_LENGTH) == ArrayBufferPool::MAX_POOLED_LENGTH);
+
+    for (size_t length = ArrayBufferPool::MIN_POOLED_LENGTH; length <= ArrayBufferPool::MAX_POOLED_LENGTH; length += 4093) {
+        auto blockSize = pool.GetBlockSize(length);
+        REQUIRE(blockSize >= length);
+        REQUIRE(blockSize < length + length / 4 + 1);
+    }
+}
+
+TEST_CASE("array buffer pool rounds large blocks to huge pages", "[array-buffer-pool]") {
+    ArrayBufferPoolOptions options;
+    options.hugePages = napa::platform::HugePages::Transparent;
+    ArrayBufferPool pool(options);
+
+    REQUIRE(pool.GetBlockSize(1024 * 1024) == 1024 * 1024);
+    REQUIRE(pool.GetBlockSize(2 * 1024 * 1024 + 1) == 4 * 1024 * 1024);
+    REQUIRE(pool.GetBlockSize(5 * 1024 * 1024) == 6 * 1024 * 1024);
+
+    auto data = pool.Allocate(3 * 1024 * 1024, true);
+    REQUIRE(data != nullptr);
+    REQUIRE(reinterpret_cast<uintptr_t>(data) % napa::platform::HUGE_PAGE_SIZE == 0);
+    REQUIRE(IsZeroed(data, 3 * 1024 * 1024));
+    pool.Free(data, 3 * 1024 * 1024);
+}
+
+TEST_CASE("array buffer pool reuses released blocks zero-filled", "[array-buffer-pool]") {
+    ArrayBufferPool pool(ArrayBufferPoolOptions{});
+    const size_t length = 64 * 1024;
+
+    auto data = pool.Allocate(length, true);
+    REQUIRE(data != nullptr);
+    REQUIRE(IsZeroed(data, length));
+    std::memset(data, 0xab, length);
+    pool.Free(data, length);
+
+    auto stats = pool.GetStats();
+    REQUIRE(stats.pooledBlocks == 1);
+    REQUIRE(stats.pooledSize == length);
+    REQUIRE(stats.liveBuffers == 0);
+
+    // A length of the same class gets the same block, cleared again.
+    auto reused = pool.Allocate(length - 100, true);
+    REQUIRE(reused == data);
+    REQUIRE(IsZeroed(reused, length - 100));
+
+    stats = pool.GetStats();
+    REQUIRE(stats.allocations == 2);
+    REQUIRE(stats.poolHits == 1);
+    REQUIRE(stats.mappedBlocks == 1);
+    REQUIRE(stats.liveBuffers == 1);
+    REQUIRE(stats.liveSize == length - 100);
+    REQUIRE(stats.pooledBlocks == 0);
+    pool.Free(reused, length - 100);
+}
+
+TEST_CASE("array buffer pool serves short and long buffers outside the pools", "[array-buffer-pool]") {
+    ArrayBufferPool pool(ArrayBufferPoolOptions{});
+
+    for (size_t length : { size_t(0), size_t(100), size_t(16 * 1024), ArrayBufferPool::MAX_POOLED_LENGTH + 1 }) {
+        auto data = pool.Allocate(length, true);
+        REQUIRE(data != nullptr);
+        REQUIRE(IsZeroed(data, length));
+        pool.Free(data, length);
+    }
+
+    auto stats = pool.GetStats();
+    REQUIRE(stats.allocations == 4);
+    REQUIRE(stats.mappedBlocks == 1);
+    REQUIRE(stats.pooledBlocks == 0);
+    REQUIRE(stats.liveBuffers == 0);
+}
+
+TEST_CASE("array buffer pool keeps at most the max pooled size", "[array-buffer-pool]") {
+    ArrayBufferPoolOptions options;
+    options.maxPooledSize = 256 * 1024;
+    ArrayBufferPool pool(options);
+
+    std::vector<void*> buffers;
+    for (int i = 0; i < 8; ++i) {
+        buffers.push_back(pool.Allocate(64 * 1024, false));
+    }
+    for (auto data : buffers) {
+        pool.Free(data, 64 * 1024);
+    }
+
+    auto stats = pool.GetStats();
+    REQUIRE(stats.pooledBlocks == 4);
+    REQUIRE(stats.pooledSize == 256 * 1024);
+
+    pool.Trim();
+    stats = pool.GetStats();
+    REQUIRE(stats.pooledBlocks == 0);
+    REQUIRE(stats.pooledSize == 0);
+}
+
+TEST_CASE("array buffer pool is shared across threads", "[array-buffer-pool]") {
+    ArrayBufferPool pool(ArrayBufferPoolOptions{});
+
+    std::atomic<bool> dirty(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool, &dirty, t]() {
+            for (int i = 0; i < 200; ++i) {
+                size_t length = 32 * 1024 + ((i * 7 + t) % 16) * 16 * 1024;
+                auto data = static_cast<uint8_t*>(pool.Allocate(length, true));
+                if (data[0] != 0 || data[length - 1] != 0) {
+                    dirty = true;
+                }
+                data[0] = data[length - 1] = 0xcd;
+                pool.Free(data, length);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(!dirty);
+
+    auto stats = pool.GetStats();
+    REQUIRE(stats.allocations == 800);
+    REQUIRE(stats.liveBuffers == 0);
+    REQUIRE(stats.liveSize == 0);
+    REQUIRE(stats.poolHits + stats.mappedBlocks == 800);
+}
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <memory/array-buffer-pool.h>
+#include <memory/malloc-library.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace napa::memory;
+
+namespace {
+    size_t _allocations = 0;
+    size_t _deallocations = 0;
+
+    void* CountingAllocate(size_t size) {
+        _allocations++;
+        return std::malloc(size);
+    }
+
+    void* CountingAllocateZeroed(size_t size) {
+        _allocations++;
+        return std::calloc(1, size);
+    }
+
+    void CountingDeallocate(void* memory, size_t /*sizeHint*/) {
+        _deallocations++;
+        std::free(memory);
+    }
+
+    void GetCountingStats(MallocLibraryStats& stats) {
+        stats.allocatedSize = _allocations - _deallocations;
+    }
+
+    const MallocLibrary _countingLibrary = {
+        "counting", CountingAllocate, CountingAllocateZeroed, CountingDeallocate, GetCountingStats
+    };
+}
+
+TEST_CASE("malloc libraries load by name only", "[malloc-library]") {
+    REQUIRE(LoadMallocLibrary("tcmalloc") == nullptr);
+
+    SECTION("known libraries serve memory when they are found") {
+        for (auto name : { "mimalloc", "jemalloc" }) {
+            auto library = LoadMallocLibrary(name);
+            if (library == nullptr) {
+                continue;
+            }
+            REQUIRE(std::string(library->name) == name);
+
+            auto memory = library->allocateZeroed(64);
+            REQUIRE(memory != nullptr);
+            REQUIRE(static_cast<char*>(memory)[63] == 0);
+            library->deallocate(memory, 64);
+        }
+    }
+}
+
+TEST_CASE("malloc library stats report the library in use", "[malloc-library]") {
+    REQUIRE(GetMallocLibrary() == nullptr);
+    REQUIRE(std::string(GetMallocLibraryStats().name).empty());
+
+    SetMallocLibrary(&_countingLibrary);
+    auto memory = _countingLibrary.allocate(16);
+    auto stats = GetMallocLibraryStats();
+    _countingLibrary.deallocate(memory, 16);
+    SetMallocLibrary(nullptr);
+
+    REQUIRE(std::string(stats.name) == "counting");
+    REQUIRE(stats.allocatedSize == 1);
+    REQUIRE(stats.residentSize == 0);
+}
+
+TEST_CASE("array buffer pool takes short buffers from the malloc library", "[malloc-library]") {
+    ArrayBufferPoolOptions options;
+    options.mallocLibrary = &_countingLibrary;
+    ArrayBufferPool pool(options);
+
+    auto allocations = _allocations;
+    auto deallocations = _deallocations;
+
+    auto shortBuffer = pool.Allocate(100, true);
+    REQUIRE(shortBuffer != nullptr);
+    REQUIRE(static_cast<char*>(shortBuffer)[99] == 0);
+    pool.Free(shortBuffer, 100);
+    REQUIRE(_allocations == allocations + 1);
+    REQUIRE(_deallocations == deallocations + 1);
+
+    auto longBuffer = pool.Allocate(ArrayBufferPool::MIN_POOLED_LENGTH, false);
+    REQUIRE(longBuffer != nullptr);
+    pool.Free(longBuffer, ArrayBufferPool::MIN_POOLED_LENGTH);
+    REQUIRE(_allocations == allocations + 1);
+}
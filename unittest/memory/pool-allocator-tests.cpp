@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <memory/pool-allocator.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace napa::memory;
+
+TEST_CASE("pool allocator serves aligned and distinct blocks", "[pool-allocator]") {
+    std::vector<void*> blocks;
+    std::set<void*> distinct;
+    for (size_t size : { 0, 1, 16, 17, 100, 256, 1000, 4096, 30000 }) {
+        for (int i = 0; i < 100; ++i) {
+            auto block = PoolAllocate(size);
+            REQUIRE(reinterpret_cast<uintptr_t>(block) % 16 == 0);
+            std::memset(block, 0xab, size);
+            blocks.push_back(block);
+            distinct.insert(block);
+        }
+    }
+    REQUIRE(distinct.size() == blocks.size());
+
+    for (auto block : blocks) {
+        PoolDeallocate(block, 0);
+    }
+}
+
+TEST_CASE("pool allocator block sizes cover requests", "[pool-allocator]") {
+    REQUIRE(GetPoolBlockSize(0) == 0);
+    REQUIRE(GetPoolBlockSize(1) == 16);
+    REQUIRE(GetPoolBlockSize(16) == 16);
+    REQUIRE(GetPoolBlockSize(17) == 32);
+    REQUIRE(GetPoolBlockSize(300) == 320 - 16);
+    REQUIRE(GetPoolBlockSize(POOL_MAX_POOLED_SIZE) == POOL_MAX_POOLED_SIZE);
+    REQUIRE(GetPoolBlockSize(POOL_MAX_POOLED_SIZE + 1) == 0);
+
+    for (size_t size = 1; size <= POOL_MAX_POOLED_SIZE; size += 7) {
+        auto blockSize = GetPoolBlockSize(size);
+        REQUIRE(blockSize >= size);
+        REQUIRE(blockSize < size + size / 4 + 16);
+    }
+}
+
+TEST_CASE("pool allocator reuses a released block on the same thread", "[pool-allocator]") {
+    auto block = PoolAllocate(64);
+    PoolDeallocate(block, 64);
+    REQUIRE(PoolAllocate(64) == block);
+    PoolDeallocate(block, 64);
+}
+
+TEST_CASE("pool allocator serves large requests from the C runtime", "[pool-allocator]") {
+    auto block = static_cast<char*>(PoolAllocate(1024 * 1024));
+    block[0] = 1;
+    block[1024 * 1024 - 1] = 1;
+    PoolDeallocate(block, 0);
+    PoolDeallocate(nullptr, 0);
+}
+
+TEST_CASE("pool allocator releases malloc memory allocated before it was selected", "[pool-allocator]") {
+    auto block = std::malloc(128);
+    PoolDeallocate(block, 128);
+}
+
+TEST_CASE("pool allocator takes blocks released on other threads", "[pool-allocator]") {
+    constexpr size_t count = 10000;
+    std::vector<void*> blocks(count);
+    for (auto& block : blocks) {
+        block = PoolAllocate(48);
+    }
+
+    // Releasing thread caches the blocks, then returns them to the pool when it exits.
+    std::thread releaser([&blocks]() {
+        for (auto block : blocks) {
+            PoolDeallocate(block, 48);
+        }
+    });
+    releaser.join();
+
+    std::set<void*> released(blocks.begin(), blocks.end());
+    size_t reused = 0;
+    for (size_t i = 0; i < count; ++i) {
+        blocks[i] = PoolAllocate(48);
+        if (released.count(blocks[i]) > 0) {
+            ++reused;
+        }
+    }
+    REQUIRE(reused > count / 2);
+
+    for (auto block : blocks) {
+        PoolDeallocate(block, 48);
+    }
+}
+
+TEST_CASE("pool allocator is thread safe", "[pool-allocator]") {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t]() {
+            std::vector<void*> blocks;
+            for (int i = 0; i < 20000; ++i) {
+                auto size = static_cast<size_t>((i * 37 + t) % 2000);
+                auto block = static_cast<unsigned char*>(PoolAllocate(size));
+                if (size > 0) {
+                    block[0] = static_cast<unsigned char>(t);
+                }
+                blocks.push_back(block);
+                if (i % 3 == 0) {
+                    PoolDeallocate(blocks[blocks.size() / 2], 0);
+                    blocks[blocks.size() / 2] = blocks.back();
+                    blocks.pop_back();
+                }
+            }
+            for (auto block : blocks) {
+                PoolDeallocate(block, 0);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
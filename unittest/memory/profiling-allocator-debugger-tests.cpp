@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <memory/profiling-allocator-debugger.h>
+
+#include <rapidjson/document.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace napa::memory;
+
+namespace {
+    class MallocAllocator : public Allocator {
+    public:
+        void* Allocate(size_t size) override {
+            return std::malloc(size);
+        }
+
+        void Deallocate(void* memory, size_t) override {
+            std::free(memory);
+        }
+
+        const char* GetType() const override {
+            return "MallocAllocator";
+        }
+
+        bool operator==(const Allocator& other) const override {
+            return &other == this;
+        }
+    };
+
+    rapidjson::Document GetDebugInfo(const AllocatorDebugger& debugger) {
+        rapidjson::Document document;
+        document.Parse(debugger.GetDebugInfo().c_str());
+        REQUIRE(!document.HasParseError());
+        return document;
+    }
+}
+
+TEST_CASE("profiling allocator debugger counts sizes whatever the size hints", "[profiling-allocator-debugger]") {
+    ProfilingAllocatorDebugger debugger(std::make_shared<MallocAllocator>(), 0);
+    REQUIRE(std::string(debugger.GetType()) == "ProfilingAllocatorDebugger<MallocAllocator>");
+
+    auto small = debugger.Allocate(10);
+    auto large = debugger.Allocate(1000);
+    std::memset(large, 0, 1000);
+    debugger.Deallocate(small, 0);
+
+    auto info = GetDebugInfo(debugger);
+    REQUIRE(info["allocate"].GetUint64() == 2);
+    REQUIRE(info["deallocate"].GetUint64() == 1);
+    REQUIRE(info["allocatedSize"].GetUint64() == 1010);
+    REQUIRE(info["deallocatedSize"].GetUint64() == 10);
+    REQUIRE(info["liveSize"].GetInt64() == 1000);
+    REQUIRE(info["peakLiveSize"].GetInt64() == 1000);
+    REQUIRE(info["samples"].Size() == 0);
+
+    const auto& histogram = info["sizeHistogram"];
+    REQUIRE(histogram.Size() == 2);
+    REQUIRE(histogram[0]["maxSize"].GetUint64() == 16);
+    REQUIRE(histogram[0]["count"].GetUint64() == 1);
+    REQUIRE(histogram[1]["maxSize"].GetUint64() == 1024);
+    REQUIRE(histogram[1]["count"].GetUint64() == 1);
+
+    debugger.Deallocate(large, 0);
+}
+
+TEST_CASE("profiling allocator debugger tracks the peak across threads", "[profiling-allocator-debugger]") {
+    ProfilingAllocatorDebugger debugger(std::make_shared<MallocAllocator>(), 0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&debugger]() {
+            std::vector<void*> blocks;
+            for (int i = 0; i < 100; ++i) {
+                blocks.push_back(debugger.Allocate(4096));
+            }
+            for (auto block : blocks) {
+                debugger.Deallocate(block, 4096);
+            }
+        });
+        threads.back().join();
+    }
+
+    auto info = GetDebugInfo(debugger);
+    REQUIRE(info["allocate"].GetUint64() == 400);
+    REQUIRE(info["liveSize"].GetInt64() == 0);
+
+    // Each thread peaks at 400KB, within a step of the shared total.
+    auto peak = info["peakLiveSize"].GetInt64();
+    REQUIRE(peak <= 100 * 4096);
+    REQUIRE(peak > 100 * 4096 - ProfilingAllocatorDebugger::LIVE_SIZE_STEP);
+}
+
+TEST_CASE("profiling allocator debugger samples allocation stacks", "[profiling-allocator-debugger]") {
+    ProfilingAllocatorDebugger debugger(std::make_shared<MallocAllocator>(), 4);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 40; ++i) {
+        blocks.push_back(debugger.Allocate(32));
+    }
+    for (auto block : blocks) {
+        debugger.Deallocate(block, 32);
+    }
+
+    auto info = GetDebugInfo(debugger);
+    REQUIRE(info["sampleInterval"].GetUint() == 4);
+
+    uint64_t count = 0;
+    uint64_t size = 0;
+    for (const auto& sample : info["samples"].GetArray()) {
+        count += sample["count"].GetUint64();
+        size += sample["size"].GetUint64();
+        REQUIRE(sample["stack"].Size() > 0);
+        REQUIRE(sample["stack"][0].IsString());
+    }
+    REQUIRE(count == 10);
+    REQUIRE(size == 320);
+    REQUIRE(info["droppedSamples"].GetUint64() == 0);
+}
@@ -0,0 +1,185 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <memory/shared-map.h>
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace napa::memory;
+
+namespace {
+    SharedMapValue MakeNumber(double number) {
+        SharedMapValue value;
+        value.number = number;
+        return value;
+    }
+
+    SharedMapValue MakeString(const std::string& string) {
+        SharedMapValue value;
+        value.type = SharedMapValueType::String;
+        value.bytes = string;
+        return value;
+    }
+
+    bool Get(const SharedMap& map, const std::string& key, SharedMapValue& value) {
+        return map.Get(key.data(), key.size(), value);
+    }
+
+    void Set(SharedMap& map, const std::string& key, SharedMapValue value) {
+        map.Set(key.data(), key.size(), std::move(value));
+    }
+}
+
+TEST_CASE("shared map sets, gets and deletes values of each type", "[shared-map]") {
+    SharedMap map;
+    SharedMapValue value;
+    REQUIRE(!Get(map, "missing", value));
+    REQUIRE(map.GetSize() == 0);
+
+    Set(map, "number", MakeNumber(1.5));
+    Set(map, "string", MakeString("hello"));
+
+    SharedMapValue boolean;
+    boolean.type = SharedMapValueType::Boolean;
+    boolean.boolean = true;
+    Set(map, "boolean", boolean);
+
+    SharedMapValue buffer;
+    buffer.type = SharedMapValueType::ArrayBuffer;
+    buffer.bytes = std::string("\0\1\2", 3);
+    Set(map, "buffer", buffer);
+
+    REQUIRE(map.GetSize() == 4);
+
+    REQUIRE(Get(map, "number", value));
+    REQUIRE(value.type == SharedMapValueType::Number);
+    REQUIRE(value.number == 1.5);
+
+    REQUIRE(Get(map, "string", value));
+    REQUIRE(value.type == SharedMapValueType::String);
+    REQUIRE(value.bytes == "hello");
+
+    REQUIRE(Get(map, "boolean", value));
+    REQUIRE(value.type == SharedMapValueType::Boolean);
+    REQUIRE(value.boolean);
+
+    REQUIRE(Get(map, "buffer", value));
+    REQUIRE(value.type == SharedMapValueType::ArrayBuffer);
+    REQUIRE(value.bytes == std::string("\0\1\2", 3));
+
+    // Replacing a value keeps the size.
+    Set(map, "string", MakeNumber(2));
+    REQUIRE(map.GetSize() == 4);
+    REQUIRE(Get(map, "string", value));
+    REQUIRE(value.type == SharedMapValueType::Number);
+    REQUIRE(value.number == 2);
+
+    REQUIRE(map.Delete("string", 6));
+    REQUIRE(!map.Delete("string", 6));
+    REQUIRE(!map.Has("string", 6));
+    REQUIRE(map.Has("number", 6));
+    REQUIRE(map.GetSize() == 3);
+
+    auto keys = map.GetKeys();
+    std::sort(keys.begin(), keys.end());
+    REQUIRE(keys == std::vector<std::string>({ "boolean", "buffer", "number" }));
+
+    map.Clear();
+    REQUIRE(map.GetSize() == 0);
+    REQUIRE(!map.Has("number", 6));
+}
+
+TEST_CASE("shared map tells keys apart by their bytes", "[shared-map]") {
+    SharedMap map(1);
+    Set(map, std::string("a\0b", 3), MakeNumber(1));
+    Set(map, "a", MakeNumber(2));
+    Set(map, "", MakeNumber(3));
+
+    SharedMapValue value;
+    REQUIRE(Get(map, std::string("a\0b", 3), value));
+    REQUIRE(value.number == 1);
+    REQUIRE(Get(map, "a", value));
+    REQUIRE(value.number == 2);
+    REQUIRE(Get(map, "", value));
+    REQUIRE(value.number == 3);
+    REQUIRE(map.GetSize() == 3);
+}
+
+TEST_CASE("shared map keeps its keys across growth and deletes", "[shared-map]") {
+    // A single shard makes every key share one table.
+    SharedMap map(1);
+    for (int i = 0; i < 1000; i++) {
+        Set(map, std::to_string(i), MakeNumber(i));
+    }
+    REQUIRE(map.GetSize() == 1000);
+
+    // Deleting and inserting over and over reuses the deleted slots or rehashes them away.
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 1000; i += 2) {
+            auto key = std::to_string(i);
+            REQUIRE(map.Delete(key.data(), key.size()));
+        }
+        for (int i = 0; i < 1000; i += 2) {
+            Set(map, std::to_string(i), MakeNumber(i + round));
+        }
+    }
+
+    REQUIRE(map.GetSize() == 1000);
+    SharedMapValue value;
+    for (int i = 0; i < 1000; i++) {
+        REQUIRE(Get(map, std::to_string(i), value));
+        REQUIRE(value.number == (i % 2 == 0 ? i + 9 : i));
+    }
+}
+
+TEST_CASE("shared map adds to numbers", "[shared-map]") {
+    SharedMap map;
+    double result = 0;
+    REQUIRE(map.Add("counter", 7, 2, result));
+    REQUIRE(result == 2);
+    REQUIRE(map.Add("counter", 7, 3, result));
+    REQUIRE(result == 5);
+
+    Set(map, "name", MakeString("napa"));
+    REQUIRE(!map.Add("name", 4, 1, result));
+
+    SharedMapValue value;
+    REQUIRE(Get(map, "name", value));
+    REQUIRE(value.bytes == "napa");
+}
+
+TEST_CASE("shared map serves threads concurrently", "[shared-map]") {
+    SharedMap map;
+    const int threadCount = 8;
+    const int operations = 10000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.emplace_back([&map, t, operations]() {
+            SharedMapValue value;
+            double result = 0;
+            for (int i = 0; i < operations; i++) {
+                auto key = std::to_string(t) + ":" + std::to_string(i % 100);
+                Set(map, key, MakeNumber(i));
+                Get(map, key, value);
+                map.Add("total", 5, 1, result);
+                if (i % 3 == 0) {
+                    map.Delete(key.data(), key.size());
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    SharedMapValue value;
+    REQUIRE(Get(map, "total", value));
+    REQUIRE(value.number == threadCount * operations);
+    REQUIRE(map.GetSize() == map.GetKeys().size());
+}
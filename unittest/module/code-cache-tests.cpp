@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <module/loader/code-cache.h>
+
+#include <string>
+
+using namespace napa;
+using namespace napa::module;
+
+TEST_CASE("code cache keys entries by path and content", "[code-cache]") {
+    CodeCache cache;
+    auto hash = CodeCache::HashContent("var a = 1;", 10);
+
+    REQUIRE(cache.Get("/napajs/a.js", hash) == nullptr);
+
+    cache.Insert("/napajs/a.js", hash, "code-a");
+
+    SECTION("same path and content hits") {
+        auto data = cache.Get("/napajs/a.js", hash);
+        REQUIRE(data != nullptr);
+        REQUIRE(*data == "code-a");
+    }
+
+    SECTION("another content misses") {
+        REQUIRE(cache.Get("/napajs/a.js", CodeCache::HashContent("var a = 2;", 10)) == nullptr);
+    }
+
+    SECTION("another path misses") {
+        REQUIRE(cache.Get("/napajs/b.js", hash) == nullptr);
+    }
+
+    SECTION("a new content replaces the old one") {
+        auto newHash = CodeCache::HashContent("var a = 2;", 10);
+        cache.Insert("/napajs/a.js", newHash, "code-a2");
+
+        REQUIRE(cache.Get("/napajs/a.js", hash) == nullptr);
+        REQUIRE(*cache.Get("/napajs/a.js", newHash) == "code-a2");
+    }
+
+    SECTION("removed entries miss") {
+        cache.Remove("/napajs/a.js", hash);
+        REQUIRE(cache.Get("/napajs/a.js", hash) == nullptr);
+    }
+}
+
+TEST_CASE("code cache keeps the first code compiled for a content", "[code-cache]") {
+    CodeCache cache;
+    auto hash = CodeCache::HashContent("var a = 1;", 10);
+
+    cache.Insert("/napajs/a.js", hash, "first");
+    cache.Insert("/napajs/a.js", hash, "second");
+
+    REQUIRE(*cache.Get("/napajs/a.js", hash) == "first");
+}
+
+TEST_CASE("code cache persists entries in its directory", "[code-cache]") {
+    std::string directory = "code-cache-test";
+    auto hash = CodeCache::HashContent("var a = 1;", 10);
+    std::string code("code\0with\0zeros", 15);
+
+    {
+        CodeCache cache;
+        cache.SetDirectory(directory);
+
+        // Clear the entry a previous run may have left.
+        cache.Remove("/napajs/a.js", hash);
+        cache.Insert("/napajs/a.js", hash, code);
+    }
+
+    CodeCache restarted;
+    restarted.SetDirectory(directory);
+
+    SECTION("a restarted cache loads the entry") {
+        auto data = restarted.Get("/napajs/a.js", hash);
+        REQUIRE(data != nullptr);
+        REQUIRE(*data == code);
+    }
+
+    SECTION("a persisted entry for another content misses") {
+        REQUIRE(restarted.Get("/napajs/a.js", CodeCache::HashContent("var a = 2;", 10)) == nullptr);
+    }
+
+    SECTION("removed entries are deleted from the directory") {
+        restarted.Remove("/napajs/a.js", hash);
+
+        CodeCache another;
+        another.SetDirectory(directory);
+        REQUIRE(another.Get("/napajs/a.js", hash) == nullptr);
+    }
+
+    restarted.Remove("/napajs/a.js", hash);
+}
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <platform/os.h>
+#include <platform/platform.h>
+#include <module/core-modules/node/file-system-helpers.h>
+#include <module/loader/file-status-cache.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+using namespace napa;
+using namespace napa::module;
+
+namespace {
+    const std::string STATUS_DIRECTORY("file-status-cache-test");
+
+    /// <summary> Creates the test directory and returns a path in it, removing the file if it exists. </summary>
+    filesystem::Path PrepareFile(const std::string& name) {
+        file_system_helpers::MkdirSync(STATUS_DIRECTORY);
+        auto path = filesystem::Path(STATUS_DIRECTORY + platform::DIR_SEPARATOR + name).Normalize();
+        std::remove(path.c_str());
+        return path;
+    }
+
+    void CreateFile(const filesystem::Path& path) {
+        file_system_helpers::WriteFileSync(path.String(), "1", 1);
+    }
+}
+
+TEST_CASE("file status cache keeps statuses for the process by default", "[file-status-cache]") {
+    auto path = PrepareFile("late.js");
+
+    FileStatusCache cache;
+    REQUIRE(cache.GetMode() == FileStatusCacheMode::Process);
+    REQUIRE_FALSE(cache.IsRegularFile(path));
+
+    CreateFile(path);
+    REQUIRE_FALSE(cache.IsRegularFile(path));
+    REQUIRE(cache.IsDirectory(filesystem::Path(STATUS_DIRECTORY)));
+
+    SECTION("until the directory is invalidated") {
+        cache.Invalidate(filesystem::Path(STATUS_DIRECTORY).Normalize().String());
+        REQUIRE(cache.IsRegularFile(path));
+        REQUIRE_FALSE(cache.IsDirectory(path));
+    }
+
+    SECTION("until the cache is cleared") {
+        cache.Clear();
+        REQUIRE(cache.IsRegularFile(path));
+    }
+}
+
+TEST_CASE("file status cache probes each time when it's off", "[file-status-cache]") {
+    auto path = PrepareFile("off.js");
+
+    FileStatusCache cache(FileStatusCacheMode::Off);
+    REQUIRE_FALSE(cache.IsRegularFile(path));
+
+    CreateFile(path);
+    REQUIRE(cache.IsRegularFile(path));
+}
+
+#ifdef OS_LINUX
+
+TEST_CASE("file status cache drops statuses of changed directories when watching", "[file-status-cache]") {
+    auto path = PrepareFile("watched.js");
+    auto other = PrepareFile("other.js");
+    CreateFile(other);
+
+    FileStatusCache cache(FileStatusCacheMode::Watch);
+    REQUIRE(cache.GetMode() == FileStatusCacheMode::Watch);
+    REQUIRE_FALSE(cache.IsRegularFile(path));
+    REQUIRE(cache.IsRegularFile(other));
+
+    // The change is seen once the watcher got the event.
+    CreateFile(path);
+    std::remove(other.c_str());
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((!cache.IsRegularFile(path) || cache.IsRegularFile(other)) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE(cache.IsRegularFile(path));
+    REQUIRE_FALSE(cache.IsRegularFile(other));
+
+    cache.SetMode(FileStatusCacheMode::Process);
+    REQUIRE(cache.GetMode() == FileStatusCacheMode::Process);
+}
+
+#endif
@@ -26,4 +26,41 @@ TEST_CASE("File system helpers reads/writes a file correctly.", "[file-system-he
 
     auto names = file_system_helpers::ReadDirectorySync(dirname);
     REQUIRE(names.size() == 3);
-}
\ No newline at end of file
+}
+TEST_CASE("File system helpers gets the status of a path.", "[file-system-helpers]") {
+    const std::string dirname("file-system-helpers-stat-test");
+    const std::string filename(dirname + platform::DIR_SEPARATOR + "file-system-helpers-stat-test.dat");
+
+    file_system_helpers::MkdirSync(dirname);
+    file_system_helpers::WriteFileSync(filename, dirname.data(), dirname.length());
+
+    auto fileStatus = file_system_helpers::StatSync(filename);
+    REQUIRE(fileStatus.isFile);
+    REQUIRE(!fileStatus.isDirectory);
+    REQUIRE(fileStatus.size == dirname.length());
+    REQUIRE(fileStatus.modifiedTime > 0);
+
+    auto directoryStatus = file_system_helpers::StatSync(dirname);
+    REQUIRE(!directoryStatus.isFile);
+    REQUIRE(directoryStatus.isDirectory);
+
+    REQUIRE_THROWS(file_system_helpers::StatSync(dirname + platform::DIR_SEPARATOR + "non-existing-file.dat"));
+}
+
+TEST_CASE("File system helpers maps a file once for all callers.", "[file-system-helpers]") {
+    const std::string dirname("file-system-helpers-map-test");
+    const std::string filename(dirname + platform::DIR_SEPARATOR + "file-system-helpers-map-test.dat");
+
+    file_system_helpers::MkdirSync(dirname);
+    file_system_helpers::WriteFileSync(filename, dirname.data(), dirname.length());
+
+    auto file = file_system_helpers::MapFileSync(filename);
+    REQUIRE(file->Size() == dirname.length());
+    REQUIRE(std::string(static_cast<const char*>(file->Data()), file->Size()) == dirname);
+
+    auto other = file_system_helpers::MapFileSync(filename);
+    REQUIRE(other == file);
+
+    REQUIRE_THROWS(file_system_helpers::MapFileSync(dirname + platform::DIR_SEPARATOR + "non-existing-file.dat"));
+    REQUIRE_THROWS(file_system_helpers::MapFileSync(dirname));
+}
@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <module/loader/json-module-cache.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace napa;
+using namespace napa::module;
+
+TEST_CASE("JSON module cache creates a value once", "[json-module-cache]") {
+    JsonModuleCache cache;
+    REQUIRE(cache.IsEnabled() == false);
+
+    uint32_t creations = 0;
+    auto create = [&creations]() {
+        creations++;
+        return std::string("serialized");
+    };
+
+    // The first caller keeps the value it created, the others get the serialized one.
+    REQUIRE(cache.Get("config.json", create) == nullptr);
+    auto data = cache.Get("config.json", create);
+    REQUIRE(data != nullptr);
+    REQUIRE(*data == "serialized");
+    REQUIRE(cache.Get("config.json", create) == data);
+    REQUIRE(creations == 1);
+
+    SECTION("paths have values of their own") {
+        REQUIRE(cache.Get("other.json", create) == nullptr);
+        REQUIRE(creations == 2);
+    }
+
+    SECTION("failures are not cached") {
+        auto fail = []() { return std::string(); };
+        REQUIRE(cache.Get("invalid.json", fail) == nullptr);
+
+        auto throwing = []() -> std::string { throw std::runtime_error("can't read"); };
+        REQUIRE_THROWS_AS(cache.Get("missing.json", throwing), std::runtime_error);
+
+        REQUIRE(cache.Get("invalid.json", create) == nullptr);
+        REQUIRE(cache.Get("missing.json", create) == nullptr);
+        REQUIRE(*cache.Get("missing.json", create) == "serialized");
+    }
+}
+
+TEST_CASE("JSON module cache lets concurrent callers wait for the first one", "[json-module-cache]") {
+    JsonModuleCache cache;
+    std::atomic<uint32_t> creations(0);
+
+    std::vector<JsonModuleCache::Data> values(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < values.size(); i++) {
+        threads.emplace_back([&cache, &creations, &values, i]() {
+            values[i] = cache.Get("config.json", [&creations]() {
+                creations++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                return std::string("serialized");
+            });
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(creations == 1);
+    uint32_t created = 0;
+    for (const auto& value : values) {
+        if (value == nullptr) {
+            created++;
+        } else {
+            REQUIRE(*value == "serialized");
+        }
+    }
+    REQUIRE(created == 1);
+}
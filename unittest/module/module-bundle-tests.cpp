@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <platform/os.h>
+#include <module/core-modules/node/file-system-helpers.h>
+#include <module/loader/module-bundle.h>
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+using namespace napa;
+using namespace napa::module;
+
+namespace {
+    const std::string BUNDLE_DIRECTORY("module-bundle-test");
+}
+
+TEST_CASE("module bundle serves the content of the caches it was written from", "[module-bundle]") {
+    const std::string moduleFile(BUNDLE_DIRECTORY + platform::DIR_SEPARATOR + "module.js");
+    const std::string bundleFile(BUNDLE_DIRECTORY + platform::DIR_SEPARATOR + "app.bundle");
+    const std::string source("module.exports = 1;");
+    auto hash = CodeCache::HashContent(source.data(), source.size());
+
+    file_system_helpers::MkdirSync(BUNDLE_DIRECTORY);
+    file_system_helpers::WriteFileSync(moduleFile, source.data(), source.length());
+
+    {
+        ModuleResolverCache resolverCache;
+        ModuleSourceCache sourceCache;
+        CodeCache codeCache;
+
+        resolverCache.Insert("./module", "/napajs", ModuleInfo{ ModuleType::JAVASCRIPT, moduleFile, "" });
+        REQUIRE(*sourceCache.Get(moduleFile) == source);
+        codeCache.Insert(moduleFile, hash, "code");
+
+        REQUIRE(ModuleBundle::Write(bundleFile, resolverCache, sourceCache, codeCache));
+    }
+
+    // The bundle is used in place of the module file.
+    std::remove(moduleFile.c_str());
+
+    auto bundle = ModuleBundle::Open(bundleFile);
+    REQUIRE(bundle != nullptr);
+
+    ModuleResolverCache resolverCache;
+    ModuleSourceCache sourceCache;
+    CodeCache codeCache;
+    ModuleBundle::Install(bundle, resolverCache, sourceCache, codeCache);
+
+    SECTION("resolutions") {
+        auto moduleInfo = resolverCache.Lookup("./module", "/napajs");
+        REQUIRE(moduleInfo.type == ModuleType::JAVASCRIPT);
+        REQUIRE(moduleInfo.fullPath == moduleFile);
+        REQUIRE(resolverCache.Lookup("./other", "/napajs").type == ModuleType::NONE);
+    }
+
+    SECTION("sources") {
+        REQUIRE(*sourceCache.Get(moduleFile) == source);
+        REQUIRE(sourceCache.Get(moduleFile) == sourceCache.Get(moduleFile));
+        REQUIRE_THROWS_AS(sourceCache.Get(BUNDLE_DIRECTORY + platform::DIR_SEPARATOR + "missing.js"), std::runtime_error);
+    }
+
+    SECTION("compiled code of the same content") {
+        auto data = codeCache.Get(moduleFile, hash);
+        REQUIRE(data != nullptr);
+        REQUIRE(*data == "code");
+        REQUIRE(codeCache.Get(moduleFile, hash + 1) == nullptr);
+    }
+}
+
+TEST_CASE("module bundle rejects invalid files", "[module-bundle]") {
+    const std::string bundleFile(BUNDLE_DIRECTORY + platform::DIR_SEPARATOR + "invalid.bundle");
+    file_system_helpers::MkdirSync(BUNDLE_DIRECTORY);
+
+    SECTION("missing file") {
+        std::remove(bundleFile.c_str());
+        REQUIRE(ModuleBundle::Open(bundleFile) == nullptr);
+    }
+
+    SECTION("another format") {
+        const std::string content("module.exports = 1;");
+        file_system_helpers::WriteFileSync(bundleFile, content.data(), content.length());
+        REQUIRE(ModuleBundle::Open(bundleFile) == nullptr);
+    }
+
+    SECTION("truncated bundle") {
+        ModuleResolverCache resolverCache;
+        ModuleSourceCache sourceCache;
+        CodeCache codeCache;
+        resolverCache.Insert("a", "/napajs", ModuleInfo{ ModuleType::JSON, "/napajs/a.json", "" });
+        REQUIRE(ModuleBundle::Write(bundleFile, resolverCache, sourceCache, codeCache));
+        REQUIRE(ModuleBundle::Open(bundleFile) != nullptr);
+
+        auto content = file_system_helpers::ReadFileSync(bundleFile);
+        file_system_helpers::WriteFileSync(bundleFile, content.data(), content.length() - 1);
+        REQUIRE(ModuleBundle::Open(bundleFile) == nullptr);
+    }
+}
@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <module/core-modules/node/file-system-helpers.h>
+#include <module/loader/module-prefetcher.h>
+#include <module/loader/module-source-cache.h>
+#include <platform/filesystem.h>
+#include <zone/simple-thread-pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace napa;
+using namespace napa::module;
+
+namespace {
+
+    std::string WriteModule(const std::string& dirname, const std::string& name, const std::string& source) {
+        auto path = (filesystem::CurrentDirectory() / dirname / name).String();
+        file_system_helpers::WriteFileSync(path, source.data(), source.length());
+        return path;
+    }
+
+    bool IsCached(const std::string& path) {
+        auto entries = ModuleSourceCache::GetInstance().GetEntries();
+        return std::any_of(entries.begin(), entries.end(), [&path](const std::pair<std::string, ModuleSourceCache::Source>& entry) {
+            return entry.first == path;
+        });
+    }
+}
+
+TEST_CASE("module prefetcher scans static requires", "[module-prefetcher]") {
+    SECTION("string literals in single and double quotes") {
+        auto names = ModulePrefetcher::ScanRequires(
+            "var a = require('./a');\n"
+            "const b = require ( \"b/c\" );\n"
+            "require('./d').init();");
+        REQUIRE(names == std::vector<std::string>({ "./a", "b/c", "./d" }));
+    }
+
+    SECTION("comments, strings and expressions are skipped") {
+        auto names = ModulePrefetcher::ScanRequires(
+            "// require('./commented')\n"
+            "/* require('./block') */\n"
+            "var s = \"require('./quoted')\";\n"
+            "var t = `require('./template')`;\n"
+            "var e = require('./' + name);\n"
+            "var m = loader.require('./member');\n"
+            "var o = myrequire('./other');\n"
+            "var r = s.replace(/'/g, '');\n"
+            "var last = require('./last');");
+        REQUIRE(names == std::vector<std::string>({ "./last" }));
+    }
+}
+
+TEST_CASE("module prefetcher reads dependencies into the source cache", "[module-prefetcher]") {
+    const std::string dirname("module-prefetcher-test");
+    file_system_helpers::MkdirSync(dirname);
+
+    auto b = WriteModule(dirname, "b.js", "module.exports = 'b';");
+    auto a = WriteModule(dirname, "a.js", "var b = require('./b'); var main = require('./main'); module.exports = b;");
+    auto main = WriteModule(dirname, "main.js", "var fs = require('fs'); var a = require('./a'); require('./missing');");
+
+    ModulePrefetcher prefetcher;
+    prefetcher.AddCoreModule("fs");
+
+    // The module loader reads the source of the module before it prefetches its dependencies.
+    ModuleSourceCache::GetInstance().Get(main);
+
+    SECTION("dependencies fan out on a pool") {
+        std::atomic<size_t> posted(0);
+        {
+            zone::SimpleThreadPool pool(4);
+            prefetcher.Prefetch(main, [&pool, &posted](std::function<void()> work) {
+                ++posted;
+                pool.Execute(std::move(work));
+                return true;
+            });
+        }
+
+        // Scans of main and a, fetches of './a', './missing', './b' and './main', not of core module 'fs'.
+        REQUIRE(posted == 5);
+        REQUIRE(prefetcher.GetScannedCount() == 3);
+        REQUIRE(IsCached(a));
+        REQUIRE(IsCached(b));
+
+        // A module is scanned once.
+        prefetcher.Prefetch(a, [&posted](std::function<void()> work) {
+            ++posted;
+            work();
+            return true;
+        });
+        REQUIRE(posted == 5);
+    }
+
+    SECTION("nothing is fetched if the pool can't run it") {
+        prefetcher.Prefetch(main, [](std::function<void()>) {
+            return false;
+        });
+        REQUIRE(prefetcher.GetScannedCount() == 1);
+    }
+}
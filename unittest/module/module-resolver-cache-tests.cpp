@@ -5,6 +5,10 @@
 
 #include <module/loader/module-resolver-cache.h>
 
+#include <string>
+#include <thread>
+#include <vector>
+
 using namespace napa;
 using namespace napa::module;
 
@@ -32,3 +36,55 @@ TEST_CASE("module resolver cache works correctly.", "[module-resolver-cache]") {
         REQUIRE(result.fullPath == "/home/napajs/test/a.js");
     }
 }
+
+TEST_CASE("module resolver cache tells apart keys made of the same strings.", "[module-resolver-cache]") {
+    ModuleResolverCache cache;
+    cache.Insert("a", "b", ModuleInfo{ModuleType::JAVASCRIPT, "/ab.js", std::string()});
+    cache.Insert("b", "a", ModuleInfo{ModuleType::JSON, "/ba.json", std::string()});
+    cache.Insert("ab", "", ModuleInfo{ModuleType::NAPA, "/ab.napa", std::string()});
+
+    REQUIRE(cache.Lookup("a", "b").fullPath == "/ab.js");
+    REQUIRE(cache.Lookup("b", "a").fullPath == "/ba.json");
+    REQUIRE(cache.Lookup("ab", "").fullPath == "/ab.napa");
+    REQUIRE(cache.Lookup("", "ab").type == ModuleType::NONE);
+}
+
+TEST_CASE("module resolver cache keeps the first resolution.", "[module-resolver-cache]") {
+    ModuleResolverCache cache;
+    cache.Insert("a", "/home/napajs/test/", ModuleInfo{ModuleType::JAVASCRIPT, "/home/napajs/test/a.js", std::string()});
+    cache.Insert("a", "/home/napajs/test/", ModuleInfo{ModuleType::JSON, "/home/napajs/test/a.json", std::string()});
+
+    REQUIRE(cache.Lookup("a", "/home/napajs/test/").fullPath == "/home/napajs/test/a.js");
+}
+
+TEST_CASE("module resolver cache serves concurrent lookups and inserts.", "[module-resolver-cache]") {
+    ModuleResolverCache cache;
+    const int count = 1000;
+
+    std::vector<std::thread> threads;
+    std::vector<int> misses(4, 0);
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&cache, &misses, t, count]() {
+            for (int i = 0; i < count; i++) {
+                auto name = std::to_string(i);
+                if (i % 4 == t) {
+                    cache.Insert(name.c_str(), "/", ModuleInfo{ModuleType::JAVASCRIPT, "/" + name + ".js", std::string()});
+                }
+                if (cache.Lookup(name.c_str(), "/").type == ModuleType::NONE) {
+                    misses[t]++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int i = 0; i < count; i++) {
+        auto name = std::to_string(i);
+        REQUIRE(cache.Lookup(name.c_str(), "/").fullPath == "/" + name + ".js");
+    }
+    for (int t = 0; t < 4; t++) {
+        REQUIRE(misses[t] <= count * 3 / 4);
+    }
+}
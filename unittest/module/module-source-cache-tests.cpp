@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <platform/os.h>
+#include <module/core-modules/node/file-system-helpers.h>
+#include <module/loader/module-source-cache.h>
+
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace napa;
+using namespace napa::module;
+
+TEST_CASE("module source cache reads a file once", "[module-source-cache]") {
+    const std::string dirname("module-source-cache-test");
+    const std::string filename(dirname + platform::DIR_SEPARATOR + "module.js");
+    const std::string source("module.exports = 1;");
+
+    file_system_helpers::MkdirSync(dirname);
+    file_system_helpers::WriteFileSync(filename, source.data(), source.length());
+
+    ModuleSourceCache cache;
+    auto first = cache.Get(filename);
+    REQUIRE(*first == source);
+
+    SECTION("later reads share the source") {
+        auto second = cache.Get(filename);
+        REQUIRE(second == first);
+    }
+
+    SECTION("sources are immutable once read") {
+        const std::string changed("module.exports = 2;");
+        file_system_helpers::WriteFileSync(filename, changed.data(), changed.length());
+
+        REQUIRE(*cache.Get(filename) == source);
+        file_system_helpers::WriteFileSync(filename, source.data(), source.length());
+    }
+
+    SECTION("concurrent reads get the same source") {
+        std::vector<ModuleSourceCache::Source> sources(8);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < sources.size(); i++) {
+            threads.emplace_back([&cache, &sources, &filename, i]() {
+                sources[i] = cache.Get(filename);
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (const auto& source : sources) {
+            REQUIRE(source == first);
+        }
+    }
+}
+
+TEST_CASE("module source cache doesn't cache failed reads", "[module-source-cache]") {
+    const std::string dirname("module-source-cache-test");
+    const std::string filename(dirname + platform::DIR_SEPARATOR + "late-module.js");
+    const std::string source("module.exports = 3;");
+
+    file_system_helpers::MkdirSync(dirname);
+    std::remove(filename.c_str());
+
+    ModuleSourceCache cache;
+    REQUIRE_THROWS_AS(cache.Get(filename), std::runtime_error);
+
+    file_system_helpers::WriteFileSync(filename, source.data(), source.length());
+    REQUIRE(*cache.Get(filename) == source);
+}
@@ -282,4 +282,53 @@ TEST_CASE("filesystem", "[Operations]") {
         REQUIRE(filesystem::MakeDirectories("./a/b/c"));
         REQUIRE(filesystem::IsDirectory("./a/b/c"));
     }
-}
\ No newline at end of file
+
+    SECTION("GetFileStatus") {
+        filesystem::FileStatus status;
+        REQUIRE(filesystem::GetFileStatus(filesystem::ProgramPath(), status));
+        REQUIRE(status.isFile);
+        REQUIRE(status.size > 0);
+
+        REQUIRE(!filesystem::GetFileStatus("./non-existing-file", status));
+    }
+
+    SECTION("MappedFile") {
+        filesystem::MappedFile file(filesystem::ProgramPath());
+        REQUIRE(file.IsOpen());
+        REQUIRE(file.Data() != nullptr);
+
+        filesystem::FileStatus status;
+        REQUIRE(filesystem::GetFileStatus(filesystem::ProgramPath(), status));
+        REQUIRE(file.Size() == status.size);
+
+        filesystem::MappedFile directory(".");
+        REQUIRE(!directory.IsOpen());
+    }
+}
+TEST_CASE("filesystem::Path::Normalize", "[Path]") {
+
+    SECTION("Resolves segments in place") {
+        filesystem::Path path("/a/./b//c/../../d/e/");
+        auto buffer = path.c_str();
+
+#ifdef _WIN32
+        REQUIRE(path.Normalize() == "\\a\\d\\e");
+#else
+        REQUIRE(path.Normalize() == "/a/d/e");
+#endif
+        REQUIRE(path.c_str() == buffer);
+    }
+
+    SECTION("Keeps leading '..' of relative paths") {
+        REQUIRE(filesystem::Path("a/../../b/..").Normalize().GenericForm() == "..");
+        REQUIRE(filesystem::Path("./a/..").Normalize() == ".");
+        REQUIRE(filesystem::Path("..").Normalize() == "..");
+    }
+
+    SECTION("Absolute paths have no parent of their root") {
+        REQUIRE(filesystem::Path("/a/../..").Normalize().IsEmpty());
+        REQUIRE(filesystem::Path("/").Normalize().GenericForm() == "/");
+        REQUIRE(filesystem::Path("c:/a/../..").Normalize().IsEmpty());
+        REQUIRE(filesystem::Path("c:a/..").Normalize() == "c:");
+    }
+}
@@ -0,0 +1,49 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <platform/os.h>
+#include <platform/thread.h>
+
+#include <algorithm>
+
+using namespace napa;
+
+TEST_CASE("platform::GetCpuTopology reports the CPUs of the machine", "[os]") {
+    const auto& topology = platform::GetCpuTopology();
+
+    REQUIRE(topology.logicalCpus == platform::GetCpuCount());
+    REQUIRE(topology.physicalCores > 0);
+    REQUIRE(topology.physicalCores <= topology.logicalCpus);
+
+    SECTION("NUMA nodes hold logical CPUs") {
+        REQUIRE(!topology.numaNodes.empty());
+
+        size_t cpus = 0;
+        for (size_t i = 0; i < topology.numaNodes.size(); ++i) {
+            const auto& node = topology.numaNodes[i];
+            REQUIRE(!node.cpus.empty());
+            REQUIRE(std::is_sorted(node.cpus.begin(), node.cpus.end()));
+            if (i > 0) {
+                REQUIRE(node.id > topology.numaNodes[i - 1].id);
+            }
+            cpus += node.cpus.size();
+        }
+        REQUIRE(cpus >= topology.logicalCpus);
+    }
+
+    SECTION("Caches are ordered by level") {
+        for (size_t i = 0; i < topology.caches.size(); ++i) {
+            const auto& cache = topology.caches[i];
+            REQUIRE(cache.level > 0);
+            REQUIRE((cache.type == "data" || cache.type == "instruction" || cache.type == "unified"));
+            if (i > 0) {
+                REQUIRE(cache.level >= topology.caches[i - 1].level);
+            }
+        }
+    }
+
+    SECTION("Topology is read once") {
+        REQUIRE(&platform::GetCpuTopology() == &topology);
+    }
+}
@@ -0,0 +1,25 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <platform/platform.h>
+#include <platform/process.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace napa;
+
+TEST_CASE("platform::GetResidentSetSize grows with touched memory", "[process]") {
+    auto before = platform::GetResidentSetSize();
+#if defined(OS_LINUX) || defined(SUPPORT_WINDOWS)
+    REQUIRE(before > 0);
+
+    std::vector<char> memory(64 * 1024 * 1024);
+    std::memset(memory.data(), 1, memory.size());
+    REQUIRE(platform::GetResidentSetSize() > before + memory.size() / 2);
+    REQUIRE(memory[memory.size() - 1] == 1);
+#else
+    REQUIRE(before == 0);
+#endif
+}
@@ -0,0 +1,112 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <platform/thread.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace napa;
+
+TEST_CASE("platform::ParseCpuList", "[thread]") {
+    std::vector<uint32_t> cpus;
+
+    SECTION("Single CPUs and ranges") {
+        REQUIRE(platform::ParseCpuList("0-2,5,7-8", cpus));
+        REQUIRE(cpus == std::vector<uint32_t>({ 0, 1, 2, 5, 7, 8 }));
+    }
+
+    SECTION("Duplicates are merged and sorted") {
+        REQUIRE(platform::ParseCpuList("4, 1-2,\n2", cpus));
+        REQUIRE(cpus == std::vector<uint32_t>({ 1, 2, 4 }));
+    }
+
+    SECTION("Empty list") {
+        REQUIRE(platform::ParseCpuList("", cpus));
+        REQUIRE(cpus.empty());
+    }
+
+    SECTION("Invalid lists") {
+        REQUIRE(platform::ParseCpuList("a", cpus) == false);
+        REQUIRE(platform::ParseCpuList("3-1", cpus) == false);
+        REQUIRE(platform::ParseCpuList("-1", cpus) == false);
+        REQUIRE(platform::ParseCpuList("1-", cpus) == false);
+    }
+}
+
+TEST_CASE("platform::GetPhysicalCoreCpus returns valid CPUs", "[thread]") {
+    auto cpus = platform::GetPhysicalCoreCpus();
+    REQUIRE(!cpus.empty());
+    REQUIRE(cpus.size() <= platform::GetCpuCount());
+}
+
+TEST_CASE("platform::WaitOnValue", "[thread]") {
+    std::atomic<uint32_t> value(0);
+
+    SECTION("Returns right away if the value differs") {
+        REQUIRE(platform::WaitOnValue(value, 1, std::chrono::milliseconds(1000)));
+    }
+
+    SECTION("Times out while the value is unchanged") {
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(platform::WaitOnValue(value, 0, std::chrono::milliseconds(20)) == false);
+        REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(15));
+    }
+
+    SECTION("Wakes when the value changes") {
+        std::thread waker([&value]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            value.store(1, std::memory_order_release);
+            platform::WakeOnValue(value);
+        });
+
+        while (value.load(std::memory_order_acquire) == 0) {
+            platform::WaitOnValue(value, 0, std::chrono::milliseconds(5000));
+        }
+        REQUIRE(value.load() == 1);
+        waker.join();
+    }
+}
+
+TEST_CASE("platform::GetCurrentThreadCpuUsage counts the calling thread only", "[thread]") {
+    platform::ThreadCpuUsage before;
+    if (!platform::GetCurrentThreadCpuUsage(before)) {
+        WARN("Per-thread CPU clocks are not supported on this platform.");
+        return;
+    }
+
+    // Another thread sleeping doesn't add to the time of this one, spinning here does.
+    std::thread sleeper([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    });
+    volatile uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(50)) {
+        sum = sum + 1;
+    }
+    sleeper.join();
+
+    platform::ThreadCpuUsage after;
+    REQUIRE(platform::GetCurrentThreadCpuUsage(after));
+    REQUIRE(after.user + after.system > before.user + before.system);
+    REQUIRE(after.user + after.system - before.user - before.system <= 1000000);
+}
+
+TEST_CASE("platform::SetCurrentThreadPriority lowers the priority of the calling thread", "[thread]") {
+    // Lowering the priority needs no privilege, it's done on a thread of its own so the test thread keeps its priority.
+    bool low = false;
+    bool background = false;
+    std::thread thread([&low, &background]() {
+        low = platform::SetCurrentThreadPriority(platform::ThreadPriority::Low);
+        background = platform::SetCurrentThreadPriority(platform::ThreadPriority::Background);
+    });
+    thread.join();
+
+    if (!low) {
+        WARN("Thread priorities are not supported on this platform.");
+        return;
+    }
+    REQUIRE(background);
+}
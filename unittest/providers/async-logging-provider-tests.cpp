@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <providers/async-logging-provider.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace napa::providers;
+
+using Verboseness = LoggingProvider::Verboseness;
+
+namespace {
+    std::string ReadFile(const std::string& path) {
+        std::ifstream file(path);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    size_t CountLines(const std::string& text) {
+        size_t count = 0;
+        for (auto c : text) {
+            count += c == '\n' ? 1 : 0;
+        }
+        return count;
+    }
+
+    /// <summary> A log file removed before and after a test case, even when the test case fails. </summary>
+    struct LogFile {
+        explicit LogFile(std::string path) : path(std::move(path)) {
+            (void)std::remove(this->path.c_str());
+        }
+
+        ~LogFile() {
+            (void)std::remove(path.c_str());
+        }
+
+        std::string path;
+    };
+
+    AsyncLoggingOptions GetOptions(const LogFile& file) {
+        AsyncLoggingOptions options;
+        options.file = file.path;
+        return options;
+    }
+}
+
+TEST_CASE("async logging provider writes messages with their level and trace id", "[async-logging-provider]") {
+    LogFile logFile("async-logging-format.log");
+    auto options = GetOptions(logFile);
+    {
+        AsyncLoggingProvider provider(options);
+        provider.LogMessage("Zone", Verboseness::Info, "", "zone.cpp", 10, "first");
+        provider.LogMessage("", Verboseness::Error, "trace", "worker.cpp", 20, "second");
+        provider.Flush();
+
+        REQUIRE(ReadFile(options.file) == "Info [Zone] first [zone.cpp:10]\nError (trace) second [worker.cpp:20]\n");
+    }
+}
+
+TEST_CASE("async logging provider filters levels and sections", "[async-logging-provider]") {
+    AsyncLoggingOptions options;
+    options.level = Verboseness::Warning;
+    AsyncLoggingProvider provider(options);
+
+    REQUIRE(provider.IsLogEnabled("Zone", Verboseness::Error));
+    REQUIRE(provider.IsLogEnabled("Zone", Verboseness::Warning));
+    REQUIRE(!provider.IsLogEnabled("Zone", Verboseness::Info));
+    REQUIRE(!provider.IsLogEnabled(nullptr, Verboseness::Debug));
+
+    options.level = Verboseness::Debug;
+    options.sections = { "Zone", "Store" };
+    AsyncLoggingProvider sectioned(options);
+
+    REQUIRE(sectioned.IsLogEnabled("Zone", Verboseness::Debug));
+    REQUIRE(sectioned.IsLogEnabled("Store", Verboseness::Info));
+    REQUIRE(!sectioned.IsLogEnabled("Worker", Verboseness::Error));
+    REQUIRE(!sectioned.IsLogEnabled(nullptr, Verboseness::Error));
+}
+
+TEST_CASE("async logging provider keeps the logging order across threads", "[async-logging-provider]") {
+    LogFile logFile("async-logging-threads.log");
+    auto options = GetOptions(logFile);
+    options.bufferSize = 4096;
+    {
+        AsyncLoggingProvider provider(options);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&provider, t]() {
+                for (int i = 0; i < 500; ++i) {
+                    auto message = std::to_string(t) + ":" + std::to_string(i);
+                    provider.LogMessage("Test", Verboseness::Info, "", "test.cpp", i, message.c_str());
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        provider.Destroy();
+        REQUIRE(provider.GetDroppedCount() == 0);
+    }
+
+    // Each thread's messages keep their order within the merged output.
+    std::ifstream file(options.file);
+    std::vector<int> next(4, 0);
+    std::string line;
+    size_t count = 0;
+    while (std::getline(file, line)) {
+        auto start = line.find("] ") + 2;
+        auto colon = line.find(':', start);
+        auto thread = std::stoi(line.substr(start, colon - start));
+        auto index = std::stoi(line.substr(colon + 1));
+        REQUIRE(index == next[thread]);
+        next[thread]++;
+        count++;
+    }
+    REQUIRE(count == 2000);
+}
+
+TEST_CASE("async logging provider drops messages of a full buffer", "[async-logging-provider]") {
+    LogFile logFile("async-logging-dropped.log");
+    auto options = GetOptions(logFile);
+    options.bufferSize = 8;
+    options.flushInterval = std::chrono::milliseconds(60000);
+    {
+        AsyncLoggingProvider provider(options);
+        for (int i = 0; i < 1000; ++i) {
+            provider.LogMessage("Test", Verboseness::Info, "", "test.cpp", i, "message");
+        }
+        provider.Flush();
+
+        // The writer may drain the buffer once it's half full, but it can't keep up with a tight loop.
+        auto dropped = provider.GetDroppedCount();
+        REQUIRE(dropped > 0);
+
+        auto text = ReadFile(options.file);
+        REQUIRE(CountLines(text) == 1000 - dropped + 1);
+        REQUIRE(text.find("[Logging] " + std::to_string(dropped) + " messages were dropped") != std::string::npos);
+    }
+}
+
+TEST_CASE("async logging provider writes synchronously once destroyed", "[async-logging-provider]") {
+    LogFile logFile("async-logging-destroyed.log");
+    auto options = GetOptions(logFile);
+    {
+        AsyncLoggingProvider provider(options);
+        provider.LogMessage("Test", Verboseness::Info, "", "test.cpp", 1, "buffered");
+        provider.Destroy();
+        provider.LogMessage("Test", Verboseness::Info, "", "test.cpp", 2, "direct");
+
+        REQUIRE(ReadFile(options.file) == "Info [Test] buffered [test.cpp:1]\nInfo [Test] direct [test.cpp:2]\n");
+    }
+}
@@ -0,0 +1,164 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <providers/in-process-metric-provider.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace napa::providers;
+
+TEST_CASE("in-process metric provider caches metrics by section and name", "[in-process-metric-provider]") {
+    InProcessMetricProvider provider;
+    const char* dimensions[] = { "dc" };
+
+    auto metric = provider.GetMetric("app", "qps", MetricType::Rate, 1, dimensions);
+    REQUIRE(metric != nullptr);
+    REQUIRE(provider.GetMetric("app", "qps", MetricType::Rate, 1, dimensions) == metric);
+    REQUIRE(provider.GetMetric("app", "errors", MetricType::Rate, 1, dimensions) != metric);
+}
+
+TEST_CASE("in-process metric keeps one series per dimension values", "[in-process-metric-provider]") {
+    const char* dimensionNames[] = { "dc", "api" };
+    InProcessMetric metric("app", "requests", MetricType::Number, 2, dimensionNames);
+
+    const char* first[] = { "dc1", "get" };
+    const char* second[] = { "dc1", "put" };
+    REQUIRE(metric.Set(10, 2, first));
+    REQUIRE(metric.Increment(5, 2, first));
+    REQUIRE(metric.Decrement(2, 2, first));
+    REQUIRE(metric.Set(-7, 2, second));
+
+    SECTION("the number of dimension values must match") {
+        REQUIRE_FALSE(metric.Set(1, 1, first));
+        REQUIRE_FALSE(metric.Increment(1, 0, nullptr));
+    }
+
+    auto snapshot = metric.Snapshot();
+    REQUIRE(snapshot.series.size() == 2);
+    REQUIRE(snapshot.series[0].dimensionValues == std::vector<std::string>({ "dc1", "get" }));
+    REQUIRE(snapshot.series[0].value == 13);
+    REQUIRE(snapshot.series[1].dimensionValues == std::vector<std::string>({ "dc1", "put" }));
+    REQUIRE(snapshot.series[1].value == -7);
+}
+
+TEST_CASE("in-process rate sums concurrent increments", "[in-process-metric-provider]") {
+    InProcessMetric metric("app", "qps", MetricType::Rate, 0, nullptr);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&metric]() {
+            for (int j = 0; j < 10000; ++j) {
+                metric.Increment(1, 0, nullptr);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto snapshot = metric.Snapshot();
+    REQUIRE(snapshot.series.size() == 1);
+    REQUIRE(snapshot.series[0].value == 80000);
+
+    REQUIRE(metric.Set(3, 0, nullptr));
+    REQUIRE(metric.Snapshot().series[0].value == 3);
+}
+
+TEST_CASE("in-process concurrent first uses create a single series", "[in-process-metric-provider]") {
+    const char* dimensionNames[] = { "id" };
+    InProcessMetric metric("app", "hits", MetricType::Number, 1, dimensionNames);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&metric]() {
+            for (int j = 0; j < 200; ++j) {
+                auto id = std::to_string(j);
+                const char* values[] = { id.c_str() };
+                metric.Increment(1, 1, values);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto snapshot = metric.Snapshot();
+    REQUIRE(snapshot.series.size() == 200);
+    for (const auto& series : snapshot.series) {
+        REQUIRE(series.value == 8);
+    }
+}
+
+TEST_CASE("in-process percentile reports quantiles within the histogram precision", "[in-process-metric-provider]") {
+    InProcessMetric metric("app", "latency", MetricType::Percentile, 0, nullptr);
+
+    for (int64_t i = 1; i <= 10000; ++i) {
+        REQUIRE(metric.Set(i, 0, nullptr));
+    }
+    REQUIRE_FALSE(metric.Increment(1, 0, nullptr));
+
+    auto snapshot = metric.Snapshot();
+    REQUIRE(snapshot.series.size() == 1);
+
+    const auto& series = snapshot.series[0];
+    REQUIRE(series.count == 10000);
+    REQUIRE(series.sum == 50005000);
+    REQUIRE(series.min == 1);
+    REQUIRE(series.max == 10000);
+
+    REQUIRE(series.percentiles.size() == InProcessMetric::QUANTILES.size());
+    for (const auto& percentile : series.percentiles) {
+        auto expected = percentile.first * 10000;
+        REQUIRE(percentile.second >= expected);
+        REQUIRE(percentile.second <= expected * 1.04);
+    }
+}
+
+TEST_CASE("metric histogram buckets cover all values", "[in-process-metric-provider]") {
+    for (uint64_t value : { 0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, 0xFFFFFFFFFFFFFFFFull }) {
+        auto index = MetricHistogram::GetBucketIndex(value);
+        REQUIRE(index < MetricHistogram::BUCKET_COUNT);
+        REQUIRE(MetricHistogram::GetBucketUpperBound(index) >= value);
+        if (index > 0) {
+            REQUIRE(MetricHistogram::GetBucketUpperBound(index - 1) < value);
+        }
+    }
+}
+
+TEST_CASE("in-process metric provider formats snapshots", "[in-process-metric-provider]") {
+    InProcessMetricProvider provider;
+    const char* dimensionNames[] = { "client-id" };
+    const char* dimensionValues[] = { "a\"b" };
+
+    provider.GetMetric("app", "qps", MetricType::Rate, 1, dimensionNames)->Increment(2, 1, dimensionValues);
+    provider.GetMetric("app", "latency", MetricType::Percentile, 0, nullptr)->Set(100, 0, nullptr);
+
+    SECTION("as JSON") {
+        auto json = provider.Snapshot(METRIC_SNAPSHOT_JSON);
+        REQUIRE(json ==
+            "[{\"section\":\"app\",\"name\":\"latency\",\"type\":\"percentile\",\"series\":[{\"dimensions\":{},"
+            "\"count\":1,\"sum\":100,\"min\":100,\"max\":100,"
+            "\"percentiles\":{\"p50\":100,\"p90\":100,\"p95\":100,\"p99\":100,\"p999\":100}}]},"
+            "{\"section\":\"app\",\"name\":\"qps\",\"type\":\"rate\",\"series\":["
+            "{\"dimensions\":{\"client-id\":\"a\\\"b\"},\"value\":2}]}]");
+    }
+
+    SECTION("as Prometheus text") {
+        auto text = provider.Snapshot(METRIC_SNAPSHOT_PROMETHEUS);
+        REQUIRE(text ==
+            "# TYPE app_latency summary\n"
+            "app_latency{quantile=\"0.5\"} 100\n"
+            "app_latency{quantile=\"0.9\"} 100\n"
+            "app_latency{quantile=\"0.95\"} 100\n"
+            "app_latency{quantile=\"0.99\"} 100\n"
+            "app_latency{quantile=\"0.999\"} 100\n"
+            "app_latency_sum 100\n"
+            "app_latency_count 1\n"
+            "# TYPE app_qps counter\n"
+            "app_qps{client_id=\"a\\\"b\"} 2\n");
+    }
+}
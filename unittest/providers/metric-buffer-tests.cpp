@@ -0,0 +1,97 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <providers/in-process-metric-provider.h>
+#include <providers/metric-buffer.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace napa::providers;
+
+TEST_CASE("metric buffer keeps one series per metric and dimension values", "[metric-buffer]") {
+    const char* dimensionNames[] = { "dc" };
+    InProcessMetric first("app", "qps", MetricType::Rate, 1, dimensionNames);
+    InProcessMetric second("app", "errors", MetricType::Rate, 1, dimensionNames);
+    MetricBuffer buffer(3);
+
+    uint32_t index = 0;
+    REQUIRE(buffer.AddSeries(&first, { "dc1" }, index));
+    REQUIRE(index == 0);
+    REQUIRE(buffer.AddSeries(&first, { "dc2" }, index));
+    REQUIRE(index == 1);
+    REQUIRE(buffer.AddSeries(&second, { "dc1" }, index));
+    REQUIRE(index == 2);
+    REQUIRE(buffer.AddSeries(&first, { "dc1" }, index));
+    REQUIRE(index == 0);
+    REQUIRE(buffer.GetSeriesCount() == 3);
+
+    SECTION("a full buffer rejects new series") {
+        REQUIRE_FALSE(buffer.AddSeries(&second, { "dc2" }, index));
+        REQUIRE(buffer.GetSeriesCount() == 3);
+    }
+}
+
+TEST_CASE("metric buffer reports pending updates on flush", "[metric-buffer]") {
+    InProcessMetric metric("app", "requests", MetricType::Number, 0, nullptr);
+    MetricBuffer buffer;
+    REQUIRE(buffer.GetSlotCount() == 1 + 2 * MetricBuffer::DEFAULT_CAPACITY);
+
+    uint32_t index = 0;
+    REQUIRE(buffer.AddSeries(&metric, {}, index));
+    auto slots = buffer.GetSlots();
+    auto& increments = slots[1 + 2 * index];
+    auto& value = slots[2 + 2 * index];
+    REQUIRE(increments == 0);
+    REQUIRE(std::isnan(value));
+
+    SECTION("a clean buffer reports nothing") {
+        increments = 5;
+        buffer.Flush();
+        REQUIRE(metric.Snapshot().series.empty());
+    }
+
+    SECTION("increments are summed") {
+        increments = 5;
+        slots[MetricBuffer::DIRTY_SLOT] = 1;
+        buffer.Flush();
+        REQUIRE(metric.Snapshot().series[0].value == 5);
+        REQUIRE(increments == 0);
+        REQUIRE(slots[MetricBuffer::DIRTY_SLOT] == 0);
+
+        increments = -2;
+        slots[MetricBuffer::DIRTY_SLOT] = 1;
+        buffer.Flush();
+        REQUIRE(metric.Snapshot().series[0].value == 3);
+    }
+
+    SECTION("a set is applied before the increments after it") {
+        value = 10;
+        increments = 2;
+        slots[MetricBuffer::DIRTY_SLOT] = 1;
+        buffer.Flush();
+        REQUIRE(metric.Snapshot().series[0].value == 12);
+        REQUIRE(std::isnan(value));
+    }
+
+    SECTION("pending updates are reported on destruction") {
+        {
+            MetricBuffer scoped;
+            REQUIRE(scoped.AddSeries(&metric, {}, index));
+            scoped.GetSlots()[2 + 2 * index] = 7;
+            scoped.GetSlots()[MetricBuffer::DIRTY_SLOT] = 1;
+        }
+        REQUIRE(metric.Snapshot().series[0].value == 7);
+    }
+}
+
+TEST_CASE("metric buffer of the current thread", "[metric-buffer]") {
+    MetricBuffer buffer;
+    REQUIRE(MetricBuffer::GetCurrent() == nullptr);
+    MetricBuffer::SetCurrent(&buffer);
+    REQUIRE(MetricBuffer::GetCurrent() == &buffer);
+    MetricBuffer::SetCurrent(nullptr);
+}
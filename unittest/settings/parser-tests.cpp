@@ -3,6 +3,7 @@
 
 #include <catch/catch.hpp>
 
+#include <platform/thread.h>
 #include <settings/settings-parser.h>
 
 #include <string>
@@ -36,6 +37,101 @@ TEST_CASE("Parsing from console", "[settings-parser]") {
     REQUIRE(settings.loggingProvider == "myProvider");
 }
 
+TEST_CASE("Parsing code cache directory", "[settings-parser]") {
+    settings::PlatformSettings settings;
+    REQUIRE(settings.codeCacheDirectory.empty());
+
+    REQUIRE(settings::ParseFromString("--codeCacheDirectory ./code-cache", settings));
+    REQUIRE(settings.codeCacheDirectory == "./code-cache");
+}
+
+TEST_CASE("Parsing default allocator", "[settings-parser]") {
+    settings::PlatformSettings settings;
+    REQUIRE(settings.defaultAllocator == settings::AllocatorType::Crt);
+
+    REQUIRE(settings::ParseFromString("--defaultAllocator pool", settings));
+    REQUIRE(settings.defaultAllocator == settings::AllocatorType::Pool);
+
+    REQUIRE(settings::ParseFromString("--defaultAllocator mimalloc", settings));
+    REQUIRE(settings.defaultAllocator == settings::AllocatorType::Mimalloc);
+
+    REQUIRE(settings::ParseFromString("--defaultAllocator jemalloc", settings));
+    REQUIRE(settings.defaultAllocator == settings::AllocatorType::Jemalloc);
+
+    REQUIRE(settings::ParseFromString("--defaultAllocator system", settings));
+    REQUIRE(settings.defaultAllocator == settings::AllocatorType::Crt);
+
+    REQUIRE(settings::ParseFromString("--defaultAllocator tcmalloc", settings) == false);
+}
+
+TEST_CASE("Parsing logging settings", "[settings-parser]") {
+    settings::PlatformSettings settings;
+    REQUIRE(settings.logLevel == napa::providers::LoggingProvider::Verboseness::Debug);
+    REQUIRE(settings.logSections.empty());
+
+    REQUIRE(settings::ParseFromString("--loggingProvider async --logFile napa.log --logLevel warning --logSections Zone,Store", settings));
+    REQUIRE(settings.loggingProvider == "async");
+    REQUIRE(settings.logFile == "napa.log");
+    REQUIRE(settings.logLevel == napa::providers::LoggingProvider::Verboseness::Warning);
+    REQUIRE(settings.logSections == std::vector<std::string>({ "Zone", "Store" }));
+
+    REQUIRE(settings::ParseFromString("--logLevel verbose", settings) == false);
+}
+
+TEST_CASE("Parsing ArrayBuffer pool settings", "[settings-parser]") {
+    settings::PlatformSettings settings;
+    REQUIRE(settings.arrayBufferPoolSize == 64 * 1024 * 1024);
+    REQUIRE(settings.arrayBufferHugePages == napa::platform::HugePages::None);
+
+    REQUIRE(settings::ParseFromString("--arrayBufferPoolSize 1048576 --arrayBufferHugePages transparent", settings));
+    REQUIRE(settings.arrayBufferPoolSize == 1048576);
+    REQUIRE(settings.arrayBufferHugePages == napa::platform::HugePages::Transparent);
+
+    REQUIRE(settings::ParseFromString("--arrayBufferHugePages explicit", settings));
+    REQUIRE(settings.arrayBufferHugePages == napa::platform::HugePages::Explicit);
+
+    REQUIRE(settings::ParseFromString("--arrayBufferHugePages always", settings) == false);
+}
+
+TEST_CASE("Parsing module status cache settings", "[settings-parser]") {
+    settings::PlatformSettings settings;
+    REQUIRE(settings.moduleStatusCache == napa::module::FileStatusCacheMode::Process);
+
+    REQUIRE(settings::ParseFromString("--moduleStatusCache watch", settings));
+    REQUIRE(settings.moduleStatusCache == napa::module::FileStatusCacheMode::Watch);
+
+    REQUIRE(settings::ParseFromString("--moduleStatusCache off", settings));
+    REQUIRE(settings.moduleStatusCache == napa::module::FileStatusCacheMode::Off);
+
+    REQUIRE(settings::ParseFromString("--moduleStatusCache always", settings) == false);
+}
+
+TEST_CASE("Parsing prewarm isolates setting", "[settings-parser]") {
+    settings::PlatformSettings settings;
+    REQUIRE(settings.prewarmIsolates == 0);
+
+    REQUIRE(settings::ParseFromString("--prewarmIsolates 4", settings));
+    REQUIRE(settings.prewarmIsolates == 4);
+}
+
+TEST_CASE("Parsing shared JSON modules setting", "[settings-parser]") {
+    settings::PlatformSettings settings;
+    REQUIRE(settings.sharedJsonModules == false);
+
+    REQUIRE(settings::ParseFromString("--sharedJsonModules true", settings));
+    REQUIRE(settings.sharedJsonModules == true);
+
+    REQUIRE(settings::ParseFromString("--sharedJsonModules often", settings) == false);
+}
+
+TEST_CASE("Parsing console buffer size setting", "[settings-parser]") {
+    settings::PlatformSettings settings;
+    REQUIRE(settings.consoleBufferSize == 0);
+
+    REQUIRE(settings::ParseFromString("--consoleBufferSize 65536", settings));
+    REQUIRE(settings.consoleBufferSize == 65536);
+}
+
 TEST_CASE("Parsing non existing setting fails", "[settings-parser]") {
     settings::PlatformSettings settings;
 
@@ -69,3 +165,404 @@ TEST_CASE("Parsing with different value type fails", "[settings-parser]") {
 
     REQUIRE(settings::ParseFromString("--workers five", settings) == false);
 }
+
+TEST_CASE("Parsing scheduler type", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.scheduler == settings::SchedulerType::Synchronized);
+
+    REQUIRE(settings::ParseFromString("--scheduler lockFree", settings));
+    REQUIRE(settings.scheduler == settings::SchedulerType::LockFree);
+
+    REQUIRE(settings::ParseFromString("--scheduler workStealing", settings));
+    REQUIRE(settings.scheduler == settings::SchedulerType::WorkStealing);
+
+    REQUIRE(settings::ParseFromString("--scheduler synchronized", settings));
+    REQUIRE(settings.scheduler == settings::SchedulerType::Synchronized);
+
+    REQUIRE(settings::ParseFromString("--scheduler unknown", settings) == false);
+}
+
+TEST_CASE("Parsing worker placement settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.cpuSet.empty());
+    REQUIRE(settings.numaNode == -1);
+    REQUIRE(settings.pinWorkersToCores == false);
+
+    REQUIRE(settings::ParseFromString("--cpuSet 0-3,8 --numaNode 1 --pinWorkersToCores true", settings));
+    REQUIRE(settings.cpuSet == std::vector<uint32_t>({ 0, 1, 2, 3, 8 }));
+    REQUIRE(settings.numaNode == 1);
+    REQUIRE(settings.pinWorkersToCores == true);
+
+    REQUIRE(settings::ParseFromString("--cpuSet 3-1", settings) == false);
+    REQUIRE(settings::ParseFromString("--pinWorkersToCores maybe", settings) == false);
+}
+
+TEST_CASE("Parsing stuck worker settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.stuckWorkerThreshold == 0);
+    REQUIRE(settings.recycleStuckWorkers == false);
+
+    REQUIRE(settings::ParseFromString("--stuckWorkerThreshold 5000 --recycleStuckWorkers true", settings));
+    REQUIRE(settings.stuckWorkerThreshold == 5000);
+    REQUIRE(settings.recycleStuckWorkers == true);
+
+    REQUIRE(settings::ParseFromString("--recycleStuckWorkers sometimes", settings) == false);
+}
+
+TEST_CASE("Parsing worker thread priority", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.threadPriority == platform::ThreadPriority::Normal);
+
+    REQUIRE(settings::ParseFromString("--threadPriority background", settings));
+    REQUIRE(settings.threadPriority == platform::ThreadPriority::Background);
+
+    REQUIRE(settings::ParseFromString("--threadPriority high", settings));
+    REQUIRE(settings.threadPriority == platform::ThreadPriority::High);
+
+    REQUIRE(settings::ParseFromString("--threadPriority idle", settings) == false);
+}
+
+TEST_CASE("Parsing worker count from the CPU topology", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings::ParseFromString("--workers 3", settings));
+    REQUIRE(settings.workers == 3);
+
+    REQUIRE(settings::ParseFromString("--workers auto", settings));
+    REQUIRE(settings.workers == platform::GetCpuCount());
+
+    REQUIRE(settings::ParseFromString("--workers physical", settings));
+    REQUIRE(settings.workers == platform::GetPhysicalCoreCpus().size());
+
+    settings::ZoneSettings restricted;
+    REQUIRE(settings::ParseFromString("--workers auto --cpuSet 0", restricted));
+    REQUIRE(restricted.workers == 1);
+
+    REQUIRE(settings::ParseFromString("--workers physical --cpuSet 0", restricted));
+    REQUIRE(restricted.workers == 1);
+
+    REQUIRE(settings::ParseFromString("--workers all", settings) == false);
+    REQUIRE(settings::ParseFromString("--workers -1", settings) == false);
+}
+
+TEST_CASE("Parsing tenant weights", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.tenantWeights.empty());
+
+    REQUIRE(settings::ParseFromString("--tenantWeights gold:4,silver:1,42:2", settings));
+    REQUIRE(settings.tenantWeights.size() == 3);
+    REQUIRE(settings.tenantWeights[0].name == "gold");
+    REQUIRE(settings.tenantWeights[0].weight == 4);
+    REQUIRE(settings.tenantWeights[1].name == "silver");
+    REQUIRE(settings.tenantWeights[0].tenant != settings.tenantWeights[1].tenant);
+
+    // Names of digits are numeric tenant keys.
+    REQUIRE(settings.tenantWeights[2].tenant == 42);
+    REQUIRE(settings.tenantWeights[2].weight == 2);
+
+    REQUIRE(settings::ParseFromString("--tenantWeights gold", settings) == false);
+    REQUIRE(settings::ParseFromString("--tenantWeights gold:0", settings) == false);
+    REQUIRE(settings::ParseFromString("--tenantWeights :3", settings) == false);
+}
+
+TEST_CASE("Parsing rate limits", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.rateLimit == 0);
+    REQUIRE(settings.tenantRateLimits.empty());
+
+    REQUIRE(settings::ParseFromString("--rateLimit 1000 --tenantRateLimits gold:100,*:10", settings));
+    REQUIRE(settings.rateLimit == 1000);
+    REQUIRE(settings.tenantRateLimits.size() == 2);
+    REQUIRE(settings.tenantRateLimits[0].name == "gold");
+    REQUIRE(settings.tenantRateLimits[0].rate == 100);
+    REQUIRE(settings.tenantRateLimits[1].name == "*");
+    REQUIRE(settings.tenantRateLimits[1].rate == 10);
+
+    REQUIRE(settings::ParseFromString("--tenantRateLimits gold:0", settings) == false);
+
+    settings::ZoneSettings contexts;
+    REQUIRE(contexts.tenantContexts == 0);
+    REQUIRE(settings::ParseFromString("--tenantContexts 200", contexts));
+    REQUIRE(contexts.tenantContexts == 200);
+    REQUIRE(settings::ParseFromString("--tenantRateLimits gold:fast", settings) == false);
+}
+
+TEST_CASE("Parsing concurrency limits", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.maxConcurrency == 0);
+
+    REQUIRE(settings::ParseFromString("--maxConcurrency 64", settings));
+    REQUIRE(settings.maxConcurrency == 64);
+}
+
+TEST_CASE("Parsing preloaded modules", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.preload.empty());
+
+    REQUIRE(settings::ParseFromString("--preload /app/handler.js,lodash,,/app/model.js", settings));
+    REQUIRE(settings.preload == std::vector<std::string>({ "/app/handler.js", "lodash", "/app/model.js" }));
+}
+
+TEST_CASE("Parsing warm-up settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.warmupModule.empty());
+    REQUIRE(settings.warmupIterations == 100);
+
+    REQUIRE(settings::ParseFromString(
+        "--warmupModule /app/handler.js --warmupFunction handle --warmupSamples /app/samples --warmupIterations 20 --warmupRecord /app/recorded",
+        settings));
+    REQUIRE(settings.warmupModule == "/app/handler.js");
+    REQUIRE(settings.warmupFunction == "handle");
+    REQUIRE(settings.warmupSamples == "/app/samples");
+    REQUIRE(settings.warmupIterations == 20);
+    REQUIRE(settings.warmupRecord == "/app/recorded");
+
+    settings::ZoneSettings other;
+    REQUIRE(settings::ParseFromString("--warmupFunction handle", other) == false);
+
+    settings::ZoneSettings another;
+    REQUIRE(settings::ParseFromString("--warmupSamples /app/samples", another) == false);
+}
+
+TEST_CASE("Parsing worker scaling settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.minWorkers == 0);
+    REQUIRE(settings.maxWorkers == 0);
+
+    REQUIRE(settings::ParseFromString("--minWorkers 1 --maxWorkers 8 --workerIdleTimeout 500 --scaleUpQueueDepth 4", settings));
+    REQUIRE(settings.minWorkers == 1);
+    REQUIRE(settings.maxWorkers == 8);
+    REQUIRE(settings.workerIdleTimeout == 500);
+    REQUIRE(settings.scaleUpQueueDepth == 4);
+
+    settings::ZoneSettings invalid;
+    REQUIRE(settings::ParseFromString("--minWorkers 4 --maxWorkers 2", invalid) == false);
+}
+
+TEST_CASE("Parsing worker recycling settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.maxTasksPerWorker == 0);
+    REQUIRE(settings.maxHeapBeforeRecycle == 0);
+    REQUIRE(settings.recycleOnHeapLimit == false);
+
+    REQUIRE(settings::ParseFromString("--maxTasksPerWorker 10000 --maxHeapBeforeRecycle 512 --recycleOnHeapLimit true", settings));
+    REQUIRE(settings.maxTasksPerWorker == 10000);
+    REQUIRE(settings.maxHeapBeforeRecycle == 512);
+    REQUIRE(settings.recycleOnHeapLimit == true);
+
+    REQUIRE(settings::ParseFromString("--recycleOnHeapLimit maybe", settings) == false);
+}
+
+TEST_CASE("Parsing result cache settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.resultCacheSize == 16);
+
+    REQUIRE(settings::ParseFromString("--resultCacheSize 0", settings));
+    REQUIRE(settings.resultCacheSize == 0);
+}
+
+TEST_CASE("Parsing worker idle settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.idleSpinTime == 0);
+    REQUIRE(settings.idleYieldTime == 0);
+    REQUIRE(settings.lowLatency == false);
+    REQUIRE(settings.idleGcTime == 0);
+
+    REQUIRE(settings::ParseFromString("--idleSpinTime 20 --idleYieldTime 100 --lowLatency true --idleGcTime 5", settings));
+    REQUIRE(settings.idleSpinTime == 20);
+    REQUIRE(settings.idleYieldTime == 100);
+    REQUIRE(settings.lowLatency == true);
+    REQUIRE(settings.idleGcTime == 5);
+
+    REQUIRE(settings::ParseFromString("--lowLatency fast", settings) == false);
+}
+
+TEST_CASE("Parsing GC profiles", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.gcProfile == settings::GcProfile::Default);
+
+    REQUIRE(settings::ParseFromString("--gcProfile latency", settings));
+    REQUIRE(settings.gcProfile == settings::GcProfile::Latency);
+    REQUIRE(settings.maxSemiSpaceSize == 8);
+    REQUIRE(settings.idleGcTime == 5);
+
+    REQUIRE(settings::ParseFromString("--gcProfile throughput", settings));
+    REQUIRE(settings.gcProfile == settings::GcProfile::Throughput);
+    REQUIRE(settings.maxSemiSpaceSize == 64);
+    REQUIRE(settings.idleGcTime == 0);
+
+    // Explicit settings win over the profile, whatever their order.
+    REQUIRE(settings::ParseFromString("--idleGcTime 50 --gcProfile memory --maxSemiSpaceSize 2", settings));
+    REQUIRE(settings.gcProfile == settings::GcProfile::Memory);
+    REQUIRE(settings.maxSemiSpaceSize == 2);
+    REQUIRE(settings.idleGcTime == 50);
+
+    REQUIRE(settings::ParseFromString("--gcProfile default", settings));
+    REQUIRE(settings.maxSemiSpaceSize == 0);
+    REQUIRE(settings.idleGcTime == 0);
+
+    REQUIRE(settings::ParseFromString("--gcProfile fast", settings) == false);
+}
+
+TEST_CASE("Parsing microtask settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.microtaskPolicy == settings::MicrotaskPolicy::Auto);
+    REQUIRE(settings.microtaskBatchSize == 32);
+    REQUIRE(settings.microtaskTimeSlice == 1000);
+
+    REQUIRE(settings::ParseFromString("--microtaskPolicy batched --microtaskBatchSize 64 --microtaskTimeSlice 500", settings));
+    REQUIRE(settings.microtaskPolicy == settings::MicrotaskPolicy::Batched);
+    REQUIRE(settings.microtaskBatchSize == 64);
+    REQUIRE(settings.microtaskTimeSlice == 500);
+
+    REQUIRE(settings::ParseFromString("--microtaskPolicy auto", settings));
+    REQUIRE(settings.microtaskPolicy == settings::MicrotaskPolicy::Auto);
+
+    REQUIRE(settings::ParseFromString("--microtaskPolicy lazy", settings) == false);
+    REQUIRE(settings::ParseFromString("--microtaskBatchSize 0", settings) == false);
+}
+
+TEST_CASE("Parsing queue admission settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.maxQueueLength == 0);
+    REQUIRE(settings.overloadPolicy == settings::OverloadPolicy::Reject);
+
+    REQUIRE(settings::ParseFromString("--maxQueueLength 100 --overloadPolicy block", settings));
+    REQUIRE(settings.maxQueueLength == 100);
+    REQUIRE(settings.overloadPolicy == settings::OverloadPolicy::Block);
+
+    REQUIRE(settings::ParseFromString("--overloadPolicy dropOldest", settings));
+    REQUIRE(settings.overloadPolicy == settings::OverloadPolicy::DropOldest);
+
+    REQUIRE(settings::ParseFromString("--overloadPolicy reject", settings));
+    REQUIRE(settings.overloadPolicy == settings::OverloadPolicy::Reject);
+
+    REQUIRE(settings::ParseFromString("--overloadPolicy unknown", settings) == false);
+}
+
+TEST_CASE("Parsing routing settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.routingImbalance == 4);
+
+    REQUIRE(settings::ParseFromString("--routingImbalance 16", settings));
+    REQUIRE(settings.routingImbalance == 16);
+}
+
+TEST_CASE("Parsing in-flight call settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.maxInFlightPerWorker == 0);
+
+    REQUIRE(settings::ParseFromString("--maxInFlightPerWorker 8", settings));
+    REQUIRE(settings.maxInFlightPerWorker == 8);
+}
+
+TEST_CASE("Parsing timeout settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.timeoutGracePeriod == 0);
+
+    REQUIRE(settings::ParseFromString("--timeoutGracePeriod 200", settings));
+    REQUIRE(settings.timeoutGracePeriod == 200);
+}
+
+TEST_CASE("Parsing slow task settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.slowTaskThreshold == 0);
+
+    REQUIRE(settings::ParseFromString("--slowTaskThreshold 500", settings));
+    REQUIRE(settings.slowTaskThreshold == 500);
+}
+
+TEST_CASE("Parsing hardware counter settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.hardwareCounters == false);
+
+    REQUIRE(settings::ParseFromString("--hardwareCounters true", settings));
+    REQUIRE(settings.hardwareCounters == true);
+
+    REQUIRE(settings::ParseFromString("--hardwareCounters perf", settings) == false);
+}
+
+TEST_CASE("Parsing module context settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.sharedModuleContext == false);
+
+    REQUIRE(settings::ParseFromString("--sharedModuleContext true", settings));
+    REQUIRE(settings.sharedModuleContext == true);
+
+    REQUIRE(settings::ParseFromString("--sharedModuleContext yes", settings) == false);
+}
+
+TEST_CASE("Parsing module prefetch settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.modulePrefetch == false);
+
+    REQUIRE(settings::ParseFromString("--modulePrefetch true", settings));
+    REQUIRE(settings.modulePrefetch == true);
+
+    REQUIRE(settings::ParseFromString("--modulePrefetch eager", settings) == false);
+}
+
+TEST_CASE("Parsing startup snapshot settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.startupScript.empty());
+    REQUIRE(settings.startupSnapshot.empty());
+
+    REQUIRE(settings::ParseFromString("--startupScript ./startup.js --startupSnapshot ./startup.bin", settings));
+    REQUIRE(settings.startupScript == "./startup.js");
+    REQUIRE(settings.startupSnapshot == "./startup.bin");
+}
+
+TEST_CASE("Parsing module bundle settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.bundle.empty());
+
+    REQUIRE(settings::ParseFromString("--bundle ./app.bundle", settings));
+    REQUIRE(settings.bundle == "./app.bundle");
+}
+
+TEST_CASE("Parsing async work settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.asyncWorkers == 4);
+
+    REQUIRE(settings::ParseFromString("--asyncWorkers 16", settings));
+    REQUIRE(settings.asyncWorkers == 16);
+
+    REQUIRE(settings::ParseFromString("--asyncWorkers 0", settings) == false);
+}
+
+TEST_CASE("Parsing worker event loop settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.eventLoop == false);
+
+    REQUIRE(settings::ParseFromString("--eventLoop true", settings));
+    REQUIRE(settings.eventLoop == true);
+
+    REQUIRE(settings::ParseFromString("--eventLoop uv", settings) == false);
+}
+
+TEST_CASE("Parsing timer slack settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.timerSlack == 0);
+    REQUIRE(settings.alignedIntervals == false);
+
+    REQUIRE(settings::ParseFromString("--timerSlack 20 --alignedIntervals true", settings));
+    REQUIRE(settings.timerSlack == 20);
+    REQUIRE(settings.alignedIntervals == true);
+
+    REQUIRE(settings::ParseFromString("--alignedIntervals sometimes", settings) == false);
+}
+
+TEST_CASE("Parsing zone allocator settings", "[settings-parser]") {
+    settings::ZoneSettings settings;
+    REQUIRE(settings.allocator == settings::AllocatorType::Default);
+    REQUIRE(settings.taskArenaChunkSize == 64 * 1024);
+
+    REQUIRE(settings::ParseFromString("--allocator pool --taskArenaChunkSize 16384", settings));
+    REQUIRE(settings.allocator == settings::AllocatorType::Pool);
+    REQUIRE(settings.taskArenaChunkSize == 16384);
+
+    REQUIRE(settings::ParseFromString("--allocator crt", settings));
+    REQUIRE(settings.allocator == settings::AllocatorType::Crt);
+
+    REQUIRE(settings::ParseFromString("--allocator arena", settings) == false);
+    REQUIRE(settings::ParseFromString("--taskArenaChunkSize 16", settings) == false);
+}
@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <napa/stl/flat-hash-map.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace napa::stl;
+
+namespace {
+    template <typename Key, typename T, typename Hash = std::hash<Key>>
+    using StdFlatHashMap = FlatHashMap<Key, T, Hash, std::equal_to<Key>, std::allocator<std::pair<Key, T>>>;
+
+    /// <summary> Puts all keys in the same slot, so every lookup probes. </summary>
+    struct CollidingHash {
+        size_t operator()(int) const {
+            return 42;
+        }
+    };
+}
+
+TEST_CASE("flat hash map inserts, finds and erases entries", "[flat-hash-map]") {
+    StdFlatHashMap<std::string, int> map;
+    REQUIRE(map.find("a") == map.end());
+    REQUIRE(map.erase("a") == 0);
+
+    map["a"] = 1;
+    REQUIRE(map.insert(std::make_pair(std::string("b"), 2)).second);
+    REQUIRE(!map.try_emplace("a", 10).second);
+
+    REQUIRE(map.size() == 2);
+    REQUIRE(map.at("a") == 1);
+    REQUIRE(map.find("b")->second == 2);
+    REQUIRE(map.count("c") == 0);
+    REQUIRE_THROWS_AS(map.at("c"), std::out_of_range);
+
+    REQUIRE(map.erase("a") == 1);
+    REQUIRE(map.size() == 1);
+    REQUIRE(map.find("a") == map.end());
+
+    map.erase(map.find("b"));
+    REQUIRE(map.empty());
+    REQUIRE(map.begin() == map.end());
+}
+
+TEST_CASE("flat hash map matches unordered_map under random updates", "[flat-hash-map]") {
+    StdFlatHashMap<uintptr_t, int> map;
+    std::unordered_map<uintptr_t, int> expected;
+
+    uint32_t seed = 12345;
+    for (int i = 0; i < 20000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        // Pointer like keys, 16 bytes aligned.
+        auto key = static_cast<uintptr_t>((seed >> 8) % 512) * 16;
+        if ((seed >> 4) % 3 == 0) {
+            REQUIRE(map.erase(key) == expected.erase(key));
+        } else {
+            map[key] = i;
+            expected[key] = i;
+        }
+        REQUIRE(map.size() == expected.size());
+    }
+
+    for (const auto& entry : expected) {
+        auto it = map.find(entry.first);
+        REQUIRE(it != map.end());
+        REQUIRE(it->second == entry.second);
+    }
+
+    size_t count = 0;
+    for (const auto& entry : map) {
+        REQUIRE(expected.at(entry.first) == entry.second);
+        ++count;
+    }
+    REQUIRE(count == expected.size());
+}
+
+TEST_CASE("flat hash map erases in colliding probe sequences", "[flat-hash-map]") {
+    StdFlatHashMap<int, int, CollidingHash> map;
+    for (int i = 0; i < 6; ++i) {
+        map[i] = i;
+    }
+
+    REQUIRE(map.erase(0) == 1);
+    REQUIRE(map.erase(3) == 1);
+    for (int i : { 1, 2, 4, 5 }) {
+        REQUIRE(map.at(i) == i);
+    }
+    REQUIRE(map.find(0) == map.end());
+    REQUIRE(map.find(3) == map.end());
+}
+
+TEST_CASE("flat hash map grows at 3/4 load and honors reserve", "[flat-hash-map]") {
+    StdFlatHashMap<int, int> map;
+    map.reserve(100);
+    auto buckets = map.bucket_count();
+    REQUIRE(buckets >= 134);
+
+    for (int i = 0; i < 100; ++i) {
+        map[i] = i;
+    }
+    REQUIRE(map.bucket_count() == buckets);
+
+    for (int i = 100; i < 1000; ++i) {
+        map[i] = i;
+    }
+    REQUIRE(map.size() == 1000);
+    REQUIRE(map.bucket_count() * 3 / 4 >= 1000);
+}
+
+TEST_CASE("flat hash map copies, moves and destroys entries", "[flat-hash-map]") {
+    auto value = std::make_shared<int>(1);
+    {
+        StdFlatHashMap<int, std::shared_ptr<int>> map;
+        for (int i = 0; i < 20; ++i) {
+            map[i] = value;
+        }
+        REQUIRE(value.use_count() == 21);
+
+        auto copy = map;
+        REQUIRE(value.use_count() == 41);
+        REQUIRE(copy.size() == 20);
+
+        StdFlatHashMap<int, std::shared_ptr<int>> moved(std::move(map));
+        REQUIRE(map.empty());
+        REQUIRE(moved.size() == 20);
+        REQUIRE(value.use_count() == 41);
+
+        copy = std::move(moved);
+        REQUIRE(value.use_count() == 21);
+
+        copy.clear();
+        REQUIRE(value.use_count() == 1);
+        copy[1] = value;
+    }
+    REQUIRE(value.use_count() == 1);
+}
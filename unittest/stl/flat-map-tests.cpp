@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <napa/stl/flat-map.h>
+
+#include <memory>
+#include <string>
+
+using namespace napa::stl;
+
+namespace {
+    template <typename Key, typename T>
+    using StdFlatMap = FlatMap<Key, T, std::less<Key>, std::allocator<std::pair<Key, T>>>;
+}
+
+TEST_CASE("flat map keeps entries sorted by key", "[flat-map]") {
+    StdFlatMap<int, std::string> map;
+
+    for (int key : { 5, 1, 4, 2, 3 }) {
+        REQUIRE(map.insert(std::make_pair(key, std::to_string(key))).second);
+    }
+    REQUIRE(map.size() == 5);
+
+    int expected = 1;
+    for (const auto& entry : map) {
+        REQUIRE(entry.first == expected);
+        REQUIRE(entry.second == std::to_string(expected));
+        ++expected;
+    }
+}
+
+TEST_CASE("flat map finds, replaces and erases entries", "[flat-map]") {
+    StdFlatMap<std::string, int> map;
+    map["b"] = 2;
+    map["a"] = 1;
+
+    REQUIRE(map.find("a")->second == 1);
+    REQUIRE(map.find("c") == map.end());
+    REQUIRE(map.count("b") == 1);
+    REQUIRE(map.at("b") == 2);
+    REQUIRE_THROWS_AS(map.at("c"), std::out_of_range);
+
+    auto result = map.insert(std::make_pair(std::string("a"), 10));
+    REQUIRE(!result.second);
+    REQUIRE(result.first->second == 1);
+
+    REQUIRE(map.try_emplace("c", 3).second);
+    REQUIRE(map.erase("b") == 1);
+    REQUIRE(map.erase("b") == 0);
+    REQUIRE(map.size() == 2);
+
+    auto next = map.erase(map.find("a"));
+    REQUIRE(next->first == "c");
+    REQUIRE(map.size() == 1);
+}
+
+TEST_CASE("flat map holds move-only values with napa allocators", "[flat-map]") {
+    struct Allocator : napa::memory::Allocator {
+        void* Allocate(size_t size) override { return ::operator new(size); }
+        void Deallocate(void* memory, size_t) override { ::operator delete(memory); }
+        const char* GetType() const override { return "Allocator"; }
+        bool operator==(const napa::memory::Allocator& other) const override { return &other == this; }
+    } allocator;
+
+    FlatMap<int, std::unique_ptr<int>> map{ napa::stl::Allocator<std::pair<int, std::unique_ptr<int>>>(allocator) };
+    map.try_emplace(2, new int(2));
+    map.try_emplace(1, new int(1));
+    map.insert(std::make_pair(3, std::unique_ptr<int>(new int(3))));
+
+    REQUIRE(map.size() == 3);
+    REQUIRE(*map.at(1) == 1);
+    REQUIRE(*map.begin()->second == 1);
+    REQUIRE(*map[3] == 3);
+}
@@ -0,0 +1,138 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <napa/stl/small-vector.h>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+using namespace napa::stl;
+
+namespace {
+    /// <summary> Counts the allocations made through it. </summary>
+    class CountingAllocator : public napa::memory::Allocator {
+    public:
+        void* Allocate(size_t size) override {
+            ++allocations;
+            ++outstanding;
+            return std::malloc(size);
+        }
+
+        void Deallocate(void* memory, size_t) override {
+            --outstanding;
+            std::free(memory);
+        }
+
+        const char* GetType() const override {
+            return "CountingAllocator";
+        }
+
+        bool operator==(const napa::memory::Allocator& other) const override {
+            return &other == this;
+        }
+
+        size_t allocations = 0;
+        size_t outstanding = 0;
+    };
+
+    template <typename T, size_t N>
+    using CountingSmallVector = SmallVector<T, N, Allocator<T>>;
+}
+
+TEST_CASE("small vector keeps up to N elements in place", "[small-vector]") {
+    CountingAllocator counting;
+    CountingSmallVector<std::string, 4> vector{ Allocator<std::string>(counting) };
+
+    for (int i = 0; i < 4; ++i) {
+        vector.push_back(std::to_string(i));
+    }
+    REQUIRE(vector.is_inline());
+    REQUIRE(vector.size() == 4);
+    REQUIRE(vector.capacity() == 4);
+    REQUIRE(counting.allocations == 0);
+
+    vector.emplace_back("4");
+    REQUIRE(!vector.is_inline());
+    REQUIRE(vector.capacity() == 8);
+    REQUIRE(counting.allocations == 1);
+    for (int i = 0; i < 5; ++i) {
+        REQUIRE(vector[i] == std::to_string(i));
+    }
+
+    vector.clear();
+    REQUIRE(vector.empty());
+}
+
+TEST_CASE("small vector returns its storage to the allocator", "[small-vector]") {
+    CountingAllocator counting;
+    {
+        CountingSmallVector<std::shared_ptr<int>, 2> vector{ Allocator<std::shared_ptr<int>>(counting) };
+        for (int i = 0; i < 10; ++i) {
+            vector.push_back(std::make_shared<int>(i));
+        }
+        REQUIRE(counting.outstanding == 1);
+    }
+    REQUIRE(counting.outstanding == 0);
+}
+
+TEST_CASE("small vector inserts and erases in the middle", "[small-vector]") {
+    SmallVector<int, 2, std::allocator<int>> vector{ 1, 2, 4 };
+
+    auto it = vector.insert(vector.begin() + 2, 3);
+    REQUIRE(*it == 3);
+    REQUIRE(vector.size() == 4);
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(vector[i] == i + 1);
+    }
+
+    it = vector.erase(vector.begin());
+    REQUIRE(*it == 2);
+    it = vector.erase(vector.begin() + 1, vector.end());
+    REQUIRE(it == vector.end());
+    REQUIRE(vector.size() == 1);
+    REQUIRE(vector.back() == 2);
+    REQUIRE_THROWS_AS(vector.at(1), std::out_of_range);
+}
+
+TEST_CASE("small vector appends one of its own elements while growing", "[small-vector]") {
+    SmallVector<std::string, 1, std::allocator<std::string>> vector;
+    vector.push_back("value");
+    vector.push_back(vector[0]);
+
+    REQUIRE(vector.size() == 2);
+    REQUIRE(vector[1] == "value");
+}
+
+TEST_CASE("small vector copies and moves inline and heap elements", "[small-vector]") {
+    using Vector = SmallVector<std::unique_ptr<int>, 2, std::allocator<std::unique_ptr<int>>>;
+
+    Vector inlineVector;
+    inlineVector.emplace_back(new int(1));
+    Vector movedInline(std::move(inlineVector));
+    REQUIRE(inlineVector.empty());
+    REQUIRE(movedInline.is_inline());
+    REQUIRE(*movedInline[0] == 1);
+
+    Vector heapVector;
+    for (int i = 0; i < 3; ++i) {
+        heapVector.emplace_back(new int(i));
+    }
+    auto data = heapVector.data();
+    Vector movedHeap;
+    movedHeap = std::move(heapVector);
+    REQUIRE(heapVector.empty());
+    REQUIRE(heapVector.is_inline());
+    REQUIRE(movedHeap.data() == data);
+    REQUIRE(*movedHeap[2] == 2);
+
+    SmallVector<int, 2, std::allocator<int>> values{ 1, 2, 3 };
+    auto copy = values;
+    copy.resize(5);
+    REQUIRE(values.size() == 3);
+    REQUIRE(copy.size() == 5);
+    REQUIRE(copy[2] == 3);
+    REQUIRE(copy[4] == 0);
+}
@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <napa/memory/common.h>
+#include <napa/stl/static-allocator.h>
+
+#include <cstdlib>
+#include <list>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace napa::stl;
+
+namespace {
+    /// <summary> Counts the allocations made through it. </summary>
+    struct CountingPolicy {
+        static void* Allocate(size_t size) {
+            ++allocations;
+            ++outstanding;
+            return std::malloc(size);
+        }
+
+        static void Deallocate(void* memory, size_t) {
+            --outstanding;
+            std::free(memory);
+        }
+
+        static size_t allocations;
+        static size_t outstanding;
+    };
+
+    size_t CountingPolicy::allocations = 0;
+    size_t CountingPolicy::outstanding = 0;
+
+    template <typename T>
+    using CountingAllocator = StaticAllocator<T, CountingPolicy>;
+}
+
+TEST_CASE("static allocator takes no space and instances are equal", "[static-allocator]") {
+    bool isEmpty = std::is_empty<CountingAllocator<int>>::value;
+    REQUIRE(isEmpty);
+
+    CountingAllocator<int> first;
+    CountingAllocator<std::string> second(first);
+    REQUIRE(first == CountingAllocator<int>());
+    REQUIRE(!(second != CountingAllocator<std::string>()));
+}
+
+TEST_CASE("static allocator serves containers from its policy", "[static-allocator]") {
+    auto allocations = CountingPolicy::allocations;
+    {
+        std::vector<std::string, CountingAllocator<std::string>> values;
+        for (int i = 0; i < 100; ++i) {
+            values.emplace_back(std::to_string(i));
+        }
+        REQUIRE(values[42] == "42");
+        REQUIRE(CountingPolicy::allocations > allocations);
+
+        // Nodes are allocated through the rebound allocator.
+        std::list<int, CountingAllocator<int>> nodes = { 1, 2, 3 };
+        REQUIRE(nodes.size() == 3);
+        REQUIRE(CountingPolicy::outstanding > 0);
+    }
+    REQUIRE(CountingPolicy::outstanding == 0);
+}
+
+TEST_CASE("MakeShared and MakeUnique allocate from a policy", "[static-allocator]") {
+    auto allocations = CountingPolicy::allocations;
+    {
+        auto shared = napa::memory::MakeShared<std::string, CountingPolicy>("shared");
+        REQUIRE(*shared == "shared");
+        REQUIRE(CountingPolicy::allocations == allocations + 1);
+
+        auto unique = napa::memory::MakeUnique<std::string, CountingPolicy>("unique");
+        REQUIRE(*unique == "unique");
+        REQUIRE(CountingPolicy::allocations == allocations + 2);
+    }
+    REQUIRE(CountingPolicy::outstanding == 0);
+}
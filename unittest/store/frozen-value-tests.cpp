@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <store/frozen-value.h>
+
+#include <string>
+
+using namespace napa::store;
+
+namespace {
+    std::shared_ptr<FrozenValue> Freeze(const std::string& json) {
+        return FrozenValue::FromJson(json.data(), json.size());
+    }
+
+    std::string GetString(const FrozenValue& value, uint32_t node) {
+        return std::string(value.GetString(node), value.GetCount(node));
+    }
+}
+
+TEST_CASE("frozen value reads scalars", "[frozen-value]") {
+    auto value = Freeze("[null, false, true, 1.5, -2, \"text\", \"\"]");
+    REQUIRE(value != nullptr);
+
+    auto root = value->GetRoot();
+    REQUIRE(value->GetKind(root) == FrozenValueKind::Array);
+    REQUIRE(value->GetCount(root) == 7);
+    REQUIRE(value->GetKind(value->GetElement(root, 0)) == FrozenValueKind::Null);
+    REQUIRE(value->GetKind(value->GetElement(root, 1)) == FrozenValueKind::False);
+    REQUIRE(value->GetKind(value->GetElement(root, 2)) == FrozenValueKind::True);
+    REQUIRE(value->GetNumber(value->GetElement(root, 3)) == 1.5);
+    REQUIRE(value->GetNumber(value->GetElement(root, 4)) == -2);
+    REQUIRE(GetString(*value, value->GetElement(root, 5)) == "text");
+    REQUIRE(GetString(*value, value->GetElement(root, 6)) == "");
+    REQUIRE(value->GetElement(root, 7) == FrozenValue::NOT_FOUND);
+
+    for (uint32_t i = 0; i < 7; ++i) {
+        REQUIRE(value->IsNode(value->GetElement(root, i)));
+    }
+    REQUIRE(!value->IsNode(4));
+    REQUIRE(!value->IsNode(static_cast<uint32_t>(value->GetByteLength())));
+}
+
+TEST_CASE("frozen value finds properties by key and keeps their order", "[frozen-value]") {
+    auto value = Freeze("{\"zeta\": 1, \"alpha\": {\"nested\": [2]}, \"mid\": \"zeta\", \"al\": null}");
+    REQUIRE(value != nullptr);
+
+    auto root = value->GetRoot();
+    REQUIRE(value->GetKind(root) == FrozenValueKind::Object);
+    REQUIRE(value->GetCount(root) == 4);
+    REQUIRE(GetString(*value, value->GetPropertyKey(root, 0)) == "zeta");
+    REQUIRE(GetString(*value, value->GetPropertyKey(root, 1)) == "alpha");
+    REQUIRE(GetString(*value, value->GetPropertyKey(root, 3)) == "al");
+
+    REQUIRE(value->GetNumber(value->FindProperty(root, "zeta", 4)) == 1);
+    REQUIRE(value->GetKind(value->FindProperty(root, "al", 2)) == FrozenValueKind::Null);
+    REQUIRE(value->FindProperty(root, "a", 1) == FrozenValue::NOT_FOUND);
+    REQUIRE(value->FindProperty(root, "omega", 5) == FrozenValue::NOT_FOUND);
+
+    auto alpha = value->FindProperty(root, "alpha", 5);
+    auto nested = value->FindProperty(alpha, "nested", 6);
+    REQUIRE(value->GetKind(nested) == FrozenValueKind::Array);
+    REQUIRE(value->GetNumber(value->GetElement(nested, 0)) == 2);
+
+    SECTION("equal strings share a node") {
+        REQUIRE(value->GetPropertyKey(root, 0) == value->FindProperty(root, "mid", 3));
+    }
+}
+
+TEST_CASE("frozen value shares strings of repeated keys", "[frozen-value]") {
+    std::string json = "[";
+    for (int i = 0; i < 100; ++i) {
+        json += (i > 0 ? "," : "");
+        json += "{\"featureName\": " + std::to_string(i) + "}";
+    }
+    json += "]";
+
+    auto value = Freeze(json);
+    REQUIRE(value != nullptr);
+
+    // The root takes 8 + 400 bytes, each object 24 with padding and its number 16, the key 24 once.
+    REQUIRE(value->GetByteLength() == 408 + 100 * 40 + 24);
+    auto root = value->GetRoot();
+    REQUIRE(value->GetNumber(value->FindProperty(value->GetElement(root, 99), "featureName", 11)) == 99);
+}
+
+TEST_CASE("frozen value rejects invalid and deeply nested JSON", "[frozen-value]") {
+    REQUIRE(Freeze("{\"a\": ") == nullptr);
+    REQUIRE(Freeze("[1] 2") == nullptr);
+    REQUIRE(Freeze("") == nullptr);
+
+    std::string deep(FrozenValue::MAX_DEPTH + 1, '[');
+    deep += std::string(FrozenValue::MAX_DEPTH + 1, ']');
+    REQUIRE(Freeze(deep) == nullptr);
+
+    std::string allowed(FrozenValue::MAX_DEPTH, '[');
+    allowed += std::string(FrozenValue::MAX_DEPTH, ']');
+    REQUIRE(Freeze(allowed) != nullptr);
+}
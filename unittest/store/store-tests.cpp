@@ -0,0 +1,1031 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <store/store.h>
+#include <store/payload-table.h>
+#include <store/shared-store.h>
+#include <platform/process.h>
+#include <platform/shared-memory.h>
+
+#include <napa/memory/allocator.h>
+#include <providers/nop-metric-provider.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace napa::store;
+
+namespace {
+    /// <summary> The tests don't link napa's allocators, transport contexts of values allocate from the CRT. </summary>
+    class TestAllocator : public napa::memory::Allocator {
+    public:
+        void* Allocate(size_t size) override {
+            return std::malloc(size);
+        }
+
+        void Deallocate(void* memory, size_t) override {
+            std::free(memory);
+        }
+
+        const char* GetType() const override {
+            return "TestAllocator";
+        }
+
+        bool operator==(const Allocator& other) const override {
+            return std::strcmp(other.GetType(), GetType()) == 0;
+        }
+    };
+
+    std::shared_ptr<Store::ValueType> MakeValue(const std::u16string& payload) {
+        auto value = std::make_shared<Store::ValueType>();
+        value->payload = payload;
+        return value;
+    }
+
+    std::shared_ptr<Store::ValueType> MakeOneByteValue(const std::string& payload) {
+        auto value = std::make_shared<Store::ValueType>();
+        value->oneBytePayload = payload;
+        return value;
+    }
+
+    void TestStoreOperations(uint32_t shards) {
+        StoreOptions options;
+        options.shards = shards;
+        auto store = CreateStore(("store-operations-" + std::to_string(shards)).c_str(), options);
+        REQUIRE(store != nullptr);
+
+        for (int i = 0; i < 100; ++i) {
+            auto key = "key" + std::to_string(i);
+            store->Set(key.c_str(), MakeValue(u"value"));
+        }
+        REQUIRE(store->Size() == 100);
+        REQUIRE(store->Has("key42"));
+        REQUIRE(store->Get("key42")->payload == u"value");
+
+        store->Set("key42", MakeValue(u"updated"));
+        REQUIRE(store->Size() == 100);
+        REQUIRE(store->Get("key42")->payload == u"updated");
+
+        store->Delete("key42");
+        REQUIRE(store->Size() == 99);
+        REQUIRE(!store->Has("key42"));
+        REQUIRE(store->Get("key42") == nullptr);
+    }
+
+    void TestStoreScans(bool ordered) {
+        StoreOptions options;
+        options.shards = 4;
+        options.ordered = ordered;
+        auto store = CreateStore(ordered ? "store-scans-ordered" : "store-scans", options);
+
+        for (int i = 0; i < 20; ++i) {
+            auto key = "bucket:" + std::to_string(100 + i);
+            store->Set(key.c_str(), MakeOneByteValue(std::to_string(i)));
+        }
+        store->Set("bucket:expired", MakeValue(u"expired"), 1);
+        int64_t counter = 0;
+        store->Increment("counter", 5, counter);
+        store->Delete("bucket:105");
+        store->Set("bucket:110", MakeOneByteValue("replaced"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+        auto keys = store->Keys("bucket:");
+        REQUIRE(keys.size() == 19);
+        REQUIRE(std::is_sorted(keys.begin(), keys.end()));
+        REQUIRE(keys.front() == "bucket:100");
+        REQUIRE(std::find(keys.begin(), keys.end(), "bucket:105") == keys.end());
+        REQUIRE(store->Keys("").size() == 20);
+        REQUIRE(store->Keys("missing").empty());
+
+        auto entries = store->Range("bucket:108", "bucket:112");
+        REQUIRE(entries.size() == 4);
+        REQUIRE(entries[0].first == "bucket:108");
+        REQUIRE(entries[2].first == "bucket:110");
+        REQUIRE(entries[2].second->oneBytePayload == "replaced");
+        REQUIRE(entries[3].first == "bucket:111");
+
+        entries = store->Range("c", "");
+        REQUIRE(entries.size() == 1);
+        REQUIRE(entries[0].second->oneBytePayload == "5");
+    }
+}
+
+napa::memory::Allocator& napa::memory::GetDefaultAllocator() {
+    static TestAllocator allocator;
+    return allocator;
+}
+
+napa::providers::MetricProvider& napa::providers::GetMetricProvider() {
+    static NopMetricProvider provider;
+    return provider;
+}
+
+TEST_CASE("store works with any number of shards.", "[store]") {
+    SECTION("one shard") {
+        TestStoreOperations(1);
+    }
+
+    SECTION("multiple shards") {
+        TestStoreOperations(16);
+    }
+
+    SECTION("shards out of range are clamped") {
+        TestStoreOperations(0);
+        TestStoreOperations(MAX_STORE_SHARDS + 1);
+    }
+}
+
+TEST_CASE("store assigns a new version to every value set.", "[store]") {
+    auto store = CreateStore("store-versions");
+    auto other = CreateStore("store-versions-other");
+
+    auto first = MakeValue(u"first");
+    store->Set("key", first);
+    auto second = MakeValue(u"second");
+    other->Set("key", second);
+    auto third = MakeValue(u"first");
+    store->Set("key", third);
+
+    REQUIRE(first->version != 0);
+    REQUIRE(second->version > first->version);
+    REQUIRE(third->version > second->version);
+    REQUIRE(store->Get("key")->version == third->version);
+}
+
+TEST_CASE("get or create store applies options only when creating.", "[store]") {
+    StoreOptions options;
+    options.shards = 8;
+    auto store = GetOrCreateStore("store-get-or-create", options);
+    REQUIRE(store != nullptr);
+    REQUIRE(GetOrCreateStore("store-get-or-create") == store);
+    REQUIRE(store->GetOptions().shards == 8);
+    REQUIRE(CreateStore("store-get-or-create", options) == nullptr);
+}
+
+TEST_CASE("sharded store serves concurrent readers and writers.", "[store]") {
+    StoreOptions options;
+    options.shards = 16;
+    auto store = CreateStore("store-concurrent", options);
+    store->Set("config", MakeValue(u"config"));
+
+    // Catch assertions aren't thread safe, readers count the values they miss instead.
+    std::atomic<int> misses(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([store, t]() {
+            for (int i = 0; i < 1000; ++i) {
+                auto key = "key" + std::to_string(t) + "-" + std::to_string(i);
+                store->Set(key.c_str(), MakeValue(u"value"));
+            }
+        });
+        threads.emplace_back([store, &misses]() {
+            for (int i = 0; i < 1000; ++i) {
+                auto value = store->Get("config");
+                if (value == nullptr || value->payload != u"config") {
+                    misses++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(misses == 0);
+    REQUIRE(store->Size() == 4001);
+}
+
+TEST_CASE("store drops values after their time to live.", "[store]") {
+    auto store = CreateStore("store-ttl");
+    store->Set("short", MakeValue(u"short"), 1);
+    store->Set("long", MakeValue(u"long"), 60 * 1000);
+    store->Set("forever", MakeValue(u"forever"));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    REQUIRE(store->Get("short") == nullptr);
+    REQUIRE(!store->Has("short"));
+    REQUIRE(store->Get("long")->payload == u"long");
+    REQUIRE(store->Get("forever")->payload == u"forever");
+
+    auto statistics = store->GetStatistics();
+    REQUIRE(statistics.hits == 2);
+    REQUIRE(statistics.misses == 1);
+}
+
+TEST_CASE("store evicts values to stay within its byte budget.", "[store]") {
+    StoreOptions options;
+    options.maxBytes = 1024;
+    auto store = CreateStore("store-max-bytes", options);
+
+    // Each value takes 4 bytes of key and 64 bytes of payload.
+    std::u16string payload(32, u'x');
+    store->Set("hot0", MakeValue(payload));
+    for (int i = 0; i < 100; ++i) {
+        store->Get("hot0");
+        auto key = "k" + std::to_string(i % 10) + std::to_string(i / 10 % 10) + "x";
+        store->Set(key.c_str(), MakeValue(payload));
+    }
+
+    auto statistics = store->GetStatistics();
+    REQUIRE(statistics.bytes <= options.maxBytes);
+    REQUIRE(statistics.evictions > 0);
+    REQUIRE(store->Size() < 101);
+    REQUIRE(store->Has("hot0"));
+}
+
+TEST_CASE("store counts one-byte payloads at one byte per character.", "[store]") {
+    auto store = CreateStore("store-one-byte");
+    store->Set("wide", MakeValue(u"value"));
+    REQUIRE(store->GetStatistics().bytes == 4 + 10);
+
+    store->Set("wide", MakeOneByteValue("value"));
+    REQUIRE(store->GetStatistics().bytes == 4 + 5);
+    REQUIRE(store->Get("wide")->IsOneByte());
+}
+
+TEST_CASE("store accounts bytes of keys, payloads and shared objects.", "[store]") {
+    auto store = CreateStore("store-accounting");
+    store->Set("key", MakeOneByteValue("value"));
+
+    auto shared = MakeOneByteValue("buffer");
+    shared->transportContext.SaveShared(std::make_shared<int>(1), 1024);
+    shared->transportContext.SaveShared(std::make_shared<int>(2), 512);
+    store->Set("shared", shared);
+
+    auto statistics = store->GetStatistics();
+    REQUIRE(statistics.keyBytes == 3 + 6);
+    REQUIRE(statistics.payloadBytes == 5 + 6);
+    REQUIRE(statistics.bytes == statistics.keyBytes + statistics.payloadBytes);
+    REQUIRE(statistics.sharedObjects == 2);
+    REQUIRE(statistics.sharedObjectBytes == 1024 + 512);
+
+    // Replacing and deleting values takes them out of the counts.
+    store->Set("shared", MakeOneByteValue("v"));
+    statistics = store->GetStatistics();
+    REQUIRE(statistics.payloadBytes == 5 + 1);
+    REQUIRE(statistics.sharedObjects == 0);
+    REQUIRE(statistics.sharedObjectBytes == 0);
+
+    store->Delete("key");
+    store->Delete("shared");
+    statistics = store->GetStatistics();
+    REQUIRE(statistics.bytes == 0);
+    REQUIRE(statistics.keyBytes == 0);
+}
+
+TEST_CASE("get stores returns living stores in order of their ids.", "[store]") {
+    auto second = CreateStore("store-list-b");
+    auto first = CreateStore("store-list-a");
+
+    auto stores = GetStores();
+    REQUIRE(stores.size() == GetStoreCount());
+
+    auto firstIt = std::find(stores.begin(), stores.end(), first);
+    auto secondIt = std::find(stores.begin(), stores.end(), second);
+    REQUIRE(firstIt != stores.end());
+    REQUIRE(secondIt != stores.end());
+    REQUIRE(firstIt < secondIt);
+
+    // A store is gone once the last reference to it is.
+    stores.clear();
+    second.reset();
+    stores = GetStores();
+    auto found = std::any_of(stores.begin(), stores.end(), [](const std::shared_ptr<Store>& store) {
+        return std::strcmp(store->GetId(), "store-list-b") == 0;
+    });
+    REQUIRE(!found);
+}
+
+TEST_CASE("store sets and gets many values at once.", "[store]") {
+    StoreOptions options;
+    options.shards = 4;
+    auto store = CreateStore("store-many", options);
+
+    Store::EntryList entries;
+    for (int i = 0; i < 50; ++i) {
+        entries.emplace_back("key" + std::to_string(i), MakeValue(u"value" + std::u16string(1, u'a' + i % 26)));
+    }
+    store->SetMany(entries, 0);
+    REQUIRE(store->Size() == 50);
+
+    auto values = store->GetMany({ "key3", "missing", "key29", "key3" });
+    REQUIRE(values.size() == 4);
+    REQUIRE(values[0]->payload == u"valued");
+    REQUIRE(values[1] == nullptr);
+    REQUIRE(values[2]->payload == u"valued");
+    REQUIRE(values[3] == values[0]);
+
+    auto statistics = store->GetStatistics();
+    REQUIRE(statistics.hits == 3);
+    REQUIRE(statistics.misses == 1);
+}
+
+TEST_CASE("store scans keys and ranges in order.", "[store]") {
+    SECTION("ordered store") {
+        TestStoreScans(true);
+    }
+
+    SECTION("unordered store") {
+        TestStoreScans(false);
+    }
+}
+
+TEST_CASE("store keeps numbers updated atomically.", "[store]") {
+    auto store = CreateStore("store-numbers");
+
+    SECTION("integer numbers") {
+        int64_t result = 0;
+        REQUIRE(store->Increment("counter", 1, result));
+        REQUIRE(result == 1);
+        REQUIRE(store->Increment("counter", 41, result));
+        REQUIRE(result == 42);
+        REQUIRE(store->Get("counter")->oneBytePayload == "42");
+
+        double value = 0;
+        REQUIRE(store->Add("counter", 1.0, value));
+        REQUIRE(value == 43.0);
+        REQUIRE(!store->Add("counter", 0.5, value));
+
+        REQUIRE(!store->CompareAndSet("counter", 42.0, 0.0));
+        REQUIRE(store->CompareAndSet("counter", 43.0, 100.0));
+        REQUIRE(store->GetNumber("counter", value));
+        REQUIRE(value == 100.0);
+    }
+
+    SECTION("floating point numbers") {
+        double value = 0;
+        REQUIRE(store->Add("quota", 0.5, value));
+        REQUIRE(store->Add("quota", 0.25, value));
+        REQUIRE(value == 0.75);
+        REQUIRE(store->Get("quota")->oneBytePayload == "0.75");
+
+        int64_t result = 0;
+        REQUIRE(!store->Increment("quota", 1, result));
+        REQUIRE(store->CompareAndSet("quota", 0.75, 1.5));
+        REQUIRE(store->GetNumber("quota", value));
+        REQUIRE(value == 1.5);
+    }
+
+    SECTION("values are not numbers") {
+        store->Set("value", MakeValue(u"1"));
+        int64_t result = 0;
+        double value = 0;
+        REQUIRE(!store->Increment("value", 1, result));
+        REQUIRE(!store->GetNumber("value", value));
+        REQUIRE(!store->GetNumber("missing", value));
+        REQUIRE(!store->CompareAndSet("missing", 0.0, 1.0));
+    }
+
+    SECTION("concurrent increments") {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([store]() {
+                int64_t result;
+                for (int i = 0; i < 10000; ++i) {
+                    store->Increment("shared", 1, result);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        double value = 0;
+        REQUIRE(store->GetNumber("shared", value));
+        REQUIRE(value == 40000.0);
+    }
+}
+
+TEST_CASE("store snapshots load into another store.", "[store]") {
+    const std::string filename("store-snapshot-test.snap");
+    std::remove(filename.c_str());
+
+    StoreOptions options;
+    options.shards = 4;
+    auto store = CreateStore("store-snapshot", options);
+    for (int i = 0; i < 100; ++i) {
+        auto key = "key" + std::to_string(i);
+        store->Set(key.c_str(), MakeValue(u"value" + std::u16string(i % 7, u'\u4e2d')));
+    }
+    store->Set("expiring", MakeValue(u"expiring"), 60 * 1000);
+    store->Set("compact", MakeOneByteValue("caf\xe9"));
+    int64_t counter = 0;
+    store->Increment("counter", 42, counter);
+    double ratio = 0;
+    store->Add("ratio", 0.5, ratio);
+
+    auto shared = MakeValue(u"shared");
+    shared->transportContext.SaveShared(std::make_shared<int>(1));
+    store->Set("shared", shared);
+
+    size_t saved = 0;
+    REQUIRE(store->Snapshot(filename.c_str(), saved));
+    REQUIRE(saved == 104);
+
+    SECTION("values and numbers are loaded") {
+        auto loadedStore = CreateStore("store-snapshot-loaded");
+        loadedStore->Set("key0", MakeValue(u"overwritten"));
+
+        size_t loaded = 0;
+        REQUIRE(loadedStore->Load(filename.c_str(), loaded));
+        REQUIRE(loaded == 104);
+        REQUIRE(loadedStore->Size() == 104);
+        REQUIRE(loadedStore->Get("key0")->payload == u"value");
+        REQUIRE(loadedStore->Get("key13")->payload == store->Get("key13")->payload);
+        REQUIRE(loadedStore->Get("expiring")->payload == u"expiring");
+        REQUIRE(loadedStore->Get("compact")->oneBytePayload == "caf\xe9");
+        REQUIRE(!loadedStore->Has("shared"));
+
+        double value = 0;
+        REQUIRE(loadedStore->GetNumber("counter", value));
+        REQUIRE(value == 42.0);
+        REQUIRE(loadedStore->GetNumber("ratio", value));
+        REQUIRE(value == 0.5);
+        REQUIRE(!loadedStore->Increment("ratio", 1, counter));
+    }
+
+    SECTION("truncated snapshots load nothing") {
+        std::string content;
+        {
+            std::ifstream file(filename, std::ios::binary);
+            content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+        {
+            std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+            file.write(content.data(), content.size() / 2);
+        }
+
+        auto loadedStore = CreateStore("store-snapshot-truncated");
+        size_t loaded = 0;
+        REQUIRE(!loadedStore->Load(filename.c_str(), loaded));
+        REQUIRE(loadedStore->Size() == 0);
+    }
+
+    SECTION("missing snapshots fail to load") {
+        size_t loaded = 0;
+        REQUIRE(!store->Load("store-snapshot-missing.snap", loaded));
+    }
+
+    std::remove(filename.c_str());
+}
+
+TEST_CASE("store values over the compression threshold are kept compressed.", "[store]") {
+    std::string json;
+    for (int i = 0; i < 100; ++i) {
+        json += "{\"id\":" + std::to_string(i) + ",\"name\":\"item\"},";
+    }
+
+    SECTION("one-byte payloads") {
+        auto value = MakeOneByteValue(json);
+        value->Compress(64);
+        REQUIRE(value->IsCompressed());
+        REQUIRE(!value->IsOneByte());
+        REQUIRE(value->oneBytePayload.empty());
+        REQUIRE(value->GetPayloadBytes() < json.size());
+
+        std::string oneByte;
+        std::u16string twoByte;
+        REQUIRE(value->Decompress(oneByte, twoByte));
+        REQUIRE(oneByte == json);
+        REQUIRE(twoByte.empty());
+    }
+
+    SECTION("two-byte payloads") {
+        std::u16string payload(json.begin(), json.end());
+        payload += u"\u4e2d";
+        auto value = MakeValue(payload);
+        value->Compress(64);
+        REQUIRE(value->IsCompressed());
+        REQUIRE(value->payload.empty());
+
+        std::string oneByte;
+        std::u16string twoByte;
+        REQUIRE(value->Decompress(oneByte, twoByte));
+        REQUIRE(twoByte == payload);
+    }
+
+    SECTION("payloads under the threshold are kept as they are") {
+        auto value = MakeOneByteValue(json);
+        value->Compress(json.size() + 1);
+        REQUIRE(!value->IsCompressed());
+        REQUIRE(value->oneBytePayload == json);
+    }
+
+    SECTION("snapshots keep payloads uncompressed and loading compresses them again") {
+        const std::string filename("store-compression-test.snap");
+        std::remove(filename.c_str());
+
+        StoreOptions options;
+        options.compressionThreshold = 64;
+        auto store = CreateStore("store-compression", options);
+        auto value = MakeOneByteValue(json);
+        value->Compress(options.compressionThreshold);
+        store->Set("compressed", value);
+        store->Set("small", MakeOneByteValue("small"));
+
+        size_t saved = 0;
+        REQUIRE(store->Snapshot(filename.c_str(), saved));
+        REQUIRE(saved == 2);
+
+        auto uncompressedStore = CreateStore("store-compression-uncompressed");
+        size_t loaded = 0;
+        REQUIRE(uncompressedStore->Load(filename.c_str(), loaded));
+        REQUIRE(uncompressedStore->Get("compressed")->oneBytePayload == json);
+        REQUIRE(uncompressedStore->Get("small")->oneBytePayload == "small");
+
+        auto compressedStore = CreateStore("store-compression-compressed", options);
+        REQUIRE(compressedStore->Load(filename.c_str(), loaded));
+        REQUIRE(compressedStore->Get("compressed")->IsCompressed());
+        REQUIRE(!compressedStore->Get("small")->IsCompressed());
+
+        std::remove(filename.c_str());
+    }
+}
+
+TEST_CASE("interning stores keep equal payloads once.", "[store]") {
+    StoreOptions options;
+    options.intern = true;
+    auto store = CreateStore("store-intern", options);
+    auto otherStore = CreateStore("store-intern-other", options);
+
+    SECTION("keys and stores share the value of an equal payload") {
+        store->Set("a", MakeOneByteValue("{\"config\":1}"));
+        store->Set("b", MakeOneByteValue("{\"config\":1}"));
+        otherStore->Set("c", MakeOneByteValue("{\"config\":1}"));
+        store->Set("d", MakeValue(u"{\"config\":1}"));
+
+        auto value = store->Get("a");
+        REQUIRE(value->interned);
+        REQUIRE(store->Get("b") == value);
+        REQUIRE(otherStore->Get("c") == value);
+        REQUIRE(store->Get("d") != value);
+
+        // The version stays with the payload, setting it again doesn't change it.
+        auto version = value->version;
+        store->Set("a", MakeOneByteValue("{\"config\":1}"));
+        REQUIRE(store->Get("a")->version == version);
+        REQUIRE(store->GetStatistics().payloadBytes == 2 * value->GetPayloadBytes() + store->Get("d")->GetPayloadBytes());
+    }
+
+    SECTION("setMany and load intern values") {
+        store->SetMany({
+            { "x", MakeOneByteValue("[1,2,3]") },
+            { "y", MakeOneByteValue("[1,2,3]") } }, 0);
+        REQUIRE(store->Get("x") == store->Get("y"));
+
+        const std::string filename("store-intern-test.snap");
+        size_t saved = 0;
+        REQUIRE(store->Snapshot(filename.c_str(), saved));
+        size_t loaded = 0;
+        REQUIRE(otherStore->Load(filename.c_str(), loaded));
+        REQUIRE(otherStore->Get("x") == store->Get("x"));
+        std::remove(filename.c_str());
+    }
+
+    SECTION("stores that don't intern keep their own values") {
+        auto plainStore = CreateStore("store-intern-plain");
+        plainStore->Set("a", MakeOneByteValue("{\"config\":2}"));
+        plainStore->Set("b", MakeOneByteValue("{\"config\":2}"));
+        REQUIRE(!plainStore->Get("a")->interned);
+        REQUIRE(plainStore->Get("a") != plainStore->Get("b"));
+    }
+
+    SECTION("payloads no longer held are swept from the table") {
+        auto& table = PayloadTable::Get();
+        table.Sweep();
+        auto size = table.Size();
+
+        store->Set("unique", MakeOneByteValue("\"only held by this key\""));
+        REQUIRE(table.Size() == size + 1);
+
+        store->Delete("unique");
+        table.Sweep();
+        REQUIRE(table.Size() == size);
+    }
+}
+
+TEST_CASE("store applies JSON merge patches to values.", "[store]") {
+    auto store = CreateStore("store-patch");
+
+    // Patches from RFC 7386, applied to the value of a key or to a missing key.
+    auto patch = [&store](const std::string& target, const std::u16string& patchJson) {
+        store->Delete("key");
+        if (!target.empty()) {
+            store->Set("key", MakeOneByteValue(target));
+        }
+        REQUIRE(store->Patch("key", patchJson));
+        return store->Get("key")->oneBytePayload;
+    };
+
+    SECTION("objects are merged, null members remove members") {
+        REQUIRE(patch("{\"a\":\"b\"}", u"{\"a\":\"c\"}") == "{\"a\":\"c\"}");
+        REQUIRE(patch("{\"a\":\"b\"}", u"{\"b\":\"c\"}") == "{\"a\":\"b\",\"b\":\"c\"}");
+        REQUIRE(patch("{\"a\":\"b\",\"b\":\"c\"}", u"{\"a\":null}") == "{\"b\":\"c\"}");
+        REQUIRE(patch("{\"a\":{\"b\":\"c\"}}", u"{\"a\":{\"b\":\"d\",\"c\":null}}") == "{\"a\":{\"b\":\"d\"}}");
+        REQUIRE(patch("{\"e\":null}", u"{\"a\":1}") == "{\"e\":null,\"a\":1}");
+        REQUIRE(patch("{}", u"{\"a\":{\"bb\":{\"ccc\":null}}}") == "{\"a\":{\"bb\":{}}}");
+    }
+
+    SECTION("patches that are not objects replace values") {
+        REQUIRE(patch("{\"a\":[{\"b\":\"c\"}]}", u"{\"a\":[1]}") == "{\"a\":[1]}");
+        REQUIRE(patch("[\"a\",\"b\"]", u"[\"c\",\"d\"]") == "[\"c\",\"d\"]");
+        REQUIRE(patch("{\"a\":\"foo\"}", u"\"bar\"") == "\"bar\"");
+        REQUIRE(patch("[1,2]", u"{\"a\":\"b\",\"c\":null}") == "{\"a\":\"b\"}");
+    }
+
+    SECTION("missing keys are set to the patch") {
+        REQUIRE(patch("", u"{\"a\":1.5,\"b\":null}") == "{\"a\":1.5}");
+    }
+
+    SECTION("patched values are in UTF-16 only if they need to be") {
+        store->Set("key", MakeValue(u"{\"a\":\"\u4e2d\"}"));
+        REQUIRE(store->Patch("key", u"{\"a\":\"\u00e9\"}"));
+        REQUIRE(store->Get("key")->oneBytePayload == "{\"a\":\"\xe9\"}");
+        REQUIRE(store->Patch("key", u"{\"b\":\"\u4e2d\"}"));
+        REQUIRE(store->Get("key")->payload == u"{\"a\":\"\u00e9\",\"b\":\"\u4e2d\"}");
+    }
+
+    SECTION("patches keep the time to live and change the version") {
+        store->Set("key", MakeOneByteValue("{}"), 60 * 1000);
+        auto version = store->Get("key")->version;
+        REQUIRE(store->Patch("key", u"{\"a\":1}"));
+        REQUIRE(store->Get("key")->version != version);
+
+        const std::string filename("store-patch-test.snap");
+        size_t saved = 0;
+        REQUIRE(store->Snapshot(filename.c_str(), saved));
+        std::ifstream file(filename, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+        std::remove(filename.c_str());
+        REQUIRE(content.find("{\"a\":1}") != std::string::npos);
+    }
+
+    SECTION("compressed values are patched") {
+        StoreOptions options;
+        options.compressionThreshold = 64;
+        auto compressedStore = CreateStore("store-patch-compressed", options);
+        std::string json = "{\"items\":[";
+        for (int i = 0; i < 100; ++i) {
+            json += (i == 0 ? "" : ",") + std::string("\"item\"");
+        }
+        json += "]}";
+        auto value = MakeOneByteValue(json);
+        value->Compress(options.compressionThreshold);
+        compressedStore->Set("key", value);
+
+        REQUIRE(compressedStore->Patch("key", u"{\"items\":null,\"count\":100}"));
+        auto patched = compressedStore->Get("key");
+        REQUIRE(!patched->IsCompressed());
+        REQUIRE(patched->oneBytePayload == "{\"count\":100}");
+    }
+
+    SECTION("numbers, shared objects and invalid JSON are not patched") {
+        int64_t result = 0;
+        store->Increment("counter", 1, result);
+        REQUIRE(!store->Patch("counter", u"{}"));
+
+        auto shared = MakeValue(u"{}");
+        shared->transportContext.SaveShared(std::make_shared<int>(1));
+        store->Set("shared", shared);
+        REQUIRE(!store->Patch("shared", u"{}"));
+
+        store->Set("key", MakeOneByteValue("{\"a\":1}"));
+        REQUIRE(!store->Patch("key", u"{\"a\":"));
+        REQUIRE(store->Get("key")->oneBytePayload == "{\"a\":1}");
+    }
+
+    SECTION("concurrent patches of different members all land") {
+        store->Set("key", MakeOneByteValue("{}"));
+        std::atomic<int> applied(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&store, &applied, t]() {
+                for (int i = 0; i < 50; ++i) {
+                    auto member = std::to_string(t * 50 + i);
+                    if (store->Patch("key", u"{\"" + std::u16string(member.begin(), member.end()) + u"\":true}")) {
+                        ++applied;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        REQUIRE(applied == 200);
+        auto payload = store->Get("key")->oneBytePayload;
+        REQUIRE(std::count(payload.begin(), payload.end(), ':') == 200);
+    }
+}
+
+TEST_CASE("store views read values as they were when they were created.", "[store]") {
+    StoreOptions options;
+    options.shards = 4;
+    auto store = CreateStore("store-view", options);
+    store->Set("a", MakeOneByteValue("1"));
+    store->Set("b", MakeOneByteValue("1"));
+    store->Set("deleted", MakeOneByteValue("1"));
+
+    auto view = store->CreateView();
+    REQUIRE(view != nullptr);
+
+    SECTION("writes after the view are not read by it") {
+        store->Set("a", MakeOneByteValue("2"));
+        store->SetMany({ { "b", MakeOneByteValue("2") }, { "created", MakeOneByteValue("2") } }, 0);
+        store->Delete("deleted");
+        REQUIRE(store->Patch("a", u"3"));
+
+        REQUIRE(view->Get("a")->oneBytePayload == "1");
+        REQUIRE(view->Get("b")->oneBytePayload == "1");
+        REQUIRE(view->Get("deleted")->oneBytePayload == "1");
+        REQUIRE(view->Get("created") == nullptr);
+        REQUIRE(!view->Has("created"));
+
+        auto values = view->GetMany({ "a", "created", "b" });
+        REQUIRE(values[0]->oneBytePayload == "1");
+        REQUIRE(values[1] == nullptr);
+        REQUIRE(values[2]->oneBytePayload == "1");
+
+        REQUIRE(store->Get("a")->oneBytePayload == "3");
+        REQUIRE(!store->Has("deleted"));
+
+        auto newerView = store->CreateView();
+        REQUIRE(newerView->Get("a")->oneBytePayload == "3");
+        REQUIRE(newerView->Get("created")->oneBytePayload == "2");
+        REQUIRE(!newerView->Has("deleted"));
+    }
+
+    SECTION("numbers replaced after the view are read as they were") {
+        int64_t result = 0;
+        store->Increment("counter", 5, result);
+        auto numberView = store->CreateView();
+        store->Set("counter", MakeOneByteValue("\"text\""));
+        REQUIRE(numberView->Get("counter")->oneBytePayload == "5");
+        REQUIRE(view->Get("counter") == nullptr);
+    }
+
+    SECTION("all writes of a writer before the view are read by it") {
+        std::atomic<bool> stop(false);
+        std::thread writer([&store, &stop]() {
+            // From the values set above, so b is never newer than a before the first write of a.
+            for (int i = 1; !stop; ++i) {
+                auto value = std::to_string(i);
+                store->Set("a", MakeOneByteValue(value));
+                store->Set("b", MakeOneByteValue(value));
+            }
+        });
+
+        // b is written after a, so a view never reads b newer than a.
+        auto consistent = true;
+        for (int i = 0; i < 1000; ++i) {
+            auto readView = store->CreateView();
+            auto b = std::stoll(readView->Get("b")->oneBytePayload);
+            auto a = std::stoll(readView->Get("a")->oneBytePayload);
+            consistent = consistent && b <= a && a <= b + 1;
+        }
+        stop = true;
+        writer.join();
+        REQUIRE(consistent);
+    }
+
+    SECTION("stores in shared memory have no views") {
+        auto id = std::string(SHARED_STORE_PREFIX) + "view-" + std::to_string(napa::platform::Getpid());
+        auto sharedStore = CreateStore(id.c_str());
+        REQUIRE(sharedStore != nullptr);
+        REQUIRE(sharedStore->CreateView() == nullptr);
+        napa::platform::RemoveSharedMemory("napa-store-view-" + std::to_string(napa::platform::Getpid()));
+    }
+}
+
+TEST_CASE("store runs one load of a missing key at a time.", "[store]") {
+    auto store = CreateStore("store-load");
+
+    std::string moduleName;
+    std::string functionName;
+    uint32_t ttl = 0;
+    REQUIRE(!store->GetLoader(moduleName, functionName, ttl));
+    store->SetLoader("loader-module", "load", 1000, DEFAULT_LOAD_WAIT_TIMEOUT);
+    REQUIRE(store->GetLoader(moduleName, functionName, ttl));
+    REQUIRE(moduleName == "loader-module");
+    REQUIRE(functionName == "load");
+    REQUIRE(ttl == 1000);
+
+    SECTION("callers of other threads wait for the load and share its value") {
+        std::shared_ptr<Store::ValueType> value;
+        std::string error;
+        REQUIRE(store->BeginLoad("key", value, error) == Store::LoadStatus::LOAD);
+        REQUIRE(store->BeginLoad("key", value, error) == Store::LoadStatus::REENTERED);
+
+        constexpr size_t WAITERS = 4;
+        std::atomic<size_t> shared(0);
+        std::vector<std::thread> waiters;
+        for (size_t i = 0; i < WAITERS; ++i) {
+            waiters.emplace_back([&store, &shared]() {
+                std::shared_ptr<Store::ValueType> loaded;
+                std::string loadError;
+                if (store->BeginLoad("key", loaded, loadError) == Store::LoadStatus::LOADED
+                    && loaded != nullptr && loaded->oneBytePayload == "1") {
+                    ++shared;
+                }
+            });
+        }
+        while (store->GetStatistics().loadWaits != WAITERS) {
+            std::this_thread::yield();
+        }
+
+        auto loaded = MakeOneByteValue("1");
+        store->Set("key", loaded);
+        store->EndLoad("key", loaded, "");
+        for (auto& waiter : waiters) {
+            waiter.join();
+        }
+        REQUIRE(shared == WAITERS);
+
+        auto statistics = store->GetStatistics();
+        REQUIRE(statistics.loads == 1);
+        REQUIRE(statistics.loadWaits == WAITERS);
+
+        // The next miss begins a new load.
+        REQUIRE(store->BeginLoad("key", value, error) == Store::LoadStatus::LOAD);
+        store->EndLoad("key", nullptr, "");
+    }
+
+    SECTION("callers waiting for a failed load get its error") {
+        std::shared_ptr<Store::ValueType> value;
+        std::string error;
+        REQUIRE(store->BeginLoad("key", value, error) == Store::LoadStatus::LOAD);
+
+        Store::LoadStatus status = Store::LoadStatus::LOAD;
+        std::thread waiter([&store, &status, &error]() {
+            std::shared_ptr<Store::ValueType> loaded;
+            status = store->BeginLoad("key", loaded, error);
+        });
+        while (store->GetStatistics().loadWaits != 1) {
+            std::this_thread::yield();
+        }
+        store->EndLoad("key", nullptr, "Error: backend is down");
+        waiter.join();
+
+        REQUIRE(status == Store::LoadStatus::FAILED);
+        REQUIRE(error == "Error: backend is down");
+    }
+
+    SECTION("loaders of two keys getting each other's key don't wait for each other") {
+        std::shared_ptr<Store::ValueType> value;
+        std::string error;
+        REQUIRE(store->BeginLoad("second", value, error) == Store::LoadStatus::LOAD);
+
+        // The other thread loads the first key, and waits for the second one from its loader.
+        Store::LoadStatus firstStatus = Store::LoadStatus::LOADED;
+        Store::LoadStatus status = Store::LoadStatus::LOAD;
+        std::shared_ptr<Store::ValueType> loaded;
+        std::thread loader([&store, &firstStatus, &status, &loaded]() {
+            std::shared_ptr<Store::ValueType> value;
+            std::string error;
+            firstStatus = store->BeginLoad("first", value, error);
+            status = store->BeginLoad("second", loaded, error);
+            store->EndLoad("first", nullptr, "");
+        });
+        while (store->GetStatistics().loadWaits != 1) {
+            std::this_thread::yield();
+        }
+
+        // Waiting for the first key would wait for this thread.
+        REQUIRE(store->BeginLoad("first", value, error) == Store::LoadStatus::CYCLE);
+
+        store->EndLoad("second", MakeOneByteValue("2"), "");
+        loader.join();
+        REQUIRE(firstStatus == Store::LoadStatus::LOAD);
+        REQUIRE(status == Store::LoadStatus::LOADED);
+        REQUIRE(loaded != nullptr);
+        REQUIRE(loaded->oneBytePayload == "2");
+        REQUIRE(store->GetStatistics().loadWaits == 1);
+    }
+
+    SECTION("callers stop waiting for a load after the wait timeout") {
+        store->SetLoader("loader-module", "load", 1000, 10);
+
+        std::shared_ptr<Store::ValueType> value;
+        std::string error;
+        REQUIRE(store->BeginLoad("key", value, error) == Store::LoadStatus::LOAD);
+
+        Store::LoadStatus status = Store::LoadStatus::LOAD;
+        std::thread waiter([&store, &status]() {
+            std::shared_ptr<Store::ValueType> loaded;
+            std::string loadError;
+            status = store->BeginLoad("key", loaded, loadError);
+        });
+        waiter.join();
+        REQUIRE(status == Store::LoadStatus::TIMEDOUT);
+
+        // The load goes on, and ends like one that was waited for.
+        store->EndLoad("key", nullptr, "");
+        REQUIRE(store->BeginLoad("key", value, error) == Store::LoadStatus::LOAD);
+        store->EndLoad("key", nullptr, "");
+    }
+}
+
+TEST_CASE("store notifies watchers of changed keys.", "[store]") {
+    auto store = CreateStore("store-watch");
+
+    std::vector<std::string> keyChanges;
+    std::vector<std::string> prefixChanges;
+    auto keyWatch = store->Watch("config", [&keyChanges](const std::string& key) { keyChanges.push_back(key); });
+    auto prefixWatch = store->Watch("config.*", [&prefixChanges](const std::string& key) { prefixChanges.push_back(key); });
+    REQUIRE(keyWatch != prefixWatch);
+
+    store->Set("config", MakeValue(u"1"));
+    store->Set("config.timeout", MakeValue(u"2"));
+    store->SetMany({ { "config.retries", MakeValue(u"3") }, { "other", MakeValue(u"4") } }, 0);
+    int64_t result = 0;
+    store->Increment("config.version", 1, result);
+    store->Delete("config.timeout");
+    store->Delete("missing");
+
+    REQUIRE(keyChanges == std::vector<std::string>({ "config" }));
+    REQUIRE(prefixChanges == std::vector<std::string>({ "config.timeout", "config.retries", "config.version", "config.timeout" }));
+
+    store->Unwatch(prefixWatch);
+    store->Set("config.timeout", MakeValue(u"5"));
+    REQUIRE(prefixChanges.size() == 4);
+}
+
+TEST_CASE("shared stores share values through named shared memory.", "[store]") {
+    const std::string name("napa-store-unittest-" + std::to_string(napa::platform::Getpid()));
+    napa::platform::RemoveSharedMemory(name);
+
+    StoreOptions options;
+    options.maxBytes = 64 * 1024;
+    auto id = std::string(SHARED_STORE_PREFIX) + "unittest-" + std::to_string(napa::platform::Getpid());
+    auto store = CreateStore(id.c_str(), options);
+    REQUIRE(store != nullptr);
+
+    // A second mapping of the segment stands for another process.
+    auto other = CreateSharedStore(id.c_str(), StoreOptions());
+    REQUIRE(other != nullptr);
+    REQUIRE(other->GetOptions().maxBytes == options.maxBytes);
+
+    SECTION("values are seen by all mappings") {
+        store->Set("key", MakeOneByteValue("value"));
+        other->Set("wide", MakeValue(u"\u4e2d"));
+        REQUIRE(other->Get("key")->oneBytePayload == "value");
+        REQUIRE(store->Get("wide")->payload == u"\u4e2d");
+
+        other->Set("key", MakeOneByteValue("updated"));
+        REQUIRE(store->Get("key")->oneBytePayload == "updated");
+        REQUIRE(store->Size() == 2);
+        REQUIRE(store->Keys("") == std::vector<std::string>({ "key", "wide" }));
+
+        store->Delete("key");
+        REQUIRE(!other->Has("key"));
+        REQUIRE(other->Size() == 1);
+    }
+
+    SECTION("numbers are updated in place") {
+        int64_t result = 0;
+        REQUIRE(store->Increment("counter", 2, result));
+        REQUIRE(other->Increment("counter", 3, result));
+        REQUIRE(result == 5);
+        REQUIRE(store->CompareAndSet("counter", 5.0, 7.0));
+
+        double value = 0;
+        REQUIRE(other->GetNumber("counter", value));
+        REQUIRE(value == 7.0);
+        REQUIRE(other->Get("counter")->oneBytePayload == "7");
+    }
+
+    SECTION("values are patched by all mappings") {
+        store->Set("doc", MakeOneByteValue("{\"a\":1,\"b\":2}"));
+        REQUIRE(other->Patch("doc", u"{\"b\":null,\"c\":\"\u4e2d\"}"));
+        REQUIRE(store->Get("doc")->payload == u"{\"a\":1,\"c\":\"\u4e2d\"}");
+
+        int64_t result = 0;
+        REQUIRE(store->Increment("counter", 1, result));
+        REQUIRE(!other->Patch("counter", u"{}"));
+    }
+
+    SECTION("values that don't fit are dropped") {
+        store->Set("large", MakeOneByteValue(std::string(128 * 1024, 'x')));
+        REQUIRE(!store->Has("large"));
+
+        auto shared = MakeValue(u"shared");
+        shared->transportContext.SaveShared(std::make_shared<int>(1));
+        store->Set("shared", shared);
+        REQUIRE(!other->Has("shared"));
+        REQUIRE(store->GetStatistics().evictions == 2);
+    }
+
+    REQUIRE(napa::platform::RemoveSharedMemory(name));
+}
@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <napa/transport/transport-context.h>
+
+using namespace napa::transport;
+
+TEST_CASE("transport context loads shared pointers with their external size", "[transport-context]") {
+    TransportContext context;
+    auto object = std::make_shared<int>(1);
+    auto handle = reinterpret_cast<uintptr_t>(object.get());
+
+    context.SaveShared(object, 1024);
+    REQUIRE(context.LoadShared<int>(handle) == object);
+    REQUIRE(context.GetExternalSize(handle) == 1024);
+
+    SECTION("unknown handles have no external size") {
+        REQUIRE(context.LoadShared<int>(handle + 1) == nullptr);
+        REQUIRE(context.GetExternalSize(handle + 1) == 0);
+    }
+
+    SECTION("shared contexts keep the external size") {
+        auto shared = context.Share();
+        REQUIRE(shared->LoadShared<int>(handle) == object);
+        REQUIRE(shared->GetExternalSize(handle) == 1024);
+        REQUIRE(object.use_count() == 3);
+    }
+
+    SECTION("contexts share the pointers of other contexts") {
+        TransportContext other;
+        auto otherObject = std::make_shared<int>(2);
+        other.SaveShared(otherObject);
+
+        context.ShareFrom(other);
+        REQUIRE(context.GetSharedCount() == 2);
+        REQUIRE(context.LoadShared<int>(reinterpret_cast<uintptr_t>(otherObject.get())) == otherObject);
+        REQUIRE(other.GetSharedCount() == 1);
+    }
+
+    SECTION("saving again replaces the external size") {
+        context.SaveShared(object);
+        REQUIRE(context.GetExternalSize(handle) == 0);
+        REQUIRE(context.GetSharedCount() == 1);
+    }
+}
@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <utils/console-buffer.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace napa::utils;
+using namespace std::chrono_literals;
+
+namespace {
+
+    /// <summary> Output of a console buffer, as the writes it got. </summary>
+    struct Output {
+        std::mutex mutex;
+        std::vector<std::string> writes;
+
+        std::function<void(const std::string&)> Writer() {
+            return [this](const std::string& text) {
+                std::lock_guard<std::mutex> lock(mutex);
+                writes.push_back(text);
+            };
+        }
+
+        std::string Text() {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::string text;
+            for (const auto& write : writes) {
+                text += write;
+            }
+            return text;
+        }
+
+        size_t WriteCount() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return writes.size();
+        }
+    };
+
+    ConsoleBufferOptions SlowFlush(size_t flushSize) {
+        ConsoleBufferOptions options;
+        options.flushSize = flushSize;
+        options.flushInterval = 1h;
+        return options;
+    }
+}
+
+TEST_CASE("console buffer writes lines through until started", "[console-buffer]") {
+    Output output;
+    ConsoleBuffer buffer(output.Writer());
+
+    buffer.WriteLine("hello");
+    buffer.WriteLine("world");
+
+    REQUIRE(!buffer.IsStarted());
+    REQUIRE(output.WriteCount() == 2);
+    REQUIRE(output.Text() == "hello\nworld\n");
+}
+
+TEST_CASE("console buffer writes lines of a flush in one write", "[console-buffer]") {
+    Output output;
+    ConsoleBuffer buffer(output.Writer());
+    buffer.Start(SlowFlush(1024));
+
+    buffer.WriteLine("a");
+    buffer.WriteLine("b");
+    REQUIRE(output.WriteCount() == 0);
+
+    buffer.Flush();
+    REQUIRE(output.WriteCount() == 1);
+    REQUIRE(output.Text() == "a\nb\n");
+}
+
+TEST_CASE("console buffer writes buffers once they reach the flush size", "[console-buffer]") {
+    Output output;
+    ConsoleBuffer buffer(output.Writer());
+    buffer.Start(SlowFlush(16));
+
+    buffer.WriteLine("0123456789abcdef");
+    for (int i = 0; i < 100 && output.WriteCount() == 0; ++i) {
+        std::this_thread::sleep_for(10ms);
+    }
+    REQUIRE(output.Text() == "0123456789abcdef\n");
+}
+
+TEST_CASE("console buffer writes buffers every flush interval", "[console-buffer]") {
+    Output output;
+    ConsoleBuffer buffer(output.Writer());
+    ConsoleBufferOptions options;
+    options.flushInterval = 5ms;
+    buffer.Start(options);
+
+    buffer.WriteLine("tick");
+    for (int i = 0; i < 100 && output.WriteCount() == 0; ++i) {
+        std::this_thread::sleep_for(10ms);
+    }
+    REQUIRE(output.Text() == "tick\n");
+}
+
+TEST_CASE("console buffer writes pending lines when stopped", "[console-buffer]") {
+    Output output;
+    ConsoleBuffer buffer(output.Writer());
+    buffer.Start(SlowFlush(1024));
+
+    buffer.WriteLine("pending");
+    buffer.Stop();
+    REQUIRE(!buffer.IsStarted());
+    REQUIRE(output.Text() == "pending\n");
+
+    buffer.WriteLine("after");
+    REQUIRE(output.Text() == "pending\nafter\n");
+}
+
+TEST_CASE("console buffer keeps the order of lines of each thread", "[console-buffer]") {
+    Output output;
+    {
+        ConsoleBuffer buffer(output.Writer());
+        ConsoleBufferOptions options;
+        options.flushSize = 64;
+        options.flushInterval = 1ms;
+        buffer.Start(options);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&buffer, t]() {
+                for (int i = 0; i < 1000; ++i) {
+                    buffer.WriteLine(std::to_string(t) + " " + std::to_string(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    std::map<int, int> next;
+    std::istringstream lines(output.Text());
+    int thread;
+    int index;
+    size_t count = 0;
+    while (lines >> thread >> index) {
+        REQUIRE(index == next[thread]);
+        next[thread]++;
+        count++;
+    }
+    REQUIRE(count == 4000);
+}
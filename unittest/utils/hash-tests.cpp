@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <utils/hash.h>
+
+#include <cstdio>
+#include <random>
+#include <string>
+
+using namespace napa;
+using namespace napa::utils;
+
+namespace {
+
+    std::string ToHex(const std::array<uint8_t, hash::SHA256_DIGEST_SIZE>& digest) {
+        std::string hex;
+        char digits[3];
+        for (auto byte : digest) {
+            std::snprintf(digits, sizeof(digits), "%02x", byte);
+            hex += digits;
+        }
+        return hex;
+    }
+
+    std::string Sha256(const std::string& input) {
+        return ToHex(hash::Sha256(input.data(), input.size()));
+    }
+
+    /// <summary> CRC-32C computed bit by bit, as the reference of the table and hardware implementations. </summary>
+    uint32_t BitwiseCrc32c(const std::string& input) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (auto c : input) {
+            crc ^= static_cast<uint8_t>(c);
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (0x82F63B78 & (0 - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+
+    std::string RandomBytes(size_t size) {
+        std::mt19937 random(42);
+        std::string bytes(size, '\0');
+        for (auto& byte : bytes) {
+            byte = static_cast<char>(random());
+        }
+        return bytes;
+    }
+}
+
+TEST_CASE("xxHash matches the reference implementation", "[hash]") {
+    REQUIRE(hash::XxHash64("", 0) == 0xEF46DB3751D8E999ULL);
+    REQUIRE(hash::XxHash64("abc", 3) == 0x44BC2CF5AD770999ULL);
+
+    std::string sentence = "Nobody inspects the spammish repetition";
+    REQUIRE(hash::XxHash64(sentence.data(), sentence.size()) == 0xFBCEA83C8A378BF1ULL);
+
+    // Seeds and lengths make other hashes.
+    REQUIRE(hash::XxHash64("abc", 3, 1) != hash::XxHash64("abc", 3));
+    REQUIRE(hash::XxHash64("abc", 2) != hash::XxHash64("abc", 3));
+    REQUIRE(hash::HashRoutingKey("abc", 3) == hash::XxHash64("abc", 3));
+}
+
+TEST_CASE("CRC-32C matches the reference implementation", "[hash]") {
+    REQUIRE(hash::Crc32c("", 0) == 0);
+    REQUIRE(hash::Crc32c("123456789", 9) == 0xE3069283);
+
+    std::string zeros(32, '\0');
+    REQUIRE(hash::Crc32c(zeros.data(), zeros.size()) == 0x8A9136AA);
+
+    auto bytes = RandomBytes(300);
+    for (size_t length = 0; length <= bytes.size(); length++) {
+        auto part = bytes.substr(0, length);
+        REQUIRE(hash::Crc32c(part.data(), part.size()) == BitwiseCrc32c(part));
+    }
+
+    SECTION("CRC of data in parts") {
+        auto whole = hash::Crc32c(bytes.data(), bytes.size());
+        for (size_t split : { 0, 1, 7, 8, 100, 299, 300 }) {
+            auto crc = hash::Crc32c(bytes.data(), split);
+            REQUIRE(hash::Crc32c(bytes.data() + split, bytes.size() - split, crc) == whole);
+        }
+    }
+}
+
+TEST_CASE("SHA-256 matches the reference implementation", "[hash]") {
+    REQUIRE(Sha256("") == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    REQUIRE(Sha256("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    REQUIRE(Sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")
+        == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    // Messages around the lengths that need another block for padding.
+    REQUIRE(Sha256(std::string(55, 'a')) == "9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318");
+    REQUIRE(Sha256(std::string(56, 'a')) == "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a");
+    REQUIRE(Sha256(std::string(64, 'a')) == "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb");
+    REQUIRE(Sha256(std::string(1000, 'a')) == "41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3");
+}
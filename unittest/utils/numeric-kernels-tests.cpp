@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <utils/numeric-kernels.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace napa::utils::numeric;
+
+namespace {
+    const InstructionSet ALL_INSTRUCTION_SETS[] = {
+        InstructionSet::Scalar, InstructionSet::Sse2, InstructionSet::Avx2, InstructionSet::Neon
+    };
+
+    const Kernels<float>* GetKernels(InstructionSet instructionSet, float) {
+        return GetFloatKernels(instructionSet);
+    }
+
+    const Kernels<double>* GetKernels(InstructionSet instructionSet, double) {
+        return GetDoubleKernels(instructionSet);
+    }
+
+    template <typename T>
+    std::vector<T> MakeValues(size_t count, uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<T> distribution(-10, 10);
+        std::vector<T> values(count);
+        for (auto& value : values) {
+            value = distribution(random);
+        }
+        return values;
+    }
+
+    /// <summary> Check the kernels of each instruction set the CPU has against loops. </summary>
+    template <typename T>
+    void CheckKernels() {
+        for (auto instructionSet : ALL_INSTRUCTION_SETS) {
+            auto kernels = GetKernels(instructionSet, T());
+            if (kernels == nullptr) {
+                continue;
+            }
+            INFO("Instruction set: " << GetInstructionSetName(instructionSet));
+
+            // Lengths around multiples of the vector lengths exercise the loops and their tails.
+            for (size_t count = 0; count <= 70; count++) {
+                INFO("Count: " << count);
+                auto left = MakeValues<T>(count, static_cast<uint32_t>(count));
+                auto right = MakeValues<T>(count, static_cast<uint32_t>(count + 1000));
+
+                // Kernels add in another order, within rounding errors of the magnitudes added.
+                double sum = 0;
+                double sumMagnitude = 0;
+                double dot = 0;
+                double dotMagnitude = 0;
+                for (size_t i = 0; i < count; i++) {
+                    sum += left[i];
+                    sumMagnitude += std::abs(left[i]);
+                    dot += static_cast<double>(left[i]) * right[i];
+                    dotMagnitude += std::abs(static_cast<double>(left[i]) * right[i]);
+                }
+                REQUIRE(std::abs(kernels->sum(left.data(), count) - sum) <= 1e-5 * sumMagnitude);
+                REQUIRE(std::abs(kernels->dot(left.data(), right.data(), count) - dot) <= 1e-5 * dotMagnitude);
+
+                if (count > 0) {
+                    T minimum = left[0];
+                    T maximum = left[0];
+                    for (auto value : left) {
+                        minimum = std::min(minimum, value);
+                        maximum = std::max(maximum, value);
+                    }
+                    REQUIRE(kernels->minimum(left.data(), count) == minimum);
+                    REQUIRE(kernels->maximum(left.data(), count) == maximum);
+                }
+
+                auto scaled = left;
+                kernels->scale(scaled.data(), count, 2.5);
+                for (size_t i = 0; i < count; i++) {
+                    REQUIRE(scaled[i] == static_cast<T>(left[i] * static_cast<T>(2.5)));
+                }
+
+                auto y = right;
+                kernels->axpy(3, left.data(), y.data(), count);
+                for (size_t i = 0; i < count; i++) {
+                    REQUIRE(y[i] == Approx(3 * left[i] + right[i]).epsilon(1e-5));
+                }
+            }
+        }
+    }
+
+    template <typename T>
+    void CheckNaN() {
+        for (auto instructionSet : ALL_INSTRUCTION_SETS) {
+            auto kernels = GetKernels(instructionSet, T());
+            if (kernels == nullptr) {
+                continue;
+            }
+            INFO("Instruction set: " << GetInstructionSetName(instructionSet));
+
+            for (size_t position : { 0, 5, 16, 32 }) {
+                auto values = MakeValues<T>(33, 7);
+                values[position] = std::numeric_limits<T>::quiet_NaN();
+                REQUIRE(std::isnan(kernels->minimum(values.data(), values.size())));
+                REQUIRE(std::isnan(kernels->maximum(values.data(), values.size())));
+                REQUIRE(std::isnan(kernels->sum(values.data(), values.size())));
+            }
+
+            T infinities[] = { 1, -std::numeric_limits<T>::infinity(), std::numeric_limits<T>::infinity(), 2, 3, 4, 5, 6, 7 };
+            REQUIRE(kernels->minimum(infinities, 9) == -std::numeric_limits<T>::infinity());
+            REQUIRE(kernels->maximum(infinities, 9) == std::numeric_limits<T>::infinity());
+        }
+    }
+}
+
+TEST_CASE("numeric kernels match loops for floats", "[numeric-kernels]") {
+    CheckKernels<float>();
+}
+
+TEST_CASE("numeric kernels match loops for doubles", "[numeric-kernels]") {
+    CheckKernels<double>();
+}
+
+TEST_CASE("numeric kernels find NaN and infinities like Math.min and Math.max", "[numeric-kernels]") {
+    CheckNaN<float>();
+    CheckNaN<double>();
+}
+
+TEST_CASE("numeric kernels of the best instruction set are supported", "[numeric-kernels]") {
+    auto best = GetBestInstructionSet();
+    REQUIRE(GetFloatKernels(best) == &GetFloatKernels());
+    REQUIRE(GetDoubleKernels(best) == &GetDoubleKernels());
+    REQUIRE(GetFloatKernels(InstructionSet::Scalar) != nullptr);
+
+#if defined(__x86_64__) || defined(_M_X64)
+    REQUIRE(best != InstructionSet::Scalar);
+    REQUIRE(GetFloatKernels(InstructionSet::Neon) == nullptr);
+#endif
+}
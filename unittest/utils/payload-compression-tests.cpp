@@ -0,0 +1,184 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <utils/lz4.h>
+#include <utils/payload-compression.h>
+
+#include <random>
+#include <vector>
+
+using namespace napa;
+
+namespace {
+
+    /// <summary> Compress bytes and decompress them back. </summary>
+    std::string RoundTrip(const std::string& input, size_t& compressedSize) {
+        std::vector<uint8_t> block(utils::lz4::CompressBound(input.size()));
+        compressedSize = utils::lz4::Compress(
+            reinterpret_cast<const uint8_t*>(input.data()), input.size(), block.data(), block.size());
+
+        std::string output(input.size(), '\0');
+        auto decompressed = utils::lz4::Decompress(
+            block.data(), compressedSize, reinterpret_cast<uint8_t*>(&output[0]), output.size());
+        return decompressed ? output : "<corrupted>";
+    }
+
+    std::string RandomBytes(size_t size) {
+        std::mt19937 random(42);
+        std::string bytes(size, '\0');
+        for (auto& byte : bytes) {
+            byte = static_cast<char>(random() & 0xFF);
+        }
+        return bytes;
+    }
+
+    std::string RepetitiveJson(size_t items) {
+        std::string json = "[";
+        for (size_t i = 0; i < items; ++i) {
+            json += "{\"id\":" + std::to_string(i) + ",\"name\":\"item\",\"tags\":[\"a\",\"b\"]},";
+        }
+        json.back() = ']';
+        return json;
+    }
+}
+
+TEST_CASE("lz4 round trips bytes", "[payload-compression]") {
+    size_t compressedSize = 0;
+
+    SECTION("Empty input") {
+        REQUIRE(RoundTrip("", compressedSize) == "");
+        REQUIRE(compressedSize == 1);
+    }
+
+    SECTION("Input shorter than a match") {
+        REQUIRE(RoundTrip("abc", compressedSize) == "abc");
+        REQUIRE(RoundTrip("abcdefghijklm", compressedSize) == "abcdefghijklm");
+    }
+
+    SECTION("Repetitive input shrinks") {
+        auto input = RepetitiveJson(1000);
+        REQUIRE(RoundTrip(input, compressedSize) == input);
+        REQUIRE(compressedSize < input.size() / 4);
+    }
+
+    SECTION("Runs of a single byte overlap their matches") {
+        std::string input(100000, 'x');
+        REQUIRE(RoundTrip(input, compressedSize) == input);
+        REQUIRE(compressedSize < 1000);
+    }
+
+    SECTION("Random input stays within the bound") {
+        auto input = RandomBytes(70000);
+        REQUIRE(RoundTrip(input, compressedSize) == input);
+        REQUIRE(compressedSize <= utils::lz4::CompressBound(input.size()));
+    }
+
+    SECTION("Matches farther than the largest offset are not used") {
+        auto block = RandomBytes(1000);
+        auto input = block + RandomBytes(70000).substr(1000) + block;
+        REQUIRE(RoundTrip(input, compressedSize) == input);
+    }
+
+    SECTION("A buffer smaller than the bound is rejected") {
+        auto input = RepetitiveJson(10);
+        std::vector<uint8_t> block(utils::lz4::CompressBound(input.size()) - 1);
+        REQUIRE(utils::lz4::Compress(
+            reinterpret_cast<const uint8_t*>(input.data()), input.size(), block.data(), block.size()) == 0);
+    }
+}
+
+TEST_CASE("lz4 rejects corrupted blocks", "[payload-compression]") {
+    auto input = RepetitiveJson(100);
+    std::vector<uint8_t> block(utils::lz4::CompressBound(input.size()));
+    auto blockSize = utils::lz4::Compress(
+        reinterpret_cast<const uint8_t*>(input.data()), input.size(), block.data(), block.size());
+    std::string output(input.size(), '\0');
+    auto destination = reinterpret_cast<uint8_t*>(&output[0]);
+
+    SECTION("Truncated block") {
+        REQUIRE_FALSE(utils::lz4::Decompress(block.data(), blockSize - 1, destination, output.size()));
+        REQUIRE_FALSE(utils::lz4::Decompress(block.data(), blockSize / 2, destination, output.size()));
+    }
+
+    SECTION("Wrong decompressed size") {
+        REQUIRE_FALSE(utils::lz4::Decompress(block.data(), blockSize, destination, output.size() - 1));
+    }
+
+    SECTION("Offset before the start of the output") {
+        // A literal, then a match 2 bytes back.
+        uint8_t corrupted[] = { 0x10, 'a', 0x02, 0x00, 0x00 };
+        uint8_t small[16];
+        REQUIRE_FALSE(utils::lz4::Decompress(corrupted, sizeof(corrupted), small, sizeof(small)));
+    }
+
+    SECTION("Literals past the end of the block") {
+        uint8_t corrupted[] = { 0xF0, 0xFF, 0xFF };
+        uint8_t small[16];
+        REQUIRE_FALSE(utils::lz4::Decompress(corrupted, sizeof(corrupted), small, sizeof(small)));
+    }
+
+    SECTION("Random bytes never write out of bounds") {
+        std::mt19937 random(7);
+        for (int i = 0; i < 1000; ++i) {
+            auto bytes = block;
+            bytes[random() % blockSize] = static_cast<uint8_t>(random());
+            (void)utils::lz4::Decompress(bytes.data(), blockSize, destination, output.size());
+        }
+    }
+}
+
+TEST_CASE("CompressPayload compresses payloads over the threshold", "[payload-compression]") {
+    auto json = RepetitiveJson(200);
+
+    SECTION("Payloads under the threshold are kept") {
+        auto payload = json;
+        REQUIRE_FALSE(utils::CompressPayload(payload, json.size() + 1, utils::PayloadSource::Call));
+        REQUIRE(payload == json);
+        REQUIRE_FALSE(utils::IsCompressedPayload(payload));
+    }
+
+    SECTION("Threshold 0 never compresses") {
+        auto payload = json;
+        REQUIRE_FALSE(utils::CompressPayload(payload, 0, utils::PayloadSource::Call));
+        REQUIRE(payload == json);
+    }
+
+    SECTION("Payloads over the threshold round trip") {
+        auto before = utils::GetPayloadCompressionStatistics();
+
+        auto payload = json;
+        REQUIRE(utils::CompressPayload(payload, 64, utils::PayloadSource::Call));
+        REQUIRE(utils::IsCompressedPayload(payload));
+        REQUIRE(payload.size() < json.size());
+        REQUIRE(utils::GetDecompressedSize(payload) == json.size());
+
+        auto after = utils::GetPayloadCompressionStatistics();
+        REQUIRE(after.compressedPayloads == before.compressedPayloads + 1);
+        REQUIRE(after.bytesBefore == before.bytesBefore + json.size());
+        REQUIRE(after.bytesAfter == before.bytesAfter + payload.size());
+
+        REQUIRE(utils::DecompressPayload(payload));
+        REQUIRE(payload == json);
+    }
+
+    SECTION("Payloads that don't shrink are kept") {
+        auto random = RandomBytes(4096);
+        auto payload = random;
+        REQUIRE_FALSE(utils::CompressPayload(payload, 64, utils::PayloadSource::Store));
+        REQUIRE(payload == random);
+    }
+
+    SECTION("Uncompressed payloads decompress to themselves") {
+        auto payload = json;
+        REQUIRE(utils::DecompressPayload(payload));
+        REQUIRE(payload == json);
+    }
+
+    SECTION("Corrupted payloads fail to decompress") {
+        auto payload = json;
+        REQUIRE(utils::CompressPayload(payload, 64, utils::PayloadSource::Call));
+        payload.resize(payload.size() - 4);
+        REQUIRE_FALSE(utils::DecompressPayload(payload));
+    }
+}
@@ -3,6 +3,7 @@
 
 #include <catch/catch.hpp>
 #include <utils/string.h>
+#include <napa/utils.h>
 
 using namespace napa;
 
@@ -81,4 +82,35 @@ TEST_CASE("utils", "[string]") {
         REQUIRE(utils::string::CaseInsensitiveEquals("abc", "ABc"));
         REQUIRE(!utils::string::CaseInsensitiveEquals("abc", "AB"));
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("utils detect ASCII strings", "[string]") {
+
+    SECTION("IsAscii - Empty and short strings") {
+        REQUIRE(utils::IsAscii("", 0));
+        REQUIRE(utils::IsAscii("abc", 3));
+        REQUIRE(!utils::IsAscii("caf\xe9", 4));
+    }
+
+    SECTION("IsAscii - Non-ASCII chars at every position") {
+        std::string str(100, 'a');
+        REQUIRE(utils::IsAscii(str.data(), str.size()));
+        for (size_t i = 0; i < str.size(); ++i) {
+            auto copy = str;
+            copy[i] = '\x80';
+            REQUIRE(!utils::IsAscii(copy.data(), copy.size()));
+            REQUIRE(utils::IsAscii(copy.data(), i));
+        }
+    }
+
+    SECTION("IsAscii - UTF-16 chars at every position") {
+        std::u16string str(50, u'a');
+        REQUIRE(utils::IsAscii(str.data(), str.size()));
+        for (size_t i = 0; i < str.size(); ++i) {
+            auto copy = str;
+            copy[i] = i % 2 == 0 ? u'\u00e9' : u'\u4e2d';
+            REQUIRE(!utils::IsAscii(copy.data(), copy.size()));
+            REQUIRE(utils::IsAscii(copy.data(), i));
+        }
+    }
+}
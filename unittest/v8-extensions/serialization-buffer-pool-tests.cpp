@@ -0,0 +1,66 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "v8-extensions/serialization-buffer-pool.h"
+
+#include <cstring>
+#include <thread>
+
+using namespace napa::v8_extensions;
+
+TEST_CASE("serialization buffer pool rounds buffers up to their blocks", "[serialization-buffer-pool]") {
+    size_t actualSize = 0;
+    auto buffer = SerializationBufferPool::Reallocate(nullptr, 100, &actualSize);
+    REQUIRE(buffer != nullptr);
+    REQUIRE(actualSize == 256 - 16);
+    REQUIRE(SerializationBufferPool::GetCapacity(buffer) == actualSize);
+    REQUIRE(reinterpret_cast<uintptr_t>(buffer) % 16 == 0);
+
+    SECTION("growing within the capacity keeps the buffer") {
+        REQUIRE(SerializationBufferPool::Reallocate(buffer, actualSize, &actualSize) == buffer);
+        SerializationBufferPool::Free(buffer);
+    }
+
+    SECTION("growing beyond the capacity keeps the contents") {
+        std::memset(buffer, 'x', actualSize);
+        auto oldSize = actualSize;
+        auto grown = static_cast<char*>(SerializationBufferPool::Reallocate(buffer, 1000, &actualSize));
+        REQUIRE(grown != nullptr);
+        REQUIRE(actualSize == 1024 - 16);
+        REQUIRE(grown[0] == 'x');
+        REQUIRE(grown[oldSize - 1] == 'x');
+        SerializationBufferPool::Free(grown);
+    }
+}
+
+TEST_CASE("serialization buffer pool reuses released blocks of the thread", "[serialization-buffer-pool]") {
+    size_t actualSize = 0;
+    auto buffer = SerializationBufferPool::Reallocate(nullptr, 4000, &actualSize);
+    SerializationBufferPool::Free(buffer);
+    REQUIRE(SerializationBufferPool::Reallocate(nullptr, 3000, &actualSize) == buffer);
+    REQUIRE(actualSize == 4096 - 16);
+
+    SECTION("other threads don't take the released block") {
+        SerializationBufferPool::Free(buffer);
+
+        void* other = nullptr;
+        std::thread thread([&other]() {
+            size_t size = 0;
+            other = SerializationBufferPool::Reallocate(nullptr, 3000, &size);
+            SerializationBufferPool::Free(other);
+        });
+        thread.join();
+        REQUIRE(other != buffer);
+        REQUIRE(SerializationBufferPool::Reallocate(nullptr, 3000, &actualSize) == buffer);
+        SerializationBufferPool::Free(buffer);
+    }
+
+    SECTION("buffers larger than the pooled blocks are exact") {
+        SerializationBufferPool::Free(buffer);
+        auto large = SerializationBufferPool::Reallocate(nullptr, 100000, &actualSize);
+        REQUIRE(actualSize == 100000);
+        SerializationBufferPool::Free(large);
+    }
+}
@@ -0,0 +1,80 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/async-lock.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace napa::zone;
+using namespace std::chrono_literals;
+
+TEST_CASE("async lock is exclusive", "[async-lock]") {
+    AsyncLock lock;
+
+    REQUIRE(lock.TryLock());
+    REQUIRE(!lock.TryLock());
+    REQUIRE(!lock.TryLockFor(10ms));
+
+    lock.Unlock();
+    REQUIRE(lock.TryLockFor(10ms));
+    lock.Unlock();
+}
+
+TEST_CASE("async lock runs a continuation right away when it's available", "[async-lock]") {
+    AsyncLock lock;
+
+    bool ran = false;
+    lock.LockAsync([&ran]() { ran = true; });
+    REQUIRE(ran);
+    REQUIRE(!lock.TryLock());
+
+    lock.Unlock();
+    REQUIRE(lock.TryLock());
+    lock.Unlock();
+}
+
+TEST_CASE("async lock hands itself to queued continuations in order", "[async-lock]") {
+    AsyncLock lock;
+    lock.Lock();
+
+    std::vector<int> order;
+    lock.LockAsync([&order]() { order.push_back(1); });
+    lock.LockAsync([&order]() { order.push_back(2); });
+    REQUIRE(order.empty());
+
+    lock.Unlock();
+    REQUIRE(order == std::vector<int>({ 1 }));
+    REQUIRE(!lock.TryLock());
+
+    lock.Unlock();
+    REQUIRE(order == std::vector<int>({ 1, 2 }));
+
+    lock.Unlock();
+    REQUIRE(lock.TryLock());
+    lock.Unlock();
+}
+
+TEST_CASE("async lock wakes up a blocked thread when it's released", "[async-lock]") {
+    AsyncLock lock;
+    lock.Lock();
+
+    std::atomic<bool> obtained(false);
+    auto waiter = std::async(std::launch::async, [&]() {
+        lock.Lock();
+        obtained = true;
+        lock.Unlock();
+    });
+
+    std::this_thread::sleep_for(20ms);
+    REQUIRE(!obtained);
+
+    // A thread other than the one that obtained the lock can release it.
+    std::thread([&lock]() { lock.Unlock(); }).join();
+    waiter.wait();
+    REQUIRE(obtained);
+}
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+// Stands in for napa/async.h in the tests of napa/zone/async-task.h, whose coroutines run on fake workers without V8.
+
+#include <functional>
+
+namespace napa {
+namespace zone {
+
+    using WorkerContinuation = std::function<void(std::function<void()>)>;
+
+    /// <summary> Returns a continuation to the current fake worker, or an empty function off the fake workers. </summary>
+    WorkerContinuation CreateWorkerContinuation();
+
+    /// <summary> Runs a function on the fake async work pool, false off the fake workers or when the pool is closed. </summary>
+    bool PostToAsyncWorkPool(std::function<void()> work);
+}
+}
@@ -0,0 +1,271 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+// Compiled as C++20 against the fakes of async-task-fakes/napa/async.h, see CMakeLists.txt.
+
+#include <catch/catch.hpp>
+
+#include <napa/zone/async-task.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> A thread running posted functions in order, standing in for a Napa worker or the async work pool. </summary>
+    class FakeLoop {
+    public:
+        FakeLoop() : _thread([this]() { Run(); }) {}
+
+        ~FakeLoop() {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stopping = true;
+            }
+            _ready.notify_one();
+            _thread.join();
+        }
+
+        void Post(std::function<void()> function) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _functions.push_back(std::move(function));
+            }
+            _ready.notify_one();
+        }
+
+        std::thread::id GetThreadId() const {
+            return _thread.get_id();
+        }
+
+        /// <summary> The loop the calling thread runs, nullptr off the fake loops. </summary>
+        static thread_local FakeLoop* current;
+
+    private:
+        void Run() {
+            current = this;
+            std::unique_lock<std::mutex> lock(_mutex);
+            while (true) {
+                _ready.wait(lock, [this]() { return _stopping || !_functions.empty(); });
+                if (_functions.empty()) {
+                    return;
+                }
+                auto function = std::move(_functions.front());
+                _functions.pop_front();
+                lock.unlock();
+                function();
+                lock.lock();
+            }
+        }
+
+        std::mutex _mutex;
+        std::condition_variable _ready;
+        std::deque<std::function<void()>> _functions;
+        bool _stopping = false;
+        std::thread _thread;
+    };
+
+    thread_local FakeLoop* FakeLoop::current = nullptr;
+
+    /// <summary> The async work pool of the fake workers, nullptr to refuse work as a busy runner would. </summary>
+    FakeLoop* _pool = nullptr;
+
+    /// <summary> Runs a detached coroutine on a worker, and waits for it to finish. </summary>
+    template <typename Coroutine>
+    void RunOnWorker(FakeLoop& worker, Coroutine coroutine) {
+        std::promise<void> finished;
+        worker.Post([&]() {
+            [](Coroutine coroutine, std::promise<void>& finished) -> AsyncTask<void> {
+                co_await coroutine();
+                finished.set_value();
+            }(coroutine, finished).Detach();
+        });
+        REQUIRE(finished.get_future().wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    }
+
+    AsyncTask<int> Add(int left, int right) {
+        auto sum = co_await RunAsync([left, right]() { return left + right; });
+        co_return sum;
+    }
+
+    AsyncTask<int> Fail() {
+        co_await RunAsync([]() -> int { throw std::runtime_error("failed in the pool"); });
+        co_return 0;
+    }
+}
+
+WorkerContinuation napa::zone::CreateWorkerContinuation() {
+    auto worker = FakeLoop::current;
+    if (worker == nullptr) {
+        return nullptr;
+    }
+    return [worker](std::function<void()> callback) { worker->Post(std::move(callback)); };
+}
+
+bool napa::zone::PostToAsyncWorkPool(std::function<void()> work) {
+    if (FakeLoop::current == nullptr || _pool == nullptr) {
+        return false;
+    }
+    _pool->Post(std::move(work));
+    return true;
+}
+
+TEST_CASE("async tasks run work in the pool and resume on the awaiting worker", "[async-task]") {
+    FakeLoop worker;
+    FakeLoop pool;
+    _pool = &pool;
+
+    std::thread::id workThread;
+    std::thread::id resumedThread;
+    int value = 0;
+    RunOnWorker(worker, [&]() -> AsyncTask<void> {
+        value = co_await RunAsync([&]() {
+            workThread = std::this_thread::get_id();
+            return 42;
+        });
+        resumedThread = std::this_thread::get_id();
+    });
+
+    REQUIRE(value == 42);
+    REQUIRE(workThread == pool.GetThreadId());
+    REQUIRE(resumedThread == worker.GetThreadId());
+    _pool = nullptr;
+}
+
+TEST_CASE("async tasks chain the results of awaited tasks", "[async-task]") {
+    FakeLoop worker;
+    FakeLoop pool;
+    _pool = &pool;
+
+    int value = 0;
+    std::thread::id resumedThread;
+    RunOnWorker(worker, [&]() -> AsyncTask<void> {
+        auto first = co_await Add(1, 2);
+        value = co_await Add(first, 3);
+        resumedThread = std::this_thread::get_id();
+    });
+
+    REQUIRE(value == 6);
+    REQUIRE(resumedThread == worker.GetThreadId());
+    _pool = nullptr;
+}
+
+TEST_CASE("async tasks rethrow exceptions of their steps on the awaiting worker", "[async-task]") {
+    FakeLoop worker;
+    FakeLoop pool;
+    _pool = &pool;
+
+    std::string error;
+    std::thread::id caughtThread;
+
+    SECTION("An exception of a function run in the pool") {
+        RunOnWorker(worker, [&]() -> AsyncTask<void> {
+            try {
+                co_await RunAsync([]() { throw std::runtime_error("failed in the pool"); });
+            } catch (const std::runtime_error& ex) {
+                error = ex.what();
+                caughtThread = std::this_thread::get_id();
+            }
+        });
+    }
+
+    SECTION("An exception of an awaited task") {
+        RunOnWorker(worker, [&]() -> AsyncTask<void> {
+            try {
+                (void)co_await Fail();
+            } catch (const std::runtime_error& ex) {
+                error = ex.what();
+                caughtThread = std::this_thread::get_id();
+            }
+        });
+    }
+
+    REQUIRE(error == "failed in the pool");
+    REQUIRE(caughtThread == worker.GetThreadId());
+    _pool = nullptr;
+}
+
+TEST_CASE("async tasks run work in place when the pool refuses it", "[async-task]") {
+    FakeLoop worker;
+
+    std::thread::id workThread;
+    std::thread::id resumedThread;
+    RunOnWorker(worker, [&]() -> AsyncTask<void> {
+        co_await RunAsync([&]() { workThread = std::this_thread::get_id(); });
+        resumedThread = std::this_thread::get_id();
+    });
+
+    REQUIRE(workThread == worker.GetThreadId());
+    REQUIRE(resumedThread == worker.GetThreadId());
+}
+
+TEST_CASE("async tasks wait for completions on the awaiting worker", "[async-task]") {
+    FakeLoop worker;
+    FakeLoop other;
+
+    std::thread::id resumedThread;
+    std::string value;
+
+    SECTION("A completion called from another thread") {
+        RunOnWorker(worker, [&]() -> AsyncTask<void> {
+            value = co_await WaitForCompletion<std::string>([&](std::function<void(std::string)> complete) {
+                other.Post([complete]() { complete("completed"); });
+            });
+            resumedThread = std::this_thread::get_id();
+        });
+    }
+
+    SECTION("A completion called in place doesn't resume inside the start function") {
+        bool started = false;
+        bool startedBeforeResuming = false;
+        RunOnWorker(worker, [&]() -> AsyncTask<void> {
+            value = co_await WaitForCompletion<std::string>([&](std::function<void(std::string)> complete) {
+                complete("completed");
+                started = true;
+            });
+            startedBeforeResuming = started;
+            resumedThread = std::this_thread::get_id();
+        });
+        REQUIRE(startedBeforeResuming);
+    }
+
+    REQUIRE(value == "completed");
+    REQUIRE(resumedThread == worker.GetThreadId());
+}
+
+TEST_CASE("async tasks off workers run work in place and can't wait for completions", "[async-task]") {
+    std::thread::id workThread;
+
+    auto run = [&]() -> AsyncTask<std::thread::id> {
+        std::thread::id thread;
+        co_await RunAsync([&]() { thread = std::this_thread::get_id(); });
+        co_return thread;
+    };
+
+    auto wait = []() -> AsyncTask<bool> {
+        try {
+            co_await WaitForCompletion<int>([](std::function<void(int)> complete) { complete(1); });
+        } catch (const std::runtime_error&) {
+            co_return true;
+        }
+        co_return false;
+    };
+
+    // Awaited by a task started on this thread, which isn't a worker.
+    bool threw = false;
+    [&]() -> AsyncTask<void> {
+        workThread = co_await run();
+        threw = co_await wait();
+    }().Detach();
+
+    REQUIRE(workThread == std::this_thread::get_id());
+    REQUIRE(threw);
+}
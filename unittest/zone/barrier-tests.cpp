@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/barrier.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace napa::zone;
+
+TEST_CASE("barrier releases all parties once the last one arrives", "[barrier]") {
+    Barrier barrier(3);
+    REQUIRE(barrier.GetParties() == 3);
+
+    std::vector<bool> released;
+    barrier.ArriveAndWaitAsync([&released](bool last) { released.push_back(last); });
+    barrier.ArriveAndWaitAsync([&released](bool last) { released.push_back(last); });
+    REQUIRE(released.empty());
+    REQUIRE(barrier.GetArrived() == 2);
+
+    barrier.ArriveAndWaitAsync([&released](bool last) { released.push_back(last); });
+    REQUIRE(released == std::vector<bool>({ false, false, true }));
+    REQUIRE(barrier.GetArrived() == 0);
+}
+
+TEST_CASE("barrier synchronizes threads over several phases", "[barrier]") {
+    const uint32_t parties = 4;
+    const int phases = 100;
+    Barrier barrier(parties);
+
+    std::atomic<int> arrivals(0);
+    std::atomic<int> lastCount(0);
+    std::atomic<bool> inPhase(true);
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < parties; ++i) {
+        threads.emplace_back([&]() {
+            for (int phase = 0; phase < phases; ++phase) {
+                ++arrivals;
+                if (barrier.ArriveAndWait()) {
+                    ++lastCount;
+                }
+
+                // All parties of this phase arrived before any of them is released.
+                if (arrivals < static_cast<int>(parties) * (phase + 1)) {
+                    inPhase = false;
+                }
+                barrier.ArriveAndWait();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(inPhase);
+    REQUIRE(lastCount == phases);
+}
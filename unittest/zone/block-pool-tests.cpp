@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/block-pool.h"
+
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace napa::zone;
+
+namespace {
+    /// <summary> Number of global allocations made by the current thread. </summary>
+    thread_local size_t globalAllocations = 0;
+
+    /// <summary> Stands for a task that holds a call context, the way a call is scheduled. </summary>
+    struct TestContext {
+        TestContext(std::string module, std::function<void(int)> callback) :
+            module(std::move(module)),
+            callback(std::move(callback)) {}
+
+        std::string module;
+        std::function<void(int)> callback;
+    };
+
+    struct TestTask {
+        TestTask(std::shared_ptr<TestContext> context, std::shared_ptr<BlockPool> pool) :
+            contexts(PoolAllocator<std::shared_ptr<TestContext>>(std::move(pool))) {
+            contexts.reserve(1);
+            contexts.emplace_back(std::move(context));
+        }
+
+        std::vector<std::shared_ptr<TestContext>, PoolAllocator<std::shared_ptr<TestContext>>> contexts;
+    };
+
+    void RunCall(const std::shared_ptr<BlockPool>& pool, int& result) {
+        auto context = AllocateShared<TestContext>(pool, "module", [&result](int value) { result += value; });
+        auto task = AllocateShared<TestTask>(pool, std::move(context), pool);
+        task->contexts.front()->callback(1);
+    }
+}
+
+void* operator new(size_t size) {
+    globalAllocations++;
+    if (auto block = std::malloc(size == 0 ? 1 : size)) {
+        return block;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    std::free(block);
+}
+
+TEST_CASE("block pool reuses released blocks", "[block-pool]") {
+    BlockPool pool(4);
+
+    auto first = pool.Allocate(24);
+    pool.Deallocate(first, 24);
+    REQUIRE(pool.GetFreeBlockCount() == 1);
+
+    SECTION("a block is reused by any size of its class") {
+        auto second = pool.Allocate(32);
+        REQUIRE(second == first);
+        REQUIRE(pool.GetFreeBlockCount() == 0);
+        pool.Deallocate(second, 32);
+    }
+
+    SECTION("a block is not reused by another size class") {
+        auto second = pool.Allocate(64);
+        REQUIRE(pool.GetFreeBlockCount() == 1);
+        pool.Deallocate(second, 64);
+        REQUIRE(pool.GetFreeBlockCount() == 2);
+    }
+}
+
+TEST_CASE("block pool keeps a bounded number of free blocks", "[block-pool]") {
+    BlockPool pool(2);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 5; i++) {
+        blocks.push_back(pool.Allocate(16));
+    }
+    for (auto block : blocks) {
+        pool.Deallocate(block, 16);
+    }
+
+    REQUIRE(pool.GetFreeBlockCount() == 2);
+}
+
+TEST_CASE("block pool serves large blocks from the global allocator", "[block-pool]") {
+    BlockPool pool(2);
+
+    auto block = pool.Allocate(BLOCK_POOL_MAX_BLOCK_SIZE + 1);
+    pool.Deallocate(block, BLOCK_POOL_MAX_BLOCK_SIZE + 1);
+
+    REQUIRE(pool.GetFreeBlockCount() == 0);
+}
+
+TEST_CASE("pooled calls don't allocate once the pool is warm", "[block-pool]") {
+    auto pool = std::make_shared<BlockPool>(16);
+
+    int result = 0;
+    RunCall(pool, result);
+
+    auto allocations = globalAllocations;
+    for (int i = 0; i < 1000; i++) {
+        RunCall(pool, result);
+    }
+
+    // Catch allocates while building the assertion, so the count is taken first.
+    allocations = globalAllocations - allocations;
+    REQUIRE(allocations == 0);
+    REQUIRE(result == 1001);
+}
+
+TEST_CASE("pool allocator keeps the pool alive", "[block-pool]") {
+    auto pool = std::make_shared<BlockPool>(16);
+    std::weak_ptr<BlockPool> weakPool = pool;
+
+    auto context = AllocateShared<TestContext>(pool, "module", [](int) {});
+    pool.reset();
+    REQUIRE(!weakPool.expired());
+
+    context.reset();
+    REQUIRE(weakPool.expired());
+}
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/call-coalescer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace napa;
+using namespace napa::zone;
+
+TEST_CASE("call coalescer delivers the first call's result to identical calls", "[call-coalescer]") {
+    CallCoalescer coalescer;
+    std::vector<std::string> values;
+    auto callback = [&values](Result result) {
+        values.push_back(result.returnValue);
+    };
+
+    REQUIRE(coalescer.Join("key", callback));
+    REQUIRE(!coalescer.Join("key", callback));
+    REQUIRE(!coalescer.Join("key", callback));
+    REQUIRE(coalescer.Join("other", callback));
+    REQUIRE(coalescer.GetInFlightCount() == 2);
+
+    coalescer.Complete("key", { NAPA_RESULT_SUCCESS, "", "42", nullptr });
+    REQUIRE(values == std::vector<std::string>({ "42", "42", "42" }));
+    REQUIRE(coalescer.GetInFlightCount() == 1);
+
+    SECTION("a completed call is not joined") {
+        REQUIRE(coalescer.Join("key", callback));
+    }
+
+    SECTION("results of unknown calls are dropped") {
+        coalescer.Complete("unknown", { NAPA_RESULT_SUCCESS, "", "0", nullptr });
+        REQUIRE(values.size() == 3);
+    }
+}
+
+TEST_CASE("call coalescer shares transported handles with all calls", "[call-coalescer]") {
+    CallCoalescer coalescer;
+    auto object = std::make_shared<int>(42);
+    auto handle = reinterpret_cast<uintptr_t>(object.get());
+
+    std::vector<std::shared_ptr<int>> loaded;
+    auto callback = [&loaded, handle](Result result) {
+        loaded.push_back(result.transportContext->LoadShared<int>(handle));
+    };
+    REQUIRE(coalescer.Join("key", callback));
+    REQUIRE(!coalescer.Join("key", callback));
+
+    auto transportContext = std::make_unique<napa::transport::TransportContext>();
+    transportContext->SaveShared(object);
+    coalescer.Complete("key", { NAPA_RESULT_SUCCESS, "", "", std::move(transportContext) });
+
+    REQUIRE(loaded.size() == 2);
+    REQUIRE(loaded[0] == object);
+    REQUIRE(loaded[1] == object);
+}
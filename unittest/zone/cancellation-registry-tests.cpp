@@ -0,0 +1,76 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/cancellation-registry.h"
+
+#include <memory>
+
+using namespace napa::zone;
+
+namespace {
+    class TestTask : public Task {
+    public:
+        void Execute() override {}
+
+        void Reject(napa::ResultCode, const std::string&) override {}
+
+        void Cancel() override {
+            numberOfCancellations++;
+        }
+
+        int numberOfCancellations = 0;
+    };
+}
+
+TEST_CASE("cancellation registry cancels tasks by token", "[cancellation-registry]") {
+    CancellationRegistry registry;
+
+    auto first = std::make_shared<TestTask>();
+    auto second = std::make_shared<TestTask>();
+    auto other = std::make_shared<TestTask>();
+    registry.Register(1, first);
+    registry.Register(1, second);
+    registry.Register(2, other);
+
+    REQUIRE(registry.Cancel(1) == 2);
+    REQUIRE(first->numberOfCancellations == 1);
+    REQUIRE(second->numberOfCancellations == 1);
+    REQUIRE(other->numberOfCancellations == 0);
+
+    SECTION("a token is cancelled once") {
+        REQUIRE(registry.Cancel(1) == 0);
+        REQUIRE(first->numberOfCancellations == 1);
+    }
+
+    SECTION("unknown tokens cancel nothing") {
+        REQUIRE(registry.Cancel(3) == 0);
+        REQUIRE(registry.GetTaskCount() == 1);
+    }
+}
+
+TEST_CASE("cancellation registry ignores tasks without a token", "[cancellation-registry]") {
+    CancellationRegistry registry;
+
+    auto task = std::make_shared<TestTask>();
+    registry.Register(0, task);
+
+    REQUIRE(registry.GetTaskCount() == 0);
+    REQUIRE(registry.Cancel(0) == 0);
+}
+
+TEST_CASE("cancellation registry skips and sweeps completed tasks", "[cancellation-registry]") {
+    CancellationRegistry registry;
+
+    auto live = std::make_shared<TestTask>();
+    registry.Register(1, live);
+
+    for (uint64_t i = 0; i < 1000; i++) {
+        registry.Register(1, std::make_shared<TestTask>());
+    }
+    REQUIRE(registry.GetTaskCount() < 100);
+
+    REQUIRE(registry.Cancel(1) == 1);
+    REQUIRE(live->numberOfCancellations == 1);
+}
@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/channel.h"
+
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace napa::zone;
+using namespace std::chrono_literals;
+
+TEST_CASE("channel receives items in the order they are sent", "[channel]") {
+    Channel<int> channel(2);
+    REQUIRE(channel.GetCapacity() == 2);
+
+    int item = 1;
+    REQUIRE(channel.Send(item) == ChannelStatus::SUCCESS);
+    item = 2;
+    REQUIRE(channel.SendFor(item, 0ms) == ChannelStatus::SUCCESS);
+    item = 3;
+    REQUIRE(channel.SendFor(item, 10ms) == ChannelStatus::TIMEOUT);
+    REQUIRE(channel.GetSize() == 2);
+
+    REQUIRE(channel.Receive(item) == ChannelStatus::SUCCESS);
+    REQUIRE(item == 1);
+    REQUIRE(channel.ReceiveFor(item, 0ms) == ChannelStatus::SUCCESS);
+    REQUIRE(item == 2);
+    REQUIRE(channel.ReceiveFor(item, 10ms) == ChannelStatus::TIMEOUT);
+}
+
+TEST_CASE("channel moves items only when they are sent", "[channel]") {
+    Channel<std::unique_ptr<int>> channel(1);
+
+    auto item = std::make_unique<int>(1);
+    REQUIRE(channel.Send(item) == ChannelStatus::SUCCESS);
+    REQUIRE(item == nullptr);
+
+    item = std::make_unique<int>(2);
+    REQUIRE(channel.SendFor(item, 0ms) == ChannelStatus::TIMEOUT);
+    REQUIRE(item != nullptr);
+}
+
+TEST_CASE("channel hands items to asynchronous receivers", "[channel]") {
+    Channel<int> channel(1);
+
+    std::vector<int> received;
+    channel.ReceiveAsync([&received](bool success, int item) {
+        REQUIRE(success);
+        received.push_back(item);
+    });
+    REQUIRE(received.empty());
+
+    int item = 1;
+    REQUIRE(channel.Send(item) == ChannelStatus::SUCCESS);
+    REQUIRE(received == std::vector<int>({ 1 }));
+    REQUIRE(channel.GetSize() == 0);
+
+    // An item ready right away is received on the calling thread.
+    item = 2;
+    REQUIRE(channel.Send(item) == ChannelStatus::SUCCESS);
+    channel.ReceiveAsync([&received](bool success, int item) {
+        REQUIRE(success);
+        received.push_back(item);
+    });
+    REQUIRE(received == std::vector<int>({ 1, 2 }));
+}
+
+TEST_CASE("channel accepts items of asynchronous senders once there is room", "[channel]") {
+    Channel<int> channel(1);
+
+    std::vector<bool> sent;
+    channel.SendAsync(1, [&sent](bool success) { sent.push_back(success); });
+    channel.SendAsync(2, [&sent](bool success) { sent.push_back(success); });
+    REQUIRE(sent == std::vector<bool>({ true }));
+    REQUIRE(channel.GetSize() == 2);
+
+    int item = 0;
+    REQUIRE(channel.Receive(item) == ChannelStatus::SUCCESS);
+    REQUIRE(item == 1);
+    REQUIRE(sent == std::vector<bool>({ true, true }));
+
+    REQUIRE(channel.Receive(item) == ChannelStatus::SUCCESS);
+    REQUIRE(item == 2);
+}
+
+TEST_CASE("channel fails waiters on close and drains remaining items", "[channel]") {
+    Channel<int> channel(1);
+
+    channel.SendAsync(1, [](bool success) { REQUIRE(success); });
+    bool pendingSent = true;
+    channel.SendAsync(2, [&pendingSent](bool success) { pendingSent = success; });
+
+    channel.Close();
+    REQUIRE(channel.IsClosed());
+    REQUIRE(!pendingSent);
+
+    int item = 3;
+    REQUIRE(channel.Send(item) == ChannelStatus::CLOSED);
+    REQUIRE(channel.Receive(item) == ChannelStatus::SUCCESS);
+    REQUIRE(item == 1);
+    REQUIRE(channel.Receive(item) == ChannelStatus::CLOSED);
+
+    bool received = true;
+    channel.ReceiveAsync([&received](bool success, int) { received = success; });
+    REQUIRE(!received);
+}
+
+TEST_CASE("channel wakes up blocked receivers on close", "[channel]") {
+    Channel<int> channel(1);
+
+    auto receiver = std::async(std::launch::async, [&channel]() {
+        int item = 0;
+        return channel.Receive(item);
+    });
+
+    std::this_thread::sleep_for(20ms);
+    channel.Close();
+    REQUIRE(receiver.get() == ChannelStatus::CLOSED);
+}
+
+TEST_CASE("channel delivers all items between producer and consumer threads", "[channel]") {
+    Channel<int> channel(4);
+    const int count = 10000;
+
+    std::thread producer([&channel]() {
+        for (int i = 0; i < count; ++i) {
+            int item = i;
+            REQUIRE(channel.Send(item) == ChannelStatus::SUCCESS);
+        }
+        channel.Close();
+    });
+
+    int expected = 0;
+    int item = 0;
+    while (channel.Receive(item) == ChannelStatus::SUCCESS) {
+        REQUIRE(item == expected);
+        ++expected;
+    }
+    producer.join();
+    REQUIRE(expected == count);
+}
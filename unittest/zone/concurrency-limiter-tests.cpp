@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <zone/concurrency-limiter.h>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    using Clock = ConcurrencyLimiter::Clock;
+    using std::chrono::milliseconds;
+
+    /// <summary> Admits calls until one is rejected. </summary>
+    uint32_t Fill(ConcurrencyLimiter& limiter) {
+        uint32_t admitted = 0;
+        while (limiter.TryAcquire() && admitted < 100000) {
+            admitted++;
+        }
+        return admitted;
+    }
+
+    /// <summary> Completes calls, all with the same latency at the same time. </summary>
+    void Complete(ConcurrencyLimiter& limiter, uint32_t calls, milliseconds latency, Clock::time_point now, bool dropped = false) {
+        for (uint32_t i = 0; i < calls; i++) {
+            limiter.Release(latency, dropped, now);
+        }
+    }
+
+    /// <summary> Runs rounds of fast calls using the whole limit until it reaches a target. </summary>
+    void Grow(ConcurrencyLimiter& limiter, uint32_t target, Clock::time_point now) {
+        for (int round = 0; round < 1000 && limiter.GetLimit() < target; round++) {
+            Complete(limiter, Fill(limiter), milliseconds(1), now);
+        }
+    }
+}
+
+TEST_CASE("Concurrency limiter without a maximum admits all calls", "[concurrency-limiter]") {
+    ConcurrencyLimiter limiter("zone", 4, 0);
+    REQUIRE_FALSE(limiter.IsEnabled());
+}
+
+TEST_CASE("Concurrency limiter starts at its minimum", "[concurrency-limiter]") {
+    ConcurrencyLimiter limiter("zone", 4, 100);
+    REQUIRE(limiter.IsEnabled());
+    REQUIRE(limiter.GetLimit() == 4);
+
+    REQUIRE(Fill(limiter) == 4);
+    REQUIRE(limiter.GetInFlightCount() == 4);
+
+    limiter.Release(milliseconds(1), false, Clock::now());
+    REQUIRE(limiter.GetInFlightCount() == 3);
+    REQUIRE(limiter.TryAcquire());
+}
+
+TEST_CASE("Concurrency limiter raises the limit on fast calls", "[concurrency-limiter]") {
+    auto now = Clock::now();
+
+    SECTION("The limit grows while the zone uses it") {
+        ConcurrencyLimiter limiter("zone", 2, 100);
+        Grow(limiter, 20, now);
+        REQUIRE(limiter.GetLimit() == 20);
+        REQUIRE(Fill(limiter) == 20);
+    }
+
+    SECTION("The limit doesn't grow past the maximum") {
+        ConcurrencyLimiter limiter("zone", 2, 8);
+        Grow(limiter, 20, now);
+        REQUIRE(limiter.GetLimit() == 8);
+    }
+
+    SECTION("The limit doesn't grow while the zone uses less than half of it") {
+        ConcurrencyLimiter limiter("zone", 4, 100);
+        for (int i = 0; i < 100; i++) {
+            REQUIRE(limiter.TryAcquire());
+            limiter.Release(milliseconds(1), false, now);
+        }
+        REQUIRE(limiter.GetLimit() == 4);
+    }
+}
+
+TEST_CASE("Concurrency limiter lowers the limit on slow calls", "[concurrency-limiter]") {
+    ConcurrencyLimiter limiter("zone", 2, 100);
+    auto now = Clock::now();
+    Grow(limiter, 20, now);
+    REQUIRE(Fill(limiter) == 20);
+
+    SECTION("A call slower than twice the lowest latency lowers the limit by a tenth") {
+        Complete(limiter, 1, milliseconds(10), now + milliseconds(10));
+        REQUIRE(limiter.GetLimit() == 18);
+    }
+
+    SECTION("Calls admitted before a decrease don't lower the limit again") {
+        Complete(limiter, 10, milliseconds(10), now + milliseconds(10));
+        REQUIRE(limiter.GetLimit() == 18);
+
+        REQUIRE(Fill(limiter) == 8);
+        Complete(limiter, 1, milliseconds(10), now + milliseconds(30));
+        REQUIRE(limiter.GetLimit() == 16);
+    }
+
+    SECTION("Dropped calls lower the limit whatever their latency") {
+        Complete(limiter, 1, milliseconds(1), now + milliseconds(1), true);
+        REQUIRE(limiter.GetLimit() == 18);
+    }
+
+    SECTION("The limit doesn't go below the minimum") {
+        Complete(limiter, 20, milliseconds(10), now + milliseconds(10));
+        for (int i = 0; i < 100; i++) {
+            REQUIRE(limiter.TryAcquire());
+            limiter.Release(milliseconds(10), true, now + milliseconds(20 + 20 * i));
+        }
+        REQUIRE(limiter.GetLimit() == 2);
+        REQUIRE(limiter.GetInFlightCount() == 0);
+    }
+}
+
+TEST_CASE("Concurrency limiter follows calls that got slower for good", "[concurrency-limiter]") {
+    ConcurrencyLimiter limiter("zone", 1, 100);
+    auto now = Clock::now();
+
+    // A window of fast calls, then slower ones, which keep the limit down while the fast calls set the lowest latency.
+    for (int i = 0; i < 1999; i++) {
+        REQUIRE(limiter.TryAcquire());
+        limiter.Release(milliseconds(i < 1000 ? 1 : 3), false, now + milliseconds(10 * i));
+    }
+    REQUIRE(limiter.GetLimit() == 1);
+
+    // The call completing their window makes the slower latency the lowest one, and raises the limit again.
+    REQUIRE(limiter.TryAcquire());
+    limiter.Release(milliseconds(3), false, now + milliseconds(19990));
+    REQUIRE(limiter.GetLimit() == 2);
+}
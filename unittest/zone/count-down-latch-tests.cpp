@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/count-down-latch.h"
+
+#include <future>
+
+using namespace napa::zone;
+using namespace std::chrono_literals;
+
+TEST_CASE("count down latch opens once counted down to zero", "[count-down-latch]") {
+    CountDownLatch latch(3);
+
+    int opened = 0;
+    latch.WaitAsync([&opened]() { ++opened; });
+    REQUIRE(!latch.WaitFor(10ms));
+
+    latch.CountDown();
+    REQUIRE(latch.GetCount() == 2);
+    REQUIRE(opened == 0);
+
+    // Count downs past zero keep the latch open.
+    latch.CountDown(5);
+    REQUIRE(latch.GetCount() == 0);
+    REQUIRE(opened == 1);
+    REQUIRE(latch.WaitFor(0ms));
+
+    latch.WaitAsync([&opened]() { ++opened; });
+    REQUIRE(opened == 2);
+}
+
+TEST_CASE("count down latch releases blocked threads", "[count-down-latch]") {
+    CountDownLatch latch(1);
+
+    auto waiters = {
+        std::async(std::launch::async, [&latch]() { latch.Wait(); }),
+        std::async(std::launch::async, [&latch]() { latch.Wait(); })
+    };
+
+    latch.CountDown();
+    for (auto& waiter : waiters) {
+        REQUIRE(waiter.wait_for(1s) == std::future_status::ready);
+    }
+}
@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <zone/fair-task-queue.h>
+
+#include <string>
+#include <vector>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    class TenantTask : public Task {
+    public:
+        TenantTask(uint64_t tenant, uint32_t id, uint32_t priority = 0) : id(id), _tenant(tenant), _priority(priority) {}
+
+        void Execute() override {}
+        void Reject(ResultCode, const std::string&) override {}
+        uint32_t GetPriority() const override { return _priority; }
+        uint64_t GetTenant() const override { return _tenant; }
+
+        const uint32_t id;
+
+    private:
+        uint64_t _tenant;
+        uint32_t _priority;
+    };
+
+    std::vector<uint32_t> Drain(FairTaskQueue& queue) {
+        std::vector<uint32_t> ids;
+        while (!queue.Empty()) {
+            ids.push_back(std::static_pointer_cast<TenantTask>(queue.Pop())->id);
+        }
+        return ids;
+    }
+}
+
+TEST_CASE("FairTaskQueue keeps the order of a single tenant", "[fair-task-queue]") {
+    FairTaskQueue queue;
+    REQUIRE(queue.Empty());
+    REQUIRE(queue.Pop() == nullptr);
+
+    queue.Push(std::make_shared<TenantTask>(0, 1));
+    queue.Push(std::make_shared<TenantTask>(0, 2, 1));
+    queue.Push(std::make_shared<TenantTask>(0, 3));
+    REQUIRE(queue.Size() == 3);
+
+    REQUIRE(Drain(queue) == std::vector<uint32_t>({ 2, 1, 3 }));
+}
+
+TEST_CASE("FairTaskQueue serves tenants in turns", "[fair-task-queue]") {
+    FairTaskQueue queue;
+
+    // The noisy tenant floods the queue before the quiet one.
+    for (uint32_t i = 0; i < 4; i++) {
+        queue.Push(std::make_shared<TenantTask>(1, 10 + i));
+    }
+    queue.Push(std::make_shared<TenantTask>(2, 20));
+    queue.Push(std::make_shared<TenantTask>(2, 21));
+
+    REQUIRE(Drain(queue) == std::vector<uint32_t>({ 10, 20, 11, 21, 12, 13 }));
+}
+
+TEST_CASE("FairTaskQueue dispatches tenants by their weights", "[fair-task-queue]") {
+    FairTaskQueue queue({ { "gold", 1, 3 }, { "silver", 2, 1 } });
+
+    for (uint32_t i = 0; i < 4; i++) {
+        queue.Push(std::make_shared<TenantTask>(1, 10 + i));
+        queue.Push(std::make_shared<TenantTask>(2, 20 + i));
+    }
+
+    REQUIRE(Drain(queue) == std::vector<uint32_t>({ 10, 11, 12, 20, 13, 21, 22, 23 }));
+}
+
+TEST_CASE("FairTaskQueue drops from the tenant with the most waiting tasks", "[fair-task-queue]") {
+    FairTaskQueue queue;
+    queue.Push(std::make_shared<TenantTask>(1, 10));
+    queue.Push(std::make_shared<TenantTask>(2, 20));
+    queue.Push(std::make_shared<TenantTask>(2, 21));
+
+    auto dropped = std::static_pointer_cast<TenantTask>(queue.PopFromLongest());
+    REQUIRE(dropped->id == 20);
+    REQUIRE(queue.Size() == 2);
+
+    // Dropped tasks are not counted as dispatched.
+    auto stats = queue.GetStats();
+    REQUIRE(stats.size() == 2);
+    REQUIRE(stats[1].tenant == 2);
+    REQUIRE(stats[1].queuedTasks == 1);
+    REQUIRE(stats[1].dispatchedTasks == 0);
+}
+
+TEST_CASE("FairTaskQueue reports the waiting tasks and waits of each tenant", "[fair-task-queue]") {
+    FairTaskQueue queue({ { "gold", 7, 2 }, { "idle", 8, 1 } });
+    queue.Push(std::make_shared<TenantTask>(7, 1));
+    queue.Push(std::make_shared<TenantTask>(7, 2));
+    queue.Push(std::make_shared<TenantTask>(0, 3));
+    queue.Pop();
+
+    // Tenants whose tasks never waited are left out.
+    auto stats = queue.GetStats();
+    REQUIRE(stats.size() == 2);
+
+    REQUIRE(stats[0].tenant == 0);
+    REQUIRE(stats[0].name.empty());
+    REQUIRE(stats[0].queuedTasks == 1);
+    REQUIRE(stats[0].dispatchedTasks == 0);
+
+    REQUIRE(stats[1].tenant == 7);
+    REQUIRE(stats[1].name == "gold");
+    REQUIRE(stats[1].queuedTasks == 1);
+    REQUIRE(stats[1].dispatchedTasks == 1);
+    REQUIRE(stats[1].maxWaitTime <= stats[1].waitTime);
+}
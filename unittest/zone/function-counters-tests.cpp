@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <platform/hardware-counters.h>
+#include <zone/function-counters.h>
+
+#include <thread>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    platform::HardwareCounterSample MakeSample(uint64_t cycles, uint64_t instructions, uint64_t references, uint64_t misses) {
+        platform::HardwareCounterSample sample;
+        sample.cycles = cycles;
+        sample.instructions = instructions;
+        sample.cacheReferences = references;
+        sample.cacheMisses = misses;
+        return sample;
+    }
+}
+
+TEST_CASE("FunctionCounterTable sums the calls of a function across workers", "[function-counters]") {
+    FunctionCounterTable table(2);
+
+    table.Add(0, "lib", "compute", MakeSample(100, 200, 10, 1));
+    table.Add(1, "lib", "compute", MakeSample(300, 400, 30, 3));
+    table.Add(1, "lib", "compute", MakeSample(1, 2, 3, 4));
+
+    auto counters = table.GetCounters();
+    REQUIRE(counters.size() == 1);
+    REQUIRE(counters[0].function == "lib.compute");
+    REQUIRE(counters[0].calls == 3);
+    REQUIRE(counters[0].cycles == 401);
+    REQUIRE(counters[0].instructions == 602);
+    REQUIRE(counters[0].cacheReferences == 43);
+    REQUIRE(counters[0].cacheMisses == 8);
+}
+
+TEST_CASE("FunctionCounterTable orders functions by name", "[function-counters]") {
+    FunctionCounterTable table(2);
+
+    table.Add(1, "lib", "sort", MakeSample(1, 1, 1, 1));
+    table.Add(0, "", "anonymous", MakeSample(1, 1, 1, 1));
+    table.Add(0, "lib", "compute", MakeSample(1, 1, 1, 1));
+
+    auto counters = table.GetCounters();
+    REQUIRE(counters.size() == 3);
+    REQUIRE(counters[0].function == "anonymous");
+    REQUIRE(counters[1].function == "lib.compute");
+    REQUIRE(counters[2].function == "lib.sort");
+}
+
+TEST_CASE("FunctionCounterTable ignores workers beyond its shards", "[function-counters]") {
+    FunctionCounterTable table(1);
+
+    table.Add(1, "lib", "compute", MakeSample(1, 1, 1, 1));
+
+    REQUIRE(table.GetCounters().empty());
+}
+
+TEST_CASE("platform::ReadThreadHardwareCounters counts the calling thread", "[function-counters]") {
+    platform::HardwareCounterSample before;
+    if (!platform::ReadThreadHardwareCounters(before)) {
+        REQUIRE_FALSE(platform::AreHardwareCountersSupported());
+        WARN("Hardware counters are not supported on this machine.");
+        return;
+    }
+
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < 1000000; i++) {
+        sum += i;
+    }
+
+    platform::HardwareCounterSample after;
+    REQUIRE(platform::ReadThreadHardwareCounters(after));
+    REQUIRE(after.instructions > before.instructions + 1000000);
+    REQUIRE(after.cycles > before.cycles);
+    REQUIRE(after.cacheReferences >= before.cacheReferences);
+    REQUIRE(after.cacheMisses >= before.cacheMisses);
+}
@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <zone/function-stats.h>
+
+#include <thread>
+#include <vector>
+
+using namespace napa;
+using namespace napa::zone;
+
+TEST_CASE("FunctionStatsTable counts calls, errors and execution times", "[function-stats]") {
+    FunctionStatsTable table("stats-zone", 2);
+
+    table.GetEntry(0, "lib", "compute")->Record(std::chrono::microseconds(10), false);
+    table.GetEntry(1, "lib", "compute")->Record(std::chrono::microseconds(30), true);
+
+    auto stats = table.GetStats();
+    REQUIRE(stats.size() == 1);
+    REQUIRE(stats[0].module == "lib");
+    REQUIRE(stats[0].function == "compute");
+    REQUIRE(stats[0].calls == 2);
+    REQUIRE(stats[0].errors == 1);
+    REQUIRE(stats[0].totalTime == 40000);
+    REQUIRE(stats[0].maxTime == 30000);
+    REQUIRE(stats[0].histogram[FunctionStatsTable::Entry::GetBucketIndex(std::chrono::microseconds(10))] == 1);
+    REQUIRE(stats[0].histogram[FunctionStatsTable::Entry::GetBucketIndex(std::chrono::microseconds(30))] == 1);
+}
+
+TEST_CASE("FunctionStatsTable workers share the entry of a function", "[function-stats]") {
+    FunctionStatsTable table("stats-zone", 2);
+
+    auto entry = table.GetEntry(0, "lib", "compute");
+    REQUIRE(table.GetEntry(0, "lib", "compute") == entry);
+    REQUIRE(table.GetEntry(1, "lib", "compute") == entry);
+    REQUIRE(table.GetEntry(5, "lib", "compute") == entry);
+
+    // The module and function are kept apart, they don't form one name.
+    REQUIRE(table.GetEntry(0, "lib.compute", "") != entry);
+    REQUIRE(table.GetEntry(0, "", "lib.compute") != entry);
+}
+
+TEST_CASE("FunctionStatsTable orders functions by module and function", "[function-stats]") {
+    FunctionStatsTable table("stats-zone", 1);
+
+    table.GetEntry(0, "lib", "sort")->Record(std::chrono::microseconds(1), false);
+    table.GetEntry(0, "", "global")->Record(std::chrono::microseconds(1), false);
+    table.GetEntry(0, "lib", "compute")->Record(std::chrono::microseconds(1), false);
+
+    auto stats = table.GetStats();
+    REQUIRE(stats.size() == 3);
+    REQUIRE(stats[0].function == "global");
+    REQUIRE(stats[1].function == "compute");
+    REQUIRE(stats[2].function == "sort");
+}
+
+TEST_CASE("FunctionStatsTable buckets are powers of 2 microseconds", "[function-stats]") {
+    using Entry = FunctionStatsTable::Entry;
+
+    REQUIRE(Entry::GetBucketIndex(std::chrono::nanoseconds(0)) == 0);
+    REQUIRE(Entry::GetBucketIndex(std::chrono::nanoseconds(999)) == 0);
+    REQUIRE(Entry::GetBucketIndex(std::chrono::microseconds(1)) == 1);
+    REQUIRE(Entry::GetBucketIndex(std::chrono::microseconds(2)) == 2);
+    REQUIRE(Entry::GetBucketIndex(std::chrono::microseconds(3)) == 2);
+    REQUIRE(Entry::GetBucketIndex(std::chrono::microseconds(1024)) == 11);
+    REQUIRE(Entry::GetBucketIndex(std::chrono::hours(24)) == NAPA_FUNCTION_STATS_HISTOGRAM_BUCKETS - 1);
+}
+
+TEST_CASE("FunctionStatsTable records calls of concurrent workers", "[function-stats]") {
+    const uint32_t workerCount = 4;
+    const uint32_t callsPerWorker = 10000;
+    FunctionStatsTable table("stats-zone", workerCount);
+
+    std::vector<std::thread> workers;
+    for (uint32_t i = 0; i < workerCount; i++) {
+        workers.emplace_back([&table, i, callsPerWorker]() {
+            for (uint32_t call = 0; call < callsPerWorker; call++) {
+                table.GetEntry(i, "lib", "compute")->Record(std::chrono::microseconds(call % 100), call % 10 == 0);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    auto stats = table.GetStats();
+    REQUIRE(stats.size() == 1);
+    REQUIRE(stats[0].calls == workerCount * callsPerWorker);
+    REQUIRE(stats[0].errors == workerCount * callsPerWorker / 10);
+    REQUIRE(stats[0].maxTime == 99000);
+
+    uint64_t histogramCalls = 0;
+    for (auto count : stats[0].histogram) {
+        histogramCalls += count;
+    }
+    REQUIRE(histogramCalls == workerCount * callsPerWorker);
+}
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <zone/atomic-bitmap.h>
+#include <zone/mpmc-queue.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace napa::zone;
+
+TEST_CASE("mpmc queue rounds capacity up to a power of 2", "[mpmc-queue]") {
+    MpmcQueue<int> queue(100);
+    REQUIRE(queue.Capacity() == 128);
+}
+
+TEST_CASE("mpmc queue is first in first out and bounded", "[mpmc-queue]") {
+    MpmcQueue<int> queue(4);
+    REQUIRE(queue.Empty());
+
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(queue.TryPush(int(i)));
+    }
+    REQUIRE(!queue.TryPush(4));
+    REQUIRE(!queue.Empty());
+
+    int value;
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(queue.TryPop(value));
+        REQUIRE(value == i);
+    }
+    REQUIRE(!queue.TryPop(value));
+    REQUIRE(queue.Empty());
+}
+
+TEST_CASE("mpmc queue delivers each value exactly once under concurrency", "[mpmc-queue]") {
+    MpmcQueue<size_t> queue(64);
+
+    const size_t numberOfThreads = 4;
+    const size_t valuesPerThread = 10000;
+
+    std::vector<std::atomic<uint32_t>> received(numberOfThreads * valuesPerThread);
+    std::atomic<size_t> consumed(0);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numberOfThreads; t++) {
+        threads.emplace_back([&queue, t, valuesPerThread]() {
+            for (size_t i = 0; i < valuesPerThread; i++) {
+                size_t value = t * valuesPerThread + i;
+                while (!queue.TryPush(std::move(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&]() {
+            size_t value;
+            while (consumed < received.size()) {
+                if (queue.TryPop(value)) {
+                    received[value]++;
+                    consumed++;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (auto& count : received) {
+        REQUIRE(count == 1);
+    }
+}
+
+TEST_CASE("atomic bitmap sets, clears and claims bits", "[atomic-bitmap]") {
+    AtomicBitmap bitmap(130);
+    size_t index;
+
+    REQUIRE(!bitmap.TryClaim(index));
+
+    bitmap.Set(3);
+    bitmap.Set(129);
+    REQUIRE(bitmap.Test(3));
+    REQUIRE(bitmap.Test(129));
+
+    REQUIRE(bitmap.Clear(3));
+    REQUIRE(!bitmap.Clear(3));
+
+    REQUIRE(bitmap.TryClaim(index));
+    REQUIRE(index == 129);
+    REQUIRE(!bitmap.Test(129));
+    REQUIRE(!bitmap.TryClaim(index));
+
+    bitmap.Set(0);
+    bitmap.Set(64);
+    bitmap.ClearAll();
+    REQUIRE(!bitmap.TryClaim(index));
+}
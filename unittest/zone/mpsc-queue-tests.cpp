@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <napa/zone/mpsc-queue.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace napa::zone;
+
+TEST_CASE("mpsc queue drains values in the order they were pushed", "[mpsc-queue]") {
+    MpscQueue<int> queue;
+    REQUIRE(queue.Empty());
+
+    REQUIRE(queue.Push(0));
+    for (int i = 1; i < 5; i++) {
+        REQUIRE(!queue.Push(int(i)));
+    }
+    REQUIRE(!queue.Empty());
+
+    std::vector<int> values;
+    auto drained = queue.Drain([&values](int value) { values.push_back(value); });
+    REQUIRE(drained == 5);
+    REQUIRE(values == std::vector<int>({ 0, 1, 2, 3, 4 }));
+    REQUIRE(queue.Empty());
+
+    drained = queue.Drain([](int) {});
+    REQUIRE(drained == 0);
+    REQUIRE(queue.Push(5));
+}
+
+TEST_CASE("mpsc queue frees pending values when destroyed", "[mpsc-queue]") {
+    auto value = std::make_shared<int>(1);
+    {
+        MpscQueue<std::shared_ptr<int>> queue;
+        queue.Push(value);
+        queue.Push(value);
+        REQUIRE(value.use_count() == 3);
+    }
+    REQUIRE(value.use_count() == 1);
+}
+
+TEST_CASE("mpsc queue delivers each value exactly once under concurrency", "[mpsc-queue]") {
+    constexpr size_t PRODUCERS = 4;
+    constexpr size_t VALUES_PER_PRODUCER = 20000;
+
+    MpscQueue<size_t> queue;
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < PRODUCERS; p++) {
+        producers.emplace_back([&queue, p]() {
+            for (size_t i = 0; i < VALUES_PER_PRODUCER; i++) {
+                queue.Push(p * VALUES_PER_PRODUCER + i);
+            }
+        });
+    }
+
+    // Values of each producer come out in the order the producer pushed them.
+    std::vector<size_t> next(PRODUCERS, 0);
+    size_t drained = 0;
+    bool ordered = true;
+    while (drained < PRODUCERS * VALUES_PER_PRODUCER) {
+        drained += queue.Drain([&next, &ordered](size_t value) {
+            auto producer = value / VALUES_PER_PRODUCER;
+            ordered = ordered && value % VALUES_PER_PRODUCER == next[producer];
+            next[producer]++;
+        });
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    REQUIRE(ordered);
+    REQUIRE(queue.Empty());
+    for (auto count : next) {
+        REQUIRE(count == VALUES_PER_PRODUCER);
+    }
+}
+
+TEST_CASE("mpsc queue drains at most the budget and keeps the order", "[mpsc-queue]") {
+    MpscQueue<int> queue;
+    for (int i = 0; i < 5; i++) {
+        queue.Push(int(i));
+    }
+
+    std::vector<int> values;
+    auto consumer = [&values](int value) { values.push_back(value); };
+    auto drained = queue.Drain(consumer, 2);
+    REQUIRE(drained == 2);
+    REQUIRE(!queue.Empty());
+
+    // Values pushed after values were taken are drained after them.
+    queue.Push(5);
+    drained = queue.Drain(consumer, 2);
+    REQUIRE(drained == 2);
+    drained = queue.Drain(consumer, 2);
+    REQUIRE(drained == 1);
+    drained = queue.Drain(consumer, 2);
+    REQUIRE(drained == 1);
+    REQUIRE(queue.Empty());
+    REQUIRE(values == std::vector<int>({ 0, 1, 2, 3, 4, 5 }));
+}
@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/native-task.h"
+
+#include <stdexcept>
+
+using namespace napa;
+using namespace napa::zone;
+
+TEST_CASE("native task runs its function then calls back", "[native-task]") {
+    int calls = 0;
+    ResultCode code = NAPA_RESULT_UNDEFINED;
+
+    NativeTask task([&calls]() { calls++; }, [&calls, &code](ResultCode result) {
+        REQUIRE(calls == 1);
+        code = result;
+    });
+    task.Execute();
+
+    REQUIRE(calls == 1);
+    REQUIRE(code == NAPA_RESULT_SUCCESS);
+}
+
+TEST_CASE("native task reports a function that throws", "[native-task]") {
+    ResultCode code = NAPA_RESULT_UNDEFINED;
+
+    NativeTask task([]() { throw std::runtime_error("failed"); }, [&code](ResultCode result) { code = result; });
+    task.Execute();
+
+    REQUIRE(code == NAPA_RESULT_INTERNAL_ERROR);
+}
+
+TEST_CASE("native task rejected by the scheduler doesn't run its function", "[native-task]") {
+    bool ran = false;
+    ResultCode code = NAPA_RESULT_UNDEFINED;
+
+    NativeTask task([&ran]() { ran = true; }, [&code](ResultCode result) { code = result; });
+    task.Reject(NAPA_RESULT_ZONE_OVERLOADED, "The zone queue is full");
+
+    REQUIRE_FALSE(ran);
+    REQUIRE(code == NAPA_RESULT_ZONE_OVERLOADED);
+}
+
+TEST_CASE("native task runs without a callback", "[native-task]") {
+    bool ran = false;
+
+    NativeTask task([&ran]() { ran = true; }, nullptr);
+    task.Execute();
+
+    REQUIRE(ran);
+}
@@ -0,0 +1,85 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <zone/rate-limiter.h>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> Takes tokens of a tenant until a call is rejected. </summary>
+    size_t Drain(RateLimiter& limiter, uint64_t tenant, RateLimiter::Clock::time_point now) {
+        size_t acquired = 0;
+        while (limiter.TryAcquire(tenant, now) && acquired < 100000) {
+            acquired++;
+        }
+        return acquired;
+    }
+}
+
+TEST_CASE("Rate limiter without limits admits all calls", "[rate-limiter]") {
+    RateLimiter limiter(0, {});
+    REQUIRE_FALSE(limiter.IsEnabled());
+
+    for (int i = 0; i < 1000; i++) {
+        REQUIRE(limiter.TryAcquire(1));
+    }
+}
+
+TEST_CASE("Rate limiter limits the zone", "[rate-limiter]") {
+    RateLimiter limiter(10, {});
+    auto now = RateLimiter::Clock::now();
+    REQUIRE(limiter.IsEnabled());
+
+    SECTION("A burst of a second of calls passes") {
+        REQUIRE(Drain(limiter, 0, now) == 10);
+    }
+
+    SECTION("Tokens refill at the rate") {
+        REQUIRE(Drain(limiter, 0, now) == 10);
+        REQUIRE(Drain(limiter, 0, now + std::chrono::milliseconds(300)) == 3);
+    }
+
+    SECTION("Tokens don't accrue past a second of calls") {
+        REQUIRE(Drain(limiter, 0, now + std::chrono::seconds(10)) == 10);
+    }
+
+    SECTION("All tenants share the zone's rate") {
+        REQUIRE(Drain(limiter, 1, now) == 10);
+        REQUIRE_FALSE(limiter.TryAcquire(2, now));
+    }
+}
+
+TEST_CASE("Rate limiter limits tenants", "[rate-limiter]") {
+    SECTION("Tenants have their own rate") {
+        RateLimiter limiter(0, { { "gold", 1, 5 }, { "silver", 2, 2 } });
+        auto now = RateLimiter::Clock::now();
+        REQUIRE(Drain(limiter, 1, now) == 5);
+        REQUIRE(Drain(limiter, 2, now) == 2);
+
+        // Tenants without a rate and the default tenant are not limited.
+        REQUIRE(Drain(limiter, 3, now) == 100000);
+        REQUIRE(Drain(limiter, 0, now) == 100000);
+    }
+
+    SECTION("The '*' rate applies to each other tenant") {
+        RateLimiter limiter(0, { { "gold", 1, 5 }, { "*", 0, 3 } });
+        auto now = RateLimiter::Clock::now();
+        REQUIRE(Drain(limiter, 1, now) == 5);
+        REQUIRE(Drain(limiter, 3, now) == 3);
+        REQUIRE(Drain(limiter, 4, now) == 3);
+        REQUIRE(limiter.TryAcquire(0, now));
+    }
+
+    SECTION("Calls rejected by the zone don't cost their tenant") {
+        RateLimiter limiter(2, { { "gold", 1, 3 } });
+        auto now = RateLimiter::Clock::now();
+        REQUIRE(Drain(limiter, 1, now) == 2);
+        REQUIRE_FALSE(limiter.TryAcquire(1, now));
+
+        // Gold kept the token of its rejected call, it makes a third call as soon as the zone has a token.
+        REQUIRE(Drain(limiter, 1, now + std::chrono::milliseconds(500)) == 1);
+    }
+}
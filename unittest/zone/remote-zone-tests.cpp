@@ -0,0 +1,442 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/remote-protocol.h"
+#include "zone/remote-zone.h"
+#include "zone/shared-memory-channel.h"
+#include "zone/zone-server.h"
+
+#include <platform/process.h>
+
+#include <napa/transport/transport-context.h>
+
+#include <atomic>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <thread>
+
+using namespace napa;
+using namespace napa::zone;
+using namespace napa::zone::remote;
+
+namespace {
+
+    /// <summary> A zone answering calls with their function and arguments, from a thread of its own. </summary>
+    class EchoZone : public Zone {
+    public:
+        const std::string& GetId() const override { return _id; }
+        size_t GetQueueLength() const override { return 0; }
+        uint32_t GetWorkerCount() const override { return 3; }
+
+        void Cancel(uint64_t token) override {
+            cancelledToken = token;
+        }
+
+        void Broadcast(const FunctionSpec& spec, const std::vector<uint32_t>& workerIds, BroadcastCallback callback) override {
+            Reply(spec, "broadcast:" + std::to_string(workerIds.size()), std::move(callback));
+        }
+
+        void Execute(const FunctionSpec& spec, ExecuteCallback callback) override {
+            Reply(spec, "execute", std::move(callback));
+        }
+
+        void ExecuteOnWorker(uint32_t workerId, const FunctionSpec& spec, ExecuteCallback callback) override {
+            Reply(spec, "worker:" + std::to_string(workerId), std::move(callback));
+        }
+
+        void ExecuteBatch(const std::vector<FunctionSpec>&, ExecuteBatchCallback callback) override { callback({}); }
+        void ExecuteNative(NativeFunction, NativeCallback callback) override { callback(NAPA_RESULT_SUCCESS); }
+        void GetHeapStatistics(HeapStatisticsCallback callback) override { callback({}); }
+        ZoneStats GetStats() const override { return ZoneStats(); }
+        std::vector<FunctionStats> GetFunctionStats() const override { return {}; }
+        void NotifyMemoryPressure(MemoryPressureLevel) override {}
+        void StartProfiling(const std::vector<uint32_t>&, uint32_t) override {}
+        void StopProfiling(CpuProfilesCallback callback) override { callback({}); }
+        ResultCode Recycle() override { return NAPA_RESULT_SUCCESS; }
+
+        ~EchoZone() {
+            for (auto& thread : _threads) {
+                thread.join();
+            }
+        }
+
+        /// <summary> Calls of this function are held until released. </summary>
+        std::string heldFunction = "hold";
+        std::vector<ExecuteCallback> held;
+
+        /// <summary> Calls of this function return a shared object. </summary>
+        std::string sharingFunction = "share";
+
+        std::atomic<uint64_t> cancelledToken { 0 };
+        std::mutex lock;
+
+    private:
+        void Reply(const FunctionSpec& spec, std::string kind, ExecuteCallback callback) {
+            auto function = NAPA_STRING_REF_TO_STD_STRING(spec.function);
+            if (function == heldFunction) {
+                std::lock_guard<std::mutex> guard(lock);
+                held.push_back(std::move(callback));
+                return;
+            }
+
+            std::string value = kind + ":" + NAPA_STRING_REF_TO_STD_STRING(spec.module) + "." + function;
+            for (const auto& argument : spec.ownedArguments) {
+                value += "|" + argument;
+            }
+            auto timeout = spec.options.timeout;
+            auto sharing = function == sharingFunction;
+
+            // Results complete out of order, on another thread, like zone workers do.
+            std::lock_guard<std::mutex> guard(lock);
+            _threads.emplace_back([value, timeout, sharing, callback = std::move(callback)]() {
+                std::this_thread::sleep_for(std::chrono::microseconds(timeout));
+                auto context = std::make_unique<napa::transport::TransportContext>();
+                if (sharing) {
+                    context->SaveShared(std::make_shared<int>(1));
+                }
+                callback({ NAPA_RESULT_SUCCESS, "", value, std::move(context) });
+            });
+        }
+
+        std::string _id = "echo";
+        std::vector<std::thread> _threads;
+    };
+
+    FunctionSpec MakeSpec(const char* function, std::vector<StringRef> arguments = {}) {
+        FunctionSpec spec;
+        spec.module = NAPA_STRING_REF("mod");
+        spec.function = NAPA_STRING_REF_WITH_SIZE(function, strlen(function));
+        spec.arguments = std::move(arguments);
+        return spec;
+    }
+
+    /// <summary> A segment name of this process, so runs of tests don't share segments. </summary>
+    std::string MakeSegmentName(const char* name) {
+        return std::string("unittest-") + name + "-" + std::to_string(platform::Getpid());
+    }
+
+    Result Call(Zone& zone, const FunctionSpec& spec) {
+        std::promise<Result> promise;
+        zone.Execute(spec, [&promise](Result result) { promise.set_value(std::move(result)); });
+        return promise.get_future().get();
+    }
+}
+
+TEST_CASE("remote protocol round trips a spec and a result", "[remote-zone]") {
+    std::string binary("a\0b", 3);
+    auto spec = MakeSpec("run", { NAPA_STRING_REF("\"x\""), STD_STRING_TO_NAPA_STRING_REF(binary) });
+    spec.options.timeout = 7;
+    spec.options.transport = BINARY;
+    spec.options.deadline = 1234567890123;
+    spec.options.tenant = 42;
+    spec.options.trace_id = 0xffffffffffffffffull;
+
+    MessageWriter writer(MessageType::Execute, 99);
+    writer.WriteSpec(spec);
+    auto& message = writer.Finish();
+
+    auto header = ReadHeader(message.data());
+    REQUIRE(header.type == MessageType::Execute);
+    REQUIRE(header.requestId == 99);
+    REQUIRE(header.size == message.size() - HEADER_SIZE);
+
+    DecodedSpec decoded;
+    MessageReader reader(message.data() + HEADER_SIZE, header.size);
+    REQUIRE(reader.ReadSpec(decoded));
+    REQUIRE(reader.IsAtEnd());
+    REQUIRE(NAPA_STRING_REF_TO_STD_STRING(decoded.spec.module) == "mod");
+    REQUIRE(NAPA_STRING_REF_TO_STD_STRING(decoded.spec.function) == "run");
+    REQUIRE(decoded.spec.ownedArguments == std::vector<std::string>({ "\"x\"", binary }));
+    REQUIRE(decoded.spec.options.timeout == 7);
+    REQUIRE(decoded.spec.options.transport == BINARY);
+    REQUIRE(decoded.spec.options.deadline == 1234567890123);
+    REQUIRE(decoded.spec.options.tenant == 42);
+    REQUIRE(decoded.spec.options.trace_id == 0xffffffffffffffffull);
+    REQUIRE(decoded.spec.transportContext != nullptr);
+
+    MessageWriter resultWriter(MessageType::Result, 99);
+    resultWriter.WriteResult({ NAPA_RESULT_TIMEOUT, "late", "1", nullptr, { 1, 2, 3, 4 } });
+    auto& resultMessage = resultWriter.Finish();
+
+    Result result;
+    MessageReader resultReader(resultMessage.data() + HEADER_SIZE, resultMessage.size() - HEADER_SIZE);
+    REQUIRE(resultReader.ReadResult(result));
+    REQUIRE(result.code == NAPA_RESULT_TIMEOUT);
+    REQUIRE(result.errorMessage == "late");
+    REQUIRE(result.returnValue == "1");
+    REQUIRE(result.timing.execute == 3);
+    REQUIRE(result.timing.marshall == 4);
+}
+
+TEST_CASE("remote protocol rejects a truncated spec", "[remote-zone]") {
+    MessageWriter writer(MessageType::Execute, 1);
+    writer.WriteSpec(MakeSpec("run", { NAPA_STRING_REF("1") }));
+    auto& message = writer.Finish();
+
+    for (size_t size = 0; size < message.size() - HEADER_SIZE; size++) {
+        DecodedSpec decoded;
+        MessageReader reader(message.data() + HEADER_SIZE, size);
+        REQUIRE_FALSE(reader.ReadSpec(decoded));
+    }
+}
+
+TEST_CASE("remote zone calls a served zone", "[remote-zone]") {
+    auto echo = std::make_shared<EchoZone>();
+    auto server = ZoneServer::Start(echo, "127.0.0.1:0");
+    REQUIRE(server != nullptr);
+    REQUIRE(server->GetPort() != 0);
+
+    auto remote = RemoteZone::Connect("127.0.0.1:" + std::to_string(server->GetPort()), 2);
+    REQUIRE(remote != nullptr);
+    REQUIRE(remote->GetId() == "echo");
+    REQUIRE(remote->GetWorkerCount() == 3);
+
+    SECTION("execute") {
+        std::string binary("\0\1\2", 3);
+        auto result = Call(*remote, MakeSpec("run", { NAPA_STRING_REF("1"), STD_STRING_TO_NAPA_STRING_REF(binary) }));
+        REQUIRE(result.code == NAPA_RESULT_SUCCESS);
+        REQUIRE(result.returnValue == "execute:mod.run|1|" + binary);
+        REQUIRE(result.transportContext != nullptr);
+    }
+
+    SECTION("execute on a worker and broadcast") {
+        std::promise<Result> onWorker;
+        remote->ExecuteOnWorker(2, MakeSpec("run"), [&onWorker](Result result) { onWorker.set_value(std::move(result)); });
+        REQUIRE(onWorker.get_future().get().returnValue == "worker:2:mod.run");
+
+        std::promise<Result> broadcast;
+        remote->Broadcast(MakeSpec("run"), { 0, 1 }, [&broadcast](Result result) { broadcast.set_value(std::move(result)); });
+        REQUIRE(broadcast.get_future().get().returnValue == "broadcast:2:mod.run");
+    }
+
+    SECTION("pipelined calls complete out of order") {
+        constexpr size_t CALLS = 200;
+        std::vector<std::string> values(CALLS);
+        std::vector<std::promise<void>> done(CALLS);
+        std::vector<std::string> arguments(CALLS);
+        for (size_t i = 0; i < CALLS; i++) {
+            arguments[i] = std::to_string(i);
+            auto spec = MakeSpec("run", { STD_STRING_TO_NAPA_STRING_REF(arguments[i]) });
+            spec.options.timeout = static_cast<uint32_t>((CALLS - i) * 10);
+            remote->Execute(spec, [&values, &done, i](Result result) {
+                values[i] = std::move(result.returnValue);
+                done[i].set_value();
+            });
+        }
+        for (size_t i = 0; i < CALLS; i++) {
+            done[i].get_future().wait();
+            REQUIRE(values[i] == "execute:mod.run|" + std::to_string(i));
+        }
+        REQUIRE(remote->GetQueueLength() == 0);
+    }
+
+    SECTION("execute batch") {
+        std::vector<FunctionSpec> specs;
+        specs.push_back(MakeSpec("a"));
+        specs.push_back(MakeSpec("b"));
+
+        std::promise<std::vector<Result>> promise;
+        remote->ExecuteBatch(specs, [&promise](std::vector<Result> results) {
+            promise.set_value(std::move(results));
+        });
+        auto results = promise.get_future().get();
+        REQUIRE(results.size() == 2);
+        REQUIRE(results[0].returnValue == "execute:mod.a");
+        REQUIRE(results[1].returnValue == "execute:mod.b");
+    }
+
+    SECTION("cancel reaches the served zone") {
+        remote->Cancel(77);
+
+        // Messages of a connection are handled in order, so a call made after the cancel sees it.
+        for (int i = 0; i < 2 && echo->cancelledToken != 77; i++) {
+            Call(*remote, MakeSpec("run"));
+        }
+        REQUIRE(echo->cancelledToken == 77);
+    }
+
+    SECTION("shared objects don't cross the connection") {
+        auto spec = MakeSpec("run");
+        spec.transportContext = std::make_unique<napa::transport::TransportContext>();
+        spec.transportContext->SaveShared(std::make_shared<int>(1));
+        REQUIRE(Call(*remote, spec).code == NAPA_RESULT_REMOTE_UNSUPPORTED);
+
+        REQUIRE(Call(*remote, MakeSpec("share")).code == NAPA_RESULT_REMOTE_UNSUPPORTED);
+
+        std::promise<ResultCode> native;
+        remote->ExecuteNative([]() {}, [&native](ResultCode code) { native.set_value(code); });
+        REQUIRE(native.get_future().get() == NAPA_RESULT_REMOTE_UNSUPPORTED);
+    }
+
+    SECTION("calls fail once the server goes away") {
+        std::promise<Result> promise;
+        remote->Execute(MakeSpec("hold"), [&promise](Result result) { promise.set_value(std::move(result)); });
+        while (true) {
+            std::lock_guard<std::mutex> guard(echo->lock);
+            if (!echo->held.empty()) {
+                break;
+            }
+        }
+
+        server = nullptr;
+        REQUIRE(promise.get_future().get().code == NAPA_RESULT_REMOTE_CONNECTION_ERROR);
+        REQUIRE(Call(*remote, MakeSpec("run")).code == NAPA_RESULT_REMOTE_CONNECTION_ERROR);
+    }
+
+    SECTION("recycle waits for calls, then fails later ones") {
+        std::promise<Result> promise;
+        remote->Execute(MakeSpec("hold"), [&promise](Result result) { promise.set_value(std::move(result)); });
+        while (true) {
+            std::lock_guard<std::mutex> guard(echo->lock);
+            if (!echo->held.empty()) {
+                break;
+            }
+        }
+
+        auto recycled = std::async(std::launch::async, [&remote]() { return remote->Recycle(); });
+        REQUIRE(recycled.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+        {
+            std::lock_guard<std::mutex> guard(echo->lock);
+            echo->held[0]({ NAPA_RESULT_SUCCESS, "", "held", std::make_unique<napa::transport::TransportContext>() });
+        }
+        REQUIRE(recycled.get() == NAPA_RESULT_SUCCESS);
+        REQUIRE(promise.get_future().get().returnValue == "held");
+        REQUIRE(Call(*remote, MakeSpec("run")).code == NAPA_RESULT_ZONE_RECYCLED);
+        REQUIRE(remote->GetWorkerCount() == 0);
+    }
+
+    remote = nullptr;
+    server = nullptr;
+}
+
+TEST_CASE("remote zone fails to connect to an address without a server", "[remote-zone]") {
+    uint16_t port;
+    {
+        platform::Listener listener("127.0.0.1", 0);
+        REQUIRE(listener.IsListening());
+        port = listener.GetPort();
+    }
+
+    REQUIRE(RemoteZone::Connect("127.0.0.1:" + std::to_string(port), 1) == nullptr);
+    REQUIRE(RemoteZone::Connect("no-port", 1) == nullptr);
+    REQUIRE(ZoneServer::Start(std::make_shared<EchoZone>(), "127.0.0.1") == nullptr);
+}
+
+TEST_CASE("shared memory channel streams bytes through its rings", "[remote-zone]") {
+    auto name = MakeSegmentName("channel");
+    auto listener = SharedMemoryChannelListener::Create(name);
+    REQUIRE(listener != nullptr);
+    REQUIRE(SharedMemoryChannelListener::Create(name) == nullptr);
+
+    auto accepted = std::async(std::launch::async, [&listener]() { return listener->Accept(); });
+    auto client = ConnectSharedMemoryChannel(name);
+    REQUIRE(client != nullptr);
+    auto server = accepted.get();
+    REQUIRE(server != nullptr);
+
+    SECTION("messages larger than a ring wrap around it") {
+        std::string sent(3 * 1024 * 1024 + 17, '\0');
+        for (size_t i = 0; i < sent.size(); i++) {
+            sent[i] = static_cast<char>(i * 31);
+        }
+
+        auto writer = std::async(std::launch::async, [&client, &sent]() { return client->Write(sent.data(), sent.size()); });
+        std::string received(sent.size(), '\0');
+        size_t offset = 0;
+        for (size_t chunk = 1; offset < received.size(); chunk = chunk * 3 % 100003 + 1) {
+            auto size = std::min(chunk, received.size() - offset);
+            REQUIRE(server->Read(&received[offset], size));
+            offset += size;
+        }
+        REQUIRE(writer.get());
+        REQUIRE(received == sent);
+
+        REQUIRE(server->Write("ok", 2));
+        char reply[2];
+        REQUIRE(client->Read(reply, 2));
+        REQUIRE(std::string(reply, 2) == "ok");
+    }
+
+    SECTION("a shut down channel fails blocked reads of its peer") {
+        auto reader = std::async(std::launch::async, [&server]() {
+            char byte;
+            return server->Read(&byte, 1);
+        });
+        REQUIRE(reader.wait_for(std::chrono::milliseconds(20)) == std::future_status::timeout);
+        client->Shutdown();
+        REQUIRE_FALSE(reader.get());
+        REQUIRE_FALSE(client->Write("x", 1));
+    }
+
+    client = nullptr;
+    server = nullptr;
+    listener = nullptr;
+    REQUIRE(ConnectSharedMemoryChannel(name) == nullptr);
+}
+
+TEST_CASE("remote zone calls a zone served on shared memory", "[remote-zone]") {
+    auto name = MakeSegmentName("zone");
+    auto echo = std::make_shared<EchoZone>();
+    auto server = ZoneServer::StartSharedMemory(echo, name);
+    REQUIRE(server != nullptr);
+    REQUIRE(server->GetPort() == 0);
+
+    auto remote = RemoteZone::ConnectSharedMemory(name, 2);
+    REQUIRE(remote != nullptr);
+    REQUIRE(remote->GetId() == "echo");
+    REQUIRE(remote->GetWorkerCount() == 3);
+
+    SECTION("pipelined calls with large arguments") {
+        constexpr size_t CALLS = 50;
+        std::string large(512 * 1024, 'x');
+        std::vector<std::string> values(CALLS);
+        std::vector<std::promise<void>> done(CALLS);
+        std::vector<std::string> arguments(CALLS);
+        for (size_t i = 0; i < CALLS; i++) {
+            arguments[i] = std::to_string(i);
+            auto spec = MakeSpec("run", { STD_STRING_TO_NAPA_STRING_REF(arguments[i]), STD_STRING_TO_NAPA_STRING_REF(large) });
+            spec.options.timeout = static_cast<uint32_t>((CALLS - i) * 10);
+            remote->Execute(spec, [&values, &done, i](Result result) {
+                values[i] = std::move(result.returnValue);
+                done[i].set_value();
+            });
+        }
+        for (size_t i = 0; i < CALLS; i++) {
+            done[i].get_future().wait();
+            REQUIRE(values[i] == "execute:mod.run|" + std::to_string(i) + "|" + large);
+        }
+        REQUIRE(remote->GetQueueLength() == 0);
+    }
+
+    SECTION("slots of closed clients are reused") {
+        for (int i = 0; i < 40; i++) {
+            auto client = RemoteZone::ConnectSharedMemory(name, 1);
+            REQUIRE(client != nullptr);
+            REQUIRE(Call(*client, MakeSpec("run")).returnValue == "execute:mod.run");
+        }
+    }
+
+    SECTION("calls fail once the server goes away") {
+        std::promise<Result> promise;
+        remote->Execute(MakeSpec("hold"), [&promise](Result result) { promise.set_value(std::move(result)); });
+        while (true) {
+            std::lock_guard<std::mutex> guard(echo->lock);
+            if (!echo->held.empty()) {
+                break;
+            }
+        }
+
+        server = nullptr;
+        REQUIRE(promise.get_future().get().code == NAPA_RESULT_REMOTE_CONNECTION_ERROR);
+        REQUIRE(Call(*remote, MakeSpec("run")).code == NAPA_RESULT_REMOTE_CONNECTION_ERROR);
+        REQUIRE(RemoteZone::ConnectSharedMemory(name, 1) == nullptr);
+    }
+
+    remote = nullptr;
+    server = nullptr;
+    REQUIRE(RemoteZone::ConnectSharedMemory(MakeSegmentName("unserved"), 1) == nullptr);
+    REQUIRE(ZoneServer::StartSharedMemory(echo, "a/b") == nullptr);
+}
@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/result-cache.h"
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+    FunctionSpec MakeSpec(const char* function, std::vector<StringRef> arguments) {
+        FunctionSpec spec;
+        spec.module = NAPA_STRING_REF("module");
+        spec.function = NAPA_STRING_REF(function);
+        spec.arguments = std::move(arguments);
+        return spec;
+    }
+}
+
+TEST_CASE("result cache returns results until they expire", "[result-cache]") {
+    ResultCache cache("zone", 1024);
+
+    std::string value;
+    REQUIRE(!cache.Get("key", value));
+
+    cache.Put("key", "result", std::chrono::milliseconds(50));
+    REQUIRE(cache.Get("key", value));
+    REQUIRE(value == "result");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    REQUIRE(!cache.Get("key", value));
+
+    auto statistics = cache.GetStatistics();
+    REQUIRE(statistics.hits == 1);
+    REQUIRE(statistics.misses == 2);
+    REQUIRE(statistics.expirations == 1);
+    REQUIRE(statistics.entries == 0);
+    REQUIRE(statistics.bytes == 0);
+}
+
+TEST_CASE("result cache evicts the least recently used results", "[result-cache]") {
+    // Each entry takes 2 bytes of key and 8 bytes of result.
+    ResultCache cache("zone", 30);
+    auto ttl = std::chrono::milliseconds(60000);
+
+    cache.Put("k1", "result-1", ttl);
+    cache.Put("k2", "result-2", ttl);
+    cache.Put("k3", "result-3", ttl);
+
+    std::string value;
+    REQUIRE(cache.Get("k1", value));
+
+    cache.Put("k4", "result-4", ttl);
+    REQUIRE(cache.Get("k1", value));
+    REQUIRE(!cache.Get("k2", value));
+    REQUIRE(cache.Get("k3", value));
+    REQUIRE(cache.Get("k4", value));
+
+    auto statistics = cache.GetStatistics();
+    REQUIRE(statistics.evictions == 1);
+    REQUIRE(statistics.entries == 3);
+    REQUIRE(statistics.bytes == 30);
+
+    SECTION("replacing a result doesn't evict") {
+        cache.Put("k4", "replaced", ttl);
+        REQUIRE(cache.Get("k4", value));
+        REQUIRE(value == "replaced");
+        REQUIRE(cache.GetStatistics().evictions == 1);
+    }
+
+    SECTION("results larger than the cache are not cached") {
+        cache.Put("k5", std::string(64, 'x'), ttl);
+        REQUIRE(!cache.Get("k5", value));
+        REQUIRE(cache.GetStatistics().entries == 3);
+    }
+
+    SECTION("clear drops all results") {
+        cache.Clear();
+        REQUIRE(!cache.Get("k1", value));
+        REQUIRE(cache.GetStatistics().bytes == 0);
+    }
+}
+
+TEST_CASE("result cache keys calls by function and arguments", "[result-cache]") {
+    auto key = ResultCache::MakeKey(MakeSpec("f", { NAPA_STRING_REF("1"), NAPA_STRING_REF("2") }));
+    REQUIRE(key == ResultCache::MakeKey(MakeSpec("f", { NAPA_STRING_REF("1"), NAPA_STRING_REF("2") })));
+    REQUIRE(key != ResultCache::MakeKey(MakeSpec("g", { NAPA_STRING_REF("1"), NAPA_STRING_REF("2") })));
+    REQUIRE(key != ResultCache::MakeKey(MakeSpec("f", { NAPA_STRING_REF("12") })));
+
+    SECTION("owned arguments make the same key") {
+        auto spec = MakeSpec("f", {});
+        spec.ownedArguments = { "1", "2" };
+        REQUIRE(key == ResultCache::MakeKey(spec));
+    }
+
+    SECTION("a cache key replaces the arguments") {
+        auto first = MakeSpec("f", { NAPA_STRING_REF("1") });
+        auto second = MakeSpec("f", { NAPA_STRING_REF("2") });
+        first.options.cache_key = second.options.cache_key = 42;
+        REQUIRE(ResultCache::MakeKey(first) == ResultCache::MakeKey(second));
+        REQUIRE(key != ResultCache::MakeKey(first));
+    }
+}
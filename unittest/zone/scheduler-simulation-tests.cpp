@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include "scheduler-simulation.h"
+
+using namespace napa;
+using namespace napa::zone;
+using namespace napa::zone::simulation;
+using namespace napa::settings;
+
+static ZoneSettings CreateSettings(uint32_t workers, SchedulerType type) {
+    ZoneSettings settings;
+    settings.workers = workers;
+    settings.scheduler = type;
+    return settings;
+}
+
+TEST_CASE("scheduler simulation is reproducible", "[scheduler-simulation]") {
+    Workload workload;
+    workload.arrivals = PoissonArrivals(3500);
+    workload.classes[0].serviceTime = ExponentialServiceTime(1000);
+    workload.classes[0].routingKeys = 16;
+    workload.calls = 2000;
+    workload.seed = 42;
+
+    for (auto type : { SchedulerType::Synchronized, SchedulerType::LockFree, SchedulerType::WorkStealing }) {
+        SchedulerSimulation simulation(CreateSettings(4, type));
+        auto first = simulation.Run(workload);
+        auto second = simulation.Run(workload);
+
+        REQUIRE(first.completed == 2000);
+        REQUIRE(first.ToString() == second.ToString());
+    }
+
+    // Another seed is another workload.
+    SchedulerSimulation simulation(CreateSettings(4, SchedulerType::Synchronized));
+    auto first = simulation.Run(workload);
+    workload.seed = 43;
+    REQUIRE(first.ToString() != simulation.Run(workload).ToString());
+}
+
+TEST_CASE("scheduler simulation matches the queueing delay of a single server queue", "[scheduler-simulation]") {
+    // With Poisson arrivals and exponential service times, a single worker at 50% load waits for as long as a
+    // call takes on average.
+    Workload workload;
+    workload.arrivals = PoissonArrivals(500);
+    workload.classes[0].serviceTime = ExponentialServiceTime(1000);
+    workload.calls = 5000;
+
+    SchedulerSimulation simulation(CreateSettings(1, SchedulerType::Synchronized));
+    auto report = simulation.Run(workload);
+
+    REQUIRE(report.completed == 5000);
+    REQUIRE(report.meanQueueingDelay == Approx(1.0).epsilon(0.25));
+    REQUIRE(report.throughput == Approx(500).epsilon(0.1));
+    REQUIRE(report.workerUtilization[0] == Approx(0.5).epsilon(0.1));
+}
+
+TEST_CASE("scheduler simulation reports longer delays for bursty arrivals", "[scheduler-simulation]") {
+    Workload steady;
+    steady.arrivals = PoissonArrivals(2000);
+    steady.calls = 2000;
+
+    // Bursts of 50 calls at 20000 calls per second, 22.5 ms apart, have the same mean rate.
+    Workload bursty = steady;
+    bursty.arrivals = BurstyArrivals(20000, 50, 22500);
+
+    SchedulerSimulation simulation(CreateSettings(4, SchedulerType::Synchronized));
+    auto steadyReport = simulation.Run(steady);
+    auto burstyReport = simulation.Run(bursty);
+
+    REQUIRE(burstyReport.completed == 2000);
+    REQUIRE(burstyReport.meanQueueingDelay > 2 * steadyReport.meanQueueingDelay);
+    REQUIRE(burstyReport.p99QueueingDelay > steadyReport.p99QueueingDelay);
+    REQUIRE(steadyReport.workerBalance > 0.95);
+}
+
+TEST_CASE("scheduler simulation compares tenant weights", "[scheduler-simulation]") {
+    // Both tenants send the same calls, more than the workers can serve.
+    Workload workload;
+    workload.arrivals = PoissonArrivals(4400);
+    workload.classes = { CallClass(), CallClass() };
+    workload.classes[0].name = "gold";
+    workload.classes[0].tenant = 1;
+    workload.classes[1].name = "silver";
+    workload.classes[1].tenant = 2;
+    workload.calls = 2000;
+
+    auto settings = CreateSettings(4, SchedulerType::Synchronized);
+    auto fair = SchedulerSimulation(settings).Run(workload);
+
+    settings.tenantWeights = { { "1", 1, 4 }, { "2", 2, 1 } };
+    auto weighted = SchedulerSimulation(settings).Run(workload);
+
+    REQUIRE(weighted.completed == 2000);
+    REQUIRE(fair.fairness > weighted.fairness);
+    REQUIRE(weighted.classes[0].meanQueueingDelay < fair.classes[0].meanQueueingDelay);
+    REQUIRE(weighted.classes[0].meanQueueingDelay < weighted.classes[1].meanQueueingDelay);
+}
+
+TEST_CASE("scheduler simulation reports rejected calls and slow workers", "[scheduler-simulation]") {
+    Workload workload;
+    workload.arrivals = PoissonArrivals(8000);
+    workload.calls = 1000;
+
+    auto settings = CreateSettings(2, SchedulerType::Synchronized);
+    settings.maxQueueLength = 4;
+    settings.overloadPolicy = OverloadPolicy::Reject;
+    auto report = SchedulerSimulation(settings, { 1.0, 0.25 }).Run(workload);
+
+    REQUIRE(report.rejected > 0);
+    REQUIRE(report.completed + report.rejected == 1000);
+    REQUIRE(report.maxQueueingDelay > 0);
+
+    // Both workers are saturated, the slow one does less work in the same time.
+    REQUIRE(report.workerUtilization.size() == 2);
+    REQUIRE(report.workerUtilization[0] > 0.9);
+    REQUIRE(report.workerUtilization[1] > 0.9);
+    REQUIRE(report.workerBalance == Approx(1.0).epsilon(0.05));
+}
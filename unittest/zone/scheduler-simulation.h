@@ -0,0 +1,578 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#pragma once
+
+#include <zone/scheduler.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace napa {
+namespace zone {
+namespace simulation {
+
+    /// <summary> Virtual time of a simulation, in microseconds. </summary>
+    using Microseconds = int64_t;
+
+    /// <summary> Draws an uniform number in [0, 1), the same for a seed whatever the standard library. </summary>
+    inline double DrawUniform(std::mt19937_64& random) {
+        return static_cast<double>(random() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    /// <summary> Draws an exponentially distributed number of the given mean, by inverse transform sampling. </summary>
+    inline double DrawExponential(std::mt19937_64& random, double mean) {
+        return -mean * std::log(1.0 - DrawUniform(random));
+    }
+
+    /// <summary> Draws the time a worker spends running a call. </summary>
+    using ServiceTime = std::function<Microseconds(std::mt19937_64&)>;
+
+    /// <summary> Calls that all take the same time. </summary>
+    inline ServiceTime ConstantServiceTime(Microseconds time) {
+        return [time](std::mt19937_64&) { return time; };
+    }
+
+    /// <summary> Calls whose times are exponentially distributed. </summary>
+    inline ServiceTime ExponentialServiceTime(Microseconds mean) {
+        return [mean](std::mt19937_64& random) {
+            return std::max<Microseconds>(1, static_cast<Microseconds>(DrawExponential(random, static_cast<double>(mean))));
+        };
+    }
+
+    /// <summary> Mostly fast calls, with a fraction of slow ones. </summary>
+    inline ServiceTime BimodalServiceTime(Microseconds fast, Microseconds slow, double slowFraction) {
+        return [fast, slow, slowFraction](std::mt19937_64& random) {
+            return DrawUniform(random) < slowFraction ? slow : fast;
+        };
+    }
+
+    /// <summary> Draws the time between a call and the next one. </summary>
+    using ArrivalProcess = std::function<Microseconds(std::mt19937_64&)>;
+
+    /// <summary> Calls arriving independently of each other, at the given mean rate. </summary>
+    inline ArrivalProcess PoissonArrivals(double callsPerSecond) {
+        return [callsPerSecond](std::mt19937_64& random) {
+            return static_cast<Microseconds>(DrawExponential(random, 1000000.0 / callsPerSecond));
+        };
+    }
+
+    /// <summary> Bursts of calls arriving at the given rate, separated by quiet periods of exponential length. </summary>
+    /// <param name="callsPerSecond"> The rate of calls within a burst. </param>
+    /// <param name="burstSize"> The number of calls of a burst. </param>
+    /// <param name="meanQuietTime"> The mean time between the last call of a burst and the first call of the next one. </param>
+    inline ArrivalProcess BurstyArrivals(double callsPerSecond, uint32_t burstSize, Microseconds meanQuietTime) {
+        auto calls = std::make_shared<uint32_t>(0);
+        return [callsPerSecond, burstSize, meanQuietTime, calls](std::mt19937_64& random) {
+            if (++(*calls) % burstSize == 0) {
+                return static_cast<Microseconds>(DrawExponential(random, static_cast<double>(meanQuietTime)));
+            }
+            return static_cast<Microseconds>(DrawExponential(random, 1000000.0 / callsPerSecond));
+        };
+    }
+
+    /// <summary> A kind of calls of a workload. </summary>
+    struct CallClass {
+
+        /// <summary> The name the class is reported with. </summary>
+        std::string name;
+
+        /// <summary> The share of the arrivals of the class, relative to the shares of the other classes. </summary>
+        double share = 1;
+
+        /// <summary> The tenant key of the calls, as given to tenantWeights. </summary>
+        uint64_t tenant = 0;
+
+        /// <summary> The scheduling priority of the calls. </summary>
+        uint32_t priority = 0;
+
+        /// <summary> The number of routing keys the calls are spread over, 0 for calls without routing key. </summary>
+        uint32_t routingKeys = 0;
+
+        /// <summary> The time a worker of speed 1 spends running a call. </summary>
+        ServiceTime serviceTime = ConstantServiceTime(1000);
+    };
+
+    /// <summary> The calls a simulation schedules. </summary>
+    struct Workload {
+
+        /// <summary> The times between calls. </summary>
+        ArrivalProcess arrivals = PoissonArrivals(1000);
+
+        /// <summary> The kinds of calls, each call draws its class by share. </summary>
+        std::vector<CallClass> classes = { CallClass() };
+
+        /// <summary> The number of calls. </summary>
+        uint32_t calls = 1000;
+
+        /// <summary> The seed all random draws of the workload derive from. </summary>
+        uint64_t seed = 1;
+    };
+
+    /// <summary> The results of the calls of a class. </summary>
+    struct ClassReport {
+        std::string name;
+        uint32_t completed = 0;
+        uint32_t rejected = 0;
+
+        /// <summary> Milliseconds between arrival and start of the calls. </summary>
+        double meanQueueingDelay = 0;
+        double p99QueueingDelay = 0;
+
+        /// <summary> The mean ratio of time in the zone to service time, 1 for calls that never waited. </summary>
+        double meanSlowdown = 0;
+    };
+
+    /// <summary> The results of a simulation, delays are in milliseconds of virtual time. </summary>
+    struct SimulationReport {
+        uint32_t completed = 0;
+        uint32_t rejected = 0;
+
+        /// <summary> Milliseconds from the first arrival to the last completion. </summary>
+        double duration = 0;
+
+        /// <summary> Completed calls per second. </summary>
+        double throughput = 0;
+
+        double meanQueueingDelay = 0;
+        double p50QueueingDelay = 0;
+        double p99QueueingDelay = 0;
+        double maxQueueingDelay = 0;
+
+        /// <summary> Jain's index of the mean slowdowns of the classes, 1 when all classes are slowed down alike. </summary>
+        double fairness = 1;
+
+        /// <summary> Jain's index of the busy times of the workers, 1 when all workers did the same amount of work. </summary>
+        double workerBalance = 1;
+
+        /// <summary> The fraction of the duration each worker was busy. </summary>
+        std::vector<double> workerUtilization;
+
+        std::vector<ClassReport> classes;
+
+        /// <summary> Returns the report as text, to compare runs side by side. </summary>
+        std::string ToString() const {
+            std::stringstream ss;
+            ss << std::fixed << std::setprecision(3)
+                << "completed=" << completed << " rejected=" << rejected
+                << " throughput=" << throughput << "/s"
+                << " delay(mean/p50/p99/max)=" << meanQueueingDelay << "/" << p50QueueingDelay
+                << "/" << p99QueueingDelay << "/" << maxQueueingDelay << "ms"
+                << " fairness=" << fairness << " balance=" << workerBalance << "\n";
+            for (const auto& report : classes) {
+                ss << "  " << report.name << ": completed=" << report.completed << " rejected=" << report.rejected
+                    << " delay(mean/p99)=" << report.meanQueueingDelay << "/" << report.p99QueueingDelay << "ms"
+                    << " slowdown=" << report.meanSlowdown << "\n";
+            }
+            return ss.str();
+        }
+    };
+
+    class SchedulerSimulation;
+
+    /// <summary> A call of a simulation, as scheduled by the scheduler under test. </summary>
+    class SimulatedTask : public Task {
+    public:
+        SimulatedTask(SchedulerSimulation& simulation, size_t index, uint32_t priority, uint64_t routingKey, uint64_t tenant) :
+            _simulation(simulation), _index(index), _priority(priority), _routingKey(routingKey), _tenant(tenant) {}
+
+        size_t GetIndex() const { return _index; }
+
+        /// <summary> Workers don't run simulated calls, they are busy for the service time of the call instead. </summary>
+        virtual void Execute() override {}
+
+        virtual uint32_t GetPriority() const override { return _priority; }
+        virtual uint64_t GetRoutingKey() const override { return _routingKey; }
+        virtual uint64_t GetTenant() const override { return _tenant; }
+
+        virtual void Reject(ResultCode code, const std::string& reason) override;
+
+    private:
+        SchedulerSimulation& _simulation;
+        size_t _index;
+        uint32_t _priority;
+        uint64_t _routingKey;
+        uint64_t _tenant;
+    };
+
+    /// <summary> A worker of a simulation, which hands the tasks it's given to the simulation. </summary>
+    class SimulatedWorker {
+    public:
+        SimulatedWorker(WorkerId id,
+                        const settings::ZoneSettings& settings,
+                        std::function<void(WorkerId)> setupCompleteCallback,
+                        std::function<void(WorkerId)> idleCallback);
+
+        SimulatedWorker(SimulatedWorker&&) = default;
+
+        /// <summary> The worker is idle once started, it doesn't run the setup callback since it has no thread. </summary>
+        void Start() {
+            _idleCallback(_id);
+        }
+
+        void Schedule(std::shared_ptr<Task> task, SchedulePhase phase = SchedulePhase::DefaultPhase);
+
+        /// <summary> Simulated calls start as soon as the worker is free. </summary>
+        bool Unschedule(const std::shared_ptr<Task>&) {
+            return false;
+        }
+
+        /// <summary> Workers are never stuck in virtual time. </summary>
+        std::chrono::milliseconds GetBusyDuration() const {
+            return std::chrono::milliseconds(0);
+        }
+
+        void TerminateExecution() {}
+
+        bool NeedsRecycling() const {
+            return false;
+        }
+
+        bool IsSheddingLoad() const {
+            return false;
+        }
+
+        napa::WorkerStats GetStats() const {
+            napa::WorkerStats stats = {};
+            stats.worker_id = _id;
+            return stats;
+        }
+
+        /// <summary> The simulation running on the current process, workers are created by the scheduler. </summary>
+        static SchedulerSimulation*& CurrentSimulation() {
+            static SchedulerSimulation* simulation = nullptr;
+            return simulation;
+        }
+
+    private:
+        WorkerId _id;
+        std::function<void(WorkerId)> _idleCallback;
+    };
+
+    /// <summary>
+    ///     Runs a workload through SchedulerImpl in virtual time. Workers are busy for the service time of each call
+    ///     they are given, without threads or JavaScript, so scheduler changes can be compared on the same workload.
+    /// </summary>
+    /// <remarks>
+    ///     Events are processed one at a time in time order, completions before arrivals of the same time, and the
+    ///     scheduler settles after each of them before the clock moves on. With the same seed, a run makes the same
+    ///     scheduling decisions with any scheduler type, and its report is the same.
+    ///     Timers of the scheduler run in real time, so worker scaling and stuck worker checks, which depend on them,
+    ///     don't make runs reproducible. The block overload policy would block the simulation and is not supported.
+    ///     Simulations run one at a time.
+    /// </remarks>
+    class SchedulerSimulation {
+    public:
+
+        /// <param name="settings"> The zone settings of the scheduler under test. </param>
+        /// <param name="workerSpeeds"> How fast each worker runs calls relative to their service time, 1 by default. </param>
+        SchedulerSimulation(settings::ZoneSettings settings, std::vector<double> workerSpeeds = {}) :
+            _settings(std::move(settings)),
+            _workerSpeeds(std::move(workerSpeeds)) {
+
+            NAPA_ASSERT(_settings.overloadPolicy != settings::OverloadPolicy::Block, "The block overload policy is not supported");
+            auto maxWorkers = std::max(_settings.workers, _settings.maxWorkers);
+            _workerSpeeds.resize(std::max<size_t>(_workerSpeeds.size(), maxWorkers), 1.0);
+        }
+
+        /// <summary> Schedules the calls of a workload and returns how they were served. </summary>
+        SimulationReport Run(const Workload& workload) {
+            NAPA_ASSERT(SimulatedWorker::CurrentSimulation() == nullptr, "Simulations run one at a time");
+            GenerateCalls(workload);
+
+            auto maxWorkers = static_cast<WorkerId>(_workerSpeeds.size());
+            _now = 0;
+            _workers.assign(maxWorkers, WorkerState());
+            _completions = CompletionQueue();
+            _scheduledCount = 0;
+
+            SimulatedWorker::CurrentSimulation() = this;
+            {
+                SchedulerImpl<SimulatedWorker> scheduler(_settings, [](WorkerId) {});
+                _scheduler = &scheduler;
+                Settle();
+
+                size_t nextArrival = 0;
+                while (nextArrival < _calls.size() || !_completions.empty()) {
+                    if (!_completions.empty()
+                        && (nextArrival == _calls.size() || std::get<0>(_completions.top()) <= _calls[nextArrival].arrival)) {
+                        auto completion = _completions.top();
+                        _completions.pop();
+                        _now = std::get<0>(completion);
+                        Complete(std::get<1>(completion));
+                    } else {
+                        auto& call = _calls[nextArrival++];
+                        _now = call.arrival;
+                        scheduler.Schedule(std::make_shared<SimulatedTask>(*this, nextArrival - 1, call.priority, call.routingKey, call.tenant));
+                    }
+                    Settle();
+                }
+                _scheduler = nullptr;
+            }
+            SimulatedWorker::CurrentSimulation() = nullptr;
+
+            return CreateReport(workload);
+        }
+
+    private:
+        friend class SimulatedTask;
+        friend class SimulatedWorker;
+
+        struct Call {
+            Microseconds arrival;
+            Microseconds serviceTime;
+            size_t callClass;
+            uint32_t priority;
+            uint64_t routingKey;
+            uint64_t tenant;
+
+            Microseconds start = -1;
+            Microseconds finish = -1;
+            bool rejected = false;
+        };
+
+        struct WorkerState {
+            std::function<void(WorkerId)> idleCallback;
+            std::queue<size_t> calls;
+            bool busy = false;
+            Microseconds busyTime = 0;
+        };
+
+        /// <summary> Completions by time, then by worker, the earliest on top. </summary>
+        using Completion = std::tuple<Microseconds, WorkerId, size_t>;
+        using CompletionQueue = std::priority_queue<Completion, std::vector<Completion>, std::greater<Completion>>;
+
+        void GenerateCalls(const Workload& workload) {
+            std::mt19937_64 random(workload.seed);
+            double totalShare = 0;
+            for (const auto& callClass : workload.classes) {
+                totalShare += callClass.share;
+            }
+
+            _calls.clear();
+            _calls.reserve(workload.calls);
+            Microseconds arrival = 0;
+            for (uint32_t i = 0; i < workload.calls; i++) {
+                auto draw = DrawUniform(random) * totalShare;
+                size_t index = 0;
+                while (index + 1 < workload.classes.size() && draw >= workload.classes[index].share) {
+                    draw -= workload.classes[index++].share;
+                }
+                const auto& callClass = workload.classes[index];
+
+                Call call;
+                call.arrival = arrival;
+                call.serviceTime = callClass.serviceTime(random);
+                call.callClass = index;
+                call.priority = callClass.priority;
+                call.routingKey = callClass.routingKeys == 0 ? 0 : 1 + random() % callClass.routingKeys;
+                call.tenant = callClass.tenant;
+                _calls.push_back(call);
+
+                arrival += workload.arrivals(random);
+            }
+        }
+
+        /// <summary> Waits until the scheduler processed all it was given, which the synchronized scheduler does on its own thread. </summary>
+        void Settle() {
+            size_t scheduledCount;
+            do {
+                {
+                    std::lock_guard<std::mutex> lock(_lock);
+                    scheduledCount = _scheduledCount;
+                }
+
+                // Stats are collected on the synchronizer, after the work queued before.
+                (void)_scheduler->GetStats();
+
+                std::lock_guard<std::mutex> lock(_lock);
+                if (scheduledCount == _scheduledCount) {
+                    break;
+                }
+            } while (true);
+        }
+
+        void RegisterWorker(WorkerId id, std::function<void(WorkerId)> idleCallback) {
+            std::lock_guard<std::mutex> lock(_lock);
+            _workers[id].idleCallback = std::move(idleCallback);
+        }
+
+        void OnScheduled(WorkerId id, size_t index) {
+            std::lock_guard<std::mutex> lock(_lock);
+            _scheduledCount++;
+            auto& worker = _workers[id];
+            if (worker.busy) {
+                worker.calls.push(index);
+            } else {
+                StartCall(id, index);
+            }
+        }
+
+        void OnRejected(size_t index) {
+            std::lock_guard<std::mutex> lock(_lock);
+            _calls[index].rejected = true;
+        }
+
+        void StartCall(WorkerId id, size_t index) {
+            auto& call = _calls[index];
+            auto& worker = _workers[id];
+            auto serviceTime = std::max<Microseconds>(1, static_cast<Microseconds>(call.serviceTime / _workerSpeeds[id]));
+            call.start = _now;
+            call.finish = _now + serviceTime;
+            worker.busy = true;
+            worker.busyTime += serviceTime;
+            _completions.emplace(call.finish, id, index);
+        }
+
+        /// <summary> Frees a worker that finished a call, it starts its next call or tells the scheduler it's idle. </summary>
+        void Complete(WorkerId id) {
+            std::function<void(WorkerId)> idleCallback;
+            {
+                std::lock_guard<std::mutex> lock(_lock);
+                auto& worker = _workers[id];
+                worker.busy = false;
+                if (!worker.calls.empty()) {
+                    auto index = worker.calls.front();
+                    worker.calls.pop();
+                    StartCall(id, index);
+                    return;
+                }
+                idleCallback = worker.idleCallback;
+            }
+
+            // The lock-free schedulers give the worker its next call within the callback.
+            idleCallback(id);
+        }
+
+        static double Percentile(std::vector<double> values, double percentile) {
+            if (values.empty()) {
+                return 0;
+            }
+            std::sort(values.begin(), values.end());
+            auto rank = static_cast<size_t>(std::ceil(percentile * values.size()));
+            return values[std::min(values.size(), std::max<size_t>(rank, 1)) - 1];
+        }
+
+        static double JainIndex(const std::vector<double>& values) {
+            double sum = 0;
+            double squares = 0;
+            for (auto value : values) {
+                sum += value;
+                squares += value * value;
+            }
+            return squares == 0 ? 1 : sum * sum / (values.size() * squares);
+        }
+
+        SimulationReport CreateReport(const Workload& workload) const {
+            SimulationReport report;
+            std::vector<double> delays;
+            std::vector<std::vector<double>> classDelays(workload.classes.size());
+            std::vector<double> classSlowdowns(workload.classes.size(), 0);
+            report.classes.resize(workload.classes.size());
+
+            Microseconds lastFinish = 0;
+            for (const auto& call : _calls) {
+                auto& classReport = report.classes[call.callClass];
+                if (call.rejected || call.start < 0) {
+                    report.rejected++;
+                    classReport.rejected++;
+                    continue;
+                }
+
+                auto delay = (call.start - call.arrival) / 1000.0;
+                delays.push_back(delay);
+                classDelays[call.callClass].push_back(delay);
+                classSlowdowns[call.callClass] += static_cast<double>(call.finish - call.arrival) / (call.finish - call.start);
+                report.completed++;
+                classReport.completed++;
+                lastFinish = std::max(lastFinish, call.finish);
+            }
+
+            report.duration = (lastFinish - (_calls.empty() ? 0 : _calls.front().arrival)) / 1000.0;
+            report.throughput = report.duration > 0 ? report.completed * 1000.0 / report.duration : 0;
+            if (!delays.empty()) {
+                double total = 0;
+                for (auto delay : delays) {
+                    total += delay;
+                }
+                report.meanQueueingDelay = total / delays.size();
+                report.p50QueueingDelay = Percentile(delays, 0.5);
+                report.p99QueueingDelay = Percentile(delays, 0.99);
+                report.maxQueueingDelay = *std::max_element(delays.begin(), delays.end());
+            }
+
+            std::vector<double> slowdowns;
+            for (size_t i = 0; i < workload.classes.size(); i++) {
+                auto& classReport = report.classes[i];
+                classReport.name = workload.classes[i].name;
+                if (classReport.completed == 0) {
+                    continue;
+                }
+                double total = 0;
+                for (auto delay : classDelays[i]) {
+                    total += delay;
+                }
+                classReport.meanQueueingDelay = total / classReport.completed;
+                classReport.p99QueueingDelay = Percentile(classDelays[i], 0.99);
+                classReport.meanSlowdown = classSlowdowns[i] / classReport.completed;
+                slowdowns.push_back(classReport.meanSlowdown);
+            }
+            report.fairness = JainIndex(slowdowns);
+
+            // Only the workers the zone starts with are reported, slots of elastic zones may never run a worker.
+            std::vector<double> busyTimes;
+            for (WorkerId i = 0; i < _settings.workers && i < _workers.size(); i++) {
+                busyTimes.push_back(static_cast<double>(_workers[i].busyTime));
+                report.workerUtilization.push_back(report.duration > 0 ? _workers[i].busyTime / (report.duration * 1000.0) : 0);
+            }
+            report.workerBalance = JainIndex(busyTimes);
+            return report;
+        }
+
+        settings::ZoneSettings _settings;
+        std::vector<double> _workerSpeeds;
+        std::vector<Call> _calls;
+
+        /// <summary> Guards the worker states, which the synchronized scheduler reaches from its own thread. </summary>
+        std::mutex _lock;
+
+        Microseconds _now = 0;
+        std::vector<WorkerState> _workers;
+        CompletionQueue _completions;
+
+        /// <summary> The number of calls given to workers, which tells whether the scheduler settled. </summary>
+        size_t _scheduledCount = 0;
+
+        SchedulerImpl<SimulatedWorker>* _scheduler = nullptr;
+    };
+
+    inline void SimulatedTask::Reject(ResultCode, const std::string&) {
+        _simulation.OnRejected(_index);
+    }
+
+    inline SimulatedWorker::SimulatedWorker(WorkerId id,
+                                            const settings::ZoneSettings&,
+                                            std::function<void(WorkerId)>,
+                                            std::function<void(WorkerId)> idleCallback) :
+        _id(id), _idleCallback(idleCallback) {
+        CurrentSimulation()->RegisterWorker(id, std::move(idleCallback));
+    }
+
+    inline void SimulatedWorker::Schedule(std::shared_ptr<Task> task, SchedulePhase) {
+        CurrentSimulation()->OnScheduled(_id, std::static_pointer_cast<SimulatedTask>(task)->GetIndex());
+    }
+
+}   // End of namespace simulation.
+}   // End of namespace zone.
+}   // End of namespace napa.
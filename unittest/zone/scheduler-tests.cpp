@@ -6,7 +6,10 @@
 
 #include <cstddef>
 #include <atomic>
+#include <chrono>
 #include <future>
+#include <mutex>
+#include <thread>
 
 using namespace napa;
 using namespace napa::zone;
@@ -14,10 +17,12 @@ using namespace napa::settings;
 
 class TestTask : public Task {
 public:
-    TestTask(std::function<void()> callback = []() {}) : 
+    TestTask(std::function<void()> callback = []() {}, bool canReject = true) : 
         numberOfExecutions(0),
+        numberOfRejections(0),
         lastExecutedWorkerId(99),
-        _callback(std::move(callback)) {}
+        _callback(std::move(callback)),
+        _canReject(canReject) {}
 
     void SetCurrentWorkerId(WorkerId id) {
         lastExecutedWorkerId = id;
@@ -29,11 +34,23 @@ public:
         _callback();
     }
 
+    virtual void Reject(ResultCode /*code*/, const std::string& /*reason*/) override
+    {
+        numberOfRejections++;
+    }
+
+    virtual bool CanReject() const override
+    {
+        return _canReject;
+    }
+
     std::atomic<uint32_t> numberOfExecutions;
+    std::atomic<uint32_t> numberOfRejections;
     std::atomic<WorkerId> lastExecutedWorkerId;
 
 private:
     std::function<void()> _callback;
+    bool _canReject;
 };
 
 
@@ -51,10 +68,13 @@ public:
         setupCompleteCallback(id);
     }
 
+    TestWorker(TestWorker&&) = default;
+
     ~TestWorker() {
         for (auto& fut : _futures) {
             fut.get();
         }
+        std::this_thread::sleep_for(stopDelay);
     }
 
     void Start() {
@@ -65,23 +85,89 @@ public:
         auto testTask = std::dynamic_pointer_cast<TestTask>(task);
         testTask->SetCurrentWorkerId(_id);
 
-        _futures.emplace_back(std::async(std::launch::async, [this, task]() {
+        std::lock_guard<std::mutex> lock(*_futuresLock);
+        _futures.emplace_back(std::async(std::launch::async, [this, task, phase]() {
+            // Like a worker near its heap limit, a shedding worker rejects the calls it's given.
+            if (IsSheddingLoad() && phase != SchedulePhase::ImmediatePhase && task->CanReject()) {
+                task->Reject(NAPA_RESULT_HEAP_LIMIT_REACHED, "The worker is near its heap limit");
+                _idleNotificationCallback(_id);
+                return;
+            }
+            *_busySince = std::chrono::steady_clock::now().time_since_epoch().count();
             task->Execute();
+            *_busySince = 0;
+            (*_executions)++;
             _idleNotificationCallback(_id);
         }));
     }
 
+    bool Unschedule(const std::shared_ptr<Task>&) {
+        // Tasks start as soon as they are scheduled.
+        return false;
+    }
+
+    std::chrono::milliseconds GetBusyDuration() const {
+        auto busySince = _busySince->load();
+        if (busySince == 0) {
+            return std::chrono::milliseconds(0);
+        }
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(busySince)));
+    }
+
+    void TerminateExecution() {
+        terminations++;
+    }
+
+    bool NeedsRecycling() const {
+        return (tasksBeforeRecycling > 0 && *_executions >= tasksBeforeRecycling) || IsSheddingLoad();
+    }
+
+    bool IsSheddingLoad() const {
+        return tasksBeforeShedding > 0 && *_executions >= tasksBeforeShedding;
+    }
+
+    napa::WorkerStats GetStats() const {
+        napa::WorkerStats stats = {};
+        stats.worker_id = _id;
+        stats.executed_tasks = *_executions;
+        return stats;
+    }
+
     static uint32_t numberOfWorkers;
+    static uint32_t tasksBeforeRecycling;
+
+    /// <summary> Tasks a worker runs before its heap is near its limit. </summary>
+    static uint32_t tasksBeforeShedding;
+    static std::atomic<uint32_t> terminations;
+
+    /// <summary> Time a worker takes to stop, like joining its thread and disposing its isolate. </summary>
+    static std::chrono::milliseconds stopDelay;
 
 private:
     WorkerId _id;
     std::vector<std::shared_future<void>> _futures;
+    std::unique_ptr<std::mutex> _futuresLock = std::make_unique<std::mutex>();
+    std::unique_ptr<std::atomic<uint32_t>> _executions = std::make_unique<std::atomic<uint32_t>>(0);
+    std::unique_ptr<std::atomic<int64_t>> _busySince = std::make_unique<std::atomic<int64_t>>(0);
     std::function<void(WorkerId)> _idleNotificationCallback;
 };
 
 template <uint32_t I>
 uint32_t TestWorker<I>::numberOfWorkers = 0;
 
+template <uint32_t I>
+uint32_t TestWorker<I>::tasksBeforeRecycling = 0;
+
+template <uint32_t I>
+uint32_t TestWorker<I>::tasksBeforeShedding = 0;
+
+template <uint32_t I>
+std::atomic<uint32_t> TestWorker<I>::terminations(0);
+
+template <uint32_t I>
+std::chrono::milliseconds TestWorker<I>::stopDelay(0);
+
 
 TEST_CASE("scheduler creates correct number of worker", "[scheduler]") {
     ZoneSettings settings;
@@ -165,3 +251,1044 @@ TEST_CASE("scheduler distributes and schedules all tasks", "[scheduler]") {
         REQUIRE(flag);
     }
 }
+
+TEST_CASE("lock-free scheduler assigns tasks correctly", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 3;
+    settings.scheduler = SchedulerType::LockFree;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<4>>>(settings, [](WorkerId) {});
+    auto task = std::make_shared<TestTask>();
+
+    SECTION("schedules on exactly one worker") {
+        scheduler->Schedule(task);
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(task->numberOfExecutions == 1);
+    }
+
+    SECTION("schedule on a specific worker") {
+        scheduler->ScheduleOnWorker(2, task);
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(task->numberOfExecutions == 1);
+        REQUIRE(task->lastExecutedWorkerId == 2);
+    }
+
+    SECTION("schedule on all workers") {
+        scheduler->ScheduleOnAllWorkers(task);
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(task->numberOfExecutions == settings.workers);
+    }
+}
+
+TEST_CASE("lock-free scheduler schedules all tasks from concurrent callers", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 4;
+    settings.scheduler = SchedulerType::LockFree;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<5>>>(settings, [](WorkerId) {});
+
+    // More tasks than the pending queue capacity, so the overflow path is exercised as well.
+    const size_t numberOfCallers = 4;
+    const size_t tasksPerCaller = 2000;
+
+    std::vector<std::shared_ptr<TestTask>> tasks;
+    for (size_t i = 0; i < numberOfCallers * tasksPerCaller; i++) {
+        tasks.push_back(std::make_shared<TestTask>());
+    }
+
+    std::vector<std::thread> callers;
+    for (size_t c = 0; c < numberOfCallers; c++) {
+        callers.emplace_back([&scheduler, &tasks, c, tasksPerCaller]() {
+            for (size_t i = 0; i < tasksPerCaller; i++) {
+                scheduler->Schedule(tasks[c * tasksPerCaller + i]);
+            }
+        });
+    }
+
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    scheduler = nullptr; // force draining all scheduled tasks
+
+    std::vector<bool> scheduledWorkersFlags = { false, false, false, false };
+    for (auto& task : tasks) {
+        REQUIRE(task->numberOfExecutions == 1);
+        scheduledWorkersFlags[task->lastExecutedWorkerId] = true;
+    }
+
+    // Make sure that all workers were participating
+    for (auto flag: scheduledWorkersFlags) {
+        REQUIRE(flag);
+    }
+}
+TEST_CASE("work-stealing scheduler assigns tasks correctly", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 3;
+    settings.scheduler = SchedulerType::WorkStealing;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<6>>>(settings, [](WorkerId) {});
+    auto task = std::make_shared<TestTask>();
+
+    SECTION("schedules on exactly one worker") {
+        scheduler->Schedule(task);
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(task->numberOfExecutions == 1);
+    }
+
+    SECTION("schedule on a specific worker") {
+        scheduler->ScheduleOnWorker(2, task);
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(task->numberOfExecutions == 1);
+        REQUIRE(task->lastExecutedWorkerId == 2);
+    }
+
+    SECTION("schedule on all workers") {
+        scheduler->ScheduleOnAllWorkers(task);
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(task->numberOfExecutions == settings.workers);
+    }
+}
+
+TEST_CASE("work-stealing scheduler schedules all tasks from concurrent callers", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 4;
+    settings.scheduler = SchedulerType::WorkStealing;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<7>>>(settings, [](WorkerId) {});
+
+    // More tasks than the pending queue capacity, so the overflow path is exercised as well.
+    const size_t numberOfCallers = 4;
+    const size_t tasksPerCaller = 2000;
+
+    std::vector<std::shared_ptr<TestTask>> tasks;
+    for (size_t i = 0; i < numberOfCallers * tasksPerCaller; i++) {
+        tasks.push_back(std::make_shared<TestTask>());
+    }
+
+    std::vector<std::thread> callers;
+    for (size_t c = 0; c < numberOfCallers; c++) {
+        callers.emplace_back([&scheduler, &tasks, c, tasksPerCaller]() {
+            for (size_t i = 0; i < tasksPerCaller; i++) {
+                scheduler->Schedule(tasks[c * tasksPerCaller + i]);
+            }
+        });
+    }
+
+    for (auto& caller : callers) {
+        caller.join();
+    }
+
+    scheduler = nullptr; // force draining all scheduled tasks
+
+    std::vector<bool> scheduledWorkersFlags = { false, false, false, false };
+    for (auto& task : tasks) {
+        REQUIRE(task->numberOfExecutions == 1);
+        scheduledWorkersFlags[task->lastExecutedWorkerId] = true;
+    }
+
+    // Make sure that all workers were participating
+    for (auto flag: scheduledWorkersFlags) {
+        REQUIRE(flag);
+    }
+}
+
+TEST_CASE("non scheduled tasks are ordered by priority, deadline and arrival", "[scheduler]") {
+    std::priority_queue<NonScheduledTask> tasks;
+
+    tasks.push({ 0, 0, 0, nullptr });
+    tasks.push({ 0, 100, 1, nullptr });
+    tasks.push({ 1, 0, 2, nullptr });
+    tasks.push({ 0, 50, 3, nullptr });
+    tasks.push({ 0, 0, 4, nullptr });
+
+    std::vector<uint64_t> order;
+    while (!tasks.empty()) {
+        order.push_back(tasks.top().sequence);
+        tasks.pop();
+    }
+
+    REQUIRE(order == std::vector<uint64_t>({ 2, 3, 1, 0, 4 }));
+}
+
+TEST_CASE("scheduler dispatches high priority tasks first when workers are busy", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+
+    class PriorityTask : public TestTask {
+    public:
+        PriorityTask(uint32_t priority, std::function<void()> callback) : TestTask(std::move(callback)), _priority(priority) {}
+        uint32_t GetPriority() const override { return _priority; }
+    private:
+        uint32_t _priority;
+    };
+
+    std::promise<void> blockerStarted;
+    std::promise<void> releaseBlocker;
+    auto releaseFuture = releaseBlocker.get_future().share();
+
+    std::mutex orderLock;
+    std::vector<uint32_t> order;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<8>>>(settings, [](WorkerId) {});
+
+    // Keep the only worker busy so the following tasks are queued.
+    scheduler->Schedule(std::make_shared<TestTask>([&blockerStarted, releaseFuture]() {
+        blockerStarted.set_value();
+        releaseFuture.wait();
+    }));
+    blockerStarted.get_future().wait();
+
+    for (uint32_t priority : { 0u, 2u, 1u }) {
+        scheduler->Schedule(std::make_shared<PriorityTask>(priority, [priority, &order, &orderLock]() {
+            std::lock_guard<std::mutex> lock(orderLock);
+            order.push_back(priority);
+        }));
+    }
+
+    releaseBlocker.set_value();
+    scheduler = nullptr; // force draining all scheduled tasks
+
+    REQUIRE(order == std::vector<uint32_t>({ 2, 1, 0 }));
+}
+
+TEST_CASE("scheduler dispatches waiting tasks of tenants in turns", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+    settings.tenantWeights = { { "gold", 1, 2 } };
+
+    class TenantTask : public TestTask {
+    public:
+        TenantTask(uint64_t tenant, std::function<void()> callback) : TestTask(std::move(callback)), _tenant(tenant) {}
+        uint64_t GetTenant() const override { return _tenant; }
+    private:
+        uint64_t _tenant;
+    };
+
+    std::promise<void> blockerStarted;
+    std::promise<void> releaseBlocker;
+    auto releaseFuture = releaseBlocker.get_future().share();
+
+    std::mutex orderLock;
+    std::vector<uint64_t> order;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<22>>>(settings, [](WorkerId) {});
+
+    // Keep the only worker busy so the following tasks are queued.
+    scheduler->Schedule(std::make_shared<TestTask>([&blockerStarted, releaseFuture]() {
+        blockerStarted.set_value();
+        releaseFuture.wait();
+    }));
+    blockerStarted.get_future().wait();
+
+    // Tenant 2 floods the queue before tenant 1, which has twice its weight.
+    for (uint64_t tenant : { 2, 2, 2, 2, 1, 1, 1, 1 }) {
+        scheduler->Schedule(std::make_shared<TenantTask>(tenant, [tenant, &order, &orderLock]() {
+            std::lock_guard<std::mutex> lock(orderLock);
+            order.push_back(tenant);
+        }));
+    }
+
+    auto queued = scheduler->GetStats();
+    REQUIRE(queued.pendingTasks == 8);
+    REQUIRE(queued.tenants.size() == 2);
+    REQUIRE(queued.tenants[0].name == "gold");
+    REQUIRE(queued.tenants[0].queuedTasks == 4);
+    REQUIRE(queued.tenants[1].tenant == 2);
+    REQUIRE(queued.tenants[1].queuedTasks == 4);
+
+    releaseBlocker.set_value();
+    scheduler = nullptr; // force draining all scheduled tasks
+
+    REQUIRE(order == std::vector<uint64_t>({ 2, 1, 1, 2, 1, 1, 2, 2 }));
+}
+
+/// <summary> Waits until the predicate holds or the timeout expires. </summary>
+static bool WaitFor(std::function<bool()> predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(5000)) {
+    auto end = std::chrono::steady_clock::now() + timeout;
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > end) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+TEST_CASE("elastic scheduler starts workers when tasks queue up", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+    settings.minWorkers = 1;
+    settings.maxWorkers = 4;
+
+    std::promise<void> release;
+    auto releaseFuture = release.get_future().share();
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<9>>>(settings, [](WorkerId) {});
+    REQUIRE(scheduler->GetWorkerCount() == 1);
+
+    std::vector<std::shared_ptr<TestTask>> tasks;
+    for (int i = 0; i < 8; i++) {
+        tasks.emplace_back(std::make_shared<TestTask>([releaseFuture]() { releaseFuture.wait(); }));
+        scheduler->Schedule(tasks.back());
+    }
+
+    auto scaled = WaitFor([&scheduler]() { return scheduler->GetWorkerCount() == 4; });
+    REQUIRE(scaled);
+
+    release.set_value();
+    scheduler = nullptr; // force draining all scheduled tasks
+
+    REQUIRE(TestWorker<9>::numberOfWorkers == 4);
+    for (auto& task : tasks) {
+        REQUIRE(task->numberOfExecutions == 1);
+    }
+}
+
+TEST_CASE("elastic scheduler replays broadcasts on new workers", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+    settings.maxWorkers = 3;
+
+    std::atomic<uint32_t> broadcasts(0);
+    std::atomic<uint32_t> replays(0);
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<10>>>(settings, [](WorkerId) {});
+    scheduler->ScheduleOnAllWorkers([&broadcasts, &replays](uint32_t workerCount) {
+        if (workerCount == 0) {
+            return std::make_shared<TestTask>([&replays]() { replays++; });
+        }
+        return std::make_shared<TestTask>([&broadcasts]() { broadcasts++; });
+    });
+
+    std::promise<void> release;
+    auto releaseFuture = release.get_future().share();
+    for (int i = 0; i < 6; i++) {
+        scheduler->Schedule(std::make_shared<TestTask>([releaseFuture]() { releaseFuture.wait(); }));
+    }
+
+    auto scaled = WaitFor([&scheduler]() { return scheduler->GetWorkerCount() == 3; });
+    REQUIRE(scaled);
+
+    release.set_value();
+    scheduler = nullptr; // force draining all scheduled tasks
+
+    REQUIRE(broadcasts == 1);
+    REQUIRE(replays == 2);
+}
+
+TEST_CASE("scheduler broadcasts to the given workers only", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 3;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<21>>>(settings, [](WorkerId) {});
+
+    std::mutex lock;
+    std::vector<std::shared_ptr<TestTask>> tasks;
+    std::vector<uint32_t> workerCounts;
+    auto createTask = [&lock, &tasks, &workerCounts](uint32_t workerCount) {
+        std::lock_guard<std::mutex> guard(lock);
+        workerCounts.push_back(workerCount);
+        tasks.emplace_back(std::make_shared<TestTask>());
+        return tasks.back();
+    };
+
+    SECTION("duplicate and unknown ids are skipped") {
+        scheduler->ScheduleOnWorkers({ 2, 0, 2, 9 }, createTask);
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(workerCounts == std::vector<uint32_t>({ 2, 2 }));
+        REQUIRE(tasks.size() == 2);
+        REQUIRE(tasks[0]->numberOfExecutions == 1);
+        REQUIRE(tasks[1]->numberOfExecutions == 1);
+        REQUIRE(tasks[0]->lastExecutedWorkerId + tasks[1]->lastExecutedWorkerId == 2);
+        REQUIRE(tasks[0]->lastExecutedWorkerId != tasks[1]->lastExecutedWorkerId);
+    }
+
+    SECTION("a broadcast to no running worker is done right away") {
+        scheduler->ScheduleOnWorkers({ 9 }, createTask);
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(workerCounts == std::vector<uint32_t>({ 0 }));
+        REQUIRE(tasks[0]->numberOfExecutions == 0);
+    }
+}
+
+TEST_CASE("scheduler recycles workers that reached their task limit", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 2;
+    settings.maxTasksPerWorker = 3;
+    TestWorker<17>::tasksBeforeRecycling = 3;
+
+    std::atomic<uint32_t> replays(0);
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<17>>>(settings, [](WorkerId) {});
+    scheduler->ScheduleOnAllWorkers([&replays](uint32_t workerCount) {
+        if (workerCount == 0) {
+            return std::make_shared<TestTask>([&replays]() { replays++; });
+        }
+        return std::make_shared<TestTask>();
+    });
+
+    std::vector<std::shared_ptr<TestTask>> tasks;
+    for (int i = 0; i < 12; i++) {
+        tasks.emplace_back(std::make_shared<TestTask>());
+        scheduler->Schedule(tasks.back());
+
+        auto executed = WaitFor([&tasks]() { return tasks.back()->numberOfExecutions == 1; });
+        REQUIRE(executed);
+    }
+
+    auto recycled = WaitFor([]() { return TestWorker<17>::numberOfWorkers > 2; });
+    REQUIRE(recycled);
+    REQUIRE(scheduler->GetWorkerCount() == 2);
+
+    scheduler = nullptr; // force draining all scheduled tasks
+
+    // Replacements replay the broadcast before they take over.
+    REQUIRE(replays == TestWorker<17>::numberOfWorkers - 2);
+    for (auto& task : tasks) {
+        REQUIRE(task->numberOfExecutions == 1);
+    }
+}
+
+TEST_CASE("scheduler gives no tasks to workers shedding their load until they are replaced", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+    settings.recycleOnHeapLimit = true;
+    TestWorker<26>::tasksBeforeShedding = 1;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<26>>>(settings, [](WorkerId) {});
+
+    // Pinned work keeps the worker from being replaced after its heap got near its limit.
+    scheduler->RetainWorker(0);
+    auto first = std::make_shared<TestTask>();
+    scheduler->Schedule(first);
+    auto executed = WaitFor([&first]() { return first->numberOfExecutions == 1; });
+    REQUIRE(executed);
+
+    auto second = std::make_shared<TestTask>();
+    scheduler->Schedule(second);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    REQUIRE(second->numberOfExecutions == 0);
+    REQUIRE(second->numberOfRejections == 0);
+
+    // Completing the pinned work lets the replacement take over, which runs the waiting task.
+    auto release = std::make_shared<TestTask>([&scheduler]() { scheduler->ReleaseWorker(0); });
+    scheduler->ScheduleOnRetainedWorker(0, release, SchedulePhase::ImmediatePhase);
+    executed = WaitFor([&second]() { return second->numberOfExecutions == 1; });
+    REQUIRE(executed);
+    REQUIRE(second->numberOfRejections == 0);
+    REQUIRE(TestWorker<26>::numberOfWorkers > 1);
+
+    scheduler = nullptr; // force draining all scheduled tasks
+}
+
+TEST_CASE("workers shedding their load still run async completions", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+    settings.recycleOnHeapLimit = true;
+    TestWorker<28>::tasksBeforeShedding = 1;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<28>>>(settings, [](WorkerId) {});
+
+    // The worker issued async work and then got near its heap limit.
+    scheduler->RetainWorker(0);
+    auto first = std::make_shared<TestTask>();
+    scheduler->Schedule(first);
+    auto executed = WaitFor([&first]() { return first->numberOfExecutions == 1; });
+    REQUIRE(executed);
+
+    // Like AsyncCompleteTask, the completion is queued in the default phase and can't be rejected.
+    auto completion = std::make_shared<TestTask>([&scheduler]() { scheduler->ReleaseWorker(0); }, false);
+    scheduler->ScheduleOnRetainedWorker(0, completion);
+    executed = WaitFor([&completion]() { return completion->numberOfExecutions == 1; });
+    REQUIRE(executed);
+    REQUIRE(completion->numberOfRejections == 0);
+
+    // The released worker is replaced, which runs new calls.
+    auto next = std::make_shared<TestTask>();
+    scheduler->Schedule(next);
+    executed = WaitFor([&next]() { return next->numberOfExecutions == 1; });
+    REQUIRE(executed);
+    REQUIRE(TestWorker<28>::numberOfWorkers > 1);
+
+    scheduler = nullptr; // force draining all scheduled tasks
+}
+
+TEST_CASE("elastic scheduler doesn't replay tasks scheduled on running workers", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+    settings.maxWorkers = 3;
+
+    std::atomic<uint32_t> executions(0);
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<16>>>(settings, [](WorkerId) {});
+    scheduler->ScheduleOnRunningWorkers([&executions](uint32_t) {
+        return std::make_shared<TestTask>([&executions]() { executions++; });
+    });
+
+    std::promise<void> release;
+    auto releaseFuture = release.get_future().share();
+    for (int i = 0; i < 6; i++) {
+        scheduler->Schedule(std::make_shared<TestTask>([releaseFuture]() { releaseFuture.wait(); }));
+    }
+
+    auto scaled = WaitFor([&scheduler]() { return scheduler->GetWorkerCount() == 3; });
+    REQUIRE(scaled);
+
+    release.set_value();
+    scheduler = nullptr; // force draining all scheduled tasks
+
+    REQUIRE(executions == 1);
+}
+
+TEST_CASE("elastic scheduler retires idle workers", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 3;
+    settings.minWorkers = 1;
+    settings.maxWorkers = 3;
+    settings.workerIdleTimeout = 20;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<11>>>(settings, [](WorkerId) {});
+    REQUIRE(scheduler->GetWorkerCount() == 3);
+
+    SECTION("down to the minimum number of workers") {
+        auto scaled = WaitFor([&scheduler]() { return scheduler->GetWorkerCount() == 1; });
+        REQUIRE(scaled);
+
+        // Retired workers don't run broadcasts.
+        auto task = std::make_shared<TestTask>();
+        scheduler->ScheduleOnAllWorkers(task);
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(task->numberOfExecutions == 1);
+    }
+
+    SECTION("except workers that are retained") {
+        for (WorkerId id = 0; id < 3; id++) {
+            scheduler->RetainWorker(id);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        REQUIRE(scheduler->GetWorkerCount() == 3);
+
+        scheduler->ReleaseWorker(2);
+        auto scaled = WaitFor([&scheduler]() { return scheduler->GetWorkerCount() == 2; });
+        REQUIRE(scaled);
+
+        // The pinned task of a retained worker still runs there.
+        auto task = std::make_shared<TestTask>();
+        scheduler->ScheduleOnWorker(1, task);
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(task->numberOfExecutions == 1);
+        REQUIRE(task->lastExecutedWorkerId == 1);
+    }
+}
+
+/// <summary> Keeps the only worker of a scheduler busy until released. </summary>
+template <typename SchedulerType>
+static std::shared_ptr<std::promise<void>> BlockWorker(SchedulerType& scheduler) {
+    auto started = std::make_shared<std::promise<void>>();
+    auto release = std::make_shared<std::promise<void>>();
+    auto releaseFuture = release->get_future().share();
+
+    scheduler.Schedule(std::make_shared<TestTask>([started, releaseFuture]() {
+        started->set_value();
+        releaseFuture.wait();
+    }));
+    started->get_future().wait();
+    return release;
+}
+
+TEST_CASE("scheduler applies the overload policy when the queue is full", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+    settings.maxQueueLength = 2;
+
+    std::vector<std::shared_ptr<TestTask>> tasks;
+    for (int i = 0; i < 4; i++) {
+        tasks.emplace_back(std::make_shared<TestTask>());
+    }
+
+    SECTION("rejects new tasks") {
+        settings.overloadPolicy = OverloadPolicy::Reject;
+
+        auto scheduler = std::make_unique<SchedulerImpl<TestWorker<12>>>(settings, [](WorkerId) {});
+        auto release = BlockWorker(*scheduler);
+        for (auto& task : tasks) {
+            scheduler->Schedule(task);
+        }
+
+        auto rejected = WaitFor([&tasks]() { return tasks[3]->numberOfRejections == 1; });
+        REQUIRE(rejected);
+        REQUIRE(scheduler->GetQueueLength() == 2);
+
+        release->set_value();
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(tasks[0]->numberOfExecutions == 1);
+        REQUIRE(tasks[1]->numberOfExecutions == 1);
+        REQUIRE(tasks[2]->numberOfRejections == 1);
+        REQUIRE(tasks[3]->numberOfExecutions == 0);
+    }
+
+    SECTION("drops the oldest tasks") {
+        settings.overloadPolicy = OverloadPolicy::DropOldest;
+
+        auto scheduler = std::make_unique<SchedulerImpl<TestWorker<12>>>(settings, [](WorkerId) {});
+        auto release = BlockWorker(*scheduler);
+        for (auto& task : tasks) {
+            scheduler->Schedule(task);
+        }
+
+        auto dropped = WaitFor([&tasks]() { return tasks[1]->numberOfRejections == 1; });
+        REQUIRE(dropped);
+        REQUIRE(scheduler->GetQueueLength() == 2);
+
+        release->set_value();
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(tasks[0]->numberOfRejections == 1);
+        REQUIRE(tasks[1]->numberOfExecutions == 0);
+        REQUIRE(tasks[2]->numberOfExecutions == 1);
+        REQUIRE(tasks[3]->numberOfExecutions == 1);
+    }
+
+    SECTION("blocks the caller until there is room") {
+        settings.overloadPolicy = OverloadPolicy::Block;
+
+        auto scheduler = std::make_unique<SchedulerImpl<TestWorker<12>>>(settings, [](WorkerId) {});
+        auto release = BlockWorker(*scheduler);
+
+        std::atomic<size_t> scheduled(0);
+        std::thread caller([&scheduler, &tasks, &scheduled]() {
+            for (auto& task : tasks) {
+                scheduler->Schedule(task);
+                scheduled++;
+            }
+        });
+
+        auto queued = WaitFor([&scheduler]() { return scheduler->GetQueueLength() == 2; });
+        REQUIRE(queued);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(scheduled == 2);
+
+        release->set_value();
+        caller.join();
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        for (auto& task : tasks) {
+            REQUIRE(task->numberOfExecutions == 1);
+            REQUIRE(task->numberOfRejections == 0);
+        }
+    }
+}
+
+TEST_CASE("lock-free scheduler applies the overload policy when the queue is full", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+    settings.maxQueueLength = 2;
+    settings.scheduler = SchedulerType::LockFree;
+
+    std::vector<std::shared_ptr<TestTask>> tasks;
+    for (int i = 0; i < 4; i++) {
+        tasks.emplace_back(std::make_shared<TestTask>());
+    }
+
+    SECTION("rejects new tasks") {
+        settings.overloadPolicy = OverloadPolicy::Reject;
+
+        auto scheduler = std::make_unique<SchedulerImpl<TestWorker<13>>>(settings, [](WorkerId) {});
+        auto release = BlockWorker(*scheduler);
+        for (auto& task : tasks) {
+            scheduler->Schedule(task);
+        }
+        REQUIRE(scheduler->GetQueueLength() == 2);
+
+        release->set_value();
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(tasks[0]->numberOfExecutions == 1);
+        REQUIRE(tasks[1]->numberOfExecutions == 1);
+        REQUIRE(tasks[2]->numberOfRejections == 1);
+        REQUIRE(tasks[3]->numberOfRejections == 1);
+    }
+
+    SECTION("drops the oldest tasks") {
+        settings.overloadPolicy = OverloadPolicy::DropOldest;
+
+        auto scheduler = std::make_unique<SchedulerImpl<TestWorker<13>>>(settings, [](WorkerId) {});
+        auto release = BlockWorker(*scheduler);
+        for (auto& task : tasks) {
+            scheduler->Schedule(task);
+        }
+        REQUIRE(scheduler->GetQueueLength() == 2);
+
+        release->set_value();
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(tasks[0]->numberOfRejections == 1);
+        REQUIRE(tasks[1]->numberOfRejections == 1);
+        REQUIRE(tasks[2]->numberOfExecutions == 1);
+        REQUIRE(tasks[3]->numberOfExecutions == 1);
+    }
+}
+
+TEST_CASE("routing keys map consistently to workers", "[scheduler]") {
+    for (uint64_t key = 1; key < 1000; key++) {
+        auto worker = GetRoutedWorker(key, 4);
+        REQUIRE(worker < 4);
+        REQUIRE(GetRoutedWorker(key, 4) == worker);
+
+        // Growing the number of workers only moves keys to the new worker.
+        auto grown = GetRoutedWorker(key, 5);
+        REQUIRE((grown == worker || grown == 4));
+    }
+}
+
+TEST_CASE("scheduler routes tasks to their preferred worker", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 4;
+    settings.routingImbalance = 2;
+
+    class RoutedTask : public TestTask {
+    public:
+        RoutedTask(uint64_t routingKey, std::function<void()> callback = []() {}) :
+            TestTask(std::move(callback)), _routingKey(routingKey) {}
+        uint64_t GetRoutingKey() const override { return _routingKey; }
+    private:
+        uint64_t _routingKey;
+    };
+
+    const uint64_t routingKey = 42;
+    auto preferred = GetRoutedWorker(routingKey, settings.workers);
+
+    SECTION("while the preferred worker is idle") {
+        auto scheduler = std::make_unique<SchedulerImpl<TestWorker<14>>>(settings, [](WorkerId) {});
+
+        std::vector<std::shared_ptr<RoutedTask>> tasks;
+        for (int i = 0; i < 8; i++) {
+            tasks.emplace_back(std::make_shared<RoutedTask>(routingKey));
+            scheduler->Schedule(tasks.back());
+
+            auto executed = WaitFor([&tasks]() { return tasks.back()->numberOfExecutions == 1; });
+            REQUIRE(executed);
+        }
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        for (auto& task : tasks) {
+            REQUIRE(task->numberOfExecutions == 1);
+            REQUIRE(task->lastExecutedWorkerId == preferred);
+        }
+    }
+
+    SECTION("until too many tasks wait for the preferred worker") {
+        auto scheduler = std::make_unique<SchedulerImpl<TestWorker<14>>>(settings, [](WorkerId) {});
+
+        std::promise<void> started;
+        std::promise<void> release;
+        auto releaseFuture = release.get_future().share();
+        scheduler->Schedule(std::make_shared<RoutedTask>(routingKey, [&started, releaseFuture]() {
+            started.set_value();
+            releaseFuture.wait();
+        }));
+        started.get_future().wait();
+
+        std::vector<std::shared_ptr<RoutedTask>> tasks;
+        for (int i = 0; i < 3; i++) {
+            tasks.emplace_back(std::make_shared<RoutedTask>(routingKey));
+            scheduler->Schedule(tasks.back());
+        }
+
+        // The third task finds two tasks waiting for the busy preferred worker and runs elsewhere.
+        auto executed = WaitFor([&tasks]() { return tasks[2]->numberOfExecutions == 1; });
+        REQUIRE(executed);
+        REQUIRE(tasks[2]->lastExecutedWorkerId != preferred);
+        REQUIRE(tasks[0]->numberOfExecutions == 0);
+        REQUIRE(scheduler->GetQueueLength() == 2);
+
+        release.set_value();
+        scheduler = nullptr; // force draining all scheduled tasks
+
+        REQUIRE(tasks[0]->lastExecutedWorkerId == preferred);
+        REQUIRE(tasks[1]->lastExecutedWorkerId == preferred);
+    }
+}
+
+TEST_CASE("scheduler moves the routed tasks of a stuck worker to other workers", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 4;
+    settings.routingImbalance = 2;
+    settings.stuckWorkerThreshold = 50;
+
+    class RoutedTask : public TestTask {
+    public:
+        RoutedTask(uint64_t routingKey, std::function<void()> callback = []() {}) :
+            TestTask(std::move(callback)), _routingKey(routingKey) {}
+        uint64_t GetRoutingKey() const override { return _routingKey; }
+    private:
+        uint64_t _routingKey;
+    };
+
+    const uint64_t routingKey = 42;
+    auto preferred = GetRoutedWorker(routingKey, settings.workers);
+
+    SECTION("while the stuck worker runs") {
+        auto scheduler = std::make_unique<SchedulerImpl<TestWorker<23>>>(settings, [](WorkerId) {});
+
+        std::promise<void> started;
+        std::promise<void> release;
+        auto releaseFuture = release.get_future().share();
+        scheduler->Schedule(std::make_shared<RoutedTask>(routingKey, [&started, releaseFuture]() {
+            started.set_value();
+            releaseFuture.wait();
+        }));
+        started.get_future().wait();
+
+        std::vector<std::shared_ptr<RoutedTask>> tasks;
+        for (int i = 0; i < 2; i++) {
+            tasks.emplace_back(std::make_shared<RoutedTask>(routingKey));
+            scheduler->Schedule(tasks.back());
+        }
+
+        // The routed tasks wait for the busy worker until it's found stuck, new ones skip it meanwhile.
+        auto rerouted = WaitFor([&tasks]() { return tasks[0]->numberOfExecutions == 1 && tasks[1]->numberOfExecutions == 1; });
+        REQUIRE(rerouted);
+        REQUIRE(tasks[0]->lastExecutedWorkerId != preferred);
+        REQUIRE(tasks[1]->lastExecutedWorkerId != preferred);
+        REQUIRE(scheduler->GetQueueLength() == 0);
+        REQUIRE(TestWorker<23>::terminations == 0);
+
+        auto skipping = std::make_shared<RoutedTask>(routingKey);
+        scheduler->Schedule(skipping);
+        auto executed = WaitFor([&skipping]() { return skipping->numberOfExecutions == 1; });
+        REQUIRE(executed);
+        REQUIRE(skipping->lastExecutedWorkerId != preferred);
+
+        release.set_value();
+        scheduler = nullptr; // force draining all scheduled tasks
+    }
+
+    SECTION("recycling the stuck worker") {
+        settings.recycleStuckWorkers = true;
+        auto scheduler = std::make_unique<SchedulerImpl<TestWorker<24>>>(settings, [](WorkerId) {});
+
+        std::promise<void> started;
+        scheduler->Schedule(std::make_shared<RoutedTask>(routingKey, [&started]() {
+            started.set_value();
+            WaitFor([]() { return TestWorker<24>::terminations > 0; });
+        }));
+        started.get_future().wait();
+
+        // The stuck worker is terminated, and its replacement takes over once it's idle.
+        auto recycled = WaitFor([]() { return TestWorker<24>::numberOfWorkers == 5; });
+        REQUIRE(recycled);
+        REQUIRE(TestWorker<24>::terminations == 1);
+        REQUIRE(scheduler->GetWorkerCount() == 4);
+
+        scheduler = nullptr; // force draining all scheduled tasks
+    }
+}
+
+TEST_CASE("scheduler enqueues directly when a worker schedules on itself", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 1;
+
+    // Test workers run their setup on the constructing thread, which makes this thread worker 0.
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<15>>>(settings, [](WorkerId) {});
+
+    auto task = std::make_shared<TestTask>();
+    scheduler->ScheduleOnWorker(0, task, SchedulePhase::ImmediatePhase);
+
+    // The task reached the worker before ScheduleOnWorker returned, without a round trip to the synchronizer.
+    REQUIRE(task->lastExecutedWorkerId == 0);
+
+    scheduler = nullptr; // force draining all scheduled tasks
+    REQUIRE(task->numberOfExecutions == 1);
+}
+
+TEST_CASE("scheduler enqueues directly on a retained worker from another thread", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 2;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<20>>>(settings, [](WorkerId) {});
+    scheduler->RetainWorker(1);
+
+    auto task = std::make_shared<TestTask>();
+    std::thread([&scheduler, &task]() {
+        scheduler->ScheduleOnRetainedWorker(1, task);
+    }).join();
+
+    // The task reached the worker before ScheduleOnRetainedWorker returned, without a round trip to the synchronizer.
+    REQUIRE(task->lastExecutedWorkerId == 1);
+
+    scheduler->ReleaseWorker(1);
+    scheduler = nullptr; // force draining all scheduled tasks
+    REQUIRE(task->numberOfExecutions == 1);
+}
+
+TEST_CASE("scheduler dispatches to the idle worker with the fewest calls in flight", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 3;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<18>>>(settings, [](WorkerId) {});
+
+    // Workers 0 and 1 have calls whose results are still pending.
+    scheduler->OnCallDispatched(0);
+    scheduler->OnCallDispatched(0);
+    scheduler->OnCallDispatched(1);
+    REQUIRE(scheduler->GetInFlightCount(0) == 2);
+
+    auto task = std::make_shared<TestTask>();
+    scheduler->Schedule(task);
+
+    auto executed = WaitFor([&task]() { return task->numberOfExecutions == 1; });
+    REQUIRE(executed);
+    REQUIRE(task->lastExecutedWorkerId == 2);
+
+    scheduler->OnCallFinished(0);
+    scheduler->OnCallFinished(0);
+    scheduler->OnCallFinished(1);
+    REQUIRE(scheduler->GetInFlightCount(0) == 0);
+}
+
+TEST_CASE("scheduler holds tasks back from workers with too many calls in flight", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 2;
+    settings.maxInFlightPerWorker = 1;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<18>>>(settings, [](WorkerId) {});
+    scheduler->OnCallDispatched(0);
+
+    // Worker 0 is idle but saturated, the task runs on worker 1 and keeps it busy.
+    std::promise<void> started;
+    std::promise<void> release;
+    auto releaseFuture = release.get_future().share();
+    auto blocking = std::make_shared<TestTask>([&started, releaseFuture]() {
+        started.set_value();
+        releaseFuture.wait();
+    });
+    scheduler->Schedule(blocking);
+    started.get_future().wait();
+    REQUIRE(blocking->lastExecutedWorkerId == 1);
+
+    auto task = std::make_shared<TestTask>();
+    scheduler->Schedule(task);
+
+    auto queued = WaitFor([&scheduler]() { return scheduler->GetQueueLength() == 1; });
+    REQUIRE(queued);
+    REQUIRE(task->numberOfExecutions == 0);
+
+    // Once the call in flight finished, the idle worker takes the waiting task.
+    scheduler->OnCallFinished(0);
+
+    auto executed = WaitFor([&task]() { return task->numberOfExecutions == 1; });
+    REQUIRE(executed);
+    REQUIRE(task->lastExecutedWorkerId == 0);
+
+    release.set_value();
+    scheduler = nullptr; // force draining all scheduled tasks
+}
+
+TEST_CASE("scheduler reports the waiting tasks and the counters of its workers", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 2;
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<19>>>(settings, [](WorkerId) {});
+
+    // Both workers are kept busy, so the next task waits.
+    std::atomic<uint32_t> started(0);
+    std::promise<void> release;
+    auto releaseFuture = release.get_future().share();
+    std::vector<std::shared_ptr<TestTask>> blockingTasks;
+    for (int i = 0; i < 2; i++) {
+        blockingTasks.emplace_back(std::make_shared<TestTask>([&started, releaseFuture]() {
+            started++;
+            releaseFuture.wait();
+        }));
+        scheduler->Schedule(blockingTasks.back());
+    }
+    auto busy = WaitFor([&started]() { return started == 2; });
+    REQUIRE(busy);
+
+    auto task = std::make_shared<TestTask>();
+    scheduler->Schedule(task);
+
+    auto stats = scheduler->GetStats();
+    REQUIRE(stats.pendingTasks == 1);
+    REQUIRE(stats.workers.size() == 2);
+    REQUIRE(stats.workers[0].worker_id == 0);
+    REQUIRE(stats.workers[1].worker_id == 1);
+
+    release.set_value();
+
+    auto executed = WaitFor([&scheduler]() {
+        auto stats = scheduler->GetStats();
+        return stats.pendingTasks == 0 && stats.workers[0].executed_tasks + stats.workers[1].executed_tasks == 3;
+    });
+    REQUIRE(executed);
+
+    scheduler = nullptr; // force draining all scheduled tasks
+}
+
+TEST_CASE("scheduler stops its workers in parallel", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 8;
+    TestWorker<25>::stopDelay = std::chrono::milliseconds(100);
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<25>>>(settings, [](WorkerId) {});
+    std::vector<std::shared_ptr<TestTask>> tasks;
+    for (int i = 0; i < 32; i++) {
+        tasks.emplace_back(std::make_shared<TestTask>());
+        scheduler->Schedule(tasks.back());
+    }
+
+    // Stopping the workers one after another takes 800ms.
+    auto start = std::chrono::steady_clock::now();
+    scheduler = nullptr;
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(elapsed < std::chrono::milliseconds(400));
+    for (auto& task : tasks) {
+        REQUIRE(task->numberOfExecutions == 1);
+    }
+    TestWorker<25>::stopDelay = std::chrono::milliseconds(0);
+}
+
+TEST_CASE("scheduler shuts down once before it is destroyed", "[scheduler]") {
+    ZoneSettings settings;
+    settings.workers = 2;
+    TestWorker<27>::stopDelay = std::chrono::milliseconds(100);
+
+    auto scheduler = std::make_unique<SchedulerImpl<TestWorker<27>>>(settings, [](WorkerId) {});
+    std::vector<std::shared_ptr<TestTask>> tasks;
+    for (int i = 0; i < 4; i++) {
+        tasks.emplace_back(std::make_shared<TestTask>());
+        scheduler->Schedule(tasks.back());
+    }
+
+    // Shutting down runs the scheduled tasks and stops the workers.
+    auto start = std::chrono::steady_clock::now();
+    scheduler->Shutdown();
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(100));
+    for (auto& task : tasks) {
+        REQUIRE(task->numberOfExecutions == 1);
+    }
+
+    // The workers are stopped already, shutting down again and destroying the scheduler don't wait for them.
+    start = std::chrono::steady_clock::now();
+    scheduler->Shutdown();
+    scheduler = nullptr;
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(50));
+    for (auto& task : tasks) {
+        REQUIRE(task->numberOfExecutions == 1);
+    }
+    TestWorker<27>::stopDelay = std::chrono::milliseconds(0);
+}
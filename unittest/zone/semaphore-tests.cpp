@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/semaphore.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace napa::zone;
+using namespace std::chrono_literals;
+
+TEST_CASE("semaphore hands out its permits", "[semaphore]") {
+    Semaphore semaphore(2);
+
+    REQUIRE(semaphore.TryAcquire());
+    REQUIRE(semaphore.TryAcquireFor(10ms));
+    REQUIRE(semaphore.GetCount() == 0);
+    REQUIRE(!semaphore.TryAcquire());
+    REQUIRE(!semaphore.TryAcquireFor(10ms));
+
+    semaphore.Release(2);
+    REQUIRE(semaphore.GetCount() == 2);
+}
+
+TEST_CASE("semaphore hands released permits to queued continuations in order", "[semaphore]") {
+    Semaphore semaphore(1);
+
+    std::vector<int> order;
+    semaphore.AcquireAsync([&order]() { order.push_back(1); });
+    semaphore.AcquireAsync([&order]() { order.push_back(2); });
+    semaphore.AcquireAsync([&order]() { order.push_back(3); });
+    REQUIRE(order == std::vector<int>({ 1 }));
+
+    semaphore.Release(2);
+    REQUIRE(order == std::vector<int>({ 1, 2, 3 }));
+    REQUIRE(semaphore.GetCount() == 0);
+
+    semaphore.Release();
+    REQUIRE(semaphore.GetCount() == 1);
+}
+
+TEST_CASE("semaphore wakes up a blocked thread when a permit is released", "[semaphore]") {
+    Semaphore semaphore(0);
+
+    std::atomic<bool> acquired(false);
+    auto waiter = std::async(std::launch::async, [&]() {
+        semaphore.Acquire();
+        acquired = true;
+    });
+
+    std::this_thread::sleep_for(20ms);
+    REQUIRE(!acquired);
+
+    semaphore.Release();
+    waiter.wait();
+    REQUIRE(acquired);
+    REQUIRE(semaphore.GetCount() == 0);
+}
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/simple-thread-pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+using namespace napa::zone;
+
+namespace {
+    /// <summary> Blocks pool threads until it is opened. </summary>
+    class Gate {
+    public:
+        void Wait() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _entered++;
+            _changed.notify_all();
+            _changed.wait(lock, [this]() { return _open; });
+        }
+
+        void WaitForEntered(uint32_t count) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _changed.wait(lock, [this, count]() { return _entered >= count; });
+        }
+
+        void Open() {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _open = true;
+            _changed.notify_all();
+        }
+
+    private:
+        std::mutex _mutex;
+        std::condition_variable _changed;
+        uint32_t _entered = 0;
+        bool _open = false;
+    };
+}
+
+TEST_CASE("simple thread pool starts threads on demand", "[simple-thread-pool]") {
+    SimpleThreadPool pool(4);
+    REQUIRE(pool.GetWorkerCount() == 0);
+
+    std::atomic<uint32_t> done(0);
+    pool.Execute([&done]() { done++; });
+
+    while (done == 0) {
+        std::this_thread::yield();
+    }
+
+    // Give the thread the time to become idle, the next task must reuse it.
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    pool.Execute([&done]() { done++; });
+
+    while (done < 2) {
+        std::this_thread::yield();
+    }
+    REQUIRE(pool.GetWorkerCount() == 1);
+}
+
+TEST_CASE("simple thread pool bounds the concurrency", "[simple-thread-pool]") {
+    auto gate = std::make_shared<Gate>();
+    std::atomic<uint32_t> running(0);
+    std::atomic<uint32_t> maxRunning(0);
+    std::atomic<uint32_t> done(0);
+
+    {
+        SimpleThreadPool pool(2);
+        for (int i = 0; i < 10; i++) {
+            pool.Execute([gate, &running, &maxRunning, &done]() {
+                auto current = ++running;
+                auto max = maxRunning.load();
+                while (current > max && !maxRunning.compare_exchange_weak(max, current)) {}
+
+                gate->Wait();
+                running--;
+                done++;
+            });
+        }
+
+        gate->WaitForEntered(2);
+        REQUIRE(pool.GetWorkerCount() == 2);
+        REQUIRE(pool.GetActiveWorkerCount() == 2);
+        REQUIRE(pool.GetQueueLength() == 8);
+
+        gate->Open();
+    }
+
+    // The destructor drains the queue before stopping the threads.
+    REQUIRE(done == 10);
+    REQUIRE(maxRunning == 2);
+}
@@ -0,0 +1,71 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/slow-task-detector.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+using namespace napa::zone;
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+TEST_CASE("slow task detector reports a call that runs past the threshold", "[slow-task-detector]") {
+    std::promise<milliseconds> promise;
+    auto future = promise.get_future();
+    std::atomic<uint64_t> reportedSequence(0);
+
+    SlowTaskDetector detector(2, 50ms, [&](uint32_t slot, uint64_t sequence, v8::Isolate*, milliseconds elapsed) {
+        REQUIRE(slot == 1);
+        reportedSequence = sequence;
+        promise.set_value(elapsed);
+    });
+
+    detector.Begin(1, nullptr);
+
+    REQUIRE(future.wait_for(1s) == std::future_status::ready);
+    REQUIRE(future.get() >= 50ms);
+    REQUIRE(detector.IsRunning(1, reportedSequence));
+
+    detector.End(1);
+    REQUIRE(!detector.IsRunning(1, reportedSequence));
+}
+
+TEST_CASE("slow task detector reports each slow call once", "[slow-task-detector]") {
+    std::atomic<int> reports(0);
+
+    SlowTaskDetector detector(1, 10ms, [&reports](uint32_t, uint64_t, v8::Isolate*, milliseconds) {
+        reports++;
+    });
+
+    detector.Begin(0, nullptr);
+    std::this_thread::sleep_for(100ms);
+    detector.End(0);
+    REQUIRE(reports == 1);
+
+    SECTION("the next slow call on the worker is reported again") {
+        detector.Begin(0, nullptr);
+        std::this_thread::sleep_for(100ms);
+        detector.End(0);
+        REQUIRE(reports == 2);
+    }
+}
+
+TEST_CASE("slow task detector doesn't report fast calls", "[slow-task-detector]") {
+    std::atomic<int> reports(0);
+
+    SlowTaskDetector detector(1, 100ms, [&reports](uint32_t, uint64_t, v8::Isolate*, milliseconds) {
+        reports++;
+    });
+
+    for (int i = 0; i < 100; i++) {
+        detector.Begin(0, nullptr);
+        detector.End(0);
+    }
+    std::this_thread::sleep_for(150ms);
+
+    REQUIRE(reports == 0);
+}
@@ -0,0 +1,175 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/span-recorder.h"
+
+#include <rapidjson/document.h>
+
+#include <string>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+    CallOptions CreateOptions() {
+        CallOptions options = {};
+        options.transport = AUTO;
+        return options;
+    }
+
+    Span CreateSpan(const char* name) {
+        return { 1, SpanRecorder::NewId(), 0, "call", name, "zone", SpanRecorder::Now(), 1000, { 0, 0, 0, 0 }, NAPA_RESULT_SUCCESS };
+    }
+}
+
+TEST_CASE("span recorder formats and parses ids", "[span-recorder]") {
+    REQUIRE(SpanRecorder::FormatId(0x1234abcdull) == "000000001234abcd");
+
+    uint64_t id = 0;
+    REQUIRE(SpanRecorder::ParseId("000000001234ABCD", id));
+    REQUIRE(id == 0x1234abcdull);
+
+    auto newId = SpanRecorder::NewId();
+    REQUIRE(newId != 0);
+    REQUIRE(SpanRecorder::ParseId(SpanRecorder::FormatId(newId), id));
+    REQUIRE(id == newId);
+
+    REQUIRE(!SpanRecorder::ParseId("", id));
+    REQUIRE(!SpanRecorder::ParseId("12345678901234567", id));
+    REQUIRE(!SpanRecorder::ParseId("12g4", id));
+}
+
+TEST_CASE("span recorder samples traces at their head", "[span-recorder]") {
+    auto& recorder = SpanRecorder::GetInstance();
+    auto options = CreateOptions();
+
+    recorder.SetSampling(0);
+    auto root = recorder.StartCall(options, nullptr);
+    REQUIRE(root.traceId != 0);
+    REQUIRE(root.spanId != 0);
+    REQUIRE(root.parentSpanId == 0);
+    REQUIRE(!root.sampled);
+
+    recorder.SetSampling(1);
+    root = recorder.StartCall(options, nullptr);
+    REQUIRE(root.sampled);
+
+    // Calls made by a call continue its trace and its decision, whatever the sample rate is now.
+    recorder.SetSampling(0);
+    auto child = recorder.StartCall(options, &root);
+    REQUIRE(child.traceId == root.traceId);
+    REQUIRE(child.parentSpanId == root.spanId);
+    REQUIRE(child.spanId != root.spanId);
+    REQUIRE(child.sampled);
+
+    // A trace carried by the options wins over the caller's.
+    options.trace_id = 42;
+    options.parent_span_id = 7;
+    options.trace_sampled = 0;
+    auto continued = recorder.StartCall(options, &root);
+    REQUIRE(continued.traceId == 42);
+    REQUIRE(continued.parentSpanId == 7);
+    REQUIRE(!continued.sampled);
+
+    recorder.SetSampling(0.25);
+    REQUIRE(recorder.GetSampleRate() == Approx(0.25));
+    size_t sampled = 0;
+    for (int i = 0; i < 10000; i++) {
+        if (recorder.StartCall(CreateOptions(), nullptr).sampled) {
+            sampled++;
+        }
+    }
+    REQUIRE(sampled > 2000);
+    REQUIRE(sampled < 3000);
+
+    recorder.SetSampling(0);
+}
+
+TEST_CASE("span recorder keeps the newest spans until they are exported", "[span-recorder]") {
+    auto& recorder = SpanRecorder::GetInstance();
+    recorder.SetSampling(0, 3);
+    recorder.Export();
+    auto dropped = recorder.GetDropped();
+
+    for (auto name : { "a", "b", "c", "d", "e" }) {
+        recorder.Record(CreateSpan(name));
+    }
+
+    auto spans = recorder.Export();
+    REQUIRE(spans.size() == 3);
+    REQUIRE(spans[0].name == "c");
+    REQUIRE(spans[1].name == "d");
+    REQUIRE(spans[2].name == "e");
+    REQUIRE(recorder.GetDropped() == dropped + 2);
+    REQUIRE(recorder.Export().empty());
+
+    // Shrinking the buffer keeps the newest spans.
+    recorder.SetSampling(0, 4);
+    for (auto name : { "f", "g", "h" }) {
+        recorder.Record(CreateSpan(name));
+    }
+    recorder.SetSampling(0, 2);
+    spans = recorder.Export();
+    REQUIRE(spans.size() == 2);
+    REQUIRE(spans[0].name == "g");
+    REQUIRE(spans[1].name == "h");
+
+    recorder.SetSampling(0, DEFAULT_SPAN_CAPACITY);
+}
+
+TEST_CASE("span scope records operations of sampled traces", "[span-recorder]") {
+    auto& recorder = SpanRecorder::GetInstance();
+    recorder.Export();
+
+    TraceContext trace;
+    trace.traceId = 5;
+    trace.spanId = 6;
+    {
+        SpanScope scope(&trace, "store", "get", "store1");
+    }
+    {
+        SpanScope scope(nullptr, "store", "get", "store1");
+    }
+    REQUIRE(recorder.Export().empty());
+
+    trace.sampled = true;
+    {
+        SpanScope scope(&trace, "store", "get", "store1");
+    }
+    auto spans = recorder.Export();
+    REQUIRE(spans.size() == 1);
+    REQUIRE(spans[0].traceId == 5);
+    REQUIRE(spans[0].parentSpanId == 6);
+    REQUIRE(std::string(spans[0].kind) == "store");
+    REQUIRE(spans[0].name == "get");
+    REQUIRE(spans[0].target == "store1");
+    REQUIRE(spans[0].duration >= 0);
+}
+
+TEST_CASE("span recorder formats spans as JSON", "[span-recorder]") {
+    auto root = CreateSpan("module.function");
+    auto child = CreateSpan("get");
+    child.parentSpanId = root.spanId;
+    child.kind = "store";
+    child.timing = { 1, 2, 3, 4 };
+
+    rapidjson::Document document;
+    document.Parse(SpanRecorder::ToJson({ root, child }).c_str());
+    REQUIRE(!document.HasParseError());
+    REQUIRE(document.IsArray());
+    REQUIRE(document.Size() == 2);
+
+    REQUIRE(std::string(document[0]["traceId"].GetString()) == "0000000000000001");
+    REQUIRE(std::string(document[0]["spanId"].GetString()) == SpanRecorder::FormatId(root.spanId));
+    REQUIRE(!document[0].HasMember("parentSpanId"));
+    REQUIRE(!document[0].HasMember("timing"));
+    REQUIRE(std::string(document[0]["name"].GetString()) == "module.function");
+    REQUIRE(document[0]["duration"].GetInt64() == 1000);
+
+    REQUIRE(std::string(document[1]["parentSpanId"].GetString()) == SpanRecorder::FormatId(root.spanId));
+    REQUIRE(std::string(document[1]["kind"].GetString()) == "store");
+    REQUIRE(document[1]["timing"]["execute"].GetInt64() == 3);
+    REQUIRE(document[1]["code"].GetInt() == NAPA_RESULT_SUCCESS);
+}
@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+#include <zone/task-graph.h>
+
+#include <napa/transport/transport-context.h>
+
+#include <algorithm>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+
+    /// <summary> Records the calls of graph tasks, and runs them on threads like zone workers. </summary>
+    struct Executor {
+        std::mutex lock;
+        std::vector<std::string> calls;
+        std::vector<std::thread> threads;
+
+        ~Executor() {
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+
+        /// <summary> A task returning its name and arguments like 'b(1,a())', with a '*' if it got handles, or failing if it's named 'fail'. </summary>
+        GraphTask Task(const std::string& name, std::vector<size_t> dependencies, std::vector<std::string> arguments = {}) {
+            GraphTask task;
+            task.name = name;
+            task.function = name;
+            task.arguments = std::move(arguments);
+            task.options = FunctionSpec().options;
+            task.dependencies = std::move(dependencies);
+            task.execute = [this](const FunctionSpec& spec, ExecuteCallback callback) {
+                auto name = NAPA_STRING_REF_TO_STD_STRING(spec.function);
+                auto arguments = spec.ownedArguments;
+                auto loaded = spec.transportContext->GetSharedCount() > 0;
+                std::lock_guard<std::mutex> guard(lock);
+                calls.push_back(name);
+                threads.emplace_back([name, arguments, loaded, callback]() {
+                    if (name == "fail") {
+                        callback({ NAPA_RESULT_EXECUTE_FUNC_ERROR, "failed", "", nullptr });
+                        return;
+                    }
+                    std::string value = name + "(";
+                    for (size_t i = 0; i < arguments.size(); i++) {
+                        value += (i > 0 ? "," : "") + arguments[i];
+                    }
+                    value += loaded ? ")*" : ")";
+                    callback({ NAPA_RESULT_SUCCESS, "", value, std::make_unique<transport::TransportContext>() });
+                });
+            };
+            return task;
+        }
+    };
+
+    std::vector<Result> RunGraph(std::vector<GraphTask> tasks) {
+        std::promise<std::vector<Result>> promise;
+        TaskGraph::Run(std::move(tasks), [&promise](std::vector<Result> results) {
+            promise.set_value(std::move(results));
+        });
+        return promise.get_future().get();
+    }
+}
+
+TEST_CASE("Task graph validation", "[task-graph]") {
+    Executor executor;
+    std::string error;
+
+    SECTION("Accepts a diamond") {
+        std::vector<GraphTask> tasks;
+        tasks.push_back(executor.Task("a", {}));
+        tasks.push_back(executor.Task("b", { 0 }));
+        tasks.push_back(executor.Task("c", { 0 }));
+        tasks.push_back(executor.Task("d", { 1, 2 }));
+        REQUIRE(TaskGraph::Validate(tasks, error));
+    }
+
+    SECTION("Rejects unknown dependencies") {
+        std::vector<GraphTask> tasks;
+        tasks.push_back(executor.Task("a", { 3 }));
+        REQUIRE_FALSE(TaskGraph::Validate(tasks, error));
+        REQUIRE(error.find("\"a\"") != std::string::npos);
+    }
+
+    SECTION("Rejects cycles") {
+        std::vector<GraphTask> tasks;
+        tasks.push_back(executor.Task("a", {}));
+        tasks.push_back(executor.Task("b", { 0, 2 }));
+        tasks.push_back(executor.Task("c", { 1 }));
+        REQUIRE_FALSE(TaskGraph::Validate(tasks, error));
+        REQUIRE(error.find("cycle") != std::string::npos);
+    }
+
+    SECTION("Rejects tasks depending on themselves") {
+        std::vector<GraphTask> tasks;
+        tasks.push_back(executor.Task("a", { 0 }));
+        REQUIRE_FALSE(TaskGraph::Validate(tasks, error));
+    }
+}
+
+TEST_CASE("Task graph runs tasks after their dependencies", "[task-graph]") {
+    Executor executor;
+
+    SECTION("Results of dependencies follow the arguments of a task") {
+        std::vector<GraphTask> tasks;
+        tasks.push_back(executor.Task("a", {}, { "1" }));
+        tasks.push_back(executor.Task("b", { 0 }));
+        tasks.push_back(executor.Task("c", { 0 }, { "2" }));
+        tasks.push_back(executor.Task("d", { 2, 1 }));
+
+        auto results = RunGraph(std::move(tasks));
+        REQUIRE(results.size() == 4);
+        REQUIRE(results[0].returnValue == "a(1)");
+        REQUIRE(results[1].returnValue == "b(a(1))");
+        REQUIRE(results[2].returnValue == "c(2,a(1))");
+        REQUIRE(results[3].returnValue == "d(c(2,a(1)),b(a(1)))");
+
+        std::lock_guard<std::mutex> guard(executor.lock);
+        REQUIRE(executor.calls.front() == "a");
+        REQUIRE(executor.calls.back() == "d");
+    }
+
+    SECTION("Handles of arguments and results are passed on") {
+        std::vector<GraphTask> tasks;
+        tasks.push_back(executor.Task("a", {}));
+        tasks.push_back(executor.Task("b", {}));
+        tasks.push_back(executor.Task("c", { 1 }));
+        tasks.push_back(executor.Task("d", { 1 }));
+        tasks[0].transportContext = std::make_unique<transport::TransportContext>();
+        tasks[0].transportContext->SaveShared(std::make_shared<int>(1));
+
+        // 'b' returns a handle, both of its dependents get it.
+        tasks[1].execute = [](const FunctionSpec&, ExecuteCallback callback) {
+            auto context = std::make_unique<transport::TransportContext>();
+            context->SaveShared(std::make_shared<int>(2));
+            callback({ NAPA_RESULT_SUCCESS, "", "b()", std::move(context) });
+        };
+
+        auto results = RunGraph(std::move(tasks));
+        REQUIRE(results[0].returnValue == "a()*");
+        REQUIRE(results[1].transportContext->GetSharedCount() == 1);
+        REQUIRE(results[2].returnValue == "c(b())*");
+        REQUIRE(results[3].returnValue == "d(b())*");
+    }
+
+    SECTION("Independent tasks all run") {
+        std::vector<GraphTask> tasks;
+        for (int i = 0; i < 16; i++) {
+            tasks.push_back(executor.Task("t" + std::to_string(i), {}));
+        }
+        auto results = RunGraph(std::move(tasks));
+        for (int i = 0; i < 16; i++) {
+            REQUIRE(results[i].returnValue == "t" + std::to_string(i) + "()");
+        }
+    }
+
+    SECTION("An empty graph completes at once") {
+        REQUIRE(RunGraph({}).empty());
+    }
+}
+
+TEST_CASE("Task graph fails the dependents of a failed task", "[task-graph]") {
+    Executor executor;
+
+    std::vector<GraphTask> tasks;
+    tasks.push_back(executor.Task("a", {}));
+    tasks.push_back(executor.Task("fail", { 0 }));
+    tasks.push_back(executor.Task("c", { 1 }));
+    tasks.push_back(executor.Task("d", { 2, 0 }));
+    tasks.push_back(executor.Task("e", { 0 }));
+
+    auto results = RunGraph(std::move(tasks));
+    REQUIRE(results[0].code == NAPA_RESULT_SUCCESS);
+    REQUIRE(results[1].code == NAPA_RESULT_EXECUTE_FUNC_ERROR);
+    REQUIRE(results[2].code == NAPA_RESULT_EXECUTE_FUNC_ERROR);
+    REQUIRE(results[2].errorMessage == "Dependency \"fail\" failed: failed");
+    REQUIRE(results[3].code == NAPA_RESULT_EXECUTE_FUNC_ERROR);
+    REQUIRE(results[4].returnValue == "e(a())");
+
+    std::lock_guard<std::mutex> guard(executor.lock);
+    REQUIRE(std::find(executor.calls.begin(), executor.calls.end(), "c") == executor.calls.end());
+    REQUIRE(std::find(executor.calls.begin(), executor.calls.end(), "d") == executor.calls.end());
+}
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/timeout-watchdog.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+using namespace napa::zone;
+using namespace std::chrono;
+using namespace std::chrono_literals;
+
+namespace {
+    class TestTask : public TerminableTask {
+    public:
+        void Execute() override {}
+        void Reject(napa::ResultCode, const std::string&) override {}
+    };
+}
+
+TEST_CASE("watchdog expires a task that runs past its timeout", "[timeout-watchdog]") {
+    TestTask task;
+    std::promise<TerminableTask*> promise;
+    auto future = promise.get_future();
+
+    TimeoutWatchdog watchdog(2, [&promise](TerminableTask* expired, v8::Isolate*) {
+        promise.set_value(expired);
+    });
+
+    auto startTime = steady_clock::now();
+    watchdog.Arm(1, &task, nullptr, 50ms);
+
+    REQUIRE(future.wait_for(1s) == std::future_status::ready);
+    REQUIRE(future.get() == &task);
+    REQUIRE(steady_clock::now() - startTime >= 50ms);
+
+    watchdog.Disarm(1);
+}
+
+TEST_CASE("watchdog doesn't expire a task disarmed in time", "[timeout-watchdog]") {
+    TestTask task;
+    std::atomic<int> expirations(0);
+
+    TimeoutWatchdog watchdog(1, [&expirations](TerminableTask*, v8::Isolate*) {
+        expirations++;
+    });
+
+    for (int i = 0; i < 100; i++) {
+        watchdog.Arm(0, &task, nullptr, 100ms);
+        watchdog.Disarm(0);
+    }
+    std::this_thread::sleep_for(150ms);
+
+    REQUIRE(expirations == 0);
+}
+
+TEST_CASE("watchdog expires a task once", "[timeout-watchdog]") {
+    TestTask task;
+    std::atomic<int> expirations(0);
+
+    TimeoutWatchdog watchdog(1, [&expirations](TerminableTask*, v8::Isolate*) {
+        expirations++;
+    });
+
+    watchdog.Arm(0, &task, nullptr, 10ms);
+    std::this_thread::sleep_for(100ms);
+    watchdog.Disarm(0);
+
+    REQUIRE(expirations == 1);
+}
+
+TEST_CASE("disarm waits for the expiration handler", "[timeout-watchdog]") {
+    TestTask task;
+    std::atomic<bool> handling(false);
+    std::atomic<bool> handled(false);
+
+    TimeoutWatchdog watchdog(1, [&handling, &handled](TerminableTask*, v8::Isolate*) {
+        handling = true;
+        std::this_thread::sleep_for(50ms);
+        handled = true;
+    });
+
+    watchdog.Arm(0, &task, nullptr, 1ms);
+    while (!handling) {
+        std::this_thread::yield();
+    }
+    watchdog.Disarm(0);
+
+    REQUIRE(handled);
+}
+
+TEST_CASE("watchdog wakes up after parking", "[timeout-watchdog]") {
+    TestTask task;
+    std::promise<void> promise;
+    auto future = promise.get_future();
+
+    TimeoutWatchdog watchdog(1, [&promise](TerminableTask*, v8::Isolate*) {
+        promise.set_value();
+    });
+
+    // Long enough for the watchdog to park.
+    std::this_thread::sleep_for(300ms);
+
+    watchdog.Arm(0, &task, nullptr, 10ms);
+    REQUIRE(future.wait_for(1s) == std::future_status::ready);
+    watchdog.Disarm(0);
+}
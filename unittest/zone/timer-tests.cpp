@@ -4,9 +4,13 @@
 #include <catch/catch.hpp>
 
 #include "zone/timer.h"
+#include "zone/timer-slack.h"
 
 #include <atomic>
 #include <future>
+#include <limits>
+#include <thread>
+#include <vector>
 
 #include <iostream>
 
@@ -77,4 +81,109 @@ TEST_CASE("timers are called by order", "[timer]") {
     REQUIRE(future1.get() == 3);
     REQUIRE(future2.get() == 2);
     REQUIRE(future3.get() == 1);
-}
\ No newline at end of file
+}
+TEST_CASE("timer restarted before expiration fires once after the last start", "[timer]") {
+    std::atomic<int> calls(0);
+    std::promise<high_resolution_clock::time_point> promise;
+    auto future = promise.get_future();
+
+    Timer timer([&promise, &calls]() {
+        if (++calls == 1) {
+            promise.set_value(high_resolution_clock::now());
+        }
+    }, 100ms);
+
+    timer.Start();
+    std::this_thread::sleep_for(50ms);
+
+    auto restartTime = high_resolution_clock::now();
+    timer.Start();
+
+    REQUIRE(future.get() - restartTime >= 100ms);
+    std::this_thread::sleep_for(150ms);
+    REQUIRE(calls == 1);
+}
+
+TEST_CASE("timers are not limited to a 16 bit index", "[timer]") {
+    const int count = 70000;
+    std::atomic<int> calls(0);
+
+    std::vector<std::unique_ptr<Timer>> timers;
+    timers.reserve(count);
+    for (int i = 0; i < count; i++) {
+        timers.emplace_back(std::make_unique<Timer>([&calls]() { calls++; }, milliseconds(10 + i % 100)));
+        timers.back()->Start();
+    }
+
+    auto end = high_resolution_clock::now() + 5s;
+    while (calls < count && high_resolution_clock::now() < end) {
+        std::this_thread::sleep_for(10ms);
+    }
+    REQUIRE(calls == count);
+}
+
+TEST_CASE("timers created on different threads are all called", "[timer]") {
+    std::atomic<int> calls(0);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&calls, i]() {
+            std::promise<void> promise;
+            Timer timer([&promise, &calls]() {
+                calls++;
+                promise.set_value();
+            }, milliseconds(20 * (i + 1)));
+
+            timer.Start();
+            promise.get_future().wait();
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(calls == 4);
+}
+
+TEST_CASE("timers with slack coalesce on shared ticks", "[timer]") {
+    // Without slack a timer fires when it's due.
+    REQUIRE(CoalesceTick(103, 0, 100) == 103);
+
+    // The tick the thread wakes up at anyway is taken when it's in the window.
+    REQUIRE(CoalesceTick(100, 10, 107) == 107);
+    REQUIRE(CoalesceTick(100, 10, 111) == 104);
+
+    // Otherwise a multiple of a power of two, which timers of other slacks pick too.
+    REQUIRE(CoalesceTick(101, 10, 0) == 104);
+    REQUIRE(CoalesceTick(101, 20, 0) == 112);
+    REQUIRE(CoalesceTick(105, 20, 0) == 112);
+    for (uint64_t earliest = 0; earliest < 200; earliest++) {
+        for (uint64_t slack = 1; slack < 40; slack++) {
+            auto tick = CoalesceTick(earliest, slack, std::numeric_limits<uint64_t>::max());
+            REQUIRE(tick >= earliest);
+            REQUIRE(tick <= earliest + slack);
+        }
+    }
+
+    // Aligned intervals fire on the next multiple of their period.
+    REQUIRE(AlignTick(0, 50) == 50);
+    REQUIRE(AlignTick(149, 50) == 150);
+    REQUIRE(AlignTick(150, 50) == 200);
+}
+
+TEST_CASE("timer with slack is triggered within its slack", "[timer][!mayfail]") {
+    std::promise<high_resolution_clock::time_point> promise;
+    auto future = promise.get_future();
+
+    Timer timer([&promise]() {
+        promise.set_value(high_resolution_clock::now());
+    }, 50ms, 30ms);
+
+    auto startTime = high_resolution_clock::now();
+    timer.Start();
+
+    REQUIRE(future.wait_for(150ms) != std::future_status::timeout);
+    auto elapsed = future.get() - startTime;
+    REQUIRE(elapsed >= 50ms);
+    REQUIRE(elapsed < 120ms);
+}
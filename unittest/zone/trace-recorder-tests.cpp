@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/trace-recorder.h"
+
+#include <rapidjson/document.h>
+
+#include <string>
+#include <thread>
+
+using namespace napa::zone;
+
+namespace {
+    rapidjson::Document StopTrace() {
+        std::string json;
+        REQUIRE(TraceRecorder::GetInstance().Stop(json));
+
+        rapidjson::Document document;
+        document.Parse(json.c_str());
+        REQUIRE(!document.HasParseError());
+        return document;
+    }
+
+    size_t CountEvents(const rapidjson::Document& trace, const char* name) {
+        size_t count = 0;
+        for (const auto& event : trace["traceEvents"].GetArray()) {
+            if (std::string(event["name"].GetString()) == name) {
+                count++;
+            }
+        }
+        return count;
+    }
+}
+
+TEST_CASE("trace recorder records events of all threads", "[trace-recorder]") {
+    auto& recorder = TraceRecorder::GetInstance();
+    REQUIRE(recorder.Start());
+    REQUIRE(TraceRecorder::IsEnabled());
+    REQUIRE(!recorder.Start());
+
+    std::thread thread([&recorder]() {
+        recorder.SetThreadName("test worker");
+        for (int i = 0; i < 10; i++) {
+            TraceScope scope("test", "Scope", "index", i);
+        }
+    });
+    thread.join();
+
+    recorder.RecordInstant("test", "Instant", "value", 42);
+    recorder.RecordBegin("test", "Duration");
+    recorder.RecordEnd("test", "Duration");
+
+    auto trace = StopTrace();
+    REQUIRE(!TraceRecorder::IsEnabled());
+    REQUIRE(CountEvents(trace, "Scope") == 10);
+    REQUIRE(CountEvents(trace, "Instant") == 1);
+    REQUIRE(CountEvents(trace, "Duration") == 2);
+    REQUIRE(CountEvents(trace, "thread_name") >= 1);
+    REQUIRE(trace["otherData"]["droppedEvents"].GetUint64() == 0);
+
+    for (const auto& event : trace["traceEvents"].GetArray()) {
+        std::string name = event["name"].GetString();
+        if (name == "Scope") {
+            REQUIRE(std::string(event["ph"].GetString()) == "X");
+            REQUIRE(event["dur"].GetDouble() >= 0);
+            REQUIRE(event["args"]["index"].GetInt64() < 10);
+        } else if (name == "Instant") {
+            REQUIRE(std::string(event["ph"].GetString()) == "i");
+            REQUIRE(event["args"]["value"].GetInt64() == 42);
+        }
+    }
+
+    std::string json;
+    REQUIRE(!recorder.Stop(json));
+}
+
+TEST_CASE("trace recorder drops events past the thread buffer", "[trace-recorder]") {
+    auto& recorder = TraceRecorder::GetInstance();
+    REQUIRE(recorder.Start(4));
+
+    for (int i = 0; i < 10; i++) {
+        recorder.RecordInstant("test", "Instant");
+    }
+
+    auto trace = StopTrace();
+    REQUIRE(CountEvents(trace, "Instant") == 4);
+    REQUIRE(trace["otherData"]["droppedEvents"].GetUint64() == 6);
+}
+
+TEST_CASE("trace recorder leaves out events of earlier traces and while stopped", "[trace-recorder]") {
+    auto& recorder = TraceRecorder::GetInstance();
+    REQUIRE(recorder.Start());
+    recorder.RecordInstant("test", "Earlier");
+    StopTrace();
+
+    recorder.RecordInstant("test", "Stopped");
+    TraceScope scope("test", "Stopped");
+
+    REQUIRE(recorder.Start());
+    recorder.RecordInstant("test", "Later");
+
+    auto trace = StopTrace();
+    REQUIRE(CountEvents(trace, "Earlier") == 0);
+    REQUIRE(CountEvents(trace, "Stopped") == 0);
+    REQUIRE(CountEvents(trace, "Later") == 1);
+}
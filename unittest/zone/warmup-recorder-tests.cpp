@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <module/core-modules/node/file-system-helpers.h>
+#include <napa/transport/transport-context.h>
+#include <utils/payload-compression.h>
+#include <zone/warmup-recorder.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+
+using namespace napa;
+using namespace napa::zone;
+
+namespace {
+    const std::string SAMPLES_FILE("warmup-recorder-test.samples");
+
+    FunctionSpec MakeSpec(const std::string& module, const std::string& function, std::vector<std::string> arguments) {
+        FunctionSpec spec;
+        spec.module = STD_STRING_TO_NAPA_STRING_REF(module);
+        spec.function = STD_STRING_TO_NAPA_STRING_REF(function);
+        spec.ownedArguments = std::move(arguments);
+        return spec;
+    }
+}
+
+TEST_CASE("warm-up samples are JSON arrays of marshalled arguments", "[warmup-recorder]") {
+    REQUIRE(WarmupRecorder::FormatSample({}) == "[]");
+    REQUIRE(WarmupRecorder::FormatSample({ "1", "\"a\"" }) == "[\"1\",\"\\\"a\\\"\"]");
+    REQUIRE(WarmupRecorder::FormatSample({ "\"a\\\\b\"" }) == "[\"\\\"a\\\\\\\\b\\\"\"]");
+    REQUIRE(WarmupRecorder::FormatSample({ std::string("\n\x01", 2) }) == "[\"\\n\\u0001\"]");
+}
+
+TEST_CASE("warm-up recorder records the first calls of its function", "[warmup-recorder]") {
+    const std::string module("/app/handler.js");
+    const std::string function("handle");
+    const std::string other("other");
+
+    // A previous file is replaced on the first sample.
+    const std::string stale("stale\n");
+    module::file_system_helpers::WriteFileSync(SAMPLES_FILE, stale.data(), stale.size());
+
+    std::unique_ptr<WarmupRecorder> recorder(new WarmupRecorder(SAMPLES_FILE, module, function, 2));
+
+    recorder->Record(MakeSpec(module, other, { "0" }));
+    recorder->Record(MakeSpec(other, function, { "0" }));
+    REQUIRE(recorder->GetSampleCount() == 0);
+
+    SECTION("up to the maximum number of samples") {
+        recorder->Record(MakeSpec(module, function, { "1", "{\"a\":1}" }));
+
+        std::string compressed(2048, 'a');
+        compressed = "\"" + compressed + "\"";
+        auto original = compressed;
+        REQUIRE(utils::CompressPayload(compressed, 1, utils::PayloadSource::Call));
+        recorder->Record(MakeSpec(module, function, { compressed }));
+
+        recorder->Record(MakeSpec(module, function, { "3" }));
+        REQUIRE(recorder->GetSampleCount() == 2);
+
+        recorder.reset();
+        auto content = module::file_system_helpers::ReadFileSync(SAMPLES_FILE);
+        REQUIRE(content == "[\"1\",\"{\\\"a\\\":1}\"]\n" + WarmupRecorder::FormatSample({ original }) + "\n");
+    }
+
+    SECTION("without calls passing handles or binary arguments") {
+        auto spec = MakeSpec(module, function, { "1" });
+        spec.transportContext = std::make_unique<napa::transport::TransportContext>();
+        spec.transportContext->SaveShared(std::make_shared<int>(1));
+        recorder->Record(spec);
+
+        auto binary = MakeSpec(module, function, { "1" });
+        binary.options.transport = BINARY;
+        recorder->Record(binary);
+
+        REQUIRE(recorder->GetSampleCount() == 0);
+    }
+
+    recorder.reset();
+    std::remove(SAMPLES_FILE.c_str());
+}
@@ -0,0 +1,56 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include <zone/worker-affinity.h>
+
+using namespace napa;
+using namespace napa::zone;
+
+using Cpus = std::vector<uint32_t>;
+
+TEST_CASE("worker affinity computation", "[worker-affinity]") {
+    settings::ZoneSettings settings;
+    Cpus numaNodeCpus = { 4, 5, 6, 7 };
+    Cpus physicalCoreCpus = { 0, 2, 4, 6 };
+
+    SECTION("No placement settings means no restriction") {
+        REQUIRE(ComputeWorkerAffinity(0, settings, numaNodeCpus, physicalCoreCpus).empty());
+    }
+
+    SECTION("CPU set applies to all workers") {
+        settings.cpuSet = { 1, 2 };
+        REQUIRE(ComputeWorkerAffinity(0, settings, numaNodeCpus, physicalCoreCpus) == Cpus({ 1, 2 }));
+        REQUIRE(ComputeWorkerAffinity(3, settings, numaNodeCpus, physicalCoreCpus) == Cpus({ 1, 2 }));
+    }
+
+    SECTION("NUMA node restricts the CPU set") {
+        settings.numaNode = 1;
+        REQUIRE(ComputeWorkerAffinity(0, settings, numaNodeCpus, physicalCoreCpus) == numaNodeCpus);
+
+        settings.cpuSet = { 3, 4, 5 };
+        REQUIRE(ComputeWorkerAffinity(0, settings, numaNodeCpus, physicalCoreCpus) == Cpus({ 4, 5 }));
+
+        settings.cpuSet = { 0, 1 };
+        REQUIRE(ComputeWorkerAffinity(0, settings, numaNodeCpus, physicalCoreCpus).empty());
+    }
+
+    SECTION("Pinning assigns distinct physical cores") {
+        settings.pinWorkersToCores = true;
+        REQUIRE(ComputeWorkerAffinity(0, settings, numaNodeCpus, physicalCoreCpus) == Cpus({ 0 }));
+        REQUIRE(ComputeWorkerAffinity(1, settings, numaNodeCpus, physicalCoreCpus) == Cpus({ 2 }));
+        REQUIRE(ComputeWorkerAffinity(4, settings, numaNodeCpus, physicalCoreCpus) == Cpus({ 0 }));
+
+        settings.numaNode = 1;
+        REQUIRE(ComputeWorkerAffinity(0, settings, numaNodeCpus, physicalCoreCpus) == Cpus({ 4 }));
+        REQUIRE(ComputeWorkerAffinity(1, settings, numaNodeCpus, physicalCoreCpus) == Cpus({ 6 }));
+    }
+
+    SECTION("Pinning falls back to logical CPUs when no physical core is allowed") {
+        settings.pinWorkersToCores = true;
+        settings.cpuSet = { 1, 3 };
+        REQUIRE(ComputeWorkerAffinity(0, settings, numaNodeCpus, physicalCoreCpus) == Cpus({ 1 }));
+        REQUIRE(ComputeWorkerAffinity(1, settings, numaNodeCpus, physicalCoreCpus) == Cpus({ 3 }));
+    }
+}
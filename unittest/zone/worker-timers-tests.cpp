@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license.
+
+#include <catch/catch.hpp>
+
+#include "zone/worker-timers.h"
+
+#include <thread>
+#include <vector>
+
+using namespace napa::zone;
+using namespace std::chrono_literals;
+
+TEST_CASE("worker timers fire once they are due", "[worker-timers]") {
+    WorkerTimers timers;
+    int fired = 0;
+    timers.Add([&fired]() { fired++; }, 20ms);
+
+    REQUIRE_FALSE(timers.HasDue());
+    REQUIRE(timers.FireDue() == 0);
+
+    WorkerTimers::Clock::time_point due;
+    REQUIRE(timers.GetNextDue(due));
+    std::this_thread::sleep_until(due);
+
+    REQUIRE(timers.HasDue());
+    REQUIRE(timers.FireDue() == 1);
+    REQUIRE(fired == 1);
+    REQUIRE(timers.GetSize() == 0);
+    REQUIRE_FALSE(timers.GetNextDue(due));
+}
+
+TEST_CASE("worker timers fire in order of due time and then of adding", "[worker-timers]") {
+    WorkerTimers timers;
+    std::vector<int> order;
+    timers.Add([&order]() { order.push_back(3); }, 10ms);
+    timers.Add([&order]() { order.push_back(1); }, 0ms);
+    timers.Add([&order]() { order.push_back(2); }, 0ms);
+
+    std::this_thread::sleep_for(20ms);
+    REQUIRE(timers.FireDue() == 3);
+    REQUIRE(order == std::vector<int>({ 1, 2, 3 }));
+}
+
+TEST_CASE("worker timers added by a callback fire on a later call", "[worker-timers]") {
+    WorkerTimers timers;
+    int fired = 0;
+    timers.Add([&timers, &fired]() {
+        fired++;
+        timers.Add([&fired]() { fired++; }, 0ms);
+    }, 0ms);
+
+    REQUIRE(timers.FireDue() == 1);
+    REQUIRE(fired == 1);
+    REQUIRE(timers.GetSize() == 1);
+
+    REQUIRE(timers.FireDue() == 1);
+    REQUIRE(fired == 2);
+}
+
+TEST_CASE("worker timers are per thread", "[worker-timers]") {
+    WorkerTimers timers;
+    WorkerTimers::SetCurrent(&timers);
+    REQUIRE(WorkerTimers::GetCurrent() == &timers);
+
+    WorkerTimers* other = &timers;
+    std::thread([&other]() { other = WorkerTimers::GetCurrent(); }).join();
+    REQUIRE(other == nullptr);
+
+    WorkerTimers::SetCurrent(nullptr);
+}
+
+TEST_CASE("worker timers with slack fire together", "[worker-timers]") {
+    WorkerTimers timers;
+    timers.SetSlack(40ms);
+
+    int fired = 0;
+    timers.Add([&fired]() { fired++; }, 10ms);
+    WorkerTimers::Clock::time_point first;
+    REQUIRE(timers.GetNextDue(first));
+    REQUIRE(first >= WorkerTimers::Clock::now() + 9ms);
+
+    // The second timer is due within its slack of the first one, it fires with it.
+    timers.Add([&fired]() { fired++; }, 12ms);
+    WorkerTimers::Clock::time_point next;
+    REQUIRE(timers.GetNextDue(next));
+    REQUIRE(next == first);
+
+    std::this_thread::sleep_until(first);
+    REQUIRE(timers.FireDue() == 2);
+    REQUIRE(fired == 2);
+}
+
+TEST_CASE("worker timers fire aligned intervals on multiples of their period", "[worker-timers]") {
+    WorkerTimers timers;
+    timers.SetAlignedIntervals(true);
+
+    timers.Add([]() {}, 50ms, true);
+    WorkerTimers::Clock::time_point due;
+    REQUIRE(timers.GetNextDue(due));
+
+    auto sinceEpoch = due.time_since_epoch();
+    REQUIRE(sinceEpoch % std::chrono::milliseconds(50) == WorkerTimers::Clock::duration::zero());
+    REQUIRE(due > WorkerTimers::Clock::now());
+    REQUIRE(due <= WorkerTimers::Clock::now() + 50ms);
+
+    // Timers that don't repeat fire after their timeout.
+    WorkerTimers unaligned;
+    unaligned.SetAlignedIntervals(true);
+    auto before = WorkerTimers::Clock::now();
+    unaligned.Add([]() {}, 50ms);
+    REQUIRE(unaligned.GetNextDue(due));
+    REQUIRE(due >= before + 50ms);
+}